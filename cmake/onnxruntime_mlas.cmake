@@ -6,6 +6,9 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/dgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/bf16gemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/spgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
@@ -15,7 +18,16 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/erf.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/gelu.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/layernorm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/normalize.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/quantize.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/qlbinary.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/qlgavgpool.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/transpose.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/convert.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/winograd.cpp
 )
 
 if(MSVC)
@@ -37,7 +49,10 @@ if(MSVC)
         COMMAND
             armasm64.exe ${ARMASM_FLAGS} ${pre_filename} ${obj_filename}
     )
-    set(mlas_platform_srcs ${obj_filename})
+    set(mlas_platform_srcs
+      ${obj_filename}
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/QgemmU8X8KernelNeon.cpp
+    )
   elseif(CMAKE_GENERATOR_PLATFORM STREQUAL "ARM" OR CMAKE_GENERATOR MATCHES "ARM")
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/arm/sgemmc.cpp
@@ -76,7 +91,13 @@ if(MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/CvtFp16KernelF16C.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QuantizeKernelAvx2.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QuantizeKernelAvx512F.cpp
     )
+
+    # The AVX512-BF16 kernel is only built with GCC and Clang.
+    set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVX512BF16_UNSUPPORTED)
   else()
     enable_language(ASM_MASM)
 
@@ -124,8 +145,37 @@ else()
   elseif(ARM64)
     enable_language(ASM)
 
+    # The UDOT kernel needs a compiler that supports the ARMv8.2 dot product
+    # extension. Without it, only the baseline NEON kernel is built.
+    include(CheckCXXSourceCompiles)
+    check_cxx_compiler_flag("-march=armv8.2-a+dotprod" HAS_ARM64_DOTPROD)
+    if(HAS_ARM64_DOTPROD)
+      set(CMAKE_REQUIRED_FLAGS "-march=armv8.2-a+dotprod")
+      check_cxx_source_compiles("
+        #include <arm_neon.h>
+        int main() {
+          uint32x4_t acc = vdupq_n_u32(0);
+          acc = vdotq_u32(acc, vdupq_n_u8(1), vdupq_n_u8(2));
+          return (int)vgetq_lane_u32(acc, 0);
+        }"
+        ARM64_DOTPROD_COMPILES
+      )
+      set(CMAKE_REQUIRED_FLAGS "")
+    endif()
+
+    if(ARM64_DOTPROD_COMPILES)
+      set(mlas_platform_srcs_udot
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/QgemmU8X8KernelUdot.cpp
+      )
+      set_source_files_properties(${mlas_platform_srcs_udot} PROPERTIES COMPILE_FLAGS "-march=armv8.2-a+dotprod")
+    else()
+      set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_ARM64_DOTPROD_UNSUPPORTED)
+    endif()
+
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemmKernelNeon.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/QgemmU8X8KernelNeon.cpp
+      ${mlas_platform_srcs_udot}
     )
   elseif(X86)
     enable_language(ASM)
@@ -172,6 +222,11 @@ else()
     )
     set_source_files_properties(${mlas_platform_srcs_avx} PROPERTIES COMPILE_FLAGS "-mavx")
 
+    set(mlas_platform_srcs_f16c
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/CvtFp16KernelF16C.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_f16c} PROPERTIES COMPILE_FLAGS "-mavx -mf16c")
+
     set(mlas_platform_srcs_avx2
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QgemmU8S8KernelAvx2.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QgemvU8S8KernelAvx2.S
@@ -182,6 +237,7 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QuantizeKernelAvx2.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
@@ -214,6 +270,12 @@ else()
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
       endif()
 
+      set(mlas_platform_srcs_avx512f_cpp
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QuantizeKernelAvx512F.cpp
+      )
+      # The MLAS headers include Eigen, which requires FMA along with AVX512F.
+      set_source_files_properties(${mlas_platform_srcs_avx512f_cpp} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mavx512f")
+
       # AVX512BW support is only available if AVX512F support is present.
       check_cxx_compiler_flag("-mavx512bw" HAS_AVX512BW)
       if(HAS_AVX512BW)
@@ -244,6 +306,29 @@ else()
         #
         set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512BW_UNSUPPORTED")
       endif() # AVX512BW_COMPILES
+
+      # AVX512BF16 support is only available if AVX512F support is present.
+      check_cxx_compiler_flag("-mavx512bf16" HAS_AVX512BF16)
+      if(HAS_AVX512BF16)
+        set(CMAKE_REQUIRED_FLAGS "-mavx512bf16")
+        check_cxx_source_compiles("
+          int main() {
+            asm(\"vdpbf16ps %zmm0,%zmm0,%zmm0\");
+            return 0;
+          }"
+          AVX512BF16_COMPILES
+        )
+      endif()
+
+      if(AVX512BF16_COMPILES)
+        set(mlas_platform_srcs_avx512bf16
+          ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/Bf16GemmKernelAvx512BF16.cpp
+        )
+        # The MLAS headers include Eigen, which requires FMA along with AVX512F.
+        set_source_files_properties(${mlas_platform_srcs_avx512bf16} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mavx512f -mavx512bf16")
+      else() # AVX512BF16_COMPILES
+        set_property(SOURCE ${mlas_common_srcs} APPEND PROPERTY COMPILE_DEFINITIONS MLAS_AVX512BF16_UNSUPPORTED)
+      endif() # AVX512BF16_COMPILES
     else() # AVX512F_COMPILES
       set_source_files_properties(${mlas_common_srcs} PROPERTIES COMPILE_FLAGS "-DMLAS_AVX512F_UNSUPPORTED")
     endif() # AVX512F_COMPILES
@@ -251,9 +336,12 @@ else()
     set(mlas_platform_srcs
       ${mlas_platform_srcs_sse2}
       ${mlas_platform_srcs_avx}
+      ${mlas_platform_srcs_f16c}
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
+      ${mlas_platform_srcs_avx512f_cpp}
       ${mlas_platform_srcs_avx512bw}
+      ${mlas_platform_srcs_avx512bf16}
     )
   endif()
 endif()
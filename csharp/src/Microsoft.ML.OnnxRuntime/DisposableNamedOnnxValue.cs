@@ -67,6 +67,29 @@ namespace Microsoft.ML.OnnxRuntime
             _nativeMemoryManager = nativeMemoryManager;
         }
 
+        /// <summary>
+        /// Returns the data of the output tensor as a Memory over the native buffer, without copying.
+        /// The memory is only valid until this value is disposed. String tensors are not supported.
+        /// </summary>
+        public Memory<T> AsMemory<T>()
+        {
+            var nativeMemory = _nativeMemoryManager as NativeOnnxTensorMemory<T>;
+            if (nativeMemory == null || typeof(T) == typeof(string))
+            {
+                throw new NotSupportedException("Value " + Name + " is not a native tensor of " + typeof(T));
+            }
+            return nativeMemory.Memory;
+        }
+
+        /// <summary>
+        /// Returns the data of the output tensor as a Span over the native buffer, without copying.
+        /// The span is only valid until this value is disposed. String tensors are not supported.
+        /// </summary>
+        public Span<T> AsSpan<T>()
+        {
+            return AsMemory<T>().Span;
+        }
+
         internal static DisposableNamedOnnxValue CreateTensorFromOnnxValue(string name, IntPtr nativeOnnxValue)
         {
             DisposableNamedOnnxValue result = null;
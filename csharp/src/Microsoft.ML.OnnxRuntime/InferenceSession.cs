@@ -198,6 +198,35 @@ namespace Microsoft.ML.OnnxRuntime
 
         }
 
+        /// <summary>
+        /// Creates an OrtIoBinding to bind the inputs and preallocated outputs of this session once and run it
+        /// repeatedly. User must dispose the binding before the session.
+        /// </summary>
+        public OrtIoBinding CreateIoBinding()
+        {
+            return new OrtIoBinding(_nativeHandle);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the values bound to ioBinding. The outputs are read from
+        /// ioBinding.GetOutputValues(), the preallocated outputs are written in place.
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        public void Run(OrtIoBinding ioBinding)
+        {
+            Run(ioBinding, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the values bound to ioBinding, with the given run options.
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        /// <param name="options"></param>
+        public void Run(OrtIoBinding ioBinding, RunOptions options)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRunWithBinding(_nativeHandle, options.Handle, ioBinding.Handle));
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -196,7 +196,7 @@ namespace Microsoft.ML.OnnxRuntime
                 int totalLength = 0;
                 for (int i = 0; i < tensorValue.Length; i++)
                 {
-                    totalLength += Encoding.UTF8.GetByteCount(tensorValue.GetValue(i));
+                    totalLength += Encoding.UTF8.GetByteCount(tensorValue.GetValue(i) ?? string.Empty);
                 }
 
                 long[] longShape = new long[tensorValue.Dimensions.Length];
@@ -218,30 +218,37 @@ namespace Microsoft.ML.OnnxRuntime
                                                     ));
 
                     // fill the native tensor, using GetValue(index) from the Tensor<string>
+                    // all the strings are encoded back to back, null terminated, into a single buffer
+                    // so there is one allocation and one pinned handle regardless of the number of strings
                     var len = tensorValue.Length;
                     var stringsInTensor = new IntPtr[len];
-                    var pinnedHandles = new GCHandle[len + 1];
-                    pinnedHandles[len] = GCHandle.Alloc(stringsInTensor, GCHandleType.Pinned);
+                    var stringOffsets = new int[len];
+                    var utf8Buffer = new byte[totalLength + len];
+                    int offset = 0;
+                    for (int i = 0; i < len; i++)
+                    {
+                        var str = tensorValue.GetValue(i) ?? string.Empty;
+                        stringOffsets[i] = offset;
+                        offset += Encoding.UTF8.GetBytes(str, 0, str.Length, utf8Buffer, offset);
+                        utf8Buffer[offset++] = 0;
+                    }
+
+                    var bufferHandle = GCHandle.Alloc(utf8Buffer, GCHandleType.Pinned);
+                    var stringsHandle = GCHandle.Alloc(stringsInTensor, GCHandleType.Pinned);
                     try
                     {
+                        var bufferAddress = bufferHandle.AddrOfPinnedObject();
                         for (int i = 0; i < len; i++)
                         {
-                            var utf8str = UTF8Encoding.UTF8.GetBytes(tensorValue.GetValue(i) + "\0");
-                            pinnedHandles[i] = GCHandle.Alloc(utf8str, GCHandleType.Pinned);
-                            stringsInTensor[i] = pinnedHandles[i].AddrOfPinnedObject();
+                            stringsInTensor[i] = IntPtr.Add(bufferAddress, stringOffsets[i]);
                         }
 
                         NativeApiStatus.VerifySuccess(NativeMethods.OrtFillStringTensor(nativeTensor, stringsInTensor, (UIntPtr)len));
                     }
                     finally
                     {
-                        foreach (var handle in pinnedHandles)
-                        {
-                            if (handle.IsAllocated)
-                            {
-                                handle.Free();
-                            }
-                        }
+                        stringsHandle.Free();
+                        bufferHandle.Free();
                     }
                 }
                 catch (OnnxRuntimeException e)
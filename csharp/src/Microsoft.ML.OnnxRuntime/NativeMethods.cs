@@ -127,6 +127,49 @@ namespace Microsoft.ML.OnnxRuntime
         public IntPtr ReleaseTensorTypeAndShapeInfo;
         public IntPtr ReleaseSessionOptions;
         public IntPtr ReleaseCustomOpDomain;
+        public IntPtr EnableSharedInitializers;
+        public IntPtr DisableSharedInitializers;
+        public IntPtr RunBatch;
+        public IntPtr CreatePreparedRun;
+        public IntPtr RunPrepared;
+        public IntPtr ReleasePreparedRun;
+        public IntPtr SetLightweightProfilingSamplingInterval;
+        public IntPtr SessionGetProfilingStatistics;
+        public IntPtr SessionGetArenaMemoryUsage;
+        public IntPtr SessionGetMemoryStatistics;
+        public IntPtr SessionGetPeakActivationBytes;
+        public IntPtr CreateIoBinding;
+        public IntPtr BindInput;
+        public IntPtr BindOutput;
+        public IntPtr BindOutputToDevice;
+        public IntPtr GetBoundOutputCount;
+        public IntPtr GetBoundOutputValues;
+        public IntPtr RunWithBinding;
+        public IntPtr ReleaseIoBinding;
+
+        public IntPtr SessionShrinkMemoryArenas;
+        public IntPtr RunOptionsSetShrinkMemoryArenas;
+        public IntPtr SetSessionArenaIdleShrinkTime;
+        public IntPtr SetSessionCpuArenaBackend;
+        public IntPtr SetSessionDeferSubgraphInitializers;
+
+        public IntPtr KernelContext_GetThreadCount;
+        public IntPtr KernelContext_ParallelFor;
+        public IntPtr KernelContext_AllocateScratch;
+        public IntPtr KernelContext_FreeScratch;
+
+        public IntPtr ShapeInferContext_GetInputCount;
+        public IntPtr ShapeInferContext_GetInputTypeShape;
+        public IntPtr ShapeInferContext_SetOutputTypeShape;
+        public IntPtr CreateEnvWithGlobalThreadPools;
+        public IntPtr DisablePerSessionThreads;
+        public IntPtr CreateThreadingOptions;
+        public IntPtr ReleaseThreadingOptions;
+        public IntPtr SetGlobalIntraOpNumThreads;
+        public IntPtr SetGlobalInterOpNumThreads;
+        public IntPtr RunOptionsSetDeadline;
+        public IntPtr RunOptionsSetPriority;
+        public IntPtr SetSessionRunPriorityMaxThreads;
     }
 
     internal static class NativeMethods
@@ -224,6 +267,15 @@ namespace Microsoft.ML.OnnxRuntime
             OrtGetSymbolicDimensions = (DOrtGetSymbolicDimensions)Marshal.GetDelegateForFunctionPointer(api_.GetSymbolicDimensions, typeof(DOrtGetSymbolicDimensions));
             OrtGetTensorShapeElementCount = (DOrtGetTensorShapeElementCount)Marshal.GetDelegateForFunctionPointer(api_.GetTensorShapeElementCount, typeof(DOrtGetTensorShapeElementCount));
             OrtReleaseValue = (DOrtReleaseValue)Marshal.GetDelegateForFunctionPointer(api_.ReleaseValue, typeof(DOrtReleaseValue));
+
+            OrtCreateIoBinding = (DOrtCreateIoBinding)Marshal.GetDelegateForFunctionPointer(api_.CreateIoBinding, typeof(DOrtCreateIoBinding));
+            OrtBindInput = (DOrtBindInput)Marshal.GetDelegateForFunctionPointer(api_.BindInput, typeof(DOrtBindInput));
+            OrtBindOutput = (DOrtBindOutput)Marshal.GetDelegateForFunctionPointer(api_.BindOutput, typeof(DOrtBindOutput));
+            OrtBindOutputToDevice = (DOrtBindOutputToDevice)Marshal.GetDelegateForFunctionPointer(api_.BindOutputToDevice, typeof(DOrtBindOutputToDevice));
+            OrtGetBoundOutputCount = (DOrtGetBoundOutputCount)Marshal.GetDelegateForFunctionPointer(api_.GetBoundOutputCount, typeof(DOrtGetBoundOutputCount));
+            OrtGetBoundOutputValues = (DOrtGetBoundOutputValues)Marshal.GetDelegateForFunctionPointer(api_.GetBoundOutputValues, typeof(DOrtGetBoundOutputValues));
+            OrtRunWithBinding = (DOrtRunWithBinding)Marshal.GetDelegateForFunctionPointer(api_.RunWithBinding, typeof(DOrtRunWithBinding));
+            OrtReleaseIoBinding = (DOrtReleaseIoBinding)Marshal.GetDelegateForFunctionPointer(api_.ReleaseIoBinding, typeof(DOrtReleaseIoBinding));
         }
 
         [DllImport(nativeLib, CharSet = charSet)]
@@ -664,6 +716,37 @@ namespace Microsoft.ML.OnnxRuntime
 
         #endregion
 
+        #region IoBinding API
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtCreateIoBinding(IntPtr /*(OrtSession*)*/ session, out IntPtr /*(OrtIoBinding**)*/ binding);
+        public static DOrtCreateIoBinding OrtCreateIoBinding;
+
+        /// The binding keeps a reference to the tensor, the value can be released after the call
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtBindInput(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtValue*)*/ value);
+        public static DOrtBindInput OrtBindInput;
+
+        /// A bound tensor is written in place by the runs, its shape must match the shape of the output
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtBindOutput(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtValue*)*/ value);
+        public static DOrtBindOutput OrtBindOutput;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtBindOutputToDevice(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtMemoryInfo*)*/ memoryInfo);
+        public static DOrtBindOutputToDevice OrtBindOutputToDevice;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtGetBoundOutputCount(IntPtr /*(const OrtIoBinding*)*/ binding, out UIntPtr count);
+        public static DOrtGetBoundOutputCount OrtGetBoundOutputCount;
+
+        /// Each of the returned values must be released by the caller
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtGetBoundOutputValues(IntPtr /*(const OrtIoBinding*)*/ binding, IntPtr[] /*(OrtValue**)*/ outputs, UIntPtr outputsLength);
+        public static DOrtGetBoundOutputValues OrtGetBoundOutputValues;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtRunWithBinding(IntPtr /*(OrtSession*)*/ session, IntPtr /*(const OrtRunOptions*)*/ runOptions, IntPtr /*(OrtIoBinding*)*/ binding);
+        public static DOrtRunWithBinding OrtRunWithBinding;
+
+        public delegate void DOrtReleaseIoBinding(IntPtr /*(OrtIoBinding*)*/ binding);
+        public static DOrtReleaseIoBinding OrtReleaseIoBinding;
+
+        #endregion IoBinding API
+
         public static byte[] GetPlatformSerializedString(string str)
         {
             if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
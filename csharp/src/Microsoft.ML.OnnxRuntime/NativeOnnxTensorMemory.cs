@@ -204,7 +204,7 @@ namespace Microsoft.ML.OnnxRuntime
                 }
                 Retain();
 
-                return new MemoryHandle((void*)((int)_dataBufferPointer + elementIndex * _elementWidth)); //could not use Unsafe.Add
+                return new MemoryHandle((byte*)_dataBufferPointer + elementIndex * _elementWidth, default(GCHandle), this); //could not use Unsafe.Add
             }
         }
 
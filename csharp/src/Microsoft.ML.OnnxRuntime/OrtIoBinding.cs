@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// Binds the inputs and outputs of an InferenceSession once, to run it repeatedly without passing the values
+    /// on every call. A tensor bound as an output is preallocated: the runs write the output into its buffer.
+    /// The buffers of the bound tensors are pinned until they are rebound or the binding is disposed.
+    /// Created by InferenceSession.CreateIoBinding().
+    /// </summary>
+    public class OrtIoBinding : IDisposable
+    {
+        private IntPtr _nativeHandle;
+        private Dictionary<string, MemoryHandle> _pinnedInputs = new Dictionary<string, MemoryHandle>();
+        private Dictionary<string, MemoryHandle> _pinnedOutputs = new Dictionary<string, MemoryHandle>();
+        private List<string> _outputNames = new List<string>();  // in the order of the native bound outputs
+
+        internal OrtIoBinding(IntPtr session)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateIoBinding(session, out _nativeHandle));
+        }
+
+        internal IntPtr Handle
+        {
+            get
+            {
+                return _nativeHandle;
+            }
+        }
+
+        /// <summary>
+        /// Binds a tensor to an input of the model. Rebinding an input replaces its value.
+        /// </summary>
+        /// <param name="input">Tensor named after the input</param>
+        public void BindInput(NamedOnnxValue input)
+        {
+            Bind(input, false);
+        }
+
+        /// <summary>
+        /// Binds a preallocated tensor to an output of the model. The runs write the output into the buffer of the
+        /// tensor, its shape must match the shape of the output. Rebinding an output replaces its value.
+        /// </summary>
+        /// <param name="output">Tensor named after the output</param>
+        public void BindOutput(NamedOnnxValue output)
+        {
+            Bind(output, true);
+            if (!_outputNames.Contains(output.Name))
+            {
+                _outputNames.Add(output.Name);
+            }
+        }
+
+        /// <summary>
+        /// Returns the bound outputs of the last run over their native memory, without copying. Use
+        /// DisposableNamedOnnxValue.AsSpan() or AsMemory() to read the data. The preallocated outputs share the
+        /// buffer bound by BindOutput. User must dispose the output.
+        /// </summary>
+        public IDisposableReadOnlyCollection<DisposableNamedOnnxValue> GetOutputValues()
+        {
+            UIntPtr count = UIntPtr.Zero;
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtGetBoundOutputCount(_nativeHandle, out count));
+            var outputValueArray = new IntPtr[(ulong)count];
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtGetBoundOutputValues(_nativeHandle, outputValueArray, count));
+
+            var result = new DisposableList<DisposableNamedOnnxValue>();
+            try
+            {
+                for (int i = 0; i < outputValueArray.Length; i++)
+                {
+                    result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(_outputNames[i], outputValueArray[i]));
+                    outputValueArray[i] = IntPtr.Zero;
+                }
+            }
+            catch (Exception e)
+            {
+                result.Dispose();
+                for (int i = 0; i < outputValueArray.Length; i++)
+                {
+                    if (outputValueArray[i] != IntPtr.Zero)
+                    {
+                        NativeMethods.OrtReleaseValue(outputValueArray[i]);
+                    }
+                }
+                throw e;
+            }
+            return result;
+        }
+
+        private void Bind(NamedOnnxValue value, bool isOutput)
+        {
+            IntPtr nativeValue;
+            MemoryHandle pinnedBufferHandle;
+            value.ToNativeOnnxValue(out nativeValue, out pinnedBufferHandle);
+            try
+            {
+                // the binding holds its own reference to the tensor, only the pin must outlive the call
+                NativeApiStatus.VerifySuccess(isOutput ? NativeMethods.OrtBindOutput(_nativeHandle, value.Name, nativeValue)
+                                                       : NativeMethods.OrtBindInput(_nativeHandle, value.Name, nativeValue));
+            }
+            catch (OnnxRuntimeException e)
+            {
+                pinnedBufferHandle.Dispose();
+                throw e;
+            }
+            finally
+            {
+                NativeMethods.OrtReleaseValue(nativeValue);
+            }
+
+            var pinnedBuffers = isOutput ? _pinnedOutputs : _pinnedInputs;
+            MemoryHandle previous;
+            if (pinnedBuffers.TryGetValue(value.Name, out previous))
+            {
+                previous.Dispose();
+            }
+            pinnedBuffers[value.Name] = pinnedBufferHandle;
+        }
+
+        #region destructors disposers
+
+        ~OrtIoBinding()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (_nativeHandle == IntPtr.Zero)
+            {
+                return;
+            }
+            // release the binding first, it references the pinned buffers
+            NativeMethods.OrtReleaseIoBinding(_nativeHandle);
+            _nativeHandle = IntPtr.Zero;
+            foreach (var pinned in _pinnedInputs.Values)
+            {
+                pinned.Dispose();
+            }
+            foreach (var pinned in _pinnedOutputs.Values)
+            {
+                pinned.Dispose();
+            }
+            _pinnedInputs.Clear();
+            _pinnedOutputs.Clear();
+        }
+
+        #endregion
+    }
+}
@@ -235,6 +235,44 @@ namespace Microsoft.ML.OnnxRuntime.Tests
         }
 
 
+        [Fact]
+        private void TestIoBindingWithPreallocatedOutput()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+            float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
+
+            using (var session = new InferenceSession(modelPath))
+            using (var ioBinding = session.CreateIoBinding())
+            {
+                var inputMeta = session.InputMetadata;
+                var inputName = inputMeta.Keys.First();
+                float[] inputData = LoadTensorFromFile(@"bench.in");
+                ioBinding.BindInput(NamedOnnxValue.CreateFromTensor<float>(inputName,
+                    new DenseTensor<float>(inputData, inputMeta[inputName].Dimensions)));
+
+                float[] outputData = new float[expectedOutput.Length];
+                ioBinding.BindOutput(NamedOnnxValue.CreateFromTensor<float>("softmaxout_1",
+                    new DenseTensor<float>(outputData, new int[] { 1, 1000, 1, 1 })));
+
+                // the runs write the output into the preallocated buffer
+                for (int i = 0; i < 2; i++)
+                {
+                    Array.Clear(outputData, 0, outputData.Length);
+                    session.Run(ioBinding);
+                    Assert.Equal(expectedOutput, outputData, new floatComparer());
+                }
+
+                using (var results = ioBinding.GetOutputValues())
+                {
+                    Assert.Equal(1, results.Count);
+                    var output = results.First();
+                    Assert.Equal("softmaxout_1", output.Name);
+                    Assert.Equal(expectedOutput, output.AsSpan<float>().ToArray(), new floatComparer());
+                    Assert.Equal(expectedOutput.Length, output.AsMemory<float>().Length);
+                }
+            }
+        }
+
         [Fact]
         private void ThrowWrongInputName()
         {
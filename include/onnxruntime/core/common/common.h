@@ -43,6 +43,8 @@
 namespace onnxruntime {
 
 using TimePoint = std::chrono::high_resolution_clock::time_point;
+// the clock of the deadlines of the runs. steady so that a change of the wall clock doesn't move them.
+using DeadlineTimePoint = std::chrono::steady_clock::time_point;
 
 // Using statements for common classes that we refer to in ONNXRuntime very often.
 // TODO(Task:137) Remove 'using' statements from header files
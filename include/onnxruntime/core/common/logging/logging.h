@@ -176,6 +176,11 @@ class LoggingManager final {
   */
   static const Logger& DefaultLogger();
 
+  /**
+     Whether a default logger is registered, for code that may run without one.
+  */
+  static bool HasDefaultLogger() { return s_default_logger_ != nullptr; }
+
   /**
      Change the minimum severity level for log messages to be output by the default logger.
      @param severity The severity.
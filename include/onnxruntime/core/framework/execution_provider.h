@@ -15,6 +15,9 @@
 namespace onnxruntime {
 class GraphViewer;
 class Node;
+namespace profiling {
+class Profiler;
+}
 }  // namespace onnxruntime
 namespace onnxruntime {
 
@@ -136,6 +139,101 @@ class IExecutionProvider {
   */
   virtual common::Status OnRunEnd();
 
+  /**
+     Returns the memory the arenas of this provider hold but don't use to the device allocators.
+     Can be called while other Runs are in progress, the memory they use is kept.
+  */
+  virtual common::Status ShrinkMemoryArenas();
+
+  /**
+     Called before and after the kernel of each node assigned to this provider while the session is profiling.
+     A provider that queues the work of its kernels on a device can time that work on the device, so that the
+     profile shows how long the node ran and not how long queuing it took, and add the events to the profiler
+     with Profiler::RecordDeviceEvent once the device completed them, without synchronizing the device.
+  */
+  virtual void StartNodeProfiling(const Node& /*node*/, profiling::Profiler& /*profiler*/) const {}
+  virtual void EndNodeProfiling(const Node& /*node*/) const {}
+
+  /**
+     Called before the profile is written. Waits for the device work timed by StartNodeProfiling and
+     EndNodeProfiling and adds the remaining events to the profiler.
+  */
+  virtual void FlushNodeProfiling() const {}
+
+  /**
+     Whether the provider can record the device work of a Run and replay it for later Runs with the same key.
+     The session only asks for it when all the nodes run on this provider and the inputs and outputs are bound to
+     device memory, so the key, which covers their names, addresses and shapes, identifies the work of a Run.
+  */
+  virtual bool IsGraphCaptureEnabled() const { return false; }
+
+  /**
+     Whether the work of the Runs with this key was recorded by an earlier Run.
+  */
+  virtual bool IsGraphCaptured(const std::string& /*key*/) const { return false; }
+
+  /**
+     Called after OnRunStart. Returns true if the provider records, instead of running, the work queued until
+     EndGraphCapture, e.g. when the key has been seen before so that the lazy initializations of the kernels are done.
+  */
+  virtual bool BeginGraphCapture(const std::string& /*key*/) { return false; }
+
+  /**
+     Ends the recording started by BeginGraphCapture and runs the recorded work. Returns an error when the work
+     could not be recorded, e.g. as a kernel waited for the device. The work of the Run then was not done, and
+     the key is not recorded again.
+     @param run_succeeded whether the kernels of the recorded Run succeeded.
+  */
+  virtual common::Status EndGraphCapture(const std::string& /*key*/, bool /*run_succeeded*/) {
+    return common::Status::OK();
+  }
+
+  /**
+     Whether a Run is between BeginGraphCapture and EndGraphCapture. The memory its frame uses stays in use by the
+     replays of the graph, so it is not reused by other Runs.
+  */
+  virtual bool IsGraphCapturing() const { return false; }
+
+  /**
+     Runs the work recorded for the key, instead of the kernels of the Run.
+  */
+  virtual common::Status ReplayGraph(const std::string& /*key*/) { return common::Status::OK(); }
+
+  /**
+     Whether the provider runs the nodes of different branches of the execution plan, see
+     SequentialExecutionPlan::node_branches, on separate device streams when the parallel executor runs them. The
+     executor then brackets the nodes of the provider with StartBranchNode and EndBranchNode, and orders the streams
+     with markers.
+  */
+  virtual bool UsesBranchStreams() const { return false; }
+
+  /**
+     Makes the calling thread queue the work of the provider on the stream of the branch until EndBranchNode, after
+     the work marked by wait_markers.
+  */
+  virtual common::Status StartBranchNode(int /*branch*/, const std::vector<void*>& /*wait_markers*/) const {
+    return common::Status::OK();
+  }
+
+  virtual common::Status EndBranchNode() const { return common::Status::OK(); }
+
+  /**
+     Marks the work queued so far on the stream of the calling thread: the branch between StartBranchNode and
+     EndBranchNode, else the stream of the provider. The marker is valid until ReleaseStreamMarker.
+  */
+  virtual common::Status RecordStreamMarker(void** marker) const {
+    *marker = nullptr;
+    return common::Status::OK();
+  }
+
+  /**
+     Makes the work queued afterwards on the stream of the calling thread wait for the marked work, e.g. to join the
+     branches at the end of a Run.
+  */
+  virtual common::Status WaitForStreamMarker(void* /*marker*/) const { return common::Status::OK(); }
+
+  virtual void ReleaseStreamMarker(void* /*marker*/) const {}
+
   void InsertAllocator(AllocatorPtr allocator);
 
   /**
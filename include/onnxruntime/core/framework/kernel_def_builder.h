@@ -64,6 +64,10 @@ class KernelDef {
     return alias_map_;
   }
 
+  const std::vector<std::pair<int, int>>& MayView() const {
+    return view_map_;
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -86,6 +90,10 @@ class KernelDef {
     return exec_queue_id_;
   }
 
+  bool AllowsPackedStringInputs() const {
+    return packed_string_inputs_;
+  }
+
   bool IsConflict(const KernelDef& other) const;
 
  private:
@@ -118,12 +126,17 @@ class KernelDef {
   // An element <i, j> means that output j is an alias of input i.
   std::vector<std::pair<int, int>> alias_map_;
 
+  // An element <i, j> means that output j may be created as a view into the buffer of input i.
+  std::vector<std::pair<int, int>> view_map_;
+
   // The memory types of inputs/outputs of this kernel
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
 
   // execution command queue id, 0 for default queue in execution provider
   int exec_queue_id_ = 0;
+  // whether the kernel reads string tensor inputs in the packed layout
+  bool packed_string_inputs_ = false;
   // Default memory type for all inputs
   OrtMemType default_inputs_mem_type_{OrtMemTypeDefault};
   // Default memory type for all outputs
@@ -201,6 +214,16 @@ class KernelDefBuilder {
   KernelDefBuilder& Alias(const std::vector<std::pair<int, int>>& aliases);
   KernelDefBuilder& Alias(int input_index, int output_index);
 
+  /**
+     View mapping from inputs to outputs. The kernel may create the output as
+     a view into part of the input buffer (see OpKernelContext::OutputView),
+     e.g. for Slice and Split, so the planner keeps the input buffer alive
+     while the output is in use. The kernel must still handle the output
+     being allocated normally. An output_index of -1 applies to all the
+     outputs, for kernels with variadic outputs.
+  */
+  KernelDefBuilder& MayView(int input_index, int output_index);
+
   /**
      Specify that this kernel requires an input arg
      in certain memory type (instead of the default, device memory).
@@ -229,6 +252,16 @@ class KernelDefBuilder {
     return *this;
   }
 
+  /**
+     Specify that this kernel reads its string tensor inputs in either layout, std::string elements or packed
+     (see Tensor::IsPackedStrings), e.g. with StringTensorReader. The producers of string tensors that are
+     only read by such kernels may create them in the packed layout, see OpKernelContext::OutputPackedStrings.
+  */
+  KernelDefBuilder& PackedStringInputs() {
+    kernel_def_->packed_string_inputs_ = true;
+    return *this;
+  }
+
   /**
   Specify the default inputs memory type, if not specified, it is DefaultMemory
   */
@@ -49,6 +49,14 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  // Called once after the kernel is created for every input that is a constant initializer.
+  // The kernel can save a transformed copy of 'tensor' (e.g. a packed GEMM weight) and use it in Compute.
+  // Set 'is_packed' to true if the copy was made. The initializer is still passed to Compute either way.
+  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) {
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
@@ -69,6 +77,14 @@ class OpKernelContext {
                            concurrency::ThreadPool* threadpool,
                            const logging::Logger& logger);
 
+  // node_offset is the offset of the node's values in the frame, as returned by IExecutionFrame::GetNodeOffset.
+  // The executors compute it once per session rather than looking it up for every node.
+  OpKernelContext(IExecutionFrame* frame,
+                  const OpKernel* kernel,
+                  int node_offset,
+                  concurrency::ThreadPool* threadpool,
+                  const logging::Logger& logger);
+
   virtual ~OpKernelContext() = default;
 
   /**
@@ -113,6 +129,27 @@ class OpKernelContext {
   // unless static optimization pre-allocates it.
   SparseTensor* Output(int index, size_t num_values, const TensorShape& shape);
 
+  /**
+  Create an output tensor as a view into the buffer of an input instead of allocating it, for kernels that
+  declare the pair with KernelDefBuilder::MayView.
+  @param index The index of the output.
+  @param input_index The index of the viewed input.
+  @param shape The shape of the output.
+  @param byte_offset The offset of the output data from the start of the input data.
+  @returns The output tensor, or nullptr if the output can't be a view (for example it's a graph output),
+  in which case Output(index, shape) has to be used.
+  */
+  Tensor* OutputView(int index, int input_index, const TensorShape& shape, size_t byte_offset);
+
+  /**
+  Fetch a string tensor output whose strings have num_chars characters in total. The output is created in the
+  packed string layout (see Tensor::IsPackedStrings) if the allocation plan allows it, that is when all the kernels
+  reading it are registered with KernelDefBuilder::PackedStringInputs, else it has std::string elements.
+  StringTensorWriter writes the strings in either layout.
+  Return nullptr if the output is an unused optional output.
+  */
+  Tensor* OutputPackedStrings(int index, const TensorShape& shape, size_t num_chars);
+
   const logging::Logger& Logger() const {
     return *logger_;
   }
@@ -138,6 +175,13 @@ class OpKernelContext {
    */
   Status GetTempSpaceAllocator(AllocatorPtr* output) const;
 
+  /**
+   * return an allocator for temporary buffers that are freed before Compute returns, e.g. the im2col buffer of Conv.
+   * it carves them from a per-Run scratch buffer when the session enables it, otherwise it is the same as
+   * GetTempSpaceAllocator. don't use it for buffers that outlive the call, like the ones cached by the kernel.
+   */
+  Status GetScratchAllocator(AllocatorPtr* output) const;
+
   /**
   Return the fence of current node's input.
   @param index The index of the input.
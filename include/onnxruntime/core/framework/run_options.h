@@ -3,8 +3,9 @@
 
 #pragma once
 
-#include <string>
 #include <atomic>
+#include <chrono>
+#include <string>
 #include "core/session/onnxruntime_c_api.h"
 
 /**
@@ -22,6 +23,20 @@ struct OrtRunOptions {
   // be forced to terminate with an error status.
   bool terminate = false;
 
+  // The Run() calls that use this instance fail once this time has passed, so a request that can't complete in time
+  // stops using the threads other requests need. It is checked before the run and before each node, including the
+  // nodes of every Loop and Scan iteration, but a running kernel is not interrupted.
+  // The default of time_point::max() means there is no deadline.
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+  // The priority of the Run() calls that use this instance on the intra op thread pool. See
+  // SessionOptions::intra_op_max_threads_by_priority to also limit the threads of a priority.
+  OrtRunPriority priority = ORT_RUN_PRIORITY_NORMAL;
+
+  // Set to 'true' to return the memory the arenas of the session hold but don't use to the system at the end of
+  // the Run() calls that use this instance. See InferenceSession::ShrinkMemoryArenas.
+  bool shrink_memory_arenas = false;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
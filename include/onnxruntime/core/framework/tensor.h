@@ -6,6 +6,7 @@
 #include <stddef.h>
 #include <iostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "gsl/gsl"
@@ -76,6 +77,22 @@ class Tensor final {
    */
   Tensor(MLDataType p_type, const TensorShape& shape, std::shared_ptr<IAllocator> allocator, int64_t offset = 0);
 
+  /**
+   * Create a string tensor in the packed layout, which keeps the characters of all the strings back to back in one
+   * buffer instead of a std::string per element. The buffer, allocated from allocator, holds shape.Size() + 1
+   * offsets, string i being the characters [offsets[i], offsets[i + 1]), followed by num_chars characters, which
+   * the strings written to the tensor fill exactly.
+   * Only the kernels registered with KernelDefBuilder::PackedStringInputs read string tensors in this layout.
+   */
+  Tensor(const TensorShape& shape, size_t num_chars, std::shared_ptr<IAllocator> allocator);
+
+  /**
+   * Create a tensor with the given shape over the strings of a tensor in the packed layout, which owns the buffer,
+   * e.g. for a kernel that reuses its input as its output with another shape.
+   * The shape must have the same number of elements.
+   */
+  Tensor(const TensorShape& shape, Tensor& packed);
+
   ~Tensor();
 
   //Move is allowed
@@ -128,6 +145,8 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    ORT_ENFORCE(!std::is_same<T, std::string>::value || !packed_strings_,
+                "The strings of the tensor are in the packed layout.");
     return reinterpret_cast<T*>(static_cast<char*>(p_data_) + byte_offset_);
   }
 
@@ -139,6 +158,8 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    ORT_ENFORCE(!std::is_same<T, std::string>::value || !packed_strings_,
+                "The strings of the tensor are in the packed layout.");
     T* data = reinterpret_cast<T*>(static_cast<char*>(p_data_) + byte_offset_);
     return gsl::make_span(data, shape_.Size());
   }
@@ -148,6 +169,8 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    ORT_ENFORCE(!std::is_same<T, std::string>::value || !packed_strings_,
+                "The strings of the tensor are in the packed layout.");
     return reinterpret_cast<const T*>(static_cast<char*>(p_data_) + byte_offset_);
   }
 
@@ -156,6 +179,8 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    ORT_ENFORCE(!std::is_same<T, std::string>::value || !packed_strings_,
+                "The strings of the tensor are in the packed layout.");
     const T* data = reinterpret_cast<const T*>(static_cast<char*>(p_data_) + byte_offset_);
     return gsl::make_span(data, shape_.Size());
   }
@@ -195,6 +220,38 @@ class Tensor final {
   */
   size_t SizeInBytes() const;
 
+  /**
+     Whether the tensor releases its buffer when it is destroyed, so that the buffer lives as long as the tensor.
+  */
+  bool OwnsBuffer() const noexcept { return buffer_deleter_ != nullptr; }
+
+  /**
+     Whether this is a string tensor in the packed layout, see the constructor taking num_chars.
+     Data<std::string> and MutableData<std::string> can't be used on it.
+  */
+  bool IsPackedStrings() const noexcept { return packed_strings_; }
+
+  /**
+     The shape.Size() + 1 offsets of the strings of a tensor in the packed layout into PackedStringChars.
+  */
+  const int64_t* PackedStringOffsets() const {
+    ORT_ENFORCE(packed_strings_, "The tensor is not in the packed string layout.");
+    return static_cast<const int64_t*>(p_data_);
+  }
+
+  int64_t* MutablePackedStringOffsets() {
+    ORT_ENFORCE(packed_strings_, "The tensor is not in the packed string layout.");
+    return static_cast<int64_t*>(p_data_);
+  }
+
+  const char* PackedStringChars() const {
+    return reinterpret_cast<const char*>(PackedStringOffsets() + shape_.Size() + 1);
+  }
+
+  char* MutablePackedStringChars() {
+    return reinterpret_cast<char*>(MutablePackedStringOffsets() + shape_.Size() + 1);
+  }
+
   // More API methods.
  private:
   void Init(MLDataType p_type,
@@ -217,6 +274,8 @@ class Tensor final {
   const PrimitiveDataTypeBase* dtype_;
   OrtMemoryInfo alloc_info_;
   int64_t byte_offset_;
+  // whether the buffer holds the strings in the packed layout instead of std::string elements
+  bool packed_strings_{false};
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -5,6 +5,9 @@
 #include <iosfwd>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include <string>
 #include <cstring>
 #include "onnxruntime_config.h"
@@ -16,45 +19,116 @@ namespace onnxruntime {
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 #endif
 #endif
-class TensorShape : private std::vector<int64_t> {
-  // TODO - Use a custom STL allocator to avoid heap allocations in the common case.
+/**
+   Read-only view of a sequence of dimensions, e.g. the ones of a TensorShape returned by TensorShape::GetDims.
+   It is valid as long as the dimensions it views are alive and not resized, and it converts to a
+   std::vector<int64_t> for the callers that need a copy of them.
+*/
+class TensorShapeDims {
+ public:
+  using value_type = int64_t;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const int64_t*;
+  using const_pointer = const int64_t*;
+  using reference = const int64_t&;
+  using const_reference = const int64_t&;
+  using iterator = const int64_t*;
+  using const_iterator = const int64_t*;
+  using reverse_iterator = std::reverse_iterator<const_iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  TensorShapeDims() = default;
+
+  TensorShapeDims(const int64_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  TensorShapeDims(const std::vector<int64_t>& dims) noexcept : data_(dims.data()), size_(dims.size()) {}
+
+  const int64_t* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  const int64_t& operator[](size_t idx) const { return data_[idx]; }
+
+  const int64_t& at(size_t idx) const {
+    if (idx >= size_) throw std::out_of_range("TensorShapeDims index out of range");
+    return data_[idx];
+  }
+
+  const int64_t& front() const { return data_[0]; }
+  const int64_t& back() const { return data_[size_ - 1]; }
+
+  const_iterator begin() const noexcept { return data_; }
+  const_iterator end() const noexcept { return data_ + size_; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  operator std::vector<int64_t>() const { return std::vector<int64_t>(begin(), end()); }
+
+  friend bool operator==(const TensorShapeDims& lhs, const TensorShapeDims& rhs) noexcept {
+    return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+  friend bool operator!=(const TensorShapeDims& lhs, const TensorShapeDims& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  const int64_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+class TensorShape {
   // We use negative numbers for unknown symbolic dimension. Each negative
   // number represents a unique symbolic dimension.
-  // Private inheritance is used to prevent ambiguity of element versus dimension size
+  // The dimensions of a shape of up to kInlineDims dimensions are stored in the shape itself, so that creating
+  // and copying the shape of a tensor does not allocate in the common case.
  public:
+  static constexpr size_t kInlineDims = 5;
+
   TensorShape() = default;
 
   TensorShape(const TensorShape& /*other*/) = default;
   TensorShape& operator=(const TensorShape& /*other*/) = default;
 
-  TensorShape(TensorShape&& /*other*/) = default;
-  TensorShape& operator=(TensorShape&& /*other*/) = default;
+  TensorShape(TensorShape&& other) noexcept { *this = std::move(other); }
+
+  TensorShape& operator=(TensorShape&& other) noexcept {
+    num_dims_ = other.num_dims_;
+    memcpy(inline_dims_, other.inline_dims_, sizeof(inline_dims_));
+    heap_dims_ = std::move(other.heap_dims_);
+    other.num_dims_ = 0;
+    other.heap_dims_.clear();
+    return *this;
+  }
 
-  TensorShape(const std::vector<int64_t>& dims) : std::vector<int64_t>(dims) {}
+  TensorShape(const std::vector<int64_t>& dims) : TensorShape(dims.data(), dims.size()) {}
 
-  TensorShape(std::vector<int64_t>&& dims) : std::vector<int64_t>(std::move(dims)) {}
+  TensorShape(std::vector<int64_t>&& dims);
 
-  TensorShape(const std::initializer_list<int64_t>& dims) : std::vector<int64_t>(dims) {}
+  TensorShape(const std::initializer_list<int64_t>& dims) : TensorShape(dims.begin(), dims.size()) {}
 
   TensorShape(const int64_t* dimension_sizes, size_t dimension_count);
 
+  explicit TensorShape(TensorShapeDims dims) : TensorShape(dims.data(), dims.size()) {}
+
   TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end);
 
   /**
      Return the dimension specified by <idx>.
   */
   const int64_t& operator[](size_t idx) const {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return Data()[idx];
   }
 
   int64_t& operator[](size_t idx) {
-    return std::vector<int64_t>::operator[](static_cast<int>(idx));
+    return Data()[idx];
   }
 
   bool operator==(const TensorShape& other) const noexcept {
-    auto thisVector = static_cast<const std::vector<int64_t>*>(this);
-    auto otherVector = static_cast<const std::vector<int64_t>*>(&other);
-    return *thisVector == *otherVector;
+    return GetDims() == other.GetDims();
   }
 
   bool operator!=(const TensorShape& other) const noexcept {
@@ -62,20 +136,26 @@ class TensorShape : private std::vector<int64_t> {
   }
 
   size_t NumDimensions() const noexcept {
-    return size();
+    return num_dims_;
   }
 
   /**
      Copy dims into an array with given size
   */
   void CopyDims(int64_t* dims, size_t num_dims) const {
-    memcpy(dims, data(), sizeof(value_type) * std::min(num_dims, NumDimensions()));
+    memcpy(dims, Data(), sizeof(int64_t) * std::min(num_dims, NumDimensions()));
   }
 
   /**
-     Return underlying vector representation.
+     Return a view of the dimensions. It is returned const, so that the callers that bind it to an auto& keep
+     compiling, and converts to a std::vector<int64_t> where a copy is needed.
+  */
+  const TensorShapeDims GetDims() const { return TensorShapeDims(Data(), num_dims_); }
+
+  /**
+     Return a copy of the dimensions.
   */
-  const std::vector<int64_t>& GetDims() const { return *this; }
+  std::vector<int64_t> GetDimsAsVector() const { return std::vector<int64_t>(Data(), Data() + num_dims_); }
 
   /**
    * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
@@ -125,14 +205,18 @@ class TensorShape : private std::vector<int64_t> {
      empty shape or 1D shape (1) is regarded as scalar tensor
   */
   bool IsScalar() const {
-    size_t len = size();
+    size_t len = num_dims_;
     return len == 0 || (len == 1 && operator[](0) == 1);
   }
 
-  static const TensorShape& ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
-    static_assert(sizeof(TensorShape) == sizeof(std::vector<int64_t>), "Size of TensorShape prevents safe casting from vector");
-    return *static_cast<const TensorShape*>(&dimensions);
-  }
+ private:
+  const int64_t* Data() const noexcept { return num_dims_ <= kInlineDims ? inline_dims_ : heap_dims_.data(); }
+  int64_t* Data() noexcept { return num_dims_ <= kInlineDims ? inline_dims_ : heap_dims_.data(); }
+
+  size_t num_dims_ = 0;
+  int64_t inline_dims_[kInlineDims]{};
+  // the dimensions of a shape with more than kInlineDims dimensions
+  std::vector<int64_t> heap_dims_;
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
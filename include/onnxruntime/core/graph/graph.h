@@ -458,6 +458,11 @@ class Node {
   // Map of attribute name to the Graph instance created from the GraphProto attribute
   std::unordered_map<std::string, gsl::not_null<Graph*>> attr_to_subgraph_map_;
 
+  // The input, implicit input and output defs this node was last type/shape inferred with. Graph::Resolve
+  // repeats the inferencing of the node only if these, the types of the defs or the attributes have changed.
+  std::vector<const NodeArg*> inferred_defs_;
+  bool inference_needed_ = true;
+
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
 };
@@ -620,6 +625,12 @@ class Graph {
     return *(result.first->second);
   }
 
+  /** Replaces the type of an existing NodeArg, e.g. when a transformer changes the Node that produces a graph output
+  to one that produces a different type. Any shape the NodeArg had is replaced by the shape in type_proto. */
+  void SetNodeArgType(NodeArg& node_arg, const ONNX_NAMESPACE::TypeProto& type_proto) {
+    node_arg.SetType(type_proto);
+  }
+
   /** Generate a unique name.in this Graph for a NodeArg */
   std::string GenerateNodeArgName(const std::string& base_name);
 
@@ -932,6 +943,15 @@ class Graph {
   // information matches between node and op.
   common::Status VerifyNodeAndOpMatch();
 
+  // Returns true if the node, its defs or their types changed since it was last type/shape inferred.
+  static bool NodeInferenceNeeded(const Node& node);
+
+  // Record the defs the node was type/shape inferred with.
+  static void RecordNodeInference(Node& node);
+
+  // Mark the NodeArg of an initializer as changed after its value changed.
+  void MarkInitializerChanged(const std::string& name);
+
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
@@ -992,6 +1012,10 @@ class Graph {
 
   bool graph_proto_sync_needed_ = false;
 
+  // The NodeProtos of <graph_proto_> were released once the Nodes were created from them,
+  // so they need to be regenerated from the Nodes by ToGraphProto.
+  bool node_protos_released_ = false;
+
   // The topological order of node index used to do node and op match verification temporarily.
   std::vector<NodeIndex> nodes_in_topological_order_;
 
@@ -98,5 +98,9 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Set when the type or shape changes, so Graph::Resolve repeats the type/shape inferencing of the nodes
+  // that produce or consume <*this> node arg. Cleared by the Graph once it has done so.
+  bool type_changed_ = true;
 };
 }  // namespace onnxruntime
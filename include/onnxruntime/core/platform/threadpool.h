@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <functional>
@@ -25,6 +30,73 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+/**
+ * Eigen thread environment that restricts the threads it creates to a set of logical processors.
+ */
+struct ThreadEnvironment : Eigen::StlThreadEnvironment {
+  ThreadEnvironment() = default;
+  explicit ThreadEnvironment(std::vector<int> cpu_affinity) : cpu_affinity_(std::move(cpu_affinity)) {}
+
+  EnvThread* CreateThread(std::function<void()> f);
+
+ private:
+  std::vector<int> cpu_affinity_;
+};
+
+/**
+ * Utilization of the parallel loops run by a thread pool, collected for the loops started by a thread while a
+ * ParallelForStatsScope is active on it.
+ */
+struct ParallelForStats {
+  uint64_t num_calls = 0;
+  // summed over the calls: the threads that ran at least one block, and the threads that could have
+  uint64_t num_threads_used = 0;
+  uint64_t num_threads_available = 0;
+  // the helpers taken by pool threads spinning for work after an earlier loop, instead of being scheduled
+  uint64_t num_helpers_to_spinning_threads = 0;
+};
+
+// Collects the stats of the parallel loops started by the current thread into stats until destroyed.
+// nullptr stops the collection within the scope.
+class ParallelForStatsScope {
+ public:
+  explicit ParallelForStatsScope(ParallelForStats* stats);
+  ~ParallelForStatsScope();
+
+ private:
+  ParallelForStats* const previous_;
+};
+
+/**
+ * Priority of the parallel loops started by a thread while a ThreadPoolPriorityScope is active on it.
+ * The helper threads of a loop stop claiming its blocks while a loop of a higher priority runs on the same pool,
+ * which leaves the pool threads to the higher priority loop. The calling thread always runs the blocks no helper
+ * claimed, so every loop completes.
+ */
+enum class ThreadPoolPriority : int {
+  kHigh = 0,
+  kNormal = 1,
+  kLow = 2,
+};
+
+constexpr int kNumThreadPoolPriorities = 3;
+
+// Sets the priority of the parallel loops started by the current thread until destroyed. If max_threads > 0 the
+// loops also use at most max_threads threads, including the calling thread. Without a scope the loops have
+// kNormal priority and no limit.
+class ThreadPoolPriorityScope {
+ public:
+  explicit ThreadPoolPriorityScope(ThreadPoolPriority priority, int max_threads = 0);
+  ~ThreadPoolPriorityScope();
+
+  static ThreadPoolPriority CurrentPriority();
+  static int CurrentMaxThreads();
+
+ private:
+  const ThreadPoolPriority previous_priority_;
+  const int previous_max_threads_;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
@@ -33,8 +105,18 @@ class ThreadPool {
  public:
   /*
   Initializes a thread pool given the current environment.
+  allow_spinning: worker threads spin briefly looking for work before blocking. Disable it when throughput
+                  across many concurrent sessions matters more than the latency of individual ops.
+  spin_duration_us: how long a thread waiting for ParallelFor work to complete spins/yields before blocking, and
+                    how long a pool thread that ran the blocks of a loop spins/yields for the next loop before
+                    parking, in place of the fixed spin of allow_spinning. 0 blocks immediately and keeps the
+                    fixed spin of the pool threads.
+  cpu_affinity: logical processors the pool threads are restricted to. Empty means no restriction.
   */
-  ThreadPool(const std::string& name, int num_threads);
+  ThreadPool(const std::string& name, int num_threads, bool allow_spinning = true, int spin_duration_us = 0,
+             const std::vector<int>& cpu_affinity = {});
+
+  ~ThreadPool();
 
   /*
   Enqueue a unit of work.
@@ -56,6 +138,14 @@ class ThreadPool {
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Schedule work in the interval [0, total), with fn called on sub-ranges [first, last).
+  cost_per_unit is the estimated number of CPU cycles to process one unit of work. It is used to pick the
+  block size, and to run the work on the calling thread if it's too small to benefit from parallelization.
+  */
+  void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
@@ -96,14 +186,54 @@ class ThreadPool {
     }
   }
 
+  /**
+  Tries to call the given function in parallel, with fn called on sub-ranges [first, last) of [0, total).
+  See ParallelFor for the meaning of cost_per_unit.
+  **/
+  template <typename F>
+  inline static void TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
+                                    F&& fn) {
+    if (tp != nullptr) {
+      tp->ParallelFor(total, cost_per_unit, std::forward<F>(fn));
+    } else if (total > 0) {
+      fn(0, total);
+    }
+  }
+
   int NumThreads() const;
 
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler() { return impl_; }
 
  private:
-  Eigen::ThreadPool impl_;
+  // Run block_fn for each block index in [0, num_blocks). The calling thread and up to NumThreads() workers
+  // claim blocks from a shared counter until all are done, so load is balanced without per-block tasks.
+  void RunBlocks(std::ptrdiff_t num_blocks, const std::function<void(std::ptrdiff_t)>& block_fn);
+
+  // Whether a loop with helpers of a higher priority than 'priority' is running
+  bool HasHigherPriorityLoops(int priority) const;
+
+  // Queues a helper of a loop for a pool thread spinning in SpinForWork. Returns false if no thread is free.
+  bool HandToSpinningThread(const std::function<void()>& helper);
+
+  // Called by a pool thread after the helper of a loop. Spins/yields for spin_duration_us_ running the helpers
+  // handed to it, so that the next loops of an op don't wait for parked threads to wake up.
+  void SpinForWork();
+
+  const bool allow_spinning_;
+  const int spin_duration_us_;
+  // the helpers handed to spinning threads, never more than the threads spinning. both only change under
+  // spin_mutex_, the atomics are read without it while spinning. declared before impl_, which joins the threads
+  // using them when it is destroyed.
+  std::mutex spin_mutex_;
+  std::deque<std::function<void()>> spin_helpers_;
+  std::atomic<int> num_spin_helpers_{0};
+  std::atomic<int> num_spinning_threads_{0};
+  std::atomic<bool> stop_spinning_{false};
+  Eigen::ThreadPoolTempl<ThreadEnvironment> impl_;
+  // the running loops with helpers, by priority
+  std::atomic<int> active_loops_[kNumThreadPoolPriorities];
 };
 
 }  // namespace concurrency
@@ -12,6 +12,15 @@ extern "C" {
  */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_CUDA, with the kernels and copies of the provider queued on a stream
+ * of the application, so that the work the application queues on it before and after a Run is ordered with the Run
+ * without synchronizing. The stream must outlive the sessions created with the options.
+ * \param compute_stream the cudaStream_t to use.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream, _In_ OrtSessionOptions* options,
+               int device_id, _In_ void* compute_stream);
+
 #ifdef __cplusplus
 }
 #endif
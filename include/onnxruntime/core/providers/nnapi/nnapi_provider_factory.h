@@ -1,15 +1,36 @@
 // Copyright 2019 JD.com Inc. JD AI
 
+#pragma once
+
 #include "onnxruntime_c_api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+enum NNAPIFlags {
+  NNAPI_FLAG_USE_NONE = 0x000,
+
+  // Allow float32 to be computed with the range and precision of float16 by the NNAPI devices
+  // (ANeuralNetworksModel_relaxComputationFloat32toFloat16). Faster on most GPUs and DSPs.
+  NNAPI_FLAG_USE_FP16 = 0x001,
+
+  // Keep the compiled NNAPI models in the process and reuse them in the sessions created again for the
+  // same model, so creating them doesn't compile the model again.
+  NNAPI_FLAG_CACHE_COMPILATION = 0x002,
+};
+
+/**
+ * Same as OrtSessionOptionsAppendExecutionProvider_NnapiWithFlags with NNAPI_FLAG_USE_FP16
+ */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSessionOptions* options);
 
+/**
+ * \param nnapi_flags NNAPIFlags combined with bitwise OR
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_NnapiWithFlags, _In_ OrtSessionOptions* options,
+               uint32_t nnapi_flags);
+
 #ifdef __cplusplus
 }
 #endif
-
-
@@ -9,6 +9,20 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class SharedInitializerStore;
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+   Configures the thread pools an environment shares between its sessions.
+   A number of threads of 0 uses the default, which is the same as the default of a per session thread pool.
+*/
+struct ThreadingOptions {
+  int intra_op_num_threads = 0;
+  int inter_op_num_threads = 0;
+};
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -20,6 +34,12 @@ class Environment {
   */
   static Status Create(std::unique_ptr<Environment>& environment);
 
+  /**
+     Create and initialize the runtime environment with intra op and inter op thread pools that are used by the
+     sessions created with SessionOptions::use_per_session_threads set to false.
+  */
+  static Status Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& tp_options);
+
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
   */
@@ -30,12 +50,38 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns the store sessions created in this environment use to share identical initializers
+     when SessionOptions::share_initializers_across_sessions is set.
+  */
+  const std::shared_ptr<SharedInitializerStore>& GetSharedInitializerStore() const {
+    return shared_initializer_store_;
+  }
+
+  /**
+     Returns whether the environment was created with global thread pools.
+  */
+  bool CreatedGlobalThreadPools() const { return create_global_thread_pools_; }
+
+  /**
+     Returns the thread pools shared by the sessions that don't use per session threads. The intra op thread pool
+     is nullptr if it was configured with a single thread, in which case the ops run on the calling thread.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_.get(); }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_.get(); }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
   Environment() = default;
-  Status Initialize();
+  Status Initialize(const ThreadingOptions* tp_options);
 
   static std::atomic<bool> is_initialized_;
+
+  std::shared_ptr<SharedInitializerStore> shared_initializer_store_;
+
+  bool create_global_thread_pools_ = false;
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
 };
 }  // namespace onnxruntime
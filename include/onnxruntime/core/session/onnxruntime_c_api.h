@@ -7,7 +7,7 @@
 #include <string.h>
 
 // This value is used in structures passed to ORT so that a newer version of ORT will still work with
-#define ORT_API_VERSION 1
+#define ORT_API_VERSION 2
 
 #ifdef __cplusplus
 extern "C" {
@@ -156,6 +156,9 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(PreparedRun);
+ORT_RUNTIME_CLASS(IoBinding);
+ORT_RUNTIME_CLASS(ThreadingOptions);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -185,10 +188,30 @@ typedef enum ExecutionMode {
   ORT_PARALLEL = 1,
 } ExecutionMode;
 
+// The arena of the CPU allocations of a session. ORT_ARENA_BACKEND_DEFAULT is mimalloc in a build with mimalloc
+// enabled and BFC otherwise.
+typedef enum OrtArenaBackend {
+  ORT_ARENA_BACKEND_DEFAULT = 0,
+  ORT_ARENA_BACKEND_BFC = 1,
+  ORT_ARENA_BACKEND_MIMALLOC = 2,
+} OrtArenaBackend;
+
+// The priority of a run on the intra op thread pool. While a run is in a parallel loop, the threads of the pool
+// stop helping the loops of runs with a lower priority.
+typedef enum OrtRunPriority {
+  ORT_RUN_PRIORITY_HIGH = 0,
+  ORT_RUN_PRIORITY_NORMAL = 1,
+  ORT_RUN_PRIORITY_LOW = 2,
+} OrtRunPriority;
+
 struct OrtKernelInfo;
 typedef struct OrtKernelInfo OrtKernelInfo;
 struct OrtKernelContext;
 typedef struct OrtKernelContext OrtKernelContext;
+struct OrtShapeInferContext;
+typedef struct OrtShapeInferContext OrtShapeInferContext;
+// The work of a custom op kernel that KernelContext_ParallelFor calls for each index
+typedef void(ORT_API_CALL* OrtParallelForFunc)(void* user_data, size_t index);
 struct OrtCustomOp;
 typedef struct OrtCustomOp OrtCustomOp;
 
@@ -646,6 +669,286 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  // Share constant CPU initializers with the other sessions created with the same OrtEnv.
+  // Initializers with the same type, shape and content, including the ones created by graph optimizations,
+  // are then allocated once for all of these sessions.
+  OrtStatus*(ORT_API_CALL* EnableSharedInitializers)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableSharedInitializers)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Run batch_size independent requests with the same input and output names in one call, which amortizes the
+   * per call setup of Run. The requests are spread across the inter-op thread pool if the session uses
+   * ORT_PARALLEL execution mode.
+   * \param input batch_size * input_len values, the inputs of the first request followed by the ones of the second...
+   * \param output batch_size * output_names_len values laid out like input. As for Run, an entry that is nullptr is
+   *   allocated by onnxruntime and must be released with OrtReleaseValue.
+   */
+  OrtStatus*(ORT_API_CALL* RunBatch)(_Inout_ OrtSession* sess,
+                                     _In_opt_ const OrtRunOptions* run_options,
+                                     _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                                     _In_ const char* const* output_names, size_t output_names_len,
+                                     size_t batch_size, _Inout_ OrtValue** output)NO_EXCEPTION;
+
+  /**
+   * Resolve the input and output names once for repeated calls to RunPrepared with the same names.
+   * Calls to RunPrepared with the same OrtPreparedRun are serialized, so use one per thread to run concurrently.
+   * It must be released before the session.
+   */
+  OrtStatus*(ORT_API_CALL* CreatePreparedRun)(_In_ const OrtSession* sess,
+                                              _In_ const char* const* input_names, size_t input_len,
+                                              _In_ const char* const* output_names, size_t output_names_len,
+                                              _Outptr_ OrtPreparedRun** out)NO_EXCEPTION;
+
+  /**
+   * Like Run, with the inputs and outputs in the order of the names given to CreatePreparedRun.
+   */
+  OrtStatus*(ORT_API_CALL* RunPrepared)(_Inout_ OrtSession* sess,
+                                        _In_opt_ const OrtRunOptions* run_options,
+                                        _Inout_ OrtPreparedRun* prepared_run,
+                                        _In_ const OrtValue* const* input, size_t input_len,
+                                        _Inout_ OrtValue** output, size_t output_len)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /**
+   * Record the per node kernel time, output size and intra op thread pool use of one in every sampling_interval
+   * runs with the always-on lightweight profiler. 0 disables it.
+   */
+  OrtStatus*(ORT_API_CALL* SetLightweightProfilingSamplingInterval)(_Inout_ OrtSessionOptions* options,
+                                                                    uint32_t sampling_interval)NO_EXCEPTION;
+
+  /**
+   * Get the statistics of the runs sampled by the lightweight profiler as a JSON object with the per op type
+   * statistics under "ops" and the per node ones under "nodes". Nothing is written to a file.
+   * \param out a null terminated string allocated with allocator
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetProfilingStatistics)(_In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                                                          _Outptr_ char** out)NO_EXCEPTION;
+
+  /**
+   * Get the bytes in use and the peak bytes in use of the arena allocators of the session's execution providers.
+   * Allocators that don't use an arena are not counted.
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetArenaMemoryUsage)(_In_ const OrtSession* sess, _Out_ int64_t* bytes_in_use,
+                                                       _Out_ int64_t* max_bytes_in_use)NO_EXCEPTION;
+
+  /**
+   * Get the statistics of each arena allocator of the session's execution providers as a JSON object:
+   * {"allocators": [{"name", "id", "mem_type", "num_allocs", "bytes_in_use", "max_bytes_in_use",
+   * "total_allocated_bytes", "max_alloc_size", "bytes_limit"}, ...]}
+   * \param out a null terminated string allocated with allocator
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetMemoryStatistics)(_In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                                                       _Outptr_ char** out)NO_EXCEPTION;
+
+  /**
+   * Get the largest peak bytes of the intermediate and output tensors allocated by a single Run of the session.
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetPeakActivationBytes)(_In_ const OrtSession* sess,
+                                                          _Out_ int64_t* out)NO_EXCEPTION;
+
+  /**
+   * Create a binding of inputs and outputs for repeated calls to RunWithBinding. It must be released before the
+   * session.
+   */
+  OrtStatus*(ORT_API_CALL* CreateIoBinding)(_Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out)NO_EXCEPTION;
+
+  /**
+   * Bind an input to a value. If the value isn't on the device of the node using the input it is copied there now,
+   * otherwise the binding uses it without copying, so it must outlive the runs. Binding a name again replaces it.
+   */
+  OrtStatus*(ORT_API_CALL* BindInput)(_Inout_ OrtIoBinding* binding, _In_ const char* name,
+                                      _In_ const OrtValue* val)NO_EXCEPTION;
+
+  /**
+   * Bind an output to a preallocated value the runs write to, so it must outlive them. Binding a name again
+   * replaces it.
+   */
+  OrtStatus*(ORT_API_CALL* BindOutput)(_Inout_ OrtIoBinding* binding, _In_ const char* name,
+                                       _In_ const OrtValue* val)NO_EXCEPTION;
+
+  /**
+   * Bind an output to the device of an allocator of the session without preallocating it. The runs allocate it from
+   * a buffer owned by the binding, which only grows when an output is larger than the previous ones. The value
+   * returned by GetBoundOutputValues is overwritten by the next run.
+   */
+  OrtStatus*(ORT_API_CALL* BindOutputToDevice)(_Inout_ OrtIoBinding* binding, _In_ const char* name,
+                                               _In_ const OrtMemoryInfo* mem_info)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* GetBoundOutputCount)(_In_ const OrtIoBinding* binding, _Out_ size_t* out)NO_EXCEPTION;
+
+  /**
+   * Get the outputs of the last run in the order they were bound.
+   * \param output output_len values, which must be released with OrtReleaseValue. They share the memory of the
+   *   outputs of the binding.
+   */
+  OrtStatus*(ORT_API_CALL* GetBoundOutputValues)(_In_ const OrtIoBinding* binding, _Outptr_ OrtValue** output,
+                                                 size_t output_len)NO_EXCEPTION;
+
+  /**
+   * Run with the inputs and outputs of a binding.
+   */
+  OrtStatus*(ORT_API_CALL* RunWithBinding)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                           _Inout_ OrtIoBinding* binding)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(IoBinding);
+
+  /**
+   * Return the memory the arenas of the session's execution providers hold but don't use to the system, e.g. after
+   * a spike of large inputs. Runs in progress keep the memory they use.
+   */
+  OrtStatus*(ORT_API_CALL* SessionShrinkMemoryArenas)(_Inout_ OrtSession* sess)NO_EXCEPTION;
+
+  /**
+   * Shrink the memory arenas of the session at the end of the runs that use these options.
+   * \param shrink 1 to shrink, 0 not to (default)
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetShrinkMemoryArenas)(_Inout_ OrtRunOptions* options, int shrink)NO_EXCEPTION;
+
+  /**
+   * Shrink the memory arenas of the session from a background thread once no run was in progress for idle_ms
+   * milliseconds. 0 disables it (default).
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionArenaIdleShrinkTime)(_Inout_ OrtSessionOptions* options,
+                                                         int64_t idle_ms)NO_EXCEPTION;
+
+  // Select the arena of the CPU allocations. Ignored when the CPU arena is disabled.
+  OrtStatus*(ORT_API_CALL* SetSessionCpuArenaBackend)(_Inout_ OrtSessionOptions* options,
+                                                     OrtArenaBackend backend)NO_EXCEPTION;
+
+  /**
+   * Load the large constant initializers of control flow subgraphs (e.g. If branches) when the subgraph first runs
+   * instead of when the session is created.
+   * \param defer 1 to defer, 0 not to (default)
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionDeferSubgraphInitializers)(_Inout_ OrtSessionOptions* options,
+                                                               int defer)NO_EXCEPTION;
+
+  /**
+   * The number of threads, including the calling thread, that KernelContext_ParallelFor runs the work of a custom op
+   * kernel on. It is 1 if the session has no intra-op thread pool.
+   */
+  OrtStatus*(ORT_API_CALL* KernelContext_GetThreadCount)(_In_ const OrtKernelContext* context,
+                                                        _Out_ size_t* out)NO_EXCEPTION;
+
+  /**
+   * Call fn(user_data, i) for each i in [0, total) on the intra-op thread pool of the session and wait for the calls
+   * to complete, so a custom op kernel doesn't start threads that compete with the pool.
+   * \param num_batches the number of batches the calls are split into, 0 for one per thread
+   * fn must not throw.
+   */
+  OrtStatus*(ORT_API_CALL* KernelContext_ParallelFor)(_In_ const OrtKernelContext* context, _In_ OrtParallelForFunc fn,
+                                                     _In_opt_ void* user_data, size_t total,
+                                                     size_t num_batches)NO_EXCEPTION;
+
+  /**
+   * Allocate a temporary buffer of a custom op kernel, which must be freed by KernelContext_FreeScratch before the
+   * kernel returns. It is carved from the per-Run scratch buffer when the session enables it, else it is allocated
+   * by the allocator of the kernel's execution provider.
+   */
+  OrtStatus*(ORT_API_CALL* KernelContext_AllocateScratch)(_Inout_ OrtKernelContext* context, size_t size,
+                                                         _Outptr_ void** out)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* KernelContext_FreeScratch)(_Inout_ OrtKernelContext* context, _In_ void* p)NO_EXCEPTION;
+
+  /**
+   * Access the inputs and outputs of a node in the InferOutputShapes callback of a custom op.
+   * ShapeInferContext_GetInputTypeShape returns nullptr if the type or shape of the input is unknown, else the
+   * info must be released with ReleaseTensorTypeAndShapeInfo. Unknown dims are -1, with the symbolic dims returned
+   * by GetSymbolicDimensions.
+   * ShapeInferContext_SetOutputTypeShape sets the output to the element type and dims of info, with the dims of
+   * -1 set to the symbolic dims of info.
+   */
+  OrtStatus*(ORT_API_CALL* ShapeInferContext_GetInputCount)(_In_ const OrtShapeInferContext* context,
+                                                           _Out_ size_t* out)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* ShapeInferContext_GetInputTypeShape)(_In_ const OrtShapeInferContext* context,
+                                                               size_t index,
+                                                               _Outptr_ OrtTensorTypeAndShapeInfo** out)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* ShapeInferContext_SetOutputTypeShape)(_Inout_ OrtShapeInferContext* context, size_t index,
+                                                                _In_ const OrtTensorTypeAndShapeInfo* info)NO_EXCEPTION;
+
+  /**
+   * Create an env with intra op and inter op thread pools that are shared by all the sessions created with
+   * per session threads disabled, so the number of threads doesn't grow with the number of sessions.
+   * The env is a singleton, so tp_options is only used if no env exists yet. The sessions using the global thread
+   * pools must be released before the env.
+   * \param tp_options configures the global thread pools. A number of threads of 0 uses the default.
+   * \param out Should be freed by `OrtReleaseEnv` after use
+   */
+  OrtStatus*(ORT_API_CALL* CreateEnvWithGlobalThreadPools)(OrtLoggingLevel default_logging_level,
+                                                          _In_ const char* logid,
+                                                          _In_ const OrtThreadingOptions* tp_options,
+                                                          _Outptr_ OrtEnv** out)NO_EXCEPTION;
+
+  // Use the global thread pools of the env instead of creating thread pools for the session. The thread pool
+  // options of the session options are then not used.
+  OrtStatus*(ORT_API_CALL* DisablePerSessionThreads)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* CreateThreadingOptions)(_Outptr_ OrtThreadingOptions** out)NO_EXCEPTION;
+  ORT_CLASS_RELEASE(ThreadingOptions);
+  OrtStatus*(ORT_API_CALL* SetGlobalIntraOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options,
+                                                      int intra_op_num_threads)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* SetGlobalInterOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options,
+                                                      int inter_op_num_threads)NO_EXCEPTION;
+
+  /**
+   * Set the deadline of the runs that use these options to timeout_us microseconds from now. A run fails once its
+   * deadline has passed: it is checked when the run starts and before each node, including the nodes of Loop and
+   * Scan iterations. A running kernel is not interrupted.
+   * \param timeout_us 0 removes the deadline (default)
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetDeadline)(_Inout_ OrtRunOptions* options, int64_t timeout_us)NO_EXCEPTION;
+
+  /**
+   * Set the priority of the runs that use these options on the intra op thread pool. The default is
+   * ORT_RUN_PRIORITY_NORMAL.
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetPriority)(_Inout_ OrtRunOptions* options, OrtRunPriority priority)NO_EXCEPTION;
+
+  /**
+   * Limit the intra op threads, including the thread calling Run, that a parallel loop of a run with the given
+   * priority uses, e.g. to keep some cores free for the high priority runs. 0 removes the limit (default).
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionRunPriorityMaxThreads)(_Inout_ OrtSessionOptions* options,
+                                                           OrtRunPriority priority, int max_threads)NO_EXCEPTION;
+
+  /**
+   * Back the CPU device allocations of at least threshold_bytes with huge pages, i.e. the regions the CPU arena
+   * extends by and the buffers of the initializers. The allocations huge pages can't be had for use small pages.
+   * \param threshold_bytes 0 disables it (default)
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionCpuHugePageThreshold)(_Inout_ OrtSessionOptions* options,
+                                                          size_t threshold_bytes)NO_EXCEPTION;
+
+  /**
+   * Like RunWithBinding, but returns once the work is queued on the devices instead of when it is done, e.g. to
+   * pipeline it with the work of the application on the stream given to
+   * OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream. All the outputs must be bound to device memory.
+   */
+  OrtStatus*(ORT_API_CALL* RunAsync)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                     _Inout_ OrtIoBinding* binding)NO_EXCEPTION;
+
+  /**
+   * Coalesce concurrent Runs of the session with compatible inputs into single runs along dim 0 of the inputs, which
+   * must be a free or DATA_BATCH denoted dimension of all the model inputs.
+   * \param max_batch_size the most rows of a coalesced run. 0 or 1 disables it (default).
+   * \param timeout_us how long the first Run of a batch waits for other Runs to join it
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionDynamicBatching)(_Inout_ OrtSessionOptions* options, int64_t max_batch_size,
+                                                      int64_t timeout_us)NO_EXCEPTION;
+
+  /**
+   * Get the counters of the dynamic batching of the session. They are 0 if it's not enabled for the session.
+   * \param requests the Runs that went through the batching path
+   * \param batches the coalesced runs of those Runs
+   * \param unbatched_requests the Runs that could not be batched, e.g. as their inputs are not batch-major tensors
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetDynamicBatchingStats)(_In_ const OrtSession* sess, _Out_ uint64_t* requests,
+                                                           _Out_ uint64_t* batches,
+                                                           _Out_ uint64_t* unbatched_requests)NO_EXCEPTION;
 };
 
 /*
@@ -681,6 +984,24 @@ struct OrtCustomOp {
   // Op kernel callbacks
   void(ORT_API_CALL* KernelCompute)(_In_ void* op_kernel, _In_ OrtKernelContext* context);
   void(ORT_API_CALL* KernelDestroy)(_In_ void* op_kernel);
+
+  // The callbacks below are only read if version is at least 2, and each may be nullptr.
+
+  // Infers the output shapes of a node from its inputs when the model is loaded, so the memory planner can size and
+  // reuse the buffers of the outputs. The output element types are set from GetOutputType before it is called.
+  OrtStatus*(ORT_API_CALL* InferOutputShapes)(_In_ struct OrtCustomOp* op, _Inout_ OrtShapeInferContext* context);
+
+  // Returns the index of an input whose buffer the output may reuse if no other node uses the input, or -1
+  int(ORT_API_CALL* GetMayInplace)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
+
+  // Returns the index of an input whose buffer the output always shares, e.g. for an op that only changes the shape,
+  // or -1
+  int(ORT_API_CALL* GetAlias)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
+
+  // Called once for each constant input of the kernel when the session is initialized, so the kernel can pack it
+  // before the first run. The input is only valid during the call. Set is_packed to 1 if the kernel packed it.
+  OrtStatus*(ORT_API_CALL* KernelPrePack)(_In_ void* op_kernel, _In_ const OrtValue* input, _In_ size_t input_index,
+                                          _Out_ int* is_packed);
 };
 
 /*
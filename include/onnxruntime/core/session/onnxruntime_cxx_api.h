@@ -71,6 +71,9 @@ ORT_DEFINE_RELEASE(SessionOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
 ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
+ORT_DEFINE_RELEASE(PreparedRun);
+ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(ThreadingOptions);
 
 // This is used internally by the C++ API. This is the common base class used by the wrapper objects.
 template <typename T>
@@ -118,11 +121,24 @@ struct MemoryInfo;
 struct Env;
 struct TypeInfo;
 struct Value;
+struct PreparedRun;
+struct IoBinding;
+
+struct ThreadingOptions : Base<OrtThreadingOptions> {
+  explicit ThreadingOptions(std::nullptr_t) {}
+  ThreadingOptions();
+
+  ThreadingOptions& SetGlobalIntraOpNumThreads(int intra_op_num_threads);
+  ThreadingOptions& SetGlobalInterOpNumThreads(int inter_op_num_threads);
+};
 
 struct Env : Base<OrtEnv> {
   Env(std::nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING, _In_ const char* logid = "");
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
+  // creates the env with thread pools shared by the sessions that disable per session threads
+  Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_logging_level = ORT_LOGGING_LEVEL_WARNING,
+      _In_ const char* logid = "");
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
 
   Env& EnableTelemetryEvents();
@@ -155,6 +171,12 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // fail the Session::Run calls that use this RunOptions instance once timeout_us microseconds have passed.
+  // 0 removes the deadline.
+  RunOptions& SetDeadline(int64_t timeout_us);
+
+  RunOptions& SetPriority(OrtRunPriority priority);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -179,6 +201,19 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions& EnableMemPattern();
   SessionOptions& DisableMemPattern();
 
+  SessionOptions& EnableSharedInitializers();
+  SessionOptions& DisableSharedInitializers();
+
+  SessionOptions& DisablePerSessionThreads();
+
+  SessionOptions& SetRunPriorityMaxThreads(OrtRunPriority priority, int max_threads);
+
+  SessionOptions& SetCpuHugePageThreshold(size_t threshold_bytes);
+
+  SessionOptions& SetDynamicBatching(int64_t max_batch_size, int64_t timeout_us);
+
+  SessionOptions& SetLightweightProfilingSamplingInterval(uint32_t sampling_interval);
+
   SessionOptions& SetExecutionMode(ExecutionMode execution_mode);
 
   SessionOptions& SetLogId(const char* logid);
@@ -197,6 +232,17 @@ struct Session : Base<OrtSession> {
   // Run for when there is a list of prealloated outputs
   void Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
+  // Run batch_size requests in one call. input_values holds the input_count inputs of each request one request after
+  // the other, and the outputs are returned the same way.
+  std::vector<Value> RunBatch(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                              size_t input_count, const char* const* output_names, size_t output_count, size_t batch_size);
+  // Run with the input and output names resolved by a PreparedRun, input_values and the outputs in their order
+  std::vector<Value> Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                         size_t output_count);
+  // Run with the inputs and outputs of a binding
+  void Run(const RunOptions& run_options, IoBinding& io_binding);
+  // Run with the inputs and outputs of a binding, returning once the work is queued on the devices
+  void RunAsync(const RunOptions& run_options, IoBinding& io_binding);
 
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
@@ -205,12 +251,39 @@ struct Session : Base<OrtSession> {
   char* GetInputName(size_t index, OrtAllocator* allocator) const;
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
+  // JSON statistics of the runs sampled by the lightweight profiler
+  char* GetProfilingStatistics(OrtAllocator* allocator) const;
+  // bytes in use and peak bytes in use of the session's arena allocators
+  void GetArenaMemoryUsage(int64_t& bytes_in_use, int64_t& max_bytes_in_use) const;
+  // JSON statistics of each arena allocator of the session
+  char* GetMemoryStatistics(OrtAllocator* allocator) const;
+  // largest peak bytes of the tensors allocated by a single Run of the session
+  int64_t GetPeakActivationBytes() const;
+  // counters of the dynamic batching of the session, all 0 if it's not enabled
+  void GetDynamicBatchingStats(uint64_t& requests, uint64_t& batches, uint64_t& unbatched_requests) const;
 
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;
 };
 
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
+};
+
+struct IoBinding : Base<OrtIoBinding> {
+  explicit IoBinding(std::nullptr_t) {}
+  explicit IoBinding(Session& session);
+
+  void BindInput(const char* name, const Value& value);
+  void BindOutput(const char* name, const Value& value);
+  void BindOutput(const char* name, const MemoryInfo& mem_info);
+  // outputs of the last run in the order they were bound
+  std::vector<Value> GetOutputValues() const;
+};
+
 struct TensorTypeAndShapeInfo : Base<OrtTensorTypeAndShapeInfo> {
   explicit TensorTypeAndShapeInfo(std::nullptr_t) {}
   explicit TensorTypeAndShapeInfo(OrtTensorTypeAndShapeInfo* p) : Base<OrtTensorTypeAndShapeInfo>{p} {}
@@ -322,6 +395,16 @@ struct CustomOpApi {
   const OrtValue* KernelContext_GetInput(const OrtKernelContext* context, _In_ size_t index);
   size_t KernelContext_GetOutputCount(const OrtKernelContext* context);
   OrtValue* KernelContext_GetOutput(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
+  size_t KernelContext_GetThreadCount(const OrtKernelContext* context);
+  // calls fn(i) for each i in [0, total) on the intra-op thread pool, fn must not throw
+  template <typename F>
+  void KernelContext_ParallelFor(const OrtKernelContext* context, size_t total, size_t num_batches, F&& fn);
+  void* KernelContext_AllocateScratch(OrtKernelContext* context, size_t size);
+  void KernelContext_FreeScratch(OrtKernelContext* context, void* p);
+  size_t ShapeInferContext_GetInputCount(const OrtShapeInferContext* context);
+  // returns nullptr if the shape of the input is unknown, else it must be released by ReleaseTensorTypeAndShapeInfo
+  OrtTensorTypeAndShapeInfo* ShapeInferContext_GetInputTypeShape(const OrtShapeInferContext* context, size_t index);
+  void ShapeInferContext_SetOutputTypeShape(OrtShapeInferContext* context, size_t index, const OrtTensorTypeAndShapeInfo* info);
 
   void ThrowOnError(OrtStatus* result);
 
@@ -346,10 +429,21 @@ struct CustomOpBase : OrtCustomOp {
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) { static_cast<TKernel*>(op_kernel)->Compute(context); };
     OrtCustomOp::KernelDestroy = [](void* op_kernel) { delete static_cast<TKernel*>(op_kernel); };
+
+    OrtCustomOp::GetMayInplace = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetMayInplace(index); };
+    OrtCustomOp::GetAlias = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetAlias(index); };
+
+    // set by the ops that implement them
+    OrtCustomOp::InferOutputShapes = nullptr;
+    OrtCustomOp::KernelPrePack = nullptr;
   }
 
   // Default implementation of GetExecutionProviderType that returns nullptr to default to the CPU provider
   const char* GetExecutionProviderType() const { return nullptr; }
+
+  // Default implementations of GetMayInplace and GetAlias that don't reuse any input
+  int GetMayInplace(size_t /*output_index*/) const { return -1; }
+  int GetAlias(size_t /*output_index*/) const { return -1; }
 };
 
 }  // namespace Ort
@@ -76,6 +76,20 @@ inline MemoryInfo::MemoryInfo(const char* name, OrtAllocatorType type, int id, O
   ThrowOnError(Global<void>::api_.CreateMemoryInfo(name, type, id, mem_type, &p_));
 }
 
+inline ThreadingOptions::ThreadingOptions() {
+  ThrowOnError(Global<void>::api_.CreateThreadingOptions(&p_));
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpNumThreads(int intra_op_num_threads) {
+  ThrowOnError(Global<void>::api_.SetGlobalIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpNumThreads(int inter_op_num_threads) {
+  ThrowOnError(Global<void>::api_.SetGlobalInterOpNumThreads(p_, inter_op_num_threads));
+  return *this;
+}
+
 inline Env::Env(OrtLoggingLevel default_warning_level, _In_ const char* logid) {
   ThrowOnError(Global<void>::api_.CreateEnv(default_warning_level, logid, &p_));
 }
@@ -84,6 +98,10 @@ inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLog
   ThrowOnError(Global<void>::api_.CreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
 
+inline Env::Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_warning_level, _In_ const char* logid) {
+  ThrowOnError(Global<void>::api_.CreateEnvWithGlobalThreadPools(default_warning_level, logid, tp_options, &p_));
+}
+
 inline Env& Env::EnableTelemetryEvents() {
   ThrowOnError(Global<void>::api_.EnableTelemetryEvents(p_));
   return *this;
@@ -143,6 +161,16 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetDeadline(int64_t timeout_us) {
+  ThrowOnError(Global<void>::api_.RunOptionsSetDeadline(p_, timeout_us));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetPriority(OrtRunPriority priority) {
+  ThrowOnError(Global<void>::api_.RunOptionsSetPriority(p_, priority));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(Global<void>::api_.CreateSessionOptions(&p_));
 }
@@ -193,6 +221,41 @@ inline SessionOptions& SessionOptions::DisableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableSharedInitializers() {
+  ThrowOnError(Global<void>::api_.EnableSharedInitializers(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableSharedInitializers() {
+  ThrowOnError(Global<void>::api_.DisableSharedInitializers(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
+  ThrowOnError(Global<void>::api_.DisablePerSessionThreads(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetRunPriorityMaxThreads(OrtRunPriority priority, int max_threads) {
+  ThrowOnError(Global<void>::api_.SetSessionRunPriorityMaxThreads(p_, priority, max_threads));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetCpuHugePageThreshold(size_t threshold_bytes) {
+  ThrowOnError(Global<void>::api_.SetSessionCpuHugePageThreshold(p_, threshold_bytes));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetDynamicBatching(int64_t max_batch_size, int64_t timeout_us) {
+  ThrowOnError(Global<void>::api_.SetSessionDynamicBatching(p_, max_batch_size, timeout_us));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetLightweightProfilingSamplingInterval(uint32_t sampling_interval) {
+  ThrowOnError(Global<void>::api_.SetLightweightProfilingSamplingInterval(p_, sampling_interval));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableCpuMemArena() {
   ThrowOnError(Global<void>::api_.EnableCpuMemArena(p_));
   return *this;
@@ -242,6 +305,69 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(Global<void>::api_.Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline std::vector<Value> Session::RunBatch(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                                            size_t input_count, const char* const* output_names, size_t output_count, size_t batch_size) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count * batch_size; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ThrowOnError(Global<void>::api_.RunBatch(p_, run_options, input_names, ort_input_values, input_count,
+                                           output_names, output_count, batch_size, ort_output_values));
+  return output_values;
+}
+
+inline std::vector<Value> Session::Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+                                       size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ThrowOnError(Global<void>::api_.RunPrepared(p_, run_options, prepared_run, ort_input_values, input_count,
+                                              ort_output_values, output_count));
+  return output_values;
+}
+
+inline void Session::Run(const RunOptions& run_options, IoBinding& io_binding) {
+  ThrowOnError(Global<void>::api_.RunWithBinding(p_, run_options, io_binding));
+}
+
+inline void Session::RunAsync(const RunOptions& run_options, IoBinding& io_binding) {
+  ThrowOnError(Global<void>::api_.RunAsync(p_, run_options, io_binding));
+}
+
+inline IoBinding::IoBinding(Session& session) {
+  ThrowOnError(Global<void>::api_.CreateIoBinding(session, &p_));
+}
+
+inline void IoBinding::BindInput(const char* name, const Value& value) {
+  ThrowOnError(Global<void>::api_.BindInput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const Value& value) {
+  ThrowOnError(Global<void>::api_.BindOutput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const MemoryInfo& mem_info) {
+  ThrowOnError(Global<void>::api_.BindOutputToDevice(p_, name, mem_info));
+}
+
+inline std::vector<Value> IoBinding::GetOutputValues() const {
+  size_t count;
+  ThrowOnError(Global<void>::api_.GetBoundOutputCount(p_, &count));
+  std::vector<Value> output_values;
+  for (size_t i = 0; i < count; i++)
+    output_values.emplace_back(nullptr);
+  ThrowOnError(Global<void>::api_.GetBoundOutputValues(p_, reinterpret_cast<OrtValue**>(output_values.data()), count));
+  return output_values;
+}
+
+inline PreparedRun::PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(Global<void>::api_.CreatePreparedRun(session, input_names, input_count, output_names, output_count, &p_));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(Global<void>::api_.SessionGetInputCount(p_, &out));
@@ -278,6 +404,33 @@ inline char* Session::GetOverridableInitializerName(size_t index, OrtAllocator*
   return out;
 }
 
+inline char* Session::GetProfilingStatistics(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(Global<void>::api_.SessionGetProfilingStatistics(p_, allocator, &out));
+  return out;
+}
+
+inline void Session::GetArenaMemoryUsage(int64_t& bytes_in_use, int64_t& max_bytes_in_use) const {
+  ThrowOnError(Global<void>::api_.SessionGetArenaMemoryUsage(p_, &bytes_in_use, &max_bytes_in_use));
+}
+
+inline void Session::GetDynamicBatchingStats(uint64_t& requests, uint64_t& batches,
+                                             uint64_t& unbatched_requests) const {
+  ThrowOnError(Global<void>::api_.SessionGetDynamicBatchingStats(p_, &requests, &batches, &unbatched_requests));
+}
+
+inline char* Session::GetMemoryStatistics(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(Global<void>::api_.SessionGetMemoryStatistics(p_, allocator, &out));
+  return out;
+}
+
+inline int64_t Session::GetPeakActivationBytes() const {
+  int64_t out;
+  ThrowOnError(Global<void>::api_.SessionGetPeakActivationBytes(p_, &out));
+  return out;
+}
+
 inline TypeInfo Session::GetInputTypeInfo(size_t index) const {
   OrtTypeInfo* out;
   ThrowOnError(Global<void>::api_.SessionGetInputTypeInfo(p_, index, &out));
@@ -553,4 +706,43 @@ inline OrtValue* CustomOpApi::KernelContext_GetOutput(OrtKernelContext* context,
   return out;
 }
 
+inline size_t CustomOpApi::KernelContext_GetThreadCount(const OrtKernelContext* context) {
+  size_t out;
+  ThrowOnError(api_.KernelContext_GetThreadCount(context, &out));
+  return out;
+}
+
+template <typename F>
+inline void CustomOpApi::KernelContext_ParallelFor(const OrtKernelContext* context, size_t total, size_t num_batches, F&& fn) {
+  using FnType = typename std::remove_reference<F>::type;
+  OrtParallelForFunc call = [](void* user_data, size_t index) { (*static_cast<FnType*>(user_data))(index); };
+  ThrowOnError(api_.KernelContext_ParallelFor(context, call, const_cast<void*>(static_cast<const void*>(&fn)), total, num_batches));
+}
+
+inline void* CustomOpApi::KernelContext_AllocateScratch(OrtKernelContext* context, size_t size) {
+  void* out;
+  ThrowOnError(api_.KernelContext_AllocateScratch(context, size, &out));
+  return out;
+}
+
+inline void CustomOpApi::KernelContext_FreeScratch(OrtKernelContext* context, void* p) {
+  ThrowOnError(api_.KernelContext_FreeScratch(context, p));
+}
+
+inline size_t CustomOpApi::ShapeInferContext_GetInputCount(const OrtShapeInferContext* context) {
+  size_t out;
+  ThrowOnError(api_.ShapeInferContext_GetInputCount(context, &out));
+  return out;
+}
+
+inline OrtTensorTypeAndShapeInfo* CustomOpApi::ShapeInferContext_GetInputTypeShape(const OrtShapeInferContext* context, size_t index) {
+  OrtTensorTypeAndShapeInfo* out;
+  ThrowOnError(api_.ShapeInferContext_GetInputTypeShape(context, index, &out));
+  return out;
+}
+
+inline void CustomOpApi::ShapeInferContext_SetOutputTypeShape(OrtShapeInferContext* context, size_t index, const OrtTensorTypeAndShapeInfo* info) {
+  ThrowOnError(api_.ShapeInferContext_SetOutputTypeShape(context, index, info));
+}
+
 }  // namespace Ort
@@ -123,6 +123,7 @@ public class OnnxTensor implements OnnxValue {
      * Returns a copy of the underlying OnnxTensor as a ByteBuffer.
      * <p>
      * This method returns null if the OnnxTensor contains Strings as they are stored externally to the OnnxTensor.
+     * Use {@link #getByteBufferView} to read the OnnxTensor without copying it.
      * @return A ByteBuffer copy of the OnnxTensor.
      */
     public ByteBuffer getByteBuffer() {
@@ -236,6 +237,97 @@ public class OnnxTensor implements OnnxValue {
         }
     }
 
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as a direct ByteBuffer in native order.
+     * Unlike {@link #getByteBuffer} nothing is copied or allocated on the Java heap.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed, reading it afterwards reads freed memory.
+     * This method returns null if the OnnxTensor contains Strings as they are stored externally to the OnnxTensor.
+     * @return A read-only ByteBuffer view of the OnnxTensor.
+     */
+    public ByteBuffer getByteBufferView() {
+        if (info.type != OnnxJavaType.STRING) {
+            return getBuffer().asReadOnlyBuffer().order(ByteOrder.nativeOrder());
+        } else {
+            return null;
+        }
+    }
+
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as a FloatBuffer if the underlying type is
+     * a float (fp32), otherwise it returns null. fp16 tensors can only be copied out by {@link #getFloatBuffer}.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed.
+     * @return A read-only FloatBuffer view of the OnnxTensor.
+     */
+    public FloatBuffer getFloatBufferView() {
+        if ((info.type == OnnxJavaType.FLOAT) && (info.onnxType != TensorInfo.OnnxTensorType.ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16)) {
+            return getBuffer().asFloatBuffer().asReadOnlyBuffer();
+        } else {
+            return null;
+        }
+    }
+
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as a DoubleBuffer if the underlying type is
+     * a double, otherwise it returns null.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed.
+     * @return A read-only DoubleBuffer view of the OnnxTensor.
+     */
+    public DoubleBuffer getDoubleBufferView() {
+        if (info.type == OnnxJavaType.DOUBLE) {
+            return getBuffer().asDoubleBuffer().asReadOnlyBuffer();
+        } else {
+            return null;
+        }
+    }
+
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as a ShortBuffer if the underlying type is
+     * int16 or uint16, otherwise it returns null.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed.
+     * @return A read-only ShortBuffer view of the OnnxTensor.
+     */
+    public ShortBuffer getShortBufferView() {
+        if (info.type == OnnxJavaType.INT16) {
+            return getBuffer().asShortBuffer().asReadOnlyBuffer();
+        } else {
+            return null;
+        }
+    }
+
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as an IntBuffer if the underlying type is
+     * int32 or uint32, otherwise it returns null.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed.
+     * @return A read-only IntBuffer view of the OnnxTensor.
+     */
+    public IntBuffer getIntBufferView() {
+        if (info.type == OnnxJavaType.INT32) {
+            return getBuffer().asIntBuffer().asReadOnlyBuffer();
+        } else {
+            return null;
+        }
+    }
+
+    /**
+     * Returns a read-only view of the underlying OnnxTensor memory as a LongBuffer if the underlying type is
+     * int64 or uint64, otherwise it returns null.
+     * <p>
+     * The view is only valid until the OnnxTensor is closed.
+     * @return A read-only LongBuffer view of the OnnxTensor.
+     */
+    public LongBuffer getLongBufferView() {
+        if (info.type == OnnxJavaType.INT64) {
+            return getBuffer().asLongBuffer().asReadOnlyBuffer();
+        } else {
+            return null;
+        }
+    }
+
     /**
      * Wraps the OrtTensor pointer in a direct byte buffer of the native platform endian-ness.
      * Unless you really know what you're doing, you want this one rather than the native call {@link OnnxTensor#getBuffer(long,long)}.
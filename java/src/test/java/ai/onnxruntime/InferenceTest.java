@@ -29,6 +29,7 @@ import java.io.IOException;
 import java.io.InputStream;
 import java.io.UncheckedIOException;
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.nio.FloatBuffer;
 import java.nio.file.Files;
 import java.nio.file.Path;
@@ -492,10 +493,25 @@ public class InferenceTest {
                 float[] resultBufferArray = new float[flatInput.length];
                 ((OnnxTensor)res.get(0)).getFloatBuffer().get(resultBufferArray);
                 assertArrayEquals(flatInput,resultBufferArray,1e-6f);
+                FloatBuffer view = ((OnnxTensor)res.get(0)).getFloatBufferView();
+                assertTrue(view.isDirect());
+                assertTrue(view.isReadOnly());
+                float[] resultViewArray = new float[flatInput.length];
+                view.get(resultViewArray);
+                assertArrayEquals(flatInput,resultViewArray,1e-6f);
                 OnnxValue.close(container);
             }
             container.clear();
 
+            // Now test loading from a direct buffer, which the tensor uses without copying
+            ByteBuffer directBuffer = ByteBuffer.allocateDirect(flatInput.length*4).order(ByteOrder.nativeOrder());
+            directBuffer.asFloatBuffer().put(flatInput);
+            OnnxTensor directTensor = OnnxTensor.createTensor(env,directBuffer.asFloatBuffer(),shape);
+            assertEquals(directBuffer.getFloat(0),directTensor.getByteBufferView().getFloat(0),1e-6f);
+            directBuffer.putFloat(0,42.0f);
+            assertEquals(42.0f,directTensor.getFloatBufferView().get(0),1e-6f);
+            directTensor.close();
+
             // Now test loading from buffer
             FloatBuffer buffer = FloatBuffer.wrap(flatInput);
             OnnxTensor newTensor = OnnxTensor.createTensor(env,buffer,shape);
@@ -3,6 +3,7 @@
 
 #include "attention.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/mlas/inc/mlas.h"
 #include "onnx/defs/schema.h"
 #include "core/util/eigen_common_wrapper.h"
 #include "core/util/math.h"
@@ -31,6 +32,8 @@ AttentionBase::AttentionBase(const OpKernelInfo& info) {
   int64_t num_heads = 0;
   ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
   num_heads_ = static_cast<int>(num_heads);
+
+  is_unidirectional_ = info.GetAttrOrDefault<int64_t>("unidirectional", 0) == 1;
 }
 
 Status AttentionBase::CheckInputs(const OpKernelContext* context) const {
@@ -39,7 +42,9 @@ Status AttentionBase::CheckInputs(const OpKernelContext* context) const {
   //   Input 1 - weights     : (hidden_size, 3 * hidden_size)
   //   Input 2 - bias        : (3 * hidden_size)
   //   Input 3 - mask_index  : (batch_size)
-  //   Output                : (batch_size, sequence_length, hidden_size)
+  //   Input 4 - past        : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //   Output 0              : (batch_size, sequence_length, hidden_size)
+  //   Output 1 - present    : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
 
   const Tensor* input = context->Input<Tensor>(0);
   const auto dims = input->Shape().GetDims();
@@ -91,6 +96,31 @@ Status AttentionBase::CheckInputs(const OpKernelContext* context) const {
                            "Inputs 3 and 0 shall have same length at dimension 0");
   }
 
+  const Tensor* past = context->Input<Tensor>(4);
+  if (past != nullptr) {
+    const auto past_dims = past->Shape().GetDims();
+    if (past_dims.size() != 5) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 4 is expected to have 5 dimensions, got ", past_dims.size());
+    }
+    if (past_dims[0] != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 4 dimension 0 should be 2, got ", past_dims[0]);
+    }
+    if (static_cast<int>(past_dims[1]) != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 4 dimension 1 and input 0 dimension 0 shall have same length");
+    }
+    if (static_cast<int>(past_dims[2]) != num_heads_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 4 dimension 2 should be equal to the num_heads attribute");
+    }
+    if (static_cast<int>(past_dims[4]) != hidden_size / num_heads_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 4 dimension 4 should be hidden_size / num_heads");
+    }
+  }
+
   return Status::OK();
 }
 
@@ -105,20 +135,27 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* weights = context->Input<Tensor>(1);
   const Tensor* bias = context->Input<Tensor>(2);
   const Tensor* mask_index = context->Input<Tensor>(3);
+  const Tensor* past = context->Input<Tensor>(4);
 
   const auto dims = input->Shape().GetDims();
   const int batch_size = static_cast<int>(dims[0]);
   const int sequence_length = static_cast<int>(dims[1]);
   const int hidden_size = static_cast<int>(dims[2]);
   const int head_size = hidden_size / num_heads_;
+  const int past_sequence_length = (past != nullptr) ? static_cast<int>(past->Shape()[3]) : 0;
+  const int all_sequence_length = past_sequence_length + sequence_length;
 
   TensorShape output_shape(dims);
   Tensor* output = context->Output(0, output_shape);
 
+  std::vector<int64_t> present_dims{2, batch_size, num_heads_, all_sequence_length, head_size};
+  TensorShape present_shape(present_dims);
+  Tensor* present = context->Output(1, present_shape);
+
   constexpr size_t element_size = sizeof(T);
 
   AllocatorPtr allocator;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  ORT_RETURN_IF_ERROR(context->GetScratchAllocator(&allocator));
 
   // STEP.1: gemm_data(BS, 3NH) = input(BS, NH) x weights(NH, 3NH) + bias(3NH)
   auto gemm_data = allocator->Alloc(batch_size * sequence_length * 3 * hidden_size * element_size);
@@ -135,6 +172,14 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     const auto weights_data = weights->template Data<T>();
     const auto bias_data = bias->template Data<T>();
 
+    //                   original           transposed            iteration
+    // A: input          (BxSxNxH)          (B.)S x NH            S x NH
+    // B: weights        (NxHx3xNxH)        NH  x (3.N.)H         NH x H
+    // C: QKV[qkv_index] (3xBxNxSxH)        (3.B.N.)S x H         S x H
+    std::vector<const float*> gemm_a(loop_len);
+    std::vector<const float*> gemm_b(loop_len);
+    std::vector<float*> gemm_c(loop_len);
+
     concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), loop_len, [&](int32_t i) {
       const int batch_index = (i / 3) / num_heads_;
       const int head_index = (i / 3) % num_heads_;
@@ -153,148 +198,171 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
         broadcast_data_dest += head_size;
       }
 
-      //                   original           transposed            iteration
-      // A: input          (BxSxNxH)          (B.)S x NH            S x NH
-      // B: weights        (NxHx3xNxH)        NH  x (3.N.)H         NH x H
-      // C: QKV[qkv_index] (3xBxNxSxH)        (3.B.N.)S x H         S x H
-
-      math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans,                   // TransA = no
-                                                   CblasNoTrans,                   // TransB = no
-                                                   sequence_length,                // M      = S
-                                                   head_size,                      // N      = H
-                                                   hidden_size,                    // K      = NH
-                                                   1.0f,                           // alpha
-                                                   input_data + input_offset,      // A
-                                                   hidden_size,                    // lda    = NH
-                                                   weights_data + weights_offset,  // B
-                                                   3 * hidden_size,                // ldb    = 3NH
-                                                   1.0f,                           // beta
-                                                   qkv_dest + qkv_offset,          // C
-                                                   head_size,                      // ldc
-                                                   nullptr                         // use single-thread
-      );
+      gemm_a[i] = input_data + input_offset;
+      gemm_b[i] = weights_data + weights_offset;
+      gemm_c[i] = qkv_dest + qkv_offset;
     });
-  }
 
-  // STEP.2: scratch(B, N, S, S) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S, H -> B, N, H, S) + 1 x mask_index(B -> B, 1, 1, 1)
-  auto scratch_data = allocator->Alloc(batch_size * num_heads_ * sequence_length * sequence_length * element_size);
-  BufferUniquePtr scratch_buffer(scratch_data, BufferDeleter(allocator));
+    // the gemms of all the heads are a single batch, so the threads split the heads or, for a small batch, the
+    // blocks of each head
+    MlasGemmBatch(CblasNoTrans,                            // TransA = no
+                  CblasNoTrans,                            // TransB = no
+                  static_cast<size_t>(sequence_length),    // M      = S
+                  static_cast<size_t>(head_size),          // N      = H
+                  static_cast<size_t>(hidden_size),        // K      = NH
+                  1.0f,                                    // alpha
+                  gemm_a.data(),                           // A
+                  static_cast<size_t>(hidden_size),        // lda    = NH
+                  gemm_b.data(),                           // B
+                  static_cast<size_t>(3 * hidden_size),    // ldb    = 3NH
+                  1.0f,                                    // beta
+                  gemm_c.data(),                           // C
+                  static_cast<size_t>(head_size),          // ldc
+                  static_cast<size_t>(loop_len),           // BatchN = 3BN
+                  context->GetOperatorThreadPool());
+  }
 
-  {
-    auto scratch_broadcast_data = allocator->Alloc(batch_size * sequence_length * element_size);
-    BufferUniquePtr scratch_broadcast_buffer(scratch_broadcast_data, BufferDeleter(allocator));
-    memset(scratch_broadcast_data, 0, batch_size * sequence_length * element_size);
-    T* p_scratch_broadcast_current_data = reinterpret_cast<T*>(scratch_broadcast_data);
-    for (int b_i = 0; b_i < batch_size; b_i++) {
-      // TODO: mask_index can be used in softmax to save some calculation.
-      int mask = mask_index->template Data<int32_t>()[b_i];
-      for (int m_i = mask; m_i < sequence_length; m_i++) {
-        p_scratch_broadcast_current_data[m_i] = static_cast<T>(-10000.0);
-      }
-      p_scratch_broadcast_current_data += sequence_length;
+  // STEP.2: present(2, B, N, L, H) = concat(past(2, B, N, P, H), K/V(B, N, S, H)) with L = P + S.
+  // Without past, K and V are used as they are. Without present, the concatenation goes to a temporary buffer.
+  const T* K_all = K;
+  const T* V_all = V;
+  BufferUniquePtr present_buffer;
+
+  if (past != nullptr || present != nullptr) {
+    T* present_data;
+    if (present != nullptr) {
+      present_data = present->template MutableData<T>();
+    } else {
+      auto present_temp_data = allocator->Alloc(2 * batch_size * num_heads_ * all_sequence_length * head_size * element_size);
+      present_buffer = BufferUniquePtr(present_temp_data, BufferDeleter(allocator));
+      present_data = reinterpret_cast<T*>(present_temp_data);
     }
 
-    const int loop_len = batch_size * num_heads_;
-    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+    const T* past_data = (past != nullptr) ? past->template Data<T>() : nullptr;
+    const int loop_len = 2 * batch_size * num_heads_;
+    const size_t past_chunk = static_cast<size_t>(past_sequence_length) * head_size;
+    const size_t chunk = static_cast<size_t>(sequence_length) * head_size;
 
     concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), loop_len, [&](int32_t i) {
-      const int batch_index = i / num_heads_;
-      // broadcast masks (B) -> (B.N.)S.S
-      const T* broadcast_data_src = reinterpret_cast<T*>(scratch_broadcast_data) + batch_index * sequence_length;
-      T* broadcast_data_dest = reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i;
-      for (int seq_index = 0; seq_index < sequence_length; seq_index++) {
-        memcpy(broadcast_data_dest, broadcast_data_src, sequence_length * sizeof(T));
-        broadcast_data_dest += sequence_length;
+      T* dest = present_data + (past_chunk + chunk) * i;
+      if (past_chunk > 0) {
+        memcpy(dest, past_data + past_chunk * i, past_chunk * sizeof(T));
       }
-
-      // gemm
-
-      //                   original           transposed            iteration
-      // A: Q              (BxNxSxH)          (B.N.)S x H            S x H
-      // B: K'             (BxNxSxH)          (B.N.)H x S            H x S
-      // C: scratch_data   (BxNxSxS)          (B.N.)S x S            S x S
-
-      math::Gemm<T, concurrency::ThreadPool>(
-          CblasNoTrans,
-          CblasTrans,
-          sequence_length,
-          sequence_length,
-          head_size,
-          alpha,
-          Q + sequence_length * head_size * i,
-          K + sequence_length * head_size * i,
-          1.0,
-          reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i,
-          nullptr);
+      // i < B.N selects the keys, the remaining indices select the values.
+      memcpy(dest + past_chunk, K + chunk * i, chunk * sizeof(T));
     });
+
+    K_all = present_data;
+    V_all = present_data + batch_size * num_heads_ * all_sequence_length * head_size;
   }
 
-  // STEP.3: P(B, N, S, S) = Softmax(scratch)
+  // STEP.3: for each (batch, head) and block of query rows, with the query rows of the block denoted by s:
+  //   scores(s, L) = 1/sqrt(H) x Q(B, N, s, H) x K'(B, N, L, H -> B, N, H, L) + mask_bias(B -> L)
+  //   P(s, L) = Softmax(scores)
+  //   output(B, s, N, H) = P(s, L) x V(B, N, L, H)
+  // The scores of a block stay in a scratch buffer of (query_block x L), so memory scales with the block size
+  // rather than with (B, N, S, L), and the probabilities are consumed by the second gemm while still in cache.
+  // With a past state, only the rows of the new tokens are computed.
   {
-    const int N = batch_size * num_heads_ * sequence_length;
-    const int D = sequence_length;
-
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), N, [&](int j) {
-      float* x = reinterpret_cast<T*>(scratch_data) + j * D;
-      float* y = x;
-
-      // e^x is represented as infinity if x is large enough, like 100.f.
-      // Infinity divided by Infinity is a NAN. Thus, softmax gets a NAN if one or more item are large enough.
-      // a math transform as below is leveraged to get a stable softmax:
-      // e^xi/(e^x1 + ...e^xn) = e^(xi - max) / (e^(x1 - max) + ... + e^(xn - max))
-      float max = -std::numeric_limits<float>::infinity();
-      for (int i = 0; i < D; i++) {
-        if (max < x[i]) max = x[i];
-      }
-      for (int i = 0; i < D; i++) {
-        y[i] = expf(x[i] - max);
-      }
-
-      double sum = 0.0;
-
-      for (int i = 0; i < D; i++) {
-        sum += x[i];
-      }
+    // mask_bias: 0 for the first mask_index[b] keys of batch b and -10000 for the remaining keys.
+    auto mask_bias_data = allocator->Alloc(batch_size * all_sequence_length * element_size);
+    BufferUniquePtr mask_bias_buffer(mask_bias_data, BufferDeleter(allocator));
+    T* mask_bias = reinterpret_cast<T*>(mask_bias_data);
+    const int32_t* mask_index_data = mask_index->template Data<int32_t>();
+    for (int b_i = 0; b_i < batch_size; b_i++) {
+      const int mask = std::min(std::max(static_cast<int>(mask_index_data[b_i]), 0), all_sequence_length);
+      T* current_mask_bias = mask_bias + b_i * all_sequence_length;
+      std::fill(current_mask_bias, current_mask_bias + mask, static_cast<T>(0.0));
+      std::fill(current_mask_bias + mask, current_mask_bias + all_sequence_length, static_cast<T>(-10000.0));
+    }
 
-      if (sum == 0) {
-        for (int i = 0; i < D; i++) {
-          y[i] = 1.0f / (float)D;
-        }
-      } else {
-        for (int i = 0; i < D; i++) {
-          y[i] = x[i] / (float)sum;
+    // Size the query block so that its scores fit in a per-thread cache.
+    constexpr int kScratchElements = 16384;
+    const int query_block = std::max(1, std::min(sequence_length, kScratchElements / std::max(all_sequence_length, 1)));
+    const int query_block_count = (sequence_length + query_block - 1) / query_block;
+    const int64_t loop_len = static_cast<int64_t>(batch_size) * num_heads_ * query_block_count;
+    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+    const double cost = static_cast<double>(query_block) * all_sequence_length * (4.0 * head_size + 16.0);
+    T* output_data = output->template MutableData<T>();
+
+    concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), loop_len, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      auto scratch_data = allocator->Alloc(query_block * all_sequence_length * element_size);
+      BufferUniquePtr scratch_buffer(scratch_data, BufferDeleter(allocator));
+      T* scores = reinterpret_cast<T*>(scratch_data);
+
+      for (std::ptrdiff_t task = first; task < last; task++) {
+        const int i = static_cast<int>(task / query_block_count);
+        const int batch_index = i / num_heads_;
+        const int head_index = i % num_heads_;
+        const int query_start = static_cast<int>(task % query_block_count) * query_block;
+        const int query_count = std::min(query_block, sequence_length - query_start);
+
+        //                   original           transposed            iteration
+        // A: Q              (BxNxSxH)          (B.N.)S x H            s x H
+        // B: K'             (BxNxSxH)          (B.N.)H x S            H x S
+        // C: scores         (sxL)              s x L                  s x L
+
+        math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans,
+                                                     CblasTrans,
+                                                     query_count,
+                                                     all_sequence_length,
+                                                     head_size,
+                                                     alpha,
+                                                     Q + (sequence_length * i + query_start) * head_size,
+                                                     head_size,
+                                                     K_all + all_sequence_length * head_size * i,
+                                                     head_size,
+                                                     0.0f,
+                                                     scores,
+                                                     all_sequence_length,
+                                                     nullptr);
+
+        const T* current_mask_bias = mask_bias + batch_index * all_sequence_length;
+        const int D = all_sequence_length;
+
+        for (int j = 0; j < query_count; j++) {
+          float* x = scores + j * D;
+
+          if (is_unidirectional_) {
+            // The query at position P + s can not attend to the keys after it.
+            for (int k = past_sequence_length + query_start + j + 1; k < D; k++) {
+              x[k] += static_cast<T>(-10000.0);
+            }
+          }
+
+          for (int k = 0; k < D; k++) {
+            x[k] += current_mask_bias[k];
+          }
         }
+
+        // The blocks are already spread over the thread pool, so the softmax of a block runs on this thread.
+        MlasComputeSoftmax(scores, scores, query_count, D, false, nullptr);
+
+        // The product is written directly in the transposed output layout, out(B, S, N, H).
+
+        //                   original           transposed            iteration
+        // A: P              (sxL)              s x L                  s x L
+        // B: V              (BxNxLxH)          (B.N.)L x H            L x H
+        // C: output         (BxSxNxH)          (B.)s x N x H          s x H
+
+        math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans,
+                                                     CblasNoTrans,
+                                                     query_count,
+                                                     head_size,
+                                                     all_sequence_length,
+                                                     1.0f,
+                                                     scores,
+                                                     all_sequence_length,
+                                                     V_all + all_sequence_length * head_size * i,
+                                                     head_size,
+                                                     0.0f,
+                                                     output_data + ((batch_index * sequence_length + query_start) * num_heads_ + head_index) * head_size,
+                                                     hidden_size,
+                                                     nullptr);
       }
     });
   }
 
-  // STEP.4: out_tmp(B, N, S, H) = P(B, N, S, S) x V(B, N, S, H)
-  auto out_tmp_data = allocator->Alloc(batch_size * num_heads_ * sequence_length * head_size * element_size);
-  BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
-
-  concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), batch_size * num_heads_, [&](int i) {
-    T* current_tmp_data = reinterpret_cast<T*>(out_tmp_data) + sequence_length * head_size * i;
-    math::MatMul<T>(
-        sequence_length,
-        head_size,
-        sequence_length,
-        reinterpret_cast<T*>(scratch_data) + sequence_length * sequence_length * i,
-        V + sequence_length * head_size * i,
-        current_tmp_data,
-        nullptr);
-
-    // transpose: out(B, S, N, H) = transpose out_tmp(B, N, S, H)
-    const int batch_index = i / num_heads_;
-    const int head_index = i % num_heads_;
-    T* src = current_tmp_data;
-    T* dest = output->template MutableData<T>() + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
-    for (int j = 0; j < sequence_length; j++) {
-      memcpy(dest, src, head_size * sizeof(T));
-      src += head_size;
-      dest += hidden_size;
-    }
-  });
-
   return Status::OK();
 }
 
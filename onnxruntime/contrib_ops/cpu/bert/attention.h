@@ -14,7 +14,8 @@ class AttentionBase {
   AttentionBase(const OpKernelInfo& info);
   Status CheckInputs(const OpKernelContext* context) const;
 
-  int num_heads_;  // number of attention heads
+  int num_heads_;           // number of attention heads
+  bool is_unidirectional_;  // whether every token can only attend to itself and previous tokens
 };
 
 template <typename T>
@@ -5,8 +5,12 @@
 #include "embed_layer_norm_helper.h"
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
+#include "core/mlas/inc/mlas.h"
 
 #include <atomic>
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace onnxruntime {
 namespace contrib {
@@ -24,6 +28,59 @@ namespace contrib {
 
 REGISTER_KERNEL_TYPED(float)
 
+namespace {
+
+constexpr float kEmbedLayerNormEpsilon = 1.0e-13f;
+
+template <typename T>
+void PrefetchEmbeddingRow(const T* row, int64_t hidden_size) {
+  constexpr int64_t kCacheLineElements = 64 / sizeof(T);
+  for (int64_t i = 0; i < hidden_size; i += kCacheLineElements) {
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+    _mm_prefetch(reinterpret_cast<const char*>(row + i), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(row + i);
+#else
+    ORT_UNUSED_PARAMETER(row);
+#endif
+  }
+}
+
+template <typename T>
+void ComputeEmbedLayerNormRow(const T* input_word_embedding, const T* input_position_embedding,
+                              const T* input_segment_embedding, const T* gamma_data, const T* beta_data,
+                              T* y, int64_t hidden_size) {
+  T sum = static_cast<T>(0);
+  for (int64_t i = 0; i < hidden_size; i++) {
+    T subtotal = input_word_embedding[i] + input_position_embedding[i] + input_segment_embedding[i];
+    y[i] = subtotal;
+    sum += subtotal;
+  }
+  T mean = sum / hidden_size;
+  sum = 0;
+  for (int64_t i = 0; i < hidden_size; i++) {
+    T a = y[i] - mean;
+    y[i] = a;
+    sum += a * a;
+  }
+  T e = sqrt(sum / hidden_size + static_cast<T>(kEmbedLayerNormEpsilon));
+  for (int64_t i = 0; i < hidden_size; i++) {
+    y[i] = y[i] / e * gamma_data[i] + beta_data[i];
+  }
+}
+
+// The float rows use the vectorized MLAS kernel, which sums the three embeddings in its statistics pass.
+template <>
+void ComputeEmbedLayerNormRow<float>(const float* input_word_embedding, const float* input_position_embedding,
+                                     const float* input_segment_embedding, const float* gamma_data,
+                                     const float* beta_data, float* y, int64_t hidden_size) {
+  MlasComputeLayerNormalization(input_word_embedding, input_position_embedding, input_segment_embedding,
+                                gamma_data, beta_data, y, static_cast<size_t>(hidden_size), kEmbedLayerNormEpsilon,
+                                nullptr, nullptr);
+}
+
+}  // namespace
+
 template <typename T>
 EmbedLayerNorm<T>::EmbedLayerNorm(const OpKernelInfo& info) : OpKernel(info) {}
 
@@ -76,45 +133,42 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   {
     std::atomic_bool failed{false};
 
-    int n = batch_size * sequence_length;
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), n, [=, &failed](int index) {
-      int word_col_index = input_ids_data[index];
-      if (word_col_index < 0 || word_col_index >= word_embedding_length) {
-        failed.store(true, std::memory_order_release);
-        return;
-      }
-      int position_col_index = index % sequence_length;
-      if (position_col_index >= position_embedding_length) {
-        failed.store(true, std::memory_order_release);
-        return;
-      }
-      int segment_col_index = segment_ids_data[index];
-      if (segment_col_index < 0 || segment_col_index >= segment_embedding_length) {
-        failed.store(true, std::memory_order_release);
-        return;
-      }
-
-      T* y = output_data + index * hidden_size;
-      const T* input_word_embedding = word_embedding_data + word_col_index * hidden_size;
-      const T* input_position_embedding = position_embedding_data + position_col_index * hidden_size;
-      const T* input_segment_embedding = segment_embedding_data + segment_col_index * hidden_size;
-
-      T sum = static_cast<T>(0);
-      for (int i = 0; i < hidden_size; i++) {
-        T subtotal = input_word_embedding[i] + input_position_embedding[i] + input_segment_embedding[i];
-        y[i] = subtotal;
-        sum += subtotal;
-      }
-      T mean = sum / hidden_size;
-      sum = 0;
-      for (int i = 0; i < hidden_size; i++) {
-        T a = y[i] - mean;
-        y[i] = a;
-        sum += a * a;
-      }
-      T e = sqrt(sum / hidden_size + static_cast<T>(1.0e-13));
-      for (int i = 0; i < hidden_size; i++) {
-        y[i] = y[i] / e * gamma_data[i] + beta_data[i];
+    const int n = batch_size * sequence_length;
+    const double cost = static_cast<double>(hidden_size) * 8.0;
+    concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), n, cost, [=, &failed](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t index = first; index < last; index++) {
+        int word_col_index = input_ids_data[index];
+        if (word_col_index < 0 || word_col_index >= word_embedding_length) {
+          failed.store(true, std::memory_order_release);
+          return;
+        }
+        int position_col_index = static_cast<int>(index % sequence_length);
+        if (position_col_index >= position_embedding_length) {
+          failed.store(true, std::memory_order_release);
+          return;
+        }
+        int segment_col_index = segment_ids_data[index];
+        if (segment_col_index < 0 || segment_col_index >= segment_embedding_length) {
+          failed.store(true, std::memory_order_release);
+          return;
+        }
+
+        // The word embedding rows are gathered in a random order, so fetch the row of the next token while
+        // the current one is normalized.
+        if (index + 1 < last) {
+          int next_word_col_index = input_ids_data[index + 1];
+          if (next_word_col_index >= 0 && next_word_col_index < word_embedding_length) {
+            PrefetchEmbeddingRow(word_embedding_data + next_word_col_index * hidden_size, hidden_size);
+          }
+        }
+
+        ComputeEmbedLayerNormRow(word_embedding_data + word_col_index * hidden_size,
+                                 position_embedding_data + position_col_index * hidden_size,
+                                 segment_embedding_data + segment_col_index * hidden_size,
+                                 gamma_data,
+                                 beta_data,
+                                 output_data + index * hidden_size,
+                                 hidden_size);
       }
     });
 
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fast_gelu.h"
+
+#include "core/platform/threadpool.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FastGelu,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FastGelu<float>);
+
+template <typename T>
+Status FastGelu<T>::Compute(OpKernelContext* ctx) const {
+  const Tensor* X = ctx->Input<Tensor>(0);
+  const auto input_dims = X->Shape().GetDims();
+  if (input_dims.size() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 is expected to have 1 or more dimensions, got ", input_dims.size());
+  }
+
+  const Tensor* B = ctx->Input<Tensor>(1);
+  int64_t bias_len = 0;
+  if (B != nullptr) {
+    const auto bias_dims = B->Shape().GetDims();
+    if (bias_dims.size() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 1 is expected to have 1 dimensions, got ", bias_dims.size());
+    }
+    bias_len = bias_dims[0];
+    if (bias_len != input_dims[input_dims.size() - 1]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 1 dimension 0 should have same length as the last dimension of input 0");
+    }
+  }
+
+  Tensor* Y = ctx->Output(0, X->Shape());
+
+  MlasComputeGelu(MlasGeluTanh,
+                  X->template Data<T>(),
+                  B != nullptr ? B->template Data<T>() : nullptr,
+                  Y->template MutableData<T>(),
+                  static_cast<size_t>(X->Shape().Size()),
+                  static_cast<size_t>(bias_len),
+                  ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,10 +8,10 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "assert.h"
-#ifndef USE_OPENMP
-#include "core/util/eigen_common_wrapper.h"
-#endif
+#include <algorithm>
 
 namespace onnxruntime {
 namespace contrib {
@@ -20,73 +20,72 @@ namespace contrib {
 //\param a: matrix with shape of[ma,n]
 //\param b: matrix with shape of[mb,n]
 //\param dest: matrix with shape of [ma,mb]
+// The rows of dest are independent, so they are split across the threads.
 template <typename T, typename ElemFunc>
-void cdist_single_threaded(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n) {
-  ElemFunc f;
-  for (size_t i = 0; i != ma; ++i) {
-    const T* a1 = a + n * i;
-    for (size_t j = 0; j != mb; ++j) {
-      const T* b1 = b + n * j;
-      *dest++ = f(a1, b1, n);
-    }
-  }
+void cdist(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, concurrency::ThreadPool* tp) {
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(ma), static_cast<double>(3 * n * mb),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        ElemFunc f;
+        T* dest_local = dest + first * mb;
+        for (std::ptrdiff_t i = first; i != last; ++i) {
+          const T* a1 = a + n * i;
+          for (size_t j = 0; j != mb; ++j) {
+            const T* b1 = b + n * j;
+            *dest_local++ = f(a1, b1, n);
+          }
+        }
+      });
 }
 
-template <typename T, typename ElemFunc>
-class CDistOneBlock {
- public:
-  const T* a;
-  const T* b;
-  T* dest;
-  size_t mb;
-  size_t n;
+// dest = -2 * a * b^T
+inline void cdist_cross_products(const float* a, const float* b, float* dest, size_t ma, size_t mb, size_t n,
+                                 concurrency::ThreadPool* tp) {
+  MlasGemm(CblasNoTrans, CblasTrans, ma, mb, n, -2.f, a, n, b, n, 0.f, dest, mb, tp);
+}
 
-  CDistOneBlock(const T* a1, const T* b1, T* dest1, size_t mb1, size_t n1)
-      : a(a1), b(b1), dest(dest1), mb(mb1), n(n1) {}
+inline void cdist_cross_products(const double* a, const double* b, double* dest, size_t ma, size_t mb, size_t n,
+                                 concurrency::ThreadPool* tp) {
+#if defined(_M_AMD64) || defined(__x86_64__)
+  MlasGemm(CblasNoTrans, CblasTrans, ma, mb, n, -2., a, n, b, n, 0., dest, mb, tp);
+#else
+  ORT_UNUSED_PARAMETER(tp);
+  EigenMatrixMapRowMajor<double>(dest, ma, mb).noalias() =
+      -2. * ConstEigenMatrixMapRowMajor<double>(a, ma, n) * ConstEigenMatrixMapRowMajor<double>(b, mb, n).transpose();
+#endif
+}
 
-  void operator()(Eigen::Index start, Eigen::Index end) {
-    Eigen::Index mb_local = mb;
-    Eigen::Index i = start / mb_local;
-    Eigen::Index j = start - i * mb_local;
-    assert(i * mb_local + j == start);
-    Eigen::Index i_end = end / mb_local;
-    Eigen::Index j_end = end - i_end * mb_local;
-    assert(i_end * mb_local + j_end == end);
+// Computes the squared euclidean distances as |a|^2 + |b|^2 - 2 * a * b^T, so most of the work is a GEMM.
+// The distances are the square roots of these if take_sqrt is set.
+template <typename T>
+void cdist_gemm(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, bool take_sqrt,
+                concurrency::ThreadPool* tp) {
+  cdist_cross_products(a, b, dest, ma, mb, n, tp);
 
-    T* dest_local = dest + start;
-    ElemFunc f;
-    const T* a1 = a + n * i;
-    for (; i != i_end; ++i) {
-      a1 = a + n * i;
-      for (; j != mb_local; ++j) {
-        const T* b1 = b + n * j;
-        *dest_local++ = f(a1, b1, n);
-      }
-      j = 0;
-    }
-    a1 = a + n * i;
-    for (j = 0; j != j_end; ++j) {
-      const T* b1 = b + n * j;
-      *dest_local++ = f(a1, b1, n);
-    }
-    assert(dest_local == dest + end);
-  }
-};
+  std::vector<T> norms(ma + mb);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(ma + mb), static_cast<double>(2 * n),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i != last; ++i) {
+          const T* row = static_cast<size_t>(i) < ma ? a + n * i : b + n * (i - ma);
+          norms[i] = ConstEigenVectorMap<T>(row, n).squaredNorm();
+        }
+      });
 
-template <typename T, typename ElemFunc>
-void cdist(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, concurrency::ThreadPool* tp) {
-#ifndef USE_OPENMP
-  if (tp == nullptr) {
-#else
-  (void)tp;
-#endif
-    return cdist_single_threaded<T, ElemFunc>(a, b, dest, ma, mb, n);
-#ifndef USE_OPENMP
-  }
-  Eigen::ThreadPoolDevice device(&tp->GetHandler(), tp->NumThreads());
-  device.parallelFor(ma * mb, Eigen::TensorOpCost(0, 0, static_cast<double>(3 * n)),
-                     CDistOneBlock<T, ElemFunc>(a, b, dest, mb, n));
-#endif
+  const T* a_norms = norms.data();
+  const T* b_norms = norms.data() + ma;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(ma), static_cast<double>(4 * mb),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i != last; ++i) {
+          T* dest_row = dest + mb * i;
+          for (size_t j = 0; j != mb; ++j) {
+            // rounding may leave the distance of (nearly) equal vectors slightly negative
+            const T d = std::max(dest_row[j] + a_norms[i] + b_norms[j], T(0));
+            dest_row[j] = take_sqrt ? std::sqrt(d) : d;
+          }
+        }
+      });
 }
 
 template <typename T>
@@ -134,14 +133,13 @@ class CDist final : public OpKernel {
     switch (mode_) {
       case EUCLIDEAN:
         if (shape_a[1] >= 8)
-          cdist<T, EuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+          cdist_gemm<T>(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], true, tp);
         else  // for smaller vector size, a raw loop is better
           cdist<T, Euclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
         break;
       case SQEUCLIDEAN:
         if (shape_a[1] >= 8)
-          cdist<T, SqeuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1],
-                                             tp);
+          cdist_gemm<T>(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], false, tp);
         else  // for smaller vector size, a raw loop is better
           cdist<T, Sqeuclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
         break;
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/rnn/deep_cpu_lstm.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using namespace rnn::detail;
+
+// LSTM with int8 W and R. The input and recurrent projections run as QGEMMs on the dynamically quantized
+// input and hidden state, and everything else is shared with the float LSTM.
+class DynamicQuantizeLSTM final : public DeepCpuLstmOp {
+ public:
+  DynamicQuantizeLSTM(const OpKernelInfo& info) : DeepCpuLstmOp(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // W and R transposed by PrePack if they are constant initializers
+  TransposedQuantizedWeights transposed_W_;
+  TransposedQuantizedWeights transposed_R_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicQuantizeLSTM,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>()),
+    DynamicQuantizeLSTM);
+
+Status DynamicQuantizeLSTM::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (input_idx == 1 || input_idx == 2) {
+    ORT_RETURN_IF_ERROR(TransposeQuantizedWeights(tensor, input_idx == 1 ? transposed_W_ : transposed_R_));
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeLSTM::Compute(OpKernelContext* context) const {
+  const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
+  const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
+  const Tensor& W_scale = *context->Input<Tensor>(8);
+  const Tensor* W_zero_point = context->Input<Tensor>(9);
+  const Tensor& R_scale = *context->Input<Tensor>(10);
+  const Tensor* R_zero_point = context->Input<Tensor>(11);
+
+  const int N = 4 * hidden_size_;
+
+  std::vector<float> W_scales, R_scales;
+  std::vector<int8_t> W_zero_points, R_zero_points;
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(W_scale, W_zero_point, num_directions_, N,
+                                                      W_scales, W_zero_points));
+  ORT_RETURN_IF_ERROR(GetWeightQuantizationParameters(R_scale, R_zero_point, num_directions_, N,
+                                                      R_scales, R_zero_points));
+
+  // transpose the weights here if they could not be transposed by PrePack
+  TransposedQuantizedWeights local_W, local_R;
+  const TransposedQuantizedWeights* transposed_W = &transposed_W_;
+  if (!transposed_W_.IsTransposed(W.Shape())) {
+    ORT_RETURN_IF_ERROR(TransposeQuantizedWeights(W, local_W));
+    transposed_W = &local_W;
+  }
+
+  const TransposedQuantizedWeights* transposed_R = &transposed_R_;
+  if (!transposed_R_.IsTransposed(R.Shape())) {
+    ORT_RETURN_IF_ERROR(TransposeQuantizedWeights(R, local_R));
+    transposed_R = &local_R;
+  }
+
+  const int64_t input_weights_size_per_direction = W.Shape().Size() / num_directions_;
+  const int64_t recurrent_weights_size_per_direction = R.Shape().Size() / num_directions_;
+
+  std::vector<GemmWeights<float>> input_weights;
+  std::vector<GemmWeights<float>> recurrent_weights;
+  for (int direction = 0; direction < num_directions_; ++direction) {
+    input_weights.emplace_back(QuantizedWeights{
+        transposed_W->buffer_.data() + direction * input_weights_size_per_direction, N,
+        W_scales.data() + direction * N, W_zero_points.data() + direction * N});
+    recurrent_weights.emplace_back(QuantizedWeights{
+        transposed_R->buffer_.data() + direction * recurrent_weights_size_per_direction, N,
+        R_scales.data() + direction * N, R_zero_points.data() + direction * N});
+  }
+
+  return ComputeImpl<float>(*context, input_weights, recurrent_weights);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul of a float A with a quantized B. A is quantized to uint8 with its range, and the QGEMM output stage
+// scales the accumulators back to float and adds the bias, so the int32 result of MatMulInteger, the Cast and the
+// Mul nodes the fusion replaced never reach memory.
+template <typename T>
+class DynamicQuantizeMatMul final : public OpKernel {
+ public:
+  DynamicQuantizeMatMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* ctx) const override;
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeMatMul<uint8_t>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    int8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>()),
+    DynamicQuantizeMatMul<int8_t>);
+
+// number of elements of A each thread finds the range of and quantizes at a time
+static constexpr std::ptrdiff_t kQuantizeBlockSize = 16384;
+
+// Quantizes A to uint8 with the scale and zero point of its range, like DynamicQuantizeLinear.
+static void DynamicQuantizeA(const float* A, uint8_t* quantized_A, std::ptrdiff_t size, float& scale,
+                             uint8_t& zero_point, concurrency::ThreadPool* thread_pool) {
+  const std::ptrdiff_t block_count = (size + kQuantizeBlockSize - 1) / kQuantizeBlockSize;
+
+  // the range includes 0 so that 0 is exactly representable
+  std::vector<float> block_min(static_cast<size_t>(block_count), 0.f);
+  std::vector<float> block_max(static_cast<size_t>(block_count), 0.f);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, block_count, static_cast<double>(kQuantizeBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const std::ptrdiff_t begin = block * kQuantizeBlockSize;
+          const size_t count = static_cast<size_t>(std::min(kQuantizeBlockSize, size - begin));
+          float min, max;
+          MlasFindMinMaxElement(A + begin, &min, &max, count);
+          block_min[block] = std::min(block_min[block], min);
+          block_max[block] = std::max(block_max[block], max);
+        }
+      });
+
+  const float min = *std::min_element(block_min.begin(), block_min.end());
+  const float max = *std::max_element(block_max.begin(), block_max.end());
+
+  // A is all zeros if the range is empty. any scale works.
+  scale = (max - min) / 255.f;
+  if (scale == 0.f) {
+    scale = 1.f;
+  }
+  zero_point = static_cast<uint8_t>(std::nearbyint(std::max(0.f, std::min(255.f, -min / scale))));
+
+  const float quantize_scale = scale;
+  const uint8_t quantize_zero_point = zero_point;
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, block_count, static_cast<double>(kQuantizeBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const std::ptrdiff_t begin = block * kQuantizeBlockSize;
+          const size_t count = static_cast<size_t>(std::min(kQuantizeBlockSize, size - begin));
+          MlasQuantizeLinear(A + begin, quantized_A + begin, count, quantize_scale, quantize_zero_point);
+        }
+      });
+}
+
+template <typename T>
+Status DynamicQuantizeMatMul<T>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  const Tensor* b_scale = ctx->Input<Tensor>(2);
+  const Tensor* b_zero_point = ctx->Input<Tensor>(3);
+  const Tensor* bias = ctx->Input<Tensor>(4);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  const int64_t N = helper.N();
+
+  // b_scale and b_zero_point are a scalar or have a value for each column of B
+  const bool per_column = !IsScalarOr1ElementVector(b_scale);
+  ORT_RETURN_IF_NOT(!per_column || (b_scale->Shape().NumDimensions() == 1 && b_scale->Shape()[0] == N),
+                    "DynamicQuantizeMatMul: b_scale must be a scalar or 1D tensor with one value per column. Got ",
+                    b_scale->Shape(), " for ", N, " columns");
+
+  T b_offset = 0;
+  const T* b_column_offsets = nullptr;
+  if (b_zero_point != nullptr) {
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      b_offset = *b_zero_point->template Data<T>();
+    } else {
+      ORT_RETURN_IF_NOT(b_zero_point->Shape().NumDimensions() == 1 && b_zero_point->Shape()[0] == N,
+                        "DynamicQuantizeMatMul: b_zero_point must be a scalar or 1D tensor with one value per "
+                        "column. Got ",
+                        b_zero_point->Shape(), " for ", N, " columns");
+      b_column_offsets = b_zero_point->template Data<T>();
+    }
+  }
+
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().NumDimensions() == 1 && bias->Shape()[0] == N,
+                      "DynamicQuantizeMatMul: bias must be a 1D tensor with one value per column. Got ",
+                      bias->Shape(), " for ", N, " columns");
+  }
+
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // an empty inner dimension leaves only the bias
+  if (helper.K() == 0) {
+    float* y_data = y->template MutableData<float>();
+    const int64_t y_size = y->Shape().Size();
+    for (int64_t i = 0; i < y_size; i++) {
+      y_data[i] = bias != nullptr ? bias->template Data<float>()[i % N] : 0.f;
+    }
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  const std::ptrdiff_t a_size = static_cast<std::ptrdiff_t>(a->Shape().Size());
+  auto quantized_a = IAllocator::MakeUniquePtr<uint8_t>(allocator, static_cast<size_t>(a_size));
+  float a_scale;
+  uint8_t a_offset;
+  DynamicQuantizeA(a->template Data<float>(), quantized_a.get(), a_size, a_scale, a_offset, thread_pool);
+
+  // the output stage multiplies the accumulators by the product of the scales of A and B
+  const float* b_scale_data = b_scale->template Data<float>();
+  std::vector<float> output_scales(per_column ? static_cast<size_t>(N) : 1);
+  for (size_t n = 0; n < output_scales.size(); n++) {
+    output_scales[n] = a_scale * b_scale_data[n];
+  }
+
+  MLAS_QGEMM_OUTPUT_STAGE output_stage = {};
+  output_stage.Scale = output_scales.data();
+  output_stage.PerColumnScale = per_column;
+  output_stage.Bias = bias != nullptr ? bias->template Data<float>() : nullptr;
+  output_stage.ldOutput = static_cast<size_t>(N);
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t K = static_cast<size_t>(helper.K());
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    output_stage.Output = y->template MutableData<float>() + helper.OutputOffsets()[i];
+    const uint8_t* a_data = quantized_a.get() + helper.LeftOffsets()[i];
+    const T* b_data = b->template Data<T>() + helper.RightOffsets()[i];
+    if (b_column_offsets != nullptr) {
+      MlasGemm(M, static_cast<size_t>(N), K, a_data, K, a_offset, b_data, static_cast<size_t>(N), b_column_offsets,
+               nullptr, 0, &output_stage, thread_pool);
+    } else {
+      MlasGemm(M, static_cast<size_t>(N), K, a_data, K, a_offset, b_data, static_cast<size_t>(N), b_offset,
+               nullptr, 0, &output_stage, thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,300 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/einsum.h"
+
+#include <algorithm>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    Einsum,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Einsum);
+
+namespace {
+
+int64_t Product(const std::vector<int>& labels, const std::vector<int64_t>& label_sizes) {
+  int64_t product = 1;
+  for (int label : labels) {
+    product *= label_sizes[label];
+  }
+  return product;
+}
+
+// The offset of element 'index' of the first 'count' labels of a row major buffer of the given sizes, in an
+// operand with the given strides.
+int64_t Offset(int64_t index, const std::vector<int64_t>& sizes, const std::vector<int64_t>& strides, size_t count) {
+  int64_t offset = 0;
+  for (size_t i = count; i-- > 0;) {
+    offset += (index % sizes[i]) * strides[i];
+    index /= sizes[i];
+  }
+  return offset;
+}
+
+// Sums the labels of an operand that are not kept into a buffer holding the kept labels in order, which also copies
+// the operand to a transposed layout when all of its labels are kept.
+void Reduce(const float* input, const EinsumOperand& operand, const std::vector<int>& kept_labels,
+            const std::vector<int64_t>& label_sizes, float* output, concurrency::ThreadPool* tp) {
+  std::vector<int64_t> kept_sizes;
+  std::vector<int64_t> kept_strides;
+  for (int label : kept_labels) {
+    kept_sizes.push_back(label_sizes[label]);
+    kept_strides.push_back(operand.Stride(label));
+  }
+
+  // the summed labels from the largest stride to the smallest, so the innermost loop has the best locality
+  std::vector<int> summed_labels;
+  for (int label : operand.labels) {
+    if (std::find(kept_labels.begin(), kept_labels.end(), label) == kept_labels.end()) {
+      summed_labels.push_back(label);
+    }
+  }
+  std::stable_sort(summed_labels.begin(), summed_labels.end(),
+                   [&operand](int a, int b) { return operand.Stride(a) > operand.Stride(b); });
+  std::vector<int64_t> summed_sizes;
+  std::vector<int64_t> summed_strides;
+  for (int label : summed_labels) {
+    summed_sizes.push_back(label_sizes[label]);
+    summed_strides.push_back(operand.Stride(label));
+  }
+
+  const int64_t output_size = Product(kept_labels, label_sizes);
+  const int64_t summed_size = Product(summed_labels, label_sizes);
+
+  if (!kept_labels.empty() && (summed_labels.empty() || kept_strides.back() < summed_strides.back())) {
+    // The innermost kept label has the smallest stride, so each row of the output accumulates rows of the input.
+    const int64_t row_size = kept_sizes.back();
+    const int64_t row_stride = kept_strides.back();
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(output_size / row_size), static_cast<double>(row_size * summed_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row < last; ++row) {
+            float* output_row = output + row * row_size;
+            const int64_t row_offset = Offset(row, kept_sizes, kept_strides, kept_labels.size() - 1);
+            for (int64_t i = 0; i < summed_size; ++i) {
+              const float* input_row =
+                  input + row_offset + Offset(i, summed_sizes, summed_strides, summed_labels.size());
+              if (row_stride == 1) {
+                EigenVectorArrayMap<float> output_map(output_row, row_size);
+                ConstEigenVectorArrayMap<float> input_map(input_row, row_size);
+                if (i == 0) {
+                  output_map = input_map;
+                } else {
+                  output_map += input_map;
+                }
+              } else {
+                for (int64_t j = 0; j < row_size; ++j) {
+                  output_row[j] = (i == 0 ? 0.0f : output_row[j]) + input_row[j * row_stride];
+                }
+              }
+            }
+          }
+        });
+    return;
+  }
+
+  // Each element of the output sums runs of the innermost summed label.
+  const int64_t run_size = summed_labels.empty() ? 1 : summed_sizes.back();
+  const int64_t run_stride = summed_labels.empty() ? 0 : summed_strides.back();
+  const size_t num_outer_labels = summed_labels.empty() ? 0 : summed_labels.size() - 1;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(output_size), static_cast<double>(summed_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t index = first; index < last; ++index) {
+          const int64_t offset = Offset(index, kept_sizes, kept_strides, kept_labels.size());
+          float sum = 0.0f;
+          for (int64_t i = 0; i < summed_size / run_size; ++i) {
+            const float* run = input + offset + Offset(i, summed_sizes, summed_strides, num_outer_labels);
+            if (run_stride == 1) {
+              sum += ConstEigenVectorArrayMap<float>(run, run_size).sum();
+            } else {
+              for (int64_t j = 0; j < run_size; ++j) {
+                sum += run[j * run_stride];
+              }
+            }
+          }
+          output[index] = sum;
+        }
+      });
+}
+
+// An operand of a contraction as a batch of matrices.
+struct Matrix {
+  const float* data;
+  EinsumOperand operand;
+  bool transpose;
+  int64_t ld;
+  BufferUniquePtr buffer;
+};
+
+// Reads the operand in place as a batch of row_labels x column_labels matrices if it can, otherwise copies it to a
+// contiguous buffer in that order.
+Matrix GetMatrix(const float* data, const EinsumOperand& operand, const std::vector<int>& batch_labels,
+                 const std::vector<int>& row_labels, const std::vector<int>& column_labels,
+                 const std::vector<int64_t>& label_sizes, const AllocatorPtr& alloc, concurrency::ThreadPool* tp) {
+  Matrix matrix{data, operand, false, 0, nullptr};
+  if (EinsumGetMatrix(operand, row_labels, column_labels, label_sizes, matrix.transpose, matrix.ld)) {
+    return matrix;
+  }
+
+  std::vector<int> labels(batch_labels);
+  labels.insert(labels.end(), row_labels.begin(), row_labels.end());
+  labels.insert(labels.end(), column_labels.begin(), column_labels.end());
+  matrix.buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * Product(labels, label_sizes)), BufferDeleter(alloc));
+  float* buffer = static_cast<float*>(matrix.buffer.get());
+  Reduce(data, operand, labels, label_sizes, buffer, tp);
+  matrix.data = buffer;
+  matrix.operand = EinsumOperand::Contiguous(labels, label_sizes);
+  matrix.transpose = false;
+  matrix.ld = Product(column_labels, label_sizes);
+  return matrix;
+}
+
+void Contract(const EinsumStep& step, const float* a_data, const EinsumOperand& a_operand, const float* b_data,
+              const EinsumOperand& b_operand, const std::vector<int64_t>& label_sizes, float* output,
+              const AllocatorPtr& alloc, concurrency::ThreadPool* tp) {
+  const Matrix a = GetMatrix(a_data, a_operand, step.batch_labels, step.m_labels, step.k_labels, label_sizes, alloc,
+                             tp);
+  const Matrix b = GetMatrix(b_data, b_operand, step.batch_labels, step.k_labels, step.n_labels, label_sizes, alloc,
+                             tp);
+
+  const int64_t M = Product(step.m_labels, label_sizes);
+  const int64_t N = Product(step.n_labels, label_sizes);
+  const int64_t K = Product(step.k_labels, label_sizes);
+  const int64_t batch_size = Product(step.batch_labels, label_sizes);
+
+  std::vector<int64_t> batch_sizes;
+  std::vector<int64_t> a_batch_strides;
+  std::vector<int64_t> b_batch_strides;
+  for (int label : step.batch_labels) {
+    batch_sizes.push_back(label_sizes[label]);
+    a_batch_strides.push_back(a.operand.Stride(label));
+    b_batch_strides.push_back(b.operand.Stride(label));
+  }
+
+  if (M == 1 && N == 1) {
+    // a batch of dot products, which are too small for GEMMs
+    const int64_t a_stride = a.transpose ? a.ld : 1;
+    const int64_t b_stride = b.transpose ? 1 : b.ld;
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(batch_size), static_cast<double>(2 * K),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const float* a_row = a.data + Offset(i, batch_sizes, a_batch_strides, batch_sizes.size());
+            const float* b_row = b.data + Offset(i, batch_sizes, b_batch_strides, batch_sizes.size());
+            float sum = 0.0f;
+            if (a_stride == 1 && b_stride == 1) {
+              sum = (ConstEigenVectorArrayMap<float>(a_row, K) * ConstEigenVectorArrayMap<float>(b_row, K)).sum();
+            } else {
+              for (int64_t k = 0; k < K; ++k) {
+                sum += a_row[k * a_stride] * b_row[k * b_stride];
+              }
+            }
+            output[i] = sum;
+          }
+        });
+    return;
+  }
+
+  std::vector<const float*> a_matrices(batch_size);
+  std::vector<const float*> b_matrices(batch_size);
+  std::vector<float*> c_matrices(batch_size);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    a_matrices[i] = a.data + Offset(i, batch_sizes, a_batch_strides, batch_sizes.size());
+    b_matrices[i] = b.data + Offset(i, batch_sizes, b_batch_strides, batch_sizes.size());
+    c_matrices[i] = output + i * M * N;
+  }
+
+  MlasGemmBatch(a.transpose ? CblasTrans : CblasNoTrans,
+                b.transpose ? CblasTrans : CblasNoTrans,
+                static_cast<size_t>(M),
+                static_cast<size_t>(N),
+                static_cast<size_t>(K),
+                1.0f,
+                a_matrices.data(),
+                static_cast<size_t>(a.ld),
+                b_matrices.data(),
+                static_cast<size_t>(b.ld),
+                0.0f,
+                c_matrices.data(),
+                static_cast<size_t>(N),
+                static_cast<size_t>(batch_size),
+                tp);
+}
+
+}  // namespace
+
+Einsum::Einsum(const OpKernelInfo& info) : OpKernel(info) {
+  std::string equation;
+  ORT_ENFORCE(info.GetAttr<std::string>("equation", &equation).IsOK(), "Einsum requires the equation attribute");
+  ORT_THROW_IF_ERROR(EinsumEquation::Parse(equation, equation_));
+}
+
+Status Einsum::Compute(OpKernelContext* context) const {
+  const size_t num_inputs = static_cast<size_t>(context->InputCount());
+  std::vector<const TensorShape*> input_shapes;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    input_shapes.push_back(&context->Input<Tensor>(static_cast<int>(i))->Shape());
+  }
+
+  EinsumComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(equation_, input_shapes));
+
+  Tensor* Y = context->Output(0, helper.OutputShape());
+  float* output = Y->MutableData<float>();
+  if (helper.HasEmptyLabel()) {
+    std::fill_n(output, Y->Shape().Size(), 0.0f);
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  const auto& label_sizes = helper.LabelSizes();
+  const auto& operands = helper.Operands();
+  const auto& steps = helper.Steps();
+
+  // the data of each operand, and the buffers of the intermediate results that a later step still reads
+  std::vector<const float*> data(operands.size());
+  std::vector<BufferUniquePtr> buffers(operands.size());
+  for (size_t i = 0; i < num_inputs; ++i) {
+    data[i] = context->Input<Tensor>(static_cast<int>(i))->Data<float>();
+  }
+
+  for (size_t s = 0; s < steps.size(); ++s) {
+    const auto& step = steps[s];
+    const size_t result = num_inputs + s;
+    float* result_data = output;
+    if (s + 1 < steps.size()) {
+      const int64_t size = Product(operands[result].labels, label_sizes);
+      buffers[result] = BufferUniquePtr(alloc->Alloc(sizeof(float) * size), BufferDeleter(alloc));
+      result_data = static_cast<float*>(buffers[result].get());
+    }
+
+    if (step.is_contraction) {
+      Contract(step, data[step.input0], operands[step.input0], data[step.input1], operands[step.input1],
+               label_sizes, result_data, alloc, tp);
+      buffers[step.input1].reset();
+    } else {
+      Reduce(data[step.input0], operands[step.input0], step.kept_labels, label_sizes, result_data, tp);
+    }
+    buffers[step.input0].reset();
+    data[result] = result_data;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/einsum_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates an Einsum as the pairwise contractions planned by EinsumComputeHelper. Each contraction is a batch of
+// GEMMs that read the operands in place through their strides when the labels of each group are evenly strided, and
+// the labels summed before a contraction or at the end are reduced with vectorized loops.
+class Einsum final : public OpKernel {
+ public:
+  explicit Einsum(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  EinsumEquation equation_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
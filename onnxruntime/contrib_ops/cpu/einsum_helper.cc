@@ -0,0 +1,414 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/einsum_helper.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+Status ParseTerm(const std::string& term, std::vector<int>& labels) {
+  labels.clear();
+  bool has_ellipsis = false;
+  for (size_t i = 0; i < term.size(); ++i) {
+    const char c = term[i];
+    if (c >= 'A' && c <= 'Z') {
+      labels.push_back(c - 'A');
+    } else if (c >= 'a' && c <= 'z') {
+      labels.push_back(26 + (c - 'a'));
+    } else if (c == '.') {
+      if (has_ellipsis || term.compare(i, 3, "...") != 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum term '", term,
+                               "' must have at most one ellipsis of three dots");
+      }
+      has_ellipsis = true;
+      labels.push_back(EinsumEquation::kEllipsis);
+      i += 2;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum term '", term, "' has an invalid character '", c,
+                             "'");
+    }
+  }
+  return Status::OK();
+}
+
+// The dimensions of a term for an input of the given rank, with the ellipsis expanded to the labels of the last of
+// the ellipsis dimensions, which are broadcast from the right.
+Status ExpandTerm(const std::vector<int>& term, size_t rank, size_t ellipsis_rank, std::vector<int>& labels) {
+  const auto ellipsis = std::find(term.begin(), term.end(), EinsumEquation::kEllipsis);
+  const size_t num_letters = term.size() - (ellipsis != term.end() ? 1 : 0);
+  if (ellipsis == term.end() ? rank != num_letters : rank < num_letters) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum input of rank ", rank, " doesn't match its term of ",
+                           num_letters, " labels");
+  }
+
+  labels.clear();
+  for (int label : term) {
+    if (label != EinsumEquation::kEllipsis) {
+      labels.push_back(label);
+      continue;
+    }
+    const size_t term_ellipsis_rank = rank - num_letters;
+    for (size_t i = ellipsis_rank - term_ellipsis_rank; i < ellipsis_rank; ++i) {
+      labels.push_back(EinsumEquation::kNumLetters + static_cast<int>(i));
+    }
+  }
+  return Status::OK();
+}
+
+template <typename Fn>
+void SortLabels(std::vector<int>& labels, Fn key) {
+  std::stable_sort(labels.begin(), labels.end(), [&key](int a, int b) { return key(a) < key(b); });
+}
+
+}  // namespace
+
+constexpr int EinsumEquation::kNumLetters;
+constexpr int EinsumEquation::kEllipsis;
+
+Status EinsumEquation::Parse(const std::string& equation, EinsumEquation& parsed) {
+  std::string compact;
+  for (char c : equation) {
+    if (c != ' ') {
+      compact.push_back(c);
+    }
+  }
+
+  parsed = EinsumEquation();
+  const auto arrow = compact.find("->");
+  parsed.has_output_term_ = arrow != std::string::npos;
+  const std::string inputs = compact.substr(0, arrow);
+  if (parsed.has_output_term_) {
+    const std::string output = compact.substr(arrow + 2);
+    if (output.find_first_of(",-") != std::string::npos) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum equation '", equation, "' has an invalid output");
+    }
+    ORT_RETURN_IF_ERROR(ParseTerm(output, parsed.output_term_));
+  }
+
+  size_t begin = 0;
+  for (;;) {
+    const auto end = inputs.find(',', begin);
+    parsed.input_terms_.emplace_back();
+    ORT_RETURN_IF_ERROR(ParseTerm(inputs.substr(begin, end - begin), parsed.input_terms_.back()));
+    if (end == std::string::npos) {
+      break;
+    }
+    begin = end + 1;
+  }
+
+  return Status::OK();
+}
+
+bool EinsumOperand::HasLabel(int label) const {
+  return std::find(labels.begin(), labels.end(), label) != labels.end();
+}
+
+int64_t EinsumOperand::Stride(int label) const {
+  const auto it = std::find(labels.begin(), labels.end(), label);
+  return it != labels.end() ? strides[it - labels.begin()] : 0;
+}
+
+EinsumOperand EinsumOperand::Contiguous(const std::vector<int>& labels, const std::vector<int64_t>& label_sizes) {
+  EinsumOperand operand;
+  operand.labels = labels;
+  operand.strides.resize(labels.size());
+  int64_t stride = 1;
+  for (size_t i = labels.size(); i-- > 0;) {
+    operand.strides[i] = stride;
+    stride *= label_sizes[labels[i]];
+  }
+  return operand;
+}
+
+std::vector<int> EinsumStep::ResultLabels() const {
+  if (!is_contraction) {
+    return kept_labels;
+  }
+  std::vector<int> labels(batch_labels);
+  labels.insert(labels.end(), m_labels.begin(), m_labels.end());
+  labels.insert(labels.end(), n_labels.begin(), n_labels.end());
+  return labels;
+}
+
+Status EinsumComputeHelper::Compute(const EinsumEquation& equation,
+                                    const std::vector<const TensorShape*>& input_shapes) {
+  const auto& terms = equation.InputTerms();
+  if (terms.size() != input_shapes.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum equation has ", terms.size(), " terms for ",
+                           input_shapes.size(), " inputs");
+  }
+
+  size_t ellipsis_rank = 0;
+  for (size_t i = 0; i < terms.size(); ++i) {
+    const size_t num_letters = static_cast<size_t>(
+        std::count_if(terms[i].begin(), terms[i].end(), [](int label) { return label != EinsumEquation::kEllipsis; }));
+    if (input_shapes[i]->NumDimensions() > num_letters) {
+      ellipsis_rank = std::max(ellipsis_rank, input_shapes[i]->NumDimensions() - num_letters);
+    }
+  }
+
+  // the size of each label, -1 for the letters that no input has
+  label_sizes_.assign(EinsumEquation::kNumLetters + ellipsis_rank, -1);
+  std::fill(label_sizes_.begin() + EinsumEquation::kNumLetters, label_sizes_.end(), 1);
+  std::vector<int> label_counts(label_sizes_.size(), 0);
+
+  std::vector<std::vector<int>> input_labels(terms.size());
+  for (size_t i = 0; i < terms.size(); ++i) {
+    const auto& dims = input_shapes[i]->GetDims();
+    ORT_RETURN_IF_ERROR(ExpandTerm(terms[i], dims.size(), ellipsis_rank, input_labels[i]));
+    for (size_t d = 0; d < dims.size(); ++d) {
+      const int label = input_labels[i][d];
+      ++label_counts[label];
+      auto& label_size = label_sizes_[label];
+      if (label < EinsumEquation::kNumLetters ? label_size == -1 : label_size == 1) {
+        label_size = dims[d];
+      } else if (dims[d] != label_size && (label < EinsumEquation::kNumLetters || dims[d] != 1)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Einsum input ", i, " has dimension ", d, " of size ",
+                               dims[d], " where the size of its label is ", label_size);
+      }
+    }
+  }
+
+  std::vector<int> output_term_labels;
+  if (equation.HasOutputTerm()) {
+    for (int label : equation.OutputTerm()) {
+      if (label == EinsumEquation::kEllipsis) {
+        for (size_t i = 0; i < ellipsis_rank; ++i) {
+          output_term_labels.push_back(EinsumEquation::kNumLetters + static_cast<int>(i));
+        }
+      } else if (label_sizes_[label] == -1 ||
+                 std::find(output_term_labels.begin(), output_term_labels.end(), label) != output_term_labels.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Einsum output labels must be distinct labels of the inputs");
+      } else {
+        output_term_labels.push_back(label);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < ellipsis_rank; ++i) {
+      output_term_labels.push_back(EinsumEquation::kNumLetters + static_cast<int>(i));
+    }
+    for (int label = 0; label < EinsumEquation::kNumLetters; ++label) {
+      if (label_counts[label] == 1) {
+        output_term_labels.push_back(label);
+      }
+    }
+  }
+
+  std::vector<int64_t> output_dims;
+  output_labels_.clear();
+  for (int label : output_term_labels) {
+    output_dims.push_back(label_sizes_[label]);
+    if (label_sizes_[label] != 1) {
+      output_labels_.push_back(label);
+    }
+  }
+  output_shape_ = TensorShape(output_dims);
+
+  has_empty_label_ = std::find(label_sizes_.begin(), label_sizes_.end(), 0) != label_sizes_.end();
+
+  operands_.clear();
+  for (size_t i = 0; i < terms.size(); ++i) {
+    const auto& dims = input_shapes[i]->GetDims();
+    EinsumOperand operand;
+    int64_t stride = 1;
+    for (size_t d = dims.size(); d-- > 0;) {
+      const int label = input_labels[i][d];
+      if (label_sizes_[label] != 1) {
+        // a broadcast dimension stays at index 0
+        const int64_t label_stride = dims[d] == 1 ? 0 : stride;
+        const auto it = std::find(operand.labels.begin(), operand.labels.end(), label);
+        if (it != operand.labels.end()) {
+          operand.strides[it - operand.labels.begin()] += label_stride;
+        } else {
+          operand.labels.insert(operand.labels.begin(), label);
+          operand.strides.insert(operand.strides.begin(), label_stride);
+        }
+      }
+      stride *= dims[d];
+    }
+    operands_.push_back(std::move(operand));
+  }
+
+  steps_.clear();
+  if (!has_empty_label_) {
+    Plan(terms.size());
+  }
+
+  return Status::OK();
+}
+
+void EinsumComputeHelper::AddStep(EinsumStep&& step) {
+  operands_.push_back(EinsumOperand::Contiguous(step.ResultLabels(), label_sizes_));
+  steps_.push_back(std::move(step));
+}
+
+void EinsumComputeHelper::Plan(size_t num_inputs) {
+  std::vector<size_t> remaining(num_inputs);
+  for (size_t i = 0; i < num_inputs; ++i) {
+    remaining[i] = i;
+  }
+
+  // whether a label is in the output or in a remaining operand other than a and b, which a step still needs
+  auto is_needed = [this, &remaining](int label, size_t a, size_t b) {
+    if (std::find(output_labels_.begin(), output_labels_.end(), label) != output_labels_.end()) {
+      return true;
+    }
+    return std::any_of(remaining.begin(), remaining.end(), [this, label, a, b](size_t operand) {
+      return operand != a && operand != b && operands_[operand].HasLabel(label);
+    });
+  };
+
+  while (remaining.size() > 1) {
+    // contract the pair of operands with the smallest result
+    size_t best_i = 0;
+    size_t best_j = 1;
+    double best_size = -1.0;
+    for (size_t i = 0; i < remaining.size(); ++i) {
+      for (size_t j = i + 1; j < remaining.size(); ++j) {
+        const auto& a = operands_[remaining[i]];
+        const auto& b = operands_[remaining[j]];
+        double size = 1.0;
+        for (int label : a.labels) {
+          if (is_needed(label, remaining[i], remaining[j])) {
+            size *= static_cast<double>(label_sizes_[label]);
+          }
+        }
+        for (int label : b.labels) {
+          if (!a.HasLabel(label) && is_needed(label, remaining[i], remaining[j])) {
+            size *= static_cast<double>(label_sizes_[label]);
+          }
+        }
+        if (best_size < 0.0 || size < best_size) {
+          best_i = i;
+          best_j = j;
+          best_size = size;
+        }
+      }
+    }
+
+    size_t a = remaining[best_i];
+    size_t b = remaining[best_j];
+    const bool is_last = remaining.size() == 2;
+    remaining.erase(remaining.begin() + best_j);
+    remaining.erase(remaining.begin() + best_i);
+
+    // sum the labels that only one of the operands has and no later step needs
+    for (size_t* operand : {&a, &b}) {
+      const size_t other = operand == &a ? b : a;
+      EinsumStep reduction;
+      reduction.input0 = *operand;
+      for (int label : operands_[*operand].labels) {
+        if (operands_[other].HasLabel(label) || is_needed(label, a, b)) {
+          reduction.kept_labels.push_back(label);
+        }
+      }
+      if (reduction.kept_labels.size() != operands_[*operand].labels.size()) {
+        AddStep(std::move(reduction));
+        *operand = operands_.size() - 1;
+      }
+    }
+
+    EinsumStep contraction;
+    contraction.is_contraction = true;
+    for (int label : operands_[a].labels) {
+      if (!operands_[b].HasLabel(label)) {
+        contraction.m_labels.push_back(label);
+      } else if (is_needed(label, a, b)) {
+        contraction.batch_labels.push_back(label);
+      } else {
+        contraction.k_labels.push_back(label);
+      }
+    }
+    for (int label : operands_[b].labels) {
+      if (!operands_[a].HasLabel(label)) {
+        contraction.n_labels.push_back(label);
+      }
+    }
+
+    // The GEMMs read each group of labels as a single dimension when they are evenly strided in the operands. The
+    // last contraction writes its result in the order of the output if it can, which saves a transpose.
+    auto output_position = [this](int label) {
+      return std::find(output_labels_.begin(), output_labels_.end(), label) - output_labels_.begin();
+    };
+    auto stride_in = [this](size_t operand) {
+      return [this, operand](int label) { return -operands_[operand].Stride(label); };
+    };
+    SortLabels(contraction.k_labels, stride_in(a));
+    if (is_last) {
+      SortLabels(contraction.batch_labels, output_position);
+      SortLabels(contraction.m_labels, output_position);
+      SortLabels(contraction.n_labels, output_position);
+      if (contraction.ResultLabels() != output_labels_) {
+        std::swap(contraction.m_labels, contraction.n_labels);
+        if (contraction.ResultLabels() == output_labels_) {
+          std::swap(a, b);
+        } else {
+          std::swap(contraction.m_labels, contraction.n_labels);
+        }
+      }
+    } else {
+      SortLabels(contraction.batch_labels, stride_in(a));
+      SortLabels(contraction.m_labels, stride_in(a));
+      SortLabels(contraction.n_labels, stride_in(b));
+    }
+    contraction.input0 = a;
+    contraction.input1 = b;
+
+    AddStep(std::move(contraction));
+    remaining.push_back(operands_.size() - 1);
+  }
+
+  // sum or transpose the last operand to the output
+  if (steps_.empty() || operands_.back().labels != output_labels_) {
+    EinsumStep reduction;
+    reduction.input0 = remaining[0];
+    reduction.kept_labels = output_labels_;
+    AddStep(std::move(reduction));
+  }
+}
+
+bool EinsumCollapseLabels(const EinsumOperand& operand, const std::vector<int>& labels,
+                          const std::vector<int64_t>& label_sizes, int64_t& size, int64_t& stride) {
+  size = 1;
+  stride = 0;
+  for (size_t i = labels.size(); i-- > 0;) {
+    const int64_t label_stride = operand.Stride(labels[i]);
+    if (i + 1 == labels.size()) {
+      stride = label_stride;
+    } else if (label_stride != stride * size) {
+      return false;
+    }
+    size *= label_sizes[labels[i]];
+  }
+  return true;
+}
+
+bool EinsumGetMatrix(const EinsumOperand& operand, const std::vector<int>& row_labels,
+                     const std::vector<int>& column_labels, const std::vector<int64_t>& label_sizes,
+                     bool& transpose, int64_t& ld) {
+  int64_t rows, row_stride, columns, column_stride;
+  if (!EinsumCollapseLabels(operand, row_labels, label_sizes, rows, row_stride) ||
+      !EinsumCollapseLabels(operand, column_labels, label_sizes, columns, column_stride)) {
+    return false;
+  }
+
+  if ((columns == 1 || column_stride == 1) && (rows == 1 || row_stride >= columns)) {
+    transpose = false;
+    ld = rows == 1 ? columns : row_stride;
+    return true;
+  }
+  if ((rows == 1 || row_stride == 1) && (columns == 1 || column_stride >= rows)) {
+    transpose = true;
+    ld = columns == 1 ? rows : column_stride;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
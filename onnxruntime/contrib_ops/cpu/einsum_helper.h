@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// The terms of an Einsum equation such as "bij,bjk->bik". The letters 'A'-'Z' and 'a'-'z' are the labels 0-51, and
+// a term may have one ellipsis for the dimensions it doesn't name, stored as kEllipsis.
+class EinsumEquation {
+ public:
+  static constexpr int kNumLetters = 52;
+  static constexpr int kEllipsis = -1;
+
+  static Status Parse(const std::string& equation, EinsumEquation& parsed);
+
+  const std::vector<std::vector<int>>& InputTerms() const { return input_terms_; }
+
+  // false if the equation has no "->", in which case the output has the ellipsis dimensions followed by the labels
+  // that appear once, in alphabetical order
+  bool HasOutputTerm() const { return has_output_term_; }
+  const std::vector<int>& OutputTerm() const { return output_term_; }
+
+ private:
+  std::vector<std::vector<int>> input_terms_;
+  std::vector<int> output_term_;
+  bool has_output_term_ = false;
+};
+
+// A tensor viewed through its labels: the element at index i of each label l is at the sum of i * strides[l].
+// The labels of an operand are distinct. A label repeated in a term (a diagonal) has the sum of the strides of its
+// dimensions, and a broadcast ellipsis dimension has stride 0. The labels of size 1 are left out.
+struct EinsumOperand {
+  std::vector<int> labels;
+  std::vector<int64_t> strides;
+
+  bool HasLabel(int label) const;
+  int64_t Stride(int label) const;
+
+  // The operand of a buffer holding the labels in order, without gaps.
+  static EinsumOperand Contiguous(const std::vector<int>& labels, const std::vector<int64_t>& label_sizes);
+};
+
+// A step of the evaluation of an Einsum, which produces a new contiguous operand.
+struct EinsumStep {
+  // A contraction multiplies two operands and sums the k_labels, as one GEMM of m_labels x k_labels by
+  // k_labels x n_labels for each index of the batch_labels. The result holds batch_labels, m_labels then n_labels.
+  // A reduction of a single operand, input0, sums the labels not in kept_labels. The result holds kept_labels.
+  bool is_contraction = false;
+  size_t input0 = 0;
+  size_t input1 = 0;
+  std::vector<int> batch_labels;
+  std::vector<int> m_labels;
+  std::vector<int> k_labels;
+  std::vector<int> n_labels;
+  std::vector<int> kept_labels;
+
+  std::vector<int> ResultLabels() const;
+};
+
+// Resolves the labels of an equation for the shapes of its inputs, and plans the evaluation as pairwise
+// contractions. The two operands whose contraction has the smallest result are contracted first, and a label that
+// only one operand has and no later step needs is summed before the contraction of that operand.
+class EinsumComputeHelper {
+ public:
+  Status Compute(const EinsumEquation& equation, const std::vector<const TensorShape*>& input_shapes);
+
+  const TensorShape& OutputShape() const { return output_shape_; }
+
+  // true if a label has size 0, so there are no steps and the output is empty or all zeros
+  bool HasEmptyLabel() const { return has_empty_label_; }
+
+  const std::vector<int64_t>& LabelSizes() const { return label_sizes_; }
+
+  // The inputs, followed by the result of each step in order.
+  const std::vector<EinsumOperand>& Operands() const { return operands_; }
+
+  // The result of the last step is the output.
+  const std::vector<EinsumStep>& Steps() const { return steps_; }
+
+ private:
+  void Plan(size_t num_inputs);
+  void AddStep(EinsumStep&& step);
+
+  TensorShape output_shape_;
+  std::vector<int> output_labels_;
+  std::vector<int64_t> label_sizes_;
+  std::vector<EinsumOperand> operands_;
+  std::vector<EinsumStep> steps_;
+  bool has_empty_label_ = false;
+};
+
+// Returns the size and the stride of the labels of an operand taken as one dimension in that order, or false if the
+// labels are not evenly strided. An empty list of labels has size 1.
+bool EinsumCollapseLabels(const EinsumOperand& operand, const std::vector<int>& labels,
+                          const std::vector<int64_t>& label_sizes, int64_t& size, int64_t& stride);
+
+// Returns how a GEMM reads an operand as a row major matrix of row_labels x column_labels: either directly or
+// transposed, with a leading dimension ld. Returns false if the operand must be copied first.
+bool EinsumGetMatrix(const EinsumOperand& operand, const std::vector<int>& row_labels,
+                     const std::vector<int>& column_labels, const std::vector<int64_t>& label_sizes,
+                     bool& transpose, int64_t& ld);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,291 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/platform/threadpool.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of elements processed by all the operations before moving to the next block. A block of the running
+// value and of any full size operands stays in the L1 cache.
+constexpr int64_t kBlockSize = 1024;
+
+enum class OperandKind {
+  Full,    // same shape as X
+  Scalar,  // a single element
+  Row,     // a vector broadcast along the last dimension of X
+};
+
+struct Operand {
+  OperandKind kind;
+  const float* data;
+  int64_t row_size;
+};
+
+struct AddOp {
+  static float Apply(float a, float b) { return a + b; }
+};
+
+struct SubOp {
+  static float Apply(float a, float b) { return a - b; }
+};
+
+struct MulOp {
+  static float Apply(float a, float b) { return a * b; }
+};
+
+struct DivOp {
+  static float Apply(float a, float b) { return a / b; }
+};
+
+template <typename Op, bool OperandFirst>
+void ApplyBinary(float* value, const Operand& operand, int64_t start, int64_t count) {
+  switch (operand.kind) {
+    case OperandKind::Scalar: {
+      const float b = operand.data[0];
+      for (int64_t i = 0; i < count; i++) {
+        value[i] = OperandFirst ? Op::Apply(b, value[i]) : Op::Apply(value[i], b);
+      }
+      break;
+    }
+
+    case OperandKind::Full: {
+      const float* b = operand.data + start;
+      for (int64_t i = 0; i < count; i++) {
+        value[i] = OperandFirst ? Op::Apply(b[i], value[i]) : Op::Apply(value[i], b[i]);
+      }
+      break;
+    }
+
+    case OperandKind::Row: {
+      // Walk the block as runs that do not cross the end of the row.
+      int64_t offset = start % operand.row_size;
+      int64_t i = 0;
+      while (i < count) {
+        const int64_t run = std::min(count - i, operand.row_size - offset);
+        const float* b = operand.data + offset;
+        float* v = value + i;
+        for (int64_t j = 0; j < run; j++) {
+          v[j] = OperandFirst ? Op::Apply(b[j], v[j]) : Op::Apply(v[j], b[j]);
+        }
+        i += run;
+        offset = 0;
+      }
+      break;
+    }
+  }
+}
+
+template <typename Op>
+void ApplyBinary(float* value, const Operand& operand, bool operand_first, int64_t start, int64_t count) {
+  if (operand_first) {
+    ApplyBinary<Op, true>(value, operand, start, count);
+  } else {
+    ApplyBinary<Op, false>(value, operand, start, count);
+  }
+}
+
+void ApplyStep(const FusedElementwise::Step& step, const Operand* operand, float* value, int64_t start,
+               int64_t count) {
+  const size_t n = static_cast<size_t>(count);
+
+  switch (step.operation) {
+    case FusedElementwise::Operation::Add:
+      ApplyBinary<AddOp>(value, *operand, step.operand_first, start, count);
+      break;
+    case FusedElementwise::Operation::Sub:
+      ApplyBinary<SubOp>(value, *operand, step.operand_first, start, count);
+      break;
+    case FusedElementwise::Operation::Mul:
+      ApplyBinary<MulOp>(value, *operand, step.operand_first, start, count);
+      break;
+    case FusedElementwise::Operation::Div:
+      ApplyBinary<DivOp>(value, *operand, step.operand_first, start, count);
+      break;
+    case FusedElementwise::Operation::Relu:
+      for (int64_t i = 0; i < count; i++) {
+        value[i] = std::max(value[i], 0.0f);
+      }
+      break;
+    case FusedElementwise::Operation::Sigmoid:
+      MlasComputeLogistic(value, value, n);
+      break;
+    case FusedElementwise::Operation::Tanh:
+      MlasComputeTanh(value, value, n);
+      break;
+    case FusedElementwise::Operation::Exp:
+      MlasComputeExp(value, value, n);
+      break;
+    case FusedElementwise::Operation::Log:
+      MlasComputeLog(value, value, n);
+      break;
+    case FusedElementwise::Operation::Neg:
+      for (int64_t i = 0; i < count; i++) {
+        value[i] = -value[i];
+      }
+      break;
+    case FusedElementwise::Operation::Abs:
+      for (int64_t i = 0; i < count; i++) {
+        value[i] = std::fabs(value[i]);
+      }
+      break;
+    case FusedElementwise::Operation::Sqrt:
+      MlasComputeSqrt(value, value, n);
+      break;
+    case FusedElementwise::Operation::Erf:
+      MlasComputeErf(value, value, n);
+      break;
+  }
+}
+
+}  // namespace
+
+bool FusedElementwise::ParseOperation(const std::string& op_type, Operation* operation) {
+  static const std::pair<const char*, Operation> operations[] = {
+      {"Add", Operation::Add},
+      {"Sub", Operation::Sub},
+      {"Mul", Operation::Mul},
+      {"Div", Operation::Div},
+      {"Relu", Operation::Relu},
+      {"Sigmoid", Operation::Sigmoid},
+      {"Tanh", Operation::Tanh},
+      {"Exp", Operation::Exp},
+      {"Log", Operation::Log},
+      {"Neg", Operation::Neg},
+      {"Abs", Operation::Abs},
+      {"Sqrt", Operation::Sqrt},
+      {"Erf", Operation::Erf},
+  };
+
+  for (const auto& entry : operations) {
+    if (op_type == entry.first) {
+      if (operation != nullptr) {
+        *operation = entry.second;
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::vector<FusedElementwise::Step> FusedElementwise::ParseSteps(const OpKernelInfo& info) {
+  std::vector<std::string> operations;
+  std::vector<int64_t> operand_indices;
+  std::vector<int64_t> operand_positions;
+  ORT_ENFORCE(info.GetAttrs<std::string>("operations", operations).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("operand_indices", operand_indices).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("operand_positions", operand_positions).IsOK());
+  ORT_ENFORCE(operand_indices.size() == operations.size() && operand_positions.size() == operations.size(),
+              "operand_indices and operand_positions must have one entry per operation");
+
+  const int input_count = static_cast<int>(info.GetInputCount());
+
+  std::vector<Step> steps;
+  for (size_t i = 0; i < operations.size(); i++) {
+    Step step;
+    ORT_ENFORCE(ParseOperation(operations[i], &step.operation), "Unsupported operation: ", operations[i]);
+
+    if (IsBinaryOperation(step.operation)) {
+      ORT_ENFORCE(operand_indices[i] >= 0 && operand_indices[i] < input_count,
+                  "Invalid operand index ", operand_indices[i], " for operation ", operations[i]);
+      ORT_ENFORCE(operand_positions[i] == 0 || operand_positions[i] == 1,
+                  "Invalid operand position ", operand_positions[i], " for operation ", operations[i]);
+      step.operand_index = static_cast<int>(operand_indices[i]);
+      step.operand_first = (operand_positions[i] == 0);
+    } else {
+      step.operand_index = -1;
+      step.operand_first = false;
+    }
+
+    steps.push_back(step);
+  }
+
+  return steps;
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info), steps_(ParseSteps(info)) {
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  const int64_t total = shape.Size();
+  const int64_t row_size = shape.NumDimensions() > 0 ? shape[shape.NumDimensions() - 1] : 1;
+
+  Tensor* Y = context->Output(0, shape);
+
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  // Resolve how each operand broadcasts against X.
+  std::vector<Operand> operands(steps_.size());
+  for (size_t i = 0; i < steps_.size(); i++) {
+    if (steps_[i].operand_index < 0) {
+      continue;
+    }
+
+    const Tensor* B = context->Input<Tensor>(steps_[i].operand_index);
+    const int64_t size = B->Shape().Size();
+
+    Operand& operand = operands[i];
+    operand.data = B->template Data<float>();
+    operand.row_size = row_size;
+
+    if (size == total && B->Shape() == shape) {
+      operand.kind = OperandKind::Full;
+    } else if (size == 1) {
+      operand.kind = OperandKind::Scalar;
+    } else if (size == row_size && B->Shape()[B->Shape().NumDimensions() - 1] == row_size) {
+      operand.kind = OperandKind::Row;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Operand ", steps_[i].operand_index, " with shape ",
+                             B->Shape(), " does not broadcast to the input shape ", shape);
+    }
+  }
+
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+
+  const int64_t block_count = (total + kBlockSize - 1) / kBlockSize;
+  const double cost_per_block = static_cast<double>(kBlockSize) * 4.0 * static_cast<double>(steps_.size());
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(block_count), cost_per_block,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; block++) {
+          const int64_t start = static_cast<int64_t>(block) * kBlockSize;
+          const int64_t count = std::min(kBlockSize, total - start);
+
+          // The running value lives in the output block.
+          float* value = y_data + start;
+          std::copy_n(x_data + start, count, value);
+
+          for (size_t i = 0; i < steps_.size(); i++) {
+            ApplyStep(steps_[i], steps_[i].operand_index >= 0 ? &operands[i] : nullptr, value, start, count);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Runs a chain of element-wise operations over blocks of the input, so that the intermediate values of a
+// block stay in the cache instead of being written to full size tensors between operations.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class Operation {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Relu,
+    Sigmoid,
+    Tanh,
+    Exp,
+    Log,
+    Neg,
+    Abs,
+    Sqrt,
+    Erf,
+  };
+
+  // Returns true if op_type names an operation supported by the kernel, and optionally returns the operation.
+  static bool ParseOperation(const std::string& op_type, Operation* operation = nullptr);
+
+  static bool IsBinaryOperation(Operation operation) {
+    return operation == Operation::Add || operation == Operation::Sub ||
+           operation == Operation::Mul || operation == Operation::Div;
+  }
+
+  struct Step {
+    Operation operation;
+    int operand_index;     // input with the second operand, or -1 for a unary operation
+    bool operand_first;    // true if the operand is the first input of the original operation
+  };
+
+  // Reads the steps from the attributes of the node. Shared with the CUDA kernel.
+  static std::vector<Step> ParseSteps(const OpKernelInfo& info);
+
+ private:
+  std::vector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
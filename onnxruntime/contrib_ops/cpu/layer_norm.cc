@@ -4,6 +4,7 @@
 #include "layer_norm.h"
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -25,6 +26,40 @@ namespace contrib {
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 
+namespace {
+
+template <typename T>
+void ComputeLayerNormRow(const T* p_input, const T* scale_data, const T* bias_data, T* p_output,
+                         int64_t norm_size, float epsilon, T* p_mean, T* p_inv_std_var) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+  }
+
+  *p_mean = mean;
+  *p_inv_std_var = 1 / mean_square;
+}
+
+// The float rows use the vectorized MLAS kernel, which accumulates the statistics and normalizes in two passes.
+template <>
+void ComputeLayerNormRow<float>(const float* p_input, const float* scale_data, const float* bias_data, float* p_output,
+                                int64_t norm_size, float epsilon, float* p_mean, float* p_inv_std_var) {
+  MlasComputeLayerNormalization(p_input, nullptr, nullptr, scale_data, bias_data, p_output,
+                                static_cast<size_t>(norm_size), epsilon, p_mean, p_inv_std_var);
+}
+
+}  // namespace
+
 template <typename T>
 LayerNorm<T>::LayerNorm(const OpKernelInfo& op_kernel_info)
     : OpKernel(op_kernel_info) {
@@ -90,26 +125,14 @@ Status LayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
   concurrency::ThreadPool::TryBatchParallelFor(p_ctx->GetOperatorThreadPool(),
                                                static_cast<int32_t>(norm_count),
                                                [&](int32_t task_idx) {
-                                                 const T* p_input = X_data + task_idx * norm_size;
-                                                 T* p_output = Y_data + task_idx * norm_size;
-
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   mean += p_input[h];
-                                                   mean_square += p_input[h] * p_input[h];
-                                                 }
-
-                                                 mean = mean / norm_size;
-                                                 mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-                                                 }
-
-                                                 mean_data[task_idx] = mean;
-                                                 inv_std_var_data[task_idx] = mean_square;
+                                                 ComputeLayerNormRow(X_data + task_idx * norm_size,
+                                                                     scale_data,
+                                                                     bias_data,
+                                                                     Y_data + task_idx * norm_size,
+                                                                     norm_size,
+                                                                     epsilon_,
+                                                                     mean_data + task_idx,
+                                                                     inv_std_var_data + task_idx);
                                                });
 
   return Status::OK();
@@ -67,14 +67,30 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Upsample,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcUpsample);
+
 template <typename T>
 Status ReorderInput<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& X_shape = X->Shape();
   ORT_ENFORCE(X_shape.NumDimensions() == 4);
-  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
-  auto* Y = context->Output(0, X_shape);
-  MlasReorderInput(X_shape.GetDims().data(), X->template Data<T>(), Y->template MutableData<T>());
+  if (channels_last_) {
+    // Reorder from NHWC to NCHWc. The output has the shape of the equivalent
+    // NCHW tensor.
+    ORT_ENFORCE((X_shape[3] % MlasNchwcGetBlockSize()) == 0);
+    auto* Y = context->Output(0, {X_shape[0], X_shape[3], X_shape[1], X_shape[2]});
+    MlasReorderInputNhwc(X_shape.GetDims().data(), X->template Data<T>(), Y->template MutableData<T>());
+  } else {
+    ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+    auto* Y = context->Output(0, X_shape);
+    MlasReorderInput(X_shape.GetDims().data(), X->template Data<T>(), Y->template MutableData<T>());
+  }
   return Status::OK();
 }
 
@@ -83,11 +99,18 @@ Status ReorderOutput<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& X_shape = X->Shape();
   ORT_ENFORCE(X_shape.NumDimensions() == 4);
-  std::vector<int64_t> Y_shape(X_shape.GetDims());
-  ORT_ENFORCE(channels_ <= Y_shape[1]);
-  Y_shape[1] = channels_;
-  auto* Y = context->Output(0, Y_shape);
-  MlasReorderOutput(Y_shape.data(), X->template Data<T>(), Y->template MutableData<T>());
+  ORT_ENFORCE(channels_ <= X_shape[1]);
+  if (channels_last_) {
+    // Reorder from NCHWc to NHWC.
+    std::vector<int64_t> Y_shape{X_shape[0], X_shape[2], X_shape[3], channels_};
+    auto* Y = context->Output(0, Y_shape);
+    MlasReorderOutputNhwc(Y_shape.data(), X->template Data<T>(), Y->template MutableData<T>());
+  } else {
+    std::vector<int64_t> Y_shape(X_shape.GetDims());
+    Y_shape[1] = channels_;
+    auto* Y = context->Output(0, Y_shape);
+    MlasReorderOutput(Y_shape.data(), X->template Data<T>(), Y->template MutableData<T>());
+  }
   return Status::OK();
 }
 
@@ -197,5 +220,27 @@ Status NchwcAveragePool::Compute(OpKernelContext* context) const {
                                                                          : MlasAveragePoolingExcludePad);
 }
 
+Status NchwcUpsample::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+
+  const auto& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+
+  std::vector<int64_t> Y_shape(X_shape.GetDims());
+  for (size_t i = 0; i < 4; i++) {
+    Y_shape[i] *= scales_[i];
+  }
+  auto* Y = context->Output(0, Y_shape);
+
+  MlasNchwcUpsample(X_shape.GetDims().data(),
+                    scales_.data() + 2,
+                    X->template Data<float>(),
+                    Y->template MutableData<float>(),
+                    context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
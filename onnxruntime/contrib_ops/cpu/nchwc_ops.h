@@ -16,9 +16,13 @@ template <typename T>
 class ReorderInput : public OpKernel {
  public:
   ReorderInput(const OpKernelInfo& info) : OpKernel(info) {
+    channels_last_ = info.GetAttrOrDefault<int64_t>("channels_last", 0) != 0;
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool channels_last_;
 };
 
 template <typename T>
@@ -27,12 +31,14 @@ class ReorderOutput : public OpKernel {
   ReorderOutput(const OpKernelInfo& info) : OpKernel(info) {
     ORT_ENFORCE(info.GetAttr<int64_t>("channels", &channels_).IsOK());
     ORT_ENFORCE(channels_ > 0, "invalid channel count");
+    channels_last_ = info.GetAttrOrDefault<int64_t>("channels_last", 0) != 0;
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
   int64_t channels_;
+  bool channels_last_;
 };
 
 class NchwcConv : public OpKernel {
@@ -75,5 +81,20 @@ class NchwcAveragePool : public OpKernel, public NchwcPoolBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
+class NchwcUpsample : public OpKernel {
+ public:
+  NchwcUpsample(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttrs<int64_t>("scales", scales_).IsOK());
+    ORT_ENFORCE(scales_.size() == 4);
+    // Batch and channel dimensions cannot scale and spatial scaling must be positive.
+    ORT_ENFORCE(scales_[0] == 1 && scales_[1] == 1 && scales_[2] >= 1 && scales_[3] >= 1);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<int64_t> scales_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/qlinear_util.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using QLinearBinaryFunction = void(MLASCALL*)(const uint8_t* InputA, float ScaleA, uint8_t ZeroPointA,
+                                              const uint8_t* InputB, float ScaleB, uint8_t ZeroPointB,
+                                              float ScaleC, uint8_t ZeroPointC, uint8_t* OutputC,
+                                              size_t N, bool IsScalarB);
+
+// Computes C from the quantized A and B with broadcasting. The MLAS routine takes a scalar as its second operand,
+// which is fine for the commutative Add and Mul.
+static Status ComputeQLinearBinary(OpKernelContext* ctx, QLinearBinaryFunction function) {
+  const Tensor& A = *ctx->Input<Tensor>(0);
+  const Tensor& B = *ctx->Input<Tensor>(3);
+
+  float a_scale, b_scale, c_scale;
+  uint8_t a_zero_point, b_zero_point, c_zero_point;
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(1), "A_scale", a_scale));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(2), "A_zero_point", a_zero_point));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(4), "B_scale", b_scale));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(5), "B_zero_point", b_zero_point));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(6), "C_scale", c_scale));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(7), "C_zero_point", c_zero_point));
+
+  TBroadcaster<uint8_t, uint8_t> bc(A, B);
+  Tensor& C = *ctx->Output(0, bc.GetOutputShape());
+  ParallelBroadcastLoop<uint8_t, uint8_t, uint8_t>(
+      ctx->GetOperatorThreadPool(), bc, C,
+      [&](EigenVectorMap<uint8_t> output, uint8_t a, ConstEigenVectorMap<uint8_t> b) {
+        function(b.data(), b_scale, b_zero_point, &a, a_scale, a_zero_point, c_scale, c_zero_point,
+                 output.data(), static_cast<size_t>(output.size()), true);
+      },
+      [&](EigenVectorMap<uint8_t> output, ConstEigenVectorMap<uint8_t> a, uint8_t b) {
+        function(a.data(), a_scale, a_zero_point, &b, b_scale, b_zero_point, c_scale, c_zero_point,
+                 output.data(), static_cast<size_t>(output.size()), true);
+      },
+      [&](EigenVectorMap<uint8_t> output, ConstEigenVectorMap<uint8_t> a, ConstEigenVectorMap<uint8_t> b) {
+        function(a.data(), a_scale, a_zero_point, b.data(), b_scale, b_zero_point, c_scale, c_zero_point,
+                 output.data(), static_cast<size_t>(output.size()), false);
+      },
+      4.0);
+
+  return Status::OK();
+}
+
+class QLinearAdd final : public OpKernel {
+ public:
+  QLinearAdd(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* ctx) const override {
+    return ComputeQLinearBinary(ctx, MlasQLinearAdd);
+  }
+};
+
+class QLinearMul final : public OpKernel {
+ public:
+  QLinearMul(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* ctx) const override {
+    return ComputeQLinearBinary(ctx, MlasQLinearMul);
+  }
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearAdd,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearAdd);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearMul,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMul);
+
+}  // namespace contrib
+}  // namespace onnxruntime
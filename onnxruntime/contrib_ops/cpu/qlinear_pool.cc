@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/qlinear_util.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/nn/pool_attributes.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace onnxruntime {
+namespace contrib {
+
+struct QLinearPoolParameters {
+  float x_scale;
+  uint8_t x_zero_point;
+  float y_scale;
+  uint8_t y_zero_point;
+};
+
+static Status GetQLinearPoolParameters(OpKernelContext* ctx, QLinearPoolParameters& parameters) {
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(1), "x_scale", parameters.x_scale));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(2), "x_zero_point", parameters.x_zero_point));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(3), "y_scale", parameters.y_scale));
+  ORT_RETURN_IF_ERROR(GetQuantizationParameter(ctx->Input<Tensor>(4), "y_zero_point", parameters.y_zero_point));
+  return Status::OK();
+}
+
+// AveragePool of a quantized NCHW input. The channels are split in blocks across the threads, and each block is
+// expanded to float relative to the input zero point, pooled by MLAS and quantized to the output block, so the buffers
+// stay in the cache.
+class QLinearAveragePool final : public OpKernel {
+ public:
+  QLinearAveragePool(const OpKernelInfo& info) : OpKernel(info), pool_attrs_(info, "AveragePool", 1) {}
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  PoolAttributes pool_attrs_;
+};
+
+// GlobalAveragePool of a quantized NCHW input. The channels are summed as integers.
+class QLinearGlobalAveragePool final : public OpKernel {
+ public:
+  QLinearGlobalAveragePool(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* ctx) const override;
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearAveragePool,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearAveragePool);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearGlobalAveragePool,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearGlobalAveragePool);
+
+// number of input elements each thread pools at a time
+static constexpr int64_t kPoolBlockSize = 16384;
+
+Status QLinearAveragePool::Compute(OpKernelContext* ctx) const {
+  const Tensor& X = *ctx->Input<Tensor>(0);
+  const TensorShape& x_shape = X.Shape();
+
+  const size_t input_dims = x_shape.NumDimensions();
+  ORT_RETURN_IF_NOT(input_dims >= 3 && input_dims <= 5, "QLinearAveragePool: input must have 3 to 5 dimensions");
+  const size_t pooling_dims = input_dims - 2;
+  ORT_RETURN_IF_NOT(pooling_dims == pool_attrs_.kernel_shape.size(),
+                    "kernel_shape num_dims is not compatible with X num_dims.");
+
+  QLinearPoolParameters parameters;
+  ORT_RETURN_IF_ERROR(GetQLinearPoolParameters(ctx, parameters));
+
+  std::vector<int64_t> pads = pool_attrs_.pads;
+  std::vector<int64_t> output_dims = pool_attrs_.SetOutputSize(x_shape, x_shape[1], &pads);
+  Tensor& Y = *ctx->Output(0, output_dims);
+  if (Y.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const TensorShape& y_shape = Y.Shape();
+  const int64_t channels = x_shape[0] * x_shape[1];
+  const int64_t input_image_size = x_shape.SizeFromDimension(2);
+  const int64_t output_image_size = y_shape.SizeFromDimension(2);
+  const int64_t kernel_size = std::accumulate(pool_attrs_.kernel_shape.begin(), pool_attrs_.kernel_shape.end(),
+                                              int64_t{1}, std::multiplies<int64_t>());
+
+  const int64_t channels_per_block = std::max(int64_t{1}, kPoolBlockSize / std::max(int64_t{1}, input_image_size));
+  const int64_t block_count = (channels + channels_per_block - 1) / channels_per_block;
+  const double cost = static_cast<double>(channels_per_block) *
+                      static_cast<double>(input_image_size + output_image_size * kernel_size);
+
+  const MLAS_POOLING_KIND kind =
+      pool_attrs_.count_include_pad ? MlasAveragePoolingIncludePad : MlasAveragePoolingExcludePad;
+  const uint8_t* x_data = X.Data<uint8_t>();
+  uint8_t* y_data = Y.MutableData<uint8_t>();
+
+  // the float values are relative to the input zero point, so quantizing them with the ratio of the scales maps
+  // them to the output
+  const float scale = parameters.y_scale / parameters.x_scale;
+  const float x_zero_point = static_cast<float>(parameters.x_zero_point);
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(block_count), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> input_buffer(static_cast<size_t>(channels_per_block * input_image_size));
+        std::vector<float> output_buffer(static_cast<size_t>(channels_per_block * output_image_size));
+        std::vector<int64_t> input_shape = x_shape.GetDims();
+        std::vector<int64_t> output_shape = y_shape.GetDims();
+        input_shape[0] = 1;
+        output_shape[0] = 1;
+
+        for (std::ptrdiff_t block = first; block < last; block++) {
+          const int64_t first_channel = block * channels_per_block;
+          const int64_t count = std::min(channels_per_block, channels - first_channel);
+          const uint8_t* x = x_data + first_channel * input_image_size;
+          const int64_t input_size = count * input_image_size;
+          for (int64_t i = 0; i < input_size; i++) {
+            input_buffer[i] = static_cast<float>(x[i]) - x_zero_point;
+          }
+
+          input_shape[1] = count;
+          output_shape[1] = count;
+          MlasPool(kind, pooling_dims, input_shape.data(), pool_attrs_.kernel_shape.data(), pads.data(),
+                   pool_attrs_.strides.data(), output_shape.data(), input_buffer.data(), output_buffer.data(),
+                   nullptr);
+
+          MlasQuantizeLinear(output_buffer.data(), y_data + first_channel * output_image_size,
+                             static_cast<size_t>(count * output_image_size), scale, parameters.y_zero_point);
+        }
+      });
+
+  return Status::OK();
+}
+
+Status QLinearGlobalAveragePool::Compute(OpKernelContext* ctx) const {
+  const Tensor& X = *ctx->Input<Tensor>(0);
+  const TensorShape& x_shape = X.Shape();
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "QLinearGlobalAveragePool: input must have at least 3 dimensions");
+
+  QLinearPoolParameters parameters;
+  ORT_RETURN_IF_ERROR(GetQLinearPoolParameters(ctx, parameters));
+
+  std::vector<int64_t> output_dims(x_shape.NumDimensions(), 1);
+  output_dims[0] = x_shape[0];
+  output_dims[1] = x_shape[1];
+  Tensor& Y = *ctx->Output(0, output_dims);
+
+  const int64_t channels = x_shape[0] * x_shape[1];
+  const int64_t image_size = x_shape.SizeFromDimension(2);
+  const uint8_t* x_data = X.Data<uint8_t>();
+  uint8_t* y_data = Y.MutableData<uint8_t>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(channels), static_cast<double>(image_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        MlasQLinearGlobalAveragePool(x_data + first * image_size, parameters.x_scale, parameters.x_zero_point,
+                                     y_data + first, parameters.y_scale, parameters.y_zero_point,
+                                     static_cast<size_t>(last - first), static_cast<size_t>(image_size));
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Reads the per-tensor scale or zero point of a quantized input or output. A missing optional zero point is 0.
+template <typename T>
+Status GetQuantizationParameter(const Tensor* tensor, const char* name, T& value) {
+  if (tensor == nullptr) {
+    value = 0;
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(tensor), name, " must be a scalar or 1D tensor of size 1. Got ",
+                    tensor->Shape());
+  value = *tensor->template Data<T>();
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
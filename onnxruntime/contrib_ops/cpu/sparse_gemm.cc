@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Gemm with a constant B that SparseWeightTransformer packed with MlasSparseGemmPackB.
+class SparseGemm final : public OpKernel {
+ public:
+  SparseGemm(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("N", &n_).IsOK() && n_ > 0);
+    ORT_ENFORCE(info.GetAttr<int64_t>("K", &k_).IsOK() && k_ > 0);
+    trans_a_ = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    alpha_ = info.GetAttrOrDefault("alpha", 1.0f);
+    beta_ = info.GetAttrOrDefault("beta", 1.0f);
+  }
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  int64_t n_;
+  int64_t k_;
+  bool trans_a_;
+  float alpha_;
+  float beta_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    SparseGemm,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    SparseGemm);
+
+Status SparseGemm::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* A = ctx->Input<Tensor>(0);
+  const auto* B = ctx->Input<Tensor>(1);
+  const auto* C = ctx->Input<Tensor>(2);
+
+  // A (..., K) is multiplied as a (M, K) matrix
+  const auto& a_shape = A->Shape();
+  std::vector<int64_t> y_dims;
+  TensorShape a_matrix_shape = a_shape;
+  if (trans_a_) {
+    ORT_RETURN_IF_NOT(a_shape.NumDimensions() == 2, "SparseGemm: A must be 2-D if transA is non-zero");
+    y_dims = {a_shape[1], n_};
+  } else {
+    ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 1 && a_shape[a_shape.NumDimensions() - 1] == k_,
+                      "SparseGemm: the last dimension of A must be K");
+    y_dims = a_shape.GetDims();
+    y_dims.back() = n_;
+    a_matrix_shape = TensorShape({a_shape.SizeToDimension(a_shape.NumDimensions() - 1), k_});
+  }
+
+  GemmHelper helper(a_matrix_shape, trans_a_, TensorShape({k_, n_}), false,
+                    C != nullptr ? C->Shape() : TensorShape({}));
+  ORT_RETURN_IF_ERROR(helper.State());
+
+  Tensor* Y = ctx->Output(0, y_dims);
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(n_);
+  const size_t K = static_cast<size_t>(k_);
+  if (M == 0) {
+    return Status::OK();
+  }
+
+  float* y_data = Y->MutableData<float>();
+  float beta = 0.0f;
+
+  // broadcast C into Y, which MlasSparseGemm then scales by beta
+  if (beta_ != 0 && C != nullptr) {
+    const auto& c_shape = C->Shape();
+    const float* c_data = C->Data<float>();
+    if (c_shape.Size() == 1) {
+      // C is (), (1,) or (1, 1)
+      std::fill_n(y_data, M * N, *c_data);
+    } else if (c_shape.NumDimensions() == 1 || c_shape[0] == 1) {
+      // C is (N,) or (1, N)
+      for (size_t m = 0; m < M; m++) {
+        std::copy_n(c_data, N, y_data + m * N);
+      }
+    } else if (c_shape[1] == 1) {
+      // C is (M, 1)
+      for (size_t m = 0; m < M; m++) {
+        std::fill_n(y_data + m * N, N, c_data[m]);
+      }
+    } else {
+      // C is (M, N)
+      std::copy_n(c_data, M * N, y_data);
+    }
+    beta = beta_;
+  }
+
+  MlasSparseGemm(trans_a_ ? CblasTrans : CblasNoTrans,
+                 M,
+                 N,
+                 K,
+                 alpha_,
+                 A->Data<float>(),
+                 trans_a_ ? M : K,
+                 B->Data<uint8_t>(),
+                 beta,
+                 y_data,
+                 N,
+                 thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
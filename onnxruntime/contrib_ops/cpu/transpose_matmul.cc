@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul with the last two dimensions of either input transposed, which MlasGemm reads directly from the
+// untransposed data.
+class TransposeMatMul final : public OpKernel {
+ public:
+  TransposeMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    trans_a_ = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+  }
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  bool trans_a_;
+  bool trans_b_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    TransposeMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    TransposeMatMul);
+
+Status TransposeMatMul::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* A = ctx->Input<Tensor>(0);
+  const auto* B = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(A->Shape(), B->Shape(), trans_a_, trans_b_));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  const size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    MlasGemm(
+        trans_a_ ? CblasTrans : CblasNoTrans,
+        trans_b_ ? CblasTrans : CblasNoTrans,
+        M,
+        N,
+        K,
+        1.0f,
+        A->Data<float>() + helper.LeftOffsets()[i],
+        trans_a_ ? M : K,
+        B->Data<float>() + helper.RightOffsets()[i],
+        trans_b_ ? K : N,
+        0.0f,
+        Y->MutableData<float>() + helper.OutputOffsets()[i],
+        N,
+        thread_pool);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
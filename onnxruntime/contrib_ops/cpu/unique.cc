@@ -8,6 +8,7 @@
 #pragma warning(disable : 4996)
 #endif
 #include "unique.h"
+#include "core/providers/cpu/ml/flat_hash_map.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -36,34 +37,26 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
   Tensor* output_idx = ctx->Output(1, input->Shape());
   int64_t* output_idx_data = output_idx->template MutableData<int64_t>();
 
-  // container to hold the unique elements (in the order it was first seen)
-  std::vector<float> unique_elements;
-  // number of unique elements is atmost number of elements in the raw data
-  unique_elements.reserve(num_elements);
-
-  // containers to store other metadata needed for other output tensors
-  std::unordered_map<float, size_t> mapped_indices;
-  std::unordered_map<float, size_t> element_counts;
+  // open addressing hash map of the unique elements, which keeps them in the order they were first seen
+  ml::FlatHashMap<float, size_t> unique_elements;
+  // container to store other metadata needed for other output tensors
+  std::vector<int64_t> element_counts;
 
   // processing
   for (size_t i = 0; i < num_elements; ++i) {
-    float temp = input_data[i];
-
-    const auto iter = mapped_indices.find(temp);
-    if (iter == mapped_indices.end()) {
+    const auto entry = unique_elements.TryInsert(input_data[i], i);
+    if (entry.second) {
       // element is being seen for the first time
-      element_counts[temp] = 1;
-      output_idx_data[i] = mapped_indices[temp] = unique_elements.size();
-      unique_elements.push_back(temp);
+      element_counts.push_back(1);
     } else {
       // element has been seen before
-      output_idx_data[i] = iter->second;
-      ++element_counts[temp];
+      ++element_counts[entry.first];
     }
+    output_idx_data[i] = static_cast<int64_t>(entry.first);
   }
 
   // 'uniques' output
-  TensorShape output_shape({static_cast<int64_t>(unique_elements.size())});
+  TensorShape output_shape({static_cast<int64_t>(unique_elements.Size())});
   Tensor* output_uniques = ctx->Output(0, output_shape);
   float* output_uniques_data = output_uniques->template MutableData<float>();
 
@@ -71,17 +64,10 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
   Tensor* output_counts = ctx->Output(2, output_shape);
   int64_t* output_counts_data = output_counts->template MutableData<int64_t>();
 
-  size_t iter = 0;
-  for (const float& e : unique_elements) {
-    // 'uniques' data
-    output_uniques_data[iter] = e;
-
-    // 'counts' data
-    const auto iter_map = element_counts.find(e);
-    output_counts_data[iter] = static_cast<int64_t>(iter_map->second);
-
-    ++iter;
-  }
+  // 'uniques' data
+  std::copy(unique_elements.Keys().cbegin(), unique_elements.Keys().cend(), output_uniques_data);
+  // 'counts' data
+  std::copy(element_counts.cbegin(), element_counts.cend(), output_counts_data);
 
   return Status::OK();
 }
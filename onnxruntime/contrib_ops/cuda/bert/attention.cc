@@ -36,6 +36,10 @@ Attention<T>::Attention(const OpKernelInfo& info) : CudaKernel(info), AttentionB
 template <typename T>
 Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(CheckInputs(context));
+  if (context->Input<Tensor>(4) != nullptr || context->OutputCount() > 1 || is_unidirectional_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "Attention with past, present or unidirectional is only supported by the CPU execution provider");
+  }
   // Input and output shapes:
   //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
   //   Input 1 - weights     : (hidden_size, 3 * hidden_size)
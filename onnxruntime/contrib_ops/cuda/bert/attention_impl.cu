@@ -49,7 +49,27 @@ size_t ScratchSize(size_t element_size, int batch_size, int num_heads, int seque
   return bytesAligned;
 }
 
+constexpr int kWarpSize = 32;
+
+// The fused kernel processes kFusedQueryRows query rows of a head per block, with kFusedQueryRowsPerWarp rows per
+// warp, and steps through the keys in tiles of kFusedKeyRows keys, one per lane.
+constexpr int kFusedAttentionMinSequenceLength = 512;
+constexpr int kFusedAttentionMaxHeadSize = 128;
+constexpr int kFusedQueryRowsPerWarp = 4;
+constexpr int kFusedWarps = 4;
+constexpr int kFusedQueryRows = kFusedQueryRowsPerWarp * kFusedWarps;
+constexpr int kFusedKeyRows = kWarpSize;
+
+bool UseFusedAttention(int sequence_length, int head_size) {
+  return sequence_length >= kFusedAttentionMinSequenceLength && head_size <= kFusedAttentionMaxHeadSize;
+}
+
 size_t GetAttentionWorkspaceSize(size_t element_size, int batch_size, int num_heads, int head_size, int sequence_length) {
+  // the fused kernel reads Q, K and V from the input and keeps the scores on chip
+  if (UseFusedAttention(sequence_length, head_size)) {
+    return 0;
+  }
+
   size_t qkv_size = 3 * batch_size * sequence_length * num_heads * head_size * element_size;
   return qkv_size + 2 * ScratchSize(element_size, batch_size, num_heads, sequence_length);
 }
@@ -334,6 +354,159 @@ bool LaunchTransQkv(cudaStream_t stream,
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
+__device__ inline float WarpReduceMax(float value) {
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value = fmaxf(value, __shfl_xor_sync(0xffffffff, value, offset));
+  }
+  return value;
+}
+
+__device__ inline float WarpReduceSum(float value) {
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value += __shfl_xor_sync(0xffffffff, value, offset);
+  }
+  return value;
+}
+
+// Computes softmax(Q*K'/sqrt(H))*V for kFusedQueryRows query rows of a head without materializing the scores. The
+// keys are visited a tile at a time, and the softmax is computed online: each row keeps the running maximum of its
+// scores, and the running sum and output are rescaled whenever the maximum grows. Memory traffic and workspace are
+// therefore linear in the sequence length. The keys past the mask index are skipped.
+// Input:  BxSx3xNxH, the output of the QKV projection
+// Output: BxSxNxH
+// Grid:   (ceil(S / kFusedQueryRows), N, B)
+template <typename T, int kHeadChunks>
+__global__ void FusedAttentionKernel(const int sequence_length, const int head_size, const float scale,
+                                     const int* mask_index, const T* input, T* output) {
+  extern __shared__ float shared_tiles[];
+
+  const int H = head_size;
+  // the lanes read the rows of different keys at once, so the key rows are padded to avoid bank conflicts
+  const int key_stride = H + 1;
+  float* q_tile = shared_tiles;
+  float* k_tile = q_tile + kFusedQueryRows * H;
+  float* v_tile = k_tile + kFusedKeyRows * key_stride;
+
+  const int n = blockIdx.y;
+  const int b = blockIdx.z;
+  const int num_heads = gridDim.y;
+  const int NH = num_heads * H;
+  const int token_stride = 3 * NH;
+  const T* head_input = input + b * sequence_length * token_stride + n * H;
+
+  const int num_valid = max(0, min(sequence_length, mask_index[b]));
+  const int query_start = blockIdx.x * kFusedQueryRows;
+
+  // Q is scaled once here rather than each score
+  for (int i = threadIdx.x; i < kFusedQueryRows * H; i += blockDim.x) {
+    const int r = i / H;
+    const int s = query_start + r;
+    q_tile[i] = s < sequence_length ? float(head_input[s * token_stride + (i - r * H)]) * scale : 0.f;
+  }
+
+  const int warp = threadIdx.x / kWarpSize;
+  const int lane = threadIdx.x % kWarpSize;
+
+  float row_max[kFusedQueryRowsPerWarp];
+  float row_sum[kFusedQueryRowsPerWarp];
+  float row_output[kFusedQueryRowsPerWarp][kHeadChunks];
+  for (int r = 0; r < kFusedQueryRowsPerWarp; r++) {
+    row_max[r] = -CUDART_INF_F;
+    row_sum[r] = 0.f;
+    for (int c = 0; c < kHeadChunks; c++) {
+      row_output[r][c] = 0.f;
+    }
+  }
+
+  for (int key_start = 0; key_start < num_valid; key_start += kFusedKeyRows) {
+    // the previous tile has been consumed, and for the first tile Q has been stored
+    __syncthreads();
+    for (int i = threadIdx.x; i < kFusedKeyRows * H; i += blockDim.x) {
+      const int r = i / H;
+      const int h = i - r * H;
+      const int t = key_start + r;
+      const bool valid = t < num_valid;
+      k_tile[r * key_stride + h] = valid ? float(head_input[t * token_stride + NH + h]) : 0.f;
+      v_tile[r * H + h] = valid ? float(head_input[t * token_stride + 2 * NH + h]) : 0.f;
+    }
+    __syncthreads();
+
+    const bool key_valid = key_start + lane < num_valid;
+    const float* k = k_tile + lane * key_stride;
+
+    for (int r = 0; r < kFusedQueryRowsPerWarp; r++) {
+      const float* q = q_tile + (warp * kFusedQueryRowsPerWarp + r) * H;
+      float score = 0.f;
+      for (int h = 0; h < H; h++) {
+        score += q[h] * k[h];
+      }
+      if (!key_valid) {
+        score = -CUDART_INF_F;
+      }
+
+      // each tile has a valid key, so the new maximum is finite
+      const float new_max = fmaxf(row_max[r], WarpReduceMax(score));
+      const float correction = expf(row_max[r] - new_max);
+      const float p = expf(score - new_max);
+      row_sum[r] = row_sum[r] * correction + WarpReduceSum(p);
+      row_max[r] = new_max;
+
+      // each lane accumulates the output dimensions lane, lane + 32, ...
+      for (int c = 0; c < kHeadChunks; c++) {
+        row_output[r][c] *= correction;
+      }
+      for (int j = 0; j < kFusedKeyRows; j++) {
+        const float p_j = __shfl_sync(0xffffffff, p, j);
+        const float* v = v_tile + j * H;
+        for (int c = 0; c < kHeadChunks; c++) {
+          const int h = lane + c * kWarpSize;
+          if (h < H) {
+            row_output[r][c] += p_j * v[h];
+          }
+        }
+      }
+    }
+  }
+
+  for (int r = 0; r < kFusedQueryRowsPerWarp; r++) {
+    const int s = query_start + warp * kFusedQueryRowsPerWarp + r;
+    if (s < sequence_length) {
+      // like the unfused softmax, a sequence with no valid key produces zeros
+      const float inverse_sum = row_sum[r] > 0.f ? 1.f / row_sum[r] : 0.f;
+      T* out = output + (b * sequence_length + s) * NH + n * H;
+      for (int c = 0; c < kHeadChunks; c++) {
+        const int h = lane + c * kWarpSize;
+        if (h < H) {
+          out[h] = T(row_output[r][c] * inverse_sum);
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+bool LaunchFusedAttention(cudaStream_t stream,
+                          const int batch_size, const int sequence_length, const int num_heads, const int head_size,
+                          const T* input, T* output, const int* mask_index) {
+  const dim3 grid(CeilDiv(sequence_length, kFusedQueryRows), num_heads, batch_size);
+  const dim3 block(kFusedWarps * kWarpSize, 1, 1);
+  const size_t shared_bytes =
+      (kFusedQueryRows * head_size + kFusedKeyRows * (head_size + 1) + kFusedKeyRows * head_size) * sizeof(float);
+  const float scale = 1.f / sqrtf(static_cast<float>(head_size));
+
+  if (head_size <= kWarpSize) {
+    FusedAttentionKernel<T, 1><<<grid, block, shared_bytes, stream>>>(
+        sequence_length, head_size, scale, mask_index, input, output);
+  } else if (head_size <= 2 * kWarpSize) {
+    FusedAttentionKernel<T, 2><<<grid, block, shared_bytes, stream>>>(
+        sequence_length, head_size, scale, mask_index, input, output);
+  } else {
+    FusedAttentionKernel<T, 4><<<grid, block, shared_bytes, stream>>>(
+        sequence_length, head_size, scale, mask_index, input, output);
+  }
+  return CUDA_CALL(cudaPeekAtLastError());
+}
+
 cublasStatus_t inline CublasGemmStridedBatched(
     cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb,
     int m, int n, int k, const float alpha,
@@ -416,8 +589,16 @@ bool LaunchAttentionKernel(
     void* workspace,
     cublasHandle_t& cublas,
     const size_t element_size) {
-  // use default stream
-  const cudaStream_t stream = nullptr;
+  const cudaStream_t stream = onnxruntime::cuda::CurrentStream();
+
+  if (UseFusedAttention(sequence_length, head_size)) {
+    if (element_size == 2) {
+      return LaunchFusedAttention(stream, batch_size, sequence_length, num_heads, head_size,
+                                  reinterpret_cast<const half*>(input), reinterpret_cast<half*>(output), mask_index);
+    }
+    return LaunchFusedAttention(stream, batch_size, sequence_length, num_heads, head_size,
+                                reinterpret_cast<const float*>(input), reinterpret_cast<float*>(output), mask_index);
+  }
 
   if (element_size == 2) {
     return QkvToContext(cublas, stream,
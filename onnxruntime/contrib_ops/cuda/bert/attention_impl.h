@@ -7,6 +7,9 @@
 namespace onnxruntime {
 namespace contrib {
 namespace cuda {
+  // Whether the attention is computed by the fused kernel, which needs no workspace, instead of the cuBLAS GEMMs.
+  bool UseFusedAttention(int sequence_length, int head_size);
+
   size_t GetAttentionWorkspaceSize(size_t element_size, int batchsize, int num_heads, int head_size, int sequence_length);
 
   bool LaunchAttentionKernel(
@@ -180,10 +180,10 @@ bool LaunchEmbedLayerNormKernel(
     int batch_size,
     int sequence_length,
     const size_t element_size) {
-  const cudaStream_t stream = nullptr;  // default stream
+  const cudaStream_t stream = onnxruntime::cuda::CurrentStream();
 
   if (nullptr == input_mask) {
-    if (!CUDA_CALL(cudaMemsetAsync(mask_index, 0, sizeof(int) * batch_size)))
+    if (!CUDA_CALL(cudaMemsetAsync(mask_index, 0, sizeof(int) * batch_size, stream)))
       return false;
   } else if (!ComputeMaskIndex(stream, sequence_length, batch_size, input_mask, static_cast<int*>(mask_index))) {
     return false;
@@ -107,8 +107,7 @@ bool LaunchSkipLayerNormKernel(
     const int hidden_size,
     const int element_count,
     const size_t element_size) {
-  // use default stream
-  const cudaStream_t stream = nullptr;
+  const cudaStream_t stream = onnxruntime::cuda::CurrentStream();
 
   if (element_size == 2) {
     return ComputeSkipLayerNorm(
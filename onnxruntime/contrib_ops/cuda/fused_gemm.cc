@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/gemm.h"
+#include "core/providers/cuda/activation/activations_impl.h"
+#include "contrib_ops/cuda/bert/fast_gelu_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+template <typename T>
+class FusedGemm final : public onnxruntime::cuda::Gemm<T> {
+  using Base = onnxruntime::cuda::Gemm<T>;
+  using typename Base::Activation;
+  using typename Base::CudaT;
+
+ public:
+  FusedGemm(const OpKernelInfo& info) : Base(info) {
+    const std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+    if (activation == "Relu") {
+      Base::activation_ = Activation::Relu;
+    } else if (activation == "FastGelu") {
+      Base::activation_ = Activation::FastGelu;
+    } else if (activation == "LeakyRelu") {
+      Base::activation_ = Activation::LeakyRelu;
+      leaky_relu_alpha_ = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+    } else if (activation == "Sigmoid") {
+      Base::activation_ = Activation::Sigmoid;
+    } else if (activation == "Tanh") {
+      Base::activation_ = Activation::Tanh;
+    } else {
+      ORT_ENFORCE(activation.empty(), "Unsupported activation for FusedGemm on CUDA: ", activation);
+    }
+  }
+
+ private:
+  Status ApplyActivation(CudaT* y_data, int64_t count) const override {
+    switch (Base::activation_) {
+      case Activation::Relu: {
+        onnxruntime::cuda::CtxRelu ctx;
+        onnxruntime::cuda::Impl_Relu<CudaT>(y_data, y_data, &ctx, static_cast<size_t>(count));
+        break;
+      }
+      case Activation::LeakyRelu: {
+        onnxruntime::cuda::CtxLeakyRelu ctx{leaky_relu_alpha_};
+        onnxruntime::cuda::Impl_LeakyRelu<CudaT>(y_data, y_data, &ctx, static_cast<size_t>(count));
+        break;
+      }
+      case Activation::Sigmoid: {
+        onnxruntime::cuda::CtxSigmoid ctx;
+        onnxruntime::cuda::Impl_Sigmoid<CudaT>(y_data, y_data, &ctx, static_cast<size_t>(count));
+        break;
+      }
+      case Activation::Tanh: {
+        onnxruntime::cuda::CtxTanh ctx;
+        onnxruntime::cuda::Impl_Tanh<CudaT>(y_data, y_data, &ctx, static_cast<size_t>(count));
+        break;
+      }
+      case Activation::FastGelu:
+        if (!LaunchFastGeluKernel<CudaT>(onnxruntime::cuda::CurrentStream(), static_cast<int>(count), 0, y_data, nullptr, y_data)) {
+          CUDA_CALL(cudaGetLastError());
+          return Status(common::ONNXRUNTIME, common::FAIL);
+        }
+        break;
+      default:
+        break;
+    }
+    return Status::OK();
+  }
+
+  float leaky_relu_alpha_{0.01f};
+};
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
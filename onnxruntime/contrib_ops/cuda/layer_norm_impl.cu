@@ -390,7 +390,7 @@ void HostApplyLayerNorm(
   const dim3 blocks(1, std::min((uint64_t)n1, maxGridY), 1);
   int nshared =
       threads.y > 1 ? threads.y * sizeof(U) + (threads.y / 2) * sizeof(U) : 0;
-  cuApplyLayerNorm<<<blocks, threads, nshared, 0>>>(
+  cuApplyLayerNorm<<<blocks, threads, nshared, CurrentStream()>>>(
       output,
       mean,
       invvar,
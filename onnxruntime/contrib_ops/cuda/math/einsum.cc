@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "einsum.h"
+#include "einsum_impl.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+
+#include <algorithm>
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Einsum,                                                     \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Einsum<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+int64_t Product(const std::vector<int>& labels, const std::vector<int64_t>& label_sizes) {
+  int64_t product = 1;
+  for (int label : labels) {
+    product *= label_sizes[label];
+  }
+  return product;
+}
+
+// An operand of a contraction as a batch of evenly strided matrices.
+template <typename CudaT>
+struct Matrix {
+  const CudaT* data;
+  bool transpose;
+  int64_t ld;
+  int64_t batch_stride;
+  IAllocatorUniquePtr<CudaT> buffer;
+};
+
+}  // namespace
+
+template <typename T>
+Einsum<T>::Einsum(const OpKernelInfo& info) : CudaKernel(info) {
+  std::string equation;
+  ORT_ENFORCE(info.GetAttr<std::string>("equation", &equation).IsOK(), "Einsum requires the equation attribute");
+  ORT_THROW_IF_ERROR(EinsumEquation::Parse(equation, equation_));
+}
+
+template <typename T>
+Status Einsum<T>::Reduce(const CudaT* input, const EinsumOperand& operand, const std::vector<int>& kept_labels,
+                         const std::vector<int64_t>& label_sizes, CudaT* output) const {
+  // the summed labels from the largest stride to the smallest, so consecutive iterations read nearby elements
+  std::vector<int> summed_labels;
+  for (int label : operand.labels) {
+    if (std::find(kept_labels.begin(), kept_labels.end(), label) == kept_labels.end()) {
+      summed_labels.push_back(label);
+    }
+  }
+  std::stable_sort(summed_labels.begin(), summed_labels.end(),
+                   [&operand](int a, int b) { return operand.Stride(a) > operand.Stride(b); });
+
+  if (kept_labels.size() > static_cast<size_t>(kMaxEinsumReduceRank) ||
+      summed_labels.size() > static_cast<size_t>(kMaxEinsumReduceRank)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Einsum operands with more than ", kMaxEinsumReduceRank,
+                           " distinct labels are not supported by the CUDA execution provider");
+  }
+
+  EinsumReduceArgs args;
+  args.kept_rank = static_cast<int>(kept_labels.size());
+  for (size_t i = 0; i < kept_labels.size(); ++i) {
+    args.kept_sizes[i] = fast_divmod(static_cast<int>(label_sizes[kept_labels[i]]));
+    args.kept_strides[i] = operand.Stride(kept_labels[i]);
+  }
+  args.summed_rank = static_cast<int>(summed_labels.size());
+  for (size_t i = 0; i < summed_labels.size(); ++i) {
+    args.summed_sizes[i] = fast_divmod(static_cast<int>(label_sizes[summed_labels[i]]));
+    args.summed_strides[i] = operand.Stride(summed_labels[i]);
+  }
+  args.summed_count = static_cast<int>(Product(summed_labels, label_sizes));
+
+  EinsumReduceImpl<CudaT>(input, output, args, static_cast<size_t>(Product(kept_labels, label_sizes)));
+  return Status::OK();
+}
+
+template <typename T>
+Status Einsum<T>::Contract(const EinsumStep& step, const CudaT* a_data, const EinsumOperand& a_operand,
+                           const CudaT* b_data, const EinsumOperand& b_operand,
+                           const std::vector<int64_t>& label_sizes, CudaT* output) const {
+  // Reads an operand in place if its batch labels collapse to one stride and each matrix is evenly strided,
+  // otherwise copies it to a contiguous buffer of batch_labels, row_labels then column_labels.
+  auto get_matrix = [&](const CudaT* data, const EinsumOperand& operand, const std::vector<int>& row_labels,
+                        const std::vector<int>& column_labels, Matrix<CudaT>& matrix) -> Status {
+    int64_t batch_size = 0;
+    matrix.data = data;
+    if (EinsumCollapseLabels(operand, step.batch_labels, label_sizes, batch_size, matrix.batch_stride) &&
+        EinsumGetMatrix(operand, row_labels, column_labels, label_sizes, matrix.transpose, matrix.ld)) {
+      return Status::OK();
+    }
+
+    std::vector<int> labels(step.batch_labels);
+    labels.insert(labels.end(), row_labels.begin(), row_labels.end());
+    labels.insert(labels.end(), column_labels.begin(), column_labels.end());
+    matrix.buffer = GetScratchBuffer<CudaT>(Product(labels, label_sizes));
+    ORT_RETURN_IF_ERROR(Reduce(data, operand, labels, label_sizes, matrix.buffer.get()));
+    matrix.data = matrix.buffer.get();
+    matrix.transpose = false;
+    matrix.ld = Product(column_labels, label_sizes);
+    matrix.batch_stride = Product(row_labels, label_sizes) * matrix.ld;
+    return Status::OK();
+  };
+
+  Matrix<CudaT> a;
+  Matrix<CudaT> b;
+  ORT_RETURN_IF_ERROR(get_matrix(a_data, a_operand, step.m_labels, step.k_labels, a));
+  ORT_RETURN_IF_ERROR(get_matrix(b_data, b_operand, step.k_labels, step.n_labels, b));
+
+  const int M = static_cast<int>(Product(step.m_labels, label_sizes));
+  const int N = static_cast<int>(Product(step.n_labels, label_sizes));
+  const int K = static_cast<int>(Product(step.k_labels, label_sizes));
+  const int batch_size = static_cast<int>(Product(step.batch_labels, label_sizes));
+
+  const CudaT one = ToCudaType<T>::FromFloat(1.0f);
+  const CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+
+  // cuBLAS is column major, so the row major C = A x B is computed as C^T = B^T x A^T.
+  CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+      CublasHandle(),
+      b.transpose ? CUBLAS_OP_T : CUBLAS_OP_N,
+      a.transpose ? CUBLAS_OP_T : CUBLAS_OP_N,
+      N, M, K, &one,
+      b.data, static_cast<int>(b.ld), b.batch_stride,
+      a.data, static_cast<int>(a.ld), a.batch_stride,
+      &zero, output, N, static_cast<int64_t>(M) * N,
+      batch_size));
+
+  return Status::OK();
+}
+
+template <typename T>
+Status Einsum<T>::ComputeInternal(OpKernelContext* context) const {
+  const size_t num_inputs = static_cast<size_t>(context->InputCount());
+  std::vector<const TensorShape*> input_shapes;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    input_shapes.push_back(&context->Input<Tensor>(static_cast<int>(i))->Shape());
+  }
+
+  EinsumComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(equation_, input_shapes));
+
+  Tensor* Y = context->Output(0, helper.OutputShape());
+  CudaT* output = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  if (helper.HasEmptyLabel()) {
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(output, 0, Y->SizeInBytes(), onnxruntime::cuda::CurrentStream()));
+    return Status::OK();
+  }
+
+  const auto& label_sizes = helper.LabelSizes();
+  const auto& operands = helper.Operands();
+  const auto& steps = helper.Steps();
+
+  // the data of each operand, and the buffers of the intermediate results that a later step still reads
+  std::vector<const CudaT*> data(operands.size());
+  std::vector<IAllocatorUniquePtr<CudaT>> buffers(operands.size());
+  for (size_t i = 0; i < num_inputs; ++i) {
+    data[i] = reinterpret_cast<const CudaT*>(context->Input<Tensor>(static_cast<int>(i))->template Data<T>());
+  }
+
+  for (size_t s = 0; s < steps.size(); ++s) {
+    const auto& step = steps[s];
+    const size_t result = num_inputs + s;
+    CudaT* result_data = output;
+    if (s + 1 < steps.size()) {
+      buffers[result] = GetScratchBuffer<CudaT>(Product(operands[result].labels, label_sizes));
+      result_data = buffers[result].get();
+    }
+
+    if (step.is_contraction) {
+      ORT_RETURN_IF_ERROR(Contract(step, data[step.input0], operands[step.input0], data[step.input1],
+                                   operands[step.input1], label_sizes, result_data));
+      buffers[step.input1].reset();
+    } else {
+      ORT_RETURN_IF_ERROR(Reduce(data[step.input0], operands[step.input0], step.kept_labels, label_sizes,
+                                 result_data));
+    }
+    buffers[step.input0].reset();
+    data[result] = result_data;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/einsum_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Evaluates the contractions planned by EinsumComputeHelper as one strided batched cuBLAS GEMM each. An operand
+// whose labels don't map to evenly strided matrices is copied to a contiguous buffer first, by the same kernel
+// that sums the labels reduced before a contraction or at the end.
+template <typename T>
+class Einsum final : public onnxruntime::cuda::CudaKernel {
+ public:
+  explicit Einsum(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  typedef typename onnxruntime::cuda::ToCudaType<T>::MappedType CudaT;
+
+  Status Reduce(const CudaT* input, const EinsumOperand& operand, const std::vector<int>& kept_labels,
+                const std::vector<int64_t>& label_sizes, CudaT* output) const;
+
+  Status Contract(const EinsumStep& step, const CudaT* a_data, const EinsumOperand& a_operand,
+                  const CudaT* b_data, const EinsumOperand& b_operand, const std::vector<int64_t>& label_sizes,
+                  CudaT* output) const;
+
+  EinsumEquation equation_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
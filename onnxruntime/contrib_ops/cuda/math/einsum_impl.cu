@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "einsum_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The sums are accumulated in float for half.
+template <typename T>
+struct EinsumAccumulator {
+  typedef T Type;
+};
+
+template <>
+struct EinsumAccumulator<half> {
+  typedef float Type;
+};
+
+__device__ __inline__ int64_t EinsumOffset(
+    int index,
+    int rank,
+    const fast_divmod* sizes,
+    const int64_t* strides) {
+  int64_t offset = 0;
+  for (int i = rank - 1; i >= 0; i--) {
+    int q, r;
+    sizes[i].divmod(index, q, r);
+    offset += r * strides[i];
+    index = q;
+  }
+  return offset;
+}
+
+// One thread for each element of the output.
+template <typename T>
+__global__ void _EinsumReduceKernel(
+    const T* input_data,
+    T* output_data,
+    const EinsumReduceArgs args,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  typedef typename EinsumAccumulator<T>::Type AccT;
+
+  const T* input = input_data + EinsumOffset(id, args.kept_rank, args.kept_sizes, args.kept_strides);
+  AccT sum = 0;
+  for (int i = 0; i < args.summed_count; i++) {
+    sum += static_cast<AccT>(input[EinsumOffset(i, args.summed_rank, args.summed_sizes, args.summed_strides)]);
+  }
+
+  output_data[id] = static_cast<T>(sum);
+}
+
+// One block for each element of the output, for the long sums whose few results would leave most threads idle.
+template <typename T>
+__global__ void _EinsumReduceBlockKernel(
+    const T* input_data,
+    T* output_data,
+    const EinsumReduceArgs args) {
+  typedef typename EinsumAccumulator<T>::Type AccT;
+  __shared__ AccT partial_sums[GridDim::maxThreadsPerBlock];
+
+  const T* input = input_data + EinsumOffset(blockIdx.x, args.kept_rank, args.kept_sizes, args.kept_strides);
+  AccT sum = 0;
+  for (int i = threadIdx.x; i < args.summed_count; i += blockDim.x) {
+    sum += static_cast<AccT>(input[EinsumOffset(i, args.summed_rank, args.summed_sizes, args.summed_strides)]);
+  }
+
+  partial_sums[threadIdx.x] = sum;
+  __syncthreads();
+
+  for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+    if (threadIdx.x < stride) {
+      partial_sums[threadIdx.x] += partial_sums[threadIdx.x + stride];
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.x == 0) {
+    output_data[blockIdx.x] = static_cast<T>(partial_sums[0]);
+  }
+}
+
+template <typename T>
+void EinsumReduceImpl(
+    const T* input_data,
+    T* output_data,
+    const EinsumReduceArgs& args,
+    size_t output_count) {
+  if (args.summed_count >= GridDim::maxThreadsPerBlock) {
+    _EinsumReduceBlockKernel<T><<<static_cast<int>(output_count), GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+        input_data, output_data, args);
+    return;
+  }
+
+  int blocksPerGrid = (int)(ceil(static_cast<float>(output_count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(output_count);
+  _EinsumReduceKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_data, output_data, args, N);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                             \
+  template void EinsumReduceImpl<T>(const T* input_data, T* output_data, const EinsumReduceArgs& args, \
+                                    size_t output_count);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/fast_divmod.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The most labels a reduction keeps or sums. The sizes and strides are passed in the launch parameters, so an
+// operand with more labels is not supported by the CUDA execution provider.
+constexpr int kMaxEinsumReduceRank = 12;
+
+struct EinsumReduceArgs {
+  // the labels of the output, which is contiguous, with the stride of each in the input
+  int kept_rank;
+  onnxruntime::cuda::fast_divmod kept_sizes[kMaxEinsumReduceRank];
+  int64_t kept_strides[kMaxEinsumReduceRank];
+  // the labels summed into each element of the output, in the order they are visited
+  int summed_rank;
+  onnxruntime::cuda::fast_divmod summed_sizes[kMaxEinsumReduceRank];
+  int64_t summed_strides[kMaxEinsumReduceRank];
+  int summed_count;
+};
+
+// Writes output_count elements, each the sum of the summed_count elements of the input it indexes. With no summed
+// labels, this copies the input to the order of the kept labels.
+template <typename T>
+void EinsumReduceImpl(
+    const T* input_data,
+    T* output_data,
+    const EinsumReduceArgs& args,
+    size_t output_count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+#include "fused_elementwise_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedElementwise,                                           \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedElementwise<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+FusedElementwiseOperation ToCudaOperation(contrib::FusedElementwise::Operation operation) {
+  using Operation = contrib::FusedElementwise::Operation;
+  switch (operation) {
+    case Operation::Add:
+      return FusedElementwiseOperation::Add;
+    case Operation::Sub:
+      return FusedElementwiseOperation::Sub;
+    case Operation::Mul:
+      return FusedElementwiseOperation::Mul;
+    case Operation::Div:
+      return FusedElementwiseOperation::Div;
+    case Operation::Relu:
+      return FusedElementwiseOperation::Relu;
+    case Operation::Sigmoid:
+      return FusedElementwiseOperation::Sigmoid;
+    case Operation::Tanh:
+      return FusedElementwiseOperation::Tanh;
+    case Operation::Exp:
+      return FusedElementwiseOperation::Exp;
+    case Operation::Log:
+      return FusedElementwiseOperation::Log;
+    case Operation::Neg:
+      return FusedElementwiseOperation::Neg;
+    case Operation::Abs:
+      return FusedElementwiseOperation::Abs;
+    case Operation::Sqrt:
+      return FusedElementwiseOperation::Sqrt;
+    case Operation::Erf:
+      return FusedElementwiseOperation::Erf;
+  }
+  ORT_THROW("Unexpected operation ", static_cast<int>(operation));
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info)
+    : CudaKernel(info), steps_(contrib::FusedElementwise::ParseSteps(info)) {
+  ORT_ENFORCE(steps_.size() <= static_cast<size_t>(kMaxFusedElementwiseSteps),
+              "FusedElementwise on CUDA supports at most ", kMaxFusedElementwiseSteps, " operations, got ",
+              steps_.size());
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  const int64_t total = shape.Size();
+  const int64_t row_size = shape.NumDimensions() > 0 ? shape[shape.NumDimensions() - 1] : 1;
+
+  Tensor* Y = context->Output(0, shape);
+
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  // Resolve how each operand broadcasts against X, as the CPU kernel does.
+  FusedElementwiseProgram<CudaT> program;
+  program.step_count = static_cast<int>(steps_.size());
+  for (size_t i = 0; i < steps_.size(); i++) {
+    FusedElementwiseStep<CudaT>& step = program.steps[i];
+    step.operation = ToCudaOperation(steps_[i].operation);
+    step.operand_first = steps_[i].operand_first;
+    step.operand = nullptr;
+    step.operand_kind = FusedElementwiseOperandKind::None;
+
+    if (steps_[i].operand_index < 0) {
+      continue;
+    }
+
+    const Tensor* B = context->Input<Tensor>(steps_[i].operand_index);
+    const int64_t size = B->Shape().Size();
+    step.operand = reinterpret_cast<const CudaT*>(B->template Data<T>());
+
+    if (size == total && B->Shape() == shape) {
+      step.operand_kind = FusedElementwiseOperandKind::Full;
+    } else if (size == 1) {
+      step.operand_kind = FusedElementwiseOperandKind::Scalar;
+    } else if (size == row_size && B->Shape()[B->Shape().NumDimensions() - 1] == row_size) {
+      step.operand_kind = FusedElementwiseOperandKind::Row;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Operand ", steps_[i].operand_index, " with shape ",
+                             B->Shape(), " does not broadcast to the input shape ", shape);
+    }
+  }
+
+  FusedElementwiseImpl<CudaT>(
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+      program,
+      onnxruntime::cuda::fast_divmod(gsl::narrow_cast<int>(row_size)),
+      static_cast<size_t>(total));
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
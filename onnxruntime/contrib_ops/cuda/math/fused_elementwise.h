@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Runs the chain of element-wise operations of a FusedElementwise node in a single kernel, so the chain costs one
+// launch and one pass over memory rather than one of each per operation.
+template <typename T>
+class FusedElementwise final : public onnxruntime::cuda::CudaKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<contrib::FusedElementwise::Step> steps_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
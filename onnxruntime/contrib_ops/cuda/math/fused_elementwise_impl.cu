@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Every thread runs the same steps, so the switches don't diverge. The arithmetic is in float for half.
+template <typename T>
+__global__ void _FusedElementwiseKernel(
+    const T* input_data,
+    T* output_data,
+    const FusedElementwiseProgram<T> program,
+    const fast_divmod row_size,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  float value = static_cast<float>(input_data[id]);
+
+  for (int i = 0; i < program.step_count; i++) {
+    const FusedElementwiseStep<T>& step = program.steps[i];
+
+    float operand = 0.0f;
+    switch (step.operand_kind) {
+      case FusedElementwiseOperandKind::Full:
+        operand = static_cast<float>(step.operand[id]);
+        break;
+      case FusedElementwiseOperandKind::Scalar:
+        operand = static_cast<float>(step.operand[0]);
+        break;
+      case FusedElementwiseOperandKind::Row: {
+        int row, column;
+        row_size.divmod(id, row, column);
+        operand = static_cast<float>(step.operand[column]);
+        break;
+      }
+      default:
+        break;
+    }
+
+    const float a = step.operand_first ? operand : value;
+    const float b = step.operand_first ? value : operand;
+
+    switch (step.operation) {
+      case FusedElementwiseOperation::Add:
+        value = a + b;
+        break;
+      case FusedElementwiseOperation::Sub:
+        value = a - b;
+        break;
+      case FusedElementwiseOperation::Mul:
+        value = a * b;
+        break;
+      case FusedElementwiseOperation::Div:
+        value = a / b;
+        break;
+      case FusedElementwiseOperation::Relu:
+        value = _Max(value, 0.0f);
+        break;
+      case FusedElementwiseOperation::Sigmoid:
+        value = 1.0f / (1.0f + _Exp(-value));
+        break;
+      case FusedElementwiseOperation::Tanh:
+        value = _Tanh(value);
+        break;
+      case FusedElementwiseOperation::Exp:
+        value = _Exp(value);
+        break;
+      case FusedElementwiseOperation::Log:
+        value = _Log(value);
+        break;
+      case FusedElementwiseOperation::Neg:
+        value = -value;
+        break;
+      case FusedElementwiseOperation::Abs:
+        value = fabsf(value);
+        break;
+      case FusedElementwiseOperation::Sqrt:
+        value = _Sqrt(value);
+        break;
+      case FusedElementwiseOperation::Erf:
+        value = _Erf(value);
+        break;
+    }
+  }
+
+  output_data[id] = static_cast<T>(value);
+}
+
+template <typename T>
+void FusedElementwiseImpl(
+    const T* input_data,
+    T* output_data,
+    const FusedElementwiseProgram<T>& program,
+    const fast_divmod& row_size,
+    size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _FusedElementwiseKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      input_data, output_data, program, row_size, N);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                    \
+  template void FusedElementwiseImpl<T>(const T* input_data, T* output_data,                                   \
+                                        const FusedElementwiseProgram<T>& program, const fast_divmod& row_size, \
+                                        size_t count);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/fast_divmod.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The most operations a kernel applies. The program is passed in the launch parameters, so ElementwiseFusion stops
+// a CUDA chain at this length.
+constexpr int kMaxFusedElementwiseSteps = 16;
+
+enum class FusedElementwiseOperation : int8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Log,
+  Neg,
+  Abs,
+  Sqrt,
+  Erf,
+};
+
+enum class FusedElementwiseOperandKind : int8_t {
+  None,    // a unary operation
+  Full,    // same shape as X
+  Scalar,  // a single element
+  Row,     // a vector broadcast along the last dimension of X
+};
+
+template <typename T>
+struct FusedElementwiseStep {
+  FusedElementwiseOperation operation;
+  FusedElementwiseOperandKind operand_kind;
+  bool operand_first;  // true if the operand is the first input of the original operation
+  const T* operand;
+};
+
+template <typename T>
+struct FusedElementwiseProgram {
+  int step_count;
+  FusedElementwiseStep<T> steps[kMaxFusedElementwiseSteps];
+};
+
+// Applies the steps of the program to each element of input in one kernel, keeping the running value in a register.
+// row_size is the last dimension of the input, for the Row operands.
+template <typename T>
+void FusedElementwiseImpl(
+    const T* input_data,
+    T* output_data,
+    const FusedElementwiseProgram<T>& program,
+    const onnxruntime::cuda::fast_divmod& row_size,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
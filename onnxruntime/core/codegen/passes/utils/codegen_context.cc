@@ -23,5 +23,17 @@ std::string CodeGenContext::CreateUnnamedSymbol() {
   return "unnamed_" + std::to_string(unname_symbol_counter_++);
 }
 
+void CodeGenContext::SpecializeDynamicDim(const std::string& name, int64_t value) {
+  specialized_dims_[name] = value;
+}
+
+bool CodeGenContext::TryGetSpecializedDim(const std::string& name, int64_t& value) const {
+  auto iter = specialized_dims_.find(name);
+  if (iter == specialized_dims_.end())
+    return false;
+  value = iter->second;
+  return true;
+}
+
 }  // namespace tvm_codegen
 }  // namespace onnxruntime
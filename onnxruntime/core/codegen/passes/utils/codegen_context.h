@@ -29,9 +29,17 @@ class CodeGenContext {
 
   std::string CreateUnnamedSymbol();
 
+  // a specialized dynamic dim is generated as a constant instead of a tvm::Var
+  void SpecializeDynamicDim(const std::string& name, int64_t value);
+
+  // returns true and the value of the dynamic dim if it is specialized
+  bool TryGetSpecializedDim(const std::string& name, int64_t& value) const;
+
  protected:
   std::unordered_map<std::string, tvm::Var> dynamic_dims_;
 
+  std::unordered_map<std::string, int64_t> specialized_dims_;
+
   const codegen::CodeGenHandle* handle_;
 
   int unname_symbol_counter_;
@@ -98,6 +98,9 @@ tvm::Array<tvm::Expr> ShapeToTvmArray(const NodeArg* def, CodeGenContext& ctx) {
 
 tvm::Expr ShapeDimToTvmDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim, CodeGenContext& ctx) {
   if (utils::HasDimParam(dim)) {
+    int64_t value;
+    if (ctx.TryGetSpecializedDim(dim.dim_param(), value))
+      return tvm::Expr(gsl::narrow_cast<int32_t>(value));
     return ctx.GetOrCreateDynamicDim(dim.dim_param());
   } else if (utils::HasDimValue(dim)) {
     return tvm::Expr(gsl::narrow_cast<int32_t>(dim.dim_value()));
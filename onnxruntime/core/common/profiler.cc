@@ -64,15 +64,28 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
   long long dur = TimeDiffMicroSeconds(start_time);
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
-  EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+  RecordEvent(EventRecord(category, logging::GetProcessId(),
+                          logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()}));
+}
+
+void Profiler::RecordDeviceEvent(EventCategory category,
+                                 const std::string& event_name,
+                                 const TimePoint& start_time,
+                                 long long duration_us,
+                                 int thread_id,
+                                 const std::initializer_list<std::pair<std::string, std::string>>& event_args) {
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+  RecordEvent(EventRecord(category, logging::GetProcessId(),
+                          thread_id, event_name, ts, duration_us, {event_args.begin(), event_args.end()}));
+}
+
+void Profiler::RecordEvent(EventRecord&& event) {
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
-    //TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
+      events_.emplace_back(std::move(event));
     } else {
       if (session_logger_ && !max_events_reached) {
         LOGS(*session_logger_, ERROR)
@@ -67,6 +67,18 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record an event timed on a device, e.g. the device time of a node queued by its execution provider.
+  start_time is the start of the event on the host clock. thread_id is the tid of the event in the profile,
+  so that the events of a device show on their own row.
+  */
+  void RecordDeviceEvent(EventCategory category,
+                         const std::string& event_name,
+                         const TimePoint& start_time,
+                         long long duration_us,
+                         int thread_id,
+                         const std::initializer_list<std::pair<std::string, std::string>>& event_args = {});
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -85,6 +97,8 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  void RecordEvent(EventRecord&& event);
+
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
   bool enabled_{false};
@@ -3,35 +3,270 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#else
-#pragma warning(push)
-#pragma warning(disable : 4267)
-#endif
-#include <unsupported/Eigen/CXX11/src/ThreadPool/Barrier.h>
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
-#else
-#pragma warning(pop)
-#endif
-
-using Eigen::Barrier;
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace onnxruntime {
 
 namespace concurrency {
+namespace {
+// Barrier for the caller of a parallel loop. Waits for 'count' notifications, spinning/yielding for up to
+// spin_duration_us before blocking on a condition variable.
+class SpinBarrier {
+ public:
+  SpinBarrier(unsigned int count, int spin_duration_us) : pending_(count), spin_duration_us_(spin_duration_us) {}
+
+  void Notify() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+      cv_.notify_all();
+    }
+  }
+
+  void Wait() {
+    if (spin_duration_us_ > 0) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_duration_us_);
+      for (unsigned int i = 1; pending_.load(std::memory_order_acquire) > 0; ++i) {
+        // checking the clock is relatively expensive so only do it periodically
+        if (i % 64 == 0) {
+          if (std::chrono::steady_clock::now() >= deadline)
+            break;
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    // always synchronize via the mutex so the last notifier is done with this object before it is destroyed
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return done_; });
+  }
+
+ private:
+  std::atomic<unsigned int> pending_;
+  const int spin_duration_us_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_ = false;
+};
+
+// see ParallelForStatsScope
+thread_local ParallelForStats* current_parallel_for_stats = nullptr;
+
+// see ThreadPoolPriorityScope
+thread_local ThreadPoolPriority current_priority = ThreadPoolPriority::kNormal;
+thread_local int current_max_threads = 0;
+}  // namespace
+
+ParallelForStatsScope::ParallelForStatsScope(ParallelForStats* stats) : previous_(current_parallel_for_stats) {
+  current_parallel_for_stats = stats;
+}
+
+ParallelForStatsScope::~ParallelForStatsScope() {
+  current_parallel_for_stats = previous_;
+}
+
+ThreadPoolPriorityScope::ThreadPoolPriorityScope(ThreadPoolPriority priority, int max_threads)
+    : previous_priority_(current_priority), previous_max_threads_(current_max_threads) {
+  current_priority = priority;
+  current_max_threads = max_threads;
+}
+
+ThreadPoolPriorityScope::~ThreadPoolPriorityScope() {
+  current_priority = previous_priority_;
+  current_max_threads = previous_max_threads_;
+}
+
+ThreadPoolPriority ThreadPoolPriorityScope::CurrentPriority() { return current_priority; }
+
+int ThreadPoolPriorityScope::CurrentMaxThreads() { return current_max_threads; }
+
+//
+// ThreadEnvironment
+//
+ThreadEnvironment::EnvThread* ThreadEnvironment::CreateThread(std::function<void()> f) {
+  if (cpu_affinity_.empty()) {
+    return Eigen::StlThreadEnvironment::CreateThread(std::move(f));
+  }
+
+  std::vector<int> cpus = cpu_affinity_;
+  return new EnvThread([cpus, f]() {
+    // the session checks that the processors exist, but the process may not be allowed to run on them, e.g. in a
+    // container. the thread then runs without the affinity.
+    auto status = Env::Default().SetCurrentThreadAffinity(cpus);
+    if (!status.IsOK() && logging::LoggingManager::HasDefaultLogger()) {
+      LOGS_DEFAULT(WARNING) << "Could not set the affinity of a thread pool thread. Error Message: "
+                            << status.ErrorMessage();
+    }
+    f();
+  });
+}
+
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadPool::ThreadPool(const std::string&, int num_threads, bool allow_spinning, int spin_duration_us,
+                       const std::vector<int>& cpu_affinity)
+    : allow_spinning_(allow_spinning),
+      spin_duration_us_(spin_duration_us),
+      impl_(num_threads, allow_spinning && spin_duration_us <= 0, ThreadEnvironment(cpu_affinity)) {
+  for (auto& active_loops : active_loops_) {
+    active_loops.store(0, std::memory_order_relaxed);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  // the threads spinning for work stop so that impl_ can join them
+  stop_spinning_.store(true, std::memory_order_relaxed);
+}
 
 void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
 
+void ThreadPool::RunBlocks(std::ptrdiff_t num_blocks, const std::function<void(std::ptrdiff_t)>& block_fn) {
+  if (num_blocks <= 0)
+    return;
+
+  ParallelForStats* stats = current_parallel_for_stats;
+  if (stats != nullptr) {
+    ++stats->num_calls;
+    stats->num_threads_available += NumThreads() + 1;
+  }
+
+  const int priority = static_cast<int>(ThreadPoolPriorityScope::CurrentPriority());
+  const int max_threads = ThreadPoolPriorityScope::CurrentMaxThreads();
+  std::ptrdiff_t num_helpers = std::min<std::ptrdiff_t>(NumThreads(), num_blocks - 1);
+  if (max_threads > 0) {
+    num_helpers = std::min<std::ptrdiff_t>(num_helpers, max_threads - 1);
+  }
+
+  if (num_helpers <= 0) {
+    for (std::ptrdiff_t i = 0; i < num_blocks; ++i) {
+      block_fn(i);
+    }
+    if (stats != nullptr) {
+      ++stats->num_threads_used;
+    }
+    return;
+  }
+
+  std::atomic<std::ptrdiff_t> next_block{0};
+  std::atomic<uint64_t> num_threads_used{0};
+  auto run_blocks = [this, &next_block, &num_threads_used, num_blocks, &block_fn, priority](bool is_helper) {
+    bool ran_block = false;
+    for (;;) {
+      // a helper leaves the remaining blocks to the calling thread while a higher priority loop needs the threads
+      if (is_helper && HasHigherPriorityLoops(priority))
+        break;
+      std::ptrdiff_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+      if (block >= num_blocks)
+        break;
+      block_fn(block);
+      ran_block = true;
+    }
+    if (ran_block) {
+      num_threads_used.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  active_loops_[priority].fetch_add(1, std::memory_order_relaxed);
+
+  SpinBarrier barrier(static_cast<unsigned int>(num_helpers), spin_duration_us_);
+  std::function<void()> helper = [&run_blocks, &barrier]() {
+    run_blocks(true);
+    barrier.Notify();
+  };
+  uint64_t num_helpers_to_spinning_threads = 0;
+  for (std::ptrdiff_t i = 0; i < num_helpers; ++i) {
+    if (HandToSpinningThread(helper)) {
+      ++num_helpers_to_spinning_threads;
+      continue;
+    }
+    Schedule([this, helper]() {
+      helper();
+      SpinForWork();
+    });
+  }
+
+  // the calling thread participates, so all blocks may be done before a helper gets to run
+  run_blocks(false);
+  // all the blocks are claimed, so the loop no longer needs more threads
+  active_loops_[priority].fetch_sub(1, std::memory_order_relaxed);
+  barrier.Wait();
+
+  if (stats != nullptr) {
+    stats->num_threads_used += num_threads_used.load(std::memory_order_relaxed);
+    stats->num_helpers_to_spinning_threads += num_helpers_to_spinning_threads;
+  }
+}
+
+bool ThreadPool::HandToSpinningThread(const std::function<void()>& helper) {
+  if (num_spinning_threads_.load(std::memory_order_relaxed) == 0)
+    return false;
+
+  std::lock_guard<std::mutex> lock(spin_mutex_);
+  if (static_cast<size_t>(num_spinning_threads_.load(std::memory_order_relaxed)) <= spin_helpers_.size())
+    return false;
+  spin_helpers_.push_back(helper);
+  num_spin_helpers_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void ThreadPool::SpinForWork() {
+  if (!allow_spinning_ || spin_duration_us_ <= 0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(spin_mutex_);
+    num_spinning_threads_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_duration_us_);
+  for (unsigned int i = 1;; ++i) {
+    // checking the clock is relatively expensive so only do it periodically
+    const bool timed_out = i % 64 == 0 && (stop_spinning_.load(std::memory_order_relaxed) ||
+                                           std::chrono::steady_clock::now() >= deadline);
+    if (num_spin_helpers_.load(std::memory_order_acquire) == 0 && !timed_out) {
+      if (i % 64 == 0)
+        std::this_thread::yield();
+      continue;
+    }
+
+    // a thread stops spinning only when no helper is left for it, so every helper handed over is run
+    std::function<void()> helper;
+    {
+      std::lock_guard<std::mutex> lock(spin_mutex_);
+      if (!spin_helpers_.empty()) {
+        helper = std::move(spin_helpers_.front());
+        spin_helpers_.pop_front();
+        num_spin_helpers_.fetch_sub(1, std::memory_order_relaxed);
+      } else if (!timed_out) {
+        // another spinning thread took it
+        continue;
+      }
+      num_spinning_threads_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (!helper)
+      return;
+
+    helper();
+
+    {
+      std::lock_guard<std::mutex> lock(spin_mutex_);
+      num_spinning_threads_.fetch_add(1, std::memory_order_relaxed);
+    }
+    deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(spin_duration_us_);
+  }
+}
+
 void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
   if (total <= 0)
     return;
@@ -41,20 +276,46 @@ void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(total - 1));
-  std::function<void(int32_t)> handle_iteration = [&barrier, &fn](int iteration) {
-    fn(iteration);
-    barrier.Notify();
-  };
+  // use a few blocks per thread so uneven iterations can be balanced
+  const int32_t num_threads = NumThreads() + 1;
+  const int32_t block_size = std::max<int32_t>(1, total / (num_threads * 4));
+  const int32_t num_blocks = (total + block_size - 1) / block_size;
+
+  RunBlocks(num_blocks, [total, block_size, &fn](std::ptrdiff_t block) {
+    const int32_t start = static_cast<int32_t>(block) * block_size;
+    const int32_t end = std::min(total, start + block_size);
+    for (int32_t i = start; i < end; i++) {
+      fn(i);
+    }
+  });
+}
+
+void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+  if (total <= 0)
+    return;
 
-  for (int32_t id = 1; id < total; ++id) {
-    Schedule([=, &handle_iteration]() { handle_iteration(id); });
+  // Roughly the cost of handing a block to another thread, in cycles. Work totalling less than a
+  // couple of these runs inline as the dispatch would cost about as much as the work itself.
+  constexpr double kDispatchCost = 10000.0;
+  const double total_cost = static_cast<double>(total) * std::max(cost_per_unit, 1.0);
+  const std::ptrdiff_t num_threads = NumThreads() + 1;
+  if (total == 1 || num_threads == 1 || total_cost < 2 * kDispatchCost) {
+    fn(0, total);
+    return;
   }
 
-  fn(0);
-  barrier.Wait();
+  // each block should be worth at least one dispatch, and there should be up to 4 blocks per thread for balancing
+  const std::ptrdiff_t max_blocks = std::min<std::ptrdiff_t>(total, num_threads * 4);
+  const std::ptrdiff_t num_blocks =
+      std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(max_blocks,
+                                                           static_cast<std::ptrdiff_t>(total_cost / kDispatchCost)));
+  const std::ptrdiff_t block_size = (total + num_blocks - 1) / num_blocks;
+
+  RunBlocks((total + block_size - 1) / block_size, [total, block_size, &fn](std::ptrdiff_t block) {
+    const std::ptrdiff_t first = block * block_size;
+    fn(first, std::min(total, first + block_size));
+  });
 }
 
 void ThreadPool::BatchParallelFor(int32_t total, std::function<void(int32_t)> fn, int32_t num_batches) {
@@ -78,9 +339,9 @@ void ThreadPool::BatchParallelFor(int32_t total, std::function<void(int32_t)> fn
     return;
   }
 
-  ParallelFor(num_batches, [&](int batch_index) {
-    int start = batch_index * total / num_batches;
-    int end = (batch_index + 1) * total / num_batches;
+  RunBlocks(num_batches, [&](std::ptrdiff_t batch_index) {
+    int start = static_cast<int>(batch_index * total / num_batches);
+    int end = static_cast<int>((batch_index + 1) * total / num_batches);
     for (int i = start; i < end; i++) {
       fn(i);
     }
@@ -94,20 +355,17 @@ void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<voi
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(last - first));
-  std::function<void(int64_t, int64_t)> handle_range = [&barrier, &fn](int64_t first, int64_t last) {
-    fn(first, last);
-    barrier.Notify();
-  };
+  RunBlocks(static_cast<std::ptrdiff_t>(last - first + 1), [first, &fn](std::ptrdiff_t i) {
+    fn(first + i, first + i + 1);
+  });
+}
 
-  for (int64_t id = first + 1; id <= last; ++id) {
-    Schedule([=, &handle_range]() { handle_range(id, id + 1); });
+bool ThreadPool::HasHigherPriorityLoops(int priority) const {
+  for (int i = 0; i < priority; ++i) {
+    if (active_loops_[i].load(std::memory_order_relaxed) > 0)
+      return true;
   }
-
-  fn(first, first + 1);
-  barrier.Wait();
+  return false;
 }
 
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
@@ -4,6 +4,8 @@
 #pragma once
 
 #include "core/framework/tensor.h"
+#include <iterator>
+#include <memory>
 #include <vector>
 #include <utility>
 
@@ -17,7 +19,29 @@ class TensorSeq {
     SetType(elem_type);
   }
 
-  using const_iterator = std::vector<Tensor>::const_iterator;
+  // Iterates the tensors of the sequence
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Tensor;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Tensor*;
+    using reference = const Tensor&;
+
+    explicit const_iterator(std::vector<std::shared_ptr<const Tensor>>::const_iterator it) noexcept : it_(it) {}
+
+    reference operator*() const noexcept { return **it_; }
+    pointer operator->() const noexcept { return it_->get(); }
+    const_iterator& operator++() noexcept {
+      ++it_;
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const noexcept { return it_ == other.it_; }
+    bool operator!=(const const_iterator& other) const noexcept { return it_ != other.it_; }
+
+   private:
+    std::vector<std::shared_ptr<const Tensor>>::const_iterator it_;
+  };
 
   // Sets the element type after construction.
   // Expects sequence to be empty at the time.
@@ -29,7 +53,32 @@ class TensorSeq {
 
   void SetElements(std::vector<Tensor>&& tensors) {
     assert(tensors_.empty());
-    tensors_ = std::move(tensors);
+    tensors_.reserve(tensors.size());
+    for (auto& tensor : tensors) {
+      tensors_.push_back(std::make_shared<Tensor>(std::move(tensor)));
+    }
+  }
+
+  // Reserves space for capacity tensors so that building the sequence a tensor at a time doesn't reallocate it.
+  void Reserve(size_t capacity) {
+    tensors_.reserve(capacity);
+  }
+
+  // Moves tensor to the end of the sequence.
+  void Add(Tensor&& tensor) {
+    tensors_.push_back(std::make_shared<Tensor>(std::move(tensor)));
+  }
+
+  // Adds a tensor that may be shared with other sequences, or whose deleter keeps alive a buffer it is a view of.
+  void Add(std::shared_ptr<const Tensor> tensor) {
+    tensors_.push_back(std::move(tensor));
+  }
+
+  // Adds the tensor at index i of another sequence without copying it. The tensors of a sequence are immutable,
+  // so ops like SequenceInsert and SequenceErase share them between their input and output sequences.
+  void Add(const TensorSeq& other, size_t i) {
+    ORT_ENFORCE(i < other.tensors_.size());
+    tensors_.push_back(other.tensors_[i]);
   }
 
   MLDataType DataType() const noexcept { return elem_type_; }
@@ -46,17 +95,17 @@ class TensorSeq {
 
   // Suitable for for range loop
   const_iterator begin() const noexcept {
-    return tensors_.cbegin();
+    return const_iterator(tensors_.cbegin());
   }
 
   const_iterator end() const noexcept {
-    return tensors_.cend();
+    return const_iterator(tensors_.cend());
   }
 
   // Get by index
   const Tensor& Get(size_t i) const {
     ORT_ENFORCE(i < tensors_.size());
-    return tensors_[i];
+    return *tensors_[i];
   }
 
  private:
@@ -69,7 +118,9 @@ class TensorSeq {
 
   // TODO: optimization opportunity - if all tensors in the seq are scalars, we can potentially represent them
   // as vector<primitive type>
-  std::vector<Tensor> tensors_;
+  // The tensors are shared so that the sequence ops can create a new sequence without copying the tensors
+  // of their input.
+  std::vector<std::shared_ptr<const Tensor>> tensors_;
 };
 
 }  // namespace onnxruntime
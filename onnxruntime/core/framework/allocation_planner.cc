@@ -4,6 +4,7 @@
 #include "core/framework/allocation_planner.h"
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <sstream>
 #include "core/common/exceptions.h"
@@ -63,6 +64,8 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.viewed_value >= 0) out << ", may view " << elt_plan.viewed_value;
+      if (elt_plan.container >= 0) out << ", in " << elt_plan.container << " at " << elt_plan.container_offset;
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -134,6 +137,9 @@ class PlannerImpl {
     const onnxruntime::NodeArg* p_def_site;  // the (unique) NodeArg corresponding to the MLValue
     int usecount = 0;                        // static reference-count
     OrtValueIndex reused_buffer_index;       // index of original buffer to reuse
+    // original buffers that must stay alive until this buffer is freed, as it may be a view into them
+    std::vector<OrtValueIndex> viewed_buffers;
+    bool is_container = false;  // other tensors are allocated in this buffer, see AllocPlanPerValue::container
   };
 
   // ort_value_info_ is indexed by an OrtValueIndex
@@ -184,9 +190,318 @@ class PlannerImpl {
     OrtValueInfo& info = ort_value_info_[id];
     info.usecount = 0;
     info.reused_buffer_index = id;  // initially, no reuse; the ml-value uses its own buffer
+    info.viewed_buffers.clear();
+    info.is_container = false;
     info.p_def_site = p_def_site;
   }
 
+  // A value that may be a view into another buffer must not be reused or updated in-place,
+  // as that would write to (or free) the viewed buffer.
+  bool MayBeView(OrtValueIndex original) {
+    ORT_ENFORCE(original >= 0 && static_cast<size_t>(original) < ort_value_info_.size());
+    return !ort_value_info_[original].viewed_buffers.empty();
+  }
+
+  // Decrement the usecount of an original buffer, and free it once it's no longer used. A freed buffer that
+  // may be a view releases the buffers it views, as nothing can read them through it anymore.
+  void ReleaseUse(OrtValueIndex original, size_t program_counter) {
+    if (0 == --UseCount(original)) {
+      freelist_.push_front(FreeBufferInfo(original, program_counter));
+      for (auto viewed : ort_value_info_[original].viewed_buffers) {
+        ReleaseUse(viewed, program_counter);
+      }
+    }
+  }
+
+  // Returns the shape of node_arg if it is a tensor with a statically known shape and sets num_bytes to its size.
+  const TensorShapeProto* GetStaticShape(const onnxruntime::NodeArg& node_arg, size_t& num_bytes) {
+    if (!node_arg.Exists() || IsNonTensor(node_arg) || IsStringTensor(node_arg)) return nullptr;
+    auto p_shape = context_.GetShape(node_arg);
+    if (nullptr == p_shape) return nullptr;
+
+    num_bytes = GetElementSize(node_arg.Type());
+    for (const auto& dim : p_shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() <= 0) return nullptr;
+      num_bytes *= static_cast<size_t>(dim.dim_value());
+    }
+    return p_shape;
+  }
+
+  // Estimate the size of a value for ordering the nodes. Symbolic dims count as 1 and values of unknown shape as 0.
+  size_t EstimateBytes(const onnxruntime::NodeArg& node_arg) {
+    if (!node_arg.Exists() || IsNonTensor(node_arg)) return 0;
+    auto p_shape = context_.GetShape(node_arg);
+    if (nullptr == p_shape) return 0;
+
+    size_t num_bytes = IsStringTensor(node_arg) ? sizeof(std::string) : GetElementSize(node_arg.Type());
+    for (const auto& dim : p_shape->dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() > 0) num_bytes *= static_cast<size_t>(dim.dim_value());
+    }
+    return num_bytes;
+  }
+
+  // Tracks the estimated bytes of the live values produced by the nodes while the nodes are executed in some order.
+  // A value is live from the execution of its producer to the execution of its last consumer. Graph outputs are
+  // never freed, and the graph inputs and initializers are not counted as they're live for the whole run.
+  class LiveBytesTracker {
+   public:
+    LiveBytesTracker(PlannerImpl& planner, const std::vector<NodeIndex>& nodes) : graph_viewer_(planner.graph_viewer_) {
+      for (const auto* graph_output : graph_viewer_.GetOutputs()) {
+        ++remaining_uses_[graph_output];
+      }
+      for (auto node_index : nodes) {
+        const auto* node = graph_viewer_.GetNode(node_index);
+        if (node == nullptr) continue;
+        for (const auto* output : node->OutputDefs()) {
+          bytes_[output] = planner.EstimateBytes(*output);
+        }
+        for (const auto* input : UniqueInputs(*node)) {
+          ++remaining_uses_[input];
+        }
+      }
+    }
+
+    // Bytes freed after executing the node, which are the inputs it's the last consumer of.
+    size_t FreedBytes(const Node& node) const {
+      size_t freed = 0;
+      for (const auto* input : UniqueInputs(node)) {
+        auto bytes = bytes_.find(input);
+        if (bytes != bytes_.end() && remaining_uses_.at(input) == 1) freed += bytes->second;
+      }
+      return freed;
+    }
+
+    // Bytes allocated by the node.
+    size_t AllocatedBytes(const Node& node) const {
+      size_t allocated = 0;
+      for (const auto* output : node.OutputDefs()) {
+        allocated += bytes_.at(output);
+      }
+      return allocated;
+    }
+
+    // Execute the node and return the live bytes while it runs.
+    size_t Execute(const Node& node) {
+      const size_t peak = live_bytes_ + AllocatedBytes(node);
+      live_bytes_ = peak - FreedBytes(node);
+      for (const auto* input : UniqueInputs(node)) {
+        --remaining_uses_[input];
+      }
+      // free the outputs that are not used at all
+      for (const auto* output : node.OutputDefs()) {
+        if (remaining_uses_[output] == 0) live_bytes_ -= bytes_[output];
+      }
+      return peak;
+    }
+
+   private:
+    static std::unordered_set<const onnxruntime::NodeArg*> UniqueInputs(const Node& node) {
+      std::unordered_set<const onnxruntime::NodeArg*> inputs;
+      for (const auto* input : node.InputDefs()) {
+        if (input->Exists()) inputs.insert(input);
+      }
+      for (const auto* input : node.ImplicitInputDefs()) {
+        inputs.insert(input);
+      }
+      return inputs;
+    }
+
+    const onnxruntime::GraphViewer& graph_viewer_;
+    std::unordered_map<const onnxruntime::NodeArg*, size_t> bytes_;
+    std::unordered_map<const onnxruntime::NodeArg*, size_t> remaining_uses_;
+    size_t live_bytes_ = 0;
+  };
+
+  size_t PeakLiveBytes(const std::vector<NodeIndex>& order) {
+    LiveBytesTracker tracker(*this, order);
+    size_t peak = 0;
+    for (auto node_index : order) {
+      const auto* node = graph_viewer_.GetNode(node_index);
+      if (node != nullptr) peak = std::max(peak, tracker.Execute(*node));
+    }
+    return peak;
+  }
+
+  // Greedily build a topological order that executes the ready node with the smallest growth of the live bytes
+  // first. Ties are broken by the position in the default order, so the default order is kept when the sizes are
+  // unknown. Returns the default order if the greedy order doesn't have a lower peak.
+  std::vector<NodeIndex> ComputeMemoryEfficientOrder(const std::vector<NodeIndex>& default_order) {
+    std::unordered_map<NodeIndex, size_t> position;
+    for (size_t i = 0; i < default_order.size(); ++i) {
+      position[default_order[i]] = i;
+    }
+
+    // number of distinct producer nodes that have not been executed yet
+    std::vector<size_t> pending_producers(default_order.size(), 0);
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < default_order.size(); ++i) {
+      const auto* node = graph_viewer_.GetNode(default_order[i]);
+      std::unordered_set<NodeIndex> producers;
+      for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+        if (position.count(it->Index()) != 0) producers.insert(it->Index());
+      }
+      pending_producers[i] = producers.size();
+      if (producers.empty()) ready.push_back(i);
+    }
+
+    LiveBytesTracker tracker(*this, default_order);
+    std::vector<NodeIndex> order;
+    order.reserve(default_order.size());
+    while (!ready.empty()) {
+      // pick the node with the smallest net allocation, i.e. the one freeing the most bytes relative to what it
+      // allocates
+      size_t best = 0;
+      int64_t best_growth = 0;
+      for (size_t r = 0; r < ready.size(); ++r) {
+        const auto& node = *graph_viewer_.GetNode(default_order[ready[r]]);
+        int64_t growth = static_cast<int64_t>(tracker.AllocatedBytes(node)) -
+                         static_cast<int64_t>(tracker.FreedBytes(node));
+        if (r == 0 || growth < best_growth || (growth == best_growth && ready[r] < ready[best])) {
+          best = r;
+          best_growth = growth;
+        }
+      }
+
+      const size_t current = ready[best];
+      ready.erase(ready.begin() + best);
+      const auto& node = *graph_viewer_.GetNode(default_order[current]);
+      tracker.Execute(node);
+      order.push_back(default_order[current]);
+
+      std::unordered_set<NodeIndex> consumers;
+      for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
+        consumers.insert(it->Index());
+      }
+      for (auto consumer : consumers) {
+        auto consumer_position = position.find(consumer);
+        if (consumer_position != position.end() && --pending_producers[consumer_position->second] == 0) {
+          ready.push_back(consumer_position->second);
+        }
+      }
+    }
+
+    if (order.size() != default_order.size() || PeakLiveBytes(order) >= PeakLiveBytes(default_order)) {
+      return default_order;
+    }
+    return order;
+  }
+
+  // Plan the inputs of CPU Concat nodes to be allocated directly in the Concat output, so the producers write
+  // them in place and Concat doesn't need to copy them. This requires static shapes, and each input has to be a
+  // contiguous range of the output, which is the case if all the dims before the concat axis are 1.
+  // The output is allocated when the first of them is, so it's never a reused buffer.
+  // This isn't done for parallel execution, where the inputs may be allocated concurrently.
+  void PlanConcatInputs() {
+    if (context_.IsParallelExecutionEnabled()) return;
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    auto is_graph_output = [&graph_outputs](const onnxruntime::NodeArg* node_arg) {
+      return std::find(graph_outputs.begin(), graph_outputs.end(), node_arg) != graph_outputs.end();
+    };
+
+    // the nodes producing the values seen so far, and whether the kernel requires the output to alias an input
+    std::unordered_map<const onnxruntime::NodeArg*, bool> produced_values;
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      if (pnode == nullptr) continue;
+
+      if (pnode->OpType() == "Concat" && pnode->Domain() == kOnnxDomain &&
+          pnode->GetExecutionProviderType() == kCpuExecutionProvider) {
+        PlanConcatInputs(*pnode, produced_values, is_graph_output);
+      }
+
+      const KernelCreateInfo* ci = nullptr;
+      Status st = kernel_registry_.SearchKernelRegistry(*pnode, &ci);
+      int output_arg_num = 0;
+      for (auto node_output : pnode->OutputDefs()) {
+        bool is_alias = !st.IsOK() || ci == nullptr || ci->kernel_def == nullptr;
+        if (!is_alias) {
+          for (auto pair : ci->kernel_def->Alias()) {
+            is_alias = is_alias || pair.second == output_arg_num;
+          }
+        }
+        produced_values[node_output] = is_alias;
+        ++output_arg_num;
+      }
+    }
+  }
+
+  template <typename IsGraphOutput>
+  void PlanConcatInputs(const onnxruntime::Node& node,
+                        const std::unordered_map<const onnxruntime::NodeArg*, bool>& produced_values,
+                        const IsGraphOutput& is_graph_output) {
+    const auto* output_arg = node.OutputDefs()[0];
+    size_t output_bytes = 0;
+    const auto* output_shape = GetStaticShape(*output_arg, output_bytes);
+    if (output_shape == nullptr || is_graph_output(output_arg) || HasFence(output_arg)) return;
+
+    const auto& attributes = node.GetAttributes();
+    auto axis_attr = attributes.find("axis");
+    if (axis_attr == attributes.end()) return;
+    const int64_t rank = output_shape->dim_size();
+    int64_t axis = axis_attr->second.i();
+    if (axis < 0) axis += rank;
+    if (axis < 0 || axis >= rank) return;
+    for (int64_t i = 0; i < axis; ++i) {
+      if (output_shape->dim(static_cast<int>(i)).dim_value() != 1) return;
+    }
+
+    const OrtValueIndex output_index = Index(output_arg->Name());
+    const auto& output_location = AllocPlan(output_index).location;
+    auto input_args = node.InputDefs();
+
+    // check all the inputs first, as they are either all in the output or none of them are
+    std::unordered_set<const onnxruntime::NodeArg*> seen_inputs;
+    std::vector<size_t> input_bytes(input_args.size());
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < input_args.size(); ++i) {
+      const auto* input_arg = input_args[i];
+      auto producer = produced_values.find(input_arg);
+      if (producer == produced_values.end() || producer->second ||
+          !seen_inputs.insert(input_arg).second || is_graph_output(input_arg) || HasFence(input_arg) ||
+          GetStaticShape(*input_arg, input_bytes[i]) == nullptr) {
+        return;
+      }
+
+      const OrtValueIndex input_index = Index(input_arg->Name());
+      if (AllocPlan(input_index).container >= 0 || ort_value_info_[input_index].is_container ||
+          !(AllocPlan(input_index).location == output_location)) {
+        return;
+      }
+      total_bytes += input_bytes[i];
+    }
+    if (total_bytes != output_bytes) return;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < input_args.size(); ++i) {
+      auto& input_plan = AllocPlan(input_args[i]->Name());
+      input_plan.container = output_index;
+      input_plan.container_offset = offset;
+      input_plan.container_bytes = input_bytes[i];
+      offset += input_bytes[i];
+    }
+
+    auto& output_plan = AllocPlan(output_index);
+    output_plan.container_shape.clear();
+    for (const auto& dim : output_shape->dim()) {
+      output_plan.container_shape.push_back(dim.dim_value());
+    }
+    ort_value_info_[output_index].is_container = true;
+  }
+
+  // Record that current may be created as a view into the buffer of viewed. The viewed buffer is kept
+  // alive until current is freed by holding a use of it.
+  void View(OrtValueIndex viewed, OrtValueIndex current) {
+    OrtValueIndex original = Buffer(viewed);
+    ++UseCount(original);
+    ort_value_info_[current].viewed_buffers.push_back(original);
+
+    auto& symplan = AllocPlan(current);
+    symplan.alloc_kind = AllocKind::kAllocate;
+    symplan.viewed_value = viewed;
+  }
+
   // Reuse/Alias/Share between two OrtValue indexes
   void Reuse(OrtValueIndex reused, OrtValueIndex reused_for, AllocKind alloc_kind) {
     ORT_ENFORCE(reused != reused_for);
@@ -235,7 +550,7 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            if (1 == UseCount(original) && !MayBeView(original)) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -249,6 +564,39 @@ class PlannerImpl {
     return false;
   }
 
+  // Find if the kernel may create output_arg as a view into one of its inputs
+  bool FindViewableInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* viewable_input) {
+    auto p_output_arg = node.OutputDefs()[output_arg_num];
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
+      return false;
+    }
+
+    // string tensors need to be placement new'ed, and a fence would be shared with the viewed buffer
+    if (IsStringTensor(*p_output_arg) || HasFence(p_output_arg)) {
+      return false;
+    }
+
+    const std::vector<std::pair<int, int>>& view_map = ci->kernel_def->MayView();
+    auto input_args = node.InputDefs();
+    for (auto pair : view_map) {
+      if (pair.second == output_arg_num || pair.second == -1) {
+        if ((0 <= pair.first) && (static_cast<size_t>(pair.first) < input_args.size())) {
+          auto p_input_arg = input_args[pair.first];
+          if (p_input_arg->Exists() && !HasFence(p_input_arg)) {
+            auto input_arg_index = Index(p_input_arg->Name());
+            if (AllocPlan(input_arg_index).location == AllocPlan(p_output_arg->Name()).location) {
+              *viewable_input = input_arg_index;
+              return true;
+            }
+          }
+        }
+      }
+    }
+    return false;
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -328,6 +676,7 @@ class PlannerImpl {
     if (HasFence(&output_arg)) return false;
 
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
+      if (MayBeView(it->ml_value)) continue;
       size_t reusable = static_cast<size_t>(it->ml_value);
       const onnxruntime::NodeArg* p_node_arg = ort_value_info_.at(reusable).p_def_site;
       auto& available_memory_info = AllocPlan(p_node_arg->Name()).location;
@@ -579,9 +928,21 @@ class PlannerImpl {
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (ort_value_info_[current].is_container) {
+          // tensors were allocated in this buffer before it is produced, so it can't reuse another one
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (AllocPlan(current).container >= 0) {
+          // the tensor is allocated in the buffer of its container, which has to stay alive as long as it's used
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+          OrtValueIndex container = AllocPlan(current).container;
+          ++UseCount(container);
+          ort_value_info_[current].viewed_buffers.push_back(container);
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
+        } else if (FindViewableInput(*pnode, output_arg_num, &reused)) {
+          // The kernel may create this output as a view into the input buffer (e.g. Slice), so keep it alive
+          View(reused, current);
         } else if (!context_.IsParallelExecutionEnabled() && FindReusableTensor(*node_output, &reused)) {
           // Reuse an available (dead) buffer for this output, this is only for sequential execution.
           Reuse(reused, current, AllocKind::kReuse);
@@ -595,18 +956,14 @@ class PlannerImpl {
       for (auto node_input : pnode->InputDefs()) {
         if (node_input->Exists()) {
           auto& sym = node_input->Name();
-          auto original = Buffer(Index(sym));
-          if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+          ReleaseUse(Buffer(Index(sym)), program_counter);
         }
       }
 
       for (auto node_input : pnode->ImplicitInputDefs()) {
         if (node_input->Exists()) {
           auto& sym = node_input->Name();
-          auto original = Buffer(Index(sym));
-          if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+          ReleaseUse(Buffer(Index(sym)), program_counter);
         }
       }
 
@@ -614,9 +971,7 @@ class PlannerImpl {
       for (auto node_output : pnode->OutputDefs()) {
         if (node_output->Exists()) {
           auto& sym = node_output->Name();
-          auto original = Buffer(Index(sym));
-          if (0 == --UseCount(original))
-            freelist_.push_front(FreeBufferInfo(original, program_counter));
+          ReleaseUse(Buffer(Index(sym)), program_counter);
         }
       }
     }
@@ -666,6 +1021,80 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // A string tensor may be created in the packed layout if all the kernels reading it accept that layout. Graph
+  // outputs and the implicit inputs of subgraphs keep std::string elements.
+  Status ComputePackedStrings() {
+    std::vector<bool> packed(plan_.allocation_plan.size(), true);
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      const KernelCreateInfo* kernel_create_info = nullptr;
+      ORT_RETURN_IF_ERROR(kernel_registry_.SearchKernelRegistry(*pnode, &kernel_create_info));
+      if (!kernel_create_info->kernel_def->AllowsPackedStringInputs()) {
+        for (const auto* node_input : pnode->InputDefs()) {
+          if (node_input->Exists()) packed[Index(node_input->Name())] = false;
+        }
+      }
+
+      for (const auto* node_input : pnode->ImplicitInputDefs()) {
+        packed[Index(node_input->Name())] = false;
+      }
+    }
+
+    for (const auto* graph_output : graph_viewer_.GetOutputs()) {
+      packed[Index(graph_output->Name())] = false;
+    }
+
+    // the values reusing or sharing a string buffer, e.g. the output of Reshape, are views of the same strings, which
+    // are packed only if all of them may be
+    auto shares_buffer = [this](size_t i) {
+      const auto alloc_kind = plan_.allocation_plan[i].alloc_kind;
+      return alloc_kind == AllocKind::kReuse || alloc_kind == AllocKind::kShare;
+    };
+    for (size_t i = 0; i < packed.size(); ++i) {
+      if (shares_buffer(i) && !packed[i]) {
+        packed[Buffer(static_cast<OrtValueIndex>(i))] = false;
+      }
+    }
+    for (size_t i = 0; i < packed.size(); ++i) {
+      if (shares_buffer(i)) {
+        packed[i] = packed[Buffer(static_cast<OrtValueIndex>(i))];
+      }
+    }
+
+    for (size_t i = 0; i < packed.size(); ++i) {
+      auto& alloc_plan = plan_.allocation_plan[i];
+      alloc_plan.packed_strings = packed[i] && alloc_plan.value_type != nullptr &&
+                                  alloc_plan.value_type->IsTensorType() &&
+                                  utils::IsDataTypeString(
+                                      static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType());
+    }
+
+    return Status::OK();
+  }
+
+  // Assign the nodes to branches for parallel execution. A node continues the branch of its first producer that no
+  // other node continued yet, and starts a new branch otherwise, e.g. as a root or the second consumer of an output.
+  void ComputeBranches() {
+    if (!context_.IsParallelExecutionEnabled()) return;
+
+    plan_.node_branches.assign(graph_viewer_.MaxNodeIndex(), -1);
+    std::vector<bool> continued(graph_viewer_.MaxNodeIndex(), false);
+    int num_branches = 0;
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      int branch = -1;
+      for (auto it = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); it != end; ++it) {
+        const NodeIndex producer = it->GetNode().Index();
+        if (!continued[producer]) {
+          continued[producer] = true;
+          branch = plan_.node_branches[producer];
+          break;
+        }
+      }
+      plan_.node_branches[step.node_index] = branch >= 0 ? branch : num_branches++;
+    }
+  }
+
   // Convert information in a freelist (about which ml-value becomes free when) into
   // a deallocation plan in the format required in an ExecutionPlan
   void GenerateDeallocationPlan() {
@@ -696,6 +1125,10 @@ class PlannerImpl {
       plan_.execution_plan[prev_dealloc_point].free_to_index = current - 1;
   }
 
+  static bool IsStringTensor(const onnxruntime::NodeArg& nodearg) {
+    return nodearg.TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING;
+  }
+
   static bool IsNonTensor(const onnxruntime::NodeArg& nodearg) {
     // TODO: unclear why we should go through a string-representation of type
     auto ptype = nodearg.Type();
@@ -711,21 +1144,36 @@ Status PlannerImpl::CreatePlan() {
 
   Initialize(p_graph_nodes.size(), static_cast<size_t>(num_ml_values));
 
-  // Determine execution order: we use the default topological sort order for now. We can later
-  // explore more efficient orderings (from a memory usage perspective).
-  for (auto n : p_graph_nodes) {
-    plan_.execution_plan.emplace_back(n);
+  // Determine execution order: we use the default topological sort order unless the memory efficient order is
+  // enabled. The order doesn't matter for the parallel executor.
+  if (context_.IsMemoryEfficientOrderEnabled() && !context_.IsParallelExecutionEnabled()) {
+    for (auto n : ComputeMemoryEfficientOrder(p_graph_nodes)) {
+      plan_.execution_plan.emplace_back(n);
+    }
+  } else {
+    for (auto n : p_graph_nodes) {
+      plan_.execution_plan.emplace_back(n);
+    }
   }
 
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
 
+  // find the tensors that can be allocated directly in a Concat output
+  PlanConcatInputs();
+
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
   // Determine nodes that need fence check. This needs to be done after ComputeUseCounts and ComputeReusePlan.
   ORT_RETURN_IF_ERROR(ComputeFenceCheck());
 
+  // find the string tensors that may be created in the packed layout
+  ORT_RETURN_IF_ERROR(ComputePackedStrings());
+
+  // assign the nodes to branches for the parallel executor
+  ComputeBranches();
+
   // convert information in the freelist_ into a deallocation plan in required format
   GenerateDeallocationPlan();
 
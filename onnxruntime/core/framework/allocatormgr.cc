@@ -11,19 +11,24 @@
 
 namespace onnxruntime {
 
-#ifdef USE_MIMALLOC
-  using TArenaAllocator = MiMallocArena;
-#else
-  using TArenaAllocator = BFCArena;
-#endif
-
 using namespace ::onnxruntime::common;
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
   if (device_allocator->AllowsArena()) {
+#ifdef USE_MIMALLOC
+    if (info.arena_backend != ArenaBackend::kBFC) {
+      return std::shared_ptr<IArenaAllocator>(
+          onnxruntime::make_unique<MiMallocArena>(std::move(device_allocator), info.max_mem));
+    }
+#else
+    ORT_ENFORCE(info.arena_backend != ArenaBackend::kMiMalloc,
+                "The mimalloc arena requires a build with mimalloc enabled");
+#endif
     return std::shared_ptr<IArenaAllocator>(
-          onnxruntime::make_unique<TArenaAllocator>(std::move(device_allocator), info.max_mem));
+        onnxruntime::make_unique<BFCArena>(std::move(device_allocator), info.max_mem,
+                                           info.arena_extend_strategy, info.initial_chunk_size_bytes,
+                                           info.arena_thread_cache));
   }
 
   return AllocatorPtr(std::move(device_allocator));
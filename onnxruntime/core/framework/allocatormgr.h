@@ -14,6 +14,14 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  // growth policy of the arena created for the device allocator
+  ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  // size of the first region of the arena
+  size_t initial_chunk_size_bytes = 1 << 20;
+  // serve the small allocations from per-thread caches in front of the arena
+  bool arena_thread_cache = false;
+  // the arena created for the device allocator
+  ArenaBackend arena_backend = ArenaBackend::kDefault;
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
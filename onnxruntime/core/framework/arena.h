@@ -9,6 +9,22 @@
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+// How an arena picks the size of a new region when it has to grow.
+enum class ArenaExtendStrategy {
+  kNextPowerOfTwo = 0,  // double the region size until the request fits. fewer regions, more unused memory.
+  kSameAsRequested,     // allocate exactly the rounded request. memory use follows the peak closely.
+};
+
+// Which arena manages the memory of a device allocator that allows one.
+enum class ArenaBackend {
+  kDefault = 0,  // mimalloc in a build with USE_MIMALLOC, BFC otherwise.
+  kBFC,          // BFCArena, the only arena that supports the extend strategy and the thread caches.
+  kMiMalloc,     // MiMallocArena. only in a build with USE_MIMALLOC.
+};
+static_assert(static_cast<int>(ArenaBackend::kBFC) == ORT_ARENA_BACKEND_BFC &&
+                  static_cast<int>(ArenaBackend::kMiMalloc) == ORT_ARENA_BACKEND_MIMALLOC,
+              "ArenaBackend must match OrtArenaBackend");
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -26,6 +42,9 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return the memory that is not in use to the device, if the arena supports it.
+  // Shrink call need to be thread safe.
+  virtual Status Shrink() { return Status::OK(); }
   const OrtMemoryInfo& Info() const override = 0;
   // allocate host pinned memory?
 };
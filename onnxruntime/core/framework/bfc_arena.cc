@@ -2,15 +2,88 @@
 // Licensed under the MIT License.
 
 #include "core/framework/bfc_arena.h"
+#include "core/platform/probes.h"
 
 namespace onnxruntime {
+
+namespace {
+
+// the arenas with thread caches that are not destroyed yet, keyed by id. a thread that exits releases its caches
+// of these arenas only. both are leaked so the threads that exit after the static destructors ran can use them.
+OrtMutex& LiveArenasLock() {
+  static auto* lock = new OrtMutex();
+  return *lock;
+}
+
+std::unordered_map<uint64_t, BFCArena*>& LiveArenas() {
+  static auto* arenas = new std::unordered_map<uint64_t, BFCArena*>();
+  return *arenas;
+}
+
+}  // namespace
+
+struct BFCArena::ThreadLocalCaches {
+  std::unordered_map<uint64_t, ThreadCache*> caches;
+
+  // the cache GetThreadCache returned last, by arena id. trivially destructible, so they stay usable by the
+  // thread_local destructors that run after ~ThreadLocalCaches, which clears them.
+  static thread_local uint64_t last_arena_id;
+  static thread_local ThreadCache* last_cache;
+  // set by ~ThreadLocalCaches. the allocations and frees of the thread go to the arena lock from then on.
+  static thread_local bool released;
+
+  // drops the caches of the destroyed arenas. the arenas owned and freed them.
+  void EraseDestroyedArenas() {
+    std::lock_guard<OrtMutex> lock(LiveArenasLock());
+    const auto& live_arenas = LiveArenas();
+    for (auto it = caches.begin(); it != caches.end();) {
+      if (live_arenas.find(it->first) == live_arenas.end()) {
+        it = caches.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  ~ThreadLocalCaches() {
+    last_arena_id = 0;
+    last_cache = nullptr;
+    released = true;
+
+    // holding the lock keeps an arena from being destroyed while its cache is released
+    std::lock_guard<OrtMutex> lock(LiveArenasLock());
+    const auto& live_arenas = LiveArenas();
+    for (const auto& entry : caches) {
+      auto arena = live_arenas.find(entry.first);
+      if (arena != live_arenas.end()) {
+        arena->second->ReleaseThreadCache(entry.second);
+      }
+    }
+  }
+};
+
+thread_local uint64_t BFCArena::ThreadLocalCaches::last_arena_id = 0;
+thread_local BFCArena::ThreadCache* BFCArena::ThreadLocalCaches::last_cache = nullptr;
+thread_local bool BFCArena::ThreadLocalCaches::released = false;
+
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   ArenaExtendStrategy arena_extend_strategy,
+                   size_t initial_chunk_size_bytes,
+                   bool enable_thread_cache)
+    : arena_extend_strategy_(arena_extend_strategy),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      enable_thread_cache_(enable_thread_cache),
+      id_([]() {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id++;
+      }()) {
+  ORT_ENFORCE(initial_chunk_size_bytes > 0, "Initial chunk size of the arena must be positive");
+  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, initial_chunk_size_bytes));
+  initial_chunk_size_bytes_ = curr_region_allocation_bytes_;
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -32,9 +105,20 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (enable_thread_cache_) {
+    std::lock_guard<OrtMutex> lock(LiveArenasLock());
+    LiveArenas()[id_] = this;
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (enable_thread_cache_) {
+    // after this the exiting threads leave the caches of this arena alone, they are freed with thread_caches_
+    std::lock_guard<OrtMutex> lock(LiveArenasLock());
+    LiveArenas().erase(id_);
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -68,13 +152,19 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   // allocation, keep multiplying by a power of two until that is
   // sufficient.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo) {
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= 2;
+      increased_allocation = true;
+    }
   }
 
-  // Try allocating.
+  // Try allocating. with kSameAsRequested only the first region uses curr_region_allocation_bytes_.
   size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kSameAsRequested &&
+      (!region_manager_.regions().empty() || rounded_bytes > bytes)) {
+    bytes = rounded_bytes;
+  }
   auto safe_alloc = [this](size_t alloc_bytes) {
     void* new_mem = nullptr;
     try {
@@ -107,7 +197,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   }
 
   // if we didn't update already, default to growing by 2x next time
-  if (!increased_allocation) {
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo && !increased_allocation) {
     curr_region_allocation_bytes_ *= 2;
   }
 
@@ -172,6 +262,9 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (enable_thread_cache_) {
+    return ThreadCacheAlloc(size);
+  }
   return AllocateRawInternal(size, false);
 }
 
@@ -179,6 +272,11 @@ void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
 
+  // with the thread caches, Free tells a reserved buffer from its header
+  if (enable_thread_cache_) {
+    size += kThreadCacheHeaderSize;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = device_allocator_->Alloc(size);
   ORT_ENFORCE(reserved_chunks_.find(ptr) == reserved_chunks_.end());
@@ -188,23 +286,220 @@ void* BFCArena::Reserve(size_t size) {
   stats_.max_alloc_size = std::max<size_t>(stats_.max_alloc_size, size);
   stats_.max_bytes_in_use = std::max<size_t>(stats_.max_bytes_in_use, stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
+  ORT_PROBE4(arena_alloc, this, ptr, size, size);
+  if (enable_thread_cache_) {
+    return TagBlock(ptr, kThreadCacheReserved);
+  }
   return ptr;
 }
 
+Status BFCArena::Shrink() {
+  if (enable_thread_cache_) {
+    FlushThreadCaches();
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // a region with no chunk in use has been coalesced back into a single free chunk
+  std::vector<void*> free_regions;
+  for (const auto& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    const Chunk* c = ChunkFromHandle(h);
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      free_regions.push_back(region.ptr());
+    }
+  }
+
+  for (void* ptr : free_regions) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    size_t bytes = ChunkFromHandle(h)->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+    stats_.total_allocated_bytes -= bytes;
+
+    LOGS_DEFAULT(INFO) << "Freed region of " << bytes << " bytes at " << ptr;
+  }
+
+  if (region_manager_.regions().empty()) {
+    // start over from the configured size instead of the doubled size of the freed regions
+    curr_region_allocation_bytes_ = initial_chunk_size_bytes_;
+  }
+
+  return Status::OK();
+}
+
 size_t BFCArena::RequestedSize(const void* ptr) {
+  const size_t header_size = enable_thread_cache_ ? kThreadCacheHeaderSize : 0;
   std::lock_guard<OrtMutex> lock(lock_);
-  BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+  BFCArena::ChunkHandle h = region_manager_.get_handle(static_cast<const char*>(ptr) - header_size);
   ORT_ENFORCE(h != kInvalidChunkHandle);
   BFCArena::Chunk* c = ChunkFromHandle(h);
-  return c->requested_size;
+  return c->requested_size - header_size;
 }
 
 size_t BFCArena::AllocatedSize(const void* ptr) {
+  const size_t header_size = enable_thread_cache_ ? kThreadCacheHeaderSize : 0;
   std::lock_guard<OrtMutex> lock(lock_);
-  BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+  BFCArena::ChunkHandle h = region_manager_.get_handle(static_cast<const char*>(ptr) - header_size);
   ORT_ENFORCE(h != kInvalidChunkHandle);
   BFCArena::Chunk* c = ChunkFromHandle(h);
-  return c->size;
+  return c->size - header_size;
+}
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache() {
+  // keyed by arena id as a new arena can get the address of a destroyed one. the caches are owned by the arenas.
+  if (ThreadLocalCaches::last_arena_id == id_) {
+    return ThreadLocalCaches::last_cache;
+  }
+  if (ThreadLocalCaches::released) {
+    // a thread_local destructor that runs after the caches of the thread were released
+    return nullptr;
+  }
+
+  thread_local ThreadLocalCaches thread_caches;
+  auto& caches = thread_caches.caches;
+  auto it = caches.find(id_);
+  if (it == caches.end()) {
+    // a thread that uses many arenas in turn, e.g. of sessions that are created and destroyed, would otherwise
+    // keep an entry per arena it ever used
+    thread_caches.EraseDestroyedArenas();
+
+    std::lock_guard<OrtMutex> lock(thread_caches_lock_);
+    thread_caches_.push_back(onnxruntime::make_unique<ThreadCache>());
+    it = caches.emplace(id_, thread_caches_.back().get()).first;
+  }
+  ThreadLocalCaches::last_arena_id = id_;
+  ThreadLocalCaches::last_cache = it->second;
+  return it->second;
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache* cache) {
+  std::unique_ptr<ThreadCache> released;
+  {
+    std::lock_guard<OrtMutex> lock(thread_caches_lock_);
+    auto it = std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                           [cache](const std::unique_ptr<ThreadCache>& c) { return c.get() == cache; });
+    if (it == thread_caches_.end()) {
+      return;
+    }
+    // FlushThreadCaches only sets busy while it holds thread_caches_lock_, and the owning thread is exiting
+    released = std::move(*it);
+    thread_caches_.erase(it);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& free_blocks : released->free_blocks) {
+    for (void* block : free_blocks) {
+      DeallocateRawInternal(block);
+    }
+  }
+}
+
+void* BFCArena::ThreadCacheAlloc(size_t size) {
+  if (size == 0) {
+    return AllocateRawInternal(size, false);
+  }
+
+  const int size_class = ThreadCacheClassForSize(size);
+  if (size_class < 0) {
+    return TagBlock(AllocateRawInternal(size + kThreadCacheHeaderSize, false), kThreadCacheNotCached);
+  }
+
+  ThreadCache* cache = GetThreadCache();
+  if (cache == nullptr || cache->busy.exchange(true, std::memory_order_acquire)) {
+    // the thread is exiting, or Shrink is emptying the cache
+    return TagBlock(AllocateRawInternal(ThreadCacheBlockSize(size_class), false), size_class);
+  }
+
+  auto& free_blocks = cache->free_blocks[size_class];
+  if (free_blocks.empty()) {
+    RefillThreadCache(size_class, free_blocks);
+  }
+  void* block = nullptr;
+  if (!free_blocks.empty()) {
+    block = free_blocks.back();
+    free_blocks.pop_back();
+  }
+  cache->busy.store(false, std::memory_order_release);
+  return TagBlock(block, size_class);
+}
+
+void BFCArena::RefillThreadCache(int size_class, std::vector<void*>& free_blocks) {
+  const size_t block_size = ThreadCacheBlockSize(size_class);
+  const size_t count = std::min(std::max(kThreadCacheRefillBytes / block_size, size_t{1}),
+                                size_t{kThreadCacheMaxRefillBlocks});
+  const BinNum bin_num = BinNumForSize(block_size);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (size_t i = 0; i < count; ++i) {
+    void* ptr = FindChunkPtr(bin_num, block_size, block_size);
+    if (ptr == nullptr) {
+      // only grow the arena for the block that was asked for
+      if (!free_blocks.empty() || !Extend(block_size)) {
+        break;
+      }
+      ptr = FindChunkPtr(bin_num, block_size, block_size);
+      if (ptr == nullptr) {
+        break;
+      }
+    }
+    free_blocks.push_back(ptr);
+  }
+}
+
+void BFCArena::ThreadCacheFree(void* p) {
+  void* block = static_cast<char*>(p) - kThreadCacheHeaderSize;
+  const size_t tag = *static_cast<const size_t*>(block);
+  if (tag < static_cast<size_t>(kThreadCacheNumClasses)) {
+    ThreadCache* cache = GetThreadCache();
+    if (cache != nullptr && !cache->busy.exchange(true, std::memory_order_acquire)) {
+      auto& free_blocks = cache->free_blocks[tag];
+      free_blocks.push_back(block);
+      const size_t max_blocks = std::max(kThreadCacheBytesPerClass / ThreadCacheBlockSize(static_cast<int>(tag)),
+                                         size_t{2});
+      if (free_blocks.size() > max_blocks) {
+        // return the least recently freed half in one go
+        const size_t count = free_blocks.size() / 2;
+        {
+          std::lock_guard<OrtMutex> lock(lock_);
+          for (size_t i = 0; i < count; ++i) {
+            DeallocateRawInternal(free_blocks[i]);
+          }
+        }
+        free_blocks.erase(free_blocks.begin(), free_blocks.begin() + count);
+      }
+      cache->busy.store(false, std::memory_order_release);
+      return;
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  FreeLocked(block);
+}
+
+void BFCArena::FlushThreadCaches() {
+  std::vector<void*> blocks;
+  {
+    std::lock_guard<OrtMutex> lock(thread_caches_lock_);
+    for (auto& cache : thread_caches_) {
+      // a cache its thread is using keeps its blocks until the next Shrink
+      if (cache->busy.exchange(true, std::memory_order_acquire)) {
+        continue;
+      }
+      for (auto& free_blocks : cache->free_blocks) {
+        blocks.insert(blocks.end(), free_blocks.begin(), free_blocks.end());
+        free_blocks.clear();
+      }
+      cache->busy.store(false, std::memory_order_release);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* block : blocks) {
+    DeallocateRawInternal(block);
+  }
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
@@ -247,7 +542,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   return nullptr;
 }
 
-void BFCArena::GetStats(AllocatorStats* stats) {
+void BFCArena::GetStats(AllocatorStats* stats) const {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
 }
@@ -294,6 +589,7 @@ void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         stats_.max_alloc_size =
             std::max<std::size_t>(stats_.max_alloc_size, chunk->size);
 
+        ORT_PROBE4(arena_alloc, this, chunk->ptr, num_bytes, chunk->size);
         return chunk->ptr;
       }
     }
@@ -340,9 +636,18 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (enable_thread_cache_) {
+    ThreadCacheFree(p);
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
+  FreeLocked(p);
+}
+
+void BFCArena::FreeLocked(void* p) {
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
+    ORT_PROBE3(arena_free, this, p, it->second);
     device_allocator_->Free(it->first);
     stats_.bytes_in_use -= it->second;
     stats_.total_allocated_bytes -= it->second;
@@ -431,6 +736,8 @@ void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
   Chunk* c = ChunkFromHandle(h);
   ORT_ENFORCE(c->in_use() && (c->bin_num == kInvalidBinNum));
 
+  ORT_PROBE3(arena_free, this, c->ptr, c->size);
+
   // Mark the chunk as no longer in use
   c->allocation_id = -1;
 
@@ -15,10 +15,14 @@ limitations under the License.
 // Portions Copyright (c) Microsoft Corporation
 
 #pragma once
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -46,9 +50,15 @@ namespace onnxruntime {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// With enable_thread_cache, the allocations of up to 64KB are served from per-thread free lists of a few size
+// classes, so the threads only take the arena lock to refill a list or to return the excess of a list in batches.
+// The blocks held by the lists count as in use in the stats until Shrink returns them to the arena.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+           size_t initial_chunk_size_bytes = 1 << 20, bool enable_thread_cache = false);
 
   ~BFCArena() override;
 
@@ -62,6 +72,9 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Free the regions that have no chunk in use and return their memory to the device allocator.
+  Status Shrink() override;
+
   size_t Used() const override {
     return stats_.bytes_in_use;
   }
@@ -79,7 +92,7 @@ class BFCArena : public IArenaAllocator {
     return device_allocator_->CreateFence(session_state);
   }
 
-  void GetStats(AllocatorStats* stats);
+  void GetStats(AllocatorStats* stats) const;
 
   size_t RequestedSize(const void* ptr);
 
@@ -88,6 +101,67 @@ class BFCArena : public IArenaAllocator {
  private:
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
+  // Frees a chunk or a reserved buffer. lock_ must be held.
+  void FreeLocked(void* p);
+
+  // A block of the thread caches starts with a header holding its size class, or one of the tags below for the
+  // allocations that bypass the caches. The caller gets the memory after the header, which keeps 64 byte alignment.
+  static const size_t kThreadCacheHeaderSize = 64;
+  static const size_t kThreadCacheNotCached = static_cast<size_t>(-1);
+  static const size_t kThreadCacheReserved = static_cast<size_t>(-2);
+  // blocks of 256 bytes to 64KB, header included
+  static const int kThreadCacheNumClasses = 9;
+  // bytes of blocks a free list holds before it returns half of them to the arena
+  static const size_t kThreadCacheBytesPerClass = 256 * 1024;
+  // bytes of blocks, up to kThreadCacheMaxRefillBlocks, a list takes from the arena when it's empty
+  static const size_t kThreadCacheRefillBytes = 32 * 1024;
+  static const size_t kThreadCacheMaxRefillBlocks = 32;
+
+  struct ThreadCache {
+    // set by the owning thread while it uses the lists and by Shrink while it empties them. neither waits for the
+    // other: the owning thread goes through the arena lock, and Shrink skips the cache.
+    std::atomic<bool> busy{false};
+    std::array<std::vector<void*>, kThreadCacheNumClasses> free_blocks;
+  };
+
+  void* ThreadCacheAlloc(size_t size);
+  void ThreadCacheFree(void* p);
+  // Fills the empty free list of a size class from the arena.
+  void RefillThreadCache(int size_class, std::vector<void*>& free_blocks);
+  // Returns the blocks of the free lists not in use to the arena.
+  void FlushThreadCaches();
+  // The cache of the calling thread for this arena, created on first use. nullptr once the caches of the thread
+  // were released at its exit.
+  ThreadCache* GetThreadCache();
+  // Returns the blocks of a cache to the arena and destroys it. Called when its thread exits.
+  void ReleaseThreadCache(ThreadCache* cache);
+
+  // The caches of a thread, keyed by arena id. Releases them when the thread exits.
+  struct ThreadLocalCaches;
+
+  static size_t ThreadCacheBlockSize(int size_class) {
+    return kMinAllocationSize << size_class;
+  }
+
+  // The smallest size class with room for size bytes after the header, or -1 if the allocation isn't cached.
+  int ThreadCacheClassForSize(size_t size) {
+    const size_t block_size = size + kThreadCacheHeaderSize;
+    if (block_size > ThreadCacheBlockSize(kThreadCacheNumClasses - 1)) {
+      return -1;
+    }
+    return block_size <= kMinAllocationSize
+               ? 0
+               : Log2FloorNonZero(block_size - 1) + 1 - static_cast<int>(kMinAllocationBits);
+  }
+
+  // Writes the header of a block and returns the memory after it.
+  static void* TagBlock(void* block, size_t tag) {
+    if (block == nullptr) {
+      return nullptr;
+    }
+    *static_cast<size_t*>(block) = tag;
+    return static_cast<char*>(block) + kThreadCacheHeaderSize;
+  }
 
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
@@ -271,6 +345,13 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -422,6 +503,11 @@ class BFCArena : public IArenaAllocator {
   // The size of the current region allocation.
   size_t curr_region_allocation_bytes_;
 
+  // The size of the first region allocation.
+  size_t initial_chunk_size_bytes_;
+
+  ArenaExtendStrategy arena_extend_strategy_;
+
   std::unique_ptr<IDeviceAllocator> device_allocator_;
 
   mutable OrtMutex lock_;
@@ -441,6 +527,12 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  const bool enable_thread_cache_;
+  // unique among the arenas of the process, the threads look up their cache with it
+  const uint64_t id_;
+  OrtMutex thread_caches_lock_;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
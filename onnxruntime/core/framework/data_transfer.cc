@@ -17,6 +17,15 @@ common::Status IDataTransfer::CopyTensors(const Tensor* src, Tensor* dst, int si
   return Status::OK();
 }
 
+common::Status IDataTransfer::CopyTensors(const std::vector<const Tensor*>& src,
+                                          const std::vector<Tensor*>& dst) const {
+  ORT_RETURN_IF_NOT(src.size() == dst.size(), "Number of source and destination tensors mismatch");
+  for (size_t i = 0; i < src.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyTensor(*src[i], *dst[i], 0));
+  }
+  return Status::OK();
+}
+
 bool CPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::CPU && dst_device.Type() == OrtDevice::CPU;
 }
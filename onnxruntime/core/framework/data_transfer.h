@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "core/common/status.h"
 #include "core/framework/tensor.h"
 
@@ -18,6 +20,10 @@ class IDataTransfer {
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const = 0;
   virtual common::Status CopyTensors(const Tensor* src, Tensor* dst, int size) const;
+
+  // Copy each src[i] to dst[i]. An implementation may coalesce the copies, e.g. pack small tensors into a single
+  // transfer between host and device. The default copies them one by one on exec queue 0.
+  virtual common::Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst) const;
 };
 
 class CPUDataTransfer : public IDataTransfer {
@@ -51,4 +51,48 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst, int exec_
                          dst.Location().device.ToString());
 }
 
+Status DataTransferManager::CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst) const {
+  if (src.size() != dst.size()) {
+    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Number of source and destination tensors mismatch");
+  }
+
+  // the copies of each data transfer, in the order of the data transfers
+  std::vector<std::vector<const Tensor*>> transfer_src(datatransfers_.size());
+  std::vector<std::vector<Tensor*>> transfer_dst(datatransfers_.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (src[i]->Shape().Size() != dst[i]->Shape().Size()) {
+      return Status(ONNXRUNTIME, FAIL, "Tensor size mismatch");
+    }
+
+    size_t transfer = 0;
+    while (transfer < datatransfers_.size() &&
+           !datatransfers_[transfer]->CanCopy(src[i]->Location().device, dst[i]->Location().device)) {
+      ++transfer;
+    }
+
+    if (transfer == datatransfers_.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME,
+                             FAIL,
+                             "There's no data transfer registered for copying tensors from ",
+                             src[i]->Location().device.ToString(),
+                             " to ",
+                             dst[i]->Location().device.ToString());
+    }
+
+    transfer_src[transfer].push_back(src[i]);
+    transfer_dst[transfer].push_back(dst[i]);
+  }
+
+  for (size_t transfer = 0; transfer < datatransfers_.size(); ++transfer) {
+    if (transfer_src[transfer].size() == 1) {
+      ORT_RETURN_IF_ERROR(datatransfers_[transfer]->CopyTensor(*transfer_src[transfer][0],
+                                                               *transfer_dst[transfer][0], 0));
+    } else if (!transfer_src[transfer].empty()) {
+      ORT_RETURN_IF_ERROR(datatransfers_[transfer]->CopyTensors(transfer_src[transfer], transfer_dst[transfer]));
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -23,6 +23,11 @@ class DataTransferManager {
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const;
 
+  // Copy each src[i] to dst[i]. The copies that go through the same data transfer are handed to it in a single
+  // IDataTransfer::CopyTensors call, which lets it coalesce them. e.g. the many small inputs of a model are copied
+  // to a CUDA device with one transfer and one synchronization.
+  common::Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DataTransferManager);
 
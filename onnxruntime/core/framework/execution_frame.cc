@@ -3,15 +3,18 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/framework/mem_pattern_planner.h"
 #include "core/framework/execution_plan_base.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/scratch_allocator.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/packed_strings.h"
 #include "core/framework/session_state.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/utils.h"
@@ -24,8 +27,18 @@ IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, cons
                                  const std::unordered_map<int, OrtValue>& initializers,
                                  const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
                                  const OrtValueNameIdxMap& ort_value_idx_map, const NodeIndexInfo& node_index_info)
-    : node_index_info_(node_index_info),
+    : IExecutionFrame(feed_mlvalue_idxs, feeds, initializers, fetch_mlvalue_idxs, fetches, ort_value_idx_map,
+                      node_index_info, {}) {
+}
+
+IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                                 const std::unordered_map<int, OrtValue>& initializers,
+                                 const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                                 const OrtValueNameIdxMap& ort_value_idx_map, const NodeIndexInfo& node_index_info,
+                                 std::vector<OrtValue>&& values)
+    : all_values_(std::move(values)),
       all_values_size_(static_cast<size_t>(ort_value_idx_map.MaxIdx()) + 1),
+      node_index_info_(node_index_info),
       fetch_mlvalue_idxs_(fetch_mlvalue_idxs) {
   ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
   ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs_.size());
@@ -78,10 +91,63 @@ Status IExecutionFrame::GetOrCreateNodeOutputMLValue(int index, const TensorShap
   return status;
 }
 
+Status IExecutionFrame::CreateNodeOutputMLValueAsView(int index, int input_index, const TensorShape& shape,
+                                                      size_t byte_offset, OrtValue*& p_ort_value) {
+  p_ort_value = nullptr;
+
+  int ort_value_idx = GetNodeIdxToMLValueIdx(index);
+  int viewed_ort_value_idx = GetNodeIdxToMLValueIdx(input_index);
+  if (ort_value_idx == NodeIndexInfo::kInvalidEntry || viewed_ort_value_idx == NodeIndexInfo::kInvalidEntry ||
+      all_values_[ort_value_idx].IsAllocated() || !CanBeViewImpl(ort_value_idx, viewed_ort_value_idx)) {
+    return Status::OK();
+  }
+
+  const OrtValue& viewed_value = all_values_[viewed_ort_value_idx];
+  if (!viewed_value.IsTensor()) {
+    return Status::OK();
+  }
+
+  const Tensor& viewed = viewed_value.Get<Tensor>();
+  const int64_t len = shape.Size();
+  if (len < 0) {
+    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Tensor shape cannot contain any negative value");
+  }
+  if (byte_offset + static_cast<size_t>(len) * viewed.DataType()->Size() > viewed.SizeInBytes()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "View of shape ", shape, " at byte offset ", byte_offset,
+                           " is outside of the viewed tensor of shape ", viewed.Shape());
+  }
+
+  OrtValue& ort_value = all_values_[ort_value_idx];
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  auto p_tensor = onnxruntime::make_unique<Tensor>(viewed.DataType(), shape, const_cast<void*>(viewed.DataRaw()),
+                                                   viewed.Location(), static_cast<int64_t>(byte_offset));
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  p_ort_value = &ort_value;
+
+  return Status::OK();
+}
+
+Status IExecutionFrame::GetOrCreateNodeOutputPackedStrings(int index, const TensorShape& shape, size_t num_chars,
+                                                           OrtValue*& p_ort_value) {
+  int ort_value_idx = GetNodeIdxToMLValueIdx(index);
+
+  // an unused optional output, or one that is already allocated, e.g. provided by the caller, keeps its layout
+  if (ort_value_idx == NodeIndexInfo::kInvalidEntry || all_values_[ort_value_idx].IsAllocated()) {
+    return GetOrCreateNodeOutputMLValue(index, &shape, p_ort_value);
+  }
+
+  p_ort_value = &all_values_[ort_value_idx];
+  return CreateNodeOutputPackedStringsImpl(*p_ort_value, ort_value_idx, shape, num_chars);
+}
+
 AllocatorPtr IExecutionFrame::GetAllocator(const OrtMemoryInfo& info) const {
   return GetAllocatorImpl(info);
 }
 
+AllocatorPtr IExecutionFrame::GetScratchAllocator(const OrtMemoryInfo& info) const {
+  return GetScratchAllocatorImpl(info);
+}
+
 Status IExecutionFrame::ReleaseMLValue(int ort_value_idx) { return ReleaseMLValueImpl(ort_value_idx); }
 
 Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
@@ -109,7 +175,7 @@ int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
 void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                            const std::unordered_map<int, OrtValue>& initializers,
                            const std::vector<OrtValue>& fetches) {
-  // 1. resize the all_value_ vector
+  // 1. resize the all_value_ vector. the storage of a previous frame already has the size.
   all_values_.resize(all_values_size_);
 
   // 2. Handle non-empty output vector
@@ -167,15 +233,96 @@ bool IExecutionFrame::IsOutput(int ort_value_idx) const {
   return std::find(fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end(), ort_value_idx) != fetch_mlvalue_idxs_.end();
 }
 
+namespace {
+
+bool AllTensors(const std::vector<OrtValue>& feeds) {
+  return std::all_of(feeds.cbegin(), feeds.cend(), [](const OrtValue& feed) { return feed.IsTensor(); });
+}
+
+// the memory patterns of a Run with these feeds, if the session has them
+std::shared_ptr<const MemoryPatternGroup> FindMemoryPatterns(const std::vector<int>& feed_mlvalue_idxs,
+                                                             const std::vector<OrtValue>& feeds,
+                                                             const SessionState& session_state) {
+  if (!session_state.GetEnableMemoryPattern() || !session_state.GetExecutionPlan()) {
+    return nullptr;
+  }
+
+  // a pattern generated at initialization for fixed input shapes needs neither the cache lookup nor tracing.
+  auto mem_patterns = session_state.GetStaticMemoryPatternGroup(feed_mlvalue_idxs, feeds);
+  if (mem_patterns) {
+    return mem_patterns;
+  }
+
+  //if there are some traditional ml value type in inputs disable the memory pattern optimization.
+  if (!AllTensors(feeds)) {
+    return nullptr;
+  }
+
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
+  // Reserve mem to avoid re-allocation.
+  input_shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    input_shapes.push_back(std::cref(feed.Get<Tensor>().Shape()));
+  }
+
+  return session_state.GetMemoryPatternGroup(input_shapes);
+}
+
+// a graph captured by a provider keeps using the addresses of the buffers of the frame that ran while it was
+// captured, so the frame neither takes pooled buffers nor returns its own
+bool IsCapturingGraph(const SessionState& session_state) {
+  for (const auto& xp : session_state.GetExecutionProviders()) {
+    if (xp->IsGraphCapturing()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ExecutionFrameResources AcquireResources(const std::vector<int>& feed_mlvalue_idxs,
+                                         const std::vector<OrtValue>& feeds, const SessionState& session_state,
+                                         bool pool_resources) {
+  auto mem_patterns = FindMemoryPatterns(feed_mlvalue_idxs, feeds, session_state);
+  ExecutionFrameResources resources;
+  if (pool_resources) {
+    resources = session_state.AcquireFrameResources(mem_patterns.get());
+  }
+  resources.mem_patterns = std::move(mem_patterns);
+  return resources;
+}
+
+}  // namespace
+
 ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                                const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                const SessionState& session_state)
+    : ExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state,
+                     !IsCapturingGraph(session_state)) {
+}
+
+ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                               const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               const SessionState& session_state, bool pool_resources)
+    : ExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state,
+                     pool_resources, AcquireResources(feed_mlvalue_idxs, feeds, session_state, pool_resources)) {
+}
+
+ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                               const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               const SessionState& session_state, bool pool_resources,
+                               ExecutionFrameResources&& resources)
     : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
-                      session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
+                      session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(),
+                      std::move(resources.values)),
       session_state_(session_state),
-      mem_patterns_(nullptr),
-      planner_(nullptr) {
+      pool_resources_(pool_resources),
+      mem_patterns_(std::move(resources.mem_patterns)),
+      planner_(nullptr),
+      buffers_(std::move(resources.buffers)),
+      value_allocated_bytes_(all_values_size_, 0) {
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
@@ -188,50 +335,80 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     }
   }
 
-  // If the session enable memory pattern optimization
-  // and we have execution plan generated, try to setup
-  // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan()) {
-    std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
-    bool all_tensors = true;
-    // Reserve mem to avoid re-allocation.
-    input_shapes.reserve(feeds.size());
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
+  if (mem_patterns_) {
+    // pre-allocate the big chunk requested in memory pattern, unless a previous frame with the same patterns left
+    // it. all the internal kernel's input/output tensors will be allocated on these buffer.
+    for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+      const OrtMemoryInfo& location = mem_patterns_->locations[i];
+      size_t peak_size = mem_patterns_->patterns[i].PeakSize();
+      if (peak_size > 0) {
+        AddAllocatedBytes(static_cast<int64_t>(peak_size));
+      }
+
+      if (buffers_.find(location) != buffers_.end()) {
+        continue;
       }
-      auto& tensor = feed.Get<Tensor>();
-      input_shapes.push_back(std::cref(tensor.Shape()));
+
+      AllocatorPtr alloc = GetAllocator(location);
+      void* buffer = nullptr;
+      if (peak_size > 0) {
+        buffer = utils::AllocateBlock(*alloc, peak_size);
+      }
+
+      buffers_[location] = BufferUniquePtr(buffer, alloc);
     }
 
-    //if there are some traditional ml value type in inputs disable the memory pattern optimization.
-    if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-
-          void* buffer = nullptr;
-          size_t peak_size = mem_patterns_->patterns[i].PeakSize();
-          if (peak_size > 0) {
-            buffer = utils::AllocateBlock(*alloc, peak_size);
-          }
+    // the pattern of a shape bucket was traced with the shapes of one Run in the bucket, which may be smaller than
+    // the ones of this Run. a pattern generated at initialization is for these exact shapes.
+    if (session_state.GetMemoryPatternShapeBucketing() &&
+        !session_state.GetStaticMemoryPatternGroup(feed_mlvalue_idxs, feeds)) {
+      planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
+    }
+  } else if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan() && AllTensors(feeds)) {
+    // if no existing patterns, generate one in this executionframe
+    planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
+  }
 
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
+  // the feeds in the packed string layout that are read by kernels which need std::string elements are unpacked
+  if (const SequentialExecutionPlan* p_seq_exec_plan = session_state.GetExecutionPlan()) {
+    for (int ort_value_idx : feed_mlvalue_idxs) {
+      OrtValue& feed = GetMutableMLValue(ort_value_idx);
+      const auto& per_alloc_plan = p_seq_exec_plan->allocation_plan[ort_value_idx];
+      if (feed.IsTensor() && feed.Get<Tensor>().IsPackedStrings() && !per_alloc_plan.packed_strings) {
+        OrtValue unpacked;
+        UnpackStrings(feed.Get<Tensor>(), GetAllocator(per_alloc_plan.location), unpacked);
+        feed = unpacked;
       }
     }
   }
+
+  if (session_state.GetEnableScratchAllocator()) {
+    const IExecutionProvider* cpu_provider =
+        session_state.GetExecutionProviders().Get(onnxruntime::kCpuExecutionProvider);
+    if (cpu_provider != nullptr) {
+      scratch_allocator_ = std::make_shared<ScratchAllocator>(cpu_provider->GetAllocator(0, OrtMemTypeDefault),
+                                                              session_state.GetScratchBytes());
+    }
+  }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  // size the scratch of the next runs
+  if (scratch_allocator_) {
+    session_state_.UpdateScratchBytes(scratch_allocator_->PeakBytes());
+  }
+
+  // release the values before the buffers of the memory patterns the tensors may point into, and keep both for the
+  // next run with the same inputs.
+  std::fill(all_values_.begin(), all_values_.end(), OrtValue());
+  if (pool_resources_) {
+    ExecutionFrameResources resources;
+    resources.values = std::move(all_values_);
+    resources.mem_patterns = std::move(mem_patterns_);
+    resources.buffers = std::move(buffers_);
+    session_state_.ReleaseFrameResources(std::move(resources));
+  }
+}
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
@@ -278,19 +455,20 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // a smaller tensor can use the block as the block is exclusively assigned to this ort_value for its
+        // lifetime. that happens when the pattern was recorded with different shapes in the same shape bucket.
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
+          TraceAllocate(ort_value_index, size);
           return status;
         }
-        if (block->size_ != size) {
+        if (size > block->size_) {
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
-          // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
           LOGS_DEFAULT(VERBOSE) << "For ort_value with index: " << ort_value_index
                                 << ", block in memory pattern size is: " << block->size_
                                 << " but the actually size is: " << size
@@ -310,6 +488,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
   }
 
+  value_allocated_bytes_[ort_value_index] = size;
+  AddAllocatedBytes(static_cast<int64_t>(size));
+
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
   // placement new, we don't support it in memory pattern optimization.
@@ -358,6 +539,16 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
 
   // reused OrtValue share the same fence
   ort_value.ShareFenceWith(ort_value_reuse);
+
+  // strings in the packed layout are reused as they are, only the planner's aliases of string tensors reuse them
+  if (reuse_tensor->IsPackedStrings()) {
+    ORT_RETURN_IF_NOT(buffer_num_elements == required_num_elements,
+                      "Shape mismatch attempting to re-use packed strings. ", reuse_tensor->Shape(), " != ", shape);
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    ort_value.Init(new Tensor(shape, *reuse_tensor), ml_tensor, ml_tensor->GetDeleteFunc());
+    return Status::OK();
+  }
+
   return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
 }
 
@@ -372,6 +563,51 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_v
   return Status::OK();
 }
 
+Status ExecutionFrame::AllocateMLValueTensorInContainer(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                                        MLDataType element_type, const TensorShape& shape,
+                                                        bool& allocated) {
+  allocated = false;
+
+  // the static shapes the plan was created with may not match, in which case the tensor is allocated normally
+  // and the consumer copies it into the container
+  const int64_t len = shape.Size();
+  if (len < 0 || static_cast<size_t>(len) * element_type->Size() != per_alloc_plan.container_bytes) {
+    return Status::OK();
+  }
+
+  // the container is allocated with the first tensor in it, before it is produced
+  const int container_index = per_alloc_plan.container;
+  OrtValue& container = GetMutableMLValue(container_index);
+  if (!container.IsAllocated()) {
+    const auto& container_plan = GetAllocationPlan(container_index);
+    if (container_plan.value_type == nullptr || !container_plan.value_type->IsTensorType()) {
+      return Status::OK();
+    }
+    const auto* container_element_type =
+        static_cast<const TensorTypeBase*>(container_plan.value_type)->GetElementType();
+    ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(container, container_index, container_element_type,
+                                                           container_plan.location,
+                                                           TensorShape(container_plan.container_shape),
+                                                           container_plan.create_fence_if_async));
+  }
+
+  if (!container.IsTensor()) {
+    return Status::OK();
+  }
+
+  auto* container_tensor = container.GetMutable<Tensor>();
+  if (container_tensor->DataType() != element_type ||
+      per_alloc_plan.container_offset + per_alloc_plan.container_bytes > container_tensor->SizeInBytes()) {
+    return Status::OK();
+  }
+
+  void* buffer = static_cast<char*>(container_tensor->MutableDataRaw()) + per_alloc_plan.container_offset;
+  ORT_RETURN_IF_ERROR(AllocateTensorWithPreAllocateBufferHelper(ort_value, buffer, element_type,
+                                                                per_alloc_plan.location, shape));
+  allocated = true;
+  return Status::OK();
+}
+
 static Status AllocateTraditionalMLValue(OrtValue& ort_value, const NonTensorTypeBase& type) {
   auto creator = type.GetCreateFunc();
   ort_value.Init(creator(), &type, type.GetDeleteFunc());
@@ -443,12 +679,26 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       // In the future we may want to have different way to handle it.
       case AllocKind::kAllocateOutput:
       case AllocKind::kAllocate: {
+        if (per_alloc_plan.container >= 0) {
+          bool allocated = false;
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorInContainer(ort_value, per_alloc_plan, ml_data_type, *shape,
+                                                               allocated));
+          if (allocated) {
+            break;
+          }
+        }
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, ml_data_type, alloc_info,
                                                                *shape, per_alloc_plan.create_fence_if_async));
         break;
       }
       case AllocKind::kReuse: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
+        if (!GetMutableMLValue(reuse_mlvalue_index).IsAllocated()) {
+          // the node producing the buffer was skipped as it isn't needed for the requested outputs
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, ml_data_type, alloc_info,
+                                                                 *shape, per_alloc_plan.create_fence_if_async));
+          break;
+        }
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
             ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
         break;
@@ -481,18 +731,69 @@ AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtMemoryInfo& info) const {
   return utils::GetAllocator(session_state_, info);
 }
 
+AllocatorPtr ExecutionFrame::GetScratchAllocatorImpl(const OrtMemoryInfo& info) const {
+  if (scratch_allocator_ && scratch_allocator_->Info() == info) {
+    return scratch_allocator_;
+  }
+  return nullptr;
+}
+
 // This method is not thread safe!
 // Return S_OK and nullptr if index map to an value that is an unused optional input/output
 Status ExecutionFrame::CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) {
   return AllocateAsPerAllocationPlan(ort_value, ort_value_idx, shape, nnz);
 }
 
+Status ExecutionFrame::CreateNodeOutputPackedStringsImpl(OrtValue& ort_value, int ort_value_idx,
+                                                         const TensorShape& shape, size_t num_chars) {
+  const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
+  const auto& per_alloc_plan = p_seq_exec_plan->allocation_plan[ort_value_idx];
+  if (!per_alloc_plan.packed_strings || per_alloc_plan.alloc_kind != AllocKind::kAllocate) {
+    return AllocateAsPerAllocationPlan(ort_value, ort_value_idx, &shape, 0);
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(shape, num_chars, GetAllocator(per_alloc_plan.location));
+  const size_t size = p_tensor->SizeInBytes();
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+
+  value_allocated_bytes_[ort_value_idx] = size;
+  AddAllocatedBytes(static_cast<int64_t>(size));
+  return Status::OK();
+}
+
+bool ExecutionFrame::CanBeViewImpl(int ort_value_idx, int viewed_ort_value_idx) const {
+  // graph outputs are returned to the caller so they can't refer to a buffer that will be freed
+  if (IsOutput(ort_value_idx)) {
+    return false;
+  }
+
+  const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
+  const auto& alloc_plan = p_seq_exec_plan->allocation_plan;
+  ORT_ENFORCE(ort_value_idx >= 0 && static_cast<size_t>(ort_value_idx) < alloc_plan.size());
+  const auto& per_alloc_plan = alloc_plan[ort_value_idx];
+  return per_alloc_plan.alloc_kind == AllocKind::kAllocate && per_alloc_plan.viewed_value == viewed_ort_value_idx;
+}
+
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
+  // the release is deferred if an async read of the value hasn't completed
+  if (value_allocated_bytes_[ort_value_idx] != 0 && !GetMLValue(ort_value_idx).IsAllocated()) {
+    AddAllocatedBytes(-static_cast<int64_t>(value_allocated_bytes_[ort_value_idx]));
+    value_allocated_bytes_[ort_value_idx] = 0;
+  }
   TraceFree(ort_value_idx);
   return Status::OK();
 }
 
+void ExecutionFrame::AddAllocatedBytes(int64_t bytes) {
+  const int64_t allocated_bytes = allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = peak_allocated_bytes_.load(std::memory_order_relaxed);
+  while (allocated_bytes > peak &&
+         !peak_allocated_bytes_.compare_exchange_weak(peak, allocated_bytes, std::memory_order_relaxed)) {
+  }
+}
+
 const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
   const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
   const auto& alloc_plan = p_seq_exec_plan->allocation_plan;
@@ -505,6 +806,16 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
     // don't trace the output tensors.
     auto& allocation_plan = GetAllocationPlan(ort_value_idx);
     if (allocation_plan.alloc_kind == AllocKind::kAllocateOutput) return;
+    if (mem_patterns_) {
+      // keep the sizes of the pattern, so that it grows to the largest shapes of the bucket
+      const MemoryPattern* pattern = mem_patterns_->GetPatterns(allocation_plan.location);
+      const MemoryBlock* block = pattern != nullptr ? pattern->GetBlock(ort_value_idx) : nullptr;
+      if (block == nullptr || size > block->size_) {
+        mem_patterns_outgrown_.store(true, std::memory_order_relaxed);
+      } else {
+        size = block->size_;
+      }
+    }
     auto status = planner_->TraceAllocation(ort_value_idx, size);
     if (!status.IsOK())
       LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for ort_value_idx=" << ort_value_idx
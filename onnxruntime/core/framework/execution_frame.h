@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "core/common/common.h"
@@ -19,8 +20,10 @@ namespace onnxruntime {
 
 class SessionState;
 class OrtValueNameIdxMap;
+class ScratchAllocator;
 class OrtValuePatternPlanner;
 struct MemoryPatternGroup;
+struct ExecutionFrameResources;
 class NodeIndexInfo;
 
 class IExecutionFrame {
@@ -30,6 +33,12 @@ class IExecutionFrame {
                   const std::vector<OrtValue>& fetches, const OrtValueNameIdxMap& ort_value_idx_map,
                   const NodeIndexInfo& node_index_info);
 
+  // values is storage of empty OrtValues to use for all_values_, such as the vector of a previous frame
+  IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                  const std::unordered_map<int, OrtValue>& initializers, const std::vector<int>& fetch_mlvalue_idxs,
+                  const std::vector<OrtValue>& fetches, const OrtValueNameIdxMap& ort_value_idx_map,
+                  const NodeIndexInfo& node_index_info, std::vector<OrtValue>&& values);
+
  public:
   virtual ~IExecutionFrame();
 
@@ -48,6 +57,18 @@ class IExecutionFrame {
   // Shape is required for tensors but not traditional ML values.
   Status GetOrCreateNodeOutputMLValue(int index, const TensorShape* shape, OrtValue*& p_ort_value, size_t nnz = 0);
 
+  // Create the output at index as a tensor of the given shape that views the buffer of the input at input_index,
+  // starting byte_offset bytes into the input data.
+  // Return S_OK and nullptr if the output can't be a view of that input, in which case it has to be allocated with
+  // GetOrCreateNodeOutputMLValue.
+  Status CreateNodeOutputMLValueAsView(int index, int input_index, const TensorShape& shape, size_t byte_offset,
+                                       OrtValue*& p_ort_value);
+
+  // Like GetOrCreateNodeOutputMLValue for a string tensor output of num_chars characters in total, which is created
+  // in the packed string layout if the allocation plan allows it (see OpKernelContext::OutputPackedStrings).
+  Status GetOrCreateNodeOutputPackedStrings(int index, const TensorShape& shape, size_t num_chars,
+                                            OrtValue*& p_ort_value);
+
   /**
    * write the output values to the 'fetches' vector
    * Don't access the values after SessionState is destroyed 
@@ -56,6 +77,10 @@ class IExecutionFrame {
 
   AllocatorPtr GetAllocator(const OrtMemoryInfo& info) const;
 
+  // allocator for the temporaries a kernel frees before it returns, see OpKernelContext::GetScratchAllocator.
+  // nullptr if the frame has none for the device of info.
+  AllocatorPtr GetScratchAllocator(const OrtMemoryInfo& info) const;
+
   Status ReleaseMLValue(int ort_value_idx);
 
  protected:
@@ -69,6 +94,13 @@ class IExecutionFrame {
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // All the intermediate values for the entire graph.
+  // Input and Output values are passed in by executors
+  std::vector<OrtValue> all_values_;
+
+  // perf optimization to avoid calling all_values_.size() repeatedly as the size is fixed once constructed
+  const size_t all_values_size_;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
@@ -83,16 +115,20 @@ class IExecutionFrame {
 
   virtual AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const = 0;
 
+  virtual AllocatorPtr GetScratchAllocatorImpl(const OrtMemoryInfo& /*info*/) const { return nullptr; }
+
   virtual Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) = 0;
 
-  const NodeIndexInfo& node_index_info_;
+  // creates the string tensor in the packed layout if the frame can. the default keeps std::string elements.
+  virtual Status CreateNodeOutputPackedStringsImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape& shape,
+                                                   size_t /*num_chars*/) {
+    return CreateNodeOutputMLValueImpl(ort_value, ort_value_idx, &shape, 0);
+  }
 
-  // All the intermediate values for the entire graph.
-  // Input and Output values are passed in by executors
-  std::vector<OrtValue> all_values_;
+  // returns true if the allocation plan allows the OrtValue to be a view into the viewed OrtValue
+  virtual bool CanBeViewImpl(int /*ort_value_idx*/, int /*viewed_ort_value_idx*/) const { return false; }
 
-  // perf optimization to avoid calling all_values_.size() repeatedly as the size is fixed once constructed
-  const size_t all_values_size_;
+  const NodeIndexInfo& node_index_info_;
 
   const std::vector<int> fetch_mlvalue_idxs_;
 };
@@ -125,16 +161,52 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_ != nullptr;
   }
 
+  // Whether the patterns generated by the planner are to be cached: the frame had none, or the ones cached for the
+  // shape bucket of the feeds were traced with smaller shapes and were too small for some of its tensors.
+  bool ShouldCacheMemoryPatterns() const {
+    return planner_ != nullptr && (!mem_patterns_ || mem_patterns_outgrown_.load(std::memory_order_relaxed));
+  }
+
+  // the memory patterns the frame allocates in, nullptr if none
+  const MemoryPatternGroup* GetMemoryPatterns() const { return mem_patterns_.get(); }
+
+  // Peak bytes of the tensor buffers allocated by this frame that were alive at the same time. The buffers of the
+  // memory patterns count for the lifetime of the frame. Buffers provided by the caller or by custom allocators,
+  // and memory the kernels allocate for themselves, are not included.
+  int64_t GetPeakAllocatedBytes() const {
+    return peak_allocated_bytes_.load(std::memory_order_relaxed);
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
+  // pool_resources is false while a provider captures a graph, see the definition
+  ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                 const SessionState& session_state, bool pool_resources);
+
+  ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                 const SessionState& session_state, bool pool_resources, ExecutionFrameResources&& resources);
+
   AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const override;
+  AllocatorPtr GetScratchAllocatorImpl(const OrtMemoryInfo& info) const override;
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
+  Status CreateNodeOutputPackedStringsImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape& shape,
+                                           size_t num_chars) override;
+  bool CanBeViewImpl(int ort_value_idx, int viewed_ort_value_idx) const override;
 
   common::Status AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                              size_t nnz);
 
+  // Allocate a tensor in the buffer of the container it's planned to be in (see AllocPlanPerValue::container).
+  // allocated is false if it doesn't match the part of the container planned for it.
+  Status AllocateMLValueTensorInContainer(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                          MLDataType element_type, const TensorShape& shape, bool& allocated);
+
   Status AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_value, int ort_value_index, MLDataType element_type,
                                                   const OrtMemoryInfo& location, const TensorShape& shape,
                                                   bool create_fence);
@@ -145,23 +217,43 @@ class ExecutionFrame final : public IExecutionFrame {
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
+  // thread-safe as the parallel executor allocates the outputs of the nodes from several threads
+  void AddAllocatedBytes(int64_t bytes);
+
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
   const SessionState& session_state_;
 
+  // whether the values and buffers are returned to the SessionState for later frames when the frame is destroyed
+  const bool pool_resources_;
+
   // map of index to custom allocator
   std::unordered_map<int, IExecutor::CustomAllocator> custom_allocators_;
 
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // Shared with the SessionState cache so it stays valid if the cache evicts it during execution.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
+  // With shape bucketing it also traces the allocations of a frame with a cached pattern, at no less than the sizes
+  // of the pattern, so that the pattern can be re-planned for the largest shapes of the bucket seen.
   std::unique_ptr<OrtValuePatternPlanner> planner_;
 
+  // a tensor didn't fit in its block of mem_patterns_. written by the threads of the parallel executor.
+  std::atomic<bool> mem_patterns_outgrown_{false};
+
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
+
+  // size of the buffer allocated for each value, or 0 if it doesn't own one. each value is written by one thread.
+  std::vector<size_t> value_allocated_bytes_;
+  std::atomic<int64_t> allocated_bytes_{0};
+  std::atomic<int64_t> peak_allocated_bytes_{0};
+
+  // per-Run scratch of the CPU kernels if SessionState::GetEnableScratchAllocator()
+  std::shared_ptr<ScratchAllocator> scratch_allocator_;
 };
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 #include "core/framework/execution_provider.h"
 
 #include "core/graph/graph_viewer.h"
+#include "core/framework/arena.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel.h"
@@ -49,6 +50,16 @@ common::Status IExecutionProvider::OnRunStart() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
+common::Status IExecutionProvider::ShrinkMemoryArenas() {
+  for (auto& entry : allocators_) {
+    auto arena = std::dynamic_pointer_cast<IArenaAllocator>(entry.second);
+    if (arena) {
+      ORT_RETURN_IF_ERROR(arena->Shrink());
+    }
+  }
+  return Status::OK();
+}
+
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtMemoryInfo& info = allocator->Info();
   const int key = MakeKey(info.id, info.mem_type);
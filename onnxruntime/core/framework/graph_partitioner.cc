@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <algorithm>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +13,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/graph/graph_utils.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,6 +109,256 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+// Rough relative costs used by the cost based placement. The unit is the cost of processing one tensor element on
+// CPU. Symbolic dimensions are counted as 1, which underestimates the compute and the copy costs alike.
+static constexpr double kDeviceSpeedup = 10.0;
+static constexpr double kCopyCostPerByte = 0.25;
+static constexpr double kCopyLatencyCost = 5000.0;
+
+// The providers that run on CPU memory, so that no copies are needed between them and the CPU provider.
+// This matches the providers the MemcpyTransformer ignores.
+static bool UsesDeviceMemory(const std::string& provider_type) {
+  return provider_type != kCpuExecutionProvider &&
+         provider_type != kDnnlExecutionProvider &&
+         provider_type != kNGraphExecutionProvider &&
+         provider_type != kNupharExecutionProvider &&
+         provider_type != kOpenVINOExecutionProvider &&
+         provider_type != kAclExecutionProvider;
+}
+
+static double NumElements(const NodeArg& arg, bool& known) {
+  const auto* shape = arg.Shape();
+  known = shape != nullptr;
+  double elements = 1.0;
+  if (shape != nullptr) {
+    for (const auto& dim : shape->dim()) {
+      if (dim.has_dim_value()) {
+        elements *= static_cast<double>(dim.dim_value());
+      }
+    }
+  }
+  return elements;
+}
+
+static size_t ElementSize(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return 4;
+  }
+  switch (type->tensor_type().elem_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return 1;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+      return 8;
+    default:
+      return 4;
+  }
+}
+
+static double CopyCost(const NodeArg& arg) {
+  bool known;
+  return kCopyLatencyCost + NumElements(arg, known) * ElementSize(arg) * kCopyCostPerByte;
+}
+
+// Estimates the cost of running the node on CPU. Returns a negative value for the compute bound nodes whose cost
+// can't be estimated, which are always left on the device.
+static double ComputeCost(const Node& node) {
+  static const std::unordered_set<std::string> always_on_device_ops =
+      {"LSTM", "GRU", "RNN", "Attention", "ConvInteger", "QLinearConv", "TopK", "NonMaxSuppression"};
+  if (always_on_device_ops.count(node.OpType()) != 0) {
+    return -1.0;
+  }
+
+  double output_elements = 0.0;
+  for (const auto* output : node.OutputDefs()) {
+    bool known;
+    if (output->Exists()) {
+      output_elements += NumElements(*output, known);
+    }
+  }
+
+  // the compute bound ops perform a reduction over K elements per output element
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+  const ONNX_NAMESPACE::TensorShapeProto* k_shape = nullptr;
+  int k_first_dim = 0;
+  int k_last_dim = 0;
+  if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul" ||
+      op_type == "Gemm" || op_type == "FusedGemm") {
+    // the second to last dim of B is K, independent of the transpose of A
+    k_shape = inputs.size() > 1 ? inputs[1]->Shape() : nullptr;
+    bool trans_b = false;
+    const auto& attributes = node.GetAttributes();
+    auto trans_b_attr = attributes.find("transB");
+    if (trans_b_attr != attributes.end()) {
+      trans_b = trans_b_attr->second.i() != 0;
+    }
+    if (k_shape != nullptr) {
+      k_first_dim = k_shape->dim_size() - (trans_b ? 1 : 2);
+      k_last_dim = k_first_dim + 1;
+      if (k_first_dim < 0) {
+        k_first_dim = 0;
+        k_last_dim = k_shape->dim_size();
+      }
+    }
+  } else if (op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvTranspose") {
+    // each output element is a dot product over the input channels and kernel spatial dims of the weights
+    k_shape = inputs.size() > 1 ? inputs[1]->Shape() : nullptr;
+    if (k_shape != nullptr) {
+      k_first_dim = 1;
+      k_last_dim = k_shape->dim_size();
+    }
+  } else {
+    return output_elements;
+  }
+
+  if (k_shape == nullptr) {
+    return -1.0;
+  }
+
+  double k = 1.0;
+  for (int i = k_first_dim; i < k_last_dim; ++i) {
+    if (!k_shape->dim(i).has_dim_value()) {
+      return -1.0;
+    }
+    k *= static_cast<double>(k_shape->dim(i).dim_value());
+  }
+  return output_elements * k;
+}
+
+void GraphPartitioner::PlaceIslandsByCost(Graph& graph) const {
+  // the islands can only be moved to the CPU provider if it's registered
+  if (providers_.Get(kCpuExecutionProvider) == nullptr) {
+    return;
+  }
+
+  std::unordered_set<NodeIndex> visited;
+  for (auto& start_node : graph.Nodes()) {
+    const std::string provider_type = start_node.GetExecutionProviderType();
+    if (!UsesDeviceMemory(provider_type) || provider_type.empty() || visited.count(start_node.Index()) != 0) {
+      continue;
+    }
+
+    // collect the island of connected nodes assigned to the same provider
+    std::vector<Node*> island;
+    std::unordered_set<NodeIndex> island_nodes;
+    std::vector<Node*> to_visit{&start_node};
+    visited.insert(start_node.Index());
+    while (!to_visit.empty()) {
+      Node* node = to_visit.back();
+      to_visit.pop_back();
+      island.push_back(node);
+      island_nodes.insert(node->Index());
+
+      auto visit = [&](const Node& neighbor) {
+        if (neighbor.GetExecutionProviderType() == provider_type && visited.insert(neighbor.Index()).second) {
+          to_visit.push_back(graph.GetNode(neighbor.Index()));
+        }
+      };
+      for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+        visit(*it);
+      }
+      for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+        visit(*it);
+      }
+    }
+
+    // The island can be moved if all its neighbors are on CPU and CPU kernels exist for all its nodes.
+    // Fused and control flow nodes are left alone.
+    bool can_move = true;
+    double cpu_cost = 0.0;
+    std::unordered_set<const NodeArg*> copied_args;
+    const auto& graph_outputs = graph.GetOutputs();
+    for (Node* node : island) {
+      if (node->NodeType() == Node::Type::Fused || node->ContainsSubgraph()) {
+        can_move = false;
+        break;
+      }
+
+      for (auto it = node->InputNodesBegin(); can_move && it != node->InputNodesEnd(); ++it) {
+        can_move = island_nodes.count(it->Index()) != 0 || it->GetExecutionProviderType() == kCpuExecutionProvider;
+      }
+      for (auto it = node->OutputNodesBegin(); can_move && it != node->OutputNodesEnd(); ++it) {
+        can_move = island_nodes.count(it->Index()) != 0 || it->GetExecutionProviderType() == kCpuExecutionProvider;
+      }
+
+      double cost = ComputeCost(*node);
+      if (!can_move || cost < 0.0) {
+        can_move = false;
+        break;
+      }
+      cpu_cost += cost;
+
+      node->SetExecutionProviderType(kCpuExecutionProvider);
+      bool has_cpu_kernel = kernel_registry_mgr_.HasImplementationOf(*node, kCpuExecutionProvider);
+      node->SetExecutionProviderType(provider_type);
+      if (!has_cpu_kernel) {
+        can_move = false;
+        break;
+      }
+
+      // The values produced outside the island, other than initializers which are copied once, and the values
+      // consumed outside the island are copied on every run. Values the device kernel reads or writes in CPU memory
+      // aren't.
+      const KernelCreateInfo* kci = nullptr;
+      kernel_registry_mgr_.SearchKernelRegistry(*node, &kci);
+      const auto& input_defs = node->InputDefs();
+      std::vector<bool> produced_in_island(input_defs.size(), false);
+      for (auto it = node->InputEdgesBegin(); it != node->InputEdgesEnd(); ++it) {
+        if (island_nodes.count(it->GetNode().Index()) != 0 &&
+            static_cast<size_t>(it->GetDstArgIndex()) < input_defs.size()) {
+          produced_in_island[it->GetDstArgIndex()] = true;
+        }
+      }
+      for (size_t i = 0; i < input_defs.size(); ++i) {
+        const NodeArg* arg = input_defs[i];
+        if (arg->Exists() && !produced_in_island[i] && !(kci && kci->kernel_def->IsInputOnCpu(i)) &&
+            !graph_utils::IsInitializer(graph, arg->Name(), true)) {
+          copied_args.insert(arg);
+        }
+      }
+
+      const auto& output_defs = node->OutputDefs();
+      for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+        size_t index = static_cast<size_t>(it->GetSrcArgIndex());
+        if (island_nodes.count(it->GetNode().Index()) == 0 && !(kci && kci->kernel_def->IsOutputOnCpu(index))) {
+          copied_args.insert(output_defs[index]);
+        }
+      }
+      for (size_t i = 0; i < output_defs.size(); ++i) {
+        if (!(kci && kci->kernel_def->IsOutputOnCpu(i)) &&
+            std::find(graph_outputs.cbegin(), graph_outputs.cend(), output_defs[i]) != graph_outputs.cend()) {
+          copied_args.insert(output_defs[i]);
+        }
+      }
+    }
+
+    if (!can_move) {
+      continue;
+    }
+
+    double copy_cost = 0.0;
+    for (const NodeArg* arg : copied_args) {
+      copy_cost += CopyCost(*arg);
+    }
+
+    if (cpu_cost <= cpu_cost / kDeviceSpeedup + copy_cost) {
+      for (Node* node : island) {
+        node->SetExecutionProviderType(kCpuExecutionProvider);
+      }
+    }
+  }
+}
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
@@ -212,6 +466,10 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     ORT_RETURN_IF_ERROR(Partition(graph, export_dll, func_mgr));
   }
 
+  if (enable_cost_based_placement_ && !inline_flag) {
+    PlaceIslandsByCost(graph);
+  }
+
   //For some cases, like fp16 on cpu, right now we don't have any kernel support that.
   //But we will insert cast op to run the model, so skip the error checking here.
   //If after graph transform phase, the node still not assigned, we will report error
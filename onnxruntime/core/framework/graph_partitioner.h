@@ -16,16 +16,24 @@ class KernelRegistryManager;
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  //If enable_cost_based_placement is true, the islands of nodes assigned to a provider with device memory are moved
+  //back to the CPU provider when the estimated cost of copying their inputs and outputs exceeds the estimated
+  //speedup of running them on the device.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   bool enable_cost_based_placement = false)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {}
+        providers_(providers),
+        enable_cost_based_placement_(enable_cost_based_placement) {}
 
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
+  void PlaceIslandsByCost(Graph& graph) const;
+
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  const bool enable_cost_based_placement_;
 };
 }  // namespace onnxruntime
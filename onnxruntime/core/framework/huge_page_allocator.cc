@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/huge_page_allocator.h"
+
+#include "core/framework/utils.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+// Maps size bytes backed by huge pages, rounded up to the huge page size in mapped_size. Returns nullptr if the
+// platform has no huge pages for it.
+void* MapHugePages(size_t size, size_t& mapped_size) {
+#ifdef _WIN32
+  const size_t large_page_size = GetLargePageMinimum();
+  if (large_page_size == 0) {
+    return nullptr;
+  }
+  mapped_size = (size + large_page_size - 1) / large_page_size * large_page_size;
+  // fails without the SeLockMemoryPrivilege, or once the physical memory is too fragmented for large pages
+  return VirtualAlloc(nullptr, mapped_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#elif defined(__linux__)
+  constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+  mapped_size = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+
+#ifdef MAP_HUGETLB
+  // the pages reserved by the administrator in vm.nr_hugepages. this fails right away when there are none left.
+  int hugetlb_flags = MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+  // the 2MB pages rather than the default huge page size, which may be 1GB
+  hugetlb_flags |= 21 << MAP_HUGE_SHIFT;
+#endif
+  void* p = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | hugetlb_flags, -1, 0);
+  if (p != MAP_FAILED) {
+    return p;
+  }
+#endif
+
+  // transparent huge pages need a 2MB aligned range, so map an extra huge page and unmap the unaligned ends
+  const size_t reserved_size = mapped_size + kHugePageSize;
+  void* base = mmap(nullptr, reserved_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+
+  char* const reserved = static_cast<char*>(base);
+  char* const aligned = reinterpret_cast<char*>(
+      (reinterpret_cast<uintptr_t>(reserved) + kHugePageSize - 1) & ~uintptr_t{kHugePageSize - 1});
+  const size_t head = static_cast<size_t>(aligned - reserved);
+  if (head != 0) {
+    munmap(reserved, head);
+  }
+  if (reserved_size - head != mapped_size) {
+    munmap(aligned + mapped_size, reserved_size - head - mapped_size);
+  }
+
+#ifdef MADV_HUGEPAGE
+  // only a hint. the kernel falls back to small pages if transparent huge pages are disabled or none are free.
+  madvise(aligned, mapped_size, MADV_HUGEPAGE);
+#endif
+  return aligned;
+#else
+  ORT_UNUSED_PARAMETER(size);
+  ORT_UNUSED_PARAMETER(mapped_size);
+  return nullptr;
+#endif
+}
+
+void UnmapHugePages(void* p, size_t mapped_size) {
+#ifdef _WIN32
+  ORT_UNUSED_PARAMETER(mapped_size);
+  VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+  munmap(p, mapped_size);
+#else
+  ORT_UNUSED_PARAMETER(p);
+  ORT_UNUSED_PARAMETER(mapped_size);
+#endif
+}
+
+}  // namespace
+
+HugePageAllocator::HugePageAllocator(size_t threshold)
+    : threshold_{threshold}, memory_info_{CPU, OrtAllocatorType::OrtDeviceAllocator} {
+}
+
+HugePageAllocator::~HugePageAllocator() {
+  for (const auto& allocation : huge_page_allocations_) {
+    UnmapHugePages(allocation.first, allocation.second);
+  }
+}
+
+void* HugePageAllocator::Alloc(size_t size) {
+  if (threshold_ != 0 && size >= threshold_) {
+    size_t mapped_size = 0;
+    void* p = MapHugePages(size, mapped_size);
+    if (p != nullptr) {
+      std::lock_guard<OrtMutex> lock(lock_);
+      huge_page_allocations_.emplace(p, mapped_size);
+      huge_page_bytes_ += mapped_size;
+      return p;
+    }
+  }
+
+  return utils::DefaultAlloc(size);
+}
+
+void HugePageAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  size_t mapped_size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = huge_page_allocations_.find(p);
+    if (it != huge_page_allocations_.end()) {
+      mapped_size = it->second;
+      huge_page_bytes_ -= mapped_size;
+      huge_page_allocations_.erase(it);
+    }
+  }
+
+  if (mapped_size != 0) {
+    UnmapHugePages(p, mapped_size);
+  } else {
+    utils::DefaultFree(p);
+  }
+}
+
+size_t HugePageAllocator::HugePageBytes() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  return huge_page_bytes_;
+}
+
+}  // namespace onnxruntime
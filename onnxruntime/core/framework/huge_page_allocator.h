@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// CPU device allocator that backs the allocations of at least threshold bytes with huge pages, which saves the TLB
+// misses of the large buffers. These are the regions the arena extends by and the buffers of the initializers and
+// the memory patterns, so there are few of them. On Linux a buffer is taken from the reserved hugetlbfs pages if
+// there are any, else it's a 2MB aligned mapping the kernel is advised to back with transparent huge pages. On
+// Windows it uses large pages, which need the SeLockMemoryPrivilege. The smaller allocations, and the large ones huge
+// pages can't be had for, are aligned mallocs like CPUAllocator.
+// Thread-safe.
+class HugePageAllocator : public IDeviceAllocator {
+ public:
+  explicit HugePageAllocator(size_t threshold);
+  ~HugePageAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  const OrtMemoryInfo& Info() const override { return memory_info_; }
+
+  // The number of bytes currently mapped with huge pages, including the rounding up to the huge page size.
+  size_t HugePageBytes() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HugePageAllocator);
+
+  const size_t threshold_;
+  const OrtMemoryInfo memory_info_;
+
+  // the mapped size of each huge page allocation, to unmap it and to tell it from the mallocs
+  mutable OrtMutex lock_;
+  std::unordered_map<void*, size_t> huge_page_allocations_;
+  size_t huge_page_bytes_{0};
+};
+
+}  // namespace onnxruntime
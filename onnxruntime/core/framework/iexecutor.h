@@ -44,5 +44,14 @@ class IExecutor {
                                  // optional custom allocators. key is index in fetches
                                  const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                  const logging::Logger& logger) = 0;
+
+  /**
+   * Peak bytes of the tensors allocated by the last successful Execute call.
+   * See ExecutionFrame::GetPeakAllocatedBytes.
+   */
+  int64_t GetPeakAllocatedBytes() const { return peak_allocated_bytes_; }
+
+ protected:
+  int64_t peak_allocated_bytes_ = 0;
 };
 }  // namespace onnxruntime
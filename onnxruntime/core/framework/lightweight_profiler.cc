@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/lightweight_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace profiling {
+using namespace std::chrono;
+
+namespace {
+std::atomic<uint64_t> next_profiler_id{1};
+
+// the buffer of the profiler the thread recorded to last, so the lookup of thread_buffers_ can mostly be skipped
+struct ThreadBufferCache {
+  uint64_t profiler_id = 0;
+  void* buffer = nullptr;
+};
+thread_local ThreadBufferCache thread_buffer_cache;
+
+// values below 4 have their own bucket. above that, each power of two is split into 4 buckets.
+size_t HistogramBucket(int64_t ns) {
+  if (ns < 4) {
+    return ns < 0 ? 0 : static_cast<size_t>(ns);
+  }
+  int exponent = 0;
+  for (uint64_t v = static_cast<uint64_t>(ns); v > 1; v >>= 1) {
+    ++exponent;
+  }
+  return static_cast<size_t>((exponent - 1) * 4) + ((static_cast<uint64_t>(ns) >> (exponent - 2)) & 3);
+}
+
+// the middle of the range of values of a bucket
+int64_t HistogramBucketValue(size_t bucket) {
+  if (bucket < 4) {
+    return static_cast<int64_t>(bucket);
+  }
+  const int exponent = static_cast<int>(bucket / 4) + 1;
+  const uint64_t width = uint64_t{1} << (exponent - 2);
+  return static_cast<int64_t>((4 + bucket % 4) * width + width / 2);
+}
+
+uint16_t SaturateToUInt16(uint64_t value) {
+  return static_cast<uint16_t>(std::min<uint64_t>(value, std::numeric_limits<uint16_t>::max()));
+}
+}  // namespace
+
+void LightweightProfiler::Aggregate::Add(const Event& event) {
+  if (stats.count == 0 || event.duration_ns < stats.min_ns) {
+    stats.min_ns = event.duration_ns;
+  }
+  if (stats.count == 0 || event.duration_ns > stats.max_ns) {
+    stats.max_ns = event.duration_ns;
+  }
+  stats.total_ns += event.duration_ns;
+  ++stats.count;
+  stats.output_bytes += event.output_bytes;
+  stats.parallel_for_calls += event.parallel_for_calls;
+  threads_used += event.threads_used;
+  threads_available += event.threads_available;
+  ++histogram[std::min(HistogramBucket(event.duration_ns), kHistogramBuckets - 1)];
+}
+
+OpStatistics LightweightProfiler::Aggregate::Get() const {
+  OpStatistics result = stats;
+  if (threads_available > 0) {
+    result.thread_pool_utilization = static_cast<double>(threads_used) / static_cast<double>(threads_available);
+  }
+
+  auto percentile = [this](double fraction) {
+    const uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(fraction * static_cast<double>(stats.count) + 0.5));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+      seen += histogram[bucket];
+      if (seen >= rank) {
+        return std::min(std::max(HistogramBucketValue(bucket), stats.min_ns), stats.max_ns);
+      }
+    }
+    return stats.max_ns;
+  };
+  result.p50_ns = percentile(0.5);
+  result.p99_ns = percentile(0.99);
+  return result;
+}
+
+LightweightProfiler::LightweightProfiler(const GraphViewer& graph_viewer, uint32_t sampling_interval)
+    : id_(next_profiler_id.fetch_add(1, std::memory_order_relaxed)),
+      sampling_interval_(sampling_interval),
+      start_time_(high_resolution_clock::now()) {
+  ORT_ENFORCE(sampling_interval_ > 0, "The sampling interval must be positive.");
+
+  std::unordered_map<std::string, uint32_t> op_ids;
+  node_op_ids_.resize(graph_viewer.MaxNodeIndex(), 0);
+  node_names_.resize(graph_viewer.MaxNodeIndex());
+  for (const auto& node : graph_viewer.Nodes()) {
+    auto result = op_ids.insert({node.OpType(), static_cast<uint32_t>(op_types_.size())});
+    if (result.second) {
+      op_types_.push_back(node.OpType());
+    }
+    node_op_ids_[node.Index()] = result.first->second;
+    node_names_[node.Index()] = node.Name();
+  }
+  op_aggregates_.resize(op_types_.size());
+  node_aggregates_.resize(node_names_.size());
+}
+
+LightweightProfiler::ThreadBuffer& LightweightProfiler::GetThreadBuffer() {
+  if (thread_buffer_cache.profiler_id == id_) {
+    return *static_cast<ThreadBuffer*>(thread_buffer_cache.buffer);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto& buffer = thread_buffers_[std::this_thread::get_id()];
+  if (buffer == nullptr) {
+    buffer = onnxruntime::make_unique<ThreadBuffer>();
+    buffer->thread_id = static_cast<uint32_t>(thread_buffers_.size() - 1);
+  }
+  thread_buffer_cache.profiler_id = id_;
+  thread_buffer_cache.buffer = buffer.get();
+  return *buffer;
+}
+
+void LightweightProfiler::RecordNodeEvent(OpKernelContextInternal& context,
+                                          high_resolution_clock::time_point start_time,
+                                          high_resolution_clock::time_point end_time,
+                                          const concurrency::ParallelForStats& parallel_for_stats) {
+  uint64_t output_bytes = 0;
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const OrtValue* output = context.GetOutputMLValue(i);
+    if (output != nullptr && output->IsAllocated() && output->IsTensor()) {
+      output_bytes += output->Get<Tensor>().SizeInBytes();
+    }
+  }
+
+  ThreadBuffer& buffer = GetThreadBuffer();
+  // only this thread writes write_count
+  const uint64_t write_count = buffer.write_count.load(std::memory_order_relaxed);
+  Event& event = buffer.events[write_count % kEventsPerThread];
+  event.node_index = static_cast<uint32_t>(context.GetNodeIndex());
+  event.thread_id = buffer.thread_id;
+  event.start_ns = duration_cast<nanoseconds>(start_time - start_time_).count();
+  event.duration_ns = duration_cast<nanoseconds>(end_time - start_time).count();
+  event.output_bytes = output_bytes;
+  event.parallel_for_calls = static_cast<uint32_t>(parallel_for_stats.num_calls);
+  event.threads_used = SaturateToUInt16(parallel_for_stats.num_threads_used);
+  event.threads_available = SaturateToUInt16(parallel_for_stats.num_threads_available);
+  buffer.write_count.store(write_count + 1, std::memory_order_release);
+}
+
+void LightweightProfiler::AggregateEvents() const {
+  std::vector<Event> events;
+  for (const auto& entry : thread_buffers_) {
+    ThreadBuffer& buffer = *entry.second;
+    const uint64_t write_count = buffer.write_count.load(std::memory_order_acquire);
+    uint64_t begin = std::max(buffer.read_count,
+                              write_count > kEventsPerThread ? write_count - kEventsPerThread : 0);
+    events.clear();
+    for (uint64_t i = begin; i < write_count; ++i) {
+      events.push_back(buffer.events[i % kEventsPerThread]);
+    }
+
+    // the owner may have wrapped around while the events were copied. the event being written when
+    // write_count is read again overwrites the slot of index (write_count - kEventsPerThread).
+    const uint64_t new_write_count = buffer.write_count.load(std::memory_order_acquire);
+    const uint64_t first_valid = new_write_count + 1 > kEventsPerThread ? new_write_count + 1 - kEventsPerThread : 0;
+    const uint64_t skipped = std::min<uint64_t>(first_valid > begin ? first_valid - begin : 0, events.size());
+
+    dropped_event_count_ += (begin - buffer.read_count) + skipped;
+    buffer.read_count = write_count;
+
+    for (size_t i = static_cast<size_t>(skipped); i < events.size(); ++i) {
+      const Event& event = events[i];
+      op_aggregates_[node_op_ids_[event.node_index]].Add(event);
+      node_aggregates_[event.node_index].Add(event);
+    }
+  }
+}
+
+std::map<std::string, OpStatistics> LightweightProfiler::Collect(const std::vector<Aggregate>& aggregates,
+                                                                 const std::vector<std::string>& keys) {
+  std::map<std::string, OpStatistics> result;
+  for (size_t i = 0; i < aggregates.size(); ++i) {
+    if (aggregates[i].stats.count > 0) {
+      result[keys[i]] = aggregates[i].Get();
+    }
+  }
+  return result;
+}
+
+std::map<std::string, OpStatistics> LightweightProfiler::GetOpStatistics() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  AggregateEvents();
+  return Collect(op_aggregates_, op_types_);
+}
+
+std::map<std::string, OpStatistics> LightweightProfiler::GetNodeStatistics() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  AggregateEvents();
+  return Collect(node_aggregates_, node_names_);
+}
+
+std::string LightweightProfiler::GetStatisticsJson() const {
+  std::map<std::string, OpStatistics> op_statistics;
+  std::map<std::string, OpStatistics> node_statistics;
+  uint64_t dropped_event_count;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    AggregateEvents();
+    op_statistics = Collect(op_aggregates_, op_types_);
+    node_statistics = Collect(node_aggregates_, node_names_);
+    dropped_event_count = dropped_event_count_;
+  }
+
+  std::ostringstream json;
+  auto write_string = [&json](const std::string& str) {
+    json << '"';
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        json << '\\' << c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        json << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+      } else {
+        json << c;
+      }
+    }
+    json << '"';
+  };
+  auto write_statistics = [&json, &write_string](const std::map<std::string, OpStatistics>& statistics) {
+    json << '{';
+    for (auto it = statistics.cbegin(); it != statistics.cend(); ++it) {
+      const OpStatistics& stats = it->second;
+      if (it != statistics.cbegin()) {
+        json << ", ";
+      }
+      write_string(it->first);
+      json << ": {\"count\": " << stats.count
+           << ", \"total_ns\": " << stats.total_ns
+           << ", \"min_ns\": " << stats.min_ns
+           << ", \"max_ns\": " << stats.max_ns
+           << ", \"p50_ns\": " << stats.p50_ns
+           << ", \"p99_ns\": " << stats.p99_ns
+           << ", \"output_bytes\": " << stats.output_bytes
+           << ", \"parallel_for_calls\": " << stats.parallel_for_calls
+           << ", \"thread_pool_utilization\": " << stats.thread_pool_utilization << '}';
+    }
+    json << '}';
+  };
+
+  json << "{\"dropped_events\": " << dropped_event_count << ", \"ops\": ";
+  write_statistics(op_statistics);
+  json << ", \"nodes\": ";
+  write_statistics(node_statistics);
+  json << '}';
+  return json.str();
+}
+
+uint64_t LightweightProfiler::DroppedEventCount() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  AggregateEvents();
+  return dropped_event_count_;
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class OpKernelContextInternal;
+
+namespace profiling {
+
+/**
+ * Statistics of the nodes recorded by the LightweightProfiler, accumulated across the sampled runs.
+ */
+struct OpStatistics {
+  uint64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t min_ns = 0;
+  int64_t max_ns = 0;
+  // estimated from a histogram with 4 buckets per power of two
+  int64_t p50_ns = 0;
+  int64_t p99_ns = 0;
+  // total size of the output tensors
+  uint64_t output_bytes = 0;
+  // number of parallel loops, and the fraction of the intra op threads that ran part of them
+  uint64_t parallel_for_calls = 0;
+  double thread_pool_utilization = 0.0;
+};
+
+/**
+ * Profiler that can be left on in production. Unlike Profiler, it doesn't format or store strings while the
+ * model runs: each thread writes fixed size events into its own ring buffer without taking a lock, and the
+ * events are only aggregated into per node and per op statistics when they are requested.
+ * Only one in sampling_interval runs is recorded.
+ */
+class LightweightProfiler {
+ public:
+  LightweightProfiler(const GraphViewer& graph_viewer, uint32_t sampling_interval);
+
+  /*
+  Whether the run that is starting should be recorded. Called once per run.
+  */
+  bool SampleRun() {
+    return run_count_.fetch_add(1, std::memory_order_relaxed) % sampling_interval_ == 0;
+  }
+
+  /*
+  Record the kernel time, the output sizes and the parallel loops of a node. Lock free other than the first time
+  a thread records an event.
+  */
+  void RecordNodeEvent(OpKernelContextInternal& context,
+                       std::chrono::high_resolution_clock::time_point start_time,
+                       std::chrono::high_resolution_clock::time_point end_time,
+                       const concurrency::ParallelForStats& parallel_for_stats);
+
+  /*
+  Aggregate the events recorded since the last call, and return the statistics of all the recorded runs
+  keyed by op type.
+  */
+  std::map<std::string, OpStatistics> GetOpStatistics() const;
+
+  /*
+  Same as GetOpStatistics, keyed by node name.
+  */
+  std::map<std::string, OpStatistics> GetNodeStatistics() const;
+
+  /*
+  The op and node statistics and the dropped event count as a JSON object:
+  {"dropped_events": N, "ops": {"<op type>": {<OpStatistics fields>}, ...}, "nodes": {"<node name>": {...}, ...}}
+  */
+  std::string GetStatisticsJson() const;
+
+  /*
+  Number of events that were overwritten before they could be aggregated.
+  */
+  uint64_t DroppedEventCount() const;
+
+  // number of events each thread can hold between two aggregations
+  static constexpr size_t kEventsPerThread = 4096;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LightweightProfiler);
+
+  // plain data so recording an event is a few stores.
+  struct Event {
+    uint32_t node_index;
+    uint32_t thread_id;
+    int64_t start_ns;
+    int64_t duration_ns;
+    uint64_t output_bytes;
+    uint32_t parallel_for_calls;
+    uint16_t threads_used;
+    uint16_t threads_available;
+  };
+
+  // written by a single thread. write_count is published with release semantics after the event is stored.
+  struct ThreadBuffer {
+    std::array<Event, kEventsPerThread> events;
+    std::atomic<uint64_t> write_count{0};
+    uint64_t read_count = 0;  // protected by lock_
+    uint32_t thread_id = 0;
+  };
+
+  static constexpr size_t kHistogramBuckets = 256;
+
+  struct Aggregate {
+    OpStatistics stats;
+    uint64_t threads_used = 0;
+    uint64_t threads_available = 0;
+    std::array<uint32_t, kHistogramBuckets> histogram{};
+
+    void Add(const Event& event);
+    OpStatistics Get() const;
+  };
+
+  ThreadBuffer& GetThreadBuffer();
+
+  // called with lock_ held
+  void AggregateEvents() const;
+  static std::map<std::string, OpStatistics> Collect(const std::vector<Aggregate>& aggregates,
+                                                     const std::vector<std::string>& keys);
+
+  const uint64_t id_;
+  const uint32_t sampling_interval_;
+  const std::chrono::high_resolution_clock::time_point start_time_;
+  std::atomic<uint64_t> run_count_{0};
+
+  // node index to the interned op type, and the node names
+  std::vector<uint32_t> node_op_ids_;
+  std::vector<std::string> op_types_;
+  std::vector<std::string> node_names_;
+
+  mutable OrtMutex lock_;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> thread_buffers_;  // protected by lock_
+  // indexed by op id and by node index
+  mutable std::vector<Aggregate> op_aggregates_;    // protected by lock_
+  mutable std::vector<Aggregate> node_aggregates_;  // protected by lock_
+  mutable uint64_t dropped_event_count_ = 0;        // protected by lock_
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -16,6 +16,8 @@ limitations under the License.
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <limits>
 #include <list>
 
 #include "core/framework/mem_pattern.h"
@@ -26,6 +28,11 @@ namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
 // in a single iteration, record the pattern and cached for
 // future request if they have the same input shape.
+// Offsets are assigned as the allocations are traced, using best-fit
+// against the currently live blocks. Once the whole iteration has been
+// traced, the lifetime of every block is known, and GenerateMemPattern
+// also places the blocks largest first against the blocks with
+// overlapping lifetimes, keeping whichever layout has the smaller peak.
 // Thread-safe.
 class MemPatternPlanner {
  public:
@@ -34,6 +41,8 @@ class MemPatternPlanner {
   void TraceAllocation(int ml_value_idx, size_t size) {
     std::lock_guard<OrtMutex> lock(lock_);
 
+    lifetimes_.push_back({ml_value_idx, size, step_++, std::numeric_limits<size_t>::max()});
+
     if (size == 0) {
       allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0));
       return;
@@ -68,6 +77,15 @@ class MemPatternPlanner {
   void TraceFree(int ml_value_index) {
     std::lock_guard<OrtMutex> lock(lock_);
 
+    for (auto it = lifetimes_.rbegin(); it != lifetimes_.rend(); it++) {
+      if (it->index_ == ml_value_index) {
+        if (it->free_step_ == std::numeric_limits<size_t>::max()) {
+          it->free_step_ = step_++;
+        }
+        break;
+      }
+    }
+
     for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
       if (allocs_[*it].index_ == ml_value_index) {
         blocks_.erase(it);
@@ -85,10 +103,83 @@ class MemPatternPlanner {
       pattern.patterns_[alloc.index_] = alloc.block_;
     }
 
+    MemoryPattern greedy_pattern = GenerateGreedyBySizePattern();
+    if (greedy_pattern.peak_size_ < pattern.peak_size_) {
+      return greedy_pattern;
+    }
+
     return pattern;
   }
 
  protected:
+  struct OrtValueLifetime {
+    int index_;
+    size_t size_;
+    size_t alloc_step_;
+    size_t free_step_;  // max() while the block is still allocated
+  };
+
+  // Assigns offsets to the traced blocks in order of decreasing size. Each block goes into the
+  // smallest gap left by the already placed blocks whose lifetimes overlap its own, or after all
+  // of them if no gap is large enough.
+  MemoryPattern GenerateGreedyBySizePattern() const {
+    std::vector<size_t> order(lifetimes_.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+      return lifetimes_[lhs].size_ > lifetimes_[rhs].size_;
+    });
+
+    MemoryPattern pattern;
+    std::vector<size_t> placed;
+    std::vector<MemoryBlock> offsets(lifetimes_.size());
+    std::vector<const MemoryBlock*> overlapping;
+
+    for (size_t i : order) {
+      const OrtValueLifetime& lifetime = lifetimes_[i];
+      if (lifetime.size_ == 0) {
+        pattern.patterns_[lifetime.index_] = MemoryBlock(0, 0);
+        continue;
+      }
+
+      overlapping.clear();
+      for (size_t j : placed) {
+        const OrtValueLifetime& other = lifetimes_[j];
+        if (lifetime.alloc_step_ < other.free_step_ && other.alloc_step_ < lifetime.free_step_) {
+          overlapping.push_back(&offsets[j]);
+        }
+      }
+      std::sort(overlapping.begin(), overlapping.end(), [](const MemoryBlock* lhs, const MemoryBlock* rhs) {
+        return lhs->offset_ < rhs->offset_;
+      });
+
+      size_t current = 0;
+      size_t best_offset = std::numeric_limits<size_t>::max();
+      size_t waste_bytes = std::numeric_limits<size_t>::max();
+      for (const MemoryBlock* block : overlapping) {
+        if (block->offset_ > current) {
+          auto gap = block->offset_ - current;
+          if (gap >= lifetime.size_ && (gap - lifetime.size_) < waste_bytes) {
+            waste_bytes = gap - lifetime.size_;
+            best_offset = current;
+          }
+        }
+        current = std::max(current, block->offset_ + block->size_);
+      }
+      if (best_offset == std::numeric_limits<size_t>::max()) {
+        best_offset = current;
+      }
+
+      offsets[i] = MemoryBlock(best_offset, lifetime.size_);
+      placed.push_back(i);
+      pattern.patterns_[lifetime.index_] = offsets[i];
+      pattern.peak_size_ = std::max(pattern.peak_size_, best_offset + lifetime.size_);
+    }
+
+    return pattern;
+  }
+
   struct OrtValueAllocationBlock {
     int index_{-1};
     MemoryBlock block_;
@@ -101,6 +192,9 @@ class MemPatternPlanner {
   // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
   std::list<int> blocks_;
   size_t buffer_size{0};
+  // lifetimes_ the size and allocation/free steps of every traced block, in allocation order
+  std::vector<OrtValueLifetime> lifetimes_;
+  size_t step_{0};
   mutable OrtMutex lock_;
 };
 
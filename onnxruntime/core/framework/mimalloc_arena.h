@@ -17,6 +17,9 @@ class MiMallocArena : public IArenaAllocator {
 
     void* Reserve(size_t size) override;
 
+    // returns the free pages of the mimalloc heaps to the OS
+    Status Shrink() override;
+
     size_t Used() const override;
 
     size_t Max() const override {
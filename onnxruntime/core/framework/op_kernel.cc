@@ -9,10 +9,24 @@
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
+static int GetNodeOffset(const IExecutionFrame* frame, const OpKernel* kernel) {
+  ORT_ENFORCE(frame != nullptr, "Execution frame was null");
+  ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
+  return frame->GetNodeOffset(kernel->Node().Index());
+}
+
 OpKernelContext::OpKernelContext(IExecutionFrame* frame,
                                  const OpKernel* kernel,
                                  concurrency::ThreadPool* threadpool,
                                  const logging::Logger& logger)
+    : OpKernelContext(frame, kernel, GetNodeOffset(frame, kernel), threadpool, logger) {
+}
+
+OpKernelContext::OpKernelContext(IExecutionFrame* frame,
+                                 const OpKernel* kernel,
+                                 int node_offset,
+                                 concurrency::ThreadPool* threadpool,
+                                 const logging::Logger& logger)
     : execution_frame_(frame),
       kernel_(kernel),
       threadpool_(threadpool),
@@ -20,7 +34,7 @@ OpKernelContext::OpKernelContext(IExecutionFrame* frame,
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
 
-  node_input_start_index_ = frame->GetNodeOffset(kernel->Node().Index());
+  node_input_start_index_ = node_offset;
   node_implicit_input_start_index_ = node_input_start_index_ + InputCount();
   node_output_start_index_ = node_implicit_input_start_index_ + ImplicitInputCount();
 }
@@ -35,6 +49,29 @@ SparseTensor* OpKernelContext::Output(int index, size_t nnz, const TensorShape&
   return p_ml_value ? p_ml_value->GetMutable<SparseTensor>() : nullptr;
 }
 
+Tensor* OpKernelContext::OutputView(int index, int input_index, const TensorShape& shape, size_t byte_offset) {
+  if (index < 0 || index >= OutputCount() || input_index < 0 || input_index >= InputCount())
+    return nullptr;
+
+  OrtValue* p_ml_value = nullptr;
+  Status status = execution_frame_->CreateNodeOutputMLValueAsView(GetOutputArgIndex(index),
+                                                                  GetInputArgIndex(input_index),
+                                                                  shape, byte_offset, p_ml_value);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+}
+
+Tensor* OpKernelContext::OutputPackedStrings(int index, const TensorShape& shape, size_t num_chars) {
+  if (index < 0 || index >= OutputCount())
+    return nullptr;
+
+  OrtValue* p_ml_value = nullptr;
+  Status status = execution_frame_->GetOrCreateNodeOutputPackedStrings(GetOutputArgIndex(index), shape, num_chars,
+                                                                       p_ml_value);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+}
+
 OrtValue* OpKernelContext::OutputMLValue(int index, const TensorShape& shape, size_t nnz) {
   if (index < 0 || index >= OutputCount())
     return nullptr;
@@ -65,6 +102,13 @@ Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
   return Status::OK();
 }
 
+Status OpKernelContext::GetScratchAllocator(AllocatorPtr* output) const {
+  *output = execution_frame_->GetScratchAllocator(kernel_->Allocator(0, OrtMemTypeDefault));
+  if (!*output)
+    return GetTempSpaceAllocator(output);
+  return Status::OK();
+}
+
 MLDataType OpKernelContext::InputType(int index) const {
   int input_arg_index = GetInputArgIndex(index);
   const OrtValue* p_ml_value = execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
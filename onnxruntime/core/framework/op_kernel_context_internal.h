@@ -4,6 +4,7 @@
 #pragma once
 
 #include <functional>
+#include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/session/onnxruntime_c_api.h"
@@ -21,10 +22,24 @@ class OpKernelContextInternal : public OpKernelContext {
                                    IExecutionFrame& frame,
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
-                                   const bool& terminate_flag)
-      : OpKernelContext(&frame, &kernel, session_state.GetThreadPool(), logger),
+                                   const bool& terminate_flag,
+                                   DeadlineTimePoint deadline)
+      : OpKernelContextInternal(session_state, frame, kernel, frame.GetNodeOffset(kernel.Node().Index()), logger,
+                                terminate_flag, deadline) {
+  }
+
+  // node_offset is the precomputed offset of the node's values in the frame. See NodeExecutionRecord.
+  OpKernelContextInternal(const SessionState& session_state,
+                          IExecutionFrame& frame,
+                          const OpKernel& kernel,
+                          int node_offset,
+                          const logging::Logger& logger,
+                          const bool& terminate_flag,
+                          DeadlineTimePoint deadline)
+      : OpKernelContext(&frame, &kernel, node_offset, session_state.GetThreadPool(), logger),
         session_state_(session_state),
-        terminate_flag_(terminate_flag) {
+        terminate_flag_(terminate_flag),
+        deadline_(deadline) {
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
     int num_implicit_inputs = static_cast<int>(implicit_inputs.size());
     implicit_input_values_.reserve(num_implicit_inputs);
@@ -41,6 +56,10 @@ class OpKernelContextInternal : public OpKernelContext {
     return session_state_.GetSubgraphSessionState(GetNodeIndex(), attribute_name);
   }
 
+  NodeIndex GetNodeIndex() const {
+    return OpKernelContext::GetNodeIndex();
+  }
+
   const OrtValue* GetInputMLValue(int index) const {
     return OpKernelContext::GetInputMLValue(index);
   }
@@ -60,9 +79,13 @@ class OpKernelContextInternal : public OpKernelContext {
 
   const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
 
+  // the deadline of the run, which the control flow kernels pass to the execution of their subgraphs
+  DeadlineTimePoint GetDeadline() const noexcept { return deadline_; }
+
  private:
   const SessionState& session_state_;
   const bool& terminate_flag_;
+  const DeadlineTimePoint deadline_;
   std::vector<const OrtValue*> implicit_input_values_;
 };
 
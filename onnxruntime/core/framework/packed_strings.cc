@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/packed_strings.h"
+
+namespace onnxruntime {
+
+size_t StringTensorReader::Length(size_t begin, size_t end) const {
+  if (packed_) {
+    return static_cast<size_t>(offsets_[end] - offsets_[begin]);
+  }
+
+  size_t length = 0;
+  for (size_t i = begin; i < end; ++i) {
+    length += strings_[i].size();
+  }
+  return length;
+}
+
+void StringTensorWriter::Append(const StringTensorReader& source, size_t begin, size_t end) {
+  if (packed_ && source.packed_) {
+    const int64_t start = offsets_[next_];
+    const int64_t source_start = source.offsets_[begin];
+    memcpy(chars_ + start, source.chars_ + source_start, static_cast<size_t>(source.offsets_[end] - source_start));
+    for (size_t i = begin; i < end; ++i) {
+      offsets_[++next_] = start + source.offsets_[i + 1] - source_start;
+    }
+    return;
+  }
+
+  for (size_t i = begin; i < end; ++i) {
+    Append(source.Data(i), source.Length(i));
+  }
+}
+
+void UnpackStrings(const Tensor& packed, AllocatorPtr allocator, OrtValue& unpacked) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(packed.DataType(), packed.Shape(), std::move(allocator));
+  StringTensorReader reader(packed);
+  StringTensorWriter writer(*p_tensor);
+  writer.Append(reader, 0, reader.Size());
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  unpacked.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+}
+
+}  // namespace onnxruntime
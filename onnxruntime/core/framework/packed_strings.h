@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+/**
+Reads the strings of a string tensor in place, whether it has std::string elements or is in the packed layout
+(see Tensor::IsPackedStrings), so that kernels registered with KernelDefBuilder::PackedStringInputs can handle both
+without building a std::string per element.
+*/
+class StringTensorReader {
+ public:
+  explicit StringTensorReader(const Tensor& tensor)
+      : packed_(tensor.IsPackedStrings()),
+        strings_(packed_ ? nullptr : tensor.Data<std::string>()),
+        offsets_(packed_ ? tensor.PackedStringOffsets() : nullptr),
+        chars_(packed_ ? tensor.PackedStringChars() : nullptr),
+        size_(static_cast<size_t>(tensor.Shape().Size())) {}
+
+  size_t Size() const noexcept { return size_; }
+
+  bool IsPacked() const noexcept { return packed_; }
+
+  const char* Data(size_t i) const { return packed_ ? chars_ + offsets_[i] : strings_[i].data(); }
+
+  size_t Length(size_t i) const {
+    return packed_ ? static_cast<size_t>(offsets_[i + 1] - offsets_[i]) : strings_[i].size();
+  }
+
+  // The number of characters of the strings [begin, end).
+  size_t Length(size_t begin, size_t end) const;
+
+ private:
+  friend class StringTensorWriter;
+
+  const bool packed_;
+  const std::string* strings_;
+  const int64_t* offsets_;
+  const char* chars_;
+  const size_t size_;
+};
+
+/**
+Writes the strings of a string tensor in order, whether it has std::string elements or is in the packed layout,
+e.g. an output created with OpKernelContext::OutputPackedStrings.
+*/
+class StringTensorWriter {
+ public:
+  explicit StringTensorWriter(Tensor& tensor)
+      : packed_(tensor.IsPackedStrings()),
+        strings_(packed_ ? nullptr : tensor.MutableData<std::string>()),
+        offsets_(packed_ ? tensor.MutablePackedStringOffsets() : nullptr),
+        chars_(packed_ ? tensor.MutablePackedStringChars() : nullptr) {}
+
+  void Append(const char* data, size_t length) {
+    if (packed_) {
+      memcpy(chars_ + offsets_[next_], data, length);
+      offsets_[next_ + 1] = offsets_[next_] + static_cast<int64_t>(length);
+    } else {
+      strings_[next_].assign(data, length);
+    }
+    ++next_;
+  }
+
+  // Appends the strings [begin, end) of source. Copying between packed tensors copies the characters at once.
+  void Append(const StringTensorReader& source, size_t begin, size_t end);
+
+ private:
+  const bool packed_;
+  std::string* strings_;
+  int64_t* offsets_;
+  char* chars_;
+  size_t next_{0};
+};
+
+// The number of characters of the strings of a string tensor.
+inline size_t StringTensorLength(const Tensor& tensor) {
+  StringTensorReader reader(tensor);
+  return reader.Length(0, reader.Size());
+}
+
+// Copies a string tensor in the packed layout into unpacked, a new tensor with std::string elements allocated
+// from allocator, for code that needs the elements as std::string.
+void UnpackStrings(const Tensor& packed, AllocatorPtr allocator, OrtValue& unpacked);
+
+}  // namespace onnxruntime
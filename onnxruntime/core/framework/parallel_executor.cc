@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -14,16 +15,37 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/probes.h"
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+namespace {
+
+// ends the node started on a branch stream when the thread is done with it, also if it failed
+struct BranchNodeEnd {
+  const IExecutionProvider* provider = nullptr;
+
+  ~BranchNodeEnd() {
+    if (provider != nullptr) {
+      ORT_IGNORE_RETURN_VALUE(provider->EndBranchNode());
+    }
+  }
+};
+
+}  // namespace
+
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag,
+                                   DeadlineTimePoint deadline)
+    : out_standings_(0),
+      has_errors_(false),
+      terminate_flag_(terminate_flag),
+      deadline_(deadline),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
+  node_refs_.reset(new std::atomic<size_t>[graph_viewer->MaxNodeIndex()]);
   for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()].store(node.GetInputEdgesCount(), std::memory_order_relaxed);
   }
 }
 
@@ -38,25 +60,59 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     tp = session_state.Profiler().StartTime();
   }
 
+  // the always-on profiler only records one in every N runs
+  lightweight_profiler_ = session_state.GetLightweightProfiler();
+  if (lightweight_profiler_ != nullptr && !lightweight_profiler_->SampleRun()) {
+    lightweight_profiler_ = nullptr;
+  }
+
+  priority_ = concurrency::ThreadPoolPriorityScope::CurrentPriority();
+  max_threads_ = concurrency::ThreadPoolPriorityScope::CurrentMaxThreads();
+
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                  fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
-  for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
+
+  // the branches start after the work queued on the stream of their provider before the run, e.g. to copy the feeds
+  if (!session_state.GetExecutionPlan()->node_branches.empty()) {
+    for (const auto& provider : session_state.GetExecutionProviders()) {
+      if (provider->UsesBranchStreams()) {
+        void* marker = nullptr;
+        ORT_RETURN_IF_ERROR(provider->RecordStreamMarker(&marker));
+        run_start_markers_.emplace(provider.get(), marker);
+      }
+    }
+    if (!run_start_markers_.empty()) {
+      node_markers_.assign(session_state.GetGraphViewer()->MaxNodeIndex(), nullptr);
+    }
+  }
+
+  // start the root nodes on the longest paths first
+  std::vector<NodeIndex> root_nodes = session_state.GetGraphViewer()->GetRootNodes();
+  critical_path_costs_ = session_state.GetNodeCriticalPathCosts();
+  const auto& critical_path_costs = *critical_path_costs_;
+  std::stable_sort(root_nodes.begin(), root_nodes.end(), [&critical_path_costs](NodeIndex a, NodeIndex b) {
+    return critical_path_costs[a] > critical_path_costs[b];
+  });
+
+  for (auto node_index : root_nodes) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
     EnqueueNode(node_index, session_state, logger);
   }
 
   // Wait for finish.
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
-    while (out_standings_ > 0) complete_cv_.wait(lock);
+    while (out_standings_.load(std::memory_order_acquire) > 0) complete_cv_.wait(lock);
   }
 
-  Status status = Status::OK();
+  Status status = JoinBranches(session_state, !errors_.empty());
+  if (!status.IsOK()) {
+    std::lock_guard<OrtMutex> lock(error_mutex_);
+    errors_.push_back(status);
+  }
 
   if (!errors_.empty()) {
     if (errors_.size() == 1)
@@ -80,8 +136,9 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   // ExecutionFrame::Finalize will update 'fetches' with the final output
   ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
   VLOGS(logger, 1) << "Done execution.";
+  peak_allocated_bytes_ = root_frame_->GetPeakAllocatedBytes();
 
-  if (root_frame_->HasMemoryPatternPlanner()) {
+  if (root_frame_->ShouldCacheMemoryPatterns()) {
     std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -96,7 +153,8 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     if (all_tensors) {
       auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns),
+                                                                     root_frame_->GetMemoryPatterns()));
     }
   }
 
@@ -121,6 +179,9 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  // the costs the run started with, which a runtime profile may have replaced since
+  const auto& critical_path_costs = *critical_path_costs_;
+  std::vector<size_t> ready_nodes;
 
   // Avoid context switching if possible.
   while (keep_running) {
@@ -131,6 +192,11 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       ORT_THROW("Exiting due to terminate flag being set to true.");
     }
 
+    if (deadline_ != DeadlineTimePoint::max() && std::chrono::steady_clock::now() > deadline_) {
+      LOGS(logger, WARNING) << "Exiting due to the deadline of the run having passed.";
+      ORT_THROW("Exiting due to the deadline of the run having passed.");
+    }
+
     const auto* p_op_kernel = session_state.GetKernel(node_index);
     const auto& node = *graph_viewer->GetNode(node_index);
 
@@ -139,7 +205,33 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
     }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_,
+                                              deadline_);
+
+    // queue the work of the node on the stream of its branch, after the work of its producers on other branches
+    const IExecutionProvider* provider = p_op_kernel->Info().GetExecutionProvider();
+    const bool on_branch_stream = !run_start_markers_.empty() && run_start_markers_.count(provider) != 0;
+    const int branch = on_branch_stream ? exec_plan.node_branches[node_index] : -1;
+    BranchNodeEnd branch_node_end;
+    if (on_branch_stream) {
+      std::vector<void*> wait_markers;
+      bool has_producer = false;
+      for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+        const NodeIndex producer = it->GetNode().Index();
+        if (session_state.GetKernel(producer)->Info().GetExecutionProvider() != provider) {
+          continue;
+        }
+        has_producer = true;
+        if (exec_plan.node_branches[producer] != branch) {
+          wait_markers.push_back(node_markers_[producer]);
+        }
+      }
+      if (!has_producer) {
+        wait_markers.push_back(run_start_markers_.at(provider));
+      }
+      ORT_THROW_IF_ERROR(provider->StartBranchNode(branch, wait_markers));
+      branch_node_end.provider = provider;
+    }
 
     if (f_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -189,11 +281,35 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
-    // Execute the kernel.
-    try {
-      status = p_op_kernel->Compute(&op_kernel_context);
-    } catch (const std::exception& ex) {
-      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    std::chrono::high_resolution_clock::time_point lightweight_begin_time;
+    concurrency::ParallelForStats parallel_for_stats;
+    {
+      // collect the utilization of the intra op thread pool by the node
+      concurrency::ParallelForStatsScope parallel_for_stats_scope(
+          lightweight_profiler_ != nullptr ? &parallel_for_stats : nullptr);
+      if (lightweight_profiler_ != nullptr) {
+        lightweight_begin_time = std::chrono::high_resolution_clock::now();
+      }
+
+      // Execute the kernel.
+      if (f_profiler_enabled) {
+        p_op_kernel->Info().GetExecutionProvider()->StartNodeProfiling(node, session_state.Profiler());
+      }
+      ORT_PROBE4(node_start, &session_state, node_index, node.OpType().c_str(), node.Name().c_str());
+      try {
+        status = p_op_kernel->Compute(&op_kernel_context);
+      } catch (const std::exception& ex) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      }
+      ORT_PROBE4(node_end, &session_state, node_index, node.OpType().c_str(), status.Code());
+      if (f_profiler_enabled) {
+        p_op_kernel->Info().GetExecutionProvider()->EndNodeProfiling(node);
+      }
+    }
+
+    if (lightweight_profiler_ != nullptr) {
+      lightweight_profiler_->RecordNodeEvent(op_kernel_context, lightweight_begin_time,
+                                             std::chrono::high_resolution_clock::now(), parallel_for_stats);
     }
 
     if (!status.IsOK()) {
@@ -245,6 +361,28 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
     }
 
+    if (on_branch_stream) {
+      // mark the work of the node for the consumers on other branches and the join at the end of the run
+      bool cross_branch = false;
+      bool continued = false;
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        const NodeIndex consumer = it->GetNode().Index();
+        if (session_state.GetKernel(consumer)->Info().GetExecutionProvider() != provider) {
+          continue;
+        }
+        if (exec_plan.node_branches[consumer] == branch) {
+          continued = true;
+        } else {
+          cross_branch = true;
+        }
+      }
+      if (cross_branch || !continued) {
+        ORT_THROW_IF_ERROR(provider->RecordStreamMarker(&node_markers_[node_index]));
+      }
+      branch_node_end.provider = nullptr;
+      ORT_THROW_IF_ERROR(provider->EndBranchNode());
+    }
+
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
     keep_running = false;
@@ -254,21 +392,40 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       auto begin = node.OutputEdgesBegin();
       auto end = node.OutputEdgesEnd();
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
+      ready_nodes.clear();
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
+        // acq_rel so the thread that runs the consumer sees the outputs of all its producers
+        if (node_refs_[idx].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          ready_nodes.push_back(idx);
+        }
+      }
+
+      if (!ready_nodes.empty()) {
+        // continue with the ready node on the longest remaining path on this thread, and enqueue the rest with
+        // the cheapest first. a worker runs the most recently enqueued task from its own queue first, and other
+        // workers steal from the other end, so this favors the more expensive paths.
+        std::sort(ready_nodes.begin(), ready_nodes.end(), [&critical_path_costs](size_t a, size_t b) {
+          return critical_path_costs[a] < critical_path_costs[b];
+        });
+
+        if (on_branch_stream) {
+          // continue the branch of the node on this thread, so that it keeps queuing on the same stream
+          auto same_branch = std::find_if(ready_nodes.begin(), ready_nodes.end(), [&exec_plan, branch](size_t idx) {
+            return exec_plan.node_branches[idx] == branch;
+          });
+          if (same_branch != ready_nodes.end()) {
+            std::iter_swap(same_branch, ready_nodes.end() - 1);
           }
         }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+        node_index = ready_nodes.back();
+        keep_running = true;
+        ready_nodes.pop_back();
+
+        for (auto idx : ready_nodes) {
+          EnqueueNode(idx, session_state, logger);
+        }
       }
     }
   }
@@ -276,15 +433,40 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   return status;
 }
 
+Status ParallelExecutor::JoinBranches(const SessionState& session_state, bool failed) {
+  Status status;
+  if (failed) {
+    // the nodes that were not run did not mark the ends of their branches
+    for (const auto& entry : run_start_markers_) {
+      if (status.IsOK()) {
+        status = entry.first->Sync();
+      }
+    }
+  }
+  for (size_t node_index = 0; node_index < node_markers_.size(); ++node_index) {
+    void* marker = node_markers_[node_index];
+    if (marker != nullptr) {
+      const auto* provider = session_state.GetKernel(node_index)->Info().GetExecutionProvider();
+      if (status.IsOK()) {
+        status = provider->WaitForStreamMarker(marker);
+      }
+      provider->ReleaseStreamMarker(marker);
+      node_markers_[node_index] = nullptr;
+    }
+  }
+  for (auto& entry : run_start_markers_) {
+    entry.first->ReleaseStreamMarker(entry.second);
+  }
+  run_start_markers_.clear();
+  return status;
+}
+
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
+  // if there are errors there's no point queuing more work
+  if (has_errors_.load(std::memory_order_relaxed))
+    return;
 
-    out_standings_++;
-  }
+  out_standings_.fetch_add(1, std::memory_order_relaxed);
 
   executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
@@ -295,6 +477,8 @@ void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& sess
                              ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
     };
 
+    concurrency::ThreadPoolPriorityScope priority_scope(priority_, max_threads_);
+
     Status status;
     try {
       status = ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
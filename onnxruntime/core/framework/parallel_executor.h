@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 #include "core/common/common.h"
 #include "core/common/status.h"
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ml_value.h"
@@ -21,7 +24,8 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false,
+                   DeadlineTimePoint deadline = DeadlineTimePoint::max());
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -36,31 +40,60 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // makes the streams of the providers wait for the branches, or the devices if the run failed, and releases the
+  // markers
+  Status JoinBranches(const SessionState& session_state, bool failed);
+
   void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
-      std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
+    if (!status.IsOK()) {
+      std::lock_guard<OrtMutex> lock(error_mutex_);
+      errors_.push_back(status);
+      has_errors_.store(true, std::memory_order_relaxed);
+    }
+
+    // only the last node can bring the count to zero, and there are no more nodes to enqueue once it's 1
+    int out_standings = out_standings_.load(std::memory_order_relaxed);
+    while (out_standings > 1) {
+      if (out_standings_.compare_exchange_weak(out_standings, out_standings - 1, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+        return;
+      }
     }
 
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
+    // the final decrement and the notification happen under the lock. the waiter returns and may destroy the
+    // executor as soon as it sees zero, which it checks with the lock held, so this thread must not touch the
+    // executor after releasing it.
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    if (out_standings_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
       complete_cv_.notify_all();
     }
   }
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // number of unfinished input edges for each node. a node is ready when its count drops to zero.
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+  // the marker of the work queued before the run on the stream of each provider that runs the branches of the plan
+  // on streams of their own, see IExecutionProvider::UsesBranchStreams
+  std::unordered_map<const IExecutionProvider*, void*> run_start_markers_;
+  // the marker of the work of each node on a branch stream whose outputs are consumed on another branch or which
+  // ends its branch, keyed by node index. set by the thread running the node before it releases the consumers.
+  std::vector<void*> node_markers_;
+  std::atomic<int> out_standings_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::atomic<bool> has_errors_;
+  OrtMutex error_mutex_;
+  std::vector<Status> errors_;  //protected by error_mutex_
 
   const bool& terminate_flag_;
+  const DeadlineTimePoint deadline_;
+  // the thread pool priority of the thread calling Execute, which the nodes run with
+  concurrency::ThreadPoolPriority priority_ = concurrency::ThreadPoolPriority::kNormal;
+  int max_threads_ = 0;
+  // set for the runs that the always-on profiler samples
+  profiling::LightweightProfiler* lightweight_profiler_ = nullptr;
+  // the critical path costs of the session when the run started, see SessionState::GetNodeCriticalPathCosts
+  std::shared_ptr<const std::vector<int64_t>> critical_path_costs_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
   onnxruntime::concurrency::ThreadPool* const executor_pool_{};
 };
@@ -53,3 +53,31 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetShrinkMemoryArenas, _Inout_ OrtRunOptions* options, int shrink) {
+  options->shrink_memory_arenas = shrink != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetPriority, _Inout_ OrtRunOptions* options, OrtRunPriority priority) {
+  switch (priority) {
+    case ORT_RUN_PRIORITY_HIGH:
+    case ORT_RUN_PRIORITY_NORMAL:
+    case ORT_RUN_PRIORITY_LOW:
+      options->priority = priority;
+      break;
+    default:
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "priority is not valid");
+  }
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetDeadline, _Inout_ OrtRunOptions* options, int64_t timeout_us) {
+  if (timeout_us < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The timeout can't be negative.");
+  }
+  options->deadline = timeout_us == 0
+                          ? std::chrono::steady_clock::time_point::max()
+                          : std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+  return nullptr;
+}
@@ -0,0 +1,228 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/runtime_profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+#include "core/framework/lightweight_profiler.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// the first line of the file
+constexpr const char* kFileHeader = "onnxruntime runtime profile 1";
+
+// the rest of the line after the value the stream is at, without the separating space
+std::string ReadName(std::istringstream& values) {
+  std::string name;
+  values.get();
+  std::getline(values, name);
+  return name;
+}
+
+}  // namespace
+
+Status RuntimeProfile::Load(const std::string& path, RuntimeProfile& profile) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kFileHeader) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Runtime profile ", path,
+                           " was written by a different version or is not a profile file");
+  }
+
+  // each line is a record type followed by its values:
+  //   runs <number of runs>
+  //   input <name>
+  //   shapes <runs> then the rank and dims of each input
+  //   node <mean ns> <output bytes> <name>
+  RuntimeProfile result;
+  while (std::getline(file, line)) {
+    std::istringstream values(line);
+    std::string type;
+    values >> type;
+    if (type == "runs") {
+      values >> result.num_runs;
+    } else if (type == "input") {
+      result.input_names.push_back(ReadName(values));
+    } else if (type == "shapes") {
+      uint32_t runs = 0;
+      values >> runs;
+      std::vector<std::vector<int64_t>> shapes(result.input_names.size());
+      for (auto& shape : shapes) {
+        size_t rank = 0;
+        values >> rank;
+        shape.resize(rank);
+        for (auto& dim : shape) {
+          values >> dim;
+        }
+      }
+      result.input_shapes[shapes] = runs;
+    } else if (type == "node") {
+      NodeProfile node;
+      values >> node.mean_ns >> node.output_bytes;
+      auto name = ReadName(values);
+      result.nodes[name] = node;
+    } else {
+      values.setstate(std::ios::failbit);
+    }
+
+    if (values.fail()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Runtime profile ", path, " is corrupted");
+    }
+  }
+
+  profile = std::move(result);
+  return Status::OK();
+}
+
+Status RuntimeProfile::Save(const std::string& path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", path, " to write the runtime profile");
+  }
+
+  file << kFileHeader << "\n";
+  file << "runs " << num_runs << "\n";
+  for (const auto& name : input_names) {
+    file << "input " << name << "\n";
+  }
+  for (const auto& entry : input_shapes) {
+    file << "shapes " << entry.second;
+    for (const auto& shape : entry.first) {
+      file << " " << shape.size();
+      for (auto dim : shape) {
+        file << " " << dim;
+      }
+    }
+    file << "\n";
+  }
+  for (const auto& entry : nodes) {
+    file << "node " << entry.second.mean_ns << " " << entry.second.output_bytes << " " << entry.first << "\n";
+  }
+
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the runtime profile to ", path);
+  }
+
+  return Status::OK();
+}
+
+void ApplyRuntimeProfile(const RuntimeProfile& profile, SessionState& session_state) {
+  const auto& graph_viewer = *session_state.GetGraphViewer();
+
+  // the nodes that didn't run in the recorded runs, or that are not in the profile because it was recorded for
+  // another version of the model, cost nothing. a profile that matches none of the nodes is ignored.
+  std::vector<int64_t> node_costs(graph_viewer.MaxNodeIndex(), 0);
+  size_t num_measured_nodes = 0;
+  for (const auto& node : graph_viewer.Nodes()) {
+    auto entry = profile.nodes.find(node.Name());
+    if (entry != profile.nodes.end()) {
+      node_costs[node.Index()] = entry->second.mean_ns;
+      ++num_measured_nodes;
+    }
+  }
+  if (num_measured_nodes > 0) {
+    session_state.SetNodeCosts(node_costs);
+  }
+
+  // the cache holds a pattern per set of input shapes. if the shapes seen round up to fewer sets, planning the
+  // memory once per bucket saves both the planning runs and the memory of the patterns.
+  bool shape_bucketing = false;
+  if (session_state.GetEnableMemoryPattern() && !session_state.GetMemoryPatternShapeBucketing()) {
+    std::set<std::vector<std::vector<int64_t>>> buckets;
+    for (const auto& entry : profile.input_shapes) {
+      auto shapes = entry.first;
+      for (auto& shape : shapes) {
+        std::transform(shape.begin(), shape.end(), shape.begin(), SessionState::BucketMemoryPatternDim);
+      }
+      buckets.insert(std::move(shapes));
+    }
+
+    if (buckets.size() < profile.input_shapes.size()) {
+      shape_bucketing = true;
+      session_state.SetMemoryPatternCacheOptions(true, session_state.GetMemoryPatternCacheCapacity());
+    }
+  }
+
+  LOGS(session_state.Logger(), INFO) << "Applied the runtime profile of " << profile.num_runs << " runs. Measured "
+                                     << num_measured_nodes << " of " << graph_viewer.NumberOfNodes()
+                                     << " nodes, saw " << profile.input_shapes.size() << " sets of input shapes"
+                                     << (shape_bucketing ? " and enabled memory pattern shape bucketing." : ".");
+}
+
+RuntimeProfileRecorder::RuntimeProfileRecorder(const profiling::LightweightProfiler& profiler, uint32_t num_runs,
+                                               std::function<void(const RuntimeProfile&)> on_recorded)
+    : profiler_(profiler), num_runs_(num_runs), on_recorded_(std::move(on_recorded)) {
+  ORT_ENFORCE(num_runs_ > 0, "The runtime profile must record at least one run");
+}
+
+RuntimeProfileRecorder::~RuntimeProfileRecorder() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void RuntimeProfileRecorder::RecordRun(const std::vector<std::string>& feed_names,
+                                       const std::vector<OrtValue>& feeds) {
+  if (done_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // the shapes are recorded in the order of the names so the order of the feeds doesn't matter
+  std::vector<size_t> order(feed_names.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&feed_names](size_t a, size_t b) { return feed_names[a] < feed_names[b]; });
+
+  std::vector<std::string> names;
+  std::vector<std::vector<int64_t>> shapes;
+  names.reserve(order.size());
+  shapes.reserve(order.size());
+  for (auto i : order) {
+    names.push_back(feed_names[i]);
+    // the shapes of the inputs that are not tensors are left empty
+    shapes.push_back(feeds[i].IsTensor() ? feeds[i].Get<Tensor>().Shape().GetDimsAsVector() : std::vector<int64_t>{});
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (done_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // the first run decides the inputs. the shapes of the runs that feed other inputs are not recorded.
+  if (profile_.num_runs == 0) {
+    profile_.input_names = names;
+  }
+  if (names == profile_.input_names) {
+    ++profile_.input_shapes[shapes];
+  }
+
+  if (++profile_.num_runs < num_runs_) {
+    return;
+  }
+
+  done_.store(true, std::memory_order_release);
+  thread_ = std::thread([this]() {
+    // the statistics are aggregated here rather than in the run that completed the profile
+    for (const auto& entry : profiler_.GetNodeStatistics()) {
+      const auto& stats = entry.second;
+      if (stats.count == 0) continue;
+      auto& node = profile_.nodes[entry.first];
+      node.mean_ns = stats.total_ns / static_cast<int64_t>(stats.count);
+      node.output_bytes = stats.output_bytes / stats.count;
+    }
+    on_recorded_(profile_);
+  });
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class SessionState;
+
+namespace profiling {
+class LightweightProfiler;
+}
+
+/**
+ * What a session observed over its first runs, see SessionOptions::runtime_profile_runs. It is saved to and loaded
+ * from a text file so later sessions of the same model start from it.
+ */
+struct RuntimeProfile {
+  struct NodeProfile {
+    int64_t mean_ns = 0;
+    // per run
+    uint64_t output_bytes = 0;
+  };
+
+  uint32_t num_runs = 0;
+  // names of the graph inputs the shapes are recorded for, sorted
+  std::vector<std::string> input_names;
+  // the shapes of input_names in a run, and the number of runs they were seen in
+  std::map<std::vector<std::vector<int64_t>>, uint32_t> input_shapes;
+  // keyed by node name
+  std::map<std::string, NodeProfile> nodes;
+
+  // a missing file is not an error, it leaves the profile empty
+  static Status Load(const std::string& path, RuntimeProfile& profile);
+
+  Status Save(const std::string& path) const;
+};
+
+/**
+ * Re-plan the session from the profile: the critical path costs the ParallelExecutor starts the nodes by are
+ * computed from the measured kernel times, and shape bucketing is enabled in the memory pattern cache if it
+ * would have shared the patterns of the shapes that were seen. Safe to call while the session runs.
+ */
+void ApplyRuntimeProfile(const RuntimeProfile& profile, SessionState& session_state);
+
+/**
+ * Records the input shapes of the first num_runs runs of a session, and the node statistics of the lightweight
+ * profiler of the session. Once num_runs runs were recorded, on_recorded is called with the profile from a
+ * background thread so the run that completes the profile isn't delayed by the re-planning.
+ */
+class RuntimeProfileRecorder {
+ public:
+  RuntimeProfileRecorder(const profiling::LightweightProfiler& profiler, uint32_t num_runs,
+                         std::function<void(const RuntimeProfile&)> on_recorded);
+
+  // waits for on_recorded to return
+  ~RuntimeProfileRecorder();
+
+  // record the feeds of a run that succeeded. free once num_runs runs were recorded.
+  void RecordRun(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RuntimeProfileRecorder);
+
+  const profiling::LightweightProfiler& profiler_;
+  const uint32_t num_runs_;
+  const std::function<void(const RuntimeProfile&)> on_recorded_;
+
+  std::atomic<bool> done_{false};
+  OrtMutex mutex_;
+  RuntimeProfile profile_;  // protected by mutex_
+
+  std::thread thread_;
+};
+
+}  // namespace onnxruntime
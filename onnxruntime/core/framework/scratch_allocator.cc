@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/scratch_allocator.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+constexpr size_t ScratchAllocator::kAlignment;
+constexpr int ScratchAllocator::kOffsetBits;
+constexpr uint64_t ScratchAllocator::kOffsetMask;
+constexpr uint64_t ScratchAllocator::kOneAllocation;
+
+ScratchAllocator::ScratchAllocator(AllocatorPtr allocator, size_t capacity)
+    : allocator_(std::move(allocator)),
+      buffer_(capacity > 0 ? allocator_->Alloc(capacity) : nullptr),
+      // a failed allocation of the buffer leaves every allocation to allocator_
+      capacity_(buffer_ != nullptr ? capacity : 0) {
+}
+
+ScratchAllocator::~ScratchAllocator() {
+  if (buffer_ != nullptr) {
+    allocator_->Free(buffer_);
+  }
+}
+
+void* ScratchAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  const uint64_t aligned_size = (static_cast<uint64_t>(size) + kAlignment - 1) & ~uint64_t{kAlignment - 1};
+  ORT_ENFORCE(aligned_size <= kOffsetMask, "Scratch allocation of ", size, " bytes is too large");
+
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t offset;
+  uint64_t end;
+  // acquire the memory the last user of the range released
+  do {
+    offset = state & kOffsetMask;
+    end = std::min(offset + aligned_size, kOffsetMask);
+    ORT_ENFORCE((state >> kOffsetBits) + 1 < (uint64_t{1} << (64 - kOffsetBits)), "Too many live scratch allocations");
+    // an allocation that does not fit leaves the offset alone, so that the concurrent kernels of a parallel run
+    // cannot push it, and the peak, further than one allocation past the buffer
+  } while (!state_.compare_exchange_weak(state,
+                                         (state & ~kOffsetMask) + kOneAllocation + (end <= capacity_ ? end : offset),
+                                         std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (end > peak && !peak_bytes_.compare_exchange_weak(peak, static_cast<size_t>(end), std::memory_order_relaxed)) {
+  }
+
+  if (end <= capacity_) {
+    return static_cast<char*>(buffer_) + offset;
+  }
+
+  void* p = nullptr;
+  try {
+    p = allocator_->Alloc(size);
+  } catch (...) {
+    Release();
+    throw;
+  }
+  if (p == nullptr) {
+    Release();
+  }
+  return p;
+}
+
+void ScratchAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  const char* ptr = static_cast<const char*>(p);
+  const char* buffer = static_cast<const char*>(buffer_);
+  if (buffer == nullptr || ptr < buffer || ptr >= buffer + capacity_) {
+    allocator_->Free(p);
+  }
+  Release();
+}
+
+void ScratchAllocator::Release() {
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t new_state;
+  do {
+    ORT_ENFORCE(state >= kOneAllocation, "Unmatched scratch Free");
+    new_state = state - kOneAllocation;
+    if (new_state < kOneAllocation) {
+      // no live allocation left, the next one starts at the beginning of the buffer
+      new_state = 0;
+    }
+  } while (!state_.compare_exchange_weak(state, new_state, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+}  // namespace onnxruntime
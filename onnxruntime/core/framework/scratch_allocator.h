@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+// Bump allocator for the temporaries the kernels allocate and free during one Run, see
+// OpKernelContext::GetScratchAllocator. The allocations are carved from one buffer, and the buffer is reused from
+// the start once all of them are freed, which happens between the kernels of a sequential run. The allocations
+// past the end of the buffer are served by the underlying allocator, and PeakBytes() tells how large the buffer
+// has to be for them to fit.
+// Thread-safe: the parallel executor runs several kernels of a Run at once.
+class ScratchAllocator : public IAllocator {
+ public:
+  // capacity may be 0, all the allocations then go to allocator
+  ScratchAllocator(AllocatorPtr allocator, size_t capacity);
+  ~ScratchAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  const OrtMemoryInfo& Info() const override { return allocator_->Info(); }
+
+  // The largest end offset the allocations needed, the buffer size for them to fit in a later Run.
+  size_t PeakBytes() const { return peak_bytes_.load(std::memory_order_relaxed); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScratchAllocator);
+
+  static constexpr size_t kAlignment = 64;
+  // the state packs the offset of the next allocation in its low bits and the number of live allocations, including
+  // the ones served by allocator_, in its high bits.
+  static constexpr int kOffsetBits = 40;
+  static constexpr uint64_t kOffsetMask = (uint64_t{1} << kOffsetBits) - 1;
+  static constexpr uint64_t kOneAllocation = uint64_t{1} << kOffsetBits;
+
+  // Removes a live allocation, rewinding the buffer when it was the last one.
+  void Release();
+
+  AllocatorPtr allocator_;
+  void* buffer_;
+  const size_t capacity_;
+  std::atomic<uint64_t> state_{0};
+  std::atomic<size_t> peak_bytes_{0};
+};
+
+}  // namespace onnxruntime
@@ -28,9 +28,23 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // viewed_value is valid only if it's not -1. It indicates the OrtValue that the kernel may create this
+  // tensor as a view into instead of allocating it (see KernelDefBuilder::MayView).
+  OrtValueIndex viewed_value{-1};
+  // container is valid only if it's not -1. It indicates the OrtValue whose buffer this tensor is allocated in,
+  // container_bytes bytes starting at container_offset, so that e.g. the producer of a Concat input writes it
+  // directly into the Concat output.
+  OrtValueIndex container{-1};
+  size_t container_offset{0};
+  size_t container_bytes{0};
+  // the shape to allocate a container with when a tensor in it is allocated before the container is produced.
+  std::vector<int64_t> container_shape;
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
+  // a string tensor may be created in the packed layout (see Tensor::IsPackedStrings) as all the kernels reading it
+  // are registered with KernelDefBuilder::PackedStringInputs. graph outputs always have std::string elements.
+  bool packed_strings{false};
 
  public:
   AllocPlanPerValue() : location(CPU, Invalid) {}
@@ -69,6 +83,11 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // Records whether a given node has fence on its input or output, key is node index.
   std::vector<bool> node_has_fence;
 
+  // The branch of each node for parallel execution, key is node index. A node continues the branch of one of its
+  // producers, so that a chain of nodes is one branch, and the branches only meet where a node consumes the outputs
+  // of several. A provider may run the branches on separate device streams. Empty for sequential execution.
+  std::vector<int> node_branches;
+
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
@@ -14,6 +14,7 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/probes.h"
 
 // Define this symbol to create Concurrency Visualizer markers.
 // See https://docs.microsoft.com/en-us/visualstudio/profiling/concurrency-visualizer-sdk
@@ -45,7 +46,7 @@ namespace onnxruntime {
 
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
-                                  const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                                  const NodeExecutionRecord& record,
                                   const logging::Logger& logger);
 
 Status SequentialExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
@@ -66,14 +67,26 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
-  const auto& exec_plan_vec = seq_exec_plan.execution_plan;
-  VLOGS(logger, 1) << "Size of execution plan vector: " << exec_plan_vec.size();
+  // the kernel, value offsets and fence and release information of each node are looked up once per session
+  const auto& node_records = session_state.GetNodeExecutionRecords();
+  VLOGS(logger, 1) << "Size of execution plan vector: " << seq_exec_plan.execution_plan.size();
+  ORT_RETURN_IF_NOT(node_records.size() == seq_exec_plan.execution_plan.size(),
+                    "The node execution records don't match the execution plan.");
+
+  // nodes that only contribute to outputs that weren't requested are skipped
+  const std::vector<bool>* nodes_to_execute = session_state.GetNodesToExecute(fetch_mlvalue_idxs);
+
+  // the always-on profiler only records one in every N runs
+  auto* lightweight_profiler = session_state.GetLightweightProfiler();
+  if (lightweight_profiler != nullptr && !lightweight_profiler->SampleRun()) {
+    lightweight_profiler = nullptr;
+  }
 
   // uncomment the line below to dump execution plan
   //std::cout << std::make_pair(p_seq_exec_plan, &session_state) << "\n";
-  const auto* graph_viewer = session_state.GetGraphViewer();
 
 #ifdef CONCURRENCY_VISUALIZER
+  const auto* graph_viewer = session_state.GetGraphViewer();
   // need unique name for the series. number of nodes should be good enough for a subgraph
   char series_name[MaxSeriesNameLengthInChars] = "MainGraph";
   if (graph_viewer->IsSubgraph()) {
@@ -84,20 +97,31 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   diagnostic::marker_series series(series_name);
 #endif
 
-  for (const auto& node_exec_plan : exec_plan_vec) {
+  for (const auto& record : node_records) {
     if (terminate_flag_) {
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
     }
 
-    auto node_index = node_exec_plan.node_index;
-    const auto& node = *graph_viewer->GetNode(node_exec_plan.node_index);
+    if (deadline_ != DeadlineTimePoint::max() && std::chrono::steady_clock::now() > deadline_) {
+      LOGS(logger, WARNING) << "Exiting due to the deadline of the run having passed.";
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the deadline of the run having passed.");
+    }
+
+    auto node_index = record.node_index;
+    if (nodes_to_execute != nullptr && !(*nodes_to_execute)[node_index]) {
+      // values produced by the executed nodes can still be freed at this step
+      ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, record, logger));
+      continue;
+    }
+
+    const auto& node = *record.node;
 
 #ifdef CONCURRENCY_VISUALIZER
     series.write_flag(node.Name().c_str());
 #endif
 
-    auto p_op_kernel = session_state.GetKernel(node_index);
+    auto p_op_kernel = record.kernel;
 
     // if a kernel has been added in the session state, it better be NON-null.
     if (p_op_kernel == nullptr)
@@ -109,7 +133,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 #endif
     // construct OpKernelContext
     // TODO: log kernel inputs?
-    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, record.node_offset, logger,
+                                              terminate_flag_, deadline_);
     // TODO: log kernel outputs?
     if (is_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -117,7 +142,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
     // sync before compute
     int queue_id = p_op_kernel->KernelDef().ExecQueueId();
-    if (seq_exec_plan.NodeHasFence(node_index)) {
+    if (record.has_fence) {
       for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
         Fence_t fence = op_kernel_context.InputFence(input_index);
         if (fence) {
@@ -168,11 +193,34 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       diagnostic::span span(series, "%s.%d", node.OpType().c_str(), node.Index());
 #endif
       Status compute_status;
+      std::chrono::high_resolution_clock::time_point lightweight_begin_time;
+      concurrency::ParallelForStats parallel_for_stats;
+      {
+        // collect the utilization of the intra op thread pool by the node
+        concurrency::ParallelForStatsScope parallel_for_stats_scope(
+            lightweight_profiler != nullptr ? &parallel_for_stats : nullptr);
+        if (lightweight_profiler != nullptr) {
+          lightweight_begin_time = std::chrono::high_resolution_clock::now();
+        }
+
+        if (is_profiler_enabled) {
+          p_op_kernel->Info().GetExecutionProvider()->StartNodeProfiling(node, session_state.Profiler());
+        }
+        ORT_PROBE4(node_start, &session_state, node_index, node.OpType().c_str(), node.Name().c_str());
+        try {
+          compute_status = p_op_kernel->Compute(&op_kernel_context);
+        } catch (const std::exception& ex) {
+          compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        }
+        ORT_PROBE4(node_end, &session_state, node_index, node.OpType().c_str(), compute_status.Code());
+        if (is_profiler_enabled) {
+          p_op_kernel->Info().GetExecutionProvider()->EndNodeProfiling(node);
+        }
+      }
 
-      try {
-        compute_status = p_op_kernel->Compute(&op_kernel_context);
-      } catch (const std::exception& ex) {
-        compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      if (lightweight_profiler != nullptr) {
+        lightweight_profiler->RecordNodeEvent(op_kernel_context, lightweight_begin_time,
+                                              std::chrono::high_resolution_clock::now(), parallel_for_stats);
       }
 
       if (!compute_status.IsOK()) {
@@ -198,7 +246,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 
     // sync after compute for outputs
-    if (seq_exec_plan.NodeHasFence(node_index)) {
+    if (record.has_fence) {
       for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
         Fence_t fence = op_kernel_context.InputFence(input_index);
         if (fence) {
@@ -246,15 +294,17 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
     // free ml-values corresponding to this node
     VLOGS(logger, 1) << "Releasing node ML values after computing kernel: " << p_op_kernel->Node().Name();
-    ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
+    ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, record, logger));
   }
 
   VLOGS(logger, 1) << "Fetching output.";
   // ExecutionFrame::Finalize will update 'fetches' with the final output
   ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
   VLOGS(logger, 1) << "Done with execution.";
+  peak_allocated_bytes_ = frame.GetPeakAllocatedBytes();
 
-  if (frame.HasMemoryPatternPlanner()) {
+  // the patterns are cached by input shapes only, so don't cache the partial patterns of a run that skipped nodes
+  if (frame.ShouldCacheMemoryPatterns() && nodes_to_execute == nullptr) {
     std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -269,7 +319,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     if (all_tensors) {
       auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns),
+                                                                     frame.GetMemoryPatterns()));
     }
   }
 
@@ -282,9 +333,9 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
-                                  const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
+                                  const NodeExecutionRecord& record,
                                   const logging::Logger& logger) {
-  for (auto i = node_exec_plan.free_from_index; i <= node_exec_plan.free_to_index; ++i) {
+  for (auto i = record.free_from_index; i <= record.free_to_index; ++i) {
     auto ort_value_idx = seq_exec_plan.to_be_freed[i];
     VLOGS(logger, 1) << "Releasing ort_value with index: " << ort_value_idx;
     ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(ort_value_idx));
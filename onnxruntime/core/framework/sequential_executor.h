@@ -17,7 +17,8 @@
 namespace onnxruntime {
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
+  SequentialExecutor(const bool& terminate_flag = false, DeadlineTimePoint deadline = DeadlineTimePoint::max())
+      : terminate_flag_{terminate_flag}, deadline_{deadline} {}
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -28,5 +29,6 @@ class SequentialExecutor : public IExecutor {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
   const bool& terminate_flag_;
+  const DeadlineTimePoint deadline_;
 };
 }  // namespace onnxruntime
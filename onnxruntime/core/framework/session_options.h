@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include "core/session/onnxruntime_c_api.h"
@@ -24,6 +25,8 @@ struct SessionOptions {
   bool enable_profiling = false;
 
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
+  // the saved model records its optimization level and execution providers in its metadata, and a session with
+  // the same providers that loads it skips the graph optimizers up to that level.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
   // enable the memory pattern optimization.
@@ -33,11 +36,123 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // round input dims up to the next power of two when looking up a cached memory pattern, so that inputs with
+  // similar shapes (e.g. varying sequence lengths) share a pattern instead of each creating a new cache entry.
+  bool mem_pattern_shape_bucketing = false;
+
+  // maximum number of memory patterns cached per graph. the least recently used pattern is evicted when
+  // the limit is reached. 0 means unbounded.
+  size_t mem_pattern_cache_capacity = 0;
+
+  // execute the nodes in a topological order chosen to reduce the peak size of the live intermediate tensors,
+  // instead of the default topological order. the order is only used if it lowers the peak estimated from the
+  // inferred shapes. only applies to the sequential executor.
+  bool enable_memory_efficient_order = false;
+
+  // if > 0, the activations of CUDA nodes of at least this many bytes that are kept alive across many nodes are
+  // copied to pinned host memory after their early uses and copied back before their late uses, releasing the device
+  // buffer in between. this trades copy time for a lower peak device memory. 0 disables the offloading.
+  size_t activation_offload_min_bytes = 0;
+
+  // if all the graph inputs have fixed shapes (from the model or free_dimension_overrides), compute the memory
+  // pattern at session initialization from the inferred shapes instead of tracing the first Run. Runs with inputs
+  // of those shapes then place all the intermediate tensors in a single preallocated buffer without a cache lookup.
+  // requires enable_mem_pattern and the sequential executor.
+  bool enable_static_shape_planning = false;
+
+  // run the MatMul, Gemm, Conv and Attention nodes assigned to the CUDA execution provider in float16 so that they
+  // use Tensor Core math. the other nodes, including softmax and the reductions, keep running in float.
+  bool enable_cuda_mixed_precision = false;
+
+  // replace the ZipMap nodes that produce graph outputs, so that those outputs are the [N, C] float tensors of class
+  // scores instead of sequences of maps. this avoids a heap allocation per class and row in classifier pipelines,
+  // and column j of an output is the score of the j-th label of the removed ZipMap.
+  bool enable_zipmap_tensor_outputs = false;
+
+  // load the model file through a memory mapping, and use the data of CPU initializers in place instead of copying
+  // it into buffers allocated by the session. inline initializer data is taken over from the parsed model and
+  // initializers in external data files alias the mapped file pages, so peak memory at load is about the model size.
+  bool use_mmap_model_load = false;
+
+  // share constant CPU initializers with other sessions created in the same environment. initializers with the
+  // same type, shape and content are allocated once, including the ones created by graph transformers.
+  bool share_initializers_across_sessions = false;
+
+  // load the large constant initializers of the control flow subgraphs (e.g. the branches of If nodes) the first time
+  // the subgraph is executed instead of at Initialize, so the weights of branches that rarely run are neither
+  // deserialized nor copied to their device up front. the kernels of a subgraph don't see its deferred initializers
+  // as constant inputs, e.g. they aren't pre-packed.
+  bool defer_subgraph_initializers = false;
+
+  // after the execution providers claimed their nodes, move the islands of nodes assigned to a device provider
+  // (e.g. CUDA) between CPU nodes back to the CPU provider when the estimated cost of copying their inputs and outputs
+  // exceeds the estimated speedup from running them on the device. this reduces the number of copies inserted
+  // between the CPU and the device.
+  bool enable_cost_based_partitioning = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // serve the CPU allocations of up to 64KB from per-thread free lists in front of the arena, so the intra op
+  // threads and concurrent runs only take the arena lock to refill or trim a list. the blocks held by the lists
+  // count as in use in the arena stats. ignored when the CPU arena is disabled.
+  bool enable_cpu_mem_arena_thread_cache = false;
+
+  // the arena of the CPU allocations. ORT_ARENA_BACKEND_MIMALLOC requires a build with mimalloc enabled.
+  // ignored when the CPU arena is disabled.
+  OrtArenaBackend cpu_arena_backend = ORT_ARENA_BACKEND_DEFAULT;
+
+  // back the CPU device allocations of at least this many bytes with huge pages, which are the regions the CPU arena
+  // extends by and the buffers of the initializers. this uses the hugetlbfs pages reserved on Linux if there are any,
+  // else transparent huge pages, and large pages on Windows, which need the SeLockMemoryPrivilege. the allocations
+  // huge pages can't be had for fall back to small pages. 0 disables it.
+  size_t cpu_huge_page_threshold_bytes = 0;
+
+  // shrink the memory arenas of the execution providers from a background thread once no Run was in progress for
+  // this many milliseconds, so a spike doesn't keep the memory of the process inflated. 0 disables it.
+  int64_t arena_idle_shrink_ms = 0;
+
+  // carve the temporary buffers the CPU kernels allocate during a Run (e.g. the im2col buffer of Conv) from one
+  // per-Run buffer that is rewound between the kernels. the buffer is sized from the scratch the previous runs
+  // needed, so the first runs still allocate some of the temporaries from the arena.
+  bool enable_scratch_allocator = false;
+
+  // pack the constant B of float MatMul nodes on CPU as bfloat16. this halves the memory traffic of the weights and
+  // uses the AVX512-BF16 instructions when available, at the cost of rounding the weights (and, with AVX512-BF16,
+  // the activations) to bfloat16. the products are accumulated in float.
+  bool enable_cpu_bf16_gemm = false;
+
+  // pack the constant B of float MatMul and Gemm nodes on CPU as half precision. this halves the memory of the packed
+  // weights, which are widened back to float one panel at a time, so the GEMMs still compute in float. weights with
+  // values outside the range of half precision are packed as float. enable_cpu_bf16_gemm takes precedence.
+  bool enable_cpu_fp16_weights = false;
+
+  // time candidate block sizes and thread splits of the float GEMMs run by MLAS on CPU the first time each shape is
+  // seen, and use the fastest for the later GEMMs with that shape. the autotuning is process wide and stays enabled
+  // once a session enables it, and it only pays off for models whose GEMM shapes are fixed.
+  bool enable_cpu_gemm_autotuning = false;
+
+  // if not empty, the file the autotuned GEMM parameters are read from and appended to, so that later processes on
+  // the same machine reuse them. empty keeps them in memory.
+  std::string cpu_gemm_autotuning_cache_path;
+
+  // if > 0, record the kernel time of the nodes in one of every this many runs with the always-on lightweight
+  // profiler. the per op statistics are returned by InferenceSession::GetOpStatistics. 0 disables it.
+  uint32_t lightweight_profiling_sampling_interval = 0;
+
+  // if > 0, record the input shapes and the kernel times of the nodes of the first this many runs, then re-plan the
+  // session from them in the background: the parallel executor starts the nodes on the critical path by their
+  // measured times rather than by estimates from their op types, and the memory pattern cache enables shape
+  // bucketing if the shapes seen round up to fewer memory patterns. the kernel times are recorded with the lightweight
+  // profiler, which is enabled for every run if lightweight_profiling_sampling_interval is 0. 0 disables it.
+  uint32_t runtime_profile_runs = 0;
+
+  // if not empty, the file the runtime profile is saved to once it is recorded. a session that finds a profile in the
+  // file when it is initialized applies it right away instead of recording a new one.
+  std::string runtime_profile_path;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -51,16 +166,58 @@ struct SessionOptions {
 
   unsigned max_num_graph_transformation_steps = 10;  // TODO choose a good default here?
 
+  // constant folding skips the nodes with an output larger than this many bytes, so that folding nodes like Tile or
+  // Expand does not blow up the size of the model. 0 means no limit.
+  size_t constant_folding_max_output_bytes = 0;
+
   // set graph optimization level
   TransformerLevel graph_optimization_level = TransformerLevel::Level3;
 
   // controls the size of the thread pool used to parallelize the execution of tasks within individual nodes (ops)
   int intra_op_num_threads = 0;
 
+  // allow the intra op threads to spin looking for work before blocking. spinning reduces the latency of
+  // starting an op, but burns CPU that other sessions in the process could use.
+  bool intra_op_allow_spinning = true;
+
+  // how long (in microseconds) a thread waiting for intra op work to complete spins before blocking, and an intra
+  // op thread that ran its part of the work spins for more before parking. 0 blocks immediately, and leaves the
+  // intra op threads to the fixed spin of intra_op_allow_spinning.
+  int intra_op_spin_duration_us = 0;
+
+  // the most intra op threads, including the thread calling Run, that a parallel loop of a run uses, indexed by the
+  // OrtRunPriority of the run. 0 means no limit.
+  std::array<int, 3> intra_op_max_threads_by_priority{};
+
   // controls the size of the thread pool used to parallelize the execution of nodes (ops)
   // configuring this makes sense only when you're using parallel executor
   int inter_op_num_threads = 0;
 
+  // logical processor ids the intra/inter op threads are restricted to. empty means no restriction.
+  std::vector<int> intra_op_thread_affinity;
+  std::vector<int> inter_op_thread_affinity;
+
+  // if >= 0, restrict the intra and inter op threads to the processors of this NUMA node unless an explicit
+  // affinity is provided above. as memory is allocated on the node of the thread that first touches it, this also
+  // keeps most of the memory used by the kernels local to the node.
+  int numa_node = -1;
+
+  // if false, the session uses the intra and inter op thread pools of the environment, which must have been created
+  // with global thread pools, instead of creating its own. the thread pool options above are then not used.
+  bool use_per_session_threads = true;
+
+  // if > 1, concurrent Run calls with compatible inputs are coalesced along dim 0 (the batch dimension) into a single
+  // run of up to this many rows. the model inputs must have a free or DATA_BATCH denoted dim 0.
+  // See class 'RequestBatcher'.
+  int64_t dynamic_batching_max_batch_size = 0;
+
+  // how long (in microseconds) the first request of a batch waits for other requests to join it.
+  int64_t dynamic_batching_timeout_us = 1000;
+
+  // run the Python (PyOp) nodes of the session on a dedicated thread instead of the executor threads, so that the
+  // executor threads wait on that thread rather than contend for the GIL. only used with language interop ops.
+  bool pyop_dedicated_thread = false;
+
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
@@ -3,11 +3,16 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 #include "core/common/logging/logging.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 
 using namespace ::onnxruntime::common;
@@ -65,9 +70,52 @@ Status SessionState::SetGraph(const Graph& graph) {
   }
 
   LOGS(logger, INFO) << "Done saving OrtValue mappings.";
+
+  ComputeNodeCriticalPathCosts();
+
   return Status::OK();
 }
 
+// Rough relative cost of running a node. Ops that are usually compute bound are weighted higher so that
+// branches containing them are started earlier by the ParallelExecutor.
+static int64_t EstimateNodeCost(const Node& node) {
+  static const std::unordered_map<std::string, int64_t> op_costs = {
+      {"Conv", 10}, {"ConvTranspose", 10}, {"FusedConv", 10}, {"QLinearConv", 10}, {"ConvInteger", 10},
+      {"MatMul", 10}, {"Gemm", 10}, {"FusedGemm", 10}, {"MatMulInteger", 10}, {"QLinearMatMul", 10},
+      {"LSTM", 20}, {"GRU", 20}, {"RNN", 20}, {"Attention", 20}, {"Scan", 20}, {"Loop", 20}};
+
+  auto entry = op_costs.find(node.OpType());
+  return entry != op_costs.end() ? entry->second : 1;
+}
+
+void SessionState::ComputeNodeCriticalPathCosts(const std::vector<int64_t>* node_costs) {
+  auto costs = std::make_shared<std::vector<int64_t>>(graph_viewer_->MaxNodeIndex(), 0);
+
+  // visit in reverse topological order so the costs of all consumers are known when a node is processed
+  const auto& order = graph_viewer_->GetNodesInTopologicalOrder();
+  for (auto it = order.crbegin(), end = order.crend(); it != end; ++it) {
+    const Node* node = graph_viewer_->GetNode(*it);
+    if (node == nullptr) continue;
+
+    int64_t max_consumer_cost = 0;
+    for (auto edge = node->OutputEdgesBegin(), edge_end = node->OutputEdgesEnd(); edge != edge_end; ++edge) {
+      max_consumer_cost = std::max(max_consumer_cost, (*costs)[edge->GetNode().Index()]);
+    }
+
+    const int64_t cost = node_costs != nullptr ? (*node_costs)[node->Index()] : EstimateNodeCost(*node);
+    (*costs)[node->Index()] = cost + max_consumer_cost;
+  }
+
+  std::atomic_store(&node_critical_path_costs_, std::shared_ptr<const std::vector<int64_t>>(std::move(costs)));
+}
+
+void SessionState::SetNodeCosts(const std::vector<int64_t>& node_costs) {
+  ORT_ENFORCE(node_costs.size() == static_cast<size_t>(graph_viewer_->MaxNodeIndex()),
+              "Expected a cost for each of the ", graph_viewer_->MaxNodeIndex(), " node indexes but got ",
+              node_costs.size());
+  ComputeNodeCriticalPathCosts(&node_costs);
+}
+
 Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_manager) {
   const GraphNodes& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
@@ -100,15 +148,123 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
   }
   node_index_info_ = onnxruntime::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
+  CreateNodeExecutionRecords();
+  return PrePackConstantInitializedTensors();
+}
+
+void SessionState::CreateNodeExecutionRecords() {
+  node_execution_records_.clear();
+  if (p_seq_exec_plan_ == nullptr || node_index_info_ == nullptr) {
+    return;
+  }
+
+  node_execution_records_.reserve(p_seq_exec_plan_->execution_plan.size());
+  for (const auto& node_exec_plan : p_seq_exec_plan_->execution_plan) {
+    const NodeIndex node_index = node_exec_plan.node_index;
+    NodeExecutionRecord record;
+    record.kernel = GetKernel(node_index);
+    record.node = graph_viewer_->GetNode(node_index);
+    record.node_index = node_index;
+    record.node_offset = node_index_info_->GetNodeOffset(node_index);
+    record.has_fence = p_seq_exec_plan_->NodeHasFence(node_index);
+    record.free_from_index = node_exec_plan.free_from_index;
+    record.free_to_index = node_exec_plan.free_to_index;
+    node_execution_records_.push_back(record);
+  }
+}
+
+Status SessionState::PrePackConstantInitializedTensors() {
+  if (constant_initialized_tensors_.empty()) {
+    return Status::OK();
+  }
+
+  for (auto& node : graph_viewer_->Nodes()) {
+    OpKernel* kernel = session_kernels_[node.Index()];
+    if (kernel == nullptr) {
+      continue;
+    }
+
+    int input_idx = 0;
+    for (const auto* input_def : node.InputDefs()) {
+      int ort_value_idx;
+      if (input_def->Exists() && ort_value_name_idx_map_.GetIdx(input_def->Name(), ort_value_idx).IsOK()) {
+        auto entry = constant_initialized_tensors_.find(ort_value_idx);
+        if (entry != constant_initialized_tensors_.end() && entry->second.IsTensor()) {
+          bool is_packed = false;
+          ORT_RETURN_IF_ERROR(kernel->PrePack(entry->second.Get<Tensor>(), input_idx, is_packed));
+        }
+      }
+      ++input_idx;
+    }
+  }
+
   return Status::OK();
 }
 
 void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan) {
   p_seq_exec_plan_ = std::move(p_seq_exec_plan);
+  CreateNodeExecutionRecords();
 }
 
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const { return p_seq_exec_plan_.get(); }
 
+const std::vector<bool>* SessionState::GetNodesToExecute(const std::vector<int>& fetch_mlvalue_idxs) const {
+  std::vector<int> key(fetch_mlvalue_idxs);
+  std::sort(key.begin(), key.end());
+  key.erase(std::unique(key.begin(), key.end()), key.end());
+
+  std::lock_guard<OrtMutex> lock(nodes_to_execute_lock_);
+  auto cached = nodes_to_execute_.find(key);
+  if (cached != nodes_to_execute_.end()) {
+    return cached->second.get();
+  }
+
+  // the node producing each OrtValue
+  std::vector<const Node*> producers(static_cast<size_t>(ort_value_name_idx_map_.MaxIdx() + 1), nullptr);
+  for (const auto& node : graph_viewer_->Nodes()) {
+    for (const auto* output_def : node.OutputDefs()) {
+      int idx;
+      if (output_def->Exists() && ort_value_name_idx_map_.GetIdx(output_def->Name(), idx).IsOK()) {
+        producers[idx] = &node;
+      }
+    }
+  }
+
+  // walk back from the producers of the fetches. the input edges include the implicit inputs of the nodes with
+  // subgraphs and the control edges.
+  std::vector<bool> needed(graph_viewer_->MaxNodeIndex(), false);
+  std::vector<const Node*> to_visit;
+  for (int idx : key) {
+    if (idx >= 0 && static_cast<size_t>(idx) < producers.size() && producers[idx] != nullptr) {
+      to_visit.push_back(producers[idx]);
+    }
+  }
+
+  size_t num_needed = 0;
+  while (!to_visit.empty()) {
+    const Node* node = to_visit.back();
+    to_visit.pop_back();
+    if (needed[node->Index()]) {
+      continue;
+    }
+
+    needed[node->Index()] = true;
+    ++num_needed;
+    for (auto it = node->InputNodesBegin(), end = node->InputNodesEnd(); it != end; ++it) {
+      to_visit.push_back(&*it);
+    }
+  }
+
+  std::unique_ptr<const std::vector<bool>> nodes_to_execute;
+  if (num_needed < static_cast<size_t>(graph_viewer_->NumberOfNodes())) {
+    LOGS(Logger(), INFO) << "Skipping " << graph_viewer_->NumberOfNodes() - num_needed
+                         << " nodes that are not needed for the requested outputs.";
+    nodes_to_execute = onnxruntime::make_unique<const std::vector<bool>>(std::move(needed));
+  }
+
+  return nodes_to_execute_.emplace(std::move(key), std::move(nodes_to_execute)).first->second.get();
+}
+
 Status SessionState::AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d,
                                           bool constant) {
   auto p = initialized_tensors_.insert({ort_value_index, ort_value});
@@ -133,6 +289,29 @@ const std::unordered_map<int, OrtValue>& SessionState::GetConstantInitializedTen
   return constant_initialized_tensors_;
 }
 
+void SessionState::SetDeferredInitializersLoader(std::function<Status()> loader) {
+  deferred_initializers_loader_ = std::move(loader);
+  deferred_initializers_loaded_ = !deferred_initializers_loader_;
+}
+
+Status SessionState::LoadDeferredInitializers() const {
+  if (deferred_initializers_loaded_.load(std::memory_order_acquire)) {
+    return deferred_initializers_status_;
+  }
+
+  std::lock_guard<OrtMutex> lock(deferred_initializers_mutex_);
+  if (!deferred_initializers_loaded_.load(std::memory_order_relaxed)) {
+    try {
+      deferred_initializers_status_ = deferred_initializers_loader_();
+    } catch (const std::exception& ex) {
+      deferred_initializers_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+    deferred_initializers_loader_ = nullptr;
+    deferred_initializers_loaded_.store(true, std::memory_order_release);
+  }
+  return deferred_initializers_status_;
+}
+
 SessionState& SessionState::SetLogger(const logging::Logger& logger) {
   logger_ = &logger;
   return *this;
@@ -148,41 +327,358 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
+int64_t SessionState::BucketMemoryPatternDim(int64_t dim) {
+  // round up to the next power of two. values <= 0 are left as-is.
+  if (dim <= 1) return dim;
+  uint64_t v = static_cast<uint64_t>(dim - 1);
+  v |= v >> 1;
+  v |= v >> 2;
+  v |= v >> 4;
+  v |= v >> 8;
+  v |= v >> 16;
+  v |= v >> 32;
+  return static_cast<int64_t>(v + 1);
+}
+
+static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes,
+                                          bool shape_bucketing) {
+  // hash combine of rank and dims so that e.g. {2, 3} and {3, 2} produce different keys
+  uint64_t key = 0;
+  auto combine = [&key](uint64_t v) { key ^= v + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2); };
   for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    const auto& dims = shape.get().GetDims();
+    combine(dims.size());
+    for (auto dim : dims) {
+      combine(static_cast<uint64_t>(shape_bucketing ? SessionState::BucketMemoryPatternDim(dim) : dim));
+    }
   }
-  return key;
+  return static_cast<int64_t>(key);
+}
+
+// a small ordinal of the calling thread, assigned on first use so the threads spread evenly over the reader shards
+static size_t GetThreadOrdinal() {
+  static std::atomic<size_t> next_ordinal{0};
+  thread_local size_t ordinal = next_ordinal.fetch_add(1, std::memory_order_relaxed);
+  return ordinal;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  int64_t key = CalculateMemoryPatternsKey(input_shapes, GetMemoryPatternShapeBucketing());
+
+  auto& shard = mem_pattern_reader_shards_[GetThreadOrdinal() % kMemoryPatternReaderShards];
+  std::shared_ptr<const MemoryPatternGroup> result;
+
+  // registering before loading the snapshot keeps a writer that replaces it from freeing it until we are done
+  auto& readers = shard.readers[mem_patterns_epoch_.load() & 1];
+  readers.fetch_add(1);
+  const MemoryPatternCacheMap* cache = mem_patterns_.load();
+  if (cache != nullptr) {
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      auto& entry = *it->second;
+      const auto clock = mem_patterns_clock_.load(std::memory_order_relaxed);
+      if (entry.last_used.load(std::memory_order_relaxed) != clock) {
+        entry.last_used.store(clock, std::memory_order_relaxed);
+      }
+      result = entry.patterns;
+    }
+  }
+  readers.fetch_sub(1, std::memory_order_release);
 
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  (result ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
+  return result;
+}
 
-  return it->second.get();
+// must be called with mem_patterns_lock_ held
+void SessionState::WaitForMemoryPatternReaders() const {
+  auto wait_for_readers = [this](size_t parity) {
+    for (;;) {
+      uint64_t readers = 0;
+      for (const auto& shard : mem_pattern_reader_shards_) {
+        readers += shard.readers[parity].load();
+      }
+      if (readers == 0) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+  };
+
+  // a lookup that loaded the replaced snapshot registered under the current parity, or under the other one if it
+  // read the epoch before the last flip. the lookups that start after the flip load the new snapshot.
+  const size_t parity = static_cast<size_t>(mem_patterns_epoch_.load() & 1);
+  wait_for_readers(parity ^ 1);
+  mem_patterns_epoch_.fetch_add(1);
+  wait_for_readers(parity);
+}
+
+// must be called with mem_patterns_lock_ held
+void SessionState::PublishMemoryPatternCache(std::unique_ptr<MemoryPatternCacheMap> cache) const {
+  mem_pattern_snapshots_.fetch_add(1, std::memory_order_relaxed);
+  const MemoryPatternCacheMap* replaced = mem_patterns_.exchange(cache.release());
+  if (replaced != nullptr) {
+    WaitForMemoryPatternReaders();
+    delete replaced;
+    mem_pattern_snapshots_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
-    std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+    std::unique_ptr<MemoryPatternGroup> mem_patterns, const MemoryPatternGroup* replaced) const {
+  int64_t key = CalculateMemoryPatternsKey(input_shapes, GetMemoryPatternShapeBucketing());
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  // writers are serialized by the lock so the snapshot can't change until it is published below
+  const MemoryPatternCacheMap* cache = mem_patterns_.load();
+  bool replace = false;
+  if (cache != nullptr) {
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      if (replaced == nullptr || it->second->patterns.get() != replaced) {
+        // another Run with the same shapes created it first, or replaced the patterns that were too small
+        return Status::OK();
+      }
+      replace = true;
+    }
+  }
+
+  auto new_cache = cache != nullptr ? onnxruntime::make_unique<MemoryPatternCacheMap>(*cache)
+                                    : onnxruntime::make_unique<MemoryPatternCacheMap>();
+
+  if (replace) {
+    new_cache->erase(key);
+  } else if (mem_pattern_cache_capacity_ > 0 && new_cache->size() >= mem_pattern_cache_capacity_) {
+    // evict the least recently used entry. any ExecutionFrame still using it holds a reference.
+    auto lru = std::min_element(new_cache->cbegin(), new_cache->cend(),
+                                [](const MemoryPatternCacheMap::value_type& a,
+                                   const MemoryPatternCacheMap::value_type& b) {
+                                  return a.second->last_used.load(std::memory_order_relaxed) <
+                                         b.second->last_used.load(std::memory_order_relaxed);
+                                });
+    new_cache->erase(lru);
+    ++mem_patterns_evictions_;
+  }
+
+  // the entries used after this insertion are stamped with the advanced clock, so they rank above the new one
+  auto clock = mem_patterns_clock_.load(std::memory_order_relaxed);
+  new_cache->emplace(key, std::make_shared<MemoryPatternCacheEntry>(std::move(mem_patterns), clock));
+  mem_patterns_clock_.store(clock + 1, std::memory_order_relaxed);
+  PublishMemoryPatternCache(std::move(new_cache));
+
+  return Status::OK();
+}
+
+void SessionState::SetMemoryPatternCacheOptions(bool shape_bucketing, size_t capacity) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  // keys depend on the bucketing policy so existing entries can't be kept. when a runtime profile enables bucketing
+  // while the session runs, a run that computed its key before the switch may still add an unbucketed entry,
+  // which is only wasted until it is evicted.
+  const MemoryPatternCacheMap* cache = mem_patterns_.load();
+  if (cache != nullptr && (shape_bucketing != GetMemoryPatternShapeBucketing() ||
+                           (capacity > 0 && cache->size() > capacity))) {
+    mem_patterns_evictions_ += cache->size();
+    PublishMemoryPatternCache(onnxruntime::make_unique<MemoryPatternCacheMap>());
+  }
+
+  mem_pattern_shape_bucketing_.store(shape_bucketing, std::memory_order_relaxed);
+  mem_pattern_cache_capacity_ = capacity;
+}
+
+SessionState::MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  MemoryPatternCacheStats stats;
+  for (const auto& shard : mem_pattern_reader_shards_) {
+    stats.hits += shard.hits.load(std::memory_order_relaxed);
+    stats.misses += shard.misses.load(std::memory_order_relaxed);
+  }
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  const MemoryPatternCacheMap* cache = mem_patterns_.load();
+  stats.size = cache != nullptr ? cache->size() : 0;
+  stats.evictions = mem_patterns_evictions_;
+  stats.snapshots = mem_pattern_snapshots_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// returns true and the shape if the NodeArg is a tensor with all dims known
+static bool GetStaticShape(const NodeArg& arg, TensorShape& shape) {
+  const auto* shape_proto = arg.Shape();
+  if (shape_proto == nullptr) {
+    return false;
+  }
+
+  for (const auto& dim : shape_proto->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return false;
+    }
+  }
+
+  shape = utils::GetTensorShapeFromTensorShapeProto(*shape_proto);
+  return true;
+}
+
+Status SessionState::GenerateStaticMemoryPattern() {
+  const auto* exec_plan = GetExecutionPlan();
+  if (!enable_mem_pattern_ || exec_plan == nullptr) {
+    LOGS(Logger(), INFO) << "Memory pattern is disabled. Static memory pattern is not generated.";
+    return Status::OK();
+  }
+
+  std::vector<std::pair<int, TensorShape>> input_shapes;
+  for (const auto* input_def : graph_viewer_->GetInputs()) {
+    int idx;
+    TensorShape shape;
+    if (!GetStaticShape(*input_def, shape) || !ort_value_name_idx_map_.GetIdx(input_def->Name(), idx).IsOK()) {
+      LOGS(Logger(), INFO) << "Graph input " << input_def->Name()
+                           << " does not have a fixed shape. Static memory pattern is not generated.";
+      return Status::OK();
+    }
+    input_shapes.emplace_back(idx, shape);
+  }
+
+  // replay the allocations the sequential executor makes for the traced values, see
+  // ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper and ExecutionFrame::TraceFree.
+  // a value without a fixed shape is left out of the pattern and is allocated when it is created.
+  const auto& alloc_plan = exec_plan->allocation_plan;
+  OrtValuePatternPlanner planner(*exec_plan);
+
+  for (const auto& node_plan : exec_plan->execution_plan) {
+    const auto* node = graph_viewer_->GetNode(node_plan.node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    for (const auto* output_def : node->OutputDefs()) {
+      int idx;
+      if (!output_def->Exists() || !ort_value_name_idx_map_.GetIdx(output_def->Name(), idx).IsOK()) {
+        continue;
+      }
+
+      const auto& per_alloc_plan = alloc_plan[idx];
+      if (per_alloc_plan.alloc_kind != AllocKind::kAllocate || per_alloc_plan.value_type == nullptr ||
+          !per_alloc_plan.value_type->IsTensorType()) {
+        continue;
+      }
+
+      const auto* element_type = static_cast<const TensorTypeBase*>(per_alloc_plan.value_type)->GetElementType();
+      TensorShape shape;
+      size_t size;
+      if (utils::IsDataTypeString(element_type) || !GetStaticShape(*output_def, shape) ||
+          !IAllocator::CalcMemSizeForArrayWithAlignment<64>(static_cast<size_t>(shape.Size()), element_type->Size(),
+                                                            &size)) {
+        continue;
+      }
+
+      auto status = planner.TraceAllocation(idx, size);
+      if (!status.IsOK()) {
+        LOGS(Logger(), WARNING) << "Static memory pattern is not generated. TraceAllocation for ort_value_idx="
+                                << idx << " failed: " << status.ErrorMessage();
+        return Status::OK();
+      }
+    }
+
+    for (int i = node_plan.free_from_index; i <= node_plan.free_to_index; ++i) {
+      auto status = planner.TraceFree(exec_plan->to_be_freed[i]);
+      if (!status.IsOK()) {
+        LOGS(Logger(), WARNING) << "Static memory pattern is not generated. TraceFree for ort_value_idx="
+                                << exec_plan->to_be_freed[i] << " failed: " << status.ErrorMessage();
+        return Status::OK();
+      }
+    }
   }
 
+  auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
+  ORT_RETURN_IF_ERROR(planner.GeneratePatterns(mem_patterns.get()));
+
+  static_input_shapes_ = std::move(input_shapes);
+  static_mem_patterns_ = std::move(mem_patterns);
   return Status::OK();
 }
 
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetStaticMemoryPatternGroup(
+    const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds) const {
+  if (!static_mem_patterns_ || feeds.size() != static_input_shapes_.size()) {
+    return nullptr;
+  }
+
+  for (const auto& input_shape : static_input_shapes_) {
+    auto it = std::find(feed_mlvalue_idxs.cbegin(), feed_mlvalue_idxs.cend(), input_shape.first);
+    if (it == feed_mlvalue_idxs.cend()) {
+      return nullptr;
+    }
+
+    const auto& feed = feeds[it - feed_mlvalue_idxs.cbegin()];
+    if (!feed.IsTensor() || feed.Get<Tensor>().Shape() != input_shape.second) {
+      return nullptr;
+    }
+  }
+
+  return static_mem_patterns_;
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
+void SessionState::UpdateScratchBytes(size_t peak_bytes) const {
+  size_t current = scratch_bytes_.load(std::memory_order_relaxed);
+  while (peak_bytes > current &&
+         !scratch_bytes_.compare_exchange_weak(current, peak_bytes, std::memory_order_relaxed)) {
+  }
+}
+
+ExecutionFrameResources SessionState::AcquireFrameResources(const MemoryPatternGroup* mem_patterns) const {
+  ExecutionFrameResources resources;
+  {
+    std::lock_guard<OrtMutex> lock(frame_resources_lock_);
+    if (frame_resources_.empty()) {
+      return resources;
+    }
+
+    auto entry = std::find_if(frame_resources_.begin(), frame_resources_.end(),
+                              [mem_patterns](const ExecutionFrameResources& r) {
+                                return mem_patterns != nullptr && r.mem_patterns.get() == mem_patterns;
+                              });
+    if (entry == frame_resources_.end()) {
+      entry = std::prev(frame_resources_.end());
+    }
+
+    resources = std::move(*entry);
+    frame_resources_.erase(entry);
+  }
+
+  // the buffers of other patterns are freed outside of the lock
+  if (mem_patterns == nullptr || resources.mem_patterns.get() != mem_patterns) {
+    resources.mem_patterns = nullptr;
+    resources.buffers.clear();
+  }
+
+  return resources;
+}
+
+void SessionState::ReleaseFrameResources(ExecutionFrameResources&& resources) const {
+  std::list<ExecutionFrameResources> evicted;
+  std::lock_guard<OrtMutex> lock(frame_resources_lock_);
+  frame_resources_.push_front(std::move(resources));
+  if (frame_resources_.size() > kMaxFrameResources) {
+    evicted.splice(evicted.end(), frame_resources_, std::prev(frame_resources_.end()));
+  }
+  // evicted is destroyed after the lock is released
+}
+
+void SessionState::ClearFrameResources() const {
+  std::list<ExecutionFrameResources> cleared;
+  {
+    std::lock_guard<OrtMutex> lock(frame_resources_lock_);
+    cleared.swap(frame_resources_);
+  }
+
+  for (const auto& node_entry : subgraph_session_states_) {
+    for (const auto& attribute_entry : node_entry.second) {
+      attribute_entry.second->ClearFrameResources();
+    }
+  }
+}
+
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
   // Graph partitioning should ensure an input is only consumed from one device. Copy nodes should have been inserted
   // to handle a scenario where an input is required on different devices by different nodes. Validate that.
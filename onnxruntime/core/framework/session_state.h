@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -18,6 +21,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/lightweight_profiler.h"
 #include "core/framework/mem_pattern.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/callback.h"
@@ -36,6 +40,32 @@ class NodeIndexInfo;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 
+/**
+The per-Run resources of an ExecutionFrame that SessionState keeps for later frames: the storage of the OrtValues,
+sized to all the values of the graph, and the buffers allocated for the memory patterns the frame used.
+*/
+struct ExecutionFrameResources {
+  // empty OrtValues only
+  std::vector<OrtValue> values;
+  // the patterns the buffers were allocated for, nullptr if the frame had none
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+  std::map<OrtMemoryInfo, BufferUniquePtr> buffers;
+};
+
+// The per node data of the execution plan that the SequentialExecutor uses for every node of every run, looked up
+// once when the kernels are created.
+struct NodeExecutionRecord {
+  const OpKernel* kernel;
+  const Node* node;
+  NodeIndex node_index;
+  // offset of the node's values in the NodeIndexInfo
+  int node_offset;
+  bool has_fence;
+  // range in SequentialExecutionPlan::to_be_freed of the values to release after the node
+  int free_from_index;
+  int free_to_index;
+};
+
 /**
  * SessionState should be modified by the inference session class only.
  * It is supposed to be passed by const-ref only to all the executors.
@@ -66,6 +96,7 @@ class SessionState {
     for (auto& kvp : deleter_for_initialized_tensors_) {
       kvp.second.f(kvp.second.param);
     }
+    delete mem_patterns_.load();
   }
 
   // Graph viewer.
@@ -115,10 +146,35 @@ class SessionState {
    */
   const std::unordered_map<int, OrtValue>& GetConstantInitializedTensors() const;
 
+  /**
+   * Sets the function that adds the initialized tensors whose loading is deferred until the graph is first executed.
+   * The kernels are created without them, so they are not constant initialized tensors.
+   */
+  void SetDeferredInitializersLoader(std::function<Status()> loader);
+
+  /**
+   * Adds the deferred initialized tensors if they weren't added yet. Must be called before the initialized tensors
+   * are used to execute the graph. Thread-safe. The loader runs once and every call returns its status.
+   */
+  Status LoadDeferredInitializers() const;
+
   // execution plan
   void SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan);
   const SequentialExecutionPlan* GetExecutionPlan() const;
 
+  /**
+  Get the record of each node of the execution plan, in the order of the plan. Set once both the plan
+  and the kernels are created.
+  */
+  const std::vector<NodeExecutionRecord>& GetNodeExecutionRecords() const { return node_execution_records_; }
+
+  /**
+  Get the nodes that need to be executed to produce the given fetches, indexed by node index.
+  Returns nullptr if all the nodes are needed. The result is computed once per set of fetches and cached, and stays
+  valid for the lifetime of this SessionState.
+  */
+  const std::vector<bool>* GetNodesToExecute(const std::vector<int>& fetch_mlvalue_idxs) const;
+
   /**
   Set the logger to use for this session.
   */
@@ -142,23 +198,110 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Set the always-on profiler that records the kernel time of the nodes of this graph. Optional.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  void SetLightweightProfiler(profiling::LightweightProfiler* profiler) { lightweight_profiler_ = profiler; }
+
+  /**
+  Get the always-on profiler of this graph. Returns nullptr if lightweight profiling is disabled.
+  */
+  profiling::LightweightProfiler* GetLightweightProfiler() const { return lightweight_profiler_; }
+
+  /**
+  Get cached memory pattern based on input shapes.
+  The returned pattern stays valid for as long as the caller holds it, even if it is evicted from the cache.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
+  @param replaced The cached patterns of the shape bucket that were too small for the Run that generated these,
+                  which replace them. The patterns cached for the shapes are kept if they aren't these.
   Const as it's an internal cache update only.
   */
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
-                                       std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
+                                       std::unique_ptr<MemoryPatternGroup> mem_patterns,
+                                       const MemoryPatternGroup* replaced = nullptr) const;
 
   /**
   Get enable memory pattern flag
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Configure the memory pattern cache.
+  @param shape_bucketing If true, input dims are rounded up to the next power of two when computing the cache key
+                         so that inputs with similar shapes (e.g. varying sequence lengths) share a pattern. A Run
+                         the pattern of its bucket is too small for re-plans it, so that it grows to the largest
+                         shapes of the bucket seen.
+  @param capacity Maximum number of cached patterns. The least recently used pattern is evicted when the cache
+                  is full. 0 means unbounded.
+  */
+  void SetMemoryPatternCacheOptions(bool shape_bucketing, size_t capacity);
+  bool GetMemoryPatternShapeBucketing() const { return mem_pattern_shape_bucketing_.load(std::memory_order_relaxed); }
+  size_t GetMemoryPatternCacheCapacity() const { return mem_pattern_cache_capacity_; }
+
+  /**
+  Round a dim the way the memory pattern cache does with shape bucketing.
+  */
+  static int64_t BucketMemoryPatternDim(int64_t dim);
+
+  /**
+  Enable the per-Run scratch allocator kernels get from OpKernelContext::GetScratchAllocator.
+  */
+  void SetEnableScratchAllocator(bool enable) { enable_scratch_allocator_ = enable; }
+  bool GetEnableScratchAllocator() const { return enable_scratch_allocator_; }
+
+  /**
+  Size of the scratch buffer of a Run, learned from the scratch the previous runs needed.
+  Const as it's an internal cache update only.
+  */
+  size_t GetScratchBytes() const { return scratch_bytes_.load(std::memory_order_relaxed); }
+  void UpdateScratchBytes(size_t peak_bytes) const;
+
+  /**
+  Resources of a previous ExecutionFrame, reused so that a Run with the same input signature doesn't allocate the
+  value storage and the memory pattern buffers again. Returns the resources released with mem_patterns if there
+  are, else the storage of the least recently released ones without their buffers, else empty resources.
+  Thread-safe. Const as it's an internal cache update only.
+  */
+  ExecutionFrameResources AcquireFrameResources(const MemoryPatternGroup* mem_patterns) const;
+  void ReleaseFrameResources(ExecutionFrameResources&& resources) const;
+
+  // Frees the resources kept for later frames, including those of the subgraphs, e.g. before shrinking the arenas.
+  void ClearFrameResources() const;
+
+  struct MemoryPatternCacheStats {
+    size_t size = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // number of cache snapshots not freed yet, including the current one. a replaced snapshot stays alive while
+    // lookups that started before the replacement still use it, which the writer that replaced it waits for.
+    size_t snapshots = 0;
+  };
+
+  /**
+  Get a snapshot of the memory pattern cache counters.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+  Generate the memory pattern from the shapes inferred for the graph, if all the graph inputs have fixed shapes.
+  The allocations and frees of the execution plan are replayed with those shapes so that the first Run can use
+  the pattern instead of tracing the allocations. Does nothing if some input shape is not fixed.
+  Must be called after the execution plan is created.
+  */
+  Status GenerateStaticMemoryPattern();
+
+  /**
+  Get the memory pattern generated by GenerateStaticMemoryPattern if the feeds have the shapes it was generated for.
+  Returns nullptr otherwise.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetStaticMemoryPatternGroup(const std::vector<int>& feed_mlvalue_idxs,
+                                                                        const std::vector<OrtValue>& feeds) const;
+
   struct NodeInfo {
     /**
      *
@@ -205,6 +348,13 @@ class SessionState {
   concurrency::ThreadPool* GetThreadPool() const { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_; }
 
+  // Replace the thread pools, e.g. with the ones shared by the sessions of an environment.
+  // Must be called before the kernels are created.
+  void SetThreadPools(concurrency::ThreadPool* thread_pool, concurrency::ThreadPool* inter_op_thread_pool) {
+    thread_pool_ = thread_pool;
+    inter_op_thread_pool_ = inter_op_thread_pool;
+  }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -214,12 +364,33 @@ class SessionState {
   const DataTransferManager& GetDataTransferMgr() const { return *data_transfer_mgr_; }
   void SetDataTransferMgr(const DataTransferManager* data_transfer_mgr) { data_transfer_mgr_ = data_transfer_mgr; }
 
+  /**
+  Get the estimated cost of the most expensive path from each node to the end of the graph, indexed by node index.
+  Used to start the nodes on the critical path first when the nodes are executed in parallel.
+  A run should get the costs once, as SetNodeCosts may replace them while it runs.
+  */
+  std::shared_ptr<const std::vector<int64_t>> GetNodeCriticalPathCosts() const {
+    return std::atomic_load(&node_critical_path_costs_);
+  }
+
+  /**
+  Recompute the critical path costs from measured node costs indexed by node index, instead of the costs estimated
+  from the op types. Safe to call while the session runs.
+  */
+  void SetNodeCosts(const std::vector<int64_t>& node_costs);
+
   std::vector<BufferUniquePtr>& GetMutableWeightsBuffers() { return weights_buffers_; }
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
+  // give the kernels a chance to pre-pack their constant initializer inputs. called by CreateKernels.
+  Status PrePackConstantInitializedTensors();
+
+  // set node_execution_records_ from the execution plan and the kernels. called by CreateKernels and SetExecutionPlan.
+  void CreateNodeExecutionRecords();
+
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::vector<OpKernel*> session_kernels_;
@@ -239,15 +410,95 @@ class SessionState {
   std::vector<BufferUniquePtr> weights_buffers_;
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
 
+  // see SetDeferredInitializersLoader. the loader is released once it ran.
+  mutable std::function<Status()> deferred_initializers_loader_;
+  mutable std::atomic<bool> deferred_initializers_loaded_{true};
+  mutable OrtMutex deferred_initializers_mutex_;
+  mutable Status deferred_initializers_status_;
+
   const logging::Logger* logger_ = nullptr;
   profiling::Profiler* profiler_ = nullptr;
+  profiling::LightweightProfiler* lightweight_profiler_ = nullptr;
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
-  // lock for the mem_patterns_
+  // round input dims up to a power of two when computing the mem_patterns_ key. atomic as a runtime profile
+  // can enable it while the session runs.
+  std::atomic<bool> mem_pattern_shape_bucketing_{false};
+  // max number of entries in mem_patterns_. 0 means unbounded.
+  size_t mem_pattern_cache_capacity_ = 0;
+
+  bool enable_scratch_allocator_ = false;
+  // largest scratch a Run needed so far, see UpdateScratchBytes
+  mutable std::atomic<size_t> scratch_bytes_{0};
+
+  // see AcquireFrameResources. most recently released first. the buffers of the patterns of a few signatures
+  // are kept, the arenas get the others back.
+  static constexpr size_t kMaxFrameResources = 8;
+  mutable OrtMutex frame_resources_lock_;
+  mutable std::list<ExecutionFrameResources> frame_resources_;
+
+  struct MemoryPatternCacheEntry {
+    MemoryPatternCacheEntry(std::shared_ptr<const MemoryPatternGroup> p, uint64_t tick)
+        : patterns(std::move(p)), last_used(tick) {}
+
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    // value of mem_patterns_clock_ when the entry was last used. approximates LRU order without a lock. a lookup
+    // only writes it on the first use of the entry after an insertion.
+    std::atomic<uint64_t> last_used;
+  };
+  // entries are shared between snapshots so last_used survives a snapshot being replaced
+  using MemoryPatternCacheMap = std::unordered_map<int64_t, std::shared_ptr<MemoryPatternCacheEntry>>;
+
+  // The lookups of a thread register in one of these while they use a snapshot, and count their hits and misses
+  // in it, so that concurrent lookups don't write to a shared cache line.
+  struct MemoryPatternReaderShard {
+    // lookups in progress, by the parity of mem_patterns_epoch_ when they started
+    std::atomic<uint64_t> readers[2]{};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    // keeps the counters of neighbouring shards off a cache line whatever the alignment of the array
+    char padding[64];
+  };
+  static constexpr size_t kMemoryPatternReaderShards = 16;
+
+  // node_costs is indexed by node index. nullptr estimates the costs from the op types.
+  void ComputeNodeCriticalPathCosts(const std::vector<int64_t>* node_costs = nullptr);
+
+  void PublishMemoryPatternCache(std::unique_ptr<MemoryPatternCacheMap> cache) const;
+  // Waits until the lookups that may have loaded a replaced snapshot are done.
+  void WaitForMemoryPatternReaders() const;
+
+  // The cache for the generated mem_patterns is read-mostly. Readers register in the reader shard of their thread
+  // and load the immutable snapshot without taking a lock. Writers (first run with a new input shape) copy the
+  // current snapshot, update the copy, publish it, and free the replaced snapshot once the readers registered
+  // before the publish are done (an epoch based grace period).
+  //
+  // lock for writers of the cache. protects mem_patterns_evictions_, and serializes the updates of mem_patterns_.
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // cache for the generated mem_patterns. key is calculated based on input shapes. owned, freed by
+  // PublishMemoryPatternCache when replaced.
+  mutable std::atomic<const MemoryPatternCacheMap*> mem_patterns_{nullptr};
+  // flipped by each grace period. its parity selects the reader count a lookup registers in.
+  mutable std::atomic<uint64_t> mem_patterns_epoch_{0};
+  // number of insertions into the cache. only changed with mem_patterns_lock_ held.
+  mutable std::atomic<uint64_t> mem_patterns_clock_{0};
+  // snapshots allocated by PublishMemoryPatternCache and not freed yet
+  mutable std::atomic<size_t> mem_pattern_snapshots_{0};
+  mutable MemoryPatternReaderShard mem_pattern_reader_shards_[kMemoryPatternReaderShards];
+  mutable uint64_t mem_patterns_evictions_ = 0;
+
+  // memory pattern generated at initialization for the fixed input shapes in static_input_shapes_
+  std::shared_ptr<const MemoryPatternGroup> static_mem_patterns_;
+  // OrtValue index and shape of each graph input
+  std::vector<std::pair<int, TensorShape>> static_input_shapes_;
+
+  // see GetNodeCriticalPathCosts. replaced with std::atomic_store.
+  std::shared_ptr<const std::vector<int64_t>> node_critical_path_costs_;
+
+  // see GetNodesToExecute. key is the sorted fetch indexes. the value is nullptr if all the nodes are needed.
+  mutable OrtMutex nodes_to_execute_lock_;
+  mutable std::map<std::vector<int>, std::unique_ptr<const std::vector<bool>>> nodes_to_execute_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -259,14 +510,16 @@ class SessionState {
   SubgraphSessionStateMap subgraph_session_states_;
 
   // It could be NULL
-  concurrency::ThreadPool* const thread_pool_{};
-  concurrency::ThreadPool* const inter_op_thread_pool_{};
+  concurrency::ThreadPool* thread_pool_{};
+  concurrency::ThreadPool* inter_op_thread_pool_{};
 
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
   const DataTransferManager* data_transfer_mgr_ = nullptr;
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
+  // see GetNodeExecutionRecords
+  std::vector<NodeExecutionRecord> node_execution_records_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   SessionState* parent_ = nullptr;
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -20,21 +21,36 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
+// the CPU memory used to stage the initializers of other devices at a time
+static constexpr size_t kDeviceStagingWindowBytes = 256 * 1024 * 1024;
+
+// the smallest initializer whose loading is deferred. the small ones are cheap to load and are often shapes or
+// scales that the kernels use as constant inputs when they are created.
+static constexpr size_t kMinDeferredInitializerBytes = 16 * 1024;
+
 // T should have signature of '(int idx, const OrtValue& value, const OrtCallback& d) -> Status'
 template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                             const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
+                                             const InitializedTensorSet& initialized_tensor_set,
+                                             const std::unordered_set<std::string>& constant_initializers,
+                                             const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             const SequentialExecutionPlan& exec_plan, bool use_initializers_in_place,
+                                             SharedInitializerStore* shared_initializer_store,
+                                             concurrency::ThreadPool* thread_pool);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -46,19 +62,25 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
                                                  const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                                  onnxruntime::Graph& graph, SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 bool use_initializers_in_place,
+                                                 SharedInitializerStore* shared_initializer_store,
+                                                 bool defer_initializers)
     : graph_loc_(graph_loc),
       graph_(graph),
       session_state_(session_state),
       execution_providers_(providers),
       kernel_registry_manager_(kernel_registry_manager),
       logger_(session_state.Logger()),
-      enable_mem_pattern_(enable_mem_pattern) {}
+      enable_mem_pattern_(enable_mem_pattern),
+      use_initializers_in_place_(use_initializers_in_place),
+      shared_initializer_store_(shared_initializer_store),
+      defer_initializers_(defer_initializers) {}
 
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
     const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-    ExecutionMode execution_mode) {
+    ExecutionMode execution_mode, bool enable_memory_efficient_order) {
   session_state_.SetGraph(graph_);
   const GraphViewer* graph_viewer = session_state_.GetGraphViewer();
 
@@ -78,7 +100,7 @@ common::Status SessionStateInitializer::CreatePlan(
   }
 
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
-  SequentialPlannerContext context(execution_mode);
+  SequentialPlannerContext context(execution_mode, enable_memory_efficient_order);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_registry_manager_,
                                                     ort_value_name_idx_map, context, exec_plan));
@@ -90,14 +112,76 @@ common::Status SessionStateInitializer::CreatePlan(
   std::unique_ptr<ITensorAllocator> tensor_allocator_(ITensorAllocator::Create(
       enable_mem_pattern_, *exec_plan_ptr, execution_providers_, session_state_.GetMutableWeightsBuffers()));
 
+  const InitializedTensorSet& all_initializers = graph_.GetAllInitializedTensors();
+  std::unordered_set<std::string> constant_initializers;
+  for (const auto& entry : all_initializers) {
+    if (graph_utils::IsConstantInitializer(graph_, entry.first, /* check_outer_scope */ false)) {
+      constant_initializers.insert(entry.first);
+    }
+  }
+
+  // the deferred initializers are moved out of the graph as it is cleared below
+  struct DeferredInitializers {
+    std::vector<ONNX_NAMESPACE::TensorProto> tensor_protos;
+    InitializedTensorSet initializers;
+  };
+  auto deferred = std::make_shared<DeferredInitializers>();
+  InitializedTensorSet initializers_to_save;
+  if (defer_initializers_) {
+    deferred->tensor_protos.reserve(all_initializers.size());
+    for (const auto& entry : all_initializers) {
+      size_t size_in_bytes = 0;
+      if (constant_initializers.count(entry.first) != 0 &&
+          entry.second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+          utils::GetSizeInBytesFromTensorProto<0>(*entry.second, &size_in_bytes).IsOK() &&
+          size_in_bytes >= kMinDeferredInitializerBytes) {
+        deferred->tensor_protos.push_back(std::move(const_cast<ONNX_NAMESPACE::TensorProto&>(*entry.second)));
+        deferred->initializers[entry.first] = &deferred->tensor_protos.back();
+      } else {
+        initializers_to_save.insert(entry);
+      }
+    }
+  }
+
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
+      env, graph_loc_, deferred->initializers.empty() ? all_initializers : initializers_to_save,
+      constant_initializers, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), *exec_plan_ptr, use_initializers_in_place_,
+      shared_initializer_store_, session_state_.GetThreadPool()));
+
+  if (!deferred->initializers.empty()) {
+    LOGS(logger_, INFO) << "Deferring the loading of " << deferred->initializers.size() << " initialized tensors.";
+    SessionState* session_state = &session_state_;
+    const ExecutionProviders* providers = &execution_providers_;
+    std::basic_string<PATH_CHAR_TYPE> graph_loc = graph_loc_;
+    bool use_initializers_in_place = use_initializers_in_place_;
+    SharedInitializerStore* shared_initializer_store = shared_initializer_store_;
+    session_state_.SetDeferredInitializersLoader(
+        [deferred, session_state, providers, graph_loc, use_initializers_in_place,
+         shared_initializer_store, constant_initializers]() -> Status {
+          // the weights buffers of the initial plan are final, so each deferred tensor gets its own buffer
+          const SequentialExecutionPlan& exec_plan = *session_state->GetExecutionPlan();
+          std::unique_ptr<ITensorAllocator> tensor_allocator(ITensorAllocator::Create(
+              false, exec_plan, *providers, session_state->GetMutableWeightsBuffers()));
+          ORT_RETURN_IF_ERROR(SaveInitializedTensors(
+              Env::Default(), graph_loc, deferred->initializers, constant_initializers, *providers,
+              session_state->GetOrtValueNameIdxMap(), tensor_allocator.get(),
+              [session_state](int idx, const OrtValue& value, const OrtCallback& d, bool /*constant*/) -> Status {
+                // the kernels may hold the constant initialized tensors, so they mustn't change after Initialize
+                return session_state->AddInitializedTensor(idx, value, &d, false);
+              },
+              session_state->Logger(), session_state->GetDataTransferMgr(), exec_plan, use_initializers_in_place,
+              shared_initializer_store, session_state->GetThreadPool()));
+          deferred->initializers.clear();
+          deferred->tensor_protos.clear();
+          return Status::OK();
+        });
+  }
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
@@ -109,31 +193,20 @@ common::Status SessionStateInitializer::CreatePlan(
   return Status::OK();
 }
 
-static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
-                                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
-                                             const ExecutionProviders& exec_providers, OrtValue& ort_value,
-                                             OrtCallback& deleter,
-                                             const DataTransferManager& data_transfer_mgr) {
-  const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
-    // deserialize directly to CPU tensor
-    return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
-  }
-  //alloc_info.name is not 'CPU'
-  const IExecutionProvider* provider = exec_providers.Get(alloc_info);
-  if (provider == nullptr) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid allocation info. Provider name = ", alloc_info.name);
-  }
-  // deserialize and copy. In the copy stage, it won't check if the buffer has enough room.
-  // The result tensor won't need a deleter because:
-  // 1. It mustn't be a string tensor
-  // 2. The memory is not memory-mapped.
-  deleter.f = nullptr;
-  deleter.param = nullptr;
+// an initializer of a non-CPU device deserialized to CPU memory, to be copied to its device
+struct StagedTensor {
+  std::unique_ptr<char[]> data;
+  OrtValue value;
+};
+
+// deserialize an initializer of a non-CPU device to a CPU tensor. external data is copied out of the file mapping
+// so that the file is read here, which can run on any thread, and not by the copy to the device.
+static common::Status StageTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                       const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
+                                       const ExecutionProviders& exec_providers, StagedTensor& staged) {
   if (tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "string tensor is not supported for copying between allocators");
   }
-  // deserialize to CPU first for non-CPU allocator, then alloc and copy
   size_t cpu_tensor_length;
   ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &cpu_tensor_length));
   if (m.GetLen() < cpu_tensor_length) {
@@ -141,19 +214,39 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
                            cpu_tensor_length, ", Got ", m.GetLen());
   }
   OrtMemoryInfo info = exec_providers.GetDefaultCpuMemoryInfo();
-  std::unique_ptr<char[]> data(new char[cpu_tensor_length]);
-  std::unique_ptr<Tensor> p_tensor;
-  OrtValue tmp_ort_value;
+  staged.data.reset(new char[cpu_tensor_length]);
   OrtCallback d;
   ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto,
-                                                  MemBuffer(data.get(), cpu_tensor_length, info), tmp_ort_value, d));
-  const Tensor& p_deserialize_tensor = tmp_ort_value.Get<Tensor>();
+                                                  MemBuffer(staged.data.get(), cpu_tensor_length, info),
+                                                  staged.value, d));
+  if (d.f) {
+    // the tensor uses the file data in place
+    const Tensor& file_tensor = staged.value.Get<Tensor>();
+    memcpy(staged.data.get(), file_tensor.DataRaw(), file_tensor.SizeInBytes());
+    auto p_tensor = onnxruntime::make_unique<Tensor>(file_tensor.DataType(), file_tensor.Shape(),
+                                                     staged.data.get(), info);
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    staged.value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+    d.f(d.param);
+  }
+  return Status::OK();
+}
+
+// copy a staged initializer to its preallocated device buffer
+static common::Status CopyStagedTensor(const StagedTensor& staged, const MemBuffer& m,
+                                       const ExecutionProviders& exec_providers, OrtValue& ort_value,
+                                       const DataTransferManager& data_transfer_mgr) {
+  const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
+  const IExecutionProvider* provider = exec_providers.Get(alloc_info);
+  if (provider == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid allocation info. Provider name = ", alloc_info.name);
+  }
 
-  p_tensor = onnxruntime::make_unique<Tensor>(p_deserialize_tensor.DataType(), p_deserialize_tensor.Shape(), m.GetBuffer(),
-                                              m.GetAllocInfo());
+  const Tensor& p_deserialize_tensor = staged.value.Get<Tensor>();
+  auto p_tensor = onnxruntime::make_unique<Tensor>(p_deserialize_tensor.DataType(), p_deserialize_tensor.Shape(),
+                                                   m.GetBuffer(), alloc_info);
   // TODO: does this function work for string tensor?
   Status copy_status = data_transfer_mgr.CopyTensor(p_deserialize_tensor, *p_tensor);
-  if (d.f) d.f(d.param);
   if (!copy_status.IsOK()) {
     if (copy_status.ErrorMessage().empty()) {
       // The windows execution provider does not return any error message today for CopyTensor since it is
@@ -170,57 +263,270 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
+                                             const ExecutionProviders& exec_providers, OrtValue& ort_value,
+                                             OrtCallback& deleter,
+                                             const DataTransferManager& data_transfer_mgr) {
+  const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
+  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+    // deserialize directly to CPU tensor
+    return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
+  }
+  // deserialize to CPU first for non-CPU allocator, then copy. In the copy stage, it won't check if the buffer has
+  // enough room. The result tensor won't need a deleter because:
+  // 1. It mustn't be a string tensor
+  // 2. The memory is not memory-mapped.
+  deleter.f = nullptr;
+  deleter.param = nullptr;
+  StagedTensor staged;
+  ORT_RETURN_IF_ERROR(StageTensorProto(env, proto_path, tensor_proto, m, exec_providers, staged));
+  return CopyStagedTensor(staged, m, exec_providers, ort_value, data_transfer_mgr);
+}
+
+static void DeleteCharArray(void* param) noexcept {
+  delete[] reinterpret_cast<char*>(param);
+}
+
+// deserialize a constant CPU initializer into a buffer it owns and replace it with the stored copy if another
+// session already has an identical one
+static common::Status DeserializeSharedTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                   const OrtMemoryInfo& location, SharedInitializerStore& store,
+                                                   OrtValue& ort_value, OrtCallback& deleter) {
+  if (utils::CanUseTensorProtoDataInPlace(tensor_proto)) {
+    // the graph owns the TensorProto and its initializers are cleared as soon as they are saved, so moving the
+    // raw data out of it is safe
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValueInPlace(env, proto_path.c_str(),
+                                                           const_cast<ONNX_NAMESPACE::TensorProto&>(tensor_proto),
+                                                           location, ort_value, deleter));
+  } else {
+    size_t cpu_tensor_length;
+    ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &cpu_tensor_length));
+    std::unique_ptr<char[]> data(new char[cpu_tensor_length]);
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto,
+                                                    MemBuffer(data.get(), cpu_tensor_length, location), ort_value,
+                                                    deleter));
+    // non-string tensors deserialized into a preallocated buffer don't need a deleter of their own
+    ORT_ENFORCE(deleter.f == nullptr);
+    deleter = OrtCallback{DeleteCharArray, data.release()};
+  }
+
+  return store.Share(ort_value, deleter);
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                      const Graph& graph, const ExecutionProviders& exec_providers,
+                                      const InitializedTensorSet& initialized_tensor_set,
+                                      const std::unordered_set<std::string>& constant_initializers,
+                                      const ExecutionProviders& exec_providers,
                                       const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      const SequentialExecutionPlan& exec_plan, bool use_initializers_in_place,
+                                      SharedInitializerStore* shared_initializer_store,
+                                      concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
   //1. first plan the memory
-  const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
+  std::unordered_set<int> in_place_ids;
+  std::unordered_set<int> shared_ids;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     id_to_initialized_tensor[ort_value_index] = entry.second;
+    // CPU initializers that can use their data in place or are shared don't need a buffer from the planner
+    if (strcmp(exec_plan.GetLocation(ort_value_index).name, CPU) != 0) {
+      continue;
+    }
+    if (shared_initializer_store != nullptr &&
+        entry.second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+        constant_initializers.count(entry.first) != 0) {
+      shared_ids.insert(ort_value_index);
+    } else if (use_initializers_in_place && utils::CanUseTensorProtoDataInPlace(*entry.second)) {
+      in_place_ids.insert(ort_value_index);
+    }
   }
   for (const auto& entry : id_to_initialized_tensor) {
-    ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    if (in_place_ids.count(entry.first) == 0 && shared_ids.count(entry.first) == 0) {
+      ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    }
   }
 
   //2. allocate weight buffer on different locations
   ORT_RETURN_IF_ERROR(planner->FinalizePlan());
-  OrtCallback deleter;
-  //3. create weight tensors based on weights buffer
-  for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
-    const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+  //3. create weight tensors based on weights buffer.
+  // the buffers are handed out by the planner up front so the CPU tensors can be deserialized in parallel.
+  // the tensors of other devices are staged to CPU memory in parallel and copied to the device on this thread.
+  struct InitializerToSave {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> buffer;
+    StagedTensor staged;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
 
-    std::unique_ptr<MemBuffer> m;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+  std::vector<InitializerToSave> initializers;
+  initializers.reserve(id_to_initialized_tensor.size());
+  for (const auto& entry : id_to_initialized_tensor) {
+    InitializerToSave initializer;
+    initializer.ort_value_index = entry.first;
+    initializer.tensor_proto = entry.second;
+    if (in_place_ids.count(entry.first) == 0 && shared_ids.count(entry.first) == 0) {
+      // TODO: if the tensor need be copied, does it have enough room?
+      ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(entry.first, entry.second->name().c_str(),
+                                                         initializer.buffer));
 #ifndef NDEBUG
-    ORT_ENFORCE(m != nullptr);
-    ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+      ORT_ENFORCE(initializer.buffer != nullptr);
+      ORT_ENFORCE(initializer.buffer->GetBuffer() != nullptr || initializer.buffer->GetLen() == 0);
 #endif
-    OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, exec_providers, ort_value, deleter, data_transfer_mgr);
-    if (!st.IsOK()) {
+    }
+    initializers.push_back(std::move(initializer));
+  }
+
+  auto deserialize = [&](InitializerToSave& initializer) {
+    int ort_value_index = initializer.ort_value_index;
+    const ONNX_NAMESPACE::TensorProto& tensor_proto = *initializer.tensor_proto;
+    if (shared_ids.count(ort_value_index) != 0) {
+      initializer.status = DeserializeSharedTensorProto(env, graph_loc, tensor_proto,
+                                                        exec_plan.GetLocation(ort_value_index),
+                                                        *shared_initializer_store, initializer.ort_value,
+                                                        initializer.deleter);
+    } else if (in_place_ids.count(ort_value_index) != 0) {
+      // the graph owns the TensorProto and its initializers are cleared as soon as they are saved, so moving the
+      // raw data out of it is safe
+      initializer.status = utils::TensorProtoToMLValueInPlace(env, graph_loc.c_str(),
+                                                              const_cast<ONNX_NAMESPACE::TensorProto&>(tensor_proto),
+                                                              exec_plan.GetLocation(ort_value_index),
+                                                              initializer.ort_value, initializer.deleter);
+    } else {
+      initializer.status = DeserializeTensorProto(env, graph_loc, tensor_proto, *initializer.buffer, exec_providers,
+                                                  initializer.ort_value, initializer.deleter, data_transfer_mgr);
+    }
+  };
+
+  // the device initializers are staged in windows of about kDeviceStagingWindowBytes. the next window is staged
+  // while the current one is copied, which bounds the CPU memory used for staging to about two windows.
+  std::vector<InitializerToSave*> cpu_initializers;
+  std::vector<std::vector<InitializerToSave*>> device_windows;
+  size_t window_bytes = 0;
+  for (auto& initializer : initializers) {
+    const OrtMemoryInfo& location = exec_plan.GetLocation(initializer.ort_value_index);
+    if (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) {
+      cpu_initializers.push_back(&initializer);
+      continue;
+    }
+    if (device_windows.empty() || window_bytes >= kDeviceStagingWindowBytes) {
+      device_windows.emplace_back();
+      window_bytes = 0;
+    }
+    device_windows.back().push_back(&initializer);
+    window_bytes += initializer.buffer->GetLen();
+  }
+
+  auto stage = [&](InitializerToSave& initializer) {
+    try {
+      initializer.status = StageTensorProto(env, graph_loc, *initializer.tensor_proto, *initializer.buffer,
+                                            exec_providers, initializer.staged);
+    } catch (const std::exception& ex) {
+      initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+
+  OrtMutex staging_mutex;
+  OrtCondVar staging_done;
+  size_t staging_pending = 0;
+  auto start_staging = [&](std::vector<InitializerToSave*>& window) {
+    if (thread_pool == nullptr) {
+      for (auto* initializer : window) {
+        stage(*initializer);
+      }
+      return;
+    }
+    {
+      std::lock_guard<OrtMutex> lock(staging_mutex);
+      staging_pending += window.size();
+    }
+    for (auto* initializer : window) {
+      thread_pool->Schedule([&, initializer]() {
+        stage(*initializer);
+        std::lock_guard<OrtMutex> lock(staging_mutex);
+        if (--staging_pending == 0) {
+          staging_done.notify_all();
+        }
+      });
+    }
+  };
+  auto wait_for_staging = [&]() {
+    std::unique_lock<OrtMutex> lock(staging_mutex);
+    while (staging_pending != 0) {
+      staging_done.wait(lock);
+    }
+  };
+
+  if (!device_windows.empty()) {
+    start_staging(device_windows[0]);
+    wait_for_staging();
+  }
+  for (size_t w = 0; w < device_windows.size(); ++w) {
+    if (w + 1 < device_windows.size()) {
+      start_staging(device_windows[w + 1]);
+    }
+    // the staging tasks reference this frame, so nothing may escape before they are done
+    for (auto* initializer : device_windows[w]) {
+      if (initializer->status.IsOK()) {
+        try {
+          initializer->status = CopyStagedTensor(initializer->staged, *initializer->buffer, exec_providers,
+                                                 initializer->ort_value, data_transfer_mgr);
+        } catch (const std::exception& ex) {
+          initializer->status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+        }
+      }
+      initializer->staged = StagedTensor();
+    }
+    wait_for_staging();
+  }
+
+  concurrency::ThreadPool::TryBatchParallelFor(thread_pool, static_cast<int32_t>(cpu_initializers.size()),
+                                               [&](int32_t i) { deserialize(*cpu_initializers[i]); });
+
+  // save in a fixed order. the deleters of initializers that fail or aren't saved yet are run here so nothing leaks
+  Status status;
+  for (auto& initializer : initializers) {
+    const char* name = initializer.tensor_proto->name().c_str();
+    if (status.IsOK() && !initializer.status.IsOK()) {
       std::ostringstream oss;
-      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-      return Status(st.Category(), st.Code(), oss.str());
+      oss << "Deserialize tensor " << name << " failed." << initializer.status.ErrorMessage();
+      status = Status(initializer.status.Category(), initializer.status.Code(), oss.str());
     }
 
-    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    if (!status.IsOK()) {
+      initializer.ort_value = OrtValue();
+      if (initializer.deleter.f != nullptr) {
+        initializer.deleter.f(initializer.deleter.param);
+      }
+      continue;
+    }
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    bool constant = constant_initializers.count(name) != 0;
+    status = save_tensor_func(initializer.ort_value_index, initializer.ort_value, initializer.deleter, constant);
+    if (!status.IsOK()) {
+      initializer.ort_value = OrtValue();
+      if (initializer.deleter.f != nullptr) {
+        initializer.deleter.f(initializer.deleter.param);
+      }
+      continue;
+    }
+
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << initializer.ort_value_index;
   }
 
+  ORT_RETURN_IF_ERROR(status);
+
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
@@ -20,6 +20,7 @@ class KernelRegistryManager;
 class Node;
 class NodeArg;
 class SessionState;
+class SharedInitializerStore;
 
 namespace logging {
 class Logger;
@@ -31,16 +32,23 @@ class SessionStateInitializer {
   /**
    *
    * \param graph_loc The file path of where the graph was loaded. e.g. /tmp/test_squeezenet/model.onnx
+   * \param use_initializers_in_place Use the data of CPU initializers in place instead of copying it into
+   *                                  buffers allocated by the session. Inline data is moved out of the graph.
+   * \param shared_initializer_store If not null, constant CPU initializers are shared through this store with
+   *                                 other sessions that have identical initializers.
+   * \param defer_initializers Defer loading the large constant initializers until the graph is first executed.
+   *                           The kernels are created without them, so they don't see them as constant inputs.
    */
   SessionStateInitializer(bool enable_mem_pattern, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                           onnxruntime::Graph& graph, SessionState& session_state, const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager, bool use_initializers_in_place = false,
+                          SharedInitializerStore* shared_initializer_store = nullptr, bool defer_initializers = false);
 
   // First perform any transformations and create the execution plan
   // Then initialize tensors, and save. save kernels and input/output node mappings
   common::Status CreatePlan(_In_opt_ const Node* parent_node,
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-                            ExecutionMode execution_mode);
+                            ExecutionMode execution_mode, bool enable_memory_efficient_order = false);
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
@@ -51,5 +59,8 @@ class SessionStateInitializer {
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  const bool use_initializers_in_place_;
+  SharedInitializerStore* const shared_initializer_store_;
+  const bool defer_initializers_;
 };
 }  // namespace onnxruntime
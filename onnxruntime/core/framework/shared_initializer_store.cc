@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <cstring>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// FNV-1a
+constexpr uint64_t kHashPrime = 1099511628211ULL;
+constexpr uint64_t kHashOffset = 14695981039346656037ULL;
+
+uint64_t HashBytes(const void* data, size_t len, uint64_t hash) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ bytes[i]) * kHashPrime;
+  }
+  return hash;
+}
+
+uint64_t HashTensor(const Tensor& tensor) {
+  const auto* type = tensor.DataType();
+  uint64_t hash = HashBytes(&type, sizeof(type), kHashOffset);
+  const auto& dims = tensor.Shape().GetDims();
+  if (!dims.empty()) {
+    hash = HashBytes(dims.data(), dims.size() * sizeof(int64_t), hash);
+  }
+  return HashBytes(tensor.DataRaw(), tensor.SizeInBytes(), hash);
+}
+
+bool IsSameTensor(const Tensor& a, const Tensor& b) {
+  return a.DataType() == b.DataType() && a.Shape() == b.Shape() &&
+         (a.SizeInBytes() == 0 || memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0);
+}
+
+void ReleaseSharedInitializer(void* param) noexcept {
+  delete reinterpret_cast<std::shared_ptr<void>*>(param);
+}
+
+}  // namespace
+
+SharedInitializerStore::Entry::~Entry() {
+  // drop the tensor before its buffer
+  value = OrtValue();
+  if (deleter.f != nullptr) {
+    deleter.f(deleter.param);
+  }
+}
+
+common::Status SharedInitializerStore::Share(OrtValue& value, OrtCallback& deleter) {
+  ORT_RETURN_IF_NOT(value.IsTensor(), "Only tensors can be shared");
+  const Tensor& tensor = value.Get<Tensor>();
+  ORT_RETURN_IF_NOT(!tensor.IsDataTypeString(), "String tensors can't be shared");
+
+  const uint64_t hash = HashTensor(tensor);
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto& candidates = entries_[hash];
+    for (auto it = candidates.begin(); it != candidates.end();) {
+      auto candidate = it->lock();
+      if (candidate == nullptr) {
+        it = candidates.erase(it);
+        continue;
+      }
+
+      if (IsSameTensor(candidate->value.Get<Tensor>(), tensor)) {
+        entry = std::move(candidate);
+        break;
+      }
+      ++it;
+    }
+
+    if (entry == nullptr) {
+      entry = std::make_shared<Entry>(value, deleter);
+      candidates.push_back(entry);
+      deleter = OrtCallback{nullptr, nullptr};
+    }
+  }
+
+  if (deleter.f != nullptr) {
+    // an identical initializer is already stored so this copy isn't needed
+    value = OrtValue();
+    deleter.f(deleter.param);
+  }
+
+  value = entry->value;
+  deleter = OrtCallback{ReleaseSharedInitializer, new std::shared_ptr<void>(std::move(entry))};
+  return Status::OK();
+}
+
+size_t SharedInitializerStore::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& candidates : entries_) {
+    for (const auto& candidate : candidates.second) {
+      if (!candidate.expired()) {
+        ++size;
+      }
+    }
+  }
+  return size;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/callback.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Stores CPU initializers so sessions with identical weights share a single copy.
+ *
+ * Initializers are matched by element type, shape and content. This happens after the graph transformers ran, so
+ * reordered or packed initializers they created (e.g. by the NchwcTransformer) are shared too.
+ * An initializer is released once no session holds it anymore. This class is thread-safe.
+ */
+class SharedInitializerStore {
+ public:
+  SharedInitializerStore() = default;
+
+  /**
+   * Replace 'value' with a stored initializer of the same type, shape and content, or add it to the store if there
+   * is none. In both cases the buffer of 'value' is owned by the store afterwards and 'deleter' is replaced by a
+   * callback that releases this reference to the stored initializer.
+   * 'value' must be a non-string CPU tensor.
+   */
+  common::Status Share(OrtValue& value, OrtCallback& deleter);
+
+  // number of distinct initializers currently held
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+  struct Entry {
+    Entry(const OrtValue& value1, const OrtCallback& deleter1) : value(value1), deleter(deleter1) {}
+    ~Entry();
+
+    OrtValue value;
+    OrtCallback deleter;
+  };
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<uint64_t, std::vector<std::weak_ptr<Entry>>> entries_;
+};
+
+}  // namespace onnxruntime
@@ -35,8 +35,41 @@ Tensor::Tensor(MLDataType p_type, const TensorShape& shape, std::shared_ptr<IAll
   Init(p_type, shape, p_data, allocator, offset);
 }
 
+Tensor::Tensor(const TensorShape& shape, size_t num_chars, std::shared_ptr<IAllocator> allocator)
+    : alloc_info_(allocator->Info()) {
+  int64_t shape_size = shape.Size();
+  if (shape_size < 0 || static_cast<uint64_t>(shape_size) >= std::numeric_limits<size_t>::max())
+    ORT_THROW("shape.Size() must >=0");
+
+  size_t len = 0;
+  if (!allocator->CalcMemSizeForArray(static_cast<size_t>(shape_size) + 1, sizeof(int64_t), &len) ||
+      len + num_chars < len)
+    ORT_THROW("tensor failed memory size calculation");
+  void* p_data = allocator->Alloc(len + num_chars);
+
+  // Init does the placement new of std::string elements for the other string tensors
+  packed_strings_ = true;
+  Init(DataTypeImpl::GetType<std::string>(), shape, p_data, allocator);
+  auto* offsets = static_cast<int64_t*>(p_data_);
+  offsets[0] = 0;
+  offsets[shape_size] = static_cast<int64_t>(num_chars);
+}
+
+Tensor::Tensor(const TensorShape& shape, Tensor& packed) : alloc_info_(packed.alloc_info_) {
+  ORT_ENFORCE(packed.packed_strings_, "The tensor is not in the packed string layout.");
+  ORT_ENFORCE(shape.Size() == packed.shape_.Size(), "The shape ", shape, " doesn't have the ",
+              packed.shape_.Size(), " elements of the packed strings.");
+  packed_strings_ = true;
+  Init(packed.DataType(), shape, packed.p_data_, nullptr);
+}
+
 size_t Tensor::SizeInBytes() const {
   size_t ret;
+  if (packed_strings_) {
+    const int64_t num_strings = shape_.Size();
+    return static_cast<size_t>(num_strings + 1) * sizeof(int64_t) +
+           static_cast<size_t>(PackedStringOffsets()[num_strings]);
+  }
   int64_t l = shape_.Size();
   if (l >= static_cast<int64_t>(std::numeric_limits<ptrdiff_t>::max())) {
     ORT_THROW("tensor size overflow");
@@ -60,7 +93,7 @@ void Tensor::Init(MLDataType p_type, const TensorShape& shape, void* p_raw_data,
   buffer_deleter_ = std::move(deleter);
   // for string tensors, if this tensor own the buffer (caller passed in the deleter)
   // do the placement new for strings on pre-allocated buffer.
-  if (buffer_deleter_ && IsDataTypeString()) {
+  if (buffer_deleter_ && IsDataTypeString() && !packed_strings_) {
     auto* ptr = static_cast<std::string*>(p_data_);
     for (int64_t i = 0, n = shape_size; i < n; ++i) {
       new (ptr + i) std::string();
@@ -71,16 +104,18 @@ void Tensor::Init(MLDataType p_type, const TensorShape& shape, void* p_raw_data,
 
 Tensor::Tensor(Tensor&& other) noexcept
     : p_data_(other.p_data_),
-      buffer_deleter_(other.buffer_deleter_),
-      shape_(other.shape_),
+      buffer_deleter_(std::move(other.buffer_deleter_)),
+      shape_(std::move(other.shape_)),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
-      byte_offset_(other.byte_offset_) {
+      byte_offset_(other.byte_offset_),
+      packed_strings_(other.packed_strings_) {
   other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
-  other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
+  other.shape_ = TensorShape{0};
   other.p_data_ = nullptr;
   other.buffer_deleter_ = nullptr;
   other.byte_offset_ = 0;
+  other.packed_strings_ = false;
 }
 
 Tensor& Tensor::operator=(Tensor&& other) noexcept {
@@ -88,17 +123,19 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     ReleaseBuffer();
 
     dtype_ = other.dtype_;
-    shape_ = other.shape_;
+    shape_ = std::move(other.shape_);
     alloc_info_ = other.alloc_info_;
     byte_offset_ = other.byte_offset_;
     p_data_ = other.p_data_;
-    buffer_deleter_ = other.buffer_deleter_;
+    buffer_deleter_ = std::move(other.buffer_deleter_);
+    packed_strings_ = other.packed_strings_;
 
     other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
-    other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
+    other.shape_ = TensorShape{0};
     other.p_data_ = nullptr;
     other.byte_offset_ = 0;
     other.buffer_deleter_ = nullptr;
+    other.packed_strings_ = false;
   }
   return *this;
 }
@@ -112,7 +149,7 @@ void Tensor::ReleaseBuffer() {
     // if current tensor is responsible for deleting the buffer
     // and it is a string tensor, need to explicitly call string(s)
     // __dtor(s).
-    if (IsDataTypeString()) {
+    if (IsDataTypeString() && !packed_strings_) {
       using string = std::string;
       auto* ptr = static_cast<std::string*>(p_data_);
       int64_t len = shape_.Size();
@@ -8,29 +8,38 @@
 
 namespace onnxruntime {
 
-TensorShape::TensorShape(const int64_t* dimension_sizes, size_t dimension_count)
-    : std::vector<int64_t>(dimension_count) {
-  for (size_t i = 0; i < dimension_count; ++i) {
-    (*this)[i] = dimension_sizes[i];
+TensorShape::TensorShape(const int64_t* dimension_sizes, size_t dimension_count) : num_dims_(dimension_count) {
+  if (dimension_count > kInlineDims) {
+    heap_dims_.assign(dimension_sizes, dimension_sizes + dimension_count);
+  } else if (dimension_count > 0) {
+    memcpy(inline_dims_, dimension_sizes, dimension_count * sizeof(int64_t));
   }
 }
 
-TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end) {
-  assign(dims.begin() + start, dims.begin() + end);
+TensorShape::TensorShape(std::vector<int64_t>&& dims) : num_dims_(dims.size()) {
+  if (num_dims_ > kInlineDims) {
+    heap_dims_ = std::move(dims);
+  } else if (num_dims_ > 0) {
+    memcpy(inline_dims_, dims.data(), num_dims_ * sizeof(int64_t));
+  }
+}
+
+TensorShape::TensorShape(const std::vector<int64_t>& dims, size_t start, size_t end)
+    : TensorShape(dims.data() + start, end - start) {
 }
 
 /**
  * Return the total number of elements. Returns 1 for an empty (rank 0) TensorShape.
  */
 int64_t TensorShape::Size() const {
-  size_t arraySize = size();
+  size_t arraySize = num_dims_;
   int64_t size = SizeHelper(0, arraySize);
   //should we cache the size? as multiple operation may be expensive.
   return size;
 }
 
 int64_t TensorShape::SizeToDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = num_dims_;
   ORT_ENFORCE(dimension <= num_dims,
               "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
               num_dims, " dimensions.");
@@ -40,7 +49,7 @@ int64_t TensorShape::SizeToDimension(size_t dimension) const {
 }
 
 int64_t TensorShape::SizeFromDimension(size_t dimension) const {
-  const size_t num_dims = size();
+  const size_t num_dims = num_dims_;
   ORT_ENFORCE(dimension <= num_dims,
               "Invalid dimension of ", dimension, " for SizeFromDimension. Tensor has ",
               num_dims, " dimensions.");
@@ -50,13 +59,13 @@ int64_t TensorShape::SizeFromDimension(size_t dimension) const {
 }
 
 TensorShape TensorShape::Slice(size_t dimstart, size_t dimend) const {
-  ORT_ENFORCE(dimstart <= dimend && dimend <= size(),
+  ORT_ENFORCE(dimstart <= dimend && dimend <= num_dims_,
               "Invalid tensor shape slice argument.");
-  return TensorShape(*this, dimstart, dimend);
+  return TensorShape(Data() + dimstart, dimend - dimstart);
 }
 
 TensorShape TensorShape::Slice(size_t dimstart) const {
-  return Slice(dimstart, size());
+  return Slice(dimstart, num_dims_);
 }
 
 // output dimensions
@@ -65,7 +74,7 @@ std::string TensorShape::ToString() const {
 
   result.append("{");
   bool first = true;
-  for (auto dim : (*this)) {
+  for (auto dim : GetDims()) {
     if (!first) {
       result.append(",");
     }
@@ -81,9 +90,10 @@ std::string TensorShape::ToString() const {
 int64_t TensorShape::SizeHelper(size_t start, size_t end) const {
   // Must return 1 for an empty sequence
   int64_t size = 1;
+  const int64_t* dims = Data();
   for (size_t i = start; i < end; i++) {
-    if ((*this)[i] < 0) return -1;
-    size *= (*this)[i];
+    if (dims[i] < 0) return -1;
+    size *= dims[i];
   }
   return size;
 }
@@ -486,6 +486,56 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
   return Status::OK();
 }
 
+static void DeleteString(void* param) noexcept {
+  auto str = reinterpret_cast<std::string*>(param);
+  delete str;
+}
+
+bool CanUseTensorProtoDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  return endian::native == endian::little &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL || utils::HasRawData(tensor_proto));
+}
+
+Status TensorProtoToMLValueInPlace(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                   ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtMemoryInfo& location,
+                                   OrtValue& value, OrtCallback& deleter) {
+  ORT_ENFORCE(CanUseTensorProtoDataInPlace(tensor_proto));
+
+  if (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL) {
+    // the external data is mapped or read into a buffer owned by the tensor so nothing needs to be preallocated
+    return TensorProtoToMLValue(env, tensor_proto_path, tensor_proto, MemBuffer(nullptr, 0, location), value,
+                                deleter);
+  }
+
+  deleter.f = nullptr;
+  deleter.param = nullptr;
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  TensorShape tensor_shape{GetTensorShapeFromTensorProto(tensor_proto)};
+  if (tensor_shape.Size() < 0) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "tensor can't contain negative dims");
+  }
+
+  size_t expected_size;
+  if (!IAllocator::CalcMemSizeForArrayWithAlignment<0>(static_cast<size_t>(tensor_shape.Size()), type->Size(),
+                                                       &expected_size)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "size overflow");
+  }
+
+  if (tensor_proto.raw_data().size() != expected_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The raw data size does not match the tensor shape, expected ",
+                           expected_size, ", got ", tensor_proto.raw_data().size());
+  }
+
+  // moving the string keeps its heap buffer so the tensor uses the parsed bytes without copying them
+  auto* buffer = new std::string(std::move(*tensor_proto.mutable_raw_data()));
+  deleter = OrtCallback{DeleteString, buffer};
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(new Tensor(type, tensor_shape, &(*buffer)[0], location), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
 #define CASE_TYPE(X)                             \
   case ONNX_NAMESPACE::TensorProto_DataType_##X: \
     return ONNX_TENSOR_ELEMENT_DATA_TYPE_##X;
@@ -542,6 +592,143 @@ ONNX_NAMESPACE::TensorProto TensorToTensorProto(const Tensor& tensor, const std:
   return tensor_proto;
 }
 
+namespace {
+// copies the values of a sparse tensor to their linear offsets in the raw data of a dense tensor
+template <typename T>
+common::Status ScatterSparseValues(const TensorProto& values, const std::vector<int64_t>& offsets,
+                                   std::string& dense_raw_data) {
+  const auto count = static_cast<int64_t>(offsets.size());
+  std::unique_ptr<T[]> unpacked(new T[offsets.size()]);
+  ORT_RETURN_IF_ERROR(UnpackTensor(values, utils::HasRawData(values) ? values.raw_data().data() : nullptr,
+                                   values.raw_data().size(), unpacked.get(), count));
+  T* dense = reinterpret_cast<T*>(&dense_raw_data[0]);
+  for (int64_t i = 0; i < count; ++i) {
+    dense[offsets[i]] = unpacked[i];
+  }
+  return Status::OK();
+}
+}  // namespace
+
+common::Status SparseTensorProtoToDenseTensorProto(const ONNX_NAMESPACE::SparseTensorProto& sparse_tensor_proto,
+                                                   ONNX_NAMESPACE::TensorProto& dense_tensor_proto) {
+  // the raw data of the dense tensor is little-endian
+  ORT_RETURN_IF_NOT(endian::native == endian::little, "Sparse tensors are only supported on little-endian hosts");
+
+  const auto& values = sparse_tensor_proto.values();
+  const auto& indices = sparse_tensor_proto.indices();
+  ORT_RETURN_IF_NOT(values.data_location() != TensorProto_DataLocation_EXTERNAL &&
+                        indices.data_location() != TensorProto_DataLocation_EXTERNAL,
+                    "Sparse tensor ", values.name(), " has external data, which is not supported");
+  ORT_RETURN_IF_NOT(values.dims_size() == 1, "Sparse tensor ", values.name(), " values must be 1-D");
+
+  const int64_t nnz = values.dims(0);
+  const int rank = sparse_tensor_proto.dims_size();
+  int64_t dense_size = 1;
+  for (int i = 0; i < rank; ++i) {
+    ORT_RETURN_IF_NOT(sparse_tensor_proto.dims(i) >= 0, "Sparse tensor ", values.name(), " has a negative dim");
+    dense_size *= sparse_tensor_proto.dims(i);
+  }
+
+  // linear [NNZ] or coordinate [NNZ, rank] indices
+  const bool linear = indices.dims_size() == 1;
+  ORT_RETURN_IF_NOT(indices.data_type() == TensorProto_DataType_INT64 &&
+                        ((linear && indices.dims(0) == nnz) ||
+                         (indices.dims_size() == 2 && indices.dims(0) == nnz && indices.dims(1) == rank)),
+                    "Sparse tensor ", values.name(), " indices must be int64 of shape [NNZ] or [NNZ, rank]");
+  std::vector<int64_t> index_values(static_cast<size_t>(linear ? nnz : nnz * rank));
+  ORT_RETURN_IF_ERROR(UnpackTensor(indices, utils::HasRawData(indices) ? indices.raw_data().data() : nullptr,
+                                   indices.raw_data().size(), index_values.data(),
+                                   static_cast<int64_t>(index_values.size())));
+
+  std::vector<int64_t> offsets(static_cast<size_t>(nnz));
+  for (int64_t i = 0; i < nnz; ++i) {
+    int64_t offset = 0;
+    if (linear) {
+      offset = index_values[i];
+    } else {
+      for (int d = 0; d < rank; ++d) {
+        const int64_t coordinate = index_values[i * rank + d];
+        ORT_RETURN_IF_NOT(coordinate >= 0 && coordinate < sparse_tensor_proto.dims(d),
+                          "Sparse tensor ", values.name(), " has an index out of range");
+        offset = offset * sparse_tensor_proto.dims(d) + coordinate;
+      }
+    }
+    ORT_RETURN_IF_NOT(offset >= 0 && offset < dense_size, "Sparse tensor ", values.name(),
+                      " has an index out of range");
+    offsets[i] = offset;
+  }
+
+  size_t element_size = 0;
+  switch (values.data_type()) {
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_UINT32:
+      element_size = 4;
+      break;
+    case TensorProto_DataType_DOUBLE:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_UINT64:
+      element_size = 8;
+      break;
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_BFLOAT16:
+      element_size = 2;
+      break;
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT8:
+    case TensorProto_DataType_BOOL:
+      element_size = 1;
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Sparse tensor ", values.name(),
+                             " has an unsupported data type ", values.data_type());
+  }
+
+  dense_tensor_proto.Clear();
+  dense_tensor_proto.set_name(values.name());
+  dense_tensor_proto.set_data_type(values.data_type());
+  for (int i = 0; i < rank; ++i) {
+    dense_tensor_proto.add_dims(sparse_tensor_proto.dims(i));
+  }
+
+  std::string& dense_raw_data = *dense_tensor_proto.mutable_raw_data();
+  dense_raw_data.assign(static_cast<size_t>(dense_size) * element_size, '\0');
+  if (nnz == 0) {
+    return Status::OK();
+  }
+
+  switch (values.data_type()) {
+    case TensorProto_DataType_FLOAT:
+      return ScatterSparseValues<float>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_DOUBLE:
+      return ScatterSparseValues<double>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_INT8:
+      return ScatterSparseValues<int8_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_UINT8:
+      return ScatterSparseValues<uint8_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_INT16:
+      return ScatterSparseValues<int16_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_UINT16:
+      return ScatterSparseValues<uint16_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_INT32:
+      return ScatterSparseValues<int32_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_UINT32:
+      return ScatterSparseValues<uint32_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_INT64:
+      return ScatterSparseValues<int64_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_UINT64:
+      return ScatterSparseValues<uint64_t>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_FLOAT16:
+      return ScatterSparseValues<MLFloat16>(values, offsets, dense_raw_data);
+    case TensorProto_DataType_BFLOAT16:
+      return ScatterSparseValues<BFloat16>(values, offsets, dense_raw_data);
+    default:
+      return ScatterSparseValues<bool>(values, offsets, dense_raw_data);
+  }
+}
+
 template common::Status GetSizeInBytesFromTensorProto<256>(const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                                            size_t* out);
 template common::Status GetSizeInBytesFromTensorProto<0>(const ONNX_NAMESPACE::TensorProto& tensor_proto, size_t* out);
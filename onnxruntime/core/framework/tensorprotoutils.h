@@ -19,6 +19,7 @@
 namespace ONNX_NAMESPACE {
 class TensorProto;
 class TensorShapeProto;
+class SparseTensorProto;
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {
@@ -35,6 +36,22 @@ common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_prot
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
 
+/**
+ * Whether the data of a TensorProto can be used in place by TensorProtoToMLValueInPlace.
+ * This requires a non-string tensor with raw or external data on a little-endian host.
+ */
+bool CanUseTensorProtoDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+/**
+ * deserialize a TensorProto into a CPU tensor without a preallocated buffer.
+ * External data is memory mapped (or read if that fails) and inline raw data is moved out of the TensorProto, so
+ * tensor_proto can't be used for anything else once this returns. The buffer is released by deleter.
+ * CanUseTensorProtoDataInPlace must be true for tensor_proto.
+ */
+common::Status TensorProtoToMLValueInPlace(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                           ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtMemoryInfo& location,
+                                           OrtValue& value, OrtCallback& deleter);
+
 /** Creates a TensorProto from a Tensor.
     @param[in] tensor the Tensor whose data and shape will be used to create the TensorProto.
     @param[in] tensor_proto_name the name of the TensorProto.
@@ -47,6 +64,12 @@ common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_prot
 ONNX_NAMESPACE::TensorProto TensorToTensorProto(const Tensor& tensor, const std::string& tensor_proto_name,
                                                 const ONNX_NAMESPACE::TypeProto& tensor_proto_type);
 
+/** Creates the dense TensorProto of a SparseTensorProto, with the name of its values and raw data.
+    The indices can be linear indices of shape [NNZ] or coordinates of shape [NNZ, rank].
+    String values and values with external data are not supported. */
+common::Status SparseTensorProtoToDenseTensorProto(const ONNX_NAMESPACE::SparseTensorProto& sparse_tensor_proto,
+                                                   ONNX_NAMESPACE::TensorProto& dense_tensor_proto);
+
 ONNXTensorElementDataType CApiElementTypeFromProtoType(int type);
 ONNXTensorElementDataType GetTensorElementType(const ONNX_NAMESPACE::TensorProto& tensor_proto);
 
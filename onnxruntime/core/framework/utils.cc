@@ -14,6 +14,7 @@
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/packed_strings.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
@@ -183,6 +184,34 @@ static Status CopyMLValue(const DataTransferManager& data_transfer_mgr,
   return Status::OK();
 }
 
+// Like CopyMLValue for each value. The tensors that need a copy are copied with a single call to
+// DataTransferManager::CopyTensors, so a data transfer can coalesce them, e.g. many small inputs copied to a GPU.
+static Status CopyMLValues(const DataTransferManager& data_transfer_mgr,
+                           const std::vector<MLValueCopyInfo>& copy_info,
+                           const std::vector<OrtValue>& source_mlvalues,
+                           std::vector<OrtValue>& target_mlvalues) {
+  std::vector<const Tensor*> source_tensors;
+  std::vector<Tensor*> target_tensors;
+  for (size_t idx = 0, end = source_mlvalues.size(); idx < end; ++idx) {
+    const auto& info = copy_info[idx];
+    if (info.source_device == info.target_device) {
+      target_mlvalues[idx] = source_mlvalues[idx];
+      continue;
+    }
+
+    const auto& source_tensor = source_mlvalues[idx].Get<Tensor>();
+    if (!target_mlvalues[idx].IsAllocated()) {
+      ORT_RETURN_IF_ERROR(utils::AllocateHelper(*info.allocation_provider, info.target_device,
+                                                source_tensor, target_mlvalues[idx]));
+    }
+
+    source_tensors.push_back(&source_tensor);
+    target_tensors.push_back(target_mlvalues[idx].GetMutable<Tensor>());
+  }
+
+  return source_tensors.empty() ? Status::OK() : data_transfer_mgr.CopyTensors(source_tensors, target_tensors);
+}
+
 static bool HaveCpuExecutionProvidersOnly(const ExecutionProviders& execution_providers) {
   for (const auto& execution_provider : execution_providers) {
     if (!ProviderIsCpuBased(execution_provider->Type())) {
@@ -357,11 +386,13 @@ void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
   feeds_fetches_manager.SetDeviceCopyChecks(input_copy, output_copy);
 }
 
-// Finalize the copy info using the OrtValue instances for the feeds and fetches
+// Finalize the copy info using the OrtValue instances for the feeds and fetches.
+// fetch_locations optionally has the device to return each fetch that is not preallocated on, or nullptr for CPU.
 static void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
                                       FeedsFetchesManager& feeds_fetches_manager,
                                       const std::vector<OrtValue>& feeds,
-                                      std::vector<OrtValue>& fetches) {
+                                      std::vector<OrtValue>& fetches,
+                                      const std::vector<const OrtMemoryInfo*>& fetch_locations = {}) {
   if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy)
     return;
 
@@ -385,6 +416,8 @@ static void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
     const auto& fetch = fetches[i];
     if (fetch.IsAllocated() && fetch.IsTensor()) {
       fetch_alloc_info[i] = &fetch.Get<Tensor>().Location();
+    } else if (i < fetch_locations.size()) {
+      fetch_alloc_info[i] = fetch_locations[i];
     }
   }
 
@@ -400,11 +433,7 @@ static common::Status CopyInputsAcrossDevices(const std::vector<OrtValue>& orig_
 
   new_feeds.resize(num_feeds);
 
-  for (size_t idx = 0; idx < num_feeds; ++idx) {
-    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], orig_feeds[idx], new_feeds[idx]));
-  }
-
-  return Status::OK();
+  return CopyMLValues(data_transfer_mgr, copy_info, orig_feeds, new_feeds);
 }
 
 // public method to do a single copy. used by external partners
@@ -432,31 +461,28 @@ static common::Status CopyOutputsAcrossDevices(const SessionState& session_state
   auto num_outputs = fetches.size();
   user_fetches.resize(num_outputs);
 
-  const auto& data_transfer_mgr = session_state.GetDataTransferMgr();
-
-  for (size_t idx = 0; idx < num_outputs; ++idx) {
-    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], fetches[idx], user_fetches[idx]));
-  }
-
-  return Status::OK();
+  return CopyMLValues(session_state.GetDataTransferMgr(), copy_info, fetches, user_fetches);
 }
 
 static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        const FeedsFetchesManager& feeds_fetches_manager,
                                        const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                                       ExecutionMode execution_mode, const bool& terminate_flag,
-                                       const logging::Logger& logger) {
+                                       ExecutionMode execution_mode, const bool& terminate_flag, DeadlineTimePoint deadline,
+                                       const logging::Logger& logger, int64_t* peak_allocated_bytes = nullptr) {
+  // a subgraph may defer loading its initializers until it is executed
+  ORT_RETURN_IF_ERROR(session_state.LoadDeferredInitializers());
+
   std::unique_ptr<IExecutor> p_exec;
   if (execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
+    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, deadline));
   } else if (execution_mode == ExecutionMode::ORT_PARALLEL) {
     auto* p_inter_op_thread_pool = session_state.GetInterOpThreadPool();
     if (!p_inter_op_thread_pool) {
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
-      p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
+      p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, deadline));
     } else {
-      p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+      p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag, deadline));
     }
   }
 
@@ -512,31 +538,60 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
     }
   }
 
+  if (peak_allocated_bytes != nullptr) {
+    *peak_allocated_bytes = p_exec->GetPeakAllocatedBytes();
+  }
+
   return Status::OK();
 }
 
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                            ExecutionMode execution_mode, const bool& terminate_flag,
+                            ExecutionMode execution_mode, const bool& terminate_flag, DeadlineTimePoint deadline,
                             const logging::Logger& logger) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
+  return ExecuteGraphWithInitializedCopyInfo(session_state, feeds_fetches_manager, feeds, fetches,
+                                             execution_mode, terminate_flag, deadline, logger);
+}
+
+common::Status ExecuteGraphWithInitializedCopyInfo(const SessionState& session_state,
+                                                   FeedsFetchesManager& feeds_fetches_manager,
+                                                   const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                   ExecutionMode execution_mode, const bool& terminate_flag,
+                                                   DeadlineTimePoint deadline, const logging::Logger& logger,
+                                                   int64_t* peak_allocated_bytes) {
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches);
 
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
-                                 execution_mode, terminate_flag, logger);
+                                 execution_mode, terminate_flag, deadline, logger, peak_allocated_bytes);
 
   return status;
 }
 
+common::Status ExecuteGraphWithInitializedCopyInfo(const SessionState& session_state,
+                                                   FeedsFetchesManager& feeds_fetches_manager,
+                                                   const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                                   const std::vector<const OrtMemoryInfo*>& fetch_locations,
+                                                   ExecutionMode execution_mode, const bool& terminate_flag,
+                                                   DeadlineTimePoint deadline, const logging::Logger& logger,
+                                                   int64_t* peak_allocated_bytes) {
+  FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches, fetch_locations);
+
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                          execution_mode, terminate_flag, deadline, logger, peak_allocated_bytes);
+}
+
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger) {
+                               ExecutionMode execution_mode, const bool& terminate_flag, DeadlineTimePoint deadline,
+                               const logging::Logger& logger) {
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 execution_mode, terminate_flag, logger);
+                                 execution_mode, terminate_flag, deadline, logger);
   return status;
 }
 
@@ -638,7 +693,15 @@ void DumpNodeOutputs(OpKernelContext& context, const Node& node, const SessionSt
             // check tensor is on CPU before dumping it
             auto& tensor_location = tensor.Location();
             const auto data_type = tensor.DataType();
-            if (tensor_location.device.Type() == OrtDevice::CPU || tensor_location.mem_type == OrtMemTypeCPUOutput) {
+            if (tensor.IsPackedStrings()) {
+              // packed strings are dumped from a copy with std::string elements
+              const auto* cpu_execution_provider =
+                  session_state.GetExecutionProviders().Get(onnxruntime::kCpuExecutionProvider);
+              OrtValue unpacked;
+              UnpackStrings(tensor, cpu_execution_provider->GetAllocator(0, OrtMemTypeDefault), unpacked);
+              DumpTensor<std::string>(unpacked.Get<Tensor>(), shape);
+            } else if (tensor_location.device.Type() == OrtDevice::CPU ||
+                       tensor_location.mem_type == OrtMemTypeCPUOutput) {
               DispatchOnTensorType(data_type, DumpTensor, tensor, shape);
             } else {
               std::cout << tensor_location << "\n";
@@ -73,14 +73,38 @@ void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
 // Execute the main graph. The feed_fetches_manager will be finalized based on the provided feeds and fetches.
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                            ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger);
+                            ExecutionMode execution_mode, const bool& terminate_flag, DeadlineTimePoint deadline,
+                            const logging::Logger& logger);
+
+// Execute the main graph with a feeds_fetches_manager that InitializeFeedFetchCopyInfo was already called for.
+// Runs that use the same feed and fetch names can share the static copy info this way, as long as they run
+// one after the other.
+// If peak_allocated_bytes is not null it's set to the peak bytes of the tensors allocated by the run.
+common::Status ExecuteGraphWithInitializedCopyInfo(const SessionState& session_state,
+                                                   FeedsFetchesManager& feeds_fetches_manager,
+                                                   const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                   ExecutionMode execution_mode, const bool& terminate_flag,
+                                                   DeadlineTimePoint deadline, const logging::Logger& logger,
+                                                   int64_t* peak_allocated_bytes = nullptr);
+
+// As above, with custom allocators for some of the fetches. fetch_locations has the device each fetch that is not
+// preallocated is returned on, or nullptr to return it on CPU.
+common::Status ExecuteGraphWithInitializedCopyInfo(const SessionState& session_state,
+                                                   FeedsFetchesManager& feeds_fetches_manager,
+                                                   const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                                   const std::vector<const OrtMemoryInfo*>& fetch_locations,
+                                                   ExecutionMode execution_mode, const bool& terminate_flag,
+                                                   DeadlineTimePoint deadline, const logging::Logger& logger,
+                                                   int64_t* peak_allocated_bytes = nullptr);
 
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger);
+                               ExecutionMode execution_mode, const bool& terminate_flag, DeadlineTimePoint deadline,
+                               const logging::Logger& logger);
 
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 // to create a build with these enabled run the build script with 1 to dump just shapes, or 2 to dump shapes and data
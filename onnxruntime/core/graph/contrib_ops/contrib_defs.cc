@@ -28,6 +28,8 @@ void matmulShapeInference(
     int input1Idx,
     int input2Idx);
 
+void RNNShapeInference(InferenceContext& ctx);
+
 void convTransposeWithDynamicPadsShapeInference(InferenceContext& ctx) {
   propagateElemTypeFromInputToOutput(ctx, 0, 0);
 
@@ -201,6 +203,50 @@ void NchwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
   });
 }
 
+// The attributes, outputs and quantization parameter inputs shared by the DynamicQuantize RNN operators.
+// The weight inputs follow the inputs of the float operator.
+void DynamicQuantizeRNNOpSchemaGenerator(OpSchema& schema, int first_quantization_input) {
+  schema.SetDomain(kMSDomain);
+  schema.SinceVersion(1);
+  schema.Attr("direction",
+              "Specify if the RNN is forward, reverse, or bidirectional. Must be one of "
+              "forward (default), reverse, or bidirectional.",
+              AttributeProto::STRING, std::string("forward"));
+  schema.Attr("hidden_size", "Number of neurons in the hidden layer.", AttributeProto::INT, OPTIONAL);
+  schema.Attr("activations", "A list of activation functions, as in the float operator.",
+              AttributeProto::STRINGS, OPTIONAL);
+  schema.Attr("activation_alpha", "Optional scaling values used by some activation functions.",
+              AttributeProto::FLOATS, OPTIONAL);
+  schema.Attr("activation_beta", "Optional scaling values used by some activation functions.",
+              AttributeProto::FLOATS, OPTIONAL);
+  schema.Attr("clip", "Cell clip threshold. No clip if not specified.", AttributeProto::FLOAT, OPTIONAL);
+  schema.Input(first_quantization_input, "W_scale",
+               "Scale of W. It has shape `[num_directions]` for per tensor quantization or "
+               "`[num_directions, num_gates*hidden_size]` for per channel quantization.",
+               "T");
+  schema.Input(first_quantization_input + 1, "W_zero_point",
+               "Zero point of W with the shape of W_scale. Optional: assumed to be 0 if not specified.",
+               "T2", OpSchema::Optional);
+  schema.Input(first_quantization_input + 2, "R_scale",
+               "Scale of R. It has shape `[num_directions]` for per tensor quantization or "
+               "`[num_directions, num_gates*hidden_size]` for per channel quantization.",
+               "T");
+  schema.Input(first_quantization_input + 3, "R_zero_point",
+               "Zero point of R with the shape of R_scale. Optional: assumed to be 0 if not specified.",
+               "T2", OpSchema::Optional);
+  schema.Output(0, "Y",
+                "A tensor that concats all the intermediate output values of the hidden. "
+                "It has shape `[seq_length, num_directions, batch_size, hidden_size]`.",
+                "T", OpSchema::Optional);
+  schema.Output(1, "Y_h",
+                "The last output value of the hidden. It has shape `[num_directions, batch_size, hidden_size]`.",
+                "T", OpSchema::Optional);
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.");
+  schema.TypeConstraint("T1", {"tensor(int32)"}, "Constrain seq_lens to integer tensor.");
+  schema.TypeConstraint("T2", {"tensor(int8)"}, "Constrain the weights and their zero points to int8 tensors.");
+  schema.TypeAndShapeInferenceFunction(ONNX_NAMESPACE::RNNShapeInference);
+}
+
 void ValidateTypeAndShapeForScaleAndZP(ONNX_NAMESPACE::InferenceContext& ctx, int index, ::google::protobuf::int32 expectedType, bool isScalar, int expectedTensorSize = 0) {
   if (ctx.getNumInputs() > static_cast<size_t>(index)) {
     auto data_type = ctx.getInputType(index);
@@ -326,13 +372,38 @@ void RegisterNchwcSchemas() {
       .SetDomain(kMSNchwcDomain)
       .SinceVersion(1)
       .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "channels_last",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(0, "X", "", "T")
       .Output(0, "Y", "", "T")
       .TypeConstraint(
           "T",
           {"tensor(float)", "tensor(int8)", "tensor(uint8)"},
           "Constrain input and output types to float/quantized tensors")
-      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        if (getAttribute(ctx, "channels_last", 0) == 0) {
+          propagateShapeFromInputToOutput(ctx, 0, 0);
+          return;
+        }
+
+        // Permute the NHWC input shape to the NCHW output shape.
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("tensor must have rank 4");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        *output_shape->add_dim() = input_shape.dim(3);
+        *output_shape->add_dim() = input_shape.dim(1);
+        *output_shape->add_dim() = input_shape.dim(2);
+      });
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderOutput)
       .SetDomain(kMSNchwcDomain)
@@ -343,6 +414,11 @@ void RegisterNchwcSchemas() {
           "",
           AttributeProto::INT,
           static_cast<int64_t>(0))
+      .Attr(
+          "channels_last",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(0, "X", "", "T")
       .Output(0, "Y", "", "T")
       .TypeConstraint(
@@ -368,6 +444,18 @@ void RegisterNchwcSchemas() {
         auto* channels_dim = output_shape->mutable_dim(1);
         channels_dim->clear_dim_param();
         channels_dim->set_dim_value(channels);
+
+        // Permute the NCHW output shape to NHWC.
+        if (getAttribute(ctx, "channels_last", 0) != 0) {
+          if (output_shape->dim_size() != 4) {
+            fail_shape_inference("tensor must have rank 4");
+          }
+          auto channels_dim_proto = output_shape->dim(1);
+          for (int i = 1; i < 3; i++) {
+            *output_shape->mutable_dim(i) = output_shape->dim(i + 1);
+          }
+          *output_shape->mutable_dim(3) = channels_dim_proto;
+        }
       });
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(Conv)
@@ -445,23 +533,99 @@ void RegisterNchwcSchemas() {
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
       .FillUsing(NchwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "scales",
+          "",
+          AttributeProto::INTS)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("input must be 4D tensor");
+        }
+
+        std::vector<int64_t> scales;
+        if (!getRepeatedAttribute(ctx, "scales", scales) || scales.size() != 4) {
+          fail_shape_inference("scales must have 4 values");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < 4; i++) {
+          auto& input_dim = input_shape.dim(i);
+          if (scales[i] == 1) {
+            *output_shape->add_dim() = input_dim;
+          } else if (input_dim.has_dim_value()) {
+            output_shape->add_dim()->set_dim_value(input_dim.dim_value() * scales[i]);
+          } else {
+            output_shape->add_dim();
+          }
+        }
+      });
 }
 
 void RegisterBertSchemas() {
+  static const char* Attention_ver1_doc = R"DOC(
+Multi-Head Self Attention that can be either unidirectional (like GPT-2) or bidirectional (like BERT).
+The mask_index input is the number of keys that can be attended to in each batch.
+When the optional past input is given, the keys and values of previous tokens are taken from past and
+attention is only computed for the tokens of the current input. The optional present output holds the
+keys and values of past and of the current input, and can be fed back as past for the next step.)DOC";
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
       .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
-      .SetDoc("Multi-Head Self Attention")
+      .SetDoc(Attention_ver1_doc)
       .Attr("num_heads", "Number of attention heads", AttributeProto::INT)
+      .Attr("unidirectional",
+            "Whether every token can only attend to previous tokens. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
       .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size), hidden_size = num_heads * head_size", "T")
       .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
       .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
-      .Input(3, "mask_index", "Attention mask index with shape (batch_size)", "M")
+      .Input(3, "mask_index", "Attention mask index with shape (batch_size). It is the number of keys, including the past, that can be attended to", "M")
+      .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).", "T", OpSchema::Optional)
       .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Output(1, "present", "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)", "T", OpSchema::Optional)
       .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
       .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index to integer types")
-      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput(ctx);
+
+        if (ctx.getNumOutputs() > 1) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 1);
+
+          if (hasInputShape(ctx, 0) && ctx.getNumInputs() > 4 && hasInputShape(ctx, 4)) {
+            auto& input_shape = getInputShape(ctx, 0);
+            auto& past_shape = getInputShape(ctx, 4);
+            if (input_shape.dim_size() == 3 && past_shape.dim_size() == 5) {
+              ONNX_NAMESPACE::TensorShapeProto present_shape = past_shape;
+              auto& sequence_dim = input_shape.dim(1);
+              auto& past_sequence_dim = past_shape.dim(3);
+              auto* present_sequence_dim = present_shape.mutable_dim(3);
+              present_sequence_dim->clear_dim_value();
+              present_sequence_dim->clear_dim_param();
+              if (sequence_dim.has_dim_value() && past_sequence_dim.has_dim_value()) {
+                present_sequence_dim->set_dim_value(sequence_dim.dim_value() + past_sequence_dim.dim_value());
+              }
+              updateOutputShape(ctx, 1, present_shape);
+            }
+          }
+        }
+      });
 
   static const char* EmbedLayerNormalization_ver1_doc = R"DOC(
 EmbedLayerNormalization is the fusion of embedding layer in BERT model, with optional mask processing.
@@ -1176,7 +1340,8 @@ Sample echo operator.)DOC");
       .SinceVersion(1)
       .SetDoc(R"DOC(
 The fused convolution operator schema is the same as Conv besides it includes an attribute
-activation.)DOC")
+activation and an optional input Z. If Z is provided, it is summed into the output of the
+convolution before the bias and the activation are applied.)DOC")
       .Attr(
           "auto_pad",
           "",
@@ -1233,6 +1398,12 @@ activation.)DOC")
           "",
           "T",
           OpSchema::Optional)
+      .Input(
+          3,
+          "Z",
+          "Tensor with the same shape as the output that is summed into the output.",
+          "T",
+          OpSchema::Optional)
       .Output(
           0,
           "Y",
@@ -1334,6 +1505,127 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(TransposeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product that behaves like numpy.matmul, in which the last two dimensions of A and/or B are swapped first.
+It replaces a MatMul consuming the output of a Transpose which only swaps those dimensions.)DOC")
+      .Input(0, "A", "N-dimensional matrix A. It must have at least 2 dimensions if transA is non-zero.", "T")
+      .Input(1, "B", "N-dimensional matrix B. It must have at least 2 dimensions if transA or transB is non-zero.", "T")
+      .Output(0, "Y", "Matrix multiply results", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .Attr("transA", "Whether the last two dimensions of A should be transposed", AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("transB", "Whether the last two dimensions of B should be transposed", AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 2)) {
+          return;
+        }
+
+        const bool transA = getAttribute(ctx, "transA", 0) != 0;
+        const bool transB = getAttribute(ctx, "transB", 0) != 0;
+        const auto& shape0 = getInputShape(ctx, 0);
+        const auto& shape1 = getInputShape(ctx, 1);
+        if (shape0.dim_size() == 0 || shape1.dim_size() == 0) {
+          fail_shape_inference("Input tensors of wrong rank (0).");
+        }
+        if ((transA && (shape0.dim_size() < 2 || shape1.dim_size() < 2)) || (transB && shape1.dim_size() < 2)) {
+          fail_shape_inference("Transposed inputs must have at least 2 dimensions.");
+        }
+
+        // promote each shape to at least rank 2 like MatMul, and apply the transposes
+        TensorShapeProto shapeL, shapeR;
+        if (shape0.dim_size() == 1) {
+          shapeL.add_dim()->set_dim_value(1);
+          *shapeL.add_dim() = shape0.dim(0);
+        } else {
+          *shapeL.mutable_dim() = shape0.dim();
+          if (transA) {
+            shapeL.mutable_dim()->SwapElements(shapeL.dim_size() - 2, shapeL.dim_size() - 1);
+          }
+        }
+        if (shape1.dim_size() == 1) {
+          *shapeR.add_dim() = shape1.dim(0);
+          shapeR.add_dim()->set_dim_value(1);
+        } else {
+          *shapeR.mutable_dim() = shape1.dim();
+          if (transB) {
+            shapeR.mutable_dim()->SwapElements(shapeR.dim_size() - 2, shapeR.dim_size() - 1);
+          }
+        }
+
+        const auto& dimL = shapeL.dim(shapeL.dim_size() - 1);
+        const auto& dimR = shapeR.dim(shapeR.dim_size() - 2);
+        if (dimL.has_dim_value() && dimR.has_dim_value() && dimL.dim_value() != dimR.dim_value()) {
+          fail_shape_inference("Incompatible dimensions for matrix multiplication");
+        }
+
+        // broadcast the dimensions preceding the matrices
+        TensorShapeProto resultShape;
+        TensorShapeProto prefixShapeL, prefixShapeR;
+        for (int i = 0; i < shapeL.dim_size() - 2; ++i) {
+          *prefixShapeL.add_dim() = shapeL.dim(i);
+        }
+        for (int i = 0; i < shapeR.dim_size() - 2; ++i) {
+          *prefixShapeR.add_dim() = shapeR.dim(i);
+        }
+        bidirectionalBroadcastShapeInference(prefixShapeL, prefixShapeR, resultShape);
+
+        if (shape0.dim_size() != 1) {
+          *resultShape.add_dim() = shapeL.dim(shapeL.dim_size() - 2);
+        }
+        if (shape1.dim_size() != 1) {
+          *resultShape.add_dim() = shapeR.dim(shapeR.dim_size() - 1);
+        }
+        *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape() = resultShape;
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseGemm)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Computes Y = alpha * A * B + beta * C, in which B is a mostly zero (K, N) matrix packed by MlasSparseGemmPackB.
+It replaces a MatMul or Gemm with a pruned constant weight, so that only the non-zero values of the weight are stored.
+If transA is 0, A is (..., K) and Y is (..., N) like MatMul, else A is (K, M) and Y is (M, N).)DOC")
+      .Input(0, "A", "Input tensor A.", "T")
+      .Input(1, "B", "The packed matrix B.", "tensor(uint8)")
+      .Input(2, "C", "Optional input tensor C, which should be unidirectional broadcastable to (M, N).", "T",
+             OpSchema::Optional)
+      .Output(0, "Y", "Output tensor.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .Attr("N", "The number of columns of matrix B.", AttributeProto::INT)
+      .Attr("K", "The number of rows of matrix B.", AttributeProto::INT)
+      .Attr("transA", "Whether A should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("alpha", "Scalar multiplier for the product of input tensors A * B.", AttributeProto::FLOAT, 1.0f)
+      .Attr("beta", "Scalar multiplier for input tensor C.", AttributeProto::FLOAT, 1.0f)
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        const auto& shape = getInputShape(ctx, 0);
+        const bool transA = getAttribute(ctx, "transA", 0) != 0;
+        const int64_t N = getAttribute(ctx, "N", 0);
+        if (shape.dim_size() == 0 || (transA && shape.dim_size() != 2)) {
+          fail_shape_inference("Input tensor A has the wrong rank.");
+        }
+
+        TensorShapeProto resultShape;
+        if (transA) {
+          *resultShape.add_dim() = shape.dim(1);
+        } else {
+          for (int i = 0; i < shape.dim_size() - 1; ++i) {
+            *resultShape.add_dim() = shape.dim(i);
+          }
+        }
+        resultShape.add_dim()->set_dim_value(N);
+        *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape() = resultShape;
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1961,6 +2253,42 @@ Output = Dequantize(Input) -> AveragePool on fp32 data -> Quantize(output)
         ONNX_NAMESPACE::convPoolShapeInference(ctx, false, true, 0, 5);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(QLinearGlobalAveragePool)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+QLinearGlobalAveragePool consumes an input tensor X and applies average pooling across the values in the same
+channel, like GlobalAveragePool. Input and output scales and zero points are used to convert the output to a new
+quantization range.
+Output = Dequantize(Input) -> GlobalAveragePool on fp32 data -> Quantize(output)
+)DOC")
+      .Input(0, "X", "Input data tensor from the previous operator; dimensions are (N x C x D1 x D2 ... Dn).", "T")
+      .Input(1, "x_scale", "Input scale. It's a scalar, which means a per-tensor/layer quantization.", "tensor(float)")
+      .Input(2, "x_zero_point",
+             "Input zero point. Default value is 0 if it's not specified. It's a scalar, which means a per-tensor/layer quantization.",
+             "T", OpSchema::Optional)
+      .Input(3, "y_scale", "Output scale. It's a scalar, which means a per-tensor/layer quantization.", "tensor(float)")
+      .Input(4, "y_zero_point",
+             "Output zero point. Default value is 0 if it's not specified. It's a scalar, which means a per-tensor/layer quantization.",
+             "T", OpSchema::Optional)
+      .Output(0, "Y", "Output data tensor from pooling across the input tensor. The output tensor has the same rank "
+              "as the input, with the spatial dimensions of size 1.", "T")
+      .TypeConstraint("T", {"tensor(uint8)", "tensor(int8)"}, "Constrain input and output types to 8 bit tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        auto data_type = ctx.getInputType(0);
+        if (nullptr == data_type || data_type->value_case() != ONNX_NAMESPACE::TypeProto::kTensorType) {
+          fail_type_inference("inputs are expected to have tensor type.");
+        }
+
+        // validate scale and zero points
+        ValidateTypeAndShapeForScaleAndZP(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT, true);
+        ValidateTypeAndShapeForScaleAndZP(ctx, 2, data_type->tensor_type().elem_type(), true);
+        ValidateTypeAndShapeForScaleAndZP(ctx, 3, ONNX_NAMESPACE::TensorProto::FLOAT, true);
+        ValidateTypeAndShapeForScaleAndZP(ctx, 4, data_type->tensor_type().elem_type(), true);
+
+        ONNX_NAMESPACE::globalPoolTypeShapeInference(ctx);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(MurmurHash3)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -2479,6 +2807,122 @@ It's an extension of Gelu. It takes the sum of input A and bias input B as the i
           "Constrain input and output types to float tensors.")
       .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
 
+  static const char* FusedElementwise_ver1_doc = R"DOC(
+Applies a chain of element-wise operations to the input X in a single pass, without materializing the
+intermediate results. The operations run in order on the running value, which starts as X.
+
+Each binary operation combines the running value with one of the inputs, selected by operand_indices
+(0 selects X itself). The operand must have the shape of X, hold a single element, or be a vector that matches
+the last dimension of X. operand_positions gives the position of the operand in the original operation, 0 for
+"operand OP value" and 1 for "value OP operand". Unary operations use -1 for both attributes.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetSupportLevel(OpSchema::SupportType::EXPERIMENTAL)
+      .SetDoc(FusedElementwise_ver1_doc)
+      .Attr("operations",
+            "The element-wise operations to apply: Add, Sub, Mul, Div, Relu, Sigmoid, Tanh, Exp, Log, Neg, Abs, "
+            "Sqrt or Erf.",
+            AttributeProto::STRINGS)
+      .Attr("operand_indices", "The input providing the second operand of each operation, or -1.", AttributeProto::INTS)
+      .Attr("operand_positions", "The position of the second operand in each operation, or -1.", AttributeProto::INTS)
+      .Input(0, "inputs", "The input tensor X, followed by the extra operands of the binary operations.", "T",
+             OpSchema::Variadic)
+      .Output(0, "Y", "The output tensor, of the same shape as X.", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  static const char* DynamicQuantizeLSTM_ver1_doc = R"DOC(
+Computes a one-layer LSTM like the ONNX LSTM operator with int8 weights. W and R have the layout of the float
+operator and are dequantized with a scale and zero point per direction, or per row for per channel quantization.
+The input and the hidden state of each step are quantized to uint8 using their range, so the input and recurrent
+projections run as integer matrix multiplications.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeLSTM)
+      .FillUsing([](OpSchema& schema) { DynamicQuantizeRNNOpSchemaGenerator(schema, 8); })
+      .SetDoc(DynamicQuantizeLSTM_ver1_doc)
+      .Attr("input_forget", "Couple the input and forget gates if 1.", AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "X", "The input sequences with the shape of `[seq_length, batch_size, input_size]`.", "T")
+      .Input(1, "W", "The int8 weight tensor for the gates with the shape `[num_directions, 4*hidden_size, input_size]`.", "T2")
+      .Input(2, "R", "The int8 recurrence weight tensor with the shape `[num_directions, 4*hidden_size, hidden_size]`.", "T2")
+      .Input(3, "B", "The bias tensor with the shape `[num_directions, 8*hidden_size]`.", "T", OpSchema::Optional)
+      .Input(4, "sequence_lens", "The lengths of the sequences in the batch. It has shape `[batch_size]`.", "T1",
+             OpSchema::Optional)
+      .Input(5, "initial_h", "The initial value of the hidden with the shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(6, "initial_c", "The initial value of the cell with the shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(7, "P", "The weight tensor for peepholes with the shape `[num_directions, 3*hidden_size]`.", "T",
+             OpSchema::Optional)
+      .Output(2, "Y_c", "The last output value of the cell. It has shape `[num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional);
+
+  static const char* DynamicQuantizeGRU_ver1_doc = R"DOC(
+Computes a one-layer GRU like the ONNX GRU operator with int8 weights. W and R have the layout of the float
+operator and are dequantized with a scale and zero point per direction, or per row for per channel quantization.
+The input and the hidden state of each step are quantized to uint8 using their range, so the input and recurrent
+projections run as integer matrix multiplications.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeGRU)
+      .FillUsing([](OpSchema& schema) { DynamicQuantizeRNNOpSchemaGenerator(schema, 6); })
+      .SetDoc(DynamicQuantizeGRU_ver1_doc)
+      .Attr("linear_before_reset", "Apply the linear transformation before multiplying by the output of the reset gate.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "X", "The input sequences with the shape of `[seq_length, batch_size, input_size]`.", "T")
+      .Input(1, "W", "The int8 weight tensor for the gates with the shape `[num_directions, 3*hidden_size, input_size]`.", "T2")
+      .Input(2, "R", "The int8 recurrence weight tensor with the shape `[num_directions, 3*hidden_size, hidden_size]`.", "T2")
+      .Input(3, "B", "The bias tensor with the shape `[num_directions, 6*hidden_size]`.", "T", OpSchema::Optional)
+      .Input(4, "sequence_lens", "The lengths of the sequences in the batch. It has shape `[batch_size]`.", "T1",
+             OpSchema::Optional)
+      .Input(5, "initial_h", "The initial value of the hidden with the shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional);
+
+  static const char* DynamicQuantizeMatMul_ver1_doc = R"DOC(
+Matrix product that behaves like numpy.matmul of a float A with a quantized B. A is quantized to uint8 with the
+scale and zero point of its range, like DynamicQuantizeLinear, and the integer product is scaled back to float with
+the scales of A and B and added to the optional bias. It replaces the DynamicQuantizeLinear, MatMulInteger, Cast
+and Mul nodes of a dynamically quantized MatMul.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(DynamicQuantizeMatMul_ver1_doc)
+      .Input(0, "A", "N-dimensional matrix A", "T1")
+      .Input(1, "B", "N-dimensional quantized matrix B", "T2")
+      .Input(2, "b_scale", "Scale of B. It's a scalar or a 1-D tensor with one value per column of B.", "T1")
+      .Input(3, "b_zero_point", "Zero point of B, with the shape of b_scale. It's 0 if not specified.", "T2",
+             OpSchema::Optional)
+      .Input(4, "bias", "1-D tensor with one value per column of B, added to the result.", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, b_scale, bias and output Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain input B and its zero point to 8-bit integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        matmulShapeInference(ctx, 0, 1);
+      });
+
+  static const char* Einsum_ver1_doc = R"DOC(
+Sums the products of the elements of the inputs along the labels of an equation in the Einstein summation
+convention, like numpy.einsum. The equation has a comma separated term for each input and an optional output term
+after "->", such as "bij,bjk->bik". Each letter of a term labels a dimension, and a term may have one ellipsis "..."
+for the dimensions it doesn't label, which broadcast against those of the other inputs. The labels of the inputs
+that are not in the output are summed. Without an output term, the output has the ellipsis dimensions followed by
+the labels that appear once, in alphabetical order.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Einsum)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(Einsum_ver1_doc)
+      .Attr("equation", "The Einsum equation.", AttributeProto::STRING)
+      .Input(0, "Inputs", "The operands of the equation.", "T", OpSchema::Variadic)
+      .Output(0, "Output", "The result of the equation.", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)", "tensor(double)"},
+                      "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+      });
+
   RegisterBertSchemas();
 
 #ifdef MICROSOFT_INTERNAL
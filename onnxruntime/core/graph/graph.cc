@@ -83,6 +83,18 @@ static Status MergeShapeInfo(const std::string& output_name,
   return Status::OK();
 }
 
+// Clearing RepeatedPtrFields does not free objects' memory. The memory is retained
+// and can be reused. Need to explicitly release the cleared objects and free the
+// memory.
+template <typename T>
+static void ClearAndFree(google::protobuf::RepeatedPtrField<T>& field) {
+  field.Clear();
+  const int num_cleared = field.ClearedCount();
+  for (int i = 0; i < num_cleared; i++) {
+    delete field.ReleaseCleared();
+  }
+}
+
 static bool GraphLoadedFromModelFile(const GraphProto* graph_proto) {
   return graph_proto && (graph_proto->node_size() != 0 ||
                          graph_proto->output_size() != 0);
@@ -172,14 +184,37 @@ const TensorShapeProto* NodeArg::Shape() const {
   }
 }
 
+static bool ShapesEqual(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    const auto& l = lhs.dim(i);
+    const auto& r = rhs.dim(i);
+    if (l.value_case() != r.value_case() ||
+        (utils::HasDimValue(l) && l.dim_value() != r.dim_value()) ||
+        (utils::HasDimParam(l) && l.dim_param() != r.dim_param())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  const TensorShapeProto* existing_shape = Shape();
+  if (existing_shape != nullptr && ShapesEqual(*existing_shape, shape)) {
+    return;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
       *(node_arg_info_.mutable_type()->mutable_tensor_type()->mutable_shape()) = shape;
+      type_changed_ = true;
       break;
     case TypeProto::kSparseTensorType:
       *(node_arg_info_.mutable_type()->mutable_sparse_tensor_type()->mutable_shape()) = shape;
+      type_changed_ = true;
       break;
     case TypeProto::kSequenceType:
     case TypeProto::kMapType:
@@ -191,6 +226,11 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
 }
 
 void NodeArg::ClearShape() {
+  if (Shape() == nullptr) {
+    return;
+  }
+
+  type_changed_ = true;
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -212,6 +252,7 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
   if (!utils::HasType(node_arg_info_)) {
     *node_arg_info_.mutable_type() = input_type;
     type_ = DataTypeUtils::ToType(node_arg_info_.type());
+    type_changed_ = true;
     return Status::OK();
   }
 
@@ -237,9 +278,14 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
       if (utils::HasShape(input_tensor_type)) {
         auto& current_tensor_type = *current_type.mutable_tensor_type();
         if (utils::HasShape(current_tensor_type)) {
+          const TensorShapeProto existing_shape = current_tensor_type.shape();
           ORT_RETURN_IF_ERROR(MergeShapeInfo(Name(), input_tensor_type, current_tensor_type, strict, logger));
+          if (!utils::HasShape(current_tensor_type) || !ShapesEqual(existing_shape, current_tensor_type.shape())) {
+            type_changed_ = true;
+          }
         } else {
           current_tensor_type = input_tensor_type;
+          type_changed_ = true;
         }
       }
 
@@ -262,6 +308,7 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
           // mergeInShapeInfo(input_tensor_type, current_tensor_type);
         } else {
           current_tensor_type = input_tensor_type;
+          type_changed_ = true;
         }
       }
     } break;
@@ -291,11 +338,13 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  type_changed_ = true;
 }
 
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  type_changed_ = true;
 }
 
 bool NodeArg::Exists() const noexcept {
@@ -496,6 +545,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_needed_ = true;
   attributes_[attr_name] = value;
 }
 
@@ -503,6 +553,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inference_needed_ = true;                                                \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -514,6 +565,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inference_needed_ = true;                                                \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -526,6 +578,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inference_needed_ = true;                                \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -538,6 +591,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_needed_ = true;
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -562,6 +616,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_needed_ = true;
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -730,15 +785,26 @@ Graph::Graph(GraphProto* graph_proto, const std::unordered_map<std::string, int>
     // Copy constant nodes _value to name_to_initial_tensor_
     const gsl::not_null<TensorProto*> tensor{graph_proto_->add_initializer()};
     const AttributeProto& constant_attribute = node.attribute(0);
-    // TODO: Add support for parsing 'sparse_value' attribute from a 'Constant' node
-    // Discussion surrounding handling the SparseTensorProto must be had.
-    // An easy way is to implement a method that converts a SparseTensorproto into a TensorProto
-    // to use the same downstream flow, but that is going to impact peak memory usage and probably a smarter way is required.
-    ORT_ENFORCE(constant_attribute.has_t(), "Only 'value' attribute is supported within a 'Constant' node in ORT");
-    *tensor = constant_attribute.t();
+    // a 'sparse_value' is densified like a sparse initializer
+    if (constant_attribute.has_sparse_tensor()) {
+      ORT_THROW_IF_ERROR(utils::SparseTensorProtoToDenseTensorProto(constant_attribute.sparse_tensor(), *tensor));
+    } else {
+      ORT_ENFORCE(constant_attribute.has_t(),
+                  "Only 'value' and 'sparse_value' attributes are supported within a 'Constant' node in ORT");
+      *tensor = constant_attribute.t();
+    }
     *(tensor->mutable_name()) = node.output(0);
   }
 
+  // Densify the sparse initializers so they are used like the other initializers. This keeps pruned models small
+  // on disk, and the kernels that benefit from the zeros, e.g. MatMul and Gemm on CPU, pack the non-zero values of
+  // the initializers they use.
+  for (const auto& sparse_tensor : graph_proto_->sparse_initializer()) {
+    const gsl::not_null<TensorProto*> tensor{graph_proto_->add_initializer()};
+    ORT_THROW_IF_ERROR(utils::SparseTensorProtoToDenseTensorProto(sparse_tensor, *tensor));
+  }
+  graph_proto_->clear_sparse_initializer();
+
   // Remove constant nodes as they're replaced with initializers above.
   const gsl::not_null<RepeatedPtrField<NodeProto>*> graph_mutable_nodes{graph_proto_->mutable_node()};
   graph_mutable_nodes->erase(
@@ -803,6 +869,15 @@ Graph::Graph(GraphProto* graph_proto, const std::unordered_map<std::string, int>
   for (const auto& node_proto : graph_proto_->node()) {
     AddNode(node_proto, name_to_type_map);
   }
+
+  // The Nodes hold their own copies of the NodeProto content, so the NodeProtos of the main graph are released
+  // rather than kept alongside the Nodes for the lifetime of the model. ToGraphProto regenerates them.
+  // A subgraph's GraphProto is an attribute of its parent node that is read directly, so that is left as is.
+  // The graph outputs are kept, so GraphLoadedFromModelFile is unchanged.
+  if (parent_graph_ == nullptr && graph_proto_->output_size() != 0 && graph_proto_->node_size() != 0) {
+    ClearAndFree(*graph_proto_->mutable_node());
+    node_protos_released_ = true;
+  }
 }
 
 Graph::Graph(Graph& parent_graph, const Node& parent_node, ONNX_NAMESPACE::GraphProto& subgraph_proto)
@@ -1754,6 +1829,41 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+bool Graph::NodeInferenceNeeded(const Node& node) {
+  // a subgraph may have changed without any change to the node containing it
+  if (node.inference_needed_ || node.op_ == nullptr || node.ContainsSubgraph()) {
+    return true;
+  }
+
+  const auto& definitions = node.GetDefinitions();
+  auto inferred_def = node.inferred_defs_.cbegin();
+  const auto inferred_end = node.inferred_defs_.cend();
+  for (const auto* defs : {&definitions.input_defs, &definitions.implicit_input_defs, &definitions.output_defs}) {
+    for (const NodeArg* def : *defs) {
+      if (inferred_def == inferred_end || *inferred_def != def || (def->Exists() && def->type_changed_)) {
+        return true;
+      }
+      ++inferred_def;
+    }
+    // the defs of each kind are terminated by a nullptr
+    if (inferred_def == inferred_end || *inferred_def != nullptr) {
+      return true;
+    }
+    ++inferred_def;
+  }
+  return inferred_def != inferred_end;
+}
+
+void Graph::RecordNodeInference(Node& node) {
+  const auto& definitions = node.GetDefinitions();
+  node.inferred_defs_.clear();
+  for (const auto* defs : {&definitions.input_defs, &definitions.implicit_input_defs, &definitions.output_defs}) {
+    node.inferred_defs_.insert(node.inferred_defs_.end(), defs->cbegin(), defs->cend());
+    node.inferred_defs_.push_back(nullptr);
+  }
+  node.inference_needed_ = false;
+}
+
 Status Graph::VerifyNodeAndOpMatch() {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
@@ -1776,10 +1886,22 @@ Status Graph::VerifyNodeAndOpMatch() {
   // and need to call Resolve
   lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
 
+  // The main graph only repeats the verification and type/shape inferencing of the nodes that changed since the
+  // last Resolve, or whose inputs changed type or shape, which includes the consumers of the outputs of any node
+  // whose inferred output types changed. Subgraphs are always inferred as a whole via the node containing them.
+  const bool incremental = parent_graph_ == nullptr;
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
+    if (incremental && !NodeInferenceNeeded(node)) {
+      for (const auto* output_def : node.OutputDefs()) {
+        lsc.output_names.insert(output_def->Name());
+      }
+      continue;
+    }
+
     NodeProto node_proto;
     node.ToProto(node_proto);
     auto& node_name = node.Name();
@@ -1853,6 +1975,7 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
 
     NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    RecordNodeInference(node);
 
     // Accumulate output names of the iterated Node
     for (auto& output_name : node_proto.output()) {
@@ -1860,6 +1983,13 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
   }
 
+  if (incremental) {
+    // every changed type and shape has been propagated to the nodes using it
+    for (auto& node_arg : node_args_) {
+      node_arg.second->type_changed_ = false;
+    }
+  }
+
   return Status::OK();
 }
 
@@ -2034,6 +2164,15 @@ void Graph::SetDescription(const std::string& description) {
   graph_proto_->set_doc_string(description);
 }
 
+void Graph::MarkInitializerChanged(const std::string& name) {
+  // the type/shape inferencing of a node may use the values of constant initializers, so treat a change to the
+  // value as a change to the type of the initializer for the nodes consuming it.
+  auto* node_arg = GetNodeArg(name);
+  if (node_arg != nullptr) {
+    node_arg->type_changed_ = true;
+  }
+}
+
 void Graph::AddInitializedTensor(const TensorProto& tensor) {
   auto existing = name_to_initial_tensor_.find(tensor.name());
   if (existing != name_to_initial_tensor_.cend()) {
@@ -2045,6 +2184,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  MarkInitializerChanged(tensor.name());
 
   if (!GraphLoadedFromModelFile(graph_proto_) && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
@@ -2078,6 +2218,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   found = iter != name_to_initial_tensor_.end();
   if (found) {
     name_to_initial_tensor_.erase(tensor_name);
+    MarkInitializerChanged(tensor_name);
     SetGraphResolveNeeded();
   }
 
@@ -2126,6 +2267,7 @@ Status Graph::ReplaceInitializedTensor(const ONNX_NAMESPACE::TensorProto& new_in
               "graph_proto_ is not in sync with name_to_initial_tensor_");
 
   **existing_entry = new_initializer;
+  MarkInitializerChanged(initializer_name);
 
   return Status::OK();
 }
@@ -2142,15 +2284,7 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
 
 void Graph::CleanAllInitializedTensors() noexcept {
   name_to_initial_tensor_.clear();
-
-  // Clearing RepeatedPtrFields does not free objects' memory. The memory is retained
-  // and can be reused. Need to explicitly release the cleared objects and free the
-  // memory.
-  graph_proto_->mutable_initializer()->Clear();
-  const int num_cleared = graph_proto_->initializer().ClearedCount();
-  for (int i = 0; i < num_cleared; i++) {
-    delete graph_proto_->mutable_initializer()->ReleaseCleared();
-  }
+  ClearAndFree(*graph_proto_->mutable_initializer());
 }
 
 const InitializedTensorSet& Graph::GetAllInitializedTensors() const noexcept {
@@ -2314,7 +2448,7 @@ bool Graph::AddControlEdge(NodeIndex src_node_index, NodeIndex dst_node_index) {
 }
 
 const ONNX_NAMESPACE::GraphProto& Graph::ToGraphProto() {
-  if (!GraphProtoSyncNeeded()) {
+  if (!GraphProtoSyncNeeded() && !node_protos_released_) {
     return *graph_proto_;
   }
 
@@ -2322,12 +2456,13 @@ const ONNX_NAMESPACE::GraphProto& Graph::ToGraphProto() {
   ToGraphProtoInternal(*graph_proto_);
 
   GraphProtoSyncNeeded(false);
+  node_protos_released_ = false;
 
   return *graph_proto_;
 }
 
 ONNX_NAMESPACE::GraphProto Graph::ToGraphProto() const {
-  if (!GraphProtoSyncNeeded()) {
+  if (!GraphProtoSyncNeeded() && !node_protos_released_) {
     return *graph_proto_;
   }
   GraphProto result;
@@ -3,6 +3,7 @@
 
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/model.h"
+#include <limits>
 #include <memory>
 #include "core/common/logging/logging.h"
 
@@ -12,6 +13,7 @@
 #pragma warning(disable : 4800)
 #endif
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -208,6 +210,20 @@ const ModelMetaData& Model::MetaData() const noexcept {
   return model_metadata_;
 }
 
+void Model::SetMetaData(const std::string& key, const std::string& value) {
+  model_metadata_[key] = value;
+  for (auto& prop : *model_proto_->mutable_metadata_props()) {
+    if (prop.key() == key) {
+      prop.set_value(value);
+      return;
+    }
+  }
+
+  const gsl::not_null<StringStringEntryProto*> prop{model_proto_->add_metadata_props()};
+  prop->set_key(key);
+  prop->set_value(value);
+}
+
 Graph& Model::MainGraph() noexcept {
   return *graph_;
 }
@@ -390,18 +406,12 @@ Status Model::LoadFromBytes(int count, void* p_bytes, /*out*/ ONNX_NAMESPACE::Mo
 
 Status Model::LoadFromBytes(int count, void* p_bytes, /*out*/ std::shared_ptr<Model>& p_model,
                             const IOnnxRuntimeOpSchemaRegistryList* local_registries, const logging::Logger& logger) {
-  ModelProto model_proto;
+  // parse into a ModelProto that the Model takes ownership of so the initializers aren't copied
+  auto model_proto = onnxruntime::make_unique<ModelProto>();
 
-  auto status = LoadFromBytes(count, p_bytes, model_proto);
-  if (!status.IsOK()) {
-    return status;
-  }
-
-  p_model = std::make_shared<Model>(model_proto, local_registries, logger);
+  ORT_RETURN_IF_ERROR(LoadFromBytes(count, p_bytes, *model_proto));
 
-  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
-
-  return Status::OK();
+  return Load(std::move(model_proto), p_model, local_registries, logger);
 }
 
 using ::google::protobuf::io::CodedInputStream;
@@ -438,15 +448,50 @@ Status Model::Load(int fd, ONNX_NAMESPACE::ModelProto& model_proto) {
 
 Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                    const logging::Logger& logger) {
-  ModelProto model_proto;
+  // parse into a ModelProto that the Model takes ownership of so the initializers aren't copied
+  auto model_proto = onnxruntime::make_unique<ModelProto>();
 
-  ORT_RETURN_IF_ERROR(Load(fd, model_proto));
+  ORT_RETURN_IF_ERROR(Load(fd, *model_proto));
 
-  p_model = std::make_shared<Model>(model_proto, local_registries, logger);
+  return Load(std::move(model_proto), p_model, local_registries, logger);
+}
 
-  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
+Status Model::LoadFromMappedFile(const std::basic_string<ORTCHAR_T>& file_path, std::shared_ptr<Model>& p_model,
+                                 const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                 const logging::Logger& logger) {
+  const Env& env = Env::Default();
+  size_t length = 0;
+  Env::MappedMemoryPtr mapped_memory{};
+  Status status = env.GetFileLength(file_path.c_str(), length);
+  if (status.IsOK()) {
+    if (length > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Model file ", ToMBString(file_path),
+                             " is too large to be parsed as a single protobuf message: ", length, " bytes");
+    }
 
-  return Status::OK();
+    status = env.MapFileIntoMemory(file_path.c_str(), 0, length, mapped_memory);
+  }
+
+  if (!status.IsOK() || mapped_memory == nullptr) {
+    LOGS(logger, INFO) << "Memory mapping of " << ToMBString(file_path) << " failed, loading it from a stream. "
+                       << status.ErrorMessage();
+    return Load(file_path, p_model, local_registries, logger);
+  }
+
+  auto model_proto = onnxruntime::make_unique<ModelProto>();
+  {
+    google::protobuf::io::ArrayInputStream array_stream(mapped_memory.get(), static_cast<int>(length));
+    CodedInputStream coded_stream(&array_stream);
+    coded_stream.SetTotalBytesLimit(std::numeric_limits<int>::max());
+    if (!model_proto->ParseFromCodedStream(&coded_stream)) {
+      return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+    }
+  }
+
+  // the proto owns its own copy of the data now so the mapping can be released
+  mapped_memory.reset();
+
+  return Load(std::move(model_proto), p_model, local_registries, logger);
 }
 
 Status Model::Save(Model& model, int p_fd) {
@@ -85,6 +85,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Add or replace an entry of the model's metadata.
+  void SetMetaData(const std::string& key, const std::string& value);
 
   // Get model's main graph.
   Graph& MainGraph() noexcept;
@@ -114,6 +116,13 @@ class Model {
                              const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                              const logging::Logger& logger);
 
+  // Parse the model from a memory mapping of the file instead of reading it through a stream.
+  // Falls back to the regular Load if the file can't be mapped.
+  static common::Status LoadFromMappedFile(const std::basic_string<ORTCHAR_T>& file_path,
+                                           /*out*/ std::shared_ptr<Model>& p_model,
+                                           const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                           const logging::Logger& logger);
+
   static common::Status Load(int fd, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
 
   static common::Status Load(int fd, /*out*/ std::shared_ptr<Model>& p_model,
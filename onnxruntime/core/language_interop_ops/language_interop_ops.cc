@@ -19,34 +19,39 @@ void InterOpDomainDeleter(OrtCustomOpDomain* domain) {
   }
 }
 
-void LoadInterOp(const std::basic_string<ORTCHAR_T>& model_uri, InterOpDomains& domains, const InterOpLogFunc& log_func) {
+void LoadInterOp(const std::basic_string<ORTCHAR_T>& model_uri, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 bool pyop_dedicated_thread) {
   int fd;
   ORT_ENFORCE(Env::Default().FileOpenRd(model_uri, fd).IsOK(), "Failed to read model file");
   google::protobuf::io::FileInputStream f(fd);
   f.SetCloseOnDelete(true);
   ONNX_NAMESPACE::ModelProto model_proto;
   ORT_ENFORCE(model_proto.ParseFromZeroCopyStream(&f), "Failed to parse model proto");
-  LoadInterOp(model_proto, domains, log_func);
+  LoadInterOp(model_proto, domains, log_func, pyop_dedicated_thread);
 }
 
-void LoadInterOp(const ONNX_NAMESPACE::ModelProto& model_proto, InterOpDomains& domains, const InterOpLogFunc& log_func) {
-  LoadInterOp(model_proto.graph(), domains, log_func);
+void LoadInterOp(const ONNX_NAMESPACE::ModelProto& model_proto, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 bool pyop_dedicated_thread) {
+  // the thread is shared by the PyOp nodes of the main graph and the subgraphs, and stops with the last kernel using it
+  LoadInterOp(model_proto.graph(), domains, log_func,
+              pyop_dedicated_thread ? std::make_shared<PyOpThread>() : std::shared_ptr<PyOpThread>());
 }
 
-void LoadInterOp(const ONNX_NAMESPACE::GraphProto& graph_proto, InterOpDomains& domains, const InterOpLogFunc& log_func) {
+void LoadInterOp(const ONNX_NAMESPACE::GraphProto& graph_proto, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 const std::shared_ptr<PyOpThread>& pyop_thread) {
   for (int i = 0; i < graph_proto.node_size(); ++i) {
     const auto& node_proto = graph_proto.node(i);
     if (node_proto.op_type() == "PyOp") {
       OrtCustomOpDomain* pyop_domain = nullptr;
       Ort::ThrowOnError(Ort::GetApi().CreateCustomOpDomain(node_proto.domain().c_str(), &pyop_domain));
-      Ort::ThrowOnError(Ort::GetApi().CustomOpDomain_Add(pyop_domain, LoadPyOp(node_proto, log_func)));
+      Ort::ThrowOnError(Ort::GetApi().CustomOpDomain_Add(pyop_domain, LoadPyOp(node_proto, log_func, pyop_thread)));
       auto ort_domain = std::unique_ptr<OrtCustomOpDomain, decltype(&InterOpDomainDeleter)>(pyop_domain, &InterOpDomainDeleter);
       domains.push_back(std::move(ort_domain));
     } else {
       for (int j = 0; j < node_proto.attribute_size(); ++j) {
         const auto& attr = node_proto.attribute(j);
         if (utils::HasGraph(attr)) {
-          LoadInterOp(attr.g(), domains, log_func);  //load pyop in subgraph
+          LoadInterOp(attr.g(), domains, log_func, pyop_thread);  //load pyop in subgraph
         }
       }  //for
     }    //else
@@ -8,10 +8,15 @@
 #include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
+class PyOpThread;
 void InterOpDomainDeleter(OrtCustomOpDomain*);
 using InterOpLogFunc = std::function<void(const char*)>;
 using InterOpDomains = std::vector<std::unique_ptr<OrtCustomOpDomain,decltype(&InterOpDomainDeleter)>>;
-void LoadInterOp(const std::basic_string<ORTCHAR_T>& model_uri, InterOpDomains& domains, const InterOpLogFunc& log_func);
-void LoadInterOp(const ONNX_NAMESPACE::ModelProto& model_proto, InterOpDomains& domains, const InterOpLogFunc& log_func);
-void LoadInterOp(const ONNX_NAMESPACE::GraphProto& graph_proto, InterOpDomains& domains, const InterOpLogFunc& log_func);
+// if pyop_dedicated_thread is true, the PyOp nodes of the model run on one thread owned by the loaded domains
+void LoadInterOp(const std::basic_string<ORTCHAR_T>& model_uri, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 bool pyop_dedicated_thread = false);
+void LoadInterOp(const ONNX_NAMESPACE::ModelProto& model_proto, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 bool pyop_dedicated_thread = false);
+void LoadInterOp(const ONNX_NAMESPACE::GraphProto& graph_proto, InterOpDomains& domains, const InterOpLogFunc& log_func,
+                 const std::shared_ptr<PyOpThread>& pyop_thread);
 }
@@ -40,12 +40,49 @@ PyOpLibProxy::~PyOpLibProxy() {
   Env::Default().UnloadDynamicLibrary(handle_);
 }
 
+PyOpThread::PyOpThread() : thread_([this]() {
+  for (;;) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}) {}
+
+PyOpThread::~PyOpThread() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+void PyOpThread::Run(std::function<void()> task) {
+  std::packaged_task<void()> packaged_task(std::move(task));
+  auto result = packaged_task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(packaged_task));
+  }
+  cv_.notify_one();
+  result.get();
+}
+
 PyCustomKernel::PyCustomKernel(Ort::CustomOpApi ort,
                                const OnnxAttrs& attrs,
                                const std::string& module,
                                const std::string& class_name,
                                const std::string& compute,
-                               PyOpLogFunc logging_func) : ort_(ort), attrs_(attrs), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func) {
+                               PyOpLogFunc logging_func,
+                               std::shared_ptr<PyOpThread> thread) : ort_(ort), attrs_(attrs), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func), thread_(std::move(thread)) {
   std::string err;
   instance_ = PyOpLibProxy::GetInstance().new_instance_(module.c_str(), class_name_.c_str(), attrs_);
   ORT_ENFORCE(nullptr != instance_, PyOpLibProxy::GetInstance().get_last_error_message_(err));
@@ -63,12 +100,14 @@ void PyCustomKernel::GetOutputShape(OrtKernelContext*, size_t, OrtTensorTypeAndS
 
 void PyCustomKernel::Compute(OrtKernelContext* context) {
   ORT_ENFORCE(nullptr != context);
-  auto inputs_count = (size_t) reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->InputCount();
+  auto* ctx_internal = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context);
+  auto inputs_count = (size_t)ctx_internal->InputCount();
+  auto outputs_count = (size_t)ctx_internal->OutputCount();
   std::vector<const void*> inputs;
-  std::vector<std::unique_ptr<char[]>> outputs;
-  std::vector<int32_t> inputs_type, outputs_elem_size;
-  std::vector<std::vector<int64_t>> inputs_dim, outputs_dim;
+  std::vector<int32_t> inputs_type;
+  std::vector<std::vector<int64_t>> inputs_dim;
 
+  // the inputs are passed to Python as read-only views of the ORT buffers
   for (size_t i = 0; i < inputs_count; ++i) {
     auto ort_value = ort_.KernelContext_GetInput(context, i);
     inputs.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().DataRaw());
@@ -76,17 +115,32 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
     inputs_dim.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().Shape().GetDims());
   }
 
-  std::string err;
-  ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, compute_.c_str(), inputs, inputs_type,
-                                                              inputs_dim, outputs, outputs_elem_size,
-                                                              outputs_dim, logging_func_),
-              PyOpLibProxy::GetInstance().get_last_error_message_(err));  //ORT_ENFORCE
-
-  for (size_t i = 0; i < outputs.size(); ++i) {
-    auto ort_output = ort_.KernelContext_GetOutput(context, i, outputs_dim[i].data(), outputs_dim[i].size());
-    auto output_mem_addr = ort_.GetTensorMutableData<char>(ort_output);
-    auto output_len = std::accumulate(begin(outputs_dim[i]), end(outputs_dim[i]), static_cast<int64_t>(outputs_elem_size[i]), std::multiplies<int64_t>());
-    memcpy(output_mem_addr, outputs[i].get(), output_len);
+  // the returned arrays are copied once, straight into the ORT outputs
+  PyOpAllocateOutputFunc allocate_output = [&](size_t index, int32_t elem_size,
+                                               const std::vector<int64_t>& dims) -> void* {
+    if (index >= outputs_count) {
+      logging_func_("PyOp returned more outputs than the node has");
+      return nullptr;
+    }
+    auto* output = ort_.KernelContext_GetOutput(context, index, dims.data(), dims.size())->GetMutable<Tensor>();
+    if (static_cast<int32_t>(output->DataType()->Size()) != elem_size) {
+      logging_func_("PyOp output element size does not match the output type of the node");
+      return nullptr;
+    }
+    return output->MutableDataRaw();
+  };
+
+  auto invoke = [&]() {
+    std::string err;
+    ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, compute_.c_str(), inputs, inputs_type,
+                                                                inputs_dim, allocate_output, logging_func_),
+                PyOpLibProxy::GetInstance().get_last_error_message_(err));  //ORT_ENFORCE
+  };
+
+  if (thread_) {
+    thread_->Run(invoke);
+  } else {
+    invoke();
   }
 }
 
@@ -143,10 +197,11 @@ PyCustomOp::PyCustomOp(const OnnxAttrs& attrs,
                        const std::string& module,
                        const std::string& class_name,
                        const std::string& compute,
-                       PyOpLogFunc logging_func) : attrs_(attrs), inputs_type_(inputs_type), outputs_type_(outputs_type), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func) { OrtCustomOp::version = ORT_API_VERSION; }
+                       PyOpLogFunc logging_func,
+                       std::shared_ptr<PyOpThread> thread) : attrs_(attrs), inputs_type_(inputs_type), outputs_type_(outputs_type), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func), thread_(std::move(thread)) { OrtCustomOp::version = ORT_API_VERSION; }
 
 void* PyCustomOp::CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo*) {
-  return new PyCustomKernel(api, attrs_, module_, class_name_, compute_, logging_func_);
+  return new PyCustomKernel(api, attrs_, module_, class_name_, compute_, logging_func_, thread_);
 }
 
 const char* PyCustomOp::GetName() const { return "PyOp"; }
@@ -157,7 +212,8 @@ ONNXTensorElementDataType PyCustomOp::GetInputType(size_t index) const { return
 size_t PyCustomOp::GetOutputTypeCount() const { return outputs_type_.size(); }
 ONNXTensorElementDataType PyCustomOp::GetOutputType(size_t index) const { return outputs_type_[index]; }
 
-PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc log_func) {
+PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc log_func,
+                     std::shared_ptr<PyOpThread> thread) {
   OnnxAttrs onnx_attrs;
   OnnxTypes input_types, output_types;
   std::string module, class_name, compute = "compute";
@@ -188,6 +244,6 @@ PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc lo
   ORT_ENFORCE(class_name != "", "PyOp class name not specified");
   ORT_ENFORCE(!input_types.empty(), "PyOp node inputs not specified");
   ORT_ENFORCE(!output_types.empty(), "PyOp node outputs not specified");
-  return new PyCustomOp(onnx_attrs, input_types, output_types, module, class_name, compute, log_func);
+  return new PyCustomOp(onnx_attrs, input_types, output_types, module, class_name, compute, log_func, std::move(thread));
 }
 }  // namespace onnxruntime
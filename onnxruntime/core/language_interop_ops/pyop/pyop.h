@@ -4,7 +4,12 @@
 #include "core/framework/ml_value.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #ifdef _WIN32
@@ -18,6 +23,8 @@ namespace onnxruntime {
 using OnnxTypes   = std::vector<ONNXTensorElementDataType>;
 using OnnxAttrs   = std::unordered_map<std::string, std::string>;
 using PyOpLogFunc = std::function<void(const char*)>;
+// returns the buffer of output index with the given element size and shape, or nullptr if it can't be created
+using PyOpAllocateOutputFunc = std::function<void*(size_t, int32_t, const std::vector<int64_t>&)>;
 
 typedef bool Initialize();
 typedef void ReleaseInstance(void*);
@@ -26,9 +33,7 @@ typedef bool InvokePythonFunc(void*,
                               const std::vector<const void*>&,
                               const std::vector<int32_t>&,
                               const std::vector<std::vector<int64_t>>&,
-                              std::vector<std::unique_ptr<char[]>>&,
-                              std::vector<int32_t>&,
-                              std::vector<std::vector<int64_t>>&,
+                              const PyOpAllocateOutputFunc&,
                               std::function<void(const char*)>);
 typedef const char* GetLastErrorMessage(std::string&);
 typedef void* NewInstance(const char*, const char*, const OnnxAttrs&);
@@ -48,6 +53,23 @@ private:
     ~PyOpLibProxy();
 };
 
+// a thread that runs the Python calls of the PyOp nodes of a session in order. the thread keeps its Python
+// thread state, and the executor thread calling Run waits on it without contending for the GIL.
+class PyOpThread {
+
+public:
+    PyOpThread();
+    ~PyOpThread();
+    // runs task on the thread and rethrows what it throws
+    void Run(std::function<void()> task);
+private:
+    std::mutex                              mutex_;
+    std::condition_variable                 cv_;
+    std::deque<std::packaged_task<void()>>  tasks_;
+    bool                                    stop_ = false;
+    std::thread                             thread_;
+};
+
 struct PyCustomKernel {
 
     PyCustomKernel(Ort::CustomOpApi   ort,
@@ -55,7 +77,8 @@ struct PyCustomKernel {
                    const std::string& module,
                    const std::string& class_name,
                    const std::string& compute,
-                   PyOpLogFunc        logging_func);
+                   PyOpLogFunc        logging_func,
+                   std::shared_ptr<PyOpThread> thread = nullptr);
     ~PyCustomKernel();
     void    GetOutputShape(OrtKernelContext*, size_t, OrtTensorTypeAndShapeInfo*);
     void    Compute(OrtKernelContext* context);
@@ -68,6 +91,7 @@ private:
     std::string      compute_;
     void*            instance_ = nullptr;
     PyOpLogFunc      logging_func_;
+    std::shared_ptr<PyOpThread> thread_;
 };
 
 struct PyCustomOp: Ort::CustomOpBase<PyCustomOp, PyCustomKernel> {
@@ -78,7 +102,8 @@ struct PyCustomOp: Ort::CustomOpBase<PyCustomOp, PyCustomKernel> {
                const std::string&  module,
                const std::string&  class_name,
                const std::string&  compute      = "compute",
-               PyOpLogFunc         logging_func = [](const char*){});
+               PyOpLogFunc         logging_func = [](const char*){},
+               std::shared_ptr<PyOpThread> thread = nullptr);
     void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo*);
     const char* GetName() const;
     size_t GetInputTypeCount() const;
@@ -93,7 +118,10 @@ private:
     std::string    class_name_;
     std::string    compute_;
     PyOpLogFunc    logging_func_;
+    std::shared_ptr<PyOpThread> thread_;
 };//struct PyCustomOp
 
-PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc log_func);
+// thread is the dedicated thread the node runs on, or nullptr to run it on the executor thread
+PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc log_func,
+                     std::shared_ptr<PyOpThread> thread = nullptr);
 }//namespace onnxruntime
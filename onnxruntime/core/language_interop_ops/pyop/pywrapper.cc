@@ -16,7 +16,6 @@
 #include <numeric>
 #include <vector>
 #include <memory>
-#include <mutex>
 #include <functional>
 #include <unordered_map>
 
@@ -29,44 +28,81 @@ namespace onnxruntime {
 #define PYOP_EXPORT extern "C"
 #endif
 
+using AllocateOutputFunc = std::function<void*(size_t, int32_t, const std::vector<int64_t>&)>;
+
+// the thread state saved when this library initialized the interpreter itself, nullptr if it is hosted by Python
+static PyThreadState* main_thread_state = nullptr;
+
 struct Finalizer
 {
     ~Finalizer() {
-        Py_Finalize();
+        if (nullptr != main_thread_state) {
+            PyEval_RestoreThread(main_thread_state);
+            Py_Finalize();
+        }
     }
 };
 
+// holds the GIL, so that the PyOp nodes can run from any thread, and releases the given objects before releasing it
 class Scope
 {
 public:
-    Scope(const vector<PyObject*>& objs = {}): objs_(objs) {
-        mtx_.lock();
-    }
+    Scope(const vector<PyObject*>& objs = {}): objs_(objs), state_(PyGILState_Ensure()) {}
     ~Scope() {
         for (auto obj: objs_) {
             Py_XDECREF(obj);
         }
-        mtx_.unlock();
+        PyGILState_Release(state_);
     }
     void Add(PyObject* obj) {
         objs_.push_back(obj);
     }
 private:
-    static std::mutex mtx_;
     vector<PyObject*> objs_;
+    PyGILState_STATE  state_;
 };
 
-std::mutex Scope::mtx_;
+// the Python error indicator belongs to the thread state, which PyGILState_Release may destroy,
+// so the message is saved while the GIL is still held
+static thread_local string last_error;
+
+static void SaveLastError() {
+    last_error.clear();
+    if (PyErr_Occurred()) {
+        PyObject *type, *value, *trace;
+        PyErr_Fetch(&type, &value, &trace);
+        if (nullptr != value) {
+            auto pyVal = PyObject_Repr(value);
+            auto pyStr = nullptr == pyVal ? nullptr : PyUnicode_AsEncodedString(pyVal, "utf-8", "Error ~");
+            if (nullptr != pyStr) {
+                last_error = PyBytes_AS_STRING(pyStr);
+            }
+            Py_XDECREF(pyStr);
+            Py_XDECREF(pyVal);
+        }
+        PyErr_Restore(type, value, trace);
+        PyErr_Clear();
+    }
+}
 
 PYOP_EXPORT bool Initialize() {
+    if (!Py_IsInitialized()) {
+        Py_Initialize();
+        PyEval_InitThreads();
+        // release the GIL taken by Py_Initialize, so every call below has to acquire it
+        main_thread_state = PyEval_SaveThread();
+    }
     Scope scope;
-    Py_Initialize();
     if (_import_array() < 0) {
+        SaveLastError();
         return false;
     }
     auto path_list = PySys_GetObject("path");//do not release it
+    auto cur_dir = PyUnicode_FromString(".");
+    scope.Add(cur_dir);
     if (nullptr == path_list || !PyList_Check(path_list) ||
-        PyList_Append(path_list, PyUnicode_FromString(".")) != 0) {
+        PyList_Append(path_list, cur_dir) != 0) {
+        SaveLastError();
         return false; 
     }
     static Finalizer finalizer;
@@ -74,72 +110,66 @@ PYOP_EXPORT bool Initialize() {
 }
 
 PYOP_EXPORT const char* GetLastErrorMessage(std::string& err) {
-    Scope scope;
-    if (PyErr_Occurred()) {
-        PyObject *type, *value, *trace;
-        PyErr_Fetch(&type, &value, &trace);
-        if (nullptr != value) {
-            auto pyVal = PyObject_Repr(value);
-            scope.Add(pyVal);
-            auto pyStr = PyUnicode_AsEncodedString(pyVal, "utf-8", "Error ~");
-            scope.Add(pyStr);
-            err = PyBytes_AS_STRING(pyStr);
-        }
-        PyErr_Restore(type, value, trace);
-    }
+    err = last_error;
     return err.c_str();
 }
 
+// wraps an ORT input without copying it. the array is read-only and only valid during the call.
 PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim) {
     std::vector<npy_intp> np_dim;
     for (auto d: dim) {
         np_dim.push_back(static_cast<npy_intp>(d));
     }
-    auto pyObj = static_cast<PyObject*>(PyArray_EMPTY(static_cast<int>(np_dim.size()), np_dim.data(), type, 0));
-    auto data_len = std::accumulate(begin(np_dim), end(np_dim),
-                                    static_cast<int64_t>(PyArray_DescrFromType(type)->elsize),
-                                    std::multiplies<int64_t>());
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    memcpy(PyArray_DATA(np_array), data, data_len);
+    auto pyObj = PyArray_SimpleNewFromData(static_cast<int>(np_dim.size()), np_dim.data(), type, const_cast<void*>(data));
+    if (nullptr != pyObj) {
+        PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(pyObj), NPY_ARRAY_WRITEABLE);
+    }
     return pyObj;
 }
 
-bool ExtractOutput(PyObject*                   pyObj,
-                   vector<unique_ptr<char[]>>& outputs,
-                   vector<int32_t>&            outputs_elem_size,
-                   vector<vector<int64_t>>&    outputs_dim) {
+// copies a returned numpy array into the ORT output allocated by allocate_output
+bool ExtractOutput(PyObject*              pyObj,
+                   size_t                 index,
+                   const AllocateOutputFunc& allocate_output) {
     if (!PyArray_Check(pyObj)) {
         return false;
     }
 
-    outputs_dim.push_back({});
     auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
-
-    for (int i = 0; i < PyArray_NDIM(np_array); ++i) {
-        outputs_dim.back().push_back(PyArray_SHAPE(np_array)[i]);
+    auto elem_size = static_cast<int32_t>(PyArray_ITEMSIZE(np_array));
+    vector<int64_t> dim(PyArray_SHAPE(np_array), PyArray_SHAPE(np_array) + PyArray_NDIM(np_array));
+    auto output = allocate_output(index, elem_size, dim);
+    if (nullptr == output) {
+        return false;
     }
 
-    auto data_len = std::accumulate(begin(outputs_dim.back()),
-                                    end(outputs_dim.back()),
-                                    static_cast<int64_t>(outputs_elem_size.back()),
-                                    std::multiplies<int64_t>());
+    if (PyArray_IS_C_CONTIGUOUS(np_array)) {
+        memcpy(output, PyArray_DATA(np_array), PyArray_NBYTES(np_array));
+        return true;
+    }
 
-    outputs.push_back(unique_ptr<char[]>(new char[data_len]));
-    memcpy(static_cast<void*>(outputs.back().get()), PyArray_DATA(np_array), data_len);
-    return true;
+    // view the output as an array of the same type so numpy copies the strided data into it
+    auto dst = PyArray_SimpleNewFromData(PyArray_NDIM(np_array), PyArray_SHAPE(np_array), PyArray_TYPE(np_array), output);
+    if (nullptr == dst) {
+        return false;
+    }
+    auto ret = PyArray_CopyInto(reinterpret_cast<PyArrayObject*>(dst), np_array);
+    Py_DECREF(dst);
+    return 0 == ret;
 }
 
 PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const unordered_map<string, string>& args) {
     Scope scope; 
     auto pyModule = PyImport_ImportModule(module);
     if (nullptr == pyModule) {
+        SaveLastError();
         return nullptr;
     }
 
     scope.Add(pyModule);
     auto pyClass  = PyObject_GetAttrString(pyModule, class_name);
     if (nullptr == pyClass) {
+        SaveLastError();
         return nullptr;
     }
 
@@ -149,10 +179,16 @@ PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const
     auto named_args = PyDict_New();
     scope.Add(named_args);
     for (const auto& iter: args) {
-        PyDict_SetItemString(named_args, iter.first.c_str(), PyUnicode_FromString(iter.second.c_str()));
+        auto value = PyUnicode_FromString(iter.second.c_str());
+        scope.Add(value);
+        PyDict_SetItemString(named_args, iter.first.c_str(), value);
     }
 
-    return PyObject_Call(pyClass, empty_args, named_args);
+    auto instance = PyObject_Call(pyClass, empty_args, named_args);
+    if (nullptr == instance) {
+        SaveLastError();
+    }
+    return instance;
 }
 
 PYOP_EXPORT void ReleaseInstance(void* instance) {
@@ -164,11 +200,10 @@ PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
                                   const vector<const void*>&       inputs,
                                   const vector<int32_t>&           inputs_type,
                                   const vector<vector<int64_t>>&   inputs_dim,
-                                  vector<unique_ptr<char[]>>&      outputs,
-                                  vector<int32_t>&                 outputs_elem_size,
-                                  vector<vector<int64_t>>&         outputs_dim,
+                                  const AllocateOutputFunc&        allocate_output,
                                   std::function<void(const char*)> logging_func) {
     Scope scope;
+    last_error.clear();
     auto instance = static_cast<PyObject*>(raw_inst);
     if (nullptr == instance || nullptr == function) {
         logging_func("InvokePythonFunc: found invalid instance or function");
@@ -178,29 +213,42 @@ PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
     auto pyFunc = PyObject_GetAttrString(instance, function);
     if (nullptr == pyFunc) {
         logging_func("InvokePythonFunc: failed to create function object");
+        SaveLastError();
         return false;
     }
 
     scope.Add(pyFunc);
     auto pyArgs = PyTuple_New(inputs.size());
+    scope.Add(pyArgs);
     for (size_t i = 0; i < inputs.size(); ++i) {
-        PyTuple_SetItem(pyArgs, i, MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]));
+        auto pyInput = MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]);
+        if (nullptr == pyInput) {
+            logging_func("InvokePythonFunc: failed to create input");
+            SaveLastError();
+            return false;
+        }
+        PyTuple_SetItem(pyArgs, i, pyInput);
     }
 
-    scope.Add(pyArgs);
     auto pyResult = PyEval_CallObject(pyFunc, pyArgs);
     if (nullptr == pyResult) {
         logging_func("InvokePythonFunc: no result");
+        SaveLastError();
         return false;
     }
 
     scope.Add(pyResult);
     if (PyArray_Check(pyResult)) {
-        ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim);
+        if (!ExtractOutput(pyResult, 0, allocate_output)) {
+            logging_func("InvokePythonFunc: failed to extract output");
+            SaveLastError();
+            return false;
+        }
     } else if (PyTuple_Check(pyResult)) {
         for (int32_t i = 0; i < PyTuple_Size(pyResult); ++i) {
-            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim)) {
+            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), static_cast<size_t>(i), allocate_output)) {
                 logging_func("InvokePythonFunc: failed to extract output");
+                SaveLastError();
                 return false;
             }
         }
@@ -128,6 +128,295 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Output stage of a SGEMM that is applied to each block of matrix C after its
+// last accumulation, while the block is still in the cache. Element (m, n) of
+// the optional bias is read from Bias[m * BiasRowStride + n * BiasColumnStride],
+// so zero strides broadcast a scalar, a row or a column of the bias to matrix
+// C. The bias is multiplied by BiasScale and added to matrix C, then the
+// optional activation is applied.
+//
+
+struct MLAS_SGEMM_OUTPUT_STAGE {
+    const float* Bias;
+    size_t BiasRowStride;
+    size_t BiasColumnStride;
+    float BiasScale;
+    const MLAS_ACTIVATION* Activation;
+};
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Batched matrix/matrix multiply routine. Each of the BatchN operations
+// multiplies A[i] by B[i] into C[i] with the same shape, leading dimensions
+// and scalars. The addresses may repeat, so a broadcast matrix is supplied
+// once per operation that uses it. The threads are distributed across the
+// operations of the batch and the blocks of each operation jointly, so that a
+// batch of small matrices uses the thread pool as well as a single large one.
+//
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* const* A,
+    size_t lda,
+    const float* const* B,
+    size_t ldb,
+    float beta,
+    float* const* C,
+    size_t ldc,
+    size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Enables the autotuning of the single precision matrix/matrix multiply
+// routines that take an unpacked matrix B. The first operation with a new
+// shape times candidate thread splits and block sizes and the fastest is used
+// by the later operations with the same shape. The selected parameters are
+// read from and appended to the optional cache file, which is specific to the
+// machine it was written on. The autotuning stays enabled for the process.
+//
+
+void
+MLASCALL
+MlasGemmEnableAutotuning(
+    const char* CacheFilePath
+    );
+
+//
+// Packed matrix/matrix multiply routines. A constant matrix B can be packed
+// once with MlasGemmPackB and then used by MlasGemm without repacking it on
+// every call.
+//
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Sparse matrix/matrix multiply routines. A constant matrix B that is mostly
+// zeros, such as the weights of a pruned model, is packed once with only its
+// non-zero values and then used by MlasSparseGemm, which skips the products
+// with the zero values. MlasSparseGemmPackBSize returns zero if matrix B has
+// too many non-zero values for MlasSparseGemm to be faster than MlasGemm.
+// MlasSparseGemmEstimateSpeedup returns the estimated ratio of the time of
+// MlasGemm to the time of MlasSparseGemm.
+//
+
+float
+MLASCALL
+MlasSparseGemmEstimateSpeedup(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSparseGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Bfloat16 matrix/matrix multiply routines. A constant matrix B is packed once
+// as bfloat16 values, which halves the memory traffic of matrix B. Matrix A is
+// supplied as single precision values and the products are accumulated in
+// single precision. The inner products are computed using the AVX512-BF16
+// instructions if MlasBf16GemmIsAccelerated returns true, else matrix B is
+// widened to single precision and the SGEMM kernels are used.
+//
+
+bool
+MLASCALL
+MlasBf16GemmIsAccelerated(
+    void
+    );
+
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasBf16Gemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Half precision matrix/matrix multiply routines. A constant matrix B is
+// packed once as half precision values, which halves the memory used by the
+// packed matrix B. Each packed panel is widened to single precision when it is
+// used, so the products are computed and accumulated in single precision.
+// Values of matrix B outside the range of half precision become infinities.
+//
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasHalfGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -181,6 +470,105 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Output stage of a QGEMM that converts the int32 accumulators to float by
+// multiplying with the combined scale of matrix A and matrix B. The scale is
+// per column of matrix C when PerColumnScale is set. The bias (one value per
+// column) and the activation are optional.
+//
+// RowBias optionally supplies an int32 value per row of matrix C that is added
+// to the accumulators before scaling. When QuantizedOutput is set, the float
+// values are requantized instead of being stored to Output: they are rounded
+// to the nearest even integer, offset by QuantizedZeroPoint and saturated to
+// uint8. Matrix C is then not referenced and may be nullptr; the accumulators
+// are staged through a small buffer while still in the cache. Matrix C may also
+// be nullptr for the float output, which then skips the int32 temporary.
+//
+
+struct MLAS_QGEMM_OUTPUT_STAGE {
+    const float* Scale;
+    bool PerColumnScale;
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+    float* Output;
+    size_t ldOutput;
+    const int32_t* RowBias;
+    uint8_t* QuantizedOutput;
+    uint8_t QuantizedZeroPoint;
+};
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    const int8_t* offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    const uint8_t* offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -189,6 +577,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
+    MlasConvAlgorithmWinograd,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -207,6 +597,7 @@ struct MLAS_CONV_PARAMETERS {
     size_t InputSize;
     size_t OutputSize;
     size_t K;
+    float Beta;
     MLAS_CONV_ALGORITHM Algorithm;
     int32_t ThreadCount;
     union {
@@ -217,6 +608,10 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileRowsPerBlock;
+            size_t WorkingBufferSizePerThread;
+        } Winograd;
     } u;
 };
 
@@ -237,6 +632,7 @@ MlasConvPrepare(
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
+    float Beta,
     MLAS_THREADPOOL* ThreadPool
     );
 
@@ -252,6 +648,54 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd F(2x2, 3x3) convolution routines for 2D convolutions with a 3x3
+// kernel, unit strides and unit dilations.
+//
+// The filter is transformed once by MlasConvWinogradPackFilter. After
+// MlasConvPrepare, MlasConvWinogradPrepare returns false if the convolution
+// cannot or should not use the Winograd algorithm; otherwise it updates the
+// parameters and the working buffer size for use with MlasConvWinograd.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
+bool
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Pooling routines.
 //
@@ -306,6 +750,124 @@ MlasComputeErf(
     size_t N
     );
 
+enum MLAS_GELU_KIND {
+    MlasGeluErf,
+    MlasGeluTanh,
+};
+
+void
+MLASCALL
+MlasComputeGelu(
+    MLAS_GELU_KIND Kind,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t BiasLength,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+    );
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    float Shift
+    );
+
+void
+MLASCALL
+MlasComputeMeanAndInvStdDev(
+    const float* Input,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+    );
+
+void
+MLASCALL
+MlasComputeLocalResponseNormalization(
+    const float* Input,
+    float* Output,
+    size_t Channels,
+    size_t ChannelStride,
+    size_t N,
+    size_t Size,
+    float Alpha,
+    float Beta,
+    float Bias
+    );
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeReciprocalSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Input,
+    float Exponent,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -319,6 +881,53 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+//
+// Integer conversion routines.
+//
+// The float to integer conversions truncate toward zero and saturate values
+// outside of the range of the destination type.
+//
+
+void
+MLASCALL
+MlasConvertFloatToInt8Buffer(
+    const float* Source,
+    int8_t* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertFloatToUInt8Buffer(
+    const float* Source,
+    uint8_t* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertInt8ToFloatBuffer(
+    const int8_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertUInt8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -331,6 +940,14 @@ MlasReorderInput(
     float* D
     );
 
+void
+MLASCALL
+MlasReorderInputNhwc(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    );
+
 void
 MLASCALL
 MlasReorderOutput(
@@ -339,6 +956,14 @@ MlasReorderOutput(
     float* D
     );
 
+void
+MLASCALL
+MlasReorderOutputNhwc(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    );
+
 void
 MLASCALL
 MlasReorderFilterOIHWBiBo(
@@ -401,6 +1026,16 @@ MlasNchwcPool(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Linear quantization routines.
 //
@@ -424,3 +1059,113 @@ MlasQuantizeLinear(
     float Scale,
     int8_t ZeroPoint
     );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasFindMinMaxElement(
+    const float* Input,
+    float* Min,
+    float* Max,
+    size_t N
+    );
+
+//
+// Quantized element-wise and pooling routines. The inputs and output are
+// uint8 with a per-tensor scale and zero point, and the results are
+// requantized without intermediate float buffers. MlasQLinearAdd and
+// MlasQLinearMul broadcast the single element of InputB if IsScalarB is set.
+//
+
+void
+MLASCALL
+MlasQLinearAdd(
+    const uint8_t* InputA,
+    float ScaleA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    float ScaleB,
+    uint8_t ZeroPointB,
+    float ScaleC,
+    uint8_t ZeroPointC,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB
+    );
+
+void
+MLASCALL
+MlasQLinearMul(
+    const uint8_t* InputA,
+    float ScaleA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    float ScaleB,
+    uint8_t ZeroPointB,
+    float ScaleC,
+    uint8_t ZeroPointC,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB
+    );
+
+void
+MLASCALL
+MlasQLinearGlobalAveragePool(
+    const uint8_t* Input,
+    float ScaleInput,
+    uint8_t ZeroPointInput,
+    uint8_t* Output,
+    float ScaleOutput,
+    uint8_t ZeroPointOutput,
+    size_t Channels,
+    size_t ImageSize
+    );
+
+//
+// Transpose routines.
+//
+// Output[n * ldb + m] = Input[m * lda + n] for the M rows and N columns of the
+// input matrix.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t lda,
+    uint32_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    );
@@ -0,0 +1,64 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    QgemmU8X8KernelNeon.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using the baseline ARMv8 NEON instruction set.
+
+--*/
+
+#include "mlasi.h"
+#include "QgemmU8X8KernelNeonCommon.h"
+
+//
+// Computes the dot products with widening multiplies and pairwise additions.
+//
+
+struct MLAS_GEMM_U8X8_DOT_PRODUCT_NEON {
+
+    static
+    MLAS_FORCEINLINE
+    uint32x4_t
+    Accumulate(
+        uint32x4_t Accumulator,
+        uint8x16_t BElements,
+        uint8x16_t AElements
+        )
+    {
+        uint16x8_t Products0 = vmull_u8(vget_low_u8(BElements), vget_low_u8(AElements));
+        uint16x8_t Products1 = vmull_u8(vget_high_u8(BElements), vget_high_u8(AElements));
+
+        uint32x4_t DotProducts = vpaddq_u32(vpaddlq_u16(Products0), vpaddlq_u16(Products1));
+
+        return vaddq_u32(Accumulator, DotProducts);
+    }
+};
+
+size_t
+MLASCALL
+MlasGemmU8X8KernelNeon(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t QuadCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+{
+    return MlasGemmU8X8Kernel<MLAS_GEMM_U8X8_DOT_PRODUCT_NEON>(A, B, C,
+        QuadCountK, CountM, CountN, ldc, RowSumVector, ColumnSumVector,
+        DepthValue, ZeroMode);
+}
@@ -0,0 +1,285 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    QgemmU8X8KernelNeonCommon.h
+
+Abstract:
+
+    This module contains the common implementation of the quantized integer
+    matrix/matrix multiply operation (QGEMM) kernels for ARM64 NEON.
+
+    The kernels consume matrix A as packed by MlasGemmU8X8CopyPackANeon and
+    matrix B as packed by MlasGemmU8X8CopyPackBNeon. Both matrices are unsigned
+    by the time they reach the kernel, so a single kernel serves the U8U8 and
+    U8S8 operations. The DotProductType template argument supplies the routine
+    that accumulates the four 4-byte dot products of a vector.
+
+--*/
+
+//
+// Stores a vector of accumulators to matrix C after optionally accumulating
+// the existing values of matrix C.
+//
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8StoreVectorNeon(
+    int32_t* C,
+    uint32x4_t Accumulator,
+    bool ZeroMode
+    )
+{
+    int32x4_t Vector = vreinterpretq_s32_u32(Accumulator);
+
+    if (!ZeroMode) {
+        Vector = vaddq_s32(Vector, vld1q_s32(C));
+    }
+
+    vst1q_s32(C, Vector);
+}
+
+//
+// Stores the first CountN (less than 4) accumulators to matrix C after
+// optionally accumulating the existing values of matrix C.
+//
+
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8StorePartialVectorNeon(
+    int32_t* C,
+    uint32x4_t Accumulator,
+    size_t CountN,
+    bool ZeroMode
+    )
+{
+    int32x4_t Vector = vreinterpretq_s32_u32(Accumulator);
+
+    if ((CountN & 2) != 0) {
+
+        int32x2_t Pair = vget_low_s32(Vector);
+
+        if (!ZeroMode) {
+            Pair = vadd_s32(Pair, vld1_s32(C));
+        }
+
+        vst1_s32(C, Pair);
+
+        Vector = vextq_s32(Vector, Vector, 2);
+        C += 2;
+    }
+
+    if ((CountN & 1) != 0) {
+
+        int32_t Value = vgetq_lane_s32(Vector, 0);
+
+        if (!ZeroMode) {
+            Value += C[0];
+        }
+
+        C[0] = Value;
+    }
+}
+
+template<typename DotProductType, size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8KernelBlock(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t QuadCountK,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    fixed number of rows.
+
+Arguments:
+
+    See MlasGemmU8X8Kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t lda = QuadCountK * 4;
+
+    while (CountN > 0) {
+
+        //
+        // Initialize the accumulators with the sum of the global depth value
+        // constant, the column sums, and the row sums.
+        //
+
+        uint32x4_t Accumulators[RowCount][4];
+
+        for (size_t i = 0; i < RowCount; i++) {
+
+            int32x4_t RowBias = vdupq_n_s32(DepthValue + RowSumVector[i]);
+
+            for (size_t j = 0; j < 4; j++) {
+                Accumulators[i][j] = vreinterpretq_u32_s32(
+                    vaddq_s32(RowBias, vld1q_s32(&ColumnSumVector[j * 4])));
+            }
+        }
+
+        //
+        // Broadcast each quad of 8-bit values from matrix A and accumulate the
+        // dot product with each of the quads of 8-bit values from the four
+        // column groups of matrix B.
+        //
+
+        const uint8_t* a = A;
+
+        for (size_t k = 0; k < QuadCountK; k++) {
+
+            uint8x16_t BElements0 = vld1q_u8(&B[0]);
+            uint8x16_t BElements1 = vld1q_u8(&B[16]);
+            uint8x16_t BElements2 = vld1q_u8(&B[32]);
+            uint8x16_t BElements3 = vld1q_u8(&B[48]);
+
+            for (size_t i = 0; i < RowCount; i++) {
+
+                uint8x16_t AElements = vreinterpretq_u8_u32(
+                    vld1q_dup_u32((const uint32_t*)&a[i * lda]));
+
+                Accumulators[i][0] = DotProductType::Accumulate(Accumulators[i][0], BElements0, AElements);
+                Accumulators[i][1] = DotProductType::Accumulate(Accumulators[i][1], BElements1, AElements);
+                Accumulators[i][2] = DotProductType::Accumulate(Accumulators[i][2], BElements2, AElements);
+                Accumulators[i][3] = DotProductType::Accumulate(Accumulators[i][3], BElements3, AElements);
+            }
+
+            a += 4;
+            B += 64;
+        }
+
+        //
+        // Output the accumulator block after optionally accumulating the values
+        // from matrix C.
+        //
+
+        size_t CountNThisBlock = (CountN < 16) ? CountN : 16;
+
+        for (size_t i = 0; i < RowCount; i++) {
+
+            int32_t* c = C + i * ldc;
+            size_t n = CountNThisBlock;
+            size_t j = 0;
+
+            while (n >= 4) {
+
+                MlasGemmU8X8StoreVectorNeon(c, Accumulators[i][j], ZeroMode);
+
+                c += 4;
+                n -= 4;
+                j++;
+            }
+
+            if (n > 0) {
+                MlasGemmU8X8StorePartialVectorNeon(c, Accumulators[i][j], n, ZeroMode);
+            }
+        }
+
+        C += CountNThisBlock;
+        CountN -= CountNThisBlock;
+        ColumnSumVector += 16;
+    }
+}
+
+template<typename DotProductType>
+MLAS_FORCEINLINE
+size_t
+MlasGemmU8X8Kernel(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t QuadCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. The matrix data has been packed
+        using MlasGemmU8X8CopyPackANeon.
+
+    B - Supplies the address of matrix B. The matrix data has been packed
+        using MlasGemmU8X8CopyPackBNeon.
+
+    C - Supplies the address of matrix C.
+
+    QuadCountK - Supplies the number of quad columns from matrix A and the
+        number of quad rows from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to iterate
+        over.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    RowSumVector - Supplies the sum of each row from matrix A multiplied by the
+        zero point offset of matrix B. These values are accumulated into every
+        row of matrix C.
+
+    ColumnSumVector - Supplies the sum of each column from matrix B multiplied
+        by the zero point offset of matrix A. These values are accumulated into
+        every column of matrix C.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrixA multplied by the zero point offset of matrix B. This value is
+        accumulated into every element of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    if (CountM >= 4) {
+        MlasGemmU8X8KernelBlock<DotProductType, 4>(A, B, C, QuadCountK,
+            CountN, ldc, RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasGemmU8X8KernelBlock<DotProductType, 2>(A, B, C, QuadCountK,
+            CountN, ldc, RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+        return 2;
+    }
+
+    MlasGemmU8X8KernelBlock<DotProductType, 1>(A, B, C, QuadCountK,
+        CountN, ldc, RowSumVector, ColumnSumVector, DepthValue, ZeroMode);
+    return 1;
+}
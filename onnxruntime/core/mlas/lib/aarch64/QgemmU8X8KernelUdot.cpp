@@ -0,0 +1,59 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    QgemmU8X8KernelUdot.cpp
+
+Abstract:
+
+    This module implements the kernel for the quantized integer matrix/matrix
+    multiply operation (QGEMM) using the ARMv8.2 dot product instructions.
+
+--*/
+
+#include "mlasi.h"
+#include "QgemmU8X8KernelNeonCommon.h"
+
+//
+// Computes the dot products with the UDOT instruction.
+//
+
+struct MLAS_GEMM_U8X8_DOT_PRODUCT_UDOT {
+
+    static
+    MLAS_FORCEINLINE
+    uint32x4_t
+    Accumulate(
+        uint32x4_t Accumulator,
+        uint8x16_t BElements,
+        uint8x16_t AElements
+        )
+    {
+        return vdotq_u32(Accumulator, BElements, AElements);
+    }
+};
+
+size_t
+MLASCALL
+MlasGemmU8X8KernelUdot(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t QuadCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    )
+{
+    return MlasGemmU8X8Kernel<MLAS_GEMM_U8X8_DOT_PRODUCT_UDOT>(A, B, C,
+        QuadCountK, CountM, CountN, ldc, RowSumVector, ColumnSumVector,
+        DepthValue, ZeroMode);
+}
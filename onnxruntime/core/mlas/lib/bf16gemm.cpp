@@ -0,0 +1,756 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.cpp
+
+Abstract:
+
+    This module implements the bfloat16 matrix/matrix multiply operation
+    (BF16GEMM).
+
+    Matrix B is packed once to bfloat16 values using the panel strides of
+    MlasGemmPackB. Inside each panel, the 16 column blocks store pairs of rows
+    so that the two values of a column consumed by one AVX512-BF16 dot product
+    step are adjacent. Processors without AVX512-BF16 support widen the panels
+    back to single precision and use the SGEMM kernels, so only the memory
+    traffic of matrix B is reduced.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a BF16GEMM operation on worker
+// threads.
+//
+
+struct MLAS_BF16GEMM_WORK_BLOCK {
+    size_t K;
+    size_t lda;
+    size_t ldc;
+    float alpha;
+    float beta;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const float* A;
+        const uint16_t* B;
+        float* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+MLAS_FORCEINLINE
+uint16_t
+MlasBf16FromFloat(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to a bfloat16 value using
+    round to nearest even. NaN values stay NaN values.
+
+Arguments:
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the bfloat16 value.
+
+--*/
+{
+    uint32_t Bits;
+
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+        return uint16_t((Bits >> 16) | 0x40);
+    }
+
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+
+    return uint16_t(Bits >> 16);
+}
+
+MLAS_FORCEINLINE
+float
+MlasBf16ToFloat(
+    uint16_t Value
+    )
+{
+    uint32_t Bits = uint32_t(Value) << 16;
+    float Result;
+
+    memcpy(&Result, &Bits, sizeof(Result));
+
+    return Result;
+}
+
+void
+MlasBf16GemmCopyPackB(
+    uint16_t* D,
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a panel of matrix B to bfloat16 values and copies the
+    values to the destination packed buffer.
+
+    Columns of 16 elements are unrolled to be physically contiguous and each
+    pair of rows is interleaved. Any remaining columns less than 16 elements
+    wide and an odd trailing row are zero-padded.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    B - Supplies the address of the first element of the panel of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    CountN - Supplies the number of columns of the panel.
+
+    CountK - Supplies the number of rows of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t ColumnStride = (TransB == CblasNoTrans) ? 1 : ldb;
+    const size_t RowStride = (TransB == CblasNoTrans) ? ldb : 1;
+
+    for (size_t n = 0; n < CountN; n += 16) {
+
+        for (size_t k = 0; k < CountK; k += 2) {
+
+            for (size_t j = 0; j < 16; j++) {
+
+                uint16_t Value0 = 0;
+                uint16_t Value1 = 0;
+
+                if (n + j < CountN) {
+
+                    const float* b = B + (n + j) * ColumnStride + k * RowStride;
+
+                    Value0 = MlasBf16FromFloat(b[0]);
+
+                    if (k + 1 < CountK) {
+                        Value1 = MlasBf16FromFloat(b[RowStride]);
+                    }
+                }
+
+                D[j * 2] = Value0;
+                D[j * 2 + 1] = Value1;
+            }
+
+            D += 32;
+        }
+    }
+}
+
+void
+MlasBf16GemmWidenPanel(
+    float* D,
+    const uint16_t* B,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStride
+    )
+/*++
+
+Routine Description:
+
+    This routine widens a bfloat16 packed panel of matrix B to the single
+    precision panel layout used by the SGEMM kernels.
+
+Arguments:
+
+    D - Supplies the address of the destination panel.
+
+    B - Supplies the address of the first pair of rows of the packed panel.
+
+    CountN - Supplies the number of columns of the panel.
+
+    CountK - Supplies the number of rows of the panel.
+
+    BlockStride - Supplies the number of elements between the blocks of 16
+        columns of the packed panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < CountN; n += 16) {
+
+        const uint16_t* b = B;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+
+            for (size_t j = 0; j < 16; j++) {
+                D[j] = MlasBf16ToFloat(b[j * 2]);
+            }
+
+            D += 16;
+
+            if (k + 1 < CountK) {
+
+                for (size_t j = 0; j < 16; j++) {
+                    D[j] = MlasBf16ToFloat(b[j * 2 + 1]);
+                }
+
+                D += 16;
+            }
+
+            b += 32;
+        }
+
+        B += BlockStride;
+    }
+}
+
+void
+MlasBf16GemmComputeBlock(
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const uint16_t* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies all rows of matrix A with a bfloat16 packed panel
+    of matrix B and accumulates the result to a block of matrix C.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and the block
+        of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of the packed panel.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first element of matrix A to use.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output block should be overwritten rather
+        than accumulated to.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+
+    PMLAS_BF16GEMM_KERNEL Bf16GemmKernel = MlasPlatform.Bf16GemmKernel;
+
+    if (Bf16GemmKernel != nullptr) {
+
+        size_t RowsRemaining = M;
+
+        while (RowsRemaining > 0) {
+
+            size_t RowsHandled = Bf16GemmKernel(A, PanelB, C, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+
+            C += ldc * RowsHandled;
+            A += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+        }
+
+        return;
+    }
+
+#endif
+
+    //
+    // Widen the packed panel to single precision in slices of the default K
+    // stride so that the local panel stays the size used by SGEMM.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float PanelFloat[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    const size_t BlockStride = ((CountK + 1) & ~size_t(1)) * 16;
+
+    size_t CountKThisSlice;
+
+    for (size_t k = 0; k < CountK; k += CountKThisSlice) {
+
+        CountKThisSlice = MLAS_SGEMM_STRIDEK;
+
+        if (CountKThisSlice > (CountK - k)) {
+            CountKThisSlice = CountK - k;
+        }
+
+        MlasBf16GemmWidenPanel(PanelFloat, PanelB + k * 16, CountN, CountKThisSlice, BlockStride);
+
+        MlasSgemmComputeBlock(CblasNoTrans, M, CountN, CountKThisSlice, alpha,
+            A + k, lda, PanelFloat, C, ldc, ZeroMode && k == 0);
+    }
+}
+
+void
+MlasBf16GemmOperation(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const uint16_t* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the bfloat16 matrix/matrix multiply operation
+    (BF16GEMM) on a single thread.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B, offset to the first
+        column to use. The column must be a multiple of the packed N stride.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedK = (K + 1) & ~size_t(1);
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. All
+        // slices except the last have an even number of rows, so the offset
+        // of a slice inside the panel is k * AlignedCountN.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const uint16_t* PanelB = PackedB + n * AlignedK + k * AlignedCountN;
+
+            MlasBf16GemmComputeBlock(M, CountN, CountK, alpha, A + k, lda, PanelB, C + n, ldc, ZeroMode);
+        }
+    }
+}
+
+void
+MlasBf16GemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    BF16GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_BF16GEMM_WORK_BLOCK* WorkBlock = (MLAS_BF16GEMM_WORK_BLOCK*)Context;
+
+    MLAS_BF16GEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasBf16GemmOperation(Segment->M, Segment->N, WorkBlock->K, WorkBlock->alpha,
+        Segment->A, WorkBlock->lda, Segment->B, WorkBlock->beta, Segment->C,
+        WorkBlock->ldc);
+}
+
+bool
+MLASCALL
+MlasBf16GemmIsAccelerated(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the inner products of MlasBf16Gemm are
+    computed with bfloat16 instructions on this processor.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns true if the bfloat16 kernel is used, else false if matrix B is
+    widened to single precision and the SGEMM kernels are used.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    return MlasPlatform.Bf16GemmKernel != nullptr;
+#else
+    return false;
+#endif
+}
+
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasBf16GemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    //
+    // Every panel is padded to a multiple of 16 columns and an even number of
+    // rows. Only the last K slice of a panel can have an odd number of rows.
+    //
+
+    size_t AlignedN = (N + 15) & ~size_t(15);
+    size_t AlignedK = (K + 1) & ~size_t(1);
+
+    return AlignedN * AlignedK * sizeof(uint16_t);
+}
+
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine converts matrix B to bfloat16 values using round to nearest
+    even and packs the values into the panel layout used by MlasBf16Gemm.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasBf16GemmPackBSize bytes and aligned to
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    uint16_t* D = (uint16_t*)PackedB;
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const float* b = (TransB == CblasNoTrans) ? B + n + k * ldb : B + k + n * ldb;
+
+            MlasBf16GemmCopyPackB(D, TransB, b, ldb, CountN, CountK);
+
+            D += AlignedCountN * ((CountK + 1) & ~size_t(1));
+        }
+    }
+}
+
+void
+MLASCALL
+MlasBf16Gemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the bfloat16 matrix/matrix multiply operation
+    (BF16GEMM) with a matrix B that was packed by MlasBf16GemmPackB. The
+    products are accumulated in single precision.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of matrix B packed by MlasBf16GemmPackB
+        with the same N and K.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const uint16_t* B = (const uint16_t*)PackedB;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    int32_t TargetThreadCount;
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasBf16GemmOperation(M, N, K, alpha, A, lda, B, beta, C, ldc);
+        return;
+    }
+
+    MLAS_BF16GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        //
+        // The packed matrix B can only be split at the start of a packed
+        // panel. All preceding panels are full, so the offset of the panel is
+        // n * AlignedK.
+        //
+
+        StrideN = (StrideN + MLAS_SGEMM_PACKED_STRIDEN - 1) & ~size_t(MLAS_SGEMM_PACKED_STRIDEN - 1);
+
+        const size_t AlignedK = (K + 1) & ~size_t(1);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].B = B + n * AlignedK;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * lda;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasBf16GemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+}
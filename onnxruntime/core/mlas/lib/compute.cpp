@@ -0,0 +1,1041 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements miscellaneous computation routines.
+
+    The exponential function uses the same range reduction and polynomial as
+    the exponential inside the error function kernel: the input is split into
+    an integer power of two and a remainder in [-ln(2)/2, ln(2)/2] that is
+    evaluated with a degree 6 polynomial. The power of two is applied as two
+    factors so that results near the limits of the single precision range are
+    not lost to an overflowed or denormal scale factor.
+
+    The natural logarithm splits the input into its exponent and a mantissa in
+    [sqrt(0.5), sqrt(2)) and evaluates log(1 + m) with a degree 9 polynomial,
+    following the Cephes library.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the constants for use by the exponential kernels.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float LowerRange;
+    float UpperRange;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_56;
+    float RoundingBias;
+} MlasExpConstants = {
+    -103.9720840f,
+    88.7228394f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.38319808e-3f,
+    8.37550033e-3f,
+    4.16689515e-2f,
+    1.66664466e-1f,
+    4.99999851e-1f,
+    1.00000000e+0f,
+    1.25829120e+7f,
+};
+
+//
+// Bundles the constants for use by the logarithm kernels.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float MinimumNormal;
+    float DenormalScale;
+    float DenormalExponent;
+    float Sqrt1_2;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+    float poly_7;
+    float poly_8;
+} MlasLogConstants = {
+    1.17549435e-38f,
+    8388608.0f,
+    23.0f,
+    0.707106781186547524f,
+    0.693359375f,
+    -2.12194440e-4f,
+    7.0376836292e-2f,
+    -1.1514610310e-1f,
+    1.1676998740e-1f,
+    -1.2420140846e-1f,
+    1.4249322787e-1f,
+    -1.6668057665e-1f,
+    2.0000714765e-1f,
+    -2.4999993993e-1f,
+    3.3333331174e-1f,
+};
+
+//
+// Define the minimum number of elements processed per thread by the softmax
+// routine.
+//
+
+#define MLAS_SOFTMAX_THREAD_ELEMENTS        (16 * 1024)
+
+//
+// Define the parameters to execute segments of a softmax operation on worker
+// threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    int32_t ThreadCount;
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+Return Value:
+
+    Returns the exponential of each element of the input vector.
+
+--*/
+{
+    const MLAS_FLOAT32X4 LowerRange = MlasBroadcastFloat32x4(MlasExpConstants.LowerRange);
+
+    //
+    // Inputs below the lower range underflow to zero. The comparison is false
+    // for NaN inputs, which propagate through the computation.
+    //
+
+    MLAS_FLOAT32X4 UnderflowMask = MlasGreaterThanFloat32x4(LowerRange, Vector);
+
+    Vector = MlasMaximumFloat32x4(LowerRange, Vector);
+    Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+
+    const MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+
+    MLAS_FLOAT32X4 Biased = MlasMultiplyAddFloat32x4(Vector, MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    MLAS_FLOAT32X4 m = MlasSubtractFloat32x4(Biased, RoundingBias);
+
+    Vector = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    Vector = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), Vector);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasExpConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+
+    //
+    // Scale by 2^m as 2^m1 * 2^m2, where both factors are normalized values.
+    //
+
+    MLAS_FLOAT32X4 m1 = MlasSubtractFloat32x4(MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(0.5f), RoundingBias), RoundingBias);
+    MLAS_FLOAT32X4 m2 = MlasSubtractFloat32x4(m, m1);
+
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m1));
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m2));
+
+    return MlasAndNotFloat32x4(UnderflowMask, p);
+}
+
+MLAS_FORCEINLINE
+float
+MlasComputeExpScalar(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a single element,
+    using the same approximation as MlasComputeExpVector.
+
+Arguments:
+
+    Value - Supplies the input value.
+
+Return Value:
+
+    Returns the exponential of the input value.
+
+--*/
+{
+    if (Value < MlasExpConstants.LowerRange) {
+        return 0.0f;
+    }
+
+    if (Value > MlasExpConstants.UpperRange) {
+        Value = MlasExpConstants.UpperRange;
+    }
+
+    float m = (Value * MlasExpConstants.Log2Reciprocal + MlasExpConstants.RoundingBias) - MlasExpConstants.RoundingBias;
+
+    Value = m * MlasExpConstants.Log2High + Value;
+    Value = m * MlasExpConstants.Log2Low + Value;
+
+    float p = MlasExpConstants.poly_0;
+    p = p * Value + MlasExpConstants.poly_1;
+    p = p * Value + MlasExpConstants.poly_2;
+    p = p * Value + MlasExpConstants.poly_3;
+    p = p * Value + MlasExpConstants.poly_4;
+    p = p * Value + MlasExpConstants.poly_56;
+    p = p * Value + MlasExpConstants.poly_56;
+
+    return std::ldexp(p, int(m));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeLogVector(
+    MLAS_FLOAT32X4 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm for a vector of elements.
+
+    Zero produces negative infinity, positive infinity produces itself and
+    negative or NaN inputs produce NaN.
+
+Arguments:
+
+    Value - Supplies the input vector.
+
+Return Value:
+
+    Returns the natural logarithm of each element of the input vector.
+
+--*/
+{
+    const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+
+    //
+    // Scale denormal inputs into the normalized range and compensate in the
+    // exponent.
+    //
+
+    MLAS_FLOAT32X4 DenormalMask = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.MinimumNormal), Value);
+    MLAS_FLOAT32X4 Scale = MlasOrFloat32x4(MlasAndFloat32x4(DenormalMask, MlasBroadcastFloat32x4(MlasLogConstants.DenormalScale)),
+        MlasAndNotFloat32x4(DenormalMask, One));
+
+    MLAS_FLOAT32X4 x = MlasMultiplyFloat32x4(Value, Scale);
+
+    //
+    // Split the input into the exponent and a mantissa in [0.5, 1).
+    //
+
+    MLAS_INT32X4 Bits = MlasReinterpretAsInt32x4(x);
+
+    MLAS_FLOAT32X4 e = MlasConvertToFloat32x4(MlasSubtractInt32x4(MlasShiftRightInt32x4<23>(Bits), MlasBroadcastInt32x4(126)));
+    e = MlasSubtractFloat32x4(e, MlasAndFloat32x4(DenormalMask, MlasBroadcastFloat32x4(MlasLogConstants.DenormalExponent)));
+
+    MLAS_FLOAT32X4 m = MlasAndFloat32x4(x, MlasReinterpretAsFloat32x4(MlasBroadcastInt32x4(0x007FFFFF)));
+    m = MlasOrFloat32x4(m, MlasBroadcastFloat32x4(0.5f));
+
+    //
+    // Fold the mantissa into [sqrt(0.5), sqrt(2)) and subtract one.
+    //
+
+    MLAS_FLOAT32X4 SmallMask = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.Sqrt1_2), m);
+
+    e = MlasSubtractFloat32x4(e, MlasAndFloat32x4(SmallMask, One));
+    m = MlasAddFloat32x4(MlasSubtractFloat32x4(m, One), MlasAndFloat32x4(SmallMask, m));
+
+    MLAS_FLOAT32X4 z = MlasMultiplyFloat32x4(m, m);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasLogConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_6));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_7));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_8));
+    p = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(p, m), z);
+
+    p = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2Low), p);
+    p = MlasMultiplyAddFloat32x4(z, MlasBroadcastFloat32x4(-0.5f), p);
+
+    MLAS_FLOAT32X4 Result = MlasAddFloat32x4(m, p);
+    Result = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2High), Result);
+
+    //
+    // Substitute the special values. For the inputs that are not positive,
+    // -infinity + sqrt(x) is -infinity for zero and NaN otherwise.
+    //
+
+    MLAS_FLOAT32X4 PositiveMask = MlasGreaterThanFloat32x4(Value, MlasZeroFloat32x4());
+    MLAS_FLOAT32X4 Special = MlasAddFloat32x4(MlasBroadcastFloat32x4(-std::numeric_limits<float>::infinity()), MlasSqrtFloat32x4(Value));
+
+    Result = MlasOrFloat32x4(MlasAndFloat32x4(PositiveMask, Result), MlasAndNotFloat32x4(PositiveMask, Special));
+
+    MLAS_FLOAT32X4 InfinityMask = MlasGreaterThanFloat32x4(Value, MlasBroadcastFloat32x4(std::numeric_limits<float>::max()));
+
+    Result = MlasOrFloat32x4(MlasAndFloat32x4(InfinityMask, Value), MlasAndNotFloat32x4(InfinityMask, Result));
+
+    return Result;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputePowVector(
+    MLAS_FLOAT32X4 Vector,
+    MLAS_FLOAT32X4 ExponentVector,
+    bool IsOddInteger,
+    bool IsInteger
+    )
+/*++
+
+Routine Description:
+
+    This routine raises a vector of elements to a scalar power as
+    exp(Exponent * log(|x|)), then applies the sign rules for negative bases.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+    ExponentVector - Supplies the broadcasted exponent.
+
+    IsOddInteger - Supplies true if the exponent is an odd integer.
+
+    IsInteger - Supplies true if the exponent is an integer.
+
+Return Value:
+
+    Returns each element of the input vector raised to the exponent.
+
+--*/
+{
+    const MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(-0.0f);
+
+    MLAS_FLOAT32X4 Magnitude = MlasAndNotFloat32x4(SignMask, Vector);
+    MLAS_FLOAT32X4 Result = MlasComputeExpVector(MlasMultiplyFloat32x4(ExponentVector, MlasComputeLogVector(Magnitude)));
+
+    if (IsOddInteger) {
+
+        //
+        // A negative base raised to an odd integer power is negative.
+        //
+
+        Result = MlasXorFloat32x4(Result, MlasAndFloat32x4(Vector, SignMask));
+
+    } else if (!IsInteger) {
+
+        //
+        // A finite negative base raised to a fractional power is NaN. A lane
+        // with all bits set is a NaN.
+        //
+
+        MLAS_FLOAT32X4 NegativeMask = MlasAndFloat32x4(MlasGreaterThanFloat32x4(MlasZeroFloat32x4(), Vector),
+            MlasGreaterThanFloat32x4(Vector, MlasBroadcastFloat32x4(-std::numeric_limits<float>::infinity())));
+
+        Result = MlasOrFloat32x4(Result, NegativeMask);
+    }
+
+    return Result;
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeExpVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = MlasComputeExpScalar(*Input++);
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeLogVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+
+        //
+        // Process the remaining elements through a padded vector so that the
+        // results match the vector path.
+        //
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[4], 16) = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+        std::copy_n(Input, N, Buffer);
+        MlasStoreAlignedFloat32x4(Buffer, MlasComputeLogVector(MlasLoadFloat32x4(Buffer)));
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the square root.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasSqrtFloat32x4(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = std::sqrt(*Input++);
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeReciprocalSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the reciprocal of the square root.
+
+    The square root is computed as a correctly rounded value and divided into
+    one, rather than refining the low precision hardware estimate, so the
+    result is within one unit in the last place of the exact value.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasDivideFloat32x4(One, MlasSqrtFloat32x4(MlasLoadFloat32x4(Input))));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = 1.0f / std::sqrt(*Input++);
+
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Input,
+    float Exponent,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine raises each element to a scalar power.
+
+    The exponents that reduce to a product or a reciprocal are computed
+    directly. Other exponents are computed as
+    exp(Exponent * log(|x|)), so the relative error grows with the magnitude
+    of Exponent * log(|x|).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Exponent - Supplies the exponent.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Exponent == 0.0f) {
+        std::fill_n(Output, N, 1.0f);
+        return;
+    }
+
+    if (Exponent == 1.0f || Exponent == 2.0f || Exponent == 3.0f || Exponent == -1.0f) {
+
+        const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+
+        size_t i = 0;
+
+        for (; i + 4 <= N; i += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + i);
+
+            if (Exponent == 2.0f) {
+                Vector = MlasMultiplyFloat32x4(Vector, Vector);
+            } else if (Exponent == 3.0f) {
+                Vector = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector, Vector), Vector);
+            } else if (Exponent == -1.0f) {
+                Vector = MlasDivideFloat32x4(One, Vector);
+            }
+
+            MlasStoreFloat32x4(Output + i, Vector);
+        }
+
+        for (; i < N; i++) {
+
+            float Value = Input[i];
+
+            if (Exponent == 2.0f) {
+                Value = Value * Value;
+            } else if (Exponent == 3.0f) {
+                Value = Value * Value * Value;
+            } else if (Exponent == -1.0f) {
+                Value = 1.0f / Value;
+            }
+
+            Output[i] = Value;
+        }
+
+        return;
+    }
+
+    //
+    // Integers of this magnitude are all even, and are exactly representable
+    // as 32-bit integers below that.
+    //
+
+    const bool IsInteger = (std::floor(Exponent) == Exponent);
+    const bool IsOddInteger = IsInteger && std::fabs(Exponent) < 16777216.0f && (int32_t(Exponent) & 1) != 0;
+
+    const MLAS_FLOAT32X4 ExponentVector = MlasBroadcastFloat32x4(Exponent);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputePowVector(MlasLoadFloat32x4(Input), ExponentVector, IsOddInteger, IsInteger));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[4], 16) = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+        std::copy_n(Input, N, Buffer);
+        MlasStoreAlignedFloat32x4(Buffer, MlasComputePowVector(MlasLoadFloat32x4(Buffer), ExponentVector, IsOddInteger, IsInteger));
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+float
+MlasReduceMaximumRow(
+    const float* Input,
+    size_t D
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum value of a row of elements.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    D - Supplies the number of elements of the row.
+
+Return Value:
+
+    Returns the maximum value of the row.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (D >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector0 = MlasBroadcastFloat32x4(Maximum);
+        MLAS_FLOAT32X4 MaximumVector1 = MaximumVector0;
+
+        while (D >= 8) {
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+            MaximumVector1 = MlasMaximumFloat32x4(MaximumVector1, MlasLoadFloat32x4(Input + 4));
+
+            Input += 8;
+            D -= 8;
+        }
+
+        if (D >= 4) {
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            D -= 4;
+        }
+
+        Maximum = MlasReduceMaximumFloat32x4(MlasMaximumFloat32x4(MaximumVector0, MaximumVector1));
+    }
+
+    while (D > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        D -= 1;
+    }
+
+    return Maximum;
+}
+
+float
+MlasComputeSumExpRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential of each element of a row offset by
+    the negated maximum of the row, and returns the sum of the exponentials.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Optionally supplies the output row that receives the
+        exponentials.
+
+    D - Supplies the number of elements of the row.
+
+    NegativeMaximum - Supplies the negated maximum of the row.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    MLAS_FLOAT32X4 SumVector = MlasZeroFloat32x4();
+
+    while (D >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasComputeExpVector(MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector));
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector);
+            Output += 4;
+        }
+
+        SumVector = MlasAddFloat32x4(SumVector, Vector);
+
+        Input += 4;
+        D -= 4;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(SumVector);
+
+    while (D > 0) {
+
+        float Value = MlasComputeExpScalar(*Input + NegativeMaximum);
+
+        if (Output != nullptr) {
+            *Output++ = Value;
+        }
+
+        Sum += Value;
+
+        Input += 1;
+        D -= 1;
+    }
+
+    return Sum;
+}
+
+void
+MlasComputeSoftmaxRows(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for a set of
+    rows.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed,
+        else false if the softmax function should be computed.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        const float Maximum = MlasReduceMaximumRow(Input, D);
+
+        if (LogSoftmax) {
+
+            //
+            // Output = Input - Maximum - log(sum(exp(Input - Maximum))).
+            //
+
+            const float Sum = MlasComputeSumExpRow(Input, nullptr, D, -Maximum);
+            const float Offset = -Maximum - std::log(Sum);
+
+            const MLAS_FLOAT32X4 OffsetVector = MlasBroadcastFloat32x4(Offset);
+
+            size_t d = 0;
+
+            for (; d + 4 <= D; d += 4) {
+                MlasStoreFloat32x4(Output + d, MlasAddFloat32x4(MlasLoadFloat32x4(Input + d), OffsetVector));
+            }
+
+            for (; d < D; d++) {
+                Output[d] = Input[d] + Offset;
+            }
+
+        } else {
+
+            //
+            // Output = exp(Input - Maximum) / sum(exp(Input - Maximum)).
+            //
+
+            const float Sum = MlasComputeSumExpRow(Input, Output, D, -Maximum);
+            const float Scale = 1.0f / Sum;
+
+            const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+            size_t d = 0;
+
+            for (; d + 4 <= D; d += 4) {
+                MlasStoreFloat32x4(Output + d, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output + d), ScaleVector));
+            }
+
+            for (; d < D; d++) {
+                Output[d] *= Scale;
+            }
+        }
+
+        Input += D;
+        Output += D;
+        N -= 1;
+    }
+}
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+    const size_t ThreadCount = size_t(WorkBlock->ThreadCount);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t StrideN = N / ThreadCount;
+    size_t ExtraN = N % ThreadCount;
+
+    size_t StartN;
+    size_t CountN;
+
+    if (size_t(Index) < ExtraN) {
+        StrideN += 1;
+        StartN = StrideN * size_t(Index);
+        CountN = StrideN;
+    } else {
+        StartN = StrideN * size_t(Index) + ExtraN;
+        CountN = StrideN;
+    }
+
+    MlasComputeSoftmaxRows(WorkBlock->Input + StartN * D, WorkBlock->Output + StartN * D,
+        CountN, D, WorkBlock->LogSoftmax);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along the rows
+    of a matrix.
+
+    The maximum of each row is found with a vector reduction, then the
+    exponentials and their sum are computed in a single fused pass, and the
+    row is finally scaled (softmax) or offset (log softmax).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed,
+        else false if the softmax function should be computed.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the number of elements.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_ELEMENTS * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_ELEMENTS)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasComputeSoftmaxRows(Input, Output, N, D, LogSoftmax);
+        return;
+    }
+
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
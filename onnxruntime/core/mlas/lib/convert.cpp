@@ -0,0 +1,584 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convert.cpp
+
+Abstract:
+
+    This module implements routines to convert buffers between single
+    precision floats and the half precision and 8-bit integer formats.
+
+    The half precision conversions are dispatched to kernels that use the
+    F16C instruction set when available. The portable kernels below handle
+    denormals, infinities and NaNs and round to nearest even.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasConvertHalfToFloat(
+    unsigned short Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision float to a single precision float.
+
+Arguments:
+
+    Value - Supplies the half precision float.
+
+Return Value:
+
+    Returns the single precision float.
+
+--*/
+{
+    const uint32_t ShiftedExponent = 0x7C00 << 13;
+    const uint32_t MagicDenormal = 113 << 23;
+
+    union { uint32_t u; float f; } Result, Magic;
+
+    Result.u = uint32_t(Value & 0x7FFF) << 13;
+    const uint32_t Exponent = Result.u & ShiftedExponent;
+    Result.u += (127 - 15) << 23;
+
+    if (Exponent == ShiftedExponent) {
+        Result.u += (128 - 16) << 23;
+    } else if (Exponent == 0) {
+        Magic.u = MagicDenormal;
+        Result.u += 1 << 23;
+        Result.f -= Magic.f;
+    }
+
+    Result.u |= uint32_t(Value & 0x8000) << 16;
+
+    return Result.f;
+}
+
+MLAS_FORCEINLINE
+unsigned short
+MlasConvertFloatToHalf(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision float to a half precision float,
+    rounding to nearest even.
+
+Arguments:
+
+    Value - Supplies the single precision float.
+
+Return Value:
+
+    Returns the half precision float.
+
+--*/
+{
+    const uint32_t Float32Infinity = 255 << 23;
+    const uint32_t Float16Overflow = (127 + 16) << 23;
+    const uint32_t Float16Denormal = 113 << 23;
+    const uint32_t MagicDenormal = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    union { uint32_t u; float f; } Input, Magic;
+
+    Input.f = Value;
+    const uint32_t Sign = Input.u & 0x80000000;
+    Input.u ^= Sign;
+
+    uint32_t Result;
+
+    if (Input.u >= Float16Overflow) {
+        Result = (Input.u > Float32Infinity) ? 0x7E00 : 0x7C00;
+    } else if (Input.u < Float16Denormal) {
+        Magic.u = MagicDenormal;
+        Input.f += Magic.f;
+        Result = Input.u - MagicDenormal;
+    } else {
+        const uint32_t MantissaOdd = (Input.u >> 13) & 1;
+        Input.u += (uint32_t(15 - 127) << 23) + 0xFFF;
+        Input.u += MantissaOdd;
+        Result = Input.u >> 13;
+    }
+
+    return (unsigned short)(Result | (Sign >> 16));
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision floats to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_WIN32)
+
+    while (Count >= 4) {
+
+        float16x4_t Half = vreinterpret_f16_u16(vld1_u16(Source));
+        vst1q_f32(Destination, vcvt_f32_f16(Half));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasConvertHalfToFloat(Source[i]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of half precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS) && !defined(_WIN32)
+
+    while (Count >= 4) {
+
+        float16x4_t Half = vcvt_f16_f32(vld1q_f32(Source));
+        vst1_u16(Destination, vreinterpret_u16_f16(Half));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasConvertFloatToHalf(Source[i]);
+    }
+}
+
+extern "C"
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision floats to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertHalfToFloatKernel(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of half precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertFloatToHalfKernel(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
+
+template<typename OutputType>
+MLAS_FORCEINLINE
+OutputType
+MlasConvertFloatToInteger(
+    float Value
+    )
+{
+    const float MinimumValue = float(std::numeric_limits<OutputType>::min());
+    const float MaximumValue = float(std::numeric_limits<OutputType>::max());
+
+    //
+    // The comparisons are ordered so that NaNs convert to the minimum value,
+    // which matches the vector implementation.
+    //
+
+    Value = (Value > MinimumValue) ? Value : MinimumValue;
+    Value = (Value < MaximumValue) ? Value : MaximumValue;
+
+    return OutputType(int32_t(Value));
+}
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+
+template<typename OutputType>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasConvertFloatToInteger32x4(
+    const float* Source
+    )
+/*++
+
+Routine Description:
+
+    This routine converts four floats to 32-bit integers that are clamped to
+    the range of OutputType, so that they can be narrowed without further
+    saturation.
+
+--*/
+{
+    const MLAS_FLOAT32X4 MinimumVector = MlasBroadcastFloat32x4(float(std::numeric_limits<OutputType>::min()));
+    const MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(float(std::numeric_limits<OutputType>::max()));
+
+    MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Source);
+
+    //
+    // MAXPS returns the second operand if either operand is a NaN, so NaNs
+    // convert to the minimum value as in the scalar implementation. The NEON
+    // conversion produces zero instead.
+    //
+
+    Vector = MlasMaximumFloat32x4(Vector, MinimumVector);
+    Vector = MlasMinimumFloat32x4(Vector, MaximumVector);
+
+#if defined(MLAS_NEON_INTRINSICS)
+    return vcvtq_s32_f32(Vector);
+#else
+    return _mm_cvttps_epi32(Vector);
+#endif
+}
+
+#endif
+
+template<typename OutputType>
+void
+MlasConvertFloatToIntegerBuffer(
+    const float* Source,
+    OutputType* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+
+    while (Count >= 16) {
+
+        MLAS_INT32X4 Vector0 = MlasConvertFloatToInteger32x4<OutputType>(Source);
+        MLAS_INT32X4 Vector1 = MlasConvertFloatToInteger32x4<OutputType>(Source + 4);
+        MLAS_INT32X4 Vector2 = MlasConvertFloatToInteger32x4<OutputType>(Source + 8);
+        MLAS_INT32X4 Vector3 = MlasConvertFloatToInteger32x4<OutputType>(Source + 12);
+
+#if defined(MLAS_NEON_INTRINSICS)
+        int16x8_t Words0 = vcombine_s16(vmovn_s32(Vector0), vmovn_s32(Vector1));
+        int16x8_t Words1 = vcombine_s16(vmovn_s32(Vector2), vmovn_s32(Vector3));
+
+        if (std::is_signed<OutputType>::value) {
+            int8x16_t Bytes = vcombine_s8(vmovn_s16(Words0), vmovn_s16(Words1));
+            vst1q_s8(reinterpret_cast<int8_t*>(Destination), Bytes);
+        } else {
+            uint8x16_t Bytes = vcombine_u8(vqmovun_s16(Words0), vqmovun_s16(Words1));
+            vst1q_u8(reinterpret_cast<uint8_t*>(Destination), Bytes);
+        }
+#else
+        __m128i Words0 = _mm_packs_epi32(Vector0, Vector1);
+        __m128i Words1 = _mm_packs_epi32(Vector2, Vector3);
+        __m128i Bytes;
+
+        if (std::is_signed<OutputType>::value) {
+            Bytes = _mm_packs_epi16(Words0, Words1);
+        } else {
+            Bytes = _mm_packus_epi16(Words0, Words1);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), Bytes);
+#endif
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+#endif
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasConvertFloatToInteger<OutputType>(Source[i]);
+    }
+}
+
+template<typename InputType>
+void
+MlasConvertIntegerToFloatBuffer(
+    const InputType* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    while (Count >= 16) {
+
+        __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+        __m128i Words0;
+        __m128i Words1;
+
+        if (std::is_signed<InputType>::value) {
+            Words0 = _mm_srai_epi16(_mm_unpacklo_epi8(Bytes, Bytes), 8);
+            Words1 = _mm_srai_epi16(_mm_unpackhi_epi8(Bytes, Bytes), 8);
+        } else {
+            Words0 = _mm_unpacklo_epi8(Bytes, _mm_setzero_si128());
+            Words1 = _mm_unpackhi_epi8(Bytes, _mm_setzero_si128());
+        }
+
+        _mm_storeu_ps(Destination, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Words0, Words0), 16)));
+        _mm_storeu_ps(Destination + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Words0, Words0), 16)));
+        _mm_storeu_ps(Destination + 8, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Words1, Words1), 16)));
+        _mm_storeu_ps(Destination + 12, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Words1, Words1), 16)));
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+    while (Count >= 8) {
+
+        int16x8_t Words;
+
+        if (std::is_signed<InputType>::value) {
+            Words = vmovl_s8(vld1_s8(reinterpret_cast<const int8_t*>(Source)));
+        } else {
+            Words = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t*>(Source))));
+        }
+
+        vst1q_f32(Destination, vcvtq_f32_s32(vmovl_s16(vget_low_s16(Words))));
+        vst1q_f32(Destination + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(Words))));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+#endif
+
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = float(Source[i]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToInt8Buffer(
+    const float* Source,
+    int8_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of signed 8-bit integers. Values are truncated toward
+    zero and saturated to the range of the destination type.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertFloatToIntegerBuffer(Source, Destination, Count);
+}
+
+void
+MLASCALL
+MlasConvertFloatToUInt8Buffer(
+    const float* Source,
+    uint8_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of unsigned 8-bit integers. Values are truncated toward
+    zero and saturated to the range of the destination type.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertFloatToIntegerBuffer(Source, Destination, Count);
+}
+
+void
+MLASCALL
+MlasConvertInt8ToFloatBuffer(
+    const int8_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of signed 8-bit integers to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertIntegerToFloatBuffer(Source, Destination, Count);
+}
+
+void
+MLASCALL
+MlasConvertUInt8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of unsigned 8-bit integers to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertIntegerToFloatBuffer(Source, Destination, Count);
+}
@@ -35,10 +35,6 @@ struct MLAS_CONV_WORK_BLOCK {
     const float* Bias;
     float* WorkingBuffer;
     float* Output;
-    struct SEGMENT {
-        size_t StartN;
-        size_t CountN;
-    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
     int32_t TargetThreadCount;
 };
 
@@ -571,7 +567,7 @@ Return Value:
         //
 
         size_t CountK;
-        float beta = 0.0f;
+        float beta = Parameters->Beta;
         float* SegmentOutput = Output + SegmentStartN + n;
 
         for (size_t k = 0; k < K; k += CountK) {
@@ -607,7 +603,7 @@ Return Value:
 }
 
 void
-MlasConvOperationThreaded(
+MlasConvExpandThenGemmSegmentedThreaded(
     void* Context,
     int32_t Index
     )
@@ -618,6 +614,10 @@ Routine Description:
     This routine is invoked from a worker thread to execute a segment of a
     convolution operation.
 
+    The segments of the N dimension of all batches and groups are partitioned
+    across the threads, so that convolutions with many small batches or
+    groups are also able to use all threads.
+
 Arguments:
 
     Context - Supplies the pointer to the context for the threaded operation.
@@ -632,14 +632,106 @@ Return Value:
 {
     MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
 
-    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    const size_t SegmentCount = (OutputSize + ThreadStrideN - 1) / ThreadStrideN;
+
+    //
+    // Compute the range of segments to use for this thread.
+    //
+
+    size_t SegmentIndex;
+    size_t SegmentRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount, BatchGroupCount * SegmentCount,
+        &SegmentIndex, &SegmentRemaining);
 
     float* ColumnBuffer =
         WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
 
-    MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
-        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
-        Segment->CountN);
+    while (SegmentRemaining > 0) {
+
+        const size_t bg = SegmentIndex / SegmentCount;
+        const size_t group = bg % GroupCount;
+
+        const size_t SegmentStartN = (SegmentIndex % SegmentCount) * ThreadStrideN;
+        const size_t SegmentCountN = std::min(OutputSize - SegmentStartN, ThreadStrideN);
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasConvOperation(Parameters, WorkBlock->Input + bg * InputGroupSize,
+            WorkBlock->Filter + group * FilterGroupSize, bias, ColumnBuffer,
+            WorkBlock->Output + bg * OutputGroupSize, SegmentStartN, SegmentCountN);
+
+        SegmentIndex++;
+        SegmentRemaining--;
+    }
+}
+
+void
+MlasConvExpandThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to expand a portion of the
+    input tensor to the convolution patches of the full matrix.
+
+    The rows of the K dimension are partitioned across the threads.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t OutputSize = Parameters->OutputSize;
+
+    size_t k;
+    size_t CountK;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, Parameters->K, &k, &CountK);
+
+    if (CountK == 0) {
+        return;
+    }
+
+    float* ColumnBuffer = WorkBlock->WorkingBuffer + k * OutputSize;
+
+    if (Parameters->Dimensions == 2) {
+        MlasConvIm2Col(Parameters, WorkBlock->Input, ColumnBuffer, k, CountK, 0, OutputSize);
+    } else {
+        MlasConvVol2Col(Parameters, WorkBlock->Input, ColumnBuffer, k, CountK, 0, OutputSize);
+    }
 }
 
 void
@@ -718,8 +810,8 @@ Return Value:
         //
 
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb,
+            Parameters->Beta, output, OutputSize);
 
         //
         // Apply the activation with optional bias.
@@ -736,94 +828,298 @@ Return Value:
     }
 }
 
-inline
-bool
-MlasConvTryMultithread(
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasConvDepthwiseLoadStride2Float32x4(
+    const float* Buffer
+    )
+/*++
+
+Routine Description:
+
+    This routine loads the even elements of the eight elements at the buffer.
+
+Arguments:
+
+    Buffer - Supplies the address of the elements to load.
+
+Return Value:
+
+    Returns the vector of elements 0, 2, 4, and 6.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vuzp1q_f32(vld1q_f32(Buffer), vld1q_f32(Buffer + 4));
+#elif defined(MLAS_NEON32_INTRINSICS)
+    return vuzpq_f32(vld1q_f32(Buffer), vld1q_f32(Buffer + 4)).val[0];
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_shuffle_ps(_mm_loadu_ps(Buffer), _mm_loadu_ps(Buffer + 4), _MM_SHUFFLE(2, 0, 2, 0));
+#endif
+}
+
+template<size_t KernelWidthT>
+void
+MlasConvDepthwiseRow(
     const MLAS_CONV_PARAMETERS* Parameters,
     const float* Input,
     const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
     float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    size_t oh
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+    This routine computes one output row of a single channel of a depthwise
+    convolution operation.
+
+    The output columns where the kernel lies entirely inside the input row are
+    computed four at a time with the accumulators held in registers. The
+    remaining columns at the edges check each input column against the
+    padding.
 
 Arguments:
 
     Parameters - Supplies the structure that contains the convolution
         parameters.
 
-    Input - Supplies the input tensor.
+    Input - Supplies the input channel.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the filter for the channel.
 
-    Bias - Optionally supplies the bias vector.
+    Output - Supplies the output row.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    oh - Supplies the index of the output row.
 
-    Output - Supplies the output tensor.
-
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    KernelWidthT - Supplies the kernel width if known at compile time, else
+        zero to use the kernel width from the parameters.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    None.
 
 --*/
 {
-    MLAS_CONV_WORK_BLOCK WorkBlock;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = (KernelWidthT != 0) ? KernelWidthT : Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
 
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    //
+    // Compute the range of output columns where every kernel column reads
+    // from inside the input row.
+    //
+
+    const size_t KernelExtentWidth = (KernelWidth - 1) * DilationWidth + 1;
+
+    size_t InteriorStart = (PaddingLeft + StrideWidth - 1) / StrideWidth;
+    size_t InteriorEnd = 0;
 
-    if (ThreadStrideN >= OutputSize) {
-        return false;
+    if (InputWidth + PaddingLeft >= KernelExtentWidth) {
+        InteriorEnd = (InputWidth + PaddingLeft - KernelExtentWidth) / StrideWidth + 1;
     }
 
+    InteriorEnd = std::min(InteriorEnd, OutputWidth);
+    InteriorStart = std::min(InteriorStart, InteriorEnd);
+
     //
-    // Initialize the common fields of the work block.
+    // The vector loop with a stride of two also loads the odd input column
+    // that follows the last even input column of each kernel column.
     //
 
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
+    size_t VectorEnd = InteriorStart;
+
+    if (StrideWidth == 1) {
+        VectorEnd = InteriorEnd;
+    } else if (StrideWidth == 2) {
+        while (VectorEnd + 4 <= InteriorEnd &&
+            (VectorEnd + 3) * 2 + KernelExtentWidth < InputWidth + PaddingLeft) {
+            VectorEnd += 4;
+        }
+    }
+
+    const size_t ihStart = oh * StrideHeight;
 
     //
-    // Segment the operation across multiple threads.
+    // The output row is accumulated into the existing output if requested.
     //
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+    const float Beta = Parameters->Beta;
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+    size_t ow = 0;
 
-        SegmentCountN = OutputSize - SegmentStartN;
+    while (ow < OutputWidth) {
+
+        if (ow >= InteriorStart && ow + 4 <= VectorEnd) {
+
+            MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+            if (Beta != 0.0f) {
+                Accumulator = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output + ow),
+                    MlasBroadcastFloat32x4(Beta));
+            }
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                size_t ih = ihStart + kh * DilationHeight - PaddingTop;
+
+                if (ih >= InputHeight) {
+                    continue;
+                }
+
+                const float* row = Input + ih * InputWidth + ow * StrideWidth - PaddingLeft;
+                const float* filter = Filter + kh * KernelWidth;
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                    MLAS_FLOAT32X4 InputVector = (StrideWidth == 1) ?
+                        MlasLoadFloat32x4(row + kw * DilationWidth) :
+                        MlasConvDepthwiseLoadStride2Float32x4(row + kw * DilationWidth);
+
+                    Accumulator = MlasMultiplyAddFloat32x4(InputVector,
+                        MlasBroadcastFloat32x4(filter[kw]), Accumulator);
+                }
+            }
+
+            MlasStoreFloat32x4(Output + ow, Accumulator);
+
+            ow += 4;
+
+        } else {
+
+            const bool IsInterior = (ow >= InteriorStart && ow < InteriorEnd);
+
+            float Accumulator = (Beta != 0.0f) ? Output[ow] * Beta : 0.0f;
+
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                size_t ih = ihStart + kh * DilationHeight - PaddingTop;
+
+                if (ih >= InputHeight) {
+                    continue;
+                }
+
+                const float* row = Input + ih * InputWidth;
+                const float* filter = Filter + kh * KernelWidth;
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                    size_t iw = ow * StrideWidth + kw * DilationWidth - PaddingLeft;
+
+                    if (IsInterior || iw < InputWidth) {
+                        Accumulator += row[iw] * filter[kw];
+                    }
+                }
+            }
+
+            Output[ow] = Accumulator;
+
+            ow += 1;
         }
+    }
+}
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
 
-        Index++;
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+    The output rows of all batches and channels are partitioned across the
+    threads.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount,
+        Parameters->BatchCount * GroupCount * OutputHeight, &RowIndex, &RowRemaining);
+
+    //
+    // Select the row routine specialized for the common kernel widths.
+    //
+
+    void (*RowRoutine)(const MLAS_CONV_PARAMETERS*, const float*, const float*, float*, size_t);
+
+    switch (Parameters->KernelShape[1]) {
+
+        case 3:
+            RowRoutine = MlasConvDepthwiseRow<3>;
+            break;
+
+        case 5:
+            RowRoutine = MlasConvDepthwiseRow<5>;
+            break;
+
+        default:
+            RowRoutine = MlasConvDepthwiseRow<0>;
+            break;
     }
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
+    while (RowRemaining > 0) {
+
+        const size_t bg = RowIndex / OutputHeight;
+        const size_t oh = RowIndex % OutputHeight;
+        const size_t group = bg % GroupCount;
+
+        float* output = WorkBlock->Output + bg * OutputSize + oh * OutputWidth;
 
-    return true;
+        RowRoutine(Parameters, WorkBlock->Input + bg * InputSize,
+            WorkBlock->Filter + group * K, output, oh);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, 1, OutputWidth,
+            OutputWidth);
+
+        RowIndex++;
+        RowRemaining--;
+    }
 }
 
 void
@@ -881,6 +1177,27 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // Schedule the output rows of a depthwise convolution across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -910,6 +1227,28 @@ Return Value:
         return;
     }
 
+    //
+    // Schedule the segments of all batches and groups across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmExpandThenGemmSegmented) {
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = WorkingBuffer;
+        WorkBlock.Output = Output;
+
+        MlasExecuteThreaded(MlasConvExpandThenGemmSegmentedThreaded, &WorkBlock,
+            Parameters->ThreadCount, ThreadPool);
+
+        return;
+    }
+
     //
     // Iterate over each batch and group.
     //
@@ -934,8 +1273,8 @@ Return Value:
                     //
 
                     MlasGemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize, ThreadPool);
+                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb,
+                        Parameters->Beta, Output, OutputSize, ThreadPool);
 
                     //
                     // Apply the activation with optional bias.
@@ -950,18 +1289,22 @@ Return Value:
                 case MlasConvAlgorithmExpandThenGemm:
                 {
                     //
-                    // Expand the input tensor to the working buffer and then invoke the
-                    // threaded GEMM.
+                    // Expand the input tensor to the working buffer across
+                    // multiple threads and then invoke the threaded GEMM.
                     //
 
-                    if (Parameters->Dimensions == 2) {
-                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    } else {
-                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    }
+                    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+                    WorkBlock.Parameters = Parameters;
+                    WorkBlock.Input = Input;
+                    WorkBlock.WorkingBuffer = WorkingBuffer;
+                    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+                    MlasExecuteThreaded(MlasConvExpandThreaded, &WorkBlock,
+                        Parameters->ThreadCount, ThreadPool);
 
                     MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool);
+                        K, WorkingBuffer, OutputSize, Parameters->Beta, Output, OutputSize, ThreadPool);
 
                     //
                     // Apply the activation with optional bias.
@@ -974,18 +1317,17 @@ Return Value:
                 }
 
                 case MlasConvAlgorithmExpandThenGemmSegmented:
+                case MlasConvAlgorithmDepthwise:
+                case MlasConvAlgorithmWinograd:
                 {
                     //
-                    // Attempt to launch the convolution across multiple threads or fall
-                    // back to a single thread.
+                    // The segmented and depthwise convolutions were executed
+                    // above for all batches and groups. The Winograd algorithm is only
+                    // selected by MlasConvWinogradPrepare and requires the
+                    // transformed filter, so the convolution must be executed by
+                    // MlasConvWinograd.
                     //
 
-                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
-                        Output, ThreadPool)) {
-                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
-                            Output, 0, OutputSize);
-                    }
-
                     break;
                 }
             }
@@ -1022,6 +1364,7 @@ MlasConvPrepare(
     size_t FilterCount,
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
+    float Beta,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1066,6 +1409,11 @@ Arguments:
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
+    Beta - Supplies the scalar multiplier of the existing contents of the
+        output tensor, which is accumulated into the convolution output before
+        the bias and activation are applied. This allows a residual tensor to
+        be summed while the output is still in the cache.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1085,6 +1433,7 @@ Return Value:
     Parameters->GroupCount = GroupCount;
     Parameters->InputChannels = InputChannels;
     Parameters->FilterCount = FilterCount;
+    Parameters->Beta = Beta;
 
     size_t InputSize = 1;
     size_t OutputSize = 1;
@@ -1166,6 +1515,42 @@ Return Value:
         }
     }
 
+    if (Dimensions == 2 && InputChannels == 1 && FilterCount == 1) {
+
+        //
+        // Detect a depthwise convolution, where each output channel only
+        // depends on the matching input channel. Expanding the input to invoke
+        // GEMMs with a single row is inefficient, so compute the output rows
+        // directly and partition the rows across multiple threads.
+        //
+
+        const size_t RowCount = BatchCount * GroupCount * Parameters->OutputShape[0];
+        const double Complexity = double(RowCount) * double(Parameters->OutputShape[1]) * double(K);
+
+        int32_t TargetThreadCount;
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        } else {
+            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        if (size_t(TargetThreadCount) >= RowCount) {
+            TargetThreadCount = int32_t(std::max(RowCount, size_t(1)));
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
@@ -1175,6 +1560,34 @@ Return Value:
 
         Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
 
+        //
+        // Compute the number of threads to expand the rows of the K dimension.
+        // The expansion only copies the input tensor, so use the number of
+        // elements as the complexity.
+        //
+
+        const double Complexity = double(OutputSize) * double(K);
+
+        int32_t TargetThreadCount;
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        } else {
+            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        if (size_t(TargetThreadCount) >= K) {
+            TargetThreadCount = int32_t(K);
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
         *WorkingBufferSize = OutputSize * K;
 
     } else {
@@ -1224,6 +1637,42 @@ Return Value:
             }
         }
 
+        //
+        // A single batch and group may not have enough work to use all of the
+        // threads. The segments of all batches and groups are scheduled
+        // together, so compute the number of target threads given the
+        // complexity of the entire operation.
+        //
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        if (BatchGroupCount > 1 && TargetThreadCount < MaximumThreadCount) {
+
+            const size_t TotalSegmentCount = BatchGroupCount * ((OutputSize + StrideN - 1) / StrideN);
+
+            Complexity *= double(BatchGroupCount);
+
+            int32_t BatchThreadCount;
+
+            if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+                BatchThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+            } else {
+                BatchThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+            }
+
+            if (BatchThreadCount >= MaximumThreadCount) {
+                BatchThreadCount = MaximumThreadCount;
+            }
+
+            if (size_t(BatchThreadCount) >= TotalSegmentCount) {
+                BatchThreadCount = int32_t(TotalSegmentCount);
+            }
+
+            if (BatchThreadCount > TargetThreadCount) {
+                TargetThreadCount = BatchThreadCount;
+            }
+        }
+
         Parameters->ThreadCount = TargetThreadCount;
 
         Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
@@ -0,0 +1,379 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gelu.cpp
+
+Abstract:
+
+    This module implements routines to compute the Gaussian Error Linear Unit
+    (GELU) activation, optionally preceded by the addition of a bias vector.
+
+    The exact form uses the error function and the approximate form uses the
+    hyperbolic tangent:
+
+        Gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+        FastGelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+
+    The bias addition, the argument of the transcendental function and the
+    final product are computed in blocks small enough to stay in the cache,
+    around the platform specific erf and tanh kernels.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of elements processed per block.
+//
+
+#define MLAS_GELU_BLOCK_SIZE                256
+
+//
+// Define the minimum number of elements processed per thread.
+//
+
+#define MLAS_GELU_THREAD_ELEMENTS           (16 * 1024)
+
+//
+// Define the constants of the GELU computations.
+//
+
+#define MLAS_GELU_SQRT1_2                   0.7071067811865475f
+#define MLAS_GELU_TANH_ALPHA                0.7978845608028654f
+#define MLAS_GELU_TANH_BETA                 0.035677408136300125f
+
+//
+// Define the parameters to execute segments of a GELU operation on worker
+// threads.
+//
+
+struct MLAS_GELU_WORK_BLOCK {
+    MLAS_GELU_KIND Kind;
+    const float* Input;
+    const float* Bias;
+    float* Output;
+    size_t N;
+    size_t BiasLength;
+    int32_t ThreadCount;
+};
+
+void
+MlasGeluBlock(
+    MLAS_GELU_KIND Kind,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the GELU activation for a block of elements.
+
+Arguments:
+
+    Kind - Supplies the form of the GELU activation.
+
+    Input - Supplies the input buffer.
+
+    Bias - Optionally supplies the bias buffer, which holds N elements.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process. The value must not exceed
+        MLAS_GELU_BLOCK_SIZE.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Value[MLAS_GELU_BLOCK_SIZE], 16);
+
+    //
+    // Add the bias and compute the argument of the transcendental function in
+    // the output buffer. Each input element is read before the output element
+    // at the same index is written, so the buffers may be the same.
+    //
+
+    const MLAS_FLOAT32X4 Sqrt1_2Broadcast = MlasBroadcastFloat32x4(MLAS_GELU_SQRT1_2);
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(MLAS_GELU_TANH_ALPHA);
+    const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(MLAS_GELU_TANH_BETA);
+
+    size_t i = 0;
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + i);
+
+        if (Bias != nullptr) {
+            Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + i));
+        }
+
+        MlasStoreAlignedFloat32x4(Value + i, Vector);
+
+        if (Kind == MlasGeluErf) {
+            Vector = MlasMultiplyFloat32x4(Vector, Sqrt1_2Broadcast);
+        } else {
+            MLAS_FLOAT32X4 VectorSquared = MlasMultiplyFloat32x4(Vector, Vector);
+            Vector = MlasMultiplyFloat32x4(Vector,
+                MlasMultiplyAddFloat32x4(VectorSquared, BetaBroadcast, AlphaBroadcast));
+        }
+
+        MlasStoreFloat32x4(Output + i, Vector);
+    }
+
+    for (; i < N; i++) {
+
+        float x = Input[i];
+
+        if (Bias != nullptr) {
+            x += Bias[i];
+        }
+
+        Value[i] = x;
+
+        if (Kind == MlasGeluErf) {
+            Output[i] = x * MLAS_GELU_SQRT1_2;
+        } else {
+            Output[i] = x * (MLAS_GELU_TANH_BETA * x * x + MLAS_GELU_TANH_ALPHA);
+        }
+    }
+
+    if (Kind == MlasGeluErf) {
+        MlasComputeErf(Output, Output, N);
+    } else {
+        MlasComputeTanh(Output, Output, N);
+    }
+
+    //
+    // Compute 0.5 * x * (1 + f(argument)).
+    //
+
+    const MLAS_FLOAT32X4 HalfBroadcast = MlasBroadcastFloat32x4(0.5f);
+
+    i = 0;
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 HalfValue = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Value + i), HalfBroadcast);
+        MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(HalfValue, MlasLoadFloat32x4(Output + i), HalfValue);
+
+        MlasStoreFloat32x4(Output + i, Vector);
+    }
+
+    for (; i < N; i++) {
+
+        float HalfValue = 0.5f * Value[i];
+
+        Output[i] = HalfValue * Output[i] + HalfValue;
+    }
+}
+
+void
+MlasGeluSegment(
+    MLAS_GELU_KIND Kind,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t BiasLength,
+    size_t BiasOffset
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the GELU activation for a segment of the elements.
+
+Arguments:
+
+    Kind - Supplies the form of the GELU activation.
+
+    Input - Supplies the input buffer.
+
+    Bias - Optionally supplies the bias buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    BiasLength - Supplies the number of elements of the bias buffer.
+
+    BiasOffset - Supplies the index of the bias element that applies to the
+        first element of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        size_t CountN = (N < MLAS_GELU_BLOCK_SIZE) ? N : MLAS_GELU_BLOCK_SIZE;
+
+        //
+        // A block does not cross the end of the bias vector, so that the bias
+        // elements of the block are contiguous.
+        //
+
+        if (Bias != nullptr && CountN > BiasLength - BiasOffset) {
+            CountN = BiasLength - BiasOffset;
+        }
+
+        MlasGeluBlock(Kind, Input, (Bias != nullptr) ? Bias + BiasOffset : nullptr, Output, CountN);
+
+        if (Bias != nullptr) {
+            BiasOffset += CountN;
+            if (BiasOffset == BiasLength) {
+                BiasOffset = 0;
+            }
+        }
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+void
+MlasGeluThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    GELU operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_GELU_WORK_BLOCK* WorkBlock = (MLAS_GELU_WORK_BLOCK*)Context;
+
+    const size_t N = WorkBlock->N;
+    const size_t ThreadCount = size_t(WorkBlock->ThreadCount);
+
+    //
+    // Partition the elements on a boundary of the vector size.
+    //
+
+    const size_t Stride = (((N + ThreadCount - 1) / ThreadCount) + 3) & ~size_t(3);
+    const size_t Start = size_t(Index) * Stride;
+
+    if (Start >= N) {
+        return;
+    }
+
+    const size_t CountN = (N - Start < Stride) ? N - Start : Stride;
+    const size_t BiasOffset = (WorkBlock->Bias != nullptr) ? Start % WorkBlock->BiasLength : 0;
+
+    MlasGeluSegment(WorkBlock->Kind, WorkBlock->Input + Start, WorkBlock->Bias,
+        WorkBlock->Output + Start, CountN, WorkBlock->BiasLength, BiasOffset);
+}
+
+void
+MLASCALL
+MlasComputeGelu(
+    MLAS_GELU_KIND Kind,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    size_t BiasLength,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the GELU activation of a buffer, optionally adding a
+    bias vector to the input:
+
+        Output[i] = Gelu(Input[i] + Bias[i % BiasLength])
+
+Arguments:
+
+    Kind - Supplies the form of the GELU activation: MlasGeluErf for the exact
+        form or MlasGeluTanh for the approximation that uses tanh.
+
+    Input - Supplies the input buffer.
+
+    Bias - Optionally supplies the bias buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    BiasLength - Supplies the number of elements of the bias buffer. The value
+        must divide N if the bias buffer is supplied.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || (Bias != nullptr && BiasLength == 0)) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the number of elements.
+    //
+
+    int32_t TargetThreadCount;
+
+    if (N < size_t(MLAS_GELU_THREAD_ELEMENTS) * MLAS_MAXIMUM_THREAD_COUNT) {
+        TargetThreadCount = int32_t(N / MLAS_GELU_THREAD_ELEMENTS) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasGeluSegment(Kind, Input, Bias, Output, N, BiasLength, 0);
+        return;
+    }
+
+    MLAS_GELU_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Kind = Kind;
+    WorkBlock.Input = Input;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.BiasLength = BiasLength;
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasGeluThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
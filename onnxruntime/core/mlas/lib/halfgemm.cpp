@@ -0,0 +1,544 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a matrix B stored as half precision values (HALFGEMM).
+
+    Matrix B is packed once to half precision values using the panel layout
+    of MlasGemmPackB, which halves the memory used by the packed matrix B.
+    Each panel is widened back to single precision in slices of the default
+    K stride when it is used, so the products are computed and accumulated
+    by the SGEMM kernels in single precision.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a HALFGEMM operation on
+// worker threads.
+//
+
+struct MLAS_HALFGEMM_WORK_BLOCK {
+    size_t K;
+    size_t lda;
+    size_t ldc;
+    float alpha;
+    float beta;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const float* A;
+        const unsigned short* B;
+        float* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+void
+MlasHalfGemmComputeBlock(
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const unsigned short* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies all rows of matrix A with a half precision packed
+    panel of matrix B and accumulates the result to a block of matrix C.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and the block
+        of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of the packed panel.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first element of matrix A to use.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output block should be overwritten rather
+        than accumulated to.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Widen the packed panel to single precision in slices of the default K
+    // stride so that the local panel stays the size used by SGEMM. Each
+    // block of 16 columns of the packed panel stores its CountK rows
+    // contiguously, so the rows of a slice are converted in one call.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float PanelFloat[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    const size_t BlockCount = (CountN + 15) / 16;
+
+    size_t CountKThisSlice;
+
+    for (size_t k = 0; k < CountK; k += CountKThisSlice) {
+
+        CountKThisSlice = MLAS_SGEMM_STRIDEK;
+
+        if (CountKThisSlice > (CountK - k)) {
+            CountKThisSlice = CountK - k;
+        }
+
+        for (size_t block = 0; block < BlockCount; block++) {
+            MlasConvertHalfToFloatBuffer(PanelB + block * CountK * 16 + k * 16,
+                PanelFloat + block * CountKThisSlice * 16, CountKThisSlice * 16);
+        }
+
+        MlasSgemmComputeBlock(CblasNoTrans, M, CountN, CountKThisSlice, alpha,
+            A + k, lda, PanelFloat, C, ldc, ZeroMode && k == 0);
+    }
+}
+
+void
+MlasHalfGemmOperation(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const unsigned short* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the HALFGEMM operation on a single thread.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B, offset to the first
+        column to use. The column must be a multiple of the packed N stride.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. All
+        // preceding panels are full, so the offset of the panel is n * K.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const unsigned short* PanelB = PackedB + n * K + k * AlignedCountN;
+
+            MlasHalfGemmComputeBlock(M, CountN, CountK, alpha, A + k, lda, PanelB, C + n, ldc, ZeroMode);
+        }
+    }
+}
+
+void
+MlasHalfGemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    HALFGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_HALFGEMM_WORK_BLOCK* WorkBlock = (MLAS_HALFGEMM_WORK_BLOCK*)Context;
+
+    MLAS_HALFGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasHalfGemmOperation(Segment->M, Segment->N, WorkBlock->K, WorkBlock->alpha,
+        Segment->A, WorkBlock->lda, Segment->B, WorkBlock->beta, Segment->C,
+        WorkBlock->ldc);
+}
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasHalfGemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    //
+    // Every panel is padded to a multiple of 16 columns. Only the last panel
+    // can be narrower than the packed N stride, so the padding is applied
+    // once.
+    //
+
+    size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(unsigned short);
+}
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine converts matrix B to half precision values using round to
+    nearest even and packs the values into the panel layout used by
+    MlasHalfGemm.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasHalfGemmPackBSize bytes and aligned to
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Pack each slice to single precision in slices of the default K stride
+    // and narrow the blocks of 16 columns to their rows of the packed slice.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float PanelFloat[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    unsigned short* D = (unsigned short*)PackedB;
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        const size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+        const size_t BlockCount = AlignedCountN / 16;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            size_t CountKThisSlice;
+
+            for (size_t kk = 0; kk < CountK; kk += CountKThisSlice) {
+
+                CountKThisSlice = MLAS_SGEMM_STRIDEK;
+
+                if (CountKThisSlice > (CountK - kk)) {
+                    CountKThisSlice = CountK - kk;
+                }
+
+                if (TransB == CblasNoTrans) {
+                    MlasSgemmCopyPackB(PanelFloat, B + n + (k + kk) * ldb, ldb, CountN, CountKThisSlice);
+                } else {
+                    MlasSgemmTransposePackB(PanelFloat, B + (k + kk) + n * ldb, ldb, CountN, CountKThisSlice);
+                }
+
+                for (size_t block = 0; block < BlockCount; block++) {
+                    MlasConvertFloatToHalfBuffer(PanelFloat + block * CountKThisSlice * 16,
+                        D + block * CountK * 16 + kk * 16, CountKThisSlice * 16);
+                }
+            }
+
+            D += AlignedCountN * CountK;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasHalfGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B that was packed as half precision
+    values by MlasHalfGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of matrix B packed by MlasHalfGemmPackB
+        with the same N and K.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const unsigned short* B = (const unsigned short*)PackedB;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    int32_t TargetThreadCount;
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasHalfGemmOperation(M, N, K, alpha, A, lda, B, beta, C, ldc);
+        return;
+    }
+
+    MLAS_HALFGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        //
+        // The packed matrix B can only be split at the start of a packed
+        // panel.
+        //
+
+        StrideN = (StrideN + MLAS_SGEMM_PACKED_STRIDEN - 1) & ~size_t(MLAS_SGEMM_PACKED_STRIDEN - 1);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].B = B + n * K;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * lda;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasHalfGemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+}
@@ -0,0 +1,245 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute the layer normalization of a
+    row of elements, optionally preceded by the residual (skip) and bias
+    additions used by transformer models.
+
+    The mean and variance are accumulated in a single pass over the row. The
+    values are shifted by the first element of the row before accumulating the
+    sum and the sum of squares, which avoids the loss of precision of the
+    textbook formula when the mean is large relative to the deviation. The
+    normalization is then applied in a second pass over the row, which is read
+    back from the cache.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+void
+MLASCALL
+MlasComputeLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of a row of elements:
+
+        X = Input + Skip + Bias
+        Output = (X - mean(X)) / sqrt(variance(X) + Epsilon) * Gamma + Beta
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the residual row added to the input row.
+
+    Bias - Optionally supplies the bias row added to the input row.
+
+    Gamma - Supplies the scale row.
+
+    Beta - Optionally supplies the bias row added to the normalized row.
+
+    Output - Supplies the output row. The output row may be the same as the
+        input row.
+
+    N - Supplies the number of elements of the row.
+
+    Epsilon - Supplies the value added to the variance to avoid dividing by
+        zero.
+
+    Mean - Optionally receives the mean of the row.
+
+    InvStdDev - Optionally receives the inverse of the standard deviation of
+        the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0) {
+        return;
+    }
+
+    //
+    // The sum of the input rows is stored to the output row so that the second
+    // pass only reads a single row.
+    //
+
+    const bool StoreSum = (Skip != nullptr || Bias != nullptr);
+
+    float Shift = Input[0];
+
+    if (Skip != nullptr) {
+        Shift += Skip[0];
+    }
+
+    if (Bias != nullptr) {
+        Shift += Bias[0];
+    }
+
+    //
+    // Accumulate the sum and the sum of squares of the shifted row.
+    //
+
+    MLAS_FLOAT32X4 ShiftBroadcast = MlasBroadcastFloat32x4(Shift);
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector1 = MlasZeroFloat32x4();
+
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLoadFloat32x4(Input + i);
+        MLAS_FLOAT32X4 Value1 = MlasLoadFloat32x4(Input + i + 4);
+
+        if (Skip != nullptr) {
+            Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Skip + i));
+            Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(Skip + i + 4));
+        }
+
+        if (Bias != nullptr) {
+            Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Bias + i));
+            Value1 = MlasAddFloat32x4(Value1, MlasLoadFloat32x4(Bias + i + 4));
+        }
+
+        if (StoreSum) {
+            MlasStoreFloat32x4(Output + i, Value0);
+            MlasStoreFloat32x4(Output + i + 4, Value1);
+        }
+
+        Value0 = MlasSubtractFloat32x4(Value0, ShiftBroadcast);
+        Value1 = MlasSubtractFloat32x4(Value1, ShiftBroadcast);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Value0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Value1);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquaresVector0);
+        SumSquaresVector1 = MlasMultiplyAddFloat32x4(Value1, Value1, SumSquaresVector1);
+    }
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLoadFloat32x4(Input + i);
+
+        if (Skip != nullptr) {
+            Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Skip + i));
+        }
+
+        if (Bias != nullptr) {
+            Value0 = MlasAddFloat32x4(Value0, MlasLoadFloat32x4(Bias + i));
+        }
+
+        if (StoreSum) {
+            MlasStoreFloat32x4(Output + i, Value0);
+        }
+
+        Value0 = MlasSubtractFloat32x4(Value0, ShiftBroadcast);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Value0);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquaresVector0);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+    for (; i < N; i++) {
+
+        float Value = Input[i];
+
+        if (Skip != nullptr) {
+            Value += Skip[i];
+        }
+
+        if (Bias != nullptr) {
+            Value += Bias[i];
+        }
+
+        if (StoreSum) {
+            Output[i] = Value;
+        }
+
+        Value -= Shift;
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    //
+    // Compute the statistics of the row.
+    //
+
+    const float ShiftedMean = Sum / float(N);
+    const float Variance = (std::max)(SumSquares / float(N) - ShiftedMean * ShiftedMean, 0.0f);
+    const float MeanValue = Shift + ShiftedMean;
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row.
+    //
+
+    const float* Source = StoreSum ? Output : Input;
+
+    MLAS_FLOAT32X4 MeanBroadcast = MlasBroadcastFloat32x4(MeanValue);
+    MLAS_FLOAT32X4 InvStdDevBroadcast = MlasBroadcastFloat32x4(InvStdDevValue);
+
+    i = 0;
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Source + i);
+
+        Value = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(Value, MeanBroadcast), InvStdDevBroadcast);
+        Value = MlasMultiplyFloat32x4(Value, MlasLoadFloat32x4(Gamma + i));
+
+        if (Beta != nullptr) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Beta + i));
+        }
+
+        MlasStoreFloat32x4(Output + i, Value);
+    }
+
+    for (; i < N; i++) {
+
+        float Value = (Source[i] - MeanValue) * InvStdDevValue * Gamma[i];
+
+        if (Beta != nullptr) {
+            Value += Beta[i];
+        }
+
+        Output[i] = Value;
+    }
+}
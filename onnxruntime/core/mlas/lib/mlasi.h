@@ -21,6 +21,7 @@ Abstract:
 #include <memory.h>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -120,6 +121,15 @@ Abstract:
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
+//
+// Define the strides used to pack matrix B with MlasGemmPackB. The packed
+// panels don't come from a local buffer, so the K stride can be larger than
+// the default stride.
+//
+
+#define MLAS_SGEMM_PACKED_STRIDEN                   128
+#define MLAS_SGEMM_PACKED_STRIDEK                   256
+
 //
 // Define the alignment for segmenting a GEMM operation across multiple
 // threads.
@@ -334,6 +344,109 @@ size_t
 
 typedef MLAS_GEMM_U8U8_KERNEL* PMLAS_GEMM_U8U8_KERNEL;
 
+typedef
+size_t
+(MLASCALL MLAS_GEMM_U8X8_KERNEL_NEON)(
+    const uint8_t* A,
+    const uint8_t* B,
+    int32_t* C,
+    size_t QuadCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumVector,
+    const int32_t* ColumnSumVector,
+    int32_t DepthValue,
+    bool ZeroMode
+    );
+
+typedef MLAS_GEMM_U8X8_KERNEL_NEON* PMLAS_GEMM_U8X8_KERNEL_NEON;
+
+typedef
+size_t
+(MLASCALL MLAS_BF16GEMM_KERNEL)(
+    const float* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    );
+
+typedef MLAS_BF16GEMM_KERNEL* PMLAS_BF16GEMM_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_QUANTIZE_LINEAR_U8_KERNEL)(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+typedef MLAS_QUANTIZE_LINEAR_U8_KERNEL* PMLAS_QUANTIZE_LINEAR_U8_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_QUANTIZE_LINEAR_S8_KERNEL)(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
+typedef MLAS_QUANTIZE_LINEAR_S8_KERNEL* PMLAS_QUANTIZE_LINEAR_S8_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_DEQUANTIZE_LINEAR_U8_KERNEL)(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+typedef MLAS_DEQUANTIZE_LINEAR_U8_KERNEL* PMLAS_DEQUANTIZE_LINEAR_U8_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_DEQUANTIZE_LINEAR_S8_KERNEL)(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
+typedef MLAS_DEQUANTIZE_LINEAR_S8_KERNEL* PMLAS_DEQUANTIZE_LINEAR_S8_KERNEL;
+
 typedef
 void
 (MLASCALL MLAS_GEMM_X8X8_OPERATION)(
@@ -505,6 +618,42 @@ extern "C" {
 #endif
 #endif
 
+#if defined(MLAS_TARGET_ARM64)
+    MLAS_GEMM_U8X8_KERNEL_NEON MlasGemmU8X8KernelNeon;
+#if !defined(MLAS_ARM64_DOTPROD_UNSUPPORTED)
+    MLAS_GEMM_U8X8_KERNEL_NEON MlasGemmU8X8KernelUdot;
+#endif
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_BF16GEMM_KERNEL MlasBf16GemmKernelAvx512BF16;
+#endif
+
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernel;
+#if defined(MLAS_TARGET_AMD64)
+#if defined(_WIN32)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelSse;
+#endif
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
+#endif
+
+    MLAS_QUANTIZE_LINEAR_U8_KERNEL MlasQuantizeLinearU8Kernel;
+    MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8Kernel;
+    MLAS_DEQUANTIZE_LINEAR_U8_KERNEL MlasDequantizeLinearU8Kernel;
+    MLAS_DEQUANTIZE_LINEAR_S8_KERNEL MlasDequantizeLinearS8Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_QUANTIZE_LINEAR_U8_KERNEL MlasQuantizeLinearU8KernelAvx2;
+    MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8KernelAvx2;
+    MLAS_DEQUANTIZE_LINEAR_U8_KERNEL MlasDequantizeLinearU8KernelAvx2;
+    MLAS_DEQUANTIZE_LINEAR_S8_KERNEL MlasDequantizeLinearS8KernelAvx2;
+    MLAS_QUANTIZE_LINEAR_U8_KERNEL MlasQuantizeLinearU8KernelAvx512F;
+    MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8KernelAvx512F;
+    MLAS_DEQUANTIZE_LINEAR_U8_KERNEL MlasDequantizeLinearU8KernelAvx512F;
+    MLAS_DEQUANTIZE_LINEAR_S8_KERNEL MlasDequantizeLinearS8KernelAvx512F;
+#endif
+
 #if defined(MLAS_TARGET_AMD64)
     MLAS_CONV_FLOAT_KERNEL MlasConvNchwFloatKernelSse;
     MLAS_CONV_FLOAT_KERNEL MlasConvNchwcFloatKernelSse;
@@ -596,7 +745,57 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0,
+    uint32_t StrideN = 0,
+    uint32_t StrideK = 0
+    );
+
+void
+MlasSgemmMultiplyBeta(
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    float beta
+    );
+
+void
+MlasSgemmCopyPackB(
+    float* D,
+    const float* B,
+    size_t ldb,
+    size_t CountX,
+    size_t CountY
+    );
+
+void
+MlasSgemmTransposePackB(
+    float* D,
+    const float* B,
+    size_t ldb,
+    size_t CountY,
+    size_t CountX
+    );
+
+void
+MlasSgemmComputeBlock(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0
     );
 
 //
@@ -617,12 +816,23 @@ struct MLAS_PLATFORM {
     PMLAS_GEMM_U8U8_KERNEL GemmU8U8Kernel;
 #endif
 
+#if defined(MLAS_TARGET_ARM64)
+    PMLAS_GEMM_U8X8_KERNEL_NEON GemmU8X8Kernel;
+#endif
+
 #if defined(MLAS_TARGET_AMD64)
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1Routine;
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1TransposeBRoutine;
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
     PMLAS_GEMM_DOUBLE_KERNEL GemmDoubleKernel;
     PMLAS_GEMV_U8S8_KERNEL GemvU8S8Kernel;
+    PMLAS_BF16GEMM_KERNEL Bf16GemmKernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertHalfToFloatKernel;
+    PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL ConvertFloatToHalfKernel;
+    PMLAS_QUANTIZE_LINEAR_U8_KERNEL QuantizeLinearU8Kernel;
+    PMLAS_QUANTIZE_LINEAR_S8_KERNEL QuantizeLinearS8Kernel;
+    PMLAS_DEQUANTIZE_LINEAR_U8_KERNEL DequantizeLinearU8Kernel;
+    PMLAS_DEQUANTIZE_LINEAR_S8_KERNEL DequantizeLinearS8Kernel;
     PMLAS_CONV_FLOAT_KERNEL ConvNchwFloatKernel;
     PMLAS_CONV_FLOAT_KERNEL ConvNchwcFloatKernel;
     PMLAS_CONV_DEPTHWISE_FLOAT_KERNEL ConvDepthwiseFloatKernel;
@@ -937,6 +1147,23 @@ MlasDivideFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+inline
+MLAS_FLOAT32X4
+MlasSqrtFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vsqrtq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 0)), Vector, 0);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 1)), Vector, 1);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 2)), Vector, 2);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 3)), Vector, 3);
+    return Vector;
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_sqrt_ps(Vector);
+#endif
+}
+
 inline
 MLAS_FLOAT32X4
 MlasMaximumFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
@@ -1014,6 +1241,54 @@ MlasXorFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+inline
+float
+MlasReduceAddFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vaddvq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vadd_f32(vget_low_f32(Vector), vget_high_f32(Vector));
+    return vget_lane_f32(vpadd_f32(VectorLow, VectorLow), 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_add_ps(Vector, _mm_movehl_ps(Vector, Vector));
+    Vector = _mm_add_ss(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
+inline
+float
+MlasReduceMaximumFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vmaxvq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vmax_f32(vget_low_f32(Vector), vget_high_f32(Vector));
+    return vget_lane_f32(vpmax_f32(VectorLow, VectorLow), 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_max_ps(Vector, _mm_movehl_ps(Vector, Vector));
+    Vector = _mm_max_ss(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
+inline
+float
+MlasReduceMinimumFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vminvq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vmin_f32(vget_low_f32(Vector), vget_high_f32(Vector));
+    return vget_lane_f32(vpmin_f32(VectorLow, VectorLow), 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_min_ps(Vector, _mm_movehl_ps(Vector, Vector));
+    Vector = _mm_min_ss(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
 // calc 2^int(N)
 inline
 MLAS_FLOAT32X4
@@ -1039,6 +1314,62 @@ MlasBroadcastInt32x4(int32_t Value)
 #endif
 }
 
+inline
+MLAS_INT32X4
+MlasSubtractInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vsubq_s32(Vector1, Vector2);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_sub_epi32(Vector1, Vector2);
+#endif
+}
+
+template<unsigned ShiftCount>
+inline
+MLAS_INT32X4
+MlasShiftRightInt32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(Vector), ShiftCount));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_srli_epi32(Vector, ShiftCount);
+#endif
+}
+
+inline
+MLAS_INT32X4
+MlasReinterpretAsInt32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_f32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castps_si128(Vector);
+#endif
+}
+
+inline
+MLAS_FLOAT32X4
+MlasReinterpretAsFloat32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_s32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castsi128_ps(Vector);
+#endif
+}
+
+inline
+MLAS_FLOAT32X4
+MlasConvertToFloat32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vcvtq_f32_s32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cvtepi32_ps(Vector);
+#endif
+}
+
 //
 // Cross-platform wrappers for 64-bit vector intrinsics.
 //
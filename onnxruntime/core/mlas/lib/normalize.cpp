@@ -0,0 +1,352 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    normalize.cpp
+
+Abstract:
+
+    This module implements routines for the batch, instance and local
+    response normalization of a channel of elements.
+
+    Batch and instance normalization reduce to a scale and shift of each
+    channel once the statistics of the channel are known. The statistics of a
+    channel are accumulated in a single pass, with the values shifted by the
+    first element of the channel as done for layer normalization.
+
+    Local response normalization keeps the sum of the squares of a window of
+    channels for a block of columns, which slides across the channels by
+    adding the square of the entering channel and subtracting the square of
+    the leaving channel.
+
+--*/
+
+#include "mlasi.h"
+
+#include <algorithm>
+#include <cmath>
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    float Shift
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output = Input * Scale + Shift.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the value to multiply each element by.
+
+    Shift - Supplies the value to add to each scaled element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScaleBroadcast = MlasBroadcastFloat32x4(Scale);
+    MLAS_FLOAT32X4 ShiftBroadcast = MlasBroadcastFloat32x4(Shift);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Value1 = MlasLoadFloat32x4(Input + 4);
+
+        MlasStoreFloat32x4(Output, MlasMultiplyAddFloat32x4(Value0, ScaleBroadcast, ShiftBroadcast));
+        MlasStoreFloat32x4(Output + 4, MlasMultiplyAddFloat32x4(Value1, ScaleBroadcast, ShiftBroadcast));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Input), ScaleBroadcast, ShiftBroadcast));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = *Input++ * Scale + Shift;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeMeanAndInvStdDev(
+    const float* Input,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the inverse of the standard deviation
+    of a buffer of elements in a single pass.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements of the buffer.
+
+    Epsilon - Supplies the value added to the variance to avoid dividing by
+        zero.
+
+    Mean - Receives the mean of the buffer.
+
+    InvStdDev - Receives the inverse of the standard deviation of the buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0) {
+        *Mean = 0.0f;
+        *InvStdDev = 1.0f / std::sqrt(Epsilon);
+        return;
+    }
+
+    const float Shift = Input[0];
+
+    MLAS_FLOAT32X4 ShiftBroadcast = MlasBroadcastFloat32x4(Shift);
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector1 = MlasZeroFloat32x4();
+
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + i), ShiftBroadcast);
+        MLAS_FLOAT32X4 Value1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + i + 4), ShiftBroadcast);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Value0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Value1);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquaresVector0);
+        SumSquaresVector1 = MlasMultiplyAddFloat32x4(Value1, Value1, SumSquaresVector1);
+    }
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Value0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + i), ShiftBroadcast);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Value0);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquaresVector0);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+    for (; i < N; i++) {
+
+        float Value = Input[i] - Shift;
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    const float ShiftedMean = Sum / float(N);
+    const float Variance = (std::max)(SumSquares / float(N) - ShiftedMean * ShiftedMean, 0.0f);
+
+    *Mean = Shift + ShiftedMean;
+    *InvStdDev = 1.0f / std::sqrt(Variance + Epsilon);
+}
+
+MLAS_FORCEINLINE
+void
+MlasAccumulateSquares(
+    const float* Input,
+    float* Sum,
+    size_t N,
+    float Alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Sum += Input * Input * Alpha.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Sum - Supplies the buffer of the sums to update.
+
+    N - Supplies the number of elements to process.
+
+    Alpha - Supplies the value to multiply each square by.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(Alpha);
+
+    size_t i = 0;
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Input + i);
+
+        Value = MlasMultiplyFloat32x4(Value, AlphaBroadcast);
+        MlasStoreFloat32x4(Sum + i, MlasMultiplyAddFloat32x4(Value, MlasLoadFloat32x4(Input + i), MlasLoadFloat32x4(Sum + i)));
+    }
+
+    for (; i < N; i++) {
+        Sum[i] += Input[i] * Input[i] * Alpha;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLocalResponseNormalization(
+    const float* Input,
+    float* Output,
+    size_t Channels,
+    size_t ChannelStride,
+    size_t N,
+    size_t Size,
+    float Alpha,
+    float Beta,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the local response normalization across the
+    channels of a block of columns:
+
+        Output[c] = Input[c] / (Bias + Alpha / Size * sum(Input[j]^2)) ^ Beta
+
+    where j ranges over the channels from c - (Size - 1) / 2 to
+    c + Size / 2 that lie in [0, Channels).
+
+Arguments:
+
+    Input - Supplies the input buffer. Column i of channel c is stored at
+        Input[c * ChannelStride + i].
+
+    Output - Supplies the output buffer, with the same layout as the input
+        buffer. The output buffer must not be the same as the input buffer.
+
+    Channels - Supplies the number of channels.
+
+    ChannelStride - Supplies the number of elements between the columns of
+        adjacent channels.
+
+    N - Supplies the number of columns of each channel to process.
+
+    Size - Supplies the number of channels of the window.
+
+    Alpha - Supplies the scale of the sum of squares.
+
+    Beta - Supplies the exponent.
+
+    Bias - Supplies the value added to the scaled sum of squares.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = 256;
+
+    const size_t PrePad = (Size - 1) / 2;
+    const size_t PostPad = Size - 1 - PrePad;
+    const float AlphaOverSize = Alpha / float(Size);
+
+    float Sum[BlockSize];
+
+    for (size_t Column = 0; Column < N; Column += BlockSize) {
+
+        const size_t Count = (std::min)(BlockSize, N - Column);
+        const float* InputBlock = Input + Column;
+        float* OutputBlock = Output + Column;
+
+        //
+        // Start with the window of the first channel, which is clipped by the
+        // leading padding.
+        //
+
+        std::fill_n(Sum, Count, Bias);
+
+        for (size_t c = 0; c <= PostPad && c < Channels; c++) {
+            MlasAccumulateSquares(InputBlock + c * ChannelStride, Sum, Count, AlphaOverSize);
+        }
+
+        for (size_t c = 0; c < Channels; c++) {
+
+            std::copy_n(Sum, Count, OutputBlock + c * ChannelStride);
+
+            //
+            // Slide the window to the next channel.
+            //
+
+            if (c + PostPad + 1 < Channels) {
+                MlasAccumulateSquares(InputBlock + (c + PostPad + 1) * ChannelStride, Sum, Count, AlphaOverSize);
+            }
+
+            if (c >= PrePad) {
+                MlasAccumulateSquares(InputBlock + (c - PrePad) * ChannelStride, Sum, Count, -AlphaOverSize);
+            }
+        }
+
+        //
+        // Raise the scales to the power and multiply by the input.
+        //
+
+        for (size_t c = 0; c < Channels; c++) {
+
+            float* ScaleRow = OutputBlock + c * ChannelStride;
+            const float* InputRow = InputBlock + c * ChannelStride;
+
+            MlasComputePow(ScaleRow, -Beta, ScaleRow, Count);
+
+            size_t i = 0;
+
+            for (; i + 4 <= Count; i += 4) {
+                MlasStoreFloat32x4(ScaleRow + i, MlasMultiplyFloat32x4(MlasLoadFloat32x4(ScaleRow + i), MlasLoadFloat32x4(InputRow + i)));
+            }
+
+            for (; i < Count; i++) {
+                ScaleRow[i] *= InputRow[i];
+            }
+        }
+    }
+}
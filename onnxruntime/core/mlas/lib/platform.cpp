@@ -17,6 +17,14 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(MLAS_TARGET_ARM64) && defined(__linux__) && !defined(MLAS_ARM64_DOTPROD_UNSUPPORTED)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#if !defined(HWCAP_ASIMDDP)
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#endif
+
 //
 // Stores the platform information.
 //
@@ -108,6 +116,17 @@ Return Value:
 
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->GemmDoubleKernel = MlasGemmDoubleKernelSse;
+    this->Bf16GemmKernel = nullptr;
+#if defined(_WIN32)
+    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelSse;
+#else
+    this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernel;
+#endif
+    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernel;
+    this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8Kernel;
+    this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8Kernel;
+    this->DequantizeLinearU8Kernel = MlasDequantizeLinearU8Kernel;
+    this->DequantizeLinearS8Kernel = MlasDequantizeLinearS8Kernel;
     this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
     this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelSse;
@@ -160,6 +179,16 @@ Return Value:
             this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
             this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
 
+            //
+            // Check if the processor supports the F16C feature.
+            //
+
+            if ((Cpuid1[2] & 0x20000000) != 0) {
+
+                this->ConvertHalfToFloatKernel = MlasConvertHalfToFloatKernelF16C;
+                this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelF16C;
+            }
+
             //
             // Check if the processor supports AVX2/FMA3 features.
             //
@@ -190,6 +219,10 @@ Return Value:
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
                 this->ErfKernelRoutine = MlasErfKernelFma3;
+                this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx2;
+                this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx2;
+                this->DequantizeLinearU8Kernel = MlasDequantizeLinearU8KernelAvx2;
+                this->DequantizeLinearS8Kernel = MlasDequantizeLinearS8KernelAvx2;
 
 #if !defined(MLAS_AVX512F_UNSUPPORTED)
 
@@ -209,6 +242,10 @@ Return Value:
                     this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+                    this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
+                    this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
+                    this->DequantizeLinearU8Kernel = MlasDequantizeLinearU8KernelAvx512F;
+                    this->DequantizeLinearS8Kernel = MlasDequantizeLinearS8KernelAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
                     //
@@ -234,6 +271,26 @@ Return Value:
                         }
                     }
 #endif // MLAS_AVX512BW_UNSUPPORTED
+
+                    //
+                    // Check if the processor supports AVX512BF16.
+                    //
+#if !defined(MLAS_AVX512BF16_UNSUPPORTED)
+
+                    if (Cpuid7[0] >= 1) {
+
+                        unsigned Cpuid7_1[4];
+#if defined(_WIN32)
+                        __cpuidex((int*)Cpuid7_1, 7, 1);
+#else
+                        __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
+#endif
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->Bf16GemmKernel = MlasBf16GemmKernelAvx512BF16;
+                        }
+                    }
+#endif // MLAS_AVX512BF16_UNSUPPORTED
                 }
 #endif // MLAS_AVX512F_UNSUPPORTED
 
@@ -246,6 +303,24 @@ Return Value:
 
 #endif // MLAS_TARGET_AMD64_IX86
 
+#if defined(MLAS_TARGET_ARM64)
+
+    this->GemmU8X8Kernel = MlasGemmU8X8KernelNeon;
+
+#if defined(__linux__) && !defined(MLAS_ARM64_DOTPROD_UNSUPPORTED)
+
+    //
+    // Check if the processor supports the ARMv8.2 dot product instructions.
+    //
+
+    if ((getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0) {
+        this->GemmU8X8Kernel = MlasGemmU8X8KernelUdot;
+    }
+
+#endif
+
+#endif // MLAS_TARGET_ARM64
+
 }
 
 size_t
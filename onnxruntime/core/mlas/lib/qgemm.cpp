@@ -25,6 +25,13 @@ Abstract:
 #define MLAS_GEMM_X8X8_STRIDEN              256
 #define MLAS_GEMM_X8X8_STRIDEK              128
 
+//
+// Define the number of rows of the tiles that stage the accumulators when the
+// output is requantized.
+//
+
+#define MLAS_GEMM_X8X8_QUANTIZED_TILEM      48
+
 //
 // Define the parameters to execute segments of a QGEMM operation on worker
 // threads.
@@ -47,6 +54,9 @@ struct MLAS_GEMM_X8X8_WORK_BLOCK {
     size_t StrideN;
     int16_t offa;
     int16_t offb;
+    const uint8_t* ZeroPointB;
+    bool ZeroPointBIsSigned;
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage;
 };
 
 #ifdef MLAS_TARGET_AMD64_IX86
@@ -1402,23 +1412,54 @@ Return Value:
     }
 }
 
+#endif
+
+#if defined(MLAS_TARGET_ARM64)
+
+//
+// ARM64 implementation using NEON intrinsics.
+//
+// The kernels only multiply unsigned values. For the U8S8 operation, the
+// values of matrix B are converted to unsigned values by flipping the sign
+// bit while packing. This adds 128 to every element, which is compensated
+// by adding 128 to the zero point offset of matrix B.
+//
+
 void
-MlasGemmX8X8Threaded(
-    void* Context,
-    int32_t ThreadId
+MlasGemmU8X8CopyPackANeon(
+    uint8_t* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumVector,
+    int16_t offb
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    QGEMM operation.
+    This routine copies elements from the source matrix to the destination
+    packed buffer.
 
 Arguments:
 
-    Context - Supplies the pointer to the context for the threaded operation.
+    D - Supplies the address of the destination packed buffer.
 
-    ThreadId - Supplies the current index of the threaded operation.
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows of the source matrix to copy.
+
+    CountK - Supplies the number of columns of the source matrix to copy.
+
+    RowSumVector - Supplies the address of the buffer to receive the sums of
+        the elements from each of the rows. Each sum has also been multiplied
+        by the zero point offset.
+
+    offb - Supplies the zero point offset for the other source matrix of the
+        matrix multiplication.
 
 Return Value:
 
@@ -1426,78 +1467,95 @@ Return Value:
 
 --*/
 {
-    const auto* WorkBlock = (MLAS_GEMM_X8X8_WORK_BLOCK*)Context;
-
-    const int32_t ThreadCountM = WorkBlock->ThreadCountM;
-    const int32_t ThreadCountN = WorkBlock->ThreadCountN;
-
-    const int32_t ThreadIdM = ThreadId / ThreadCountN;
-    const int32_t ThreadIdN = ThreadId % ThreadCountN;
-
     //
-    // Partition the operation along the M dimension.
+    // Each row of the packed buffer is padded with zeroes to a multiple of 4
+    // columns, so that the kernel can consume the row in quads.
     //
 
-    size_t M = WorkBlock->M;
-    size_t m;
-    size_t CountM;
+    const size_t AlignedCountK = (CountK + 3) & ~size_t(3);
 
-    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &m, &CountM);
+    while (CountM-- > 0) {
 
-    //
-    // Partition the operation along the N dimension.
-    //
+        const uint8_t* a = A;
+        uint8_t* d = D;
+        size_t k = CountK;
 
-    size_t N = WorkBlock->N;
-    size_t n;
-    size_t CountN;
+        uint32x4_t RowSums = vdupq_n_u32(0);
 
-    const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
-        MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+        while (k >= 16) {
 
-    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &n, &CountN);
+            uint8x16_t Bytes = vld1q_u8(a);
+            RowSums = vpadalq_u16(RowSums, vpaddlq_u8(Bytes));
+            vst1q_u8(d, Bytes);
 
-    n *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
-    CountN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+            a += 16;
+            d += 16;
+            k -= 16;
+        }
 
-    if (CountN > N - n) {
-        CountN = N - n;
-    }
+        uint32_t RowSum = vaddvq_u32(RowSums);
 
-    //
-    // Dispatch the partitioned operation.
-    //
+        while (k > 0) {
 
-    const size_t lda = WorkBlock->lda;
-    const size_t ldb = WorkBlock->ldb;
-    const size_t ldc = WorkBlock->ldc;
+            RowSum += *a;
+            *d++ = *a++;
+            k -= 1;
+        }
 
-    const uint8_t* a = WorkBlock->A + m * lda;
-    const uint8_t* b = WorkBlock->B + n;
-    int32_t* c = WorkBlock->C + n + m * ldc;
+        for (k = CountK; k < AlignedCountK; k++) {
+            *d++ = 0;
+        }
 
-    WorkBlock->GemmX8X8Operation(CountM, CountN, WorkBlock->K, a, lda,
-        WorkBlock->offa, b, ldb, WorkBlock->offb, c, ldc);
+        *RowSumVector++ = int32_t(RowSum) * offb;
+
+        A += lda;
+        D += AlignedCountK;
+    }
 }
 
 void
-MlasGemmX8X8Schedule(
-    MLAS_GEMM_X8X8_WORK_BLOCK* WorkBlock,
-    MLAS_THREADPOOL* ThreadPool
+MlasGemmU8X8CopyPackBNeon(
+    uint8_t* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int32_t* ColumnSumVector,
+    int16_t offa,
+    bool BIsSigned
     )
 /*++
 
 Routine Description:
 
-    This module schedules the quantized integer matrix/matrix multiply
-    operation (QGEMM) across one or more threads.
+    This routine copies elements from the source matrix to the destination
+    packed buffer.
+
+    Columns of 16 elements from the source matrix are packed as a block. Each
+    quad of rows from the block is stored as four vectors, where each vector
+    holds the quad of values for four adjacent columns.
 
 Arguments:
 
-    WorkBlock - Supplies the structure containing the GEMM parameters.
+    D - Supplies the address of the destination packed buffer.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy.
+
+    CountK - Supplies the number of rows of the source matrix to copy.
+
+    ColumnSumVector - Supplies the address of the buffer to receive the sums of
+        the elements from each of the columns. Each sum has also been
+        multiplied by the zero point offset.
+
+    offa - Supplies the zero point offset for the other source matrix of the
+        matrix multiplication.
+
+    BIsSigned - Supplies true if the source matrix is signed, in which case
+        the sign bit of each element is flipped.
 
 Return Value:
 
@@ -1505,85 +1563,111 @@ Return Value:
 
 --*/
 {
-    const size_t M = WorkBlock->M;
-    const size_t N = WorkBlock->N;
-    const size_t K = WorkBlock->K;
+    const uint8x16_t BitFlipVector = vdupq_n_u8(BIsSigned ? 0x80 : 0);
+    const uint8x16_t ZeroVector = vdupq_n_u8(0);
+    const int32x4_t OffsetBroadcast = vdupq_n_s32(offa);
 
-    //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
-    //
+    while (CountN > 0) {
 
-    double Complexity = double(M) * double(N) * double(K);
+        const size_t CountNThisBlock = (CountN < 16) ? CountN : 16;
 
-    int32_t TargetThreadCount;
+        uint32x4_t ColumnSums[4];
 
-    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-    }
+        for (size_t i = 0; i < 4; i++) {
+            ColumnSums[i] = vdupq_n_u32(0);
+        }
 
-    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+        const uint8_t* b = B;
+        size_t k = CountK;
 
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+        while (k > 0) {
 
-    //
-    // Segment the operation across multiple threads.
-    //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
+            //
+            // Load the next quad of rows. Rows beyond the end of the source
+            // matrix are zero, which is also zero after the sign bit has been
+            // flipped.
+            //
 
-    if (N > M) {
+            uint8x16_t Rows[4];
 
-        const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+            for (size_t i = 0; i < 4; i++) {
 
-        if (size_t(TargetThreadCount) > BlockedN) {
-            TargetThreadCount = int32_t(BlockedN);
-        }
+                if (i < k) {
 
-        WorkBlock->ThreadCountM = 1;
-        WorkBlock->ThreadCountN = TargetThreadCount;
+                    if (CountNThisBlock == 16) {
+                        Rows[i] = vld1q_u8(b);
+                    } else {
+                        MLAS_DECLSPEC_ALIGN(uint8_t PaddedRow[16], 16) = { 0 };
+                        std::copy_n(b, CountNThisBlock, PaddedRow);
+                        Rows[i] = vld1q_u8(PaddedRow);
+                    }
 
-    } else {
+                    Rows[i] = veorq_u8(Rows[i], BitFlipVector);
+                    b += ldb;
 
-        if (size_t(TargetThreadCount) > M) {
-            TargetThreadCount = int32_t(M);
+                } else {
+                    Rows[i] = ZeroVector;
+                }
+            }
+
+            //
+            // Transpose the quad of rows so that each 32-bit element holds a
+            // quad of values from a single column.
+            //
+
+            uint16x8_t Pairs0 = vreinterpretq_u16_u8(vzip1q_u8(Rows[0], Rows[1]));
+            uint16x8_t Pairs1 = vreinterpretq_u16_u8(vzip2q_u8(Rows[0], Rows[1]));
+            uint16x8_t Pairs2 = vreinterpretq_u16_u8(vzip1q_u8(Rows[2], Rows[3]));
+            uint16x8_t Pairs3 = vreinterpretq_u16_u8(vzip2q_u8(Rows[2], Rows[3]));
+
+            uint8x16_t Quads[4];
+
+            Quads[0] = vreinterpretq_u8_u16(vzip1q_u16(Pairs0, Pairs2));
+            Quads[1] = vreinterpretq_u8_u16(vzip2q_u16(Pairs0, Pairs2));
+            Quads[2] = vreinterpretq_u8_u16(vzip1q_u16(Pairs1, Pairs3));
+            Quads[3] = vreinterpretq_u8_u16(vzip2q_u16(Pairs1, Pairs3));
+
+            for (size_t i = 0; i < 4; i++) {
+                ColumnSums[i] = vpadalq_u16(ColumnSums[i], vpaddlq_u8(Quads[i]));
+                vst1q_u8(&D[i * 16], Quads[i]);
+            }
+
+            D += 64;
+            k -= (k < 4) ? k : 4;
         }
 
-        WorkBlock->ThreadCountM = TargetThreadCount;
-        WorkBlock->ThreadCountN = 1;
-    }
+        for (size_t i = 0; i < 4; i++) {
+            vst1q_s32(&ColumnSumVector[i * 4],
+                vmulq_s32(vreinterpretq_s32_u32(ColumnSums[i]), OffsetBroadcast));
+        }
 
-    MlasExecuteThreaded(MlasGemmX8X8Threaded, WorkBlock, TargetThreadCount, ThreadPool);
+        ColumnSumVector += 16;
+        B += CountNThisBlock;
+        CountN -= CountNThisBlock;
+    }
 }
 
+template<bool BIsSigned>
 void
-MLASCALL
-MlasGemm(
+MlasGemmU8X8OperationNeon(
     size_t M,
     size_t N,
     size_t K,
     const uint8_t* A,
     size_t lda,
-    uint8_t offa,
-    const int8_t* B,
+    int16_t offa,
+    const uint8_t* B,
     size_t ldb,
-    int8_t offb,
+    int16_t offb,
     int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+    size_t ldc
     )
 /*++
 
 Routine Description:
 
     This module implements the quantized integer matrix/matrix multiply
-    operation (QGEMM).
+    operation (QGEMM) using the NEON kernels.
 
 Arguments:
 
@@ -1610,67 +1694,702 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
-
 Return Value:
 
     None.
 
 --*/
 {
-    MLAS_GEMM_X8X8_WORK_BLOCK WorkBlock;
+    MLAS_DECLSPEC_ALIGN(uint8_t PanelA[MLAS_GEMM_X8X8_STRIDEM * MLAS_GEMM_X8X8_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(uint8_t PanelB[MLAS_GEMM_X8X8_STRIDEN * MLAS_GEMM_X8X8_STRIDEK], 64);
+
+    MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_X8X8_STRIDEM], 16);
+    MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_X8X8_STRIDEN], 16);
+
+    size_t StrideM = MLAS_GEMM_X8X8_STRIDEM;
+    size_t StrideN = MLAS_GEMM_X8X8_STRIDEN;
+    size_t StrideK = MLAS_GEMM_X8X8_STRIDEK;
 
     //
-    // Capture the GEMM parameters to the work block.
+    // Compensate for the sign bit of matrix B being flipped while packing.
     //
 
-    WorkBlock.M = M;
-    WorkBlock.N = N;
-    WorkBlock.K = K;
-    WorkBlock.A = A;
-    WorkBlock.lda = lda;
-    WorkBlock.B = (const uint8_t*)B;
-    WorkBlock.ldb = ldb;
-    WorkBlock.C = C;
-    WorkBlock.ldc = ldc;
-    WorkBlock.offa = int16_t(offa);
-    WorkBlock.offb = int16_t(offb);
-    WorkBlock.GemmX8X8Operation = MlasGemmU8S8Operation;
+    if (BIsSigned) {
+        offb += 128;
+    }
 
     //
-    // Schedule the operation across a set of worker threads.
+    // Step through each slice of matrix B along the K dimension.
     //
 
-    MlasGemmX8X8Schedule(&WorkBlock, ThreadPool);
-}
+    size_t CountK;
 
-void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
-    const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
-    const uint8_t* B,
-    size_t ldb,
-    uint8_t offb,
-    int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
-    )
-/*++
+    for (size_t k = 0; k < K; k += CountK) {
 
-Routine Description:
+        CountK = StrideK;
 
-    This module implements the quantized integer matrix/matrix multiply
-    operation (QGEMM).
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
 
-Arguments:
+        //
+        // Step through each slice of matrix B along the N dimension.
+        //
 
-    M - Supplies the number of rows of matrix A and matrix C.
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            MlasGemmU8X8CopyPackBNeon(PanelB, B + n + k * ldb, ldb, CountN,
+                CountK, ColumnSumVector, -int16_t(offa), BIsSigned);
+
+            size_t CountM;
+
+            for (size_t m = 0; m < M; m += CountM) {
+
+                CountM = StrideM;
+
+                if (CountM > (M - m)) {
+                    CountM = M - m;
+                }
+
+                MlasGemmU8X8CopyPackANeon(PanelA, A + k + m * lda, lda, CountM,
+                    CountK, RowSumVector, -int16_t(offb));
+
+                uint8_t* pa = PanelA;
+                int32_t* c = C + n + m * ldc;
+
+                int32_t* RowSums = RowSumVector;
+
+                size_t RowsRemaining = CountM;
+                size_t RowsHandled;
+
+                size_t QuadCountK = (CountK + 3) / 4;
+
+                while (RowsRemaining > 0) {
+
+                    RowsHandled = MlasPlatform.GemmU8X8Kernel(pa, PanelB, c,
+                        QuadCountK, RowsRemaining, CountN, ldc, RowSums,
+                        ColumnSumVector, int32_t(CountK) * offa * offb, k == 0);
+
+                    RowsRemaining -= RowsHandled;
+                    c += ldc * RowsHandled;
+                    pa += 4 * QuadCountK * RowsHandled;
+                    RowSums += RowsHandled;
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasGemmU8S8Operation(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    int16_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    int16_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This module implements the U8S8 quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    See MlasGemmU8X8OperationNeon.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8OperationNeon<true>(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+}
+
+void
+MLASCALL
+MlasGemmU8U8Operation(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    int16_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    int16_t offb,
+    int32_t* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This module implements the U8U8 quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    See MlasGemmU8X8OperationNeon.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8OperationNeon<false>(M, N, K, A, lda, offa, B, ldb, offb, C, ldc);
+}
+
+#endif
+
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_ARM64)
+
+void
+MlasGemmX8X8OutputStage(
+    const MLAS_GEMM_X8X8_WORK_BLOCK* WorkBlock,
+    int32_t* C,
+    size_t ldc,
+    size_t StartM,
+    size_t CountM,
+    size_t StartN,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the per column zero points of matrix B and the output
+    stage to a block of matrix C produced by a worker thread.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    C - Supplies the address of the block of accumulators.
+
+    ldc - Supplies the first dimension of the block of accumulators.
+
+    StartM - Supplies the first row of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    StartN - Supplies the first column of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage = WorkBlock->OutputStage;
+
+    //
+    // Requantized values are converted to float in place before being
+    // quantized to the output matrix.
+    //
+
+    const bool QuantizeOutput = (OutputStage != nullptr && OutputStage->QuantizedOutput != nullptr);
+
+    float* Output = nullptr;
+    size_t ldOutput = 0;
+
+    if (OutputStage != nullptr) {
+
+        if (QuantizeOutput) {
+            Output = (float*)C;
+            ldOutput = ldc;
+        } else {
+            Output = OutputStage->Output + StartN + StartM * OutputStage->ldOutput;
+            ldOutput = OutputStage->ldOutput;
+        }
+    }
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        int32_t* c = C + m * ldc;
+
+        //
+        // The operation ran with a zero point of zero for matrix B, so the
+        // accumulators are missing the zero point of each column multiplied
+        // by the sum of the row of matrix A, minus the zero point of
+        // matrix A.
+        //
+
+        if (WorkBlock->ZeroPointB != nullptr) {
+
+            const uint8_t* a = WorkBlock->A + (StartM + m) * lda;
+            int32_t RowSum = 0;
+
+            for (size_t k = 0; k < K; k++) {
+                RowSum += int32_t(a[k]);
+            }
+
+            RowSum -= int32_t(K) * int32_t(WorkBlock->offa);
+
+            for (size_t n = 0; n < CountN; n++) {
+                int32_t ZeroPoint = WorkBlock->ZeroPointBIsSigned ?
+                    int32_t(int8_t(WorkBlock->ZeroPointB[StartN + n])) :
+                    int32_t(WorkBlock->ZeroPointB[StartN + n]);
+                c[n] -= ZeroPoint * RowSum;
+            }
+        }
+
+        //
+        // Convert the row to float. Each element is read before the output
+        // is written, so the output may alias matrix C.
+        //
+
+        if (OutputStage != nullptr) {
+
+            float* output = Output + m * ldOutput;
+            const float* Scale = OutputStage->Scale;
+            const float* Bias = OutputStage->Bias;
+            const int32_t RowBias = (OutputStage->RowBias != nullptr) ?
+                OutputStage->RowBias[StartM + m] : 0;
+
+            for (size_t n = 0; n < CountN; n++) {
+                float Value = float(c[n] + RowBias) * (OutputStage->PerColumnScale ? Scale[StartN + n] : Scale[0]);
+                if (Bias != nullptr) {
+                    Value += Bias[StartN + n];
+                }
+                output[n] = Value;
+            }
+        }
+    }
+
+    if (OutputStage == nullptr) {
+        return;
+    }
+
+    if (OutputStage->Activation != nullptr) {
+        MlasActivation(OutputStage->Activation, Output, nullptr, CountM, CountN, ldOutput);
+    }
+
+    if (QuantizeOutput) {
+
+        uint8_t* QuantizedOutput = OutputStage->QuantizedOutput + StartN +
+            StartM * OutputStage->ldOutput;
+
+        for (size_t m = 0; m < CountM; m++) {
+            MlasQuantizeLinear(Output + m * ldOutput, QuantizedOutput + m * OutputStage->ldOutput,
+                CountN, 1.0f, OutputStage->QuantizedZeroPoint);
+        }
+    }
+}
+
+void
+MlasGemmX8X8Threaded(
+    void* Context,
+    int32_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_GEMM_X8X8_WORK_BLOCK*)Context;
+
+    const int32_t ThreadCountM = WorkBlock->ThreadCountM;
+    const int32_t ThreadCountN = WorkBlock->ThreadCountN;
+
+    const int32_t ThreadIdM = ThreadId / ThreadCountN;
+    const int32_t ThreadIdN = ThreadId % ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t M = WorkBlock->M;
+    size_t m;
+    size_t CountM;
+
+    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &m, &CountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t N = WorkBlock->N;
+    size_t n;
+    size_t CountN;
+
+    const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &n, &CountN);
+
+    n *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+    CountN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+    if (CountN > N - n) {
+        CountN = N - n;
+    }
+
+    //
+    // Dispatch the partitioned operation.
+    //
+
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+
+    const uint8_t* a = WorkBlock->A + m * lda;
+    const uint8_t* b = WorkBlock->B + n;
+
+    //
+    // When the output is requantized or matrix C is not supplied, compute the
+    // block in tiles that are staged through a local buffer.
+    //
+
+    if (WorkBlock->OutputStage != nullptr &&
+        (WorkBlock->OutputStage->QuantizedOutput != nullptr || WorkBlock->C == nullptr)) {
+
+        MLAS_DECLSPEC_ALIGN(int32_t Tile[MLAS_GEMM_X8X8_QUANTIZED_TILEM * MLAS_GEMM_X8X8_STRIDEN], 64);
+
+        size_t TileCountN;
+
+        for (size_t nn = 0; nn < CountN; nn += TileCountN) {
+
+            TileCountN = MLAS_GEMM_X8X8_STRIDEN;
+
+            if (TileCountN > (CountN - nn)) {
+                TileCountN = CountN - nn;
+            }
+
+            size_t TileCountM;
+
+            for (size_t mm = 0; mm < CountM; mm += TileCountM) {
+
+                TileCountM = MLAS_GEMM_X8X8_QUANTIZED_TILEM;
+
+                if (TileCountM > (CountM - mm)) {
+                    TileCountM = CountM - mm;
+                }
+
+                WorkBlock->GemmX8X8Operation(TileCountM, TileCountN, WorkBlock->K,
+                    a + mm * lda, lda, WorkBlock->offa, b + nn, ldb, WorkBlock->offb,
+                    Tile, TileCountN);
+
+                MlasGemmX8X8OutputStage(WorkBlock, Tile, TileCountN, m + mm,
+                    TileCountM, n + nn, TileCountN);
+            }
+        }
+
+        return;
+    }
+
+    int32_t* c = WorkBlock->C + n + m * ldc;
+
+    WorkBlock->GemmX8X8Operation(CountM, CountN, WorkBlock->K, a, lda,
+        WorkBlock->offa, b, ldb, WorkBlock->offb, c, ldc);
+
+    //
+    // Finish the block while it is still in the cache.
+    //
+
+    if (WorkBlock->ZeroPointB != nullptr || WorkBlock->OutputStage != nullptr) {
+        MlasGemmX8X8OutputStage(WorkBlock, c, ldc, m, CountM, n, CountN);
+    }
+}
+
+void
+MlasGemmX8X8Schedule(
+    MLAS_GEMM_X8X8_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module schedules the quantized integer matrix/matrix multiply
+    operation (QGEMM) across one or more threads.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock->ThreadCountM = 1;
+        WorkBlock->ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock->ThreadCountM = TargetThreadCount;
+        WorkBlock->ThreadCountN = 1;
+    }
+
+    MlasExecuteThreaded(MlasGemmX8X8Threaded, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C. When an output stage is supplied,
+        this is used for the int32 accumulators and may alias the output. It
+        is not referenced when the output stage requantizes the output, and
+        may be nullptr to stage the accumulators through a local buffer.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional parameters to convert matrix C to
+        float or to requantize it, else nullptr to leave the int32 result in
+        matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_X8X8_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block.
+    //
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = (const uint8_t*)B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = int16_t(offa);
+    WorkBlock.offb = int16_t(offb);
+    WorkBlock.ZeroPointB = nullptr;
+    WorkBlock.ZeroPointBIsSigned = false;
+    WorkBlock.OutputStage = OutputStage;
+    WorkBlock.GemmX8X8Operation = MlasGemmU8S8Operation;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasGemmX8X8Schedule(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
 
     N - Supplies the number of columns of matrix B and matrix C.
 
@@ -1700,6 +2419,74 @@ Return Value:
 
     None.
 
+--*/
+{
+    MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C. When an output stage is supplied,
+        this is used for the int32 accumulators and may alias the output. It
+        is not referenced when the output stage requantizes the output, and
+        may be nullptr to stage the accumulators through a local buffer.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional parameters to convert matrix C to
+        float or to requantize it, else nullptr to leave the int32 result in
+        matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
 --*/
 {
     MLAS_GEMM_X8X8_WORK_BLOCK WorkBlock;
@@ -1719,6 +2506,205 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.offa = int16_t(offa);
     WorkBlock.offb = int16_t(offb);
+    WorkBlock.ZeroPointB = nullptr;
+    WorkBlock.ZeroPointBIsSigned = false;
+    WorkBlock.OutputStage = OutputStage;
+    WorkBlock.GemmX8X8Operation = MlasGemmU8U8Operation;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasGemmX8X8Schedule(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    const int8_t* offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) with per column zero points for matrix B and an
+    optional output stage that converts the result to float.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offsets of matrix B, one per column, or
+        nullptr if the zero point of matrix B is zero.
+
+    C - Supplies the address of matrix C. When an output stage is supplied,
+        this is used for the int32 accumulators and may alias the output. It
+        is not referenced when the output stage requantizes the output, and
+        may be nullptr to stage the accumulators through a local buffer.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional parameters to convert matrix C to
+        float or to requantize it, else nullptr to leave the int32 result in
+        matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_X8X8_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block. The operation runs with
+    // a zero point of zero for matrix B and the per column zero points are
+    // applied by the output stage.
+    //
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = (const uint8_t*)B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = int16_t(offa);
+    WorkBlock.offb = 0;
+    WorkBlock.ZeroPointB = (const uint8_t*)offb;
+    WorkBlock.ZeroPointBIsSigned = true;
+    WorkBlock.OutputStage = OutputStage;
+    WorkBlock.GemmX8X8Operation = MlasGemmU8S8Operation;
+
+    //
+    // Schedule the operation across a set of worker threads.
+    //
+
+    MlasGemmX8X8Schedule(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    const uint8_t* offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) with per column zero points for matrix B and an
+    optional output stage that converts the result to float.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offsets of matrix B, one per column, or
+        nullptr if the zero point of matrix B is zero.
+
+    C - Supplies the address of matrix C. When an output stage is supplied,
+        this is used for the int32 accumulators and may alias the output. It
+        is not referenced when the output stage requantizes the output, and
+        may be nullptr to stage the accumulators through a local buffer.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional parameters to convert matrix C to
+        float or to requantize it, else nullptr to leave the int32 result in
+        matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_X8X8_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the GEMM parameters to the work block. The operation runs with
+    // a zero point of zero for matrix B and the per column zero points are
+    // applied by the output stage.
+    //
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = (const uint8_t*)B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = int16_t(offa);
+    WorkBlock.offb = 0;
+    WorkBlock.ZeroPointB = (const uint8_t*)offb;
+    WorkBlock.ZeroPointBIsSigned = false;
+    WorkBlock.OutputStage = OutputStage;
     WorkBlock.GemmX8X8Operation = MlasGemmU8U8Operation;
 
     //
@@ -0,0 +1,400 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qlbinary.cpp
+
+Abstract:
+
+    This module implements routines to add or multiply two quantized buffers
+    and requantize the result, as specified by the QLinearAdd and QLinearMul
+    operators:
+
+        C = Saturate(RoundToEven((ScaleA * (A - ZeroPointA) +
+                                  ScaleB * (B - ZeroPointB)) / ScaleC) + ZeroPointC)
+
+        C = Saturate(RoundToEven((ScaleA * (A - ZeroPointA) *
+                                  ScaleB * (B - ZeroPointB)) / ScaleC) + ZeroPointC)
+
+    The values are computed in single precision, so the quantized elements
+    are never expanded to a float buffer.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the element-wise operations applied to the values of A and B after
+// their zero points have been subtracted. The result is offset by the zero
+// point of C before it is rounded and saturated.
+//
+
+struct MLAS_QLINEAR_ADD_OPERATION {
+
+    MLAS_QLINEAR_ADD_OPERATION(
+        float ScaleA,
+        float ScaleB,
+        float ScaleC,
+        float ZeroPointC
+        ) :
+        ScaleRatioA(ScaleA / ScaleC),
+        ScaleRatioB(ScaleB / ScaleC),
+        ZeroPointC(ZeroPointC)
+    {
+    }
+
+    float
+    Compute(
+        float ValueA,
+        float ValueB
+        ) const
+    {
+        return ValueA * ScaleRatioA + ValueB * ScaleRatioB + ZeroPointC;
+    }
+
+#if defined(MLAS_NEON64_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+    MLAS_FLOAT32X4
+    Compute(
+        MLAS_FLOAT32X4 ValueA,
+        MLAS_FLOAT32X4 ValueB
+        ) const
+    {
+        MLAS_FLOAT32X4 Value = MlasMultiplyAddFloat32x4(ValueA, MlasBroadcastFloat32x4(ScaleRatioA),
+            MlasBroadcastFloat32x4(ZeroPointC));
+
+        return MlasMultiplyAddFloat32x4(ValueB, MlasBroadcastFloat32x4(ScaleRatioB), Value);
+    }
+#endif
+
+    float ScaleRatioA;
+    float ScaleRatioB;
+    float ZeroPointC;
+};
+
+struct MLAS_QLINEAR_MUL_OPERATION {
+
+    MLAS_QLINEAR_MUL_OPERATION(
+        float ScaleA,
+        float ScaleB,
+        float ScaleC,
+        float ZeroPointC
+        ) :
+        ScaleRatio(ScaleA * ScaleB / ScaleC),
+        ZeroPointC(ZeroPointC)
+    {
+    }
+
+    float
+    Compute(
+        float ValueA,
+        float ValueB
+        ) const
+    {
+        return ValueA * ValueB * ScaleRatio + ZeroPointC;
+    }
+
+#if defined(MLAS_NEON64_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+    MLAS_FLOAT32X4
+    Compute(
+        MLAS_FLOAT32X4 ValueA,
+        MLAS_FLOAT32X4 ValueB
+        ) const
+    {
+        return MlasMultiplyAddFloat32x4(MlasMultiplyFloat32x4(ValueA, ValueB),
+            MlasBroadcastFloat32x4(ScaleRatio), MlasBroadcastFloat32x4(ZeroPointC));
+    }
+#endif
+
+    float ScaleRatio;
+    float ZeroPointC;
+};
+
+#if defined(MLAS_NEON64_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+
+//
+// QLinear binary implementation using NEON or SSE2 intrinsics.
+//
+
+MLAS_FORCEINLINE
+void
+MlasQLinearLoadUint8x8(
+    const uint8_t* Input,
+    MLAS_FLOAT32X4 ZeroPointVector,
+    MLAS_FLOAT32X4& LowVector,
+    MLAS_FLOAT32X4& HighVector
+    )
+/*++
+
+Routine Description:
+
+    This routine loads 8 elements of a quantized buffer and subtracts the zero
+    point from their single precision values.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    uint16x8_t WordVector = vmovl_u8(vld1_u8(Input));
+    LowVector = vcvtq_f32_u32(vmovl_u16(vget_low_u16(WordVector)));
+    HighVector = vcvtq_f32_u32(vmovl_high_u16(WordVector));
+#else
+    const __m128i ZeroVector = _mm_setzero_si128();
+    __m128i WordVector = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)Input), ZeroVector);
+    LowVector = _mm_cvtepi32_ps(_mm_unpacklo_epi16(WordVector, ZeroVector));
+    HighVector = _mm_cvtepi32_ps(_mm_unpackhi_epi16(WordVector, ZeroVector));
+#endif
+
+    LowVector = MlasSubtractFloat32x4(LowVector, ZeroPointVector);
+    HighVector = MlasSubtractFloat32x4(HighVector, ZeroPointVector);
+}
+
+MLAS_FORCEINLINE
+void
+MlasQLinearStoreUint8x8(
+    uint8_t* Output,
+    MLAS_FLOAT32X4 LowVector,
+    MLAS_FLOAT32X4 HighVector
+    )
+/*++
+
+Routine Description:
+
+    This routine rounds 8 single precision values to the nearest even integer
+    and stores them saturated to uint8.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    int16x8_t WordVector = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(LowVector)),
+        vqmovn_s32(vcvtnq_s32_f32(HighVector)));
+    vst1_u8(Output, vqmovun_s16(WordVector));
+#else
+    // N.B. Assumes MXCSR has been configured with the default rounding mode of
+    // "round to nearest even".
+    __m128i WordVector = _mm_packs_epi32(_mm_cvtps_epi32(LowVector), _mm_cvtps_epi32(HighVector));
+    _mm_storel_epi64((__m128i*)Output, _mm_packus_epi16(WordVector, WordVector));
+#endif
+}
+
+template<typename OperationType>
+void
+MlasQLinearBinaryKernel(
+    const uint8_t* InputA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    uint8_t ZeroPointB,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB,
+    const OperationType& Operation
+    )
+{
+    const MLAS_FLOAT32X4 ZeroPointVectorA = MlasBroadcastFloat32x4(float(ZeroPointA));
+    const MLAS_FLOAT32X4 ZeroPointVectorB = MlasBroadcastFloat32x4(float(ZeroPointB));
+
+    MLAS_FLOAT32X4 LowVectorA, HighVectorA;
+    MLAS_FLOAT32X4 LowVectorB = MlasZeroFloat32x4();
+
+    if (IsScalarB) {
+        LowVectorB = MlasBroadcastFloat32x4(float(int32_t(*InputB) - int32_t(ZeroPointB)));
+    }
+
+    MLAS_FLOAT32X4 HighVectorB = LowVectorB;
+
+    while (N >= 8) {
+
+        MlasQLinearLoadUint8x8(InputA, ZeroPointVectorA, LowVectorA, HighVectorA);
+
+        if (!IsScalarB) {
+            MlasQLinearLoadUint8x8(InputB, ZeroPointVectorB, LowVectorB, HighVectorB);
+            InputB += 8;
+        }
+
+        MlasQLinearStoreUint8x8(OutputC, Operation.Compute(LowVectorA, LowVectorB),
+            Operation.Compute(HighVectorA, HighVectorB));
+
+        InputA += 8;
+        OutputC += 8;
+        N -= 8;
+    }
+
+    //
+    // Process the remaining elements through a local buffer of a full vector.
+    //
+
+    if (N > 0) {
+
+        uint8_t BufferA[8] = { 0 };
+        uint8_t BufferB[8] = { 0 };
+        uint8_t BufferC[8];
+
+        std::copy_n(InputA, N, BufferA);
+        MlasQLinearLoadUint8x8(BufferA, ZeroPointVectorA, LowVectorA, HighVectorA);
+
+        if (!IsScalarB) {
+            std::copy_n(InputB, N, BufferB);
+            MlasQLinearLoadUint8x8(BufferB, ZeroPointVectorB, LowVectorB, HighVectorB);
+        }
+
+        MlasQLinearStoreUint8x8(BufferC, Operation.Compute(LowVectorA, LowVectorB),
+            Operation.Compute(HighVectorA, HighVectorB));
+
+        std::copy_n(BufferC, N, OutputC);
+    }
+}
+
+#else
+
+//
+// QLinear binary implementation using the C++ runtime.
+//
+
+template<typename OperationType>
+void
+MlasQLinearBinaryKernel(
+    const uint8_t* InputA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    uint8_t ZeroPointB,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB,
+    const OperationType& Operation
+    )
+{
+    for (size_t n = 0; n < N; n++) {
+
+        const float ValueA = float(int32_t(InputA[n]) - int32_t(ZeroPointA));
+        const float ValueB = float(int32_t(InputB[IsScalarB ? 0 : n]) - int32_t(ZeroPointB));
+
+        float FloatValue = std::nearbyintf(Operation.Compute(ValueA, ValueB));
+        FloatValue = std::max(FloatValue, 0.0f);
+        FloatValue = std::min(FloatValue, 255.0f);
+        OutputC[n] = (uint8_t)(int32_t)FloatValue;
+    }
+}
+
+#endif
+
+void
+MLASCALL
+MlasQLinearAdd(
+    const uint8_t* InputA,
+    float ScaleA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    float ScaleB,
+    uint8_t ZeroPointB,
+    float ScaleC,
+    uint8_t ZeroPointC,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB
+    )
+/*++
+
+Routine Description:
+
+    This routine adds two quantized buffers and quantizes the sum with the
+    scale and zero point of the output buffer.
+
+Arguments:
+
+    InputA - Supplies the first input buffer.
+
+    ScaleA - Supplies the quantization scale of the first input buffer.
+
+    ZeroPointA - Supplies the quantization zero point of the first input
+        buffer.
+
+    InputB - Supplies the second input buffer.
+
+    ScaleB - Supplies the quantization scale of the second input buffer.
+
+    ZeroPointB - Supplies the quantization zero point of the second input
+        buffer.
+
+    ScaleC - Supplies the quantization scale of the output buffer.
+
+    ZeroPointC - Supplies the quantization zero point of the output buffer.
+
+    OutputC - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    IsScalarB - Supplies true if the second input buffer holds a single
+        element that is added to each element of the first input buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QLINEAR_ADD_OPERATION Operation(ScaleA, ScaleB, ScaleC, float(ZeroPointC));
+
+    MlasQLinearBinaryKernel(InputA, ZeroPointA, InputB, ZeroPointB, OutputC, N, IsScalarB, Operation);
+}
+
+void
+MLASCALL
+MlasQLinearMul(
+    const uint8_t* InputA,
+    float ScaleA,
+    uint8_t ZeroPointA,
+    const uint8_t* InputB,
+    float ScaleB,
+    uint8_t ZeroPointB,
+    float ScaleC,
+    uint8_t ZeroPointC,
+    uint8_t* OutputC,
+    size_t N,
+    bool IsScalarB
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies two quantized buffers and quantizes the product
+    with the scale and zero point of the output buffer.
+
+Arguments:
+
+    InputA - Supplies the first input buffer.
+
+    ScaleA - Supplies the quantization scale of the first input buffer.
+
+    ZeroPointA - Supplies the quantization zero point of the first input
+        buffer.
+
+    InputB - Supplies the second input buffer.
+
+    ScaleB - Supplies the quantization scale of the second input buffer.
+
+    ZeroPointB - Supplies the quantization zero point of the second input
+        buffer.
+
+    ScaleC - Supplies the quantization scale of the output buffer.
+
+    ZeroPointC - Supplies the quantization zero point of the output buffer.
+
+    OutputC - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    IsScalarB - Supplies true if the second input buffer holds a single
+        element that multiplies each element of the first input buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QLINEAR_MUL_OPERATION Operation(ScaleA, ScaleB, ScaleC, float(ZeroPointC));
+
+    MlasQLinearBinaryKernel(InputA, ZeroPointA, InputB, ZeroPointB, OutputC, N, IsScalarB, Operation);
+}
@@ -0,0 +1,172 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qlgavgpool.cpp
+
+Abstract:
+
+    This module implements routines to compute the global average pooling of
+    a quantized buffer and requantize the result, as specified by the
+    QLinearGlobalAveragePool operator:
+
+        Output = Saturate(RoundToEven(ScaleInput * (Mean(Input) - ZeroPointInput) /
+                                      ScaleOutput) + ZeroPointOutput)
+
+    The elements of each channel are summed as integers.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+uint64_t
+MlasQLinearReduceAddUint8(
+    const uint8_t* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the elements of a quantized buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the sum of the elements.
+
+--*/
+{
+    uint64_t Sum = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    if (N >= 16) {
+
+        //
+        // PSADBW sums the absolute differences of two groups of 8 bytes, so
+        // differences against zero sum each group into a 64-bit lane.
+        //
+
+        const __m128i ZeroVector = _mm_setzero_si128();
+        __m128i SumVector = _mm_setzero_si128();
+
+        while (N >= 16) {
+
+            __m128i InputVector = _mm_loadu_si128((const __m128i*)Input);
+            SumVector = _mm_add_epi64(SumVector, _mm_sad_epu8(InputVector, ZeroVector));
+
+            Input += 16;
+            N -= 16;
+        }
+
+        SumVector = _mm_add_epi64(SumVector, _mm_unpackhi_epi64(SumVector, SumVector));
+        uint64_t Lanes[2];
+        _mm_storeu_si128((__m128i*)Lanes, SumVector);
+        Sum = Lanes[0];
+    }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+    if (N >= 16) {
+
+        uint64x2_t SumVector = vdupq_n_u64(0);
+
+        while (N >= 16) {
+
+            uint16x8_t WordVector = vpaddlq_u8(vld1q_u8(Input));
+            SumVector = vpadalq_u32(SumVector, vpaddlq_u16(WordVector));
+
+            Input += 16;
+            N -= 16;
+        }
+
+        Sum = vaddvq_u64(SumVector);
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+        Sum += Input[n];
+    }
+
+    return Sum;
+}
+
+void
+MLASCALL
+MlasQLinearGlobalAveragePool(
+    const uint8_t* Input,
+    float ScaleInput,
+    uint8_t ZeroPointInput,
+    uint8_t* Output,
+    float ScaleOutput,
+    uint8_t ZeroPointOutput,
+    size_t Channels,
+    size_t ImageSize
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the average of each channel of a quantized buffer in
+    NCHW format and quantizes the averages with the scale and zero point of the
+    output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer, with ImageSize contiguous elements for
+        each channel.
+
+    ScaleInput - Supplies the quantization scale of the input buffer.
+
+    ZeroPointInput - Supplies the quantization zero point of the input buffer.
+
+    Output - Supplies the output buffer, with an element for each channel.
+
+    ScaleOutput - Supplies the quantization scale of the output buffer.
+
+    ZeroPointOutput - Supplies the quantization zero point of the output
+        buffer.
+
+    Channels - Supplies the number of channels, which is the product of the
+        batch and channel dimensions.
+
+    ImageSize - Supplies the number of elements of each channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (ImageSize == 0) {
+        std::fill_n(Output, Channels, ZeroPointOutput);
+        return;
+    }
+
+    const float ScaleRatio = ScaleInput / (ScaleOutput * float(ImageSize));
+    const int64_t ZeroPointSum = int64_t(ZeroPointInput) * int64_t(ImageSize);
+
+    for (size_t c = 0; c < Channels; c++) {
+
+        const int64_t Sum = int64_t(MlasQLinearReduceAddUint8(Input, ImageSize)) - ZeroPointSum;
+
+        float FloatValue = std::nearbyintf(float(Sum) * ScaleRatio) + float(ZeroPointOutput);
+        FloatValue = std::max(FloatValue, 0.0f);
+        FloatValue = std::min(FloatValue, 255.0f);
+        Output[c] = (uint8_t)(int32_t)FloatValue;
+
+        Input += ImageSize;
+    }
+}
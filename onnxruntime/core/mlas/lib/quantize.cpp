@@ -10,12 +10,20 @@ Module Name:
 
 Abstract:
 
-    This module implements routines to quantize buffers.
+    This module implements routines to quantize and dequantize buffers.
 
     For quantization formula as specified in the ONNX operator documentation is:
 
         Output = Saturate(RoundToEven(Input / Scale) + ZeroPoint)
 
+    The dequantization formula is:
+
+        Output = (Input - ZeroPoint) * Scale
+
+    On AMD64 the routines dispatch to the AVX2 or AVX512F kernels when the
+    processor supports them. The kernels below use the SSE2 or NEON
+    intrinsics, or the C++ runtime on other platforms.
+
 --*/
 
 #include "mlasi.h"
@@ -183,6 +191,94 @@ MlasQuantizeLinearKernel(
     }
 }
 
+template<typename InputType>
+MLAS_INT32X4
+MlasDequantizeLinearUnpackBytes(
+    const InputType* Input
+    );
+
+template<>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasDequantizeLinearUnpackBytes<uint8_t>(
+    const uint8_t* Input
+    )
+{
+    //
+    // Zero extend four bytes to the int32_t elements of the vector register.
+    //
+
+    uint32_t Bytes;
+    memcpy(&Bytes, Input, sizeof(Bytes));
+
+#if defined(MLAS_NEON64_INTRINSICS)
+    uint16x8_t WordVector = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(Bytes)));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(WordVector)));
+#else
+    const __m128i ZeroVector = _mm_setzero_si128();
+    __m128i ByteVector = _mm_cvtsi32_si128(int32_t(Bytes));
+    ByteVector = _mm_unpacklo_epi8(ByteVector, ZeroVector);
+    return _mm_unpacklo_epi16(ByteVector, ZeroVector);
+#endif
+}
+
+template<>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasDequantizeLinearUnpackBytes<int8_t>(
+    const int8_t* Input
+    )
+{
+    //
+    // Sign extend four bytes to the int32_t elements of the vector register.
+    //
+
+    uint32_t Bytes;
+    memcpy(&Bytes, Input, sizeof(Bytes));
+
+#if defined(MLAS_NEON64_INTRINSICS)
+    int16x8_t WordVector = vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(Bytes)));
+    return vmovl_s16(vget_low_s16(WordVector));
+#else
+    __m128i ByteVector = _mm_cvtsi32_si128(int32_t(Bytes));
+    ByteVector = _mm_unpacklo_epi8(ByteVector, ByteVector);
+    ByteVector = _mm_unpacklo_epi16(ByteVector, ByteVector);
+    return _mm_srai_epi32(ByteVector, 24);
+#endif
+}
+
+template<typename InputType>
+MLAS_FORCEINLINE
+void
+MlasDequantizeLinearKernel(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    auto ScaleVector = MlasBroadcastFloat32x4(Scale);
+    auto ZeroPointVector = MlasBroadcastInt32x4(ZeroPoint);
+
+    while (N >= 4) {
+
+        auto IntegerVector = MlasDequantizeLinearUnpackBytes<InputType>(Input);
+        IntegerVector = MlasSubtractInt32x4(IntegerVector, ZeroPointVector);
+
+        auto FloatVector = MlasMultiplyFloat32x4(MlasConvertToFloat32x4(IntegerVector), ScaleVector);
+        MlasStoreFloat32x4(Output, FloatVector);
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = float(int32_t(Input[n]) - ZeroPoint) * Scale;
+    }
+}
+
 #else
 
 //
@@ -209,8 +305,76 @@ MlasQuantizeLinearKernel(
     }
 }
 
+template<typename InputType>
+MLAS_FORCEINLINE
+void
+MlasDequantizeLinearKernel(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = float(int32_t(Input[n]) - ZeroPoint) * Scale;
+    }
+}
+
 #endif
 
+void
+MLASCALL
+MlasQuantizeLinearU8Kernel(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernel<uint8_t, 0, 255>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasQuantizeLinearS8Kernel(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernel<int8_t, -127, 127>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearU8Kernel(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernel<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearS8Kernel(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernel<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
 void
 MLASCALL
 MlasQuantizeLinear(
@@ -245,7 +409,11 @@ Return Value:
 
 --*/
 {
-    return MlasQuantizeLinearKernel<uint8_t, 0, 255>(Input, Output, N, Scale, ZeroPoint);
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.QuantizeLinearU8Kernel(Input, Output, N, Scale, ZeroPoint);
+#else
+    MlasQuantizeLinearU8Kernel(Input, Output, N, Scale, ZeroPoint);
+#endif
 }
 
 void
@@ -282,5 +450,164 @@ Return Value:
 
 --*/
 {
-    return MlasQuantizeLinearKernel<int8_t, -127, 127>(Input, Output, N, Scale, ZeroPoint);
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.QuantizeLinearS8Kernel(Input, Output, N, Scale, ZeroPoint);
+#else
+    MlasQuantizeLinearS8Kernel(Input, Output, N, Scale, ZeroPoint);
+#endif
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes the input buffer using the supplied quantization
+    parameters.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.DequantizeLinearU8Kernel(Input, Output, N, Scale, ZeroPoint);
+#else
+    MlasDequantizeLinearU8Kernel(Input, Output, N, Scale, ZeroPoint);
+#endif
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes the input buffer using the supplied quantization
+    parameters.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.DequantizeLinearS8Kernel(Input, Output, N, Scale, ZeroPoint);
+#else
+    MlasDequantizeLinearS8Kernel(Input, Output, N, Scale, ZeroPoint);
+#endif
+}
+
+void
+MLASCALL
+MlasFindMinMaxElement(
+    const float* Input,
+    float* Min,
+    float* Max,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the minimum and maximum values of the input buffer,
+    for example to compute the parameters to dynamically quantize it.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Min - Returns the minimum value of the buffer.
+
+    Max - Returns the maximum value of the buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None. If N is zero, Min returns the largest float value and Max returns
+    the lowest float value.
+
+--*/
+{
+    float Minimum = std::numeric_limits<float>::max();
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 8) {
+
+        MLAS_FLOAT32X4 MinimumVector0 = MlasBroadcastFloat32x4(Minimum);
+        MLAS_FLOAT32X4 MinimumVector1 = MinimumVector0;
+        MLAS_FLOAT32X4 MaximumVector0 = MlasBroadcastFloat32x4(Maximum);
+        MLAS_FLOAT32X4 MaximumVector1 = MaximumVector0;
+
+        while (N >= 8) {
+
+            MLAS_FLOAT32X4 InputVector0 = MlasLoadFloat32x4(Input);
+            MLAS_FLOAT32X4 InputVector1 = MlasLoadFloat32x4(Input + 4);
+
+            MinimumVector0 = MlasMinimumFloat32x4(MinimumVector0, InputVector0);
+            MinimumVector1 = MlasMinimumFloat32x4(MinimumVector1, InputVector1);
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, InputVector0);
+            MaximumVector1 = MlasMaximumFloat32x4(MaximumVector1, InputVector1);
+
+            Input += 8;
+            N -= 8;
+        }
+
+        Minimum = MlasReduceMinimumFloat32x4(MlasMinimumFloat32x4(MinimumVector0, MinimumVector1));
+        Maximum = MlasReduceMaximumFloat32x4(MlasMaximumFloat32x4(MaximumVector0, MaximumVector1));
+    }
+
+    while (N > 0) {
+
+        Minimum = (std::min)(Minimum, *Input);
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    *Min = Minimum;
+    *Max = Maximum;
 }
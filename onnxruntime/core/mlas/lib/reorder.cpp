@@ -267,6 +267,79 @@ Return Value:
     }
 }
 
+void
+MLASCALL
+MlasReorderInputNhwc(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an input buffer from NHWC to NCHWc format.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor in NHWC order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t InputSize = size_t(InputShape[1]) * size_t(InputShape[2]);
+    const size_t InputChannels = size_t(InputShape[3]);
+
+    //
+    // Each pixel of the source buffer stores the channels contiguously, so
+    // the channel blocks are copied directly to the planes of the destination
+    // buffer.
+    //
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const size_t InputChannelsThisIteration = (std::min)(InputChannels - c, BlockSize);
+            const size_t AlignedInputChannelsThisIteration = InputChannelsThisIteration & (~3);
+
+            const float* s = S + c;
+
+            for (size_t n = 0; n < InputSize; n++) {
+
+                size_t bc = 0;
+
+                for (; bc < AlignedInputChannelsThisIteration; bc += 4) {
+                    MlasStoreFloat32x4(&D[bc], MlasLoadFloat32x4(&s[bc]));
+                }
+
+                for (; bc < InputChannelsThisIteration; bc += 1) {
+                    D[bc] = s[bc];
+                }
+
+                for (; bc < BlockSize; bc += 1) {
+                    D[bc] = 0.0f;
+                }
+
+                s += InputChannels;
+                D += BlockSize;
+            }
+        }
+
+        S += InputSize * InputChannels;
+    }
+}
+
 void
 MLASCALL
 MlasReorderOutput(
@@ -365,6 +438,75 @@ Return Value:
     }
 }
 
+void
+MLASCALL
+MlasReorderOutputNhwc(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output buffer from NCHWc to NHWC format.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the output tensor in NHWC order.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(OutputShape[0]);
+    const size_t OutputSize = size_t(OutputShape[1]) * size_t(OutputShape[2]);
+    const size_t OutputChannels = size_t(OutputShape[3]);
+
+    //
+    // Copy the channel blocks from the planes of the source buffer to the
+    // contiguous channels of each pixel in the destination buffer. The
+    // padding channels of the source buffer are skipped.
+    //
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        for (size_t c = 0; c < OutputChannels; c += BlockSize) {
+
+            const size_t OutputChannelsThisIteration = (std::min)(OutputChannels - c, BlockSize);
+            const size_t AlignedOutputChannelsThisIteration = OutputChannelsThisIteration & (~3);
+
+            float* d = D + c;
+
+            for (size_t n = 0; n < OutputSize; n++) {
+
+                size_t bc = 0;
+
+                for (; bc < AlignedOutputChannelsThisIteration; bc += 4) {
+                    MlasStoreFloat32x4(&d[bc], MlasLoadFloat32x4(&S[bc]));
+                }
+
+                for (; bc < OutputChannelsThisIteration; bc += 1) {
+                    d[bc] = S[bc];
+                }
+
+                S += BlockSize;
+                d += OutputChannels;
+            }
+        }
+
+        D += OutputSize * OutputChannels;
+    }
+}
+
 void
 MLASCALL
 MlasReorderFilterOIHWBiBo(
@@ -16,6 +16,15 @@ Abstract:
 --*/
 
 #include "mlasi.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <tuple>
 
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
@@ -34,21 +43,67 @@ Abstract:
 struct MLAS_SGEMM_WORK_BLOCK {
     CBLAS_TRANSPOSE TransA;
     CBLAS_TRANSPOSE TransB;
+    bool BIsPacked;
     size_t K;
     size_t lda;
     size_t ldb;
     size_t ldc;
     float alpha;
     float beta;
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage;
+    uint32_t StrideN;
+    uint32_t StrideK;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartM;
+        size_t StartN;
         const float* A;
         const float* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads. Each operation is split into SegmentCount segments of SegmentStride
+// rows or columns, and each thread executes a range of the segments of the
+// whole batch.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    const float* const* A;
+    size_t lda;
+    const float* const* B;
+    size_t ldb;
+    float* const* C;
+    size_t ldc;
+    float alpha;
+    float beta;
+    size_t BatchN;
+    bool SplitN;
+    size_t SegmentCount;
+    size_t SegmentStride;
+    int32_t ThreadCount;
+};
+
+//
+// Define the block sizes and thread split of a SGEMM operation. A zero stride
+// or thread count selects the default heuristic for that parameter.
+//
+
+struct MLAS_SGEMM_TUNING {
+    uint32_t StrideN;
+    uint32_t StrideK;
+    int32_t ThreadCount;
+    bool SplitN;
+};
+
 void
 MlasSgemmMultiplyBeta(
     float* C,
@@ -762,6 +817,255 @@ Return Value:
     }
 }
 
+void
+MlasSgemmApplyOutputStage(
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t CountM,
+    size_t StartN,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the bias to a block of matrix C and applies the
+    activation.
+
+Arguments:
+
+    OutputStage - Supplies the bias and activation parameters.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StartM - Supplies the row of matrix C of the first row of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    StartN - Supplies the column of matrix C of the first column of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OutputStage->Bias != nullptr) {
+
+        const size_t BiasRowStride = OutputStage->BiasRowStride;
+        const size_t BiasColumnStride = OutputStage->BiasColumnStride;
+        const float BiasScale = OutputStage->BiasScale;
+        const float* Bias = OutputStage->Bias + StartM * BiasRowStride +
+            StartN * BiasColumnStride;
+
+        MLAS_FLOAT32X4 ScaleBroadcast = MlasBroadcastFloat32x4(BiasScale);
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            float* c = C + m * ldc;
+            const float* bias = Bias + m * BiasRowStride;
+            size_t n = CountN;
+
+            if (BiasColumnStride == 1) {
+
+                while (n >= 4) {
+
+                    MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(bias),
+                        ScaleBroadcast, MlasLoadFloat32x4(c));
+                    MlasStoreFloat32x4(c, Vector);
+
+                    c += 4;
+                    bias += 4;
+                    n -= 4;
+                }
+
+            } else if (BiasColumnStride == 0) {
+
+                MLAS_FLOAT32X4 BiasBroadcast = MlasBroadcastFloat32x4(*bias * BiasScale);
+
+                while (n >= 4) {
+
+                    MlasStoreFloat32x4(c, MlasAddFloat32x4(MlasLoadFloat32x4(c), BiasBroadcast));
+
+                    c += 4;
+                    n -= 4;
+                }
+            }
+
+            while (n > 0) {
+
+                *c++ += *bias * BiasScale;
+                bias += BiasColumnStride;
+                n -= 1;
+            }
+        }
+    }
+
+    if (OutputStage->Activation != nullptr) {
+        MlasActivation(OutputStage->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
+
+void
+MlasSgemmComputeBlock(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    size_t StartM,
+    size_t StartN
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies all rows of matrix A with a packed panel of matrix
+    B and accumulates the result to a block of matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and the block
+        of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of the packed panel.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first element of matrix A to use.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output block should be overwritten rather
+        than accumulated to.
+
+    OutputStage - Supplies the optional output stage to apply to the rows of
+        the block as they are computed, else nullptr if more slices of matrix
+        B along the K dimension remain to be accumulated.
+
+    StartM - Supplies the row of matrix C of the first row of the block.
+
+    StartN - Supplies the column of matrix C of the first column of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = MlasPlatform.GemmFloatKernel(A, PanelB, C, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(A, PanelB, C, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(A, PanelB, C, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            if (OutputStage != nullptr) {
+                MlasSgemmApplyOutputStage(OutputStage, C, ldc, StartM, RowsHandled, StartN, CountN);
+            }
+
+            StartM += RowsHandled;
+            C += ldc * RowsHandled;
+            A += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, A, lda, RowsTransposed, CountK);
+
+            A += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, C, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, C, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, C, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                if (OutputStage != nullptr) {
+                    MlasSgemmApplyOutputStage(OutputStage, C, ldc, StartM, RowsHandled, StartN, CountN);
+                }
+
+                StartM += RowsHandled;
+                C += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -776,7 +1080,12 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    size_t StartM,
+    size_t StartN,
+    uint32_t StrideN,
+    uint32_t StrideK
     )
 /*++
 
@@ -814,13 +1123,27 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputStage - Supplies the optional output stage to apply to matrix C.
+
+    StartM - Supplies the row of the full matrix C of the first row of this
+        matrix C, for the output stage.
+
+    StartN - Supplies the column of the full matrix C of the first column of
+        this matrix C, for the output stage.
+
+    StrideN - Supplies the number of columns of matrix B packed to the local
+        buffer at a time, else zero to compute it from the shape.
+
+    StrideK - Supplies the number of rows of matrix B packed to the local
+        buffer at a time, else zero to compute it from the shape. The product
+        of the strides must not exceed the size of the local buffer.
+
 Return Value:
 
     None.
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -843,6 +1166,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (OutputStage != nullptr) {
+                MlasSgemmApplyOutputStage(OutputStage, C, ldc, StartM, 1, StartN, N);
+            }
             return;
         }
 
@@ -858,21 +1184,24 @@ Return Value:
     // the A panel needs to be used for transposing.
     //
 
-    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
-    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+    if (StrideN == 0 || StrideK == 0) {
 
-    if (N >= K) {
+        StrideN = MLAS_SGEMM_STRIDEN;
+        StrideK = MLAS_SGEMM_STRIDEK;
 
-        while (StrideK / 2 >= K) {
-            StrideN *= 2;
-            StrideK /= 2;
-        }
+        if (N >= K) {
+
+            while (StrideK / 2 >= K) {
+                StrideN *= 2;
+                StrideK /= 2;
+            }
 
-    } else if (TransA == CblasNoTrans) {
+        } else if (TransA == CblasNoTrans) {
 
-        while (StrideN > 16 && StrideN / 2 >= N) {
-            StrideK *= 2;
-            StrideN /= 2;
+            while (StrideN > 16 && StrideN / 2 >= N) {
+                StrideK *= 2;
+                StrideN /= 2;
+            }
         }
     }
 
@@ -927,87 +1256,123 @@ Return Value:
             // Step through each slice of matrix A along the M dimension.
             //
 
-            float* c = C + n;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+            MlasSgemmComputeBlock(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode,
+                (k + CountK == K) ? OutputStage : nullptr, StartM, StartN + n);
+        }
+    }
+}
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    size_t StartM,
+    size_t StartN
+    )
+/*++
 
-            if (TransA == CblasNoTrans) {
+Routine Description:
 
-                const float* a = A + k;
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B that was packed by MlasGemmPackB.
 
-                //
-                // Step through the rows of matrix A.
-                //
+Arguments:
 
-                do {
+    TransA - Supplies the transpose operation for matrix A.
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-                    RowsRemaining -= RowsHandled;
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-                } while (RowsRemaining > 0);
+    A - Supplies the address of matrix A.
 
-            } else {
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B, offset to the first
+        column to use. The column must be a multiple of the packed N stride.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
 
-                const float* a = A + k * lda;
+    OutputStage - Supplies the optional output stage to apply to matrix C.
 
-                do {
+    StartM - Supplies the row of the full matrix C of the first row of this
+        matrix C, for the output stage.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    StartN - Supplies the column of the full matrix C of the first column of
+        this matrix C, for the output stage.
 
-                    size_t RowsTransposed = RowsRemaining;
+Return Value:
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    None.
 
-                    RowsRemaining -= RowsTransposed;
+--*/
+{
+    //
+    // Step through each slice of matrix B along the N dimension. The panels
+    // were packed with the same strides, so each is used directly.
+    //
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    size_t CountN;
+    size_t CountK;
 
-                    a += RowsTransposed;
+    for (size_t n = 0; n < N; n += CountN) {
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
 
-                    const float* pa = PanelA;
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
 
-                    do {
+        size_t AlignedCountN = (CountN + 15) & ~size_t(15);
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
-#else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+        for (size_t k = 0; k < K; k += CountK) {
 
-                        RowsTransposed -= RowsHandled;
+            bool ZeroMode = (k == 0 && beta == 0.0f);
 
-                    } while (RowsTransposed > 0);
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
 
-                } while (RowsRemaining > 0);
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + n * K + k * AlignedCountN;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmComputeBlock(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode,
+                (k + CountK == K) ? OutputStage : nullptr, StartM, StartN + n);
         }
     }
 }
@@ -1040,10 +1405,18 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    if (WorkBlock->BIsPacked) {
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->N,
+            WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->beta, Segment->C, WorkBlock->ldc,
+            WorkBlock->OutputStage, Segment->StartM, Segment->StartN);
+    } else {
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, WorkBlock->OutputStage, Segment->StartM,
+            Segment->StartN, WorkBlock->StrideN, WorkBlock->StrideK);
+    }
 }
 
 inline
@@ -1059,9 +1432,12 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    bool BIsPacked,
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    const MLAS_SGEMM_TUNING* Tuning,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1094,12 +1470,20 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    BIsPacked - Supplies true if matrix B was packed by MlasGemmPackB, in which
+        case TransB and ldb are ignored.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputStage - Supplies the optional output stage to apply to matrix C.
+
+    Tuning - Supplies the optional block sizes and thread split to use instead
+        of the default heuristics. The strides are ignored if BIsPacked is true.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1126,6 +1510,13 @@ Return Value:
         TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
     }
 
+    bool SplitN = (N > M);
+
+    if (Tuning != nullptr && Tuning->ThreadCount != 0) {
+        TargetThreadCount = Tuning->ThreadCount;
+        SplitN = Tuning->SplitN;
+    }
+
     int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
     if (TargetThreadCount >= MaximumThreadCount) {
@@ -1142,12 +1533,16 @@ Return Value:
 
     WorkBlock.TransA = TransA;
     WorkBlock.TransB = TransB;
+    WorkBlock.BIsPacked = BIsPacked;
     WorkBlock.K = K;
     WorkBlock.lda = lda;
     WorkBlock.ldb = ldb;
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.OutputStage = OutputStage;
+    WorkBlock.StrideN = (Tuning != nullptr) ? Tuning->StrideN : 0;
+    WorkBlock.StrideK = (Tuning != nullptr) ? Tuning->StrideK : 0;
 
     //
     // Segment the operation across multiple threads.
@@ -1155,7 +1550,7 @@ Return Value:
 
     int32_t Index = 0;
 
-    if (N > M) {
+    if (SplitN) {
 
         size_t StrideN = N / TargetThreadCount;
 
@@ -1163,10 +1558,16 @@ Return Value:
             StrideN++;
         }
 
-        StrideN =
-            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+        //
+        // A packed matrix B can only be split at the start of a packed panel.
+        // All preceding panels are full, so the offset of the panel is n * K.
+        //
+
+        size_t StrideNAlign = BIsPacked ? MLAS_SGEMM_PACKED_STRIDEN : MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        StrideN = (StrideN + StrideNAlign - 1) & ~(StrideNAlign - 1);
 
-        size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
+        size_t pldb = BIsPacked ? K : (TransB == CblasNoTrans) ? 1 : ldb;
 
         for (size_t CountN, n = 0; n < N; n += CountN) {
 
@@ -1178,6 +1579,8 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartM = 0;
+            WorkBlock.Segments[Index].StartN = n;
             WorkBlock.Segments[Index].A = A;
             WorkBlock.Segments[Index].B = B + n * pldb;
             WorkBlock.Segments[Index].C = C + n;
@@ -1205,6 +1608,8 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartM = m;
+            WorkBlock.Segments[Index].StartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1219,8 +1624,7 @@ Return Value:
 }
 
 void
-MLASCALL
-MlasGemm(
+MlasSgemmExecute(
     CBLAS_TRANSPOSE TransA,
     CBLAS_TRANSPOSE TransB,
     size_t M,
@@ -1234,14 +1638,755 @@ MlasGemm(
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    const MLAS_SGEMM_TUNING* Tuning,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
 
 Routine Description:
 
-    This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
+    This routine runs a single precision matrix/matrix multiply operation
+    (SGEMM) across multiple threads or falls back to a single thread based on
+    the GEMM parameters, the optional tuning parameters and the system
+    configuration.
+
+Arguments:
+
+    See MlasSgemmTryMultithread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, false, beta, C, ldc, OutputStage, Tuning, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, OutputStage, 0, 0,
+            (Tuning != nullptr) ? Tuning->StrideN : 0, (Tuning != nullptr) ? Tuning->StrideK : 0);
+    }
+}
+
+//
+// Define the state of the SGEMM autotuning. The first operation with a new
+// shape times the candidate thread splits and block sizes and the fastest is
+// used for every later operation with the same shape and maximum thread count.
+// The choices are appended to the optional cache file, which is read when the
+// autotuning is enabled, so that later processes on the same machine reuse
+// them.
+//
+// N.B. The operations on small matrices use the default heuristics as the
+// timing overhead would not be recovered.
+//
+
+#define MLAS_SGEMM_AUTOTUNING_COMPLEXITY            (MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)
+#define MLAS_SGEMM_AUTOTUNING_ITERATIONS            3
+
+struct MLAS_SGEMM_TUNING_KEY {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    int32_t MaximumThreadCount;
+
+    bool operator<(const MLAS_SGEMM_TUNING_KEY& Other) const
+    {
+        return std::tie(TransA, TransB, M, N, K, MaximumThreadCount) <
+            std::tie(Other.TransA, Other.TransB, Other.M, Other.N, Other.K, Other.MaximumThreadCount);
+    }
+};
+
+struct MLAS_SGEMM_AUTOTUNING {
+    std::mutex Lock;
+    std::map<MLAS_SGEMM_TUNING_KEY, MLAS_SGEMM_TUNING> Cache;
+    std::string CacheFilePath;
+};
+
+static std::atomic<bool> MlasSgemmAutotuningEnabled(false);
+
+MLAS_SGEMM_AUTOTUNING&
+MlasSgemmGetAutotuning(
+    void
+    )
+{
+    static MLAS_SGEMM_AUTOTUNING Autotuning;
+
+    return Autotuning;
+}
+
+FILE*
+MlasSgemmOpenTuningCache(
+    const char* CacheFilePath,
+    const char* Mode
+    )
+{
+#if defined(_WIN32)
+    FILE* File;
+
+    if (fopen_s(&File, CacheFilePath, Mode) != 0) {
+        return nullptr;
+    }
+
+    return File;
+#else
+    return fopen(CacheFilePath, Mode);
+#endif
+}
+
+bool
+MlasSgemmIsValidTuning(
+    const MLAS_SGEMM_TUNING_KEY& Key,
+    const MLAS_SGEMM_TUNING& Tuning
+    )
+/*++
+
+Routine Description:
+
+    This routine checks that the tuning parameters can be used for an
+    operation, so that a damaged cache file cannot overrun the local buffers.
+
+Arguments:
+
+    Key - Supplies the shape of the operation.
+
+    Tuning - Supplies the tuning parameters.
+
+Return Value:
+
+    Returns true if the tuning parameters are valid.
+
+--*/
+{
+    if (Key.TransA != CblasNoTrans && Key.TransA != CblasTrans) {
+        return false;
+    }
+
+    if (Key.TransB != CblasNoTrans && Key.TransB != CblasTrans) {
+        return false;
+    }
+
+    if (Tuning.ThreadCount < 0 || Tuning.ThreadCount > MLAS_MAXIMUM_THREAD_COUNT) {
+        return false;
+    }
+
+    if ((Tuning.StrideN == 0) != (Tuning.StrideK == 0)) {
+        return false;
+    }
+
+    if (Tuning.StrideN > MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK ||
+        Tuning.StrideK > MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK ||
+        size_t(Tuning.StrideN) * size_t(Tuning.StrideK) > MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK) {
+        return false;
+    }
+
+    //
+    // The rows of a transposed matrix A are transposed to a local buffer
+    // sized for the packed K stride.
+    //
+
+    if (Key.TransA == CblasTrans && Tuning.StrideK > MLAS_SGEMM_PACKED_STRIDEK) {
+        return false;
+    }
+
+    return true;
+}
+
+void
+MlasSgemmLoadTuningCache(
+    MLAS_SGEMM_AUTOTUNING& Autotuning,
+    const char* CacheFilePath
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the entries of a cache file to the tuning cache. Each line
+    of the file holds the integers TransA TransB M N K MaximumThreadCount
+    StrideN StrideK ThreadCount SplitN. Invalid lines are ignored.
+
+Arguments:
+
+    Autotuning - Supplies the autotuning state. The lock must be held.
+
+    CacheFilePath - Supplies the path of the cache file.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    FILE* File = MlasSgemmOpenTuningCache(CacheFilePath, "r");
+
+    if (File == nullptr) {
+        return;
+    }
+
+    char Line[256];
+
+    while (fgets(Line, sizeof(Line), File) != nullptr) {
+
+        unsigned long long Values[10];
+        const char* p = Line;
+        size_t Count = 0;
+
+        for (; Count < 10; Count++) {
+
+            char* End;
+
+            Values[Count] = strtoull(p, &End, 10);
+
+            if (End == p) {
+                break;
+            }
+
+            p = End;
+        }
+
+        if (Count != 10 || Values[2] == 0 || Values[3] == 0 || Values[4] == 0 ||
+            Values[5] > MLAS_MAXIMUM_THREAD_COUNT || Values[6] > UINT32_MAX ||
+            Values[7] > UINT32_MAX || Values[8] > MLAS_MAXIMUM_THREAD_COUNT || Values[9] > 1) {
+            continue;
+        }
+
+        MLAS_SGEMM_TUNING_KEY Key;
+
+        Key.TransA = CBLAS_TRANSPOSE(Values[0]);
+        Key.TransB = CBLAS_TRANSPOSE(Values[1]);
+        Key.M = size_t(Values[2]);
+        Key.N = size_t(Values[3]);
+        Key.K = size_t(Values[4]);
+        Key.MaximumThreadCount = int32_t(Values[5]);
+
+        MLAS_SGEMM_TUNING Tuning;
+
+        Tuning.StrideN = uint32_t(Values[6]);
+        Tuning.StrideK = uint32_t(Values[7]);
+        Tuning.ThreadCount = int32_t(Values[8]);
+        Tuning.SplitN = (Values[9] != 0);
+
+        if (MlasSgemmIsValidTuning(Key, Tuning)) {
+            Autotuning.Cache[Key] = Tuning;
+        }
+    }
+
+    fclose(File);
+}
+
+void
+MlasSgemmSaveTuning(
+    const MLAS_SGEMM_AUTOTUNING& Autotuning,
+    const MLAS_SGEMM_TUNING_KEY& Key,
+    const MLAS_SGEMM_TUNING& Tuning
+    )
+/*++
+
+Routine Description:
+
+    This routine appends an entry to the cache file, if any.
+
+Arguments:
+
+    Autotuning - Supplies the autotuning state. The lock must be held.
+
+    Key - Supplies the shape of the operation.
+
+    Tuning - Supplies the tuning parameters selected for the shape.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Autotuning.CacheFilePath.empty()) {
+        return;
+    }
+
+    FILE* File = MlasSgemmOpenTuningCache(Autotuning.CacheFilePath.c_str(), "a");
+
+    if (File == nullptr) {
+        return;
+    }
+
+    fprintf(File, "%d %d %llu %llu %llu %d %u %u %d %d\n", int(Key.TransA), int(Key.TransB),
+        (unsigned long long)Key.M, (unsigned long long)Key.N, (unsigned long long)Key.K,
+        int(Key.MaximumThreadCount), unsigned(Tuning.StrideN), unsigned(Tuning.StrideK),
+        int(Tuning.ThreadCount), Tuning.SplitN ? 1 : 0);
+
+    fclose(File);
+}
+
+double
+MlasSgemmTimeTuning(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    const MLAS_SGEMM_TUNING& Tuning,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine measures the fastest of several runs of an operation with a
+    set of tuning parameters.
+
+Arguments:
+
+    C - Supplies the address of a scratch M x N matrix C. The result of the
+        caller's operation is not written, so the operation is run with a beta
+        of zero.
+
+    Tuning - Supplies the tuning parameters to time.
+
+    See MlasSgemmTryMultithread for the other arguments.
+
+Return Value:
+
+    Returns the fastest time in seconds.
+
+--*/
+{
+    double Fastest = std::numeric_limits<double>::max();
+
+    for (int i = 0; i < MLAS_SGEMM_AUTOTUNING_ITERATIONS; i++) {
+
+        auto Start = std::chrono::steady_clock::now();
+
+        MlasSgemmExecute(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, 0.0f, C, N, nullptr, &Tuning, ThreadPool);
+
+        double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+        Fastest = std::min(Fastest, Elapsed);
+    }
+
+    return Fastest;
+}
+
+bool
+MlasSgemmGetTuning(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_SGEMM_TUNING* Tuning
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the tuning parameters for the shape of an operation,
+    timing the candidates if the shape is not in the tuning cache.
+
+    The thread split is selected first using the default block sizes, then the
+    block sizes are selected using that thread split. The K and N strides are
+    traded against each other so that the local buffer stays fully sized.
+
+Arguments:
+
+    See MlasSgemmTryMultithread.
+
+    Tuning - Receives the tuning parameters.
+
+Return Value:
+
+    Returns true if tuning parameters were found, else false if the default
+    heuristics should be used.
+
+--*/
+{
+    MLAS_SGEMM_AUTOTUNING& Autotuning = MlasSgemmGetAutotuning();
+
+    int32_t MaximumThreadCount = std::min(MlasGetMaximumThreadCount(ThreadPool), int32_t(MLAS_MAXIMUM_THREAD_COUNT));
+
+    MLAS_SGEMM_TUNING_KEY Key = {TransA, TransB, M, N, K, MaximumThreadCount};
+
+    {
+        std::lock_guard<std::mutex> Guard(Autotuning.Lock);
+
+        auto it = Autotuning.Cache.find(Key);
+
+        if (it != Autotuning.Cache.end()) {
+            *Tuning = it->second;
+            return true;
+        }
+    }
+
+    //
+    // Time the candidates without holding the lock. Concurrent operations
+    // with the same new shape may time it more than once.
+    //
+
+    std::unique_ptr<float[]> ScratchC(new (std::nothrow) float[M * N]);
+
+    if (ScratchC == nullptr) {
+        return false;
+    }
+
+    MLAS_SGEMM_TUNING Best = {0, 0, 1, false};
+    double BestTime = MlasSgemmTimeTuning(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ScratchC.get(), Best, ThreadPool);
+
+    for (int32_t ThreadCount = 2; ThreadCount < 2 * MaximumThreadCount; ThreadCount *= 2) {
+
+        ThreadCount = std::min(ThreadCount, MaximumThreadCount);
+
+        for (bool SplitN : {false, true}) {
+
+            MLAS_SGEMM_TUNING Candidate = {0, 0, ThreadCount, SplitN};
+            double Time = MlasSgemmTimeTuning(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ScratchC.get(), Candidate, ThreadPool);
+
+            if (Time < BestTime) {
+                Best = Candidate;
+                BestTime = Time;
+            }
+        }
+    }
+
+    MLAS_SGEMM_TUNING BestThreading = Best;
+
+    for (uint32_t StrideN = 16; StrideN <= MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK; StrideN *= 2) {
+
+        uint32_t StrideK = (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK) / StrideN;
+
+        //
+        // Skip the strides that exceed the matrix by more than one step, as
+        // they pack the same panels as a smaller stride.
+        //
+
+        if ((StrideN / 2 >= N && StrideN > 16) || (StrideK / 2 >= K && StrideK > 1)) {
+            continue;
+        }
+
+        MLAS_SGEMM_TUNING Candidate = BestThreading;
+
+        Candidate.StrideN = StrideN;
+        Candidate.StrideK = StrideK;
+
+        if (!MlasSgemmIsValidTuning(Key, Candidate)) {
+            continue;
+        }
+
+        double Time = MlasSgemmTimeTuning(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ScratchC.get(), Candidate, ThreadPool);
+
+        if (Time < BestTime) {
+            Best = Candidate;
+            BestTime = Time;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(Autotuning.Lock);
+
+    if (Autotuning.Cache.emplace(Key, Best).second) {
+        MlasSgemmSaveTuning(Autotuning, Key, Best);
+    }
+
+    *Tuning = Best;
+
+    return true;
+}
+
+void
+MLASCALL
+MlasGemmEnableAutotuning(
+    const char* CacheFilePath
+    )
+/*++
+
+Routine Description:
+
+    This routine enables the autotuning of the single precision matrix/matrix
+    multiply operations, optionally persisting the selected parameters.
+
+Arguments:
+
+    CacheFilePath - Supplies the optional path of the file the selected
+        parameters are read from and appended to, else nullptr to keep them
+        in memory only.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_AUTOTUNING& Autotuning = MlasSgemmGetAutotuning();
+
+    {
+        std::lock_guard<std::mutex> Guard(Autotuning.Lock);
+
+        if (CacheFilePath != nullptr && *CacheFilePath != '\0') {
+            MlasSgemmLoadTuningCache(Autotuning, CacheFilePath);
+            Autotuning.CacheFilePath = CacheFilePath;
+        }
+    }
+
+    MlasSgemmAutotuningEnabled = true;
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) followed by an output stage that adds a bias and applies
+    an activation to each block of matrix C while it is still in the cache.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional output stage to apply to matrix C. K
+        must not be zero if an output stage is supplied.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Use the tuned parameters for the shape if the autotuning is enabled and
+    // try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    MLAS_SGEMM_TUNING Tuning;
+    const MLAS_SGEMM_TUNING* TuningToUse = nullptr;
+
+    if (MlasSgemmAutotuningEnabled && double(M) * double(N) * double(K) >= double(MLAS_SGEMM_AUTOTUNING_COMPLEXITY)) {
+        if (MlasSgemmGetTuning(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, ThreadPool, &Tuning)) {
+            TuningToUse = &Tuning;
+        }
+    }
+
+    MlasSgemmExecute(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, OutputStage, TuningToUse, ThreadPool);
+}
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    segments of a batch of SGEMM operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->BatchN * WorkBlock->SegmentCount,
+        &WorkIndex, &WorkRemaining);
+
+    for (; WorkRemaining > 0; WorkIndex++, WorkRemaining--) {
+
+        const size_t Batch = WorkIndex / WorkBlock->SegmentCount;
+        const size_t Start = (WorkIndex % WorkBlock->SegmentCount) * WorkBlock->SegmentStride;
+
+        const float* A = WorkBlock->A[Batch];
+        const float* B = WorkBlock->B[Batch];
+        float* C = WorkBlock->C[Batch];
+
+        if (WorkBlock->SplitN) {
+
+            size_t CountN = std::min(WorkBlock->SegmentStride, WorkBlock->N - Start);
+            size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+            MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, WorkBlock->M,
+                CountN, WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda,
+                B + Start * pldb, WorkBlock->ldb, WorkBlock->beta, C + Start,
+                WorkBlock->ldc, nullptr, 0, Start, 0, 0);
+
+        } else {
+
+            size_t CountM = std::min(WorkBlock->SegmentStride, WorkBlock->M - Start);
+            size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+            MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, CountM,
+                WorkBlock->N, WorkBlock->K, WorkBlock->alpha, A + Start * plda,
+                WorkBlock->lda, B, WorkBlock->ldb, WorkBlock->beta,
+                C + Start * WorkBlock->ldc, WorkBlock->ldc, nullptr, Start, 0, 0, 0);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* const* A,
+    size_t lda,
+    const float* const* B,
+    size_t ldb,
+    float beta,
+    float* const* C,
+    size_t ldc,
+    size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) that share the same shape. The threads are distributed
+    across the operations and the segments of each operation jointly.
 
 Arguments:
 
@@ -1258,20 +2403,23 @@ Arguments:
 
     alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-    A - Supplies the address of matrix A.
+    A - Supplies the addresses of matrix A for each operation.
 
     lda - Supplies the first dimension of matrix A.
 
-    B - Supplies the address of matrix B.
+    B - Supplies the addresses of matrix B for each operation.
 
     ldb - Supplies the first dimension of matrix B.
 
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-    C - Supplies the address of matrix C.
+    C - Supplies the addresses of matrix C for each operation. The matrices
+        must not overlap.
 
     ldc - Supplies the first dimension of matrix C.
 
+    BatchN - Supplies the number of operations.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1282,11 +2430,330 @@ Return Value:
 --*/
 {
     //
-    // Try to run the operation across multiple threads or fall back to a
-    // single thread based on the GEMM parameters and system configuration.
+    // A single operation is split across the threads as usual, which also
+    // uses the autotuned parameters if enabled.
+    //
+
+    if (BatchN == 1) {
+        MlasGemm(TransA, TransB, M, N, K, alpha, A[0], lda, B[0], ldb, beta, C[0], ldc, nullptr, ThreadPool);
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. Unlike a single operation, the segments are not stored in a
+    // fixed size table, so only the thread pool limits the thread count.
+    //
+
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchN);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY) * double(MaximumThreadCount)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount <= 1) {
+        for (size_t Batch = 0; Batch < BatchN; Batch++) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A[Batch], lda, B[Batch], ldb, beta, C[Batch], ldc,
+                nullptr, 0, 0, 0, 0);
+        }
+        return;
+    }
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.BatchN = BatchN;
+    WorkBlock.SplitN = (N > M);
+    WorkBlock.SegmentCount = 1;
+    WorkBlock.SegmentStride = WorkBlock.SplitN ? N : M;
+
+    //
+    // Each operation is only split into segments if the batch has fewer
+    // operations than the target threads. The columns of a segment are aligned
+    // like those of a single threaded operation.
+    //
+
+    if (size_t(TargetThreadCount) > BatchN) {
+
+        const size_t SegmentsPerOperation = (size_t(TargetThreadCount) + BatchN - 1) / BatchN;
+        const size_t Extent = WorkBlock.SplitN ? N : M;
+
+        size_t SegmentStride = (Extent + SegmentsPerOperation - 1) / SegmentsPerOperation;
+
+        if (WorkBlock.SplitN) {
+            SegmentStride = (SegmentStride + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+                ~(size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN) - 1);
+        }
+
+        WorkBlock.SegmentStride = SegmentStride;
+        WorkBlock.SegmentCount = (Extent + SegmentStride - 1) / SegmentStride;
+    }
+
+    const size_t TotalSegments = BatchN * WorkBlock.SegmentCount;
+
+    if (size_t(TargetThreadCount) > TotalSegments) {
+        TargetThreadCount = int32_t(TotalSegments);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasGemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    //
+    // Every panel is padded to a multiple of 16 columns. Only the last panel
+    // can be narrower than the packed N stride, so the padding is applied
+    // once.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B into the panel layout used by the SGEMM
+    kernels, so that a constant matrix B is packed once instead of on every
+    call to MlasGemm.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasGemmPackBSize bytes and aligned to MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float* D = (float*)PackedB;
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            if (TransB == CblasNoTrans) {
+                MlasSgemmCopyPackB(D, B + n + k * ldb, ldb, CountN, CountK);
+            } else {
+                MlasSgemmTransposePackB(D, B + k + n * ldb, ldb, CountN, CountK);
+            }
+
+            D += AlignedCountN * CountK;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B that was packed by MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB with the
+        same N and K.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_OUTPUT_STAGE* OutputStage,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B that was packed by MlasGemmPackB,
+    followed by an output stage that adds a bias and applies an activation to
+    each block of matrix C while it is still in the cache.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB with the
+        same N and K.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    OutputStage - Supplies the optional output stage to apply to matrix C. K
+        must not be zero if an output stage is supplied.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* B = (const float*)PackedB;
+
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, B, 0, true, beta, C, ldc, OutputStage, nullptr, ThreadPool)) {
+        MlasSgemmPackedOperation(TransA, M, N, K, alpha, A, lda, B, beta, C, ldc, OutputStage, 0, 0);
     }
 }
@@ -1415,6 +1415,164 @@ Return Value:
     MlasExecuteThreaded(MlasNchwcThreaded<MLAS_NCHWC_POOL_ALGORITHM>, &WorkBlock, WorkBlock.tids, ThreadPool);
 }
 
+//
+// Define the parameters to execute segments of a NCHWc upsample operation on
+// worker threads.
+//
+
+struct MLAS_NCHWC_UPSAMPLE_WORK_BLOCK {
+    int32_t tids;
+    size_t TotalRows;
+    size_t InputWidth;
+    size_t ScaleHeight;
+    size_t ScaleWidth;
+    const float* Input;
+    float* Output;
+};
+
+void
+MlasNchwcUpsampleThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc upsample operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_NCHWC_UPSAMPLE_WORK_BLOCK* WorkBlock = (MLAS_NCHWC_UPSAMPLE_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t ScaleHeight = WorkBlock->ScaleHeight;
+    const size_t ScaleWidth = WorkBlock->ScaleWidth;
+
+    const size_t InputRowElements = BlockSize * InputWidth;
+    const size_t OutputRowElements = InputRowElements * ScaleWidth;
+
+    //
+    // Partition the input rows of all batches and channel blocks across the
+    // threads.
+    //
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->TotalRows, &RowIndex, &RowRemaining);
+
+    const float* input = WorkBlock->Input + RowIndex * InputRowElements;
+    float* output = WorkBlock->Output + RowIndex * OutputRowElements * ScaleHeight;
+
+    while (RowRemaining > 0) {
+
+        //
+        // Replicate each input column vector to produce the first output row.
+        //
+
+        float* OutputRow = output;
+
+        for (size_t iw = 0; iw < InputWidth; iw++) {
+
+            for (size_t sw = 0; sw < ScaleWidth; sw++) {
+                std::copy_n(input, BlockSize, OutputRow);
+                OutputRow += BlockSize;
+            }
+
+            input += BlockSize;
+        }
+
+        //
+        // Replicate the first output row to produce the remaining output rows.
+        //
+
+        for (size_t sh = 1; sh < ScaleHeight; sh++) {
+            std::copy_n(output, OutputRowElements, output + sh * OutputRowElements);
+        }
+
+        output += OutputRowElements * ScaleHeight;
+
+        RowRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc upsample operation using nearest
+    neighbor interpolation with integer scale factors.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Scales - Supplies the scale factors of the height and width dimensions.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_UPSAMPLE_WORK_BLOCK WorkBlock;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    WorkBlock.TotalRows = size_t(InputShape[0]) * (size_t(InputShape[1]) / BlockSize) *
+        size_t(InputShape[2]);
+    WorkBlock.InputWidth = size_t(InputShape[3]);
+    WorkBlock.ScaleHeight = size_t(Scales[0]);
+    WorkBlock.ScaleWidth = size_t(Scales[1]);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    //
+    // Schedule the operation across a set of worker threads. The operation is
+    // bound by memory bandwidth, so limit the threads to the number of input
+    // rows.
+    //
+
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= WorkBlock.TotalRows) {
+        TargetThreadCount = int32_t(std::max(WorkBlock.TotalRows, size_t(1)));
+    }
+
+    WorkBlock.tids = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasNchwcUpsampleThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
 #if !defined(MLAS_TARGET_AMD64)
 
 //
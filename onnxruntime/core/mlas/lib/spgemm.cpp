@@ -0,0 +1,819 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    spgemm.cpp
+
+Abstract:
+
+    This module implements the sparse matrix/matrix multiply operation
+    (SPGEMM), which multiplies a dense matrix A by a constant sparse matrix B.
+
+    Matrix B is split into blocks of MLAS_SPGEMM_STRIDEK rows. The non-zero
+    values of each column of a block are stored in compressed sparse column
+    form with a single byte row offset inside the block. To multiply a block,
+    up to 16 rows of matrix A are transposed into a panel, so that the product
+    of a non-zero value with the elements of all the rows of the panel is a
+    single vector multiply-add.
+
+--*/
+
+#include "mlasi.h"
+
+#include <vector>
+
+//
+// Define the number of rows of matrix B in a packed block. The row offsets
+// inside a block are stored as bytes.
+//
+
+#define MLAS_SPGEMM_STRIDEK                         256
+
+//
+// Define the number of rows of matrix A that are multiplied with each packed
+// block of matrix B.
+//
+
+#define MLAS_SPGEMM_STRIDEM                         16
+
+//
+// Define the number of columns of matrix C that are accumulated in a tile.
+//
+
+#define MLAS_SPGEMM_STRIDEN                         128
+
+//
+// Define the alignment of the columns of matrix C that are split across
+// threads, so threads don't share cache lines of matrix C.
+//
+
+#define MLAS_SPGEMM_STRIDEN_THREAD_ALIGN            16
+
+//
+// Define the maximum percentage of non-zero values of matrix B. Above this,
+// the dense packed SGEMM kernels are faster.
+//
+
+#define MLAS_SPGEMM_MAXIMUM_DENSITY_PERCENT         10
+
+//
+// Define the layout of a packed matrix B. Offsets holds KBlocks * N + 1
+// entries: the non-zero values of column n of block kb are at indices
+// [Offsets[kb * N + n], Offsets[kb * N + n + 1]) of RowIndices and Values.
+//
+
+struct MLAS_SPGEMM_PACKED_B {
+    const uint32_t* Offsets;
+    const uint8_t* RowIndices;
+    const float* Values;
+};
+
+//
+// Define the parameters to execute segments of a SPGEMM operation on worker
+// threads.
+//
+
+struct MLAS_SPGEMM_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    MLAS_SPGEMM_PACKED_B PackedB;
+    float beta;
+    float* C;
+    size_t ldc;
+};
+
+MLAS_FORCEINLINE
+size_t
+MlasSparseGemmOffsetsSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of bytes of the offsets of a packed matrix
+    B. The row indices follow the offsets and are padded to a multiple of 16
+    bytes, followed by the values.
+
+--*/
+{
+    const size_t KBlocks = (K + MLAS_SPGEMM_STRIDEK - 1) / MLAS_SPGEMM_STRIDEK;
+
+    return (KBlocks * N + 1) * sizeof(uint32_t);
+}
+
+MLAS_FORCEINLINE
+MLAS_SPGEMM_PACKED_B
+MlasSparseGemmGetPackedB(
+    size_t N,
+    size_t K,
+    const void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the arrays of a packed matrix B.
+
+--*/
+{
+    const size_t KBlocks = (K + MLAS_SPGEMM_STRIDEK - 1) / MLAS_SPGEMM_STRIDEK;
+    const size_t OffsetsSize = MlasSparseGemmOffsetsSize(N, K);
+
+    MLAS_SPGEMM_PACKED_B Packed;
+
+    Packed.Offsets = (const uint32_t*)PackedB;
+    Packed.RowIndices = (const uint8_t*)PackedB + OffsetsSize;
+
+    const size_t NonZeroCount = Packed.Offsets[KBlocks * N];
+    const size_t AlignedIndicesSize = (NonZeroCount + 15) & ~size_t(15);
+
+    Packed.Values = (const float*)(Packed.RowIndices + AlignedIndicesSize);
+
+    return Packed;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasSparseGemmCountNonZeros(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of non-zero values of matrix B.
+
+--*/
+{
+    size_t NonZeroCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+            float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (b != 0.0f) {
+                NonZeroCount++;
+            }
+        }
+    }
+
+    return NonZeroCount;
+}
+
+float
+MLASCALL
+MlasSparseGemmEstimateSpeedup(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine estimates how many times faster MlasSparseGemm is than
+    MlasGemm for the supplied matrix B.
+
+    The time of MlasGemm is proportional to N * K and the time of
+    MlasSparseGemm to the number of non-zero values. Each non-zero value costs
+    about as much as the dense products of 100 / MAXIMUM_DENSITY_PERCENT
+    values, so the operations break even at the maximum density.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the estimated speedup, which is less than one if MlasGemm is the
+    faster operation.
+
+--*/
+{
+    if (N == 0 || K == 0) {
+        return 0.0f;
+    }
+
+    const size_t NonZeroCount = (std::max)(MlasSparseGemmCountNonZeros(TransB, N, K, B, ldb), size_t(1));
+
+    return float(N * K) * MLAS_SPGEMM_MAXIMUM_DENSITY_PERCENT / (100.0f * float(NonZeroCount));
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer, or zero if matrix
+    B has too many non-zero values for MlasSparseGemm to be the faster
+    operation.
+
+--*/
+{
+    if (N == 0 || K == 0) {
+        return 0;
+    }
+
+    const size_t NonZeroCount = MlasSparseGemmCountNonZeros(TransB, N, K, B, ldb);
+
+    if (NonZeroCount * 100 > N * K * MLAS_SPGEMM_MAXIMUM_DENSITY_PERCENT ||
+        NonZeroCount > size_t(std::numeric_limits<uint32_t>::max())) {
+        return 0;
+    }
+
+    const size_t AlignedIndicesSize = (NonZeroCount + 15) & ~size_t(15);
+
+    return MlasSparseGemmOffsetsSize(N, K) + AlignedIndicesSize + NonZeroCount * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the non-zero values of matrix B. The packed buffer must
+    be at least as large as returned by MlasSparseGemmPackBSize.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t KBlocks = (K + MLAS_SPGEMM_STRIDEK - 1) / MLAS_SPGEMM_STRIDEK;
+
+    uint32_t* Offsets = (uint32_t*)PackedB;
+
+    //
+    // Count the non-zero values of each column of each block.
+    //
+
+    std::fill_n(Offsets, KBlocks * N + 1, 0);
+
+    for (size_t k = 0; k < K; k++) {
+
+        uint32_t* BlockOffsets = Offsets + (k / MLAS_SPGEMM_STRIDEK) * N + 1;
+
+        for (size_t n = 0; n < N; n++) {
+            float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (b != 0.0f) {
+                BlockOffsets[n]++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < KBlocks * N; i++) {
+        Offsets[i + 1] += Offsets[i];
+    }
+
+    //
+    // Store the non-zero values in ascending row order, using the start
+    // offsets of the columns as insertion points.
+    //
+
+    const size_t OffsetsSize = MlasSparseGemmOffsetsSize(N, K);
+    const size_t NonZeroCount = Offsets[KBlocks * N];
+    const size_t AlignedIndicesSize = (NonZeroCount + 15) & ~size_t(15);
+
+    uint8_t* RowIndices = (uint8_t*)PackedB + OffsetsSize;
+    float* Values = (float*)(RowIndices + AlignedIndicesSize);
+
+    std::vector<uint32_t> Positions(Offsets, Offsets + KBlocks * N);
+
+    for (size_t k = 0; k < K; k++) {
+
+        uint32_t* BlockPositions = Positions.data() + (k / MLAS_SPGEMM_STRIDEK) * N;
+
+        for (size_t n = 0; n < N; n++) {
+            float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (b != 0.0f) {
+                const uint32_t Position = BlockPositions[n]++;
+                RowIndices[Position] = uint8_t(k % MLAS_SPGEMM_STRIDEK);
+                Values[Position] = b;
+            }
+        }
+    }
+}
+
+template<size_t VectorCount>
+void
+MlasSparseGemmBlock(
+    CBLAS_TRANSPOSE TransA,
+    size_t RowCount,
+    size_t N,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_SPGEMM_PACKED_B& PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies up to VectorCount * 4 rows of matrix A by columns
+    of packed matrix B.
+
+    MLAS_SPGEMM_STRIDEN columns of matrix C at a time are accumulated in a
+    tile over all the blocks of matrix B, so matrix C is only accessed once
+    and by rows. Each block of matrix A is transposed into a panel for each
+    tile of columns.
+
+Arguments:
+
+    TransA - Supplies the transpose operation on matrix A.
+
+    RowCount - Supplies the number of rows of matrix A and matrix C, which is
+        at most VectorCount * 4.
+
+    N - Supplies the number of columns of packed matrix B.
+
+    CountN - Supplies the number of columns of matrix C to compute, starting
+        at the columns of packed matrix B that PackedB.Offsets points to.
+
+    K - Supplies the number of columns of matrix A and rows of matrix B.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first row of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the packed matrix B, with the offsets adjusted to the
+        first column to compute.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first element of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t StrideM = VectorCount * 4;
+
+    MLAS_DECLSPEC_ALIGN(float Panel[MLAS_SPGEMM_STRIDEK * MLAS_SPGEMM_STRIDEM], 16 * sizeof(float));
+    MLAS_DECLSPEC_ALIGN(float Tile[MLAS_SPGEMM_STRIDEN * MLAS_SPGEMM_STRIDEM], 16 * sizeof(float));
+
+    if (RowCount < StrideM) {
+        std::fill_n(Panel, MLAS_SPGEMM_STRIDEK * StrideM, 0.0f);
+    }
+
+    for (size_t ColumnCount, n = 0; n < CountN; n += ColumnCount) {
+
+        ColumnCount = std::min(CountN - n, size_t(MLAS_SPGEMM_STRIDEN));
+
+        for (size_t k = 0, kb = 0; k < K; k += MLAS_SPGEMM_STRIDEK, kb++) {
+
+            const size_t CountK = std::min(K - k, size_t(MLAS_SPGEMM_STRIDEK));
+
+            //
+            // Copy the columns of matrix A for this block to the rows of the
+            // panel. The unused columns of the panel stay zero.
+            //
+
+            if (TransA == CblasNoTrans) {
+                MlasTranspose((const uint32_t*)(A + k), lda, (uint32_t*)Panel, StrideM, RowCount, CountK);
+            } else {
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    std::copy_n(A + (k + kk) * lda, RowCount, Panel + kk * StrideM);
+                }
+            }
+
+            const uint32_t* Offsets = PackedB.Offsets + kb * N + n;
+
+            for (size_t nn = 0; nn < ColumnCount; nn++) {
+
+                //
+                // The accumulators are separate variables, so that they are
+                // kept in registers without relying on the compiler to unroll
+                // the loops over the vectors.
+                //
+
+                float* t = Tile + nn * StrideM;
+
+                MLAS_FLOAT32X4 Vector0 = MlasZeroFloat32x4();
+                MLAS_FLOAT32X4 Vector1 = MlasZeroFloat32x4();
+                MLAS_FLOAT32X4 Vector2 = MlasZeroFloat32x4();
+                MLAS_FLOAT32X4 Vector3 = MlasZeroFloat32x4();
+
+                if (kb > 0) {
+                    Vector0 = MlasLoadFloat32x4(t);
+                    if (VectorCount > 1) {
+                        Vector1 = MlasLoadFloat32x4(t + 4);
+                    }
+                    if (VectorCount > 2) {
+                        Vector2 = MlasLoadFloat32x4(t + 8);
+                        Vector3 = MlasLoadFloat32x4(t + 12);
+                    }
+                }
+
+                uint32_t i = Offsets[nn];
+                const uint32_t End = Offsets[nn + 1];
+
+                //
+                // A single vector of rows is latency bound, so alternate the
+                // products between two accumulators.
+                //
+
+                if (VectorCount == 1) {
+
+                    for (; i + 1 < End; i += 2) {
+
+                        MLAS_FLOAT32X4 Value0 = MlasBroadcastFloat32x4(PackedB.Values[i]);
+                        MLAS_FLOAT32X4 Value1 = MlasBroadcastFloat32x4(PackedB.Values[i + 1]);
+                        const float* a0 = Panel + PackedB.RowIndices[i] * StrideM;
+                        const float* a1 = Panel + PackedB.RowIndices[i + 1] * StrideM;
+
+                        Vector0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a0), Value0, Vector0);
+                        Vector1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a1), Value1, Vector1);
+                    }
+
+                    Vector0 = MlasAddFloat32x4(Vector0, Vector1);
+                }
+
+                for (; i < End; i++) {
+
+                    MLAS_FLOAT32X4 Value = MlasBroadcastFloat32x4(PackedB.Values[i]);
+                    const float* a = Panel + PackedB.RowIndices[i] * StrideM;
+
+                    Vector0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a), Value, Vector0);
+                    if (VectorCount > 1) {
+                        Vector1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 4), Value, Vector1);
+                    }
+                    if (VectorCount > 2) {
+                        Vector2 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 8), Value, Vector2);
+                        Vector3 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + 12), Value, Vector3);
+                    }
+                }
+
+                MlasStoreAlignedFloat32x4(t, Vector0);
+                if (VectorCount > 1) {
+                    MlasStoreAlignedFloat32x4(t + 4, Vector1);
+                }
+                if (VectorCount > 2) {
+                    MlasStoreAlignedFloat32x4(t + 8, Vector2);
+                    MlasStoreAlignedFloat32x4(t + 12, Vector3);
+                }
+            }
+        }
+
+        //
+        // Scale the tile and store it to matrix C.
+        //
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            float* c = C + r * ldc + n;
+            const float* t = Tile + r;
+
+            if (beta == 0.0f) {
+                for (size_t nn = 0; nn < ColumnCount; nn++) {
+                    c[nn] = t[nn * StrideM] * alpha;
+                }
+            } else {
+                for (size_t nn = 0; nn < ColumnCount; nn++) {
+                    c[nn] = c[nn] * beta + t[nn * StrideM] * alpha;
+                }
+            }
+        }
+    }
+}
+
+void
+MlasSparseGemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_SPGEMM_PACKED_B& PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single threaded sparse matrix/matrix multiply
+    operation for a range of rows and columns of matrix C.
+
+Arguments:
+
+    See MlasSparseGemmBlock. M supplies the number of rows of matrix A and
+    matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t RowCount, m = 0; m < M; m += RowCount) {
+
+        RowCount = std::min(M - m, size_t(MLAS_SPGEMM_STRIDEM));
+
+        const float* a = (TransA == CblasNoTrans) ? A + m * lda : A + m;
+        float* c = C + m * ldc;
+
+        //
+        // Use the narrowest panel that holds the rows, so that a small batch
+        // doesn't compute products of the zero padding.
+        //
+
+        if (RowCount <= 4) {
+            MlasSparseGemmBlock<1>(TransA, RowCount, N, CountN, K, alpha, a, lda, PackedB, beta, c, ldc);
+        } else if (RowCount <= 8) {
+            MlasSparseGemmBlock<2>(TransA, RowCount, N, CountN, K, alpha, a, lda, PackedB, beta, c, ldc);
+        } else {
+            MlasSparseGemmBlock<4>(TransA, RowCount, N, CountN, K, alpha, a, lda, PackedB, beta, c, ldc);
+        }
+    }
+}
+
+void
+MlasSparseGemmThreaded(
+    void* Context,
+    int32_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SPGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SPGEMM_WORK_BLOCK*)Context;
+
+    const int32_t ThreadIdM = ThreadId / WorkBlock->ThreadCountN;
+    const int32_t ThreadIdN = ThreadId % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension, in multiples of the
+    // panel rows.
+    //
+
+    const size_t M = WorkBlock->M;
+    const size_t BlockedM = (M + MLAS_SPGEMM_STRIDEM - 1) / MLAS_SPGEMM_STRIDEM;
+    size_t m;
+    size_t CountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, BlockedM, &m, &CountM);
+
+    m *= MLAS_SPGEMM_STRIDEM;
+    CountM *= MLAS_SPGEMM_STRIDEM;
+
+    if (CountM > M - m) {
+        CountM = M - m;
+    }
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t BlockedN = (N + MLAS_SPGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SPGEMM_STRIDEN_THREAD_ALIGN;
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &n, &CountN);
+
+    n *= MLAS_SPGEMM_STRIDEN_THREAD_ALIGN;
+    CountN *= MLAS_SPGEMM_STRIDEN_THREAD_ALIGN;
+
+    if (CountN > N - n) {
+        CountN = N - n;
+    }
+
+    if (CountM == 0 || CountN == 0) {
+        return;
+    }
+
+    MLAS_SPGEMM_PACKED_B PackedB = WorkBlock->PackedB;
+    PackedB.Offsets += n;
+
+    const size_t lda = WorkBlock->lda;
+    const float* A = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->A + m * lda : WorkBlock->A + m;
+
+    MlasSparseGemmOperation(WorkBlock->TransA, CountM, N, CountN, WorkBlock->K, WorkBlock->alpha,
+        A, lda, PackedB, WorkBlock->beta, WorkBlock->C + m * WorkBlock->ldc + n, WorkBlock->ldc);
+}
+
+void
+MLASCALL
+MlasSparseGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This module implements the sparse matrix/matrix multiply operation
+    (SPGEMM) with a matrix B packed by MlasSparseGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    MLAS_SPGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = MlasSparseGemmGetPackedB(N, K, PackedB);
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Compute the number of target threads given the number of multiplies
+    // with the non-zero values.
+    //
+
+    const size_t KBlocks = (K + MLAS_SPGEMM_STRIDEK - 1) / MLAS_SPGEMM_STRIDEK;
+    const double Complexity = double(M) * double(WorkBlock.PackedB.Offsets[KBlocks * N]);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split the rows of matrix C across the threads, then also split the
+    // columns if there are fewer panels of rows than threads.
+    //
+
+    const size_t BlockedM = (M + MLAS_SPGEMM_STRIDEM - 1) / MLAS_SPGEMM_STRIDEM;
+
+    if (BlockedM >= size_t(TargetThreadCount)) {
+        WorkBlock.ThreadCountM = TargetThreadCount;
+        WorkBlock.ThreadCountN = 1;
+    } else {
+        WorkBlock.ThreadCountM = int32_t(BlockedM);
+        WorkBlock.ThreadCountN = TargetThreadCount / int32_t(BlockedM);
+    }
+
+    TargetThreadCount = WorkBlock.ThreadCountM * WorkBlock.ThreadCountN;
+
+    if (TargetThreadCount == 1) {
+        MlasSparseGemmOperation(TransA, M, N, N, K, alpha, A, lda, WorkBlock.PackedB, beta, C, ldc);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasSparseGemmThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
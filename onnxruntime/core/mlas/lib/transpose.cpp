@@ -0,0 +1,344 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the matrix transpose routines.
+
+    The matrix is processed in tiles of rows so that the source cache lines
+    touched by a column of blocks are still resident for the next column of
+    blocks. Each block is transposed in registers by a micro-kernel.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of rows of the source matrix transposed in one tile.
+//
+
+#define MLAS_TRANSPOSE_TILE_ROWS                    64
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_KERNEL;
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint32_t>
+{
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+    static constexpr size_t BlockSize = 4;
+#else
+    static constexpr size_t BlockSize = 1;
+#endif
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint32_t* S,
+        size_t lda,
+        uint32_t* D,
+        size_t ldb
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        __m128i a0 = _mm_loadu_si128((const __m128i*)&S[lda * 0]);
+        __m128i a1 = _mm_loadu_si128((const __m128i*)&S[lda * 1]);
+        __m128i a2 = _mm_loadu_si128((const __m128i*)&S[lda * 2]);
+        __m128i a3 = _mm_loadu_si128((const __m128i*)&S[lda * 3]);
+
+        __m128i b0 = _mm_unpacklo_epi32(a0, a1);
+        __m128i b1 = _mm_unpackhi_epi32(a0, a1);
+        __m128i b2 = _mm_unpacklo_epi32(a2, a3);
+        __m128i b3 = _mm_unpackhi_epi32(a2, a3);
+
+        _mm_storeu_si128((__m128i*)&D[ldb * 0], _mm_unpacklo_epi64(b0, b2));
+        _mm_storeu_si128((__m128i*)&D[ldb * 1], _mm_unpackhi_epi64(b0, b2));
+        _mm_storeu_si128((__m128i*)&D[ldb * 2], _mm_unpacklo_epi64(b1, b3));
+        _mm_storeu_si128((__m128i*)&D[ldb * 3], _mm_unpackhi_epi64(b1, b3));
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+        uint32x4_t a0 = vld1q_u32(&S[lda * 0]);
+        uint32x4_t a1 = vld1q_u32(&S[lda * 1]);
+        uint32x4_t a2 = vld1q_u32(&S[lda * 2]);
+        uint32x4_t a3 = vld1q_u32(&S[lda * 3]);
+
+        uint32x4x2_t b01 = vtrnq_u32(a0, a1);
+        uint32x4x2_t b23 = vtrnq_u32(a2, a3);
+
+        vst1q_u32(&D[ldb * 0], vcombine_u32(vget_low_u32(b01.val[0]), vget_low_u32(b23.val[0])));
+        vst1q_u32(&D[ldb * 1], vcombine_u32(vget_low_u32(b01.val[1]), vget_low_u32(b23.val[1])));
+        vst1q_u32(&D[ldb * 2], vcombine_u32(vget_high_u32(b01.val[0]), vget_high_u32(b23.val[0])));
+        vst1q_u32(&D[ldb * 3], vcombine_u32(vget_high_u32(b01.val[1]), vget_high_u32(b23.val[1])));
+
+#else
+
+        MLAS_UNREFERENCED_PARAMETER(lda);
+        MLAS_UNREFERENCED_PARAMETER(ldb);
+
+        D[0] = S[0];
+
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint8_t>
+{
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+    static constexpr size_t BlockSize = 8;
+#else
+    static constexpr size_t BlockSize = 1;
+#endif
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint8_t* S,
+        size_t lda,
+        uint8_t* D,
+        size_t ldb
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        __m128i a0 = _mm_loadl_epi64((const __m128i*)&S[lda * 0]);
+        __m128i a1 = _mm_loadl_epi64((const __m128i*)&S[lda * 1]);
+        __m128i a2 = _mm_loadl_epi64((const __m128i*)&S[lda * 2]);
+        __m128i a3 = _mm_loadl_epi64((const __m128i*)&S[lda * 3]);
+        __m128i a4 = _mm_loadl_epi64((const __m128i*)&S[lda * 4]);
+        __m128i a5 = _mm_loadl_epi64((const __m128i*)&S[lda * 5]);
+        __m128i a6 = _mm_loadl_epi64((const __m128i*)&S[lda * 6]);
+        __m128i a7 = _mm_loadl_epi64((const __m128i*)&S[lda * 7]);
+
+        //
+        // Interleave bytes, then words, then doublewords so that each 64-bit
+        // half of the result holds one column of the block.
+        //
+
+        __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+        __m128i b1 = _mm_unpacklo_epi8(a2, a3);
+        __m128i b2 = _mm_unpacklo_epi8(a4, a5);
+        __m128i b3 = _mm_unpacklo_epi8(a6, a7);
+
+        __m128i c0 = _mm_unpacklo_epi16(b0, b1);
+        __m128i c1 = _mm_unpackhi_epi16(b0, b1);
+        __m128i c2 = _mm_unpacklo_epi16(b2, b3);
+        __m128i c3 = _mm_unpackhi_epi16(b2, b3);
+
+        __m128i d0 = _mm_unpacklo_epi32(c0, c2);
+        __m128i d1 = _mm_unpackhi_epi32(c0, c2);
+        __m128i d2 = _mm_unpacklo_epi32(c1, c3);
+        __m128i d3 = _mm_unpackhi_epi32(c1, c3);
+
+        _mm_storel_epi64((__m128i*)&D[ldb * 0], d0);
+        _mm_storel_epi64((__m128i*)&D[ldb * 1], _mm_unpackhi_epi64(d0, d0));
+        _mm_storel_epi64((__m128i*)&D[ldb * 2], d1);
+        _mm_storel_epi64((__m128i*)&D[ldb * 3], _mm_unpackhi_epi64(d1, d1));
+        _mm_storel_epi64((__m128i*)&D[ldb * 4], d2);
+        _mm_storel_epi64((__m128i*)&D[ldb * 5], _mm_unpackhi_epi64(d2, d2));
+        _mm_storel_epi64((__m128i*)&D[ldb * 6], d3);
+        _mm_storel_epi64((__m128i*)&D[ldb * 7], _mm_unpackhi_epi64(d3, d3));
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+        uint8x8_t a0 = vld1_u8(&S[lda * 0]);
+        uint8x8_t a1 = vld1_u8(&S[lda * 1]);
+        uint8x8_t a2 = vld1_u8(&S[lda * 2]);
+        uint8x8_t a3 = vld1_u8(&S[lda * 3]);
+        uint8x8_t a4 = vld1_u8(&S[lda * 4]);
+        uint8x8_t a5 = vld1_u8(&S[lda * 5]);
+        uint8x8_t a6 = vld1_u8(&S[lda * 6]);
+        uint8x8_t a7 = vld1_u8(&S[lda * 7]);
+
+        uint8x8x2_t b01 = vtrn_u8(a0, a1);
+        uint8x8x2_t b23 = vtrn_u8(a2, a3);
+        uint8x8x2_t b45 = vtrn_u8(a4, a5);
+        uint8x8x2_t b67 = vtrn_u8(a6, a7);
+
+        uint16x4x2_t c02 = vtrn_u16(vreinterpret_u16_u8(b01.val[0]), vreinterpret_u16_u8(b23.val[0]));
+        uint16x4x2_t c13 = vtrn_u16(vreinterpret_u16_u8(b01.val[1]), vreinterpret_u16_u8(b23.val[1]));
+        uint16x4x2_t c46 = vtrn_u16(vreinterpret_u16_u8(b45.val[0]), vreinterpret_u16_u8(b67.val[0]));
+        uint16x4x2_t c57 = vtrn_u16(vreinterpret_u16_u8(b45.val[1]), vreinterpret_u16_u8(b67.val[1]));
+
+        uint32x2x2_t d04 = vtrn_u32(vreinterpret_u32_u16(c02.val[0]), vreinterpret_u32_u16(c46.val[0]));
+        uint32x2x2_t d15 = vtrn_u32(vreinterpret_u32_u16(c13.val[0]), vreinterpret_u32_u16(c57.val[0]));
+        uint32x2x2_t d26 = vtrn_u32(vreinterpret_u32_u16(c02.val[1]), vreinterpret_u32_u16(c46.val[1]));
+        uint32x2x2_t d37 = vtrn_u32(vreinterpret_u32_u16(c13.val[1]), vreinterpret_u32_u16(c57.val[1]));
+
+        vst1_u8(&D[ldb * 0], vreinterpret_u8_u32(d04.val[0]));
+        vst1_u8(&D[ldb * 1], vreinterpret_u8_u32(d15.val[0]));
+        vst1_u8(&D[ldb * 2], vreinterpret_u8_u32(d26.val[0]));
+        vst1_u8(&D[ldb * 3], vreinterpret_u8_u32(d37.val[0]));
+        vst1_u8(&D[ldb * 4], vreinterpret_u8_u32(d04.val[1]));
+        vst1_u8(&D[ldb * 5], vreinterpret_u8_u32(d15.val[1]));
+        vst1_u8(&D[ldb * 6], vreinterpret_u8_u32(d26.val[1]));
+        vst1_u8(&D[ldb * 7], vreinterpret_u8_u32(d37.val[1]));
+
+#else
+
+        MLAS_UNREFERENCED_PARAMETER(lda);
+        MLAS_UNREFERENCED_PARAMETER(ldb);
+
+        D[0] = S[0];
+
+#endif
+    }
+};
+
+template<typename ElementType>
+void
+MlasTransposeTiled(
+    const ElementType* Input,
+    size_t lda,
+    ElementType* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the source matrix to the destination matrix.
+
+Arguments:
+
+    Input - Supplies the source matrix.
+
+    lda - Supplies the first dimension of the source matrix.
+
+    Output - Supplies the destination matrix.
+
+    ldb - Supplies the first dimension of the destination matrix.
+
+    M - Supplies the number of rows of the source matrix.
+
+    N - Supplies the number of columns of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_TRANSPOSE_KERNEL<ElementType>::BlockSize;
+
+    for (size_t m0 = 0; m0 < M; m0 += MLAS_TRANSPOSE_TILE_ROWS) {
+
+        const size_t TileRows = std::min(M - m0, size_t(MLAS_TRANSPOSE_TILE_ROWS));
+        const ElementType* s = Input + m0 * lda;
+        ElementType* d = Output + m0;
+
+        size_t n = 0;
+
+        for (; n + BlockSize <= N; n += BlockSize) {
+
+            size_t m = 0;
+
+            for (; m + BlockSize <= TileRows; m += BlockSize) {
+                MLAS_TRANSPOSE_KERNEL<ElementType>::Transpose(&s[m * lda + n], lda, &d[n * ldb + m], ldb);
+            }
+
+            for (; m < TileRows; m++) {
+                for (size_t j = 0; j < BlockSize; j++) {
+                    d[(n + j) * ldb + m] = s[m * lda + n + j];
+                }
+            }
+        }
+
+        for (; n < N; n++) {
+            for (size_t m = 0; m < TileRows; m++) {
+                d[n * ldb + m] = s[m * lda + n];
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of bytes.
+
+Arguments:
+
+    Input - Supplies the source matrix.
+
+    lda - Supplies the first dimension of the source matrix.
+
+    Output - Supplies the destination matrix.
+
+    ldb - Supplies the first dimension of the destination matrix.
+
+    M - Supplies the number of rows of the source matrix.
+
+    N - Supplies the number of columns of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeTiled(Input, lda, Output, ldb, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t lda,
+    uint32_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the source matrix.
+
+    lda - Supplies the first dimension of the source matrix.
+
+    Output - Supplies the destination matrix.
+
+    ldb - Supplies the first dimension of the destination matrix.
+
+    M - Supplies the number of rows of the source matrix.
+
+    N - Supplies the number of columns of the source matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeTiled(Input, lda, Output, ldb, M, N);
+}
@@ -0,0 +1,631 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    winograd.cpp
+
+Abstract:
+
+    This module implements the Winograd F(2x2, 3x3) convolution operation for
+    2D convolutions with a 3x3 kernel, unit strides and unit dilations.
+
+    Each 2x2 tile of the output is computed from a 4x4 tile of the input. The
+    input tiles and the filters are transformed so that the convolution turns
+    into 16 independent matrix multiplies, one for each element of the
+    transformed tiles, which take 16 instead of 36 multiplies per output tile
+    and channel. The transformed filters are computed once by
+    MlasConvWinogradPackFilter.
+
+    The output tiles are processed in blocks of tile rows, so the working
+    buffer only holds the transformed input and output of one block for each
+    thread instead of the expanded input of the whole image.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of elements in a transformed tile.
+//
+
+#define MLAS_WINOGRAD_TILE_ELEMENTS                 16
+
+//
+// Define the number of output tiles to target for each block of tile rows.
+//
+
+#define MLAS_WINOGRAD_TARGET_TILES_PER_BLOCK        128
+
+//
+// Define the minimum number of input channels and filters for which the
+// matrix multiplies outweigh the cost of the transforms.
+//
+
+#define MLAS_WINOGRAD_MINIMUM_CHANNELS              16
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* PackedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    size_t BlocksPerImage;
+};
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of floats required by the transformed
+    filter buffer.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of floats of the transformed filter buffer, or zero if
+    the channel counts are too small to benefit from the Winograd algorithm.
+
+--*/
+{
+    if (InputChannels < MLAS_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_WINOGRAD_MINIMUM_CHANNELS) {
+        return 0;
+    }
+
+    return GroupCount * MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filters to 4x4 tiles (G * g * G^T) and
+    stores each element of the tiles as a FilterCount by InputChannels matrix
+    for each group.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor in the layout [GroupCount *
+        FilterCount][InputChannels][3][3].
+
+    PackedFilter - Supplies the buffer to receive the transformed filters,
+        which has MlasConvWinogradPackFilterSize floats.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        float* packed = PackedFilter + group * MLAS_WINOGRAD_TILE_ELEMENTS * MatrixSize;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* g = Filter + ((group * FilterCount + f) * InputChannels + c) * 9;
+
+                float t[4][3];
+
+                for (size_t j = 0; j < 3; j++) {
+                    t[0][j] = g[j];
+                    t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+                    t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+                    t[3][j] = g[6 + j];
+                }
+
+                for (size_t i = 0; i < 4; i++) {
+
+                    float* u = packed + (i * 4) * MatrixSize + f * InputChannels + c;
+
+                    u[0] = t[i][0];
+                    u[MatrixSize] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                    u[2 * MatrixSize] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                    u[3 * MatrixSize] = t[i][2];
+                }
+            }
+        }
+    }
+}
+
+bool
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine checks whether a convolution prepared by MlasConvPrepare can
+    use the Winograd algorithm and computes the required working buffer size.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the parameters for the
+        convolution operation. The structure is updated for MlasConvWinograd
+        if the routine returns true.
+
+    WorkingBufferSize - Receives the number of floats required for the
+        working buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the convolution can use MlasConvWinograd.
+
+--*/
+{
+    if (Parameters->Dimensions != 2 ||
+        Parameters->KernelShape[0] != 3 || Parameters->KernelShape[1] != 3 ||
+        Parameters->StrideShape[0] != 1 || Parameters->StrideShape[1] != 1 ||
+        Parameters->DilationShape[0] != 1 || Parameters->DilationShape[1] != 1) {
+        return false;
+    }
+
+    if (Parameters->InputChannels < MLAS_WINOGRAD_MINIMUM_CHANNELS ||
+        Parameters->FilterCount < MLAS_WINOGRAD_MINIMUM_CHANNELS ||
+        Parameters->OutputSize == 0) {
+        return false;
+    }
+
+    const size_t TilesH = (Parameters->OutputShape[0] + 1) / 2;
+    const size_t TilesW = (Parameters->OutputShape[1] + 1) / 2;
+    const size_t BatchGroupCount = Parameters->BatchCount * Parameters->GroupCount;
+
+    //
+    // Use fewer tile rows per block if needed to give every thread a block.
+    //
+
+    const int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    size_t TileRowsPerBlock = std::max<size_t>(1, MLAS_WINOGRAD_TARGET_TILES_PER_BLOCK / TilesW);
+    size_t RowsPerThread = (TilesH * BatchGroupCount) / size_t(MaximumThreadCount);
+    TileRowsPerBlock = std::min(TileRowsPerBlock, std::max<size_t>(1, RowsPerThread));
+    TileRowsPerBlock = std::min(TileRowsPerBlock, TilesH);
+
+    const size_t BlocksPerImage = (TilesH + TileRowsPerBlock - 1) / TileRowsPerBlock;
+    const size_t TotalBlocks = BatchGroupCount * BlocksPerImage;
+
+    const size_t TilesPerBlock = TileRowsPerBlock * TilesW;
+    const size_t WorkingBufferSizePerThread = MLAS_WINOGRAD_TILE_ELEMENTS *
+        (Parameters->InputChannels + Parameters->FilterCount) * TilesPerBlock;
+
+    int32_t ThreadCount = MaximumThreadCount;
+
+    if (size_t(ThreadCount) > TotalBlocks) {
+        ThreadCount = int32_t(TotalBlocks);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = ThreadCount;
+    Parameters->u.Winograd.TileRowsPerBlock = TileRowsPerBlock;
+    Parameters->u.Winograd.WorkingBufferSizePerThread = WorkingBufferSizePerThread;
+
+    *WorkingBufferSize = size_t(ThreadCount) * WorkingBufferSizePerThread;
+
+    return true;
+}
+
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* TransformedInput,
+    size_t StartTileRow,
+    size_t TileRowCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 4x4 input tiles (B^T * d * B) for a block of
+    tile rows. Each element of the transformed tiles is stored as an
+    InputChannels by TileCount matrix.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of one image and group.
+
+    TransformedInput - Supplies the buffer to receive the transformed tiles.
+
+    StartTileRow - Supplies the first tile row of the block.
+
+    TileRowCount - Supplies the number of tile rows of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    const size_t TilesW = (Parameters->OutputShape[1] + 1) / 2;
+    const size_t TileCount = TileRowCount * TilesW;
+    const size_t MatrixSize = InputChannels * TileCount;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+        float* transformed = TransformedInput + c * TileCount;
+
+        for (size_t tr = 0; tr < TileRowCount; tr++) {
+
+            //
+            // Compute the top row of the input tile, which can be negative if
+            // the tile starts in the padding.
+            //
+
+            const ptrdiff_t ih0 = ptrdiff_t(2 * (StartTileRow + tr)) - ptrdiff_t(PaddingTop);
+
+            for (size_t tc = 0; tc < TilesW; tc++) {
+
+                const ptrdiff_t iw0 = ptrdiff_t(2 * tc) - ptrdiff_t(PaddingLeft);
+
+                float d[4][4];
+
+                if (ih0 >= 0 && size_t(ih0) + 4 <= InputHeight && iw0 >= 0 && size_t(iw0) + 4 <= InputWidth) {
+
+                    const float* row = input + size_t(ih0) * InputWidth + size_t(iw0);
+
+                    for (size_t i = 0; i < 4; i++) {
+                        d[i][0] = row[0];
+                        d[i][1] = row[1];
+                        d[i][2] = row[2];
+                        d[i][3] = row[3];
+                        row += InputWidth;
+                    }
+
+                } else {
+
+                    for (size_t i = 0; i < 4; i++) {
+
+                        const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+
+                        for (size_t j = 0; j < 4; j++) {
+
+                            const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+
+                            if (ih >= 0 && size_t(ih) < InputHeight && iw >= 0 && size_t(iw) < InputWidth) {
+                                d[i][j] = input[size_t(ih) * InputWidth + size_t(iw)];
+                            } else {
+                                d[i][j] = 0.0f;
+                            }
+                        }
+                    }
+                }
+
+                float t[4][4];
+
+                for (size_t j = 0; j < 4; j++) {
+                    t[0][j] = d[0][j] - d[2][j];
+                    t[1][j] = d[1][j] + d[2][j];
+                    t[2][j] = d[2][j] - d[1][j];
+                    t[3][j] = d[1][j] - d[3][j];
+                }
+
+                float* v = transformed + tr * TilesW + tc;
+
+                for (size_t i = 0; i < 4; i++) {
+                    v[(i * 4 + 0) * MatrixSize] = t[i][0] - t[i][2];
+                    v[(i * 4 + 1) * MatrixSize] = t[i][1] + t[i][2];
+                    v[(i * 4 + 2) * MatrixSize] = t[i][2] - t[i][1];
+                    v[(i * 4 + 3) * MatrixSize] = t[i][1] - t[i][3];
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    float* Output,
+    size_t StartTileRow,
+    size_t TileRowCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 4x4 output tiles (A^T * m * A) for a block of
+    tile rows to the 2x2 output tiles, dropping the elements that are outside
+    of the output.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransformedOutput - Supplies the output of the matrix multiplies, with
+        each element of the tiles stored as a FilterCount by TileCount matrix.
+
+    Output - Supplies the output tensor of one image and group.
+
+    StartTileRow - Supplies the first tile row of the block.
+
+    TileRowCount - Supplies the number of tile rows of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+
+    const size_t TilesW = (OutputWidth + 1) / 2;
+    const size_t TileCount = TileRowCount * TilesW;
+    const size_t MatrixSize = FilterCount * TileCount;
+
+    const float Beta = Parameters->Beta;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        const float* transformed = TransformedOutput + f * TileCount;
+        float* output = Output + f * OutputSize;
+
+        for (size_t tr = 0; tr < TileRowCount; tr++) {
+
+            const size_t oh = 2 * (StartTileRow + tr);
+
+            for (size_t tc = 0; tc < TilesW; tc++) {
+
+                const float* m = transformed + tr * TilesW + tc;
+
+                float s[2][4];
+
+                for (size_t j = 0; j < 4; j++) {
+                    const float m0 = m[(0 * 4 + j) * MatrixSize];
+                    const float m1 = m[(1 * 4 + j) * MatrixSize];
+                    const float m2 = m[(2 * 4 + j) * MatrixSize];
+                    const float m3 = m[(3 * 4 + j) * MatrixSize];
+                    s[0][j] = m0 + m1 + m2;
+                    s[1][j] = m1 - m2 - m3;
+                }
+
+                const size_t ow = 2 * tc;
+                const size_t RowCount = std::min<size_t>(2, OutputHeight - oh);
+                const size_t ColumnCount = std::min<size_t>(2, OutputWidth - ow);
+
+                for (size_t i = 0; i < RowCount; i++) {
+
+                    float* y = output + (oh + i) * OutputWidth + ow;
+
+                    for (size_t j = 0; j < ColumnCount; j++) {
+
+                        float value = (j == 0) ? s[i][0] + s[i][1] + s[i][2] :
+                            s[i][1] - s[i][2] - s[i][3];
+
+                        //
+                        // Accumulate into the existing output if requested. The
+                        // output is not read otherwise, as it may be
+                        // uninitialized.
+                        //
+
+                        if (Beta != 0.0f) {
+                            value += Beta * y[j];
+                        }
+
+                        y[j] = value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    blocks of a Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (const MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    const size_t TilesH = (Parameters->OutputShape[0] + 1) / 2;
+    const size_t TilesW = (OutputWidth + 1) / 2;
+    const size_t TileRowsPerBlock = Parameters->u.Winograd.TileRowsPerBlock;
+    const size_t BlocksPerImage = WorkBlock->BlocksPerImage;
+
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterMatrixSize = FilterCount * InputChannels;
+
+    float* TransformedInput = WorkBlock->WorkingBuffer +
+        size_t(Index) * Parameters->u.Winograd.WorkingBufferSizePerThread;
+    float* TransformedOutput = TransformedInput +
+        MLAS_WINOGRAD_TILE_ELEMENTS * InputChannels * TileRowsPerBlock * TilesW;
+
+    //
+    // Compute the range of blocks to use for this thread.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount,
+        Parameters->BatchCount * GroupCount * BlocksPerImage, &WorkIndex, &WorkRemaining);
+
+    for (size_t w = WorkIndex; w < WorkIndex + WorkRemaining; w++) {
+
+        const size_t bg = w / BlocksPerImage;
+        const size_t group = bg % GroupCount;
+        const size_t StartTileRow = (w % BlocksPerImage) * TileRowsPerBlock;
+        const size_t TileRowCount = std::min(TileRowsPerBlock, TilesH - StartTileRow);
+        const size_t TileCount = TileRowCount * TilesW;
+
+        const float* input = WorkBlock->Input + bg * InputGroupSize;
+        const float* filter = WorkBlock->PackedFilter + group * MLAS_WINOGRAD_TILE_ELEMENTS * FilterMatrixSize;
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        MlasConvWinogradTransformInput(Parameters, input, TransformedInput, StartTileRow, TileRowCount);
+
+        for (size_t e = 0; e < MLAS_WINOGRAD_TILE_ELEMENTS; e++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount,
+                InputChannels, 1.0f, filter + e * FilterMatrixSize, InputChannels,
+                TransformedInput + e * InputChannels * TileCount, TileCount, 0.0f,
+                TransformedOutput + e * FilterCount * TileCount, TileCount);
+        }
+
+        MlasConvWinogradTransformOutput(Parameters, TransformedOutput, output, StartTileRow, TileRowCount);
+
+        //
+        // Apply the activation with optional bias to the output rows of the
+        // block.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        const size_t StartRow = 2 * StartTileRow;
+        const size_t RowCount = std::min(2 * TileRowCount, Parameters->OutputShape[0] - StartRow);
+
+        MlasActivation(Parameters->Activation, output + StartRow * OutputWidth, bias,
+            FilterCount, RowCount * OutputWidth, OutputSize);
+    }
+}
+
+void
+MLASCALL
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters, as updated by MlasConvWinogradPrepare.
+
+    Input - Supplies the input tensor.
+
+    PackedFilter - Supplies the filters transformed by
+        MlasConvWinogradPackFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvWinogradPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TilesH = (Parameters->OutputShape[0] + 1) / 2;
+    const size_t TileRowsPerBlock = Parameters->u.Winograd.TileRowsPerBlock;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = PackedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.BlocksPerImage = (TilesH + TileRowsPerBlock - 1) / TileRowsPerBlock;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+}
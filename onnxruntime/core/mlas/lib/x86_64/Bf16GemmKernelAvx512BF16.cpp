@@ -0,0 +1,321 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    Bf16GemmKernelAvx512BF16.cpp
+
+Abstract:
+
+    This module implements the kernel for the bfloat16 matrix/matrix multiply
+    operation (BF16GEMM) using the AVX512-BF16 instruction set.
+
+    The kernel consumes matrix B as packed by MlasBf16GemmPackB: each block of
+    16 columns stores pairs of rows, so that every 32-bit lane holds the two
+    bfloat16 values of one column that are consumed by a single VDPBF16PS
+    step. The rows of matrix A are rounded to bfloat16 pairs in a local buffer.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the maximum number of rows from matrix A processed by the kernel.
+//
+
+#define MLAS_BF16GEMM_KERNEL_ROWS           4
+
+MLAS_FORCEINLINE
+void
+MlasBf16GemmConvertRowAvx512BF16(
+    uint32_t* D,
+    const float* A,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a row of matrix A to pairs of bfloat16 values. An odd
+    trailing element is paired with zero.
+
+Arguments:
+
+    D - Supplies the address of the destination buffer.
+
+    A - Supplies the address of the row of matrix A.
+
+    CountK - Supplies the number of elements of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountK >= 32) {
+
+        __m512bh Pairs = _mm512_cvtne2ps_pbh(_mm512_loadu_ps(A + 16), _mm512_loadu_ps(A));
+        _mm512_storeu_si512(D, (__m512i)Pairs);
+
+        A += 32;
+        D += 16;
+        CountK -= 32;
+    }
+
+    if (CountK > 0) {
+
+        __mmask16 MaskLow = __mmask16((CountK >= 16) ? 0xFFFF : (1u << CountK) - 1);
+        __mmask16 MaskHigh = __mmask16((CountK > 16) ? (1u << (CountK - 16)) - 1 : 0);
+
+        __m512bh Pairs = _mm512_cvtne2ps_pbh(_mm512_maskz_loadu_ps(MaskHigh, A + 16),
+            _mm512_maskz_loadu_ps(MaskLow, A));
+
+        __mmask16 MaskPairs = __mmask16((1u << ((CountK + 1) / 2)) - 1);
+
+        _mm512_mask_storeu_epi32(D, MaskPairs, (__m512i)Pairs);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasBf16GemmStoreVectorAvx512BF16(
+    float* C,
+    __m512 Accumulator,
+    __m512 AlphaBroadcast,
+    __mmask16 Mask,
+    bool ZeroMode
+    )
+{
+    if (ZeroMode) {
+        Accumulator = _mm512_mul_ps(Accumulator, AlphaBroadcast);
+    } else {
+        Accumulator = _mm512_fmadd_ps(Accumulator, AlphaBroadcast, _mm512_maskz_loadu_ps(Mask, C));
+    }
+
+    _mm512_mask_storeu_ps(C, Mask, Accumulator);
+}
+
+template<size_t RowCount, size_t BlockCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelBlockAvx512BF16(
+    const uint32_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t ldc,
+    size_t BlockStride,
+    __m512 AlphaBroadcast,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    fixed number of rows and up to BlockCount blocks of 16 columns.
+
+Arguments:
+
+    A - Supplies the address of the bfloat16 pairs of the rows of matrix A.
+        Each row holds MLAS_SGEMM_PACKED_STRIDEK / 2 pairs.
+
+    B - Supplies the address of the first block of the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of row pairs of matrix B to iterate over.
+
+    CountN - Supplies the number of columns of matrix C to produce. Only the
+        last block can be partial.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    BlockStride - Supplies the number of elements between the blocks of 16
+        columns of the packed matrix B.
+
+    AlphaBroadcast - Supplies the scalar alpha multiplier broadcast to a
+        vector.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t lda = MLAS_SGEMM_PACKED_STRIDEK / 2;
+
+    __m512 Accumulators[RowCount][BlockCount];
+
+    for (size_t i = 0; i < RowCount; i++) {
+        for (size_t j = 0; j < BlockCount; j++) {
+            Accumulators[i][j] = _mm512_setzero_ps();
+        }
+    }
+
+    for (size_t k = 0; k < PairCountK; k++) {
+
+        __m512bh BElements[BlockCount];
+
+        for (size_t j = 0; j < BlockCount; j++) {
+            BElements[j] = (__m512bh)_mm512_loadu_si512(B + j * BlockStride + k * 32);
+        }
+
+        for (size_t i = 0; i < RowCount; i++) {
+
+            __m512bh AElements = (__m512bh)_mm512_set1_epi32(int32_t(A[i * lda + k]));
+
+            for (size_t j = 0; j < BlockCount; j++) {
+                Accumulators[i][j] = _mm512_dpbf16_ps(Accumulators[i][j], AElements, BElements[j]);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < BlockCount; j++) {
+
+        size_t CountNThisBlock = CountN - j * 16;
+        __mmask16 Mask = __mmask16((CountNThisBlock >= 16) ? 0xFFFF : (1u << CountNThisBlock) - 1);
+
+        for (size_t i = 0; i < RowCount; i++) {
+            MlasBf16GemmStoreVectorAvx512BF16(C + i * ldc + j * 16, Accumulators[i][j],
+                AlphaBroadcast, Mask, ZeroMode);
+        }
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelRowsAvx512BF16(
+    const uint32_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t ldc,
+    __m512 AlphaBroadcast,
+    bool ZeroMode
+    )
+{
+    const size_t BlockStride = PairCountK * 32;
+
+    while (CountN > 48) {
+
+        size_t CountNThisBlock = (CountN < 64) ? CountN : 64;
+
+        MlasBf16GemmKernelBlockAvx512BF16<RowCount, 4>(A, B, C, PairCountK,
+            CountNThisBlock, ldc, BlockStride, AlphaBroadcast, ZeroMode);
+
+        B += 4 * BlockStride;
+        C += CountNThisBlock;
+        CountN -= CountNThisBlock;
+    }
+
+    if (CountN > 32) {
+        MlasBf16GemmKernelBlockAvx512BF16<RowCount, 3>(A, B, C, PairCountK,
+            CountN, ldc, BlockStride, AlphaBroadcast, ZeroMode);
+    } else if (CountN > 16) {
+        MlasBf16GemmKernelBlockAvx512BF16<RowCount, 2>(A, B, C, PairCountK,
+            CountN, ldc, BlockStride, AlphaBroadcast, ZeroMode);
+    } else if (CountN > 0) {
+        MlasBf16GemmKernelBlockAvx512BF16<RowCount, 1>(A, B, C, PairCountK,
+            CountN, ldc, BlockStride, AlphaBroadcast, ZeroMode);
+    }
+}
+
+size_t
+MLASCALL
+MlasBf16GemmKernelAvx512BF16(
+    const float* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of a panel of matrix B packed by
+        MlasBf16GemmPackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of
+        rows from matrix B to iterate over. The value must not exceed
+        MLAS_SGEMM_PACKED_STRIDEK.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelA[MLAS_BF16GEMM_KERNEL_ROWS * MLAS_SGEMM_PACKED_STRIDEK / 2], 64);
+
+    size_t RowCount = (CountM < MLAS_BF16GEMM_KERNEL_ROWS) ? CountM : MLAS_BF16GEMM_KERNEL_ROWS;
+
+    for (size_t i = 0; i < RowCount; i++) {
+        MlasBf16GemmConvertRowAvx512BF16(&PanelA[i * MLAS_SGEMM_PACKED_STRIDEK / 2], A + i * lda, CountK);
+    }
+
+    const size_t PairCountK = (CountK + 1) / 2;
+    const __m512 AlphaBroadcast = _mm512_set1_ps(alpha);
+
+    switch (RowCount) {
+
+        case 4:
+            MlasBf16GemmKernelRowsAvx512BF16<4>(PanelA, B, C, PairCountK, CountN, ldc, AlphaBroadcast, ZeroMode);
+            break;
+
+        case 3:
+            MlasBf16GemmKernelRowsAvx512BF16<3>(PanelA, B, C, PairCountK, CountN, ldc, AlphaBroadcast, ZeroMode);
+            break;
+
+        case 2:
+            MlasBf16GemmKernelRowsAvx512BF16<2>(PanelA, B, C, PairCountK, CountN, ldc, AlphaBroadcast, ZeroMode);
+            break;
+
+        default:
+            MlasBf16GemmKernelRowsAvx512BF16<1>(PanelA, B, C, PairCountK, CountN, ldc, AlphaBroadcast, ZeroMode);
+            break;
+    }
+
+    return RowCount;
+}
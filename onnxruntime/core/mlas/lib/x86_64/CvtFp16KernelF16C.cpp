@@ -0,0 +1,146 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    CvtFp16KernelF16C.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between the half precision
+    and single precision float formats using the F16C instruction set.
+
+    The trailing elements that do not fill a vector are staged through a
+    local buffer so that the kernels never access memory outside the caller's
+    buffers.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision floats to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m128i Half0 = _mm_loadu_si128((const __m128i*)Source);
+        __m128i Half1 = _mm_loadu_si128((const __m128i*)(Source + 8));
+
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(Half0));
+        _mm256_storeu_ps(Destination + 8, _mm256_cvtph_ps(Half1));
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+
+        __m128i Half = _mm_loadu_si128((const __m128i*)Source);
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(Half));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        MLAS_DECLSPEC_ALIGN(unsigned short HalfBuffer[8], 16) = { 0 };
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32);
+
+        std::copy_n(Source, Count, HalfBuffer);
+        _mm256_store_ps(FloatBuffer, _mm256_cvtph_ps(_mm_load_si128((const __m128i*)HalfBuffer)));
+        std::copy_n(FloatBuffer, Count, Destination);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of half precision floats, rounding to nearest even.
+
+Arguments:
+
+    Source - Supplies the address of the source buffer.
+
+    Destination - Supplies the address of the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 16) {
+
+        __m128i Half0 = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m128i Half1 = _mm256_cvtps_ph(_mm256_loadu_ps(Source + 8), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128((__m128i*)Destination, Half0);
+        _mm_storeu_si128((__m128i*)(Destination + 8), Half1);
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    if (Count >= 8) {
+
+        __m128i Half = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)Destination, Half);
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32) = { 0 };
+        MLAS_DECLSPEC_ALIGN(unsigned short HalfBuffer[8], 16);
+
+        std::copy_n(Source, Count, FloatBuffer);
+        _mm_store_si128((__m128i*)HalfBuffer, _mm256_cvtps_ph(_mm256_load_ps(FloatBuffer), _MM_FROUND_TO_NEAREST_INT));
+        std::copy_n(HalfBuffer, Count, Destination);
+    }
+}
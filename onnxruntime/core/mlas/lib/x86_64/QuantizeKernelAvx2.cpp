@@ -0,0 +1,251 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    QuantizeKernelAvx2.cpp
+
+Abstract:
+
+    This module implements the kernels to quantize and dequantize buffers
+    using the AVX2 instruction set.
+
+    The kernels produce the same results as the SSE2 kernels. The trailing
+    elements that do not fill a vector are staged through a local buffer so
+    that the kernels never access memory outside the caller's buffers.
+
+--*/
+
+#include "mlasi.h"
+
+template<typename OutputType>
+__m128i
+MlasQuantizeLinearPackBytesAvx2(
+    __m256i IntegerVector0,
+    __m256i IntegerVector1
+    );
+
+template<>
+MLAS_FORCEINLINE
+__m128i
+MlasQuantizeLinearPackBytesAvx2<uint8_t>(
+    __m256i IntegerVector0,
+    __m256i IntegerVector1
+    )
+{
+    __m256i WordVector = _mm256_packs_epi32(IntegerVector0, IntegerVector1);
+    __m256i ByteVector = _mm256_packus_epi16(WordVector, WordVector);
+
+    //
+    // The packing instructions operate on each 128-bit lane, so gather the
+    // groups of four bytes back into the order of the input.
+    //
+
+    ByteVector = _mm256_permutevar8x32_epi32(ByteVector, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+    return _mm256_castsi256_si128(ByteVector);
+}
+
+template<>
+MLAS_FORCEINLINE
+__m128i
+MlasQuantizeLinearPackBytesAvx2<int8_t>(
+    __m256i IntegerVector0,
+    __m256i IntegerVector1
+    )
+{
+    __m256i WordVector = _mm256_packs_epi32(IntegerVector0, IntegerVector1);
+    __m256i ByteVector = _mm256_packs_epi16(WordVector, WordVector);
+
+    ByteVector = _mm256_permutevar8x32_epi32(ByteVector, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+    return _mm256_castsi256_si128(ByteVector);
+}
+
+template<typename OutputType, int32_t MinimumValue, int32_t MaximumValue>
+void
+MlasQuantizeLinearKernelAvx2(
+    const float* Input,
+    OutputType* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    const __m256 ScaleVector = _mm256_set1_ps(Scale);
+    const __m256 MinimumValueVector = _mm256_set1_ps(float(MinimumValue - ZeroPoint));
+    const __m256 MaximumValueVector = _mm256_set1_ps(float(MaximumValue - ZeroPoint));
+    const __m256i ZeroPointVector = _mm256_set1_epi32(ZeroPoint);
+
+    auto QuantizeVector = [&](const float* Buffer) {
+
+        __m256 FloatVector0 = _mm256_div_ps(_mm256_loadu_ps(Buffer), ScaleVector);
+        __m256 FloatVector1 = _mm256_div_ps(_mm256_loadu_ps(Buffer + 8), ScaleVector);
+
+        // N.B. VMAXPS and VMINPS return the value from the second vector if
+        // the value from the first vector is a NaN.
+        FloatVector0 = _mm256_min_ps(_mm256_max_ps(FloatVector0, MinimumValueVector), MaximumValueVector);
+        FloatVector1 = _mm256_min_ps(_mm256_max_ps(FloatVector1, MinimumValueVector), MaximumValueVector);
+
+        // N.B. Assumes MXCSR has been configured with the default rounding
+        // mode of "round to nearest even".
+        __m256i IntegerVector0 = _mm256_add_epi32(_mm256_cvtps_epi32(FloatVector0), ZeroPointVector);
+        __m256i IntegerVector1 = _mm256_add_epi32(_mm256_cvtps_epi32(FloatVector1), ZeroPointVector);
+
+        return MlasQuantizeLinearPackBytesAvx2<OutputType>(IntegerVector0, IntegerVector1);
+    };
+
+    while (N >= 16) {
+
+        _mm_storeu_si128((__m128i*)Output, QuantizeVector(Input));
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[16], 32) = { 0 };
+        MLAS_DECLSPEC_ALIGN(OutputType ByteBuffer[16], 16);
+
+        std::copy_n(Input, N, FloatBuffer);
+        _mm_store_si128((__m128i*)ByteBuffer, QuantizeVector(FloatBuffer));
+        std::copy_n(ByteBuffer, N, Output);
+    }
+}
+
+template<typename InputType>
+__m256i
+MlasDequantizeLinearUnpackBytesAvx2(
+    const InputType* Input
+    );
+
+template<>
+MLAS_FORCEINLINE
+__m256i
+MlasDequantizeLinearUnpackBytesAvx2<uint8_t>(
+    const uint8_t* Input
+    )
+{
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)Input));
+}
+
+template<>
+MLAS_FORCEINLINE
+__m256i
+MlasDequantizeLinearUnpackBytesAvx2<int8_t>(
+    const int8_t* Input
+    )
+{
+    return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)Input));
+}
+
+template<typename InputType>
+void
+MlasDequantizeLinearKernelAvx2(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    const __m256 ScaleVector = _mm256_set1_ps(Scale);
+    const __m256i ZeroPointVector = _mm256_set1_epi32(ZeroPoint);
+
+    auto DequantizeVector = [&](const InputType* Buffer) {
+
+        __m256i IntegerVector = MlasDequantizeLinearUnpackBytesAvx2<InputType>(Buffer);
+        IntegerVector = _mm256_sub_epi32(IntegerVector, ZeroPointVector);
+
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(IntegerVector), ScaleVector);
+    };
+
+    while (N >= 16) {
+
+        __m256 FloatVector0 = DequantizeVector(Input);
+        __m256 FloatVector1 = DequantizeVector(Input + 8);
+
+        _mm256_storeu_ps(Output, FloatVector0);
+        _mm256_storeu_ps(Output + 8, FloatVector1);
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    if (N >= 8) {
+
+        _mm256_storeu_ps(Output, DequantizeVector(Input));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(InputType ByteBuffer[8], 8) = { 0 };
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32);
+
+        std::copy_n(Input, N, ByteBuffer);
+        _mm256_store_ps(FloatBuffer, DequantizeVector(ByteBuffer));
+        std::copy_n(FloatBuffer, N, Output);
+    }
+}
+
+void
+MLASCALL
+MlasQuantizeLinearU8KernelAvx2(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernelAvx2<uint8_t, 0, 255>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasQuantizeLinearS8KernelAvx2(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernelAvx2<int8_t, -127, 127>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearU8KernelAvx2(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernelAvx2<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearS8KernelAvx2(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernelAvx2<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
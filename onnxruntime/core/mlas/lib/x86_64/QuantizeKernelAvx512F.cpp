@@ -0,0 +1,233 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    QuantizeKernelAvx512F.cpp
+
+Abstract:
+
+    This module implements the kernels to quantize and dequantize buffers
+    using the AVX512F instruction set.
+
+    The kernels produce the same results as the SSE2 kernels. The trailing
+    elements that do not fill a vector are handled with masked loads and
+    stores so that the kernels never access memory outside the caller's
+    buffers.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// GCC 12 reports the _mm512_undefined_* placeholder that intrinsics such as
+// _mm512_max_ps and _mm512_cvtepi32_epi8 pass as the unused source operand as
+// possibly uninitialized. The operand is never read by the unmasked forms, so
+// the warning is a false positive (GCC bug 105593) and is disabled for the
+// kernels below.
+//
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+template<typename OutputType, int32_t MinimumValue, int32_t MaximumValue>
+void
+MlasQuantizeLinearKernelAvx512F(
+    const float* Input,
+    OutputType* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    const __m512 ScaleVector = _mm512_set1_ps(Scale);
+    const __m512 MinimumValueVector = _mm512_set1_ps(float(MinimumValue - ZeroPoint));
+    const __m512 MaximumValueVector = _mm512_set1_ps(float(MaximumValue - ZeroPoint));
+    const __m512i ZeroPointVector = _mm512_set1_epi32(ZeroPoint);
+
+    auto QuantizeVector = [&](__m512 FloatVector) {
+
+        FloatVector = _mm512_div_ps(FloatVector, ScaleVector);
+
+        // N.B. VMAXPS and VMINPS return the value from the second vector if
+        // the value from the first vector is a NaN.
+        FloatVector = _mm512_min_ps(_mm512_max_ps(FloatVector, MinimumValueVector), MaximumValueVector);
+
+        // N.B. Assumes MXCSR has been configured with the default rounding
+        // mode of "round to nearest even". The values are in the range of
+        // the output type, so truncating the elements to bytes is exact.
+        return _mm512_add_epi32(_mm512_cvtps_epi32(FloatVector), ZeroPointVector);
+    };
+
+    while (N >= 32) {
+
+        __m512i IntegerVector0 = QuantizeVector(_mm512_loadu_ps(Input));
+        __m512i IntegerVector1 = QuantizeVector(_mm512_loadu_ps(Input + 16));
+
+        _mm_storeu_si128((__m128i*)Output, _mm512_cvtepi32_epi8(IntegerVector0));
+        _mm_storeu_si128((__m128i*)(Output + 16), _mm512_cvtepi32_epi8(IntegerVector1));
+
+        Input += 32;
+        Output += 32;
+        N -= 32;
+    }
+
+    while (N > 0) {
+
+        const size_t Count = std::min(N, size_t(16));
+        const __mmask16 Mask = __mmask16((1u << Count) - 1);
+
+        __m512i IntegerVector = QuantizeVector(_mm512_maskz_loadu_ps(Mask, Input));
+        _mm512_mask_cvtepi32_storeu_epi8(Output, Mask, IntegerVector);
+
+        Input += Count;
+        Output += Count;
+        N -= Count;
+    }
+}
+
+template<typename InputType>
+__m512i
+MlasDequantizeLinearUnpackBytesAvx512F(
+    __m128i ByteVector
+    );
+
+template<>
+MLAS_FORCEINLINE
+__m512i
+MlasDequantizeLinearUnpackBytesAvx512F<uint8_t>(
+    __m128i ByteVector
+    )
+{
+    return _mm512_cvtepu8_epi32(ByteVector);
+}
+
+template<>
+MLAS_FORCEINLINE
+__m512i
+MlasDequantizeLinearUnpackBytesAvx512F<int8_t>(
+    __m128i ByteVector
+    )
+{
+    return _mm512_cvtepi8_epi32(ByteVector);
+}
+
+template<typename InputType>
+void
+MlasDequantizeLinearKernelAvx512F(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int32_t ZeroPoint
+    )
+{
+    const __m512 ScaleVector = _mm512_set1_ps(Scale);
+    const __m512i ZeroPointVector = _mm512_set1_epi32(ZeroPoint);
+
+    auto DequantizeVector = [&](__m128i ByteVector) {
+
+        __m512i IntegerVector = MlasDequantizeLinearUnpackBytesAvx512F<InputType>(ByteVector);
+        IntegerVector = _mm512_sub_epi32(IntegerVector, ZeroPointVector);
+
+        return _mm512_mul_ps(_mm512_cvtepi32_ps(IntegerVector), ScaleVector);
+    };
+
+    while (N >= 32) {
+
+        __m512 FloatVector0 = DequantizeVector(_mm_loadu_si128((const __m128i*)Input));
+        __m512 FloatVector1 = DequantizeVector(_mm_loadu_si128((const __m128i*)(Input + 16)));
+
+        _mm512_storeu_ps(Output, FloatVector0);
+        _mm512_storeu_ps(Output + 16, FloatVector1);
+
+        Input += 32;
+        Output += 32;
+        N -= 32;
+    }
+
+    if (N >= 16) {
+
+        _mm512_storeu_ps(Output, DequantizeVector(_mm_loadu_si128((const __m128i*)Input)));
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+
+        //
+        // Masked byte loads require AVX512BW, so stage the trailing bytes
+        // through a local buffer.
+        //
+
+        MLAS_DECLSPEC_ALIGN(InputType ByteBuffer[16], 16) = { 0 };
+        const __mmask16 Mask = __mmask16((1u << N) - 1);
+
+        std::copy_n(Input, N, ByteBuffer);
+        _mm512_mask_storeu_ps(Output, Mask, DequantizeVector(_mm_load_si128((const __m128i*)ByteBuffer)));
+    }
+}
+
+void
+MLASCALL
+MlasQuantizeLinearU8KernelAvx512F(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernelAvx512F<uint8_t, 0, 255>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasQuantizeLinearS8KernelAvx512F(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasQuantizeLinearKernelAvx512F<int8_t, -127, 127>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearU8KernelAvx512F(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernelAvx512F<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinearS8KernelAvx512F(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+{
+    MlasDequantizeLinearKernelAvx512F<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/activation_offload.h"
+
+#include <algorithm>
+
+#include "core/framework/data_types.h"
+#include "core/framework/kernel_registry.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the size of the tensor if its shape is static, or 0.
+static size_t StaticTensorBytes(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || shape == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() == TensorProto_DataType_STRING) {
+    return 0;
+  }
+
+  const auto* tensor_type = DataTypeImpl::TypeFromProto(*type)->AsTensorType();
+  if (tensor_type == nullptr) {
+    return 0;
+  }
+
+  size_t bytes = tensor_type->GetElementType()->Size();
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return 0;
+    }
+    bytes *= static_cast<size_t>(dim.dim_value());
+  }
+  return bytes;
+}
+
+namespace {
+// A use of an activation: the consumer node, the input index and the position of the consumer in the order.
+struct ActivationUse {
+  Node* node;
+  int input_index;
+  size_t position;
+};
+}  // namespace
+
+Status ActivationOffloadTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                               const logging::Logger& logger) const {
+  // the subgraphs are executed as part of their parent node, so their order isn't known here
+  ORT_UNUSED_PARAMETER(graph_level);
+  ORT_UNUSED_PARAMETER(logger);
+  if (graph.IsSubgraph()) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  std::unordered_map<NodeIndex, size_t> position;
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+
+  const auto& graph_outputs = graph.GetOutputs();
+
+  for (size_t producer_position = 0; producer_position < order.size(); ++producer_position) {
+    Node* producer = graph.GetNode(order[producer_position]);
+    if (producer == nullptr || producer->GetExecutionProviderType() != kCudaExecutionProvider ||
+        producer->OpType() == "MemcpyToHost" || producer->OpType() == "MemcpyFromHost") {
+      continue;
+    }
+
+    const KernelCreateInfo* producer_kci = nullptr;
+    registry_manager_.get().SearchKernelRegistry(*producer, &producer_kci);
+
+    const auto& output_defs = producer->OutputDefs();
+    for (int output_index = 0; output_index < static_cast<int>(output_defs.size()); ++output_index) {
+      NodeArg* activation = output_defs[output_index];
+      if (!activation->Exists() || StaticTensorBytes(*activation) < std::max<size_t>(min_bytes_, 1) ||
+          (producer_kci && producer_kci->kernel_def->IsOutputOnCpu(output_index)) ||
+          std::find(graph_outputs.cbegin(), graph_outputs.cend(), activation) != graph_outputs.cend()) {
+        continue;
+      }
+
+      // only offload activations that all the consumers read from device memory as explicit inputs
+      std::vector<ActivationUse> uses;
+      bool can_offload = true;
+      for (auto it = producer->OutputEdgesBegin(); can_offload && it != producer->OutputEdgesEnd(); ++it) {
+        if (it->GetSrcArgIndex() != output_index) {
+          continue;
+        }
+        Node* consumer = graph.GetNode(it->GetNode().Index());
+        const KernelCreateInfo* consumer_kci = nullptr;
+        registry_manager_.get().SearchKernelRegistry(*consumer, &consumer_kci);
+        can_offload = consumer->GetExecutionProviderType() == kCudaExecutionProvider &&
+                      it->GetDstArgIndex() < static_cast<int>(consumer->InputDefs().size()) &&
+                      !(consumer_kci && consumer_kci->kernel_def->IsInputOnCpu(it->GetDstArgIndex()));
+        uses.push_back({consumer, it->GetDstArgIndex(), position[consumer->Index()]});
+      }
+      if (!can_offload || uses.empty()) {
+        continue;
+      }
+
+      // split the uses at the largest gap in the execution order
+      std::sort(uses.begin(), uses.end(), [](const ActivationUse& lhs, const ActivationUse& rhs) {
+        return lhs.position < rhs.position;
+      });
+      size_t split = 0;
+      size_t largest_gap = 0;
+      size_t last_position = producer_position;
+      for (size_t i = 0; i < uses.size(); ++i) {
+        if (uses[i].position - last_position > largest_gap) {
+          largest_gap = uses[i].position - last_position;
+          split = i;
+        }
+        last_position = uses[i].position;
+      }
+      if (largest_gap <= min_distance_) {
+        continue;
+      }
+
+      const size_t last_early_position = split == 0 ? producer_position : uses[split - 1].position;
+
+      auto& host_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation->Name() + "_host"),
+                                                activation->TypeAsProto());
+      auto& device_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation->Name() + "_prefetch"),
+                                                  activation->TypeAsProto());
+
+      Node& to_host = graph.AddNode(graph.GenerateNodeName("Memcpy"), "MemcpyToHost",
+                                    "Offload a long-lived activation to host memory",
+                                    std::vector<NodeArg*>{activation}, std::vector<NodeArg*>{&host_arg});
+      to_host.SetExecutionProviderType(kCudaExecutionProvider);
+      Node& from_host = graph.AddNode(graph.GenerateNodeName("Memcpy"), "MemcpyFromHost",
+                                      "Prefetch an offloaded activation from host memory",
+                                      std::vector<NodeArg*>{&host_arg}, std::vector<NodeArg*>{&device_arg});
+      from_host.SetExecutionProviderType(kCudaExecutionProvider);
+
+      graph.AddEdge(producer->Index(), to_host.Index(), output_index, 0);
+      graph.AddEdge(to_host.Index(), from_host.Index(), 0, 0);
+
+      for (size_t i = split; i < uses.size(); ++i) {
+        graph.RemoveEdge(producer->Index(), uses[i].node->Index(), output_index, uses[i].input_index);
+        graph_utils::ReplaceNodeInput(*uses[i].node, uses[i].input_index, device_arg);
+        graph.AddEdge(from_host.Index(), uses[i].node->Index(), 0, uses[i].input_index);
+      }
+
+      // Run the copy to host before the node that follows the early uses, so the device buffer can be released
+      // then instead of before the late uses. The node is later in the order than the producer, so this does not
+      // create a cycle.
+      if (last_early_position + 1 < order.size()) {
+        graph.AddControlEdge(to_host.Index(), order[last_early_position + 1]);
+      }
+
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ActivationOffloadTransformer
+
+Transformer that spills long-lived activations of CUDA nodes to host memory, to reduce the peak device memory.
+
+An activation of at least min_bytes whose uses are separated by more than min_distance nodes in the execution order
+is copied to host memory by a MemcpyToHost node after its early uses, and copied back by a MemcpyFromHost node that
+the late uses consume instead. The device buffer can then be freed or reused in between.
+The MemcpyToHost outputs are allocated in the pinned host memory of the CUDA execution provider.
+
+This runs after the MemcpyTransformer, once all the nodes are assigned to execution providers.
+*/
+class ActivationOffloadTransformer : public GraphTransformer {
+ public:
+  ActivationOffloadTransformer(const KernelRegistryManager& registry_manager, size_t min_bytes,
+                               size_t min_distance = 16)
+      : GraphTransformer("ActivationOffloadTransformer"),
+        registry_manager_(std::cref(registry_manager)),
+        min_bytes_(min_bytes),
+        min_distance_(min_distance) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  std::reference_wrapper<const KernelRegistryManager> registry_manager_;
+  const size_t min_bytes_;
+  const size_t min_distance_;
+};
+
+}  // namespace onnxruntime
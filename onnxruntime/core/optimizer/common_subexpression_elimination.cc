@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+#include <climits>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// control edges order the execution of a node, so they would have to be merged as well
+static bool HasControlEdges(const Node& node) {
+  return !node.ControlInputs().empty() ||
+         std::any_of(node.OutputEdgesBegin(), node.OutputEdgesEnd(),
+                     [](const Node::EdgeEnd& edge) { return edge.GetSrcArgIndex() == INT_MAX; });
+}
+
+static size_t HashNode(const Node& node) {
+  size_t hash = std::hash<std::string>{}(node.OpType());
+  HashCombine(hash, std::hash<std::string>{}(node.Domain()));
+  for (const auto* input_def : node.InputDefs()) {
+    HashCombine(hash, std::hash<const NodeArg*>{}(input_def));
+  }
+  // the attributes are stored in an unordered map, so combine the hashes of the names in an order independent way
+  size_t attributes_hash = 0;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes_hash ^= std::hash<std::string>{}(attribute.first);
+  }
+  HashCombine(hash, attributes_hash);
+  return hash;
+}
+
+static bool AreEquivalent(const Node& lhs, const Node& rhs) {
+  if (lhs.OpType() != rhs.OpType() ||
+      lhs.Domain() != rhs.Domain() ||
+      lhs.Op() != rhs.Op() ||
+      lhs.GetExecutionProviderType() != rhs.GetExecutionProviderType() ||
+      lhs.InputDefs() != rhs.InputDefs() ||
+      lhs.InputArgCount() != rhs.InputArgCount()) {
+    return false;
+  }
+
+  // optional outputs must be produced by both nodes or by neither
+  const auto& lhs_outputs = lhs.OutputDefs();
+  const auto& rhs_outputs = rhs.OutputDefs();
+  if (lhs_outputs.size() != rhs_outputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs_outputs.size(); ++i) {
+    if (lhs_outputs[i]->Exists() != rhs_outputs[i]->Exists()) {
+      return false;
+    }
+  }
+
+  const auto& lhs_attributes = lhs.GetAttributes();
+  const auto& rhs_attributes = rhs.GetAttributes();
+  if (lhs_attributes.size() != rhs_attributes.size()) {
+    return false;
+  }
+  for (const auto& lhs_attribute : lhs_attributes) {
+    auto rhs_attribute = rhs_attributes.find(lhs_attribute.first);
+    if (rhs_attribute == rhs_attributes.cend() ||
+        lhs_attribute.second.SerializeAsString() != rhs_attribute->second.SerializeAsString()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                 const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the nodes kept so far, bucketed by their hash
+  std::unordered_map<size_t, std::vector<Node*>> kept_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    // the subgraphs of two nodes are not compared, and the values produced by non-deterministic nodes differ
+    if (node.ContainsSubgraph() || HasControlEdges(node) ||
+        excluded_op_types_.find(node.OpType()) != excluded_op_types_.end() ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    auto& candidates = kept_nodes[HashNode(node)];
+    auto equivalent = std::find_if(candidates.cbegin(), candidates.cend(),
+                                   [&node](const Node* candidate) { return AreEquivalent(*candidate, node); });
+
+    // the outputs of the node must keep being produced under their names if they are graph outputs
+    if (equivalent == candidates.cend() || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+      candidates.push_back(&node);
+      continue;
+    }
+
+    Node& replacement = **equivalent;
+    for (int i = 0, end = static_cast<int>(node.OutputDefs().size()); i < end; ++i) {
+      graph_utils::ReplaceDownstreamNodeInput(graph, node, i, replacement, i);
+    }
+
+    graph.RemoveNode(node.Index());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/optimizer/constant_folding.h"
 #include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
@@ -11,6 +12,83 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+// Replace a Gather node that selects dimensions from the output of a Shape node with an initializer, if all the
+// selected dimensions of the Shape input are known. The other dimensions can be symbolic.
+static bool FoldShapeGather(Graph& graph, Node& node, const logging::Logger& logger) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11})) {
+    return false;
+  }
+
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr != nullptr && axis_attr->i() != 0) {
+    return false;
+  }
+
+  const Node* shape_node = graph_utils::GetInputNode(node, 0);
+  if (shape_node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*shape_node, "Shape", {1})) {
+    return false;
+  }
+
+  const auto* input_shape = shape_node->InputDefs()[0]->Shape();
+  const auto* indices_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+  if (input_shape == nullptr || indices_proto == nullptr ||
+      (indices_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT32 &&
+       indices_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64)) {
+    return false;
+  }
+
+  Initializer indices(*indices_proto);
+  const int64_t rank = input_shape->dim_size();
+  std::vector<int64_t> dim_values;
+  dim_values.reserve(static_cast<size_t>(indices.size()));
+  for (int64_t i = 0; i < indices.size(); i++) {
+    int64_t index = indices_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT32
+                        ? static_cast<int64_t>(indices.data<int32_t>()[i])
+                        : indices.data<int64_t>()[i];
+    if (index < 0) {
+      index += rank;
+    }
+    if (index < 0 || index >= rank) {
+      return false;
+    }
+
+    const auto& dim = input_shape->dim(static_cast<int>(index));
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return false;
+    }
+    dim_values.push_back(dim.dim_value());
+  }
+
+  // we're going to create an initializer with the same name as the node output
+  const auto& new_initializer_name = node.OutputDefs()[0]->Name();
+  if (!graph_utils::CanReplaceNodeWithInitializer(graph, node, new_initializer_name, logger)) {
+    return false;
+  }
+
+  ONNX_NAMESPACE::TensorProto dims_initializer_proto;
+  dims_initializer_proto.set_name(new_initializer_name);
+  for (const auto dim : indices.dims()) {
+    dims_initializer_proto.add_dims(dim);
+  }
+  dims_initializer_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  // Here we expect little-endian format to set raw data of the TensorProto.
+  dims_initializer_proto.set_raw_data(dim_values.data(), dim_values.size() * sizeof(int64_t));
+
+  auto& new_node_arg = graph_utils::AddInitializer(graph, dims_initializer_proto);
+  NodeIndex shape_node_index = shape_node->Index();
+  graph_utils::ReplaceNodeWithInitializer(graph, node, new_node_arg);
+
+  // remove the Shape node once the last of its consumers is folded
+  Node& mutable_shape_node = *graph.GetNode(shape_node_index);
+  if (mutable_shape_node.GetOutputEdgesCount() == 0 &&
+      graph.GetNodeOutputsInGraphOutputs(mutable_shape_node).empty()) {
+    graph.RemoveNode(shape_node_index);
+  }
+
+  return true;
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -23,6 +101,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
 
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
 
+    if (graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) &&
+        FoldShapeGather(graph, *node, logger)) {
+      modified = true;
+      continue;
+    }
+
     InitializedTensorSet constant_inputs;
 
     // we currently constant fold using the CPU EP only.
@@ -78,16 +162,28 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
     // Go over all output node args and substitute them with the newly computed tensors, which will be
     // added to the graph as initializers.
     ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-    bool unsupported_output_type = false;
-    for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-      OrtValue& ort_value = fetches[fetch_idx];
-
+    bool can_fold = true;
+    for (const OrtValue& ort_value : fetches) {
       if (!ort_value.IsTensor()) {
         LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
                               << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-        unsupported_output_type = true;
+        can_fold = false;
+        break;
+      }
+
+      if (max_output_bytes_ != 0 && ort_value.Get<Tensor>().SizeInBytes() > max_output_bytes_) {
+        LOGS(logger, INFO) << "Output of " << node->OpType() << " node '" << node->Name() << "' is larger than "
+                           << max_output_bytes_ << " bytes. Not constant folding it.";
+        can_fold = false;
         break;
       }
+    }
+
+    if (!can_fold)
+      continue;
+
+    for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+      OrtValue& ort_value = fetches[fetch_idx];
 
       // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
       const auto* constant_arg_out = node->OutputDefs()[fetch_idx];
@@ -99,9 +195,6 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       graph.AddInitializedTensor(out_tensorproto);
     }
 
-    if (unsupported_output_type)
-      continue;
-
     // Remove the output edges of the constant node and then remove the node itself.
     graph_utils::RemoveNodeOutputEdges(graph, *node);
     graph.RemoveNode(node->Index());
@@ -13,11 +13,19 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+Gather nodes that select dimensions from the output of a Shape node are also folded when the selected dimensions
+are statically known, even if other dimensions of the Shape input are symbolic. This allows the shape computations
+(Shape -> Gather -> Unsqueeze -> Concat -> Reshape) of models with a free batch dimension to be folded.
+
+If max_output_bytes is not 0, nodes with outputs larger than max_output_bytes are not folded, so that
+constant folding of nodes like Tile or Expand does not blow up the size of the model.
 */
 class ConstantFolding : public GraphTransformer {
  public:
-  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
-      : GraphTransformer("ConstantFolding", compatible_execution_providers) {}
+  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                  size_t max_output_bytes = 0) noexcept
+      : GraphTransformer("ConstantFolding", compatible_execution_providers), max_output_bytes_(max_output_bytes) {}
 
  private:
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
@@ -25,6 +33,8 @@ class ConstantFolding : public GraphTransformer {
   const std::unordered_set<std::string> excluded_op_types_ =
       {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
 
+  const size_t max_output_bytes_;
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 };
 
@@ -70,6 +70,70 @@ static bool GetClipConstantMinMax(const Graph& graph, const Node& node, float& m
   return min_max_are_constant_values;
 }
 
+// Test if this is an activation that can be fused and also extract the activation's parameters.
+static bool GetFusedActivation(const Graph& graph, const Node& node, std::vector<float>& activation_params) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6})) {
+    activation_params.push_back(graph_utils::GetNodeAttribute(node, "alpha")->f());
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11})) {
+    float min, max;
+    if (GetClipConstantMinMax(graph, node, min, max)) {
+      activation_params.push_back(min);
+      activation_params.push_back(max);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool HaveSameKnownShape(const NodeArg& arg1, const NodeArg& arg2) {
+  const auto* shape1 = arg1.Shape();
+  const auto* shape2 = arg2.Shape();
+  if (shape1 == nullptr || shape2 == nullptr || shape1->dim_size() != shape2->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape1->dim_size(); i++) {
+    const auto& dim1 = shape1->dim(i);
+    const auto& dim2 = shape2->dim(i);
+    if (!dim1.has_dim_value() || !dim2.has_dim_value() || dim1.dim_value() != dim2.dim_value()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Returns the input index of the residual tensor if add_node sums the output of conv_node with another tensor of the
+// same shape, else -1. The residual tensor is then summed into the output of the convolution by FusedConv.
+static int GetResidualInputIndex(const Node& conv_node, const Node& add_node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7})) {
+    return -1;
+  }
+
+  const auto& add_inputs = add_node.InputDefs();
+  const NodeArg* conv_output = conv_node.OutputDefs()[0];
+  if (add_inputs.size() != 2 || add_inputs[0] == add_inputs[1]) {
+    return -1;
+  }
+
+  const int residual_index = add_inputs[0] == conv_output ? 1 : 0;
+  if (!HaveSameKnownShape(*conv_output, *add_inputs[residual_index])) {
+    return -1;
+  }
+
+  return residual_index;
+}
+
 }  // namespace
 
 Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -100,33 +164,51 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
-    // Test if this is an activation that can be fused and also extract the
-    // activation's parameters.
-    std::vector<float> activation_params;
-    if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Relu", {6}) &&
-        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Sigmoid", {6}) &&
-        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6})) {
-      if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LeakyRelu", {6})) {
-        activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "alpha")->f());
-      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6, 11})) {
-        float min, max;
-        if (GetClipConstantMinMax(graph, next_node, min, max)) {
-          activation_params.push_back(min);
-          activation_params.push_back(max);
-        } else {
-          continue;
+    Node& conv_node = *node;
+
+    // A residual Add is fused first, followed by an activation of its output.
+    Node* add_node = nullptr;
+    int residual_index = GetResidualInputIndex(conv_node, next_node);
+    const Node* act_candidate = &next_node;
+
+    if (residual_index >= 0) {
+      add_node = graph.GetNode(next_node.Index());
+      act_candidate = nullptr;
+
+      if (add_node->GetOutputEdgesCount() == 1 && graph.GetNodeOutputsInGraphOutputs(*add_node).empty()) {
+        const auto& add_next_node = *(add_node->OutputNodesBegin());
+        if (add_next_node.GetExecutionProviderType() == node->GetExecutionProviderType()) {
+          act_candidate = &add_next_node;
         }
-      } else {
-        continue;
       }
     }
 
-    Node& conv_node = *node;
-    Node& act_node = *graph.GetNode(next_node.Index());
+    std::vector<float> activation_params;
+    if (act_candidate != nullptr && !GetFusedActivation(graph, *act_candidate, activation_params)) {
+      act_candidate = nullptr;
+    }
+
+    if (act_candidate == nullptr && add_node == nullptr) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs = conv_node.MutableInputDefs();
+    std::string description = "fused Conv " + conv_node.Name();
+    if (add_node != nullptr) {
+      // the residual tensor is the fourth input, after the optional bias
+      if (fused_inputs.size() < 3) {
+        fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      }
+      fused_inputs.push_back(add_node->MutableInputDefs()[residual_index]);
+      description += " with residual " + add_node->OpType();
+    }
+    if (act_candidate != nullptr) {
+      description += " with activation " + act_candidate->OpType();
+    }
 
     Node& fused_conv = graph.AddNode(graph.GenerateNodeName("fused " + conv_node.Name()), "FusedConv",
-                                     "fused Conv " + conv_node.Name() + "with activation " + act_node.OpType(),
-                                     conv_node.MutableInputDefs(),
+                                     description,
+                                     fused_inputs,
                                      {},
                                      &conv_node.GetAttributes(),
                                      "com.microsoft");
@@ -135,13 +217,33 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     fused_conv.SetExecutionProviderType(conv_node.GetExecutionProviderType());
 
     // Add attributes to specify the activation type and parameters.
-    fused_conv.AddAttribute("activation", next_node.OpType());
-    if (activation_params.size() > 0) {
-      fused_conv.AddAttribute("activation_params", activation_params);
+    if (act_candidate != nullptr) {
+      fused_conv.AddAttribute("activation", act_candidate->OpType());
+      if (activation_params.size() > 0) {
+        fused_conv.AddAttribute("activation_params", activation_params);
+      }
+    }
+
+    std::vector<std::reference_wrapper<Node>> fused_nodes{conv_node};
+
+    if (add_node != nullptr) {
+      // move the edge from the producer of the residual tensor to the fused node.
+      const Node::EdgeEnd* residual_edge = graph_utils::GetInputEdge(*add_node, residual_index);
+      if (residual_edge != nullptr) {
+        const NodeIndex producer_index = residual_edge->GetNode().Index();
+        const int producer_slot = residual_edge->GetSrcArgIndex();
+        graph.RemoveEdge(producer_index, add_node->Index(), producer_slot, residual_index);
+        graph.AddEdge(producer_index, fused_conv.Index(), producer_slot, 3);
+      }
+      fused_nodes.push_back(*add_node);
+    }
+
+    if (act_candidate != nullptr) {
+      fused_nodes.push_back(*graph.GetNode(act_candidate->Index()));
     }
 
-    // move output definitions and edges from act_node to fused_conv. delete conv_node and act_node.
-    graph_utils::FinalizeNodeFusion(graph, {conv_node, act_node}, fused_conv);
+    // move output definitions and edges from the last node to fused_conv. delete the fused nodes.
+    graph_utils::FinalizeNodeFusion(graph, fused_nodes, fused_conv);
 
     modified = true;
   }
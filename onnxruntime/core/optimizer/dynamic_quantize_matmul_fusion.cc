@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the only consumer of the outputs of the node if it has the given op type, runs on the same execution
+// provider, and none of the outputs of the node are graph outputs.
+static Node* GetOnlyConsumer(Graph& graph, const Node& node, const std::string& op_type,
+                             const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions) {
+  if (node.GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return nullptr;
+  }
+
+  const Node& next_node = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, op_type, versions) ||
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  return graph.GetNode(next_node.Index());
+}
+
+// Returns the constant initializer of the NodeArg if it has the data type, and a shape of {} or {1}, or {N} when
+// per_column is set.
+static const TensorProto* GetConstantParameter(const Graph& graph, const NodeArg& node_arg, int32_t data_type,
+                                               int64_t N, bool per_column) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != data_type || tensor_proto->dims_size() > 1) {
+    return nullptr;
+  }
+
+  const int64_t size = tensor_proto->dims_size() == 0 ? 1 : tensor_proto->dims(0);
+  if (size != 1 && !(per_column && size == N)) {
+    return nullptr;
+  }
+  return tensor_proto;
+}
+
+// Returns the index of the input of a binary node other than the given NodeArg, or -1 if it's not an input.
+static int GetOtherInputIndex(const Node& node, const NodeArg& node_arg) {
+  const auto& inputs = node.InputDefs();
+  if (inputs.size() != 2) {
+    return -1;
+  }
+  if (inputs[0] == &node_arg) {
+    return 1;
+  }
+  if (inputs[1] == &node_arg) {
+    return 0;
+  }
+  return -1;
+}
+
+static bool FuseDynamicQuantizeMatMul(Graph& graph, Node& matmul_integer) {
+  // the quantized A and its zero point are produced by DynamicQuantizeLinear
+  const auto& matmul_inputs = matmul_integer.InputDefs();
+  if (matmul_inputs.size() < 3 || !matmul_inputs[2]->Exists()) {
+    return false;
+  }
+
+  const Node* dql = graph_utils::GetInputNode(matmul_integer, 0);
+  if (dql == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*dql, "DynamicQuantizeLinear", {11}) ||
+      dql->GetExecutionProviderType() != matmul_integer.GetExecutionProviderType() ||
+      dql->GetOutputEdgesCount() != 3 || !graph.GetNodeOutputsInGraphOutputs(*dql).empty()) {
+    return false;
+  }
+
+  const auto& dql_outputs = dql->OutputDefs();
+  if (matmul_inputs[0] != dql_outputs[0] || matmul_inputs[2] != dql_outputs[2]) {
+    return false;
+  }
+
+  // B and its zero point are constant, with the types of the kernel
+  const auto* b_tensor = graph_utils::GetConstantInitializer(graph, matmul_inputs[1]->Name());
+  if (b_tensor == nullptr || b_tensor->dims_size() < 2 ||
+      (b_tensor->data_type() != TensorProto_DataType_INT8 && b_tensor->data_type() != TensorProto_DataType_UINT8)) {
+    return false;
+  }
+
+  const int64_t N = b_tensor->dims(b_tensor->dims_size() - 1);
+  const bool is_b_2d = b_tensor->dims_size() == 2;
+  NodeArg* b_zero_point = nullptr;
+  if (matmul_inputs.size() > 3 && matmul_inputs[3]->Exists()) {
+    if (GetConstantParameter(graph, *matmul_inputs[3], b_tensor->data_type(), N, is_b_2d) == nullptr) {
+      return false;
+    }
+    b_zero_point = matmul_integer.MutableInputDefs()[3];
+  }
+
+  Node* cast = GetOnlyConsumer(graph, matmul_integer, "Cast", {6, 9});
+  if (cast == nullptr) {
+    return false;
+  }
+  const auto* to = graph_utils::GetNodeAttribute(*cast, "to");
+  if (to == nullptr || to->i() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  // the float product is multiplied by y_scale * b_scale
+  Node* mul = GetOnlyConsumer(graph, *cast, "Mul", {7});
+  if (mul == nullptr) {
+    return false;
+  }
+  const int scale_index = GetOtherInputIndex(*mul, *cast->OutputDefs()[0]);
+  if (scale_index < 0) {
+    return false;
+  }
+
+  const Node* scale_mul = graph_utils::GetInputNode(*mul, scale_index);
+  if (scale_mul == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*scale_mul, "Mul", {7}) ||
+      scale_mul->GetExecutionProviderType() != matmul_integer.GetExecutionProviderType() ||
+      scale_mul->GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(*scale_mul).empty()) {
+    return false;
+  }
+  const int b_scale_index = GetOtherInputIndex(*scale_mul, *dql_outputs[1]);
+  if (b_scale_index < 0 ||
+      GetConstantParameter(graph, *scale_mul->InputDefs()[b_scale_index], TensorProto_DataType_FLOAT, N,
+                           is_b_2d) == nullptr) {
+    return false;
+  }
+  NodeArg* b_scale = graph.GetNode(scale_mul->Index())->MutableInputDefs()[b_scale_index];
+
+  // optionally followed by an Add of a constant bias with a value per column
+  Node* add = GetOnlyConsumer(graph, *mul, "Add", {7});
+  NodeArg* bias = nullptr;
+  if (add != nullptr) {
+    const int bias_index = GetOtherInputIndex(*add, *mul->OutputDefs()[0]);
+    const TensorProto* bias_tensor =
+        bias_index < 0 ? nullptr : graph_utils::GetConstantInitializer(graph, add->InputDefs()[bias_index]->Name());
+    if (bias_tensor != nullptr && bias_tensor->data_type() == TensorProto_DataType_FLOAT &&
+        bias_tensor->dims_size() == 1 && bias_tensor->dims(0) == N) {
+      bias = add->MutableInputDefs()[bias_index];
+    } else {
+      add = nullptr;
+    }
+  }
+
+  Node& dql_node = *graph.GetNode(dql->Index());
+  std::vector<NodeArg*> inputs{dql_node.MutableInputDefs()[0], matmul_integer.MutableInputDefs()[1], b_scale};
+  if (b_zero_point != nullptr || bias != nullptr) {
+    inputs.push_back(b_zero_point != nullptr ? b_zero_point : &graph.GetOrCreateNodeArg("", nullptr));
+  }
+  if (bias != nullptr) {
+    inputs.push_back(bias);
+  }
+
+  Node& last_node = add != nullptr ? *add : *mul;
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(matmul_integer.Name() + "_dynamic_quantize"),
+                                   "DynamicQuantizeMatMul",
+                                   "fused DynamicQuantizeLinear, MatMulInteger, Cast and Mul",
+                                   inputs,
+                                   last_node.MutableOutputDefs(),
+                                   nullptr,
+                                   kMSDomain);
+  fused_node.SetExecutionProviderType(matmul_integer.GetExecutionProviderType());
+
+  std::vector<std::reference_wrapper<Node>> nodes{dql_node, matmul_integer, *graph.GetNode(scale_mul->Index()),
+                                                 *cast, *mul};
+  if (add != nullptr) {
+    nodes.push_back(*add);
+  }
+  graph_utils::FinalizeNodeFusion(graph, nodes, fused_node);
+  return true;
+}
+
+Status DynamicQuantizeMatMulFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                              const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulInteger", {10}) &&
+        graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      modified |= FuseDynamicQuantizeMatMul(graph, node);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
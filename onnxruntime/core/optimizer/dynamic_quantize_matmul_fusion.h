@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeMatMulFusion
+
+Fuse the nodes of a dynamically quantized MatMul into a DynamicQuantizeMatMul node:
+  DynamicQuantizeLinear -> MatMulInteger -> Cast(to float) -> Mul(y_scale * b_scale) [-> Add(bias)]
+The product of the scales is a Mul of the y_scale output of DynamicQuantizeLinear with a constant b_scale. B, its
+zero point and the optional bias must be constant initializers, so the fused node only consumes the float input of
+DynamicQuantizeLinear, and none of the intermediate values may have other consumers.
+*/
+class DynamicQuantizeMatMulFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeMatMulFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeMatMulFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
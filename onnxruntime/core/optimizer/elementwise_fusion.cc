@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsUnaryElementwiseNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9});
+}
+
+bool IsBinaryElementwiseNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7});
+}
+
+// The CUDA kernel also runs float16 chains, computing in float.
+bool IsFloatTensor(const NodeArg& arg, bool allow_float16) {
+  const TypeProto* type = arg.TypeAsProto();
+  if (type == nullptr || !utils::HasTensorType(*type)) {
+    return false;
+  }
+  const auto elem_type = type->tensor_type().elem_type();
+  return elem_type == TensorProto_DataType_FLOAT || (allow_float16 && elem_type == TensorProto_DataType_FLOAT16);
+}
+
+// The CUDA kernel passes the operations in its launch parameters, which limits a chain to
+// kMaxFusedElementwiseSteps in contrib_ops/cuda/math/fused_elementwise_impl.h.
+constexpr size_t kMaxCudaSteps = 16;
+
+// Returns true if both shapes are known and have the same dimensions.
+bool IsSameShape(const NodeArg& a, const NodeArg& b) {
+  const TensorShapeProto* a_shape = a.Shape();
+  const TensorShapeProto* b_shape = b.Shape();
+  if (a_shape == nullptr || b_shape == nullptr || a_shape->dim_size() != b_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < a_shape->dim_size(); i++) {
+    const auto& a_dim = a_shape->dim(i);
+    const auto& b_dim = b_shape->dim(i);
+    if (utils::HasDimValue(a_dim) && utils::HasDimValue(b_dim)) {
+      if (a_dim.dim_value() != b_dim.dim_value()) {
+        return false;
+      }
+    } else if (utils::HasDimParam(a_dim) && utils::HasDimParam(b_dim)) {
+      if (a_dim.dim_param() != b_dim.dim_param()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Returns true if the operand can be combined with the running value of a chain that starts at input without
+// changing its shape: the operand is input itself, has the same shape, is a scalar, or is a vector along the
+// last dimension of input.
+bool IsCompatibleOperand(const NodeArg& operand, const NodeArg& input) {
+  if (&operand == &input || IsSameShape(operand, input)) {
+    return true;
+  }
+
+  const TensorShapeProto* operand_shape = operand.Shape();
+  const TensorShapeProto* input_shape = input.Shape();
+  if (operand_shape == nullptr || input_shape == nullptr || operand_shape->dim_size() > input_shape->dim_size()) {
+    return false;
+  }
+
+  const int operand_rank = operand_shape->dim_size();
+  for (int i = 0; i < operand_rank - 1; i++) {
+    const auto& dim = operand_shape->dim(i);
+    if (!utils::HasDimValue(dim) || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+
+  if (operand_rank == 0) {
+    return true;
+  }
+
+  const auto& last_dim = operand_shape->dim(operand_rank - 1);
+  if (!utils::HasDimValue(last_dim)) {
+    return false;
+  }
+  if (last_dim.dim_value() == 1) {
+    return true;
+  }
+
+  const auto& input_last_dim = input_shape->dim(input_shape->dim_size() - 1);
+  return utils::HasDimValue(input_last_dim) && input_last_dim.dim_value() == last_dim.dim_value();
+}
+
+struct FusedStep {
+  std::string operation;
+  const NodeArg* operand;  // nullptr for a unary operation
+  bool operand_first;
+};
+
+// Adds node to the chain given the input that carries the running value. Returns false if the node can not be
+// fused.
+bool AddChainStep(const Node& node, const NodeArg& value, const NodeArg& chain_input, std::vector<FusedStep>& steps) {
+  const auto& input_defs = node.InputDefs();
+  const bool is_cuda = node.GetExecutionProviderType() == kCudaExecutionProvider;
+  if (is_cuda && steps.size() >= kMaxCudaSteps) {
+    return false;
+  }
+
+  if (IsUnaryElementwiseNode(node)) {
+    if (input_defs[0] != &value) {
+      return false;
+    }
+    steps.push_back({node.OpType(), nullptr, false});
+    return true;
+  }
+
+  if (!IsBinaryElementwiseNode(node) || input_defs.size() != 2 || input_defs[0] == input_defs[1]) {
+    return false;
+  }
+
+  const int value_index = (input_defs[0] == &value) ? 0 : (input_defs[1] == &value) ? 1 : -1;
+  if (value_index < 0) {
+    return false;
+  }
+
+  const NodeArg* operand = input_defs[1 - value_index];
+  if (!IsFloatTensor(*operand, is_cuda) || !IsCompatibleOperand(*operand, chain_input)) {
+    return false;
+  }
+
+  steps.push_back({node.OpType(), operand, value_index == 1});
+  return true;
+}
+
+// Chains that start at the output of a convolution are left alone on CPU so that the NCHWc transformer can fuse
+// the Add and activation into the convolution.
+bool HasConvInput(const Node& node) {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return false;
+  }
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    if ((*it).OpType() == "Conv" || (*it).OpType() == "FusedConv") {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !(IsUnaryElementwiseNode(node) || IsBinaryElementwiseNode(node)) ||
+        !IsFloatTensor(*node.OutputDefs()[0], node.GetExecutionProviderType() == kCudaExecutionProvider)) {
+      continue;
+    }
+
+    // Pick the chain input. For a binary node this is the input with the shape of the output, so that the
+    // other input broadcasts to it.
+    const auto& input_defs = node.InputDefs();
+    const NodeArg* chain_input = nullptr;
+    if (IsUnaryElementwiseNode(node)) {
+      chain_input = input_defs[0];
+    } else if (IsSameShape(*input_defs[0], *node.OutputDefs()[0])) {
+      chain_input = input_defs[0];
+    } else if (IsSameShape(*input_defs[1], *node.OutputDefs()[0])) {
+      chain_input = input_defs[1];
+    }
+
+    if (chain_input == nullptr || chain_input->Shape() == nullptr || chain_input->Shape()->dim_size() == 0 ||
+        HasConvInput(node)) {
+      continue;
+    }
+
+    std::vector<FusedStep> steps;
+    if (!AddChainStep(node, *chain_input, *chain_input, steps)) {
+      continue;
+    }
+
+    std::vector<std::reference_wrapper<Node>> nodes_to_fuse{node};
+    Node* current = &node;
+    for (;;) {
+      if (current->GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(*current).empty()) {
+        break;
+      }
+
+      Node& next = *graph.GetNode(current->OutputNodesBegin()->Index());
+      if (next.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          !IsFloatTensor(*next.OutputDefs()[0], next.GetExecutionProviderType() == kCudaExecutionProvider) ||
+          !AddChainStep(next, *current->OutputDefs()[0], *chain_input, steps)) {
+        break;
+      }
+
+      nodes_to_fuse.push_back(next);
+      current = &next;
+    }
+
+    if (nodes_to_fuse.size() < 2) {
+      continue;
+    }
+
+    // The fused node takes the chain input followed by the distinct operands.
+    std::vector<NodeArg*> fused_inputs{const_cast<NodeArg*>(chain_input)};
+    std::vector<std::string> operations;
+    std::vector<int64_t> operand_indices;
+    std::vector<int64_t> operand_positions;
+
+    for (const auto& step : steps) {
+      operations.push_back(step.operation);
+
+      if (step.operand == nullptr) {
+        operand_indices.push_back(-1);
+        operand_positions.push_back(-1);
+        continue;
+      }
+
+      auto it = std::find(fused_inputs.begin(), fused_inputs.end(), step.operand);
+      if (it == fused_inputs.end()) {
+        it = fused_inputs.insert(fused_inputs.end(), const_cast<NodeArg*>(step.operand));
+      }
+      operand_indices.push_back(static_cast<int64_t>(it - fused_inputs.begin()));
+      operand_positions.push_back(step.operand_first ? 0 : 1);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused element-wise operations",
+                                     fused_inputs,
+                                     {},
+                                     {},
+                                     kMSDomain);
+    fused_node.AddAttribute("operations", operations);
+    fused_node.AddAttribute("operand_indices", operand_indices);
+    fused_node.AddAttribute("operand_positions", operand_positions);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // move output definitions and edges from the last node to fused_node and delete the chain.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
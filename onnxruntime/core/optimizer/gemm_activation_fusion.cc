@@ -12,6 +12,13 @@ namespace onnxruntime {
 
 namespace {
 bool IsFusableActivation(const Node& node) {
+  // cuBLASLt applies FastGelu to the product on CUDA, like Relu
+  if (node.GetExecutionProviderType() == kCudaExecutionProvider &&
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) &&
+      node.InputDefs().size() == 1) {
+    return true;
+  }
+
   return graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
@@ -38,6 +45,16 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
       continue;
     }
 
+    // the CUDA FusedGemm has no double kernel
+    if (node.GetExecutionProviderType() == kCudaExecutionProvider) {
+      const auto* x_type = node.InputDefs()[0]->TypeAsProto();
+      if (x_type == nullptr ||
+          (x_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+           x_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16)) {
+        continue;
+      }
+    }
+
     const Node& next_node = *(node.OutputNodesBegin());
     if (!IsFusableActivation(next_node) ||
         next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
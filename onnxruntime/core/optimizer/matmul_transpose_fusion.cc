@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the Transpose node feeding the given input of the node if it only swaps the last two dimensions.
+static const Node* GetFusableTranspose(const Node& node, int input_index) {
+  const Node* transpose = graph_utils::GetInputNode(node, input_index);
+  if (transpose == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*transpose, "Transpose", {1}) ||
+      transpose->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  std::vector<int64_t> perm;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(*transpose, "perm", perm)) {
+    // the default permutation reverses the dimensions, which only swaps the last two of a 2-D input
+    const auto* input_shape = transpose->InputDefs()[0]->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() != 2) {
+      return nullptr;
+    }
+    perm = {1, 0};
+  }
+
+  const size_t rank = perm.size();
+  if (rank < 2 ||
+      perm[rank - 2] != static_cast<int64_t>(rank - 1) ||
+      perm[rank - 1] != static_cast<int64_t>(rank - 2)) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < rank - 2; ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return nullptr;
+    }
+  }
+
+  return transpose;
+}
+
+static bool GetTransposeAttribute(const Node& node, const std::string& name) {
+  const auto* attribute = graph_utils::GetNodeAttribute(node, name);
+  return attribute != nullptr && attribute->i() != 0;
+}
+
+Status MatmulTransposeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9});
+    if ((!is_matmul && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "TransposeMatMul", {1}, kMSDomain)) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // TransposeMatMul is only implemented for float
+    const auto* input_type = node.InputDefs()[0]->TypeAsProto();
+    if (input_type == nullptr || input_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    const Node* transposes[2] = {GetFusableTranspose(node, 0), GetFusableTranspose(node, 1)};
+
+    // a transposed A requires B to have at least 2 dimensions
+    const auto* b_shape = node.InputDefs()[1]->Shape();
+    if (b_shape == nullptr || b_shape->dim_size() < 2) {
+      transposes[0] = nullptr;
+    }
+
+    if (transposes[0] == nullptr && transposes[1] == nullptr) {
+      continue;
+    }
+
+    bool trans_a = GetTransposeAttribute(node, "transA");
+    bool trans_b = GetTransposeAttribute(node, "transB");
+
+    Node* fused_node = &node;
+    if (is_matmul) {
+      fused_node = &graph.AddNode(graph.GenerateNodeName(node.Name() + "_TransposeMatMul"),
+                                  "TransposeMatMul",
+                                  "fused Transpose and MatMul",
+                                  node.MutableInputDefs(),
+                                  {},
+                                  nullptr,
+                                  kMSDomain);
+      fused_node->SetExecutionProviderType(node.GetExecutionProviderType());
+      graph_utils::FinalizeNodeFusion(graph, std::vector<std::reference_wrapper<Node>>{node}, *fused_node);
+    }
+
+    // read the inputs of the Transpose nodes directly
+    for (int i = 0; i < 2; ++i) {
+      if (transposes[i] == nullptr) {
+        continue;
+      }
+
+      Node& transpose = *graph.GetNode(transposes[i]->Index());
+      graph.RemoveEdge(transpose.Index(), fused_node->Index(), 0, i);
+      fused_node->MutableInputDefs()[i] = transpose.MutableInputDefs()[0];
+      const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(transpose, 0);
+      if (input_edge != nullptr) {
+        graph.AddEdge(input_edge->GetNode().Index(), fused_node->Index(), input_edge->GetSrcArgIndex(), i);
+      }
+
+      if (i == 0) {
+        trans_a = !trans_a;
+      } else {
+        trans_b = !trans_b;
+      }
+    }
+
+    // remove the Transpose nodes without any other consumers, either input may have used the same Transpose.
+    for (int i = 0; i < 2; ++i) {
+      if (transposes[i] == nullptr || (i == 1 && transposes[1] == transposes[0])) {
+        continue;
+      }
+
+      Node& transpose = *graph.GetNode(transposes[i]->Index());
+      if (transpose.GetOutputEdgesCount() == 0 && graph.GetNodeOutputsInGraphOutputs(transpose).empty()) {
+        graph.RemoveNode(transpose.Index());
+      }
+    }
+
+    fused_node->AddAttribute("transA", static_cast<int64_t>(trans_a ? 1 : 0));
+    fused_node->AddAttribute("transB", static_cast<int64_t>(trans_b ? 1 : 0));
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatmulTransposeFusion
+
+Fuse the Transpose nodes that only swap the last two dimensions of a MatMul input into a TransposeMatMul node,
+which reads the untransposed input with a transposed GEMM instead of materializing the transposed copy.
+*/
+class MatmulTransposeFusion : public GraphTransformer {
+ public:
+  MatmulTransposeFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatmulTransposeFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
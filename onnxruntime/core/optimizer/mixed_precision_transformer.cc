@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/util/math.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloat16Candidate(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Attention", {1}, kMSDomain);
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const TypeProto* type = arg.TypeAsProto();
+  return type != nullptr && utils::HasTensorType(*type) &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// Returns a float16 NodeArg with the shape of the float arg.
+NodeArg& CreateFloat16NodeArg(Graph& graph, const NodeArg& arg) {
+  TypeProto type(*arg.TypeAsProto());
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_fp16"), &type);
+}
+
+NodeArg& AddCastNode(Graph& graph, NodeArg& input, NodeArg& output, TensorProto_DataType to,
+                     const std::string& provider) {
+  Node& cast_node = graph.AddNode(graph.GenerateNodeName("MixedPrecisionCast"), "Cast",
+                                  "cast node for mixed precision", {&input}, {&output});
+  cast_node.AddAttribute("to", static_cast<int64_t>(to));
+  cast_node.SetExecutionProviderType(provider);
+  return output;
+}
+
+// Converts a constant float initializer to a new float16 initializer.
+NodeArg& AddFloat16Initializer(Graph& graph, const TensorProto& tensor_proto) {
+  Initializer source(tensor_proto);
+  Initializer converted(TensorProto_DataType_FLOAT16, graph.GenerateNodeArgName(tensor_proto.name() + "_fp16"),
+                        source.dims());
+
+  const float* src = source.data<float>();
+  uint16_t* dst = converted.data<uint16_t>();
+  for (int64_t i = 0; i < source.size(); i++) {
+    dst[i] = math::floatToHalf(src[i]);
+  }
+
+  TensorProto new_tensor_proto;
+  converted.ToProto(new_tensor_proto);
+  return graph_utils::AddInitializer(graph, new_tensor_proto);
+}
+
+}  // namespace
+
+Status MixedPrecisionTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // float16 replacements for the float inputs, shared by the converted nodes that consume the same input.
+  std::unordered_map<const NodeArg*, NodeArg*> float16_inputs;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsFloat16Candidate(node) || !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        node.GetExecutionProviderType().empty() || !IsFloatTensor(*node.OutputDefs()[0])) {
+      continue;
+    }
+
+    const std::string& provider = node.GetExecutionProviderType();
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+
+    for (NodeArg* input : node.MutableInputDefs()) {
+      // the integer inputs such as the Attention mask index are left alone.
+      if (!input->Exists() || !IsFloatTensor(*input) || replacement_defs.count(input)) {
+        continue;
+      }
+
+      auto it = float16_inputs.find(input);
+      if (it == float16_inputs.end()) {
+        NodeArg* float16_input;
+        const TensorProto* initializer = graph_utils::GetConstantInitializer(graph, input->Name());
+        if (initializer != nullptr && initializer->data_type() == TensorProto_DataType_FLOAT) {
+          float16_input = &AddFloat16Initializer(graph, *initializer);
+        } else {
+          float16_input = &AddCastNode(graph, *input, CreateFloat16NodeArg(graph, *input),
+                                       TensorProto_DataType_FLOAT16, provider);
+        }
+        it = float16_inputs.emplace(input, float16_input).first;
+      }
+
+      replacement_defs[input] = it->second;
+    }
+
+    for (NodeArg* output : node.MutableOutputDefs()) {
+      if (!output->Exists() || !IsFloatTensor(*output)) {
+        continue;
+      }
+
+      // the node produces float16 and a Cast node produces the original float output for the consumers.
+      NodeArg& float16_output = CreateFloat16NodeArg(graph, *output);
+      AddCastNode(graph, float16_output, *output, TensorProto_DataType_FLOAT, provider);
+      replacement_defs[output] = &float16_output;
+    }
+
+    node.ReplaceDefs(replacement_defs);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MixedPrecisionTransformer
+Run the compute bound MatMul, Gemm, Conv and Attention nodes of the compatible execution providers in float16 so
+that the CUDA kernels use Tensor Core math. Constant float initializers of these nodes are converted to float16,
+other float inputs are cast to float16 and the outputs are cast back to float. All other nodes, including softmax
+and the reductions, keep running in float.
+Back to back Cast pairs between two converted nodes are removed by the InsertCastTransformer.
+*/
+class MixedPrecisionTransformer : public GraphTransformer {
+ public:
+  MixedPrecisionTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MixedPrecisionTransformer", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
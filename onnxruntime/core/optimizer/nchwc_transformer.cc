@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <deque>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
@@ -115,9 +116,12 @@ class NchwcTransformerImpl {
 
   void TransformConv(Node& node);
   void TransformPool(Node& node);
-  void TransformAdd(Node& node);
+  void TransformBinary(Node& node, bool add_node);
   void TransformConcat(Node& node);
   void TransformActivation(Node& node);
+  void TransformBatchNormalization(Node& node);
+  void TransformResize(Node& node);
+  void TransformTranspose(Node& node);
 
   Graph& graph_;
 
@@ -132,6 +136,15 @@ class NchwcTransformerImpl {
   // multiple nodes can share the NCHWc input.
   std::unordered_map<NodeArg*, NodeArg*> reorder_inputs_;
 
+  // Stores a mapping from the outputs of Transpose nodes that convert a NHWC
+  // tensor to NCHW format to the Transpose node. Inputs that are reordered
+  // from these outputs are instead reordered directly from the NHWC tensor.
+  std::unordered_map<NodeArg*, Node*> nhwc_transposes_;
+
+  // Stores the Transpose nodes that have been bypassed by a reorder from the
+  // NHWC tensor. These are removed if no other nodes use the output.
+  std::vector<NodeIndex> bypassed_transposes_;
+
   // Stores a mapping of NodeArg filters that have already been reordered, so
   // multiple nodes can share the NCHWc filter.
   std::unordered_map<NodeArg*, NodeArg*> filters_OIHWBo_;
@@ -190,14 +203,27 @@ void NchwcTransformerImpl::InsertReorderInput(Node& node) {
     std::string input_reorder_def_name = graph_.GenerateNodeArgName("reorder");
     auto* input_nchwc_arg = &graph_.GetOrCreateNodeArg(input_reorder_def_name, nullptr);
     reorder_inputs_[input_original_arg] = input_nchwc_arg;
+
+    // Reorder directly from the NHWC tensor if the input is the output of a
+    // Transpose node from NHWC to NCHW.
+    auto* reorder_source_arg = input_original_arg;
+    auto transpose_it = nhwc_transposes_.find(input_original_arg);
+    if (transpose_it != nhwc_transposes_.end()) {
+      reorder_source_arg = transpose_it->second->MutableInputDefs()[0];
+      bypassed_transposes_.push_back(transpose_it->second->Index());
+    }
+
     Node& reorder_input_node = graph_.AddNode(graph_.GenerateNodeName("ReorderInput"),
                                               "ReorderInput",
                                               "ReorderInput",
-                                              {input_original_arg},
+                                              {reorder_source_arg},
                                               {input_nchwc_arg},
                                               nullptr,
                                               kMSNchwcDomain);
     reorder_input_node.SetExecutionProviderType(node.GetExecutionProviderType());
+    if (reorder_source_arg != input_original_arg) {
+      reorder_input_node.AddAttribute("channels_last", static_cast<int64_t>(1));
+    }
     input_defs[0] = input_nchwc_arg;
   } else {
     input_defs[0] = it->second;
@@ -340,7 +366,7 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
 
   // Also require that the optional bias tensor be static.
   const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
-  if (input_defs.size() >= 3) {
+  if (input_defs.size() >= 3 && input_defs[2]->Exists()) {
     if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[2]) ||
         !graph_.GetInitializedTensor(input_defs[2]->Name(), conv_B_tensor_proto) ||
         (conv_B_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
@@ -350,6 +376,17 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     }
   }
 
+  // A FusedConv that sums a residual tensor into its output requires that the
+  // residual tensor is already in NCHWc format.
+  NchwcArgument* nchwc_sum = nullptr;
+  if (input_defs.size() >= 4 && input_defs[3]->Exists()) {
+    auto it = nchwc_args_.find(input_defs[3]);
+    if (it == nchwc_args_.end() || it->second->channels_ != output_channels) {
+      return;
+    }
+    nchwc_sum = it->second.get();
+  }
+
   // Check if the filter has already been converted to the target format.
   std::unordered_map<NodeArg*, NodeArg*>* filters_map;
   if (reorder_filter_OIHWBo) {
@@ -437,6 +474,11 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     nchwc_node.MutableInputDefs()[2] = nchwc_conv_B_arg;
   }
 
+  if (nchwc_sum != nullptr) {
+    nchwc_node.MutableInputDefs()[3] = nchwc_sum->nchwc_arg_;
+    nchwc_sum->remaining_original_uses_--;
+  }
+
   NchwcArgument::Shape output_shape(output_defs[0]);
 
   if (do_reorder_input) {
@@ -506,10 +548,11 @@ void NchwcTransformerImpl::TransformPool(Node& node) {
   removed_nodes_.push_front(node.Index());
 }
 
-// The existing Add/Sum operator implementations can be used with tensors
-// in NCHWc format if the tensor shapes are exactly the same (elementwise
-// add).
-void NchwcTransformerImpl::TransformAdd(Node& node) {
+// The existing Add/Sum/Mul/Sub operator implementations can be used with
+// tensors in NCHWc format if the tensor shapes are exactly the same
+// (elementwise operation). The padding channels of the NCHWc inputs are zero,
+// so these operators also keep the padding channels of the output zero.
+void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
   auto& input_defs = node.MutableInputDefs();
 
   // Verify that all of the inputs to this operator are from NCHWc outputs.
@@ -558,7 +601,7 @@ void NchwcTransformerImpl::TransformAdd(Node& node) {
 
   // If one of the inputs to the Add/Sum node is a NCHWc convolution, then
   // attempt to fuse the addition into the convolution itself.
-  if (input_defs_count == 2) {
+  if (add_node && input_defs_count == 2) {
     for (size_t n = 0; n < 2; n++) {
       auto* nchwc_input_n = nchwc_inputs[n];
       auto& nchwc_node = nchwc_input_n->output_node_;
@@ -666,6 +709,286 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
   }
 }
 
+// BatchNormalization in inference mode is a per-channel scale and shift, which
+// is computed as a NCHWc depthwise 1x1 convolution with the scale and shift
+// folded into the filter and the bias. The convolution can then be fused with
+// a following activation.
+void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the training outputs are specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // Only the default per-channel normalization of BatchNormalization-7 is
+  // supported.
+  auto* spatial_attr = graph_utils::GetNodeAttribute(node, "spatial");
+  if (spatial_attr != nullptr && utils::HasInt(*spatial_attr) && spatial_attr->i() != 1) {
+    return;
+  }
+
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto& nchwc_input = it->second;
+
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % nchwc_block_size) != 0) {
+    return;
+  }
+
+  // Require that the scale, bias, mean, and variance tensors be static.
+  std::unique_ptr<Initializer> bn_params[4];
+  for (size_t i = 0; i < 4; i++) {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[i + 1]) ||
+        !graph_.GetInitializedTensor(input_defs[i + 1]->Name(), tensor_proto) ||
+        (tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (tensor_proto->dims_size() != 1) ||
+        (tensor_proto->dims(0) != channels)) {
+      return;
+    }
+    bn_params[i] = onnxruntime::make_unique<Initializer>(*tensor_proto);
+  }
+
+  float epsilon = 1e-5f;
+  auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr && utils::HasFloat(*epsilon_attr)) {
+    epsilon = epsilon_attr->f();
+  }
+
+  const float* bn_scale = bn_params[0]->data<float>();
+  const float* bn_B = bn_params[1]->data<float>();
+  const float* bn_mean = bn_params[2]->data<float>();
+  const float* bn_var = bn_params[3]->data<float>();
+
+  std::vector<float> conv_W(channels);
+  std::vector<float> conv_B(channels);
+  for (int64_t c = 0; c < channels; c++) {
+    conv_W[c] = bn_scale[c] / std::sqrt(bn_var[c] + epsilon);
+    conv_B[c] = bn_B[c] - bn_mean[c] * conv_W[c];
+  }
+
+  // Reorder the depthwise filter to the NCHWc layout.
+  const int64_t conv_W_dims[] = {channels, 1, 1, 1};
+  std::vector<float> reordered_filter(channels);
+  MlasReorderFilterOIHWBo(conv_W_dims, conv_W.data(), reordered_filter.data());
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_W_tensor_proto;
+
+  nchwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_filter"));
+  nchwc_conv_W_tensor_proto.set_raw_data(reordered_filter.data(), reordered_filter.size() * sizeof(float));
+  for (size_t i = 0; i < 4; i++) {
+    nchwc_conv_W_tensor_proto.add_dims(conv_W_dims[i]);
+  }
+
+  graph_.AddInitializedTensor(nchwc_conv_W_tensor_proto);
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_B_tensor_proto;
+
+  nchwc_conv_B_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_B_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_bias"));
+  nchwc_conv_B_tensor_proto.set_raw_data(conv_B.data(), conv_B.size() * sizeof(float));
+  nchwc_conv_B_tensor_proto.add_dims(channels);
+
+  graph_.AddInitializedTensor(nchwc_conv_B_tensor_proto);
+
+  auto* nchwc_conv_W_arg = &graph_.GetOrCreateNodeArg(nchwc_conv_W_tensor_proto.name(), nullptr);
+  auto* nchwc_conv_B_arg = &graph_.GetOrCreateNodeArg(nchwc_conv_B_tensor_proto.name(), nullptr);
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_bn_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Conv",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_conv_W_arg, nchwc_conv_B_arg},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("group", channels);
+
+  nchwc_input->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Upsample/Resize with nearest neighbor interpolation and integral scale
+// factors for the spatial dimensions replicates each input element. This is
+// implemented directly with the NCHWc format.
+void NchwcTransformerImpl::TransformResize(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto& nchwc_input = it->second;
+
+  auto* mode_attr = graph_utils::GetNodeAttribute(node, "mode");
+  if (mode_attr != nullptr && utils::HasString(*mode_attr) && mode_attr->s() != "nearest") {
+    return;
+  }
+
+  const bool is_resize_11 = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {11});
+
+  if (is_resize_11) {
+    // The coordinate transformation must map each output element to the input
+    // element that it replicates for an integral scale factor.
+    auto* coordinate_transformation_mode_attr = graph_utils::GetNodeAttribute(node, "coordinate_transformation_mode");
+    std::string coordinate_transformation_mode = "half_pixel";
+    if (coordinate_transformation_mode_attr != nullptr && utils::HasString(*coordinate_transformation_mode_attr)) {
+      coordinate_transformation_mode = coordinate_transformation_mode_attr->s();
+    }
+    auto* nearest_mode_attr = graph_utils::GetNodeAttribute(node, "nearest_mode");
+    std::string nearest_mode = "round_prefer_floor";
+    if (nearest_mode_attr != nullptr && utils::HasString(*nearest_mode_attr)) {
+      nearest_mode = nearest_mode_attr->s();
+    }
+    if (coordinate_transformation_mode == "asymmetric") {
+      if (nearest_mode != "floor") {
+        return;
+      }
+    } else if (coordinate_transformation_mode == "half_pixel") {
+      if (nearest_mode != "round_prefer_floor" && nearest_mode != "round_prefer_ceil") {
+        return;
+      }
+    } else {
+      return;
+    }
+
+    // Bail out if the output sizes are specified instead of the scales.
+    if (input_defs.size() > 3 && input_defs[3]->Exists()) {
+      return;
+    }
+  }
+
+  std::vector<float> scales;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {7})) {
+    auto* scales_attr = graph_utils::GetNodeAttribute(node, "scales");
+    if (scales_attr == nullptr) {
+      return;
+    }
+    scales.assign(scales_attr->floats().begin(), scales_attr->floats().end());
+  } else {
+    // Require that the scales tensor be static.
+    const size_t scales_index = is_resize_11 ? 2 : 1;
+    const ONNX_NAMESPACE::TensorProto* scales_tensor_proto = nullptr;
+    if (input_defs.size() <= scales_index ||
+        !graph_utils::NodeArgIsConstant(graph_, *input_defs[scales_index]) ||
+        !graph_.GetInitializedTensor(input_defs[scales_index]->Name(), scales_tensor_proto) ||
+        (scales_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (scales_tensor_proto->dims_size() != 1)) {
+      return;
+    }
+    auto scales_tensor = onnxruntime::make_unique<Initializer>(*scales_tensor_proto);
+    scales.assign(scales_tensor->data<float>(), scales_tensor->data<float>() + scales_tensor->size());
+  }
+
+  // The batch and channel dimensions cannot be scaled and the spatial
+  // dimensions must be scaled by a positive integer.
+  if ((scales.size() != kNchwcDims) || (scales[0] != 1.0f) || (scales[1] != 1.0f)) {
+    return;
+  }
+  std::vector<int64_t> integral_scales(kNchwcDims);
+  for (int i = 0; i < kNchwcDims; i++) {
+    integral_scales[i] = static_cast<int64_t>(scales[i]);
+    if ((integral_scales[i] < 1) || (static_cast<float>(integral_scales[i]) != scales[i])) {
+      return;
+    }
+  }
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Upsample",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("scales", integral_scales);
+
+  nchwc_input->remaining_original_uses_--;
+
+  // Carry forward the spatial dimensions that are not scaled.
+  NchwcArgument::Shape output_shape(output_defs[0]);
+  for (int i = 0; i < kNchwcDims; i++) {
+    if (integral_scales[i] == 1) {
+      output_shape.dims_[i] = nchwc_input->shape_.dims_[i];
+      if (i >= kNchwcBatchChannelDims) {
+        output_shape.shifts_[i - kNchwcBatchChannelDims] = nchwc_input->shape_.shifts_[i - kNchwcBatchChannelDims];
+      }
+    }
+  }
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, output_shape);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Models converted from frameworks that use the NHWC format transpose the
+// input to each Conv or pooling node to NCHW format and transpose the output
+// back to NHWC format. Instead of reordering the NCHW tensors produced by
+// these Transpose nodes, the NHWC tensors are directly reordered to and from
+// the NCHWc format.
+void NchwcTransformerImpl::TransformTranspose(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  std::vector<int64_t> perm;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm)) {
+    return;
+  }
+
+  if (perm == std::vector<int64_t>{0, 3, 1, 2}) {
+    // Transpose from NHWC to NCHW. The node is bypassed if a NCHWc node
+    // reorders the output.
+    auto* input_shape = input_defs[0]->Shape();
+    if ((input_shape == nullptr) || (input_shape->dim_size() != 4)) {
+      return;
+    }
+    auto& channels_dim = input_shape->dim(3);
+    if (!utils::HasDimValue(channels_dim) ||
+        ((channels_dim.dim_value() % MlasNchwcGetBlockSize()) != 0)) {
+      return;
+    }
+    nhwc_transposes_[output_defs[0]] = &node;
+  } else if (perm == std::vector<int64_t>{0, 2, 3, 1}) {
+    // Transpose from NCHW to NHWC. Replace the node with a reorder from the
+    // NCHWc input.
+    auto it = nchwc_args_.find(input_defs[0]);
+    if (it == nchwc_args_.end()) {
+      return;
+    }
+    auto& nchwc_input = it->second;
+
+    Node& reorder_output_node = graph_.AddNode(graph_.GenerateNodeName("ReorderOutput"),
+                                               "ReorderOutput",
+                                               "ReorderOutput",
+                                               {nchwc_input->nchwc_arg_},
+                                               output_defs,
+                                               nullptr,
+                                               kMSNchwcDomain);
+    reorder_output_node.AddAttribute("channels", nchwc_input->channels_);
+    reorder_output_node.AddAttribute("channels_last", static_cast<int64_t>(1));
+    reorder_output_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    nchwc_input->remaining_original_uses_--;
+
+    graph_utils::RemoveNodeOutputEdges(graph_, node);
+    removed_nodes_.push_front(node.Index());
+  }
+}
+
 void NchwcTransformerImpl::Transform(Node& node) {
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
       graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
@@ -675,6 +998,8 @@ void NchwcTransformerImpl::Transform(Node& node) {
              graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
              graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1})) {
     TransformPool(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+    TransformTranspose(node);
   } else if (node.GetInputEdgesCount() == 0 && node.InputDefs().size() != 0) {
     // The following transforms only run when the input edge count has already
     // been decremented to zero by earlier transforms. This is a hint that the
@@ -683,11 +1008,19 @@ void NchwcTransformerImpl::Transform(Node& node) {
     // nodes unrelated to this transformer.
     if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8})) {
-      TransformAdd(node);
+      TransformBinary(node, true);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7})) {
+      TransformBinary(node, false);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11})) {
       TransformConcat(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6})) {
       TransformActivation(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {7, 9}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10, 11})) {
+      TransformResize(node);
     }
   }
 
@@ -725,6 +1058,17 @@ void NchwcTransformerImpl::Finalize(bool& modified) {
   if (!removed_nodes_.empty()) {
     modified = true;
   }
+
+  // Remove the bypassed Transpose nodes that no longer have any uses.
+  for (auto index : bypassed_transposes_) {
+    auto* transpose_node = graph_.GetNode(index);
+    if ((transpose_node != nullptr) &&
+        (transpose_node->GetOutputEdgesCount() == 0) &&
+        graph_.GetNodeOutputsInGraphOutputs(*transpose_node).empty()) {
+      graph_.RemoveNode(index);
+      modified = true;
+    }
+  }
 }
 
 Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
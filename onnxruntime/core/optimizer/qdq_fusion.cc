@@ -0,0 +1,350 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+#include <cmath>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static int32_t GetElementType(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || type->value_case() != TypeProto::kTensorType) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+  return type->tensor_type().elem_type();
+}
+
+static bool IsScalarConstant(const Graph& graph, const NodeArg& node_arg, int32_t data_type) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != data_type) {
+    return false;
+  }
+  int64_t size = 1;
+  for (auto dim : tensor_proto->dims()) {
+    size *= dim;
+  }
+  return size == 1;
+}
+
+static float GetScalarConstant(const Graph& graph, const NodeArg& node_arg) {
+  Initializer initializer(*graph_utils::GetConstantInitializer(graph, node_arg.Name()));
+  return *initializer.data<float>();
+}
+
+// Returns the DequantizeLinear node producing the given input of the node, if it dequantizes data of the given type
+// with a constant scalar scale and zero point.
+static Node* GetDequantizeLinear(Graph& graph, const Node& node, int input_index, int32_t data_type) {
+  const Node* dequantize = graph_utils::GetInputNode(node, input_index);
+  if (dequantize == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*dequantize, "DequantizeLinear", {10}) ||
+      dequantize->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  const auto& inputs = dequantize->InputDefs();
+  if (inputs.size() != 3 || !inputs[2]->Exists() ||
+      GetElementType(*inputs[0]) != data_type ||
+      !IsScalarConstant(graph, *inputs[1], TensorProto_DataType_FLOAT) ||
+      !IsScalarConstant(graph, *inputs[2], data_type)) {
+    return nullptr;
+  }
+
+  return graph.GetNode(dequantize->Index());
+}
+
+// Returns the QuantizeLinear node that is the only consumer of the output of the node, if it quantizes to uint8 with
+// a constant scalar scale and zero point.
+static Node* GetQuantizeLinear(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return nullptr;
+  }
+
+  const Node& quantize = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(quantize, "QuantizeLinear", {10}) ||
+      quantize.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  const auto& inputs = quantize.InputDefs();
+  if (inputs.size() != 3 || !inputs[2]->Exists() ||
+      !IsScalarConstant(graph, *inputs[1], TensorProto_DataType_FLOAT) ||
+      !IsScalarConstant(graph, *inputs[2], TensorProto_DataType_UINT8)) {
+    return nullptr;
+  }
+
+  return graph.GetNode(quantize.Index());
+}
+
+// Adds an edge from the producer of an input of old_node to an input of new_node. Initializers and graph inputs have
+// no producer.
+static void CopyInputEdge(Graph& graph, const Node& old_node, int old_input_index, Node& new_node, int new_input_index) {
+  const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(old_node, old_input_index);
+  if (input_edge != nullptr) {
+    graph.AddEdge(input_edge->GetNode().Index(), new_node.Index(), input_edge->GetSrcArgIndex(), new_input_index);
+  }
+}
+
+// Moves the consumers of the output of last_node to the output of replacement, which produces the same NodeArg, and
+// removes the fused nodes. The DequantizeLinear nodes are only removed if they have no other consumers.
+static void RemoveFusedNodes(Graph& graph, Node& node, Node* quantize, const std::vector<NodeIndex>& dequantizes,
+                             Node& replacement) {
+  Node& last_node = quantize != nullptr ? *quantize : node;
+  graph_utils::ReplaceDownstreamNodeInput(graph, last_node, 0, replacement, 0);
+  if (quantize != nullptr) {
+    graph.RemoveNode(quantize->Index());
+  }
+  graph.RemoveNode(node.Index());
+
+  for (auto index : dequantizes) {
+    const Node* dequantize = graph.GetNode(index);
+    if (dequantize != nullptr && dequantize->GetOutputEdgesCount() == 0 &&
+        graph.GetNodeOutputsInGraphOutputs(*dequantize).empty()) {
+      graph.RemoveNode(index);
+    }
+  }
+}
+
+static bool FuseConv(Graph& graph, Node& conv) {
+  Node* dequantize_x = GetDequantizeLinear(graph, conv, 0, TensorProto_DataType_UINT8);
+  Node* dequantize_w = GetDequantizeLinear(graph, conv, 1, TensorProto_DataType_UINT8);
+  Node* quantize = GetQuantizeLinear(graph, conv);
+  if (dequantize_x == nullptr || dequantize_w == nullptr || quantize == nullptr) {
+    return false;
+  }
+
+  auto& x_inputs = dequantize_x->MutableInputDefs();
+  auto& w_inputs = dequantize_w->MutableInputDefs();
+  auto& y_inputs = quantize->MutableInputDefs();
+  std::vector<NodeArg*> inputs{x_inputs[0], x_inputs[1], x_inputs[2],
+                               w_inputs[0], w_inputs[1], w_inputs[2],
+                               y_inputs[1], y_inputs[2]};
+
+  // QLinearConv takes the bias as int32 values with the scale of the product of the input and the weight.
+  const auto& conv_inputs = conv.InputDefs();
+  if (conv_inputs.size() > 2 && conv_inputs[2]->Exists()) {
+    const auto* bias_tensor = graph_utils::GetConstantInitializer(graph, conv_inputs[2]->Name());
+    if (bias_tensor == nullptr || bias_tensor->data_type() != TensorProto_DataType_FLOAT) {
+      return false;
+    }
+
+    const float bias_scale = GetScalarConstant(graph, *x_inputs[1]) * GetScalarConstant(graph, *w_inputs[1]);
+    Initializer bias(*bias_tensor);
+    const float* bias_data = bias.data<float>();
+    std::vector<int32_t> quantized_bias(static_cast<size_t>(bias.size()));
+    for (size_t i = 0; i < quantized_bias.size(); ++i) {
+      quantized_bias[i] = static_cast<int32_t>(std::nearbyint(bias_data[i] / bias_scale));
+    }
+
+    TensorProto quantized_bias_tensor;
+    quantized_bias_tensor.set_name(graph.GenerateNodeArgName(bias_tensor->name() + "_quantized"));
+    quantized_bias_tensor.set_data_type(TensorProto_DataType_INT32);
+    *quantized_bias_tensor.mutable_dims() = bias_tensor->dims();
+    quantized_bias_tensor.set_raw_data(quantized_bias.data(), quantized_bias.size() * sizeof(int32_t));
+    inputs.push_back(&graph_utils::AddInitializer(graph, quantized_bias_tensor));
+  }
+
+  Node& qlinear_conv = graph.AddNode(graph.GenerateNodeName(conv.Name() + "_quant"),
+                                     "QLinearConv",
+                                     "fused DequantizeLinear, Conv and QuantizeLinear",
+                                     inputs,
+                                     {quantize->MutableOutputDefs()[0]},
+                                     &conv.GetAttributes(),
+                                     kOnnxDomain);
+  qlinear_conv.SetExecutionProviderType(conv.GetExecutionProviderType());
+
+  CopyInputEdge(graph, *dequantize_x, 0, qlinear_conv, 0);
+  CopyInputEdge(graph, *dequantize_w, 0, qlinear_conv, 3);
+  RemoveFusedNodes(graph, conv, quantize, {dequantize_x->Index(), dequantize_w->Index()}, qlinear_conv);
+  return true;
+}
+
+static bool FuseMatMul(Graph& graph, Node& matmul) {
+  Node* dequantize_a = GetDequantizeLinear(graph, matmul, 0, TensorProto_DataType_UINT8);
+  if (dequantize_a == nullptr) {
+    return false;
+  }
+
+  auto& a_inputs = dequantize_a->MutableInputDefs();
+  Node* quantize = GetQuantizeLinear(graph, matmul);
+  Node* dequantize_b = GetDequantizeLinear(graph, matmul, 1, TensorProto_DataType_UINT8);
+
+  if (dequantize_b != nullptr && quantize != nullptr) {
+    auto& b_inputs = dequantize_b->MutableInputDefs();
+    auto& y_inputs = quantize->MutableInputDefs();
+    Node& qlinear_matmul = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "_quant"),
+                                         "QLinearMatMul",
+                                         "fused DequantizeLinear, MatMul and QuantizeLinear",
+                                         {a_inputs[0], a_inputs[1], a_inputs[2],
+                                          b_inputs[0], b_inputs[1], b_inputs[2],
+                                          y_inputs[1], y_inputs[2]},
+                                         {quantize->MutableOutputDefs()[0]},
+                                         nullptr,
+                                         kOnnxDomain);
+    qlinear_matmul.SetExecutionProviderType(matmul.GetExecutionProviderType());
+
+    CopyInputEdge(graph, *dequantize_a, 0, qlinear_matmul, 0);
+    CopyInputEdge(graph, *dequantize_b, 0, qlinear_matmul, 3);
+    RemoveFusedNodes(graph, matmul, quantize, {dequantize_a->Index(), dequantize_b->Index()}, qlinear_matmul);
+    return true;
+  }
+
+  // otherwise compute the int32 product with MatMulInteger, which also takes int8 weights, and scale it to float.
+  if (dequantize_b == nullptr) {
+    dequantize_b = GetDequantizeLinear(graph, matmul, 1, TensorProto_DataType_INT8);
+    if (dequantize_b == nullptr) {
+      return false;
+    }
+  }
+
+  auto& b_inputs = dequantize_b->MutableInputDefs();
+  const auto& provider = matmul.GetExecutionProviderType();
+
+  TypeProto int32_type;
+  int32_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  auto& product = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(matmul.Name() + "_int32"), &int32_type);
+  Node& matmul_integer = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "_integer"),
+                                       "MatMulInteger",
+                                       "fused DequantizeLinear and MatMul",
+                                       {a_inputs[0], b_inputs[0], a_inputs[2], b_inputs[2]},
+                                       {&product},
+                                       nullptr,
+                                       kOnnxDomain);
+  matmul_integer.SetExecutionProviderType(provider);
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& float_product = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(matmul.Name() + "_float"), &float_type);
+  Node& cast = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "_cast"),
+                             "Cast",
+                             "",
+                             {&product},
+                             {&float_product},
+                             nullptr,
+                             kOnnxDomain);
+  cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  cast.SetExecutionProviderType(provider);
+
+  TensorProto scale_tensor;
+  scale_tensor.set_name(graph.GenerateNodeArgName(matmul.Name() + "_scale"));
+  scale_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  scale_tensor.add_float_data(GetScalarConstant(graph, *a_inputs[1]) * GetScalarConstant(graph, *b_inputs[1]));
+  NodeArg& scale = graph_utils::AddInitializer(graph, scale_tensor);
+
+  Node& mul = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "_scale"),
+                            "Mul",
+                            "",
+                            {&float_product, &scale},
+                            {matmul.MutableOutputDefs()[0]},
+                            nullptr,
+                            kOnnxDomain);
+  mul.SetExecutionProviderType(provider);
+
+  CopyInputEdge(graph, *dequantize_a, 0, matmul_integer, 0);
+  CopyInputEdge(graph, *dequantize_b, 0, matmul_integer, 1);
+  graph.AddEdge(matmul_integer.Index(), cast.Index(), 0, 0);
+  graph.AddEdge(cast.Index(), mul.Index(), 0, 0);
+  RemoveFusedNodes(graph, matmul, nullptr, {dequantize_a->Index(), dequantize_b->Index()}, mul);
+  return true;
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+// DequantizeLinear -> Add/Mul <- DequantizeLinear followed by a QuantizeLinear becomes QLinearAdd/QLinearMul.
+static bool FuseBinary(Graph& graph, Node& node, const std::string& qlinear_op_type) {
+  Node* dequantize_a = GetDequantizeLinear(graph, node, 0, TensorProto_DataType_UINT8);
+  Node* dequantize_b = GetDequantizeLinear(graph, node, 1, TensorProto_DataType_UINT8);
+  Node* quantize = GetQuantizeLinear(graph, node);
+  if (dequantize_a == nullptr || dequantize_b == nullptr || quantize == nullptr) {
+    return false;
+  }
+
+  auto& a_inputs = dequantize_a->MutableInputDefs();
+  auto& b_inputs = dequantize_b->MutableInputDefs();
+  auto& c_inputs = quantize->MutableInputDefs();
+  Node& qlinear_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_quant"),
+                                     qlinear_op_type,
+                                     "fused DequantizeLinear, " + node.OpType() + " and QuantizeLinear",
+                                     {a_inputs[0], a_inputs[1], a_inputs[2],
+                                      b_inputs[0], b_inputs[1], b_inputs[2],
+                                      c_inputs[1], c_inputs[2]},
+                                     {quantize->MutableOutputDefs()[0]},
+                                     nullptr,
+                                     kMSDomain);
+  qlinear_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  CopyInputEdge(graph, *dequantize_a, 0, qlinear_node, 0);
+  CopyInputEdge(graph, *dequantize_b, 0, qlinear_node, 3);
+  RemoveFusedNodes(graph, node, quantize, {dequantize_a->Index(), dequantize_b->Index()}, qlinear_node);
+  return true;
+}
+
+// DequantizeLinear -> AveragePool/GlobalAveragePool -> QuantizeLinear becomes QLinearAveragePool or
+// QLinearGlobalAveragePool with the attributes of the pooling node.
+static bool FusePool(Graph& graph, Node& node, const std::string& qlinear_op_type) {
+  Node* dequantize_x = GetDequantizeLinear(graph, node, 0, TensorProto_DataType_UINT8);
+  Node* quantize = GetQuantizeLinear(graph, node);
+  if (dequantize_x == nullptr || quantize == nullptr) {
+    return false;
+  }
+
+  auto& x_inputs = dequantize_x->MutableInputDefs();
+  auto& y_inputs = quantize->MutableInputDefs();
+  Node& qlinear_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_quant"),
+                                     qlinear_op_type,
+                                     "fused DequantizeLinear, " + node.OpType() + " and QuantizeLinear",
+                                     {x_inputs[0], x_inputs[1], x_inputs[2], y_inputs[1], y_inputs[2]},
+                                     {quantize->MutableOutputDefs()[0]},
+                                     &node.GetAttributes(),
+                                     kMSDomain);
+  qlinear_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  CopyInputEdge(graph, *dequantize_x, 0, qlinear_node, 0);
+  RemoveFusedNodes(graph, node, quantize, {dequantize_x->Index()}, qlinear_node);
+  return true;
+}
+#endif
+
+Status QDQFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11})) {
+      modified |= FuseConv(graph, node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) {
+      modified |= FuseMatMul(graph, node);
+    }
+#ifndef DISABLE_CONTRIB_OPS
+    else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7})) {
+      modified |= FuseBinary(graph, node, "QLinearAdd");
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+      modified |= FuseBinary(graph, node, "QLinearMul");
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10, 11})) {
+      modified |= FusePool(graph, node, "QLinearAveragePool");
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1})) {
+      modified |= FusePool(graph, node, "QLinearGlobalAveragePool");
+    }
+#endif
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
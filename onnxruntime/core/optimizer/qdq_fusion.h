@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQFusion
+
+Rewrite the Conv and MatMul nodes whose inputs are produced by DequantizeLinear nodes into the quantized operators,
+so the computation runs on the 8-bit data instead of the dequantized float values.
+ - DequantizeLinear -> Conv -> QuantizeLinear becomes QLinearConv. A constant float bias is quantized to int32 with
+   the product of the input and weight scales.
+ - DequantizeLinear -> MatMul -> QuantizeLinear becomes QLinearMatMul.
+ - DequantizeLinear -> MatMul without a QuantizeLinear becomes MatMulInteger, followed by a Cast to float and a Mul
+   by the product of the input scales.
+ - DequantizeLinear -> Add/Mul -> QuantizeLinear becomes the QLinearAdd/QLinearMul contrib op, and
+   DequantizeLinear -> AveragePool/GlobalAveragePool -> QuantizeLinear becomes QLinearAveragePool or
+   QLinearGlobalAveragePool, so the residual connections and pooling between quantized convolutions stay in uint8.
+The scales and zero points must be constant scalars, and the quantized data must have the types supported by the
+CPU kernels of the quantized operators.
+*/
+class QDQFusion : public GraphTransformer {
+ public:
+  QDQFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
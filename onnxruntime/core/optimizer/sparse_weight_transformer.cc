@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/sparse_weight_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status SparseWeightTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the packed weights by the name and transB of the dense weight, so nodes sharing a weight share the packed
+  // weight. The weights that aren't sparse enough map to nullptr.
+  std::map<std::pair<std::string, bool>, NodeArg*> packed_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+    if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    auto& input_defs = node.MutableInputDefs();
+    const TensorProto* weight_tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph, *input_defs[1]) ||
+        !graph.GetInitializedTensor(input_defs[1]->Name(), weight_tensor_proto) ||
+        weight_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weight_tensor_proto->dims_size() != 2) {
+      continue;
+    }
+
+    const auto* trans_b_attr = graph_utils::GetNodeAttribute(node, "transB");
+    const bool trans_b = is_gemm && trans_b_attr != nullptr && trans_b_attr->i() != 0;
+    const int64_t K = weight_tensor_proto->dims(trans_b ? 1 : 0);
+    const int64_t N = weight_tensor_proto->dims(trans_b ? 0 : 1);
+    if (K == 0 || N == 0) {
+      continue;
+    }
+
+    auto packed_it = packed_weights.find({input_defs[1]->Name(), trans_b});
+    if (packed_it == packed_weights.end()) {
+      NodeArg* packed_weight_arg = nullptr;
+
+      Initializer weight{*weight_tensor_proto};
+      const float* weight_data = weight.data<float>();
+      const size_t zero_count = static_cast<size_t>(
+          std::count(weight_data, weight_data + weight.size(), 0.0f));
+
+      const auto trans = trans_b ? CblasTrans : CblasNoTrans;
+      const size_t n = static_cast<size_t>(N);
+      const size_t k = static_cast<size_t>(K);
+      const size_t ldb = trans_b ? k : n;
+
+      if (zero_count >= min_zero_ratio_ * weight.size() &&
+          MlasSparseGemmEstimateSpeedup(trans, n, k, weight_data, ldb) >= min_speedup_) {
+        const size_t packed_size = MlasSparseGemmPackBSize(trans, n, k, weight_data, ldb);
+        if (packed_size != 0) {
+          std::vector<uint8_t> packed_weight(packed_size);
+          MlasSparseGemmPackB(trans, n, k, weight_data, ldb, packed_weight.data());
+
+          TensorProto packed_weight_tensor_proto;
+          packed_weight_tensor_proto.set_data_type(TensorProto_DataType_UINT8);
+          packed_weight_tensor_proto.set_name(graph.GenerateNodeArgName(input_defs[1]->Name() + "_sparse"));
+          packed_weight_tensor_proto.set_raw_data(packed_weight.data(), packed_size);
+          packed_weight_tensor_proto.add_dims(static_cast<int64_t>(packed_size));
+          graph.AddInitializedTensor(packed_weight_tensor_proto);
+
+          packed_weight_arg = &graph.GetOrCreateNodeArg(packed_weight_tensor_proto.name(), nullptr);
+        }
+      }
+
+      packed_it = packed_weights.emplace(std::make_pair(input_defs[1]->Name(), trans_b), packed_weight_arg).first;
+    }
+
+    if (packed_it->second == nullptr) {
+      continue;
+    }
+
+    std::vector<NodeArg*> sparse_inputs{input_defs[0], packed_it->second};
+    if (is_gemm && input_defs.size() > 2 && input_defs[2]->Exists()) {
+      sparse_inputs.push_back(input_defs[2]);
+    }
+
+    Node& sparse_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_SparseGemm"),
+                                      "SparseGemm",
+                                      "sparse weight " + node.OpType(),
+                                      sparse_inputs,
+                                      {},
+                                      nullptr,
+                                      kMSDomain);
+    sparse_node.SetExecutionProviderType(node.GetExecutionProviderType());
+    sparse_node.AddAttribute("N", N);
+    sparse_node.AddAttribute("K", K);
+    if (is_gemm) {
+      for (const char* name : {"transA", "alpha", "beta"}) {
+        const auto* attr = graph_utils::GetNodeAttribute(node, name);
+        if (attr != nullptr) {
+          sparse_node.AddAttribute(name, *attr);
+        }
+      }
+    }
+
+    // the dense weight is removed with the other unused initializers once the graph is resolved
+    graph_utils::FinalizeNodeFusion(graph, std::vector<std::reference_wrapper<Node>>{node}, sparse_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
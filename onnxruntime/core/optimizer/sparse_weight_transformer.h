@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SparseWeightTransformer
+
+Replace the float MatMul and Gemm nodes whose constant 2-D weight is mostly zeros, such as the weights of a model
+pruned by magnitude, with SparseGemm nodes. The weight is replaced by its MlasSparseGemmPackB format, which only
+stores the non-zero values. A weight is converted if at least min_zero_ratio of its values are zero and
+MlasSparseGemmEstimateSpeedup expects the sparse multiply to be at least min_speedup times faster.
+*/
+class SparseWeightTransformer : public GraphTransformer {
+ public:
+  SparseWeightTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                          float min_zero_ratio = 0.9f,
+                          float min_speedup = 1.2f) noexcept
+      : GraphTransformer("SparseWeightTransformer", compatible_execution_providers),
+        min_zero_ratio_(min_zero_ratio),
+        min_speedup_(min_speedup) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const float min_zero_ratio_;
+  const float min_speedup_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <unordered_set>
+#include "core/optimizer/transpose_elimination.h"
+#include "core/graph/graph.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/op.h"
+
+namespace onnxruntime {
+
+// Elementwise operators with a single layout dependent input. For Clip, the
+// optional min and max inputs are scalars.
+static bool IsUnaryElementwiseNode(const Node& node) {
+  static const std::unordered_set<std::string> unary_op_types = {
+      "Abs", "Ceil", "Clip", "Elu", "Erf", "Exp", "Floor", "HardSigmoid", "LeakyRelu", "Log", "Neg",
+      "Reciprocal", "Relu", "Selu", "Sigmoid", "Softplus", "Softsign", "Sqrt", "Tanh"};
+
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) &&
+         unary_op_types.find(node.OpType()) != unary_op_types.end();
+}
+
+// Returns true if the single output of the node is only consumed by one node
+// and is not a graph output.
+static bool HasSingleConsumer(const Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 1 &&
+         node.OutputDefs().size() == 1 &&
+         graph.GetNodeOutputsInGraphOutputs(node).empty();
+}
+
+// Moves the edge that feeds the first input of the source node to the first
+// input of the target node. Inputs from graph inputs or initializers have no
+// edge.
+static void MoveFirstInputEdge(Graph& graph, Node& src_node, Node& target_node) {
+  target_node.MutableInputDefs()[0] = src_node.MutableInputDefs()[0];
+  const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(src_node, 0);
+  if (input_edge != nullptr) {
+    const NodeIndex input_node_index = input_edge->GetNode().Index();
+    const int input_arg_index = input_edge->GetSrcArgIndex();
+    graph.RemoveEdge(input_node_index, src_node.Index(), input_arg_index, 0);
+    graph.AddEdge(input_node_index, target_node.Index(), input_arg_index, 0);
+  }
+}
+
+// Finds the Transpose node that feeds the given Transpose node, possibly
+// through a chain of unary elementwise nodes. The chain is returned in
+// reverse order, so the last node of the chain consumes the output of the
+// preceding Transpose node.
+static const Node* FindPrecedingTranspose(const Graph& graph, const Node& node, std::vector<const Node*>& chain) {
+  chain.clear();
+  const Node* input_node = graph_utils::GetInputNode(node, 0);
+  while (input_node != nullptr && HasSingleConsumer(graph, *input_node) &&
+         input_node->GetExecutionProviderType() == node.GetExecutionProviderType()) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, "Transpose", {1})) {
+      return input_node;
+    }
+    if (!IsUnaryElementwiseNode(*input_node) || input_node->GetInputEdgesCount() != 1 ||
+        graph_utils::GetInputNode(*input_node, 0) == nullptr) {
+      break;
+    }
+    chain.push_back(input_node);
+    input_node = graph_utils::GetInputNode(*input_node, 0);
+  }
+  return nullptr;
+}
+
+bool EliminateTranspose::SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger&) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+    return false;
+  }
+
+  std::vector<const Node*> chain;
+  const Node* transpose_node = FindPrecedingTranspose(graph, node, chain);
+  if (transpose_node == nullptr) {
+    return false;
+  }
+
+  // Both permutations must be explicit and of the same rank.
+  std::vector<int64_t> perm;
+  std::vector<int64_t> input_perm;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm) ||
+      !graph_utils::GetRepeatedNodeAttributeValues(*transpose_node, "perm", input_perm) ||
+      perm.size() != input_perm.size()) {
+    return false;
+  }
+  for (auto p : perm) {
+    if (p < 0 || static_cast<size_t>(p) >= perm.size()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status EliminateTranspose::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const {
+  std::vector<const Node*> chain;
+  Node& transpose_node = *graph.GetNode(FindPrecedingTranspose(graph, node, chain)->Index());
+
+  // Move the preceding Transpose node past the chain of unary elementwise
+  // nodes, so that it directly feeds this node.
+  if (!chain.empty()) {
+    Node& first_node = *graph.GetNode(chain.back()->Index());
+    Node& last_node = *graph.GetNode(chain.front()->Index());
+
+    graph.RemoveEdge(transpose_node.Index(), first_node.Index(), 0, 0);
+    graph.RemoveEdge(last_node.Index(), node.Index(), 0, 0);
+
+    MoveFirstInputEdge(graph, transpose_node, first_node);
+
+    transpose_node.MutableInputDefs()[0] = last_node.MutableOutputDefs()[0];
+    graph.AddEdge(last_node.Index(), transpose_node.Index(), 0, 0);
+
+    node.MutableInputDefs()[0] = transpose_node.MutableOutputDefs()[0];
+    graph.AddEdge(transpose_node.Index(), node.Index(), 0, 0);
+
+    // The outputs of the chain are no longer transposed, so let shape
+    // inferencing recompute their shapes.
+    for (const Node* chain_node : chain) {
+      graph.GetNode(chain_node->Index())->MutableOutputDefs()[0]->ClearShape();
+    }
+  }
+
+  // Compose the permutations: output dimension i of this node is dimension
+  // perm[i] of the preceding Transpose output, which is itself dimension
+  // input_perm[perm[i]] of the preceding Transpose input.
+  std::vector<int64_t> perm;
+  std::vector<int64_t> input_perm;
+  graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm);
+  graph_utils::GetRepeatedNodeAttributeValues(transpose_node, "perm", input_perm);
+
+  bool is_identity = true;
+  std::vector<int64_t> merged_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    merged_perm[i] = input_perm[static_cast<size_t>(perm[i])];
+    is_identity = is_identity && (merged_perm[i] == static_cast<int64_t>(i));
+  }
+
+  // Feed the input of the preceding Transpose node directly into this node
+  // and remove the preceding Transpose node.
+  graph.RemoveEdge(transpose_node.Index(), node.Index(), 0, 0);
+  MoveFirstInputEdge(graph, transpose_node, node);
+  graph.RemoveNode(transpose_node.Index());
+
+  node.AddAttribute("perm", merged_perm);
+  rule_effect = RewriteRuleEffect::kUpdatedCurrentNode;
+
+  // Remove this node if the permutations cancelled out.
+  if (is_identity) {
+    if (graph_utils::CanRemoveNode(graph, node, logger)) {
+      if (graph_utils::RemoveNode(graph, node)) {
+        rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+      }
+    } else {
+      // This node produces a graph output, so move the output to the node
+      // that feeds this node if that is the only use of its output.
+      const Node* input_node = graph_utils::GetInputNode(node, 0);
+      if (input_node != nullptr && HasSingleConsumer(graph, *input_node)) {
+        graph_utils::FinalizeNodeFusion(graph, *graph.GetNode(input_node->Index()), node);
+        rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
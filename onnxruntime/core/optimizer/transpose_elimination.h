@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class EliminateTranspose
+
+Rewrite rule that merges a Transpose node with a preceding Transpose node, removing both nodes if the
+permutations cancel out. The preceding Transpose node is first moved past any chain of unary elementwise
+nodes between the two Transpose nodes. Models converted from NHWC frameworks typically wrap each operator
+with a pair of Transpose nodes, so this removes the Transpose nodes between the operators.
+
+It is attempted to be triggered only on nodes with op type "Transpose".
+*/
+class EliminateTranspose : public RewriteRule {
+ public:
+  EliminateTranspose() noexcept : RewriteRule("EliminateTranspose") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Transpose"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger& logger) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
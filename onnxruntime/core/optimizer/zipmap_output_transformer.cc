@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_output_transformer.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status ZipMapOutputTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  // ZipMap is only sensible at the end of the main graph, where its sequence of maps is handed to the caller.
+  if (graph.IsSubgraph()) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ZipMap", {1}, kMLDomain) ||
+        node.GetOutputEdgesCount() != 0 || graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+      continue;
+    }
+
+    NodeArg* input = node.MutableInputDefs()[0];
+    NodeArg* output = node.MutableOutputDefs()[0];
+    if (input->TypeAsProto() == nullptr || !utils::HasTensorType(*input->TypeAsProto())) {
+      continue;
+    }
+
+    const Node* producer = nullptr;
+    int producer_output_index = 0;
+    if (node.GetInputEdgesCount() == 1) {
+      producer = &node.InputEdgesBegin()->GetNode();
+      producer_output_index = node.InputEdgesBegin()->GetSrcArgIndex();
+    }
+
+    const std::string name = node.Name();
+    graph.RemoveNode(node.Index());
+
+    // the output takes the type and shape of the scores the ZipMap would have zipped with the labels
+    graph.SetNodeArgType(*output, *input->TypeAsProto());
+    Node& identity = graph.AddNode(graph.GenerateNodeName(name + "_scores"), "Identity",
+                                   "scores of the removed ZipMap " + name, {input}, {output});
+    if (producer != nullptr) {
+      graph.AddEdge(producer->Index(), identity.Index(), producer_output_index, 0);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
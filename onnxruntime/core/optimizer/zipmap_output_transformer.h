@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapOutputTransformer
+Replace the ZipMap nodes that only produce a graph output with an Identity node, so the output is the [N, C] float
+tensor of class scores instead of a sequence of maps. The tensor is allocated like any other output, without a heap
+allocation per class and row, and column j holds the score of the j-th label in the classlabels attribute of the
+removed ZipMap. The output keeps its name, so only its type changes.
+*/
+class ZipMapOutputTransformer : public GraphTransformer {
+ public:
+  ZipMapOutputTransformer() noexcept : GraphTransformer("ZipMapOutputTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
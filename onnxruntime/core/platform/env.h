@@ -67,6 +67,12 @@ class Env {
 
   virtual int GetNumCpuCores() const = 0;
 
+  /// \brief Gets the ids of the logical processors that belong to the given NUMA node.
+  virtual common::Status GetNumaNodeCpus(int numa_node, /*out*/ std::vector<int>& cpus) const = 0;
+
+  /// \brief Restricts the calling thread to run on the given logical processors.
+  virtual common::Status SetCurrentThreadAffinity(const std::vector<int>& cpus) const = 0;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const { return env_time_->NowMicros(); }
 
@@ -26,10 +26,15 @@ limitations under the License.
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <string.h>
+#include <fstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
 #include <assert.h>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -97,6 +102,58 @@ class PosixEnv : public Env {
     return std::thread::hardware_concurrency();
   }
 
+  common::Status GetNumaNodeCpus(int numa_node, std::vector<int>& cpus) const override {
+#if defined(__linux__)
+    cpus.clear();
+    const std::string path = "/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist";
+    std::ifstream cpulist(path);
+    if (!cpulist) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " was not found. Could not open ",
+                             path);
+    }
+
+    // format is a comma separated list of ids or inclusive ranges. e.g. "0-3,8-11"
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+      const auto dash = range.find('-');
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+    ORT_UNUSED_PARAMETER(cpus);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA node information is not supported on this platform");
+#endif
+  }
+
+  common::Status SetCurrentThreadAffinity(const std::vector<int>& cpus) const override {
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid logical processor id: ", cpu);
+      }
+      CPU_SET(cpu, &cpuset);
+    }
+
+    const int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (ret != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "pthread_setaffinity_np failed. error code: ", ret);
+    }
+
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(cpus);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform");
+#endif
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -215,6 +272,11 @@ class PosixEnv : public Env {
       return ReportSystemError("mmap", file_path);
     }
 
+    // start reading the range in the background, in large blocks instead of one page per fault. the data of a
+    // mapped initializer is usually read right away, when it's deserialized or copied to a device, or by the first
+    // Run. it's only a hint, so a failure is ignored.
+    madvise(mapped_base, mapped_length, MADV_WILLNEED);
+
     mapped_memory = MappedMemoryPtr{
         reinterpret_cast<char*>(mapped_base) + offset_to_page,
         OrtCallbackInvoker{OrtCallback{UnmapFile, new UnmapFileParam{mapped_base, mapped_length}}}};
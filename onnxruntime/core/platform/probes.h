@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+// User-level statically defined tracing (USDT) probes in the provider "onnxruntime", for correlating node execution
+// and arena allocations with perf, bpftrace or SystemTap samples, e.g.
+//
+//   perf buildid-cache --add libonnxruntime.so && perf record -e sdt_onnxruntime:node_start ...
+//   bpftrace -e 'usdt:libonnxruntime.so:onnxruntime:node_end { @[str(arg2)] = hist(arg3); }'
+//
+// A probe compiles to a nop and a note in the binary when the build sets ONNXRUNTIME_ENABLE_USDT_PROBES
+// (onnxruntime_ENABLE_USDT_PROBES, Linux with sys/sdt.h), and to nothing otherwise. The arguments of an enabled
+// probe are evaluated whether or not a tool is attached, so they must be cheap.
+//
+// node_start(session_state, node_index, op_type, node_name)
+// node_end(session_state, node_index, op_type, status_code)
+// arena_alloc(arena, ptr, requested_bytes, allocated_bytes)
+// arena_free(arena, ptr, allocated_bytes)
+
+#ifdef ONNXRUNTIME_ENABLE_USDT_PROBES
+#include <sys/sdt.h>
+
+#define ORT_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(onnxruntime, name, a1, a2, a3)
+#define ORT_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(onnxruntime, name, a1, a2, a3, a4)
+#else
+#define ORT_PROBE3(name, a1, a2, a3)
+#define ORT_PROBE4(name, a1, a2, a3, a4)
+#endif
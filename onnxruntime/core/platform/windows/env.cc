@@ -78,6 +78,40 @@ class WindowsEnv : public Env {
     return processorCoreCount;
   }
 
+  // Only processors in the current processor group (at most 64) are supported.
+  common::Status GetNumaNodeCpus(int numa_node, std::vector<int>& cpus) const override {
+    cpus.clear();
+    ULONGLONG mask = 0;
+    if (numa_node < 0 || numa_node > 0xFF || !GetNumaNodeProcessorMask(static_cast<UCHAR>(numa_node), &mask)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " was not found");
+    }
+
+    for (int cpu = 0; cpu < 64; ++cpu) {
+      if (mask & (1ULL << cpu)) {
+        cpus.push_back(cpu);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  common::Status SetCurrentThreadAffinity(const std::vector<int>& cpus) const override {
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+      if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid logical processor id: ", cpu);
+      }
+      mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "SetThreadAffinityMask failed. error code: ", err);
+    }
+
+    return Status::OK();
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
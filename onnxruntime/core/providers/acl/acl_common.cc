@@ -8,8 +8,12 @@
 
 #include "core/providers/acl/acl_common.h"
 
+#include <cstring>
+
 #include "arm_compute/runtime/PoolManager.h"
 #include "arm_compute/runtime/BlobLifetimeManager.h"
+#include "arm_compute/core/Helpers.h"
+#include "arm_compute/core/Window.h"
 
 #undef ACL_1902
 
@@ -59,5 +63,21 @@ arm_compute::Status ACLImportMemory(arm_compute::TensorAllocator* allocator, voi
 #endif
 }
 
+void ACLCopyToTensor(arm_compute::Tensor* tensor, const float* data) {
+  // visit the rows in the order of the dense buffer, from the innermost dimension outwards
+  arm_compute::Window window;
+  window.use_tensor_dimensions(tensor->info()->tensor_shape(), arm_compute::Window::DimY);
+
+  arm_compute::Iterator it(tensor, window);
+  const size_t width = tensor->info()->dimension(0);
+  arm_compute::execute_window_loop(
+      window,
+      [&](const arm_compute::Coordinates&) {
+        std::memcpy(it.ptr(), data, width * sizeof(float));
+        data += width;
+      },
+      it);
+}
+
 }  // namespace acl
 }  // namespace onnxruntime
@@ -18,6 +18,8 @@ arm_compute::TensorShape ACLTensorShape(const TensorShape& tensorShape, unsigned
 void ACLPrintTensorShape(const char*, arm_compute::Tensor& t);
 std::shared_ptr<arm_compute::MemoryManagerOnDemand> ACLCreateMemoryManager();
 arm_compute::Status ACLImportMemory(arm_compute::TensorAllocator* allocator, void* memory, size_t size);
+// Copies a dense buffer into an allocated tensor whose rows are padded for the function it feeds.
+void ACLCopyToTensor(arm_compute::Tensor* tensor, const float* data);
 
 }  // namespace acl
 }  // namespace onnxruntime
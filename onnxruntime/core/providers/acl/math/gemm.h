@@ -33,6 +33,8 @@ typedef struct {
   std::shared_ptr<arm_compute::IFunction> layer;
   std::shared_ptr<arm_compute::Tensor> a, b, c, d;
   std::shared_ptr<arm_compute::MemoryManagerOnDemand> mm_layer;
+  // the shapes the layer is configured for
+  TensorShape a_shape, b_shape, c_shape;
 } ACLNEGEMM;
 
 typedef std::map<OpKernel*, ACLNEGEMM>::iterator GEMMLayersIterator;
@@ -68,6 +70,15 @@ class Gemm : public onnxruntime::Gemm<T> {
 
     bool FC = ((alpha_ == 1 && beta_ == 1) || (alpha_ == 1 && beta_ == 0));
 
+    // the fully connected layer reads X as is
+#ifdef GEMM_ACL
+    if (trans_A_ == CblasTrans)
+      return onnxruntime::Gemm<T>::Compute(context);
+#else
+    if (!FC || trans_A_ == CblasTrans)
+      return onnxruntime::Gemm<T>::Compute(context);
+#endif
+
     int64_t K = helper.K();
     LOGS_DEFAULT(VERBOSE) << "Gemm ACL:" << std::endl;
     if (X) LOGS_DEFAULT(VERBOSE) << "X " << X->Shape().ToString().c_str() << std::endl;
@@ -82,8 +93,17 @@ class Gemm : public onnxruntime::Gemm<T> {
 
     ACLNEGEMM* pGEMM;
     GEMMLayersIterator it = gemmLayers.find((OpKernel*)this);
+    if (it != gemmLayers.end() &&
+        (it->second.a_shape != X->Shape() || it->second.b_shape != W->Shape() || it->second.c_shape != B->Shape())) {
+      // the layer was configured for other shapes
+      gemmLayers.erase(it);
+      it = gemmLayers.end();
+    }
     if (it == gemmLayers.end()) {
       ACLNEGEMM tGEMM;
+      tGEMM.a_shape = X->Shape();
+      tGEMM.b_shape = W->Shape();
+      tGEMM.c_shape = B->Shape();
       tGEMM.a = std::make_shared<arm_compute::Tensor>();
       tGEMM.b = std::make_shared<arm_compute::Tensor>();
       tGEMM.c = std::make_shared<arm_compute::Tensor>();
@@ -121,13 +141,9 @@ class Gemm : public onnxruntime::Gemm<T> {
         layer->configure(tGEMM.a.get(), tGEMM.b.get(), (B != nullptr && beta_ != 0) ? tGEMM.c.get() : nullptr, tGEMM.d.get());
         tGEMM.layer = std::move(layer);
       } else {
-#ifdef GEMM_ACL
         auto layer = std::make_shared<arm_compute::NEGEMM>(tGEMM.mm_layer);
         layer->configure(tGEMM.a.get(), tGEMM.b.get(), (B != nullptr && beta_ != 0) ? tGEMM.c.get() : nullptr, tGEMM.d.get(), alpha_, beta_, arm_compute::GEMMInfo());
         tGEMM.layer = std::move(layer);
-#else
-        return onnxruntime::Gemm<T>::Compute(context);
-#endif
       }
 
       // non-transpose
@@ -140,7 +156,6 @@ class Gemm : public onnxruntime::Gemm<T> {
       ret = gemmLayers.insert(std::pair<OpKernel*, ACLNEGEMM>((OpKernel*)this, tGEMM));
       pGEMM = &ret.first->second;
     } else {
-      //TODO: valildate shapes
       pGEMM = &it->second;
 
       // transpose
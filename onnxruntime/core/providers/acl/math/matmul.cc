@@ -3,6 +3,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/providers/cpu/math/matmul_helper.h"
 
 /*
 #include "core/util/math.h"
@@ -10,11 +11,98 @@
 */
 
 #include "core/providers/acl/acl_common.h"
+#include "core/providers/acl/math/matmul.h"
 #include "core/providers/acl/acl_fwd.h"
 
+// ACL
+#include "arm_compute/core/TensorInfo.h"
+#include "arm_compute/runtime/Allocator.h"
+
 namespace onnxruntime {
 namespace acl {
 
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  const Tensor* A = ctx->Input<Tensor>(0);
+  const Tensor* B = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(A->Shape(), B->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  LOGS_DEFAULT(VERBOSE) << "MatMul ACL:" << std::endl;
+  LOGS_DEFAULT(VERBOSE) << "A " << A->Shape().ToString().c_str() << std::endl;
+  LOGS_DEFAULT(VERBOSE) << "B " << B->Shape().ToString().c_str() << std::endl;
+  LOGS_DEFAULT(VERBOSE) << "Y " << Y->Shape().ToString().c_str() << std::endl;
+  LOGS_DEFAULT(VERBOSE) << std::endl;
+
+  // A of rank 2 or more is one (M, K) matrix for a B of rank 2, the batches of other B go to the CPU provider
+  if (A->Shape().NumDimensions() < 2 || B->Shape().NumDimensions() != 2 || Y->Shape().Size() == 0)
+    return cpu_matmul_.Compute(ctx);
+
+  const int64_t K = B->Shape()[0];
+  const int64_t N = B->Shape()[1];
+  const int64_t M = A->Shape().Size() / K;
+
+  ACLNEMatMul* pMatMul;
+  MatMulLayersIterator it = matmulLayers.find((OpKernel*)this);
+  if (it != matmulLayers.end() && (it->second.a_shape != A->Shape() || it->second.b_shape != B->Shape())) {
+    // the layer was configured for other shapes
+    matmulLayers.erase(it);
+    it = matmulLayers.end();
+  }
+  if (it == matmulLayers.end()) {
+    ACLNEMatMul tMatMul;
+    tMatMul.a_shape = A->Shape();
+    tMatMul.b_shape = B->Shape();
+    tMatMul.a = std::make_shared<arm_compute::Tensor>();
+    tMatMul.b = std::make_shared<arm_compute::Tensor>();
+    tMatMul.d = std::make_shared<arm_compute::Tensor>();
+
+    // dimensions are stored in the opposite order to ACL's
+    tMatMul.a->allocator()->init(arm_compute::TensorInfo(arm_compute::TensorShape(K, M), arm_compute::Format::F32));
+    tMatMul.b->allocator()->init(arm_compute::TensorInfo(arm_compute::TensorShape(N, K), arm_compute::Format::F32));
+    tMatMul.d->allocator()->init(arm_compute::TensorInfo(arm_compute::TensorShape(N, M), arm_compute::Format::F32));
+
+    tMatMul.mm_layer = ACLCreateMemoryManager();
+
+    auto layer = std::make_shared<arm_compute::NEGEMM>(tMatMul.mm_layer);
+    layer->configure(tMatMul.a.get(), tMatMul.b.get(), nullptr, tMatMul.d.get(), 1.f, 0.f,
+                     arm_compute::GEMMInfo(false, false, b_is_constant_));
+    tMatMul.layer = std::move(layer);
+
+    std::pair<MatMulLayersIterator, bool> ret;
+    ret = matmulLayers.insert(std::pair<OpKernel*, ACLNEMatMul>((OpKernel*)this, tMatMul));
+    pMatMul = &ret.first->second;
+  } else {
+    pMatMul = &it->second;
+  }
+
+  const float* a_data = A->template Data<float>();
+  const float* b_data = B->template Data<float>();
+  float* d_data = Y->template MutableData<float>();
+
+  ACLImportMemory(pMatMul->a->allocator(), (void*)a_data, A->Shape().Size() * 4);
+  ACLImportMemory(pMatMul->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
+  ACLImportMemory(pMatMul->d->allocator(), (void*)d_data, Y->Shape().Size() * 4);
+
+  ACLPrintTensorShape("a", *pMatMul->a);
+  ACLPrintTensorShape("b", *pMatMul->b);
+  ACLPrintTensorShape("d", *pMatMul->d);
+
+  arm_compute::Allocator alloc_mm{};
+  pMatMul->mm_layer->populate(alloc_mm, 1);
+  pMatMul->layer->run();
+  pMatMul->mm_layer->clear();
+
+  pMatMul->a->allocator()->free();
+  pMatMul->b->allocator()->free();
+  pMatMul->d->allocator()->free();
+
+  return Status::OK();
+}
+
 ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(
     MatMul,
     kOnnxDomain,
@@ -6,35 +6,60 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/matmul.h"
+#include "core/providers/acl/acl_execution_provider.h"
+
+// ACL
+#include "arm_compute/runtime/Tensor.h"
+#include "arm_compute/runtime/MemoryManagerOnDemand.h"
+
+//NEON
+#include "arm_compute/runtime/NEON/functions/NEGEMM.h"
 
 namespace onnxruntime {
 namespace acl {
 
+typedef struct {
+  std::shared_ptr<arm_compute::IFunction> layer;
+  std::shared_ptr<arm_compute::Tensor> a, b, d;
+  std::shared_ptr<arm_compute::MemoryManagerOnDemand> mm_layer;
+  // the shapes the layer is configured for
+  TensorShape a_shape, b_shape;
+} ACLNEMatMul;
+
+typedef std::map<OpKernel*, ACLNEMatMul>::iterator MatMulLayersIterator;
+
+// Runs float MatMul on NEGEMM, and the other types and shapes on the CPU provider's kernel.
 template <typename T>
-class MatMul final : public onnxruntime::MatMul<T> {
+class MatMul final : public OpKernel {
  public:
   MatMul(const OpKernelInfo& info)
-      : onnxruntime::MatMul<T>(info) {
+      : OpKernel(info), cpu_matmul_(info) {
+    const Tensor* B;
+    b_is_constant_ = info.TryGetConstantInput(1, &B);
   }
 
   Status Compute(OpKernelContext* ctx) const override {
-    const Tensor* left_X = ctx->Input<Tensor>(0);
-    const Tensor* right_X = ctx->Input<Tensor>(1);
-
-    MatMulComputeHelper helper;
-    ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+    return cpu_matmul_.Compute(ctx);
+  }
 
-    Tensor* Y = ctx->Output(0, helper.OutputShape());
+  ~MatMul() {
+    matmulLayers.erase(this);
+  }
 
-    LOGS_DEFAULT(VERBOSE) << "MatMul ACL:" << std::endl;
-    if (left_X) LOGS_DEFAULT(VERBOSE) << "left_X " << left_X->Shape().ToString().c_str() << std::endl;
-    if (right_X) LOGS_DEFAULT(VERBOSE) << "right_X " << right_X->Shape().ToString().c_str() << std::endl;
-    if (Y) LOGS_DEFAULT(VERBOSE) << "Y " << Y->Shape().ToString().c_str() << std::endl;
-    LOGS_DEFAULT(VERBOSE) << std::endl;
+ private:
+  static thread_local std::map<OpKernel*, ACLNEMatMul> matmulLayers;
 
-    return onnxruntime::MatMul<T>::Compute(ctx);
-  }
+  onnxruntime::MatMul<T> cpu_matmul_;
+  // the layer reshapes B once only if B is an initializer
+  bool b_is_constant_;
 };
 
+template <typename T>
+thread_local std::map<OpKernel*, ACLNEMatMul> onnxruntime::acl::MatMul<T>::matmulLayers;
+
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const;
+
 }  // namespace acl
 }  // namespace onnxruntime
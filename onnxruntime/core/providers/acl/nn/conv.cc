@@ -55,20 +55,26 @@ template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
 
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+
   ACLNEConv* pConv;
   ConvLayersIterator it = Conv::convLayers.find((OpKernel*)this);
+  if (it != Conv::convLayers.end() &&
+      (it->second.x_shape != X->Shape() || it->second.w_shape != W->Shape())) {
+    // the layers were configured for other shapes
+    Conv::convLayers.erase(it);
+    it = Conv::convLayers.end();
+  }
   if (it != Conv::convLayers.end()) {
     pConv = &it->second;
-    if(pConv->isDepthwiseCPU == true) {
+    if (pConv->isCPU == true) {
       Status s = onnxruntime::Conv<T>::Compute(context);
       return s;
     }
   }
 
-  const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
-  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
-
   const int64_t N = X->Shape()[0];
   const int64_t M = W->Shape()[0];
 
@@ -126,29 +132,44 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   }
 
   if (it == Conv::convLayers.end()) {
+    const int64_t C = X->Shape()[1];
+    const int64_t group = conv_attrs_.group;
 
-    auto mm_layer = ACLCreateMemoryManager();
+    // A depthwise convolution has a group for each input channel, and runs as one layer with a depth multiplier.
+    // The layers of the other grouped convolutions each read the channels of a group, which are contiguous in a
+    // batch of one image only.
+    const bool isDepthwise = group > 1 && group == C;
+    const int64_t numLayers = isDepthwise ? 1 : group;
 
     ACLNEConv tconv;
-    tconv.mm_layer = std::move(mm_layer);
+    tconv.mm_layer = ACLCreateMemoryManager();
+    tconv.isCPU = false;
+    tconv.x_shape = X->Shape();
+    tconv.w_shape = W->Shape();
+
+    if (numLayers > 1 && N != 1) {
+      tconv.isCPU = true;
+      Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
+      return onnxruntime::Conv<T>::Compute(context);
+    }
+
+    const TensorShape in_shape({N, C / numLayers, X->Shape()[2], X->Shape()[3]});
+    const TensorShape k_shape({M / numLayers, W->Shape()[1], W->Shape()[2], W->Shape()[3]});
+    const TensorShape b_shape({M / numLayers});
+    const TensorShape out_shape({N, M / numLayers, Y->Shape()[2], Y->Shape()[3]});
 
     tconv.in = std::make_shared<arm_compute::Tensor>();
-    tconv.k = std::make_shared<arm_compute::Tensor>();
-    if (B != nullptr)
-      tconv.b = std::make_shared<arm_compute::Tensor>();
     tconv.out = std::make_shared<arm_compute::Tensor>();
-
-    tconv.in->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(X->Shape(), PREF_DIM), arm_compute::Format::F32));
-    tconv.k->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(W->Shape()), arm_compute::Format::F32));
-    if (B != nullptr) {
-      tconv.b->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(B->Shape()), arm_compute::Format::F32));
+    tconv.in->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(in_shape, PREF_DIM), arm_compute::Format::F32));
+    tconv.out->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(out_shape, PREF_DIM), arm_compute::Format::F32));
+    for (int64_t g = 0; g < numLayers; g++) {
+      tconv.k.push_back(std::make_shared<arm_compute::Tensor>());
+      tconv.k.back()->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(k_shape), arm_compute::Format::F32));
+      if (B != nullptr) {
+        tconv.b.push_back(std::make_shared<arm_compute::Tensor>());
+        tconv.b.back()->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(b_shape), arm_compute::Format::F32));
+      }
     }
-    tconv.out->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(Y->Shape(), PREF_DIM), arm_compute::Format::F32));
-
-    const arm_compute::DataLayout data_layout = tconv.in->info()->data_layout();
-    const int idx_channel = arm_compute::get_data_layout_dimension_index(data_layout, arm_compute::DataLayoutDimension::CHANNEL);
-    bool isDepthwise = (1 == tconv.k->info()->tensor_shape()[idx_channel]);
-    tconv.isDepthwiseCPU = isDepthwise;
 
     std::vector<int64_t> aclStrides(2);
     aclStrides[0] = (strides.size() == 2) ? strides[1] : 1;
@@ -177,15 +198,18 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     arm_compute::PadStrideInfo aclPadStride = arm_compute::PadStrideInfo(aclStrides[0], aclStrides[1],
                                                                          aclPads[0], aclPads[1], aclPads[2], aclPads[3], arm_compute::DimensionRoundingType::FLOOR);
     unsigned int aclDilation0 = (dilations.size() == 2) ? dilations[1] : 1;
+    arm_compute::ActivationLayerInfo aclActivation =
+        acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo();
 
     if (isDepthwise) {
 #ifdef DEPTHWISE_CPU
-      Status s = onnxruntime::Conv<T>::Compute(context);
-      std::pair<ConvLayersIterator, bool> ret;
-      ret = Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
-      return s;
+      tconv.isCPU = true;
+      Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
+      return onnxruntime::Conv<T>::Compute(context);
 #else
-      tconv.k->info()->set_tensor_shape(ACLReshapeWeightsDepthwise(tconv.k.get()));
+      const unsigned int depthMultiplier = static_cast<unsigned int>(M / C);
+      tconv.k[0]->info()->set_tensor_shape(ACLReshapeWeightsDepthwise(tconv.k[0].get()));
+      arm_compute::ITensor* bias = (B != nullptr) ? tconv.b[0].get() : nullptr;
 
       // in the configure function for NEDepthwiseConvolutionLayer3x3, there is a separation based on the optimization
 #ifdef ACL_1902
@@ -193,53 +217,65 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
             arm_compute::NEDepthwiseConvolutionLayer3x3Kernel::is_optimized_execution_possible(tconv.in->info()->tensor_shape(),
                                                                                                aclPadStride,
                                                                                                tconv.in->info()->data_type(),
-                                                                                               1 /* depth multiplier */,
+                                                                                               depthMultiplier,
                                                                                                tconv.in->info()->data_layout());
 #else
       bool optimizable =
             arm_compute::NEDepthwiseConvolutionAssemblyDispatch::is_optimized_supported(tconv.in->info(),
-                                                                                        tconv.k->info(),
+                                                                                        tconv.k[0]->info(),
                                                                                         aclPadStride,
-                                                                                        1 /* depth multiplier */,
+                                                                                        depthMultiplier,
                                                                                         arm_compute::Size2D(aclDilation0, dilations[0]));
 #endif
       if(optimizable) {
         //optimized depthwise convolution
         auto layer = std::make_shared<arm_compute::NEDepthwiseConvolutionLayer3x3>();
 #ifdef ACL_1902
-        layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
-                         aclPadStride, 1 /* depth multiplier */,
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo());
+        layer->configure(tconv.in.get(), tconv.k[0].get(), bias, tconv.out.get(),
+                         aclPadStride, depthMultiplier, aclActivation);
 #else
-        layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
-                         aclPadStride, 1 /* depth multiplier */,
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo(),
+        layer->configure(tconv.in.get(), tconv.k[0].get(), bias, tconv.out.get(),
+                         aclPadStride, depthMultiplier, aclActivation,
                          arm_compute::Size2D(aclDilation0, dilations[0]));
 #endif
-        tconv.layer = std::move(layer);
-        tconv.isDepthwiseCPU = false;
+        tconv.layers.push_back(std::move(layer));
       } else {
-        // cpu depthwise convolution
-        Status s = onnxruntime::Conv<T>::Compute(context);
-        std::pair<ConvLayersIterator, bool> ret;
-        ret = Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
-        return s;
+        // generic depthwise convolution
+#ifdef ACL_1902
+        if (aclDilation0 * dilations[0] > 1) {
+          tconv.isCPU = true;
+          Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
+          return onnxruntime::Conv<T>::Compute(context);
+        }
+#endif
+        auto layer = std::make_shared<arm_compute::NEDepthwiseConvolutionLayer>();
+#ifdef ACL_1902
+        layer->configure(tconv.in.get(), tconv.k[0].get(), bias, tconv.out.get(),
+                         aclPadStride, depthMultiplier, aclActivation);
+#else
+        layer->configure(tconv.in.get(), tconv.k[0].get(), bias, tconv.out.get(),
+                         aclPadStride, depthMultiplier, aclActivation,
+                         arm_compute::Size2D(aclDilation0, dilations[0]));
+#endif
+        tconv.layers.push_back(std::move(layer));
       }
 #endif
     } else {
-      if(tconv.k->info()->tensor_shape()[0] == 1 && tconv.k->info()->tensor_shape()[1] == 1) {
+      if(tconv.k[0]->info()->tensor_shape()[0] == 1 && tconv.k[0]->info()->tensor_shape()[1] == 1) {
         //pointwise convolution
-        Status s = onnxruntime::Conv<T>::Compute(context);
-        return s;
+        tconv.isCPU = true;
+        Conv::convLayers.insert(std::pair<OpKernel*, ACLNEConv>((OpKernel*)this, tconv));
+        return onnxruntime::Conv<T>::Compute(context);
       } else {
-        //convolution
-        auto layer = std::make_shared<arm_compute::NEConvolutionLayer>(mm_layer);
-        layer->configure(tconv.in.get(), tconv.k.get(), (B != nullptr) ? tconv.b.get() : nullptr, tconv.out.get(),
-                         aclPadStride,
-                         arm_compute::WeightsInfo(), arm_compute::Size2D(aclDilation0, dilations[0]),
-                         acl_activ_enabled ? arm_compute::ActivationLayerInfo(acl_activ_func, conv_attrs_.alpha) : arm_compute::ActivationLayerInfo(),
-                         false, conv_attrs_.group);
-        tconv.layer = std::move(layer);
+        //convolution, with a layer for each group
+        for (int64_t g = 0; g < numLayers; g++) {
+          auto layer = std::make_shared<arm_compute::NEConvolutionLayer>(tconv.mm_layer);
+          layer->configure(tconv.in.get(), tconv.k[g].get(), (B != nullptr) ? tconv.b[g].get() : nullptr, tconv.out.get(),
+                           aclPadStride,
+                           arm_compute::WeightsInfo(), arm_compute::Size2D(aclDilation0, dilations[0]),
+                           aclActivation);
+          tconv.layers.push_back(std::move(layer));
+        }
       }
     }
 
@@ -253,35 +289,42 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     ACLPrintTensorShape("Y", *tconv.out.get());
 
   } else {
-    //TODO: valildate shapes
     pConv = &it->second;
   }
 
-  const T* x_data = X->template Data<T>();
-  ACLImportMemory(pConv->in->allocator(), (void*)x_data, X->Shape().Size() * 4);
+  // each layer reads and writes the slices of its group in place
+  const size_t numLayers = pConv->layers.size();
+  const int64_t x_size = X->Shape().Size() / numLayers;
+  const int64_t k_size = W->Shape().Size() / numLayers;
+  const int64_t b_size = M / numLayers;
+  const int64_t y_size = Y->Shape().Size() / numLayers;
 
+  const T* x_data = X->template Data<T>();
   const T* k_data = W->template Data<T>();
-  ACLImportMemory(pConv->k->allocator(), (void*)k_data, W->Shape().Size() * 4);
-
-  if (B != nullptr) {
-    const T* b_data = B->template Data<T>();
-    ACLImportMemory(pConv->b->allocator(), (void*)b_data, B->Shape().Size() * 4);
-  }
-
+  const T* b_data = (B != nullptr) ? B->template Data<T>() : nullptr;
   T* y_data = Y->template MutableData<T>();
-  ACLImportMemory(pConv->out->allocator(), (void*)y_data, Y->Shape().Size() * 4);
 
   arm_compute::Allocator alloc_mm{};
   pConv->mm_layer->populate(alloc_mm, 1);
-  pConv->layer->run();
-  pConv->mm_layer->clear();
 
-  pConv->in->allocator()->free();
-  pConv->k->allocator()->free();
-  if (B != nullptr)
-    pConv->b->allocator()->free();
-  pConv->out->allocator()->free();
+  for (size_t g = 0; g < numLayers; g++) {
+    ACLImportMemory(pConv->in->allocator(), (void*)(x_data + g * x_size), x_size * 4);
+    ACLImportMemory(pConv->k[g]->allocator(), (void*)(k_data + g * k_size), k_size * 4);
+    if (B != nullptr) {
+      ACLImportMemory(pConv->b[g]->allocator(), (void*)(b_data + g * b_size), b_size * 4);
+    }
+    ACLImportMemory(pConv->out->allocator(), (void*)(y_data + g * y_size), y_size * 4);
+
+    pConv->layers[g]->run();
 
+    pConv->in->allocator()->free();
+    pConv->k[g]->allocator()->free();
+    if (B != nullptr)
+      pConv->b[g]->allocator()->free();
+    pConv->out->allocator()->free();
+  }
+
+  pConv->mm_layer->clear();
 
   return Status::OK();
 }
@@ -24,13 +24,19 @@ namespace acl {
 
 typedef struct
 {
-  std::shared_ptr<arm_compute::IFunction> layer;
+  // A grouped convolution has a layer with its own weights and bias for each group, which all read and write
+  // the channels of their group through in and out.
+  std::vector<std::shared_ptr<arm_compute::IFunction>> layers;
   std::shared_ptr<arm_compute::MemoryManagerOnDemand> mm_layer;
   std::shared_ptr<arm_compute::Tensor> in;
-  std::shared_ptr<arm_compute::Tensor> k;
-  std::shared_ptr<arm_compute::Tensor> b;
+  std::vector<std::shared_ptr<arm_compute::Tensor>> k;
+  std::vector<std::shared_ptr<arm_compute::Tensor>> b;
   std::shared_ptr<arm_compute::Tensor> out;
-  bool isDepthwiseCPU;
+  // true if the convolution runs on the CPU provider instead
+  bool isCPU;
+  // the shapes the layers are configured for
+  TensorShape x_shape;
+  TensorShape w_shape;
 } ACLNEConv;
 
 typedef std::map<OpKernel*, ACLNEConv>::iterator ConvLayersIterator;
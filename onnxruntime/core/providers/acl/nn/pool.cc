@@ -57,6 +57,12 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
 
   ACLNEPool* pPool;
   PoolLayersIterator it = Pool::poolLayers.find((OpKernel*)this);
+  if (it != Pool::poolLayers.end() && it->second.x_shape != x_shape) {
+    // the layer was configured for another shape
+    Pool::poolLayers.erase(it);
+    it = Pool::poolLayers.end();
+  }
+
   if (it == Pool::poolLayers.end()) {
     auto layer = std::make_shared<arm_compute::NEPoolingLayer>();
 
@@ -115,8 +121,13 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
       layer->configure(tpool.in.get(), tpool.out.get(), pool_info);
     }
 
-    // allocate space for input tensor to accomodate paddings and strides
-    tpool.in->allocator()->allocate();
+    // Consecutive ACL nodes hand over their tensors without copies, unless the layer needs paddings around the
+    // rows of the input, in which case the input is copied into a tensor allocated with them.
+    tpool.x_shape = x_shape;
+    tpool.importInput = tpool.in->info()->padding().empty();
+    if (!tpool.importInput) {
+      tpool.in->allocator()->allocate();
+    }
 
     tpool.layer = std::move(layer);
     std::pair<PoolLayersIterator, bool> ret;
@@ -127,26 +138,22 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
   }
 
   const T* x_data = X->template Data<T>();
-  arm_compute::Window aclInpuWindow;
-  aclInpuWindow.use_tensor_dimensions(pPool->in->info()->tensor_shape());
-
-  arm_compute::Iterator aclInputIt(pPool->in.get(), aclInpuWindow);
-  const unsigned int aclWidth = pPool->in->info()->dimension(0);
-  const unsigned int aclHeight = pPool->in->info()->dimension(1);
-
-  // copy input tensor into the larger buffer
-  arm_compute::execute_window_loop(
-      aclInpuWindow,
-      [&](const arm_compute::Coordinates& co) {
-        *reinterpret_cast<float*>(aclInputIt.ptr()) = x_data[co.z() * (aclWidth * aclHeight) + co.y() * aclHeight + co.x()];
-      },
-      aclInputIt);
+  if (pPool->importInput) {
+    ACLImportMemory(pPool->in->allocator(), (void*)x_data, X->Shape().Size() * 4);
+  } else {
+    ACLCopyToTensor(pPool->in.get(), x_data);
+  }
 
   T* y_data = Y->template MutableData<T>();
   ACLImportMemory(pPool->out->allocator(), (void*)y_data, Y->Shape().Size() * 4);
 
   pPool->layer->run();
 
+  if (pPool->importInput) {
+    pPool->in->allocator()->free();
+  }
+  pPool->out->allocator()->free();
+
   return Status::OK();
 }
 
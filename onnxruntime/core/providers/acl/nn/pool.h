@@ -26,6 +26,10 @@ typedef struct {
   std::shared_ptr<arm_compute::NEPoolingLayer> layer;
   std::shared_ptr<arm_compute::Tensor> in;
   std::shared_ptr<arm_compute::Tensor> out;
+  // the input shape the layer is configured for
+  TensorShape x_shape;
+  // true if the layer reads the input in place, false if it needs a copy with padded rows
+  bool importInput;
 } ACLNEPool;
 
 typedef std::map<OpKernel*, ACLNEPool>::iterator PoolLayersIterator;
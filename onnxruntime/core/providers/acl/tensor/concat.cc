@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Copyright (c) 2019, NXP Semiconductor, Inc. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/acl/tensor/concat.h"
+#include "core/providers/acl/acl_common.h"
+#include "core/providers/acl/acl_fwd.h"
+
+// ACL
+#include "arm_compute/core/TensorInfo.h"
+
+namespace onnxruntime {
+namespace acl {
+
+thread_local std::map<OpKernel*, ACLNEConcat> Concat::concatLayers;
+
+Status Concat::Compute(OpKernelContext* ctx) const {
+  auto input_count = Node().InputArgCount().front();
+
+  // Hold pointers to the input tensors to be used in the PrepareForCompute() step
+  std::vector<const Tensor*> input_tensors;
+  input_tensors.reserve(input_count);
+  for (int i = 0; i < input_count; ++i) {
+    input_tensors.push_back(ctx->Input<Tensor>(i));
+  }
+
+  Prepare p;
+  ORT_RETURN_IF_ERROR(PrepareForCompute(ctx, input_tensors, p));
+
+  // Return at this point if output tensor is going to be empty
+  if (p.output_num_elements == 0)
+    return Status::OK();
+
+  // the layer concatenates up to 4 dimensions, and an empty input would leave ACL with a tensor of no elements
+  const size_t rank = p.output_tensor->Shape().NumDimensions();
+  bool acl_supported = rank <= 4;
+  for (const auto& input : p.inputs) {
+    acl_supported = acl_supported && input.num_elements != 0;
+  }
+  // dimensions are stored in the opposite order to ACL's
+  const size_t acl_axis = rank - 1 - static_cast<size_t>(p.axis);
+#ifdef ACL_1902
+  // the concatenation over batches came in 19.05
+  acl_supported = acl_supported && acl_axis < 3;
+#endif
+  if (!acl_supported)
+    return ComputeImpl(p);
+
+  ACLNEConcat* pConcat;
+  ConcatLayersIterator it = concatLayers.find((OpKernel*)this);
+  if (it != concatLayers.end()) {
+    bool same_shapes = true;
+    for (int i = 0; i < input_count; ++i) {
+      same_shapes = same_shapes && it->second.input_shapes[i] == input_tensors[i]->Shape();
+    }
+    if (!same_shapes) {
+      // the layer was configured for other shapes
+      concatLayers.erase(it);
+      it = concatLayers.end();
+    }
+  }
+  if (it == concatLayers.end()) {
+    ACLNEConcat tconcat;
+    tconcat.layer = std::make_shared<arm_compute::NEConcatenateLayer>();
+
+    std::vector<arm_compute::ITensor*> inputs;
+    for (int i = 0; i < input_count; ++i) {
+      tconcat.input_shapes.push_back(input_tensors[i]->Shape());
+      tconcat.inputs.push_back(std::make_shared<arm_compute::Tensor>());
+      tconcat.inputs.back()->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(input_tensors[i]->Shape()),
+                                                                       arm_compute::Format::F32));
+      inputs.push_back(tconcat.inputs.back().get());
+    }
+    tconcat.output = std::make_shared<arm_compute::Tensor>();
+    tconcat.output->allocator()->init(arm_compute::TensorInfo(ACLTensorShape(p.output_tensor->Shape()),
+                                                              arm_compute::Format::F32));
+
+#ifdef ACL_1902
+    const arm_compute::DataLayoutDimension acl_axes[] = {arm_compute::DataLayoutDimension::WIDTH,
+                                                         arm_compute::DataLayoutDimension::HEIGHT,
+                                                         arm_compute::DataLayoutDimension::CHANNEL};
+    tconcat.layer->configure(inputs, tconcat.output.get(), acl_axes[acl_axis]);
+#else
+    tconcat.layer->configure(inputs, tconcat.output.get(), acl_axis);
+#endif
+
+    std::pair<ConcatLayersIterator, bool> ret;
+    ret = concatLayers.insert(std::pair<OpKernel*, ACLNEConcat>((OpKernel*)this, tconcat));
+    pConcat = &ret.first->second;
+  } else {
+    pConcat = &it->second;
+  }
+
+  for (int i = 0; i < input_count; ++i) {
+    const float* x_data = input_tensors[i]->template Data<float>();
+    ACLImportMemory(pConcat->inputs[i]->allocator(), (void*)x_data, input_tensors[i]->Shape().Size() * 4);
+  }
+  float* y_data = p.output_tensor->template MutableData<float>();
+  ACLImportMemory(pConcat->output->allocator(), (void*)y_data, p.output_tensor->Shape().Size() * 4);
+
+  ACLPrintTensorShape("y", *pConcat->output);
+
+  pConcat->layer->run();
+
+  for (int i = 0; i < input_count; ++i) {
+    pConcat->inputs[i]->allocator()->free();
+  }
+  pConcat->output->allocator()->free();
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Concat,
+    kOnnxDomain,
+    4, 10,
+    kAclExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Concat);
+
+// Opset 11 starts to support Neg Axis.
+ONNX_OPERATOR_KERNEL_EX(
+    Concat,
+    kOnnxDomain,
+    11,
+    kAclExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Concat);
+
+}  // namespace acl
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Copyright (c) 2019, NXP Semiconductor, Inc. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/tensor/concat.h"
+#include "core/providers/acl/acl_execution_provider.h"
+
+// ACL
+#include "arm_compute/runtime/Tensor.h"
+
+//NEON
+#include "arm_compute/runtime/NEON/functions/NEConcatenateLayer.h"
+
+namespace onnxruntime {
+namespace acl {
+
+typedef struct {
+  std::shared_ptr<arm_compute::NEConcatenateLayer> layer;
+  std::vector<std::shared_ptr<arm_compute::Tensor>> inputs;
+  std::shared_ptr<arm_compute::Tensor> output;
+  // the input shapes the layer is configured for
+  std::vector<TensorShape> input_shapes;
+} ACLNEConcat;
+
+typedef std::map<OpKernel*, ACLNEConcat>::iterator ConcatLayersIterator;
+
+class Concat final : public OpKernel, public ConcatBase {
+ public:
+  Concat(const OpKernelInfo& info) : OpKernel(info), ConcatBase(info) {}
+
+  ~Concat() {
+    concatLayers.erase(this);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  static thread_local std::map<OpKernel*, ACLNEConcat> concatLayers;
+};
+
+}  // namespace acl
+}  // namespace onnxruntime
@@ -164,6 +164,13 @@ class LoopImpl {
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // true if the buffer of value is used by one of values or by the Loop inputs
+  bool IsBufferUsed(const OrtValue& value, const std::vector<OrtValue>& values) const;
+
+  // allocate the next value of a loop carried variable in the buffer of its value from two iterations ago
+  Status AllocateLoopCarriedVar(int index, const TensorShape& shape, const OrtMemoryInfo& location,
+                                OrtValue& ort_value, bool& allocated);
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
@@ -183,6 +190,12 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // the loop carried variables alternate between two buffers like the Scan loop state variables, so that each
+  // iteration doesn't allocate them. a variable's current input can be reused once it was produced by the
+  // subgraph and no other value shares its buffer. the reuse is skipped when the shape changes.
+  std::vector<bool> loop_carried_input_reusable_;
+  std::vector<OrtValue> loop_carried_spare_buffers_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -391,6 +404,8 @@ Status LoopImpl::Initialize() {
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank);
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
+  loop_carried_input_reusable_.assign(info_.num_loop_carried_vars, false);
+  loop_carried_spare_buffers_.resize(info_.num_loop_carried_vars);
 
   return status;
 }
@@ -419,8 +434,25 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
   // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
-  for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
+  next_inputs[1] = last_outputs[0];
+  for (int i = 2; i < info_.num_subgraph_inputs; ++i) {
+    OrtValue previous_input = std::move(next_inputs[i]);
     next_inputs[i] = last_outputs[i - 1];
+
+    const int var = i - 2;
+    if (loop_carried_input_reusable_[var] && !IsBufferUsed(previous_input, last_outputs)) {
+      loop_carried_spare_buffers_[var] = std::move(previous_input);
+    }
+
+    // the subgraph may pass a value through, or output the same value twice. only a buffer of its own can be
+    // written by a later iteration.
+    const OrtValue& input = next_inputs[i];
+    bool shared = false;
+    for (int j = 0; j < static_cast<int>(last_outputs.size()) && !shared; ++j) {
+      shared = j != i - 1 && last_outputs[j].IsTensor() && input.IsTensor() &&
+               last_outputs[j].Get<Tensor>().DataRaw() == input.Get<Tensor>().DataRaw();
+    }
+    loop_carried_input_reusable_[var] = !shared && !IsBufferUsed(input, {});
   }
 
   // save loop outputs as we have to concatenate at the end
@@ -429,6 +461,48 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   }
 }
 
+bool LoopImpl::IsBufferUsed(const OrtValue& value, const std::vector<OrtValue>& values) const {
+  if (!value.IsTensor() || value.Get<Tensor>().DataRaw() == nullptr) {
+    return true;
+  }
+
+  const void* buffer = value.Get<Tensor>().DataRaw();
+  auto uses_buffer = [buffer](const OrtValue& other) {
+    return other.IsTensor() && other.Get<Tensor>().DataRaw() == buffer;
+  };
+
+  if (std::any_of(values.cbegin(), values.cend(), uses_buffer)) {
+    return true;
+  }
+
+  for (int i = 0, end = context_.InputCount(); i < end; ++i) {
+    const OrtValue* input = context_.GetInputMLValue(i);
+    if (input != nullptr && uses_buffer(*input)) {
+      return true;
+    }
+  }
+
+  return std::any_of(implicit_inputs_.cbegin(), implicit_inputs_.cend(),
+                     [&uses_buffer](const OrtValue* input) { return uses_buffer(*input); });
+}
+
+Status LoopImpl::AllocateLoopCarriedVar(int index, const TensorShape& shape, const OrtMemoryInfo& location,
+                                        OrtValue& ort_value, bool& allocated) {
+  OrtValue& spare = loop_carried_spare_buffers_[index];
+  allocated = false;
+
+  if (spare.IsAllocated()) {
+    const auto& tensor = spare.Get<Tensor>();
+    if (tensor.Shape() == shape && tensor.Location().device == location.device) {
+      ort_value = std::move(spare);
+      spare = OrtValue();
+      allocated = true;
+    }
+  }
+
+  return Status::OK();
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   const auto& per_iteration_dims = first_output.Shape().GetDims();
@@ -456,6 +530,15 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   CreateInitialFeeds(feeds);
 
+  // subgraph outputs are the condition, the loop carried variables and the loop outputs
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    fetch_allocators[i + 1] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                        OrtValue& ort_value, bool& allocated) {
+      return AllocateLoopCarriedVar(i, shape, location, ort_value, allocated);
+    };
+  }
+
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
@@ -464,8 +547,9 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
-                                    ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
+                                    ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.GetDeadline(),
+                                    context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -16,9 +16,13 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
 
 #include "core/providers/cpu/tensor/utils.h"
 
+#include <atomic>
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -113,6 +117,11 @@ class Scan8Impl {
   Status AllocateOutputTensors();
   Status CreateLoopStateVariables(std::vector<std::vector<LoopStateVariable>>& loop_state_variables);
 
+  // iterate the sequence of batch entry b, writing the scan outputs with output_iterators.
+  Status ExecuteBatchEntry(int64_t b, std::vector<LoopStateVariable>& loop_state_variables,
+                           std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
+                           const FeedsFetchesManager& ffm);
+
   using ConstTensorSlicerIterators = std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator>;
   using MutableTensorSlicerIterators = std::vector<OrtValueTensorSlicer<OrtValue>::Iterator>;
 
@@ -393,6 +402,50 @@ Status Scan8Impl::CreateLoopStateVariables(std::vector<std::vector<LoopStateVari
   return status;
 }
 
+Status Scan8Impl::ExecuteBatchEntry(int64_t b, std::vector<LoopStateVariable>& loop_state_variables,
+                                    std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
+                                    const FeedsFetchesManager& ffm) {
+  auto sequence_len = sequence_lens_[b];
+
+  // Setup input OrtValue streams
+  std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator> scan_input_stream_iterators;
+  scan_input_stream_iterators.reserve(info_.num_variadic_inputs - info_.num_loop_state_variables);
+
+  for (int i = info_.num_loop_state_variables, end = info_.num_variadic_inputs; i < end; ++i) {
+    const auto& ort_value = GetSubgraphInputMLValue(context_, i);
+
+    // forward
+    if (directions_[i - info_.num_loop_state_variables] == static_cast<int64_t>(ScanDirection::kForward)) {
+      // the iterator is self contained, so we don't need to keep the OrtValueTensorSlicer instance around
+      scan_input_stream_iterators.push_back(device_helpers_.create_const_slicer_func(ort_value, 1, b).begin());
+    } else {  // reverse
+      scan_input_stream_iterators.push_back(device_helpers_.create_const_slicer_func(ort_value, 1, b).rbegin());
+      // need to skip past the empty entries at the end of the input if sequence length is short
+      auto offset = max_sequence_len_ - sequence_len;
+      if (offset > 0) {
+        // reverse iterator so += moves backwards through the input
+        scan_input_stream_iterators.back() += offset;
+      }
+    }
+  }
+
+  // Call the subgraph for each item in the sequence
+  auto status = IterateSequence(context_, session_state_, loop_state_variables, scan_input_stream_iterators,
+                                sequence_len, info_.num_loop_state_variables, info_.num_variadic_inputs,
+                                info_.num_outputs, implicit_inputs_, output_iterators, ffm);
+
+  // zero out any remaining values in the sequence
+  for (int64_t i = sequence_len; i < max_sequence_len_; ++i) {
+    for (int output = info_.num_loop_state_variables; output < info_.num_outputs; ++output) {
+      auto& iterator = *output_iterators[output];
+      iterator.ZeroOutCurrent();
+      ++iterator;
+    }
+  }
+
+  return status;
+}
+
 Status Scan8Impl::Execute(const FeedsFetchesManager& ffm) {
   Status status = Status::OK();
 
@@ -401,46 +454,78 @@ Status Scan8Impl::Execute(const FeedsFetchesManager& ffm) {
   status = CreateLoopStateVariables(batch_loop_state_variables);
   ORT_RETURN_IF_ERROR(status);
 
-  for (int64_t b = 0; b < batch_size_; ++b) {
-    auto sequence_len = sequence_lens_[b];
-
-    // Setup input OrtValue streams
-    std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator> scan_input_stream_iterators;
-    scan_input_stream_iterators.reserve(info_.num_variadic_inputs - info_.num_loop_state_variables);
-
-    for (int i = info_.num_loop_state_variables, end = info_.num_variadic_inputs; i < end; ++i) {
-      const auto& ort_value = GetSubgraphInputMLValue(context_, i);
-
-      // forward
-      if (directions_[i - info_.num_loop_state_variables] == static_cast<int64_t>(ScanDirection::kForward)) {
-        // the iterator is self contained, so we don't need to keep the OrtValueTensorSlicer instance around
-        scan_input_stream_iterators.push_back(device_helpers_.create_const_slicer_func(ort_value, 1, b).begin());
-      } else {  // reverse
-        scan_input_stream_iterators.push_back(device_helpers_.create_const_slicer_func(ort_value, 1, b).rbegin());
-        // need to skip past the empty entries at the end of the input if sequence length is short
-        auto offset = max_sequence_len_ - sequence_len;
-        if (offset > 0) {
-          // reverse iterator so += moves backwards through the input
-          scan_input_stream_iterators.back() += offset;
-        }
-      }
-    }
+  // the batch entries are independent sequences. if the session has an inter-op thread pool (ORT_PARALLEL mode)
+  // run them concurrently once the first entry has discovered the shapes of the outputs and allocated them.
+  auto* thread_pool = session_state_.GetInterOpThreadPool();
+  const bool run_in_parallel = thread_pool != nullptr && batch_size_ > 1;
+
+  const int64_t num_sequential = run_in_parallel ? 1 : batch_size_;
 
-    // Call the subgraph for each item in the sequence
-    status = IterateSequence(context_, session_state_, batch_loop_state_variables[b], scan_input_stream_iterators,
-                             sequence_len, info_.num_loop_state_variables, info_.num_variadic_inputs, info_.num_outputs,
-                             implicit_inputs_, output_iterators_, ffm);
+  for (int64_t b = 0; b < num_sequential; ++b) {
+    status = ExecuteBatchEntry(b, batch_loop_state_variables[b], output_iterators_, ffm);
+    ORT_RETURN_IF_ERROR(status);
+  }
 
-    // zero out any remaining values in the sequence
-    for (int64_t i = sequence_len; i < max_sequence_len_; ++i) {
+  if (run_in_parallel) {
+    const int32_t num_remaining = static_cast<int32_t>(batch_size_ - 1);
+    std::vector<Status> statuses(num_remaining);
+
+    // each batch entry writes to its own slice of the outputs using its own iterators.
+    std::vector<std::vector<std::unique_ptr<OutputIterator>>> batch_output_iterators(num_remaining);
+    for (int32_t i = 0; i < num_remaining; ++i) {
+      auto& iterators = batch_output_iterators[i];
+      iterators.resize(info_.num_outputs);  // no iterators for the loop state variables
       for (int output = info_.num_loop_state_variables; output < info_.num_outputs; ++output) {
-        auto& iterator = *output_iterators_[output];
-        iterator.ZeroOutCurrent();
-        ++iterator;
+        ORT_RETURN_IF_ERROR(output_iterators_[output]->CreateBatchEntryIterator(i + 1, iterators[output]));
       }
     }
 
-    ORT_RETURN_IF_ERROR(status);
+    // Scan is usually run by a worker of the inter-op thread pool, so we can't block waiting for helpers that may
+    // never get a thread. The helpers and this thread claim entries from a shared counter, and we only wait for the
+    // entries that were claimed. A helper that starts late finds no work and only touches the shared state.
+    struct ParallelState {
+      std::atomic<int32_t> next{0};
+      int32_t num_done = 0;
+      OrtMutex mutex;
+      OrtCondVar done_cv;
+    };
+
+    auto state = std::make_shared<ParallelState>();
+    std::function<void(int32_t)> run_entry = [&](int32_t i) {
+      int64_t b = static_cast<int64_t>(i) + 1;
+      statuses[i] = ExecuteBatchEntry(b, batch_loop_state_variables[b], batch_output_iterators[i], ffm);
+    };
+
+    // run_entry refers to this stack frame so is only dereferenced after successfully claiming an entry
+    const auto* p_run_entry = &run_entry;
+    auto run_entries = [state, num_remaining, p_run_entry]() {
+      for (;;) {
+        int32_t i = state->next.fetch_add(1);
+        if (i >= num_remaining)
+          break;
+
+        (*p_run_entry)(i);
+
+        std::lock_guard<OrtMutex> lock(state->mutex);
+        if (++state->num_done == num_remaining) {
+          state->done_cv.notify_all();
+        }
+      }
+    };
+
+    const int32_t num_helpers = std::min<int32_t>(thread_pool->NumThreads(), num_remaining - 1);
+    for (int32_t i = 0; i < num_helpers; ++i) {
+      thread_pool->Schedule(run_entries);
+    }
+
+    run_entries();
+
+    std::unique_lock<OrtMutex> lock(state->mutex);
+    state->done_cv.wait(lock, [&state, num_remaining]() { return state->num_done == num_remaining; });
+
+    for (const auto& entry_status : statuses) {
+      ORT_RETURN_IF_ERROR(entry_status);
+    }
   }
 
   return status;
@@ -270,7 +270,8 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
 
     // Create Executor and run graph.
     status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
-                                    ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger());
+                                    ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.GetDeadline(),
+                                    context.Logger());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -536,6 +537,29 @@ Status OutputIterator::AllocateFinalOutput(const TensorShape& shape) {
   return Status::OK();
 }
 
+Status OutputIterator::CreateBatchEntryIterator(int64_t batch_index, std::unique_ptr<OutputIterator>& iterator) const {
+  ORT_ENFORCE(is_v8_ && !is_loop_state_var_, "Only v8 scan outputs have a batch dimension to iterate.");
+  ORT_ENFORCE(is_concrete_shape_, "Final output must be allocated before creating a batch entry iterator.");
+  ORT_ENFORCE(batch_index >= 0 && batch_index < final_shape_[0], "Invalid batch index of ", batch_index);
+
+  iterator.reset(new OutputIterator(*this));
+
+  // the copy has its own slicer iterators. point it at the entry for the batch, and stop at the end of its sequence.
+  auto sequence_len = final_shape_[1];
+  iterator->cur_iteration_ = batch_index * sequence_len;
+  iterator->num_iterations_ = iterator->cur_iteration_ + sequence_len;
+  iterator->cur_slicer_iterator_ = iterator->slicer_iterators_.begin() + batch_index;
+  iterator->slicer_iterators_[batch_index] = (direction_ == ScanDirection::kForward)
+                                                 ? create_slicer_func_(*final_output_mlvalue_, 1, batch_index).begin()
+                                                 : create_slicer_func_(*final_output_mlvalue_, 1, batch_index).rbegin();
+
+  if (temporary_) {
+    iterator->final_output_mlvalue_ = &iterator->temporary_final_output_mlvalue_;
+  }
+
+  return Status::OK();
+}
+
 OrtValue& OutputIterator::operator*() {
   ORT_ENFORCE(cur_iteration_ < num_iterations_);
   ORT_ENFORCE(is_concrete_shape_,
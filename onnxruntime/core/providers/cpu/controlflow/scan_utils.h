@@ -138,6 +138,10 @@ class OutputIterator {
     return *final_output_mlvalue_;
   }
 
+  // Create an iterator that only writes the sequence of one batch entry of a v8 scan output.
+  // The final output must have been allocated. Used to write the batch entries concurrently.
+  Status CreateBatchEntryIterator(int64_t batch_index, std::unique_ptr<OutputIterator>& iterator) const;
+
  private:
   OutputIterator(OpKernelContextInternal& context,
                  int output_index,
@@ -150,6 +154,8 @@ class OutputIterator {
                  bool temporary,
                  MLDataType data_type);
 
+  OutputIterator(const OutputIterator& other) = default;
+
   Status Initialize();
   Status AllocateFinalBuffer();
 
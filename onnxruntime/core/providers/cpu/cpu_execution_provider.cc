@@ -4,6 +4,7 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/kernel_registry.h"
+#include "core/mlas/inc/mlas.h"
 
 #ifndef DISABLE_CONTRIB_OPS
 #include "contrib_ops/cpu_contrib_kernels.h"
@@ -1302,4 +1303,17 @@ std::shared_ptr<KernelRegistry> CPUExecutionProvider::GetKernelRegistry() const
 std::unique_ptr<IDataTransfer> CPUExecutionProvider::GetDataTransfer() const {
   return onnxruntime::make_unique<CPUDataTransfer>();
 }
+
+bool CPUExecutionProvider::UseFp16Weights(const float* data, size_t count) const {
+  if (!use_fp16_weights_ || count == 0) {
+    return false;
+  }
+
+  // the largest finite half precision value
+  constexpr float kMaxHalf = 65504.0f;
+  float min_value;
+  float max_value;
+  MlasFindMinMaxElement(data, &min_value, &max_value, count);
+  return min_value >= -kMaxHalf && max_value <= kMaxHalf;
+}
 }  // namespace onnxruntime
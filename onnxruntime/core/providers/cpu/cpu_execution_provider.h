@@ -5,6 +5,7 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/huge_page_allocator.h"
 #include "core/graph/constants.h"
 
 namespace onnxruntime {
@@ -12,6 +13,13 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  bool use_bf16_gemm{false};
+  bool use_fp16_weights{false};
+  // put per-thread caches in front of the arena for the small allocations
+  bool arena_thread_cache{false};
+  ArenaBackend arena_backend{ArenaBackend::kDefault};
+  // back the device allocations of at least this many bytes with huge pages. 0 disables it.
+  size_t huge_page_threshold{0};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -26,10 +34,19 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider}, use_bf16_gemm_{info.use_bf16_gemm},
+        use_fp16_weights_{info.use_fp16_weights} {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                                 [](int) { return onnxruntime::make_unique<TAllocator>(); },
                                                 std::numeric_limits<size_t>::max()};
+    device_info.arena_thread_cache = info.arena_thread_cache;
+    device_info.arena_backend = info.arena_backend;
+    if (info.huge_page_threshold != 0) {
+      const size_t huge_page_threshold = info.huge_page_threshold;
+      device_info.factory = [huge_page_threshold](int) {
+        return onnxruntime::make_unique<HugePageAllocator>(huge_page_threshold);
+      };
+    }
 
 #ifdef USE_JEMALLOC
 #if defined(USE_MIMALLOC)
@@ -55,7 +72,16 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  // whether kernels should pack constant float weights as bfloat16
+  bool UseBf16Gemm() const { return use_bf16_gemm_; }
+
+  // whether kernels should pack the constant float weights with the given values as half precision. this is false
+  // for weights with values that overflow half precision.
+  bool UseFp16Weights(const float* data, size_t count) const;
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  bool use_bf16_gemm_;
+  bool use_fp16_weights_;
 };
 }  // namespace onnxruntime
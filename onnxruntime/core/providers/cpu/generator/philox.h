@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Philox4x32-10 counter based random number generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// Each 64-bit counter maps to a block of 4 random 32-bit values, so any part of a stream can be generated on its own
+// and a tensor can be filled in parallel with the same values as a sequential fill.
+class PhiloxGenerator {
+ public:
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+  using Block = std::array<uint32_t, 4>;
+
+  explicit PhiloxGenerator(uint64_t seed) noexcept
+      : key_{{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}} {}
+
+  // The random block at 'counter' of the stream of the seed.
+  Block operator()(uint64_t counter) const noexcept {
+    return Philox4x32({{static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0}}, key_);
+  }
+
+  static Block Philox4x32(Counter counter, Key key) noexcept {
+    for (int round = 0; round < 10; ++round) {
+      const uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * counter[0];
+      const uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * counter[2];
+      counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+                  static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)}};
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    return counter;
+  }
+
+  // Uniform value in [0, 1) from the 24 high bits of a random value.
+  static float ToFloat(uint32_t bits) noexcept {
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+  }
+
+  // Uniform value in [0, 1) from the 53 high bits of two random values.
+  static double ToDouble(uint32_t high_bits, uint32_t low_bits) noexcept {
+    const uint64_t bits = (static_cast<uint64_t>(high_bits) << 32) | low_bits;
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+ private:
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  Key key_;
+};
+
+// The stream of a random generator kernel, shared by its calls to Compute. Each call reserves the blocks it uses
+// under a mutex, so a model with random generators is deterministic and still can be executed in parallel.
+class PhiloxStream {
+ public:
+  explicit PhiloxStream(uint64_t seed) noexcept : generator_(seed) {}
+
+  // Returns the counter of the first of the num_blocks blocks reserved for the caller.
+  uint64_t Reserve(uint64_t num_blocks) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    const uint64_t counter = next_counter_;
+    next_counter_ += num_blocks;
+    return counter;
+  }
+
+  const PhiloxGenerator& Generator() const noexcept { return generator_; }
+
+ private:
+  const PhiloxGenerator generator_;
+  uint64_t next_counter_ = 0;
+  OrtMutex mutex_;
+};
+
+}  // namespace onnxruntime
@@ -17,19 +17,11 @@ limitations under the License.
 
 #include "core/providers/cpu/generator/random.h"
 
-// build\windows\debug\external\eigen3\unsupported\eigen\cxx11\src/Tensor/Tensor.h(76):
-// warning C4554: '&': check operator precedence for possible error; use parentheses to clarify precedence
-// build\windows\relwithdebinfo\eigen\src\eigen\eigen-eigen-5a0156e40feb\unsupported\eigen\cxx11\src/Tensor/TensorChipping.h(52)
-// warning C4100: 'dim': unreferenced formal parameter
-#ifdef _WIN32
-#pragma warning(disable : 4554 4100)
-#endif
-
 #include <algorithm>
-#include <chrono>
-#include <random>
-#include "core/util/math_cpuonly.h"
-#include "core/util/eigen_common_wrapper.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "core/platform/threadpool.h"
 #include "gsl/gsl"
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -70,11 +62,10 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<float>()).TypeConstraint("T2", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
-
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+static Status RandomNormalCompute(float mean, float scale, PhiloxStream& stream, TensorProto::DataType dtype,
+                                  Tensor& Y, concurrency::ThreadPool* tp);
+static Status RandomUniformCompute(float low, float high, PhiloxStream& stream, TensorProto::DataType dtype,
+                                   Tensor& Y, concurrency::ThreadPool* tp);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -82,8 +73,7 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+  auto status = RandomNormalCompute(mean_, scale_, stream_, dtype_, Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -91,8 +81,7 @@ Status RandomNormal::Compute(OpKernelContext* ctx) const {
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+  auto status = RandomUniformCompute(low_, high_, stream_, dtype_, Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -113,8 +102,7 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
+  status = RandomNormalCompute(mean_, scale_, stream_, dtype, *Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -134,79 +122,67 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
+  status = RandomUniformCompute(low_, high_, stream_, dtype, *Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
 
-// Rank-2 tensor (matrix) of scalar type T.
-template <typename T, typename IndexType = int64_t>
-using Matrix = Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor, IndexType>>;
-
-template <typename T, typename IndexType = int64_t>
-using ConstMatrix = Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor, IndexType>>;
-
-template <typename T, typename IndexType = int64_t>
-using EigenVector = Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor, IndexType>>;
-
 template <typename OutputType>
-static Status MultinomialCompute(OpKernelContext* ctx,
-                                 const Tensor& X,
+static Status MultinomialCompute(const Tensor& X,
                                  const int64_t batch_size,
                                  const int64_t num_classes,
                                  const int64_t num_samples,
-                                 std::default_random_engine& generator,
-                                 Tensor& Y) {
-  // implementation copied from Tensorflow with some changes such as using the std::uniform_real_distribution
-  // instead of the Philox RNG.
-  Eigen::array<int64_t, 2> X_dims = {{batch_size, num_classes}};
-  ConstMatrix<float> logits = ConstMatrix<float>(X.template Data<float>(), X_dims);
-
-  Eigen::array<int64_t, 2> Y_dims = {{batch_size, num_samples}};
-  Matrix<OutputType> output = Matrix<OutputType>(Y.template MutableData<OutputType>(), Y_dims);
-
-  // BEGIN create temporary tensor
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-  auto cdf_data = static_cast<double*>(alloc->Alloc(sizeof(double) * num_classes));
-  BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(alloc));
-  Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
-  auto cdf = EigenVector<double>(cdf_data, cdf_dims);
-  // END create temporary tensor
-
-  std::uniform_real_distribution<double> dist(0.0, 1.0);  // TODO: should this be initialized per batch?
-
-  for (int64_t b = 0; b < batch_size; ++b) {
-    const float* logits_row = &(logits(b, 0));
-    // Takes an along-class maximum (for numerical stability).
-    float maxx = std::numeric_limits<float>::lowest();
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        maxx = std::max(maxx, logits_row[j]);
-      }
-    }
-    const auto max_logit = static_cast<double>(maxx);
-
-    // Precompute cumulative probability distribution across classes.
-    // Note: This isn't normalized.
-    cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
-    double running_total = 0;
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        running_total += cdf(j);
-      }
-      cdf(j) = running_total;
-    }
-    // Generate each sample.
-    const double* cdf_begin = cdf.data();
-    const double* cdf_end = cdf.data() + num_classes;
-    for (int64_t j = 0; j < num_samples; ++j) {
-      const double to_find = dist(generator) * running_total;
-      auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
-      output(b, j) = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
-    }
-  }
+                                 PhiloxStream& stream,
+                                 Tensor& Y,
+                                 concurrency::ThreadPool* tp) {
+  // implementation copied from Tensorflow with some changes such as drawing the uniform values of the samples from
+  // the blocks of the kernel's Philox stream, 2 doubles per block, so the batches can be sampled in parallel.
+  const float* logits = X.template Data<float>();
+  OutputType* output = Y.template MutableData<OutputType>();
+  const PhiloxGenerator& generator = stream.Generator();
+  const uint64_t counter = stream.Reserve(static_cast<uint64_t>(batch_size * num_samples + 1) / 2);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size), static_cast<double>(num_classes + num_samples * 32),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<double> cdf(num_classes);
+        for (std::ptrdiff_t b = first; b < last; ++b) {
+          const float* logits_row = logits + b * num_classes;
+          // Takes an along-class maximum (for numerical stability).
+          float maxx = std::numeric_limits<float>::lowest();
+          for (int64_t j = 0; j < num_classes; ++j) {
+            if (std::isfinite(logits_row[j])) {
+              maxx = std::max(maxx, logits_row[j]);
+            }
+          }
+          const auto max_logit = static_cast<double>(maxx);
+
+          // Precompute cumulative probability distribution across classes.
+          // Note: This isn't normalized.
+          double running_total = 0;
+          for (int64_t j = 0; j < num_classes; ++j) {
+            if (std::isfinite(logits_row[j])) {
+              running_total += std::exp(static_cast<double>(logits_row[j]) - max_logit);
+            }
+            cdf[j] = running_total;
+          }
+          // Generate each sample.
+          const double* cdf_begin = cdf.data();
+          const double* cdf_end = cdf.data() + num_classes;
+          PhiloxGenerator::Block bits{};
+          for (int64_t j = 0; j < num_samples; ++j) {
+            const int64_t sample = b * num_samples + j;
+            if (j == 0 || sample % 2 == 0) {
+              bits = generator(counter + sample / 2);
+            }
+            const double uniform = sample % 2 == 0 ? PhiloxGenerator::ToDouble(bits[0], bits[1])
+                                                   : PhiloxGenerator::ToDouble(bits[2], bits[3]);
+            const double to_find = uniform * running_total;
+            auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
+            output[sample] = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
+          }
+        }
+      });
 
   return Status::OK();
 }
@@ -238,14 +214,13 @@ Status Multinomial::Compute(OpKernelContext* ctx) const {
   Tensor* Y = ctx->Output(0, TensorShape({batch_size, num_samples_}));
 
   Status status = Status::OK();
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
   switch (output_dtype_) {
     case TensorProto::INT32: {
-      status = MultinomialCompute<int32_t>(ctx, X, batch_size, num_classes, num_samples_, generator_, *Y);
+      status = MultinomialCompute<int32_t>(X, batch_size, num_classes, num_samples_, stream_, *Y, tp);
       break;
     }
     case TensorProto::INT64: {
-      status = MultinomialCompute<int64_t>(ctx, X, batch_size, num_classes, num_samples_, generator_, *Y);
+      status = MultinomialCompute<int64_t>(X, batch_size, num_classes, num_samples_, stream_, *Y, tp);
       break;
     }
     default:
@@ -276,21 +251,91 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
   return static_cast<TensorProto::DataType>(dtype);
 }
 
+// Number of values of type T converted from one Philox block
+template <typename T>
+static constexpr int64_t ValuesPerBlock() {
+  return static_cast<int64_t>(sizeof(PhiloxGenerator::Block) / sizeof(T));
+}
+
+static void ToUniform(const PhiloxGenerator::Block& bits, float* values) {
+  for (int i = 0; i < 4; ++i) {
+    values[i] = PhiloxGenerator::ToFloat(bits[i]);
+  }
+}
+
+static void ToUniform(const PhiloxGenerator::Block& bits, double* values) {
+  values[0] = PhiloxGenerator::ToDouble(bits[0], bits[1]);
+  values[1] = PhiloxGenerator::ToDouble(bits[2], bits[3]);
+}
+
+// Fill the tensor with the uniform values of the next blocks of the stream, converted by transform_values.
+// The blocks are split across the threads of tp, the values are the same as for a sequential fill.
+template <typename T, typename TTransform>
+static void GenerateData(PhiloxStream& stream, TTransform transform_values, Tensor& tensor,
+                         concurrency::ThreadPool* tp) {
+  constexpr int64_t values_per_block = ValuesPerBlock<T>();
+  T* output = tensor.MutableData<T>();
+  const int64_t size = tensor.Shape().Size();
+  const int64_t num_blocks = (size + values_per_block - 1) / values_per_block;
+  const PhiloxGenerator& generator = stream.Generator();
+  const uint64_t counter = stream.Reserve(static_cast<uint64_t>(num_blocks));
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), 64.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        T values[values_per_block];
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          ToUniform(generator(counter + block), values);
+          transform_values(values);
+          const int64_t offset = block * values_per_block;
+          std::copy_n(values, std::min(values_per_block, size - offset), output + offset);
+        }
+      });
+}
+
+template <typename T>
+static void GenerateNormal(float mean, float scale, PhiloxStream& stream, Tensor& Y, concurrency::ThreadPool* tp) {
+  const T mean_value = static_cast<T>(mean);
+  const T scale_value = static_cast<T>(scale);
+  GenerateData<T>(
+      stream, [mean_value, scale_value](T* values) {
+        // Box-Muller transform of each pair of uniform values. 1 - u is in (0, 1] so its log is finite.
+        for (int64_t i = 0; i < ValuesPerBlock<T>(); i += 2) {
+          const T radius = scale_value * std::sqrt(static_cast<T>(-2) * std::log(static_cast<T>(1) - values[i]));
+          const T angle = static_cast<T>(6.283185307179586) * values[i + 1];
+          values[i] = mean_value + radius * std::cos(angle);
+          values[i + 1] = mean_value + radius * std::sin(angle);
+        }
+      },
+      Y, tp);
+}
+
+template <typename T>
+static void GenerateUniform(float low, float high, PhiloxStream& stream, Tensor& Y, concurrency::ThreadPool* tp) {
+  const T low_value = static_cast<T>(low);
+  const T range = static_cast<T>(high) - static_cast<T>(low);
+  GenerateData<T>(
+      stream, [low_value, range](T* values) {
+        for (int64_t i = 0; i < ValuesPerBlock<T>(); ++i) {
+          values[i] = low_value + range * values[i];
+        }
+      },
+      Y, tp);
+}
+
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
-                                  TensorProto::DataType dtype, Tensor& Y) {
+                                  PhiloxStream& stream,
+                                  TensorProto::DataType dtype, Tensor& Y,
+                                  concurrency::ThreadPool* tp) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::normal_distribution<float>>(
-          generator, std::normal_distribution<float>{mean, scale}, Y);
+      GenerateNormal<float>(mean, scale, stream, Y, tp);
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::normal_distribution<double>>(
-          generator, std::normal_distribution<double>{mean, scale}, Y);
+      GenerateNormal<double>(mean, scale, stream, Y, tp);
       break;
     }
     default:
@@ -301,21 +346,20 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxStream& stream,
                                    TensorProto::DataType dtype,
-                                   Tensor& Y) {
+                                   Tensor& Y,
+                                   concurrency::ThreadPool* tp) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::uniform_real_distribution<float>>(
-          generator, std::uniform_real_distribution<float>{low, high}, Y);
+      GenerateUniform<float>(low, high, stream, Y, tp);
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::uniform_real_distribution<double>>(
-          generator, std::uniform_real_distribution<double>{low, high}, Y);
+      GenerateUniform<double>(low, high, stream, Y, tp);
       break;
     }
     default:
@@ -325,13 +369,4 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
-  T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
-  }
-}
-
 }  // namespace onnxruntime
@@ -2,50 +2,113 @@
 // Licensed under the MIT License.
 
 #include "cumsum.h"
+
+#include <algorithm>
+#include <numeric>
+
 #include "core/providers/common.h"
-#include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime;
 
 namespace {
 // static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(rank, 0);
-  starts[axis] = index;
-  return starts;
-}
+
+// The rows of the axis are split into blocks of columns so the scans of a large inner dimension are spread over
+// the thread pool as well.
+constexpr int64_t kColumnsPerBlock = 256;
+// A contiguous axis at least this long is scanned in parallel, one block of elements per task.
+constexpr int64_t kScanBlockSize = 16 * 1024;
+
+// Cumulative sum of 'length' contiguous elements, walked backwards when reverse. 'carry' is the sum of the
+// elements scanned before them.
 template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
+void ScanRow(const T* input, T* output, int64_t length, bool exclusive, bool reverse, T carry) {
+  const std::ptrdiff_t step = reverse ? -1 : 1;
+  if (reverse) {
+    input += length - 1;
+    output += length - 1;
+  }
+
+  if (exclusive) {
+    for (int64_t i = 0; i < length; ++i, input += step, output += step) {
+      *output = carry;
+      carry += *input;
+    }
+  } else {
+    for (int64_t i = 0; i < length; ++i, input += step, output += step) {
+      carry += *input;
+      *output = carry;
+    }
   }
 }
+
+// Cumulative sum of 'length' rows of 'width' elements that are 'pitch' elements apart. Each output row is the sum
+// of the previous output row and an input row, so the inner loop over the columns vectorizes.
 template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
+void ScanColumns(const T* input, T* output, int64_t length, int64_t pitch, int64_t width, bool exclusive,
+                 bool reverse) {
+  const std::ptrdiff_t step = reverse ? -pitch : pitch;
+  if (reverse) {
+    input += (length - 1) * pitch;
+    output += (length - 1) * pitch;
+  }
+
+  // If (exclusive == true) the first row is always 0, otherwise it's a copy of the input
+  if (exclusive) {
+    std::fill_n(output, width, T{});
+  } else {
+    std::copy_n(input, width, output);
+  }
+
+  for (int64_t i = 1; i < length; ++i) {
+    const T* previous_output = output;
+    const T* current_input = exclusive ? input : input + step;
+    output += step;
+    input += step;
+    for (int64_t j = 0; j < width; ++j) {
+      output[j] = previous_output[j] + current_input[j];
+    }
   }
 }
+
+// Two pass scan of a long contiguous row: the sums of the blocks of the row are reduced in parallel, then each block
+// is scanned in parallel starting from the sum of the blocks before it.
 template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
+void ParallelScanRow(const T* input, T* output, int64_t length, bool exclusive, bool reverse,
+                     concurrency::ThreadPool* tp) {
+  const int64_t num_blocks = (length + kScanBlockSize - 1) / kScanBlockSize;
+  std::vector<T> carries(num_blocks);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), static_cast<double>(kScanBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const T* block_input = input + block * kScanBlockSize;
+          const int64_t block_length = std::min(kScanBlockSize, length - block * kScanBlockSize);
+          carries[block] = std::accumulate(block_input, block_input + block_length, T{});
+        }
+      });
+
+  // the carry of each block is the sum of the blocks scanned before it
+  T carry{};
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    const int64_t block = reverse ? num_blocks - 1 - i : i;
+    const T block_sum = carries[block];
+    carries[block] = carry;
+    carry += block_sum;
   }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), static_cast<double>(kScanBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const int64_t offset = block * kScanBlockSize;
+          ScanRow(input + offset, output + offset, std::min(kScanBlockSize, length - offset), exclusive, reverse,
+                  carries[block]);
+        }
+      });
 }
 }  // namespace
 
@@ -147,63 +210,43 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   int64_t axis;
   ORT_THROW_IF_ERROR(cumsum_op::GetAxis(axis_tensor, rank, axis));
 
-  auto dim(output_tensor.Shape()[axis]);    // dimension size for the axis
-  TensorShape slice_shape(input->Shape());  // the shape of one slice of input/output for the given value of the axis
-  slice_shape[axis] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(rank, 1);  // steps for the slice -- always set to 1
-
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
+  // view the input/output as [outer, dim, inner] where dim is the size of the axis
+  const int64_t dim = output_shape[axis];
+  const int64_t outer = output_shape.SizeToDimension(axis);
+  const int64_t inner = output_shape.SizeFromDimension(axis + 1);
+  const T* input_data = input->template Data<T>();
+  T* output_data = output_tensor.template MutableData<T>();
+  const bool exclusive = exclusive_ != 0;
+  const bool reverse = reverse_ != 0;
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  if (tp != nullptr && inner == 1 && dim >= 2 * kScanBlockSize && outer < tp->NumThreads()) {
+    // too few rows to keep the threads busy, so each row is scanned in parallel
+    for (int64_t i = 0; i < outer; ++i) {
+      ParallelScanRow(input_data + i * dim, output_data + i * dim, dim, exclusive, reverse, tp);
     }
+    return Status::OK();
   }
 
+  // the rows, and the blocks of columns of the rows, are independent
+  const int64_t column_blocks = (inner + kColumnsPerBlock - 1) / kColumnsPerBlock;
+  const int64_t columns_per_block = std::min(inner, kColumnsPerBlock);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(outer * column_blocks), static_cast<double>(dim * columns_per_block),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+          const int64_t row = unit / column_blocks;
+          const int64_t first_column = (unit % column_blocks) * kColumnsPerBlock;
+          const int64_t offset = row * dim * inner + first_column;
+          if (inner == 1) {
+            ScanRow(input_data + offset, output_data + offset, dim, exclusive, reverse, T{});
+          } else {
+            ScanColumns(input_data + offset, output_data + offset, dim, inner,
+                        std::min(kColumnsPerBlock, inner - first_column), exclusive, reverse);
+          }
+        }
+      });
+
   return Status::OK();
 }
 
@@ -5,6 +5,7 @@
 #include <unsupported/Eigen/SpecialFunctions>
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tensor/tile.h"
 
 #include <cmath>
 
@@ -18,6 +19,28 @@ namespace onnxruntime {
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       KERNEL_CLASS<TYPE>);
 
+// Unary element-wise kernels may write the output over their input. The allocation planner only does so when
+// the input is not used afterwards and has the same size as the output.
+#define REG_ELEMENTWISE_UNARY_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)                   \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                  \
+      OP_TYPE,                                                                                     \
+      VERSION,                                                                                     \
+      TYPE,                                                                                        \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KERNEL_CLASS<TYPE>);
+
+// Binary element-wise kernels may write the output over either input that has not been broadcast.
+#define REG_ELEMENTWISE_BINARY_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)      \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                      \
+      OP_TYPE,                                                                         \
+      VERSION,                                                                         \
+      TYPE,                                                                            \
+      KernelDefBuilder()                                                               \
+          .MayInplace(0, 0)                                                            \
+          .MayInplace(1, 0)                                                            \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                   \
+      KERNEL_CLASS<TYPE>);
+
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                    \
       OP_TYPE,                                                                       \
@@ -46,58 +69,58 @@ namespace onnxruntime {
           .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),                                           \
       KERNEL_CLASS<TYPE>);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int64_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, float, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, double, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int32_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int64_t, Add);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, float, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, double, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int64_t, Sub);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, float, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, double, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int64_t, Mul);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int64_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, float, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, double, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int32_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int64_t, Div);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, float, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, double, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int64_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, float, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, double, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, int8_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, int16_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, int32_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, int64_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, float, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, double, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int8_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int32_t, Neg);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Neg, 6, float, Neg);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Neg, 6, double, Neg);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Neg, 6, int8_t, Neg);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Neg, 6, int32_t, Neg);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 6, float, Floor);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Floor, 6, float, Floor);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 6, float, Ceil);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Ceil, 6, float, Ceil);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, float, Pow);
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, double, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, float, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, double, Pow);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, float, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, double, Exp);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Exp, 6, float, Exp);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Exp, 6, double, Exp);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 6, float, Log);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Log, 6, float, Log);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, float, Sum_6);
 REG_ELEMENTWISE_TYPED_KERNEL(Sum, 8, float, Sum_8);
@@ -134,7 +157,7 @@ REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint8_t, BitShift);
 REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint32_t, BitShift);
 REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint64_t, BitShift);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Erf, 9, float, Erf);
+REG_ELEMENTWISE_UNARY_TYPED_KERNEL(Erf, 9, float, Erf);
 
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(Not, 1, bool, Not);
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(And, 7, bool, And);
@@ -173,6 +196,21 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Xor);
 
+// Applies an MLAS elementwise routine to a float tensor. Large tensors are split into ranges that run on the
+// intra-op thread pool; cost_per_element is the approximate cost of the routine in cycles per element.
+template <typename Routine>
+static void ParallelElementwise(OpKernelContext* ctx, const Tensor& X, Tensor& Y, double cost_per_element,
+                                Routine routine) {
+  const float* input = X.template Data<float>();
+  float* output = Y.template MutableData<float>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(X.Shape().Size()), cost_per_element,
+      [input, output, &routine](std::ptrdiff_t first, std::ptrdiff_t last) {
+        routine(input + first, output + first, static_cast<size_t>(last - first));
+      });
+}
+
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
   return BroadcastTwo<T, T>(
@@ -234,7 +272,9 @@ Status Reciprocal<float>::Compute(OpKernelContext* ctx) const {
   auto& X = *ctx->Input<Tensor>(0);
   auto& Y = *ctx->Output(0, X.Shape());
 
-  EigenMap<float>(Y) = EigenMap<float>(X).cwiseInverse();
+  ParallelElementwise(ctx, X, Y, 4.0, [](const float* input, float* output, size_t count) {
+    MlasComputePow(input, -1.0f, output, count);
+  });
 
   return Status::OK();
 }
@@ -249,24 +289,40 @@ Status Sqrt<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status Sqrt<float>::Compute(OpKernelContext* ctx) const {
+  auto& X = *ctx->Input<Tensor>(0);
+  auto& Y = *ctx->Output(0, X.Shape());
+
+  ParallelElementwise(ctx, X, Y, 4.0, MlasComputeSqrt);
+
+  return Status::OK();
+}
+
 template <typename T>
-Status Pow<T>::Compute(OpKernelContext* context) const {
-  const Tensor& Y = *context->Input<Tensor>(1);
-  std::function<void(EigenVectorMap<T>, ConstEigenVectorMap<T>, T)> input1scalar =
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = Eigen::pow(input0.array(), input1); };
-  if (Y.Shape().Size() == 1) {
-    T value = *Y.Data<T>();
-    if (value == 2.0) {
-      input1scalar = [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T) { output = Eigen::square(input0.array()); };
-    } else if (value == 3.0) {
-      input1scalar = [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T) { output = Eigen::cube(input0.array()); };
-    }
+static void PowScalarExponent(EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) {
+  if (input1 == 2.0) {
+    output = Eigen::square(input0.array());
+  } else if (input1 == 3.0) {
+    output = Eigen::cube(input0.array());
+  } else {
+    output = Eigen::pow(input0.array(), input1);
   }
+}
+
+template <>
+void PowScalarExponent<float>(EigenVectorMap<float> output, ConstEigenVectorMap<float> input0, float input1) {
+  MlasComputePow(input0.data(), input1, output.data(), static_cast<size_t>(input0.size()));
+}
 
+template <typename T>
+Status Pow<T>::Compute(OpKernelContext* context) const {
+  // A scalar exponent is applied by PowScalarExponent on the pieces that the broadcast loop spreads over the
+  // thread pool.
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = Eigen::pow(input0, input1.array()); },
-      input1scalar,
+      PowScalarExponent<T>,
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = Eigen::pow(input0.array(), input1.array()); });
 }
 
@@ -280,12 +336,22 @@ Status Exp<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status Exp<float>::Compute(OpKernelContext* ctx) const {
+  auto& X = *ctx->Input<Tensor>(0);
+  auto& Y = *ctx->Output(0, X.Shape());
+
+  ParallelElementwise(ctx, X, Y, 16.0, MlasComputeExp);
+
+  return Status::OK();
+}
+
 template <>
 Status Log<float>::Compute(OpKernelContext* ctx) const {
   auto& X = *ctx->Input<Tensor>(0);
   auto& Y = *ctx->Output(0, X.Shape());
 
-  EigenMap<float>(Y) = EigenMap<float>(X).array().log();
+  ParallelElementwise(ctx, X, Y, 24.0, MlasComputeLog);
 
   return Status::OK();
 }
@@ -594,14 +660,14 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sin,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sin<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sin,
     7,
     double,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Sin<double>);
 
 template <typename T>
@@ -621,7 +687,7 @@ class Cos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cos<float>);
 
 template <typename T>
@@ -641,7 +707,7 @@ class Tan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Tan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Tan<float>);
 
 template <typename T>
@@ -661,7 +727,7 @@ class Asin final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asin,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asin<float>);
 
 template <typename T>
@@ -681,7 +747,7 @@ class Acos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acos<float>);
 
 template <typename T>
@@ -701,7 +767,7 @@ class Atan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atan<float>);
 
 template <typename T>
@@ -721,7 +787,7 @@ class Sinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Sinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sinh<float>);
 
 template <typename T>
@@ -741,7 +807,7 @@ class Cosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cosh<float>);
 
 template <typename T>
@@ -773,7 +839,7 @@ class Asinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asinh<float>);
 
 template <typename T>
@@ -805,7 +871,7 @@ class Acosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acosh<float>);
 
 template <typename T>
@@ -837,7 +903,7 @@ class Atanh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atanh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atanh<float>);
 
 template <>
@@ -862,7 +928,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     PRelu,
     7,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
 // This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
@@ -901,8 +967,30 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
   const auto* p_shape = tensor_shape.template Data<int64_t>();
   std::vector<int64_t> shape{p_shape, p_shape + tensor_shape.Shape().Size()};
 
-  TBroadcasterExpand<T> bc(*context->Input<Tensor>(0), shape);
-  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
+  const auto& input_tensor = *context->Input<Tensor>(0);
+  TBroadcasterExpand<T> bc(input_tensor, shape);
+  auto& output_tensor = *context->Output(0, bc.GetOutputShape());
+  const auto& output_dims = output_tensor.Shape().GetDims();
+  if (output_tensor.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  if (!output_dims.empty()) {
+    // broadcasting is tiling the input along its axes of size 1, with the axes it lacks as leading axes of size 1
+    const auto& input_dims = input_tensor.Shape().GetDims();
+    std::vector<int64_t> tile_input_dims(output_dims.size() - input_dims.size(), 1);
+    tile_input_dims.insert(tile_input_dims.end(), input_dims.begin(), input_dims.end());
+    std::vector<int64_t> repeats(output_dims.size());
+    for (size_t axis = 0; axis < output_dims.size(); axis++) {
+      repeats[axis] = output_dims[axis] / tile_input_dims[axis];
+    }
+
+    TileFixedSizeElements(input_tensor.DataRaw(), output_tensor.MutableDataRaw(), tile_input_dims, repeats.data(),
+                          sizeof(T), context->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
+  TBroadcastOutput<T> output(bc.GetSpanSize(), output_tensor);
 
   // This doesn't use BroadcastLoop since there is no second tensor, just duplicating the first
   if (bc.IsInput0Scalar()) {
@@ -945,7 +1033,7 @@ Status Erf<float>::Compute(OpKernelContext* context) const {
   auto& X = *X_ptr;
   auto& Y = *context->Output(0, X.Shape());
 
-  MlasComputeErf(X.template Data<float>(), Y.template MutableData<float>(), X.Shape().Size());
+  ParallelElementwise(context, X, Y, 32.0, MlasComputeErf);
 
   return Status::OK();
 }
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -111,6 +112,10 @@ class Sqrt final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+// float is computed by the vectorized MLAS routine rather than the Eigen expression.
+template <>
+Status Sqrt<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class Pow final : public OpKernel {
  public:
@@ -129,6 +134,10 @@ class Exp final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+// float is computed by the vectorized MLAS routine rather than the Eigen expression.
+template <>
+Status Exp<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class Log final : public OpKernel {
  public:
@@ -330,6 +339,29 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Offset of the input element used for the output element at 'position'.
+  ptrdiff_t OffsetAt(size_t position) const {
+    // every element steps by deltas_[0], and every wrap of a counter adds the delta of the next one
+    ptrdiff_t index = static_cast<ptrdiff_t>(position) * deltas_[0];
+    size_t wraps = position / static_cast<size_t>(counts_[0]);
+    for (size_t counterIndex = 1; counterIndex < counts_.size(); counterIndex++) {
+      index += static_cast<ptrdiff_t>(wraps) * deltas_[counterIndex];
+      wraps /= static_cast<size_t>(counts_[counterIndex]);
+    }
+    return index;
+  }
+
+  // Position the iterator at the output element 'position', which must be a multiple of the span size.
+  void SeekTo(size_t position) {
+    index_ = static_cast<size_t>(OffsetAt(position));
+    counters_[0] = static_cast<int64_t>(position % static_cast<size_t>(counts_[0]));
+    size_t wraps = position / static_cast<size_t>(counts_[0]);
+    for (size_t counterIndex = 1; counterIndex < counts_.size(); counterIndex++) {
+      counters_[counterIndex] = static_cast<int64_t>(wraps % static_cast<size_t>(counts_[counterIndex]));
+      wraps /= static_cast<size_t>(counts_[counterIndex]);
+    }
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(static_cast<size_t>(max_dims));
     counts_.reserve(static_cast<size_t>(max_dims));
@@ -379,7 +411,7 @@ struct BroadcastIterator {
 };
 
 struct Broadcaster {
-  Broadcaster(const std::vector<int64_t>& shape1, const std::vector<int64_t>& shape2) {
+  Broadcaster(TensorShapeDims shape1, TensorShapeDims shape2) {
     size_t dimension_count_max = std::max(shape1.size(), shape2.size());
     size_t dimension_count_min = std::min(shape1.size(), shape2.size());
     output_shape_.resize(dimension_count_max);
@@ -509,6 +541,17 @@ struct TBroadcaster {
   ConstEigenVectorMap<T0> NextEigen0() { return ConstEigenVectorMap<T0>(Next0(), span_size_); }
   ConstEigenVectorMap<T1> NextEigen1() { return ConstEigenVectorMap<T1>(Next1(), span_size_); }
 
+  // Position both inputs at the output element 'position', which must be a multiple of the span size.
+  void SeekTo(size_t position) {
+    broadcaster_.iterator1_.SeekTo(position);
+    broadcaster_.iterator2_.SeekTo(position);
+  }
+
+  // The input elements used for the output element at 'position'. The following elements of a span are
+  // contiguous, unless the input is a scalar for the span.
+  const T0* Input0At(size_t position) const { return input0_ + broadcaster_.iterator1_.OffsetAt(position); }
+  const T1* Input1At(size_t position) const { return input1_ + broadcaster_.iterator2_.OffsetAt(position); }
+
  private:
   const T0* Next0() { return input0_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
   const T1* Next1() { return input1_ + broadcaster_.iterator2_.AdvanceBy(span_size_); }
@@ -530,6 +573,13 @@ struct TBroadcastOutput {
     output_end_ = output_ + tensor.Shape().Size();
   }
 
+  // output for the spans [first_span, last_span)
+  TBroadcastOutput(size_t span_size, Tensor& tensor, size_t first_span, size_t last_span)
+      : span_size_(span_size) {
+    output_ = tensor.template MutableData<T>() + first_span * span_size;
+    output_end_ = output_ + (last_span - first_span) * span_size;
+  }
+
   operator bool() const {
     return output_ != output_end_;
   }
@@ -610,11 +660,70 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// Eigen broadcast loop (see BroadcastLoop) that splits the output across the intra-op threads.
+// Short spans, e.g. a per-channel bias over NCHW, are distributed in ranges that each thread walks with its own
+// copy of the broadcaster. Long spans, e.g. for inputs of the same shape or a scalar input, are split into pieces
+// so that a single span runs in parallel too.
+// cost_per_element is the estimated number of CPU cycles to compute one output element.
+template <typename TInput0, typename TInput1, typename TOutput, typename Input0Scalar, typename Input1Scalar,
+          typename General>
+void ParallelBroadcastLoop(concurrency::ThreadPool* tp, TBroadcaster<TInput0, TInput1>& bc, Tensor& output_tensor,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general,
+                           double cost_per_element = 1.0) {
+  const size_t span_size = bc.GetSpanSize();
+  const size_t output_size = static_cast<size_t>(output_tensor.Shape().Size());
+  if (span_size == 0 || output_size == 0) {
+    return;
+  }
+
+  const size_t span_count = output_size / span_size;
+  constexpr size_t kPieceSize = 4096;
+
+  if (span_size <= kPieceSize) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(span_count), cost_per_element * static_cast<double>(span_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          TBroadcaster<TInput0, TInput1> range_bc(bc);
+          range_bc.SeekTo(static_cast<size_t>(first) * span_size);
+          TBroadcastOutput<TOutput> output(span_size, output_tensor, static_cast<size_t>(first),
+                                           static_cast<size_t>(last));
+          BroadcastLoop(range_bc, output, input0scalar, input1scalar, general);
+        });
+    return;
+  }
+
+  const bool input0_scalar = bc.IsInput0Scalar();
+  const bool input1_scalar = bc.IsInput1Scalar();
+  const size_t pieces_per_span = (span_size + kPieceSize - 1) / kPieceSize;
+  TOutput* output = output_tensor.template MutableData<TOutput>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(span_count * pieces_per_span), cost_per_element * kPieceSize,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t piece = first; piece < last; piece++) {
+          const size_t offset_in_span = (static_cast<size_t>(piece) % pieces_per_span) * kPieceSize;
+          const size_t position = (static_cast<size_t>(piece) / pieces_per_span) * span_size + offset_in_span;
+          const std::ptrdiff_t count = static_cast<std::ptrdiff_t>(std::min(kPieceSize, span_size - offset_in_span));
+
+          EigenVectorMap<TOutput> output_map(output + position, count);
+          if (input0_scalar) {
+            input0scalar(output_map, *bc.Input0At(position), ConstEigenVectorMap<TInput1>(bc.Input1At(position), count));
+          } else if (input1_scalar) {
+            input1scalar(output_map, ConstEigenVectorMap<TInput0>(bc.Input0At(position), count), *bc.Input1At(position));
+          } else {
+            general(output_map, ConstEigenVectorMap<TInput0>(bc.Input0At(position), count),
+                    ConstEigenVectorMap<TInput1>(bc.Input1At(position), count));
+          }
+        }
+      });
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  Tensor& output = *context.Output(0, bc.GetOutputShape());
+  ParallelBroadcastLoop<TInput, TInput, TOutput>(context.GetOperatorThreadPool(), bc, output,
+                                                 input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -651,9 +760,8 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TInput, TInput, TOutput>(context.GetOperatorThreadPool(), bc, *p_output,
+                                                   input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
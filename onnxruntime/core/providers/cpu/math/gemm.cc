@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 
@@ -26,4 +27,124 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(trans_B_ == CblasNoTrans ? tensor.Shape()[0] : tensor.Shape()[1]);
+  const size_t N = static_cast<size_t>(trans_B_ == CblasNoTrans ? tensor.Shape()[1] : tensor.Shape()[0]);
+  const size_t ldb = trans_B_ == CblasNoTrans ? N : K;
+
+  // a pruned W is packed with only its non-zero values. MlasHalfGemm has no transposed A.
+  const size_t sparse_b_size = MlasSparseGemmPackBSize(trans_B_, N, K, tensor.Data<float>(), ldb);
+  packed_b_is_sparse_ = sparse_b_size != 0;
+  const auto* provider = Info().GetExecutionProvider();
+  packed_b_is_fp16_ = !packed_b_is_sparse_ && trans_A_ == CblasNoTrans &&
+                      provider != nullptr && provider->Type() == kCpuExecutionProvider &&
+                      static_cast<const CPUExecutionProvider*>(provider)->UseFp16Weights(tensor.Data<float>(), N * K);
+  const size_t packed_b_size = packed_b_is_sparse_ ? sparse_b_size
+                                                   : packed_b_is_fp16_ ? MlasHalfGemmPackBSize(N, K)
+                                                                       : MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  if (packed_b_is_sparse_) {
+    MlasSparseGemmPackB(trans_B_, N, K, tensor.Data<float>(), ldb, packed_b_data);
+  } else if (packed_b_is_fp16_) {
+    MlasHalfGemmPackB(trans_B_, N, K, tensor.Data<float>(), ldb, packed_b_data);
+  } else {
+    MlasGemmPackB(trans_B_, N, K, tensor.Data<float>(), ldb, packed_b_data);
+  }
+
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
+template <>
+bool Gemm<float>::TryComputeWithOutputStage(const Tensor* X, const Tensor* W, const Tensor* B,
+                                            const GemmHelper& helper, float* y_data,
+                                            concurrency::ThreadPool* thread_pool) const {
+  MLAS_ACTIVATION activation;
+  if (activation_.empty()) {
+    activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "Sigmoid") {
+    activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation_ == "Tanh") {
+    activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "LeakyRelu") {
+    activation.ActivationKind = MlasLeakyReluActivation;
+    activation.Parameters.LeakyRelu.alpha = leaky_relu_alpha_;
+  } else {
+    return false;
+  }
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const bool use_packed_b = packed_b_ != nullptr && W->Shape() == b_shape_;
+
+  // the output stage runs after the last slice of K is accumulated, so it can't produce a bias only output.
+  // MlasSparseGemm and MlasHalfGemm have no output stage.
+  if (K == 0 || (use_packed_b && (packed_b_is_sparse_ || packed_b_is_fp16_))) {
+    return false;
+  }
+#if defined(USE_MKLML_FOR_BLAS)
+  // the unpacked GEMM is computed by MKL
+  if (!use_packed_b) {
+    return false;
+  }
+#endif
+
+  MLAS_SGEMM_OUTPUT_STAGE output_stage;
+  output_stage.Bias = nullptr;
+  output_stage.BiasRowStride = 0;
+  output_stage.BiasColumnStride = 0;
+  output_stage.BiasScale = beta_;
+  output_stage.Activation = activation_.empty() ? nullptr : &activation;
+
+  if (beta_ != 0 && B != nullptr) {
+    const auto& b_shape = B->Shape();
+    output_stage.Bias = B->Data<float>();
+    if (b_shape.Size() == 1) {
+      // B is (), (1,) or (1, 1), broadcast the scalar
+    } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+      // B is (N,) or (1, N)
+      output_stage.BiasColumnStride = 1;
+    } else if (b_shape[1] == 1) {
+      // B is (M, 1)
+      output_stage.BiasRowStride = 1;
+    } else {
+      // B is (M, N)
+      output_stage.BiasRowStride = N;
+      output_stage.BiasColumnStride = 1;
+    }
+  }
+
+  const bool has_output_stage = output_stage.Bias != nullptr || output_stage.Activation != nullptr;
+  const size_t lda = trans_A_ == CblasNoTrans ? K : M;
+
+  if (use_packed_b) {
+    MlasGemm(trans_A_, M, N, K, alpha_, X->Data<float>(), lda, packed_b_.get(), 0.f, y_data, N,
+             has_output_stage ? &output_stage : nullptr, thread_pool);
+  } else {
+    MlasGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<float>(), lda, W->Data<float>(),
+             trans_B_ == CblasNoTrans ? N : K, 0.f, y_data, N,
+             has_output_stage ? &output_stage : nullptr, thread_pool);
+  }
+
+  return true;
+}
+
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -26,6 +27,11 @@ class Gemm : public OpKernel {
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
+  Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) override {
+    is_packed = false;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* context) const override {
     concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
@@ -47,6 +53,10 @@ class Gemm : public OpKernel {
       return Status::OK();
     T* y_data = Y->template MutableData<T>();
 
+    if (TryComputeWithOutputStage(X, W, B, helper, y_data, thread_pool)) {
+      return Status::OK();
+    }
+
     // Broadcast the bias as needed if bias is given
     if (beta_ != 0 && B != nullptr) {
       auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
@@ -68,20 +78,68 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        helper.K(),
-        alpha_,
-        X->template Data<T>(),
-        W->template Data<T>(),
-        // ideally we need to set the output buffer contents to 0 if bias is missing,
-        // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
-        B != nullptr ? beta_ : 0,
-        y_data,
-        thread_pool);
+    if (packed_b_ != nullptr && packed_b_is_sparse_ && W->Shape() == b_shape_) {
+      // W is mostly zeros and was packed by PrePack
+      const int64_t K = helper.K();
+      MlasSparseGemm(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          packed_b_.get(),
+          B != nullptr ? beta_ : 0,
+          y_data,
+          static_cast<size_t>(N),
+          thread_pool);
+    } else if (packed_b_ != nullptr && packed_b_is_fp16_ && W->Shape() == b_shape_) {
+      // W was packed as half precision by PrePack
+      MlasHalfGemm(
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(helper.K()),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          B != nullptr ? beta_ : 0,
+          y_data,
+          static_cast<size_t>(N),
+          thread_pool);
+    } else if (packed_b_ != nullptr && W->Shape() == b_shape_) {
+      // W was packed by PrePack
+      const int64_t K = helper.K();
+      MlasGemm(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          packed_b_.get(),
+          B != nullptr ? beta_ : 0,
+          y_data,
+          static_cast<size_t>(N),
+          thread_pool);
+    } else {
+      math::Gemm<T>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          helper.K(),
+          alpha_,
+          X->template Data<T>(),
+          W->template Data<T>(),
+          // ideally we need to set the output buffer contents to 0 if bias is missing,
+          // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
+          B != nullptr ? beta_ : 0,
+          y_data,
+          thread_pool);
+    }
 
     FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -89,15 +147,39 @@ class Gemm : public OpKernel {
   }
 
  private:
+  // Computes Y in a single pass by adding the bias and applying the activation in the output stage of the GEMM.
+  // Returns false if this isn't supported, in which case the bias and the activation are separate passes.
+  bool TryComputeWithOutputStage(const Tensor* /*X*/, const Tensor* /*W*/, const Tensor* /*B*/,
+                                 const GemmHelper& /*helper*/, T* /*y_data*/,
+                                 concurrency::ThreadPool* /*thread_pool*/) const {
+    return false;
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
 
+  // constant W packed by PrePack
+  BufferUniquePtr packed_b_;
+  TensorShape b_shape_;
+  // W is mostly zeros and was packed for MlasSparseGemm
+  bool packed_b_is_sparse_{false};
+  // W was packed as half precision for MlasHalfGemm, which needs a transA of 0
+  bool packed_b_is_fp16_{false};
+
  protected:
   // For fused gemm + activation
   std::string activation_;
   float leaky_relu_alpha_;
 };
 
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed);
+
+template <>
+bool Gemm<float>::TryComputeWithOutputStage(const Tensor* X, const Tensor* W, const Tensor* B,
+                                            const GemmHelper& helper, float* y_data,
+                                            concurrency::ThreadPool* thread_pool) const;
+
 }  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -65,6 +67,63 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint64_t>()),
     MatMul<uint64_t>);
 
+template <typename T>
+Status MatMul<T>::PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) {
+  is_packed = false;
+  return Status::OK();
+}
+
+template <>
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // only pack a 2-D B. the batched cases need a packed copy per matrix.
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+
+  const auto* provider = Info().GetExecutionProvider();
+  const auto* cpu_provider = provider != nullptr && provider->Type() == kCpuExecutionProvider
+                                 ? static_cast<const CPUExecutionProvider*>(provider)
+                                 : nullptr;
+  const bool use_bf16 = cpu_provider != nullptr && cpu_provider->UseBf16Gemm();
+  const bool use_fp16 = cpu_provider != nullptr && !use_bf16 &&
+                        cpu_provider->UseFp16Weights(tensor.Data<float>(), N * K);
+
+  // a pruned B is packed with only its non-zero values. this is exact, so it is preferred over bfloat16 and half.
+  const size_t sparse_b_size = MlasSparseGemmPackBSize(CblasNoTrans, N, K, tensor.Data<float>(), N);
+  const bool use_sparse = sparse_b_size != 0;
+  const size_t packed_b_size = use_sparse ? sparse_b_size
+                                          : use_bf16 ? MlasBf16GemmPackBSize(N, K)
+                                                     : use_fp16 ? MlasHalfGemmPackBSize(N, K) : MlasGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  if (use_sparse) {
+    MlasSparseGemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_data);
+  } else if (use_bf16) {
+    MlasBf16GemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_data);
+  } else if (use_fp16) {
+    MlasHalfGemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_data);
+  } else {
+    MlasGemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_data);
+  }
+  packed_b_is_sparse_ = use_sparse;
+  packed_b_is_bf16_ = !use_sparse && use_bf16;
+  packed_b_is_fp16_ = !use_sparse && use_fp16;
+
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -91,4 +150,112 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // the packed B is only valid for the 2-D B it was created from, which always gives a single output offset
+  const bool use_packed_b = packed_b_ != nullptr && right_X->Shape() == b_shape_;
+
+  size_t max_len = helper.OutputOffsets().size();
+  if (!use_packed_b) {
+    // the broadcast batch is multiplied by a single batched gemm, so the threads are shared by the slices and the
+    // blocks of each slice rather than only splitting one slice at a time
+    std::vector<const float*> left_data(max_len);
+    std::vector<const float*> right_data(max_len);
+    std::vector<float*> output_data(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      left_data[i] = left_X->Data<float>() + helper.LeftOffsets()[i];
+      right_data[i] = right_X->Data<float>() + helper.RightOffsets()[i];
+      output_data[i] = Y->MutableData<float>() + helper.OutputOffsets()[i];
+    }
+
+    MlasGemmBatch(
+        CblasNoTrans,
+        CblasNoTrans,
+        static_cast<size_t>(helper.M()),
+        static_cast<size_t>(helper.N()),
+        static_cast<size_t>(helper.K()),
+        1.0f,
+        left_data.data(),
+        static_cast<size_t>(helper.K()),
+        right_data.data(),
+        static_cast<size_t>(helper.N()),
+        0.0f,
+        output_data.data(),
+        static_cast<size_t>(helper.N()),
+        max_len,
+        thread_pool);
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < max_len; i++) {
+    if (packed_b_is_sparse_) {
+      MlasSparseGemm(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+    } else if (packed_b_is_bf16_) {
+      MlasBf16Gemm(
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+    } else if (packed_b_is_fp16_) {
+      MlasHalfGemm(
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+    } else {
+      MlasGemm(
+          CblasNoTrans,
+          static_cast<size_t>(helper.M()),
+          static_cast<size_t>(helper.N()),
+          static_cast<size_t>(helper.K()),
+          1.0f,
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          static_cast<size_t>(helper.K()),
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + helper.OutputOffsets()[i],
+          static_cast<size_t>(helper.N()),
+          thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
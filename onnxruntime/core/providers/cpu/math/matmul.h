@@ -15,7 +15,26 @@ class MatMul final : public OpKernel {
       : OpKernel(info) {
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // constant B packed by PrePack
+  BufferUniquePtr packed_b_;
+  TensorShape b_shape_;
+  // B was packed as bfloat16 for MlasBf16Gemm instead of MlasGemm
+  bool packed_b_is_bf16_{false};
+  // B was packed as half precision for MlasHalfGemm instead of MlasGemm
+  bool packed_b_is_fp16_{false};
+  // B is mostly zeros and was packed for MlasSparseGemm
+  bool packed_b_is_sparse_{false};
 };
 
+template <>
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed);
+
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const;
+
 }  // namespace onnxruntime
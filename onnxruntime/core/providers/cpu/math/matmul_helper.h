@@ -9,7 +9,10 @@ namespace onnxruntime {
 
 class MatMulComputeHelper {
  public:
-  Status Compute(const TensorShape& left_shape, const TensorShape& right_shape) {
+  // transa and transb select the transposed form of inputs that are at least 2-D, in which the last two dimensions
+  // of the input are swapped. the matrices are then read from the original data with the transposed layout.
+  Status Compute(const TensorShape& orig_left_shape, const TensorShape& orig_right_shape,
+                 bool transa = false, bool transb = false) {
     // Following numpy.matmul for shape inference:
     // https://docs.scipy.org/doc/numpy/reference/generated/numpy.matmul.html
     // The behavior depends on the arguments in the following way.
@@ -18,13 +21,22 @@ class MatMulComputeHelper {
     // * If the first argument is 1 - D, it is promoted to a matrix by prepending a 1 to its dimensions.After matrix multiplication the prepended 1 is removed.
     // * If the second argument is 1 - D, it is promoted to a matrix by appending a 1 to its dimensions.After matrix multiplication the appended 1 is removed.
 
-    size_t left_num_dims = left_shape.NumDimensions();
-    size_t right_num_dims = right_shape.NumDimensions();
+    size_t left_num_dims = orig_left_shape.NumDimensions();
+    size_t right_num_dims = orig_right_shape.NumDimensions();
     ORT_RETURN_IF_NOT(left_num_dims >= 1 && right_num_dims >= 1);
+    ORT_RETURN_IF_NOT((!transa || left_num_dims >= 2) && (!transb || right_num_dims >= 2),
+                      "Transposed MatMul operands must have at least 2 dimensions");
+    // a 1-D right operand treats each row of the left operand as a separate matrix, which needs contiguous rows.
+    ORT_RETURN_IF_NOT(!transa || right_num_dims >= 2,
+                      "A transposed left MatMul operand requires a right operand with at least 2 dimensions");
+
+    const TensorShape left_shape = transa ? TransposeLastTwoDims(orig_left_shape) : orig_left_shape;
+    const TensorShape right_shape = transb ? TransposeLastTwoDims(orig_right_shape) : orig_right_shape;
 
     // special case for right_shape being 2D and left_shape > 2D by flattening left_shape to 2D
     // note that padding 1s in front of the right shape can be flattened too
-    if (left_num_dims >= 2 && right_num_dims >= 2 &&
+    // the rows of a transposed left operand are not contiguous, so it can't be flattened.
+    if (!transa && left_num_dims >= 2 && right_num_dims >= 2 &&
         right_shape.SizeToDimension(right_num_dims - 1) == right_shape[right_num_dims - 2]) {
       M_ = left_shape.SizeToDimension(left_num_dims - 1);
       K_ = left_shape[left_num_dims - 1];
@@ -121,6 +133,12 @@ class MatMulComputeHelper {
   }
 
  private:
+  static TensorShape TransposeLastTwoDims(const TensorShape& shape) {
+    std::vector<int64_t> dims = shape.GetDims();
+    std::swap(dims[dims.size() - 2], dims[dims.size() - 1]);
+    return TensorShape(dims);
+  }
+
   void ComputeBroadcastOffsets() {
     num_broadcasted_dims_ = left_padded_dims_.size() - 2;
 
@@ -34,6 +34,48 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
     MatMulInteger<uint8_t, int8_t>);
 
+// b_zero_point is a scalar or has a zero point for each column of b (N values).
+// column_zero_points is set to nullptr for a scalar.
+template <typename T>
+static Status GetBZeroPoint(const Tensor& b_zero_point, int64_t N, T& scalar_zero_point,
+                            const T*& column_zero_points) {
+  scalar_zero_point = 0;
+  column_zero_points = nullptr;
+  if (IsScalarOr1ElementVector(&b_zero_point)) {
+    scalar_zero_point = *b_zero_point.template Data<T>();
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(b_zero_point.Shape().NumDimensions() == 1 && b_zero_point.Shape()[0] == N,
+                    "MatmulInteger : input2 zero point must be a scalar or 1D tensor with one value per column. Got ",
+                    b_zero_point.Shape(), " for ", N, " columns");
+  column_zero_points = b_zero_point.template Data<T>();
+  return Status::OK();
+}
+
+// Runs fn(i, thread_pool) for each slice i of the broadcast batch. With at least as many slices as threads, the
+// slices are spread over the thread pool and each runs on a single thread, rather than splitting one slice at a time
+// over the pool. The fewer slices of a small batch run in order and are each split over the pool.
+template <typename Fn>
+static void ForEachSlice(concurrency::ThreadPool* thread_pool, const MatMulComputeHelper& helper, Fn&& fn) {
+  const size_t count = helper.OutputOffsets().size();
+  if (thread_pool == nullptr || count < static_cast<size_t>(thread_pool->NumThreads()) + 1) {
+    for (size_t i = 0; i < count; i++) {
+      fn(i, thread_pool);
+    }
+    return;
+  }
+
+  const double cost = static_cast<double>(helper.M()) * static_cast<double>(helper.N()) *
+                      static_cast<double>(helper.K());
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(count), cost, [&fn](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          fn(static_cast<size_t>(i), nullptr);
+        }
+      });
+}
+
 template <>
 Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -49,6 +91,7 @@ Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
   // validate zero points
   uint8_t a_offset = 0;
   uint8_t b_offset = 0;
+  const uint8_t* b_column_offsets = nullptr;
   if (has_a_zero_point_) {
     auto a_zero_point = ctx->Input<Tensor>(2);
     ORT_ENFORCE(IsScalarOr1ElementVector(a_zero_point),
@@ -56,26 +99,38 @@ Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
     a_offset = static_cast<int32_t>(*a_zero_point->template Data<uint8_t>());
   }
   if (has_b_zero_point_) {
-    auto b_zero_point = ctx->Input<Tensor>(3);
-    ORT_ENFORCE(IsScalarOr1ElementVector(b_zero_point),
-                "MatmulInteger : input2 zero point must be a scalar or 1D tensor of size 1");
-    b_offset = static_cast<int32_t>(*b_zero_point->template Data<uint8_t>());
+    ORT_RETURN_IF_ERROR(GetBZeroPoint(*ctx->Input<Tensor>(3), helper.N(), b_offset, b_column_offsets));
   }
 
-  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
-    QGemmu8u8_s32(static_cast<int>(helper.M()),
-                  static_cast<int>(helper.N()),
-                  static_cast<int>(helper.K()),
-                  a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                  static_cast<int>(helper.K()),
-                  a_offset,
-                  b->template Data<uint8_t>() + helper.RightOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  b_offset,
-                  y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  thread_pool);
-  }
+  ForEachSlice(thread_pool, helper, [&](size_t i, concurrency::ThreadPool* slice_thread_pool) {
+    if (b_column_offsets != nullptr) {
+      QGemmu8u8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    a_offset,
+                    b->template Data<uint8_t>() + helper.RightOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    b_column_offsets,
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    slice_thread_pool);
+    } else {
+      QGemmu8u8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    a_offset,
+                    b->template Data<uint8_t>() + helper.RightOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    b_offset,
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    slice_thread_pool);
+    }
+  });
   return Status::OK();
 }
 
@@ -91,40 +146,58 @@ Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
   ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
   Tensor* y = ctx->Output(0, helper.OutputShape());
 
-  if (has_a_zero_point_ || has_b_zero_point_) {
-    // currently zero point is only supported in Gemmlowp path above
+  if (has_a_zero_point_) {
+    // currently a non-zero zero point of a is only supported in Gemmlowp path above
     // in future, the selection of Eigen/Gemmlowp/mklml/etc. should be in a common math library like SGEMM
-
-    auto IsZeroPointTensorAllZero = [](OpKernelContext* ctx, int input_idx) -> bool {
-      auto t = ctx->Input<Tensor>(input_idx);
-      ORT_ENFORCE(t->Shape().NumDimensions() <= 1 && t->Shape().Size() == 1,
-                  "Currently only scalar zero_point is supported. TODO: add per channel zero point support.");
-      ORT_ENFORCE(t->IsDataType<int8_t>() || t->IsDataType<uint8_t>());
-      auto data = reinterpret_cast<const int8_t*>(t->DataRaw());
-      auto vec = std::vector<int8_t>(data, data + t->Shape().Size());
-      return std::all_of(vec.begin(), vec.end(), [](int8_t v) { return v == 0; });
-    };
-
-    if ((has_a_zero_point_ && !IsZeroPointTensorAllZero(ctx, 2)) ||
-        (has_b_zero_point_ && !IsZeroPointTensorAllZero(ctx, 3))) {
+    auto a_zero_point = ctx->Input<Tensor>(2);
+    ORT_ENFORCE(IsScalarOr1ElementVector(a_zero_point),
+                "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
+    if (*static_cast<const uint8_t*>(a_zero_point->DataRaw()) != 0) {
       ORT_NOT_IMPLEMENTED("MatMulInteger: Unsupported input types with zero point");
     }
   }
 
-  for (int i = 0; i < static_cast<int>(helper.OutputOffsets().size()); i++) {
-    QGemmu8s8_s32(static_cast<int>(helper.M()),
-                  static_cast<int>(helper.N()),
-                  static_cast<int>(helper.K()),
-                  a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                  static_cast<int>(helper.K()),
-                  0,
-                  b->template Data<int8_t>() + helper.RightOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  0,
-                  y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  thread_pool);
+  // a non-zero zero point of b is applied per column, so expand a scalar one
+  int8_t b_offset = 0;
+  const int8_t* b_column_offsets = nullptr;
+  std::vector<int8_t> b_expanded_offsets;
+  if (has_b_zero_point_) {
+    ORT_RETURN_IF_ERROR(GetBZeroPoint(*ctx->Input<Tensor>(3), helper.N(), b_offset, b_column_offsets));
+    if (b_column_offsets == nullptr && b_offset != 0) {
+      b_expanded_offsets.assign(static_cast<size_t>(helper.N()), b_offset);
+      b_column_offsets = b_expanded_offsets.data();
+    }
   }
+
+  ForEachSlice(thread_pool, helper, [&](size_t i, concurrency::ThreadPool* slice_thread_pool) {
+    if (b_column_offsets != nullptr) {
+      QGemmu8s8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    0,
+                    b->template Data<int8_t>() + helper.RightOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    b_column_offsets,
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    slice_thread_pool);
+    } else {
+      QGemmu8s8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    0,
+                    b->template Data<int8_t>() + helper.RightOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    static_cast<int8_t>(0),
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    slice_thread_pool);
+    }
+  });
   return Status::OK();
 }
 }  // namespace onnxruntime
@@ -6,7 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
-#include "core/util/gemmlowp_common.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 
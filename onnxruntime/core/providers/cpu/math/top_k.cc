@@ -20,7 +20,7 @@
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
-#include "core/util/math_cpuonly.h"
+#include "core/platform/threadpool.h"
 #include <queue>
 #include <algorithm>
 #include <cmath>
@@ -30,7 +30,7 @@ namespace onnxruntime {
 
 template <typename T>
 struct GreaterValueCmp {
-  bool operator()(const pair<T, int64_t>& lhs, const pair<T, int64_t>& rhs) {
+  bool operator()(const pair<T, int64_t>& lhs, const pair<T, int64_t>& rhs) const {
     return (lhs.first > rhs.first ||
             // when values are equal, we want lhs to get higher "priority"
             // if its corresponding index comes first (i.e.) is lower
@@ -40,7 +40,7 @@ struct GreaterValueCmp {
 
 template <typename T>
 struct LesserValueCmp {
-  bool operator()(const pair<T, int64_t>& lhs, const pair<T, int64_t>& rhs) {
+  bool operator()(const pair<T, int64_t>& lhs, const pair<T, int64_t>& rhs) const {
     return (lhs.first < rhs.first ||
             // when values are equal, we want lhs to get higher "priority"
             // if its corresponding index comes first (i.e.) is lower
@@ -50,125 +50,154 @@ struct LesserValueCmp {
 
 // Static helpers that implement the core logic for each of the 'TopK' operator flavor
 
-// Selects the top k elements (largest or smallest based on template parameter)
-template <class Comparator>
-static vector<pair<float, int64_t>> select_top_k(const ConstEigenMatrixMapRowMajor<float>& raw_data, int64_t row_num, int64_t num_blocks,
-                                                 int64_t block_slice, int64_t inter_block_offset, const unsigned k,
-                                                 bool sort_top_k) {
-  // create a data holder and insert elements
-  vector<pair<float, int64_t>> data_holder;
-  data_holder.reserve(num_blocks);
-  for (int64_t l = 0; l < num_blocks; ++l) {
-    data_holder.push_back({raw_data(row_num, l * block_slice + inter_block_offset), l});
-  }
-
-  // find the top k (largest or smallest) elements in the data holder - O(n)
-  nth_element(data_holder.begin(), data_holder.begin() + (k - 1), data_holder.end(), Comparator());
+// The heap selection is used when k is at most 1 / kHeapSelectRatio of the number of values. It only needs k
+// elements of extra storage and rejects most values with a single comparison against the top of the heap.
+// Otherwise the values are copied and partitioned with nth_element, which is O(n) regardless of k.
+static constexpr int64_t kHeapSelectRatio = 8;
+
+// Rows with at least this many values per thread are split into chunks that are selected on different threads
+// when there are too few rows to keep all of the threads busy.
+static constexpr int64_t kMinValuesPerChunk = 16 * 1024;
+
+// Selects the top k elements (largest or smallest based on template parameter) of the n values
+// data[0], data[stride], ... into top_k, in no particular order. The index of data[0] is first_index.
+// If n < k all n values are selected.
+template <bool largest, typename T, class Comparator>
+static void select_top_k(const T* data, int64_t n, int64_t stride, int64_t first_index, const unsigned k,
+                         vector<pair<T, int64_t>>& top_k) {
+  top_k.clear();
+  Comparator comparator;
+
+  if (static_cast<int64_t>(k) * kHeapSelectRatio > n) {
+    // create a data holder and insert elements
+    top_k.reserve(n);
+    for (int64_t l = 0; l < n; ++l) {
+      top_k.emplace_back(data[l * stride], first_index + l);
+    }
 
-  // sort the top k elements if needed - O (k log k)
-  if (sort_top_k) {
-    std::sort(data_holder.begin(), data_holder.begin() + k, Comparator());
+    // find the top k (largest or smallest) elements in the data holder - O(n)
+    if (static_cast<int64_t>(k) < n) {
+      nth_element(top_k.begin(), top_k.begin() + (k - 1), top_k.end(), comparator);
+      top_k.resize(k);
+    }
+    return;
   }
 
-  // the data_holder now contains the top k elements in the first k indices
-  return data_holder;
+  // Build a min-heap/max-heap of the first k elements, the heap element is pair of (value, idx)
+  // The top of the heap is the smallest/largest value depending on whether it is a min-heap/max-heap
+  // This is a min-heap if largest == true, this is a max-heap if largest == false
+  top_k.reserve(k);
+  for (int64_t l = 0; l < k; ++l) {
+    top_k.emplace_back(data[l * stride], first_index + l);
+  }
+  make_heap(top_k.begin(), top_k.end(), comparator);
+
+  // the remaining values have higher indices than all of the elements in the heap, so they only replace the top
+  // if their value is strictly better
+  T threshold = top_k.front().first;
+  for (int64_t l = k; l < n; ++l) {
+    const T value = data[l * stride];
+    if (largest ? value > threshold : value < threshold) {  // the optimizer will clean-up the redundant condition
+                                                            // based on the template parameter 'largest'
+      pop_heap(top_k.begin(), top_k.end(), comparator);
+      top_k.back() = {value, first_index + l};
+      push_heap(top_k.begin(), top_k.end(), comparator);
+      threshold = top_k.front().first;
+    }
+  }
 }
 
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
-template <bool largest, bool sorted, class Comparator>
+template <bool largest, bool sorted, typename T, class Comparator>
 static void extract_top_k_elements(const Tensor* input, const TensorShape& input_shape, Tensor* values,
                                    Tensor* indices, const TensorShape& output_shape, const unsigned k,
-                                   const unsigned axis_parsed) {
+                                   const unsigned axis_parsed, concurrency::ThreadPool* tp) {
   // Cache some values that will be used in the implementation below
   const int64_t rows = input_shape.SizeToDimension(static_cast<size_t>(axis_parsed));
   const int64_t cols = input->Shape().Size() / rows;
-  auto input_map =
-      ConstEigenMatrixMapRowMajor<float>(static_cast<const float*>(input->template Data<float>()), rows, cols);
+  const T* input_data = input->template Data<T>();
 
-  // Use Eigen maps to allow indexing into the 2d tensors like Values_map(i,j)
   const int64_t reduced_cols = output_shape.SizeFromDimension(static_cast<size_t>(axis_parsed));
-  auto values_map = EigenMatrixMapRowMajor<float>(values->template MutableData<float>(), rows, reduced_cols);
-  auto indices_map = EigenMatrixMapRowMajor<int64_t>(indices->template MutableData<int64_t>(), rows, reduced_cols);
+  T* values_data = values->template MutableData<T>();
+  int64_t* indices_data = indices->template MutableData<int64_t>();
 
   // This is basically the number of elements within each of the "k" rows
   const int64_t block_slice = reduced_cols / k;
   const int64_t num_blocks = input_shape[axis_parsed];
 
-  for (int64_t i = 0; i < rows; ++i) {
-    for (int64_t j = 0; j < block_slice; ++j) {
-      // Since sorted == true, we will use a Heap to hold the top K values in sorted fashion
-      if (sorted) {  // The optimizer will clean-up the redundant condition based on the template parameter 'sorted'
-        auto n_casted = static_cast<double>(num_blocks);
-        auto k_casted = static_cast<double>(k);
-        if ((n_casted + k_casted * log(k_casted)) < (n_casted * log(k_casted))) {
-          // Select first  - O(n), then sort O(k * ln(k))
-          // Overall complexity =  O (n + k * ln(k))
-          const auto& data_holder = select_top_k<Comparator>(input_map, i, num_blocks, block_slice, j, k, true);
-          for (int64_t l = 0; l < k; ++l) {
-            const auto& elem = data_holder[l];
-            auto col_index = l * block_slice + j;
-            values_map(i, col_index) = elem.first;
-            indices_map(i, col_index) = elem.second;
-          }
-        } else {
-          // Perform sorted selection by passing 'n' elements over a heap of size 'k'
-          // overall complexity =  O (n * ln(k))
-
-          // Build a min-heap/max-heap, the heap element is pair of (value, idx)
-          // The top of the heap is the smallest/largest value depending on whether it is a min-heap/max-heap
-          // This is a min-heap if largest == true, this is a max-heap if largest == false
-          priority_queue<pair<float, int64_t>, vector<pair<float, int64_t>>, Comparator> heap;
-
-          // Maintain the size of heap to be less or equal to k, so the
-          // heap will hold the k largest/smallest values
-          for (int64_t l = 0; l < num_blocks; ++l) {
-            const auto value = input_map(i, l * block_slice + j);
-            // largest == true: insert into the min-heap if the size is < k or if the new
-            // element is greater than the min element in the min-heap
-
-            // largest == false: insert into the min-heap if the size is < k or if the new
-            // element is lesser than the max element in the max-heap
-            if ((heap.size() < k) || (largest && value > heap.top().first) ||
-                (!largest && value < heap.top().first)) {  // the optimizer will clean-up the redundant condition based
-                                                           // on the template parameter 'largest'
-              heap.push({value, l});
-            }
-            if (heap.size() > k) {
-              heap.pop();
-            }
-          }
-          // Extract these k elements and place them in the results placeholder
-          for (int64_t l = 0; l < k; ++l) {
-            const auto& elem = heap.top();
-            auto col_index = (k - l - 1) * block_slice + j;
-            values_map(i, col_index) = elem.first;
-            indices_map(i, col_index) = elem.second;
-            heap.pop();
+  // each (row, position within the block) pair selects the top k of num_blocks values
+  const int64_t num_selections = rows * block_slice;
+
+  // Insert the top 'k' (largest or smallest) elements into the final output buffers
+  auto write_top_k = [&](int64_t selection, vector<pair<T, int64_t>>& top_k) {
+    if (sorted) {  // The optimizer will clean-up the redundant condition based on the template parameter 'sorted'
+      // sort the top k elements - O (k log k)
+      std::sort(top_k.begin(), top_k.end(), Comparator());
+    }
+
+    const int64_t i = selection / block_slice;
+    const int64_t j = selection % block_slice;
+    for (int64_t l = 0; l < k; ++l) {
+      const auto& elem = top_k[l];
+      auto col_index = i * reduced_cols + l * block_slice + j;
+      values_data[col_index] = elem.first;
+      indices_data[col_index] = elem.second;
+    }
+  };
+
+  const int64_t num_threads = tp != nullptr ? tp->NumThreads() + 1 : 1;
+  const int64_t num_chunks = std::min(num_threads, num_blocks / kMinValuesPerChunk);
+
+  if (num_selections >= num_threads || num_chunks < 2) {
+    // the cost of a selection is dominated by the comparison of each of its values with the current k-th element
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(num_selections), static_cast<double>(num_blocks) * 2,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          vector<pair<T, int64_t>> top_k;
+          for (std::ptrdiff_t selection = first; selection < last; ++selection) {
+            const int64_t i = selection / block_slice;
+            const int64_t j = selection % block_slice;
+            select_top_k<largest, T, Comparator>(input_data + i * cols + j, num_blocks, block_slice, 0, k, top_k);
+            write_top_k(selection, top_k);
           }
-        }
-      } else {  // sorted == false
-        // The optimizer will clean-up the redundant condition based on the template parameter 'sorted'
-
-        // If the top K values are not required to be sorted, we use a more optimal selection algorithm
-        // Average - O(n). Worst - O(n * ln(n)) or O(n^2) depending on the implementation, where 'n' is the number of input
-
-        const auto& data_holder = select_top_k<Comparator>(input_map, i, num_blocks, block_slice, j, k, false);
-
-        // Insert the top 'k' (largest or smallest) elements into the final output buffers
-        for (int64_t l = 0; l < k; ++l) {
-          const auto& elem = data_holder[l];
-          auto col_index = l * block_slice + j;
-          values_map(i, col_index) = elem.first;
-          indices_map(i, col_index) = elem.second;
-        }
-      }
+        });
+    return;
+  }
+
+  // Too few selections of too many values to keep the threads busy, so each of them is split into chunks that
+  // are selected in parallel. The top k of the selection are among the top k of the chunks, so the candidates of
+  // the chunks are merged with a final selection.
+  vector<vector<pair<T, int64_t>>> chunk_top_k(static_cast<size_t>(num_chunks));
+  vector<pair<T, int64_t>> candidates;
+  for (int64_t selection = 0; selection < num_selections; ++selection) {
+    const int64_t i = selection / block_slice;
+    const int64_t j = selection % block_slice;
+    const T* data = input_data + i * cols + j;
+
+    concurrency::ThreadPool::TryBatchParallelFor(
+        tp, static_cast<int32_t>(num_chunks),
+        [&](int32_t chunk) {
+          const int64_t first = num_blocks * chunk / num_chunks;
+          const int64_t last = num_blocks * (chunk + 1) / num_chunks;
+          select_top_k<largest, T, Comparator>(data + first * block_slice, last - first, block_slice, first, k,
+                                               chunk_top_k[chunk]);
+        },
+        static_cast<int32_t>(num_chunks));
+
+    candidates.clear();
+    for (const auto& chunk : chunk_top_k) {
+      candidates.insert(candidates.end(), chunk.begin(), chunk.end());
     }
+    nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), Comparator());
+    candidates.resize(k);
+    write_top_k(selection, candidates);
   }
 }
 
 // Wrapper over core TopK implementation
+template <typename T>
 static Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* input, const int axis, const unsigned k,
                        bool largest = true, bool sorted = true) {
   const TensorShape& input_shape = input->Shape();
@@ -194,26 +223,28 @@ static Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* input
   }
 
   // no-op - no output buffers to fill - return silently
-  if (k == 0) {
+  if (k == 0 || output_shape.Size() == 0) {
     return Status::OK();
   }
 
+  concurrency::ThreadPool* tp = p_op_kernel_context->GetOperatorThreadPool();
+  const auto axis_unsigned = gsl::narrow_cast<unsigned>(axis_parsed);
   if (sorted && largest) {
     // extract sorted largest TopK elements
-    extract_top_k_elements<true, true, GreaterValueCmp<float>>(input, input_shape, values, indices, output_shape, k,
-                                                               gsl::narrow_cast<unsigned>(axis_parsed));
+    extract_top_k_elements<true, true, T, GreaterValueCmp<T>>(input, input_shape, values, indices, output_shape, k,
+                                                              axis_unsigned, tp);
   } else if (sorted && !largest) {
     // extract sorted smallest TopK elements
-    extract_top_k_elements<false, true, LesserValueCmp<float>>(input, input_shape, values, indices, output_shape, k,
-                                                               gsl::narrow_cast<unsigned>(axis_parsed));
+    extract_top_k_elements<false, true, T, LesserValueCmp<T>>(input, input_shape, values, indices, output_shape, k,
+                                                              axis_unsigned, tp);
   } else if (largest) {
     // extract unsorted (order undefined) largest TopK elements
-    extract_top_k_elements<true, false, GreaterValueCmp<float>>(input, input_shape, values, indices, output_shape, k,
-                                                                gsl::narrow_cast<unsigned>(axis_parsed));
+    extract_top_k_elements<true, false, T, GreaterValueCmp<T>>(input, input_shape, values, indices, output_shape, k,
+                                                               axis_unsigned, tp);
   } else {
     // extract unsorted (order undefined) smallest TopK elements
-    extract_top_k_elements<false, false, LesserValueCmp<float>>(input, input_shape, values, indices, output_shape, k,
-                                                                gsl::narrow_cast<unsigned>(axis_parsed));
+    extract_top_k_elements<false, false, T, LesserValueCmp<T>>(input, input_shape, values, indices, output_shape, k,
+                                                               axis_unsigned, tp);
   }
 
   return Status::OK();
@@ -240,7 +271,7 @@ Status TopK<9, float>::Compute(OpKernelContext* p_op_kernel_context) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "input count mismatch, expected 1 input - the tensor to be processed");
   }
 
-  return TopKImpl(p_op_kernel_context, X, axis_, k_);
+  return TopKImpl<float>(p_op_kernel_context, X, axis_, k_);
 }
 
 // Opset ver - 10
@@ -262,7 +293,7 @@ Status TopK<10, float>::Compute(OpKernelContext* p_op_kernel_context) const {
                            "the tensor to be processed and a tensor containing k value");
   }
 
-  const vector<int64_t>& y_shape = Y->Shape().GetDims();
+  const auto& y_shape = Y->Shape().GetDims();
   if (y_shape.size() != 1 || y_shape[0] != 1) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k tensor should be a 1D tensor of size 1");
   }
@@ -272,7 +303,7 @@ Status TopK<10, float>::Compute(OpKernelContext* p_op_kernel_context) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "value of k must not be negative");
   }
 
-  return TopKImpl(p_op_kernel_context, X, axis_, gsl::narrow_cast<unsigned>(parsed_input_k));
+  return TopKImpl<float>(p_op_kernel_context, X, axis_, gsl::narrow_cast<unsigned>(parsed_input_k));
 }
 
 // Opset ver - 11
@@ -302,6 +333,7 @@ TopK<11, int64_t>::TopK(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel
   TopkOpset11ConstructorCommon(op_kernel_info, axis_, largest_, sorted_);
 }
 
+template <typename T>
 static Status ComputeImplOpset11(OpKernelContext* p_op_kernel_context, int axis, bool is_largest, bool is_sorted) {
   const auto* X = p_op_kernel_context->Input<Tensor>(0);
   const auto* Y = p_op_kernel_context->Input<Tensor>(1);
@@ -311,7 +343,7 @@ static Status ComputeImplOpset11(OpKernelContext* p_op_kernel_context, int axis,
                            "the tensor to be processed and a tensor containing k value");
   }
 
-  const vector<int64_t>& y_shape = Y->Shape().GetDims();
+  const auto& y_shape = Y->Shape().GetDims();
   if (y_shape.size() != 1 || y_shape[0] != 1) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k tensor should be a 1D tensor of size 1");
   }
@@ -321,18 +353,19 @@ static Status ComputeImplOpset11(OpKernelContext* p_op_kernel_context, int axis,
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "value of k must not be negative");
   }
 
-  return TopKImpl(p_op_kernel_context, X, axis, gsl::narrow_cast<unsigned>(parsed_input_k), is_largest, is_sorted);
+  return TopKImpl<T>(p_op_kernel_context, X, axis, gsl::narrow_cast<unsigned>(parsed_input_k), is_largest,
+                     is_sorted);
 }
 
 // Opset ver - 11
 template <>
 Status TopK<11, float>::Compute(OpKernelContext* p_op_kernel_context) const {
-  return ComputeImplOpset11(p_op_kernel_context, axis_, largest_, sorted_);
+  return ComputeImplOpset11<float>(p_op_kernel_context, axis_, largest_, sorted_);
 }
 
 template <>
 Status TopK<11, int64_t>::Compute(OpKernelContext* p_op_kernel_context) const {
-  return ComputeImplOpset11(p_op_kernel_context, axis_, largest_, sorted_);
+  return ComputeImplOpset11<int64_t>(p_op_kernel_context, axis_, largest_, sorted_);
 }
 
 // Register necessary kernels
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
@@ -16,24 +18,28 @@ class DictVectorizerOp final : public OpKernel {
     //In some stupid models, the vocabulary could have duplicated elements.
     //We must support that, otherwise some tests will be break.
     ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary_).IsOK());
+    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
+      vocabulary_indices_.emplace(vocabulary_[i], i);
+    }
   }
   common::Status Compute(OpKernelContext* ctx) const override {
     auto map = ctx->Input<std::map<AttrType, TargetType> >(0);
     auto Y = ctx->Output(0, TensorShape({1, static_cast<int64_t>(vocabulary_.size())}));
     auto* y_data = Y->template MutableData<TargetType>();
-    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
-      auto index = map->find(vocabulary_[i]);
-      if (index != map->end()) {
-        *y_data++ = index->second;
-      } else {
-        //Any keys not present in the input dictionary, will be zero in the output array
-        *y_data++ = TargetType();
+    //Any keys not present in the input dictionary, will be zero in the output array
+    std::fill_n(y_data, vocabulary_.size(), TargetType());
+    //The input is usually much smaller than the vocabulary, so scatter it instead of searching it for every key
+    for (const auto& entry : *map) {
+      auto range = vocabulary_indices_.equal_range(entry.first);
+      for (auto it = range.first; it != range.second; ++it) {
+        y_data[it->second] = entry.second;
       }
     }
     return Status::OK();
   }
 
   std::vector<AttrType> vocabulary_;
+  std::unordered_multimap<AttrType, size_t> vocabulary_indices_;
 };
 
 }  // namespace ml
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+#include "gsl/gsl"
+
+namespace onnxruntime {
+namespace ml {
+
+// A hash map for the key/value pairs in the attributes of a kernel. It's filled when the kernel is created and only
+// read by Compute.
+// It uses open addressing with linear probing over a power of two number of slots, which are at most half full.
+// A slot holds the full hash of its key next to the index of the entry, so a lookup walks a contiguous array and
+// only compares the keys, e.g. the characters of two strings, when the hashes match.
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+class FlatHashMap {
+ public:
+  void Reserve(size_t num_entries) {
+    keys_.reserve(num_entries);
+    values_.reserve(num_entries);
+    size_t num_slots = kMinSlots;
+    while (num_slots < 2 * num_entries) {
+      num_slots *= 2;
+    }
+    if (num_slots > slots_.size()) {
+      Rehash(num_slots);
+    }
+  }
+
+  // Adds key with value, or replaces the value if key is already in the map, like std::unordered_map::operator[].
+  void InsertOrAssign(const TKey& key, const TValue& value) {
+    if (2 * (keys_.size() + 1) > slots_.size()) {
+      Rehash(slots_.empty() ? kMinSlots : 2 * slots_.size());
+    }
+
+    const size_t hash = hasher_(key);
+    Slot& slot = slots_[FindSlot(key, hash)];
+    if (slot.entry != kEmptySlot) {
+      values_[slot.entry] = value;
+      return;
+    }
+
+    slot.hash = hash;
+    slot.entry = keys_.size();
+    keys_.push_back(key);
+    values_.push_back(value);
+  }
+
+  // Adds key with value if key isn't in the map yet, like std::unordered_map::emplace. Returns the index of the entry
+  // of key, which is the number of distinct keys added before it, and whether it was added.
+  std::pair<size_t, bool> TryInsert(const TKey& key, const TValue& value) {
+    if (2 * (keys_.size() + 1) > slots_.size()) {
+      Rehash(slots_.empty() ? kMinSlots : 2 * slots_.size());
+    }
+
+    const size_t hash = hasher_(key);
+    Slot& slot = slots_[FindSlot(key, hash)];
+    if (slot.entry != kEmptySlot) {
+      return {slot.entry, false};
+    }
+
+    slot.hash = hash;
+    slot.entry = keys_.size();
+    keys_.push_back(key);
+    values_.push_back(value);
+    return {slot.entry, true};
+  }
+
+  // Returns the value of key, or nullptr if the map doesn't contain key.
+  const TValue* Find(const TKey& key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+
+    const Slot& slot = slots_[FindSlot(key, hasher_(key))];
+    return slot.entry == kEmptySlot ? nullptr : &values_[slot.entry];
+  }
+
+  size_t Size() const noexcept { return keys_.size(); }
+
+  // The keys and values of the entries, in the order they were added.
+  const std::vector<TKey>& Keys() const noexcept { return keys_; }
+  const std::vector<TValue>& Values() const noexcept { return values_; }
+
+ private:
+  struct Slot {
+    size_t hash;
+    size_t entry;
+  };
+
+  static constexpr size_t kEmptySlot = std::numeric_limits<size_t>::max();
+  static constexpr size_t kMinSlots = 8;
+
+  // std::hash of an integer is usually the integer itself, so the hash is mixed (Fibonacci hashing) and the slot
+  // is picked from the high bits of the product rather than the low bits of the hash.
+  size_t HomeSlot(size_t hash) const noexcept {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift_);
+  }
+
+  // Returns the slot holding key, or the empty slot key would be inserted in.
+  size_t FindSlot(const TKey& key, size_t hash) const {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = HomeSlot(hash);; i = (i + 1) & mask) {
+      const Slot& slot = slots_[i];
+      if (slot.entry == kEmptySlot || (slot.hash == hash && keys_[slot.entry] == key)) {
+        return i;
+      }
+    }
+  }
+
+  void Rehash(size_t num_slots) {
+    shift_ = 64;
+    for (size_t n = num_slots; n > 1; n /= 2) {
+      --shift_;
+    }
+
+    slots_.assign(num_slots, Slot{0, kEmptySlot});
+    const size_t mask = num_slots - 1;
+    for (size_t entry = 0; entry < keys_.size(); ++entry) {
+      const size_t hash = hasher_(keys_[entry]);
+      size_t i = HomeSlot(hash);
+      while (slots_[i].entry != kEmptySlot) {
+        i = (i + 1) & mask;
+      }
+      slots_[i] = Slot{hash, entry};
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<TKey> keys_;
+  std::vector<TValue> values_;
+  int shift_ = 64;
+  THash hasher_;
+};
+
+// Maps each element of input to the element of output at the same index, using default_value for the keys that
+// aren't in map. The elements are split across the threads of tp.
+template <typename TKey, typename TValue, typename THash>
+static inline void batched_lookup(const FlatHashMap<TKey, TValue, THash>& map, gsl::span<const TKey> input,
+                                  gsl::span<TValue> output, const TValue& default_value,
+                                  concurrency::ThreadPool* tp) {
+  // hashing and comparing a string, or copying one to the output, costs more than a few cycles
+  const double cost_per_element =
+      std::is_arithmetic<TKey>::value && std::is_arithmetic<TValue>::value ? 8. : 64.;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(input.size()), cost_per_element,
+      [&map, &input, &output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const TValue* value = map.Find(input[i]);
+          output[i] = value == nullptr ? default_value : *value;
+        }
+      });
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -73,30 +73,55 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
-  int64_t zindex = 0;
+  if (coefficients_.size() < static_cast<size_t>(class_count_ * stride)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", stride, " features but there are only ",
+                           coefficients_.size(), " coefficients for ", class_count_, " classes.");
+  }
+
   const auto* x_data = X->template Data<T>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  const float* x_float;
+  std::vector<float> x_buffer;
+  if (std::is_same<T, float>::value) {
+    x_float = reinterpret_cast<const float*>(x_data);
+  } else {
+    x_buffer.resize(static_cast<size_t>(N * stride));
+    std::transform(x_data, x_data + N * stride, x_buffer.begin(), [](T value) { return static_cast<float>(value); });
+    x_float = x_buffer.data();
+  }
+
+  // the scores of all the points are a single GEMM, written straight to Z unless the binary case adds a column
+  const bool scores_in_z = output_classes == class_count_;
+  std::vector<float> score_buffer;
+  float* all_scores;
+  if (scores_in_z) {
+    all_scores = Z->template MutableData<float>();
+  } else {
+    score_buffer.resize(static_cast<size_t>(N * class_count_));
+    all_scores = score_buffer.data();
+  }
+
+  if (class_count_ > 0) {
+    // start from the intercepts so the GEMM adds them as a bias
+    for (int64_t i = 0; i < N; i++) {
+      std::copy(intercepts_.begin(), intercepts_.end(), all_scores + i * class_count_);
+    }
+    MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(class_count_),
+             static_cast<size_t>(stride), 1.f, x_float, static_cast<size_t>(stride), coefficients_.data(),
+             static_cast<size_t>(stride), 1.f, all_scores, static_cast<size_t>(class_count_), tp);
+  }
 
-  auto class_count = static_cast<size_t>(class_count_);
+  int64_t zindex = 0;
   std::vector<float> scores;
-  scores.reserve(class_count);
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
+    const float* point_scores = all_scores + i * class_count_;
     int maxclass = -1;
     float maxweight = 0.f;
     for (int j = 0; j < class_count_; j++)  // for each class
     {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
+      const float weight = point_scores[j];
       if (weight > maxweight || maxclass == -1) {
         maxweight = weight;
         maxclass = j;
@@ -135,16 +160,23 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
         Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
-    } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
-    } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+    //write float values of the rows that are not transformed together below
+    if (!scores_in_z || class_count_ < 2) {
+      scores.assign(point_scores, point_scores + class_count_);
+      if (add_second_class && maxweight > 0) {
+        ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
+      } else if (add_second_class) {
+        ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
+      } else {
+        ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+      }
+      zindex += scores.size();
     }
-    zindex += scores.size();
   }  //for each point
+
+  if (scores_in_z && class_count_ >= 2) {
+    batched_post_transform(all_scores, N, class_count_, post_transform_, tp);
+  }
   return Status::OK();
 }
 
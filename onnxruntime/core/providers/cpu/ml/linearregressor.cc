@@ -31,29 +31,39 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
+  if (coefficients_.size() < static_cast<size_t>(targets_ * stride)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", stride, " features but there are only ",
+                           coefficients_.size(), " coefficients for ", targets_, " targets.");
+  }
+
   const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
+  auto* Ydata = Y->template MutableData<float>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  if (targets_ == 0) {
+    return Status::OK();
+  }
 
+  // start from the intercepts so the GEMM adds them as a bias
   bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
+  for (int64_t i = 0; i < N; i++) {
+    if (useIntercepts) {
+      std::copy(intercepts_.begin(), intercepts_.end(), Ydata + i * targets_);
+    } else {
+      std::fill_n(Ydata + i * targets_, targets_, 0.f);
+    }
+  }
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(targets_),
+           static_cast<size_t>(stride), 1.f, Xdata, static_cast<size_t>(stride), coefficients_.data(),
+           static_cast<size_t>(stride), 1.f, Ydata, static_cast<size_t>(targets_), tp);
+
+  if (targets_ >= 2) {
+    batched_post_transform(Ydata, N, targets_, post_transform_, tp);
+  } else if (post_transform_ == POST_EVAL_TRANSFORM::PROBIT) {
+    // a single score is only transformed by PROBIT, as write_scores does
+    for (int64_t i = 0; i < N; i++) {
+      Ydata[i] = ComputeProbit(Ydata[i]);
     }
-    ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
-    yindex += scores.size();
   }
   return Status::OK();
 }
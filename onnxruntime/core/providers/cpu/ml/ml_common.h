@@ -4,6 +4,8 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -349,5 +351,48 @@ void write_scores(std::vector<T>& scores, POST_EVAL_TRANSFORM post_transform, in
   memcpy(out_p, scores.data(), len);
 }
 
+// Applies post_transform in place to num_rows rows of row_size scores each, the same way write_scores does for a
+// single row of at least two scores. LOGISTIC and SOFTMAX use the vectorized MLAS routines, and the rows are split
+// across the threads of tp.
+static inline void batched_post_transform(float* scores, int64_t num_rows, int64_t row_size,
+                                          POST_EVAL_TRANSFORM post_transform, concurrency::ThreadPool* tp) {
+  ORT_ENFORCE(row_size >= 2);
+  switch (post_transform) {
+    case POST_EVAL_TRANSFORM::SOFTMAX:
+      MlasComputeSoftmax(scores, scores, static_cast<size_t>(num_rows), static_cast<size_t>(row_size), false, tp);
+      return;
+    case POST_EVAL_TRANSFORM::LOGISTIC:
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(num_rows), static_cast<double>(row_size) * 8.,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            MlasComputeLogistic(scores + first * row_size, scores + first * row_size,
+                                static_cast<size_t>((last - first) * row_size));
+          });
+      return;
+    case POST_EVAL_TRANSFORM::PROBIT:
+    case POST_EVAL_TRANSFORM::SOFTMAX_ZERO:
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(num_rows), static_cast<double>(row_size) * 16.,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            std::vector<float> row;
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              float* row_scores = scores + i * row_size;
+              if (post_transform == POST_EVAL_TRANSFORM::PROBIT) {
+                for (int64_t j = 0; j < row_size; ++j)
+                  row_scores[j] = ComputeProbit(row_scores[j]);
+              } else {
+                row.assign(row_scores, row_scores + row_size);
+                ComputeSoftmaxZero(row);
+                std::copy(row.begin(), row.end(), row_scores);
+              }
+            }
+          });
+      return;
+    default:
+    case POST_EVAL_TRANSFORM::NONE:
+      return;
+  }
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -73,6 +73,36 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       break;
     }
   }
+
+  if (mode_ == SVM_TYPE::SVM_LINEAR) {
+    ORT_ENFORCE(!rho_.empty());
+    ORT_ENFORCE(coefficients_.size() >= static_cast<size_t>(class_count_ * feature_count_));
+    return;
+  }
+
+  const int64_t num_pairs = class_count_ * (class_count_ - 1) / 2;
+  ORT_ENFORCE(vectors_per_class_.size() >= static_cast<size_t>(class_count_));
+  ORT_ENFORCE(rho_.size() >= static_cast<size_t>(num_pairs));
+  ORT_ENFORCE(coefficients_.size() >= static_cast<size_t>((class_count_ - 1) * vector_count_));
+
+  if (get_kernel_type() == KERNEL::RBF) {
+    support_vector_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
+
+  // the decision for the pair of classes (i, j) uses the coefficients in row j - 1 for the support vectors of class i
+  // and the coefficients in row i for the support vectors of class j
+  pair_coefficients_.resize(static_cast<size_t>(vector_count_ * num_pairs), 0.f);
+  int64_t pair = 0;
+  for (int64_t i = 0; i < class_count_; i++) {
+    for (int64_t j = i + 1; j < class_count_; j++, pair++) {
+      for (int64_t m = starting_vector_[i], end = m + vectors_per_class_[i]; m < end; ++m) {
+        pair_coefficients_[m * num_pairs + pair] = coefficients_[(j - 1) * vector_count_ + m];
+      }
+      for (int64_t m = starting_vector_[j], end = m + vectors_per_class_[j]; m < end; ++m) {
+        pair_coefficients_[m * num_pairs + pair] = coefficients_[i * vector_count_ + m];
+      }
+    }
+  }
 }
 
 template <typename LabelType>
@@ -121,123 +151,133 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", stride, " features but the model expects ",
+                           feature_count_, ".");
+  }
+
   const T* x_data = X->template Data<T>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
   int64_t zindex = 0;
 
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
-
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
+  const int64_t num_pairs = class_count_ * (class_count_ - 1) / 2;
+  const int64_t num_kernels = mode_ == SVM_TYPE::SVM_LINEAR ? class_count_ : vector_count_;
+
+  // the rows are processed in blocks that bound the size of the kernel values
+  constexpr int64_t kMaxBlockValues = 1 << 20;
+  const int64_t block_rows = std::max<int64_t>(1, kMaxBlockValues / std::max<int64_t>({1, num_kernels, num_pairs}));
+
+  std::vector<float> x_buffer;
+  std::vector<float> kernels;
+  std::vector<float> decisions;
+  std::vector<float> scores;
+  std::vector<int64_t> votes;
+
+  for (int64_t first_row = 0; first_row < N; first_row += block_rows) {
+    const int64_t M = std::min(block_rows, N - first_row);
+    int64_t lda;
+    const float* a = rows_as_float(x_data, stride, first_row, M, feature_count_, x_buffer, lda);
+
+    kernels.resize(static_cast<size_t>(M * num_kernels));
+    if (mode_ == SVM_TYPE::SVM_LINEAR) {
+      batched_kernel_dot(a, lda, coefficients_.data(), nullptr, M, class_count_, feature_count_, KERNEL::LINEAR,
+                         kernels.data(), tp);
     } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
-      int evals = 0;
-
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      votes.resize(class_count_, 0);
-      for (int64_t i = 0; i < class_count_; i++) {        // for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
-          double sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[evals];
-          scores.push_back((float)sum);
-          ++(votes[sum > 0 ? i : j]);
-          ++evals;  //index into rho
-        }
+      batched_kernel_dot(a, lda, support_vectors_.data(), support_vector_norms_.data(), M, vector_count_,
+                         feature_count_, get_kernel_type(), kernels.data(), tp);
+      decisions.resize(static_cast<size_t>(M * num_pairs));
+      if (num_pairs > 0) {
+        MlasGemm(CblasNoTrans, CblasNoTrans, static_cast<size_t>(M), static_cast<size_t>(num_pairs),
+                 static_cast<size_t>(vector_count_), 1.f, kernels.data(), static_cast<size_t>(vector_count_),
+                 pair_coefficients_.data(), static_cast<size_t>(num_pairs), 0.f, decisions.data(),
+                 static_cast<size_t>(num_pairs), tp);
       }
     }
 
-    if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
-      //compute probabilities from the scores
-      int64_t num = class_count_ * class_count_;
-      std::vector<float> probsp2(num, 0.f);
-      std::vector<float> estimates(class_count_, 0.f);
-      int64_t index = 0;
-      for (int64_t i = 0; i < class_count_; ++i) {
-        int64_t p1 = i * class_count_ + i + 1;
-        int64_t p2 = (i + 1) * class_count_ + i;
-        for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
-          float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
-          float val2 = std::max(val1, 1.0e-7f);
-          val2 = std::min(val2, 1 - 1.0e-7f);
-          probsp2[p1] = val2;
-          probsp2[p2] = 1 - val2;
-          ++p1;
-          p2 += class_count_;
+    for (int64_t n = first_row; n < first_row + M; n++)  //for each example
+    {
+      const int64_t row = n - first_row;
+      int64_t maxclass = -1;
+      scores.clear();
+      votes.clear();
+
+      if (mode_ == SVM_TYPE::SVM_LINEAR) {
+        for (int64_t j = 0; j < class_count_; j++) {  //for each class
+          scores.push_back(kernels[row * class_count_ + j] + rho_[0]);
+        }
+      } else {
+        votes.resize(class_count_, 0);
+        const float* row_decisions = decisions.data() + row * num_pairs;
+        int evals = 0;
+        for (int64_t i = 0; i < class_count_; i++) {        // for each class
+          for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
+            float sum = row_decisions[evals] + rho_[evals];
+            scores.push_back(sum);
+            ++(votes[sum > 0 ? i : j]);
+            ++evals;  //index into rho
+          }
         }
       }
-      multiclass_probability(class_count_, probsp2, estimates);
-      // copy probabilities back into scores
-      scores.resize(estimates.size());
-      std::copy(estimates.begin(), estimates.end(), scores.begin());
-    }
 
-    float max_weight = 0;
-    if (votes.size() > 0) {
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
-    } else {
-      auto it_max_weight = std::max_element(scores.begin(), scores.end());
-      maxclass = std::distance(scores.begin(), it_max_weight);
-      max_weight = *it_max_weight;
-    }
+      if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
+        //compute probabilities from the scores
+        int64_t num = class_count_ * class_count_;
+        std::vector<float> probsp2(num, 0.f);
+        std::vector<float> estimates(class_count_, 0.f);
+        int64_t index = 0;
+        for (int64_t i = 0; i < class_count_; ++i) {
+          int64_t p1 = i * class_count_ + i + 1;
+          int64_t p2 = (i + 1) * class_count_ + i;
+          for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
+            float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
+            float val2 = std::max(val1, 1.0e-7f);
+            val2 = std::min(val2, 1 - 1.0e-7f);
+            probsp2[p1] = val2;
+            probsp2[p2] = 1 - val2;
+            ++p1;
+            p2 += class_count_;
+          }
+        }
+        multiclass_probability(class_count_, probsp2, estimates);
+        // copy probabilities back into scores
+        scores.resize(estimates.size());
+        std::copy(estimates.begin(), estimates.end(), scores.begin());
+      }
 
-    // write top class
-    // onnx specs expects one column per class.
-    int write_additional_scores = -1;
-    if (rho_.size() == 1) {
-      if (using_strings_) {
-        write_additional_scores = _set_score_svm<std::string>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_strings_, "1", "0");
+      float max_weight = 0;
+      if (votes.size() > 0) {
+        auto it_maxvotes = std::max_element(votes.begin(), votes.end());
+        maxclass = std::distance(votes.begin(), it_maxvotes);
       } else {
-        write_additional_scores = _set_score_svm<int64_t>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_ints_, 1, 0);
+        auto it_max_weight = std::max_element(scores.begin(), scores.end());
+        maxclass = std::distance(scores.begin(), it_max_weight);
+        max_weight = *it_max_weight;
       }
-    } else {  //multiclass
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+
+      // write top class
+      // onnx specs expects one column per class.
+      int write_additional_scores = -1;
+      if (rho_.size() == 1) {
+        if (using_strings_) {
+          write_additional_scores = _set_score_svm<std::string>(
+              Y, max_weight, maxclass, n, post_transform_, proba_,
+              weights_are_all_positive_, classlabels_strings_, "1", "0");
+        } else {
+          write_additional_scores = _set_score_svm<int64_t>(
+              Y, max_weight, maxclass, n, post_transform_, proba_,
+              weights_are_all_positive_, classlabels_ints_, 1, 0);
+        }
+      } else {  //multiclass
+        if (using_strings_) {
+          Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
+        } else {
+          Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+        }
       }
-    }
 
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
+      write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
+      zindex += scores.size();
+    }
   }
 
   return Status::OK();
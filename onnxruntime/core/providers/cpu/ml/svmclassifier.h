@@ -3,8 +3,13 @@
 
 #pragma once
 
+#include <numeric>
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,31 +34,73 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
-    if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
-    } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
-      }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+  // Returns the squared norm of each of the count vectors of length len, which the RBF kernel uses.
+  static std::vector<float> squared_norms(const std::vector<float>& vectors, int64_t count, int64_t len) {
+    std::vector<float> norms(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; ++i) {
+      const float* v = vectors.data() + i * len;
+      norms[i] = std::inner_product(v, v + len, v, 0.f);
+    }
+    return norms;
+  }
+
+  // Returns the M rows of x that start at first_row as floats, with their stride in lda.
+  // The rows are converted into buffer if T is not float.
+  static const float* rows_as_float(const T* x, int64_t stride, int64_t first_row, int64_t M, int64_t len,
+                                    std::vector<float>& buffer, int64_t& lda) {
+    if (std::is_same<T, float>::value) {
+      lda = stride;
+      return reinterpret_cast<const float*>(x + first_row * stride);
+    }
+    buffer.resize(static_cast<size_t>(M * len));
+    for (int64_t i = 0; i < M; ++i) {
+      const T* row = x + (first_row + i) * stride;
+      std::transform(row, row + len, buffer.data() + i * len, [](T value) { return static_cast<float>(value); });
+    }
+    lda = len;
+    return buffer.data();
+  }
+
+  // Computes the kernel of each of the M rows of A with each of the N rows of B into the M x N matrix out.
+  // The dot products are computed by one GEMM and the kernel function is then applied to each row of the
+  // result with the vectorized MLAS routines. b_norms are the squared norms of the rows of B, which only the RBF
+  // kernel needs: it expands |a - b|^2 as |a|^2 + |b|^2 - 2 a.b so that it is a GEMM as well.
+  void batched_kernel_dot(const float* A, int64_t lda, const float* B, const float* b_norms,
+                          int64_t M, int64_t N, int64_t K, KERNEL k, float* out,
+                          concurrency::ThreadPool* tp) const {
+    const float alpha = k == KERNEL::RBF ? -2.f : 1.f;
+    MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             alpha, A, static_cast<size_t>(lda), B, static_cast<size_t>(K), 0.f, out, static_cast<size_t>(N), tp);
+
+    if (k == KERNEL::LINEAR) {
+      return;
     }
-    return (float)sum;
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(M), static_cast<double>(N) * 16.,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row < last; ++row) {
+            float* o = out + row * N;
+            if (k == KERNEL::RBF) {
+              const float* a = A + row * lda;
+              const float a_norm = std::inner_product(a, a + K, a, 0.f);
+              // rounding can make the distance of nearly equal vectors slightly negative
+              for (int64_t j = 0; j < N; ++j) {
+                o[j] = -gamma_ * std::max(0.f, o[j] + a_norm + b_norms[j]);
+              }
+              MlasComputeExp(o, o, static_cast<size_t>(N));
+            } else {
+              for (int64_t j = 0; j < N; ++j) {
+                o[j] = gamma_ * o[j] + coef0_;
+              }
+              if (k == KERNEL::POLY) {
+                MlasComputePow(o, degree_, o, static_cast<size_t>(N));
+              } else {
+                MlasComputeTanh(o, o, static_cast<size_t>(N));
+              }
+            }
+          }
+        });
   }
 
  private:
@@ -65,7 +112,9 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::squared_norms;
+  using SVMCommon<T>::rows_as_float;
+  using SVMCommon<T>::batched_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -86,6 +135,10 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  std::vector<float> support_vector_norms_;
+  // vector_count_ x (class_count_ * (class_count_ - 1) / 2) matrix with the coefficients each kernel value has in
+  // the decision function of each pair of classes, so the decisions are a GEMM of the kernel values
+  std::vector<float> pair_coefficients_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -34,6 +34,12 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  ORT_ENFORCE(!rho_.empty());
+  ORT_ENFORCE(mode_ == SVM_TYPE::SVM_LINEAR || coefficients_.size() >= static_cast<size_t>(vector_count_));
+
+  if (mode_ == SVM_TYPE::SVM_SVC && get_kernel_type() == KERNEL::RBF) {
+    support_vector_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
 }
 
 template <typename T>
@@ -44,31 +50,49 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", stride, " features but the model expects ",
+                           feature_count_, ".");
+  }
+
   const auto* x_data = X->template Data<T>();
+  auto* y_data = Y->template MutableData<float>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // the rows are processed in blocks that bound the size of the kernel values
+  constexpr int64_t kMaxBlockValues = 1 << 20;
+  const int64_t block_rows = mode_ == SVM_TYPE::SVM_SVC
+                                 ? std::max<int64_t>(1, kMaxBlockValues / std::max<int64_t>(1, vector_count_))
+                                 : N;
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
+  std::vector<float> x_buffer;
+  std::vector<float> kernels;
+
+  for (int64_t first_row = 0; first_row < N; first_row += block_rows) {
+    const int64_t M = std::min(block_rows, N - first_row);
+    int64_t lda;
+    const float* a = rows_as_float(x_data, stride, first_row, M, feature_count_, x_buffer, lda);
+    float* sums = y_data + first_row;
 
-    float sum = 0.f;
     if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
+      kernels.resize(static_cast<size_t>(M * vector_count_));
+      batched_kernel_dot(a, lda, support_vectors_.data(), support_vector_norms_.data(), M, vector_count_,
+                         feature_count_, get_kernel_type(), kernels.data(), tp);
+      MlasGemm(CblasNoTrans, CblasNoTrans, static_cast<size_t>(M), 1, static_cast<size_t>(vector_count_), 1.f,
+               kernels.data(), static_cast<size_t>(vector_count_), coefficients_.data(), 1, 0.f, sums, 1, tp);
     } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
+      batched_kernel_dot(a, lda, coefficients_.data(), nullptr, M, 1, feature_count_, get_kernel_type(), sums, tp);
     }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
+
+    for (int64_t n = 0; n < M; n++) {
+      float sum = sums[n] + rho_[0];
+      if (one_class_ && sum > 0) {
+        sums[n] = 1.f;
+      } else if (one_class_) {
+        sums[n] = -1.f;
+      } else {
+        sums[n] = sum;
+      }
     }
   }
 
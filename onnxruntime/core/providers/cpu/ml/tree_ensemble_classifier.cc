@@ -158,6 +158,7 @@ TreeEnsembleClassifier<T>::TreeEnsembleClassifier(const OpKernelInfo& info)
   ORT_ENFORCE(!nodes_treeids_.empty());
   ORT_ENFORCE(class_nodeids_.size() == class_ids_.size());
   ORT_ENFORCE(class_nodeids_.size() == class_weights_.size());
+  ORT_ENFORCE(class_nodeids_.size() == class_treeids_.size());
   ORT_ENFORCE(nodes_nodeids_.size() == nodes_featureids_.size());
   ORT_ENFORCE(nodes_nodeids_.size() == nodes_modes_names_.size());
   ORT_ENFORCE(nodes_nodeids_.size() == nodes_values_.size());
@@ -202,6 +203,8 @@ void TreeEnsembleClassifier<T>::Initialize() {
   for (int64_t i = 0, size_class_nodeids = static_cast<int64_t>(class_nodeids_.size());
        i < size_class_nodeids;
        ++i) {
+    ORT_ENFORCE(class_treeids_[i] >= 0 && class_treeids_[i] < static_cast<int64_t>(tree_offsets.size()),
+                "Invalid tree id ", class_treeids_[i], " for class weight ", i, ".");
     int64_t offset = tree_offsets[class_treeids_[i]];
     class_nodeids_[i] = class_nodeids_[i] - offset;
     if (class_weights_[i] < 0) {
@@ -226,22 +229,6 @@ void TreeEnsembleClassifier<T>::Initialize() {
 
     return std::get<1>(t1) < std::get<1>(t2);
   });
-  // make an index so we can find the leafnode data quickly when evaluating
-  int64_t field0 = -1;
-  int64_t field1 = -1;
-  for (size_t i = 0, end = leafnodedata_.size(); i < end; ++i) {
-    int64_t id0 = std::get<0>(leafnodedata_[i]);
-    int64_t id1 = std::get<1>(leafnodedata_[i]);
-    if (id0 != field0 || id1 != field1) {
-      int64_t id = id0 * kOffset_ + id1;
-      auto position = static_cast<int64_t>(i);
-      auto p3 = std::make_pair(id, position);
-      leafdata_map_.insert(p3);
-      field0 = id;
-      field1 = position;
-    }
-  }
-
   // treenode ids, some are roots_, and roots_ have no parents
   std::unordered_map<int64_t, int64_t> parents;  // holds count of all who point to you
   std::unordered_map<int64_t, int64_t> indices;
@@ -267,7 +254,7 @@ void TreeEnsembleClassifier<T>::Initialize() {
     // they must be in the same tree
     int64_t id = nodes_treeids_[i] * kOffset_ + nodes_truenodeids_[i];
     it = parents.find(id);
-    ORT_ENFORCE(it != parents.end());
+    ORT_ENFORCE(it != parents.end(), "Invalid child node id for tree node ", i, ".");
     it->second++;
   }
   // all false nodes arent roots_
@@ -276,7 +263,7 @@ void TreeEnsembleClassifier<T>::Initialize() {
     // they must be in the same tree
     int64_t id = nodes_treeids_[i] * kOffset_ + nodes_falsenodeids_[i];
     it = parents.find(id);
-    ORT_ENFORCE(it != parents.end());
+    ORT_ENFORCE(it != parents.end(), "Invalid child node id for tree node ", i, ".");
     it->second++;
   }
   // find all the nodes that dont have other nodes pointing at them
@@ -287,11 +274,24 @@ void TreeEnsembleClassifier<T>::Initialize() {
       roots_.push_back(it->second);
     }
   }
+  // a tree whose root is also a child has no root, and a node no other node points at is a second root
+  ORT_ENFORCE(roots_.size() == tree_offsets.size(), "Found ", roots_.size(), " root nodes for ", tree_offsets.size(),
+              " trees, each tree must have a single root.");
   class_count_ = !classlabels_strings_.empty() ? classlabels_strings_.size() : classlabels_int64s_.size();
   using_strings_ = !classlabels_strings_.empty();
   ORT_ENFORCE(base_values_.empty() ||
               base_values_.size() == static_cast<size_t>(class_count_) ||
               base_values_.size() == weights_classes_.size());
+
+  // the scores are indexed by class id, which also covers the base values
+  int64_t num_scores = std::max(class_count_, static_cast<int64_t>(base_values_.size()));
+  if (!weights_classes_.empty()) {
+    ORT_ENFORCE(*weights_classes_.begin() >= 0, "Invalid class id ", *weights_classes_.begin(), ".");
+    num_scores = std::max(num_scores, *weights_classes_.rbegin() + 1);
+  }
+  layout_.Initialize(nodes_treeids_, nodes_nodeids_, nodes_featureids_, nodes_values_, nodes_modes_,
+                     nodes_truenodeids_, nodes_falsenodeids_, missing_tracks_true_, roots_, leafnodedata_,
+                     num_scores, kMaxTreeDepth_);
 }
 
 template <typename T>
@@ -308,24 +308,30 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   Tensor* Y = context->Output(0, TensorShape({N}));
   auto* Z = context->Output(1, TensorShape({N, class_count_}));
 
-  int64_t zindex = 0;
+  if (stride <= layout_.MaxFeatureId()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", stride,
+                           " features but the trees use feature ", layout_.MaxFeatureId(), ".");
+  }
+
   const T* x_data = X.template Data<T>();
+  const int64_t num_scores = layout_.NumScores();
+  std::vector<TreeEnsembleScore> tree_scores(static_cast<size_t>(N * num_scores));
+  layout_.ComputeScores(x_data, N, stride, tree_scores.data(), context->GetOperatorThreadPool());
 
-  // for each class
+  int64_t zindex = 0;
   std::vector<float> scores;
   scores.reserve(class_count_);
+  // the classes with a base value or a leaf weight for the current row, ordered by class id
+  std::map<int64_t, float> classes;
   for (int64_t i = 0; i < N; ++i) {
     scores.clear();
-    int64_t current_weight_0 = i * stride;
-    std::map<int64_t, float> classes;
-    // fill in base values, this might be empty but that is ok
-    for (int64_t k = 0, end = static_cast<int64_t>(base_values_.size()); k < end; ++k) {
-      auto p1 = std::make_pair<int64_t&, const float&>(k, base_values_[k]);
-      classes.insert(p1);
-    }
-    // walk each tree from its root
-    for (size_t j = 0, end = roots_.size(); j < end; ++j) {
-      ORT_RETURN_IF_ERROR(ProcessTreeNode(classes, roots_[j], x_data, current_weight_0));
+    classes.clear();
+    const TreeEnsembleScore* row_scores = tree_scores.data() + i * num_scores;
+    for (int64_t k = 0; k < num_scores; ++k) {
+      const bool has_base_value = k < static_cast<int64_t>(base_values_.size());
+      if (has_base_value || row_scores[k].has_score) {
+        classes[k] = (has_base_value ? base_values_[k] : 0.f) + row_scores[k].sum;
+      }
     }
     float maxweight = 0.f;
     int64_t maxclass = -1;
@@ -431,84 +437,5 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   return Status::OK();
 }
 
-template <typename T>
-common::Status TreeEnsembleClassifier<T>::ProcessTreeNode(std::map<int64_t, float>& classes,
-                                                          int64_t treeindex,
-                                                          const T* x_data,
-                                                          int64_t feature_base) const {
-  // walk down tree to the leaf
-  auto mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-  int64_t loopcount = 0;
-  int64_t root = treeindex;
-  while (mode != NODE_MODE::LEAF) {
-    T val = x_data[feature_base + nodes_featureids_[treeindex]];
-    bool tracktrue = true;
-    if (missing_tracks_true_.size() != nodes_truenodeids_.size()) {
-      tracktrue = false;
-    } else {
-      tracktrue = missing_tracks_true_[treeindex] && std::isnan(static_cast<float>(val));
-    }
-    float threshold = nodes_values_[treeindex];
-    switch (mode) {
-      case NODE_MODE::BRANCH_LEQ:
-        treeindex = val <= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_LT:
-        treeindex = val < threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GTE:
-        treeindex = val >= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GT:
-        treeindex = val > threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_EQ:
-        treeindex = val == threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_NEQ:
-        treeindex = val != threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      default: {
-        std::ostringstream err_msg;
-        err_msg << "Invalid mode of value: " << static_cast<std::underlying_type<NODE_MODE>::type>(mode);
-        return Status(ONNXRUNTIME, INVALID_ARGUMENT, err_msg.str());
-      }
-    }
-    ORT_ENFORCE(treeindex >= 0);
-    treeindex = treeindex + root;
-    mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-    loopcount++;
-    if (loopcount > kMaxTreeDepth_) break;
-  }
-  // should be at leaf
-  int64_t id = nodes_treeids_[treeindex] * kOffset_ + nodes_nodeids_[treeindex];
-  auto it_lp = leafdata_map_.find(id);
-  if (it_lp == leafdata_map_.end()) {  // if not found, simply return
-    return Status::OK();
-  }
-  int64_t index = it_lp->second;
-  int64_t treeid = std::get<0>(leafnodedata_[index]);
-  int64_t nodeid = std::get<1>(leafnodedata_[index]);
-  while (treeid == nodes_treeids_[treeindex] && nodeid == nodes_nodeids_[treeindex]) {
-    int64_t classid = std::get<2>(leafnodedata_[index]);
-    float weight = std::get<3>(leafnodedata_[index]);
-    std::map<int64_t, float>::iterator it_classes;
-    it_classes = classes.find(classid);
-    if (it_classes != classes.end()) {
-      it_classes->second += weight;
-    } else {
-      auto p1 = std::make_pair(classid, weight);
-      classes.insert(p1);
-    }
-    ++index;
-    // some tree node will be last
-    if (index >= static_cast<int64_t>(leafnodedata_.size())) {
-      break;
-    }
-    treeid = std::get<0>(leafnodedata_[index]);
-    nodeid = std::get<1>(leafnodedata_[index]);
-  }
-  return Status::OK();
-}
 }  // namespace ml
 }  // namespace onnxruntime
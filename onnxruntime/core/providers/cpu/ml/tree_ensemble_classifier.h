@@ -5,6 +5,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "ml_common.h"
+#include "tree_ensemble_layout.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -16,10 +17,6 @@ class TreeEnsembleClassifier final : public OpKernel {
 
  private:
   void Initialize();
-  common::Status ProcessTreeNode(std::map<int64_t, float>& classes,
-                                 int64_t treeindex,
-                                 const T* x_data,
-                                 int64_t feature_base) const;
 
   std::vector<int64_t> nodes_treeids_;
   std::vector<int64_t> nodes_nodeids_;
@@ -45,12 +42,12 @@ class TreeEnsembleClassifier final : public OpKernel {
   bool using_strings_;
 
   std::vector<std::tuple<int64_t, int64_t, int64_t, float>> leafnodedata_;
-  std::unordered_map<int64_t, int64_t> leafdata_map_;
   std::vector<int64_t> roots_;
   const int64_t kOffset_ = 4000000000L;
   const int64_t kMaxTreeDepth_ = 1000;
   POST_EVAL_TRANSFORM post_transform_;
   bool weights_are_all_positive_;
+  TreeEnsembleLayout layout_;
 };
 }  // namespace ml
 }  // namespace onnxruntime
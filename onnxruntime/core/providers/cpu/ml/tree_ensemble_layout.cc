@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_layout.h"
+
+#include <limits>
+#include <unordered_map>
+
+namespace onnxruntime {
+namespace ml {
+
+void TreeEnsembleLayout::Initialize(const std::vector<int64_t>& nodes_treeids,
+                                    const std::vector<int64_t>& nodes_nodeids,
+                                    const std::vector<int64_t>& nodes_featureids,
+                                    const std::vector<float>& nodes_values,
+                                    const std::vector<NODE_MODE>& nodes_modes,
+                                    const std::vector<int64_t>& nodes_truenodeids,
+                                    const std::vector<int64_t>& nodes_falsenodeids,
+                                    const std::vector<int64_t>& missing_tracks_true,
+                                    const std::vector<int64_t>& roots,
+                                    const std::vector<std::tuple<int64_t, int64_t, int64_t, float>>& leaf_data,
+                                    int64_t num_scores,
+                                    int64_t max_tree_depth) {
+  const int64_t kOffset = 4000000000L;
+  const auto num_nodes = static_cast<int64_t>(nodes_nodeids.size());
+  ORT_ENFORCE(leaf_data.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+              "Too many leaf weights in the tree ensemble.");
+
+  num_scores_ = num_scores;
+  has_missing_tracks_ = missing_tracks_true.size() == nodes_nodeids.size();
+
+  // the weights of each leaf are consecutive in leaf_data, so a leaf only records their range
+  std::unordered_map<int64_t, std::pair<int32_t, int32_t>> leaf_ranges;
+  leaf_weights_.reserve(leaf_data.size());
+  for (const auto& data : leaf_data) {
+    const int64_t score_index = std::get<2>(data);
+    ORT_ENFORCE(score_index >= 0 && score_index < num_scores_,
+                "Leaf weight is for class or target ", score_index, " but there are ", num_scores_, ".");
+    const auto position = static_cast<int32_t>(leaf_weights_.size());
+    auto& range = leaf_ranges.emplace(std::get<0>(data) * kOffset + std::get<1>(data),
+                                      std::make_pair(position, position))
+                      .first->second;
+    range.second = position + 1;
+    leaf_weights_.push_back({static_cast<int32_t>(score_index), std::get<3>(data)});
+  }
+
+  struct PendingNode {
+    int64_t index;
+    int64_t root;
+    int64_t depth;
+    int64_t parent;  // the node whose false child this is, or -1 for a true child or a root
+  };
+  std::vector<PendingNode> pending;
+
+  bool found_mode = false;
+  NODE_MODE uniform_mode = NODE_MODE::LEAF;
+  int64_t num_leaves = 0;
+  int64_t total_leaf_depth = 0;
+  // each node is laid out once, a child id that leads back to a node would otherwise be expanded until
+  // max_tree_depth, doubling the layout at each level
+  std::vector<bool> visited(static_cast<size_t>(num_nodes), false);
+
+  roots_.reserve(roots.size());
+  for (int64_t root : roots) {
+    ORT_ENFORCE(root >= 0 && root < num_nodes);
+    roots_.push_back(static_cast<int32_t>(nodes_.size()));
+
+    // depth first, with the true child pushed last so it is laid out right after its parent
+    pending.push_back({root, root, 0, -1});
+    while (!pending.empty()) {
+      const PendingNode current = pending.back();
+      pending.pop_back();
+
+      const auto node_index = static_cast<int32_t>(nodes_.size());
+      ORT_ENFORCE(nodes_.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+                  "Tree ensemble has too many nodes.");
+      if (current.parent >= 0) {
+        nodes_[current.parent].false_child = node_index;
+      }
+
+      const int64_t i = current.index;
+      ORT_ENFORCE(!visited[i], "Tree node ", i,
+                  " is reached from more than one node or is a root and a child, the nodes don't form trees.");
+      visited[i] = true;
+
+      Node node{};
+      node.threshold = nodes_values[i];
+      node.missing_tracks_true = has_missing_tracks_ && missing_tracks_true[i] != 0;
+
+      // the evaluation stops after max_tree_depth steps, so deeper nodes are treated as leaves
+      if (nodes_modes[i] == NODE_MODE::LEAF || current.depth > max_tree_depth) {
+        node.mode = static_cast<uint8_t>(NODE_MODE::LEAF);
+        auto range = leaf_ranges.find(nodes_treeids[i] * kOffset + nodes_nodeids[i]);
+        if (range != leaf_ranges.end()) {
+          node.feature_id = range->second.first;
+          node.false_child = range->second.second;
+        }
+        nodes_.push_back(node);
+        ++num_leaves;
+        total_leaf_depth += current.depth;
+        continue;
+      }
+
+      ORT_ENFORCE(nodes_featureids[i] >= 0 && nodes_featureids[i] < std::numeric_limits<int32_t>::max(),
+                  "Invalid feature id ", nodes_featureids[i], " for tree node ", i, ".");
+      node.feature_id = static_cast<int32_t>(nodes_featureids[i]);
+      node.mode = static_cast<uint8_t>(nodes_modes[i]);
+      max_feature_id_ = std::max(max_feature_id_, nodes_featureids[i]);
+
+      if (!found_mode) {
+        uniform_mode = nodes_modes[i];
+        found_mode = true;
+      } else if (uniform_mode != nodes_modes[i]) {
+        uniform_mode = NODE_MODE::LEAF;
+      }
+
+      const int64_t true_child = current.root + nodes_truenodeids[i];
+      const int64_t false_child = current.root + nodes_falsenodeids[i];
+      ORT_ENFORCE(nodes_truenodeids[i] >= 0 && true_child < num_nodes &&
+                      nodes_falsenodeids[i] >= 0 && false_child < num_nodes,
+                  "Invalid child node ids for tree node ", i, ".");
+
+      nodes_.push_back(node);
+      pending.push_back({false_child, current.root, current.depth + 1, node_index});
+      pending.push_back({true_child, current.root, current.depth + 1, -1});
+    }
+  }
+
+  uniform_mode_ = uniform_mode;
+  average_depth_ = num_leaves > 0 ? std::max(1., static_cast<double>(total_leaf_depth) / num_leaves) : 1.;
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// The score of one class or target of a row, accumulated over the leaves reached by the row.
+struct TreeEnsembleScore {
+  float sum = 0.f;
+  float min = 0.f;
+  float max = 0.f;
+  bool has_score = false;
+
+  void Add(float weight) {
+    if (has_score) {
+      sum += weight;
+      min = std::min(min, weight);
+      max = std::max(max, weight);
+    } else {
+      sum = min = max = weight;
+      has_score = true;
+    }
+  }
+
+  void Merge(const TreeEnsembleScore& other) {
+    if (!other.has_score) {
+      return;
+    }
+    if (has_score) {
+      sum += other.sum;
+      min = std::min(min, other.min);
+      max = std::max(max, other.max);
+    } else {
+      *this = other;
+    }
+  }
+};
+
+/**
+The trees of a TreeEnsembleClassifier or TreeEnsembleRegressor in a compact layout for evaluation.
+The nodes of each tree are stored depth first in one array, so the true child of a node is the next node and
+the nodes on the path of a row are close together. Leaves refer to the range of their weights in a second array.
+*/
+class TreeEnsembleLayout {
+ public:
+  // Build the layout from the attributes of the operator, after the node ids of each tree were made relative to the
+  // first node of the tree. roots are the indices of the root nodes and leaf_data is the
+  // (tree id, node id, class or target id, weight) of the leaf weights sorted by tree and node id.
+  // A node that is more than max_tree_depth nodes below the root is treated as a leaf.
+  void Initialize(const std::vector<int64_t>& nodes_treeids,
+                  const std::vector<int64_t>& nodes_nodeids,
+                  const std::vector<int64_t>& nodes_featureids,
+                  const std::vector<float>& nodes_values,
+                  const std::vector<NODE_MODE>& nodes_modes,
+                  const std::vector<int64_t>& nodes_truenodeids,
+                  const std::vector<int64_t>& nodes_falsenodeids,
+                  const std::vector<int64_t>& missing_tracks_true,
+                  const std::vector<int64_t>& roots,
+                  const std::vector<std::tuple<int64_t, int64_t, int64_t, float>>& leaf_data,
+                  int64_t num_scores,
+                  int64_t max_tree_depth);
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // The number of classes or targets the weights of the leaves are for.
+  int64_t NumScores() const { return num_scores_; }
+
+  // The largest feature id used by a branch node, or -1 if there are none. A row needs at least one more feature.
+  int64_t MaxFeatureId() const { return max_feature_id_; }
+
+  // Add the weights of the leaves reached by the N rows of x_data to scores, which has NumScores() entries for
+  // each row. The rows are split across the threads, or the trees are if there are too few rows.
+  template <typename T>
+  void ComputeScores(const T* x_data, int64_t N, int64_t stride, TreeEnsembleScore* scores,
+                     concurrency::ThreadPool* tp) const;
+
+ private:
+  struct Node {
+    // for a leaf, feature_id and false_child are the [begin, end) range of its weights in leaf_weights_
+    int32_t feature_id;
+    float threshold;
+    int32_t false_child;
+    uint8_t mode;
+    uint8_t missing_tracks_true;
+  };
+
+  struct LeafWeight {
+    int32_t score_index;
+    float weight;
+  };
+
+  // Evaluate the trees [first_tree, last_tree) for the rows [first_row, last_row). The rows are processed in small
+  // blocks that walk each tree in turn, so the top of the tree stays in the cache for all the rows of the block.
+  // uniform_mode is the mode of all the branch nodes, or LEAF if it varies.
+  template <NODE_MODE uniform_mode, typename T>
+  void AccumulateScores(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                        size_t first_tree, size_t last_tree, TreeEnsembleScore* scores) const;
+
+  template <NODE_MODE uniform_mode, typename T>
+  const Node& FindLeaf(int32_t node_index, const T* x_row) const;
+
+  template <typename T>
+  void AccumulateScores(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                        size_t first_tree, size_t last_tree, TreeEnsembleScore* scores) const;
+
+  std::vector<Node> nodes_;
+  std::vector<LeafWeight> leaf_weights_;
+  std::vector<int32_t> roots_;
+  int64_t num_scores_ = 0;
+  int64_t max_feature_id_ = -1;
+  NODE_MODE uniform_mode_ = NODE_MODE::LEAF;
+  bool has_missing_tracks_ = false;
+  double average_depth_ = 1.;
+};
+
+template <NODE_MODE uniform_mode, typename T>
+inline const TreeEnsembleLayout::Node& TreeEnsembleLayout::FindLeaf(int32_t node_index, const T* x_row) const {
+  const Node* node = &nodes_[node_index];
+  while (node->mode != static_cast<uint8_t>(NODE_MODE::LEAF)) {
+    const T val = x_row[node->feature_id];
+    const float threshold = node->threshold;
+    const NODE_MODE mode = uniform_mode != NODE_MODE::LEAF ? uniform_mode : static_cast<NODE_MODE>(node->mode);
+
+    bool is_true;
+    switch (mode) {
+      case NODE_MODE::BRANCH_LEQ:
+        is_true = val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        is_true = val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        is_true = val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        is_true = val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        is_true = val == threshold;
+        break;
+      default:
+        is_true = val != threshold;
+        break;
+    }
+
+    if (has_missing_tracks_ && !is_true) {
+      is_true = node->missing_tracks_true && std::isnan(static_cast<float>(val));
+    }
+
+    node = is_true ? node + 1 : &nodes_[node->false_child];
+  }
+  return *node;
+}
+
+template <NODE_MODE uniform_mode, typename T>
+void TreeEnsembleLayout::AccumulateScores(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                                          size_t first_tree, size_t last_tree, TreeEnsembleScore* scores) const {
+  constexpr int64_t kRowBlockSize = 16;
+
+  for (int64_t block_start = first_row; block_start < last_row; block_start += kRowBlockSize) {
+    const int64_t block_end = std::min(block_start + kRowBlockSize, last_row);
+    for (size_t tree = first_tree; tree < last_tree; ++tree) {
+      for (int64_t row = block_start; row < block_end; ++row) {
+        const Node& leaf = FindLeaf<uniform_mode>(roots_[tree], x_data + row * stride);
+        TreeEnsembleScore* row_scores = scores + (row - first_row) * num_scores_;
+        for (int32_t i = leaf.feature_id; i < leaf.false_child; ++i) {
+          row_scores[leaf_weights_[i].score_index].Add(leaf_weights_[i].weight);
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void TreeEnsembleLayout::AccumulateScores(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                                          size_t first_tree, size_t last_tree, TreeEnsembleScore* scores) const {
+  // most converters produce a single type of comparison, which lets the compiler remove the switch on the mode
+  switch (uniform_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      AccumulateScores<NODE_MODE::BRANCH_LEQ>(x_data, stride, first_row, last_row, first_tree, last_tree, scores);
+      break;
+    case NODE_MODE::BRANCH_LT:
+      AccumulateScores<NODE_MODE::BRANCH_LT>(x_data, stride, first_row, last_row, first_tree, last_tree, scores);
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      AccumulateScores<NODE_MODE::BRANCH_GTE>(x_data, stride, first_row, last_row, first_tree, last_tree, scores);
+      break;
+    case NODE_MODE::BRANCH_GT:
+      AccumulateScores<NODE_MODE::BRANCH_GT>(x_data, stride, first_row, last_row, first_tree, last_tree, scores);
+      break;
+    default:
+      AccumulateScores<NODE_MODE::LEAF>(x_data, stride, first_row, last_row, first_tree, last_tree, scores);
+      break;
+  }
+}
+
+template <typename T>
+void TreeEnsembleLayout::ComputeScores(const T* x_data, int64_t N, int64_t stride, TreeEnsembleScore* scores,
+                                       concurrency::ThreadPool* tp) const {
+  if (N == 0) {
+    return;
+  }
+
+  const size_t num_trees = roots_.size();
+  const int64_t num_threads = tp != nullptr ? tp->NumThreads() + 1 : 1;
+
+  if (N >= num_threads || num_trees < 2) {
+    // the cost of a row is roughly a few cycles for each node on its path through each tree
+    const double cost_per_row = 4. * average_depth_ * static_cast<double>(num_trees);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(N), cost_per_row, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          AccumulateScores(x_data, stride, first, last, 0, num_trees, scores + first * num_scores_);
+        });
+    return;
+  }
+
+  // too few rows to keep the threads busy, so each thread evaluates a block of trees for all the rows and
+  // the scores of the blocks are merged in order afterwards
+  const auto num_blocks = static_cast<int32_t>(std::min<int64_t>(num_threads, static_cast<int64_t>(num_trees)));
+  const size_t scores_size = static_cast<size_t>(N * num_scores_);
+  std::vector<TreeEnsembleScore> block_scores((num_blocks - 1) * scores_size);
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, num_blocks, [&](int32_t block) {
+        const size_t first_tree = num_trees * block / num_blocks;
+        const size_t last_tree = num_trees * (block + 1) / num_blocks;
+        TreeEnsembleScore* output = block == 0 ? scores : block_scores.data() + (block - 1) * scores_size;
+        AccumulateScores(x_data, stride, 0, N, first_tree, last_tree, output);
+      },
+      num_blocks);
+
+  for (int32_t block = 1; block < num_blocks; ++block) {
+    const TreeEnsembleScore* partial = block_scores.data() + (block - 1) * scores_size;
+    for (size_t i = 0; i < scores_size; ++i) {
+      scores[i].Merge(partial[i]);
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
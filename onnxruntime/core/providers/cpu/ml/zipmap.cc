@@ -49,7 +49,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
   if (tensor_pointer == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   const Tensor& X = *tensor_pointer;
   const TensorShape& x_shape = X.Shape();
-  const vector<int64_t>& x_dims = x_shape.GetDims();
+  const auto& x_dims = x_shape.GetDims();
 
   if (x_dims.empty()) {
     return Status(ONNXRUNTIME,
@@ -82,12 +82,12 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     y_data->resize(batch_size);
     int64_t current_weight_0 = 0;
     for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
+      // fill the map in place, the hint makes the insertion constant time when the labels are sorted
+      auto& map1 = (*y_data)[n];
       for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
+        map1.emplace_hint(map1.end(), classlabels_strings_[j], x_data[current_weight_0 + j]);
       }
       current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
     }
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
@@ -102,12 +102,11 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     y_data->resize(batch_size);
     int64_t current_weight_0 = 0;
     for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
+      auto& map2 = (*y_data)[n];
       for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
+        map2.emplace_hint(map2.end(), classlabels_int64s_[j], x_data[current_weight_0 + j]);
       }
       current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
     }
   }
   return common::Status::OK();
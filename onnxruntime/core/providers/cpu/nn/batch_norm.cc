@@ -17,6 +17,8 @@
 
 #include "core/providers/cpu/nn/batch_norm.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // spec: https://github.com/onnx/onnx/blob/master/docs/Operators.md#BatchNormalization
@@ -87,17 +89,22 @@ Status BatchNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
   Eigen::Array<float, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
   Eigen::Array<float, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-  EigenArrayMap<float> Y_arr(Y->template MutableData<float>(),
-                             is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                             is_spatial_ ? N * C : N);
-  ConstEigenArrayMap<float> X_arr(X->template Data<float>(),
-                                  is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                                  is_spatial_ ? N * C : N);
   if (is_spatial_) {  // spatial == 1
-    for (size_t nc = 0; nc < N * C; ++nc) {
-      Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
-    }
+    // each channel of each image is scaled and shifted on its own
+    const float* X_data = X->template Data<float>();
+    float* Y_data = Y->template MutableData<float>();
+    concurrency::ThreadPool::TryParallelFor(
+        p_op_kernel_context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(N * C),
+        static_cast<double>(sample_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (auto nc = static_cast<size_t>(first); nc < static_cast<size_t>(last); ++nc) {
+            MlasComputeScaleShift(X_data + nc * sample_size, Y_data + nc * sample_size, sample_size,
+                                  new_scale(nc % C), new_bias(nc % C));
+          }
+        });
   } else {  // spatial == 0
+    EigenArrayMap<float> Y_arr(Y->template MutableData<float>(), sample_size_incl_all_channels, N);
+    ConstEigenArrayMap<float> X_arr(X->template Data<float>(), sample_size_incl_all_channels, N);
     for (size_t n = 0; n < N; ++n) {
       Y_arr.col(n) = X_arr.col(n) * new_scale.col(0) + new_bias.col(0);
     }
@@ -16,6 +16,9 @@
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/nn/conv.h"
+
+#include <algorithm>
+
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -63,7 +66,7 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
   AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  ORT_RETURN_IF_ERROR(context->GetScratchAllocator(&alloc));
 
   auto col_data = alloc->Alloc(sizeof(T) * col_buffer_size);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
@@ -141,11 +144,52 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 4 || tensor.Shape()[2] != 3 || tensor.Shape()[3] != 3) {
+    return Status::OK();
+  }
+
+  // the Winograd algorithm only supports unit strides and dilations
+  const auto is_one = [](int64_t value) { return value == 1; };
+  if (!std::all_of(conv_attrs_.strides.begin(), conv_attrs_.strides.end(), is_one) ||
+      !std::all_of(conv_attrs_.dilations.begin(), conv_attrs_.dilations.end(), is_one)) {
+    return Status::OK();
+  }
+
+  const int64_t group = conv_attrs_.group;
+  const int64_t M = tensor.Shape()[0];
+  if (group <= 0 || M % group != 0) {
+    return Status::OK();
+  }
+
+  const auto group_count = static_cast<size_t>(group);
+  const auto input_channels = static_cast<size_t>(tensor.Shape()[1]);
+  const auto filter_count = static_cast<size_t>(M / group);
+  const size_t packed_filter_size = MlasConvWinogradPackFilterSize(group_count, input_channels, filter_count);
+  if (packed_filter_size == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_filter_data = alloc->Alloc(sizeof(float) * packed_filter_size);
+  packed_winograd_filter_ = BufferUniquePtr(packed_filter_data, BufferDeleter(alloc));
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(packed_filter_data));
+
+  winograd_filter_shape_ = tensor.Shape();
+  is_packed = true;
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
   const auto* W = context->Input<Tensor>(1);
-  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+  const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
+  // the residual tensor summed into the output by FusedConv. optional. nullptr if not provided
+  const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
   const int64_t M = W->Shape()[0];
@@ -176,10 +220,27 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   if (Y->Shape().Size() == 0)
     return Status::OK();
 
+  // The residual tensor is accumulated into the output by the GEMMs, before the bias and activation are applied
+  // while the output is still in the cache.
+  float Beta = 0.0f;
+  if (Sum != nullptr) {
+    if (Sum->Shape() != Y->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sum input shape ", Sum->Shape(),
+                             " does not match the output shape ", Y->Shape());
+    }
+    // copy the residual tensor unless the output was allocated in place of it
+    const auto* Sumdata = Sum->template Data<float>();
+    auto* Ydata = Y->template MutableData<float>();
+    if (Ydata != Sumdata) {
+      std::copy_n(Sumdata, Sum->Shape().Size(), Ydata);
+    }
+    Beta = 1.0f;
+  }
+
   TensorShape output_shape = Y->Shape().Slice(2);
 
   AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  ORT_RETURN_IF_ERROR(context->GetScratchAllocator(&alloc));
 
   const auto* Xdata = X->template Data<float>();
   const auto* Bdata = B != nullptr ? B->template Data<float>() : nullptr;
@@ -205,18 +266,33 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     static_cast<size_t>(M / conv_attrs_.group),
                     &activation_,
                     &WorkingBufferSize,
+                    Beta,
                     thread_pool);
 
+    // W was transformed by PrePack, so use the Winograd algorithm if the convolution supports it
+    const bool use_winograd = packed_winograd_filter_ != nullptr && W->Shape() == winograd_filter_shape_ &&
+                              MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, thread_pool);
+
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
 
-    MlasConv(&Parameters,
-             Xdata,
-             W->template Data<float>(),
-             Bdata,
-             static_cast<float*>(working_buffer.get()),
-             Ydata,
-             thread_pool);
+    if (use_winograd) {
+      MlasConvWinograd(&Parameters,
+                       Xdata,
+                       static_cast<const float*>(packed_winograd_filter_.get()),
+                       Bdata,
+                       static_cast<float*>(working_buffer.get()),
+                       Ydata,
+                       thread_pool);
+    } else {
+      MlasConv(&Parameters,
+               Xdata,
+               W->template Data<float>(),
+               Bdata,
+               static_cast<float*>(working_buffer.get()),
+               Ydata,
+               thread_pool);
+    }
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -260,7 +336,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             1,
             W->template Data<float>() + group_id * W_offset,
             col_buffer_data,
-            0,
+            Beta,
             Ydata + group_id * Y_offset,
             thread_pool);
       }
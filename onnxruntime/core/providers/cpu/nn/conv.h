@@ -28,12 +28,19 @@ class Conv<float> : public OpKernel {
     activation_.ActivationKind = MlasIdentityActivation;
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // constant 3x3 W transformed by PrePack for the Winograd algorithm
+  BufferUniquePtr packed_winograd_filter_;
+  TensorShape winograd_filter_shape_;
 };
 
 }  // namespace onnxruntime
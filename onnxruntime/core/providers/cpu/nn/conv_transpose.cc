@@ -57,7 +57,7 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   const int64_t output_size = (p.Y->Shape().Slice(2)).Size();
 
   AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  ORT_RETURN_IF_ERROR(context->GetScratchAllocator(&alloc));
 
   const int64_t col_buffer_size = kernel_dim * p.input_shape.Size();
   auto col_data = alloc->Alloc(sizeof(T) * col_buffer_size);
@@ -68,30 +68,29 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   const T* filter_data = p.F->template Data<T>();
   T* Ydata = p.Y->template MutableData<T>();
 
-  std::vector<int64_t> col_buffer_shape{kernel_dim};
-  col_buffer_shape.insert(col_buffer_shape.end(), p.input_shape.GetDims().begin(), p.input_shape.GetDims().end());
-
-  if (p.X->Shape().NumDimensions() == 4) {
-    for (auto image_id = 0; image_id < p.N; ++image_id) {
-      for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
-        // Weight term
-        math::Gemm<T>(
-            CblasTrans,
-            CblasNoTrans,
-            kernel_dim,
-            input_image_size,
-            p.num_input_channels / conv_transpose_attrs_.group,
-            1,
-            filter_data + group_id * W_offset,
-            Xdata + group_id * X_offset,
-            0,
-            col_buffer_data,
-            thread_pool);
+  const T* Bdata = p.B != nullptr ? p.B->template Data<T>() : nullptr;
+
+  const int64_t output_channels_per_group = p.num_output_channels / conv_transpose_attrs_.group;
+  const int64_t col_channel_size = kernel_size * input_image_size;
+  const bool is_2d = p.X->Shape().NumDimensions() == 4;
+
+  // the shapes of the image and the col buffer of a single output channel for Col2imNd
+  std::vector<int64_t> output_image_shape{1};
+  output_image_shape.insert(output_image_shape.end(), p.Y->Shape().GetDims().begin() + 2, p.Y->Shape().GetDims().end());
+  std::vector<int64_t> col_channel_shape{kernel_size};
+  col_channel_shape.insert(col_channel_shape.end(), p.input_shape.GetDims().begin(), p.input_shape.GetDims().end());
+
+  // Each output channel is scattered from its own rows of the col buffer, so the channels are split across the
+  // threads and the bias is added while the channel is still in the cache.
+  auto col2im_channels = [&](T* Yimage, const T* Bgroup, std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t c = first; c < last; ++c) {
+      const T* col_channel = col_buffer_data + c * col_channel_size;
+      T* Ychannel = Yimage + c * output_size;
 
-        // Col2im
+      if (is_2d) {
         math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            p.num_output_channels / conv_transpose_attrs_.group,
+            col_channel,
+            1,
             p.Y->Shape()[2],
             p.Y->Shape()[3],
             p.kernel_shape[0],
@@ -104,65 +103,60 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
             p.pads[3],
             p.strides[0],
             p.strides[1],
-            Ydata + group_id * Y_offset,
+            Ychannel,
             &CPUMathUtil::Instance());
-      }
-
-      if (p.B != nullptr) {
-        auto Ymatrix = EigenMatrixMap<T>(Ydata, output_size, p.num_output_channels);
-        auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-        Ymatrix.rowwise() += Bvec.transpose();
-      }
-
-      Xdata += X_offset * conv_transpose_attrs_.group;
-      Ydata += Y_offset * conv_transpose_attrs_.group;
-    }
-  } else {
-    TensorShape output_shape = p.Y->Shape().Slice(1);
-    output_shape[0] = output_shape[0] / conv_transpose_attrs_.group;
-
-    for (auto image_id = 0; image_id < p.N; ++image_id) {
-      for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
-        // Weight term
-        math::Gemm<T>(
-            CblasTrans,
-            CblasNoTrans,
-            kernel_dim,
-            input_image_size,
-            p.num_input_channels / conv_transpose_attrs_.group,
-            1,
-            filter_data + group_id * W_offset,
-            Xdata + group_id * X_offset,
-            0,
-            col_buffer_data,
-            thread_pool);
-
-        // Col2im
+      } else {
         math::Col2imNd<T, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            output_shape.GetDims().data(),
-            col_buffer_shape.data(),
-            output_shape.Size(),
-            col_buffer_size,
+            col_channel,
+            output_image_shape.data(),
+            col_channel_shape.data(),
+            output_size,
+            col_channel_size,
             p.kernel_shape.data(),
             p.strides.data(),
             p.dilations.data(),
             p.pads.data(),
             static_cast<int>(p.kernel_shape.size()),
-            Ydata + group_id * Y_offset,
+            Ychannel,
             &CPUMathUtil::Instance());
       }
 
-      if (p.B != nullptr) {
-
-        auto Ymatrix = EigenMatrixMap<T>(Ydata, output_size, p.num_output_channels);
-        auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-        Ymatrix.rowwise() += Bvec.transpose();
+      if (Bgroup != nullptr) {
+        EigenVectorMap<T>(Ychannel, output_size).array() += Bgroup[c];
       }
-
-      Xdata += X_offset * conv_transpose_attrs_.group;
-      Ydata += Y_offset * conv_transpose_attrs_.group;
     }
+  };
+
+  for (auto image_id = 0; image_id < p.N; ++image_id) {
+    for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
+      // Weight term
+      math::Gemm<T>(
+          CblasTrans,
+          CblasNoTrans,
+          kernel_dim,
+          input_image_size,
+          p.num_input_channels / conv_transpose_attrs_.group,
+          1,
+          filter_data + group_id * W_offset,
+          Xdata + group_id * X_offset,
+          0,
+          col_buffer_data,
+          thread_pool);
+
+      // Col2im with the bias term
+      T* Yimage = Ydata + group_id * Y_offset;
+      const T* Bgroup = Bdata != nullptr ? Bdata + group_id * output_channels_per_group : nullptr;
+
+      concurrency::ThreadPool::TryParallelFor(
+          thread_pool, static_cast<std::ptrdiff_t>(output_channels_per_group),
+          static_cast<double>(col_channel_size + output_size),
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            col2im_channels(Yimage, Bgroup, first, last);
+          });
+    }
+
+    Xdata += X_offset * conv_transpose_attrs_.group;
+    Ydata += Y_offset * conv_transpose_attrs_.group;
   }
 
   return Status::OK();
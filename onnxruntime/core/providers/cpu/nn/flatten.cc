@@ -10,6 +10,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     8,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 
@@ -19,6 +20,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 
@@ -28,6 +30,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Flatten);
 }
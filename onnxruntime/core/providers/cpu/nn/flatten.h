@@ -31,7 +31,8 @@ class Flatten final : public OpKernel {
 
     ORT_ENFORCE(gsl::narrow_cast<int64_t>(X_shape.NumDimensions()) >= axis, "The rank of input tensor must be >= axis");
 
-    Tensor* Y = context->Output(0, TensorShape({X_shape.SizeToDimension(axis), X_shape.SizeFromDimension(axis)}));
+    Tensor* Y = OutputForCopy(*context, 0, *X,
+                              TensorShape({X_shape.SizeToDimension(axis), X_shape.SizeFromDimension(axis)}));
 
     CopyCpuTensor(X, Y);
 
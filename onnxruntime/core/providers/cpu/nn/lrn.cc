@@ -16,8 +16,11 @@
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/nn/lrn.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -30,62 +33,34 @@ Status LRN<float>::Compute(OpKernelContext* context) const {
 
   // Supports NCHW image format.
   ORT_ENFORCE(X->Shape().NumDimensions() == 4);
-  const int N = gsl::narrow_cast<int>(X->Shape()[0]);
-  const int C = gsl::narrow_cast<int>(X->Shape()[1]);
-  const int H = gsl::narrow_cast<int>(X->Shape()[2]);
-  const int W = gsl::narrow_cast<int>(X->Shape()[3]);
-  const int image_size = C * H * W;
-  const int pre_pad = (size_ - 1) / 2;
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t H = X->Shape()[2];
+  const int64_t W = X->Shape()[3];
+  const int64_t image_size = C * H * W;
 
   const auto* Xdata = X->template Data<float>();
   auto* Ydata = Y->template MutableData<float>();
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  const int Xsize = gsl::narrow_cast<int>(X->Shape().Size());
-  auto sdata = alloc->Alloc(sizeof(float) * Xsize);
-  BufferUniquePtr scale_buffer(sdata, BufferDeleter(alloc));
-  auto* scale_data = static_cast<float*>(scale_buffer.get());
-  math::Set<float, CPUMathUtil>(Xsize, bias_, scale_data, &CPUMathUtil::Instance());
-
-  const size_t padded_square_size = (C + size_ - 1) * H * W;
-  auto psdata = alloc->Alloc(sizeof(float) * padded_square_size);
-  BufferUniquePtr padded_square_buffer(psdata, BufferDeleter(alloc));
-  auto* padded_square_data = static_cast<float*>(padded_square_buffer.get());
-  math::Set<float, CPUMathUtil>(padded_square_size, 0.0f, padded_square_data, &CPUMathUtil::Instance());
-
-  const float alpha_over_size = alpha_ / size_;
-  // go through the images
-  for (int n = 0; n < N; ++n) {
-    // compute the padded square
-    math::Sqr<float, CPUMathUtil>(image_size, Xdata + image_size * n,
-                                  padded_square_data + pre_pad * H * W,
-                                  &CPUMathUtil::Instance());
-    // Create the first channel scale
-    for (int c = 0; c < size_; ++c) {
-      math::Axpy<float, CPUMathUtil>(
-          H * W, alpha_over_size, padded_square_data + c * H * W,
-          scale_data + image_size * n, &CPUMathUtil::Instance());
-    }
-
-    for (int c = 1; c < C; ++c) {
-      float* this_scale_slice = scale_data + n * image_size + c * H * W;
-      // copy previous scale
-      memcpy(this_scale_slice, this_scale_slice - H * W, H * W * sizeof(float));
-      // add head
-      math::Axpy<float, CPUMathUtil>(
-          H * W, alpha_over_size, padded_square_data + (c + size_ - 1) * H * W,
-          this_scale_slice, &CPUMathUtil::Instance());
-      // subtract tail
-      math::Axpy<float, CPUMathUtil>(
-          H * W, -alpha_over_size, padded_square_data + (c - 1) * H * W,
-          this_scale_slice, &CPUMathUtil::Instance());
-    }
-  }
+  // The window slides across the channels, so the images are split in blocks of columns of all the channels
+  // that are normalized on their own.
+  constexpr int64_t kColumnsPerBlock = 256;
+  const int64_t num_blocks = (H * W + kColumnsPerBlock - 1) / kColumnsPerBlock;
 
-  math::Powx<float, CPUMathUtil>(Xsize, scale_data, -beta_, Ydata, &CPUMathUtil::Instance());
-  math::Mul<float, CPUMathUtil>(Xsize, Ydata, Xdata, Ydata, &CPUMathUtil::Instance());
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(N * num_blocks),
+      static_cast<double>(C * kColumnsPerBlock * 4),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t n = task / num_blocks;
+          const int64_t column = (task % num_blocks) * kColumnsPerBlock;
+          const int64_t offset = n * image_size + column;
+          MlasComputeLocalResponseNormalization(Xdata + offset, Ydata + offset, static_cast<size_t>(C),
+                                                static_cast<size_t>(H * W),
+                                                static_cast<size_t>(std::min(kColumnsPerBlock, H * W - column)),
+                                                static_cast<size_t>(size_), alpha_, beta_, bias_);
+        }
+      });
 
   return Status::OK();
 }
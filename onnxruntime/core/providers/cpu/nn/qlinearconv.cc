@@ -50,9 +50,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_scale_data = *(result_scale->template Data<float>());
 
   const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -91,6 +88,8 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   const auto* Xdata = X->template Data<uint8_t>();
   auto* Ydata = Y->template MutableData<uint8_t>();
 
@@ -152,18 +151,21 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
             *input_offset->template Data<uint8_t>());
       }
 
-      GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
-                              Ydata + group_id * Y_offset,
-                              *filter_offset->template Data<uint8_t>(),
-                              *input_offset->template Data<uint8_t>(),
-                              *result_offset->template Data<uint8_t>(),
-                              static_cast<int>(M / conv_attrs_.group),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+      QGemmu8u8_u8(static_cast<int>(M / conv_attrs_.group),
+                   static_cast<int>(output_image_size),
+                   static_cast<int>(kernel_dim),
+                   W->template Data<uint8_t>() + group_id * W_offset,
+                   static_cast<int>(kernel_dim),
+                   *filter_offset->template Data<uint8_t>(),
+                   col_buffer_data,
+                   static_cast<int>(output_image_size),
+                   *input_offset->template Data<uint8_t>(),
+                   Ydata + group_id * Y_offset,
+                   static_cast<int>(output_image_size),
+                   real_multiplier,
+                   *result_offset->template Data<uint8_t>(),
+                   bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset,
+                   thread_pool);
     }
 
     Xdata += X_offset * conv_attrs_.group;
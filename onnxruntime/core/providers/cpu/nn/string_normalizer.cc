@@ -5,6 +5,7 @@
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <codecvt>
@@ -16,6 +17,7 @@
 #include <iconv.h>
 #endif  // _MSC_VER
 
+#include <algorithm>
 #include <locale>
 #include <functional>
 #include <unordered_set>
@@ -110,20 +112,33 @@ using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 #else
 
 // All others (Linux)
+// The conversion descriptors are opened once and reused for all the
+// strings, so a converter must not be shared between threads.
 class Utf8Converter {
  public:
+  Utf8Converter(const std::string&, const std::wstring&)
+      // Order of arguments is to, from
+      : to_wchar_(iconv_open("WCHAR_T", "UTF-8")),
+        to_utf8_(iconv_open("UTF-8", "WCHAR_T")) {
+  }
+
+  ~Utf8Converter() {
+    if (IsOpen(to_wchar_)) {
+      iconv_close(to_wchar_);
+    }
+    if (IsOpen(to_utf8_)) {
+      iconv_close(to_utf8_);
+    }
+  }
 
-  Utf8Converter(const std::string&, const std::wstring&) {}
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Utf8Converter);
 
-  std::wstring from_bytes(const std::string& s) const {
+  std::wstring from_bytes(const std::string& s) {
     std::wstring result;
     if (s.empty()) {
       return result;
     }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
+    if (!IsOpen(to_wchar_)) {
       return wconv_error;
     }
 
@@ -132,30 +147,30 @@ class Utf8Converter {
     // Temporary buffer assumes 1 byte to 1 wchar_t
     // to make sure it is enough.
     const size_t buffer_len = iconv_in_bytes * sizeof(wchar_t);
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
-    char* iconv_out = buffer.get();
+    if (buffer_.size() < buffer_len) {
+      buffer_.resize(buffer_len);
+    }
+    char* iconv_out = buffer_.data();
     size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
+    auto ret = iconv(to_wchar_, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
     if (static_cast<size_t>(-1) == ret) {
       result = wconv_error;
+      // Reset the conversion state for the next string
+      iconv(to_wchar_, nullptr, nullptr, nullptr, nullptr);
     } else {
       size_t converted_bytes = buffer_len - iconv_out_bytes;
       assert((converted_bytes % sizeof(wchar_t)) == 0);
-      result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
+      result.assign(reinterpret_cast<const wchar_t*>(buffer_.data()), converted_bytes / sizeof(wchar_t));
     }
-    iconv_close(icvt);
     return result;
   }
 
-  std::string to_bytes(const std::wstring& wstr) const {
+  std::string to_bytes(const std::wstring& wstr) {
     std::string result;
     if (wstr.empty()) {
       return result;
     }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
+    if (!IsOpen(to_utf8_)) {
       return conv_error;
     }
 
@@ -163,23 +178,35 @@ class Utf8Converter {
     wchar_t* non_const_in = const_cast<wchar_t*>(wstr.c_str());
     char* iconv_in = reinterpret_cast<char*>(non_const_in);
     size_t iconv_in_bytes = wstr.length() * sizeof(wchar_t);
-    // Temp buffer, assume every code point converts into 3 bytes, this should be enough
+    // Temp buffer, assume every code point converts into 4 bytes, this should be enough
     // We do not convert terminating zeros
-    const size_t buffer_len = wstr.length() * 3;
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
+    const size_t buffer_len = wstr.length() * 4;
+    if (buffer_.size() < buffer_len) {
+      buffer_.resize(buffer_len);
+    }
 
-    char* iconv_out = buffer.get();
+    char* iconv_out = buffer_.data();
     size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
+    auto ret = iconv(to_utf8_, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
     if (static_cast<size_t>(-1) == ret) {
       result = conv_error;
+      iconv(to_utf8_, nullptr, nullptr, nullptr, nullptr);
     } else {
       size_t converted_len = buffer_len - iconv_out_bytes;
-      result.assign(buffer.get(), converted_len);
+      result.assign(buffer_.data(), converted_len);
     }
-    iconv_close(icvt);
     return result;
   }
+
+ private:
+  static bool IsOpen(iconv_t icvt) {
+    // CentOS is not happy with -1
+    return std::numeric_limits<iconv_t>::max() != icvt;
+  }
+
+  iconv_t to_wchar_;
+  iconv_t to_utf8_;
+  std::vector<char> buffer_;
 };
 
 #endif // __APPLE__
@@ -188,54 +215,72 @@ const std::string default_locale("en_US.UTF-8"); // All non-MS
 
 #endif // MS_VER
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      Utf8Converter& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
-  std::vector<int64_t> output_dims;
-  if (N == 1) {
-    output_dims.push_back(1);
+// Checks that the locale changes the case of the ascii letters as the "C" locale does
+// and leaves the other ascii characters alone. This is not the case for example
+// for the Turkish dotted and dotless i.
+bool IsAsciiCaseChange(const Locale& loc) {
+  std::wstring lower;
+  for (wchar_t ch = 0; ch < 0x80; ++ch) {
+    lower.push_back(ch);
   }
-
-  // Empty output case
-  if (C == 0) {
-    output_dims.push_back(1);
-    TensorShape output_shape(output_dims);
-    // This will create one empty string
-    ctx->Output(0, output_shape);
-    return Status::OK();
+  std::wstring upper(lower);
+  loc.ChangeCase(StringNormalizer::LOWER, lower);
+  loc.ChangeCase(StringNormalizer::UPPER, upper);
+  for (wchar_t ch = 0; ch < 0x80; ++ch) {
+    const bool is_upper = ch >= L'A' && ch <= L'Z';
+    const bool is_lower = ch >= L'a' && ch <= L'z';
+    if (lower[ch] != (is_upper ? ch + (L'a' - L'A') : ch) ||
+        upper[ch] != (is_lower ? ch - (L'a' - L'A') : ch)) {
+      return false;
+    }
   }
+  return true;
+}
 
-  output_dims.push_back(C);
-
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
+// Changes the case of the utf8 string s into result. Returns false if s contains invalid utf8 chars.
+// Strings of ascii characters are changed in place when ascii_case_change is set,
+// the others are converted to wchar_t and back.
+bool ChangeCase(const std::string& s, StringNormalizer::CaseAction caseaction,
+                const Locale& loc, bool ascii_case_change,
+                Utf8Converter& converter, std::string& result) {
+  assert(caseaction != StringNormalizer::NONE);
+  if (ascii_case_change &&
+      std::all_of(s.cbegin(), s.cend(), [](char ch) { return static_cast<unsigned char>(ch) < 0x80; })) {
+    result = s;
+    if (caseaction == StringNormalizer::LOWER) {
+      for (auto& ch : result) {
+        if (ch >= 'A' && ch <= 'Z') {
+          ch += 'a' - 'A';
+        }
       }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
     } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+      for (auto& ch : result) {
+        if (ch >= 'a' && ch <= 'z') {
+          ch -= 'a' - 'A';
+        }
+      }
     }
-    ++output_idx;
-    ++first;
+    return true;
   }
-  return Status::OK();
+
+  std::wstring wstr = converter.from_bytes(s);
+  if (wstr == wconv_error) {
+    return false;
+  }
+  // In place transform
+  loc.ChangeCase(caseaction, wstr);
+  result = converter.to_bytes(wstr);
+  return true;
 }
+
+// What happens to an input string
+enum StringAction : uint8_t {
+  kFiltered = 0,    // it is a stopword
+  kCopyOriginal,    // output as is
+  kMoveCased,       // output the string with the case changed
+  kInvalidUtf8,     // error
+};
+
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
@@ -267,8 +312,9 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  const std::string locale_name = info.GetAttrOrDefault("locale", default_locale);
+  locale_ = onnxruntime::make_unique<Locale>(locale_name);
+  ascii_case_change_ = IsAsciiCaseChange(*locale_);
   Utf8Converter converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
@@ -278,15 +324,17 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       auto p = stopwords_.insert(sw);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
-      auto p = wstopwords_.insert(wstr);
+      std::string cased;
+      ORT_ENFORCE(ChangeCase(sw, compare_caseaction_, *locale_, ascii_case_change_, converter, cased),
+                  "Stopword contains invalid utf8 chars");
+      auto p = stopwords_.insert(std::move(cased));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -314,70 +362,75 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
+  // The strings are independent of each other, so the stopword filtering and the case changes
+  // run in parallel and the surviving strings are written out in order afterwards
   auto const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
-  if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
-        }
-        ++first;
-      }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
-    }
-  } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
-      std::vector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
-          if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
+  const bool filter = !stopwords_.empty();
+  const bool change_case = case_change_action_ != NONE;
+  std::vector<StringAction> actions(C);
+  std::vector<std::string> cased_strings(change_case || (filter && !is_case_sensitive_) ? C : 0);
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(C), 64.0,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        Utf8Converter converter(conv_error, wconv_error);
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const std::string& s = input_data[i];
+          if (filter && !is_case_sensitive_) {
+            // Compare in the case of the stopwords. It is also the output case if one is requested.
+            if (!ChangeCase(s, compare_caseaction_, *locale_, ascii_case_change_, converter, cased_strings[i])) {
+              actions[i] = kInvalidUtf8;
+            } else if (stopwords_.count(cased_strings[i]) != 0) {
+              actions[i] = kFiltered;
+            } else {
+              actions[i] = change_case ? kMoveCased : kCopyOriginal;
+            }
+          } else if (filter && stopwords_.count(s) != 0) {
+            actions[i] = kFiltered;
+          } else if (change_case) {
+            actions[i] = ChangeCase(s, case_change_action_, *locale_, ascii_case_change_, converter, cased_strings[i])
+                             ? kMoveCased
+                             : kInvalidUtf8;
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            actions[i] = kCopyOriginal;
           }
         }
-        ++first;
-      }
-      if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
-      } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
-      }
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      });
+
+  size_t output_size = 0;
+  for (size_t i = 0; i < C; ++i) {
+    if (actions[i] == kInvalidUtf8) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                    "Input contains invalid utf8 chars at: " + input_data[i]);
+    }
+    output_size += actions[i] != kFiltered;
+  }
+
+  std::vector<int64_t> output_dims;
+  if (N == 1) {
+    output_dims.push_back(1);
+  }
+
+  // Empty output case
+  if (output_size == 0) {
+    output_dims.push_back(1);
+    TensorShape output_shape(output_dims);
+    // This will create one empty string
+    ctx->Output(0, output_shape);
+    return Status::OK();
+  }
+
+  output_dims.push_back(output_size);
+
+  TensorShape output_shape(output_dims);
+  auto output_tensor = ctx->Output(0, output_shape);
+  auto output_data = output_tensor->template MutableData<std::string>();
+  for (size_t i = 0; i < C; ++i) {
+    if (actions[i] == kCopyOriginal) {
+      *output_data++ = input_data[i];
+    } else if (actions[i] == kMoveCased) {
+      *output_data++ = std::move(cased_strings[i]);
     }
   }
-  return status;
+  return Status::OK();
 }
 }  // namespace onnxruntime
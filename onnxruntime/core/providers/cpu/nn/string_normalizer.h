@@ -6,11 +6,16 @@
 #include "core/framework/op_kernel.h"
 
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
 namespace onnxruntime {
 
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -20,7 +25,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -28,10 +33,12 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
+  std::unique_ptr<string_normalizer::Locale> locale_;
+  // The locale changes the case of the ascii letters as the "C" locale does,
+  // so strings of ascii characters can change case without a conversion to wchar_t
+  bool ascii_case_change_;
+  // In compare_caseaction_ case when not case sensitive
   std::unordered_set<std::string> stopwords_;
-  std::unordered_set<std::wstring> wstopwords_;
 };
 
 }  // namespace onnxruntime
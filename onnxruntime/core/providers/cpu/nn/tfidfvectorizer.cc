@@ -5,7 +5,9 @@
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
 #include <unordered_set>
 #include <ostream>
@@ -42,6 +44,19 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 
 namespace ngram_details {
 
+// The hash of one item of an n-gram. The hash of an n-gram is combined
+// from the hashes of its items, so the input items are hashed only once
+// for all the n-grams they are part of.
+template <class T>
+inline size_t ItemHash(const T& v) {
+  return std::hash<int64_t>()(v);
+}
+
+template <>
+inline size_t ItemHash<std::string>(const std::string& s) {
+  return std::hash<std::string>()(s);
+}
+
 class NgramEntryBase {
   size_t id_;  // Id in the pool
  protected:
@@ -60,16 +75,15 @@ class NgramEntry<int64_t> : public NgramEntryBase {
   std::vector<int64_t> items_;
   size_t hash_ = 0;
 
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf;
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  void RunningHash(size_t h) {
+    hash_ ^= h + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
   }
 
  public:
   template <typename ForwardIter>
   explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
     while (first != last) {
-      RunningHash(*first);
+      RunningHash(ItemHash<int64_t>(*first));
       items_.push_back(*first);
       ++first;
     }
@@ -78,8 +92,12 @@ class NgramEntry<int64_t> : public NgramEntryBase {
   // For sampling
   explicit NgramEntry() : NgramEntryBase(0) {}
   void AddItem(int64_t v) {
+    AddItem(v, ItemHash<int64_t>(v));
+  }
+  // h is ItemHash(v)
+  void AddItem(int64_t v, size_t h) {
     items_.push_back(v);
-    RunningHash(v);
+    RunningHash(h);
   }
   void DebugPrint() const {
     std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
@@ -111,16 +129,15 @@ class NgramEntry<std::string> : public NgramEntryBase {
   std::vector<std::reference_wrapper<const std::string>> items_;
   size_t hash_ = 0;
 
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf;
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+  void RunningHash(size_t h) {
+    hash_ ^= h + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
   }
 
  public:
   template <typename ForwardIter>
   explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
     while (first != last) {
-      RunningHash(*first);
+      RunningHash(ItemHash<std::string>(*first));
       items_.push_back(std::cref(*first));
       ++first;
     }
@@ -128,8 +145,12 @@ class NgramEntry<std::string> : public NgramEntryBase {
   }
   explicit NgramEntry() : NgramEntryBase(0) {}
   void AddItem(const std::string& s) {
+    AddItem(s, ItemHash<std::string>(s));
+  }
+  // h is ItemHash(s)
+  void AddItem(const std::string& s, size_t h) {
     items_.push_back(std::cref(s));
-    RunningHash(s);
+    RunningHash(h);
   }
   void DebugPrint() const {
     std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
@@ -501,82 +522,75 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   }
 
   assert((b_dim * C) == total_items);
+  ORT_UNUSED_PARAMETER(total_items);
 
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
   auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
-
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
-        }
-        ++ngram_start;
-      }
-      ++row_num;
-      ngram_start = ngram_row_end;
-    }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
-    }
-  }
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
-          break;
-        }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
-          // Do not test anything before start_ngram_size
-          if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
-              // record frequency
-              auto ngram_id = hit->Id();
-              impl.IncrementCount(ngram_id, row_num, frequencies);
+  // Every row counts into its own part of frequencies, so the rows are processed in parallel.
+  // The items of a row are hashed once for all the n-grams that contain them.
+  const double cost_per_row = static_cast<double>(C) * max_gram_length * max_skip_distance * 8;
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(b_dim), cost_per_row,
+      [&](std::ptrdiff_t first_row, std::ptrdiff_t last_row) {
+        NgramEntry<T> sample;
+        std::vector<size_t> hashes(C);
+        for (std::ptrdiff_t r = first_row; r < last_row; ++r) {
+          const size_t row_num = static_cast<size_t>(r);
+          auto const row_start = input_data + row_num * C;
+          auto const ngram_row_end = row_start + C;
+          std::transform(row_start, ngram_row_end, hashes.begin(), &ItemHash<T>);
+          auto start_ngram_size = impl.min_gram_length_;
+
+          // Treat 1-grams in a special way
+          if (start_ngram_size == 1) {
+            for (auto ngram_start = row_start; ngram_start < ngram_row_end; ++ngram_start) {
+              sample.Clear();
+              sample.AddItem(*ngram_start, hashes[ngram_start - row_start]);
+              auto hit = impl.PoolFind<T>(sample);
+              if (hit != set_end) {
+                // record frequency
+                auto ngram_id = hit->Id();
+                impl.IncrementCount(ngram_id, row_num, frequencies);
+              }
+            }
+            if (++start_ngram_size > max_gram_length) {
+              continue;
+            }
+          }
+
+          for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+            for (auto ngram_start = row_start; ngram_start < ngram_row_end; ++ngram_start) {
+              // Check if any n-gram size in [start_ngram_size..max_gram_length] range
+              // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
+              // At least items of start_ngram_size should fit
+              auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
+              if (at_least_this >= ngram_row_end) {
+                break;
+              }
+              sample.Clear();
+              auto ngram_item = ngram_start;
+              for (auto ngram_size = 1;
+                   ngram_size <= max_gram_length &&
+                   ngram_item < ngram_row_end;
+                   ++ngram_size, ngram_item += skip_distance) {
+                sample.AddItem(*ngram_item, hashes[ngram_item - row_start]);
+
+                // Do not test anything before start_ngram_size
+                if (ngram_size >= start_ngram_size) {
+                  auto hit = impl.PoolFind<T>(sample);
+                  if (hit != set_end) {
+                    // record frequency
+                    auto ngram_id = hit->Id();
+                    impl.IncrementCount(ngram_id, row_num, frequencies);
+                  }
+                }
+              }
             }
           }
         }
-        // Sliding window shift
-        ++ngram_start;
-      }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
-    }
-  }
+      });
   OutputResult(ctx, B, frequencies);
   return Status::OK();
 }
@@ -13,7 +13,8 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -110,6 +111,111 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+struct ScoreIndexPair {
+  float score_{};
+  int64_t index_{};
+
+  ScoreIndexPair() = default;
+  explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+
+  // boxes with the same score are selected in order of their index
+  bool operator<(const ScoreIndexPair& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+// The corners and area of a box, as computed by SuppressByIOU.
+struct BoxCorners {
+  float x_min{};
+  float y_min{};
+  float x_max{};
+  float y_max{};
+  float area{};
+
+  BoxCorners() = default;
+  BoxCorners(const float* box, int64_t center_point_box) {
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], x_min, x_max);
+      MaxMin(box[0], box[2], y_min, y_max);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      float width_half = box[2] / 2;
+      float height_half = box[3] / 2;
+      x_min = box[0] - width_half;
+      x_max = box[0] + width_half;
+      y_min = box[1] - height_half;
+      y_max = box[1] + height_half;
+    }
+    area = (x_max - x_min) * (y_max - y_min);
+  }
+};
+
+// The boxes selected for a class, stored by coordinate so a candidate is compared with a block of them at a time
+// by a loop without branches that the compiler can vectorize.
+class SelectedBoxes {
+ public:
+  void Clear() {
+    x_min_.clear();
+    y_min_.clear();
+    x_max_.clear();
+    y_max_.clear();
+    area_.clear();
+  }
+
+  size_t Size() const { return area_.size(); }
+
+  void Add(const BoxCorners& box) {
+    x_min_.push_back(box.x_min);
+    y_min_.push_back(box.y_min);
+    x_max_.push_back(box.x_max);
+    y_max_.push_back(box.y_max);
+    area_.push_back(box.area);
+  }
+
+  // Whether the IOU of the box with any of the selected boxes exceeds iou_threshold, like SuppressByIOU.
+  bool Suppresses(const BoxCorners& box, float iou_threshold) const {
+    constexpr size_t kBlockSize = 16;
+    if (box.area <= .0f) {
+      return false;
+    }
+
+    const size_t size = Size();
+    for (size_t begin = 0; begin < size; begin += kBlockSize) {
+      const size_t end = std::min(begin + kBlockSize, size);
+      int suppressed = 0;
+      for (size_t i = begin; i < end; ++i) {
+        const float intersection_x_min = std::max(x_min_[i], box.x_min);
+        const float intersection_y_min = std::max(y_min_[i], box.y_min);
+        const float intersection_x_max = std::min(x_max_[i], box.x_max);
+        const float intersection_y_max = std::min(y_max_[i], box.y_max);
+        const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
+                                        std::max(intersection_y_max - intersection_y_min, .0f);
+        const float union_area = area_[i] + box.area - intersection_area;
+        suppressed |= static_cast<int>(intersection_area > .0f) & static_cast<int>(area_[i] > .0f) &
+                      static_cast<int>(union_area > .0f) &
+                      static_cast<int>(intersection_area / union_area > iou_threshold);
+      }
+      if (suppressed) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::vector<float> x_min_;
+  std::vector<float> y_min_;
+  std::vector<float> x_max_;
+  std::vector<float> y_max_;
+  std::vector<float> area_;
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   auto ret = PrepareCompute(ctx, pc);
@@ -129,69 +235,70 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct ScoreIndexPair {
-    float score_{};
-    int64_t index_{};
-
-    ScoreIndexPair() = default;
-    explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
-
-    bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
-      // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
-          }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // the corners of every box in the batch, computed once for all of the classes
+  std::vector<BoxCorners> corners(static_cast<size_t>(pc.num_batches_ * pc.num_boxes_));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(corners.size()), 8.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          corners[i] = BoxCorners(boxes_data + 4 * i, center_point_box);
         }
-      }
-
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+      });
+
+  // each (batch, class) pair is independent, so they are processed in parallel and the selected indices are
+  // concatenated in order afterwards
+  const int64_t num_tasks = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<SelectedIndex>> selected_per_task(static_cast<size_t>(num_tasks));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_tasks), static_cast<double>(pc.num_boxes_) * 16,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<ScoreIndexPair> candidates;
+        SelectedBoxes selected_boxes;
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t batch_index = task / pc.num_classes_;
+          const int64_t class_index = task % pc.num_classes_;
+          const auto* class_scores = scores_data + task * pc.num_boxes_;
+          const BoxCorners* batch_corners = corners.data() + batch_index * pc.num_boxes_;
+
+          // Filter by score_threshold_
+          candidates.clear();
+          for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+            if (pc.score_threshold_ == nullptr || class_scores[box_index] > score_threshold) {
+              candidates.emplace_back(class_scores[box_index], box_index);
+            }
           }
-        }
 
-        if (selected) {
-          if (max_output_boxes_per_class > 0 &&
-              static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
-            break;
+          // the candidates are taken from a heap in order of decreasing score, so they are only ordered as far
+          // as needed to select max_output_boxes_per_class boxes
+          std::make_heap(candidates.begin(), candidates.end());
+          auto heap_end = candidates.end();
+
+          auto& selected_indices = selected_per_task[task];
+          selected_boxes.Clear();
+          // Get the next box with top score, filter by iou_threshold
+          while (heap_end != candidates.begin() &&
+                 static_cast<int64_t>(selected_boxes.Size()) < max_output_boxes_per_class) {
+            std::pop_heap(candidates.begin(), heap_end);
+            --heap_end;
+            const ScoreIndexPair& next_top_score = *heap_end;
+            const BoxCorners& box = batch_corners[next_top_score.index_];
+
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+            // threshold
+            if (!selected_boxes.Suppresses(box, iou_threshold)) {
+              selected_boxes.Add(box);
+              selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+            }
           }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
         }
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+      });
+
+  std::vector<SelectedIndex> selected_indices;
+  for (const auto& task_indices : selected_per_task) {
+    selected_indices.insert(selected_indices.end(), task_indices.begin(), task_indices.end());
+  }
 
   const auto last_dim = 3;
   const auto num_selected = selected_indices.size();
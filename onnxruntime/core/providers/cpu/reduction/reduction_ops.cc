@@ -3,7 +3,9 @@
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
+#include <functional>
 using namespace std;
 namespace onnxruntime {
 
@@ -118,86 +120,60 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMax, 11);
 REGISTER_UNARY_ELEMENTWISE_VERSIONED_KERNEL(ArgMin, 1, 10);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMin, 11);
 
-// When all reduce axises located at the tail of the dims, quite general cases, transpose and extra
-// copy could be skipped to improve performance, if required by check_no_transpose = true;
-// return value: true means transposedInputData is not created/copied, input tensor data could
-//               be direct use as row major matrix [block_size, blocks], where blocks is the
-//               size of each reduce.
-template <typename T>
-bool PrepareForReduce(OpKernelContext* ctx,
-                      std::vector<T>& transposedInputData,
-                      Tensor** reducedTensor,
-                      int64_t& block_size,
-                      int64_t& blocks,
-                      const std::vector<int64_t>& axes_,
-                      bool keepdims_,
-                      bool check_no_transpose = false) {
-  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
-  ORT_ENFORCE(input_tensor_ptr != nullptr);
-  const Tensor& input = *input_tensor_ptr;
-
-  size_t ndim = input.Shape().GetDims().size();
-  std::vector<int64_t> axes;
-  axes.reserve(axes_.size());
-  for (int64_t axis : axes_) {
-    axes.push_back(HandleNegativeAxis(axis, static_cast<int64_t>(ndim)));
-  }
-
-  if (axes.empty()) {
-    // This is the default case for non-arg kind reductions. Reduce on all dimensions.
-    for (size_t i = 0; i < ndim; i++) {
-      axes.push_back(i);
-    }
-  }
-
-  std::sort(axes.begin(), axes.end());
-
-  // If all reduced axes are located at the tail of the input shape, then copy could be skipped is required
-  bool need_copy = true;
-  if (axes.size() <= ndim &&
-      axes.front() == static_cast<int64_t>(ndim - axes.size()) &&
-      axes.back() == static_cast<int64_t>(ndim) - 1) {
-    need_copy = false;
-  }
-
-  vector<bool> keep_axis(ndim, true);
-  for (auto i : axes) {
-    keep_axis[i] = false;
-  }
-
-  //transpose the input so that all to-be-reduced axes are at the head
-  vector<int64_t> transposed_axes(axes.begin(), axes.end());
-  for (size_t i = 0; i < ndim; ++i) {
-    if (keep_axis[i]) {
-      transposed_axes.push_back(i);
+// The reduction of a tensor over a set of axes, in terms of offsets into the input data.
+// After the dimensions of size 1 are dropped and adjacent dimensions that are both kept or both reduced are merged,
+// the innermost dimension is either reduced, so every output value reduces contiguous runs of inner_size values,
+// or kept, so every group of inner_size output values reduces contiguous rows of the input elementwise.
+// This covers reductions over the innermost axes, the outermost axes, and any pattern in between without
+// transposing the input.
+struct ReducePlan {
+  // the input offset of each output value, or of each group of inner_size output values if inner_reduced is false
+  std::vector<int64_t> output_offsets;
+  // the offset of each run or row of the input that is reduced into an output, relative to its output offset
+  std::vector<int64_t> reduced_offsets;
+  int64_t inner_size = 1;
+  bool inner_reduced = true;
+  // the number of input values reduced into each output value
+  int64_t reduced_count = 1;
+};
+
+// The offsets of all the positions of the given dimensions in row major order.
+static std::vector<int64_t> ComputeOffsets(const std::vector<int64_t>& sizes, const std::vector<int64_t>& strides) {
+  std::vector<int64_t> offsets{0};
+  for (size_t d = 0; d < sizes.size(); ++d) {
+    std::vector<int64_t> next;
+    next.reserve(offsets.size() * sizes[d]);
+    for (int64_t offset : offsets) {
+      for (int64_t i = 0; i < sizes[d]; ++i) {
+        next.push_back(offset + i * strides[d]);
+      }
     }
+    offsets.swap(next);
   }
+  return offsets;
+}
 
-  vector<int64_t> new_dims_(transposed_axes.size());
-  for (size_t i = 0; i < transposed_axes.size(); ++i) {
-    new_dims_[i] = input.Shape().GetDims().at(transposed_axes[i]);
-  }
+// Create the output of the reduction and, if plan is not null, the plan to compute it.
+// Returns false if the input is empty, in which case the output is too and there is nothing to compute.
+static bool PrepareForReduce(OpKernelContext* ctx,
+                             Tensor** reducedTensor,
+                             const std::vector<int64_t>& axes_,
+                             bool keepdims_,
+                             ReducePlan* plan = nullptr) {
+  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
 
-  int num_axes = static_cast<int>(transposed_axes.size());
-  auto in_dims = input.Shape().GetDims();
+  const auto& in_dims = input.Shape().GetDims();
+  size_t ndim = in_dims.size();
 
-  // Measure amount of contiguous data we can copy at once
-  int64_t blocksize = 1;
-  int n_shared_idxs = 0;
-  for (int i = num_axes - 1; i >= 0; --i) {
-    if (transposed_axes[i] == i) {
-      blocksize *= new_dims_[i];
-      ++n_shared_idxs;
-    } else {
-      break;
-    }
+  // no axes is the default case for non-arg kind reductions. Reduce on all dimensions.
+  vector<bool> keep_axis(ndim, !axes_.empty());
+  for (int64_t axis : axes_) {
+    keep_axis[HandleNegativeAxis(axis, static_cast<int64_t>(ndim))] = false;
   }
 
-  const T* from_data = input.template Data<T>();
-  size_t count = input.Shape().Size();
-
   //set to-be-reduced axes to one. squeeze is keepdims_ is false
-  int64_t first_dim = 1;
   std::vector<int64_t> reduced_dims;
   reduced_dims.reserve(in_dims.size());
 
@@ -206,7 +182,6 @@ bool PrepareForReduce(OpKernelContext* ctx,
     if (keep_axis[i]) {
       reduced_dims.push_back(in_dim);
     } else {
-      first_dim *= in_dim;
       if (keepdims_) {
         reduced_dims.push_back(in_dim == 0 ? 0 : 1);
       } else {
@@ -224,335 +199,395 @@ bool PrepareForReduce(OpKernelContext* ctx,
   }
 
   *reducedTensor = ctx->Output(0, std::move(reduced_dims));
-  auto num_elements = input.Shape().Size();
 
   // edge case. one or more input dims with value of 0.
-  if (num_elements == 0) {
-    block_size = blocks = 0;
-    return true;
+  if (input.Shape().Size() == 0) {
+    return false;
   }
 
-  block_size = num_elements / first_dim;
-  blocks = first_dim;
-
-  if (!need_copy && check_no_transpose) {
+  if (plan == nullptr) {
     return true;
   }
 
-  transposedInputData.resize(input.Shape().Size(), 0);
-  T* to_data = &transposedInputData[0];
-  if (num_axes < 2 || n_shared_idxs == num_axes) {
-    memcpy(to_data, from_data, count * sizeof(T));
-    return false;
-  }
-
-  int itr_axes = num_axes - n_shared_idxs;
-
-  // Calculate strides
-  std::vector<int64_t> stride_x(itr_axes, 0);
-  for (size_t i = 0; static_cast<int>(i) < itr_axes; i++) {
-    stride_x[i] = 1;
-    for (size_t j = transposed_axes[i] + 1; static_cast<int>(j) < itr_axes; j++) {
-      stride_x[i] *= in_dims[j];
+  // merge the dimensions, dropping the ones of size 1
+  std::vector<int64_t> sizes;
+  std::vector<bool> reduced;
+  for (size_t i = 0; i < ndim; ++i) {
+    if (in_dims[i] == 1) {
+      continue;
+    }
+    if (!reduced.empty() && reduced.back() == !keep_axis[i]) {
+      sizes.back() *= in_dims[i];
+    } else {
+      sizes.push_back(in_dims[i]);
+      reduced.push_back(!keep_axis[i]);
     }
   }
 
-  std::vector<int64_t> itr_idxs(itr_axes, 0);
-
-  // Branch here to avoid branching within the loop
-  if (blocksize > 1) {
-    for (size_t index = 0; index < (count / blocksize); index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
-      }
-
-      memcpy(
-          to_data + blocksize * index,
-          from_data + blocksize * from_index,
-          blocksize * sizeof(T));
-
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
-        }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
-      }
-    }
-  } else {
-    for (size_t index = 0; index < count; index++) {
-      int64_t from_index = 0;
-      for (int i = 0; i < itr_axes; ++i) {
-        from_index += stride_x[i] * itr_idxs[i];
-      }
+  *plan = ReducePlan();
+  if (!sizes.empty()) {
+    plan->inner_size = sizes.back();
+    plan->inner_reduced = reduced.back();
+    sizes.pop_back();
+    reduced.pop_back();
+  }
 
-      *(to_data + index) = *(from_data + from_index);
+  std::vector<int64_t> strides(sizes.size());
+  for (int64_t d = static_cast<int64_t>(sizes.size()) - 1, stride = plan->inner_size; d >= 0; --d) {
+    strides[d] = stride;
+    stride *= sizes[d];
+  }
 
-      ++itr_idxs[itr_axes - 1];
-      for (int i = itr_axes - 1; i >= 1; --i) {
-        auto expected_dim = new_dims_[i];
-        if (itr_idxs[i] < expected_dim) {
-          break;
-        }
-        itr_idxs[i] %= expected_dim;
-        ++itr_idxs[i - 1];
-      }
+  std::vector<int64_t> kept_sizes, kept_strides, reduced_sizes, reduced_strides;
+  for (size_t d = 0; d < sizes.size(); ++d) {
+    if (reduced[d]) {
+      plan->reduced_count *= sizes[d];
+      reduced_sizes.push_back(sizes[d]);
+      reduced_strides.push_back(strides[d]);
+    } else {
+      kept_sizes.push_back(sizes[d]);
+      kept_strides.push_back(strides[d]);
     }
   }
-  return false;
-}
-
-template <typename T>
-Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).cwiseAbs().rowwise().sum();
+  if (plan->inner_reduced) {
+    plan->reduced_count *= plan->inner_size;
+  }
 
-  return Status::OK();
+  plan->output_offsets = ComputeOffsets(kept_sizes, kept_strides);
+  plan->reduced_offsets = ComputeOffsets(reduced_sizes, reduced_strides);
+  return true;
 }
 
+// The aggregators of the reductions. Acc is the partial result of some of the input values, which
+// UpdateRun extends with a contiguous run of input values, UpdateRow extends elementwise for a group of
+// consecutive output values with a contiguous row of input values, and Merge combines with the partial result
+// of other input values. Finalize produces the output value from the partial result of reduced_count values.
 template <typename T>
-Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+struct ReduceAggregatorSum {
+  using Acc = T;
+  static Acc Init() { return 0; }
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) { acc += ConstEigenVectorMap<T>(data, size).sum(); }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    EigenVectorMap<T>(acc, size) += ConstEigenVectorMap<T>(data, size);
+  }
+  static void Merge(Acc& acc, const Acc& other) { acc += other; }
+  static T Finalize(const Acc& acc, int64_t /*reduced_count*/) { return acc; }
+};
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().norm();
+template <typename T>
+struct ReduceAggregatorMean : ReduceAggregatorSum<T> {
+  static T Finalize(const T& acc, int64_t reduced_count) { return acc / static_cast<T>(reduced_count); }
+};
 
-  return Status::OK();
-}
+template <typename T>
+struct ReduceAggregatorLogSum : ReduceAggregatorSum<T> {
+  static T Finalize(const T& acc, int64_t /*reduced_count*/) { return static_cast<T>(std::log(acc)); }
+};
 
 template <typename T>
-Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+struct ReduceAggregatorSumSquare : ReduceAggregatorSum<T> {
+  using Acc = T;
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) {
+    acc += ConstEigenVectorMap<T>(data, size).squaredNorm();
+  }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    auto values = ConstEigenVectorMap<T>(data, size).array();
+    EigenVectorMap<T>(acc, size).array() += values * values;
+  }
+};
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+struct ReduceAggregatorL2 : ReduceAggregatorSumSquare<T> {
+  static T Finalize(const T& acc, int64_t /*reduced_count*/) { return static_cast<T>(std::sqrt(acc)); }
+};
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  for (int j = 0; j < block_size; ++j) {
-    *(output_data) = static_cast<T>(std::log(*(output_data)));
-    ++output_data;
+template <typename T>
+struct ReduceAggregatorL1 : ReduceAggregatorSum<T> {
+  using Acc = T;
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) {
+    acc += ConstEigenVectorMap<T>(data, size).cwiseAbs().sum();
   }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    EigenVectorMap<T>(acc, size) += ConstEigenVectorMap<T>(data, size).cwiseAbs();
+  }
+};
 
-  return Status::OK();
-}
+template <typename T>
+struct ReduceAggregatorProd {
+  using Acc = T;
+  static Acc Init() { return 1; }
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) { acc *= ConstEigenVectorMap<T>(data, size).prod(); }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    EigenVectorMap<T>(acc, size).array() *= ConstEigenVectorMap<T>(data, size).array();
+  }
+  static void Merge(Acc& acc, const Acc& other) { acc *= other; }
+  static T Finalize(const Acc& acc, int64_t /*reduced_count*/) { return acc; }
+};
 
 template <typename T>
-Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+struct ReduceAggregatorMax {
+  using Acc = T;
+  static Acc Init() { return std::numeric_limits<T>::lowest(); }
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) {
+    acc = std::max(acc, ConstEigenVectorMap<T>(data, size).maxCoeff());
+  }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    EigenVectorMap<T> acc_vec(acc, size);
+    acc_vec = acc_vec.cwiseMax(ConstEigenVectorMap<T>(data, size));
+  }
+  static void Merge(Acc& acc, const Acc& other) { acc = std::max(acc, other); }
+  static T Finalize(const Acc& acc, int64_t /*reduced_count*/) { return acc; }
+};
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+struct ReduceAggregatorMin {
+  using Acc = T;
+  static Acc Init() { return std::numeric_limits<T>::max(); }
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) {
+    acc = std::min(acc, ConstEigenVectorMap<T>(data, size).minCoeff());
+  }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    EigenVectorMap<T> acc_vec(acc, size);
+    acc_vec = acc_vec.cwiseMin(ConstEigenVectorMap<T>(data, size));
+  }
+  static void Merge(Acc& acc, const Acc& other) { acc = std::min(acc, other); }
+  static T Finalize(const Acc& acc, int64_t /*reduced_count*/) { return acc; }
+};
 
-  for (int j = 0; j < block_size; ++j) {
-    T max_value = std::numeric_limits<T>::lowest();
-    for (int i = 0; i < blocks; ++i) {
-      max_value = std::max(max_value, transposedInputData[i * block_size + j]);
+// log(sum(exp(x))) is computed as max + log(sum(exp(x - max))) to avoid overflow, with the sum rescaled whenever
+// a larger maximum is found so the input is only read once.
+template <typename T>
+struct ReduceAggregatorLogSumExp {
+  struct Acc {
+    T max;
+    double sum;
+  };
+  static Acc Init() { return {std::numeric_limits<T>::lowest(), 0.}; }
+  static void Merge(Acc& acc, const Acc& other) {
+    if (other.max > acc.max) {
+      acc.sum = acc.sum * std::exp(static_cast<double>(acc.max) - other.max) + other.sum;
+      acc.max = other.max;
+    } else {
+      acc.sum += other.sum * std::exp(static_cast<double>(other.max) - acc.max);
     }
-    T scaled_exp_sum = 0;
-    for (int i = 0; i < blocks; ++i) {
-      scaled_exp_sum += static_cast<T>(std::exp(transposedInputData[i * block_size + j] - max_value));
+  }
+  static void UpdateRun(Acc& acc, const T* data, int64_t size) {
+    Acc run{ConstEigenVectorMap<T>(data, size).maxCoeff(), 0.};
+    for (int64_t i = 0; i < size; ++i) {
+      run.sum += std::exp(static_cast<double>(data[i]) - run.max);
+    }
+    Merge(acc, run);
+  }
+  static void UpdateRow(Acc* acc, const T* data, int64_t size) {
+    for (int64_t i = 0; i < size; ++i) {
+      Merge(acc[i], {data[i], 1.});
+    }
+  }
+  static T Finalize(const Acc& acc, int64_t /*reduced_count*/) {
+    return static_cast<T>(std::log(acc.sum) + acc.max);
+  }
+};
+
+// Reduce the runs or rows [first, last) of plan.reduced_offsets for the output value or group of output values
+// whose input starts at input_data.
+template <typename Aggregator, typename T>
+static void ReduceRange(const ReducePlan& plan, const T* input_data, size_t first, size_t last,
+                        typename Aggregator::Acc* acc) {
+  for (size_t r = first; r < last; ++r) {
+    const T* data = input_data + plan.reduced_offsets[r];
+    if (plan.inner_reduced) {
+      Aggregator::UpdateRun(*acc, data, plan.inner_size);
+    } else {
+      Aggregator::UpdateRow(acc, data, plan.inner_size);
     }
-    *(output_data++) = static_cast<T>(std::log(scaled_exp_sum) + max_value);
   }
-  return Status::OK();
 }
 
-template <typename T>
-Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
+// Compute the reduction described by the plan. The output values are split across the threads, unless there are
+// too few of them to keep the threads busy, in which case the reduced values of each output are split in chunks that
+// are reduced in parallel and then combined.
+template <typename Aggregator, typename T>
+static void Reduce(const ReducePlan& plan, const T* input_data, T* output_data, concurrency::ThreadPool* tp) {
+  using Acc = typename Aggregator::Acc;
+  constexpr int64_t kMinValuesPerChunk = 16 * 1024;
+
+  const auto num_groups = static_cast<int64_t>(plan.output_offsets.size());
+  const auto num_reduced = static_cast<int64_t>(plan.reduced_offsets.size());
+  const int64_t group_size = plan.inner_reduced ? 1 : plan.inner_size;
+  const int64_t values_per_group = num_reduced * plan.inner_size;
+  const int64_t num_threads = tp != nullptr ? tp->NumThreads() + 1 : 1;
+
+  int64_t chunks_per_group = 1;
+  if (num_groups < num_threads) {
+    chunks_per_group = std::min(num_reduced, std::max<int64_t>(1, values_per_group / kMinValuesPerChunk));
+    chunks_per_group = std::min(chunks_per_group, (num_threads + num_groups - 1) / num_groups);
+  }
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+  if (chunks_per_group == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(num_groups), static_cast<double>(values_per_group),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<Acc> acc(static_cast<size_t>(group_size));
+          for (std::ptrdiff_t g = first; g < last; ++g) {
+            std::fill(acc.begin(), acc.end(), Aggregator::Init());
+            ReduceRange<Aggregator>(plan, input_data + plan.output_offsets[g], 0, num_reduced, acc.data());
+            T* output = output_data + g * group_size;
+            for (int64_t i = 0; i < group_size; ++i) {
+              output[i] = Aggregator::Finalize(acc[i], plan.reduced_count);
+            }
+          }
+        });
+    return;
+  }
 
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).maxCoeff();
+  // tree combine: every chunk produces a partial result and the partial results of a group are merged in order
+  const auto num_chunks = static_cast<int32_t>(num_groups * chunks_per_group);
+  std::vector<Acc> partial(static_cast<size_t>(num_chunks * group_size), Aggregator::Init());
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, num_chunks, [&](int32_t chunk) {
+        const int64_t g = chunk / chunks_per_group;
+        const int64_t c = chunk % chunks_per_group;
+        ReduceRange<Aggregator>(plan, input_data + plan.output_offsets[g],
+                                static_cast<size_t>(num_reduced * c / chunks_per_group),
+                                static_cast<size_t>(num_reduced * (c + 1) / chunks_per_group),
+                                partial.data() + chunk * group_size);
+      },
+      num_chunks);
+
+  for (int64_t g = 0; g < num_groups; ++g) {
+    Acc* acc = partial.data() + g * chunks_per_group * group_size;
+    for (int64_t c = 1; c < chunks_per_group; ++c) {
+      const Acc* other = acc + c * group_size;
+      for (int64_t i = 0; i < group_size; ++i) {
+        Aggregator::Merge(acc[i], other[i]);
+      }
+    }
+    T* output = output_data + g * group_size;
+    for (int64_t i = 0; i < group_size; ++i) {
+      output[i] = Aggregator::Finalize(acc[i], plan.reduced_count);
     }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
   }
-
-  return Status::OK();
 }
 
-template <typename T>
-Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
+template <typename Aggregator, typename T>
+static Status ComputeReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes, bool keepdims) {
+  ReducePlan plan;
   Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
+  if (PrepareForReduce(ctx, &reduced, axes, keepdims, &plan)) {
+    Reduce<Aggregator>(plan, ctx->Input<Tensor>(0)->template Data<T>(), reduced->template MutableData<T>(),
+                       ctx->GetOperatorThreadPool());
   }
-
   return Status::OK();
 }
 
 template <typename T>
-Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
+Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorL1<T>, T>(ctx, axes_, keepdims_);
+}
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+template <typename T>
+Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorL2<T>, T>(ctx, axes_, keepdims_);
+}
 
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).minCoeff();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
-  }
+template <typename T>
+Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorLogSum<T>, T>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorLogSumExp<T>, T>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
-Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorMax<T>, T>(ctx, axes_, keepdims_);
+}
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorMean<T>, T>(ctx, axes_, keepdims_);
+}
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().prod();
+template <typename T>
+Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorMin<T>, T>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <typename T>
+Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
+  return ComputeReduce<ReduceAggregatorProd<T>, T>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
-
-  return Status::OK();
+  return ComputeReduce<ReduceAggregatorSum<T>, T>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+  return ComputeReduce<ReduceAggregatorSumSquare<T>, T>(ctx, axes_, keepdims_);
+}
 
-  T* output_data = reduced->template MutableData<T>();
+// ArgMax and ArgMin reduce a single axis, so the input is [outer, axis, inner] and the output is [outer, inner].
+// The output values are split across the threads, and each thread compares its range of the inner values
+// row by row so the input is read sequentially. The first index of the maximum or minimum is selected.
+template <typename T, typename Compare>
+static Status ComputeArgReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes, bool keepdims) {
+  Tensor* reduced;
+  if (!PrepareForReduce(ctx, &reduced, axes, keepdims)) {
+    return Status::OK();
+  }
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().squaredNorm();
+  const Tensor& input = *ctx->Input<Tensor>(0);
+  const auto axis = static_cast<size_t>(HandleNegativeAxis(axes[0], input.Shape().NumDimensions()));
+  const int64_t axis_size = input.Shape()[axis];
+  const int64_t inner = input.Shape().SizeFromDimension(axis + 1);
+  const int64_t num_outputs = reduced->Shape().Size();
+
+  const T* input_data = input.template Data<T>();
+  int64_t* output_data = reduced->template MutableData<int64_t>();
+  Compare compare;
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_outputs), static_cast<double>(axis_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<T> best;
+        while (first < last) {
+          // the outputs [first, end) have the same outer index
+          const int64_t outer = first / inner;
+          const int64_t begin = first % inner;
+          const int64_t end = std::min<int64_t>(inner, begin + (last - first));
+          const T* data = input_data + outer * axis_size * inner;
+          int64_t* output = output_data + outer * inner;
+
+          best.assign(data + begin, data + end);
+          std::fill(output + begin, output + end, 0);
+          for (int64_t i = 1; i < axis_size; ++i) {
+            const T* row = data + i * inner;
+            for (int64_t j = begin; j < end; ++j) {
+              if (compare(row[j], best[j - begin])) {
+                best[j - begin] = row[j];
+                output[j] = i;
+              }
+            }
+          }
+          first += end - begin;
+        }
+      });
 
   return Status::OK();
 }
 
 template <typename T>
 Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index maxIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).maxCoeff(&maxIndex);
-    *(output_data++) = maxIndex;
-  }
-
-  return Status::OK();
+  return ComputeArgReduce<T, std::greater<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index minIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).minCoeff(&minIndex);
-    *(output_data++) = minIndex;
-  }
-
-  return Status::OK();
+  return ComputeArgReduce<T, std::less<T>>(ctx, axes_, keepdims_);
 }
 
 }  // namespace onnxruntime
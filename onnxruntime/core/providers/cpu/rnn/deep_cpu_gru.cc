@@ -172,8 +172,10 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_g, float clip,
                     onnxruntime::concurrency::ThreadPool* ttp);
 
+  // recurrent_weightsZR and recurrent_weightsH are the R[zr] and R[h] parts of R
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
@@ -248,6 +250,25 @@ class UniDirectionalGru {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+Status DeepCpuGruOp::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // W is [num_directions, 3*hidden_size, input_size] and is used in one GEMM.
+  // R is [num_directions, 3*hidden_size, hidden_size] and R[zr] and R[h] are used in separate GEMMs.
+  if (input_idx == 1 || input_idx == 2) {
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    if (input_idx == 1) {
+      ORT_RETURN_IF_ERROR(PackWeights(tensor, num_directions_, {3 * hidden_size_}, alloc, packed_W_));
+      is_packed = packed_W_.buffer_ != nullptr;
+    } else {
+      ORT_RETURN_IF_ERROR(PackWeights(tensor, num_directions_, {2 * hidden_size_, hidden_size_}, alloc, packed_R_));
+      is_packed = packed_R_.buffer_ != nullptr;
+    }
+  }
+
+  return Status::OK();
+}
+
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -267,6 +288,41 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
+  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
+  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
+
+  // the shapes are validated later so split the weights using their total size
+  const int64_t input_weights_size_per_direction = W.Shape().Size() / num_directions_;
+  const int64_t recurrent_weights_size_per_direction = R.Shape().Size() / num_directions_;
+  const int64_t recurrent_weightsZR_size_per_direction = recurrent_weights_size_per_direction / 3 * 2;
+
+  // use the weights packed by PrePack for each direction, if they were constant initializers
+  const bool use_packed_W = packed_W_.IsPacked(W.Shape());
+  const bool use_packed_R = packed_R_.IsPacked(R.Shape());
+
+  std::vector<GemmWeights<T>> input_weights;
+  std::vector<GemmWeights<T>> recurrent_weightsZR;
+  std::vector<GemmWeights<T>> recurrent_weightsH;
+  for (int direction = 0; direction < num_directions_; ++direction) {
+    gsl::span<const T> recurrent_weights = R.DataAsSpan<T>().subspan(direction * recurrent_weights_size_per_direction,
+                                                                     recurrent_weights_size_per_direction);
+    input_weights.emplace_back(W.DataAsSpan<T>().subspan(direction * input_weights_size_per_direction,
+                                                         input_weights_size_per_direction),
+                               use_packed_W ? packed_W_.Block(direction, 0) : nullptr);
+    recurrent_weightsZR.emplace_back(recurrent_weights.subspan(0, recurrent_weightsZR_size_per_direction),
+                                     use_packed_R ? packed_R_.Block(direction, 0) : nullptr);
+    recurrent_weightsH.emplace_back(recurrent_weights.subspan(recurrent_weightsZR_size_per_direction),
+                                    use_packed_R ? packed_R_.Block(direction, 1) : nullptr);
+  }
+
+  return ComputeImpl<T>(context, input_weights, recurrent_weightsZR, recurrent_weightsH);
+}
+
+template <typename T>
+Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context,
+                                 const std::vector<GemmWeights<T>>& input_weights,
+                                 const std::vector<GemmWeights<T>>& recurrent_weightsZR,
+                                 const std::vector<GemmWeights<T>>& recurrent_weightsH) const {
   concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
@@ -305,19 +361,13 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
+  status = context.GetScratchAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 3 * hidden_size_ * input_size;
-  const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -352,10 +402,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -374,7 +420,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    fw.Compute(input, sequence_lens_span, num_directions_,
+               input_weights[0], recurrent_weightsZR[0], recurrent_weightsH[0],
                output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
@@ -382,7 +429,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
+    bw.Compute(input, sequence_lens_span, num_directions_,
+               input_weights[1], recurrent_weightsZR[1], recurrent_weightsH[1],
                output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
@@ -390,7 +438,8 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    gru_p.Compute(input, sequence_lens_span, num_directions_,
+                  input_weights[0], recurrent_weightsZR[0], recurrent_weightsH[0],
                   output_1, hidden_output_1);
   }
 
@@ -402,6 +451,12 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   return Status::OK();
 }
 
+// used by the GRU operators with other types of weights
+template Status DeepCpuGruOp::ComputeImpl<float>(OpKernelContext& context,
+                                                 const std::vector<GemmWeights<float>>& input_weights,
+                                                 const std::vector<GemmWeights<float>>& recurrent_weightsZR,
+                                                 const std::vector<GemmWeights<float>>& recurrent_weightsH) const;
+
 //
 // Implementation of internal helper code
 namespace detail {
@@ -490,8 +545,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -508,11 +564,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
+  DumpMatrix("input_weights", input_weights.weights_.data(), 3 * hidden_size_, input_size_);
+  DumpMatrix("recurrent_weightsZR", recurrent_weightsZR.weights_.data(), 2 * hidden_size_, hidden_size_);
+  DumpMatrix("recurrent_weightsH", recurrent_weightsH.weights_.data(), hidden_size_, hidden_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -540,14 +594,17 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   float alpha = 1.0f;
   float beta = 0.0f;  // zero out outputZRH_ when calling ComputeGemm.
 
+  // scratch buffers for the GEMMs with quantized weights
+  QuantizedGemmBuffers quantized_buffers;
+
   // apply weights to all the inputs
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, beta,
+              input_weights,
+              beta,
               outputZRH_.begin(), outputZRH_.end(),
-              hidden_size_x3, ttp_);
+              hidden_size_x3, quantized_buffers, ttp_);
 
   DumpMatrix("inputs with weights applied", outputZRH_.data(), seq_length_ * batch_size_ * 3, hidden_size_);
 
@@ -610,10 +667,10 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
                 prev_Ht, prev_Ht_end,
                 hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, beta,
+                recurrent_weightsZR,
+                beta,
                 outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                hidden_size_x3, ttp_);
+                hidden_size_x3, quantized_buffers, ttp_);
 
     DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -626,10 +683,10 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weightsH,  // Rh^T
+                  beta,
                   linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
-                  hidden_size_, ttp_);
+                  hidden_size_, quantized_buffers, ttp_);
 
       DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
     }
@@ -697,10 +754,10 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weightsH,  // Rh^T
+                  beta,
                   out_H, outputZRH_.end(),
-                  hidden_size_x3, ttp_);
+                  hidden_size_x3, quantized_buffers, ttp_);
     }
 
     DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
@@ -13,7 +13,7 @@ namespace onnxruntime {
 
 /// The class represents GRU operator using DeepCPU implementation for
 /// fast inference computation on CPU machines.
-class DeepCpuGruOp final : public OpKernel {
+class DeepCpuGruOp : public OpKernel {
  public:
   DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info) {
     // required attributes
@@ -52,20 +52,35 @@ class DeepCpuGruOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
 
- private:
+ protected:
+  // input_weights, recurrent_weightsZR and recurrent_weightsH have an entry for each direction
+  template <typename T>
+  Status ComputeImpl(OpKernelContext& context,
+                     const std::vector<rnn::detail::GemmWeights<T>>& input_weights,
+                     const std::vector<rnn::detail::GemmWeights<T>>& recurrent_weightsZR,
+                     const std::vector<rnn::detail::GemmWeights<T>>& recurrent_weightsH) const;
+
   rnn::detail::Direction direction_;
   int num_directions_;
 
   int hidden_size_ {};
+
+ private:
   float clip_;
   int linear_before_reset_ {};
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W and R packed by PrePack if they are constant initializers
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
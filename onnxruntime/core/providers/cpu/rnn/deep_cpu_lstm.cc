@@ -200,7 +200,7 @@ class UniDirectionalLstm {
                      concurrency::ThreadPool* mlas_tp_);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -311,8 +311,51 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // W is [num_directions, 4*hidden_size, input_size] and R is [num_directions, 4*hidden_size, hidden_size]
+  if (input_idx == 1 || input_idx == 2) {
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    auto& packed = input_idx == 1 ? packed_W_ : packed_R_;
+    ORT_RETURN_IF_ERROR(PackWeights(tensor, num_directions_, {4 * hidden_size_}, alloc, packed));
+    is_packed = packed.buffer_ != nullptr;
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
+  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
+  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
+
+  // the shapes are validated later so split the weights using their total size
+  const int64_t input_weights_size_per_direction = W.Shape().Size() / num_directions_;
+  const int64_t hidden_weights_size_per_direction = R.Shape().Size() / num_directions_;
+
+  // use the weights packed by PrePack for each direction, if they were constant initializers
+  const bool use_packed_W = packed_W_.IsPacked(W.Shape());
+  const bool use_packed_R = packed_R_.IsPacked(R.Shape());
+
+  std::vector<GemmWeights<T>> input_weights;
+  std::vector<GemmWeights<T>> recurrent_weights;
+  for (int direction = 0; direction < num_directions_; ++direction) {
+    input_weights.emplace_back(W.DataAsSpan<T>().subspan(direction * input_weights_size_per_direction,
+                                                         input_weights_size_per_direction),
+                               use_packed_W ? packed_W_.Block(direction, 0) : nullptr);
+    recurrent_weights.emplace_back(R.DataAsSpan<T>().subspan(direction * hidden_weights_size_per_direction,
+                                                             hidden_weights_size_per_direction),
+                                   use_packed_R ? packed_R_.Block(direction, 0) : nullptr);
+  }
+
+  return ComputeImpl<T>(context, input_weights, recurrent_weights);
+}
+
+template <typename T>
+Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context,
+                                  const std::vector<GemmWeights<T>>& input_weights,
+                                  const std::vector<GemmWeights<T>>& recurrent_weights) const {
   concurrency::ThreadPool* mlas_thread_pool = context.GetOperatorThreadPool();
 
   auto& logger = context.Logger();
@@ -359,22 +402,16 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
+  status = context.GetScratchAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
 
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
   gsl::span<const T> peephole_weights = P != nullptr ? P->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 4 * hidden_size_ * input_size;
-  const size_t hidden_weights_size_per_direction = 4 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 8 * hidden_size_;
   const size_t peephole_weights_size_per_direction = 3 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, hidden_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
   gsl::span<const T> peephole_weights_1 =
       peephole_weights.empty() ? peephole_weights
@@ -426,10 +463,6 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> hidden_weights_2 = recurrent_weights.subspan(hidden_weights_size_per_direction,
-                                                                    hidden_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
     gsl::span<const T> peephole_weights_2 =
         peephole_weights.empty() ? peephole_weights
@@ -468,9 +501,9 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[5],
                                      clip_, lstm_tp_, mlas_thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights[0],
                output_1, hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights[1], recurrent_weights[1],
                output_2, hidden_output_2, last_cell_2);
   } else {
     detail::UniDirectionalLstm<T> fw(alloc, logger, seq_length, batch_size, input_size,
@@ -481,7 +514,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[2],
                                      clip_, lstm_tp_, mlas_thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights[0],
                output_1, hidden_output_1, last_cell_1);
   }
 
@@ -495,6 +528,11 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   return Status::OK();
 }
 
+// used by the LSTM operators with other types of weights
+template Status DeepCpuLstmOp::ComputeImpl<float>(OpKernelContext& context,
+                                                  const std::vector<GemmWeights<float>>& input_weights,
+                                                  const std::vector<GemmWeights<float>>& recurrent_weights) const;
+
 Status DeepCpuLstmOp::ValidateInputs(const Tensor& X, const Tensor& W, const Tensor& R, const Tensor* B,
                                      const Tensor* sequence_lens, const Tensor* initial_h, const Tensor* initial_c,
                                      const Tensor* P, int batch_size) const {
@@ -718,8 +756,8 @@ template <typename T>
 void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const gsl::span<const int>& sequence_lengths_arg,
                                     const int num_directions,
-                                    const gsl::span<const T>& input_weights,
-                                    const gsl::span<const T>& recurrent_weights,
+                                    const GemmWeights<T>& input_weights,
+                                    const GemmWeights<T>& recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -775,14 +813,17 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int hidden_size_x4 = 4 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
+  // scratch buffers for the GEMMs with quantized weights
+  QuantizedGemmBuffers quantized_buffers;
+
   // apply the weights to all the inputs and save to output_IOFC
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta,
+              input_weights,  // W[iofc]
+              beta,
               output_iofc_.begin(), output_iofc_.end(),
-              hidden_size_x4, mlas_tp_);
+              hidden_size_x4, quantized_buffers, mlas_tp_);
 
   DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
 
@@ -802,6 +843,9 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     // lambda to do all processing on fused_hidden_rows rows
     auto hidden_gemm_and_activations = [&](int row) {
+      // each lambda needs its own scratch buffers as they run concurrently
+      QuantizedGemmBuffers local_quantized_buffers;
+
       span_T_const_iter previous_state_end = batched_hidden_state_one_step.cend();
 
       //handling boundaries
@@ -829,10 +873,10 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
                     previous_state, previous_state_end,  // Ht-1
                     hidden_size_,
-                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta,
+                    recurrent_weights,  // R[iofc]
+                    beta,
                     step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4, mlas_tp_);
+                    hidden_size_x4, local_quantized_buffers, mlas_tp_);
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str,
                    &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
@@ -909,10 +953,10 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
                   previous_state, previous_state_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, beta,
+                  recurrent_weights,  // R[iofc]
+                  beta,
                   step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, mlas_tp_);
+                  hidden_size_x4, quantized_buffers, mlas_tp_);
 
       span_T_iter batched_output;
       span_T_iter batched_output_end;
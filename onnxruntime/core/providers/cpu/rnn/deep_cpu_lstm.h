@@ -13,7 +13,7 @@ namespace onnxruntime {
 
 /// The class represents DeepCPU implementation of a long short term memory (LSTM) operator.
 /// For details, refer to http://aka.ms/dl-optimization/.
-class DeepCpuLstmOp final : public OpKernel {
+class DeepCpuLstmOp : public OpKernel {
  public:
   DeepCpuLstmOp(const OpKernelInfo& info)
       : OpKernel(info), clip_(info.GetAttrOrDefault<float>("clip", std::numeric_limits<float>::max())) {
@@ -51,10 +51,19 @@ class DeepCpuLstmOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuLstmOp() override = default;
 
+ protected:
+  // input_weights and recurrent_weights have an entry for each direction
+  template <typename T>
+  Status ComputeImpl(OpKernelContext& context,
+                     const std::vector<rnn::detail::GemmWeights<T>>& input_weights,
+                     const std::vector<rnn::detail::GemmWeights<T>>& recurrent_weights) const;
+
  private:
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
@@ -69,15 +78,22 @@ class DeepCpuLstmOp final : public OpKernel {
                         const Tensor* P,
                         int batch_size) const;
 
+ protected:
   rnn::detail::Direction direction_;
   int num_directions_;
 
   int hidden_size_ = 0;
+
+ private:
   float clip_;
   bool input_forget_ = false;
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W and R packed by PrePack if they are constant initializers
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_;
+
   // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
   // across them. mutable due to this.
   // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
@@ -3,10 +3,12 @@
 
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <stdlib.h>
 #include <string>
 #include <unordered_map>
@@ -101,6 +103,145 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+Status PackWeights(const Tensor& weights, int num_directions, const std::vector<int>& block_rows,
+                   const AllocatorPtr& allocator, PackedWeights& packed) {
+  packed = PackedWeights{};
+
+  const auto& shape = weights.Shape();
+  const int total_rows = std::accumulate(block_rows.cbegin(), block_rows.cend(), 0);
+  if (!weights.IsDataType<float>() || shape.NumDimensions() != 3 || shape[0] != num_directions ||
+      shape[1] != total_rows) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  std::vector<size_t> block_offsets;
+  size_t buffer_size_per_direction = 0;
+  for (int rows : block_rows) {
+    const size_t block_size = MlasGemmPackBSize(static_cast<size_t>(rows), K);
+    if (block_size == 0) {
+      return Status::OK();
+    }
+    block_offsets.push_back(buffer_size_per_direction);
+    buffer_size_per_direction += block_size;
+  }
+
+  auto* buffer = allocator->Alloc(buffer_size_per_direction * num_directions);
+  packed.buffer_ = BufferUniquePtr(buffer, BufferDeleter(allocator));
+  packed.buffer_size_per_direction_ = buffer_size_per_direction;
+  packed.block_offsets_ = std::move(block_offsets);
+  packed.shape_ = shape;
+
+  const float* weights_data = weights.Data<float>();
+  for (int direction = 0; direction < num_directions; ++direction) {
+    const float* block_weights = weights_data + direction * total_rows * K;
+    for (size_t block = 0; block < block_rows.size(); ++block) {
+      auto* packed_block = static_cast<uint8_t*>(buffer) + direction * buffer_size_per_direction +
+                           packed.block_offsets_[block];
+      MlasGemmPackB(CblasTrans, block_rows[block], K, block_weights, K, packed_block);
+      block_weights += block_rows[block] * K;
+    }
+  }
+
+  return Status::OK();
+}
+
+Status TransposeQuantizedWeights(const Tensor& weights, TransposedQuantizedWeights& transposed) {
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Quantized weights must have 3 dimensions. Actual:", shape);
+  }
+
+  const int64_t num_directions = shape[0];
+  const int64_t N = shape[1];
+  const int64_t K = shape[2];
+
+  const int8_t* src = weights.Data<int8_t>();
+  transposed.buffer_.resize(shape.Size());
+  transposed.shape_ = shape;
+
+  for (int64_t direction = 0; direction < num_directions; ++direction) {
+    int8_t* dst = transposed.buffer_.data() + direction * N * K;
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        dst[k * N + n] = *src++;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+Status GetWeightQuantizationParameters(const Tensor& scale, const Tensor* zero_point, int64_t num_directions,
+                                       int64_t N, std::vector<float>& scales, std::vector<int8_t>& zero_points) {
+  const auto& scale_shape = scale.Shape();
+  const bool per_channel = scale_shape.NumDimensions() == 2;
+  if (!(scale_shape.NumDimensions() == 1 && scale_shape[0] == num_directions) &&
+      !(per_channel && scale_shape[0] == num_directions && scale_shape[1] == N)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Weight scale must have shape {", num_directions,
+                           "} or {", num_directions, ",", N, "}. Actual:", scale_shape);
+  }
+
+  if (zero_point != nullptr && zero_point->Shape() != scale_shape) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Weight zero point must have the shape of the scale ",
+                           scale_shape, ". Actual:", zero_point->Shape());
+  }
+
+  const float* scale_data = scale.Data<float>();
+  const int8_t* zero_point_data = zero_point != nullptr ? zero_point->Data<int8_t>() : nullptr;
+
+  scales.resize(num_directions * N);
+  zero_points.resize(num_directions * N);
+  for (int64_t i = 0; i < num_directions * N; ++i) {
+    const int64_t index = per_channel ? i : i / N;
+    scales[i] = scale_data[index];
+    zero_points[i] = zero_point_data != nullptr ? zero_point_data[index] : 0;
+  }
+
+  return Status::OK();
+}
+
+void ComputeQuantizedGemm(int M, int N, int K, float alpha, const float* A, int lda,
+                          const QuantizedWeights& weights, float beta, float* C, int ldc,
+                          QuantizedGemmBuffers& buffers, concurrency::ThreadPool* tp) {
+  // find the range of A including 0 so that 0 is exactly representable
+  float min = 0.f;
+  float max = 0.f;
+  for (int m = 0; m < M; ++m) {
+    const auto row = ConstEigenVectorMap<float>(A + m * lda, K);
+    min = std::min(min, row.minCoeff());
+    max = std::max(max, row.maxCoeff());
+  }
+
+  // A is all zeros (e.g. the initial hidden state) if the range is empty. any scale works.
+  float scale = (max - min) / 255.f;
+  if (scale == 0.f) {
+    scale = 1.f;
+  }
+  const uint8_t zero_point = static_cast<uint8_t>(std::nearbyint(std::max(0.f, std::min(255.f, -min / scale))));
+
+  buffers.quantized_A.resize(static_cast<size_t>(M) * K);
+  buffers.accumulators.resize(static_cast<size_t>(M) * N);
+
+  for (int m = 0; m < M; ++m) {
+    MlasQuantizeLinear(A + m * lda, buffers.quantized_A.data() + m * K, K, scale, zero_point);
+  }
+
+  MlasGemm(M, N, K, buffers.quantized_A.data(), K, zero_point, weights.weights, weights.ldb, weights.zero_points,
+           buffers.accumulators.data(), N, nullptr, tp);
+
+  const float output_scale = alpha * scale;
+  for (int m = 0; m < M; ++m) {
+    const int32_t* accumulators = buffers.accumulators.data() + m * N;
+    float* c = C + m * ldc;
+    for (int n = 0; n < N; ++n) {
+      const float value = output_scale * weights.scales[n] * static_cast<float>(accumulators[n]);
+      c[n] = beta == 0.f ? value : beta * c[n] + value;
+    }
+  }
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>>
     NameToArgUsageMap{{"affine", {1, 1}},
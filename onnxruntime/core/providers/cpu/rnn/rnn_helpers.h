@@ -18,6 +18,8 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/tensor_shape.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -174,6 +176,131 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// W or R weights of an RNN operator packed by MlasGemmPackB when the weights are a constant initializer.
+// The weights are [num_directions, rows, K]. The rows of each direction are split into blocks, and each block
+// is packed separately so it can be used as B (transposed) in ComputePackedGemm.
+struct PackedWeights {
+  BufferUniquePtr buffer_;
+  size_t buffer_size_per_direction_ = 0;
+  std::vector<size_t> block_offsets_;  // offset in bytes of each block within a direction
+  TensorShape shape_;
+
+  bool IsPacked(const TensorShape& shape) const { return buffer_ != nullptr && shape == shape_; }
+
+  const void* Block(int direction, int block) const {
+    return static_cast<const uint8_t*>(buffer_.get()) + direction * buffer_size_per_direction_ +
+           block_offsets_[block];
+  }
+};
+
+// Pack the float weights in blocks of block_rows rows. packed is left empty if the weights can not be packed.
+Status PackWeights(const Tensor& weights, int num_directions, const std::vector<int>& block_rows,
+                   const AllocatorPtr& allocator, PackedWeights& packed);
+
+// A has size M x K, B has size N x K (transposed) and was packed by PackWeights, and C has size M x N
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputePackedGemm(const int M,
+                       const int N,
+                       const int K,
+                       const float alpha,
+                       TSpanAIter A,
+                       TSpanAIter A_end,
+                       const int lda,
+                       const void* packed_B,
+                       const float beta,
+                       TSpanCIter C,
+                       TSpanCIter C_end,
+                       const int ldc, concurrency::ThreadPool* tp) {
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasGemm(CblasNoTrans, M, N, K, alpha, &*A, lda, packed_B, beta, &*C, ldc, tp);
+}
+
+// The int8 weights of one direction (or a block of its columns) of a quantized RNN operator, transposed to K x N
+// so they can be used as B in a QGEMM. There is a scale and zero point per column.
+struct QuantizedWeights {
+  const int8_t* weights = nullptr;
+  int ldb = 0;
+  const float* scales = nullptr;
+  const int8_t* zero_points = nullptr;
+};
+
+// The int8 weights of a quantized RNN operator transposed from [num_directions, N, K] to [num_directions, K, N].
+struct TransposedQuantizedWeights {
+  std::vector<int8_t> buffer_;
+  TensorShape shape_;  // the shape of the weights before they were transposed
+
+  bool IsTransposed(const TensorShape& shape) const { return !buffer_.empty() && shape == shape_; }
+};
+
+Status TransposeQuantizedWeights(const Tensor& weights, TransposedQuantizedWeights& transposed);
+
+// Get a scale and zero point for each of the N rows of each direction of the weights.
+// scale and zero_point are [num_directions] for per tensor quantization or [num_directions, N] for per channel
+// quantization. zero_point is optional and defaults to 0.
+Status GetWeightQuantizationParameters(const Tensor& scale, const Tensor* zero_point, int64_t num_directions,
+                                       int64_t N, std::vector<float>& scales, std::vector<int8_t>& zero_points);
+
+// Scratch buffers for ComputeQuantizedGemm. Reused across the steps of a sequence so they are only allocated once.
+struct QuantizedGemmBuffers {
+  std::vector<uint8_t> quantized_A;
+  std::vector<int32_t> accumulators;
+};
+
+// A is a float M x K matrix that is quantized to uint8 using its range. The QGEMM result is scaled back to float
+// and C = alpha * A * B + beta * C.
+void ComputeQuantizedGemm(int M, int N, int K, float alpha, const float* A, int lda,
+                          const QuantizedWeights& weights, float beta, float* C, int ldc,
+                          QuantizedGemmBuffers& buffers, concurrency::ThreadPool* tp);
+
+// The weights used as B in the GEMMs of an RNN operator. The weights are either float N x K weights that are used
+// transposed, optionally packed by PackWeights, or the quantized weights of a DynamicQuantize RNN operator.
+template <typename T>
+struct GemmWeights {
+  GemmWeights() = default;
+
+  GemmWeights(const gsl::span<const T>& weights, const void* packed = nullptr)
+      : weights_(weights), packed_(packed) {}
+
+  GemmWeights(const QuantizedWeights& quantized) : quantized_(quantized), is_quantized_(true) {}
+
+  gsl::span<const T> weights_;
+  const void* packed_ = nullptr;
+  QuantizedWeights quantized_{};
+  bool is_quantized_ = false;
+};
+
+// A has size M x K, B has size N x K (transposed), and C has size M x N
+template <typename T, typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const GemmWeights<T>& weights,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc,
+                 QuantizedGemmBuffers& quantized_buffers,
+                 concurrency::ThreadPool* tp) {
+  if (weights.is_quantized_) {
+    ORT_ENFORCE(lda >= K && ldc >= N);
+    ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+    ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+    ComputeQuantizedGemm(M, N, K, alpha, &*A, lda, weights.quantized_, beta, &*C, ldc, quantized_buffers, tp);
+  } else if (weights.packed_ != nullptr) {
+    ComputePackedGemm(M, N, K, alpha, A, A_end, lda, weights.packed_, beta, C, C_end, ldc, tp);
+  } else {
+    ComputeGemm(M, N, K, alpha, A, A_end, lda, weights.weights_.cbegin(), weights.weights_.cend(), K, beta,
+                C, C_end, ldc, tp);
+  }
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
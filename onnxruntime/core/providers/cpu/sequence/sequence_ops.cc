@@ -13,8 +13,8 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
-// TODO: The current implementation of sequence ops relies on tensor copies. Ideally we should try to avoid
-// these copies. This has been postponed due to lack of time.
+// The tensors of a sequence are immutable, so the ops that create a sequence from another one share its tensors
+// (see TensorSeq::Add) and only copy the tensors they take from outside the sequence.
 
 // SequenceLength
 ONNX_CPU_OPERATOR_KERNEL(
@@ -95,7 +95,7 @@ Status SequenceAt::Compute(OpKernelContext* context) const {
     input_seq_idx = static_cast<int64_t>(X->Size()) + input_seq_idx;
   }
   const Tensor& indexed_tensor = X->Get(input_seq_idx);
-  auto* Y = context->Output(0, indexed_tensor.Shape().GetDims());
+  auto* Y = context->Output(0, indexed_tensor.Shape());
   ORT_ENFORCE(Y != nullptr, "SequenceAt: Got nullptr for output tensor");
   CopyCpuTensor(&indexed_tensor, Y);
 
@@ -182,12 +182,12 @@ ONNX_CPU_OPERATOR_KERNEL(
                                  DataTypeImpl::GetTensorType<int64_t>()}),
     SequenceInsert);
 
-Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, OpKernelContext* context, std::vector<Tensor>& tensors) {
+Status CreateCopyAndAppendCpuTensor(const Tensor& in_tensor, OpKernelContext* context, TensorSeq& tensors) {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
   Tensor tmp(in_tensor.DataType(), onnxruntime::TensorShape(in_tensor.Shape()), alloc);
   CopyCpuTensor(&in_tensor, &tmp);
-  tensors.push_back(std::move(tmp));
+  tensors.Add(std::move(tmp));
   return Status::OK();
 }
 
@@ -222,23 +222,18 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
 
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceInsert: Got nullptr for output sequence");
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq + 1);
+  Y->SetType(S->DataType());
+  Y->Reserve(num_tensors_input_seq + 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
-      CreateCopyAndAppendCpuTensor(*X, context, tensors);
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
-    } else {
-      CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+      ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, *Y));
     }
+    Y->Add(*S, i);
   }
   if (input_seq_idx == num_tensors_input_seq + 1) {
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, *Y));
   }
 
-  Y->SetType(S->DataType());
-  Y->SetElements(std::move(tensors));
-
   return Status::OK();
 }
 
@@ -275,15 +270,13 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   auto* Y = context->Output<TensorSeq>(0);
   ORT_ENFORCE(Y != nullptr, "SequenceErase: Got nullptr for output sequence");
   Y->SetType(S->DataType());
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_tensors_input_seq - 1);
+  Y->Reserve(num_tensors_input_seq - 1);
   for (int i = 0; i < num_tensors_input_seq; ++i) {
     if (i == input_seq_idx) {
       continue;
     }
-    CreateCopyAndAppendCpuTensor(S->Get(i), context, tensors);
+    Y->Add(*S, i);
   }
-  Y->SetElements(std::move(tensors));
   return Status::OK();
 }
 
@@ -315,13 +308,11 @@ Status SequenceConstruct::Compute(OpKernelContext* context) const {
 
   // now copy the tensors to the output sequence
   Y->SetType(first_dtype);
-  std::vector<Tensor> tensors;
-  tensors.reserve(num_inputs);
+  Y->Reserve(num_inputs);
   for (int input_idx = 0; input_idx < num_inputs; ++input_idx) {
     const auto* X = context->Input<Tensor>(input_idx);
-    CreateCopyAndAppendCpuTensor(*X, context, tensors);
+    ORT_RETURN_IF_ERROR(CreateCopyAndAppendCpuTensor(*X, context, *Y));
   }
-  Y->SetElements(std::move(tensors));
   return Status::OK();
 }
 
@@ -499,9 +490,20 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
   // copy dimensions so we can update the selected axis in place
   auto& input_dims = input_shape.GetDims();
   std::vector<int64_t> output_dimensions{input_dims};
-  std::vector<Tensor> tensors;
   int64_t input_offset = 0;
   const T* input_data = input.template Data<T>();
+
+  // the outputs are views of a single buffer that holds them one after the other, so the split allocates once,
+  // and a ConcatFromSequence of the outputs can copy them as one block.
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
+  auto buffer = std::make_shared<Tensor>(input.DataType(), input_shape, alloc);
+  T* output_data = buffer->template MutableData<T>();
+
+  auto& tseq = *context.Output<TensorSeq>(0);
+  tseq.SetType(input.DataType());
+  tseq.Reserve(static_cast<size_t>(num_outputs));
+
   for (int i = 0; i < num_outputs; ++i) {
     // update size of dimension for axis we're splitting on while considering uneven split
     int split_size;
@@ -512,10 +514,10 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
     }
     output_dimensions[axis] = split_size;
 
-    AllocatorPtr alloc;
-    ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
-    Tensor output_tensor(input.DataType(), onnxruntime::TensorShape(output_dimensions), alloc);
-    T* output_data = output_tensor.template MutableData<T>();
+    // the view keeps the buffer alive for as long as a sequence holds it
+    std::shared_ptr<Tensor> output_tensor(
+        new Tensor(input.DataType(), onnxruntime::TensorShape(output_dimensions), output_data, alloc->Info()),
+        [buffer](Tensor* tensor) { delete tensor; });
 
     ::onnxruntime::math::CopyMatrix<T>(
         before_dims,                                       // M
@@ -529,6 +531,7 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
         });
 
     input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
+    output_data += before_dims * split_size * after_dims_excluding_split;
 
     // if keep_dims = 0, reshape the tensor by dropping the dimension corresponding to 'axis'
     if (use_keep_dims && keepdims_ == 0) {
@@ -539,17 +542,13 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
           new_dims.push_back(output_dimensions[idx]);
         }
       }
-      output_tensor.Reshape(new_dims);
+      output_tensor->Reshape(new_dims);
     }
 
-    // finally move the resulting tensor to the output sequence
-    tensors.push_back(std::move(output_tensor));
+    // finally add the resulting tensor to the output sequence
+    tseq.Add(std::move(output_tensor));
   }
 
-  auto& tseq = *context.Output<TensorSeq>(0);
-  tseq.SetType(input.DataType());
-  tseq.SetElements(std::move(tensors));
-
   return Status::OK();
 }
 }  // namespace onnxruntime
@@ -7,51 +7,97 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/Default/Half.h"
 #include "core/common/common.h"
-
-#if defined(_M_AMD64)
 #include "core/mlas/inc/mlas.h"
-#endif
+#include "core/platform/threadpool.h"
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 
+// Run fn(first, last) on blocks of the count elements across the intra-op thread pool.
+template <typename F>
+inline void ParallelCast(int64_t count, concurrency::ThreadPool* tp, F&& fn) {
+  // converting an element is about a load, a conversion and a store
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(count), 2.0, std::forward<F>(fn));
+}
+
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
-  output_vector = in_vector.template cast<DstType>();
+inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<SrcType>();
+  auto* out_data = out->template MutableData<DstType>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    auto in_vector = ConstEigenVectorMap<SrcType>(in_data + first, last - first);
+    auto output_vector = EigenVectorMap<DstType>(out_data + first, last - first);
+    output_vector = in_vector.template cast<DstType>();
+  });
+}
+
+template <>
+inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                       concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<float>();
+  auto* out_data = out->template MutableData<MLFloat16>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertFloatToHalfBuffer(in_data + first, &out_data[first].val, static_cast<size_t>(last - first));
+  });
+}
+
+template <>
+inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                       concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<MLFloat16>();
+  auto* out_data = out->template MutableData<float>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertHalfToFloatBuffer(&in_data[first].val, out_data + first, static_cast<size_t>(last - first));
+  });
+}
+
+// The 8-bit conversions saturate out of range values instead of leaving them undefined.
+template <>
+inline void CastData<float, int8_t>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                    concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<float>();
+  auto* out_data = out->template MutableData<int8_t>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertFloatToInt8Buffer(in_data + first, out_data + first, static_cast<size_t>(last - first));
+  });
+}
+
+template <>
+inline void CastData<float, uint8_t>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                     concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<float>();
+  auto* out_data = out->template MutableData<uint8_t>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertFloatToUInt8Buffer(in_data + first, out_data + first, static_cast<size_t>(last - first));
+  });
 }
 
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastData<int8_t, float>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                    concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<int8_t>();
+  auto* out_data = out->template MutableData<float>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertInt8ToFloatBuffer(in_data + first, out_data + first, static_cast<size_t>(last - first));
+  });
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastData<uint8_t, float>(const Tensor* in, Tensor* out, const TensorShape& shape,
+                                     concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<uint8_t>();
+  auto* out_data = out->template MutableData<float>();
+  ParallelCast(shape.Size(), tp, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    MlasConvertUInt8ToFloatBuffer(in_data + first, out_data + first, static_cast<size_t>(last - first));
+  });
 }
 
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
+inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator,
+                            concurrency::ThreadPool* tp) {
   ORT_ENFORCE(allocator != nullptr);
   const int64_t len = shape.Size();
   ORT_ENFORCE(len > 0);
@@ -59,11 +105,11 @@ inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& sh
   ORT_ENFORCE(buffer);
   Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info());
   if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
+    CastData<MLFloat16, float>(in, &tmp_tensor, shape, tp);  // first cast to float
+    CastData<float, DstType>(&tmp_tensor, out, shape, tp);   // then cast to the destination type.
   } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
+    CastData<SrcType, float>(in, &tmp_tensor, shape, tp);
+    CastData<float, MLFloat16>(&tmp_tensor, out, shape, tp);
   }
   allocator->Free(buffer);
 }
@@ -176,8 +222,8 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
+  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) const {
+    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape, tp);
   }
 
   template <typename SrcType,
@@ -185,7 +231,7 @@ class Cast final : public OpKernel {
   Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
+    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator, context->GetOperatorThreadPool());
     return Status::OK();
   }
 
@@ -225,7 +271,10 @@ const std::vector<MLDataType> castOpTypeConstraints{
       6,                                                                                                                           \
       9,                                                                                                                           \
       in_type,                                                                                                                     \
-      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
+      KernelDefBuilder()                                                                                                           \
+          .MayInplace(0, 0)                                                                                                        \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>())                                                            \
+          .TypeConstraint("T2", castOpTypeConstraints),                                                                            \
       Cast<in_type>);                                                                                                              \
                                                                                                                                    \
   template <>                                                                                                                      \
@@ -233,44 +282,45 @@ const std::vector<MLDataType> castOpTypeConstraints{
     const Tensor* X = context->Input<Tensor>(0);                                                                                   \
     const TensorShape& shape = X->Shape();                                                                                         \
     Tensor* Y = context->Output(0, TensorShape(shape));                                                                            \
+    concurrency::ThreadPool* tp = context->GetOperatorThreadPool();                                                                \
                                                                                                                                    \
     switch (to_) {                                                                                                                 \
       case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
+        CastData<in_type, bool>(X, Y, shape, tp);                                                                                  \
         break;                                                                                                                     \
       case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int16_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int32_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int64_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, uint8_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint16_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint32_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint64_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
+        CastData<in_type, float>(X, Y, shape, tp);                                                                                 \
         break;                                                                                                                     \
       case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
+        CastData<in_type, double>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
+        CastData<in_type, int8_t>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT16:                                                                                           \
         if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
+          CastData<float, MLFloat16>(X, Y, shape, tp);                                                                             \
         } else {                                                                                                                   \
           auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
           if (!st.IsOK()) return st;                                                                                               \
@@ -304,7 +354,10 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     6,
     9,
     MLFloat16,
-    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>())
+        .TypeConstraint("T2", castOpTypeConstraints),
     Cast<MLFloat16>);
 
 template <>
@@ -339,7 +392,7 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(X, Y, shape, context->GetOperatorThreadPool());
       break;
     case TensorProto_DataType_FLOAT16: {
       auto X_type = X->DataType();
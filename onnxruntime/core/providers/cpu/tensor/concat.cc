@@ -4,6 +4,7 @@
 #include "core/providers/cpu/tensor/concat.h"
 #include "core/providers/common.h"
 #include "core/framework/TensorSeq.h"
+#include "core/framework/packed_strings.h"
 
 namespace onnxruntime {
 
@@ -11,14 +12,14 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Concat,
     4,
     10,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).PackedStringInputs(),
     Concat);
 
 // Opset 11 starts to support Neg Axis.
 ONNX_CPU_OPERATOR_KERNEL(
     Concat,
     11,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).PackedStringInputs(),
     Concat);
 
 // this method will be shared between 'Concat' (CPU and GPU) and 
@@ -103,10 +104,19 @@ Status ConcatBase::PrepareForCompute(OpKernelContext* ctx,
     output_dims.insert(output_dims.begin() + p.axis, static_cast<int64_t>(input_count));
   }
 
-  TensorShape output_shape(output_dims);
+  const TensorShape output_shape(output_dims);
 
-  // Create output tensor
-  p.output_tensor = &(*ctx->Output(0, output_shape));
+  // Create output tensor. A string output may be in the packed layout, which is sized by the number of characters.
+  if (input_tensors[0]->IsDataTypeString()) {
+    size_t num_chars = 0;
+    for (const Tensor* input : input_tensors) {
+      ORT_RETURN_IF_NOT(input->IsDataTypeString());
+      num_chars += StringTensorLength(*input);
+    }
+    p.output_tensor = ctx->OutputPackedStrings(0, output_shape, num_chars);
+  } else {
+    p.output_tensor = &(*ctx->Output(0, output_shape));
+  }
 
   // Make note if output tensor is going to be empty
   p.output_num_elements = output_shape.Size();
@@ -151,11 +161,52 @@ Status ConcatBase::PrepareForCompute(OpKernelContext* ctx,
   return Status::OK();
 }
 
+// Strings are written in the order of the output, as the packed layout requires, a block of each input at a time.
+static void ConcatStrings(const Prepare& p) {
+  std::vector<StringTensorReader> readers;
+  readers.reserve(p.inputs.size());
+  for (const auto& prep : p.inputs) {
+    readers.emplace_back(*prep.tensor);
+  }
+
+  StringTensorWriter writer(*p.output_tensor);
+  for (int64_t outer = 0, end = p.output_num_elements / p.output_axis_pitch; outer < end; ++outer) {
+    for (size_t input_index = 0; input_index < p.inputs.size(); ++input_index) {
+      const auto& prep = p.inputs[input_index];
+      if (prep.num_elements == 0)
+        continue;
+
+      const auto begin = static_cast<size_t>(outer * prep.axis_pitch);
+      writer.Append(readers[input_index], begin, begin + static_cast<size_t>(prep.axis_pitch));
+    }
+  }
+}
+
 // This method computes the output tensor for Concat/ConcatFromSequence ops
 Status ConcatBase::ComputeImpl(Prepare& p) const {
+  if (p.is_string_type) {
+    ConcatStrings(p);
+    return Status::OK();
+  }
+
   int input_count = static_cast<int>(p.inputs.size());
   int64_t initial_output_offset = 0;  // initial offset for each input
   auto element_bytes = p.output_tensor->DataType()->Size();
+  uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+
+  // inputs that are copied as a single block (concatenating on axis 0, stacking on axis 0 or stacking scalars)
+  // and that are adjacent in memory, like the tensors of a sequence created by SplitToSequence, are merged into
+  // one copy.
+  const uint8_t* pending_input = nullptr;
+  uint8_t* pending_output = nullptr;
+  size_t pending_bytes = 0;
+  auto flush_pending = [&]() {
+    if (pending_bytes != 0) {
+      memcpy(pending_output, pending_input, pending_bytes);
+      pending_bytes = 0;
+    }
+  };
+
   for (int input_index = 0; input_index < input_count; input_index++) {
     const auto& prep = p.inputs[input_index];
 
@@ -168,28 +219,36 @@ Status ConcatBase::ComputeImpl(Prepare& p) const {
 
     auto input_size = prep.num_elements;
 
+    // the producer of the input may have written it directly into its place in the output
+    // (see AllocPlanPerValue::container), in which case there is nothing to copy
+    if (input_size == input_axis_pitch && input == output + initial_output_offset * element_bytes) {
+      initial_output_offset += input_axis_pitch;
+      continue;
+    }
+
+    if (input_size == input_axis_pitch) {
+      uint8_t* block_output = output + initial_output_offset * element_bytes;
+      if (pending_bytes == 0 || pending_input + pending_bytes != input ||
+          pending_output + pending_bytes != block_output) {
+        flush_pending();
+        pending_input = input;
+        pending_output = block_output;
+      }
+      pending_bytes += input_size * element_bytes;
+      initial_output_offset += input_axis_pitch;
+      continue;
+    }
+
+    flush_pending();
+
     // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
-    // TODO: Optimization possibility: There are cases where we simply need to "merge" raw buffers and this 
-    // could be done without the pointer house-keeping as below. Some scenarios whether this is possible are:
-    // 1) Concatenating on input axis = 0
-    // 2) Stacking on output axis = 0
-    // 3) Stacking scalars
-    uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
     int64_t cur_out_offset = 0;
     int64_t cur_in_offset = 0;
     for (size_t idx_copy = 0, end = input_size / input_axis_pitch; idx_copy < end; ++idx_copy) {
-      if (p.is_string_type) {
-        size_t out = initial_output_offset + cur_out_offset;
-        for (int idx_item = 0; idx_item < input_axis_pitch; ++idx_item) {
-          reinterpret_cast<std::string*>(output)[out + idx_item] =
-              reinterpret_cast<const std::string*>(input)[cur_in_offset + idx_item];
-        }
-      } else {
-        memcpy(
-            output + (initial_output_offset + cur_out_offset) * element_bytes,
-            input + cur_in_offset * element_bytes,
-            input_axis_pitch * element_bytes);
-      }
+      memcpy(
+          output + (initial_output_offset + cur_out_offset) * element_bytes,
+          input + cur_in_offset * element_bytes,
+          input_axis_pitch * element_bytes);
 
       cur_out_offset += p.output_axis_pitch;
       cur_in_offset += input_axis_pitch;
@@ -198,6 +257,8 @@ Status ConcatBase::ComputeImpl(Prepare& p) const {
     initial_output_offset += input_axis_pitch;
   }
 
+  flush_pending();
+
   return Status::OK();
 }
 
@@ -5,6 +5,8 @@
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include <cmath>
 #include <cfenv>
 
@@ -18,6 +20,9 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
     DynamicQuantizeLinear<uint8_t>);
 
+// number of elements each thread finds the range of and quantizes at a time
+static constexpr std::ptrdiff_t kQuantizeBlockSize = 16384;
+
 static float RoundHalfToEven(float input) {
   std::fesetround(FE_TONEAREST);
   auto result = std::nearbyintf(input);
@@ -31,7 +36,7 @@ Status DynamicQuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   ORT_ENFORCE(x_ptr != nullptr);
   auto& x = *x_ptr;
   const auto* x_data = x.template Data<float>();
-  const auto num_of_elements = x.Shape().Size();
+  const auto num_of_elements = static_cast<std::ptrdiff_t>(x.Shape().Size());
 
   auto& y = *ctx->Output(0, x.Shape());
   std::vector<int64_t> shape({});
@@ -46,11 +51,27 @@ Status DynamicQuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
     qmin = -127;
   }
 
-  // find input range min and max
-  auto min = ConstEigenVectorMap<float>(x_data, num_of_elements).minCoeff();
-  min = std::min(min, qmin);
-  auto max = ConstEigenVectorMap<float>(x_data, num_of_elements).maxCoeff();
-  max = std::max(max, qmin);
+  // find input range min and max. each thread finds the range of a block of elements.
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const std::ptrdiff_t block_count = (num_of_elements + kQuantizeBlockSize - 1) / kQuantizeBlockSize;
+  std::vector<float> block_min(static_cast<size_t>(block_count), qmin);
+  std::vector<float> block_max(static_cast<size_t>(block_count), qmin);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, block_count, static_cast<double>(kQuantizeBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const std::ptrdiff_t begin = block * kQuantizeBlockSize;
+          const size_t count = static_cast<size_t>(std::min(kQuantizeBlockSize, num_of_elements - begin));
+          float block_min_value, block_max_value;
+          MlasFindMinMaxElement(x_data + begin, &block_min_value, &block_max_value, count);
+          block_min[block] = std::min(block_min[block], block_min_value);
+          block_max[block] = std::max(block_max[block], block_max_value);
+        }
+      });
+
+  // the range includes qmin, which is 0 for uint8, so that 0 is exactly representable
+  auto min = block_count > 0 ? *std::min_element(block_min.begin(), block_min.end()) : qmin;
+  auto max = block_count > 0 ? *std::max_element(block_max.begin(), block_max.end()) : qmin;
 
   // find scale and zero point
   auto scale = (max - min) / (qmax - qmin);
@@ -64,7 +85,15 @@ Status DynamicQuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
 
   // quantize the data
   auto* output = y.template MutableData<T>();
-  MlasQuantizeLinear(x_data, output, num_of_elements, scale, zero_point);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, block_count, static_cast<double>(kQuantizeBlockSize),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const std::ptrdiff_t begin = block * kQuantizeBlockSize;
+          const size_t count = static_cast<size_t>(std::min(kQuantizeBlockSize, num_of_elements - begin));
+          MlasQuantizeLinear(x_data + begin, output + begin, count, scale, zero_point);
+        }
+      });
 
   return Status::OK();
 }
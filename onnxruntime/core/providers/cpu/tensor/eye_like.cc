@@ -53,13 +53,13 @@ Status EyeLike::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status EyeLike::ComputeImpl(OpKernelContext* context, const Tensor* T1) const {
-  const std::vector<int64_t>& input_dims = T1->Shape().GetDims();
+  const auto& input_dims = T1->Shape().GetDims();
   if (input_dims.size() != 2) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "EyeLike : Input tensor dimension is not 2");
   }
 
   // set output tensor shape same as input tensor and set all values to zero
-  auto* T2 = context->Output(0, input_dims);
+  auto* T2 = context->Output(0, T1->Shape());
   auto output_mat = EigenMatrixMapRowMajor<T>(
       T2->template MutableData<T>(),
       input_dims[0],
@@ -4,6 +4,12 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
 #include "core/common/common.h"
+#include "core/framework/packed_strings.h"
+#include "core/platform/threadpool.h"
+
+#if !defined(__GNUC__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace onnxruntime {
 
@@ -14,7 +20,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
-                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+                                                        DataTypeImpl::GetTensorType<int64_t>()})
+        .PackedStringInputs(),
     Gather);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -23,7 +30,8 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
-                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+                                                        DataTypeImpl::GetTensorType<int64_t>()})
+        .PackedStringInputs(),
     Gather);
 
 Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const {
@@ -48,20 +56,32 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   for (int64_t i = p.axis + 1; i < static_cast<int64_t>(input_rank); ++i)
     shape.push_back(input_data_shape[i]);
 
-  p.output_tensor = context->Output(0, TensorShape(std::move(shape)));
+  p.output_shape = TensorShape(std::move(shape));
+  p.output_tensor = p.input_tensor->IsDataTypeString() ? nullptr : context->Output(0, p.output_shape);
 
   return Status::OK();
 }
 
+// Prefetch the start of a row of the data. The indices of embedding lookups are usually random, so the hardware
+// prefetcher can't predict the next row.
+static inline void PrefetchRow(const uint8_t* row) {
+#if defined(__GNUC__)
+  __builtin_prefetch(row);
+#elif defined(_M_X64) || defined(_M_IX86)
+  _mm_prefetch(reinterpret_cast<const char*>(row), _MM_HINT_T0);
+#else
+  ORT_UNUSED_PARAMETER(row);
+#endif
+}
+
 template <typename Tin>
-Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
-                      const size_t element_bytes, const int64_t block_size, const int64_t M,
+Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base,
+                      const int64_t block_size, const int64_t M,
                       const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const TensorShape& input_data_shape, const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
   // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
   auto axis_dim_limit = input_data_shape[axis];
 
   for (int64_t i = 0; i < N; ++i) {
@@ -73,25 +93,88 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
+  auto normalized_index = [indices_data, axis_dim_limit](int64_t i) -> int64_t {
+    const int64_t idx = indices_data[i];
+    return idx < 0 ? idx + axis_dim_limit : idx;
+  };
+
+  // number of indices ahead of the current one whose rows are prefetched. it only pays off for rows that are too
+  // large to be copied from the same few cache lines as their neighbours.
+  constexpr int64_t kPrefetchDistance = 4;
+  const bool prefetch = block_size >= 64;
+
+  // each unit of work is one index of one batch
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(M * N), static_cast<double>(block_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        int64_t index = first;
+        while (index < last) {
+          const int64_t batch = index / N;
+          const int64_t i = index % N;
+          const uint8_t* src_batch = src_base + batch * data_batch_bytes;
+          const int64_t idx = normalized_index(i);
+
+          // consecutive indices are copied as one range, which covers Gather being used to slice the data
+          int64_t run = 1;
+          const int64_t max_run = std::min<int64_t>(N - i, last - index);
+          while (run < max_run && normalized_index(i + run) == idx + run) {
+            ++run;
+          }
+
+          if (prefetch && i + kPrefetchDistance < N) {
+            PrefetchRow(src_batch + normalized_index(i + kPrefetchDistance) * block_size);
+          }
+
+          const int64_t src_offset = batch * data_batch_bytes + idx * block_size;
+          const int64_t dst_offset = batch * gathered_batch_bytes + i * block_size;
+
+          memcpy(dst_base + dst_offset, src_base + src_offset, run * block_size);
+
+          index += run;
+        }
+      });
 
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
+  return Status::OK();
+}
+
+// Strings are gathered in two passes, the first sizes the output, which is in the packed layout if the plan allows it.
+template <typename Tin>
+Status GatherStrings(OpKernelContext* context, const Tensor& input_tensor, const Tensor& indices_tensor,
+                     const TensorShape& output_shape, const int64_t axis) {
+  const TensorShape& input_data_shape = input_tensor.Shape();
+  const Tin* indices_data = indices_tensor.Data<Tin>();
+  const int64_t axis_dim_limit = input_data_shape[axis];
+  const int64_t N = indices_tensor.Shape().Size();
+  const int64_t M = input_data_shape.SizeToDimension(axis);
+  const int64_t block = input_data_shape.SizeFromDimension(axis + 1);
+  const int64_t data_batch = input_data_shape.SizeFromDimension(axis);
+
+  std::vector<int64_t> indices(static_cast<size_t>(N));
+  for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+    if (idx < -axis_dim_limit || idx >= axis_dim_limit) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -axis_dim_limit, ",", axis_dim_limit - 1, "]");
+    }
+    indices[i] = idx < 0 ? idx + axis_dim_limit : idx;
+  }
+
+  StringTensorReader reader(input_tensor);
+  size_t num_chars = 0;
+  for (int64_t batch = 0; batch < M; ++batch) {
+    for (int64_t idx : indices) {
+      const auto start = static_cast<size_t>(batch * data_batch + idx * block);
+      num_chars += reader.Length(start, start + static_cast<size_t>(block));
+    }
+  }
+
+  Tensor* output_tensor = context->OutputPackedStrings(0, output_shape, num_chars);
+  StringTensorWriter writer(*output_tensor);
+  for (int64_t batch = 0; batch < M; ++batch) {
+    for (int64_t idx : indices) {
+      const auto start = static_cast<size_t>(batch * data_batch + idx * block);
+      writer.Append(reader, start, start + static_cast<size_t>(block));
     }
   }
 
@@ -102,9 +185,17 @@ Status Gather::Compute(OpKernelContext* context) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
 
-  const TensorShape& input_data_shape = p.input_tensor->Shape();
+  if (p.input_tensor->IsDataTypeString()) {
+    if (p.indices_tensor->IsDataType<int32_t>()) {
+      return GatherStrings<int32_t>(context, *p.input_tensor, *p.indices_tensor, p.output_shape, p.axis);
+    }
+    if (p.indices_tensor->IsDataType<int64_t>()) {
+      return GatherStrings<int64_t>(context, *p.input_tensor, *p.indices_tensor, p.output_shape, p.axis);
+    }
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
+  }
 
-  bool is_string_type = p.input_tensor->IsDataTypeString();
+  const TensorShape& input_data_shape = p.input_tensor->Shape();
 
   const size_t element_bytes = p.input_tensor->DataType()->Size();
   const int64_t block = input_data_shape.SizeFromDimension(p.axis + 1);
@@ -118,12 +209,12 @@ Status Gather::Compute(OpKernelContext* context) const {
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
   if (p.indices_tensor->IsDataType<int32_t>()) {
-    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+    return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   context->GetOperatorThreadPool());
   }
   if (p.indices_tensor->IsDataType<int64_t>()) {
-    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+    return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   context->GetOperatorThreadPool());
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
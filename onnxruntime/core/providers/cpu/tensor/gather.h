@@ -18,7 +18,9 @@ class GatherBase {
   struct Prepare {
     const Tensor* input_tensor;
     const Tensor* indices_tensor;
+    // nullptr for strings, whose output is created once their length is known
     Tensor* output_tensor;
+    TensorShape output_shape;
     int64_t axis;
   };
 
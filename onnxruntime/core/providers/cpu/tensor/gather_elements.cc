@@ -2,7 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gather_elements.h"
-#include "onnxruntime_config.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -76,131 +76,109 @@ static inline void increment_over_inner_dim(std::vector<int64_t>& current_dims,
   }
 }
 
-// parse indices_tensor and along the way validate its shape and contents
-static std::vector<int64_t> parse_and_validate_indices_tensor(const Tensor* indices_tensor,
-                                                              int64_t axis, const TensorShape& input_shape) {
-  // first parse 'indices' data
-  auto num_elements = indices_tensor->Shape().Size();
-  std::vector<int64_t> indices_data;
-  // reserving memory ahead as we know the size of the container
-  indices_data.reserve(num_elements);
-  if (indices_tensor->IsDataType<int32_t>()) {
-    const auto* data = indices_tensor->Data<int32_t>();
-    for (int64_t i = 0; i < num_elements; ++i)
-      indices_data.push_back(data[i]);
-  } else if (indices_tensor->IsDataType<int64_t>()) {
-    const auto* data = indices_tensor->Data<int64_t>();
-    for (int64_t i = 0; i < num_elements; ++i)
-      indices_data.push_back(data[i]);
-  } else {
-    ORT_THROW("GatherElements op: Data type for 'indices' tensor must be 'int32_t' and 'int64_t'");
-  }
+// validate the contents of indices_tensor
+template <typename Tind>
+static void validate_indices_tensor(const Tensor* indices_tensor, int64_t axis, const TensorShape& input_shape) {
+  const auto num_elements = indices_tensor->Shape().Size();
+  const Tind* indices_data = indices_tensor->Data<Tind>();
 
-  // validate 'indices' data
-  // along the way 'fix' negative index values if within bounds
   int64_t lower_index_limit = -input_shape[axis];
   int64_t upper_index_limit = input_shape[axis] - 1;
 
   for (int64_t i = 0; i < num_elements; ++i) {
-    auto indices_val = indices_data[i];
+    auto indices_val = static_cast<int64_t>(indices_data[i]);
     if (indices_val < lower_index_limit || indices_val > upper_index_limit)
       ORT_THROW("GatherElements op: Value in indices must be within bounds [",
                 lower_index_limit, " , ", upper_index_limit, "]. Actual value is ", indices_val);
-
-    if (indices_val < 0)
-      indices_data[i] += input_shape[axis];
   }
-
-  return indices_data;
 }
 
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#ifdef HAS_CLASS_MEMACCESS
-#pragma GCC diagnostic ignored "-Wclass-memaccess"
-#endif
-#endif
-template <bool is_string, typename T>
+// T is the element type for strings, or an unsigned integer of the size of the element for everything else,
+// so the values are copied with a plain assignment instead of a memcpy of a runtime size
+template <typename T, typename Tind>
 static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
-                      Tensor* output_tensor, int64_t axis) {
-  // get pointer to input data
-  // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-  const T* input_data = nullptr;
-  if (is_string) {
-    input_data = input_tensor->Data<T>();
-  } else {
-    input_data = reinterpret_cast<const T*>(input_tensor->DataRaw());
-  }
-
-  // get pointer to output data
-  // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-  T* output_data = nullptr;
-  if (is_string) {
-    output_data = output_tensor->MutableData<T>();
-  } else {
-    output_data = reinterpret_cast<T*>(output_tensor->MutableDataRaw());
-  }
+                      Tensor* output_tensor, int64_t axis, concurrency::ThreadPool* tp) {
+  const T* input_data = reinterpret_cast<const T*>(input_tensor->DataRaw());
+  T* output_data = reinterpret_cast<T*>(output_tensor->MutableDataRaw());
 
   const int64_t input_rank = static_cast<int64_t>(input_tensor->Shape().NumDimensions());
   const TensorPitches input_shape_pitches(*input_tensor);
 
-  const std::vector<int64_t>& indices_data = parse_and_validate_indices_tensor(indices_tensor, axis, input_tensor->Shape());
+  validate_indices_tensor<Tind>(indices_tensor, axis, input_tensor->Shape());
+  const Tind* indices_data = indices_tensor->Data<Tind>();
   const TensorShape& indices_shape = indices_tensor->Shape();
 
-  int64_t num_inner_dim = calculate_num_inner_dim(indices_shape);
-  int64_t inner_dim_size = indices_shape[input_rank - 1];
-  bool processing_inner_dim = (axis == input_rank - 1) ? true : false;
+  const int64_t num_inner_dim = calculate_num_inner_dim(indices_shape);
+  const int64_t inner_dim_size = indices_shape[input_rank - 1];
+  const bool processing_inner_dim = (axis == input_rank - 1) ? true : false;
+  const int64_t axis_dim = input_tensor->Shape()[axis];
+  const int64_t axis_pitch = input_shape_pitches[axis];
+
+  // each unit of work is one chunk of 'inner dimension' length
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_inner_dim), static_cast<double>(inner_dim_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // position of the first chunk in the outer dimensions of 'indices'
+        std::vector<int64_t> process_dims(input_rank, 0);
+        int64_t remaining = first;
+        for (int64_t i = input_rank - 2; i >= 0; --i) {
+          process_dims[i] = remaining % indices_shape[i];
+          remaining /= indices_shape[i];
+        }
 
-  int64_t base_offset = 0;
-  int64_t indices_counter = -1;
-  int64_t output_counter = -1;
-  size_t element_size = input_tensor->DataType()->Size();
-
-  std::vector<int64_t> process_dims(input_rank, 0);
-
-  if (!processing_inner_dim) {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
-
-      // process 1 chunk of 'inner dimension' length
-      for (int64_t i = 0; i < inner_dim_size; ++i) {
-        // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-        if (is_string) {
-          output_data[++output_counter] = input_data[base_offset + (indices_data[++indices_counter] * input_shape_pitches[axis]) + i];
-        } else {
-          memcpy(output_data,
-                 input_data + (base_offset + (indices_data[++indices_counter] * input_shape_pitches[axis]) + i) * element_size, element_size);
-          output_data += element_size;
+        for (std::ptrdiff_t chunk = first; chunk < last; ++chunk) {
+          const int64_t base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
+          const Tind* chunk_indices = indices_data + chunk * inner_dim_size;
+          T* chunk_output = output_data + chunk * inner_dim_size;
+          const T* input_row = input_data + base_offset;
+
+          // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
+          if (processing_inner_dim) {
+            // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
+            for (int64_t i = 0; i < inner_dim_size; ++i) {
+              const int64_t index = static_cast<int64_t>(chunk_indices[i]);
+              chunk_output[i] = input_row[index < 0 ? index + axis_dim : index];
+            }
+          } else {
+            for (int64_t i = 0; i < inner_dim_size; ++i) {
+              const int64_t index = static_cast<int64_t>(chunk_indices[i]);
+              chunk_output[i] = input_row[(index < 0 ? index + axis_dim : index) * axis_pitch + i];
+            }
+          }
+
+          increment_over_inner_dim(process_dims, indices_shape);
         }
-      }
+      });
+}
 
-      increment_over_inner_dim(process_dims, indices_shape);
-    }
+template <typename Tind>
+static Status dispatch_on_element_size(const Tensor* input_tensor, const Tensor* indices_tensor,
+                                       Tensor* output_tensor, int64_t axis, concurrency::ThreadPool* tp) {
+  if (input_tensor->IsDataTypeString()) {
+    core_impl<std::string, Tind>(input_tensor, indices_tensor, output_tensor, axis, tp);
+    return Status::OK();
   }
-  // we special-case inner dim as we can weed-out some unnecessary computations in element offset calculations
-  else {
-    while (num_inner_dim-- != 0) {
-      base_offset = compute_base_offset(process_dims, input_shape_pitches, axis);
-
-      // process 1 chunk of 'inner dimension' length
-      for (int64_t i = 0; i < inner_dim_size; ++i) {
-        // for innermost axis, input_shape_pitches[axis] = 1 (so no need to multiply)
-        // optimizer will remove the redundant if/else block based on 'is_string' template parameter
-        if (is_string) {
-          output_data[++output_counter] = input_data[base_offset + indices_data[++indices_counter]];
-        } else {
-          memcpy(output_data, input_data + (base_offset + indices_data[++indices_counter]) * element_size, element_size);
-          output_data += element_size;
-        }
-      }
 
-      increment_over_inner_dim(process_dims, indices_shape);
-    }
+  switch (input_tensor->DataType()->Size()) {
+    case sizeof(uint8_t):
+      core_impl<uint8_t, Tind>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint16_t):
+      core_impl<uint16_t, Tind>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint32_t):
+      core_impl<uint32_t, Tind>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    case sizeof(uint64_t):
+      core_impl<uint64_t, Tind>(input_tensor, indices_tensor, output_tensor, axis, tp);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "GatherElements op: element size of ",
+                             input_tensor->DataType()->Size(), " is not supported");
   }
+
+  return Status::OK();
 }
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
 
 Status GatherElements::ValidateInputShapes(const TensorShape& input_data_shape,
                                            const TensorShape& indices_shape,
@@ -261,13 +239,15 @@ Status GatherElements::Compute(OpKernelContext* context) const {
     return Status::OK();
 
 
-  if (input_tensor->IsDataTypeString())
-    core_impl<true, std::string>(input_tensor, indices_tensor, output_tensor, axis);
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  if (indices_tensor->IsDataType<int32_t>())
+    return dispatch_on_element_size<int32_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
 
-  else
-    core_impl<false, int8_t>(input_tensor, indices_tensor, output_tensor, axis);
+  if (indices_tensor->IsDataType<int64_t>())
+    return dispatch_on_element_size<int64_t>(input_tensor, indices_tensor, output_tensor, axis, tp);
 
-  return Status::OK();
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                         "GatherElements op: Data type for 'indices' tensor must be 'int32_t' and 'int64_t'");
 }
 
 }  // namespace onnxruntime
@@ -26,7 +26,7 @@ ONNX_CPU_OPERATOR_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Identity,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).Alias(0, 0).PackedStringInputs(),
     IdentityOp<false>);
 
 }  // namespace onnxruntime
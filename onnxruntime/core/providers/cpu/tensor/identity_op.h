@@ -12,6 +12,7 @@
 #pragma warning(pop)
 #endif
 #include "core/framework/op_kernel.h"
+#include "core/framework/packed_strings.h"
 
 namespace onnxruntime {
 
@@ -25,7 +26,8 @@ class IdentityOp final : public OpKernel {
     const auto* X = context->Input<Tensor>(0);
     ORT_ENFORCE(X != nullptr);
     const TensorShape& shape = X->Shape();
-    Tensor* Y = context->Output(0, shape);
+    Tensor* Y = X->IsDataTypeString() ? context->OutputPackedStrings(0, shape, StringTensorLength(*X))
+                                      : context->Output(0, shape);
     auto X_type = X->DataType();
 
     const void* source = X->DataRaw(X_type);
@@ -35,10 +37,9 @@ class IdentityOp final : public OpKernel {
       if (!X->IsDataTypeString()) {
         memcpy(target, source, shape.Size() * X_type->Size());
       } else {
-        // handle std::string
-        const auto* src = X->template Data<std::string>();
-        auto* dst = Y->template MutableData<std::string>();
-        std::copy(src, src + shape.Size(), dst);
+        // handle strings, in either layout
+        StringTensorReader reader(*X);
+        StringTensorWriter(*Y).Append(reader, 0, reader.Size());
       }
     }
 
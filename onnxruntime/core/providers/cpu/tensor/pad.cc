@@ -8,6 +8,11 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/providers/cpu/tensor/pad.h"
+
+#include <functional>
+#include <numeric>
+
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -67,15 +72,14 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     int64_t,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<int64_t>()), Pad<int64_t>);
 
-// This is the general padding method to n-dimensionally do edge or reflection padding (based on the inputDelta values)
+// This is the general padding method to n-dimensionally do edge or reflection padding of an outer axis. Each block
+// is a whole row of the output, so it's copied at once. input_pitch moves to the next row to copy after each block.
 template <typename T>
-static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
+static void PadAxis(T* output, const T* input, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
   for (size_t block_index = 0; block_index < block_count; block_index++) {
-    for (size_t i = 0; i < block_size; i++) {
-      *output++ = *input;
-      input += input_delta;
-    }
-    input += input_pitch;
+    memcpy(output, input, block_size * sizeof(T));
+    output += block_size;
+    input += block_size + input_pitch;
   }
 }
 
@@ -92,8 +96,7 @@ static void PadInnermostAxis(T* output, T* input, ptrdiff_t input_delta, size_t
 // For constant padding, there is no input, just a size to write the constant to
 template <typename T>
 static void PadAxisConstant(T* output, T constant, size_t size) {
-  for (size_t i = 0; i < size; i++)
-    *output++ = constant;
+  std::fill_n(output, size, constant);
 }
 
 Status PadBase::HandleDimValueZero(const Mode& mode, const TensorShape& input_shape, TensorShape& output_shape) {
@@ -191,71 +194,49 @@ static void ReshapePads(const std::vector<int64_t>& src_pad, size_t src_dim_coun
   reshaped_pad[inner_axis + new_dim_count] = src_pad[inner_axis + src_dim_count] * inner_no_pad_size;
 }
 
-template <typename T>
-Status PadCpuImpl(OpKernelContext* ctx,
-                  const std::vector<int64_t>& pads,
-                  const std::vector<int64_t>& slices,
-                  const Mode& mode,
-                  T value) {
-  const auto& input_tensor = *ctx->Input<Tensor>(0);
-  const auto& orig_input_shape = input_tensor.Shape();
-  std::vector<int64_t> output_dims(orig_input_shape.GetDims());
-  size_t data_rank = output_dims.size();
-
-  // make copy of raw_pads as it may be mutated below
-  ORT_ENFORCE(data_rank > 0, "Input tensor has no dimensions");
-  ORT_ENFORCE(data_rank * 2 == pads.size(), "'pads' has wrong number of values");
-
-  // Reshape input dims
-  std::vector<int64_t> reshaped_input_dims;
-  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
-
-  // Reshape padding
-  size_t new_dims_count = reshaped_input_dims.size();
-  size_t inner_axis = new_dims_count - 1;
-  size_t inner_no_pad_size = output_dims[inner_axis] > 0 ? reshaped_input_dims[inner_axis] / output_dims[inner_axis] : 0;
-  std::vector<int64_t> reshaped_pad(2 * new_dims_count), reshaped_slice(2 * new_dims_count);
-  ReshapePads(pads, data_rank, new_dims_count, inner_no_pad_size, reshaped_pad);
-  ReshapePads(slices, data_rank, new_dims_count, inner_no_pad_size, reshaped_slice);
-
-  std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
-  std::vector<int64_t> input_starts;
-  std::vector<int64_t> input_extents;
-
-  // Calculate output dimensions, and handle any negative padding
-  input_starts.reserve(new_dims_count);
-  input_extents.reserve(new_dims_count);
-  for (size_t i = 0; i < new_dims_count; i++) {
-    input_starts.push_back(-1 * reshaped_slice[i]);
-    input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
-    reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
+// Flatten the outer axes that have no padding, so the blocks along the first axis can be padded in parallel.
+// For example, a shape of [2,3,224,224] with padding [0,0,1,1,0,0,1,1] can be flattened to [6,224,224] with
+// padding [0,1,1,0,1,1].
+static void FlattenOuterShape(std::vector<int64_t>& dims, std::vector<int64_t>& pads, std::vector<int64_t>& slices) {
+  const size_t dims_count = dims.size();
+  size_t outer_count = 0;
+  while (outer_count + 1 < dims_count &&
+         pads[outer_count] == 0 && pads[outer_count + dims_count] == 0 &&
+         slices[outer_count] == 0 && slices[outer_count + dims_count] == 0) {
+    ++outer_count;
   }
 
-  for (size_t i = 0; i < data_rank; i++) {
-    output_dims[i] += pads[i] + pads[i + data_rank] + slices[i] + slices[i + data_rank];
+  if (outer_count < 2) {
+    return;
   }
 
-  // special case an input with one or more dim values of 0. edge case that is easier to handle
-  // separately than to complicate all the code for normal usage.
-  if (orig_input_shape.Size() == 0) {
-    return PadInputWithDimValueOfZero(ctx, mode, orig_input_shape, output_dims, value);
+  const size_t new_dims_count = dims_count - outer_count + 1;
+  std::vector<int64_t> new_dims(new_dims_count);
+  std::vector<int64_t> new_pads(2 * new_dims_count, 0);
+  std::vector<int64_t> new_slices(2 * new_dims_count, 0);
+  new_dims[0] = std::accumulate(dims.begin(), dims.begin() + outer_count, int64_t{1}, std::multiplies<int64_t>());
+  for (size_t i = 1; i < new_dims_count; i++) {
+    const size_t src = outer_count + i - 1;
+    new_dims[i] = dims[src];
+    new_pads[i] = pads[src];
+    new_pads[i + new_dims_count] = pads[src + dims_count];
+    new_slices[i] = slices[src];
+    new_slices[i + new_dims_count] = slices[src + dims_count];
   }
 
-  TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<T> input(input_tensor, input_shape, input_starts, input_extents, {});
-
-  // output_shape need to keep original.
-  TensorShape output_shape(output_dims);
-  auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = output_tensor.template MutableData<T>();
-
-  TensorPitches output_pitches(reshaped_output_dims);
-  size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
-
-  // Initial skip, sum up the begin padding on each axis
-  for (size_t i = 0; i < new_dims_count; i++)
-    alignSkip += reshaped_pad[i] * output_pitches[i];
+  dims = std::move(new_dims);
+  pads = std::move(new_pads);
+  slices = std::move(new_slices);
+}
 
+// Pad the blocks of 'input' into 'output', which starts at the first padding of the blocks.
+// align_skip is the amount of padding before the first element of the input data.
+template <typename T>
+static void PadBlocks(T* output, SliceIterator<T>& input, const std::vector<int64_t>& input_extents,
+                      const std::vector<int64_t>& reshaped_pad, const TensorPitches& output_pitches,
+                      size_t alignSkip, const Mode& mode, T value) {
+  const size_t new_dims_count = input_extents.size();
+  const size_t inner_axis = new_dims_count - 1;
   ExtentAxisCounters input_counters(input_extents);
 
   switch (mode) {
@@ -313,8 +294,8 @@ Status PadCpuImpl(OpKernelContext* ctx,
           T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
           int64_t prePad = reshaped_pad[input_counters.Axis()];
           int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
+          PadAxis(axisStart - prePad * inner_pitch, axisStart, -inner_pitch, inner_pitch, prePad);
+          PadAxis(output, output - inner_pitch, -inner_pitch, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
@@ -344,14 +325,102 @@ Status PadCpuImpl(OpKernelContext* ctx,
           T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
           int64_t prePad = reshaped_pad[input_counters.Axis()];
           int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2, inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
+          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, -inner_pitch * 2, inner_pitch, prePad);
+          PadAxis(output, output - 2 * inner_pitch, -inner_pitch * 2, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
       }
       break;
   }
+}
+
+template <typename T>
+Status PadCpuImpl(OpKernelContext* ctx,
+                  const std::vector<int64_t>& pads,
+                  const std::vector<int64_t>& slices,
+                  const Mode& mode,
+                  T value) {
+  const auto& input_tensor = *ctx->Input<Tensor>(0);
+  const auto& orig_input_shape = input_tensor.Shape();
+  std::vector<int64_t> output_dims(orig_input_shape.GetDims());
+  size_t data_rank = output_dims.size();
+
+  // make copy of raw_pads as it may be mutated below
+  ORT_ENFORCE(data_rank > 0, "Input tensor has no dimensions");
+  ORT_ENFORCE(data_rank * 2 == pads.size(), "'pads' has wrong number of values");
+
+  // Reshape input dims
+  std::vector<int64_t> reshaped_input_dims;
+  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
+
+  // Reshape padding
+  size_t new_dims_count = reshaped_input_dims.size();
+  size_t inner_axis = new_dims_count - 1;
+  size_t inner_no_pad_size = output_dims[inner_axis] > 0 ? reshaped_input_dims[inner_axis] / output_dims[inner_axis] : 0;
+  std::vector<int64_t> reshaped_pad(2 * new_dims_count), reshaped_slice(2 * new_dims_count);
+  ReshapePads(pads, data_rank, new_dims_count, inner_no_pad_size, reshaped_pad);
+  ReshapePads(slices, data_rank, new_dims_count, inner_no_pad_size, reshaped_slice);
+  FlattenOuterShape(reshaped_input_dims, reshaped_pad, reshaped_slice);
+  new_dims_count = reshaped_input_dims.size();
+
+  std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
+  std::vector<int64_t> input_starts;
+  std::vector<int64_t> input_extents;
+
+  // Calculate output dimensions, and handle any negative padding
+  input_starts.reserve(new_dims_count);
+  input_extents.reserve(new_dims_count);
+  for (size_t i = 0; i < new_dims_count; i++) {
+    input_starts.push_back(-1 * reshaped_slice[i]);
+    input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
+    reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
+  }
+
+  for (size_t i = 0; i < data_rank; i++) {
+    output_dims[i] += pads[i] + pads[i + data_rank] + slices[i] + slices[i + data_rank];
+  }
+
+  // special case an input with one or more dim values of 0. edge case that is easier to handle
+  // separately than to complicate all the code for normal usage.
+  if (orig_input_shape.Size() == 0) {
+    return PadInputWithDimValueOfZero(ctx, mode, orig_input_shape, output_dims, value);
+  }
+
+  TensorShape input_shape(reshaped_input_dims);
+
+  // output_shape need to keep original.
+  TensorShape output_shape(output_dims);
+  auto& output_tensor = *ctx->Output(0, output_shape);
+  auto* output = output_tensor.template MutableData<T>();
+
+  TensorPitches output_pitches(reshaped_output_dims);
+  size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
+
+  // Initial skip, sum up the begin padding on each axis
+  for (size_t i = 0; i < new_dims_count; i++)
+    alignSkip += reshaped_pad[i] * output_pitches[i];
+
+  // the blocks along the first axis are independent if it has no padding
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  if (tp != nullptr && new_dims_count > 1 && input_extents[0] > 1 &&
+      reshaped_pad[0] == 0 && reshaped_pad[new_dims_count] == 0 &&
+      reshaped_slice[0] == 0 && reshaped_slice[new_dims_count] == 0) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(input_extents[0]), static_cast<double>(output_pitches[0]),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<int64_t> starts(input_starts);
+          std::vector<int64_t> extents(input_extents);
+          starts[0] = first;
+          extents[0] = last - first;
+          SliceIterator<T> input(input_tensor, input_shape, starts, extents, {});
+          PadBlocks(output + first * output_pitches[0], input, extents, reshaped_pad, output_pitches, alignSkip,
+                    mode, value);
+        });
+  } else {
+    SliceIterator<T> input(input_tensor, input_shape, input_starts, input_extents, {});
+    PadBlocks(output, input, input_extents, reshaped_pad, output_pitches, alignSkip, mode, value);
+  }
 
   return Status::OK();
 }
@@ -364,7 +433,7 @@ Status Pad<T>::Compute(OpKernelContext* ctx) const {
     size_t data_rank = input_tensor.Shape().NumDimensions();
 
     const Tensor& pads_tensor = *ctx->Input<Tensor>(1);
-    const std::vector<int64_t>& pads_tensor_dims = pads_tensor.Shape().GetDims();
+    const auto& pads_tensor_dims = pads_tensor.Shape().GetDims();
     ORT_ENFORCE(pads_tensor.IsDataType<int64_t>(),
                 "Pads tensor should be an INT64 tensor");
     ORT_ENFORCE(pads_tensor_dims.size() == 1 || (pads_tensor_dims.size() == 2 && pads_tensor_dims[0] == 1),
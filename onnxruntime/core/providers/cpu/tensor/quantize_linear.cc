@@ -4,6 +4,9 @@
 #include "core/providers/cpu/tensor/quantize_linear.h"
 #include "core/providers/common.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
 
 namespace onnxruntime {
 
@@ -29,6 +32,31 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("y", DataTypeImpl::GetTensorType<float>()),
     DequantizeLinear<int8_t>);
 
+// number of elements each thread quantizes or dequantizes at a time
+static constexpr size_t kQuantizeBlockSize = 16384;
+
+// Splits row_count rows of row_size elements that share the quantization parameters of the row into blocks and
+// calls fn(row, offset, count) for each block on the thread pool.
+template <typename TFunc>
+static void ParallelForQuantizeBlocks(concurrency::ThreadPool* thread_pool, size_t row_count, size_t row_size,
+                                      TFunc fn) {
+  if (row_count == 0 || row_size == 0) {
+    return;
+  }
+
+  const size_t block_size = std::min(kQuantizeBlockSize, row_size);
+  const size_t blocks_per_row = (row_size + block_size - 1) / block_size;
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(row_count * blocks_per_row), static_cast<double>(block_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const size_t row = static_cast<size_t>(block) / blocks_per_row;
+          const size_t offset = (static_cast<size_t>(block) % blocks_per_row) * block_size;
+          fn(row, offset, std::min(block_size, row_size - offset));
+        }
+      });
+}
+
 template <typename T>
 // formula is Y = (X - ZeroPoint) * Scale
 Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
@@ -38,48 +66,37 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   auto& y = *ctx->Output(0, x.Shape());
   const auto& x_shape = x.Shape();
 
-  int64_t axis = 0;
-  int64_t broadcastDim = x_shape[axis];
-  size_t stride = 0;
+  size_t N = 1;
+  size_t broadcastDim = 1;
+  size_t block_size = static_cast<size_t>(x_shape.Size());
 
   if (has_axis_) {
-    axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
-    broadcastDim = x_shape[axis];
-    stride = 1;
+    const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+    N = x_shape.SizeToDimension(axis);
+    broadcastDim = static_cast<size_t>(x_shape[axis]);
+    block_size = x_shape.SizeFromDimension(axis + 1);
 
     // if an axis was specified, ensure the scale and zero point are compatible
-    ORT_ENFORCE(x_scale.Shape().NumDimensions() == 1 && x_scale.Shape().Size() == broadcastDim, "x_scale must be 1D tensor with size ", broadcastDim);
-    ORT_ENFORCE(x_zero_point.Shape().NumDimensions() == 1 && x_zero_point.Shape().Size() == broadcastDim, "x_zero_point must be 1D tensor with size ", broadcastDim);
+    ORT_ENFORCE(x_scale.Shape().NumDimensions() == 1 && x_scale.Shape().Size() == x_shape[axis], "x_scale must be 1D tensor with size ", x_shape[axis]);
+    ORT_ENFORCE(x_zero_point.Shape().NumDimensions() == 1 && x_zero_point.Shape().Size() == x_shape[axis], "x_zero_point must be 1D tensor with size ", x_shape[axis]);
   } else {
     // if no axis, enforce that scale and zero point are scalars
     ORT_ENFORCE(IsScalarOr1ElementVector(&x_scale), "x_scale must be a scalar or 1D tensor or size 1.");
     ORT_ENFORCE(IsScalarOr1ElementVector(&x_zero_point), "x_zero_point must be a scalar or 1D tensor or size 1.");
   }
 
-  size_t N = x_shape.SizeToDimension(axis);
-  size_t block_size = x_shape.SizeFromDimension(axis + 1);
-
   const T* zero_point = x_zero_point.template Data<T>();
   const float* scale = x_scale.template Data<float>();
   const T* input = x.template Data<T>();
   float* output = y.template MutableData<float>();
 
-  for (size_t n = 0; n < N; n++) {
-    const float* current_scale = scale;
-    const T* current_zero_point = zero_point;
-
-    for (size_t bd = 0; bd < static_cast<size_t>(broadcastDim); bd++) {
-      auto zp = static_cast<const int>(*current_zero_point);
-      auto sc = *current_scale;
-
-      for (size_t bs = 0; bs < block_size; bs++) {
-        *output++ = static_cast<float>(static_cast<const int>(*input++) - zp) * sc;
-      }
-
-      current_scale += stride;
-      current_zero_point += stride;
-    }
-  }
+  // each row of block_size elements uses the scale and zero point of its index along the axis
+  ParallelForQuantizeBlocks(ctx->GetOperatorThreadPool(), N * broadcastDim, block_size,
+                            [&](size_t row, size_t offset, size_t count) {
+                              const size_t bd = row % broadcastDim;
+                              const size_t begin = row * block_size + offset;
+                              MlasDequantizeLinear(input + begin, output + begin, count, scale[bd], zero_point[bd]);
+                            });
 
   return Status::OK();
 }
@@ -116,61 +133,52 @@ Status QuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   const float* input = x.template Data<float>();
   T* output = y.template MutableData<T>();
 
-  const float qmax = std::numeric_limits<T>::max();
-  const float qmin_default = std::numeric_limits<T>::min();
-  // adjust qmin for int8 inputs. This is required to keep zero point as zero
-  const float qmin = qmin_default == -128 ? -127 : qmin_default;
+  size_t N = 1;
+  size_t broadcastDim = 1;
+  size_t block_size = static_cast<size_t>(x_shape.Size());
 
   // Schema of QuantizeLinearOp changed when it was promoted to onnx domain. In order to maintain backward compatiblity
   // both the versions need to be supported.
-  if (ctx->GetOpDomain() != kMSDomain) {
+  const bool is_ms_domain = ctx->GetOpDomain() == kMSDomain;
+  if (is_ms_domain && has_axis_) {
+    const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+    N = x_shape.SizeToDimension(axis);
+    broadcastDim = static_cast<size_t>(x_shape[axis]);
+    block_size = x_shape.SizeFromDimension(axis + 1);
+
+    // if an axis was specified, ensure the scale and zero point are compatible
+    ORT_ENFORCE(y_scale.Shape().NumDimensions() == 1 && y_scale.Shape().Size() == x_shape[axis], "x_scale must be 1D tensor with size ", x_shape[axis]);
+    ORT_ENFORCE(y_zero_point.Shape().NumDimensions() == 1 && y_zero_point.Shape().Size() == x_shape[axis], "x_zero_point must be 1D tensor with size ", x_shape[axis]);
+  } else {
+    // if no axis, enforce that scale and zero point are scalars
     ORT_ENFORCE(IsScalarOr1ElementVector(&y_scale), "x_scale must be a scalar or 1D tensor or size 1.");
     ORT_ENFORCE(IsScalarOr1ElementVector(&y_zero_point), "x_zero_point must be a scalar or 1D tensor or size 1.");
+  }
 
-    const T zero_point = *(y_zero_point.template Data<T>());
-    const float scale = *(y_scale.template Data<float>());
-    const auto num_of_elements = x_shape.Size();
-
-    MlasQuantizeLinear(input, output, num_of_elements, scale, zero_point);
+  const T* zero_point = y_zero_point.template Data<T>();
+  const float* scale = y_scale.template Data<float>();
 
-  } else {
-    size_t stride = 0;
-    const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
-    const auto& broadcastDim = x_shape[axis];
-
-    if (has_axis_) {
-      // if an axis was specified, ensure the scale and zero point are compatible
-      ORT_ENFORCE(y_scale.Shape().NumDimensions() == 1 && y_scale.Shape().Size() == broadcastDim, "x_scale must be 1D tensor with size ", broadcastDim);
-      ORT_ENFORCE(y_zero_point.Shape().NumDimensions() == 1 && y_zero_point.Shape().Size() == broadcastDim, "x_zero_point must be 1D tensor with size ", broadcastDim);
-      stride = 1;
-    } else {
-      // if no axis, enforce that scale and zero point are scalars
-      ORT_ENFORCE(IsScalarOr1ElementVector(&y_scale), "x_scale must be a scalar or 1D tensor or size 1.");
-      ORT_ENFORCE(IsScalarOr1ElementVector(&y_zero_point), "x_zero_point must be a scalar or 1D tensor or size 1.");
-    }
-
-    size_t N = x_shape.SizeToDimension(axis);
-    size_t block_size = x_shape.SizeFromDimension(axis + 1);
-    const T* zero_point = y_zero_point.template Data<T>();
-    const float* scale = y_scale.template Data<float>();
-
-    for (size_t n = 0; n < N; n++) {
-      const float* current_scale = scale;
-      const T* current_zero_point = zero_point;
-
-      for (size_t bd = 0; bd < static_cast<size_t>(broadcastDim); bd++) {
-        float zp = *current_zero_point;
-        auto sc = *current_scale;
-
-        for (size_t bs = 0; bs < block_size; bs++) {
-          *output++ = static_cast<T>(clamp(std::round(static_cast<float>(*input++) / sc) + zp, qmin, qmax));
-        }
+  const float qmax = std::numeric_limits<T>::max();
+  const float qmin_default = std::numeric_limits<T>::min();
+  // adjust qmin for int8 inputs. This is required to keep zero point as zero
+  const float qmin = qmin_default == -128 ? -127 : qmin_default;
 
-        current_scale += stride;
-        current_zero_point += stride;
-      }
-    }
-  }
+  // each row of block_size elements uses the scale and zero point of its index along the axis
+  ParallelForQuantizeBlocks(ctx->GetOperatorThreadPool(), N * broadcastDim, block_size,
+                            [&](size_t row, size_t offset, size_t count) {
+                              const size_t bd = row % broadcastDim;
+                              const size_t begin = row * block_size + offset;
+                              if (!is_ms_domain) {
+                                MlasQuantizeLinear(input + begin, output + begin, count, scale[bd], zero_point[bd]);
+                              } else {
+                                // the contrib op rounds halfway cases away from zero
+                                const float zp = zero_point[bd];
+                                const float sc = scale[bd];
+                                for (size_t i = begin; i < begin + count; i++) {
+                                  output[i] = static_cast<T>(clamp(std::round(input[i] / sc) + zp, qmin, qmax));
+                                }
+                              }
+                            });
 
   return Status::OK();
 }
@@ -9,6 +9,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     5,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
         .TypeConstraint("shape", DataTypeImpl::GetTensorType<int64_t>()),
     Reshape);
@@ -19,6 +20,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     4,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Reshape_1);
 
@@ -31,7 +31,7 @@ class Reshape final : public OpKernel {
 
     ReshapeHelper helper(X_shape, shape);
 
-    Tensor* Y = context->Output(0, TensorShape(shape));
+    Tensor* Y = OutputForCopy(*context, 0, *X, TensorShape(shape));
 
     CopyCpuTensor(X, Y);
 
@@ -53,7 +53,7 @@ class Reshape_1 final : public OpKernel {
 
     ReshapeHelper helper(X_shape, shape);
 
-    Tensor* Y = context->Output(0, TensorShape(shape));
+    Tensor* Y = OutputForCopy(*context, 0, *X, TensorShape(shape));
 
     CopyCpuTensor(X, Y);
 
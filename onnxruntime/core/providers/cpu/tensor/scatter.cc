@@ -4,6 +4,7 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Scatter
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 
 namespace onnxruntime {
@@ -42,7 +43,7 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 template <class Tin, class Tdata>
 Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, const Tensor* updates_input,
-                       const int64_t axis, Tensor* data_output) {
+                       const int64_t axis, Tensor* data_output, concurrency::ThreadPool* tp) {
   const TensorShape& input_data_shape = data_input->Shape();
   const Tin* indices_data_raw = indices_input->template Data<Tin>();
   const auto num_indices = indices_input->Shape().Size();
@@ -91,18 +92,6 @@ Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, co
   const auto num_dims = input_data_shape.NumDimensions();
   assert(num_dims > 0);
 
-  // Allocate and zero out counts. The input/output is of the same rank as
-  // indices/updates but the actual dimensions of indices/updates must be less or equal
-  // than that of input/output because we can update no more elements than
-  // the input contains. As we walk through the indices/updates
-  // we maintain dimension count as we will need to use it
-  // to compute output offset but using input/output dim values.
-  // We treat the whole array as a number where each element having
-  // different cardinality according to the upd_shape dimensions.
-  // As each counter reaches its max (upd_shape) it resets to zero
-  // and we carry to the more significant dim (right to left)
-  std::vector<int64_t> dim_counters(num_dims);
-
   // This vector contains number of elements under the dimension.
   // For example, for the dimensions of [4, 2, 3] the vector
   // would contain [6, 3, 1] since for each count of dim 1 it
@@ -131,41 +120,66 @@ Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, co
   }
 
   const auto* update_data = static_cast<const Tdata*>(updates_input->DataRaw());
-  // For every update we compute the destination offset and copy it there
-  for (int64_t index = 0; index < num_indices;) {
-    const Tin axis_idx = indices_data[index];
-
-    // Compute the offset
-    // See comments above for dim_block_size
-    size_t dst_offset = 0;
-    for (size_t i = 0; i < num_dims; ++i) {
-      if (i == size_t(axis)) {
-        // replace the counter with the update index for this dim
-        dst_offset += axis_idx * dim_block_size[i];
-      } else {
-        dst_offset += dim_counters[i] * dim_block_size[i];
+
+  // When the scatter is along another axis, the updates for each entry of the first axis only write to that entry
+  // of the output, so these blocks of updates are independent and are applied in parallel.
+  const bool parallel_blocks = axis != 0 && num_dims > 1 && upd_shape[0] > 1;
+  const int64_t num_blocks = parallel_blocks ? upd_shape[0] : 1;
+  const int64_t block_size = num_indices / num_blocks;
+
+  auto scatter_blocks = [&](std::ptrdiff_t first_block, std::ptrdiff_t last_block) {
+    // Allocate and zero out counts. The input/output is of the same rank as
+    // indices/updates but the actual dimensions of indices/updates must be less or equal
+    // than that of input/output because we can update no more elements than
+    // the input contains. As we walk through the indices/updates
+    // we maintain dimension count as we will need to use it
+    // to compute output offset but using input/output dim values.
+    // We treat the whole array as a number where each element having
+    // different cardinality according to the upd_shape dimensions.
+    // As each counter reaches its max (upd_shape) it resets to zero
+    // and we carry to the more significant dim (right to left)
+    std::vector<int64_t> dim_counters(num_dims);
+    dim_counters[0] = first_block;
+
+    // For every update we compute the destination offset and copy it there
+    for (int64_t index = first_block * block_size, end = last_block * block_size; index < end;) {
+      const Tin axis_idx = indices_data[index];
+
+      // Compute the offset
+      // See comments above for dim_block_size
+      size_t dst_offset = 0;
+      for (size_t i = 0; i < num_dims; ++i) {
+        if (i == size_t(axis)) {
+          // replace the counter with the update index for this dim
+          dst_offset += axis_idx * dim_block_size[i];
+        } else {
+          dst_offset += dim_counters[i] * dim_block_size[i];
+        }
       }
-    }
 
-    dst_base[dst_offset] = update_data[index];
+      dst_base[dst_offset] = update_data[index];
 
-    if (++index == num_indices) {
-      break;
-    }
-    // Increment counters
-    // See comments for dim_counters above
-    for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
-      auto v = ++dim_counters[i];
-      assert(v <= upd_shape[i]);
-      if (v < upd_shape[i]) {
-        // No carry, done
+      if (++index == end) {
         break;
       }
-      // No carry for the most significant dim
-      assert(i > 0);
-      dim_counters[i] = 0;
+      // Increment counters
+      // See comments for dim_counters above
+      for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
+        auto v = ++dim_counters[i];
+        assert(v <= upd_shape[i]);
+        if (v < upd_shape[i]) {
+          // No carry, done
+          break;
+        }
+        // No carry for the most significant dim
+        assert(i > 0);
+        dim_counters[i] = 0;
+      }
     }
-  }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(num_blocks),
+                                          static_cast<double>(block_size * num_dims), scatter_blocks);
   return Status::OK();
 }
 
@@ -224,11 +238,12 @@ Status Scatter::Compute(OpKernelContext* context) const {
   auto* data_output = context->Output(0, input_data_shape);
 
   MLDataType Tdata_type = data_input->DataType();
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
   Status status;
   if (indices_input->IsDataType<int32_t>()) {
-    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt32Index, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt32Index, data_input, indices_input, updates_input, axis, data_output, tp);
   } else if (indices_input->IsDataType<int64_t>()) {
-    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt64Index, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnTensorTypeWithReturn(Tdata_type, status, CopyInt64Index, data_input, indices_input, updates_input, axis, data_output, tp);
   } else {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expecting indices to be either int32_t or int64_t");
   }
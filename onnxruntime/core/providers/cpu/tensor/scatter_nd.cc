@@ -3,6 +3,10 @@
 
 #include "scatter_nd.h"
 
+#include <algorithm>
+
+#include "core/platform/threadpool.h"
+
 namespace onnxruntime {
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -124,34 +128,57 @@ Status ScatterNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) co
 
 template Status ScatterNDBase::PrepareForCompute<int64_t>(OpKernelContext*, Prepare&) const;
 
+// The slices written by the updates are all of the same size and start at a multiple of it,
+// so two of them overlap only if they start at the same offset.
+static bool HasOverlappingSlices(const std::vector<uint64_t>& element_offsets) {
+  std::vector<uint64_t> sorted_offsets(element_offsets);
+  std::sort(sorted_offsets.begin(), sorted_offsets.end());
+  return std::adjacent_find(sorted_offsets.cbegin(), sorted_offsets.cend()) != sorted_offsets.cend();
+}
+
+// Run fn over the updates, in parallel when no two of them write the same slice. Otherwise they're applied in order
+// so the last update of a slice wins.
+template <typename F>
+static void ForEachUpdate(const std::vector<uint64_t>& element_offsets, double cost_per_update,
+                          concurrency::ThreadPool* tp, F&& fn) {
+  const auto num_updates = static_cast<std::ptrdiff_t>(element_offsets.size());
+  if (tp == nullptr || num_updates < 2 || HasOverlappingSlices(element_offsets)) {
+    fn(0, num_updates);
+  } else {
+    concurrency::ThreadPool::TryParallelFor(tp, num_updates, cost_per_update, fn);
+  }
+}
+
 Status ScatterND::Compute(OpKernelContext* context) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute<int64_t>(context, p));
-  return nullptr == p.input_str_base ? ScatterNumber(p) : ScatterString(p);
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  return nullptr == p.input_str_base ? ScatterNumber(p, tp) : ScatterString(p, tp);
 }
 
-Status ScatterND::ScatterNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + p.element_offsets[i] * p.element_bytes,
-           p.input_base + i * p.bytes_to_copy,
-           p.bytes_to_copy);
-  }
+Status ScatterND::ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
+  const double cost_per_update = static_cast<double>(p.bytes_to_copy);
+  ForEachUpdate(p.element_offsets, cost_per_update, tp, [&p](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      memcpy(p.output_base + p.element_offsets[i] * p.element_bytes,
+             p.input_base + i * p.bytes_to_copy,
+             p.bytes_to_copy);
+    }
+  });
   return Status::OK();
 }
 
-Status ScatterND::ScatterString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[p.element_offsets[i] + j] = p.input_str_base[i * p.element_to_copy + j];
+Status ScatterND::ScatterString(const Prepare& p, concurrency::ThreadPool* tp) const {
+  // copying a string costs more than a few bytes
+  const double cost_per_update = static_cast<double>(p.element_to_copy) * 16;
+  ForEachUpdate(p.element_offsets, cost_per_update, tp, [&p](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
+        p.output_str_base[p.element_offsets[i] + j] = p.input_str_base[i * p.element_to_copy + j];
+      }
     }
-  }
+  });
   return Status::OK();
 }
 
-}
\ No newline at end of file
+}
@@ -7,6 +7,9 @@
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 class ScatterNDBase
 {
@@ -40,8 +43,8 @@ public:
   explicit ScatterND(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 private:
-  Status ScatterNumber(const Prepare& p) const;
-  Status ScatterString(const Prepare& p) const;
+  Status ScatterNumber(const Prepare& p, concurrency::ThreadPool* tp) const;
+  Status ScatterString(const Prepare& p, concurrency::ThreadPool* tp) const;
 };
 
 } // namespace onnxruntime
\ No newline at end of file
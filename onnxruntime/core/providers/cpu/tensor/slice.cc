@@ -16,7 +16,7 @@ namespace onnxruntime {
       Slice,                                                                            \
       1, 9,                                                                             \
       data_type,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()), \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()).MayView(0, 0), \
       Slice<data_type, false>);
 
 ADD_TYPED_SLICE_V9_OP(uint8_t);
@@ -39,7 +39,7 @@ ADD_TYPED_SLICE_V9_OP(string);
       10,                                                                                                                                                                                        \
       10,                                                                                                                                                                                        \
       data_type,                                                                                                                                                                                 \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()).TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}), \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()).TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}).MayView(0, 0), \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V10_OP(uint8_t);
@@ -63,7 +63,8 @@ ADD_TYPED_SLICE_V10_OP(string);
       data_type,                                                                                                     \
       KernelDefBuilder()                                                                                             \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())                                             \
-          .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}), \
+          .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()})  \
+          .MayView(0, 0),                                                                                            \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V11_OP(uint8_t);
@@ -314,6 +315,42 @@ void SliceBase::FillVectorsFromInput(const OpKernelContext* context,
   }
 }
 
+// Check if the slice is a single contiguous range of the input, so the output can be a view into the input buffer.
+// That is the case if all the dims before the first dim with more than one output value have one output value,
+// that dim has a step of 1, and all the dims after it are kept completely.
+// Sets offset to the index of the first input value in the range if it is.
+static bool IsContiguousSlice(TensorShapeDims input_dims,
+                              const std::vector<int64_t>& output_dims,
+                              const std::vector<int64_t>& starts,
+                              const std::vector<int64_t>& steps,
+                              int64_t& offset) {
+  const size_t num_dims = output_dims.size();
+  size_t first_range_dim = 0;
+  while (first_range_dim < num_dims && output_dims[first_range_dim] == 1) {
+    ++first_range_dim;
+  }
+
+  if (first_range_dim < num_dims) {
+    if (steps[first_range_dim] != 1) {
+      return false;
+    }
+    for (size_t i = first_range_dim + 1; i < num_dims; ++i) {
+      if (steps[i] != 1 || output_dims[i] != input_dims[i]) {
+        return false;
+      }
+    }
+  }
+
+  offset = 0;
+  int64_t pitch = 1;
+  for (size_t i = num_dims; i-- > 0;) {
+    offset += starts[i] * pitch;
+    pitch *= input_dims[i];
+  }
+
+  return true;
+}
+
 template <typename T>
 Status SliceImpl(OpKernelContext* ctx,
                  const Tensor& input_tensor,
@@ -321,7 +358,29 @@ Status SliceImpl(OpKernelContext* ctx,
                  std::vector<int64_t>* flattened_output_dims,
                  const std::vector<int64_t>& starts,
                  const std::vector<int64_t>& steps) {
-  TensorShape output_shape(output_dims);
+  const TensorShape output_shape(output_dims);
+
+  // if we have flattened output dims we need to also flatten the input dims.
+  // as we're combining the innermost dims and keeping all values we can just copy the size of the last dim
+  std::vector<int64_t> flattened_input_dims;
+  if (flattened_output_dims) {
+    flattened_input_dims = input_tensor.Shape().GetDims();
+    flattened_input_dims.resize(flattened_output_dims->size());
+    flattened_input_dims.back() = flattened_output_dims->back();
+  }
+
+  const TensorShapeDims slice_input_dims =
+      flattened_output_dims ? TensorShapeDims(flattened_input_dims) : input_tensor.Shape().GetDims();
+  const auto& slice_output_dims = flattened_output_dims ? *flattened_output_dims : output_dims;
+
+  // a contiguous range of the input doesn't need to be copied if the output can be a view into the input buffer
+  int64_t offset = 0;
+  if (output_shape.Size() > 0 &&
+      IsContiguousSlice(slice_input_dims, slice_output_dims, starts, steps, offset) &&
+      ctx->OutputView(0, 0, output_shape, static_cast<size_t>(offset) * sizeof(T)) != nullptr) {
+    return Status::OK();
+  }
+
   auto& output_tensor = *ctx->Output(0, output_shape);
 
   // output tensor's size is 0, nothing to fill - return
@@ -346,11 +405,6 @@ Status SliceImpl(OpKernelContext* ctx,
   };
 
   if (flattened_output_dims) {
-    // if we have flattened output dims we need to also flatten the input dims.
-    // as we're combining the innermost dims and keeping all values we can just copy the size of the last dim
-    std::vector<int64_t> flattened_input_dims(input_tensor.Shape().GetDims());
-    flattened_input_dims.resize(flattened_output_dims->size());
-    flattened_input_dims.back() = flattened_output_dims->back();
     TensorShape input_shape(std::move(flattened_input_dims));
 
     auto input_iterator = SliceIterator<T>(input_tensor, input_shape, starts, *flattened_output_dims, steps);
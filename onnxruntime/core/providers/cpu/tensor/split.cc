@@ -18,7 +18,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
                                       std::vector<MLDataType>{
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayView(0, -1),
     Split);
 
 // Opset 11 starts to support Neg Axis.
@@ -29,7 +30,8 @@ ONNX_CPU_OPERATOR_KERNEL(
                                       std::vector<MLDataType>{
                                           DataTypeImpl::GetTensorType<float>(),
                                           DataTypeImpl::GetTensorType<int32_t>(),
-                                          DataTypeImpl::GetTensorType<std::string>()}),
+                                          DataTypeImpl::GetTensorType<std::string>()})
+        .MayView(0, -1),
     Split);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -128,6 +130,13 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     auto split_size = gsl::narrow<int>(split_sizes[i]);
     output_dimensions[axis] = split_size;
 
+    // an output is a contiguous range of the input if nothing comes before the split axis
+    if (before_dims == 1 &&
+        context.OutputView(i, 0, TensorShape{output_dimensions}, input_offset * sizeof(T)) != nullptr) {
+      input_offset += split_size * after_dims_excluding_split;
+      continue;
+    }
+
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
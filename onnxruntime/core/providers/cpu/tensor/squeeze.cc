@@ -11,7 +11,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
-        .Alias(0, 0),
+        .Alias(0, 0)
+        .PackedStringInputs(),
     Squeeze);
 
 // Opset 11 starts to support Neg Axis.
@@ -20,6 +21,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
-        .Alias(0, 0),
+        .Alias(0, 0)
+        .PackedStringInputs(),
     Squeeze);
 }  // namespace onnxruntime
@@ -31,6 +31,7 @@ class SqueezeBase {
     size_t j = 0;
     std::vector<int64_t> output_shape;
     auto num_dimensions = input_shape.NumDimensions();
+    output_shape.reserve(num_dimensions);
 
     // Handle negtive axis, then resort and uniq.
     std::vector<int64_t> axes_corrected(axes.NumDimensions());
@@ -63,9 +64,9 @@ class Squeeze final : public OpKernel, public SqueezeBase {
   Status Compute(OpKernelContext* context) const override {
     const auto* X = context->Input<Tensor>(0);
     const TensorShape& X_shape = X->Shape();
-    std::vector<int64_t> output_shape = ComputeOutputShape(X_shape.GetDims(), axes_);
+    std::vector<int64_t> output_shape = ComputeOutputShape(X_shape, axes_);
 
-    Tensor* Y = context->Output(0, TensorShape(output_shape));
+    Tensor* Y = OutputForCopy(*context, 0, *X, TensorShape(output_shape));
 
     CopyCpuTensor(X, Y);
 
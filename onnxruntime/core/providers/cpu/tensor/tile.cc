@@ -9,7 +9,11 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include <functional>
+#include <numeric>
+
 #include "gsl/gsl"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/tile.h"
 #include "core/providers/cpu/tensor/utils.h"
 
@@ -38,46 +42,85 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
-Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
-  const auto& input_shape = input_tensor.Shape().GetDims();
-  const size_t dimension_count = input_shape.size();
-
-  const auto* input = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
-  auto* output = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
+namespace {
+// The block_size bytes before 'output' are repeated num_repeats more times from 'output' on. Each memcpy copies all
+// the data replicated so far instead of a single block. Returns the end of the replicated data.
+uint8_t* ReplicateBlock(uint8_t* output, size_t block_size, int64_t num_repeats) {
+  uint8_t* const begin = output - block_size;
+  const size_t total_size = block_size * static_cast<size_t>(num_repeats + 1);
+  size_t size = block_size;
+  while (size < total_size) {
+    const size_t copy_size = std::min(size, total_size - size);
+    memcpy(begin + size, begin, copy_size);
+    size += copy_size;
+  }
+  return begin + total_size;
+}
 
-  // some helper variables that will be used along the way
-  size_t block_size = 0;
-  int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
-  const int64_t innermost_dim = input_shape[dimension_count - 1];
+void TileBlocks(const uint8_t* input, uint8_t* output, const std::vector<int64_t>& input_dims, const int64_t* repeats,
+                const std::vector<int64_t>& output_pitches, size_t element_size) {
+  const size_t dimension_count = input_dims.size();
+  const size_t innermost_block_size = static_cast<size_t>(input_dims[dimension_count - 1]) * element_size;
+  ExtentAxisCounters input_counters(input_dims);
 
   while (input_counters) {
-    // Copy the input data over
-    block_size = innermost_dim * element_size;
-    memcpy(output, input, block_size);
-    output += block_size;
-    input += block_size;
-
-    // Tile data for the innermost axis
-    copy = output - block_size;
-    num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
-    }
+    // Copy the input data over and tile it for the innermost axis
+    memcpy(output, input, innermost_block_size);
+    input += innermost_block_size;
+    output = ReplicateBlock(output + innermost_block_size, innermost_block_size, repeats[dimension_count - 1] - 1);
 
     // Tile data for other axes
     while (input_counters.Increment()) {
-      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()];
-      block_size = pitch * element_size;
-      copy = output - block_size;
-      num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
+      const size_t axis = input_counters.Axis();
+      const size_t block_size = static_cast<size_t>(output_pitches[axis] * input_dims[axis]) * element_size;
+      output = ReplicateBlock(output, block_size, repeats[axis] - 1);
     }
   }
+}
+}  // namespace
+
+void TileFixedSizeElements(const void* input, void* output, const std::vector<int64_t>& input_dims,
+                           const int64_t* repeats, size_t element_size, concurrency::ThreadPool* tp) {
+  const size_t dimension_count = input_dims.size();
+  std::vector<int64_t> output_dims(dimension_count);
+  for (size_t axis = 0; axis < dimension_count; axis++) {
+    output_dims[axis] = input_dims[axis] * repeats[axis];
+  }
+  TensorPitches output_pitches(output_dims);
+
+  const auto* input_bytes = static_cast<const uint8_t*>(input);
+  auto* output_bytes = static_cast<uint8_t*>(output);
+
+  if (tp == nullptr || dimension_count < 2 || input_dims[0] < 2) {
+    TileBlocks(input_bytes, output_bytes, input_dims, repeats, output_pitches, element_size);
+    return;
+  }
+
+  // each row along the first axis is tiled into its own output block, and the blocks are replicated afterwards
+  const std::vector<int64_t> inner_dims(input_dims.begin() + 1, input_dims.end());
+  const std::vector<int64_t> inner_pitches(output_pitches.begin() + 1, output_pitches.end());
+  const int64_t input_block_elements =
+      std::accumulate(inner_dims.begin(), inner_dims.end(), int64_t{1}, std::multiplies<int64_t>());
+  const size_t input_block_size = static_cast<size_t>(input_block_elements) * element_size;
+  const size_t output_block_size = static_cast<size_t>(output_pitches[0]) * element_size;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(input_dims[0]), static_cast<double>(output_block_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          TileBlocks(input_bytes + i * input_block_size, output_bytes + i * output_block_size, inner_dims,
+                     repeats + 1, inner_pitches, element_size);
+        }
+      });
+
+  const size_t tiled_size = static_cast<size_t>(input_dims[0]) * output_block_size;
+  ReplicateBlock(output_bytes + tiled_size, tiled_size, repeats[0] - 1);
+}
+
+static Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats,
+                                        concurrency::ThreadPool* tp, size_t element_size) {
+  TileFixedSizeElements(input_tensor.DataRaw(), output_tensor.MutableDataRaw(), input_tensor.Shape().GetDims(),
+                        repeats, element_size, tp);
   return Status::OK();
 }
 
@@ -114,8 +157,7 @@ Status Tile::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  TensorAxisCounters input_counters(input_tensor);
-  TensorPitches output_pitches(output_tensor);
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
   static_assert(sizeof(float) == sizeof(int32_t), "Float and Int32 are of different sizes");
   static_assert(sizeof(double) == sizeof(int64_t), "Double and Int64 are of different sizes");
@@ -123,21 +165,21 @@ Status Tile::Compute(OpKernelContext* ctx) const {
   if (input_tensor.IsDataType<float>() ||
       input_tensor.IsDataType<int32_t>() ||
       input_tensor.IsDataType<uint32_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(float));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, tp, sizeof(float));
 
   if (input_tensor.IsDataType<double>() || input_tensor.IsDataType<int64_t>() ||
       input_tensor.IsDataType<uint64_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(double));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, tp, sizeof(double));
 
   else if (input_tensor.IsDataType<int8_t>() ||
            input_tensor.IsDataType<uint8_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int8_t));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, tp, sizeof(int8_t));
 
   if (input_tensor.IsDataType<int16_t>() || input_tensor.IsDataType<uint16_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int16_t));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, tp, sizeof(int16_t));
 
   else if (input_tensor.IsDataType<bool>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(bool));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, tp, sizeof(bool));
 
   // TODO: Support 'string' and 'float16' types for completeness
   else
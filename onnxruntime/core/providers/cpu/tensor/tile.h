@@ -1,12 +1,25 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#pragma once
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 
+namespace concurrency {
+class ThreadPool;
+}
+
+// Tile the row-major input of input_dims repeats[axis] times along each axis into output. Each innermost row is
+// copied once, and the repeated blocks are replicated with memcpy calls that double the replicated data each time.
+// The blocks along the first axis are tiled in parallel. All the dims and repeats must be > 0.
+// Expand uses this as well, as broadcasting repeats the axes of size 1.
+void TileFixedSizeElements(const void* input, void* output, const std::vector<int64_t>& input_dims,
+                           const int64_t* repeats, size_t element_size, concurrency::ThreadPool* tp);
+
 struct Tile final : OpKernel {
   Tile(const OpKernelInfo& info) : OpKernel(info) {
   }
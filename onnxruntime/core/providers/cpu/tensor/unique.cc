@@ -3,9 +3,13 @@
 
 #include "core/providers/cpu/tensor/unique.h"
 
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <numeric>
 #include "gsl/gsl"
 #include "core/providers/common.h"
+#include "core/providers/cpu/ml/flat_hash_map.h"
 
 namespace onnxruntime {
 
@@ -129,41 +133,57 @@ class Subtensor {
   std::vector<T> items_;
 };
 
+template <typename T>
+static bool LessThan(const T& lhs, const T& rhs) {
+  return lhs < rhs;
+}
+
+// NaN is ordered after all the other values so the sort sees a strict weak ordering
+static bool LessThan(float lhs, float rhs) {
+  return lhs < rhs || (std::isnan(rhs) && !std::isnan(lhs));
+}
+
 template <typename T>
 static void CreateFlattenedOutput(OpKernelContext& context,
-                                  const std::map<const T, int64_t>& offsets,         // map sorted key to unsorted idx
-                                  const std::vector<std::vector<int64_t>>& indices,  // unsorted
-                                  const std::vector<int64_t>& inverse_index,         // unsorted
+                                  const ml::FlatHashMap<T, int64_t>& offsets,  // unique value to first index, unsorted
+                                  const std::vector<int64_t>& counts,          // unsorted
+                                  const std::vector<int64_t>& inverse_index,   // unsorted
                                   bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
+  const auto& values = offsets.Keys();
+  const auto& first_indices = offsets.Values();
+  int64_t num_unique = static_cast<int64_t>(values.size());
   Tensor& Y = *context.Output(0, TensorShape({num_unique}));
   Tensor* indices_out = context.Output(1, TensorShape({num_unique}));
   Tensor* inverse_indices = context.Output(2, TensorShape({static_cast<int64_t>(inverse_index.size())}));
-  Tensor* counts = context.Output(3, TensorShape({num_unique}));
+  Tensor* counts_out = context.Output(3, TensorShape({num_unique}));
 
   auto Y_data = Y.MutableDataAsSpan<T>();
   gsl::span<int64_t> indices_data = indices_out != nullptr ? indices_out->MutableDataAsSpan<int64_t>()
                                                            : gsl::span<int64_t>();
   gsl::span<int64_t> inverse_indices_data = inverse_indices != nullptr ? inverse_indices->MutableDataAsSpan<int64_t>()
                                                                        : gsl::span<int64_t>();
-  gsl::span<int64_t> counts_data = counts != nullptr ? counts->MutableDataAsSpan<int64_t>()
-                                                     : gsl::span<int64_t>();
+  gsl::span<int64_t> counts_data = counts_out != nullptr ? counts_out->MutableDataAsSpan<int64_t>()
+                                                         : gsl::span<int64_t>();
+
+  // the unsorted idx of each output entry. only the unique values are sorted, not the whole input.
+  std::vector<int64_t> order(num_unique);
+  std::iota(order.begin(), order.end(), int64_t{0});
+  if (sorted) {
+    std::sort(order.begin(), order.end(),
+              [&values](int64_t lhs, int64_t rhs) { return LessThan(values[lhs], values[rhs]); });
+  }
 
-  // iterate using 'offsets' which is sorted, but contains the offset of the unsorted entry
-  auto offsets_iter = offsets.begin();
-  for (int64_t i = 0, end = num_unique; i < end; ++i, ++offsets_iter) {
-    // write sequentially if we want sorted output, use the unsorted_idx if not
-    auto unsorted_idx = offsets_iter->second;
-    auto output_idx = sorted ? i : unsorted_idx;
+  for (int64_t i = 0, end = num_unique; i < end; ++i) {
+    auto unsorted_idx = order[i];
 
-    Y_data[output_idx] = offsets_iter->first;
+    Y_data[i] = values[unsorted_idx];
 
     if (indices_out) {
-      indices_data[output_idx] = indices[unsorted_idx].front();
+      indices_data[i] = first_indices[unsorted_idx];
     }
 
-    if (counts) {
-      counts_data[output_idx] = indices[unsorted_idx].size();
+    if (counts_out) {
+      counts_data[i] = counts[unsorted_idx];
     }
   }
 
@@ -172,9 +192,8 @@ static void CreateFlattenedOutput(OpKernelContext& context,
       // need to convert unsorted entries in the inverse index to their sorted values
       std::vector<int64_t> unsorted_to_sorted;
       unsorted_to_sorted.resize(num_unique);
-      int64_t sorted_idx = 0;
-      for (const auto& offset : offsets) {
-        unsorted_to_sorted[offset.second] = sorted_idx++;
+      for (int64_t i = 0; i < num_unique; ++i) {
+        unsorted_to_sorted[order[i]] = i;
       }
 
       for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
@@ -289,30 +308,25 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
   auto data = input.DataAsSpan<T>();
 
   if (flatten_) {
-    std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
-    std::vector<std::vector<int64_t>> indices;
+    // open addressing hash map of the unique values in the order they first occur, with the index of that occurrence
+    ml::FlatHashMap<T, int64_t> offsets;
+    std::vector<int64_t> counts;
     std::vector<int64_t> inverse_index;
 
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
     inverse_index.reserve(data.size());
 
-    int64_t num_unique = 0;
-
     for (int64_t i = 0, end = input.Shape().Size(); i < end; ++i) {
-      auto entry = offsets.find(data[i]);
-      if (entry == offsets.end()) {
-        offsets[data[i]] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
+      auto entry = offsets.TryInsert(data[i], i);
+      if (entry.second) {
+        counts.push_back(1);
       } else {
-        size_t indices_idx = entry->second;
-        indices[indices_idx].push_back(i);
-        inverse_index.push_back(indices_idx);
+        ++counts[entry.first];
       }
+
+      inverse_index.push_back(static_cast<int64_t>(entry.first));
     }
 
-    CreateFlattenedOutput(context, offsets, indices, inverse_index, sort_);
+    CreateFlattenedOutput(context, offsets, counts, inverse_index, sort_);
   } else {
     const auto& input_shape = input.Shape();
     const int64_t input_dims = static_cast<int64_t>(input_shape.NumDimensions());
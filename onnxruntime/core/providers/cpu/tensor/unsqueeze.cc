@@ -15,6 +15,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     10,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Unsqueeze);
 
@@ -23,6 +24,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder()
         .Alias(0, 0)
+        .PackedStringInputs()
         .TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Unsqueeze);
 
@@ -56,8 +58,7 @@ Status UnsqueezeBase::PrepareCompute(OpKernelContext* ctx, Prepare& p) const {
     assert(begin == input_tensor.Shape().GetDims().cend());
   }
 
-  TensorShape output_shape(output_dims);
-  p.output_tensor = ctx->Output(0, output_shape);
+  p.output_tensor = OutputForCopy(*ctx, 0, input_tensor, TensorShape(output_dims));
   p.input_tensor = &input_tensor;
   return Status::OK();
 }
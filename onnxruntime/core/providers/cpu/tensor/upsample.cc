@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 #include <sstream>
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 using namespace std;
@@ -36,24 +37,25 @@ void UpsampleNearest2x(int64_t batch_size,
                        int64_t input_height,
                        int64_t input_width,
                        const T* input,
-                       T* output) {
-  const int64_t output_height = input_height * 2;
+                       T* output,
+                       concurrency::ThreadPool* tp) {
   const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
+
+  // each unit of work is one input row, which is written to two output rows
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * input_height), static_cast<double>(output_width),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const T* input_row = input + row * input_width;
+          T* output_row = output + row * 2 * output_width;
+          for (int64_t x = 0; x < input_width; ++x) {
+            const T v = input_row[x];
+            output_row[x * 2 + 0] = v;
+            output_row[x * 2 + 1] = v;
+          }
+          std::copy_n(output_row, output_width, output_row + output_width);
         }
-      }
-      input += input_height * input_width;
-      output += output_height * output_width;
-    }
-  }
+      });
 }
 
 template <typename T>
@@ -68,7 +70,8 @@ Status UpsampleNearest(const T* input,
                        float extrapolation_value,
                        bool use_nearest2x_optimization,
                        GetOriginalCoordinateFunc get_original_coordinate,
-                       GetNearestPixelFunc get_nearest_pixel) {
+                       GetNearestPixelFunc get_nearest_pixel,
+                       concurrency::ThreadPool* tp) {
   if (!input || !output)
     return Status(ONNXRUNTIME, FAIL,
                   is_resize ? "Resize: input/output value is nullptr"
@@ -83,127 +86,69 @@ Status UpsampleNearest(const T* input,
                             : "Upsample: input shape needs to be at least a single dimension.");
   }
 
-  int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
+  const int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
 
-  std::vector<int64_t> input_dim_counters(n_dim);
-  std::vector<int64_t> input_dim_factor(n_dim);
-  std::vector<bool> use_extrapolation_value(n_dim);
-  input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
-  for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
-    input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_shape[dim_idx + 1];
-  }
-
-  int64_t output_idx = 0;
-  int64_t input_idx = 0;
-
-#define OneDimensionProcessor(dim_inx)                                                                                                                                                                                                               \
-  use_extrapolation_value[dim_inx] = false;                                                                                                                                                                                                          \
-  float original_##dim_inx##_idx = get_original_coordinate(static_cast<float>(output_dim##dim_inx##_inx), scales[dim_inx], static_cast<float>(output_shape[dim_inx]), static_cast<float>(input_shape[dim_inx]), roi[dim_inx], roi[n_dim + dim_inx]); \
-  if (extrapolation_enabled && (original_##dim_inx##_idx < 0 || original_##dim_inx##_idx > input_shape[dim_inx] - 1)) use_extrapolation_value[dim_inx] = true;                                                                                       \
-  int64_t input_dim##dim_inx##_inx = get_nearest_pixel(original_##dim_inx##_idx, scales[dim_inx] < 1);                                                                                                                                               \
-  if (input_dim##dim_inx##_inx > input_shape[dim_inx] - 1) input_dim##dim_inx##_inx = input_shape[dim_inx] - 1;                                                                                                                                      \
-  if (input_dim##dim_inx##_inx < 0) input_dim##dim_inx##_inx = 0;                                                                                                                                                                                    \
-  if (input_dim##dim_inx##_inx != input_dim_counters[dim_inx]) {                                                                                                                                                                                     \
-    input_idx += (input_dim##dim_inx##_inx - input_dim_counters[dim_inx]) * input_dim_factor[dim_inx];                                                                                                                                               \
-    input_dim_counters[dim_inx] = input_dim##dim_inx##_inx;                                                                                                                                                                                          \
-  }
-
-  if (n_dim == 1) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      output[output_idx++] = use_extrapolation_value[0] ? static_cast<T>(extrapolation_value) : input[input_idx];
-    }
+  if (n_dim == 4 && use_nearest2x_optimization && scales[0] == 1 && scales[1] == 1 && scales[2] == 2 &&
+      scales[3] == 2) {
+    UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output, tp);
     return Status::OK();
   }
 
-  if (n_dim == 2) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        output[output_idx++] = (use_extrapolation_value[0] || use_extrapolation_value[1])
-                                   ? static_cast<T>(extrapolation_value)
-                                   : input[input_idx];
+  // The nearest input index of an output index only depends on its own axis, so it is computed once per axis
+  // instead of once per output value. input_offsets[d][i] is the offset of the input value for output index i of
+  // axis d, or -1 if the extrapolation value is used for it.
+  std::vector<std::vector<int64_t>> input_offsets(n_dim);
+  int64_t input_dim_factor = 1;
+  for (int64_t d = n_dim - 1; d >= 0; --d) {
+    auto& offsets = input_offsets[d];
+    offsets.resize(output_shape[d]);
+    for (int64_t i = 0; i < output_shape[d]; ++i) {
+      const float original_idx = get_original_coordinate(static_cast<float>(i), scales[d],
+                                                         static_cast<float>(output_shape[d]),
+                                                         static_cast<float>(input_shape[d]), roi[d], roi[n_dim + d]);
+      if (extrapolation_enabled && (original_idx < 0 || original_idx > input_shape[d] - 1)) {
+        offsets[i] = -1;
+        continue;
       }
+      int64_t input_idx = get_nearest_pixel(original_idx, scales[d] < 1);
+      input_idx = std::max(static_cast<int64_t>(0), std::min(input_idx, input_shape[d] - 1));
+      offsets[i] = input_idx * input_dim_factor;
     }
-    return Status::OK();
+    input_dim_factor *= input_shape[d];
   }
 
-  if (n_dim == 3) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDimensionProcessor(2);
-          bool use_extrapolation = std::any_of(use_extrapolation_value.begin(), use_extrapolation_value.end(),
-                                               [](bool use_extrapolation) {
-                                                 return use_extrapolation == true;
-                                               });
-
-          output[output_idx++] = use_extrapolation ? static_cast<T>(extrapolation_value) : input[input_idx];
-        }
-      }
-    }
-    return Status::OK();
-  }
+  // each unit of work is one row of the innermost axis of the output
+  const int64_t output_width = output_shape[n_dim - 1];
+  const int64_t num_rows = output_width == 0 ? 0 : output_shape.Size() / output_width;
+  const auto& row_offsets = input_offsets[n_dim - 1];
+  const T extrapolation = static_cast<T>(extrapolation_value);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_rows), static_cast<double>(output_width),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          // the input offset of the row from the indices of its outer axes
+          int64_t base_offset = 0;
+          int64_t remaining = row;
+          for (int64_t d = n_dim - 2; d >= 0 && base_offset >= 0; --d) {
+            const int64_t offset = input_offsets[d][remaining % output_shape[d]];
+            base_offset = offset < 0 ? -1 : base_offset + offset;
+            remaining /= output_shape[d];
+          }
 
-  if (n_dim == 4) {
-    if (use_nearest2x_optimization && scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-      UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-      return Status::OK();
-    }
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDimensionProcessor(2);
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            OneDimensionProcessor(3);
-            bool use_extrapolation = std::any_of(use_extrapolation_value.begin(), use_extrapolation_value.end(),
-                                                 [](bool use_extrapolation) {
-                                                   return use_extrapolation == true;
-                                                 });
-
-            output[output_idx++] = use_extrapolation ? static_cast<T>(extrapolation_value) : input[input_idx];
+          T* output_row = output + row * output_width;
+          if (base_offset < 0) {
+            std::fill_n(output_row, output_width, extrapolation);
+            continue;
           }
-        }
-      }
-    }
-    return Status::OK();
-  }
 
-#undef OneDimensionProcessor
-
-  std::vector<int64_t> output_dim_counter(n_dim);
-  output_dim_counter[n_dim - 1] = -1;  // initialize dimension counter
-
-  for (; output_idx < output_shape.Size(); output_idx++) {
-    for (int64_t dim_idx = n_dim - 1; dim_idx >= 0; dim_idx--) {
-      if (++output_dim_counter[dim_idx] < output_shape[dim_idx]) {
-        int64_t current_input_dim_counter = 0;
-        auto original_idx = get_original_coordinate(static_cast<float>(output_dim_counter[dim_idx]), scales[dim_idx],
-                                                    static_cast<float>(output_shape[dim_idx]), static_cast<float>(input_shape[dim_idx]),
-                                                    roi[dim_idx], roi[n_dim + dim_idx]);
-        current_input_dim_counter = get_nearest_pixel(original_idx, scales[dim_idx] < 1);
-        current_input_dim_counter = std::max((int64_t)0,
-                                             std::min(current_input_dim_counter, (input_shape[dim_idx] - 1)));
-
-        if (current_input_dim_counter != input_dim_counters[dim_idx]) {
-          input_idx += (current_input_dim_counter - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-          input_dim_counters[dim_idx] = current_input_dim_counter;
+          const T* input_row = input + base_offset;
+          for (int64_t x = 0; x < output_width; ++x) {
+            const int64_t offset = row_offsets[x];
+            output_row[x] = offset < 0 ? extrapolation : input_row[offset];
+          }
         }
-        break;
-      } else {
-        output_dim_counter[dim_idx] = 0;
-        input_idx += (0 - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-        input_dim_counters[dim_idx] = 0;
-      }
-    }
-
-    output[output_idx] = input[input_idx];
-  }
+      });
 
   return Status::OK();
 }
@@ -278,117 +223,237 @@ Status UpsampleLinear(const T* input,
   return Status::OK();
 }
 
-// The following method supports a 4-D input in 'Linear mode'
-// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
-// the scale values for the outermost 2 dimensions are 1.
-// This is the common use-case where the 4-D input (batched multi-channel images)
-// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
-template <typename T>
-void UpsampleBilinear(int64_t batch_size,
-                      int64_t num_channels,
-                      int64_t input_height,
-                      int64_t input_width,
-                      int64_t output_height,
-                      int64_t output_width,
-                      float height_scale,
-                      float width_scale,
-                      const std::vector<float>& roi,
-                      bool use_extrapolation,
-                      float extrapolation_value,
-                      const T* Xdata,
-                      T* Ydata,
-                      AllocatorPtr& alloc,
-                      GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
+// Per-axis tables of the bilinear interpolation, computed once for all of the channels.
+// For output row y the two input rows are input_width_mul_y1[y] / input_width (weight dy2[y]) and
+// input_width_mul_y2[y] / input_width (weight dy1[y]), and likewise for the columns with in_x1, in_x2, dx2 and dx1.
+struct BilinearParams {
   std::vector<float> x_original;
+  std::vector<float> y_original;
+
+  BufferUniquePtr idx_scale_data_buffer_holder;
+
+  int64_t* input_width_mul_y1;
+  int64_t* input_width_mul_y2;
+
+  int64_t* in_x1;
+  int64_t* in_x2;
+
+  float* dx1;
+  float* dx2;
+
+  float* dy1;
+  float* dy2;
+};
+
+static BilinearParams SetupUpsampleBilinear(int64_t input_height,
+                                            int64_t input_width,
+                                            int64_t output_height,
+                                            int64_t output_width,
+                                            float height_scale,
+                                            float width_scale,
+                                            const std::vector<float>& roi,
+                                            size_t roi_y_index,
+                                            size_t roi_x_index,
+                                            AllocatorPtr& alloc,
+                                            const GetOriginalCoordinateFunc& get_original_coordinate) {
+  BilinearParams p;
+
+  p.x_original.reserve(output_width);
+  p.y_original.reserve(output_height);
 
   size_t idx_buffer_size = 2 * sizeof(int64_t) * (output_height + output_width);
   size_t scale_buffer_size = 2 * sizeof(float_t) * (output_height + output_width);
   auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
-  BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
-  auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = idx_data + output_height;
-  int64_t* in_x1 = idx_data + 2 * output_height;
-  int64_t* in_x2 = idx_data + 2 * output_height + output_width;
-
-  auto* scale_data = reinterpret_cast<float*>(in_x2 + output_width);
-  float* dy1 = scale_data;
-  float* dy2 = scale_data + output_height;
-  float* dx1 = scale_data + 2 * output_height;
-  float* dx2 = scale_data + 2 * output_height + output_width;
-
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
+  p.idx_scale_data_buffer_holder = BufferUniquePtr(inx_scale_data_buffer, BufferDeleter(alloc));
+  auto* idx_data = static_cast<int64_t*>(p.idx_scale_data_buffer_holder.get());
+  p.input_width_mul_y1 = idx_data;
+  p.input_width_mul_y2 = idx_data + output_height;
+  p.in_x1 = idx_data + 2 * output_height;
+  p.in_x2 = idx_data + 2 * output_height + output_width;
+
+  auto* scale_data = reinterpret_cast<float*>(p.in_x2 + output_width);
+  p.dy1 = scale_data;
+  p.dy2 = scale_data + output_height;
+  p.dx1 = scale_data + 2 * output_height;
+  p.dx2 = scale_data + 2 * output_height + output_width;
+
+  auto roi_y_start = roi.size() / 2 + roi_y_index - roi.size();
+  auto roi_y_end = roi_y_index;
   for (int64_t y = 0; y < output_height; ++y) {
     float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
                                          static_cast<float>(output_height), static_cast<float>(input_height),
                                          roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
+    p.y_original.emplace_back(in_y);
     in_y = std::max(0.0f, std::min(in_y, static_cast<float>(input_height - 1)));
 
     const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
     const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
+    p.dy1[y] = std::fabs(in_y - in_y1);
+    p.dy2[y] = std::fabs(in_y - in_y2);
 
     if (in_y1 == in_y2) {
-      dy1[y] = 0.5f;
-      dy2[y] = 0.5f;
+      p.dy1[y] = 0.5f;
+      p.dy2[y] = 0.5f;
     }
 
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
+    p.input_width_mul_y1[y] = input_width * in_y1;
+    p.input_width_mul_y2[y] = input_width * in_y2;
   }
 
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
+  auto roi_x_start = roi.size() / 2 + roi_x_index - roi.size();
+  auto roi_x_end = roi_x_index;
   for (int64_t x = 0; x < output_width; ++x) {
     float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
                                          static_cast<float>(output_width), static_cast<float>(input_width),
                                          roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
+    p.x_original.emplace_back(in_x);
     in_x = std::max(0.0f, std::min(in_x, static_cast<float>(input_width - 1)));
 
-    in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
-    in_x2[x] = std::min(in_x1[x] + 1, input_width - 1);
+    p.in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
+    p.in_x2[x] = std::min(p.in_x1[x] + 1, input_width - 1);
 
-    dx1[x] = std::abs(in_x - in_x1[x]);
-    dx2[x] = std::abs(in_x - in_x2[x]);
-    if (in_x1[x] == in_x2[x]) {
-      dx1[x] = 0.5f;
-      dx2[x] = 0.5f;
+    p.dx1[x] = std::abs(in_x - p.in_x1[x]);
+    p.dx2[x] = std::abs(in_x - p.in_x2[x]);
+    if (p.in_x1[x] == p.in_x2[x]) {
+      p.dx1[x] = 0.5f;
+      p.dx2[x] = 0.5f;
     }
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        for (int64_t x = 0; x < output_width; ++x) {
+  return p;
+}
+
+// The following method supports a 4-D input in 'Linear mode'
+// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
+// the scale values for the outermost 2 dimensions are 1.
+// This is the common use-case where the 4-D input (batched multi-channel images)
+// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+template <typename T>
+void UpsampleBilinear(int64_t batch_size,
+                      int64_t num_channels,
+                      int64_t input_height,
+                      int64_t input_width,
+                      int64_t output_height,
+                      int64_t output_width,
+                      float height_scale,
+                      float width_scale,
+                      const std::vector<float>& roi,
+                      bool use_extrapolation,
+                      float extrapolation_value,
+                      const T* Xdata,
+                      T* Ydata,
+                      AllocatorPtr& alloc,
+                      GetOriginalCoordinateFunc get_original_coordinate,
+                      concurrency::ThreadPool* tp) {
+  BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width, height_scale,
+                                           width_scale, roi, roi.size() - 2, roi.size() - 1, alloc,
+                                           get_original_coordinate);
+
+  // each unit of work is one output row of one channel
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height),
+      static_cast<double>(output_width) * 8, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const int64_t channel = row / output_height;
+          const int64_t y = row % output_height;
+          const T* X = Xdata + channel * input_height * input_width;
+          T* Y = Ydata + row * output_width;
+
           // when use_extrapolation is set and original index of x or y is out of the dim range
           // then use extrapolation_value as the output value.
-          if (use_extrapolation &&
-              ((y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1)) ||
-               (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)))) {
-            Ydata[output_width * y + x] = static_cast<T>(extrapolation_value);
+          const bool y_outside = p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1);
+          if (use_extrapolation && y_outside) {
+            std::fill_n(Y, output_width, static_cast<T>(extrapolation_value));
             continue;
           }
 
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
+          const T* X1 = X + p.input_width_mul_y1[y];
+          const T* X2 = X + p.input_width_mul_y2[y];
+          const float dy1 = p.dy1[y];
+          const float dy2 = p.dy2[y];
+          for (int64_t x = 0; x < output_width; ++x) {
+            if (use_extrapolation &&
+                (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1))) {
+              Y[x] = static_cast<T>(extrapolation_value);
+              continue;
+            }
 
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
+            T X11 = X1[p.in_x1[x]];
+            T X21 = X1[p.in_x2[x]];
+            T X12 = X2[p.in_x1[x]];
+            T X22 = X2[p.in_x2[x]];
+
+            Y[x] = static_cast<T>(p.dx2[x] * dy2 * X11 +
+                                  p.dx1[x] * dy2 * X21 +
+                                  p.dx2[x] * dy1 * X12 +
+                                  p.dx1[x] * dy1 * X22);
+          }
         }
-      }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
-    }
-  }
+      });
+}
+
+// The same as UpsampleBilinear for a 4-D input of shape [N, H, W, C] with scales [1.0, height_scale, width_scale, 1.0].
+// The channels of a pixel are next to each other, so the innermost loop applies the same weights to all of them.
+template <typename T>
+void NhwcUpsampleBilinear(int64_t batch_size,
+                          int64_t num_channels,
+                          int64_t input_height,
+                          int64_t input_width,
+                          int64_t output_height,
+                          int64_t output_width,
+                          float height_scale,
+                          float width_scale,
+                          const std::vector<float>& roi,
+                          bool use_extrapolation,
+                          float extrapolation_value,
+                          const T* Xdata,
+                          T* Ydata,
+                          AllocatorPtr& alloc,
+                          GetOriginalCoordinateFunc get_original_coordinate,
+                          concurrency::ThreadPool* tp) {
+  BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width, height_scale,
+                                           width_scale, roi, roi.size() - 3, roi.size() - 2, alloc,
+                                           get_original_coordinate);
+
+  // each unit of work is one output row of one image
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * output_height),
+      static_cast<double>(output_width * num_channels) * 8, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const int64_t n = row / output_height;
+          const int64_t y = row % output_height;
+          const T* X = Xdata + n * input_height * input_width * num_channels;
+          T* Y = Ydata + row * output_width * num_channels;
+
+          const bool y_outside = p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1);
+          if (use_extrapolation && y_outside) {
+            std::fill_n(Y, output_width * num_channels, static_cast<T>(extrapolation_value));
+            continue;
+          }
+
+          const T* X1 = X + p.input_width_mul_y1[y] * num_channels;
+          const T* X2 = X + p.input_width_mul_y2[y] * num_channels;
+          for (int64_t x = 0; x < output_width; ++x, Y += num_channels) {
+            if (use_extrapolation &&
+                (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1))) {
+              std::fill_n(Y, num_channels, static_cast<T>(extrapolation_value));
+              continue;
+            }
+
+            const float w11 = p.dx2[x] * p.dy2[y];
+            const float w21 = p.dx1[x] * p.dy2[y];
+            const float w12 = p.dx2[x] * p.dy1[y];
+            const float w22 = p.dx1[x] * p.dy1[y];
+            const T* X11 = X1 + p.in_x1[x] * num_channels;
+            const T* X21 = X1 + p.in_x2[x] * num_channels;
+            const T* X12 = X2 + p.in_x1[x] * num_channels;
+            const T* X22 = X2 + p.in_x2[x] * num_channels;
+            for (int64_t c = 0; c < num_channels; ++c) {
+              Y[c] = static_cast<T>(w11 * X11[c] + w21 * X21[c] + w12 * X12[c] + w22 * X22[c]);
+            }
+          }
+        }
+      });
 }
 
 // Calculates cubic coeff based on Robert Keys approach
@@ -403,44 +468,58 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
+// The 4 input positions and weights of the cubic interpolation for one output position along an axis.
+struct CubicTaps {
+  std::array<int64_t, CubicModeGridLength> index;
+  std::array<float, CubicModeGridLength> coeff;
+  bool outside;  // the original coordinate is outside of the input, so extrapolation_value is used
+};
+
+// Compute the taps of every output position of an axis once, so the interpolation of each output value is
+// 16 multiply-adds of precomputed weights. The positions are clamped to the input like the original data
+// accessor did, and when exclude_outside is set the weights are already renormalized.
+static std::vector<CubicTaps> SetupCubicTaps(int64_t input_size,
+                                             int64_t output_size,
+                                             float scale,
+                                             float roi_start,
+                                             float roi_end,
+                                             float cubic_coeff_a,
+                                             bool exclude_outside,
+                                             const GetOriginalCoordinateFunc& get_original_coordinate) {
+  std::vector<CubicTaps> taps(static_cast<size_t>(output_size));
+  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
 
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+  for (int64_t i = 0; i < output_size; ++i) {
+    float in = get_original_coordinate(static_cast<float>(i), scale,
+                                       static_cast<float>(output_size), static_cast<float>(input_size),
+                                       roi_start, roi_end);
+    auto& tap = taps[i];
+    tap.outside = in < 0 || in > static_cast<float>(input_size - 1);
+
+    auto in_int = static_cast<int64_t>(std::floor(in));
+    auto s = in - in_int;
+    auto coeffs = cubic_coeffs.find(s);
+    if (coeffs == cubic_coeffs.end()) {
+      coeffs = cubic_coeffs.emplace(s, GetCubicCoeffs(s, cubic_coeff_a)).first;
+    }
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[i] / coeff_sum * orig_data;
+    float coeff_sum = 0;
+    for (int64_t j = 0, val = in_int - 1; j < static_cast<int64_t>(CubicModeGridLength); ++j, ++val) {
+      tap.index[j] = std::max(static_cast<int64_t>(0), std::min(val, input_size - 1));
+      // When exclude_outside is true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      tap.coeff[j] = (exclude_outside && (val < 0 || val >= input_size)) ? 0.0f : coeffs->second[j];
+      coeff_sum += tap.coeff[j];
+    }
+
+    if (exclude_outside) {
+      for (auto& coeff : tap.coeff) {
+        coeff /= coeff_sum;
+      }
+    }
   }
-  cache[grid_start_pos] = result;
 
-  return result;
+  return taps;
 }
 
 template <typename T>
@@ -460,125 +539,66 @@ void ResizeBiCubic(
     const std::vector<float>& roi,
     const T* Xdata,
     T* Ydata,
-    GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  std::vector<float> x_original;
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+    GetOriginalCoordinateFunc get_original_coordinate,
+    concurrency::ThreadPool* tp) {
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
-                                         static_cast<float>(output_height), static_cast<float>(input_height),
-                                         roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[y] - std::floor(y_original[y]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
-                                         static_cast<float>(output_width), static_cast<float>(input_width),
-                                         roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[x] - std::floor(x_original[x]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[y];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
-
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[i] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[i];
-            y_coeff_sum += y_coeff_holder[i];
-          }
-        }
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[x];
+  const std::vector<CubicTaps> y_taps = SetupCubicTaps(input_height, output_height, height_scale,
+                                                       roi[roi_y_start], roi[roi_y_end], cubic_coeff_a,
+                                                       exclude_outside, get_original_coordinate);
+  const std::vector<CubicTaps> x_taps = SetupCubicTaps(input_width, output_width, width_scale,
+                                                       roi[roi_x_start], roi[roi_x_end], cubic_coeff_a,
+                                                       exclude_outside, get_original_coordinate);
+
+  // each unit of work is one output row of one channel
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height),
+      static_cast<double>(output_width) * 32, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const int64_t channel = row / output_height;
+          const int64_t y = row % output_height;
+          const T* X = Xdata + channel * input_height * input_width;
+          T* Y = Ydata + row * output_width;
+          const CubicTaps& y_tap = y_taps[y];
 
           // when use_extrapolation is set and original index is out of the dim range
           // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
+          if (use_extrapolation && y_tap.outside) {
+            std::fill_n(Y, output_width, static_cast<T>(extrapolation_value));
             continue;
           }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[i] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[i];
-              x_coeff_sum += x_coeff_holder[i];
-            }
+          const T* X_rows[CubicModeGridLength];
+          for (size_t i = 0; i < CubicModeGridLength; ++i) {
+            X_rows[i] = X + y_tap.index[i] * input_width;
           }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[i] / y_coeff_sum;
-          }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
-        }
-      }
+          for (int64_t x = 0; x < output_width; ++x) {
+            const CubicTaps& x_tap = x_taps[x];
+            if (use_extrapolation && x_tap.outside) {
+              Y[x] = static_cast<T>(extrapolation_value);
+              continue;
+            }
 
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
+            // Compute cubic interpolation in x dimension using the x coefficients.
+            // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
+            float result = 0;
+            for (size_t i = 0; i < CubicModeGridLength; ++i) {
+              const T* X_row = X_rows[i];
+              float x_interpolation_result = x_tap.coeff[0] * X_row[x_tap.index[0]] +
+                                             x_tap.coeff[1] * X_row[x_tap.index[1]] +
+                                             x_tap.coeff[2] * X_row[x_tap.index[2]] +
+                                             x_tap.coeff[3] * X_row[x_tap.index[3]];
+              result += x_interpolation_result * y_tap.coeff[i];
+            }
 
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
-  }
+            Y[x] = static_cast<T>(result);
+          }
+        }
+      });
 }
 
 template <typename T>
@@ -588,7 +608,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                                 const std::vector<int64_t>& output_dims) const {
   const auto* X = context->Input<Tensor>(0);
   ORT_ENFORCE(X != nullptr);
-  const std::vector<int64_t>& dims = X->Shape().GetDims();
+  const auto& dims = X->Shape().GetDims();
   ORT_ENFORCE(output_dims.size() == dims.size(), "Rank of input and output tensor should be same.");
 
   Tensor* Y = context->Output(0, output_dims);
@@ -616,7 +636,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
     case UpsampleMode::NN:
       return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, roi,
                                 is_resize_, use_extrapolation_, extrapolation_value_, use_nearest2x_optimization_,
-                                get_original_coordinate_, get_nearest_pixel_);
+                                get_original_coordinate_, get_nearest_pixel_, context->GetOperatorThreadPool());
     case UpsampleMode::LINEAR: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
       //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case
@@ -628,6 +648,19 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         return Status(ONNXRUNTIME, FAIL, oss.str());
       }
 
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+      // a 4-D input that is not scaled in the outermost and innermost dimensions but is in the second one
+      // can only be a batch of images of shape [N, H, W, C]
+      if (dims.size() == 4 && scales[0] == 1.0f && scales[1] != 1.0f && scales[3] == 1.0f) {
+        NhwcUpsampleBilinear(dims[0], dims[3], dims[1], dims[2], output_dims[1], output_dims[2],
+                             scales[1], scales[2], roi, use_extrapolation_, extrapolation_value_,
+                             X->template Data<T>(), Y->template MutableData<T>(), alloc, get_original_coordinate_,
+                             context->GetOperatorThreadPool());
+        return Status::OK();
+      }
+
       bool is_2D = dims.size() == 2;
       const int64_t batch_size = is_2D ? 1 : dims[0];
       const int64_t num_channels = is_2D ? 1 : dims[1];
@@ -636,12 +669,11 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
       const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
 
-      AllocatorPtr alloc;
-      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
       UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
                        is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
                        use_extrapolation_, extrapolation_value_, X->template Data<T>(),
-                       Y->template MutableData<T>(), alloc, get_original_coordinate_);
+                       Y->template MutableData<T>(), alloc, get_original_coordinate_,
+                       context->GetOperatorThreadPool());
       return Status::OK();
     }
     case UpsampleMode::CUBIC: {
@@ -656,7 +688,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                     is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_, use_extrapolation_,
                     extrapolation_value_, exclude_outside_, roi, X->template Data<float>(), Y->template MutableData<float>(),
-                    get_original_coordinate_);
+                    get_original_coordinate_, context->GetOperatorThreadPool());
       return Status::OK();
     }
     default:
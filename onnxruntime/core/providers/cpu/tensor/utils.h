@@ -3,18 +3,21 @@
 
 #pragma once
 #include "gsl/gsl"
+#include "core/framework/op_kernel.h"
+#include "core/framework/packed_strings.h"
 #include "core/framework/utils.h"
 namespace onnxruntime {
 
 struct TensorPitches : std::vector<int64_t> {
   TensorPitches(const Tensor& tensor, size_t rank = 0) : TensorPitches(tensor.Shape(), rank) {}
   TensorPitches(const TensorShape& shape, size_t rank = 0) : TensorPitches(shape.GetDims(), rank) {}
-  TensorPitches(const std::vector<int64_t>& dims, size_t rank = 0)
+  TensorPitches(const std::vector<int64_t>& dims, size_t rank = 0) : TensorPitches(TensorShapeDims(dims), rank) {}
+  TensorPitches(TensorShapeDims dims, size_t rank = 0)
       : std::vector<int64_t>(std::max(rank, dims.size()), 0) {
     Calculate(gsl::span<int64_t>(data(), size()), dims);
   }
 
-  static bool Calculate(gsl::span<int64_t> p, const std::vector<int64_t>& dims) {
+  static bool Calculate(gsl::span<int64_t> p, TensorShapeDims dims) {
     // The pitches is the size of the next inner axis. Aka the amount to move by one of the next inner axis.
     // For a tensor with shape(2,3,4,5) the values would be: (3*4*5, 4*5, 5, 1)
     // Note that the outermost '2' is never used, as you never need to move by the entire size of the outermost axis
@@ -162,8 +165,7 @@ struct SliceIterator {
   SliceIterator(const Tensor& tensor, gsl::span<const int64_t> starts,
                 gsl::span<const int64_t> extents, gsl::span<const int64_t> steps)
       : tensor_(tensor), extents_(extents), skips_(tensor_.Shape(), extents, steps), indices_(extents.size(), 0) {
-    auto& dims = tensor_.Shape().GetDims();
-    Init(dims, starts, steps);
+    Init(tensor_.Shape().GetDims(), starts, steps);
   }
 
   // This construct takes a explicit tensor_shape which might be different from the shape defined in input tensor.
@@ -173,12 +175,11 @@ struct SliceIterator {
   SliceIterator(const Tensor& tensor, const TensorShape& tensor_shape, gsl::span<const int64_t> starts,
                 gsl::span<const int64_t> extents, gsl::span<const int64_t> steps)
       : tensor_(tensor), extents_(extents), skips_(tensor_shape, extents, steps), indices_(extents.size(), 0) {
-    const auto& dims = tensor_shape.GetDims();
-    Init(dims, starts, steps);
+    Init(tensor_shape.GetDims(), starts, steps);
   }
 
   // Initialize initial skip and inner_extent.
-  void Init(const std::vector<int64_t>& dims, gsl::span<const int64_t> starts,
+  void Init(TensorShapeDims dims, gsl::span<const int64_t> starts,
             gsl::span<const int64_t> steps) {
     ORT_ENFORCE(dims.size() == starts.size() &&
                 dims.size() == extents_.size() &&
@@ -272,22 +273,28 @@ inline void CopyCpuTensor(const Tensor* src, Tensor* tgt) {
   if (target != source) {
     auto is_string_type = utils::IsDataTypeString(src->DataType());
     if (is_string_type) {
-      for (int64_t i = 0; i < src->Shape().Size(); ++i)
-        static_cast<std::string*>(target)[i] = static_cast<const std::string*>(source)[i];
+      StringTensorReader reader(*src);
+      StringTensorWriter(*tgt).Append(reader, 0, reader.Size());
     } else {
       memcpy(target, source, static_cast<size_t>(src->Shape().Size() * src->DataType()->Size()));
     }
   }
 }
 
+// Fetch output index for a copy of src with the given shape. A string output is created in the packed layout if the
+// allocation plan allows it, so that CopyCpuTensor doesn't allocate a std::string per element.
+inline Tensor* OutputForCopy(OpKernelContext& context, int index, const Tensor& src, const TensorShape& shape) {
+  return src.IsDataTypeString() ? context.OutputPackedStrings(index, shape, StringTensorLength(src))
+                                : context.Output(index, shape);
+}
+
 // This provides easy sequential iteration over a subset of a tensor given a span of starts, extents & optionally steps
 template <typename T>
 struct WritableSliceIterator {
   WritableSliceIterator(Tensor& tensor, gsl::span<const int64_t> starts,
                         gsl::span<const int64_t> extents, gsl::span<const int64_t> steps)
       : tensor_(tensor), input_(tensor_.template MutableData<T>()), extents_(extents), skips_(tensor_.Shape(), extents, steps), indices_(extents.size(), 0) {
-    auto& dims = tensor_.Shape().GetDims();
-    Init(dims, starts, steps);
+    Init(tensor_.Shape().GetDims(), starts, steps);
   }
 
   // This construct takes a explicit tensor_shape which might be different from the shape defined in input tensor.
@@ -297,12 +304,11 @@ struct WritableSliceIterator {
   WritableSliceIterator(Tensor& tensor, const TensorShape& tensor_shape, gsl::span<const int64_t> starts,
                         gsl::span<const int64_t> extents, gsl::span<const int64_t> steps)
       : tensor_(tensor), input_(tensor_.template MutableData<T>()), extents_(extents), skips_(tensor_shape, extents, steps), indices_(extents.size(), 0) {
-    auto& dims = tensor_shape.GetDims();
-    Init(dims, starts, steps);
+    Init(tensor_shape.GetDims(), starts, steps);
   }
 
   // Initialize initial skip and inner_extent.
-  void Init(const std::vector<int64_t>& dims, gsl::span<const int64_t> starts,
+  void Init(TensorShapeDims dims, gsl::span<const int64_t> starts,
             gsl::span<const int64_t> steps) {
     ORT_ENFORCE(dims.size() == starts.size(),
                 "dims.size()=", dims.size(), " != ", "starts.size()=", starts.size());
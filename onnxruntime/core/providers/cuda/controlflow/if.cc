@@ -39,6 +39,9 @@ Status If::Compute(OpKernelContext* ctx) const {
   // the logic to run the subgraph must be on CPU either way.
   // technically we don't need this override of Compute, but it will be optimized out and it's easier to debug
   // that this implementation is being called with it.
+  // the kernels of the subgraph are queued on the stream of the provider
+  CurrentStreamScope stream_scope(
+      static_cast<const CUDAExecutionProvider*>(Info().GetExecutionProvider())->ComputeStream());
   auto status = onnxruntime::If::Compute(ctx);
   return status;
 }
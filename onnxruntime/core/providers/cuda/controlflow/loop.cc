@@ -52,8 +52,8 @@ static Status ConcatenateGpuOutput(std::vector<OrtValue>& per_iteration_output,
                              " Expected:", per_iteration_shape, " Got:", iteration_data.Shape());
     }
 
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(cur_output, iteration_data.DataRaw(), bytes_per_iteration,
-                                    cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(cur_output, iteration_data.DataRaw(), bytes_per_iteration,
+                                         cudaMemcpyDeviceToDevice, CurrentStream()));
 
     cur_output = static_cast<void*>((static_cast<gsl::byte*>(cur_output) + bytes_per_iteration));
   }
@@ -74,6 +74,9 @@ Status Loop::Compute(OpKernelContext* ctx) const {
   // the logic to run the subgraph must be on CPU either way.
   // technically we don't need this override of Compute, but it will be optimized out and it's easier to debug
   // that this implementation is being called with it.
+  // the kernels of the subgraph are queued on the stream of the provider
+  CurrentStreamScope stream_scope(
+      static_cast<const CUDAExecutionProvider*>(Info().GetExecutionProvider())->ComputeStream());
   auto status = onnxruntime::Loop::Compute(ctx);
   return status;
 }
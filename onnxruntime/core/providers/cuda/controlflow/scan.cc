@@ -17,7 +17,7 @@ Scan<8>::Scan(const OpKernelInfo& info) : onnxruntime::Scan<8>(info) {
   scan::detail::DeviceHelpers helpers;
 
   helpers.set_data_to_zero_func = [](void* data, size_t size_in_bytes) -> Status {
-    CUDA_RETURN_IF_ERROR(cudaMemset(data, 0, size_in_bytes));
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(data, 0, size_in_bytes, CurrentStream()));
     return Status::OK();
   };
 
@@ -47,6 +47,9 @@ Status Scan<8>::Compute(OpKernelContext* ctx) const {
   // the logic to run the subgraph must be on CPU either way.
   // technically we don't need this override of Compute, but it will be optimized out and it's easier to debug
   // that this implementation is being called with it.
+  // the kernels of the subgraph are queued on the stream of the provider
+  CurrentStreamScope stream_scope(
+      static_cast<const CUDAExecutionProvider*>(Info().GetExecutionProvider())->ComputeStream());
   auto status = onnxruntime::Scan<8>::Compute(ctx);
   return status;
 }
@@ -58,6 +61,9 @@ Status Scan<9>::Compute(OpKernelContext* ctx) const {
   // the logic to run the subgraph must be on CPU either way.
   // technically we don't need this override of Compute, but it will be optimized out and it's easier to debug
   // that this implementation is being called with it.
+  // the kernels of the subgraph are queued on the stream of the provider
+  CurrentStreamScope stream_scope(
+      static_cast<const CUDAExecutionProvider*>(Info().GetExecutionProvider())->ComputeStream());
   auto status = onnxruntime::Scan<9>::Compute(ctx);
   return status;
 }
@@ -129,7 +129,7 @@ void BinaryElementWiseNoBroadcastImpl(
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
   _BinaryElementWiseSimple<true, true, T, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           lhs_data,
           rhs_data,
           output_data,
@@ -157,7 +157,7 @@ void BinaryElementWiseImpl(
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
   if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::NoBroadcast)) {
     _BinaryElementWiseSimple<true, true, T, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
             lhs_data,
             rhs_data,
             output_data,
@@ -165,7 +165,7 @@ void BinaryElementWiseImpl(
             N);
   } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftScalar)) {
     _BinaryElementWiseSimple<false, true, T, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
             lhs_data,
             rhs_data,
             output_data,
@@ -173,7 +173,7 @@ void BinaryElementWiseImpl(
             N);
   } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightScalar)) {
     _BinaryElementWiseSimple<true, false, T, FuncT, GridDim::maxThreadsPerBlock,
-                             GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+                             GridDim::maxElementsPerThread><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         lhs_data,
         rhs_data,
         output_data,
@@ -181,7 +181,7 @@ void BinaryElementWiseImpl(
         N);
   } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatch1)) {
     _BinaryElementWiseRhsPerChannelBatch1<T, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
             lhs_data,
             rhs_data,
             fdm_H,
@@ -190,7 +190,7 @@ void BinaryElementWiseImpl(
             N);
   } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatchN)) {
     _BinaryElementWiseRhsPerChannelBatchN<T, FuncT, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
             lhs_data,
             rhs_data,
             fdm_H,
@@ -201,7 +201,7 @@ void BinaryElementWiseImpl(
   } else {
     if (lhs_padded_strides && rhs_padded_strides)
       _BinaryElementWise<T, FuncT, true, true, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
               output_rank_or_simple_broadcast,
               lhs_padded_strides,
               lhs_data,
@@ -213,7 +213,7 @@ void BinaryElementWiseImpl(
               N);
     else if (lhs_padded_strides)
       _BinaryElementWise<T, FuncT, true, false, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
               output_rank_or_simple_broadcast,
               lhs_padded_strides,
               lhs_data,
@@ -225,7 +225,7 @@ void BinaryElementWiseImpl(
               N);
     else
       _BinaryElementWise<T, FuncT, false, true, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+          <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
               output_rank_or_simple_broadcast,
               lhs_padded_strides,
               lhs_data,
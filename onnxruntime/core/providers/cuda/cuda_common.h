@@ -35,6 +35,8 @@ class CudaKernel : public OpKernel {
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override {
+    // the kernels, copies and library calls of the node are queued on the stream of the provider
+    CurrentStreamScope stream_scope(provider_->ComputeStream());
     auto s = ComputeInternal(p_op_kernel_context);
     // use this to precisely locate the node where CUDA failure comes from
     //  if (cudaSuccess != cudaDeviceSynchronize())
@@ -100,7 +102,7 @@ class CudaKernel : public OpKernel {
     Status CopyToGpu() {
       if (cpu_pinned_copy_) {
         gpu_copy_ = op_kernel_->GetScratchBuffer<T>(count_);
-        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice));
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice, CurrentStream()));
         op_kernel_->AddDeferredReleaseCPUPtr(cpu_pinned_copy_.release());
       }
       return Status::OK();
@@ -149,6 +151,8 @@ class CudaKernel : public OpKernel {
 
   inline int GetDeviceId() const { return provider_->GetDeviceId(); }
 
+  inline const CUDAExecutionProviderInfo& GetProviderInfo() const { return provider_->GetInfo(); }
+
  private:
   CUDAExecutionProvider* provider_;
 };
@@ -173,7 +177,7 @@ class ToCudaType<MLFloat16> {
   }
 };
 
-inline bool CalculateFdmStrides(gsl::span<fast_divmod> p, const std::vector<int64_t>& dims) {
+inline bool CalculateFdmStrides(gsl::span<fast_divmod> p, TensorShapeDims dims) {
   int stride = 1;
   if (dims.empty() || p.size() < dims.size())
     return false;
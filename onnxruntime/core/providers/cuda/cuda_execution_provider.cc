@@ -5,11 +5,13 @@
 #include "cuda_execution_provider.h"
 #include "cuda_fence.h"
 #include "cuda_allocator.h"
+#include "core/common/profiler.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/memcpy.h"
 #include "core/graph/graph_utils.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
 
 #ifndef DISABLE_CONTRIB_OPS
 #include "contrib_ops/cuda_contrib_kernels.h"
@@ -43,32 +45,88 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
     Memcpy);
 
+namespace {
+thread_local cudaStream_t current_stream = nullptr;
+}  // namespace
+
+cudaStream_t CurrentStream() {
+  return current_stream;
+}
+
+CurrentStreamScope::CurrentStreamScope(cudaStream_t stream) : previous_(current_stream) {
+  current_stream = stream;
+}
+
+CurrentStreamScope::~CurrentStreamScope() {
+  current_stream = previous_;
+}
+
 }  // namespace cuda
 
+namespace {
+// the provider whose branch the thread runs a node of between StartBranchNode and EndBranchNode, and the scope that
+// makes the stream of the branch the current stream of the thread, also for the fences of the node
+thread_local const CUDAExecutionProvider* branch_provider = nullptr;
+thread_local std::unique_ptr<cuda::CurrentStreamScope> branch_stream_scope;
+}  // namespace
+
 thread_local std::unique_ptr<CUDAExecutionProvider::PerThreadContextMap> CUDAExecutionProvider::per_thread_context_map_;
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id) {
-  CUDA_CALL_THROW(cudaSetDevice(device_id));
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(const CUDAExecutionProviderInfo& info) {
+  CUDA_CALL_THROW(cudaSetDevice(info.device_id));
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
 
   DeviceAllocatorRegistrationInfo default_memory_info(
       {OrtMemTypeDefault,
-       [](int id) { return onnxruntime::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
-  allocator_ = CreateAllocator(default_memory_info, device_id);
+       [](int id) { return onnxruntime::make_unique<CUDAAllocator>(id, CUDA); }, info.cuda_mem_limit,
+       info.arena_extend_strategy, info.arena_initial_chunk_size});
+  allocator_ = CreateAllocator(default_memory_info, info.device_id);
 }
 
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
   CUBLAS_CALL_THROW(cublasDestroy(cublas_handle_));
   CUDNN_CALL_THROW(cudnnDestroy(cudnn_handle_));
+  if (branch_handoff_event_ != nullptr) {
+    CUDA_CALL_THROW(cudaEventDestroy(branch_handoff_event_));
+  }
+}
+
+Status CUDAExecutionProvider::PerThreadContext::SetBranchStream(cudaStream_t stream) {
+  if (has_branch_stream_ && stream != branch_stream_) {
+    if (branch_handoff_event_ == nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&branch_handoff_event_, cudaEventDisableTiming));
+    }
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(branch_handoff_event_, branch_stream_));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(stream, branch_handoff_event_, 0));
+  }
+  branch_stream_ = stream;
+  has_branch_stream_ = true;
+  return Status::OK();
 }
 
 CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id), info_(info) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
+  for (int i = 0; i < info_.branch_stream_count; ++i) {
+    cudaStream_t stream;
+    CUDA_CALL_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    branch_streams_.push_back(stream);
+  }
+
+  if (info_.user_compute_stream != nullptr) {
+    stream_ = info_.user_compute_stream;
+  } else if (info_.enable_cuda_graph) {
+    CUDA_CALL_THROW(cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking));
+    owns_stream_ = true;
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&run_start_event_, cudaEventDisableTiming));
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&run_end_event_, cudaEventDisableTiming));
+  }
+
   DeviceAllocatorRegistrationInfo default_memory_info(
-      {OrtMemTypeDefault, [](int device_id) { return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA); }, std::numeric_limits<size_t>::max()});
+      {OrtMemTypeDefault, [](int device_id) { return onnxruntime::make_unique<CUDAAllocator>(device_id, CUDA); },
+       info.cuda_mem_limit, info.arena_extend_strategy, info.arena_initial_chunk_size});
   InsertAllocator(CreateAllocator(default_memory_info, device_id_));
 
   DeviceAllocatorRegistrationInfo pinned_memory_info(
@@ -87,9 +145,27 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
                                                                                OrtMemTypeCPUInput)); },
                                                    std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(cpu_memory_info, CPU_ALLOCATOR_DEVICE_ID));
+
+  if (!info_.cudnn_conv_algo_cache_file.empty()) {
+    auto status = cuda::CudnnConvAlgoCache::Instance().Load(info_.cudnn_conv_algo_cache_file);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Ignoring the convolution algorithm cache: " << status.ErrorMessage();
+    }
+  }
 }
 
 CUDAExecutionProvider::~CUDAExecutionProvider() {
+  if (stream_ != nullptr) {
+    CUDA_CALL_THROW(cudaStreamSynchronize(stream_));
+  }
+  for (auto& entry : captured_graphs_) {
+    if (entry.second.exec != nullptr) {
+      CUDA_CALL_THROW(cudaGraphExecDestroy(entry.second.exec));
+      entry.second.buffers->FreeKeptBuffers();
+    }
+  }
+  captured_graphs_.clear();
+
   auto cpu_alloc = GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPU);
   std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
   auto it = deferred_release_cpu_ptr_.begin();
@@ -104,6 +180,41 @@ CUDAExecutionProvider::~CUDAExecutionProvider() {
     CUDA_CALL_THROW(cudaEventDestroy(e));
     it = deferred_release_cpu_ptr_.erase(it);
   }
+
+  for (auto e : free_deferred_release_events_) {
+    CUDA_CALL_THROW(cudaEventDestroy(e));
+  }
+
+  // the events of nodes not flushed by EndProfiling are dropped
+  for (auto& record : pending_node_profiling_) {
+    CUDA_CALL_THROW(cudaEventSynchronize(record.stop));
+    CUDA_CALL_THROW(cudaEventDestroy(record.start));
+    CUDA_CALL_THROW(cudaEventDestroy(record.stop));
+  }
+  for (auto e : free_profiling_events_) {
+    CUDA_CALL_THROW(cudaEventDestroy(e));
+  }
+
+  if (!info_.cudnn_conv_algo_cache_file.empty()) {
+    auto status = cuda::CudnnConvAlgoCache::Instance().Save(info_.cudnn_conv_algo_cache_file);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << status.ErrorMessage();
+    }
+  }
+
+  for (auto stream : branch_streams_) {
+    CUDA_CALL_THROW(cudaStreamSynchronize(stream));
+    CUDA_CALL_THROW(cudaStreamDestroy(stream));
+  }
+  for (auto e : free_stream_markers_) {
+    CUDA_CALL_THROW(cudaEventDestroy(e));
+  }
+
+  if (owns_stream_) {
+    CUDA_CALL_THROW(cudaEventDestroy(run_start_event_));
+    CUDA_CALL_THROW(cudaEventDestroy(run_end_event_));
+    CUDA_CALL_THROW(cudaStreamDestroy(stream_));
+  }
 }
 
 CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadContext() const {
@@ -116,7 +227,7 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
     std::lock_guard<OrtMutex> lock(context_pool_mutex_);
     std::shared_ptr<PerThreadContext> ptc;
     if (retired_context_pool_.empty()) {
-      ptc = std::make_shared<PerThreadContext>(device_id_);
+      ptc = std::make_shared<PerThreadContext>(info_);
     } else {
       ptc = retired_context_pool_.back();
       retired_context_pool_.pop_back();
@@ -151,12 +262,69 @@ AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) co
   }
 }
 
+cudaStream_t CUDAExecutionProvider::ComputeStream() const {
+  return branch_provider == this ? cuda::CurrentStream() : stream_;
+}
+
+Status CUDAExecutionProvider::StartBranchNode(int branch, const std::vector<void*>& wait_markers) const {
+  cudaStream_t stream = branch_streams_[branch % branch_streams_.size()];
+  ORT_RETURN_IF_ERROR(GetPerThreadContext().SetBranchStream(stream));
+  for (void* marker : wait_markers) {
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(stream, static_cast<cudaEvent_t>(marker), 0));
+  }
+  // a node that failed before EndBranchNode restores the stream before it
+  branch_stream_scope.reset();
+  branch_stream_scope = onnxruntime::make_unique<cuda::CurrentStreamScope>(stream);
+  branch_provider = this;
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::EndBranchNode() const {
+  branch_stream_scope.reset();
+  branch_provider = nullptr;
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::RecordStreamMarker(void** marker) const {
+  cudaEvent_t event = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(stream_markers_mutex_);
+    if (!free_stream_markers_.empty()) {
+      event = free_stream_markers_.back();
+      free_stream_markers_.pop_back();
+    }
+  }
+  if (event == nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  }
+  *marker = event;
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(event, ComputeStream()));
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::WaitForStreamMarker(void* marker) const {
+  CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(ComputeStream(), static_cast<cudaEvent_t>(marker), 0));
+  return Status::OK();
+}
+
+void CUDAExecutionProvider::ReleaseStreamMarker(void* marker) const {
+  std::lock_guard<OrtMutex> lock(stream_markers_mutex_);
+  free_stream_markers_.push_back(static_cast<cudaEvent_t>(marker));
+}
+
 Status CUDAExecutionProvider::Sync() const {
   CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
   return Status::OK();
 }
 
 void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
+  // the copies from the buffer are replayed with the graph being captured
+  auto& capture_allocator = GetPerThreadContext().GetCaptureAllocator();
+  if (capture_allocator != nullptr) {
+    capture_allocator->KeepCpuPtr(p);
+    return;
+  }
+
   // when not running in InferenceSession (e.g. Test)
   // it's OK to not remember the deferred release ptr
   // as the actual memory will be cleaned in arena allocator dtor
@@ -170,6 +338,22 @@ void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
 }
 
 Status CUDAExecutionProvider::OnRunStart() {
+  if (info_.enable_cuda_graph) {
+    std::unique_lock<OrtMutex> lock(graph_mutex_);
+    graph_capture_done_.wait(lock, [this]() { return !capturing_; });
+    ++active_runs_;
+  }
+  if (owns_stream_) {
+    // the Run waits for the work the caller queued on the legacy default stream, e.g. to fill the inputs
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(run_start_event_, nullptr));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(stream_, run_start_event_, 0));
+  }
+
+  {
+    // time the nodes of this Run from a new reference
+    std::lock_guard<OrtMutex> lock(profiling_mutex_);
+    profiling_reference_.reset();
+  }
   auto cpu_alloc = GetAllocator(0, OrtMemTypeCPU);
   // check if cudaEvents has passed for deferred release
   // note that we need to take a mutex in case of multi-threaded Run()
@@ -183,30 +367,280 @@ Status CUDAExecutionProvider::OnRunStart() {
       for (auto p : v.cpu_ptrs) {
         cpu_alloc->Free(p);
       }
-      cudaEvent_t expired_event = it->first;
+      free_deferred_release_events_.push_back(it->first);
       it = deferred_release_cpu_ptr_.erase(it);
-      CUDA_RETURN_IF_ERROR(cudaEventDestroy(expired_event));
     } else {
       ++it;
     }
   }
 
   auto& current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
-  CUDA_RETURN_IF_ERROR(cudaEventCreate(&current_deferred_release_event, cudaEventDisableTiming));
+  if (!free_deferred_release_events_.empty()) {
+    // an event is re-armed by the cudaEventRecord in OnRunEnd, so one whose work has completed can be reused
+    current_deferred_release_event = free_deferred_release_events_.back();
+    free_deferred_release_events_.pop_back();
+  } else {
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&current_deferred_release_event, cudaEventDisableTiming));
+  }
   deferred_release_cpu_ptr_.emplace(current_deferred_release_event, DeferredReleaseCPUPtrs());
   return Status::OK();
 }
 
 Status CUDAExecutionProvider::OnRunEnd() {
-  // record deferred release event on default stream, and release per_thread_context
+  if (info_.enable_cuda_graph) {
+    std::lock_guard<OrtMutex> lock(graph_mutex_);
+    --active_runs_;
+  }
+  if (owns_stream_) {
+    // the work the caller queues on the legacy default stream after the Run, e.g. to read the outputs, waits for it
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(run_end_event_, stream_));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(nullptr, run_end_event_, 0));
+  }
+
+  // record deferred release event on the stream, and release per_thread_context
   auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
-  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, nullptr));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, stream_));
+  if (info_.arena_shrink_after_run) {
+    // cudaFree synchronizes the device, so a freed region is no longer used by any kernel of this Run
+    auto arena = std::dynamic_pointer_cast<IArenaAllocator>(GetPerThreadContext().GetArenaAllocator());
+    if (arena) {
+      ORT_RETURN_IF_ERROR(arena->Shrink());
+    }
+  }
   ReleasePerThreadStuffs();
-  std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
-  deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  {
+    std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+    deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  }
+  RecordNodeProfilingEvents(false);
   return Status::OK();
 }
 
+Status CUDAExecutionProvider::ShrinkMemoryArenas() {
+  ORT_RETURN_IF_ERROR(IExecutionProvider::ShrinkMemoryArenas());
+  // a Run takes its context out of the pool, and puts it back when it ends
+  std::lock_guard<OrtMutex> lock(context_pool_mutex_);
+  for (auto& context : retired_context_pool_) {
+    auto arena = std::dynamic_pointer_cast<IArenaAllocator>(context->GetArenaAllocator());
+    if (arena) {
+      ORT_RETURN_IF_ERROR(arena->Shrink());
+    }
+  }
+  return Status::OK();
+}
+
+cudaEvent_t CUDAExecutionProvider::GetProfilingEvent() const {
+  // profiling_mutex_ is held by the caller
+  if (!free_profiling_events_.empty()) {
+    cudaEvent_t event = free_profiling_events_.back();
+    free_profiling_events_.pop_back();
+    return event;
+  }
+  cudaEvent_t event;
+  CUDA_CALL_THROW(cudaEventCreate(&event));
+  return event;
+}
+
+void CUDAExecutionProvider::StartNodeProfiling(const onnxruntime::Node& node, profiling::Profiler& profiler) const {
+  auto record = onnxruntime::make_unique<NodeProfilingRecord>();
+  {
+    std::lock_guard<OrtMutex> lock(profiling_mutex_);
+    if (profiling_reference_ == nullptr) {
+      cudaEvent_t event = GetProfilingEvent();
+      CUDA_CALL_THROW(cudaEventRecord(event, stream_));
+      profiling_reference_ = std::shared_ptr<ProfilingReference>(
+          new ProfilingReference{event, std::chrono::high_resolution_clock::now()},
+          [](ProfilingReference* reference) {
+            CUDA_CALL(cudaEventDestroy(reference->event));
+            delete reference;
+          });
+    }
+    record->reference = profiling_reference_;
+    record->start = GetProfilingEvent();
+    record->stop = GetProfilingEvent();
+  }
+  record->node_name = node.Name();
+  record->op_name = node.OpType();
+  record->profiler = &profiler;
+  CUDA_CALL_THROW(cudaEventRecord(record->start, ComputeStream()));
+  GetPerThreadContext().GetCurrentNodeProfiling() = std::move(record);
+}
+
+void CUDAExecutionProvider::EndNodeProfiling(const onnxruntime::Node& /*node*/) const {
+  auto record = std::move(GetPerThreadContext().GetCurrentNodeProfiling());
+  if (record == nullptr) {
+    return;
+  }
+  CUDA_CALL_THROW(cudaEventRecord(record->stop, ComputeStream()));
+  {
+    std::lock_guard<OrtMutex> lock(profiling_mutex_);
+    pending_node_profiling_.push_back(std::move(*record));
+  }
+  RecordNodeProfilingEvents(false);
+}
+
+void CUDAExecutionProvider::FlushNodeProfiling() const {
+  RecordNodeProfilingEvents(true);
+  std::lock_guard<OrtMutex> lock(profiling_mutex_);
+  // the next profiled node records a new reference
+  profiling_reference_.reset();
+}
+
+void CUDAExecutionProvider::GraphCaptureAllocator::Free(void* p) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (freed_) {
+    device_allocator_->Free(p);
+  } else {
+    device_buffers_.push_back(p);
+  }
+}
+
+void CUDAExecutionProvider::GraphCaptureAllocator::KeepCpuPtr(void* p) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  cpu_ptrs_.push_back(p);
+}
+
+void CUDAExecutionProvider::GraphCaptureAllocator::FreeKeptBuffers() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto p : device_buffers_) {
+    device_allocator_->Free(p);
+  }
+  for (auto p : cpu_ptrs_) {
+    cpu_allocator_->Free(p);
+  }
+  device_buffers_.clear();
+  cpu_ptrs_.clear();
+  freed_ = true;
+}
+
+bool CUDAExecutionProvider::IsGraphCaptured(const std::string& key) const {
+  std::lock_guard<OrtMutex> lock(graph_mutex_);
+  auto it = captured_graphs_.find(key);
+  return it != captured_graphs_.end() && it->second.exec != nullptr;
+}
+
+bool CUDAExecutionProvider::IsGraphCapturing() const {
+  if (!info_.enable_cuda_graph) {
+    return false;
+  }
+  std::lock_guard<OrtMutex> lock(graph_mutex_);
+  return capturing_;
+}
+
+bool CUDAExecutionProvider::BeginGraphCapture(const std::string& key) {
+  {
+    std::lock_guard<OrtMutex> lock(graph_mutex_);
+    auto it = captured_graphs_.find(key);
+    if (it == captured_graphs_.end()) {
+      if (captured_graphs_.size() >= kMaxCapturedGraphs) {
+        return false;
+      }
+      it = captured_graphs_.emplace(key, CapturedGraph()).first;
+    }
+    CapturedGraph& graph = it->second;
+    if (graph.failed || graph.exec != nullptr || graph.runs++ < kGraphCaptureWarmupRuns || active_runs_ != 1) {
+      return false;
+    }
+    capturing_ = true;
+  }
+
+  auto& context = GetPerThreadContext();
+  context.GetCaptureAllocator() = std::make_shared<GraphCaptureAllocator>(
+      context.GetArenaAllocator(), GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPU));
+  // only the calls of this thread that are not allowed while capturing fail, the other threads are not affected
+  const cudaError_t result = cudaStreamBeginCapture(stream_, cudaStreamCaptureModeThreadLocal);
+  if (result != cudaSuccess) {
+    LOGS_DEFAULT(WARNING) << "Running without a CUDA graph: " << cudaGetErrorString(result);
+    cudaGetLastError();
+    context.GetCaptureAllocator() = nullptr;
+    std::lock_guard<OrtMutex> lock(graph_mutex_);
+    captured_graphs_[key].failed = true;
+    capturing_ = false;
+    graph_capture_done_.notify_all();
+    return false;
+  }
+  return true;
+}
+
+Status CUDAExecutionProvider::EndGraphCapture(const std::string& key, bool run_succeeded) {
+  auto& context = GetPerThreadContext();
+  std::shared_ptr<GraphCaptureAllocator> buffers = std::move(context.GetCaptureAllocator());
+
+  cudaGraph_t cuda_graph = nullptr;
+  cudaGraphExec_t exec = nullptr;
+  cudaError_t result = cudaStreamEndCapture(stream_, &cuda_graph);
+  if (result == cudaSuccess && run_succeeded) {
+    result = cudaGraphInstantiate(&exec, cuda_graph, nullptr, nullptr, 0);
+  }
+  if (cuda_graph != nullptr) {
+    CUDA_CALL(cudaGraphDestroy(cuda_graph));
+  }
+  // nothing ran while the graph was captured, so the Run is done by its first launch
+  if (result == cudaSuccess && exec != nullptr) {
+    result = cudaGraphLaunch(exec, stream_);
+  }
+  if (result != cudaSuccess) {
+    // clear the error of the capture, so that a later call doesn't report it
+    cudaGetLastError();
+  }
+
+  std::lock_guard<OrtMutex> lock(graph_mutex_);
+  capturing_ = false;
+  graph_capture_done_.notify_all();
+  CapturedGraph& graph = captured_graphs_[key];
+  if (result != cudaSuccess || exec == nullptr) {
+    graph.failed = true;
+    if (exec != nullptr) {
+      CUDA_CALL(cudaGraphExecDestroy(exec));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream_));
+    }
+    buffers->FreeKeptBuffers();
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The Run could not be captured into a CUDA graph: ",
+                           result != cudaSuccess ? cudaGetErrorString(result) : "a kernel failed while capturing");
+  }
+  graph.exec = exec;
+  graph.buffers = std::move(buffers);
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::ReplayGraph(const std::string& key) {
+  // a graph is not launched by two threads at once
+  std::lock_guard<OrtMutex> lock(graph_mutex_);
+  auto it = captured_graphs_.find(key);
+  if (it == captured_graphs_.end() || it->second.exec == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No CUDA graph was captured for the Run");
+  }
+  CUDA_RETURN_IF_ERROR(cudaGraphLaunch(it->second.exec, stream_));
+  return Status::OK();
+}
+
+void CUDAExecutionProvider::RecordNodeProfilingEvents(bool wait) const {
+  std::lock_guard<OrtMutex> lock(profiling_mutex_);
+  // the events complete in stream order, so stop at the first node the device has not completed without waiting. the
+  // nodes on other branch streams may have completed, they are recorded by a later call.
+  while (!pending_node_profiling_.empty()) {
+    auto& record = pending_node_profiling_.front();
+    if (wait) {
+      CUDA_CALL_THROW(cudaEventSynchronize(record.stop));
+    } else if (cudaEventQuery(record.stop) != cudaSuccess) {
+      break;
+    }
+    float offset_ms = 0.0f;
+    float duration_ms = 0.0f;
+    CUDA_CALL_THROW(cudaEventElapsedTime(&offset_ms, record.reference->event, record.start));
+    CUDA_CALL_THROW(cudaEventElapsedTime(&duration_ms, record.start, record.stop));
+    auto start_time = record.reference->host_time +
+                      std::chrono::duration_cast<TimePoint::duration>(std::chrono::duration<double, std::milli>(offset_ms));
+    // each device has its own row in the profile
+    record.profiler->RecordDeviceEvent(profiling::NODE_EVENT, record.node_name + "_device_time", start_time,
+                                       static_cast<long long>(duration_ms * 1000), -1 - device_id_,
+                                       {{"op_name", record.op_name}, {"provider", kCudaExecutionProvider}});
+    free_profiling_events_.push_back(record.start);
+    free_profiling_events_.push_back(record.stop);
+    pending_node_profiling_.pop_front();
+  }
+}
+
 namespace cuda {
 // opset 1 to 9
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
@@ -1261,8 +1695,71 @@ static bool CastNeedFallbackToCPU(const onnxruntime::Node& node) {
   return false;
 }
 
+// The ops that are cheap on the few int64 values of a shape.
+static bool IsShapeComputationOp(const std::string& op_type) {
+  static const std::unordered_set<std::string> shape_computation_ops{
+      "Add", "Cast", "Concat", "ConstantOfShape", "Div", "Equal", "Expand", "Flatten", "Gather", "Identity",
+      "Max", "Min", "Mul", "Range", "ReduceProd", "Reshape", "Slice", "Squeeze", "Sub", "Unsqueeze", "Where"};
+  return shape_computation_ops.count(op_type) > 0;
+}
+
+// Returns the shape computations whose int64 results only reach the inputs that kernels read on CPU, like the
+// shape of a Reshape, directly or through other shape computations. Run on CUDA, their results would be copied
+// back by a MemcpyToHost, which waits on the device.
+static std::unordered_set<NodeIndex> GetCpuShapeComputations(const onnxruntime::GraphViewer& graph,
+                                                             const KernelRegistry& kernel_registry,
+                                                             const std::string& provider_type) {
+  std::unordered_set<const NodeArg*> graph_outputs(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+  std::unordered_set<NodeIndex> shape_computations;
+
+  // the consumers are classified before the nodes that feed them
+  const auto& order = graph.GetNodesInTopologicalOrder();
+  for (auto it = order.crbegin(); it != order.crend(); ++it) {
+    const auto* node = graph.GetNode(*it);
+    if (node == nullptr || !IsShapeComputationOp(node->OpType())) {
+      continue;
+    }
+
+    bool is_shape_computation = true;
+    for (const auto* def : node->OutputDefs()) {
+      const auto* type = def->TypeAsProto();
+      if (type == nullptr || !type->has_tensor_type() ||
+          type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64 ||
+          graph_outputs.count(def) > 0) {
+        is_shape_computation = false;
+        break;
+      }
+    }
+
+    for (auto edge = node->OutputEdgesBegin(); is_shape_computation && edge != node->OutputEdgesEnd(); ++edge) {
+      const auto& consumer = edge->GetNode();
+      if (shape_computations.count(consumer.Index()) > 0) {
+        continue;
+      }
+
+      const auto input_index = static_cast<size_t>(edge->GetDstArgIndex());
+      if (input_index >= consumer.InputDefs().size()) {
+        // an implicit input of a subgraph
+        is_shape_computation = false;
+      } else if (consumer.GetExecutionProviderType().empty() || consumer.GetExecutionProviderType() == provider_type) {
+        // a consumer without a CUDA kernel falls back to CPU
+        const KernelCreateInfo* kernel_create_info = kernel_registry.TryFindKernel(consumer, provider_type);
+        if (kernel_create_info != nullptr && !kernel_create_info->kernel_def->IsInputOnCpu(input_index)) {
+          is_shape_computation = false;
+        }
+      }
+    }
+
+    if (is_shape_computation) {
+      shape_computations.insert(node->Index());
+    }
+  }
+
+  return shape_computations;
+}
+
 std::unique_ptr<onnxruntime::IDataTransfer> CUDAExecutionProvider::GetDataTransfer() const {
-  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>();
+  return onnxruntime::make_unique<onnxruntime::GPUDataTransfer>(stream_);
 }
 
 std::vector<std::unique_ptr<ComputeCapability>>
@@ -1270,6 +1767,7 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
                                      const std::vector<const KernelRegistry*>&) const {
   std::vector<std::unique_ptr<ComputeCapability>> result;
   std::unordered_set<const NodeArg*> defs_outside_cuda;
+  const auto cpu_shape_computations = GetCpuShapeComputations(graph, *GetKernelRegistry(), Type());
 
   for (auto& node_index : graph.GetNodesInTopologicalOrder()) {
     const auto* p_node = graph.GetNode(node_index);
@@ -1315,6 +1813,8 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
       // Ideally, those nodes should be eliminated in constant folding
       bool should_force_outside = true;
       bool all_inputs_are_initializers = true;
+      // a shape computation whose result is read on CPU stays with its inputs on CPU, whatever they are for
+      const bool cpu_shape_computation = cpu_shape_computations.count(node.Index()) > 0;
       node.ForEachWithIndex(node.InputDefs(),
                             [&](const NodeArg& def, size_t index) {
                               // The input is not a initializer and the input is from CPU
@@ -1323,7 +1823,8 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
                               bool initializer_input = graph.IsConstantInitializer(def.Name(), /*check_outer_scope*/ true);
                               bool input_is_on_cpu = defs_outside_cuda.count(&def) > 0;
                               if ((!initializer_input && !input_is_on_cpu) ||
-                                  (input_is_on_cpu && cuda_kernel_def->kernel_def->IsInputOnCpu(index))) {
+                                  (input_is_on_cpu && cuda_kernel_def->kernel_def->IsInputOnCpu(index) &&
+                                   !cpu_shape_computation)) {
                                 should_force_outside = false;
                               }
 
@@ -1333,8 +1834,8 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
                               return Status::OK();
                             });
 
-      // If all the inputs are initializers, we shouldn't force it to CPU
-      if (should_force_outside && !all_inputs_are_initializers) {
+      // If all the inputs are initializers, we shouldn't force it to CPU, unless its result is read on CPU
+      if (should_force_outside && (!all_inputs_are_initializers || cpu_shape_computation)) {
         force_outside = true;
       }
     }
@@ -8,8 +8,10 @@
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "shared_inc/cuda_call.h"
 #include "shared_inc/cuda_utils.h"
 #include <deque>
+#include <limits>
 
 namespace onnxruntime {
 
@@ -18,6 +20,33 @@ const int CPU_ALLOCATOR_DEVICE_ID = 0;
 // Information needed to construct CUDA execution providers.
 struct CUDAExecutionProviderInfo {
   int device_id{0};
+  // maximum size of the device memory arena
+  size_t cuda_mem_limit{std::numeric_limits<size_t>::max()};
+  ArenaExtendStrategy arena_extend_strategy{ArenaExtendStrategy::kNextPowerOfTwo};
+  // size of the first region of the device memory arena
+  size_t arena_initial_chunk_size{1 << 20};
+  // return the unused regions of the device memory arena to CUDA at the end of each Run
+  bool arena_shrink_after_run{false};
+  // file with the cuDNN convolution algorithms found by earlier processes. it is loaded when the provider is created
+  // and rewritten with the algorithms found so far when the provider is destroyed. empty disables the file.
+  std::string cudnn_conv_algo_cache_file;
+  // pick the convolution algorithms that are not cached with the cuDNN heuristics instead of benchmarking them,
+  // which makes the first Run of a new input shape faster at the cost of possibly slower convolutions.
+  bool cudnn_conv_use_heuristic{false};
+  // RNN, GRU and LSTM with batches up to this size run on the persistent kernels of cuDNN, which keep the recurrent
+  // weights on chip across the time steps. 0 disables them.
+  int64_t cudnn_rnn_persist_max_batch_size{0};
+  // record the device work of a Run into a CUDA graph the second time its inputs and outputs are bound to the same
+  // device buffers with the same shapes, and replay the graph for the later Runs instead of launching the kernels.
+  // the provider then runs on a stream of its own, as the legacy default stream cannot be captured.
+  bool enable_cuda_graph{false};
+  // stream of the application to queue the kernels and copies of the provider on, so that its own work on the
+  // stream is ordered with the Runs without synchronizing. the provider does not own it. nullptr uses the legacy
+  // default stream, or a stream of the provider's own if enable_cuda_graph is set.
+  cudaStream_t user_compute_stream{nullptr};
+  // number of streams the branches of the execution plan run on when the session uses parallel execution, so that
+  // the kernels of independent branches run concurrently on the device. 0 runs them all on the compute stream.
+  int branch_stream_count{0};
 };
 
 // Logical device representation.
@@ -34,12 +63,41 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status OnRunEnd() override;
 
+  bool IsGraphCaptureEnabled() const override { return info_.enable_cuda_graph; }
+  bool IsGraphCaptured(const std::string& key) const override;
+  bool IsGraphCapturing() const override;
+  bool BeginGraphCapture(const std::string& key) override;
+  Status EndGraphCapture(const std::string& key, bool run_succeeded) override;
+  Status ReplayGraph(const std::string& key) override;
+
+  // the stream the kernels of the provider are queued on: the stream of the branch the calling thread runs a node
+  // of, else nullptr, the legacy default stream, unless a stream was supplied or CUDA graphs are enabled.
+  cudaStream_t ComputeStream() const;
+
+  // the markers are CUDA events, which are reused once released as a wait only uses the record before it
+  bool UsesBranchStreams() const override { return !branch_streams_.empty(); }
+  Status StartBranchNode(int branch, const std::vector<void*>& wait_markers) const override;
+  Status EndBranchNode() const override;
+  Status RecordStreamMarker(void** marker) const override;
+  Status WaitForStreamMarker(void* marker) const override;
+  void ReleaseStreamMarker(void* marker) const override;
+
+  // also shrinks the device arenas of the per-thread contexts not used by a Run
+  Status ShrinkMemoryArenas() override;
+
+  // time the kernels of the nodes with CUDA events on the stream instead of synchronizing the device. the events of
+  // a node are added to the profiler when the device completed them, checked at the end of each node and Run.
+  void StartNodeProfiling(const onnxruntime::Node& node, profiling::Profiler& profiler) const override;
+  void EndNodeProfiling(const onnxruntime::Node& node) const override;
+  void FlushNodeProfiling() const override;
+
+  // the handles queue their work on the current stream of the calling thread
   cublasHandle_t PerThreadCublasHandle() {
-    return GetPerThreadContext().CublasHandle();
+    return GetPerThreadContext().CublasHandle(cuda::CurrentStream());
   }
 
   cudnnHandle_t PerThreadCudnnHandle() {
-    return GetPerThreadContext().CudnnHandle();
+    return GetPerThreadContext().CudnnHandle(cuda::CurrentStream());
   }
 
   template <typename T>
@@ -66,26 +124,130 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   int GetDeviceId() const { return device_id_; }
 
+  const CUDAExecutionProviderInfo& GetInfo() const { return info_; }
+
  private:
   int device_id_;
+  CUDAExecutionProviderInfo info_;
+
+  // owned by the provider if CUDA graphs are enabled
+  cudaStream_t stream_ = nullptr;
+  // whether stream_ was created by the provider rather than supplied by the application
+  bool owns_stream_ = false;
+  // orders the work of a Run on a stream_ the provider owns with the work queued on the legacy default stream before
+  // and after it. the application orders its work with the Runs on a stream it supplied.
+  cudaEvent_t run_start_event_ = nullptr;
+  cudaEvent_t run_end_event_ = nullptr;
+
+  // non-blocking streams of the branches of the parallel executor, a branch runs on the stream of its index modulo
+  // their number
+  std::vector<cudaStream_t> branch_streams_;
+  mutable std::vector<cudaEvent_t> free_stream_markers_;
+  mutable OrtMutex stream_markers_mutex_;
+
+  // the device allocator of the thread that captures a graph. the device buffers freed and the pinned buffers
+  // released while the graph is captured are the ones its replays use, so they are kept until the graph is destroyed.
+  class GraphCaptureAllocator : public IAllocator {
+   public:
+    GraphCaptureAllocator(AllocatorPtr device_allocator, AllocatorPtr cpu_allocator)
+        : device_allocator_(std::move(device_allocator)), cpu_allocator_(std::move(cpu_allocator)) {}
+
+    void* Alloc(size_t size) override { return device_allocator_->Alloc(size); }
+    void Free(void* p) override;
+    const OrtMemoryInfo& Info() const override { return device_allocator_->Info(); }
+
+    void KeepCpuPtr(void* p);
+
+    // frees the kept buffers, once the device no longer uses them. the buffers freed later are freed right away.
+    void FreeKeptBuffers();
+
+   private:
+    AllocatorPtr device_allocator_;
+    AllocatorPtr cpu_allocator_;
+    std::vector<void*> device_buffers_;
+    std::vector<void*> cpu_ptrs_;
+    bool freed_ = false;
+    OrtMutex mutex_;
+  };
+
+  // the graph recorded for the Runs with a key
+  struct CapturedGraph {
+    // the number of Runs with the key seen before it was captured
+    int runs = 0;
+    // the capture failed, the key runs without a graph
+    bool failed = false;
+    cudaGraphExec_t exec = nullptr;
+    std::shared_ptr<GraphCaptureAllocator> buffers;
+  };
+  // the graphs are captured on the second Run with a key, after the first one did the lazy initializations of the
+  // kernels, such as the cuDNN algorithm searches, that cannot be captured
+  static constexpr int kGraphCaptureWarmupRuns = 1;
+  // a model with dynamic shapes could otherwise capture a graph for every shape
+  static constexpr size_t kMaxCapturedGraphs = 64;
+
+  std::unordered_map<std::string, CapturedGraph> captured_graphs_;
+  // the Runs in progress. a graph is only captured by a Run that is alone on the provider, so that the work of
+  // another Run is not recorded with it, and the Runs wait until the capture is done before they start.
+  int active_runs_ = 0;
+  bool capturing_ = false;
+  // protects captured_graphs_, active_runs_ and the capture state
+  mutable OrtMutex graph_mutex_;
+  OrtCondVar graph_capture_done_;
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
     std::vector<void*> cpu_ptrs;
   };
   std::unordered_map<cudaEvent_t, DeferredReleaseCPUPtrs> deferred_release_cpu_ptr_;
+  // events of completed deferred releases, reused by later runs instead of creating a new event for each Run
+  std::vector<cudaEvent_t> free_deferred_release_events_;
+  // protects deferred_release_cpu_ptr_ and free_deferred_release_events_
   OrtMutex deferred_release_cpu_ptr_mutex_;
 
+  // the host time of an event recorded on the stream, which converts the device times measured from it to the host
+  // clock. a new one is recorded for the first node profiled in each Run, so that the offset does not drift.
+  struct ProfilingReference {
+    cudaEvent_t event;
+    TimePoint host_time;
+  };
+
+  struct NodeProfilingRecord {
+    std::string node_name;
+    std::string op_name;
+    profiling::Profiler* profiler;
+    std::shared_ptr<ProfilingReference> reference;
+    cudaEvent_t start;
+    cudaEvent_t stop;
+  };
+
+  cudaEvent_t GetProfilingEvent() const;
+  void RecordNodeProfilingEvents(bool wait) const;
+
+  mutable std::shared_ptr<ProfilingReference> profiling_reference_;
+  // the nodes whose events were queued on the streams, in the order they were queued
+  mutable std::deque<NodeProfilingRecord> pending_node_profiling_;
+  mutable std::vector<cudaEvent_t> free_profiling_events_;
+  // protects profiling_reference_, pending_node_profiling_ and free_profiling_events_
+  mutable OrtMutex profiling_mutex_;
+
   class PerThreadContext final {
    public:
-    PerThreadContext(int device_id);
+    PerThreadContext(const CUDAExecutionProviderInfo& info);
     ~PerThreadContext();
 
-    cublasHandle_t CublasHandle() const {
+    cublasHandle_t CublasHandle(cudaStream_t stream) {
+      if (stream != cublas_stream_) {
+        CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, stream));
+        cublas_stream_ = stream;
+      }
       return cublas_handle_;
     }
 
-    cudnnHandle_t CudnnHandle() const {
+    cudnnHandle_t CudnnHandle(cudaStream_t stream) {
+      if (stream != cudnn_stream_) {
+        CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, stream));
+        cudnn_stream_ = stream;
+      }
       return cudnn_handle_;
     }
 
@@ -93,6 +255,11 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return current_deferred_release_event_;
     }
 
+    // the node of this thread whose start event was queued by StartNodeProfiling
+    std::unique_ptr<NodeProfilingRecord>& GetCurrentNodeProfiling() {
+      return current_node_profiling_;
+    }
+
     template <typename T>
     const T* GetConstOnes(size_t count) {
       if (std::is_same<T, float>::value) {
@@ -115,24 +282,48 @@ class CUDAExecutionProvider : public IExecutionProvider {
       }
     }
 
+    // the allocator that keeps the buffers of the graph this thread is capturing, if it is capturing one
     AllocatorPtr GetAllocator() const {
+      return capture_allocator_ != nullptr ? capture_allocator_ : allocator_;
+    }
+
+    AllocatorPtr GetArenaAllocator() const {
       return allocator_;
     }
 
+    std::shared_ptr<GraphCaptureAllocator>& GetCaptureAllocator() {
+      return capture_allocator_;
+    }
+
+    // makes the work this context queues on the branch stream wait for the work it queued on the previous one, as
+    // the arena may hand a buffer a kernel on the previous stream still uses to a kernel on this one
+    Status SetBranchStream(cudaStream_t stream);
+
    private:
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
+    // the streams the handles were last set to
+    cudaStream_t cublas_stream_ = nullptr;
+    cudaStream_t cudnn_stream_ = nullptr;
 
     // deferred release for temporary CPU pinned memory used in cudaMemcpyAsync
     // note that cudaEvent will be assigned at OnRunEnd() when PerThreadContext destory
     // so the ownership is passed to deferred_release_cpu_ptr_
     cudaEvent_t current_deferred_release_event_ = nullptr;
 
+    std::unique_ptr<NodeProfilingRecord> current_node_profiling_;
+
     std::unique_ptr<cuda::IConstantBuffer<float>> constant_ones_float_;
     std::unique_ptr<cuda::IConstantBuffer<double>> constant_ones_double_;
     std::unique_ptr<cuda::IConstantBuffer<half>> constant_ones_half_;
 
     AllocatorPtr allocator_;
+    std::shared_ptr<GraphCaptureAllocator> capture_allocator_;
+
+    // the branch stream this context last queued work on
+    cudaStream_t branch_stream_ = nullptr;
+    bool has_branch_stream_ = false;
+    cudaEvent_t branch_handoff_event_ = nullptr;
   };
 
   // thread local context during execution
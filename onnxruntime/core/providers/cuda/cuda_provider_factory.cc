@@ -11,23 +11,51 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct CUDAProviderFactory : IExecutionProviderFactory {
-  CUDAProviderFactory(int device_id) : device_id_(device_id) {}
+  CUDAProviderFactory(const CUDAExecutionProviderInfo& info) : info_(info) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  int device_id_;
+  CUDAExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
-  CUDAExecutionProviderInfo info;
-  info.device_id = device_id_;
-  return onnxruntime::make_unique<CUDAExecutionProvider>(info);
+  return onnxruntime::make_unique<CUDAExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(const CUDAExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id);
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  return CreateExecutionProviderFactory_CUDA(info);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id, size_t cuda_mem_limit,
+                                                                               ArenaExtendStrategy arena_extend_strategy) {
+  return CreateExecutionProviderFactory_CUDA(device_id, cuda_mem_limit, arena_extend_strategy, "", false, 0, false, 0);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id, size_t cuda_mem_limit,
+                                                                               ArenaExtendStrategy arena_extend_strategy,
+                                                                               const std::string& cudnn_conv_algo_cache_file,
+                                                                               bool cudnn_conv_use_heuristic,
+                                                                               int64_t cudnn_rnn_persist_max_batch_size,
+                                                                               bool enable_cuda_graph,
+                                                                               int branch_stream_count) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.cuda_mem_limit = cuda_mem_limit;
+  info.arena_extend_strategy = arena_extend_strategy;
+  info.cudnn_conv_algo_cache_file = cudnn_conv_algo_cache_file;
+  info.cudnn_conv_use_heuristic = cudnn_conv_use_heuristic;
+  info.cudnn_rnn_persist_max_batch_size = cudnn_rnn_persist_max_batch_size;
+  info.enable_cuda_graph = enable_cuda_graph;
+  info.branch_stream_count = branch_stream_count;
+  return CreateExecutionProviderFactory_CUDA(info);
 }
 
 }  // namespace onnxruntime
@@ -36,3 +64,12 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessi
   options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(device_id));
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream, _In_ OrtSessionOptions* options,
+                    int device_id, _In_ void* compute_stream) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.user_compute_stream = static_cast<cudaStream_t>(compute_stream);
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
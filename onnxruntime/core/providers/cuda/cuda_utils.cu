@@ -31,7 +31,35 @@ void Fill(T* output, T value, int64_t count) {
   int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
   _Fill<T, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(output, value, N);
+      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output, value, N);
+}
+
+__global__ void _BatchedDeviceCopy(const DeviceCopyBatch batch) {
+  const DeviceCopyItem item = batch.items[blockIdx.x];
+  const char* src = static_cast<const char*>(item.src);
+  char* dst = static_cast<char*>(item.dst);
+
+  // 16 byte loads and stores when both buffers allow them, then the remaining bytes
+  size_t vectorized_bytes = 0;
+  if ((reinterpret_cast<uintptr_t>(src) | reinterpret_cast<uintptr_t>(dst)) % sizeof(uint4) == 0) {
+    const size_t count = item.bytes / sizeof(uint4);
+    const uint4* src_vectors = reinterpret_cast<const uint4*>(src);
+    uint4* dst_vectors = reinterpret_cast<uint4*>(dst);
+    for (size_t i = threadIdx.x; i < count; i += blockDim.x) {
+      dst_vectors[i] = src_vectors[i];
+    }
+    vectorized_bytes = count * sizeof(uint4);
+  }
+
+  for (size_t i = vectorized_bytes + threadIdx.x; i < item.bytes; i += blockDim.x) {
+    dst[i] = src[i];
+  }
+}
+
+void BatchedDeviceCopy(const DeviceCopyBatch& batch, cudaStream_t stream) {
+  if (batch.count > 0) {
+    _BatchedDeviceCopy<<<batch.count, GridDim::maxThreadsPerBlock, 0, stream>>>(batch);
+  }
 }
 template <typename T>
 class ConstantBufferImpl : public IConstantBuffer<T> {
@@ -118,7 +118,7 @@ cublasStatus_t cublasTransposeHelper(cublasHandle_t, cublasOperation_t, cublasOp
     dim3 dimGrid((n + TRANS_TILE_DIM - 1) / TRANS_TILE_DIM, (m + TRANS_TILE_DIM - 1) / TRANS_TILE_DIM, 1);
     dim3 dimBlock(TRANS_TILE_DIM, BLOCK_ROWS, 1);
 
-    transposeNoOverlap<<<dimGrid, dimBlock>>>(C, A, n, m);
+    transposeNoOverlap<<<dimGrid, dimBlock, 0, onnxruntime::cuda::CurrentStream()>>>(C, A, n, m);
   } else {
     return CUBLAS_STATUS_NOT_SUPPORTED;
   }
@@ -128,18 +128,18 @@ cublasStatus_t cublasTransposeHelper(cublasHandle_t, cublasOperation_t, cublasOp
 cublasStatus_t cublasCopyHelper(cublasHandle_t, int n, const half* x, int incx, half* y, int incy) {
   dim3 dimGrid((unsigned int)(n + COPY_BLOCK_DIM - 1) / COPY_BLOCK_DIM, 1, 1);
   dim3 dimBlock(COPY_BLOCK_DIM, 1, 1);
-  CopyVectorHalf<<<dimGrid, dimBlock>>>(x, incx, y, incy, n);
+  CopyVectorHalf<<<dimGrid, dimBlock, 0, onnxruntime::cuda::CurrentStream()>>>(x, incx, y, incy, n);
   return CUBLAS_STATUS_SUCCESS;
 }
 
 curandStatus_t curandGenerateUniformHelper(curandGenerator_t, half* outputPtr, size_t num) {
   curandState* devStates;
   cudaMalloc((void**)&devStates, sizeof(curandState));
-  setup_state<<<1, 1>>>(devStates, time(NULL));  // What does curandGenerateUniform actually doing? should also pass in state here
+  setup_state<<<1, 1, 0, onnxruntime::cuda::CurrentStream()>>>(devStates, time(NULL));  // What does curandGenerateUniform actually doing? should also pass in state here
 
   dim3 dimGrid((unsigned int)(num + COPY_BLOCK_DIM - 1) / COPY_BLOCK_DIM, 1, 1);
   dim3 dimBlock(COPY_BLOCK_DIM, 1, 1);
-  GenerateUniformHalf<<<dimGrid, dimBlock>>>(devStates, outputPtr, (int)num);
+  GenerateUniformHalf<<<dimGrid, dimBlock, 0, onnxruntime::cuda::CurrentStream()>>>(devStates, outputPtr, (int)num);
 
   return (curandStatus_t)0;
 }
@@ -147,11 +147,11 @@ curandStatus_t curandGenerateUniformHelper(curandGenerator_t, half* outputPtr, s
 curandStatus_t curandGenerateNormalHelper(curandGenerator_t, half* outputPtr, size_t n, half mean, half stddev) {
   curandState* devStates;
   cudaMalloc((void**)&devStates, sizeof(curandState));
-  setup_state<<<1, 1>>>(devStates, time(NULL));  // What does curandGenerateUniform actually doing? should also pass in state here
+  setup_state<<<1, 1, 0, onnxruntime::cuda::CurrentStream()>>>(devStates, time(NULL));  // What does curandGenerateUniform actually doing? should also pass in state here
 
   dim3 dimGrid((unsigned int)(n + COPY_BLOCK_DIM - 1) / COPY_BLOCK_DIM, 1, 1);
   dim3 dimBlock(COPY_BLOCK_DIM, 1, 1);
-  GenerateNormalHalf<<<dimGrid, dimBlock>>>(devStates, outputPtr, (int)n, mean, stddev);
+  GenerateNormalHalf<<<dimGrid, dimBlock, 0, onnxruntime::cuda::CurrentStream()>>>(devStates, outputPtr, (int)n, mean, stddev);
 
   return (curandStatus_t)0;
 }
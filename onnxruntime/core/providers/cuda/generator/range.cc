@@ -50,15 +50,19 @@ static Status ComputeRange(OpKernelContext* ctx) {
   // Start, Limit and Delta are stored in GPU. So we need copy it to CPU to read.
   // It is better to store these tensors in pinned memory or CPU for better performance.
   T start;
-  CUDA_RETURN_IF_ERROR(cudaMemcpy(&start, start_tensor.template Data<T>(), sizeof(T), cudaMemcpyDeviceToHost));
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(&start, start_tensor.template Data<T>(), sizeof(T), cudaMemcpyDeviceToHost,
+                                       CurrentStream()));
 
   T limit;
-  CUDA_RETURN_IF_ERROR(cudaMemcpy(&limit, limit_tensor.template Data<T>(), sizeof(T), cudaMemcpyDeviceToHost));
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(&limit, limit_tensor.template Data<T>(), sizeof(T), cudaMemcpyDeviceToHost,
+                                       CurrentStream()));
 
   T delta = T(1);
   if (delta_tensor_ptr != nullptr) {
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(&delta, delta_tensor_ptr->template Data<T>(), sizeof(T), cudaMemcpyDeviceToHost));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(&delta, delta_tensor_ptr->template Data<T>(), sizeof(T),
+                                         cudaMemcpyDeviceToHost, CurrentStream()));
   }
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(CurrentStream()));
 
   if (delta == T(0)) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "delta in Range operator can not be zero!");
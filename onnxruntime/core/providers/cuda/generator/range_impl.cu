@@ -25,7 +25,7 @@ template <typename T>
 bool RangeImpl(const T start, const T delta, const int count, T* output) {
   constexpr int block_size = 256;
   int grid_size = (count + block_size - 1) / block_size;
-  RangeKernel<T><<<grid_size, block_size, 0>>>(start, delta, count, output);
+  RangeKernel<T><<<grid_size, block_size, 0, CurrentStream()>>>(start, delta, count, output);
   return CUDA_CALL(cudaPeekAtLastError());
 }
 
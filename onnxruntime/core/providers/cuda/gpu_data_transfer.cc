@@ -2,17 +2,65 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
 #include "cuda_common.h"
 
 namespace onnxruntime {
-GPUDataTransfer::GPUDataTransfer() {
-  // create streams, default is nullptr
-  streams_[kCudaStreamDefault] = nullptr;
+
+namespace {
+bool IsPageableHost(const OrtDevice& device) {
+  return device.Type() == OrtDevice::CPU && device.MemType() != OrtDevice::MemType::CUDA_PINNED;
+}
+
+size_t AlignOffset(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// the number of tensors from indices[begin] on that fit in max_bytes of staging buffer, and the bytes they take
+size_t GetBatchEnd(const std::vector<const Tensor*>& src, const std::vector<size_t>& indices, size_t begin,
+                   size_t max_bytes, size_t alignment, size_t& bytes) {
+  size_t end = begin;
+  bytes = 0;
+  while (end < indices.size()) {
+    const size_t offset = AlignOffset(bytes, alignment);
+    const size_t tensor_bytes = src[indices[end]]->SizeInBytes();
+    if (end > begin && offset + tensor_bytes > max_bytes) {
+      break;
+    }
+    bytes = offset + tensor_bytes;
+    ++end;
+  }
+  return end;
+}
+}  // namespace
+
+GPUDataTransfer::GPUDataTransfer(cudaStream_t compute_stream) {
+  // create the copy streams, the default one is owned by the provider
+  streams_[kCudaStreamDefault] = compute_stream;
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyIn], cudaStreamNonBlocking));
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyOut], cudaStreamNonBlocking));
 }
 
 GPUDataTransfer::~GPUDataTransfer() {
+  if (batch_staging_.copy_done) {
+    CUDA_CALL(cudaEventSynchronize(batch_staging_.copy_done));
+    CUDA_CALL(cudaEventDestroy(batch_staging_.copy_done));
+  }
+  if (batch_staging_.host_data) {
+    CUDA_CALL(cudaFreeHost(batch_staging_.host_data));
+    CUDA_CALL(cudaFree(batch_staging_.device_data));
+  }
+
+  for (auto& buffer : staging_buffers_) {
+    if (buffer.copy_done) {
+      CUDA_CALL(cudaEventSynchronize(buffer.copy_done));
+      CUDA_CALL(cudaEventDestroy(buffer.copy_done));
+    }
+    if (buffer.data) {
+      CUDA_CALL(cudaFreeHost(buffer.data));
+    }
+  }
+
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyOut]));
 }
@@ -22,6 +70,41 @@ bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_
          || dst_device.Type() == OrtDevice::GPU || dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED;
 }
 
+common::Status GPUDataTransfer::CopyFromPageableHost(void* dst_data, const void* src_data, size_t bytes,
+                                                     cudaStream_t stream) const {
+  if (bytes > kMaxStagingBytes) {
+    // this returns once the source has been staged by the driver
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, stream));
+    return common::Status::OK();
+  }
+
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  StagingBuffer& buffer = staging_buffers_[next_staging_buffer_];
+  next_staging_buffer_ = (next_staging_buffer_ + 1) % kNumStagingBuffers;
+
+  if (buffer.copy_done) {
+    // wait for the previous copy from this buffer
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copy_done));
+  } else {
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&buffer.copy_done, cudaEventDisableTiming));
+  }
+
+  if (buffer.size < bytes) {
+    if (buffer.data) {
+      CUDA_RETURN_IF_ERROR(cudaFreeHost(buffer.data));
+      buffer.data = nullptr;
+      buffer.size = 0;
+    }
+    CUDA_RETURN_IF_ERROR(cudaMallocHost(&buffer.data, bytes));
+    buffer.size = bytes;
+  }
+
+  memcpy(buffer.data, src_data, bytes);
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, buffer.data, bytes, cudaMemcpyHostToDevice, stream));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copy_done, stream));
+  return common::Status::OK();
+}
+
 common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const {
   size_t bytes = src.SizeInBytes();
   const void* src_data = src.DataRaw();
@@ -33,21 +116,23 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
   if (dst_device.Type() == OrtDevice::GPU) {
     if (src_device.Type() == OrtDevice::CPU && src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copy from pinned memory to GPU, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, GetStream(exec_queue_id)));
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, GetStream(kCudaStreamDefault)));
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU through a pinned staging buffer, this is non-blocking once staged
+      ORT_RETURN_IF_ERROR(CopyFromPageableHost(dst_data, src_data, bytes, GetStream(exec_queue_id)));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copying from GPU to pinned memory, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, GetStream(exec_queue_id)));
     } else {
       // copying from GPU to CPU memory, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+      cudaStream_t stream = GetStream(kCudaStreamDefault);
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, stream));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
     }
   } else {
     // copying between cpu memory
@@ -57,4 +142,176 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::ReserveBatchStaging(size_t bytes) const {
+  if (batch_staging_.copy_done) {
+    // wait for the previous batch, which may still be copying from or scattering out of the buffers
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(batch_staging_.copy_done));
+  } else {
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&batch_staging_.copy_done, cudaEventDisableTiming));
+  }
+
+  if (batch_staging_.size < bytes) {
+    if (batch_staging_.host_data) {
+      CUDA_RETURN_IF_ERROR(cudaFreeHost(batch_staging_.host_data));
+      CUDA_RETURN_IF_ERROR(cudaFree(batch_staging_.device_data));
+      batch_staging_.host_data = nullptr;
+      batch_staging_.device_data = nullptr;
+      batch_staging_.size = 0;
+    }
+    CUDA_RETURN_IF_ERROR(cudaMallocHost(&batch_staging_.host_data, bytes));
+    CUDA_RETURN_IF_ERROR(cudaMalloc(&batch_staging_.device_data, bytes));
+    batch_staging_.size = bytes;
+  }
+
+  return common::Status::OK();
+}
+
+common::Status GPUDataTransfer::CopyBatchToDevice(const std::vector<const Tensor*>& src,
+                                                  const std::vector<Tensor*>& dst,
+                                                  const std::vector<size_t>& indices) const {
+  cudaStream_t stream = GetStream(kCudaStreamDefault);
+  std::lock_guard<OrtMutex> lock(batch_staging_mutex_);
+
+  size_t begin = 0;
+  while (begin < indices.size()) {
+    size_t bytes = 0;
+    const size_t end = GetBatchEnd(src, indices, begin, kMaxStagingBytes, kBatchAlignment, bytes);
+    ORT_RETURN_IF_ERROR(ReserveBatchStaging(bytes));
+    char* host_data = static_cast<char*>(batch_staging_.host_data);
+    char* device_data = static_cast<char*>(batch_staging_.device_data);
+
+    // pack on the host, move everything with one transfer, and scatter on the device
+    size_t offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      offset = AlignOffset(offset, kBatchAlignment);
+      const Tensor& tensor = *src[indices[i]];
+      memcpy(host_data + offset, tensor.DataRaw(), tensor.SizeInBytes());
+      offset += tensor.SizeInBytes();
+    }
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(device_data, host_data, bytes, cudaMemcpyHostToDevice, stream));
+
+    cuda::DeviceCopyBatch batch;
+    batch.count = 0;
+    offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      offset = AlignOffset(offset, kBatchAlignment);
+      const size_t tensor_bytes = src[indices[i]]->SizeInBytes();
+      batch.items[batch.count++] = {device_data + offset, dst[indices[i]]->MutableDataRaw(), tensor_bytes};
+      offset += tensor_bytes;
+      if (batch.count == cuda::DeviceCopyBatch::kMaxItems) {
+        cuda::BatchedDeviceCopy(batch, stream);
+        batch.count = 0;
+      }
+    }
+    cuda::BatchedDeviceCopy(batch, stream);
+    CUDA_RETURN_IF_ERROR(cudaGetLastError());
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(batch_staging_.copy_done, stream));
+
+    begin = end;
+  }
+
+  return common::Status::OK();
+}
+
+common::Status GPUDataTransfer::CopyBatchToHost(const std::vector<const Tensor*>& src,
+                                                const std::vector<Tensor*>& dst,
+                                                const std::vector<size_t>& indices) const {
+  // the default stream has the kernels that produced the tensors, like the copy of CopyTensor
+  cudaStream_t stream = GetStream(kCudaStreamDefault);
+  std::lock_guard<OrtMutex> lock(batch_staging_mutex_);
+
+  size_t begin = 0;
+  while (begin < indices.size()) {
+    size_t bytes = 0;
+    const size_t end = GetBatchEnd(src, indices, begin, kMaxStagingBytes, kBatchAlignment, bytes);
+    ORT_RETURN_IF_ERROR(ReserveBatchStaging(bytes));
+    char* host_data = static_cast<char*>(batch_staging_.host_data);
+    char* device_data = static_cast<char*>(batch_staging_.device_data);
+
+    // gather on the device, move everything with one transfer, synchronize once, and unpack on the host
+    cuda::DeviceCopyBatch batch;
+    batch.count = 0;
+    size_t offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      offset = AlignOffset(offset, kBatchAlignment);
+      const Tensor& tensor = *src[indices[i]];
+      batch.items[batch.count++] = {tensor.DataRaw(), device_data + offset, tensor.SizeInBytes()};
+      offset += tensor.SizeInBytes();
+      if (batch.count == cuda::DeviceCopyBatch::kMaxItems) {
+        cuda::BatchedDeviceCopy(batch, stream);
+        batch.count = 0;
+      }
+    }
+    cuda::BatchedDeviceCopy(batch, stream);
+    CUDA_RETURN_IF_ERROR(cudaGetLastError());
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(host_data, device_data, bytes, cudaMemcpyDeviceToHost, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(batch_staging_.copy_done, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(batch_staging_.copy_done));
+
+    offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      offset = AlignOffset(offset, kBatchAlignment);
+      Tensor& tensor = *dst[indices[i]];
+      memcpy(tensor.MutableDataRaw(), host_data + offset, tensor.SizeInBytes());
+      offset += tensor.SizeInBytes();
+    }
+
+    begin = end;
+  }
+
+  return common::Status::OK();
+}
+
+common::Status GPUDataTransfer::CopyTensors(const std::vector<const Tensor*>& src,
+                                            const std::vector<Tensor*>& dst) const {
+  ORT_RETURN_IF_NOT(src.size() == dst.size(), "Number of source and destination tensors mismatch");
+
+  int current_device = 0;
+  CUDA_RETURN_IF_ERROR(cudaGetDevice(&current_device));
+  bool can_batch = false;
+  {
+    // the batch staging buffers stay on the device they were first used on
+    std::lock_guard<OrtMutex> lock(batch_staging_mutex_);
+    if (batch_staging_.device_id < 0) {
+      batch_staging_.device_id = current_device;
+    }
+    can_batch = batch_staging_.device_id == current_device;
+  }
+
+  std::vector<size_t> to_device;
+  std::vector<size_t> to_host;
+  for (size_t i = 0; i < src.size(); ++i) {
+    const auto& src_device = src[i]->Location().device;
+    const auto& dst_device = dst[i]->Location().device;
+    const size_t bytes = src[i]->SizeInBytes();
+    if (can_batch && bytes > 0 && bytes <= kMaxBatchedTensorBytes) {
+      if (IsPageableHost(src_device) && dst_device.Type() == OrtDevice::GPU && dst_device.Id() == current_device) {
+        to_device.push_back(i);
+        continue;
+      }
+      if (src_device.Type() == OrtDevice::GPU && src_device.Id() == current_device && IsPageableHost(dst_device)) {
+        to_host.push_back(i);
+        continue;
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(CopyTensor(*src[i], *dst[i], kCudaStreamDefault));
+  }
+
+  // a batch of one tensor gains nothing over a plain copy
+  if (to_device.size() == 1) {
+    ORT_RETURN_IF_ERROR(CopyTensor(*src[to_device[0]], *dst[to_device[0]], kCudaStreamDefault));
+  } else if (!to_device.empty()) {
+    ORT_RETURN_IF_ERROR(CopyBatchToDevice(src, dst, to_device));
+  }
+
+  if (to_host.size() == 1) {
+    ORT_RETURN_IF_ERROR(CopyTensor(*src[to_host[0]], *dst[to_host[0]], kCudaStreamDefault));
+  } else if (!to_host.empty()) {
+    ORT_RETURN_IF_ERROR(CopyBatchToHost(src, dst, to_host));
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
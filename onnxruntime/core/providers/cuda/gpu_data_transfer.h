@@ -5,6 +5,8 @@
 
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
 
 namespace onnxruntime {
 
@@ -17,20 +19,74 @@ enum CUDAStreamType : int {
 
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer();
+  // compute_stream is the stream of the default queue, on which the provider runs the kernels
+  explicit GPUDataTransfer(cudaStream_t compute_stream = nullptr);
   ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
 
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const override;
 
+  // Small tensors copied between pageable host memory and the current device are packed into a pinned staging
+  // buffer and moved with a single transfer, and a kernel scatters them on the device (or gathers them before a
+  // copy to the host). The copies to the host are synchronized once for the whole batch.
+  using IDataTransfer::CopyTensors;
+  common::Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst) const override;
+
+  // the stream of the default queue is the current stream of the calling thread if it has one, so that a copy made
+  // by a kernel is ordered with the kernels on the stream the node runs on
   cudaStream_t GetStream(int queue_id) const {
     ORT_ENFORCE(queue_id >= 0 && queue_id < kTotalCudaStreams);
+    if (queue_id == kCudaStreamDefault) {
+      cudaStream_t current_stream = cuda::CurrentStream();
+      return current_stream != nullptr ? current_stream : streams_[kCudaStreamDefault];
+    }
     return streams_[queue_id];
   }
 
  private:
+  // copy from pageable host memory through a pinned staging buffer. returns once the copy to the device is queued.
+  common::Status CopyFromPageableHost(void* dst_data, const void* src_data, size_t bytes, cudaStream_t stream) const;
+
+  // copy the tensors of 'indices', which are small and on the device the batch staging buffers are on
+  common::Status CopyBatchToDevice(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst,
+                                   const std::vector<size_t>& indices) const;
+  common::Status CopyBatchToHost(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst,
+                                 const std::vector<size_t>& indices) const;
+
+  // make the batch staging buffers at least 'bytes' large once the previous batch is done with them
+  common::Status ReserveBatchStaging(size_t bytes) const;
+
   cudaStream_t streams_[kTotalCudaStreams];
+
+  // pinned staging buffers for copies from pageable host memory. a buffer is reused once the copy queued from it
+  // has completed, so a copy can be staged while the copy from the other buffer is still in flight.
+  struct StagingBuffer {
+    void* data = nullptr;
+    size_t size = 0;
+    cudaEvent_t copy_done = nullptr;
+  };
+  static constexpr int kNumStagingBuffers = 2;
+  // larger copies go straight from pageable memory, as the extra host copy would cost more than it saves
+  static constexpr size_t kMaxStagingBytes = 16 * 1024 * 1024;
+  mutable StagingBuffer staging_buffers_[kNumStagingBuffers];
+  mutable int next_staging_buffer_ = 0;
+  mutable OrtMutex staging_mutex_;
+
+  // staging buffers for the batches of CopyTensors, one pinned on the host and one on the device it was created on
+  struct BatchStagingBuffer {
+    void* host_data = nullptr;
+    void* device_data = nullptr;
+    size_t size = 0;
+    int device_id = -1;
+    cudaEvent_t copy_done = nullptr;
+  };
+  // tensors up to this size are batched, larger ones gain little from it
+  static constexpr size_t kMaxBatchedTensorBytes = 64 * 1024;
+  // each tensor of a batch starts at an offset aligned for the vectorized copies of the scatter kernel
+  static constexpr size_t kBatchAlignment = 16;
+  mutable BatchStagingBuffer batch_staging_;
+  mutable OrtMutex batch_staging_mutex_;
 };
 
 }  // namespace onnxruntime
@@ -17,7 +17,7 @@ void ClipImpl(const T* input_data, T* output_data, T min, T max, size_t count) {
   typedef typename ToCudaType<T>::MappedType CudaT;
 
   int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
-  _Clip<CudaT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(reinterpret_cast<const CudaT*>(input_data),
+  _Clip<CudaT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(reinterpret_cast<const CudaT*>(input_data),
                                                                   reinterpret_cast<CudaT*>(output_data),
                                                                   *reinterpret_cast<CudaT*>(&min),
                                                                   *reinterpret_cast<CudaT*>(&max),
@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/cublaslt_gemm.h"
+
+#include <memory>
+
+namespace onnxruntime {
+namespace cuda {
+
+bool CublasLtSupportsEpilogue(CublasLtEpilogue epilogue) {
+#ifdef USE_CUBLASLT
+  switch (epilogue) {
+    case CublasLtEpilogue::Default:
+    case CublasLtEpilogue::Relu:
+    case CublasLtEpilogue::Bias:
+    case CublasLtEpilogue::ReluBias:
+      return true;
+    case CublasLtEpilogue::Gelu:
+    case CublasLtEpilogue::GeluBias:
+      return CUDA_VERSION >= 11030;
+  }
+#else
+  ORT_UNUSED_PARAMETER(epilogue);
+#endif
+  return false;
+}
+
+#ifdef USE_CUBLASLT
+
+namespace {
+
+// the most scratch memory an algorithm may ask for
+constexpr size_t kMaxWorkspaceSize = 4 * 1024 * 1024;
+
+template <typename CudaT>
+struct CublasLtDataType;
+
+template <>
+struct CublasLtDataType<float> {
+  static constexpr cudaDataType_t value = CUDA_R_32F;
+};
+
+template <>
+struct CublasLtDataType<half> {
+  static constexpr cudaDataType_t value = CUDA_R_16F;
+};
+
+cublasLtEpilogue_t ToCublasLtEpilogue(CublasLtEpilogue epilogue) {
+  switch (epilogue) {
+    case CublasLtEpilogue::Relu:
+      return CUBLASLT_EPILOGUE_RELU;
+    case CublasLtEpilogue::Bias:
+      return CUBLASLT_EPILOGUE_BIAS;
+    case CublasLtEpilogue::ReluBias:
+      return CUBLASLT_EPILOGUE_RELU_BIAS;
+#if CUDA_VERSION >= 11030
+    case CublasLtEpilogue::Gelu:
+      return CUBLASLT_EPILOGUE_GELU;
+    case CublasLtEpilogue::GeluBias:
+      return CUBLASLT_EPILOGUE_GELU_BIAS;
+#endif
+    default:
+      return CUBLASLT_EPILOGUE_DEFAULT;
+  }
+}
+
+// The largest power of 2 up to 256 the address is a multiple of. The heuristic assumes 256 bytes unless it's told.
+uint32_t BufferAlignment(const void* p) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(p) | uintptr_t{256};
+  return static_cast<uint32_t>(address & (~address + 1));
+}
+
+struct MatmulDescDeleter {
+  void operator()(cublasLtMatmulDesc_t desc) const { cublasLtMatmulDescDestroy(desc); }
+};
+
+struct MatrixLayoutDeleter {
+  void operator()(cublasLtMatrixLayout_t layout) const { cublasLtMatrixLayoutDestroy(layout); }
+};
+
+struct MatmulPreferenceDeleter {
+  void operator()(cublasLtMatmulPreference_t preference) const { cublasLtMatmulPreferenceDestroy(preference); }
+};
+
+using MatmulDescPtr = std::unique_ptr<std::remove_pointer<cublasLtMatmulDesc_t>::type, MatmulDescDeleter>;
+using MatrixLayoutPtr = std::unique_ptr<std::remove_pointer<cublasLtMatrixLayout_t>::type, MatrixLayoutDeleter>;
+using MatmulPreferencePtr =
+    std::unique_ptr<std::remove_pointer<cublasLtMatmulPreference_t>::type, MatmulPreferenceDeleter>;
+
+Status CreateMatrixLayout(cudaDataType_t data_type, int rows, int cols, MatrixLayoutPtr& layout) {
+  cublasLtMatrixLayout_t raw_layout = nullptr;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&raw_layout, data_type, rows, cols, rows));
+  layout.reset(raw_layout);
+  return Status::OK();
+}
+
+}  // namespace
+
+size_t CublasLtGemm::AlgoKeyHash::operator()(const AlgoKey& key) const {
+  size_t h = 0;
+  auto combine = [&h](size_t v) { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); };
+  combine(std::hash<int>{}(key.M));
+  combine(std::hash<int>{}(key.N));
+  combine(std::hash<int>{}(key.K));
+  combine((static_cast<size_t>(key.trans_x) << 1) | static_cast<size_t>(key.trans_w));
+  combine(static_cast<size_t>(key.epilogue));
+  combine((static_cast<size_t>(key.x_alignment) << 18) ^ (static_cast<size_t>(key.w_alignment) << 9) ^
+          static_cast<size_t>(key.y_alignment));
+  return h;
+}
+
+template <typename CudaT>
+Status CublasLtGemm::Compute(const CudaKernel& kernel, cublasHandle_t handle, CublasLtEpilogue epilogue,
+                             bool trans_x, bool trans_w, int M, int N, int K, float alpha,
+                             const CudaT* x, const CudaT* w, const CudaT* bias, CudaT* y, bool& computed) const {
+  computed = false;
+  if (!CublasLtSupportsEpilogue(epilogue)) {
+    return Status::OK();
+  }
+  const bool has_bias = epilogue == CublasLtEpilogue::Bias || epilogue == CublasLtEpilogue::ReluBias ||
+                        epilogue == CublasLtEpilogue::GeluBias;
+  ORT_RETURN_IF_NOT(has_bias == (bias != nullptr), "The bias is given exactly when the epilogue adds it");
+
+  constexpr cudaDataType_t data_type = CublasLtDataType<CudaT>::value;
+  // a cublasHandle_t works as the cublasLtHandle_t it wraps
+  cublasLtHandle_t lt_handle = reinterpret_cast<cublasLtHandle_t>(handle);
+
+  // cuBLAS is column major, so this computes Y'(N,M) = op(W)'(N,K) x op(X)'(K,M), with the bias a column vector
+  cublasLtMatmulDesc_t raw_desc = nullptr;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&raw_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  MatmulDescPtr desc(raw_desc);
+
+  const cublasOperation_t op_w = trans_w ? CUBLAS_OP_T : CUBLAS_OP_N;
+  const cublasOperation_t op_x = trans_x ? CUBLAS_OP_T : CUBLAS_OP_N;
+  const cublasLtEpilogue_t lt_epilogue = ToCublasLtEpilogue(epilogue);
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.get(), CUBLASLT_MATMUL_DESC_TRANSA, &op_w, sizeof(op_w)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.get(), CUBLASLT_MATMUL_DESC_TRANSB, &op_x, sizeof(op_x)));
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.get(), CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                        &lt_epilogue, sizeof(lt_epilogue)));
+  if (has_bias) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc.get(), CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                          &bias, sizeof(bias)));
+  }
+
+  MatrixLayoutPtr w_layout, x_layout, y_layout;
+  ORT_RETURN_IF_ERROR(CreateMatrixLayout(data_type, trans_w ? K : N, trans_w ? N : K, w_layout));
+  ORT_RETURN_IF_ERROR(CreateMatrixLayout(data_type, trans_x ? M : K, trans_x ? K : M, x_layout));
+  ORT_RETURN_IF_ERROR(CreateMatrixLayout(data_type, N, M, y_layout));
+
+  const AlgoKey key{M, N, K, trans_x, trans_w, epilogue, BufferAlignment(x), BufferAlignment(w), BufferAlignment(y)};
+  AlgoResult result{};
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = algos_.find(key);
+    if (it != algos_.end()) {
+      result = it->second;
+    } else {
+      cublasLtMatmulPreference_t raw_preference = nullptr;
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&raw_preference));
+      MatmulPreferencePtr preference(raw_preference);
+
+      const uint64_t max_workspace_size = kMaxWorkspaceSize;
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+          preference.get(), CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &max_workspace_size, sizeof(max_workspace_size)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+          preference.get(), CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES, &key.w_alignment, sizeof(key.w_alignment)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+          preference.get(), CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES, &key.x_alignment, sizeof(key.x_alignment)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+          preference.get(), CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES, &key.y_alignment, sizeof(key.y_alignment)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+          preference.get(), CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES, &key.y_alignment, sizeof(key.y_alignment)));
+
+      // not finding an algorithm, e.g. for an epilogue the GPU lacks, is a cached answer rather than an error
+      cublasLtMatmulHeuristicResult_t heuristic{};
+      int algo_count = 0;
+      const cublasStatus_t status = cublasLtMatmulAlgoGetHeuristic(
+          lt_handle, desc.get(), w_layout.get(), x_layout.get(), y_layout.get(), y_layout.get(), preference.get(),
+          1, &heuristic, &algo_count);
+      result.found = status == CUBLAS_STATUS_SUCCESS && algo_count > 0 && heuristic.state == CUBLAS_STATUS_SUCCESS;
+      if (result.found) {
+        result.algo = heuristic.algo;
+        result.workspace_size = heuristic.workspaceSize;
+      }
+      algos_.emplace(key, result);
+    }
+  }
+
+  if (!result.found) {
+    return Status::OK();
+  }
+
+  auto workspace = kernel.GetScratchBuffer<char>(result.workspace_size);
+  const float beta = 0.0f;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(
+      lt_handle, desc.get(),
+      &alpha, w, w_layout.get(), x, x_layout.get(),
+      &beta, y, y_layout.get(), y, y_layout.get(),
+      &result.algo, workspace.get(), result.workspace_size, /*stream*/ nullptr));
+
+  computed = true;
+  return Status::OK();
+}
+
+#else
+
+template <typename CudaT>
+Status CublasLtGemm::Compute(const CudaKernel& /*kernel*/, cublasHandle_t /*handle*/, CublasLtEpilogue /*epilogue*/,
+                             bool /*trans_x*/, bool /*trans_w*/, int /*M*/, int /*N*/, int /*K*/, float /*alpha*/,
+                             const CudaT* /*x*/, const CudaT* /*w*/, const CudaT* /*bias*/, CudaT* /*y*/,
+                             bool& computed) const {
+  computed = false;
+  return Status::OK();
+}
+
+#endif
+
+template <>
+Status CublasLtGemm::Compute<double>(const CudaKernel& /*kernel*/, cublasHandle_t /*handle*/,
+                                     CublasLtEpilogue /*epilogue*/, bool /*trans_x*/, bool /*trans_w*/,
+                                     int /*M*/, int /*N*/, int /*K*/, float /*alpha*/,
+                                     const double* /*x*/, const double* /*w*/, const double* /*bias*/,
+                                     double* /*y*/, bool& computed) const {
+  computed = false;
+  return Status::OK();
+}
+
+template Status CublasLtGemm::Compute<float>(const CudaKernel&, cublasHandle_t, CublasLtEpilogue, bool, bool,
+                                             int, int, int, float, const float*, const float*, const float*,
+                                             float*, bool&) const;
+template Status CublasLtGemm::Compute<half>(const CudaKernel&, cublasHandle_t, CublasLtEpilogue, bool, bool,
+                                            int, int, int, float, const half*, const half*, const half*,
+                                            half*, bool&) const;
+
+}  // namespace cuda
+}  // namespace onnxruntime
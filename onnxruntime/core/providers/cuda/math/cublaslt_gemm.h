@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_common.h"
+
+// the alignment preferences of the heuristic query arrived with CUDA 11
+#if CUDA_VERSION >= 11000
+#include <cublasLt.h>
+#define USE_CUBLASLT
+#endif
+
+namespace onnxruntime {
+namespace cuda {
+
+// What cuBLASLt applies to the matrix product in the kernel that stores it.
+enum class CublasLtEpilogue {
+  Default,
+  Relu,
+  Bias,
+  ReluBias,
+  // the tanh approximation of GELU, which is FastGelu
+  Gelu,
+  GeluBias,
+};
+
+// Returns whether this build of cuBLASLt has the epilogue.
+bool CublasLtSupportsEpilogue(CublasLtEpilogue epilogue);
+
+// Computes the row major Y(M,N) = epilogue(alpha * op(X)(M,K) x op(W)(K,N)) with cuBLASLt, which lets the bias(N)
+// and the activation be applied before the product is stored rather than in separate passes over Y.
+// The algorithm the cuBLASLt heuristic picks is cached by the shape and the alignment of the buffers, so an instance
+// belongs to a kernel like the cuDNN state of Conv. Thread-safe.
+class CublasLtGemm {
+ public:
+  // computed is false, and Y is untouched, if cuBLASLt isn't available or has no algorithm for the problem.
+  // The caller then falls back to cublasGemmHelper.
+  template <typename CudaT>
+  Status Compute(const CudaKernel& kernel, cublasHandle_t handle, CublasLtEpilogue epilogue,
+                 bool trans_x, bool trans_w, int M, int N, int K, float alpha,
+                 const CudaT* x, const CudaT* w, const CudaT* bias, CudaT* y, bool& computed) const;
+
+#ifdef USE_CUBLASLT
+ private:
+  struct AlgoKey {
+    int M, N, K;
+    bool trans_x, trans_w;
+    CublasLtEpilogue epilogue;
+    uint32_t x_alignment, w_alignment, y_alignment;
+
+    bool operator==(const AlgoKey& other) const {
+      return M == other.M && N == other.N && K == other.K && trans_x == other.trans_x &&
+             trans_w == other.trans_w && epilogue == other.epilogue && x_alignment == other.x_alignment &&
+             w_alignment == other.w_alignment && y_alignment == other.y_alignment;
+    }
+  };
+
+  struct AlgoKeyHash {
+    size_t operator()(const AlgoKey& key) const;
+  };
+
+  struct AlgoResult {
+    bool found;
+    cublasLtMatmulAlgo_t algo;
+    size_t workspace_size;
+  };
+
+  mutable OrtMutex mutex_;
+  mutable std::unordered_map<AlgoKey, AlgoResult, AlgoKeyHash> algos_;
+#endif
+};
+
+// double always falls back to cublasGemmHelper
+template <>
+Status CublasLtGemm::Compute<double>(const CudaKernel& kernel, cublasHandle_t handle, CublasLtEpilogue epilogue,
+                                     bool trans_x, bool trans_w, int M, int N, int K, float alpha,
+                                     const double* x, const double* w, const double* bias, double* y,
+                                     bool& computed) const;
+
+}  // namespace cuda
+}  // namespace onnxruntime
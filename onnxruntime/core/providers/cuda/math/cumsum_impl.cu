@@ -82,7 +82,7 @@ void CumSumImpl(
   if (output_size > 0) {
     int blocksPerGrid = static_cast<int>((output_size + GridDim::maxThreadsPerBlock - 1) / GridDim::maxThreadsPerBlock);
 
-    _CumSumKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input_data,
+    _CumSumKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_data,
                                                                         input_dim_along_axis,
                                                                         input_stride_along_axis,
                                                                         output_data,
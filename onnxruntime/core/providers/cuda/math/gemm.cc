@@ -44,10 +44,22 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
+namespace {
+
+CublasLtEpilogue ToCublasLtEpilogue(bool has_bias, bool relu, bool fast_gelu) {
+  if (relu) {
+    return has_bias ? CublasLtEpilogue::ReluBias : CublasLtEpilogue::Relu;
+  }
+  if (fast_gelu) {
+    return has_bias ? CublasLtEpilogue::GeluBias : CublasLtEpilogue::Gelu;
+  }
+  return has_bias ? CublasLtEpilogue::Bias : CublasLtEpilogue::Default;
+}
+
+}  // namespace
+
 template <typename T>
 Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
-  typedef typename ToCudaType<T>::MappedType CudaT;
-
   const auto* X = ctx->Input<Tensor>(0);
   const auto* W = ctx->Input<Tensor>(1);
   const auto* B = ctx->Input<Tensor>(2);
@@ -63,11 +75,37 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   auto* Y = ctx->Output(0, TensorShape(std::vector<int64_t>{M, N}));
   CudaT* out_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
 
+  const CudaT* x_data = reinterpret_cast<const CudaT*>(X->template Data<T>());
+  const CudaT* w_data = reinterpret_cast<const CudaT*>(W->template Data<T>());
+
+  // cuBLASLt adds a bias of (N,) or (1, N) and applies the activation as it stores the product, which saves the
+  // passes over Y of the broadcast and of the activation. The plain product is left to cublasGemmHelper.
+  const bool has_bias = beta_ != 0 && B != nullptr;
+  const bool is_row_bias = has_bias && beta_ == 1.0f && B->Shape().Size() == N &&
+                           (B->Shape().NumDimensions() == 1 || (B->Shape().NumDimensions() == 2 && B->Shape()[0] == 1));
+  CublasLtEpilogue epilogue =
+      ToCublasLtEpilogue(is_row_bias, activation_ == Activation::Relu, activation_ == Activation::FastGelu);
+  bool fused_activation = epilogue != CublasLtEpilogue::Default && epilogue != CublasLtEpilogue::Bias;
+  if (fused_activation && !CublasLtSupportsEpilogue(epilogue)) {
+    epilogue = ToCublasLtEpilogue(is_row_bias, false, false);
+    fused_activation = false;
+  }
+  if ((is_row_bias || !has_bias) && epilogue != CublasLtEpilogue::Default) {
+    bool computed = false;
+    ORT_RETURN_IF_ERROR(cublaslt_gemm_.Compute<CudaT>(
+        *this, CublasHandle(), epilogue, trans_A_, trans_B_, M, N, K, alpha_, x_data, w_data,
+        is_row_bias ? reinterpret_cast<const CudaT*>(B->template Data<T>()) : nullptr,
+        out_data, computed));
+    if (computed) {
+      return fused_activation ? Status::OK() : ApplyActivation(out_data, static_cast<int64_t>(M) * N);
+    }
+  }
+
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
   CudaT zero = ToCudaType<T>::FromFloat(0.0f);
 
   // broadcast bias if needed and is present
-  if (beta_ != 0 && B != nullptr) {
+  if (has_bias) {
     auto& b_shape = B->Shape();
     const CudaT* b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
 
@@ -106,7 +144,7 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
           out_data, N));
     } else {
       // B is (M, N), no broadcast needed.
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(out_data, b_data, M * N * sizeof(float), cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(out_data, b_data, M * N * sizeof(float), cudaMemcpyDeviceToDevice, CurrentStream()));
     }
   }
 
@@ -119,17 +157,22 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
       trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N,
       N, M, K,
       &alpha,
-      reinterpret_cast<const CudaT*>(W->template Data<T>()),
+      w_data,
       (trans_B_ ? K : N),
-      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      x_data,
       (trans_A_ ? M : K),
       // ideally we need to set the output buffer contents to 0 if bias is missing,
       // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
       B != nullptr ? &beta : &zero,
       out_data, N));
 
-  return Status::OK();
+  return ApplyActivation(out_data, static_cast<int64_t>(M) * N);
 }
 
+// FusedGemm derives from these
+template class Gemm<float>;
+template class Gemm<double>;
+template class Gemm<MLFloat16>;
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -4,11 +4,12 @@
 #pragma once
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/math/cublaslt_gemm.h"
 
 namespace onnxruntime {
 namespace cuda {
 template <typename T>
-class Gemm final : public CudaKernel {
+class Gemm : public CudaKernel {
   using Base = CudaKernel;
 
  public:
@@ -26,11 +27,31 @@ class Gemm final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+ protected:
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  // The activation FusedGemm applies to Y, which cuBLASLt fuses into the product where it can.
+  enum class Activation {
+    None,
+    Relu,
+    FastGelu,
+    LeakyRelu,
+    Sigmoid,
+    Tanh,
+  };
+
+  // Applies activation_ to Y in place, when cuBLASLt didn't.
+  virtual Status ApplyActivation(CudaT* /*y_data*/, int64_t /*count*/) const { return Status::OK(); }
+
+  Activation activation_{Activation::None};
+
  private:
   bool trans_A_;
   bool trans_B_;
   float alpha_;
   float beta_;
+
+  CublasLtGemm cublaslt_gemm_;
 };
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -73,7 +73,7 @@ Status TopK<inputk>::ComputeInternal(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  auto elem_nums = tensor_X->Shape().GetDims();
+  auto elem_nums = tensor_X->Shape().GetDimsAsVector();
   auto dimension = elem_nums[axis];
   for (auto i = static_cast<int32_t>(elem_nums.size()) - 2; i >= 0; --i) {
     elem_nums[i] *= elem_nums[i + 1];
@@ -4,11 +4,27 @@
 #include "topk_impl.h"
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "cub/cub.cuh"
+#include <algorithm>
 #include <limits>
+#include <type_traits>
 
 namespace onnxruntime {
 namespace cuda {
 
+// Rows at least this wide, with k no more than 1/kRadixSelectMinRatio of them, find the k-th value with a radix
+// select over the digits of the keys and sort only the k values selected, rather than sorting the whole row.
+constexpr int64_t kRadixSelectMinDimension = 16 * 1024;
+constexpr int64_t kRadixSelectMinRatio = 8;
+
+// Narrower rows are sorted together by a segmented sort, a block per row, rather than by a sort per row.
+constexpr int64_t kSegmentedMaxDimension = 16 * 1024;
+
+constexpr int kRadixBits = 8;
+constexpr int kRadixBins = 1 << kRadixBits;
+
+// enough blocks to fill the device, each counting into a histogram in shared memory that is merged once
+constexpr int kMaxHistogramBlocks = 128;
+
 template <typename T>
 __global__ void FillInput(const T* input_x, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t K, int64_t offset, int64_t dimension) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, dimension);
@@ -36,8 +52,294 @@ __global__ void ExcludeOutput(int64_t* output_i, int64_t K, int64_t dimension) {
   }
 }
 
+template <typename T>
+__global__ void FillInputBatched(const T* input_x, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t dimension, int64_t total) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, total);
+  auto row = id / dimension;
+  auto col = id % dimension;
+  auto left = row / (axis == size - 1 ? 1 : elem_nums[axis + 1]) * elem_nums[axis];
+  auto right = axis == size - 1 ? 0 : row % elem_nums[axis + 1];
+  auto input_offset = left + col * (axis == size - 1 ? 1 : elem_nums[axis + 1]) + right;
+  output_v[id] = input_x[input_offset];
+  output_i[id] = col;
+}
+
+// takes the first K of each sorted row of dimension values
+template <typename T>
+__global__ void FillOutputBatched(const T* input_v, const int64_t* input_i, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t K, int64_t dimension, int64_t total) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, total);
+  auto row = id / K;
+  auto col = id % K;
+  auto left = row / (axis == size - 1 ? 1 : elem_nums[axis + 1]) * elem_nums[axis] * K / dimension;
+  auto right = axis == size - 1 ? 0 : row % elem_nums[axis + 1];
+  auto output_offset = left + col * (axis == size - 1 ? 1 : elem_nums[axis + 1]) + right;
+  output_v[output_offset] = input_v[row * dimension + col];
+  output_i[output_offset] = input_i[row * dimension + col];
+}
+
+__global__ void ExcludeOutputBatched(int64_t* output_i, int64_t K, int64_t dimension, int64_t total) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, total);
+  if (id % dimension >= K) {
+    output_i[id] = dimension;
+  }
+}
+
+__global__ void FillSegmentOffsets(int* offsets, int64_t dimension, int64_t count) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, count);
+  offsets[id] = static_cast<int>(id * dimension);
+}
+
+// The bits of a key as an unsigned integer with the same order as the values: the sign bit of the signed integers
+// is flipped, and all the bits of the negative floats, like the twiddling of cub's radix sort.
+template <typename T>
+struct RadixKey {
+  typedef typename std::make_unsigned<T>::type Bits;
+  __device__ __forceinline__ static Bits Get(T value) {
+    const Bits bits = static_cast<Bits>(value);
+    return std::is_signed<T>::value ? static_cast<Bits>(bits ^ (Bits(1) << (sizeof(T) * 8 - 1))) : bits;
+  }
+};
+
+template <>
+struct RadixKey<float> {
+  typedef uint32_t Bits;
+  __device__ __forceinline__ static Bits Get(float value) {
+    const Bits bits = __float_as_uint(value);
+    return bits ^ ((bits & 0x80000000u) ? 0xffffffffu : 0x80000000u);
+  }
+};
+
+template <>
+struct RadixKey<double> {
+  typedef uint64_t Bits;
+  __device__ __forceinline__ static Bits Get(double value) {
+    const Bits bits = static_cast<Bits>(__double_as_longlong(value));
+    return bits ^ ((bits & 0x8000000000000000ull) ? 0xffffffffffffffffull : 0x8000000000000000ull);
+  }
+};
+
+// the smallest values are selected as the largest of the inverted keys
+template <typename T>
+__device__ __forceinline__ typename RadixKey<T>::Bits SelectKey(T value, int64_t largest) {
+  typedef typename RadixKey<T>::Bits Bits;
+  const Bits bits = RadixKey<T>::Get(value);
+  return 1 == largest ? bits : static_cast<Bits>(~bits);
+}
+
+// The digits of the k-th key found so far, from the most significant, and how many of the keys that share them
+// are still to be selected.
+template <typename Bits>
+struct RadixSelectState {
+  Bits prefix;
+  Bits mask;
+  uint32_t remaining;
+};
+
+template <typename Bits>
+__global__ void RadixSelectInit(RadixSelectState<Bits>* state, uint32_t* histogram, int64_t K) {
+  histogram[threadIdx.x] = 0;
+  if (threadIdx.x == 0) {
+    state->prefix = 0;
+    state->mask = 0;
+    state->remaining = static_cast<uint32_t>(K);
+  }
+}
+
+// counts the digits at shift of the keys that share the prefix found so far
+template <typename T, typename Bits>
+__global__ void RadixSelectHistogram(const T* keys, int64_t dimension, int64_t largest, const RadixSelectState<Bits>* state, int shift, uint32_t* histogram) {
+  __shared__ uint32_t local[kRadixBins];
+  for (int i = threadIdx.x; i < kRadixBins; i += blockDim.x) {
+    local[i] = 0;
+  }
+  __syncthreads();
+
+  const Bits prefix = state->prefix;
+  const Bits mask = state->mask;
+  const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < dimension; i += stride) {
+    const Bits key = SelectKey(keys[i], largest);
+    if ((key & mask) == prefix) {
+      atomicAdd(&local[(key >> shift) & (kRadixBins - 1)], 1u);
+    }
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < kRadixBins; i += blockDim.x) {
+    if (local[i] != 0) {
+      atomicAdd(&histogram[i], local[i]);
+    }
+  }
+}
+
+// Picks the digit of the k-th key from the histogram of a pass, and clears the histogram for the next one.
+// Launched as a single block of kRadixBins threads.
+template <typename Bits>
+__global__ void RadixSelectDigit(uint32_t* histogram, RadixSelectState<Bits>* state, int shift) {
+  __shared__ uint32_t counts[kRadixBins];
+  counts[threadIdx.x] = histogram[threadIdx.x];
+  histogram[threadIdx.x] = 0;
+  __syncthreads();
+
+  if (threadIdx.x == 0) {
+    // every key in the bins above the digit is selected
+    uint32_t remaining = state->remaining;
+    int digit = kRadixBins - 1;
+    for (; digit > 0 && counts[digit] < remaining; --digit) {
+      remaining -= counts[digit];
+    }
+    state->prefix = static_cast<Bits>(state->prefix | (static_cast<Bits>(digit) << shift));
+    state->mask = static_cast<Bits>(state->mask | (static_cast<Bits>(kRadixBins - 1) << shift));
+    state->remaining = remaining;
+  }
+}
+
+// selects the indices of the keys above the k-th key, or equal to it
+template <typename T, typename Bits, bool Greater>
+struct RadixSelectPredicate {
+  const T* keys;
+  int64_t largest;
+  const RadixSelectState<Bits>* state;
+
+  __device__ __forceinline__ bool operator()(const int64_t& i) const {
+    const Bits key = SelectKey(keys[i], largest);
+    return Greater ? key > state->prefix : key == state->prefix;
+  }
+};
+
+// The keys above the k-th key were selected into indices, and the lowest indices of the keys equal to it make
+// up the rest of the K.
+template <typename T, typename Bits>
+__global__ void GatherSelected(const T* keys, const int64_t* equal_i, const RadixSelectState<Bits>* state, int64_t K, T* output_v, int64_t* output_i) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, K);
+  const int64_t greater = K - state->remaining;
+  if (id >= greater) {
+    output_i[id] = equal_i[id - greater];
+  }
+  output_v[id] = keys[output_i[id]];
+}
+
+template <typename T>
+Status RadixSelectTopK(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension) {
+  typedef typename RadixKey<T>::Bits Bits;
+  typedef RadixSelectPredicate<T, Bits, true> GreaterPredicate;
+  typedef RadixSelectPredicate<T, Bits, false> EqualPredicate;
+
+  // the rows along the last axis are contiguous, the others are gathered like for the sort
+  const bool contiguous = axis == static_cast<int64_t>(size) - 1;
+  auto row_buffer = kernel->GetScratchBuffer<T>(contiguous ? 0 : dimension);
+  auto equal_i_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
+  auto selected_v_buffer = kernel->GetScratchBuffer<T>(K);
+  auto selected_i_buffer = kernel->GetScratchBuffer<int64_t>(K);
+  auto sorted_v_buffer = kernel->GetScratchBuffer<T>(K);
+  auto sorted_i_buffer = kernel->GetScratchBuffer<int64_t>(K);
+  auto state_buffer = kernel->GetScratchBuffer<RadixSelectState<Bits>>(1);
+  auto histogram_buffer = kernel->GetScratchBuffer<uint32_t>(kRadixBins);
+  auto num_selected_buffer = kernel->GetScratchBuffer<int>(1);
+  auto equal_i = equal_i_buffer.get();
+  auto selected_v = selected_v_buffer.get();
+  auto selected_i = selected_i_buffer.get();
+  auto sorted_v = sorted_v_buffer.get();
+  auto sorted_i = sorted_i_buffer.get();
+  auto state = state_buffer.get();
+  auto histogram = histogram_buffer.get();
+  auto num_selected = num_selected_buffer.get();
+
+  cub::CountingInputIterator<int64_t> row_indices(0);
+  size_t greater_bytes = 0;
+  size_t equal_bytes = 0;
+  size_t sort_bytes = 0;
+  size_t index_sort_bytes = 0;
+  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(nullptr, greater_bytes, row_indices, selected_i, num_selected, static_cast<int>(dimension), GreaterPredicate{nullptr, largest, state}));
+  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(nullptr, equal_bytes, row_indices, equal_i, num_selected, static_cast<int>(dimension), EqualPredicate{nullptr, largest, state}));
+  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(nullptr, sort_bytes, selected_v, sorted_v, selected_i, sorted_i, static_cast<int>(K)));
+  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(nullptr, index_sort_bytes, selected_i, sorted_i, selected_v, sorted_v, static_cast<int>(K)));
+  size_t temp_bytes = std::max(std::max(greater_bytes, equal_bytes), std::max(sort_bytes, index_sort_bytes));
+  auto temp_storage_buffer = kernel->GetScratchBuffer<char>(temp_bytes);
+  auto temp_storage = temp_storage_buffer.get();
+
+  auto blocksPerGridD = (int)(ceil(static_cast<float>(dimension) / GridDim::maxThreadsPerBlock));
+  auto blocksPerGridK = (int)(ceil(static_cast<float>(K) / GridDim::maxThreadsPerBlock));
+  auto blocksPerGridHistogram = std::min(blocksPerGridD, kMaxHistogramBlocks);
+  for (int64_t i = 0; i < N; i++) {
+    const T* keys = input_x + i * dimension;
+    if (!contiguous) {
+      // equal_i only holds the indices until they are selected
+      FillInput<T><<<blocksPerGridD, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_x, row_buffer.get(), equal_i, elem_nums, size, axis, K, i, dimension);
+      keys = row_buffer.get();
+    }
+
+    RadixSelectInit<Bits><<<1, kRadixBins, 0, CurrentStream()>>>(state, histogram, K);
+    for (int shift = static_cast<int>(sizeof(Bits) * 8) - kRadixBits; shift >= 0; shift -= kRadixBits) {
+      RadixSelectHistogram<T, Bits><<<blocksPerGridHistogram, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(keys, dimension, largest, state, shift, histogram);
+      RadixSelectDigit<Bits><<<1, kRadixBins, 0, CurrentStream()>>>(histogram, state, shift);
+    }
+
+    // the selections keep the order of the row, so the lowest indices win the ties like the sort
+    CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(temp_storage, temp_bytes, row_indices, selected_i, num_selected, static_cast<int>(dimension), GreaterPredicate{keys, largest, state}, CurrentStream()));
+    CUDA_RETURN_IF_ERROR(cub::DeviceSelect::If(temp_storage, temp_bytes, row_indices, equal_i, num_selected, static_cast<int>(dimension), EqualPredicate{keys, largest, state}, CurrentStream()));
+    GatherSelected<T, Bits><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(keys, equal_i, state, K, selected_v, selected_i);
+
+    if (1 == sorted) {
+      CUDA_RETURN_IF_ERROR(1 == largest ? cub::DeviceRadixSort::SortPairsDescending(temp_storage, temp_bytes, selected_v, sorted_v, selected_i, sorted_i, static_cast<int>(K), 0, static_cast<int>(sizeof(*selected_v) * 8), CurrentStream()) : cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, selected_v, sorted_v, selected_i, sorted_i, static_cast<int>(K), 0, static_cast<int>(sizeof(*selected_v) * 8), CurrentStream()));
+    } else {  //reorder by ascending index
+      CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, selected_i, sorted_i, selected_v, sorted_v, static_cast<int>(K), 0, static_cast<int>(sizeof(*selected_i) * 8), CurrentStream()));
+    }
+    FillOutput<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(sorted_v, sorted_i, output_v, output_i, elem_nums, size, axis, K, i, dimension);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status SegmentedTopK(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension) {
+  const int64_t total = N * dimension;
+  auto input_key_buffer = kernel->GetScratchBuffer<T>(total);
+  auto output_key_buffer = kernel->GetScratchBuffer<T>(total);
+  auto input_value_buffer = kernel->GetScratchBuffer<int64_t>(total);
+  auto output_value_buffer = kernel->GetScratchBuffer<int64_t>(total);
+  auto offsets_buffer = kernel->GetScratchBuffer<int>(N + 1);
+  auto input_key = input_key_buffer.get();
+  auto output_key = output_key_buffer.get();
+  auto input_value = input_value_buffer.get();
+  auto output_value = output_value_buffer.get();
+  auto offsets = offsets_buffer.get();
+
+  size_t sort_bytes = 0;
+  size_t index_sort_bytes = 0;
+  CUDA_RETURN_IF_ERROR(cub::DeviceSegmentedRadixSort::SortPairs(nullptr, sort_bytes, input_key, output_key, input_value, output_value, static_cast<int>(total), static_cast<int>(N), offsets, offsets + 1));
+  if (1 != sorted) {
+    CUDA_RETURN_IF_ERROR(cub::DeviceSegmentedRadixSort::SortPairs(nullptr, index_sort_bytes, output_value, input_value, output_key, input_key, static_cast<int>(total), static_cast<int>(N), offsets, offsets + 1));
+  }
+  size_t temp_bytes = std::max(sort_bytes, index_sort_bytes);
+  auto temp_storage_buffer = kernel->GetScratchBuffer<char>(temp_bytes);
+  auto temp_storage = temp_storage_buffer.get();
+
+  auto blocksPerGrid = (int)(ceil(static_cast<float>(total) / GridDim::maxThreadsPerBlock));
+  auto blocksPerGridK = (int)(ceil(static_cast<float>(N * K) / GridDim::maxThreadsPerBlock));
+  auto blocksPerGridOffsets = (int)(ceil(static_cast<float>(N + 1) / GridDim::maxThreadsPerBlock));
+  FillSegmentOffsets<<<blocksPerGridOffsets, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(offsets, dimension, N + 1);
+  FillInputBatched<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_x, input_key, input_value, elem_nums, size, axis, dimension, total);
+  CUDA_RETURN_IF_ERROR(1 == largest ? cub::DeviceSegmentedRadixSort::SortPairsDescending(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, static_cast<int>(total), static_cast<int>(N), offsets, offsets + 1, 0, static_cast<int>(sizeof(*input_key) * 8), CurrentStream()) : cub::DeviceSegmentedRadixSort::SortPairs(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, static_cast<int>(total), static_cast<int>(N), offsets, offsets + 1, 0, static_cast<int>(sizeof(*input_key) * 8), CurrentStream()));
+  if (1 == sorted) {
+    FillOutputBatched<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output_key, output_value, output_v, output_i, elem_nums, size, axis, K, dimension, N * K);
+  } else {  //reorder by ascending index
+    ExcludeOutputBatched<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output_value, K, dimension, total);
+    CUDA_RETURN_IF_ERROR(cub::DeviceSegmentedRadixSort::SortPairs(temp_storage, temp_bytes, output_value, input_value, output_key, input_key, static_cast<int>(total), static_cast<int>(N), offsets, offsets + 1, 0, static_cast<int>(sizeof(*output_value) * 8), CurrentStream()));
+    FillOutputBatched<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_key, input_value, output_v, output_i, elem_nums, size, axis, K, dimension, N * K);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t* output_i, const int64_t* elem_nums, size_t size, int64_t axis, int64_t K, int64_t largest, int64_t sorted, int64_t N, int64_t dimension) {
+  if (dimension >= kRadixSelectMinDimension && K * kRadixSelectMinRatio <= dimension &&
+      dimension <= std::numeric_limits<int>::max()) {
+    return RadixSelectTopK(kernel, input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, N, dimension);
+  }
+  if (N > 1 && dimension <= kSegmentedMaxDimension && N * dimension <= std::numeric_limits<int>::max()) {
+    return SegmentedTopK(kernel, input_x, output_v, output_i, elem_nums, size, axis, K, largest, sorted, N, dimension);
+  }
+
   auto input_key_buffer = kernel->GetScratchBuffer<T>(dimension);
   auto output_key_buffer = kernel->GetScratchBuffer<T>(dimension);
   auto input_value_buffer = kernel->GetScratchBuffer<int64_t>(dimension);
@@ -53,14 +355,14 @@ Status TopKImpl(const CudaKernel* kernel, const T* input_x, T* output_v, int64_t
   auto blocksPerGridD = (int)(ceil(static_cast<float>(dimension) / GridDim::maxThreadsPerBlock));
   auto blocksPerGridK = (int)(ceil(static_cast<float>(K) / GridDim::maxThreadsPerBlock));
   for (int64_t i = 0; i < N; i++) {
-    FillInput<T><<<blocksPerGridD, GridDim::maxThreadsPerBlock, 0>>>(input_x, input_key, input_value, elem_nums, size, axis, K, i, dimension);
-    CUDA_RETURN_IF_ERROR(1 == largest ? cub::DeviceRadixSort::SortPairsDescending(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension) : cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension));
+    FillInput<T><<<blocksPerGridD, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_x, input_key, input_value, elem_nums, size, axis, K, i, dimension);
+    CUDA_RETURN_IF_ERROR(1 == largest ? cub::DeviceRadixSort::SortPairsDescending(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension, 0, static_cast<int>(sizeof(*input_key) * 8), CurrentStream()) : cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, input_key, output_key, input_value, output_value, dimension, 0, static_cast<int>(sizeof(*input_key) * 8), CurrentStream()));
     if (1 == sorted) {
-      FillOutput<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0>>>(output_key, output_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
+      FillOutput<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output_key, output_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
     } else {  //reorder by ascending index
-      ExcludeOutput<<<blocksPerGridD, GridDim::maxThreadsPerBlock, 0>>>(output_value, K, dimension);
-      CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, output_value, input_value, output_key, input_key, dimension));
-      FillOutput<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0>>>(input_key, input_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
+      ExcludeOutput<<<blocksPerGridD, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output_value, K, dimension);
+      CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairs(temp_storage, temp_bytes, output_value, input_value, output_key, input_key, dimension, 0, static_cast<int>(sizeof(*output_value) * 8), CurrentStream()));
+      FillOutput<T><<<blocksPerGridK, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(input_key, input_value, output_v, output_i, elem_nums, size, axis, K, i, dimension);
     }
   }
   return Status::OK();
@@ -1,9 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/providers/common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/nn/conv.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 
 namespace onnxruntime {
@@ -33,6 +36,31 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
+namespace {
+
+// key of the process wide algorithm cache. it describes the convolution in the cuDNN layout and the device, so that
+// a cache file can be reused on another machine with the same GPU.
+std::vector<int64_t> MakeConvAlgoCacheKey(int device_id, cudnnDataType_t data_type, int64_t group,
+                                          const std::vector<int64_t>& x_dims, const std::vector<int64_t>& w_dims,
+                                          const std::vector<int64_t>& pads, const std::vector<int64_t>& strides,
+                                          const std::vector<int64_t>& dilations) {
+  int major = 0;
+  int minor = 0;
+  int multiprocessors = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id);
+  cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id);
+  cudaDeviceGetAttribute(&multiprocessors, cudaDevAttrMultiProcessorCount, device_id);
+
+  std::vector<int64_t> key{major, minor, multiprocessors, static_cast<int64_t>(data_type), group,
+                           static_cast<int64_t>(x_dims.size())};
+  for (const auto* values : {&x_dims, &w_dims, &pads, &strides, &dilations}) {
+    key.insert(key.end(), values->begin(), values->end());
+  }
+  return key;
+}
+
+}  // namespace
+
 template <typename T>
 Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
@@ -137,29 +165,64 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       }
 
       if (!s_.cached_benchmark_results.contains(x_dims_cudnn)) {
-        IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
         // set math type to tensor core before algorithm search
         if (std::is_same<T, MLFloat16>::value)
           CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
 
-        cudnnConvolutionFwdAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
-            CudnnHandle(),
-            s_.x_tensor,
-            x_data,
-            s_.filter_desc,
-            w_data,
-            s_.conv_desc,
-            s_.y_tensor,
-            y_data,
-            1,
-            &algo_count,
-            &perf,
-            algo_search_workspace.get(),
-            AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+        const auto algo_key = MakeConvAlgoCacheKey(GetDeviceId(), CudnnTensor::GetDataType<CudaT>(), conv_attrs_.group,
+                                                   x_dims_cudnn, w_dims, pads, strides, dilations);
+        CudnnConvAlgoCache::Result cached;
+        if (CudnnConvAlgoCache::Instance().Find(algo_key, cached)) {
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {static_cast<cudnnConvolutionFwdAlgo_t>(cached.algo),
+                                                            cached.memory,
+                                                            static_cast<cudnnMathType_t>(cached.math_type)});
+        } else if (GetProviderInfo().cudnn_conv_use_heuristic) {
+          // the heuristic result is only kept by this kernel so that it does not replace a benchmarked result.
+          cudnnConvolutionFwdAlgoPerf_t perf_results[CUDNN_CONVOLUTION_FWD_ALGO_COUNT];
+          int algo_count = 0;
+          CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionForwardAlgorithm_v7(
+              CudnnHandle(),
+              s_.x_tensor,
+              s_.filter_desc,
+              s_.conv_desc,
+              s_.y_tensor,
+              CUDNN_CONVOLUTION_FWD_ALGO_COUNT,
+              &algo_count,
+              perf_results));
+          const auto* perf = std::find_if(perf_results, perf_results + algo_count,
+                                          [](const cudnnConvolutionFwdAlgoPerf_t& result) {
+                                            return result.status == CUDNN_STATUS_SUCCESS;
+                                          });
+          ORT_RETURN_IF_NOT(perf != perf_results + algo_count, "cuDNN found no convolution algorithm");
+
+          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf->mathType));
+          size_t workspace_bytes = 0;
+          CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionForwardWorkspaceSize(
+              CudnnHandle(), s_.x_tensor, s_.filter_desc, s_.conv_desc, s_.y_tensor, perf->algo, &workspace_bytes));
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {perf->algo, workspace_bytes, perf->mathType});
+        } else {
+          IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
+
+          cudnnConvolutionFwdAlgoPerf_t perf;
+          int algo_count = 1;
+          CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
+              CudnnHandle(),
+              s_.x_tensor,
+              x_data,
+              s_.filter_desc,
+              w_data,
+              s_.conv_desc,
+              s_.y_tensor,
+              y_data,
+              1,
+              &algo_count,
+              &perf,
+              algo_search_workspace.get(),
+              AlgoSearchWorkspaceSize));
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+          CudnnConvAlgoCache::Instance().Insert(algo_key, {static_cast<int>(perf.algo), perf.memory,
+                                                           static_cast<int>(perf.mathType)});
+        }
       }
 
       const auto& perf = s_.cached_benchmark_results.at(x_dims_cudnn);
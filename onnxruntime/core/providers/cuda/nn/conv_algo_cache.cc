@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// the first line of the file. results of a different cuDNN version are not reused.
+std::string FileHeader() {
+  return "onnxruntime cudnn convolution algorithms " + std::to_string(CUDNN_VERSION);
+}
+
+}  // namespace
+
+CudnnConvAlgoCache& CudnnConvAlgoCache::Instance() {
+  static CudnnConvAlgoCache cache;
+  return cache;
+}
+
+bool CudnnConvAlgoCache::Find(const std::vector<int64_t>& key, Result& result) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it == results_.end()) {
+    return false;
+  }
+  result = it->second;
+  return true;
+}
+
+void CudnnConvAlgoCache::Insert(const std::vector<int64_t>& key, const Result& result) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_[key] = result;
+}
+
+Status CudnnConvAlgoCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != FileHeader()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Convolution algorithm cache ", path,
+                           " was written by a different cuDNN version or is not a cache file");
+  }
+
+  // each line is the key size, the key, the algorithm, the workspace size and the math type.
+  std::unordered_map<std::vector<int64_t>, Result, vector_hash<int64_t>> results;
+  while (std::getline(file, line)) {
+    std::istringstream values(line);
+    size_t key_size = 0;
+    values >> key_size;
+    std::vector<int64_t> key(key_size);
+    for (auto& value : key) {
+      values >> value;
+    }
+    Result result;
+    values >> result.algo >> result.memory >> result.math_type;
+    if (values.fail()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Convolution algorithm cache ", path, " is corrupted");
+    }
+    results[key] = result;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : results) {
+    results_.insert(entry);
+  }
+
+  return Status::OK();
+}
+
+Status CudnnConvAlgoCache::Save(const std::string& path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", path, " to write the convolution algorithm cache");
+  }
+
+  file << FileHeader() << "\n";
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : results_) {
+    file << entry.first.size();
+    for (auto value : entry.first) {
+      file << " " << value;
+    }
+    file << " " << entry.second.algo << " " << entry.second.memory << " " << entry.second.math_type << "\n";
+  }
+
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the convolution algorithm cache to ", path);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/nn/conv.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Process wide cache of the cuDNN convolution algorithms found by benchmarking, shared by the Conv kernels of all
+// the sessions. The key describes the convolution and the device it runs on, so the cache can be written to a
+// file and loaded by a later process to skip the search.
+class CudnnConvAlgoCache {
+ public:
+  struct Result {
+    int algo;
+    size_t memory;
+    int math_type;
+  };
+
+  static CudnnConvAlgoCache& Instance();
+
+  bool Find(const std::vector<int64_t>& key, Result& result) const;
+
+  void Insert(const std::vector<int64_t>& key, const Result& result);
+
+  // merges the results in the file into the cache. a missing file is not an error.
+  Status Load(const std::string& path);
+
+  Status Save(const std::string& path) const;
+
+ private:
+  CudnnConvAlgoCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnConvAlgoCache);
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::vector<int64_t>, Result, vector_hash<int64_t>> results_;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -21,9 +21,6 @@ limitations under the License.
 
 #include "core/framework/tensor.h"
 
-#include <thrust/device_vector.h>
-#include <thrust/execution_policy.h>
-
 #include <cub/cub.cuh>
 
 namespace onnxruntime {
@@ -54,6 +51,12 @@ constexpr int kNmsBoxesPerThreadShiftBits =
 constexpr int kNmsBlockDim = 16;
 constexpr int kNmsBlockDimMax = 128;
 constexpr int kNmsChunkSize = 2000;
+constexpr int kNmsReduceBlockDim = 256;
+constexpr int kMaxGridDimZ = 65535;
+
+// The overlap bitmasks of the batches and classes processed together are at most this large. The rest wait for the
+// buffer on the stream rather than allocating more.
+constexpr size_t kMaxNmsMaskBytes = 256 * 1024 * 1024;
 
 // Check whether two boxes have an IoU greater than threshold.
 template <typename T>
@@ -89,38 +92,45 @@ __device__ inline bool CheckBit(T* bit_mask, int bit) {
   return (bit_mask[bin] >> (bit & kRemainderMask)) & 1;
 }
 
-// Produce a global bitmask (result_mask) of selected boxes from bitmask
-// generated by NMSKernel Abort early if max_boxes boxes are selected. Bitmask
-// is num_boxes*bit_mask_len bits indicating whether to keep or remove a box.
-__global__ void NMSReduce(const int* bitmask, const int bit_mask_len,
-                          const int num_boxes, const int max_boxes,
+// Select the boxes of each batch and class, a block each, from the bitmasks generated by NMSKernel.
+// Starting from the highest scoring box, a box is selected unless an earlier selected box masked it, and its own
+// bitmask masks the later boxes it overlaps. Stops once max_boxes boxes are selected. Bitmask is
+// num_boxes*bit_mask_len bits per segment indicating whether to keep or remove a box, and result_mask flags the
+// selected boxes for cub::DeviceSelect later.
+__global__ void NMSReduce(const int* bitmask, const int bit_mask_len, const int mask_stride,
+                          const int* num_boxes, const int box_stride, const int max_boxes,
                           char* result_mask) {
   extern __shared__ int local[];
 
+  const int* segment_mask = bitmask + static_cast<int64_t>(blockIdx.x) * mask_stride;
+  char* segment_result = result_mask + static_cast<int64_t>(blockIdx.x) * box_stride;
+  const int segment_num_boxes = num_boxes[blockIdx.x];
+
   // set global mask to accept all boxes
-  for (int box = blockIdx.x * blockDim.x + threadIdx.x; box < bit_mask_len; box += blockDim.x * gridDim.x) {
-    local[box] = 0xFFFFFFFF;
+  for (int b = threadIdx.x; b < bit_mask_len; b += blockDim.x) {
+    local[b] = 0xFFFFFFFF;
+  }
+  for (int box = threadIdx.x; box < box_stride; box += blockDim.x) {
+    segment_result[box] = 0;
   }
   __syncthreads();
+
   int accepted_boxes = 0;
-  for (int box = 0; box < num_boxes - 1; ++box) {
+  for (int box = 0; box < segment_num_boxes && accepted_boxes < max_boxes; ++box) {
     // if current box is masked by an earlier box, skip it.
     if (!CheckBit(local, box)) {
       continue;
     }
     accepted_boxes += 1;
-    int offset = box * bit_mask_len;
+    if (threadIdx.x == 0) {
+      segment_result[box] = 1;
+    }
     // update global mask with current box's mask
-    for (int b = blockIdx.x * blockDim.x + threadIdx.x; b < bit_mask_len; b += blockDim.x * gridDim.x) {
-      local[b] &= ~bitmask[offset + b];
+    const int offset = box * bit_mask_len;
+    for (int b = threadIdx.x; b < bit_mask_len; b += blockDim.x) {
+      local[b] &= ~segment_mask[offset + b];
     }
     __syncthreads();
-    if (accepted_boxes > max_boxes) break;
-  }
-  // copy global mask to result_max char array. char array is needed for
-  // cub::DeviceSelect later.
-  for (int box = blockIdx.x * blockDim.x + threadIdx.x; box < num_boxes; box += blockDim.x * gridDim.x) {
-    result_mask[box] = CheckBit(local, box);
   }
 }
 
@@ -129,79 +139,62 @@ __global__ void NMSReduce(const int* bitmask, const int bit_mask_len,
 //
 // Starting from highes scoring box, mark any box which has IoU>threshold with
 // given box. Each thread processes a kNmsBoxesPerThread boxes per stride, and
-// each box has bitmask of overlaps of length bit_mask_len.
+// each box has bitmask of overlaps of length bit_mask_len. The z dimension of the
+// grid strides over the batches and classes, whose sorted boxes are box_stride apart.
+//
+// Only the words of the bitmask with a later box are written. NMSReduce never reads
+// the others for a box it hasn't decided yet, so the mask isn't cleared first.
 //
 __launch_bounds__(kNmsBlockDim* kNmsBlockDim, 4) __global__
     void NMSKernel(
         const int64_t center_point_box,
         const Box* d_desc_sorted_boxes,
-        const int num_boxes,
+        const int* d_num_boxes,
+        const int box_stride,
+        const int num_segments,
         const float iou_threshold,
         const int bit_mask_len,
         int* d_delete_mask) {
-  for (int i_block_offset = blockIdx.x * blockDim.x; i_block_offset < num_boxes;
-       i_block_offset += blockDim.x * gridDim.x) {
-    const int i = i_block_offset + threadIdx.x;
-    if (i < num_boxes) {
-      for (int j_thread_offset =
-               kNmsBoxesPerThread * (blockIdx.y * blockDim.y + threadIdx.y);
-           j_thread_offset < num_boxes;
-           j_thread_offset += kNmsBoxesPerThread * blockDim.y * gridDim.y) {
-        // Note : We can do everything using multiplication,
-        // and use fp16 - we are comparing against a low precision
-        // threshold.
-        int above_threshold = 0;
-        // Make sure that threads are within valid domain.
-        bool valid = false;
-        // Loop over the next kNmsBoxesPerThread boxes and set corresponding bit
-        // if it is overlapping with current box
-        for (int ib = 0; ib < kNmsBoxesPerThread; ++ib) {
-          // This thread will compare Box i and Box j.
-          const int j = j_thread_offset + ib;
-          if (i >= j || i >= num_boxes || j >= num_boxes) continue;
-          valid = true;
-          if (SuppressByIOU(reinterpret_cast<const float*>(d_desc_sorted_boxes),
-                            i, j, center_point_box, iou_threshold)) {
-            // we have score[j] <= score[i].
-            above_threshold |= (1U << ib);
+  for (int segment = blockIdx.z; segment < num_segments; segment += gridDim.z) {
+    const Box* segment_boxes = d_desc_sorted_boxes + static_cast<int64_t>(segment) * box_stride;
+    int* segment_mask = d_delete_mask + static_cast<int64_t>(segment) * box_stride * bit_mask_len;
+    const int num_boxes = d_num_boxes[segment];
+    for (int i_block_offset = blockIdx.x * blockDim.x; i_block_offset < num_boxes;
+         i_block_offset += blockDim.x * gridDim.x) {
+      const int i = i_block_offset + threadIdx.x;
+      if (i < num_boxes) {
+        for (int j_thread_offset =
+                 kNmsBoxesPerThread * (blockIdx.y * blockDim.y + threadIdx.y);
+             j_thread_offset < num_boxes;
+             j_thread_offset += kNmsBoxesPerThread * blockDim.y * gridDim.y) {
+          // Note : We can do everything using multiplication,
+          // and use fp16 - we are comparing against a low precision
+          // threshold.
+          int above_threshold = 0;
+          // Make sure that threads are within valid domain.
+          bool valid = false;
+          // Loop over the next kNmsBoxesPerThread boxes and set corresponding bit
+          // if it is overlapping with current box
+          for (int ib = 0; ib < kNmsBoxesPerThread; ++ib) {
+            // This thread will compare Box i and Box j.
+            const int j = j_thread_offset + ib;
+            if (i >= j || i >= num_boxes || j >= num_boxes) continue;
+            valid = true;
+            if (SuppressByIOU(reinterpret_cast<const float*>(segment_boxes),
+                              i, j, center_point_box, iou_threshold)) {
+              // we have score[j] <= score[i].
+              above_threshold |= (1U << ib);
+            }
+          }
+          if (valid) {
+            segment_mask[i * bit_mask_len + j_thread_offset / kNmsBoxesPerThread] =
+                above_threshold;
           }
-        }
-        if (valid) {
-          d_delete_mask[i * bit_mask_len + j_thread_offset / kNmsBoxesPerThread] =
-              above_threshold;
         }
       }
     }
   }
 }
-// Variadic template helpers for Index selecting multiple arrays at the same
-// time
-template <typename Index>
-__device__ inline void SelectHelper(const Index i_selected,
-                                    const Index i_original) {}
-
-template <typename Index, typename T, typename... Args>
-__device__ inline void SelectHelper(const Index i_selected,
-                                    const Index i_original,
-                                    const T* original, T* selected,
-                                    Args... args) {
-  selected[i_selected] = original[i_original];
-  SelectHelper(i_selected, i_original, args...);
-}
-
-// Helper template to select elements from original arrays using the index
-// mapping and store into selected array. Each array sharing same mapping need
-// to be passed as pairs of pointers to original and selected arrays. For
-// selecting 2 arrays call would be
-// IndexMultiSelect(num_elements, indices, original1 ,selected1, original2,
-// selected2).
-template <typename Index, typename T, typename... Args>
-__global__ void IndexMultiSelect(const int num_elements, const Index* indices,
-                                 const T* original, T* selected, Args... args) {
-  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_elements; idx += blockDim.x * gridDim.x) {
-    SelectHelper(idx, indices[idx], original, selected, args...);
-  }
-}
 
 template <typename T>
 __global__ void SetZero(const int count, T* __restrict__ ptr) {
@@ -214,28 +207,63 @@ __global__ void SetZero(const int count, T* __restrict__ ptr) {
   }
 }
 
-template <typename T>
-__global__ void Iota(const int num_elements, const T offset, T* to_fill) {
+// the index of each box within its batch and class, and the offset of each segment of them for the sort
+__global__ void SegmentIota(const int num_elements, const int num_boxes, int* indices, int* offsets) {
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_elements; idx += blockDim.x * gridDim.x) {
+    indices[idx] = idx % num_boxes;
+    if (idx % num_boxes == 0) {
+      offsets[idx / num_boxes] = idx;
+    }
+  }
+  if (blockIdx.x == 0 && threadIdx.x == 0) {
+    offsets[num_elements / num_boxes] = num_elements;
+  }
+}
+
+// the boxes of a batch are shared by its classes
+__global__ void GatherSortedBoxes(const int num_elements, const int num_boxes, const int num_classes,
+                                  const int* sorted_indices, const Box* boxes, Box* sorted_boxes) {
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_elements; idx += blockDim.x * gridDim.x) {
+    const int batch_index = idx / num_boxes / num_classes;
+    sorted_boxes[idx] = boxes[static_cast<int64_t>(batch_index) * num_boxes + sorted_indices[idx]];
+  }
+}
+
+// The number of boxes of each batch and class that take part, those with a score above the threshold, which are
+// the first of the sorted boxes. num_boxes_per_segment is zero on entry if there is a threshold.
+__global__ void CountBoxes(const int num_elements, const int num_boxes, const float* sorted_scores,
+                           const bool has_score_threshold, const float score_threshold,
+                           int* num_boxes_per_segment) {
   for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_elements; idx += blockDim.x * gridDim.x) {
-    to_fill[idx] = static_cast<T>(idx) + offset;
+    if (!has_score_threshold) {
+      if (idx % num_boxes == 0) {
+        num_boxes_per_segment[idx / num_boxes] = num_boxes;
+      }
+    } else if (sorted_scores[idx] > score_threshold) {
+      atomicAdd(&num_boxes_per_segment[idx / num_boxes], 1);
+    }
   }
 }
 
-__global__ void NormalizeOutput(const int num_elements, const int* original, int64_t* to_normalize, int64_t batch_index, int64_t class_index) {
+__global__ void NormalizeOutput(const int num_elements, const int* selected, const int* sorted_indices,
+                                const int num_boxes, const int num_classes, int64_t* to_normalize) {
   for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_elements; idx += blockDim.x * gridDim.x) {
-    to_normalize[idx * 3] = batch_index;
-    to_normalize[idx * 3 + 1] = class_index;
-    to_normalize[idx * 3 + 2] = static_cast<int64_t>(original[idx]);
+    const int box = selected[idx];
+    const int segment = box / num_boxes;
+    to_normalize[idx * 3] = segment / num_classes;
+    to_normalize[idx * 3 + 1] = segment % num_classes;
+    to_normalize[idx * 3 + 2] = static_cast<int64_t>(sorted_indices[box]);
   }
 }
 
 Status NmsGpu(std::function<IAllocatorUniquePtr<void>(size_t)> allocator,
               const int64_t center_point_box,
               const float* d_sorted_boxes_float_ptr,
+              const int* d_num_boxes,
               const int num_boxes,
+              const int num_segments,
               const float iou_threshold,
-              int* d_selected_indices,
-              int* h_nkeep,
+              char* d_selected_boxes,
               const int max_boxes) {
   // Making sure we respect the __align(16)__
   // we promised to the compiler.
@@ -244,16 +272,14 @@ Status NmsGpu(std::function<IAllocatorUniquePtr<void>(size_t)> allocator,
 
   const int bit_mask_len =
       (num_boxes + kNmsBoxesPerThread - 1) / kNmsBoxesPerThread;
-  int max_nms_mask_size = num_boxes * bit_mask_len;
+  const int mask_stride = num_boxes * bit_mask_len;
+  const size_t segment_mask_bytes = static_cast<size_t>(mask_stride) * sizeof(int);
+  const int segments_per_pass = static_cast<int>(
+      std::max<size_t>(1, std::min<size_t>(num_segments, kMaxNmsMaskBytes / segment_mask_bytes)));
 
-  IAllocatorUniquePtr<void> d_nms_mask_ptr{allocator(max_nms_mask_size * sizeof(int))};
-  auto* d_nms_mask = static_cast<int*>(d_nms_mask_ptr.get());
+  IAllocatorUniquePtr<void> d_nms_mask_ptr{allocator(segments_per_pass * segment_mask_bytes)};
+  auto* d_delete_mask = static_cast<int*>(d_nms_mask_ptr.get());
 
-  int blocksPerGrid = (int)(ceil(static_cast<float>(max_nms_mask_size) / GridDim::maxThreadsPerBlock));
-  SetZero<int><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(max_nms_mask_size, d_nms_mask);
-
-  int* d_delete_mask = d_nms_mask;
-  int* h_selected_count = h_nkeep;
   const Box* d_sorted_boxes =
       reinterpret_cast<const Box*>(d_sorted_boxes_float_ptr);
   dim3 block_dim, thread_block;
@@ -261,172 +287,169 @@ Status NmsGpu(std::function<IAllocatorUniquePtr<void>(size_t)> allocator,
   num_blocks = std::max(std::min(num_blocks, kNmsBlockDimMax), 1);
   block_dim.x = num_blocks;
   block_dim.y = num_blocks;
-  block_dim.z = 1;
   thread_block.x = kNmsBlockDim;
   thread_block.y = kNmsBlockDim;
   thread_block.z = 1;
-  NMSKernel<<<block_dim, thread_block>>>(center_point_box,
-                                         d_sorted_boxes,
-                                         num_boxes,
-                                         iou_threshold,
-                                         bit_mask_len,
-                                         d_delete_mask);
-
-  IAllocatorUniquePtr<void> d_selected_boxes_ptr{allocator(num_boxes * sizeof(char))};
-  auto* d_selected_boxes = static_cast<char*>(d_selected_boxes_ptr.get());
-  IAllocatorUniquePtr<void> d_indices_ptr{allocator(num_boxes * sizeof(int))};
-  auto* d_indices = static_cast<int*>(d_indices_ptr.get());
-
-  blocksPerGrid = (int)(ceil(static_cast<float>(num_boxes) / GridDim::maxThreadsPerBlock));
-  Iota<int><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(num_boxes, 0, d_indices);
-
-  NMSReduce<<<1, 1024, bit_mask_len * sizeof(int)>>>(d_delete_mask, bit_mask_len, num_boxes, max_boxes, d_selected_boxes);
-
-  size_t flagged_buffer_size = 0;
-  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::Flagged(static_cast<void*>(nullptr),  // temp_storage
-                                                  flagged_buffer_size,
-                                                  static_cast<int*>(nullptr),   // input
-                                                  static_cast<char*>(nullptr),  // selection flag
-                                                  static_cast<int*>(nullptr),   // selected items
-                                                  static_cast<int*>(nullptr),   // num_selected
-                                                  num_boxes));
 
-  IAllocatorUniquePtr<void> d_cub_scratch_buffer_ptr{allocator(flagged_buffer_size)};
-  auto* d_cub_scratch_buffer = static_cast<uint8_t*>(d_cub_scratch_buffer_ptr.get());
-  IAllocatorUniquePtr<void> d_num_selected_ptr{allocator(sizeof(int))};
-  auto* d_num_selected = static_cast<int*>(d_num_selected_ptr.get());
-
-  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::Flagged(
-      d_cub_scratch_buffer,  // temp_storage
-      flagged_buffer_size,
-      d_indices,           // input
-      d_selected_boxes,    // selection flag
-      d_selected_indices,  // selected items
-      d_num_selected, num_boxes));
-  CUDA_RETURN_IF_ERROR(cudaMemcpy(h_selected_count, d_num_selected, sizeof(int), cudaMemcpyDeviceToHost));
+  // the passes reuse the mask in stream order, without waiting on the host
+  for (int first_segment = 0; first_segment < num_segments; first_segment += segments_per_pass) {
+    const int pass_segments = std::min(segments_per_pass, num_segments - first_segment);
+    block_dim.z = std::min(pass_segments, kMaxGridDimZ);
+    NMSKernel<<<block_dim, thread_block, 0, CurrentStream()>>>(center_point_box,
+                                           d_sorted_boxes + static_cast<int64_t>(first_segment) * num_boxes,
+                                           d_num_boxes + first_segment,
+                                           num_boxes,
+                                           pass_segments,
+                                           iou_threshold,
+                                           bit_mask_len,
+                                           d_delete_mask);
+    NMSReduce<<<pass_segments, kNmsReduceBlockDim, bit_mask_len * sizeof(int), CurrentStream()>>>(
+        d_delete_mask, bit_mask_len, mask_stride,
+        d_num_boxes + first_segment, num_boxes, max_boxes,
+        d_selected_boxes + static_cast<int64_t>(first_segment) * num_boxes);
+  }
 
   return Status::OK();
 }
 
-struct DeviceGreaterThan {
-  float threshold_;
-  __host__ __device__ __forceinline__ DeviceGreaterThan(float threshold)
-      : threshold_(threshold) {}
-
-  __host__ __device__ __forceinline__ bool operator()(const float& val) const {
-    return (val > threshold_);
-  }
-};
-
 }  // namespace
 
 Status NonMaxSuppressionImpl(
     std::function<IAllocatorUniquePtr<void>(size_t)> allocator,
     const PrepareContext& pc,
     const int64_t center_point_box,
-    int64_t batch_index,
-    int64_t class_index,
     int max_output_boxes_per_class,
     float iou_threshold,
     float score_threshold,
     IAllocatorUniquePtr<void>& selected_indices,
     int* h_number_selected) {
   // STEP 1. Prepare data
-  int num_boxes = pc.num_boxes_;
-  const float* boxes_data = pc.boxes_data_ + batch_index * num_boxes * 4;
-  const float* scores_data = pc.scores_data_ + (batch_index * pc.num_classes_ + class_index) * num_boxes;
+  // the scores of every batch and class are sorted together, a segment of num_boxes each
+  const int num_boxes = static_cast<int>(pc.num_boxes_);
+  const int num_classes = static_cast<int>(pc.num_classes_);
+  const int64_t num_segments_64 = pc.num_batches_ * pc.num_classes_;
+  ORT_RETURN_IF_NOT(num_segments_64 * num_boxes <= std::numeric_limits<int>::max(),
+                    "Too many boxes for NonMaxSuppression on CUDA: ", num_segments_64 * num_boxes);
+  const int num_segments = static_cast<int>(num_segments_64);
+  const int num_elements = num_segments * num_boxes;
 
   // prepare temporary memory for sorting scores
+  IAllocatorUniquePtr<void> d_indices_ptr{allocator(num_elements * sizeof(int))};
+  auto* d_indices = static_cast<int*>(d_indices_ptr.get());
+  IAllocatorUniquePtr<void> d_sorted_indices_ptr{allocator(num_elements * sizeof(int))};
+  auto* d_sorted_indices = static_cast<int*>(d_sorted_indices_ptr.get());
+  IAllocatorUniquePtr<void> d_offsets_ptr{allocator((num_segments + 1) * sizeof(int))};
+  auto* d_offsets = static_cast<int*>(d_offsets_ptr.get());
+  IAllocatorUniquePtr<void> d_sorted_scores_ptr{allocator(num_elements * sizeof(float))};
+  auto* d_sorted_scores = static_cast<float*>(d_sorted_scores_ptr.get());
+  IAllocatorUniquePtr<void> d_sorted_boxes_ptr{allocator(num_elements * 4 * sizeof(float))};
+  auto* d_sorted_boxes = static_cast<float*>(d_sorted_boxes_ptr.get());
+  IAllocatorUniquePtr<void> d_num_boxes_ptr{allocator(num_segments * sizeof(int))};
+  auto* d_num_boxes = static_cast<int*>(d_num_boxes_ptr.get());
+  IAllocatorUniquePtr<void> d_selected_boxes_ptr{allocator(num_elements * sizeof(char))};
+  auto* d_selected_boxes = static_cast<char*>(d_selected_boxes_ptr.get());
+  IAllocatorUniquePtr<void> d_selected_indices_ptr{allocator(num_elements * sizeof(int))};
+  auto* d_selected_indices = static_cast<int*>(d_selected_indices_ptr.get());
+  IAllocatorUniquePtr<void> d_num_selected_ptr{allocator(sizeof(int))};
+  auto* d_num_selected = static_cast<int*>(d_num_selected_ptr.get());
 
-  // calculate temporary size that used for sorting
+  // calculate temporary size that used for sorting and selecting
   size_t cub_sort_temp_storage_bytes = 0;
-  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairsDescending(
+  CUDA_RETURN_IF_ERROR(cub::DeviceSegmentedRadixSort::SortPairsDescending(
       nullptr, cub_sort_temp_storage_bytes,
       static_cast<float*>(nullptr),  // scores
       static_cast<float*>(nullptr),  // sorted scores
       static_cast<int*>(nullptr),    // input indices
       static_cast<int*>(nullptr),    // sorted indices
-      num_boxes,                     // num items
+      num_elements,                  // num items
+      num_segments,                  // num segments
+      d_offsets, d_offsets + 1,      // segment offsets
       0, 8 * sizeof(float)           // sort all bits
       ));
+  size_t flagged_buffer_size = 0;
+  cub::CountingInputIterator<int> box_indices(0);
+  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::Flagged(static_cast<void*>(nullptr),  // temp_storage
+                                                  flagged_buffer_size,
+                                                  box_indices,                  // input
+                                                  static_cast<char*>(nullptr),  // selection flag
+                                                  static_cast<int*>(nullptr),   // selected items
+                                                  static_cast<int*>(nullptr),   // num_selected
+                                                  num_elements));
 
   // allocate temporary memory
-  IAllocatorUniquePtr<void> d_cub_sort_buffer_ptr{allocator(cub_sort_temp_storage_bytes)};
-  auto* d_cub_sort_buffer = static_cast<uint8_t*>(d_cub_sort_buffer_ptr.get());
-  IAllocatorUniquePtr<void> d_indices_ptr{allocator(num_boxes * sizeof(int))};
-  auto* d_indices = static_cast<int*>(d_indices_ptr.get());
-  IAllocatorUniquePtr<void> d_sorted_indices_ptr{allocator(num_boxes * sizeof(int))};
-  auto* d_sorted_indices = static_cast<int*>(d_sorted_indices_ptr.get());
-  IAllocatorUniquePtr<void> d_selected_indices_ptr{allocator(num_boxes * sizeof(int))};
-  auto* d_selected_indices = static_cast<int*>(d_selected_indices_ptr.get());
-  IAllocatorUniquePtr<void> d_sorted_scores_ptr{allocator(num_boxes * sizeof(float))};
-  auto* d_sorted_scores = static_cast<float*>(d_sorted_scores_ptr.get());
-  IAllocatorUniquePtr<void> d_sorted_boxes_ptr{allocator(num_boxes * 4 * sizeof(float))};
-  auto* d_sorted_boxes = static_cast<float*>(d_sorted_boxes_ptr.get());
+  const size_t cub_temp_storage_bytes = std::max(cub_sort_temp_storage_bytes, flagged_buffer_size);
+  IAllocatorUniquePtr<void> d_cub_buffer_ptr{allocator(cub_temp_storage_bytes)};
+  auto* d_cub_buffer = static_cast<uint8_t*>(d_cub_buffer_ptr.get());
 
   // create sequense of indices
-  int blocksPerGrid = (int)(ceil(static_cast<float>(num_boxes) / GridDim::maxThreadsPerBlock));
-  Iota<int><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(num_boxes, 0, d_indices);
+  int blocksPerGrid = (int)(ceil(static_cast<float>(num_elements) / GridDim::maxThreadsPerBlock));
+  SegmentIota<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(num_elements, num_boxes, d_indices, d_offsets);
   CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
   // sort scores
-  CUDA_RETURN_IF_ERROR(cub::DeviceRadixSort::SortPairsDescending(
-      d_cub_sort_buffer,
-      cub_sort_temp_storage_bytes,
-      scores_data,
+  CUDA_RETURN_IF_ERROR(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      d_cub_buffer,
+      cub_temp_storage_bytes,
+      pc.scores_data_,
       d_sorted_scores,
       d_indices,
       d_sorted_indices,
-      num_boxes,
+      num_elements,
+      num_segments,
+      d_offsets,
+      d_offsets + 1,
       0,
-      8 * sizeof(float)  // sort all bits
-      ));
+      8 * sizeof(float),  // sort all bits
+      CurrentStream()));
 
   // pick sorted scores
-  const Box* original_boxes = reinterpret_cast<const Box*>(boxes_data);
+  const Box* original_boxes = reinterpret_cast<const Box*>(pc.boxes_data_);
   Box* sorted_boxes = reinterpret_cast<Box*>(d_sorted_boxes);
-  IndexMultiSelect<int, Box><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(num_boxes, d_sorted_indices, original_boxes, sorted_boxes);
+  GatherSortedBoxes<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(num_elements, num_boxes, num_classes, d_sorted_indices, original_boxes, sorted_boxes);
   CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
   // STEP 2. filter boxes by scores
-  int limited_num_boxes = num_boxes;
-  if (pc.score_threshold_ != nullptr) {
-    thrust::device_ptr<float> sorted_scores_device_ptr(d_sorted_scores);
-    limited_num_boxes = thrust::count_if(
-        sorted_scores_device_ptr,
-        sorted_scores_device_ptr + num_boxes,
-        DeviceGreaterThan(score_threshold));
-    CUDA_RETURN_IF_ERROR(cudaGetLastError());
-
-    if (limited_num_boxes == 0) {
-      *h_number_selected = 0;
-      return Status::OK();
-    }
+  const bool has_score_threshold = pc.score_threshold_ != nullptr;
+  if (has_score_threshold) {
+    int blocksPerGridSegments = (int)(ceil(static_cast<float>(num_segments) / GridDim::maxThreadsPerBlock));
+    SetZero<int><<<blocksPerGridSegments, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(num_segments, d_num_boxes);
   }
+  CountBoxes<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(num_elements, num_boxes, d_sorted_scores, has_score_threshold, score_threshold, d_num_boxes);
+  CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
   // STEP 3. launch NMS kernels
   ORT_RETURN_IF_ERROR(NmsGpu(allocator,
                              center_point_box,
                              d_sorted_boxes,
-                             limited_num_boxes,
+                             d_num_boxes,
+                             num_boxes,
+                             num_segments,
                              iou_threshold,
-                             d_selected_indices,
-                             h_number_selected,
+                             d_selected_boxes,
                              max_output_boxes_per_class));
   CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
-  // STEP 4. map back to sorted indices
-  *h_number_selected = std::min(*h_number_selected, max_output_boxes_per_class);
+  // STEP 4. compact the selected boxes of all the batches and classes, in order, and copy their number back, which
+  // is the only wait on the device
+  CUDA_RETURN_IF_ERROR(cub::DeviceSelect::Flagged(
+      d_cub_buffer,  // temp_storage
+      cub_temp_storage_bytes,
+      box_indices,         // input
+      d_selected_boxes,    // selection flag
+      d_selected_indices,  // selected items
+      d_num_selected, num_elements, CurrentStream()));
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(h_number_selected, d_num_selected, sizeof(int), cudaMemcpyDeviceToHost,
+                                       CurrentStream()));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(CurrentStream()));
+
+  // STEP 5. map back to sorted indices
   int num_to_keep = *h_number_selected;
   if (num_to_keep > 0) {
-    IAllocatorUniquePtr<void> d_output_indices_ptr{allocator(num_to_keep * sizeof(int))};
-    auto* d_output_indices = static_cast<int*>(d_output_indices_ptr.get());
     IAllocatorUniquePtr<void> d_normalized_output_indices_ptr{allocator(num_to_keep * 3 * sizeof(int64_t))};
     auto* d_normalized_output_indices = static_cast<int64_t*>(d_normalized_output_indices_ptr.get());
 
     int blocksPerGrid = (int)(ceil(static_cast<float>(num_to_keep) / GridDim::maxThreadsPerBlock));
-    IndexMultiSelect<int, int><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(num_to_keep, d_selected_indices, d_sorted_indices, d_output_indices);
-    NormalizeOutput<<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(num_to_keep, d_output_indices, d_normalized_output_indices, batch_index, class_index);
+    NormalizeOutput<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(num_to_keep, d_selected_indices, d_sorted_indices, num_boxes, num_classes, d_normalized_output_indices);
     CUDA_RETURN_IF_ERROR(cudaGetLastError());
 
     selected_indices = std::move(d_normalized_output_indices_ptr);
@@ -13,12 +13,13 @@
 namespace onnxruntime {
 namespace cuda {
 
+// Selects the boxes of every batch and class in a pass over all of them. selected_indices holds the
+// [batch_index, class_index, box_index] of the h_number_selected boxes selected, in the order of the batches, the
+// classes and the scores.
 Status NonMaxSuppressionImpl(
     std::function<IAllocatorUniquePtr<void>(size_t)> allocator,
     const PrepareContext& pc,
     const int64_t center_point_box,
-    int64_t batch_index,
-    int64_t class_index,
     int max_output_boxes_per_class,
     float iou_threshold,
     float score_threshold,
@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "reduction_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+constexpr int kMaxThreads = 256;
+
+// A single row longer than this is reduced by several blocks, whose partial results a second kernel combines.
+constexpr int64_t kSplitRowSize = 64 * 1024;
+constexpr int kMaxPartialBlocks = 256;
+
+template <typename T>
+struct AccumulationType {
+  typedef float type;
+};
+
+template <>
+struct AccumulationType<double> {
+  typedef double type;
+};
+
+template <typename T, int N>
+struct alignas(sizeof(T) * N) AlignedVector {
+  T val[N];
+};
+
+template <ReduceRowsOp Op, typename AccT>
+__device__ __forceinline__ AccT ReduceIdentity() {
+  switch (Op) {
+    case ReduceRowsOp::Max:
+      return static_cast<AccT>(-INFINITY);
+    case ReduceRowsOp::Min:
+      return static_cast<AccT>(INFINITY);
+    case ReduceRowsOp::Prod:
+      return AccT(1);
+    default:
+      return AccT(0);
+  }
+}
+
+template <ReduceRowsOp Op, typename AccT>
+__device__ __forceinline__ AccT ReduceTransform(AccT value) {
+  switch (Op) {
+    case ReduceRowsOp::L1:
+      return value < AccT(0) ? -value : value;
+    case ReduceRowsOp::L2:
+    case ReduceRowsOp::SumSquare:
+      return value * value;
+    default:
+      return value;
+  }
+}
+
+// Max and Min propagate NaN like cuDNN.
+template <ReduceRowsOp Op, typename AccT>
+__device__ __forceinline__ AccT ReduceCombine(AccT a, AccT b) {
+  switch (Op) {
+    case ReduceRowsOp::Max:
+      return (a != a || a > b) ? a : b;
+    case ReduceRowsOp::Min:
+      return (a != a || a < b) ? a : b;
+    case ReduceRowsOp::Prod:
+      return a * b;
+    default:
+      return a + b;
+  }
+}
+
+template <ReduceRowsOp Op, typename AccT>
+__device__ __forceinline__ AccT ReduceFinalize(AccT value, int64_t count) {
+  switch (Op) {
+    case ReduceRowsOp::Mean:
+      return value / static_cast<AccT>(count);
+    case ReduceRowsOp::L2:
+      return _Sqrt(value);
+    case ReduceRowsOp::LogSum:
+      return _Log(value);
+    default:
+      return value;
+  }
+}
+
+// Returns the reduction of the values of the block in thread 0. blockDim.x is a multiple of the warp size.
+template <ReduceRowsOp Op, typename AccT>
+__device__ __forceinline__ AccT BlockReduce(AccT value) {
+  __shared__ AccT warp_results[kMaxThreads / kWarpSize];
+
+#pragma unroll
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value = ReduceCombine<Op>(value, __shfl_xor_sync(0xffffffff, value, offset));
+  }
+
+  const int warp_count = blockDim.x / kWarpSize;
+  if (warp_count == 1) {
+    return value;
+  }
+
+  const int warp = threadIdx.x / kWarpSize;
+  const int lane = threadIdx.x % kWarpSize;
+  if (lane == 0) {
+    warp_results[warp] = value;
+  }
+  __syncthreads();
+
+  value = lane < warp_count ? warp_results[lane] : ReduceIdentity<Op, AccT>();
+#pragma unroll
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value = ReduceCombine<Op>(value, __shfl_xor_sync(0xffffffff, value, offset));
+  }
+  return value;
+}
+
+// Each block reduces a row of cols elements, which are VecSize aligned vectors if VecSize > 1. The partial results
+// of a split row are combined without the transform, and count is the number of elements Mean divides by.
+template <typename TIn, typename TOut, typename AccT, ReduceRowsOp Op, int VecSize, bool Transform>
+__global__ void _ReduceRowsKernel(const TIn* input, TOut* output, int64_t cols, int64_t count) {
+  const auto* vectors = reinterpret_cast<const AlignedVector<TIn, VecSize>*>(input + blockIdx.x * cols);
+  const int64_t vector_count = cols / VecSize;
+
+  AccT acc = ReduceIdentity<Op, AccT>();
+  for (int64_t i = threadIdx.x; i < vector_count; i += blockDim.x) {
+    const AlignedVector<TIn, VecSize> v = vectors[i];
+#pragma unroll
+    for (int j = 0; j < VecSize; j++) {
+      const AccT value = static_cast<AccT>(v.val[j]);
+      acc = ReduceCombine<Op>(acc, Transform ? ReduceTransform<Op>(value) : value);
+    }
+  }
+
+  acc = BlockReduce<Op>(acc);
+  if (threadIdx.x == 0) {
+    output[blockIdx.x] = static_cast<TOut>(ReduceFinalize<Op>(acc, count));
+  }
+}
+
+// The blocks stride over a single row together, each writing the partial result of its share.
+template <typename T, typename AccT, ReduceRowsOp Op, int VecSize>
+__global__ void _ReducePartialsKernel(const T* input, AccT* partials, int64_t cols) {
+  const auto* vectors = reinterpret_cast<const AlignedVector<T, VecSize>*>(input);
+  const int64_t vector_count = cols / VecSize;
+  const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+
+  AccT acc = ReduceIdentity<Op, AccT>();
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < vector_count; i += stride) {
+    const AlignedVector<T, VecSize> v = vectors[i];
+#pragma unroll
+    for (int j = 0; j < VecSize; j++) {
+      acc = ReduceCombine<Op>(acc, ReduceTransform<Op>(static_cast<AccT>(v.val[j])));
+    }
+  }
+
+  acc = BlockReduce<Op>(acc);
+  if (threadIdx.x == 0) {
+    partials[blockIdx.x] = acc;
+  }
+}
+
+template <typename T, ReduceRowsOp Op, int VecSize>
+void LaunchReduceRows(const T* input, T* output, int64_t rows, int64_t cols, void* scratch) {
+  typedef typename AccumulationType<T>::type AccT;
+
+  if (rows == 1 && cols > kSplitRowSize) {
+    const int64_t vector_count = cols / VecSize;
+    const int blocks = static_cast<int>(
+        std::min<int64_t>(kMaxPartialBlocks, (vector_count + kMaxThreads - 1) / kMaxThreads));
+    AccT* partials = reinterpret_cast<AccT*>(scratch);
+    _ReducePartialsKernel<T, AccT, Op, VecSize><<<blocks, kMaxThreads, 0, CurrentStream()>>>(input, partials, cols);
+    _ReduceRowsKernel<AccT, T, AccT, Op, 1, false><<<1, kMaxThreads, 0, CurrentStream()>>>(partials, output, blocks, cols);
+    return;
+  }
+
+  // short rows get a single warp rather than idle threads
+  const int64_t vector_count = cols / VecSize;
+  int threads = kWarpSize;
+  while (threads < kMaxThreads && threads < vector_count) {
+    threads *= 2;
+  }
+  _ReduceRowsKernel<T, T, AccT, Op, VecSize, true><<<static_cast<unsigned int>(rows), threads, 0, CurrentStream()>>>(
+      input, output, cols, cols);
+}
+
+template <typename T, ReduceRowsOp Op>
+void DispatchReduceRows(const T* input, T* output, int64_t rows, int64_t cols, void* scratch) {
+  // 16 byte loads when every row starts on a vector boundary
+  constexpr int kVecSize = 16 / sizeof(T);
+  if (cols % kVecSize == 0 && reinterpret_cast<uintptr_t>(input) % 16 == 0) {
+    LaunchReduceRows<T, Op, kVecSize>(input, output, rows, cols, scratch);
+  } else {
+    LaunchReduceRows<T, Op, 1>(input, output, rows, cols, scratch);
+  }
+}
+
+}  // namespace
+
+size_t ReduceRowsScratchSize(int64_t rows, int64_t cols) {
+  return (rows == 1 && cols > kSplitRowSize) ? kMaxPartialBlocks * sizeof(double) : 0;
+}
+
+template <typename T>
+void ReduceRowsImpl(const T* input, T* output, int64_t rows, int64_t cols, ReduceRowsOp op, void* scratch) {
+  switch (op) {
+    case ReduceRowsOp::Sum:
+      DispatchReduceRows<T, ReduceRowsOp::Sum>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::Mean:
+      DispatchReduceRows<T, ReduceRowsOp::Mean>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::Max:
+      DispatchReduceRows<T, ReduceRowsOp::Max>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::Min:
+      DispatchReduceRows<T, ReduceRowsOp::Min>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::Prod:
+      DispatchReduceRows<T, ReduceRowsOp::Prod>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::L1:
+      DispatchReduceRows<T, ReduceRowsOp::L1>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::L2:
+      DispatchReduceRows<T, ReduceRowsOp::L2>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::SumSquare:
+      DispatchReduceRows<T, ReduceRowsOp::SumSquare>(input, output, rows, cols, scratch);
+      break;
+    case ReduceRowsOp::LogSum:
+      DispatchReduceRows<T, ReduceRowsOp::LogSum>(input, output, rows, cols, scratch);
+      break;
+  }
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void ReduceRowsImpl<T>(const T* input, T* output, int64_t rows, int64_t cols, ReduceRowsOp op, void* scratch);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// The reductions of ReduceRowsImpl. The value is transformed (Abs for L1, square for L2 and SumSquare), combined,
+// and the result finalized (divided by the count for Mean, Sqrt for L2, Log for LogSum).
+enum class ReduceRowsOp {
+  Sum,
+  Mean,
+  Max,
+  Min,
+  Prod,
+  L1,
+  L2,
+  SumSquare,
+  LogSum,
+};
+
+// Returns the bytes of scratch memory ReduceRowsImpl needs for the shape, which may be 0.
+size_t ReduceRowsScratchSize(int64_t rows, int64_t cols);
+
+// Reduces each row of the row major input(rows, cols) into output(rows), which covers a reduction over the trailing
+// axes and, with a single row, over all of them. A block reduces a row, loading vectors of elements where the rows
+// are aligned for it. A single long row is first split into partial results across the GPU. half and float
+// accumulate in float.
+template <typename T>
+void ReduceRowsImpl(const T* input, T* output, int64_t rows, int64_t cols, ReduceRowsOp op, void* scratch);
+
+}  // namespace cuda
+}  // namespace onnxruntime
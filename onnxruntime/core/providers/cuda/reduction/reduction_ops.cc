@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "reduction_ops.h"
+#include "reduction_impl.h"
 #include "core/providers/common.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
@@ -143,6 +146,62 @@ static Status PrepareForReduce(OpKernelContext* ctx,
   return Status::OK();
 }
 
+// Returns true if the reduced axes, those whose output dim is 1, are trailing, or all of them, so the input is
+// rows x cols with each row reduced. Dims of 1 can be counted on either side.
+static bool IsTrailingAxesReduction(const std::vector<int64_t>& input_dims,
+                                    const std::vector<int64_t>& output_dims,
+                                    int64_t& rows,
+                                    int64_t& cols) {
+  rows = 1;
+  cols = 1;
+  bool in_reduced_suffix = true;
+  for (size_t i = input_dims.size(); i-- > 0;) {
+    const bool reduced = output_dims[i] == 1 && input_dims[i] != 1;
+    if (reduced && !in_reduced_suffix) {
+      return false;
+    }
+    if (!reduced && input_dims[i] != 1) {
+      in_reduced_suffix = false;
+    }
+    if (in_reduced_suffix) {
+      cols *= input_dims[i];
+    } else {
+      rows *= input_dims[i];
+    }
+  }
+  return rows <= std::numeric_limits<int32_t>::max();
+}
+
+static bool ToReduceRowsOp(cudnnReduceTensorOp_t cudnn_reduce_op, bool calculate_log, bool calculate_sqt,
+                           ReduceRowsOp& op) {
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      op = calculate_sqt ? ReduceRowsOp::SumSquare : calculate_log ? ReduceRowsOp::LogSum : ReduceRowsOp::Sum;
+      return !(calculate_sqt && calculate_log);
+    case CUDNN_REDUCE_TENSOR_AVG:
+      op = ReduceRowsOp::Mean;
+      break;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      op = ReduceRowsOp::Max;
+      break;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      op = ReduceRowsOp::Min;
+      break;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      op = ReduceRowsOp::Prod;
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      op = ReduceRowsOp::L1;
+      break;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      op = ReduceRowsOp::L2;
+      break;
+    default:
+      return false;
+  }
+  return !calculate_log && !calculate_sqt;
+}
+
 template <bool allow_multi_axes>
 template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices>
 Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnReduceTensorOp_t cudnnReduceOp) const {
@@ -172,6 +231,21 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
     return Status::OK();
   }
 
+  // The reductions over the trailing axes, which include those over all axes, run as a kernel of their own rather
+  // than as a cudnnReduceTensor with its workspace. cuDNN does the other axes, LogSumExp and the indices.
+  int64_t rows = 0;
+  int64_t cols = 0;
+  ReduceRowsOp reduce_rows_op;
+  if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_NO_INDICES && !log_sum_exp_ &&
+      ToReduceRowsOp(cudnnReduceOp, calculate_log_, calculate_sqt_, reduce_rows_op) &&
+      IsTrailingAxesReduction(X->Shape().GetDims(), output_dims, rows, cols)) {
+    auto scratch = GetScratchBuffer<char>(ReduceRowsScratchSize(rows, cols));
+    ReduceRowsImpl<CudaT>(reinterpret_cast<const CudaT*>(X->template Data<T>()),
+                          reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+                          rows, cols, reduce_rows_op, scratch.get());
+    return Status::OK();
+  }
+
   IAllocatorUniquePtr<float> temp_X;
   cudnnDataType_t cudnn_type_X = CudnnTensor::GetDataType<CudaT>();
   if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_FLATTENED_INDICES && std::is_same<T, MLFloat16>::value) {
@@ -273,7 +347,7 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
       // cudnnReduceTensor for ReduceSum has issue if input and output has same size, we just need to copy the data for this case
       if (input_count == output_count) {
         if (Y->template MutableData<T>() != X->template Data<T>()) {
-          CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(Y->template MutableData<T>(), X->template Data<T>(), input_count * sizeof(T), cudaMemcpyDeviceToDevice));
+          CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(Y->template MutableData<T>(), X->template Data<T>(), input_count * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream()));
         }
       } else {
         CUDNN_RETURN_IF_ERROR(cudnnReduceTensor(
@@ -343,7 +417,7 @@ Status ReduceKernel<true>::ComputeImpl<int32_t, CUDNN_REDUCE_TENSOR_NO_INDICES>(
   // cudnnReduceTensor for ReduceSum has issue if input and output has same size, we just need to copy the data for this case
   if (input_count == output_count) {
     if (Y->template MutableData<int32_t>() != X->template Data<int32_t>()) {
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(Y->template MutableData<int32_t>(), X->template Data<int32_t>(), input_count * sizeof(int32_t), cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(Y->template MutableData<int32_t>(), X->template Data<int32_t>(), input_count * sizeof(int32_t), cudaMemcpyDeviceToDevice, CurrentStream()));
     }
     return Status::OK();
   }
@@ -34,7 +34,7 @@ void CudnnRnnBase<T>::SetWeightBias(const cudnnHandle_t handle,
 
   cudnnGetFilterNdDescriptor(filter_desc, 3, &dt, &tf, &numDims, matDims.data());
   int count = matDims[0] * matDims[1] * matDims[2];
-  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice);
+  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream());
   offset += count;
 }
 template <typename T>
@@ -72,7 +72,7 @@ template <typename T>
 Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                                           IAllocatorUniquePtr<void>& reorganized_w_data,
                                           CudnnFilterDescriptor& target_w_desc,
-                                          CudnnRNN& rnn_desc) const {
+                                          const CudnnRNN& rnn_desc) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   int64_t input_size = W->Shape()[2];
   // RNN W[num_directions_, hidden_size_, input_size]
@@ -109,6 +109,12 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
 template <typename T>
 Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  // the descriptor only depends on the attributes, so it is set up once for every sequence length and batch size
+  ORT_RETURN_IF_ERROR(rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                    cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
+  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
+  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+
   // Cache the weight
   const Tensor* W;
   const Tensor* R;
@@ -118,13 +124,10 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   bool get_B = info.TryGetConstantInput(RNN_Input_Index::B, &B);
 
   if (get_W && get_R) {
-    CudnnRNN tmp_rnn_desc;
-    ORT_RETURN_IF_ERROR(tmp_rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                         cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
     if (get_B) {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, rnn_desc_));
     } else {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, rnn_desc_));
     }
     weight_cached_ = true;
   }
@@ -132,6 +135,30 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   return Status::OK();
 }
 
+template <typename T>
+const CudnnRNN* CudnnRnnBase<T>::GetPersistentRnnDesc(int64_t batch_size) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  std::lock_guard<OrtMutex> lock(persistent_rnn_descs_mutex_);
+  auto it = persistent_rnn_descs_.find(batch_size);
+  if (it == persistent_rnn_descs_.end()) {
+    auto rnn_desc = onnxruntime::make_unique<CudnnRNN>();
+    Status status = rnn_desc->Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                  cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>(),
+                                  CUDNN_RNN_ALGO_PERSIST_STATIC);
+    if (status.IsOK()) {
+      status = rnn_desc->SetPersistentPlan(batch_size, CudnnTensor::GetDataType<CudaT>());
+    }
+    if (!status.IsOK()) {
+      // remembered as unsupported, so the standard algorithm is used without trying again
+      LOGS_DEFAULT(INFO) << "cuDNN has no persistent RNN plan for batch size " << batch_size << ": "
+                         << status.ErrorMessage();
+      rnn_desc.reset();
+    }
+    it = persistent_rnn_descs_.emplace(batch_size, std::move(rnn_desc)).first;
+  }
+  return it->second.get();
+}
+
 template <typename T>
 Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
@@ -210,9 +237,7 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
 
-  CudnnRNN rnn_desc;
-  ORT_RETURN_IF_ERROR(rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                   cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_NOT(static_cast<cudnnRNNDescriptor_t>(rnn_desc_) != nullptr, "The cuDNN RNN descriptor is not set");
 
   // Prepare the weight data
   IAllocatorUniquePtr<void> w_data;
@@ -221,11 +246,18 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(RNN_Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(RNN_Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(RNN_Input_Index::B);
-    ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc);
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc_));
   }
 
-  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
-  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc, CUDNN_RNN_PADDED_IO_ENABLED));
+  const bool packed_sequences = CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data;
+
+  // The persistent kernels only take full sequences, and have no double precision.
+  const CudnnRNN* persistent_rnn_desc = nullptr;
+  if (packed_sequences && !std::is_same<T, double>::value &&
+      batch_size <= GetProviderInfo().cudnn_rnn_persist_max_batch_size) {
+    persistent_rnn_desc = GetPersistentRnnDesc(batch_size);
+  }
+  const cudnnRNNDescriptor_t rnn_desc = persistent_rnn_desc != nullptr ? *persistent_rnn_desc : rnn_desc_;
 
   size_t workspace_bytes;
   CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
@@ -234,7 +266,7 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   std::vector<int32_t> zero_seq_index_cache(batch_size, 0);
   int64_t zero_seq_index_cache_size = 0;
 
-  if (CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data) {
+  if (packed_sequences) {
     CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
                                                    rnn_desc,
                                                    gsl::narrow_cast<int>(seq_length),
@@ -336,7 +368,7 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
     if (Y != nullptr) {
       // User specified this optional output, so need to copy the reversed data to orignial place
-      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice);
+      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream());
     } else {
       y_data = y_reorganized_data.get();
     }
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "gsl/gsl"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include <cudnn.h>
@@ -26,19 +29,26 @@ const int RNN_NUM_LAYERS = 1;
 
 class CudnnRNN {
  public:
-  CudnnRNN() : cudnn_rnn_desc_(nullptr) {
+  CudnnRNN() : cudnn_rnn_desc_(nullptr), persistent_plan_(nullptr) {
   }
 
   ~CudnnRNN() {
+    if (persistent_plan_ != nullptr) {
+      cudnnDestroyPersistentRNNPlan(persistent_plan_);
+      persistent_plan_ = nullptr;
+    }
     if (cudnn_rnn_desc_ != nullptr) {
       cudnnDestroyRNNDescriptor(cudnn_rnn_desc_);
       cudnn_rnn_desc_ = nullptr;
     }
   }
 
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnRNN);
+
   Status Set(const cudnnHandle_t& cudnnHandle, int64_t hidden_size, int num_layers,
              cudnnDropoutDescriptor_t cudnn_dropout_desc, cudnnDirectionMode_t cudnn_direction_model,
-             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType) {
+             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType,
+             cudnnRNNAlgo_t algo = CUDNN_RNN_ALGO_STANDARD) {
     if (!cudnn_rnn_desc_)
       CUDNN_RETURN_IF_ERROR(cudnnCreateRNNDescriptor(&cudnn_rnn_desc_));
 
@@ -50,18 +60,27 @@ class CudnnRNN {
                                                 CUDNN_LINEAR_INPUT,  // We can also skip the input matrix transformation
                                                 cudnn_direction_model,
                                                 rnn_mode,
-                                                CUDNN_RNN_ALGO_STANDARD,  //CUDNN_RNN_ALGO_PERSIST_STATIC, CUDNN_RNN_ALGO_PERSIST_DYNAMIC
+                                                algo,
                                                 dataType));
 
     return Status::OK();
   }
 
+  // The persistent algorithms need a plan for the batch size, which cuDNN doesn't have for every device.
+  Status SetPersistentPlan(int64_t batch_size, cudnnDataType_t dataType) {
+    CUDNN_RETURN_IF_ERROR(cudnnCreatePersistentRNNPlan(cudnn_rnn_desc_, gsl::narrow_cast<int>(batch_size),
+                                                       dataType, &persistent_plan_));
+    CUDNN_RETURN_IF_ERROR(cudnnSetPersistentRNNPlan(cudnn_rnn_desc_, persistent_plan_));
+    return Status::OK();
+  }
+
   operator cudnnRNNDescriptor_t() const {
     return cudnn_rnn_desc_;
   }
 
  private:
   cudnnRNNDescriptor_t cudnn_rnn_desc_;
+  cudnnPersistentRNNPlan_t persistent_plan_;
 };
 
 template <typename T>
@@ -118,7 +137,7 @@ class CudnnRnnBase : public CudaKernel {
   Status ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                            IAllocatorUniquePtr<void>& target_w_data,
                            CudnnFilterDescriptor& target_w_desc,
-                           CudnnRNN& rnn_desc) const;
+                           const CudnnRNN& rnn_desc) const;
 
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
@@ -138,6 +157,10 @@ class CudnnRnnBase : public CudaKernel {
                         T* y_h_data,
                         T* y_c_data) const;
 
+  // Returns the descriptor with CUDNN_RNN_ALGO_PERSIST_STATIC for batch_size, or nullptr if cuDNN has no plan for
+  // it on this device.
+  const CudnnRNN* GetPersistentRnnDesc(int64_t batch_size) const;
+
  protected:
   // W_lin_layer_id_ & R_lin_layer_id_ are set in Constructor
   std::vector<int> W_lin_layer_id_;
@@ -150,6 +173,13 @@ class CudnnRnnBase : public CudaKernel {
   // hidden_size_ from attribute
   int64_t hidden_size_;
   cudnnRNNMode_t rnn_mode_;
+  // rnn_desc_ is set in Constructor, and never changed. It is the same for every sequence length and batch size.
+  CudnnRNN rnn_desc_;
+  // The persistent kernels keep the recurrent weights on chip across the time steps, which suits the small batches
+  // that leave most of the device idle with the standard algorithm. Their descriptors share the weight layout of
+  // rnn_desc_, and are cached by batch size as each has a plan for one.
+  mutable std::unordered_map<int64_t, std::unique_ptr<CudnnRNN>> persistent_rnn_descs_;
+  mutable OrtMutex persistent_rnn_descs_mutex_;
   // w_desc_cache_ & w_data_cache_ are changed in Constructor if we can get the weights as constant input
   CudnnFilterDescriptor w_desc_cache_;
   IAllocatorUniquePtr<void> w_data_cache_;
@@ -7,11 +7,29 @@
 #pragma once
 #include <memory>
 #include <vector>
+#include <cuda_runtime.h>
 #include "fast_divmod.h"
 
 namespace onnxruntime {
 namespace cuda {
 
+// The stream the kernels, copies and library calls of the calling thread are queued on. nullptr, the legacy default
+// stream, unless a CurrentStreamScope of the thread set another one, e.g. the one CudaKernel::Compute runs a node on.
+cudaStream_t CurrentStream();
+
+// Makes a stream the current stream of the calling thread until the scope ends.
+class CurrentStreamScope {
+ public:
+  explicit CurrentStreamScope(cudaStream_t stream);
+  ~CurrentStreamScope();
+
+ private:
+  CurrentStreamScope(const CurrentStreamScope&) = delete;
+  CurrentStreamScope& operator=(const CurrentStreamScope&) = delete;
+
+  cudaStream_t previous_;
+};
+
 enum class SimpleBroadcast : size_t {
   NoBroadcast = (size_t)-1,
   LeftScalar = (size_t)-2,
@@ -33,5 +51,22 @@ std::unique_ptr<IConstantBuffer<T>> CreateConstantOnes();
 template <typename T>
 void Fill(T* output, T value, int64_t count);
 
+// A copy between two buffers in device memory.
+struct DeviceCopyItem {
+  const void* src;
+  void* dst;
+  size_t bytes;
+};
+
+// The copies done by a single kernel, which are passed as a kernel parameter so no descriptors have to be uploaded.
+struct DeviceCopyBatch {
+  static constexpr int kMaxItems = 128;
+  DeviceCopyItem items[kMaxItems];
+  int count;
+};
+
+// Launch one kernel on 'stream' that does all the copies of the batch, one block per copy.
+void BatchedDeviceCopy(const DeviceCopyBatch& batch, cudaStream_t stream);
+
 }  // namespace cuda
 }  // namespace onnxruntime
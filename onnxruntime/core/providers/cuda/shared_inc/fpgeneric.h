@@ -48,6 +48,25 @@ inline cublasStatus_t cublasGemmBatchedHelper(cublasHandle_t handle, cublasOpera
   return cublasHgemmBatched(handle, transa, transb, m, n, k, alpha, (const __half**)Aarray, lda, (const __half**)Barray, ldb, beta, (__half**)Carray, ldc, batchCount);
 }
 
+// strided batched gemm
+inline cublasStatus_t cublasGemmStridedBatchedHelper(cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb, int m, int n, int k, const float* alpha, const float* A, int lda, long long int strideA, const float* B, int ldb, long long int strideB, const float* beta, float* C, int ldc, long long int strideC, int batchCount) {
+  return cublasSgemmStridedBatched(handle, transa, transb, m, n, k, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batchCount);
+}
+inline cublasStatus_t cublasGemmStridedBatchedHelper(cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb, int m, int n, int k, const double* alpha, const double* A, int lda, long long int strideA, const double* B, int ldb, long long int strideB, const double* beta, double* C, int ldc, long long int strideC, int batchCount) {
+  return cublasDgemmStridedBatched(handle, transa, transb, m, n, k, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batchCount);
+}
+inline cublasStatus_t cublasGemmStridedBatchedHelper(cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb, int m, int n, int k, const half* alpha, const half* A, int lda, long long int strideA, const half* B, int ldb, long long int strideB, const half* beta, half* C, int ldc, long long int strideC, int batchCount) {
+  // This does true FP16 computation which is slow for non-Volta GPUs
+  if (onnxruntime::cuda::DeviceProp().GetDeviceProps().major >= 7) {
+    onnxruntime::cuda::CublasMathModeSetter math_mode_setter(handle, CUBLAS_TENSOR_OP_MATH);
+    return cublasHgemmStridedBatched(handle, transa, transb, m, n, k, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batchCount);
+  }
+  // This does pseudo FP16 computation (input/output in fp16, computation in fp32)
+  float h_a = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(alpha));
+  float h_b = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(beta));
+  return cublasGemmStridedBatchedEx(handle, transa, transb, m, n, k, &h_a, A, CUDA_R_16F, lda, strideA, B, CUDA_R_16F, ldb, strideB, &h_b, C, CUDA_R_16F, ldc, strideC, batchCount, CUDA_R_32F, CUBLAS_GEMM_DFALT);
+}
+
 // axpy
 inline cublasStatus_t cublasAxpyHelper(cublasHandle_t handle, int n, const float* alpha, const float* x, int incx, float* y, int incy) {
   return cublasSaxpy(handle, n, alpha, x, incx, y, incy);
@@ -83,6 +102,7 @@ inline cublasStatus_t cublasAsumHelper(cublasHandle_t, int n, const half* x, int
   cudnnReduceTensorDescriptor_t reduceTensorDesc;
 
   cudnnCreate(&cudnnHandle);
+  cudnnSetStream(cudnnHandle, onnxruntime::cuda::CurrentStream());
   cudnnCreateTensorDescriptor(&srcTensorDesc);
   cudnnCreateTensorDescriptor(&dstTensorDesc);
   cudnnCreateReduceTensorDescriptor(&reduceTensorDesc);
@@ -120,7 +140,8 @@ inline cublasStatus_t cublasAsumHelper(cublasHandle_t, int n, const half* x, int
                     dstTensorDesc,
                     d_res);
 
-  cudaMemcpy((void*)result, d_res, sizeof(half), cudaMemcpyDeviceToHost);
+  cudaMemcpyAsync((void*)result, d_res, sizeof(half), cudaMemcpyDeviceToHost, onnxruntime::cuda::CurrentStream());
+  cudaStreamSynchronize(onnxruntime::cuda::CurrentStream());
 
   cudnnDestroyReduceTensorDescriptor(reduceTensorDesc);
   cudnnDestroyTensorDescriptor(srcTensorDesc);
@@ -147,6 +168,7 @@ inline cublasStatus_t cublasAmaxHelper(cublasHandle_t, int n, const half* x, int
   cudnnReduceTensorDescriptor_t reduceTensorDesc;
 
   cudnnCreate(&cudnnHandle);
+  cudnnSetStream(cudnnHandle, onnxruntime::cuda::CurrentStream());
   cudnnCreateTensorDescriptor(&srcTensorDesc);
   cudnnCreateTensorDescriptor(&dstTensorDesc);
   cudnnCreateReduceTensorDescriptor(&reduceTensorDesc);
@@ -185,7 +207,9 @@ inline cublasStatus_t cublasAmaxHelper(cublasHandle_t, int n, const half* x, int
                     dstTensorDesc,
                     d_max);
 
-  cudaMemcpy(&h_result_uint, d_result_uint, sizeof(unsigned int), cudaMemcpyDeviceToHost);
+  cudaMemcpyAsync(&h_result_uint, d_result_uint, sizeof(unsigned int), cudaMemcpyDeviceToHost,
+                  onnxruntime::cuda::CurrentStream());
+  cudaStreamSynchronize(onnxruntime::cuda::CurrentStream());
 
   cudnnDestroyReduceTensorDescriptor(reduceTensorDesc);
   cudnnDestroyTensorDescriptor(srcTensorDesc);
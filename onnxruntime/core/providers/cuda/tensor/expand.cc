@@ -79,7 +79,7 @@ Status Expand::ComputeInternal(OpKernelContext* ctx) const {
   }
 
   output_dims = output_shape.GetDims();
-  auto input_dims = input_data_tensor.Shape().GetDims();
+  auto input_dims = input_data_tensor.Shape().GetDimsAsVector();
 
   CalcEffectiveDims(input_dims, output_dims);
   int rank = gsl::narrow_cast<int>(output_dims.size());
@@ -26,7 +26,7 @@ void FillFromDataPtr(T* output_data, const T* input_data, int64_t count) {
   int blocksPerGrid = gsl::narrow_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock * GridDim::maxElementsPerThread));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
   _FillFromDataPtrKernel<T, GridDim::maxThreadsPerBlock, GridDim::maxElementsPerThread>
-      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(output_data, input_data, N);
+      <<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output_data, input_data, N);
 }
 
 template <typename T>
@@ -91,7 +91,7 @@ Status Expand2D(
     const int input_view_stride1) {
 #define EXPAND2D_ON(TYPE)                                                                   \
   case sizeof(TYPE):                                                                        \
-    ExpandKernel2D<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(                      \
+    ExpandKernel2D<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(                      \
         N, reinterpret_cast<const TYPE*>(input_data), reinterpret_cast<TYPE*>(output_data), \
         fdm_output_stride0, input_view_stride0, input_view_stride1);                        \
     break
@@ -119,7 +119,7 @@ Status ExpandImpl(
   const int rank = static_cast<int>(fdm_output_strides.count());
   if (rank == 1) {
     if (N_input == N_output) {
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_data, input_data, N_output * element_size, cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_data, input_data, N_output * element_size, cudaMemcpyDeviceToDevice, CurrentStream()));
     } else {  // N_input == 1
       return ExpandByFill(element_size, N_output, input_data, output_data);
     }
@@ -136,7 +136,7 @@ Status ExpandImpl(
 
 #define EXPAND_ON(TYPE)                                                                                  \
   case sizeof(TYPE):                                                                                     \
-    ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(                                     \
+    ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(                                     \
         rank, N_output, reinterpret_cast<const TYPE*>(input_data), reinterpret_cast<TYPE*>(output_data), \
         fdm_output_strides.GpuPtr(), input_view_strides.GpuPtr());                                       \
     break
@@ -32,7 +32,7 @@ void EyeLikeImpl(
   int blocksPerGrid = (int)(ceil(static_cast<float>(diag_count) / block_size));
   CUDA_LONG N = static_cast<CUDA_LONG>(diag_count);
 
-  _EyeLikeKernel<<<blocksPerGrid, block_size, 0>>>(offset, stripe, output_data, N);
+  _EyeLikeKernel<<<blocksPerGrid, block_size, 0, CurrentStream()>>>(offset, stripe, output_data, N);
 }
 
 #define SPECIALIZED_IMPL(T)                                          \
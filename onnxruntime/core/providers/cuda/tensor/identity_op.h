@@ -26,7 +26,7 @@ class IdentityOp final : public CudaKernel {
     void* target = Y->MutableDataRaw(X_type);
     //If source and target pointers are not equal, we need to copy the data.
     if (target != source) {
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X->Shape().Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X->Shape().Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice, CurrentStream()));
     }
 
     if (is_dropout) {
@@ -40,7 +40,7 @@ class IdentityOp final : public CudaKernel {
         void* mask_data = mask->MutableDataRaw();
         // In 'test'/'inference' mode, there are no input values dropped out
         // so fill the buffer with 0/false
-        CUDA_RETURN_IF_ERROR(cudaMemsetAsync(mask_data, 0, mask->SizeInBytes()));
+        CUDA_RETURN_IF_ERROR(cudaMemsetAsync(mask_data, 0, mask->SizeInBytes(), CurrentStream()));
       }
     }
 
@@ -24,7 +24,7 @@ cudaError_t NonZeroCalcPrefixSumTempStorageBytes(
 cudaError_t NonZeroInclusivePrefixSum(
     void* d_temp_storage, size_t temp_storage_bytes, int* prefix_counts, int number_of_blocks) {
   return cub::DeviceScan::InclusiveSum(
-      d_temp_storage, temp_storage_bytes, prefix_counts, prefix_counts, number_of_blocks);
+      d_temp_storage, temp_storage_bytes, prefix_counts, prefix_counts, number_of_blocks, CurrentStream());
 }
 
 template <typename InputT, int THREADS_PER_BLOCK>
@@ -71,7 +71,7 @@ __global__ void NonZeroOutputPositionsKernel(
 template <typename InputT>
 cudaError_t NonZeroCountEachBlock(const InputT* x, int64_t x_size, int* count_in_blocks) {
   int num_blocks = NonZeroCalcBlockCount(x_size);
-  NonZeroCountEachBlockKernel<InputT, NONZERO_THREADS_PER_BLOCK><<<num_blocks, NONZERO_THREADS_PER_BLOCK>>>(
+  NonZeroCountEachBlockKernel<InputT, NONZERO_THREADS_PER_BLOCK><<<num_blocks, NONZERO_THREADS_PER_BLOCK, 0, CurrentStream()>>>(
       x, x_size, count_in_blocks);
   return cudaSuccess;
 }
@@ -81,7 +81,7 @@ cudaError_t NonZeroOutputPositions(
     const InputT* x, int64_t x_size, int x_rank, const fast_divmod* x_strides,
     const int* prefix_counts, int nonzero_elements, int64_t* results) {
   int num_blocks = NonZeroCalcBlockCount(x_size);
-  NonZeroOutputPositionsKernel<InputT, NONZERO_THREADS_PER_BLOCK><<<num_blocks, NONZERO_THREADS_PER_BLOCK>>>(
+  NonZeroOutputPositionsKernel<InputT, NONZERO_THREADS_PER_BLOCK><<<num_blocks, NONZERO_THREADS_PER_BLOCK, 0, CurrentStream()>>>(
       x, x_size, x_rank, x_strides,
       prefix_counts, nonzero_elements, results);
   return cudaSuccess;
@@ -50,7 +50,7 @@ Status NonZero<T>::ComputeInternal(OpKernelContext* context) const {
   int nonzero_elements = 0;
   const auto& x_shape = x->Shape();
   const int x_rank = x_shape.IsScalar() ? 1 : static_cast<int>(x_shape.NumDimensions());
-  const std::vector<int64_t>& x_dims = (x_shape.IsScalar()) ? kScalarDims : x_shape.GetDims();
+  const TensorShapeDims x_dims = (x_shape.IsScalar()) ? TensorShapeDims(kScalarDims) : x_shape.GetDims();
   const int64_t x_size = x_shape.Size();
   if (x_size > 0) {
     auto x_data = reinterpret_cast<const typename ToCudaType<T>::MappedType*>(x->template Data<T>());
@@ -66,9 +66,10 @@ Status NonZero<T>::ComputeInternal(OpKernelContext* context) const {
     auto d_temp_storage = temp_buffer.get();
     CUDA_RETURN_IF_ERROR(NonZeroInclusivePrefixSum(d_temp_storage, temp_storage_bytes, prefix_counts, number_of_blocks));
 
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(
         &nonzero_elements, prefix_counts + number_of_blocks - 1,
-        sizeof(int), cudaMemcpyDeviceToHost));
+        sizeof(int), cudaMemcpyDeviceToHost, CurrentStream()));
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(CurrentStream()));
 
     CudaAsyncBuffer<fast_divmod> fdm_x_strides(this, x_rank);
     ORT_ENFORCE(CalculateFdmStrides(fdm_x_strides.CpuSpan(), x_dims));
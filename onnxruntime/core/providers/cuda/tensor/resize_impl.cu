@@ -474,7 +474,7 @@ void ResizeNearestImpl(
     fast_divmod div_output_image = (rank > 2) ? output_div_pitches.CpuPtr()[rank - 3] : fast_divmod(output_height * output_width);
     int blocksPerDimsMappingGrid = (int)(ceil((output_height + output_width) / 32.0));
 
-    _ResizeNearestMappingKernel2D<T><<<blocksPerDimsMappingGrid, 32, 0>>>(
+    _ResizeNearestMappingKernel2D<T><<<blocksPerDimsMappingGrid, 32, 0, CurrentStream()>>>(
         input_shape.CpuPtr()[rank - 2], input_shape.CpuPtr()[rank - 1],
         output_height, output_width,
         scales_vals.CpuPtr()[rank - 2], scales_vals.CpuPtr()[rank - 1],
@@ -483,7 +483,7 @@ void ResizeNearestImpl(
         extrapolation_enabled, transform_coordinate, calc_nearest_pixel,
         dims_mapping);
     if (extrapolation_enabled) {
-      _ResizeNearestKernel2D<T, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _ResizeNearestKernel2D<T, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           output_height, output_width,
           input_shape.CpuPtr()[rank - 2] * input_shape.CpuPtr()[rank - 1], input_shape.CpuPtr()[rank - 1],
           div_output_image, output_div_pitches.CpuPtr()[rank - 2],
@@ -491,7 +491,7 @@ void ResizeNearestImpl(
           extrapolation_value,
           dims_mapping);
     } else {
-      _ResizeNearestKernel2D<T, false><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _ResizeNearestKernel2D<T, false><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           output_height, output_width,
           input_shape.CpuPtr()[rank - 2] * input_shape.CpuPtr()[rank - 1], input_shape.CpuPtr()[rank - 1],
           div_output_image, output_div_pitches.CpuPtr()[rank - 2],
@@ -510,14 +510,14 @@ void ResizeNearestImpl(
   scales_vals.CopyToGpu();
   input_strides.CopyToGpu();
   output_div_pitches.CopyToGpu();
-  _ResizeNearestMappingKernel<T><<<blocksPerDimsMappingGrid, 32, 0>>>(
+  _ResizeNearestMappingKernel<T><<<blocksPerDimsMappingGrid, 32, 0, CurrentStream()>>>(
       rank, input_shape.GpuPtr(), output_shape.GpuPtr(),
       scales_vals.GpuPtr(), roi_vals.GpuPtr(),
       total_dim_sum, extrapolation_enabled,
       transform_coordinate, calc_nearest_pixel,
       reinterpret_cast<int64_t*>(dims_mapping),
       reinterpret_cast<NearestMappingInfo*>(reinterpret_cast<int64_t*>(dims_mapping) + rank));
-  _ResizeNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  _ResizeNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
       rank, input_strides.GpuPtr(), output_div_pitches.GpuPtr(),
       input_data, output_data, N,
       extrapolation_value,
@@ -549,7 +549,7 @@ void ResizeImpl(
   bool isSame = std::all_of(scales_vals.CpuPtr(), scales_vals.CpuPtr() + rank, [](float v) { return v == 1.0f; }) &&
                 (coordinate_transform_mode != ResizeCoordinateTransformationMode::TF_CROP_AND_RESIZE);
   if (isSame) {
-    cudaMemcpyAsync(output_data, input_data, N * sizeof(T), cudaMemcpyDeviceToDevice);
+    cudaMemcpyAsync(output_data, input_data, N * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream());
     return;
   }
 
@@ -573,7 +573,7 @@ void ResizeImpl(
   int blocksPerDimsMappingGrid = (int)(ceil((output_height + output_width) / 32.0));
   switch (upsample_mode) {
     case UpsampleMode::LINEAR:
-      _ResizeBilinearCoordinateMapping<T><<<blocksPerDimsMappingGrid, 32, 0>>>(
+      _ResizeBilinearCoordinateMapping<T><<<blocksPerDimsMappingGrid, 32, 0, CurrentStream()>>>(
           input_shape.CpuPtr()[rank - 2], input_shape.CpuPtr()[rank - 1],
           output_height, output_width,
           scales_vals.CpuPtr()[rank - 2], scales_vals.CpuPtr()[rank - 1],
@@ -581,7 +581,7 @@ void ResizeImpl(
           roi_vals.CpuPtr()[rank - 1], roi_vals.CpuPtr()[rank - 1 + rank],
           output_height + output_width, extrapolation_enabled, transform_coordinate,
           reinterpret_cast<BilinearMappingInfo*>(dims_mapping));
-      _ResizeBilinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _ResizeBilinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           input_shape.CpuPtr()[rank - 2], input_shape.CpuPtr()[rank - 1],
           output_height, output_width,
           output_div_pitches.CpuPtr()[rank - 2], div_output_image,
@@ -589,7 +589,7 @@ void ResizeImpl(
           reinterpret_cast<BilinearMappingInfo*>(dims_mapping));
       return;
     case UpsampleMode::CUBIC:
-      _ResizeCubicCoordinateMapping<T><<<blocksPerDimsMappingGrid, 32, 0>>>(
+      _ResizeCubicCoordinateMapping<T><<<blocksPerDimsMappingGrid, 32, 0, CurrentStream()>>>(
           input_shape.CpuPtr()[rank - 2], input_shape.CpuPtr()[rank - 1],
           output_height, output_width,
           scales_vals.CpuPtr()[rank - 2], scales_vals.CpuPtr()[rank - 1],
@@ -598,7 +598,7 @@ void ResizeImpl(
           output_height + output_width, extrapolation_enabled,
           cubic_coeff_a, exclude_outside, transform_coordinate,
           reinterpret_cast<CubicMappingInfo*>(dims_mapping));
-      _ResizeBiCubicKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _ResizeBiCubicKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           input_shape.CpuPtr()[rank - 2], input_shape.CpuPtr()[rank - 1],
           output_height, output_width,
           output_div_pitches.CpuPtr()[rank - 2], div_output_image,
@@ -66,11 +66,11 @@ cudaError_t ReverseSequenceCudaImpl(
   int blocksPerGrid = CeilDiv(group_count, GridDim::maxThreadsPerBlock);
 
   if (time_major) {
-    ReverseSequenceImplKernel<T, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(
+    ReverseSequenceImplKernel<T, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         x_data, seq_len_data, y_data, batch_size, max_seq_len, element_size,
         group_count, fdm_grouped_stride_0, fdm_grouped_stride_1);
   } else {
-    ReverseSequenceImplKernel<T, false><<<blocksPerGrid, GridDim::maxThreadsPerBlock>>>(
+    ReverseSequenceImplKernel<T, false><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         x_data, seq_len_data, y_data, batch_size, max_seq_len, element_size,
         group_count, fdm_grouped_stride_0, fdm_grouped_stride_1);
   }
@@ -88,8 +88,8 @@ Status Transpose::DoTranspose(const Transpose& kernel,
     }
   }
 
-  const std::vector<int64_t>& input_dims = input.Shape().GetDims();
-  const std::vector<int64_t>& output_dims = output.Shape().GetDims();
+  const auto& input_dims = input.Shape().GetDims();
+  const auto& output_dims = output.Shape().GetDims();
 
   auto rank = input_dims.size();
   CudaAsyncBuffer<int64_t> input_strides(&kernel, rank);
@@ -114,7 +114,7 @@ Status Transpose::ComputeInternal(OpKernelContext* ctx) const {
   if (X_ptr == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   const Tensor& X = *X_ptr;
   const TensorShape& input_shape = X.Shape();
-  const std::vector<int64_t>& input_dims = input_shape.GetDims();
+  const auto& input_dims = input_shape.GetDims();
   size_t rank = input_dims.size();
 
   std::vector<int64_t> output_dims(rank);
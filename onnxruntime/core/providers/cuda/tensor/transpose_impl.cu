@@ -28,7 +28,7 @@ Status TransposeImpl(size_t element_size, size_t shape_rank, const int64_t* inpu
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
   switch (element_size) {
     case sizeof(int8_t):
-      _TransposeKernel<int8_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _TransposeKernel<int8_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           shape_rank, input_strides, perm,
           reinterpret_cast<const ToCudaType<int8_t>::MappedType*>(input_data),
           fdm_output_strides,
@@ -36,7 +36,7 @@ Status TransposeImpl(size_t element_size, size_t shape_rank, const int64_t* inpu
           N);
       break;
     case sizeof(int16_t):
-      _TransposeKernel<int16_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _TransposeKernel<int16_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           shape_rank, input_strides, perm,
           reinterpret_cast<const ToCudaType<int16_t>::MappedType*>(input_data),
           fdm_output_strides,
@@ -44,7 +44,7 @@ Status TransposeImpl(size_t element_size, size_t shape_rank, const int64_t* inpu
           N);
       break;
     case sizeof(int32_t):
-      _TransposeKernel<int32_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _TransposeKernel<int32_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           shape_rank, input_strides, perm,
           reinterpret_cast<const ToCudaType<int32_t>::MappedType*>(input_data),
           fdm_output_strides,
@@ -52,7 +52,7 @@ Status TransposeImpl(size_t element_size, size_t shape_rank, const int64_t* inpu
           N);
       break;
     case sizeof(int64_t):
-      _TransposeKernel<int64_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _TransposeKernel<int64_t><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           shape_rank, input_strides, perm,
           reinterpret_cast<const ToCudaType<int64_t>::MappedType*>(input_data),
           fdm_output_strides,
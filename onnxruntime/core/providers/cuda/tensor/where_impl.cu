@@ -87,14 +87,14 @@ void WhereImpl(
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
 
   if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::NoBroadcast)) {
-    _TenaryElementWiseSimple<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    _TenaryElementWiseSimple<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         cond_data,
         x_data,
         y_data,
         output_data,
         N);
   } else {
-      _TenaryElementWise<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _TenaryElementWise<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           output_rank_or_simple_broadcast,
           cond_padded_strides,
           cond_data,
@@ -5,6 +5,8 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include <algorithm>
+
 #include "core/framework/allocator.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry.h"
@@ -41,6 +43,25 @@ DNNLExecutionProvider::DNNLExecutionProvider(const DNNLExecutionProviderInfo& in
 DNNLExecutionProvider::~DNNLExecutionProvider() {
 }
 
+std::shared_ptr<dnnl::memory> DNNLExecutionProvider::GetWeightsMemoryBuffer(const std::string& weight_key,
+                                                                            const dnnl::memory& weights_layout) {
+  std::lock_guard<OrtMutex> lock(weights_mutex_);
+  auto iter = weights_mem_map_.find(weight_key);
+  if (iter != weights_mem_map_.end()) {
+    for (const auto& weights_mem : iter->second) {
+      if (weights_mem->get_desc() == weights_layout.get_desc())
+        return weights_mem;
+    }
+  }
+  return nullptr;
+}
+
+void DNNLExecutionProvider::SetWeightsMemoryBuffer(const std::string& weight_key,
+                                                   const std::shared_ptr<dnnl::memory>& filter_dst_mem) {
+  std::lock_guard<OrtMutex> lock(weights_mutex_);
+  weights_mem_map_[weight_key].push_back(filter_dst_mem);
+}
+
 namespace ort_dnnl {
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kDnnlExecutionProvider, kOnnxDomain, 7, Gemm);
 
@@ -111,6 +132,100 @@ bool DNNLExecutionProvider::UseSubgraph(const onnxruntime::GraphViewer& graph_vi
   return use_subgraph;
 }
 
+namespace {
+bool IsZeroInitializer(const ONNX_NAMESPACE::TensorProto& tensor) {
+  if (tensor.has_raw_data()) {
+    const std::string& raw_data = tensor.raw_data();
+    return std::all_of(raw_data.begin(), raw_data.end(), [](char c) { return c == 0; });
+  }
+  return std::all_of(tensor.int32_data().begin(), tensor.int32_data().end(), [](int32_t v) { return v == 0; });
+}
+
+bool IsScalarOrSingleValue(const NodeArg* node_arg) {
+  auto shape = node_arg->Shape();
+  if (shape == nullptr)
+    return false;
+  if (shape->dim_size() == 0)
+    return true;
+  return shape->dim_size() == 1 && shape->dim(0).has_dim_value() && shape->dim(0).dim_value() == 1;
+}
+
+bool IsTensorOfType(const NodeArg* node_arg, const std::string& type) {
+  return node_arg->Type() != nullptr && *node_arg->Type() == type;
+}
+}  // namespace
+
+bool DNNLExecutionProvider::IsNodeSupported(const onnxruntime::GraphViewer& graph_viewer, const Node* node) const {
+  if (!IsDimensionSupported(node))
+    return false;
+
+  const auto& op_type = node->OpType();
+  if (op_type != "MatMul" && op_type != "Gemm" && op_type != "MatMulInteger")
+    return true;
+
+  const auto& node_inputs = node->InputDefs();
+  for (const auto* input : node_inputs) {
+    if (!input->Exists())
+      return false;
+  }
+
+  // the weights are reordered once and cached by name
+  const auto& initializers = graph_viewer.GetAllInitializedTensors();
+  if (initializers.count(node_inputs[1]->Name()) == 0)
+    return false;
+
+  auto a_shape = node_inputs[0]->Shape();
+  auto b_shape = node_inputs[1]->Shape();
+  if (a_shape == nullptr || b_shape == nullptr || b_shape->dim_size() != 2 ||
+      a_shape->dim_size() < 2 || a_shape->dim_size() > 6)
+    return false;
+
+  if (op_type == "MatMulInteger") {
+    // u8s8 only. Dnnl takes no zero point for the weights, so b_zero_point must be 0.
+    if (!IsTensorOfType(node_inputs[0], "tensor(uint8)") || !IsTensorOfType(node_inputs[1], "tensor(int8)"))
+      return false;
+    if (node_inputs.size() > 2 && !IsScalarOrSingleValue(node_inputs[2]))
+      return false;
+    if (node_inputs.size() > 3) {
+      auto b_zero_point = initializers.find(node_inputs[3]->Name());
+      if (b_zero_point == initializers.end() || !IsZeroInitializer(*b_zero_point->second))
+        return false;
+    }
+    return true;
+  }
+
+  if (!IsTensorOfType(node_inputs[0], "tensor(float)"))
+    return false;
+
+  if (op_type == "Gemm") {
+    if (a_shape->dim_size() != 2)
+      return false;
+    const auto& attributes = node->GetAttributes();
+    auto attr = attributes.find("transA");
+    if (attr != attributes.end() && attr->second.i() != 0)
+      return false;
+    attr = attributes.find("alpha");
+    if (attr != attributes.end() && attr->second.f() != 1.0f)
+      return false;
+    attr = attributes.find("beta");
+    if (attr != attributes.end() && attr->second.f() != 1.0f)
+      return false;
+    if (node_inputs.size() > 2) {
+      // C is the bias of the inner product
+      auto c_shape = node_inputs[2]->Shape();
+      if (c_shape == nullptr || c_shape->dim_size() != 1)
+        return false;
+      attr = attributes.find("transB");
+      bool trans_b = attr != attributes.end() && attr->second.i() != 0;
+      const auto& n_dim = b_shape->dim(trans_b ? 0 : 1);
+      if (!c_shape->dim(0).has_dim_value() || !n_dim.has_dim_value() ||
+          c_shape->dim(0).dim_value() != n_dim.dim_value())
+        return false;
+    }
+  }
+  return true;
+}
+
 void DNNLExecutionProvider::CreateOrUpdateDnnlNode(const Node* node,
                                                        std::shared_ptr<ort_dnnl::Subgraph>& subgraph_ptr,
                                                        ort_dnnl::Subgraph::SubgraphVariables& sub_var,
@@ -128,7 +243,8 @@ void DNNLExecutionProvider::CreateOrUpdateDnnlNode(const Node* node,
     dnnl_node.node_index = static_cast<int>(subgraph_ptr->dnnl_nodes.size()) + 1;
     const auto& node_outputs = node->OutputDefs();
     dnnl_node.output_name = node_outputs[0]->Name();
-    if (node->OpType() == "Conv") {
+    if (node->OpType() == "Conv" || node->OpType() == "MatMul" ||
+        node->OpType() == "Gemm" || node->OpType() == "MatMulInteger") {
       dnnl_node.weight_name = node->InputDefs()[1]->Name();
     }
     for (size_t i = 0; i < node_inputs.size(); i++) {
@@ -214,7 +330,7 @@ std::vector<std::unique_ptr<ComputeCapability>> DNNLExecutionProvider::GetCapabi
       continue;
     }
 
-    if (IsDimensionSupported(node) == false) {
+    if (IsNodeSupported(graph_viewer, node) == false) {
       node_index++;
       if (subgraph_ptr->dnnl_nodes.size() > 0) {
         CreateMetaDef(graph_viewer, subgraph_attributes, subgraph_ptr, sub_var, result);
@@ -238,7 +354,8 @@ std::vector<std::unique_ptr<ComputeCapability>> DNNLExecutionProvider::GetCapabi
         }
       }
       if (sub_var.subgraph_node_indexes.size() > 1 && node->OpType() == "Relu") {
-        if (subgraph_ptr->dnnl_nodes.back().name == "Conv-BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "Conv") {
+        if (subgraph_ptr->dnnl_nodes.back().name == "Conv-BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "BatchNormalization" || subgraph_ptr->dnnl_nodes.back().name == "Conv" ||
+            subgraph_ptr->dnnl_nodes.back().name == "MatMul" || subgraph_ptr->dnnl_nodes.back().name == "Gemm") {
           subgraph_ptr->dnnl_nodes.back().name += "-Relu";
           fused = true;
         }
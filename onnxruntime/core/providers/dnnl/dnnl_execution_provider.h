@@ -37,17 +37,13 @@ class DNNLExecutionProvider : public IExecutionProvider {
 
   virtual std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
-  std::shared_ptr<dnnl::memory> GetWeightsMemoryBuffer(const std::string& weight_key) {
-    auto iter = weights_mem_map_.find(weight_key);
-    if (iter != weights_mem_map_.end())
-      return iter->second;
-    return nullptr;
-  }
+  // weights reordered to the layout of weights_layout. A primitive created for other input shapes can choose
+  // another layout for the same weights, so a buffer is kept for each layout.
+  std::shared_ptr<dnnl::memory> GetWeightsMemoryBuffer(const std::string& weight_key,
+                                                       const dnnl::memory& weights_layout);
 
   void SetWeightsMemoryBuffer(const std::string& weight_key,
-                              const std::shared_ptr<dnnl::memory>& filter_dst_mem) {
-    weights_mem_map_.insert(std::make_pair(weight_key, filter_dst_mem));
-  }
+                              const std::shared_ptr<dnnl::memory>& filter_dst_mem);
 
   OrtMutex& GetMutex() {
     return mutex_;
@@ -85,8 +81,10 @@ class DNNLExecutionProvider : public IExecutionProvider {
 
  private:
   // dnnl weights(filer data) memory blocks from first iteration
-  // saved by weights name
-  std::unordered_map<std::string, std::shared_ptr<dnnl::memory>> weights_mem_map_;
+  // saved by weights name, one for each layout
+  std::unordered_map<std::string, std::vector<std::shared_ptr<dnnl::memory>>> weights_mem_map_;
+  // guards weights_mem_map_, which Bind reads without holding mutex_
+  OrtMutex weights_mutex_;
   // Save reordered memory buffers in list so that memory is not freed.
   std::vector<IAllocatorUniquePtr<void>> reordered_buffers_;
 
@@ -123,6 +121,10 @@ class DNNLExecutionProvider : public IExecutionProvider {
 
   bool UseSubgraph(const onnxruntime::GraphViewer& graph_viewer) const;
 
+  // Dimensions and inputs supported by the Dnnl kernel of the node.
+  // MatMul, Gemm and MatMulInteger need constant 2D weights, the layout of which is reordered once.
+  bool IsNodeSupported(const onnxruntime::GraphViewer& graph_viewer, const Node* node) const;
+
   // Some dimensions are not supported by DNNL
   // example: Pool with NumDimensions <= 3 is not supported
   // Fall back to CPU implementation
@@ -171,7 +173,8 @@ class DNNLExecutionProvider : public IExecutionProvider {
 
   // supported Dnnl Operators
   std::set<std::string> dnnl_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum",
-                                       "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN"};
+                                       "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN",
+                                       "MatMul", "Gemm", "MatMulInteger"};
 
   mutable std::unordered_map<std::string, std::shared_ptr<ort_dnnl::Subgraph>> mkl_subgraphs_;
 };
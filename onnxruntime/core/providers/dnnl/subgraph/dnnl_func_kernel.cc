@@ -15,6 +15,7 @@
 #include "core/providers/dnnl/subgraph/dnnl_pool.h"
 #include "core/providers/dnnl/subgraph/dnnl_sum.h"
 #include "core/providers/dnnl/subgraph/dnnl_lrn.h"
+#include "core/providers/dnnl/subgraph/dnnl_inner_product.h"
 #include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
@@ -171,6 +172,18 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
+      } else if (dnnl_node.name == "MatMul" || dnnl_node.name == "MatMul-Relu" ||
+                 dnnl_node.name == "Gemm" || dnnl_node.name == "Gemm-Relu" ||
+                 dnnl_node.name == "MatMulInteger") {
+        std::ostringstream os;
+        os << dnnl_node.name.substr(0, dnnl_node.name.find('-')) << "-" << dnnl_node.node_index << "-";
+        std::shared_ptr<DnnlInnerProduct<T>> kernel;
+        kernel = std::make_shared<DnnlInnerProduct<T>>(dnnl_node, params.provider, params.attributes, os.str());
+        kernel->fuse_relu_ = dnnl_node.name.find("-Relu") != std::string::npos;
+        for (auto index : dnnl_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
       } else if (dnnl_node.name == "Sum") {
         std::ostringstream os;
         os << "Sum-" << dnnl_node.node_index << "-";
@@ -217,8 +230,11 @@ class SubgraphPrimitivePool : public PrimitivePool<T> {
                                    OrtKernelContext* context,
                                    const SubgraphParams& params) {
     Ort::CustomOpApi ort{*api};
+    // Key the primitives by the shapes of all the inputs of the subgraph, as any of them can change
+    // the primitives and the layouts they choose.
     std::string dims_str;
-    for (auto i = 0; i < params.subgraph->dnnl_nodes[0].num_inputs; i++) {
+    const size_t num_inputs = ort.KernelContext_GetInputCount(context);
+    for (size_t i = 0; i < num_inputs; i++) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
       auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
       auto tensor_shape = ort.GetTensorShape(tensor_info);
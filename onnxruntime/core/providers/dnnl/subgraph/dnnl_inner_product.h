@@ -0,0 +1,390 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/providers/dnnl/dnnl_fwd.h"
+#include "core/providers/dnnl/dnnl_common.h"
+#include "core/providers/dnnl/dnnl_execution_provider.h"
+#include "core/providers/dnnl/subgraph/dnnl_kernel.h"
+
+namespace onnxruntime {
+namespace ort_dnnl {
+
+// MatMul, Gemm and MatMulInteger as a Dnnl inner product.
+// The leading dims of A are flattened into the rows of the inner product, and B are the weights, which are
+// reordered once to the layout the primitive prefers.
+// MatMulInteger runs as u8s8s32 with the zero point of A folded into the bias: (A - a_zero_point) * B is
+// A * B - a_zero_point * column sums of B. The zero point of B must be 0.
+template <typename T>
+class DnnlInnerProduct : public DnnlKernel {
+ public:
+  DnnlInnerProduct(const DnnlNode& node,
+                   DNNLExecutionProvider* provider,
+                   const NodeAttributes& attributes,
+                   const std::string attributes_prefix = "") : DnnlKernel(node, provider) {
+    is_integer_ = node.name == "MatMulInteger";
+    is_gemm_ = node.name.compare(0, 4, "Gemm") == 0;
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  void CreatePrimitives(const OrtCustomOpApi* api,
+                        OrtKernelContext* context,
+                        dnnl::engine& cpu_engine,
+                        std::vector<dnnl::primitive>& net,
+                        std::vector<std::unordered_map<int, dnnl::memory>>& net_args) override {
+    Ort::CustomOpApi ort{*api};
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+    TensorShape w_shape = GetInputShape(ort, context, input_index + 1);
+
+    TensorShape x_shape;
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      x_shape = GetInputShape(ort, context, input_index);
+    } else {
+      // get the output of previous node (Dnnl block propagation).
+      x_shape = parents_[0].get()->primitive_dst_shape_;
+      source_desc_ = parents_[0].get()->primitive_dst_desc_;
+    }
+
+    if (x_shape.NumDimensions() < 2 || w_shape.NumDimensions() != 2) {
+      primitive_created_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported input shapes for ", name_,
+                                                  " A: ", x_shape.ToString().c_str(),
+                                                  " B: ", w_shape.ToString().c_str());
+      return;
+    }
+    if (trans_a_ != 0 || alpha_ != 1.0f || beta_ != 1.0f) {
+      primitive_created_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                                                  "Gemm with transA, alpha or beta is not supported.");
+      return;
+    }
+
+    const size_t x_rank = x_shape.NumDimensions();
+    K_ = x_shape[x_rank - 1];
+    M_ = x_shape.SizeToDimension(x_rank - 1);
+    N_ = trans_b_ ? w_shape[0] : w_shape[1];
+    const int64_t w_k = trans_b_ ? w_shape[1] : w_shape[0];
+    if (K_ != w_k) {
+      primitive_created_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Incompatible dimensions for ", name_,
+                                                  " A: ", x_shape.ToString().c_str(),
+                                                  " B: ", w_shape.ToString().c_str());
+      return;
+    }
+
+    std::vector<int64_t> y_dims(x_shape.GetDims().begin(), x_shape.GetDims().end() - 1);
+    y_dims.push_back(N_);
+    primitive_dst_shape_ = TensorShape(y_dims);
+
+    dnnl::memory::data_type src_type = is_integer_ ? dnnl::memory::data_type::u8 : DnnnType<T>();
+    dnnl::memory::data_type weights_type = is_integer_ ? dnnl::memory::data_type::s8 : DnnnType<T>();
+    dnnl::memory::data_type dst_type = is_integer_ ? dnnl::memory::data_type::s32 : DnnnType<T>();
+    weights_type_ = weights_type;
+    // B is [K, N], or [N, K] for Gemm with transB. The weights of the inner product are {N, K}.
+    weights_format_ = trans_b_ ? dnnl::memory::format_tag::oi : dnnl::memory::format_tag::io;
+
+    has_bias_ = is_integer_ || (is_gemm_ && mklnode_ptr_->num_inputs == 3);
+    if (is_gemm_ && has_bias_) {
+      TensorShape b_shape = GetInputShape(ort, context, input_index + 2);
+      if (b_shape.NumDimensions() != 1 || b_shape[0] != N_) {
+        primitive_created_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Gemm C must have shape [N]. C: ",
+                                                    b_shape.ToString().c_str());
+        return;
+      }
+    }
+
+    dnnl::memory::dims src_dims_mkl = {M_, K_};
+    dnnl::memory::dims weights_dims_mkl = {N_, K_};
+    dnnl::memory::dims bias_dims_mkl = {N_};
+    dnnl::memory::dims dst_dims_mkl = {M_, N_};
+
+    src_md_ = onnxruntime::make_unique<dnnl::memory::desc>(
+        dnnl::memory::desc({src_dims_mkl}, src_type, dnnl::memory::format_tag::nc));
+    // Set the weights descriptor to format::any to allow DNNL to decide what the optimal memory layout should be
+    weights_md_ = onnxruntime::make_unique<dnnl::memory::desc>(
+        dnnl::memory::desc({weights_dims_mkl}, weights_type, dnnl::memory::format_tag::any));
+    dnnl::memory::desc dst_md({dst_dims_mkl}, dst_type, dnnl::memory::format_tag::nc);
+
+    if (has_bias_) {
+      dnnl::memory::data_type bias_type = is_integer_ ? dnnl::memory::data_type::s32 : DnnnType<T>();
+      dnnl::memory::desc bias_md({bias_dims_mkl}, bias_type, dnnl::memory::format_tag::x);
+      fwd_desc_ = onnxruntime::make_unique<dnnl::inner_product_forward::desc>(
+          dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference, *src_md_, *weights_md_,
+                                            bias_md, dst_md));
+    } else {
+      fwd_desc_ = onnxruntime::make_unique<dnnl::inner_product_forward::desc>(
+          dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference, *src_md_, *weights_md_,
+                                            dst_md));
+    }
+
+    if (fuse_relu_) {
+      dnnl::primitive_attr attr;
+      // Execute RELU as Fuse PostOps
+      const float ops_scale = 1.f;
+      const float ops_alpha = 0.f;  // relu negative slope
+      const float ops_beta = 0.f;
+      dnnl::post_ops ops;
+      ops.append_eltwise(ops_scale, dnnl::algorithm::eltwise_relu, ops_alpha, ops_beta);
+      attr.set_post_ops(ops);
+
+      ip_fwd_pd_ = onnxruntime::make_unique<dnnl::inner_product_forward::primitive_desc>(
+          dnnl::inner_product_forward::primitive_desc(*fwd_desc_, attr, cpu_engine));
+    } else {
+      ip_fwd_pd_ = onnxruntime::make_unique<dnnl::inner_product_forward::primitive_desc>(
+          dnnl::inner_product_forward::primitive_desc(*fwd_desc_, cpu_engine));
+    }
+
+    primitive_src_desc_ = ip_fwd_pd_->src_desc();
+
+    // The output is plain with the dims of the ONNX output, so the next Dnnl node or the output tensor
+    // take it without a reorder.
+    ort_source_format_ = GetPlainFormat(static_cast<int>(y_dims.size()));
+    dnnl::memory::dims y_dims_mkl(y_dims.begin(), y_dims.end());
+    ort_source_desc_ = dnnl::memory::desc({y_dims_mkl}, dst_type, ort_source_format_);
+    primitive_dst_desc_ = ort_source_desc_;
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(ip_fwd_pd_->src_desc(), cpu_engine, nullptr));
+    } else {
+      dnnl::memory::dims x_dims_mkl(x_shape.GetDims().begin(), x_shape.GetDims().end());
+      dnnl::memory::desc x_plain_desc({x_dims_mkl}, src_type, GetPlainFormat(static_cast<int>(x_rank)));
+      if (source_desc_ != x_plain_desc) {
+        // the parent produces a blocked format. Reorder it to plain A.
+        src_reorder_mem_ = onnxruntime::make_unique<dnnl::memory>(dnnl::memory(x_plain_desc, cpu_engine));
+        net.push_back(dnnl::reorder(*parents_[0].get()->primitive_dst_mem_, *src_reorder_mem_));
+        net_args.push_back({{DNNL_ARG_FROM, *parents_[0].get()->primitive_dst_mem_},
+                            {DNNL_ARG_TO, *src_reorder_mem_}});
+        src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(ip_fwd_pd_->src_desc(), cpu_engine, src_reorder_mem_->get_data_handle()));
+      } else {
+        src_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(ip_fwd_pd_->src_desc(), cpu_engine, parents_[0].get()->primitive_dst_mem_->get_data_handle()));
+      }
+    }
+
+    weights_mem_ = onnxruntime::make_unique<dnnl::memory>(
+        dnnl::memory(ip_fwd_pd_->weights_desc(), cpu_engine, nullptr));
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // last node of sub-graph. The output tensor is set in Bind.
+      primitive_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(primitive_dst_desc_, cpu_engine, nullptr));
+    } else {
+      // Intermediate node. Use dnnl kernel internal memory for output and
+      // use this as input to next node.
+      primitive_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+          dnnl::memory(primitive_dst_desc_, cpu_engine));
+    }
+    // 2D view of the output for the inner product
+    ip_dst_mem_ = onnxruntime::make_unique<dnnl::memory>(
+        dnnl::memory(ip_fwd_pd_->dst_desc(), cpu_engine, primitive_dst_mem_->get_data_handle()));
+
+    ip_fwd_ = onnxruntime::make_unique<dnnl::inner_product_forward>(
+        dnnl::inner_product_forward(*ip_fwd_pd_));
+    net.push_back(*ip_fwd_);
+    if (has_bias_) {
+      if (is_integer_) {
+        bias_buffer_.resize(static_cast<size_t>(N_));
+        bias_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(ip_fwd_pd_->bias_desc(), cpu_engine, bias_buffer_.data()));
+      } else {
+        bias_mem_ = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(ip_fwd_pd_->bias_desc(), cpu_engine, nullptr));
+      }
+      net_args.push_back({{DNNL_ARG_SRC, *src_mem_},
+                          {DNNL_ARG_WEIGHTS, *weights_mem_},
+                          {DNNL_ARG_BIAS, *bias_mem_},
+                          {DNNL_ARG_DST, *ip_dst_mem_}});
+    } else {
+      net_args.push_back({{DNNL_ARG_SRC, *src_mem_},
+                          {DNNL_ARG_WEIGHTS, *weights_mem_},
+                          {DNNL_ARG_DST, *ip_dst_mem_}});
+    }
+  }
+
+  void ReorderWeights(const OrtCustomOpApi* api, OrtKernelContext* context, dnnl::engine& cpu_engine) override {
+    Ort::CustomOpApi ort{*api};
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + 1);
+    const void* weights_data = is_integer_
+                                   ? static_cast<const void*>(ort.GetTensorData<int8_t>(input_tensor))
+                                   : static_cast<const void*>(ort.GetTensorData<T>(input_tensor));
+
+    if (is_integer_) {
+      // column sums of B [K, N] to fold the zero point of A into the bias
+      const int8_t* b_data = static_cast<const int8_t*>(weights_data);
+      b_col_sums_.assign(static_cast<size_t>(N_), 0);
+      for (int64_t k = 0; k < K_; k++) {
+        for (int64_t n = 0; n < N_; n++) {
+          b_col_sums_[n] += b_data[k * N_ + n];
+        }
+      }
+    }
+
+    dnnl::memory::dims weights_dims_mkl = {N_, K_};
+    {
+      // lock to make sure reordering is done only once
+      std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+      std::shared_ptr<dnnl::memory> weights_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name, *weights_mem_);
+
+      if (weights_dst_mem == nullptr) {
+        dnnl::memory src = dnnl::memory({{weights_dims_mkl}, weights_type_, weights_format_}, cpu_engine,
+                                        const_cast<void*>(weights_data));
+        IAllocatorUniquePtr<void> weights_reorder_buffer =
+            IAllocator::MakeUniquePtr<void>(alloc_, ip_fwd_pd_->weights_desc().get_size());
+        weights_dst_mem = onnxruntime::make_unique<dnnl::memory>(
+            dnnl::memory(ip_fwd_pd_->weights_desc(), cpu_engine, weights_reorder_buffer.get()));
+
+        dnnl::reorder(src, *weights_dst_mem)
+            .execute(cpu_engine, src, *weights_dst_mem);
+
+        provider_->SaveAllocatedMemory(std::move(weights_reorder_buffer));
+        provider_->SetWeightsMemoryBuffer(mklnode_ptr_->weight_name, weights_dst_mem);
+      }
+    }
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    ORT_RETURN_IF_ERROR(primitive_created_status_);
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    std::shared_ptr<dnnl::memory> weights_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name, *weights_mem_);
+    if (weights_dst_mem == nullptr) {
+      ReorderWeights(api, context, GetEngine());
+      weights_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name, *weights_mem_);
+    }
+    weights_mem_->set_data_handle(weights_dst_mem->get_data_handle());
+
+    if (is_integer_) {
+      int32_t a_zero_point = 0;
+      if (mklnode_ptr_->num_inputs > 2) {
+        const OrtValue* zp_tensor = ort.KernelContext_GetInput(context, input_index + 2);
+        a_zero_point = static_cast<int32_t>(*ort.GetTensorData<uint8_t>(zp_tensor));
+      }
+      for (size_t n = 0; n < bias_buffer_.size(); n++) {
+        bias_buffer_[n] = -a_zero_point * b_col_sums_[n];
+      }
+    } else if (has_bias_) {
+      const OrtValue* binput_tensor = ort.KernelContext_GetInput(context, input_index + 2);
+      const T* bias_data = ort.GetTensorData<T>(binput_tensor);
+      bias_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(bias_data)));
+    }
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      // Sub-graph's first node. Read input from input buffer
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      const void* src_data = is_integer_
+                                 ? static_cast<const void*>(ort.GetTensorData<uint8_t>(input_tensor))
+                                 : static_cast<const void*>(ort.GetTensorData<T>(input_tensor));
+      src_mem_->set_data_handle(const_cast<void*>(src_data));
+    } else if (src_reorder_mem_ == nullptr) {
+      src_mem_->set_data_handle(parents_[0].get()->primitive_dst_mem_->get_data_handle());
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0], static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      void* dst_data = is_integer_
+                           ? static_cast<void*>(ort.GetTensorMutableData<int32_t>(output))
+                           : static_cast<void*>(ort.GetTensorMutableData<T>(output));
+      primitive_dst_mem_->set_data_handle(dst_data);
+      ip_dst_mem_->set_data_handle(dst_data);
+    }
+    return Status::OK();
+  }
+
+ private:
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    if (!is_gemm_) {
+      return;
+    }
+
+    auto attr = attributes.find(attributes_prefix + "transA");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetIntAttr(proto, trans_a_);
+    }
+    attr = attributes.find(attributes_prefix + "transB");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetIntAttr(proto, trans_b_);
+    }
+    attr = attributes.find(attributes_prefix + "alpha");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetFloatAttr(proto, alpha_);
+    }
+    attr = attributes.find(attributes_prefix + "beta");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetFloatAttr(proto, beta_);
+    }
+  }
+
+  TensorShape GetInputShape(Ort::CustomOpApi& ort, OrtKernelContext* context, int index) {
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, index);
+    auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+    auto tensor_shape = ort.GetTensorShape(tensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+    return TensorShape(tensor_shape.data(), tensor_shape.size());
+  }
+
+  // row-major format of a tensor of rank dim_size
+  static dnnl::memory::format_tag GetPlainFormat(int dim_size) {
+    switch (dim_size) {
+      case 1:
+        return dnnl::memory::format_tag::a;
+      case 2:
+        return dnnl::memory::format_tag::ab;
+      case 3:
+        return dnnl::memory::format_tag::abc;
+      case 4:
+        return dnnl::memory::format_tag::abcd;
+      case 5:
+        return dnnl::memory::format_tag::abcde;
+      default:
+        return dnnl::memory::format_tag::abcdef;
+    }
+  }
+
+ private:
+  bool is_integer_ = false;
+  bool is_gemm_ = false;
+  bool has_bias_ = false;
+  int64_t trans_a_ = 0;
+  int64_t trans_b_ = 0;
+  float alpha_ = 1.0f;
+  float beta_ = 1.0f;
+
+  int64_t M_ = 0;
+  int64_t K_ = 0;
+  int64_t N_ = 0;
+
+  dnnl::memory::data_type weights_type_;
+  dnnl::memory::format_tag weights_format_;
+
+  std::unique_ptr<dnnl::memory> src_mem_;
+  std::unique_ptr<dnnl::memory> src_reorder_mem_;
+  std::unique_ptr<dnnl::memory> weights_mem_;
+  std::unique_ptr<dnnl::memory> bias_mem_;
+  std::unique_ptr<dnnl::memory> ip_dst_mem_;
+
+  // MatMulInteger: bias holding -a_zero_point * b_col_sums_
+  std::vector<int32_t> bias_buffer_;
+  std::vector<int32_t> b_col_sums_;
+
+  std::unique_ptr<dnnl::memory::desc> src_md_;
+  std::unique_ptr<dnnl::memory::desc> weights_md_;
+
+  std::unique_ptr<dnnl::inner_product_forward::desc> fwd_desc_;
+  std::unique_ptr<dnnl::inner_product_forward::primitive_desc> ip_fwd_pd_;
+  std::unique_ptr<dnnl::primitive> ip_fwd_;
+};
+}  // namespace ort_dnnl
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright 2019 JD.com Inc. JD AI
 
 #include "nnapi_execution_provider.h"
+#include "core/providers/nnapi/nnapi_provider_factory.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/compute_capability.h"
 #include "core/session/onnxruntime_cxx_api.h"
@@ -14,8 +15,8 @@ namespace onnxruntime {
 
 constexpr const char* NNAPI = "Nnapi";
 
-NnapiExecutionProvider::NnapiExecutionProvider()
-    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider} {
+NnapiExecutionProvider::NnapiExecutionProvider(uint32_t nnapi_flags)
+    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider}, nnapi_flags_(nnapi_flags) {
   DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                               [](int) { return onnxruntime::make_unique<CPUAllocator>(
                                                             onnxruntime::make_unique<OrtMemoryInfo>(NNAPI,
@@ -32,6 +33,40 @@ NnapiExecutionProvider::NnapiExecutionProvider()
 
 NnapiExecutionProvider::~NnapiExecutionProvider() {}
 
+std::shared_ptr<NnapiModel> NnapiExecutionProvider::CompileModel(const ONNX_NAMESPACE::ModelProto& model_proto) const {
+  // The compiled models of the process, by the hash of the model and the flags.
+  // NNAPI compiles a model for seconds on some devices, so a session created again for the same model reuses them.
+  static OrtMutex cache_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<NnapiModel>> cache;
+
+  std::string cache_key;
+  if (nnapi_flags_ & NNAPI_FLAG_CACHE_COMPILATION) {
+    std::string model_str;
+    model_proto.SerializeToString(&model_str);
+    cache_key = std::to_string(std::hash<std::string>()(model_str)) + "_" + std::to_string(model_str.size()) +
+                "_" + std::to_string(nnapi_flags_);
+    std::lock_guard<OrtMutex> lock(cache_mutex);
+    auto it = cache.find(cache_key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
+  dnn::OnnxReader onnx_reader;
+  dnn::ModelBuilder model_builder;
+  onnx_reader.ReadOnnx(model_proto, model_builder);
+  model_builder.AllowFp16((nnapi_flags_ & NNAPI_FLAG_USE_FP16) != 0);
+  auto nnapi_model = std::make_shared<NnapiModel>();
+  nnapi_model->model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
+
+  if (!cache_key.empty()) {
+    std::lock_guard<OrtMutex> lock(cache_mutex);
+    // keep the model of a concurrent compilation, if any
+    return cache.emplace(cache_key, nnapi_model).first->second;
+  }
+  return nnapi_model;
+}
+
 std::vector<std::vector<int>> NnapiExecutionProvider::GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const {
   dnn::OnnxConverter converter;
   return converter.GetSupportedNodes(model_proto);
@@ -209,12 +244,7 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     *(model_proto.mutable_graph()) = graph_body.ToGraphProto();
     model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
 
-    dnn::OnnxReader onnx_reader;
-    dnn::ModelBuilder model_builder;
-    onnx_reader.ReadOnnx(model_proto, model_builder);
-    model_builder.AllowFp16(true);
-    auto dnn_model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
-    dnn_models_.emplace(fused_node->Name(), std::move(dnn_model));
+    dnn_models_.emplace(fused_node->Name(), CompileModel(model_proto));
 
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [&](ComputeContext* context, FunctionState* state) {
@@ -223,19 +253,26 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     };
 
     compute_info.release_state_func = [](FunctionState state) {
-      // the `state` is a dnn::model managed by unique_ptr
+      // the `state` is a NnapiModel managed by shared_ptr
       ORT_UNUSED_PARAMETER(state);
     };
 
     compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
-      dnn::Model* model = reinterpret_cast<dnn::Model*>(state);
+      NnapiModel* nnapi_model = reinterpret_cast<NnapiModel*>(state);
+      dnn::Model* model = nnapi_model->model.get();
       const size_t num_inputs = ort.KernelContext_GetInputCount(context);
       const size_t num_outputs = ort.KernelContext_GetOutputCount(context);
       ORT_ENFORCE(model->GetInputs().size() <= num_inputs, "Inconsistent input sizes");
       ORT_ENFORCE(model->GetOutputs().size() == num_outputs, "Inconsistent output sizes");
-      // Maintain the created nhwc buffers so that they can be deleted after inferencing
-      std::vector<float*> nhwc_inputs;
+
+      std::lock_guard<OrtMutex> lock(nnapi_model->mutex);
+      auto& nhwc_input_buffers = nnapi_model->nhwc_inputs;
+      auto& nhwc_output_buffers = nnapi_model->nhwc_outputs;
+      nhwc_input_buffers.resize(model->GetInputs().size());
+      nhwc_output_buffers.resize(num_outputs);
+
+      // The nhwc outputs are transposed to the output tensors after inferencing
       std::vector<std::tuple<size_t, float*, std::vector<int64_t>>> nhwc_outputs;
       for (size_t i = 0; i < num_outputs; i++) {
         const auto output_name = model->GetOutputs()[i];
@@ -245,7 +282,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           // NHWC to NCHW
           std::swap(int64_output_shape[1], int64_output_shape[3]);
           std::swap(int64_output_shape[2], int64_output_shape[3]);
-          float* nhwc_output = new float[model->GetSize(output_name)];
+          nhwc_output_buffers[i].resize(model->GetSize(output_name));
+          float* nhwc_output = nhwc_output_buffers[i].data();
           model->SetOutputBuffer(i, nhwc_output);
           nhwc_outputs.push_back(std::make_tuple(i, nhwc_output, int64_output_shape));
         } else {
@@ -264,7 +302,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
         if (tensor_shape.size() == 4) {
           // Transpose nchw -> nhwc manually
           const int N = tensor_shape[0], C = tensor_shape[1], H = tensor_shape[2], W = tensor_shape[3];
-          float* nhwc_input = new float[N * C * H * W];
+          nhwc_input_buffers[i].resize(N * C * H * W);
+          float* nhwc_input = nhwc_input_buffers[i].data();
           for (int n = 0; n < N; n++) {
             for (int c = 0; c < C; c++) {
               for (int h = 0; h < H; h++) {
@@ -275,7 +314,6 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
             }
           }
           inputs.push_back(nhwc_input);
-          nhwc_inputs.push_back(nhwc_input);
         } else {
           inputs.push_back(input);
         }
@@ -302,12 +340,6 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           }
         }
       }
-      for (auto nhwc_input : nhwc_inputs) {
-        delete[] nhwc_input;
-      }
-      for (auto nhwc_output : nhwc_outputs) {
-        delete[] std::get<1>(nhwc_output);
-      }
       return Status::OK();
     };
 
@@ -4,12 +4,24 @@
 
 #include "core/framework/execution_provider.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
 #include "dnnlibrary/Model.h"
 
 namespace onnxruntime {
+
+// A compiled NNAPI model, which can be shared by the sessions of the process
+struct NnapiModel {
+  std::unique_ptr<dnn::Model> model;
+  // serializes the predictions of the sessions sharing the model
+  OrtMutex mutex;
+  // nhwc buffers of the 4D inputs and outputs, reused by the repeated predictions
+  std::vector<std::vector<float>> nhwc_inputs;
+  std::vector<std::vector<float>> nhwc_outputs;
+};
+
 class NnapiExecutionProvider : public IExecutionProvider {
  public:
-  NnapiExecutionProvider();
+  explicit NnapiExecutionProvider(uint32_t nnapi_flags);
   virtual ~NnapiExecutionProvider();
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -19,7 +31,10 @@ class NnapiExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<dnn::Model>> dnn_models_;
+  // NNAPIFlags
+  const uint32_t nnapi_flags_;
+  std::unordered_map<std::string, std::shared_ptr<NnapiModel>> dnn_models_;
   std::vector<std::vector<int>> GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const;
+  std::shared_ptr<NnapiModel> CompileModel(const ONNX_NAMESPACE::ModelProto& model_proto) const;
 };
 }  // namespace onnxruntime
@@ -9,24 +9,31 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct NnapiProviderFactory : IExecutionProviderFactory {
-  NnapiProviderFactory() {}
+  NnapiProviderFactory(uint32_t nnapi_flags) : nnapi_flags_(nnapi_flags) {}
   ~NnapiProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
+
+ private:
+  uint32_t nnapi_flags_;
 };
 
 std::unique_ptr<IExecutionProvider> NnapiProviderFactory::CreateProvider() {
-  return onnxruntime::make_unique<NnapiExecutionProvider>();
+  return onnxruntime::make_unique<NnapiExecutionProvider>(nnapi_flags_);
 }
 
-std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi() {
-  return std::make_shared<onnxruntime::NnapiProviderFactory>();
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi(uint32_t nnapi_flags) {
+  return std::make_shared<onnxruntime::NnapiProviderFactory>(nnapi_flags);
 }
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSessionOptions* options) {
-  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Nnapi());
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Nnapi(NNAPI_FLAG_USE_FP16));
   return nullptr;
 }
 
-
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_NnapiWithFlags, _In_ OrtSessionOptions* options,
+                    uint32_t nnapi_flags) {
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Nnapi(nnapi_flags));
+  return nullptr;
+}
@@ -37,6 +37,10 @@ static const std::unordered_set<std::string> valid_keys = {
     kNupharCacheSoName,
     kNupharCacheModelChecksum,
     kNupharCacheForceNoJIT,
+    kNupharCacheJitIR,
+    kNupharParallelCompile,
+    kNupharSpecializeShapes,
+    kNupharMaxSpecializedKernels,
     kNupharCodeGenTarget,
     kNupharParallelMinWorkloads};
 
@@ -17,6 +17,17 @@ constexpr static const char* kNupharCachePath = "nuphar_cache_path";
 constexpr static const char* kNupharCacheSoName = "nuphar_cache_so_name";
 constexpr static const char* kNupharCacheModelChecksum = "nuphar_cache_model_checksum";
 constexpr static const char* kNupharCacheForceNoJIT = "nuphar_cache_force_no_jit";
+// "on" to key the compiled functions by their subgraph, target and settings, and save their LLVM IR under
+// nuphar_cache_path, so later sessions and processes load them instead of compiling them again
+constexpr static const char* kNupharCacheJitIR = "nuphar_cache_jit_ir";
+// number of threads compiling the subgraphs of a fused node. 0 or 1 compiles them on the calling thread.
+constexpr static const char* kNupharParallelCompile = "nuphar_parallel_compile";
+// number of runs with the same values of the symbolic input dims of a fused node after which a kernel specialized
+// to them is compiled in the background. 0 (default) turns shape specialization off.
+constexpr static const char* kNupharSpecializeShapes = "nuphar_specialize_shapes";
+// maximum number of specialized kernels of a fused node
+constexpr static const char* kNupharMaxSpecializedKernels = "nuphar_max_specialized_kernels";
+constexpr static const int kNupharMaxSpecializedKernels_Default = 8;
 // force to use IMatMulExternMKL/IMatMul16ExternMKL
 constexpr static const char* kNupharIMatMulForceMkl = "nuphar_imatmul_force_mkl";
 
@@ -20,6 +20,8 @@
 #undef _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
 #include <atomic>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 namespace fs = std::experimental::filesystem;
 
 namespace onnxruntime {
@@ -209,6 +211,225 @@ std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const
   return NormalizeCppName("_" + subgraph.UniqueId() + "_" + codegen_target.GetTargetName() + "_p" + std::to_string(parallel_min_workloads));
 }
 
+bool IsJitIRCacheEnabled() {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  return settings.HasOption(kNupharCachePath) && settings.OptionMatches(kNupharCacheJitIR, "on");
+}
+
+// 64-bit FNV-1a
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static void AppendDefToKey(std::ostringstream& key, const NodeArg* def) {
+  if (def == nullptr || !def->Exists()) {
+    key << "<none>;";
+    return;
+  }
+  key << def->Name() << ":" << (def->Type() ? *def->Type() : "") << "[";
+  const auto* shape = def->Shape();
+  if (shape == nullptr) {
+    key << "?";
+  } else {
+    for (const auto& dim : shape->dim()) {
+      if (dim.has_dim_value())
+        key << dim.dim_value() << ",";
+      else if (dim.has_dim_param())
+        key << "$" << dim.dim_param() << ",";
+      else
+        key << "?,";
+    }
+  }
+  key << "];";
+}
+
+// options of CodeGenSettings that change the generated code
+static const char* const kCodeAffectingOptions[] = {
+    kNupharMatmulExec,
+    kNupharIMatMulForceMkl,
+    kNupharForceNoTensorize,
+    kNupharTensorize_IGEMM_Tile_M,
+    kNupharTensorize_IGEMM_Tile_N,
+    kNupharTensorize_IGEMM_Tile_K,
+    kNupharTensorize_IGEMM_Permute,
+    kNupharTensorize_IGEMM_Split_Last_Tile,
+    kNupharFastMath,
+    kNupharFastActivation,
+    kNupharCodeGenTarget,
+};
+
+std::string GetSubgraphCacheKey(const nuphar::NupharSubgraphUnit& subgraph,
+                                const CodeGenTarget& codegen_target,
+                                int64_t parallel_min_workloads,
+                                bool allow_unaligned_buffers) {
+  std::ostringstream key;
+  key << "version " << __NUPHAR_CACHE_VERSION__ << "\n";
+  key << "target " << codegen_target.GetTargetName() << " p" << parallel_min_workloads
+      << " unaligned " << allow_unaligned_buffers << "\n";
+
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  for (const char* option : kCodeAffectingOptions) {
+    if (settings.HasOption(option))
+      key << "option " << option << "=" << settings.GetOptionValue(option) << "\n";
+  }
+
+  for (const Node* node : subgraph.nodes) {
+    key << "node " << node->Domain() << ":" << node->OpType() << ":"
+        << (node->Op() ? node->Op()->SinceVersion() : -1) << " inputs ";
+    for (const NodeArg* def : node->InputDefs())
+      AppendDefToKey(key, def);
+    key << " implicit_inputs ";
+    for (const NodeArg* def : node->ImplicitInputDefs())
+      AppendDefToKey(key, def);
+    key << " outputs ";
+    for (const NodeArg* def : node->OutputDefs())
+      AppendDefToKey(key, def);
+    key << "\n";
+
+    // attributes are hashed in the order of their names, as NodeAttributes is unordered
+    std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> attributes;
+    for (const auto& attribute : node->GetAttributes())
+      attributes.emplace(attribute.first, &attribute.second);
+    for (const auto& attribute : attributes) {
+      // subgraphs are described by their Graph below, which has the optimizations applied to it
+      std::string bytes = attribute.second->type() == ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH
+                              ? std::string()
+                              : attribute.second->SerializeAsString();
+      key << "attribute " << attribute.first << " " << std::hex << HashBytes(bytes.data(), bytes.size())
+          << std::dec << "\n";
+    }
+    for (const auto& graph : node->GetSubgraphs()) {
+      std::string bytes = graph->ToGraphProto().SerializeAsString();
+      key << "subgraph " << bytes.size() << " " << std::hex << HashBytes(bytes.data(), bytes.size())
+          << std::dec << "\n";
+    }
+  }
+
+  key << "inputs ";
+  for (const NodeArg* def : subgraph.inputs)
+    AppendDefToKey(key, def);
+  key << "\noutputs ";
+  for (const NodeArg* def : subgraph.outputs)
+    AppendDefToKey(key, def);
+  key << "\nattrs ";
+  for (auto attr : subgraph.input_attrs)
+    key << static_cast<int>(attr) << ",";
+  key << " ";
+  for (auto attr : subgraph.output_attrs)
+    key << static_cast<int>(attr) << ",";
+  key << "\n";
+
+  // constant scalars are folded into the code, so the values of the initializers are part of the key
+  for (const auto& initializer : subgraph.initializers) {
+    const Tensor* tensor = initializer.second;
+    key << "initializer " << initializer.first << " " << DataTypeImpl::ToString(tensor->DataType()) << " "
+        << tensor->Shape().ToString() << " ";
+    uint64_t hash = HashBytes(nullptr, 0);
+    if (tensor->IsDataTypeString()) {
+      for (const auto& str : gsl::make_span(tensor->Data<std::string>(), tensor->Shape().Size()))
+        hash = HashBytes(str.data(), str.size() + 1, hash);
+    } else {
+      hash = HashBytes(tensor->DataRaw(), tensor->SizeInBytes(), hash);
+    }
+    key << std::hex << hash << std::dec << "\n";
+  }
+
+  return key.str();
+}
+
+std::string GetCachedPackedFuncName(const std::string& key, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads) {
+  std::ostringstream name;
+  name << "_h" << std::hex << std::setw(16) << std::setfill('0') << HashBytes(key.data(), key.size());
+  return NormalizeCppName(name.str() + "_" + codegen_target.GetTargetName() + "_p" + std::to_string(parallel_min_workloads));
+}
+
+static bool ReadFileToString(const fs::path& path, std::string& content) {
+  std::ifstream file(path.string(), std::ios::binary);
+  if (!file)
+    return false;
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  content = ss.str();
+  return true;
+}
+
+CacheStatus LoadTVMPackedFuncFromIRCache(const std::string& func_name, const std::string& key, tvm::runtime::PackedFunc& func) {
+  fs::path dir;
+  if (!IsJitIRCacheEnabled())
+    return CacheStatus::NotInUse;
+  if (!GetOrCreateTVMModuleCacheDirectory(dir, /*create*/ false))
+    return CacheStatus::Missing;
+  dir.append("ir");
+
+  fs::path key_path = dir / (func_name + ".key");
+  fs::path ll_path = dir / (func_name + ".ll");
+  std::string cached_key;
+  if (!ReadFileToString(key_path, cached_key) || !fs::is_regular_file(ll_path))
+    return CacheStatus::Missing;
+
+  if (cached_key != key) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cached " << func_name << " was compiled from another subgraph, using JIT...";
+    return CacheStatus::Mismatch;
+  }
+
+  try {
+    tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(ll_path.string(), "ll");
+    func = module.GetFunction(func_name);
+  } catch (const std::exception& ex) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Failed to load " << ll_path.string() << ": " << ex.what() << ", using JIT...";
+    return CacheStatus::Mismatch;
+  }
+
+  if (func == nullptr) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cannot find " << func_name << " in " << ll_path.string() << ", using JIT...";
+    return CacheStatus::Mismatch;
+  }
+  return CacheStatus::Found;
+}
+
+void SaveTVMModuleIRToCache(const std::string& func_name, const std::string& key, tvm::runtime::Module& module) {
+  fs::path dir;
+
+  static std::mutex save_cache_mutex;
+  std::lock_guard<std::mutex> lock(save_cache_mutex);
+  if (!GetOrCreateTVMModuleCacheDirectory(dir, /*create*/ true))
+    return;
+  dir.append("ir");
+  if (!fs::is_directory(dir) && !fs::create_directory(dir))
+    throw std::runtime_error("Failed to create directory " + dir.string());
+
+  // other processes may read or write the same entry, so the files are written under temporary names and renamed.
+  // The key is renamed last, so an entry is complete once its key exists.
+  const std::string suffix = ".tmp" + std::to_string(Env::Default().GetSelfPid());
+  fs::path ll_path = dir / (func_name + ".ll");
+  fs::path key_path = dir / (func_name + ".key");
+  fs::path ll_temp_path = dir / (func_name + ".ll" + suffix);
+  fs::path key_temp_path = dir / (func_name + ".key" + suffix);
+
+  try {
+    module->SaveToFile(ll_temp_path.string(), "ll");
+    {
+      std::ofstream key_file(key_temp_path.string(), std::ios::binary);
+      key_file << key;
+      if (!key_file)
+        throw std::runtime_error("Failed to write " + key_temp_path.string());
+    }
+    fs::rename(ll_temp_path, ll_path);
+    fs::rename(key_temp_path, key_path);
+  } catch (const std::exception& ex) {
+    // the function is compiled already, so failing to cache it only costs another compilation later
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Failed to save " << func_name << " to cache: " << ex.what();
+    std::error_code ec;
+    fs::remove(ll_temp_path, ec);
+    fs::remove(key_temp_path, ec);
+  }
+}
+
 bool TryCreateConstantScalar(
     tvm::Expr& scalar,
     const Tensor* tensor) {
@@ -32,6 +32,24 @@ void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& mod
 
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads);
 
+// Helper functions of the JIT IR cache, enabled by nuphar_cache_jit_ir with nuphar_cache_path.
+// A compiled function is saved as <func_name>.ll with its key in <func_name>.key, and is loaded only if the key
+// matches, so a hash collision or a partially written entry falls back to JIT.
+bool IsJitIRCacheEnabled();
+
+// The key describes everything the code of a subgraph depends on: its nodes and their attributes, the types and
+// shapes of their values, the constant initializers, the codegen target and the codegen settings.
+std::string GetSubgraphCacheKey(const nuphar::NupharSubgraphUnit& subgraph,
+                                const CodeGenTarget& codegen_target,
+                                int64_t parallel_min_workloads,
+                                bool allow_unaligned_buffers);
+
+// Name of the function of a subgraph in the JIT IR cache, derived from the hash of its key
+std::string GetCachedPackedFuncName(const std::string& key, const CodeGenTarget& codegen_target, int64_t parallel_min_workloads);
+
+CacheStatus LoadTVMPackedFuncFromIRCache(const std::string& func_name, const std::string& key, tvm::runtime::PackedFunc& func);
+void SaveTVMModuleIRToCache(const std::string& func_name, const std::string& key, tvm::runtime::Module& module);
+
 bool TryCreateConstantScalar(tvm::Expr& scalar, const Tensor* tensor);
 }  // namespace nuphar
 }  //  namespace onnxruntime
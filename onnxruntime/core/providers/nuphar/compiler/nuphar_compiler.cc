@@ -65,6 +65,13 @@ NupharCompiler::NupharCompiler(const nuphar::NupharSubgraphUnit& subgraph,
     : num_initializers_in_graph_inputs_(0),
       context_(subgraph, generated_initializers, handle) {}
 
+void NupharCompiler::SpecializeDims(const std::map<std::string, int64_t>& specialized_dims) {
+  specialized_dims_ = specialized_dims;
+  for (const auto& dim : specialized_dims_) {
+    context_.SpecializeDynamicDim(dim.first, dim.second);
+  }
+}
+
 Status NupharCompiler::Build(const nuphar::NupharSubgraphUnit& subgraph) {
   if (subgraph.nodes.front()->OpType() == "Scan") {
     return BuildSubgraph(*subgraph.nodes.front());
@@ -146,13 +153,19 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
     tvm::Target tvm_host_target,
     const tvm::BuildConfig& config,
     const std::string& subgraph_type,
-    const std::string& subgraph_name) {
+    const std::string& subgraph_name,
+    const std::string& cache_key,
+    bool use_aot_cache) {
   // TODO: refactor the following logic for both JIT-caching and AOT support
   // JIT-caching and AOT are mutual exclusive.
   // Change it by not always saving a compiled func unless it is in JIT-Caching model.
   // In AOT, there should be another member func explicitly loading
   tvm::runtime::PackedFunc cached_func;
-  auto cache_status = nuphar::LoadTVMPackedFuncFromCache(func_name, cached_func);
+  // the JIT IR cache replaces the AOT cache, whose function names are not derived from the subgraphs
+  auto cache_status = !cache_key.empty()
+                          ? nuphar::LoadTVMPackedFuncFromIRCache(func_name, cache_key, cached_func)
+                          : use_aot_cache ? nuphar::LoadTVMPackedFuncFromCache(func_name, cached_func)
+                                          : nuphar::CacheStatus::NotInUse;
   if (cache_status != nuphar::CacheStatus::Found) {
     codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
 
@@ -181,7 +194,9 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
 
     tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
     tvm_codegen::DumpTVMModuleToFile(func_name, module);
-    if (cache_status == nuphar::CacheStatus::Missing) {
+    if (!cache_key.empty()) {
+      nuphar::SaveTVMModuleIRToCache(func_name, cache_key, module);
+    } else if (cache_status == nuphar::CacheStatus::Missing) {
       nuphar::SaveTVMModuleToCache(func_name, module);
     }
     cached_func = module.GetFunction(func_name);
@@ -211,20 +226,56 @@ Status NupharCompiler::Lower(const nuphar::NupharSubgraphUnit& subgraph,
                              tvm::Target tvm_host_target,
                              NupharFuncInfo* func_info,
                              nuphar::OrtSubgraphAllocationInfo* partition_info) {
+  ORT_RETURN_IF_ERROR(CompileFunc(subgraph, tvm_target, tvm_host_target));
+  return FillFuncInfo(subgraph, tvm_target, func_info, partition_info);
+}
+
+Status NupharCompiler::CompileFunc(const nuphar::NupharSubgraphUnit& subgraph,
+                                   tvm::Target tvm_target,
+                                   tvm::Target tvm_host_target) {
   const auto& codegen_handle = context_.GetCodeGenHandle();
   const auto& target_codegen = *codegen_handle->codegen_target;
-  std::string func_name = nuphar::GetPackedFuncName(subgraph, target_codegen, codegen_handle->parallel_min_workloads);
+  std::string specialization;
+  for (const auto& dim : specialized_dims_) {
+    specialization += "_" + dim.first + "_" + std::to_string(dim.second);
+  }
+
+  std::string cache_key;
+  if (nuphar::IsJitIRCacheEnabled()) {
+    cache_key = nuphar::GetSubgraphCacheKey(subgraph, target_codegen, codegen_handle->parallel_min_workloads,
+                                            codegen_handle->allow_unaligned_buffers);
+    if (!specialization.empty()) {
+      cache_key += "specialized " + specialization + "\n";
+    }
+    func_name_ = nuphar::GetCachedPackedFuncName(cache_key, target_codegen, codegen_handle->parallel_min_workloads);
+  } else {
+    func_name_ = nuphar::GetPackedFuncName(subgraph, target_codegen, codegen_handle->parallel_min_workloads);
+    if (!specialization.empty()) {
+      func_name_ = NormalizeCppName(func_name_ + "_s" + specialization);
+    }
+  }
   tvm::BuildConfig config = CreateConfig(*subgraph.nodes.front(),
                                          context_.GetCodeGenHandle()->allow_unaligned_buffers);
 
   // using "subgraph" for type and name for now
   // TODO: change name
-  tvm::runtime::PackedFunc cached_func =
+  compiled_func_ =
       GetLoweredPackedFunc(
-          func_name, tvm_target, tvm_host_target,
-          config, "subgraph", "subgraph");
+          func_name_, tvm_target, tvm_host_target,
+          config, "subgraph", "subgraph", cache_key,
+          // specialized functions are compiled in the background in no fixed order, so their names cannot
+          // match the functions of an AOT cache
+          /*use_aot_cache*/ specialized_dims_.empty());
+
+  return Status::OK();
+}
 
-  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, cached_func, func_name);
+Status NupharCompiler::FillFuncInfo(const nuphar::NupharSubgraphUnit& subgraph,
+                                    tvm::Target tvm_target,
+                                    NupharFuncInfo* func_info,
+                                    nuphar::OrtSubgraphAllocationInfo* partition_info) {
+  ORT_RETURN_IF_NOT(compiled_func_ != nullptr, "FillFuncInfo is called before CompileFunc");
+  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, compiled_func_, func_name_);
 
   return Status::OK();
 }
@@ -31,6 +31,9 @@ class NupharCompiler {
                  std::unordered_map<std::string, std::unique_ptr<Tensor>>& generated_initializers,
                  const NupharCodeGenHandle* handle);
 
+  // SpecializeDims generates the given symbolic dims as constants. It must be called before Build.
+  void SpecializeDims(const std::map<std::string, int64_t>& specialized_dims);
+
   // Build builds tvm IR and apply passes
   Status Build(const nuphar::NupharSubgraphUnit& subgraph);
 
@@ -41,13 +44,28 @@ class NupharCompiler {
                NupharFuncInfo* ctx_func,
                nuphar::OrtSubgraphAllocationInfo* partition_info);
 
+  // CompileFunc and FillFuncInfo are the two steps of Lower.
+  // CompileFunc only touches this compiler, so the compilers of different subgraphs can run it concurrently.
+  Status CompileFunc(const nuphar::NupharSubgraphUnit& subgraph,
+                     tvm::Target tvm_target,
+                     tvm::Target tvm_host_target);
+
+  // FillFuncInfo fills the func info of the function compiled by CompileFunc, and updates the shared partition_info
+  Status FillFuncInfo(const nuphar::NupharSubgraphUnit& subgraph,
+                      tvm::Target tvm_target,
+                      NupharFuncInfo* ctx_func,
+                      nuphar::OrtSubgraphAllocationInfo* partition_info);
+
+  // cache_key is the key of the function in the JIT IR cache, or empty if the cache is not used
   tvm::runtime::PackedFunc GetLoweredPackedFunc(
       const std::string& func_name,
       tvm::Target tvm_target,
       tvm::Target tvm_host_target,
       const tvm::BuildConfig& config,
       const std::string& subgraph_type,
-      const std::string& subgraph_name);
+      const std::string& subgraph_name,
+      const std::string& cache_key = std::string(),
+      bool use_aot_cache = true);
 
  private:
   size_t num_initializers_in_graph_inputs_;
@@ -59,6 +77,12 @@ class NupharCompiler {
 
   tvm::Array<tvm::Tensor> tvm_args_;
   tvm::Array<tvm::Tensor> tvm_outputs_;
+
+  std::map<std::string, int64_t> specialized_dims_;
+
+  // set by CompileFunc
+  std::string func_name_;
+  tvm::runtime::PackedFunc compiled_func_;
 };
 
 }  // namespace nuphar
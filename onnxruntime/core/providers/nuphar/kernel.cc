@@ -5,13 +5,21 @@
 
 #include "core/codegen/passes/utils/codegen_context.h"
 #include "core/codegen/common/profile.h"
+#include "core/codegen/common/settings.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/nuphar/common/analysis/subgraph_codegen_stats.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/nuphar_execution_provider.h"
 #include "core/providers/nuphar/partition/subgraph_partitioner.h"
 #include "core/providers/nuphar/runtime/sequential/basic.h"
 #include "core/providers/nuphar/runtime/sequential/loop.h"
+#include "core/providers/nuphar/shape_specializer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 namespace onnxruntime {
 namespace nuphar {
@@ -21,9 +29,11 @@ thread_local std::unique_ptr<NupharFuncStateToComputeCtxMap> NupharKernelState::
 NupharKernelState::NupharKernelState(
     const Node& node,
     const ComputeContext& ctx,
-    const NupharExecutionProvider& provider)
+    const NupharExecutionProvider& provider,
+    const std::map<std::string, int64_t>& specialized_dims)
     : provider_(provider),
-      ctx_(ctx) {
+      ctx_(ctx),
+      specialized_dims_(specialized_dims) {
   partition_info_ = onnxruntime::make_unique<OrtSubgraphAllocationInfo>(node);
 
   std::vector<NupharSubgraphUnit> subgraphs;
@@ -35,16 +45,52 @@ NupharKernelState::NupharKernelState(
       subgraphs,
       [&](const std::string& name) { return provider_.GetConstantInitializer(name); });
 
-  for (auto& subgraph : subgraphs) {
-    Compile(subgraph);
+  int num_compile_threads = 1;
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(kNupharParallelCompile)) {
+    num_compile_threads = std::stoi(settings.GetOptionValue(kNupharParallelCompile));
+  }
+
+  if (num_compile_threads > 1 && subgraphs.size() > 1) {
+    CompileInParallel(subgraphs, num_compile_threads);
     if (!codegen_status_.IsOK()) {
       return;  // early return
     }
+  } else {
+    for (auto& subgraph : subgraphs) {
+      Compile(subgraph);
+      if (!codegen_status_.IsOK()) {
+        return;  // early return
+      }
+    }
   }
 
   // Currently BuildExecBlocksAndCalls is inserted here
   // TODO: after AOT support, we should move it to a proper location
   BuildExecBlocksAndCalls(subgraphs);
+
+  int specialize_shapes = 0;
+  if (settings.HasOption(kNupharSpecializeShapes)) {
+    specialize_shapes = std::stoi(settings.GetOptionValue(kNupharSpecializeShapes));
+  }
+  // specialized kernels are JIT compiled, so they are not available when JIT is not allowed
+  bool jit_allowed = !settings.OptionMatches(kNupharCacheForceNoJIT, "on");
+  if (specialized_dims_.empty() && specialize_shapes > 0 && jit_allowed) {
+    int max_kernels = kNupharMaxSpecializedKernels_Default;
+    if (settings.HasOption(kNupharMaxSpecializedKernels)) {
+      max_kernels = std::stoi(settings.GetOptionValue(kNupharMaxSpecializedKernels));
+    }
+    shape_specializer_ = onnxruntime::make_unique<NupharShapeSpecializer>(
+        node,
+        specialize_shapes,
+        max_kernels,
+        [&node, this](const std::map<std::string, int64_t>& dims) {
+          return onnxruntime::make_unique<NupharKernelState>(node, ctx_, provider_, dims);
+        });
+    if (!shape_specializer_->HasSymbolicDims()) {
+      shape_specializer_.reset();
+    }
+  }
 }
 
 void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
@@ -54,6 +100,7 @@ void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
   NupharCompiler tvm_compiler(subgraph,
                               generated_initailizers_,
                               provider_.GetNupharCodeGenHandle());
+  tvm_compiler.SpecializeDims(specialized_dims_);
 
   codegen_status_ = tvm_compiler.Build(subgraph);
 
@@ -67,6 +114,70 @@ void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
   }
 }
 
+void NupharKernelState::CompileInParallel(const std::vector<NupharSubgraphUnit>& subgraphs, int num_threads) {
+  auto tvm_target = provider_.GetTVMTarget();
+  auto tvm_host_target = provider_.GetTVMHostTarget();
+
+  // Build adds the generated initializers of the kernel, so it runs in order
+  std::vector<std::unique_ptr<NupharCompiler>> compilers;
+  for (const auto& subgraph : subgraphs) {
+    compilers.push_back(onnxruntime::make_unique<NupharCompiler>(subgraph,
+                                                                 generated_initailizers_,
+                                                                 provider_.GetNupharCodeGenHandle()));
+    compilers.back()->SpecializeDims(specialized_dims_);
+    codegen_status_ = compilers.back()->Build(subgraph);
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
+  }
+
+  std::vector<Status> statuses(subgraphs.size());
+  std::vector<std::exception_ptr> exceptions(subgraphs.size());
+  std::atomic<size_t> next_subgraph{0};
+  auto compile = [&]() {
+    for (size_t idx = next_subgraph++; idx < subgraphs.size(); idx = next_subgraph++) {
+      try {
+        statuses[idx] = compilers[idx]->CompileFunc(subgraphs[idx], tvm_target, tvm_host_target);
+      } catch (...) {
+        exceptions[idx] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  size_t num_workers = std::min(static_cast<size_t>(num_threads), subgraphs.size());
+  for (size_t i = 1; i < num_workers; ++i) {
+    threads.emplace_back(compile);
+  }
+  compile();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // report the failure of the first subgraph, as the sequential compilation does
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    if (exceptions[idx]) {
+      std::rethrow_exception(exceptions[idx]);
+    }
+    if (!statuses[idx].IsOK()) {
+      codegen_status_ = statuses[idx];
+      return;
+    }
+  }
+
+  // FillFuncInfo assigns the allocation offsets of partition_info_, so it runs in order
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    func_infos_.emplace_back(onnxruntime::make_unique<NupharFuncInfo>());
+    codegen_status_ = compilers[idx]->FillFuncInfo(subgraphs[idx],
+                                                   tvm_target,
+                                                   func_infos_.back().get(),
+                                                   partition_info_.get());
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
+  }
+}
+
 void NupharKernelState::BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs) {
   // create ExecBlocks
   for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
@@ -83,6 +194,9 @@ void NupharKernelState::BuildExecBlocksAndCalls(const std::vector<NupharSubgraph
 }
 
 NupharKernelState::~NupharKernelState() {
+  // stop compiling specialized kernels before this kernel goes away
+  shape_specializer_.reset();
+
   if (nullptr != nuphar_compute_ctx_map_)
     nuphar_compute_ctx_map_->erase(this);
 }
@@ -92,6 +206,13 @@ Status NupharKernelState::Compute(OpKernelContext* op_kernel_context) const {
     return codegen_status_;
   }
 
+  if (shape_specializer_ != nullptr) {
+    const NupharKernelState* specialized = shape_specializer_->Find(op_kernel_context);
+    if (specialized != nullptr) {
+      return specialized->Compute(op_kernel_context);
+    }
+  }
+
   // Create the unordered_map if it not exist
   if (nullptr == nuphar_compute_ctx_map_) {
     nuphar_compute_ctx_map_ = onnxruntime::make_unique<NupharFuncStateToComputeCtxMap>();
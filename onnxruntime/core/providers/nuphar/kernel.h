@@ -24,22 +24,34 @@ class NupharExecutionProvider;
 namespace nuphar {
 
 class NupharKernelState;
+class NupharShapeSpecializer;
 using NupharFuncStateToComputeCtxMap =
     std::unordered_map<const NupharKernelState*, std::unique_ptr<KernelComputeCtx>>;
 
 class NupharKernelState {
  public:
+  // specialized_dims are the symbolic dims compiled as constants. A kernel without them is the generic kernel,
+  // which runs for any shapes and dispatches to the specialized kernels it compiled for frequent shapes.
   explicit NupharKernelState(
       const Node& fused_node,
       const ComputeContext& ctx,
-      const NupharExecutionProvider& provider);
+      const NupharExecutionProvider& provider,
+      const std::map<std::string, int64_t>& specialized_dims = {});
 
   ~NupharKernelState();
 
   Status Compute(OpKernelContext* op_kernel_context) const;
 
+  const Status& CodegenStatus() const {
+    return codegen_status_;
+  }
+
   void Compile(const NupharSubgraphUnit& subgraph);
 
+  // Compile the subgraphs on up to num_threads threads. The functions are lowered concurrently,
+  // while the steps that share the state of the kernel run in order.
+  void CompileInParallel(const std::vector<NupharSubgraphUnit>& subgraphs, int num_threads);
+
   void BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs);
 
  private:
@@ -67,6 +79,11 @@ class NupharKernelState {
   // Here ComputeContext of Ort is used for allocator
   ComputeContext ctx_;  // the compute context from IExecutionProvider::Compile interface
 
+  std::map<std::string, int64_t> specialized_dims_;
+
+  // compiles and finds the specialized kernels of the generic kernel, if shape specialization is on
+  std::unique_ptr<NupharShapeSpecializer> shape_specializer_;
+
   static thread_local std::unique_ptr<NupharFuncStateToComputeCtxMap> nuphar_compute_ctx_map_;
 };
 
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/shape_specializer.h"
+
+#include "core/common/logging/logging.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/providers/nuphar/kernel.h"
+
+namespace onnxruntime {
+namespace nuphar {
+
+// values whose count is below min_hits are forgotten once this many are tracked, so shapes that never repeat
+// don't grow the counts without bound
+static const size_t kMaxTrackedShapes = 1024;
+
+NupharShapeSpecializer::NupharShapeSpecializer(const Node& fused_node,
+                                               int min_hits,
+                                               int max_kernels,
+                                               CompileFunc compile_func)
+    : min_hits_(min_hits),
+      max_kernels_(static_cast<size_t>(max_kernels)),
+      compile_func_(std::move(compile_func)) {
+  int input_index = 0;
+  for (const NodeArg* def : fused_node.InputDefs()) {
+    const auto* shape = def->Shape();
+    if (shape != nullptr) {
+      for (int dim = 0; dim < shape->dim_size(); ++dim) {
+        if (utils::HasDimParam(shape->dim(dim))) {
+          symbolic_dims_.push_back({input_index, static_cast<size_t>(dim), shape->dim(dim).dim_param()});
+        }
+      }
+    }
+    ++input_index;
+  }
+}
+
+NupharShapeSpecializer::~NupharShapeSpecializer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (compile_thread_.joinable()) {
+    compile_thread_.join();
+  }
+}
+
+bool NupharShapeSpecializer::GetSpecializedDims(const std::vector<int64_t>& values,
+                                                std::map<std::string, int64_t>& specialized_dims) const {
+  for (size_t i = 0; i < symbolic_dims_.size(); ++i) {
+    auto inserted = specialized_dims.emplace(symbolic_dims_[i].symbol, values[i]);
+    if (!inserted.second && inserted.first->second != values[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const NupharKernelState* NupharShapeSpecializer::Find(const OpKernelContext* op_kernel_context) {
+  std::vector<int64_t> values;
+  values.reserve(symbolic_dims_.size());
+  for (const auto& symbolic_dim : symbolic_dims_) {
+    const Tensor* input = op_kernel_context->Input<Tensor>(symbolic_dim.input_index);
+    if (input == nullptr || symbolic_dim.dim >= input->Shape().NumDimensions()) {
+      return nullptr;
+    }
+    values.push_back(input->Shape()[symbolic_dim.dim]);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto kernel = kernels_.find(values);
+  if (kernel != kernels_.end()) {
+    return kernel->second.get();
+  }
+
+  if (kernels_.size() >= max_kernels_) {
+    return nullptr;
+  }
+
+  if (hits_.size() >= kMaxTrackedShapes && hits_.count(values) == 0) {
+    hits_.clear();
+  }
+  if (++hits_[values] < min_hits_) {
+    return nullptr;
+  }
+  hits_.erase(values);
+
+  kernels_.emplace(values, nullptr);
+  std::map<std::string, int64_t> specialized_dims;
+  if (!GetSpecializedDims(values, specialized_dims)) {
+    // the inputs don't agree on a symbol, so the generic kernel is left to handle them
+    return nullptr;
+  }
+
+  pending_.push_back(std::move(values));
+  if (!compile_thread_.joinable()) {
+    compile_thread_ = std::thread(&NupharShapeSpecializer::CompileLoop, this);
+  }
+  cv_.notify_one();
+  return nullptr;
+}
+
+void NupharShapeSpecializer::CompileLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+    if (stop_) {
+      return;
+    }
+
+    std::vector<int64_t> values = std::move(pending_.front());
+    pending_.pop_front();
+    lock.unlock();
+
+    std::map<std::string, int64_t> specialized_dims;
+    GetSpecializedDims(values, specialized_dims);
+    std::unique_ptr<NupharKernelState> kernel;
+    try {
+      kernel = compile_func_(specialized_dims);
+      if (!kernel->CodegenStatus().IsOK()) {
+        LOGS_DEFAULT(WARNING) << "Failed to compile a specialized Nuphar kernel: "
+                              << kernel->CodegenStatus().ErrorMessage();
+        kernel.reset();
+      }
+    } catch (const std::exception& ex) {
+      LOGS_DEFAULT(WARNING) << "Failed to compile a specialized Nuphar kernel: " << ex.what();
+      kernel.reset();
+    }
+
+    lock.lock();
+    kernels_[values] = std::move(kernel);
+  }
+}
+
+}  // namespace nuphar
+}  // namespace onnxruntime
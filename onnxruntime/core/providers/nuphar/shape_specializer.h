@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+#include "core/graph/graph.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace onnxruntime {
+namespace nuphar {
+
+class NupharKernelState;
+
+// NupharShapeSpecializer tracks the values of the symbolic dims of the inputs of a fused node at runtime.
+// Once the same values are seen min_hits times, a kernel specialized to them is compiled on a background thread,
+// up to max_kernels kernels. Until then, or if the compilation fails, the generic kernel runs.
+class NupharShapeSpecializer {
+ public:
+  using CompileFunc = std::function<std::unique_ptr<NupharKernelState>(const std::map<std::string, int64_t>&)>;
+
+  NupharShapeSpecializer(const Node& fused_node,
+                         int min_hits,
+                         int max_kernels,
+                         CompileFunc compile_func);
+
+  // waits for the kernel being compiled
+  ~NupharShapeSpecializer();
+
+  // returns true if the inputs of the fused node have symbolic dims to specialize
+  bool HasSymbolicDims() const {
+    return !symbolic_dims_.empty();
+  }
+
+  // returns the kernel specialized to the input shapes of op_kernel_context, or nullptr to run the generic kernel
+  const NupharKernelState* Find(const OpKernelContext* op_kernel_context);
+
+ private:
+  struct SymbolicDim {
+    int input_index;
+    size_t dim;
+    std::string symbol;
+  };
+
+  // returns false if a symbol has different values in different inputs
+  bool GetSpecializedDims(const std::vector<int64_t>& values, std::map<std::string, int64_t>& specialized_dims) const;
+
+  void CompileLoop();
+
+  std::vector<SymbolicDim> symbolic_dims_;
+  const int min_hits_;
+  const size_t max_kernels_;
+  CompileFunc compile_func_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // the number of runs of the values that have no kernel yet
+  std::map<std::vector<int64_t>, int> hits_;
+  // the kernels by the values of symbolic_dims_. A kernel is null while it is compiled, or if it failed to compile.
+  std::map<std::vector<int64_t>, std::unique_ptr<NupharKernelState>> kernels_;
+  std::deque<std::vector<int64_t>> pending_;
+  bool stop_ = false;
+  std::thread compile_thread_;
+};
+
+}  // namespace nuphar
+}  // namespace onnxruntime
@@ -8,6 +8,10 @@
 #include <memory>
 #include <cstdlib>
 #include <fstream>
+#include <deque>
+#include <cstdio>
+#include <functional>
+#include <thread>
 #include <Python.h>
 
 #include <inference_engine.hpp>
@@ -25,6 +29,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 
 #include "openvino_graph.h"
 
@@ -84,8 +89,23 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   // having more Infer Requests than needed would waste system resources.
   // In VAD-M (HDDL) accelerator, there are 8 parallel execution units. So, creating 8 instances
   // of Infer Requests only if the VAD-M accelerator is being used.
+  // The MYRIAD and GPU plugins pipeline the transfers and the inference of a few Infer Requests.
+  // ORT_OPENVINO_NUM_INFER_REQUESTS sets the number of Infer Requests, which are shared by the
+  // batch slices and the concurrent runs of the graph.
   // sets number of maximum parallel inferences
-  num_inf_reqs_ = (device_id_ == "HDDL") ? 8 : 1;
+  if (device_id_ == "HDDL") {
+    num_inf_reqs_ = 8;
+  } else if (device_id_ == "MYRIAD") {
+    num_inf_reqs_ = 4;
+  } else if (device_id_ == "GPU") {
+    num_inf_reqs_ = 2;
+  } else {
+    num_inf_reqs_ = 1;
+  }
+  const char* num_inf_reqs_env = getenv("ORT_OPENVINO_NUM_INFER_REQUESTS");
+  if (num_inf_reqs_env != nullptr && atoi(num_inf_reqs_env) > 0) {
+    num_inf_reqs_ = static_cast<size_t>(atoi(num_inf_reqs_env));
+  }
 
   fused_node_ = fused_node;
 
@@ -124,8 +144,14 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   // Create hardware specific OpenVINO network representation
   GetExecutableHandle(openvino_network_);
 
+  std::map<std::string, std::string> config;
+  if (device_id_ == "CPU" && num_inf_reqs_ > 1) {
+    // one CPU stream for each Infer Request, so they run in parallel
+    config[CONFIG_KEY(CPU_THROUGHPUT_STREAMS)] = std::to_string(num_inf_reqs_);
+  }
+
   //Loading model to the plugin
-  auto exeNetwork = ie.LoadNetwork(*openvino_network_, device_id_);
+  auto exeNetwork = LoadNetwork(config);
 
   LOGS_DEFAULT(INFO) << log_tag << "Network loaded into accelerator plug-in succesfully";
 
@@ -134,12 +160,64 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
     auto infRequest = exeNetwork.CreateInferRequestPtr();
 
     infer_requests_.push_back(infRequest);
+    free_infer_requests_.push_back(i);
   }
   LOGS_DEFAULT(INFO) << log_tag << "Infer requests created: " << num_inf_reqs_;
 }
 
+std::string OpenVINOGraph::GetCachePath() {
+  const char* cache_path_env = getenv("ORT_OPENVINO_CACHE_PATH");
+  return cache_path_env != nullptr ? std::string(cache_path_env) : std::string();
+}
+
+// unique for the thread and the process writing a cache file
+static std::string TempFileSuffix() {
+  return ".tmp" + std::to_string(Env::Default().GetSelfPid()) + "_" +
+         std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+static bool ReadCacheFile(const std::string& file_name, std::string& content) {
+  std::ifstream file(file_name, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+// Writes to a temporary file first, so a concurrent reader never sees a partial file
+static void WriteCacheFile(const std::string& file_name, const std::string& content) {
+  std::string temp_file_name = file_name + TempFileSuffix();
+  {
+    std::ofstream file(temp_file_name, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      LOGS_DEFAULT(WARNING) << OpenVINOGraph::log_tag << "Cannot write the cache file " << file_name;
+      return;
+    }
+    file.write(content.data(), content.size());
+  }
+  if (std::rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+    std::remove(temp_file_name.c_str());
+  }
+}
+
 void OpenVINOGraph::ConvertONNXModelToOpenVINOIR(const std::string& onnx_model,
                                                  std::string& openvino_xml, std::string& openvino_bin, bool precision_fp32) {
+  // The IR of a model is cached by the hash of the serialized model and the precision.
+  // The model is kept next to the IR to detect hash collisions.
+  std::string cache_path = GetCachePath();
+  std::string cache_prefix;
+  if (!cache_path.empty()) {
+    cache_prefix = cache_path + "/" + std::to_string(std::hash<std::string>()(onnx_model)) +
+                   (precision_fp32 ? "_fp32" : "_fp16");
+    std::string cached_model;
+    if (ReadCacheFile(cache_prefix + ".onnx", cached_model) && cached_model == onnx_model &&
+        ReadCacheFile(cache_prefix + ".xml", openvino_xml) && ReadCacheFile(cache_prefix + ".bin", openvino_bin)) {
+      LOGS_DEFAULT(INFO) << log_tag << "Read the OpenVINO IR from " << cache_prefix << ".xml";
+      return;
+    }
+  }
+
   Py_Initialize();
   if (!Py_IsInitialized()) {
     throw "Python environment initialization failure";
@@ -199,11 +277,55 @@ void OpenVINOGraph::ConvertONNXModelToOpenVINOIR(const std::string& onnx_model,
   Py_XDECREF(pFunc);
   Py_XDECREF(pModule);
 
+  if (!cache_prefix.empty()) {
+    // the model is written last, so it marks a complete IR
+    WriteCacheFile(cache_prefix + ".xml", openvino_xml);
+    WriteCacheFile(cache_prefix + ".bin", openvino_bin);
+    WriteCacheFile(cache_prefix + ".onnx", onnx_model);
+  }
+
   // Calling Py_Finalize here prevents multiple invocations
   // of the interpreter from the same process. Relying on
   // OS process clean up routines for python shutdown.
 }
 
+InferenceEngine::ExecutableNetwork OpenVINOGraph::LoadNetwork(const std::map<std::string, std::string>& config) {
+  // Compiling a network for the VPUs takes long, and the compiled network can be exported.
+  // It is cached by the hash of the IR.
+  std::string cache_path = GetCachePath();
+  if (cache_path.empty() || (device_id_ != "MYRIAD" && device_id_ != "HDDL")) {
+    return ie.LoadNetwork(*openvino_network_, device_id_, config);
+  }
+
+  const auto& attributes = fused_node_->GetAttributes();
+  std::string blob_file_name = cache_path + "/" +
+                               std::to_string(std::hash<std::string>()(attributes.at("xml_str").s() + attributes.at("weights_str").s())) +
+                               "_" + std::to_string(num_inf_reqs_) + "_" + device_id_ + ".blob";
+  std::ifstream blob_file(blob_file_name, std::ios::binary);
+  if (blob_file) {
+    blob_file.close();
+    try {
+      auto exe_network = ie.ImportNetwork(blob_file_name, device_id_, config);
+      LOGS_DEFAULT(INFO) << log_tag << "Imported the compiled network from " << blob_file_name;
+      return exe_network;
+    } catch (const std::exception& ex) {
+      LOGS_DEFAULT(WARNING) << log_tag << "Cannot import " << blob_file_name << ": " << ex.what();
+    }
+  }
+
+  auto exe_network = ie.LoadNetwork(*openvino_network_, device_id_, config);
+  try {
+    std::string temp_file_name = blob_file_name + TempFileSuffix();
+    exe_network.Export(temp_file_name);
+    if (std::rename(temp_file_name.c_str(), blob_file_name.c_str()) != 0) {
+      std::remove(temp_file_name.c_str());
+    }
+  } catch (const std::exception& ex) {
+    LOGS_DEFAULT(WARNING) << log_tag << "Cannot export the compiled network to " << blob_file_name << ": " << ex.what();
+  }
+  return exe_network;
+}
+
 std::shared_ptr<InferenceEngine::CNNNetwork> OpenVINOGraph::BuildOpenVINONetworkWithMO() {
   const auto& attributes = fused_node_->GetAttributes();
   std::string xml_string = attributes.at("xml_str").s();
@@ -404,14 +526,11 @@ std::vector<OrtValue*> OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, Ort
   auto graph_output_info = openvino_network_->getOutputsInfo();
 
   // All infer_requests process identical tensor slices from the batch.
-  // So using info from first infer_request to allocate all output tensors.
-  auto infer_request = infer_requests_[0];
-
+  // So using the dims of the network outputs to allocate all output tensors.
   size_t i = 0;
   for (auto output_info_iter = graph_output_info.begin();
        output_info_iter != graph_output_info.end(); ++output_info_iter, ++i) {
-    auto graph_output_blob = infer_request->GetBlob(output_info_iter->first);
-    auto graph_output_dims = graph_output_blob->getTensorDesc().getDims();
+    auto graph_output_dims = output_info_iter->second->getTensorDesc().getDims();
 
     if (batch_size > 1) {
       // Add the batch size as dim 0.
@@ -430,11 +549,33 @@ std::vector<OrtValue*> OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, Ort
   return output_tensors;
 }
 
-void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
-  std::lock_guard<std::mutex> lock(compute_lock_);
+size_t OpenVINOGraph::AcquireInferRequest() {
+  std::unique_lock<std::mutex> lock(infer_requests_lock_);
+  infer_request_released_.wait(lock, [this] { return !free_infer_requests_.empty(); });
+  size_t infer_req_idx = free_infer_requests_.front();
+  free_infer_requests_.pop_front();
+  return infer_req_idx;
+}
 
+bool OpenVINOGraph::TryAcquireInferRequest(size_t& infer_req_idx) {
+  std::lock_guard<std::mutex> lock(infer_requests_lock_);
+  if (free_infer_requests_.empty()) {
+    return false;
+  }
+  infer_req_idx = free_infer_requests_.front();
+  free_infer_requests_.pop_front();
+  return true;
+}
+
+void OpenVINOGraph::ReleaseInferRequest(size_t infer_req_idx) {
+  {
+    std::lock_guard<std::mutex> lock(infer_requests_lock_);
+    free_infer_requests_.push_back(infer_req_idx);
+  }
+  infer_request_released_.notify_one();
+}
+
+void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   LOGS_DEFAULT(INFO) << log_tag << "Starting inference";
 
   auto input_tensors = GetInputTensors(ort, context);
@@ -443,34 +584,43 @@ void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   auto batch_size = DeduceBatchSize(ort, input_tensors[0],
                                     openvino_network_->getInputsInfo().begin()->second->getTensorDesc().getDims());
 
-  size_t full_parallel_runs = batch_size / num_inf_reqs_;
-  size_t remainder_parallel_runs = batch_size % num_inf_reqs_;
-
   auto output_tensors = GetOutputTensors(ort, context, batch_size);
 
-  // Distribute the batched inputs among available Infer Requests
-  // for parallel inference.
-
-  // Run parallel inferences as sets of num_inf_reqs_
-  for (size_t set = 0; set < full_parallel_runs; set++) {
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
+  // Distribute the batched inputs among the free Infer Requests for parallel inference.
+  // Once there is no free Infer Request, the oldest slice started by this call is completed and its
+  // Infer Request starts the next slice, so the device is kept busy while the results are copied.
+  // A call waits for an Infer Request of the concurrent calls only when it has none in flight.
+  std::deque<std::pair<size_t, size_t>> in_flight;  // batch slice index, infer request index
+  try {
+    for (size_t batch_slice_idx = 0; batch_slice_idx < batch_size; batch_slice_idx++) {
+      size_t inf_req_idx;
+      if (!TryAcquireInferRequest(inf_req_idx)) {
+        if (in_flight.empty()) {
+          inf_req_idx = AcquireInferRequest();
+        } else {
+          CompleteAsyncInference(ort, output_tensors, in_flight.front().first, in_flight.front().second);
+          inf_req_idx = in_flight.front().second;
+          in_flight.pop_front();
+        }
+      }
+      in_flight.emplace_back(batch_slice_idx, inf_req_idx);
       StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
     }
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
-    }
-  }
 
-  // Run parallel inferences for remaining batch slices
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
-  }
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
+    while (!in_flight.empty()) {
+      CompleteAsyncInference(ort, output_tensors, in_flight.front().first, in_flight.front().second);
+      ReleaseInferRequest(in_flight.front().second);
+      in_flight.pop_front();
+    }
+  } catch (...) {
+    for (const auto& slice : in_flight) {
+      try {
+        infer_requests_[slice.second]->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+      } catch (...) {
+      }
+      ReleaseInferRequest(slice.second);
+    }
+    throw;
   }
 
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include <inference_engine.hpp>
 #include <ie_utils.hpp>
@@ -24,6 +27,8 @@ class OpenVINOGraph {
 
   void Infer(Ort::CustomOpApi ort, OrtKernelContext* context);
 
+  // Converts with the Model Optimizer, or reads the IR of an earlier conversion from the cache directory
+  // set by ORT_OPENVINO_CACHE_PATH.
   static void ConvertONNXModelToOpenVINOIR(const std::string& onnx_model, std::string& openvino_xml, std::string& openvino_bin, bool precision_fp32);
 
   static const std::string log_tag;
@@ -49,12 +54,24 @@ class OpenVINOGraph {
 
   std::vector<std::string> GetEnvLdLibraryPath() const;
 
+  // Loads the network to the device, or imports the network compiled by an earlier load from the cache directory
+  InferenceEngine::ExecutableNetwork LoadNetwork(const std::map<std::string, std::string>& config);
+
+  // Infer Requests are shared by the concurrent Infer calls. AcquireInferRequest waits for a free one.
+  size_t AcquireInferRequest();
+  bool TryAcquireInferRequest(size_t& infer_req_idx);
+  void ReleaseInferRequest(size_t infer_req_idx);
+
+  static std::string GetCachePath();
+
   const onnxruntime::Node* fused_node_;
   std::shared_ptr<InferenceEngine::CNNNetwork> openvino_network_;
   size_t num_inf_reqs_;
   std::vector<InferenceEngine::InferRequest::Ptr> infer_requests_;
   std::string device_id_;
-  mutable std::mutex compute_lock_;
+  std::mutex infer_requests_lock_;
+  std::condition_variable infer_request_released_;
+  std::deque<size_t> free_infer_requests_;
   std::vector<int> input_indexes_;
   InferenceEngine::Precision precision_;
   const onnxruntime::Graph* onnx_graph_;
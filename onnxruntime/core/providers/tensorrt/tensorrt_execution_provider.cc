@@ -20,6 +20,9 @@
 #include "gsl/gsl"
 #include "core/graph/model.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::logging;
@@ -80,6 +83,122 @@ TensorrtLogger& GetTensorrtLogger() {
   return trt_logger;
 }
 
+namespace {
+
+// Parses shapes given as "input_1:1x3x224x224,input_2:1x10".
+Status ParseProfileShapes(const std::string& shapes_string,
+                          std::unordered_map<std::string, std::vector<int64_t>>& shapes) {
+  std::istringstream shapes_stream(shapes_string);
+  std::string entry;
+  while (std::getline(shapes_stream, entry, ',')) {
+    auto separator = entry.rfind(':');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == entry.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid TensorRT profile shape: ", entry);
+    }
+
+    std::vector<int64_t> dims;
+    std::istringstream dims_stream(entry.substr(separator + 1));
+    std::string dim;
+    while (std::getline(dims_stream, dim, 'x')) {
+      dims.push_back(std::stoll(dim));
+    }
+    shapes[entry.substr(0, separator)] = dims;
+  }
+  return Status::OK();
+}
+
+// Reads the int8 dynamic ranges from a TensorRT calibration table. Each line after the header is
+// "tensor_name: <scale as the hex representation of a float>", and the dynamic range is 127 times the scale.
+Status ReadDynamicRanges(const std::string& file_name, std::unordered_map<std::string, float>& dynamic_ranges) {
+  std::ifstream file(file_name);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to open the TensorRT calibration table ", file_name);
+  }
+
+  std::string line;
+  std::getline(file, line);  // calibrator name and version
+  while (std::getline(file, line)) {
+    auto separator = line.rfind(':');
+    if (separator == std::string::npos) {
+      continue;
+    }
+    uint32_t bits = static_cast<uint32_t>(std::stoul(line.substr(separator + 1), nullptr, 16));
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    dynamic_ranges[line.substr(0, separator)] = scale * 127.0f;
+  }
+  return Status::OK();
+}
+
+void SetDynamicRanges(nvinfer1::INetworkDefinition& network, const std::unordered_map<std::string, float>& dynamic_ranges) {
+  auto set_range = [&dynamic_ranges](nvinfer1::ITensor* tensor) {
+    auto it = dynamic_ranges.find(tensor->getName());
+    if (it != dynamic_ranges.end()) {
+      tensor->setDynamicRange(-it->second, it->second);
+    }
+  };
+
+  for (int i = 0, end = network.getNbInputs(); i < end; ++i) {
+    set_range(network.getInput(i));
+  }
+  for (int i = 0, end = network.getNbLayers(); i < end; ++i) {
+    auto* layer = network.getLayer(i);
+    for (int j = 0, num_outputs = layer->getNbOutputs(); j < num_outputs; ++j) {
+      set_range(layer->getOutput(j));
+    }
+  }
+}
+
+void ConfigureBuilder(const TensorrtBuildSettings& settings, nvinfer1::IBuilder& builder, nvinfer1::IBuilderConfig& config) {
+  config.setMaxWorkspaceSize(settings.max_workspace_size);
+  if (settings.fp16_enable && builder.platformHasFastFp16()) {
+    config.setFlag(nvinfer1::BuilderFlag::kFP16);
+  }
+  if (settings.int8_enable && builder.platformHasFastInt8()) {
+    config.setFlag(nvinfer1::BuilderFlag::kINT8);
+  }
+}
+
+void AppendDims(std::string& key, const nvinfer1::Dims& dims) {
+  for (int i = 0; i < dims.nbDims; ++i) {
+    key += (i == 0 ? ":" : "x") + std::to_string(dims.d[i]);
+  }
+}
+
+// Loads the engine built for the profile from the engine cache. Returns nullptr if the engine is not cached.
+nvinfer1::ICudaEngine* LoadEngine(const TensorrtBuildSettings& settings, nvinfer1::IRuntime& runtime,
+                                  const std::string& profile_key) {
+  if (settings.engine_cache_prefix.empty()) {
+    return nullptr;
+  }
+
+  std::ifstream file(settings.engine_cache_prefix + "_" + std::to_string(std::hash<std::string>()(profile_key)) + ".engine",
+                     std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  std::string engine_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return runtime.deserializeCudaEngine(engine_data.data(), engine_data.size(), nullptr);
+}
+
+void SaveEngine(const TensorrtBuildSettings& settings, nvinfer1::ICudaEngine& engine, const std::string& profile_key) {
+  if (settings.engine_cache_prefix.empty()) {
+    return;
+  }
+
+  const std::string file_name =
+      settings.engine_cache_prefix + "_" + std::to_string(std::hash<std::string>()(profile_key)) + ".engine";
+  nvinfer1::IHostMemory* serialized_engine = engine.serialize();
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  file.write(static_cast<const char*>(serialized_engine->data()), serialized_engine->size());
+  serialized_engine->destroy();
+  if (!file) {
+    LOGS_DEFAULT(WARNING) << "Failed to write the TensorRT engine cache file " << file_name;
+  }
+}
+
+}  // namespace
+
 TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProviderInfo& info)
     : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
@@ -104,6 +223,49 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
   const char* workspace_env = getenv("ORT_TENSORRT_MAX_WORKSPACE_SIZE");
   if (workspace_env)
     max_workspace_size_ = atoi(workspace_env);
+
+  fp16_enable_ = info.fp16_enable;
+  const char* fp16_enable_env = getenv("ORT_TENSORRT_FP16_ENABLE");
+  if (fp16_enable_env)
+    fp16_enable_ = (atoi(fp16_enable_env) != 0);
+
+  int8_enable_ = info.int8_enable;
+  const char* int8_enable_env = getenv("ORT_TENSORRT_INT8_ENABLE");
+  if (int8_enable_env)
+    int8_enable_ = (atoi(int8_enable_env) != 0);
+
+  std::string calibration_table_name = info.int8_calibration_table_name;
+  const char* calibration_table_env = getenv("ORT_TENSORRT_INT8_CALIBRATION_TABLE_NAME");
+  if (calibration_table_env)
+    calibration_table_name = calibration_table_env;
+
+  if (int8_enable_) {
+    ORT_ENFORCE(!calibration_table_name.empty(), "TensorRT int8 mode requires a calibration table");
+    ORT_THROW_IF_ERROR(ReadDynamicRanges(calibration_table_name, dynamic_ranges_));
+  }
+
+  engine_cache_path_ = info.engine_cache_path;
+  const char* engine_cache_env = getenv("ORT_TENSORRT_ENGINE_CACHE_PATH");
+  if (engine_cache_env)
+    engine_cache_path_ = engine_cache_env;
+
+  std::string profile_min_shapes = info.profile_min_shapes;
+  std::string profile_max_shapes = info.profile_max_shapes;
+  std::string profile_opt_shapes = info.profile_opt_shapes;
+  const char* profile_min_env = getenv("ORT_TENSORRT_PROFILE_MIN_SHAPES");
+  if (profile_min_env)
+    profile_min_shapes = profile_min_env;
+  const char* profile_max_env = getenv("ORT_TENSORRT_PROFILE_MAX_SHAPES");
+  if (profile_max_env)
+    profile_max_shapes = profile_max_env;
+  const char* profile_opt_env = getenv("ORT_TENSORRT_PROFILE_OPT_SHAPES");
+  if (profile_opt_env)
+    profile_opt_shapes = profile_opt_env;
+  ORT_THROW_IF_ERROR(ParseProfileShapes(profile_min_shapes, profile_min_shapes_));
+  ORT_THROW_IF_ERROR(ParseProfileShapes(profile_max_shapes, profile_max_shapes_));
+  ORT_THROW_IF_ERROR(ParseProfileShapes(profile_opt_shapes, profile_opt_shapes_));
+
+  runtime_ = unique_pointer<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTensorrtLogger()));
 }
 
 TensorrtExecutionProvider::~TensorrtExecutionProvider() {}
@@ -517,10 +679,42 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     auto trt_config = unique_pointer<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
     auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
     trt_parser->parse(string_buf.data(), string_buf.size());
-    trt_config->setMaxWorkspaceSize(max_workspace_size_);
+    if (int8_enable_) {
+      SetDynamicRanges(*trt_network, dynamic_ranges_);
+    }
+
+    TensorrtBuildSettings build_settings{max_workspace_size_, fp16_enable_, int8_enable_, dynamic_ranges_, ""};
+    if (!engine_cache_path_.empty()) {
+      // the cached engines are only valid for the same subgraph, GPU, TensorRT version and precision.
+      cudaDeviceProp prop;
+      CUDA_RETURN_IF_ERROR(cudaGetDeviceProperties(&prop, device_id_));
+      build_settings.engine_cache_prefix = engine_cache_path_ + "/" + std::to_string(std::hash<std::string>()(string_buf)) +
+                                           "_sm" + std::to_string(prop.major) + std::to_string(prop.minor) +
+                                           "_trt" + std::to_string(NV_TENSORRT_VERSION) +
+                                           (fp16_enable_ ? "_fp16" : "") + (int8_enable_ ? "_int8" : "");
+    }
+    ConfigureBuilder(build_settings, *trt_builder, *trt_config);
+
+    // Returns the configured optimization profile of a dynamic shape input. The opt shape defaults to the max shape.
+    auto get_profile_shapes = [this](const std::string& name, int nb_dims, std::vector<int64_t>& min_shape,
+                                     std::vector<int64_t>& opt_shape, std::vector<int64_t>& max_shape) {
+      auto min_it = profile_min_shapes_.find(name);
+      auto max_it = profile_max_shapes_.find(name);
+      if (min_it == profile_min_shapes_.end() || max_it == profile_max_shapes_.end() ||
+          min_it->second.size() != static_cast<size_t>(nb_dims) || max_it->second.size() != static_cast<size_t>(nb_dims)) {
+        return false;
+      }
+      min_shape = min_it->second;
+      max_shape = max_it->second;
+      auto opt_it = profile_opt_shapes_.find(name);
+      opt_shape = (opt_it != profile_opt_shapes_.end() && opt_it->second.size() == max_shape.size()) ? opt_it->second
+                                                                                                     : max_shape;
+      return true;
+    };
 
     // Set optimization profile for dynamic shapes
     auto trt_profile = trt_builder->createOptimizationProfile();
+    std::string profile_key;
     for (unsigned int i = 0, end = trt_network->getNbInputs(); i < end; ++i) {
       auto input = trt_network->getInput(i);
       nvinfer1::Dims dims = input->getDimensions();
@@ -539,29 +733,41 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
         trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
         trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
+        profile_key += std::string(input->getName()) + ":shape;";
       } else {  // Execution tensor
+        std::vector<int64_t> min_shape, opt_shape, max_shape;
+        bool has_profile = get_profile_shapes(input->getName(), nb_dims, min_shape, opt_shape, max_shape);
         for (int j = 0, end = nb_dims; j < end; ++j) {
-          // For dynamic shape subgraph, a dummy engine is created at compile phase.
+          // For dynamic shape subgraph, a dummy engine is created at compile phase unless a profile was configured.
           // Real engine will be created at compute phase based on input data
           if (dims.d[j] == -1) {  // Dynamic shape
-            dims_min.d[j] = 1;
-            dims_opt.d[j] = 1;
-            dims_max.d[j] = 1;
+            dims_min.d[j] = has_profile ? static_cast<int>(min_shape[j]) : 1;
+            dims_opt.d[j] = has_profile ? static_cast<int>(opt_shape[j]) : 1;
+            dims_max.d[j] = has_profile ? static_cast<int>(max_shape[j]) : 1;
           }
         }
         // TRT6: Optimization profile need to be provided for all inputs if any of them has dynamic shape
         trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
         trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
         trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+        profile_key += input->getName();
+        AppendDims(profile_key, dims_min);
+        AppendDims(profile_key, dims_opt);
+        AppendDims(profile_key, dims_max);
+        profile_key += ";";
       }
     }
 
     trt_config->addOptimizationProfile(trt_profile);
 
-    auto trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildEngineWithConfig(*trt_network, *trt_config));
+    auto trt_engine = unique_pointer<nvinfer1::ICudaEngine>(LoadEngine(build_settings, *runtime_, profile_key));
     if (trt_engine == nullptr) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                             "TensorRT EP could not build Engine for fused node: " + fused_node->Name());
+      trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildEngineWithConfig(*trt_network, *trt_config));
+      if (trt_engine == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                               "TensorRT EP could not build Engine for fused node: " + fused_node->Name());
+      }
+      SaveEngine(build_settings, *trt_engine, profile_key);
     }
 
     // Build TensorRT context
@@ -588,9 +794,13 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
           input_shape_ranges[bindingIndex][j] = std::make_pair(INT_MAX, INT_MIN);
         }
       } else {
+        // the engine already covers the configured profile, so it is only rebuilt for shapes outside of it
+        std::vector<int64_t> min_shape, opt_shape, max_shape;
+        bool has_profile = get_profile_shapes(name, dimensions.nbDims, min_shape, opt_shape, max_shape);
         for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
           if (dimensions.d[j] == -1) {
-            input_shape_ranges[bindingIndex][j] = std::make_pair(INT_MAX, INT_MIN);
+            input_shape_ranges[bindingIndex][j] = has_profile ? std::make_pair(min_shape[j], max_shape[j])
+                                                              : std::pair<int64_t, int64_t>(INT_MAX, INT_MIN);
           }
         }
       }
@@ -632,6 +842,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     output_info_[fused_node->Name()].push_back(output_types);
     input_shape_ranges_[fused_node->Name()] = input_shape_ranges;
     output_shapes_[fused_node->Name()] = output_shapes;
+    build_settings_[fused_node->Name()] = build_settings;
 
     // Create function state
     // TODO: remove default capture
@@ -641,7 +852,8 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       *p = {context->allocate_func, context->release_func, context->allocator_handle, parsers_[context->node_name].get(),
             engines_[context->node_name].get(), contexts_[context->node_name].get(), builders_[context->node_name].get(),
             networks_[context->node_name].get(), input_info_[context->node_name], output_info_[context->node_name],
-            input_shape_ranges_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_};
+            input_shape_ranges_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_,
+            runtime_.get(), build_settings_[context->node_name]};
       *state = p.release();
       return 0;
     };
@@ -666,91 +878,90 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       int total_bindings = num_binding_inputs + num_binding_outputs;
       std::vector<void*> buffers(total_bindings);
 
-      //TODO: check shape tensor inputs by allInutShapesSpecified()
-      bool dynamic_shape = false;
-      auto trt_context = trt_state->context;
-      if (!trt_context->allInputDimensionsSpecified()) {
-        dynamic_shape = true;
-      }
-
       // Update shape ranges
       bool dimension_update = false;
-      auto trt_builder = trt_state->builder;
-      nvinfer1::IOptimizationProfile* trt_profile = nullptr;
+      auto& shape_ranges = trt_state->input_shape_ranges;
       for (int i = 0, end = num_binding_inputs; i < end; ++i) {
-        // TODO: check if getInput indexing is same with binding index
-        auto input = trt_state->network->getInput(i);
-        nvinfer1::Dims dims = input->getDimensions();
-        nvinfer1::Dims dims_min = dims;
-        nvinfer1::Dims dims_opt = dims;
-        nvinfer1::Dims dims_max = dims;
-
-        // Check and update shape ranges for dynamic shape inputs
-        auto& shape_ranges = trt_state->input_shape_ranges;
-        if (shape_ranges.find(i) != shape_ranges.end()) {
-          const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_indexes[i]);
-          auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-          const auto& tensor_shape = ort.GetTensorShape(tensor_info);
-          auto& engine = trt_context->getEngine();
-          nvinfer1::Dims dimensions = engine.getBindingDimensions(static_cast<int>(i));
-          int nb_dims = dimensions.nbDims;
-          for (int j = 0, end = nb_dims; j < end; ++j) {
-            auto& shape_range = shape_ranges[i];
-            if (shape_range.find(j) != shape_range.end()) {
-              // Update minimum dimension
-              if (tensor_shape[j] < shape_range[j].first) {
-                shape_range[j].first = tensor_shape[j];
-                dims_min.d[j] = tensor_shape[j];
-                dimension_update = true;
-              }
-              // Update maximum dimension
-              if (tensor_shape[j] > shape_range[j].second) {
-                shape_range[j].second = tensor_shape[j];
-                dims_max.d[j] = tensor_shape[j];
-                dims_opt.d[j] = tensor_shape[j];
-                dimension_update = true;
-              }
-            }
-          }
-
-          if (dimension_update) {
-            if (trt_profile == nullptr) {
-              trt_profile = trt_builder->createOptimizationProfile();
-            }
-            if (engine.isShapeBinding(i)) {
-              std::vector<int32_t> shapes_min(nb_dims), shapes_opt(nb_dims), shapes_max(nb_dims);
-              for (int j = 0, end = nb_dims; j < end; ++j) {
-                shapes_min[j] = dims_min.d[j];
-                shapes_opt[j] = dims_opt.d[j];
-                shapes_max[j] = dims_max.d[j];
-              }
-              trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
-              trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
-              trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
-            } else {
-              trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
-              trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
-              trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
-            }
-          }
+        auto range_it = shape_ranges.find(i);
+        if (range_it == shape_ranges.end()) {
+          continue;
         }
 
-        // TensorRT6 requires optimization profile to be defined for all inputs if any input dimension is symbolic
-        if (dimension_update && dynamic_shape) {
-          trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
-          trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
-          trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_indexes[i]);
+        auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        for (auto& dim_range : range_it->second) {
+          const int64_t dim = tensor_shape[dim_range.first];
+          if (dim < dim_range.second.first) {
+            dim_range.second.first = dim;
+            dimension_update = true;
+          }
+          if (dim > dim_range.second.second) {
+            dim_range.second.second = dim;
+            dimension_update = true;
+          }
         }
       }
 
-      // Regenerate engine and context
+      // Regenerate engine and context with a profile covering all the input shapes seen so far.
       // Only one profile is generated, so no need to explicitly set optimization profile
+      auto trt_context = trt_state->context;
       if (dimension_update) {
-        auto trt_config = unique_pointer<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
-        trt_config->addOptimizationProfile(trt_profile);
-        trt_state->engine = trt_builder->buildEngineWithConfig(*trt_state->network, *trt_config);
+        auto trt_builder = trt_state->builder;
+        auto trt_profile = trt_builder->createOptimizationProfile();
+        std::string profile_key;
+        // TensorRT6 requires optimization profile to be defined for all inputs if any input dimension is symbolic
+        for (int i = 0, end = num_binding_inputs; i < end; ++i) {
+          // TODO: check if getInput indexing is same with binding index
+          auto input = trt_state->network->getInput(i);
+          nvinfer1::Dims dims = input->getDimensions();
+          nvinfer1::Dims dims_min = dims;
+          nvinfer1::Dims dims_opt = dims;
+          nvinfer1::Dims dims_max = dims;
+          auto range_it = shape_ranges.find(i);
+          if (range_it != shape_ranges.end()) {
+            for (const auto& dim_range : range_it->second) {
+              dims_min.d[dim_range.first] = static_cast<int>(dim_range.second.first);
+              dims_opt.d[dim_range.first] = static_cast<int>(dim_range.second.second);
+              dims_max.d[dim_range.first] = static_cast<int>(dim_range.second.second);
+            }
+          }
+
+          int nb_dims = dims.nbDims;
+          if (input->isShapeTensor()) {
+            std::vector<int32_t> shapes_min(nb_dims), shapes_opt(nb_dims), shapes_max(nb_dims);
+            for (int j = 0, end = nb_dims; j < end; ++j) {
+              shapes_min[j] = dims_min.d[j];
+              shapes_opt[j] = dims_opt.d[j];
+              shapes_max[j] = dims_max.d[j];
+            }
+            trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMIN, &shapes_min[0], nb_dims);
+            trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kOPT, &shapes_opt[0], nb_dims);
+            trt_profile->setShapeValues(input->getName(), nvinfer1::OptProfileSelector::kMAX, &shapes_max[0], nb_dims);
+          } else {
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
+            trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+          }
+          profile_key += input->getName();
+          AppendDims(profile_key, dims_min);
+          AppendDims(profile_key, dims_opt);
+          AppendDims(profile_key, dims_max);
+          profile_key += ";";
+        }
+
+        const TensorrtBuildSettings& build_settings = trt_state->build_settings;
+        trt_state->engine = LoadEngine(build_settings, *trt_state->runtime, profile_key);
         if (trt_state->engine == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Build Engine.");
+          auto trt_config = unique_pointer<nvinfer1::IBuilderConfig>(trt_builder->createBuilderConfig());
+          ConfigureBuilder(build_settings, *trt_builder, *trt_config);
+          trt_config->addOptimizationProfile(trt_profile);
+          trt_state->engine = trt_builder->buildEngineWithConfig(*trt_state->network, *trt_config);
+          if (trt_state->engine == nullptr) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Build Engine.");
+          }
+          SaveEngine(build_settings, *trt_state->engine, profile_key);
         }
         trt_state->context = trt_state->engine->createExecutionContext();
         if (trt_state->context == nullptr) {
@@ -33,6 +33,29 @@ class TensorrtLogger : public nvinfer1::ILogger {
 // Information needed to construct trt execution providers.
 struct TensorrtExecutionProviderInfo {
   int device_id{0};
+  // build the engines with float16 or int8 kernels when the GPU has fast support for them.
+  bool fp16_enable{false};
+  bool int8_enable{false};
+  // TensorRT calibration table with the int8 scales of the network tensors, required by int8_enable.
+  std::string int8_calibration_table_name;
+  // directory the built engines are serialized to and loaded from. empty disables the engine cache.
+  std::string engine_cache_path;
+  // optimization profile of the inputs with dynamic shapes, as "input_1:1x3x224x224,input_2:1x10".
+  // the first engine covers these shapes so that it is only rebuilt for inputs outside of them.
+  std::string profile_min_shapes;
+  std::string profile_max_shapes;
+  std::string profile_opt_shapes;
+};
+
+// Settings for building the engines of a fused node.
+struct TensorrtBuildSettings {
+  size_t max_workspace_size = 1 << 30;
+  bool fp16_enable = false;
+  bool int8_enable = false;
+  // int8 dynamic range of the network tensors from the calibration table
+  std::unordered_map<std::string, float> dynamic_ranges;
+  // engine cache files of the fused node start with this prefix. empty disables the engine cache.
+  std::string engine_cache_prefix;
 };
 
 // Information to construct kernel function state.
@@ -50,6 +73,8 @@ struct TensorrtFuncState {
   std::unordered_map<int, std::unordered_map<int, std::pair<int64_t, int64_t>>> input_shape_ranges;
   std::vector<std::vector<int64_t>> output_shapes;
   OrtMutex* tensorrt_mu_ptr = nullptr;
+  nvinfer1::IRuntime* runtime = nullptr;
+  TensorrtBuildSettings build_settings;
 };
 
 // Logical device representation.
@@ -76,6 +101,13 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   size_t max_workspace_size_ = 1 << 30;  // 1GB
   int max_partition_iterations_ = 1000;
   int min_subgraph_size_ = 1;
+  bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  std::string engine_cache_path_;
+  std::unordered_map<std::string, float> dynamic_ranges_;
+  std::unordered_map<std::string, std::vector<int64_t>> profile_min_shapes_;
+  std::unordered_map<std::string, std::vector<int64_t>> profile_max_shapes_;
+  std::unordered_map<std::string, std::vector<int64_t>> profile_opt_shapes_;
 
   struct InferDeleter {
     template <typename T>
@@ -91,6 +123,7 @@ class TensorrtExecutionProvider : public IExecutionProvider {
 
   OrtMutex tensorrt_mu_;
   int device_id_;
+  unique_pointer<nvinfer1::IRuntime> runtime_;
   std::unordered_map<std::string, unique_pointer<nvonnxparser::IParser>> parsers_;
   std::unordered_map<std::string, unique_pointer<nvinfer1::ICudaEngine>> engines_;
   std::unordered_map<std::string, unique_pointer<nvinfer1::IExecutionContext>> contexts_;
@@ -100,6 +133,7 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   std::unordered_map<std::string, std::vector<std::vector<int>>> output_info_;
   std::unordered_map<std::string, std::unordered_map<int, std::unordered_map<int, std::pair<int64_t, int64_t>>>> input_shape_ranges_;
   std::unordered_map<std::string, std::vector<std::vector<int64_t>>> output_shapes_;
+  std::unordered_map<std::string, TensorrtBuildSettings> build_settings_;
 
   /**Get IndexedSubGraph based on node list of the subgraph*/
   std::unique_ptr<IndexedSubGraph> GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index,
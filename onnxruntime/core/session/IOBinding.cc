@@ -5,6 +5,7 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 
 namespace onnxruntime {
@@ -77,11 +78,80 @@ common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml
   auto rc = Contains(output_names_, name);
   if (rc.first) {
     outputs_[rc.second] = ml_value;
+    output_pools_.erase(rc.second);
+    output_allocators_.erase(rc.second);
+    output_locations_[rc.second] = nullptr;
     return Status::OK();
   }
 
   output_names_.push_back(name);
   outputs_.push_back(ml_value);
+  output_locations_.push_back(nullptr);
+  return Status::OK();
+}
+
+common::Status IOBinding::BindOutput(const std::string& name, const OrtMemoryInfo& location) {
+  const NodeArg* output_arg = nullptr;
+  for (const auto* arg : session_state_.GetGraphViewer()->GetOutputs()) {
+    if (arg->Name() == name) {
+      output_arg = arg;
+      break;
+    }
+  }
+
+  if (output_arg == nullptr || output_arg->TypeAsProto() == nullptr ||
+      !utils::HasTensorType(*output_arg->TypeAsProto())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", name, " is not a tensor output of the model");
+  }
+
+  MLDataType element_type = DataTypeImpl::TypeFromProto(*output_arg->TypeAsProto())->AsTensorType()->GetElementType();
+  if (element_type == DataTypeImpl::GetType<std::string>()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", name, " of type string can't be bound to a device");
+  }
+
+  const auto* provider = session_state_.GetExecutionProviders().Get(location);
+  AllocatorPtr allocator = provider != nullptr ? provider->GetAllocator(location.id, location.mem_type) : nullptr;
+  if (allocator == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No allocator for ", location.ToString());
+  }
+
+  ORT_RETURN_IF_ERROR(BindOutput(name, OrtValue()));
+  const size_t index = Contains(output_names_, name).second;
+
+  auto& pool = output_pools_[index];
+  pool = OutputPool{allocator, element_type, nullptr, 0};
+  output_locations_[index] = &allocator->Info();
+  output_allocators_[index] = [this, index](const TensorShape& shape, const OrtMemoryInfo& alloc_info,
+                                            OrtValue& ort_value, bool& allocated) {
+    return AllocateFromPool(output_pools_.at(index), shape, alloc_info, ort_value, allocated);
+  };
+
+  return Status::OK();
+}
+
+common::Status IOBinding::AllocateFromPool(OutputPool& pool, const TensorShape& shape, const OrtMemoryInfo& location,
+                                           OrtValue& ort_value, bool& allocated) {
+  // let the execution frame allocate the output on the producing device. it is copied to the bound device.
+  if (location.device != pool.allocator->Info().device) {
+    allocated = false;
+    return Status::OK();
+  }
+
+  size_t bytes = 0;
+  if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), pool.element_type->Size(), &bytes)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Size overflow for output with shape ", shape);
+  }
+
+  if (bytes > pool.capacity) {
+    pool.buffer.reset();
+    pool.buffer = IAllocator::MakeUniquePtr<void>(pool.allocator, bytes);
+    pool.capacity = bytes;
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(pool.element_type, shape, pool.buffer.get(), pool.allocator->Info());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  allocated = true;
   return Status::OK();
 }
 
@@ -6,7 +6,9 @@
 #include <vector>
 #include <unordered_map>
 
+#include "core/framework/allocator.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/iexecutor.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ml_value.h"
@@ -57,12 +59,27 @@ class IOBinding {
     * Call InferenceSession::Run() only after calling this method or else you'll end up wasting cycles inside Run().
     */
   common::Status SynchronizeInputs();
+
+  /**
+    * Waits for the outputs to be ready. Run() returns once the work is queued on the device, so outputs bound to a
+    * device are only complete after this call. It does not need to follow Run() directly: calling it after the
+    * inputs of the next request are bound overlaps the wait with that work.
+    */
   common::Status SynchronizeOutputs();
   /**
     * This simply provides the names and optionally allocated output containers.
     */
   common::Status BindOutput(const std::string& name, const OrtValue& ml_value);
 
+  /**
+    * Binds the output to a device without preallocating it, for outputs whose shape depends on the inputs.
+    * The output is created on that device and is not copied to CPU. Its buffer comes from a pool owned by this
+    * binding that only grows when a Run needs a larger output, so repeated runs don't allocate device memory.
+    * The value returned by GetOutputs() aliases the pool and is overwritten by the next Run with this binding.
+    * If the node producing the output runs on another device, the output is copied to the bound device.
+    */
+  common::Status BindOutput(const std::string& name, const OrtMemoryInfo& location);
+
   /**
     * This simply collects the outputs obtained after calling Run() inside the @param outputs.
     */
@@ -89,6 +106,23 @@ class IOBinding {
   std::vector<std::string> output_names_;
   std::vector<OrtValue> outputs_;
 
+  struct OutputPool {
+    AllocatorPtr allocator;
+    MLDataType element_type;
+    IAllocatorUniquePtr<void> buffer;
+    size_t capacity;
+  };
+
+  // pools of the outputs bound to a device, keyed by index in output_names_
+  std::unordered_map<size_t, OutputPool> output_pools_;
+  // allocators for the fetches that are bound to a device. they allocate from output_pools_.
+  std::unordered_map<size_t, IExecutor::CustomAllocator> output_allocators_;
+  // device each output is returned on if it is bound to a device, nullptr otherwise
+  std::vector<const OrtMemoryInfo*> output_locations_;
+
+  static common::Status AllocateFromPool(OutputPool& pool, const TensorShape& shape, const OrtMemoryInfo& location,
+                                         OrtValue& ort_value, bool& allocated);
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 };
 }  // namespace onnxruntime
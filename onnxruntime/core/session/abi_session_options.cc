@@ -69,6 +69,13 @@ ORT_API_STATUS_IMPL(OrtApis::DisableProfiling, _In_ OrtSessionOptions* options)
   return nullptr;
 }
 
+// record one in every sampling_interval runs with the lightweight profiler. 0 disables it.
+ORT_API_STATUS_IMPL(OrtApis::SetLightweightProfilingSamplingInterval, _In_ OrtSessionOptions* options,
+                    uint32_t sampling_interval) {
+  options->value.lightweight_profiling_sampling_interval = sampling_interval;
+  return nullptr;
+}
+
 // enable the memory pattern optimization.
 // The idea is if the input shapes are the same, we could trace the internal memory allocation
 // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -82,6 +89,23 @@ ORT_API_STATUS_IMPL(OrtApis::DisableMemPattern, _In_ OrtSessionOptions* options)
   return nullptr;
 }
 
+// share constant CPU initializers with the other sessions created with the same env
+ORT_API_STATUS_IMPL(OrtApis::EnableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers_across_sessions = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.share_initializers_across_sessions = false;
+  return nullptr;
+}
+
+// use the global thread pools of the env instead of creating thread pools for the session
+ORT_API_STATUS_IMPL(OrtApis::DisablePerSessionThreads, _In_ OrtSessionOptions* options) {
+  options->value.use_per_session_threads = false;
+  return nullptr;
+}
+
 // enable the memory arena on CPU
 // Arena may pre-allocate memory for future usage.
 // set this option to false if you don't want it.
@@ -154,3 +178,61 @@ ORT_API_STATUS_IMPL(OrtApis::AddFreeDimensionOverride, _Inout_ OrtSessionOptions
   options->value.free_dimension_overrides.push_back(onnxruntime::FreeDimensionOverride{symbolic_dim, dim_override});
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionArenaIdleShrinkTime, _Inout_ OrtSessionOptions* options, int64_t idle_ms) {
+  if (idle_ms < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "idle_ms must not be negative");
+  }
+  options->value.arena_idle_shrink_ms = idle_ms;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionCpuArenaBackend, _Inout_ OrtSessionOptions* options,
+                    OrtArenaBackend backend) {
+  switch (backend) {
+    case ORT_ARENA_BACKEND_DEFAULT:
+    case ORT_ARENA_BACKEND_BFC:
+    case ORT_ARENA_BACKEND_MIMALLOC:
+      options->value.cpu_arena_backend = backend;
+      break;
+    default:
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "backend is not valid");
+  }
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionRunPriorityMaxThreads, _Inout_ OrtSessionOptions* options,
+                    OrtRunPriority priority, int max_threads) {
+  if (priority < ORT_RUN_PRIORITY_HIGH || priority > ORT_RUN_PRIORITY_LOW) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "priority is not valid");
+  }
+  if (max_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "max_threads can't be negative");
+  }
+  options->value.intra_op_max_threads_by_priority[priority] = max_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionCpuHugePageThreshold, _Inout_ OrtSessionOptions* options,
+                    size_t threshold_bytes) {
+  options->value.cpu_huge_page_threshold_bytes = threshold_bytes;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionDynamicBatching, _Inout_ OrtSessionOptions* options, int64_t max_batch_size,
+                    int64_t timeout_us) {
+  if (max_batch_size < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "max_batch_size can't be negative");
+  }
+  if (timeout_us < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "timeout_us can't be negative");
+  }
+  options->value.dynamic_batching_max_batch_size = max_batch_size;
+  options->value.dynamic_batching_timeout_us = timeout_us;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionDeferSubgraphInitializers, _Inout_ OrtSessionOptions* options, int defer) {
+  options->value.defer_subgraph_initializers = defer != 0;
+  return nullptr;
+}
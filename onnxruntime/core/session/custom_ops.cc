@@ -13,6 +13,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/tensor_type_and_shape.h"
+#include "core/platform/threadpool.h"
 
 ONNXTensorElementDataType MLDataTypeToOnnxRuntimeTensorElementDataType(const onnxruntime::DataTypeImpl* cpp_type);
 
@@ -51,6 +52,52 @@ ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetOutput, _Inout_ OrtKernelContext*
   return nullptr;
 };
 
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetThreadCount, _In_ const OrtKernelContext* context, _Out_ size_t* out) {
+  auto* thread_pool = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  *out = thread_pool != nullptr ? static_cast<size_t>(thread_pool->NumThreads()) + 1 : 1;
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_ParallelFor, _In_ const OrtKernelContext* context, _In_ OrtParallelForFunc fn,
+                    _In_opt_ void* user_data, size_t total, size_t num_batches) {
+  if (fn == nullptr)
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "fn is null");
+  if (total > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+      num_batches > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "total and num_batches must fit in int32_t");
+
+  auto* thread_pool = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  onnxruntime::concurrency::ThreadPool::TryBatchParallelFor(
+      thread_pool, static_cast<int32_t>(total),
+      [fn, user_data](int32_t index) { fn(user_data, static_cast<size_t>(index)); },
+      static_cast<int32_t>(num_batches));
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_AllocateScratch, _Inout_ OrtKernelContext* context, size_t size, _Outptr_ void** out) {
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetScratchAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  try {
+    *out = allocator->Alloc(size);
+  } catch (const std::exception& ex) {
+    return OrtApis::CreateStatus(ORT_FAIL, ex.what());
+  }
+  if (*out == nullptr && size != 0)
+    return OrtApis::CreateStatus(ORT_FAIL, "Failed to allocate the scratch buffer");
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_FreeScratch, _Inout_ OrtKernelContext* context, _In_ void* p) {
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetScratchAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  allocator->Free(p);
+  return nullptr;
+};
+
 ORT_API_STATUS_IMPL(OrtApis::KernelInfoGetAttribute_string, _In_ const OrtKernelInfo* info, _In_ const char* name, _Out_ char* out, _Inout_ size_t* size) {
   std::string value;
   auto status = reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->GetAttr<std::string>(name, &value);
@@ -68,11 +115,71 @@ ORT_API_STATUS_IMPL(OrtApis::KernelInfoGetAttribute_string, _In_ const OrtKernel
   return onnxruntime::ToOrtStatus(status);
 }
 
+OrtStatus* GetTensorShapeAndType(const onnxruntime::TensorShape& shape, const std::vector<std::string>* dim_params,
+                                 const ONNX_NAMESPACE::TypeProto& type_proto, OrtTensorTypeAndShapeInfo** out);
+
+ORT_API_STATUS_IMPL(OrtApis::ShapeInferContext_GetInputCount, _In_ const OrtShapeInferContext* context, _Out_ size_t* out) {
+  *out = reinterpret_cast<const ONNX_NAMESPACE::InferenceContext*>(context)->getNumInputs();
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::ShapeInferContext_GetInputTypeShape, _In_ const OrtShapeInferContext* context, size_t index,
+                    _Outptr_ OrtTensorTypeAndShapeInfo** out) {
+  *out = nullptr;
+  auto* infer_context = reinterpret_cast<ONNX_NAMESPACE::InferenceContext*>(const_cast<OrtShapeInferContext*>(context));
+  if (index >= infer_context->getNumInputs())
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input index is out of range");
+
+  const auto* type = infer_context->getInputType(index);
+  if (type == nullptr || !type->has_tensor_type() || !type->tensor_type().has_shape())
+    return nullptr;
+
+  std::vector<int64_t> dims;
+  std::vector<std::string> dim_params;
+  for (const auto& dim : type->tensor_type().shape().dim()) {
+    dims.push_back(dim.has_dim_value() ? dim.dim_value() : -1);
+    dim_params.push_back(dim.has_dim_param() ? dim.dim_param() : "");
+  }
+  return GetTensorShapeAndType(onnxruntime::TensorShape(dims), &dim_params, *type, out);
+};
+
+ORT_API_STATUS_IMPL(OrtApis::ShapeInferContext_SetOutputTypeShape, _Inout_ OrtShapeInferContext* context, size_t index,
+                    _In_ const OrtTensorTypeAndShapeInfo* info) {
+  auto* infer_context = reinterpret_cast<ONNX_NAMESPACE::InferenceContext*>(context);
+  if (index >= infer_context->getNumOutputs())
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output index is out of range");
+
+  // ONNXTensorElementDataType has the same values as TensorProto_DataType
+  auto* tensor_type = infer_context->getOutputType(index)->mutable_tensor_type();
+  tensor_type->set_elem_type(static_cast<int32_t>(info->type));
+  auto* shape = tensor_type->mutable_shape();
+  shape->clear_dim();
+  for (size_t i = 0; i < info->shape.NumDimensions(); ++i) {
+    auto* dim = shape->add_dim();
+    if (info->shape[i] >= 0) {
+      dim->set_dim_value(info->shape[i]);
+    } else if (i < info->dim_params.size() && !info->dim_params[i].empty()) {
+      dim->set_dim_param(info->dim_params[i]);
+    }
+  }
+  return nullptr;
+};
+
 namespace onnxruntime {
 
+// converts and releases the status returned by a custom op callback
+static Status ToStatus(OrtStatus* status) {
+  if (status == nullptr)
+    return Status::OK();
+  Status result(common::ONNXRUNTIME, static_cast<common::StatusCode>(OrtApis::GetErrorCode(status)),
+                OrtApis::GetErrorMessage(status));
+  OrtApis::ReleaseStatus(status);
+  return result;
+}
+
 struct CustomOpKernel : OpKernel {
   CustomOpKernel(const OpKernelInfo& info, OrtCustomOp& op) : OpKernel(info), op_(op) {
-    if (op_.version != 1)
+    if (op_.version < 1 || op_.version > ORT_API_VERSION)
       throw std::invalid_argument("Unsupported version '" + std::to_string(op_.version) + "' in custom op '" + op.GetName(&op));
     op_kernel_ = op_.CreateKernel(&op_, OrtGetApiBase()->GetApi(op_.version), reinterpret_cast<OrtKernelInfo*>(const_cast<OpKernelInfo*>(&info)));
   }
@@ -85,6 +192,19 @@ struct CustomOpKernel : OpKernel {
     return Status::OK();
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+    is_packed = false;
+    if (op_.version < 2 || op_.KernelPrePack == nullptr)
+      return Status::OK();
+
+    // the OrtValue doesn't own the initializer
+    OrtValue value(const_cast<Tensor*>(&tensor), DataTypeImpl::GetType<Tensor>(), [](void*) {});
+    int packed = 0;
+    ORT_RETURN_IF_ERROR(ToStatus(op_.KernelPrePack(op_kernel_, &value, static_cast<size_t>(input_idx), &packed)));
+    is_packed = packed != 0;
+    return Status::OK();
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CustomOpKernel);
 
@@ -123,6 +243,21 @@ common::Status CreateCustomRegistry(const std::vector<OrtCustomOpDomain*>& op_do
       schema.SetDomain(domain->domain_);
       schema.SinceVersion(1);
       schema.AllowUncheckedAttributes();
+      if (op->version >= 2 && op->InferOutputShapes != nullptr) {
+        OrtCustomOp* custom_op = op;
+        schema.TypeAndShapeInferenceFunction([custom_op](ONNX_NAMESPACE::InferenceContext& infer_context) {
+          for (size_t i = 0; i < infer_context.getNumOutputs(); i++) {
+            infer_context.getOutputType(i)->mutable_tensor_type()->set_elem_type(
+                static_cast<int32_t>(custom_op->GetOutputType(custom_op, i)));
+          }
+
+          auto status = ToStatus(custom_op->InferOutputShapes(
+              custom_op, reinterpret_cast<OrtShapeInferContext*>(&infer_context)));
+          if (!status.IsOK()) {
+            fail_shape_inference(status.ErrorMessage());
+          }
+        });
+      }
       schemas_list.push_back(schema);
 
       KernelDefBuilder def_builder;
@@ -134,6 +269,17 @@ common::Status CreateCustomRegistry(const std::vector<OrtCustomOpDomain*>& op_do
       else
         def_builder.Provider(onnxruntime::kCpuExecutionProvider);
 
+      if (op->version >= 2) {
+        for (size_t i = 0; i < output_count; i++) {
+          const int may_inplace_input = op->GetMayInplace != nullptr ? op->GetMayInplace(op, i) : -1;
+          if (may_inplace_input >= 0)
+            def_builder.MayInplace(may_inplace_input, static_cast<int>(i));
+          const int alias_input = op->GetAlias != nullptr ? op->GetAlias(op, i) : -1;
+          if (alias_input >= 0)
+            def_builder.Alias(alias_input, static_cast<int>(i));
+        }
+      }
+
       KernelCreateFn kernel_create_fn = [&op](const OpKernelInfo& info) -> OpKernel* { return new CustomOpKernel(info, *op); };
       KernelCreateInfo create_info(def_builder.Build(), kernel_create_fn);
 
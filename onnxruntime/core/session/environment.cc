@@ -3,6 +3,7 @@
 
 #include "core/session/environment.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 #include "onnx/defs/operator_sets.h"
@@ -18,6 +19,8 @@
 #endif
 
 #include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/util/thread_utils.h"
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
 #include "core/platform/tracing.h"
@@ -33,14 +36,33 @@ std::atomic<bool> Environment::is_initialized_{false};
 
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
-  auto status = environment->Initialize();
+  auto status = environment->Initialize(nullptr);
   return status;
 }
 
-Status Environment::Initialize() {
+Status Environment::Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& tp_options) {
+  environment = std::unique_ptr<Environment>(new Environment());
+  auto status = environment->Initialize(&tp_options);
+  return status;
+}
+
+Status Environment::Initialize(const ThreadingOptions* tp_options) {
   auto status = Status::OK();
 
   try {
+    if (tp_options != nullptr) {
+      // the sessions share these pools, so the number of threads doesn't grow with the number of sessions.
+      // ThreadPool queues the tasks of every caller on the same threads, and each caller also runs tasks of its
+      // own on the calling thread, so no session is left waiting for the threads while another one runs.
+      ORT_RETURN_IF_NOT(tp_options->intra_op_num_threads >= 0 && tp_options->inter_op_num_threads >= 0,
+                        "The number of threads of the global thread pools can't be negative.");
+      intra_op_thread_pool_ = concurrency::CreateThreadPool("global_intra_op_thread_pool",
+                                                            tp_options->intra_op_num_threads);
+      inter_op_thread_pool_ = concurrency::CreateThreadPool("global_inter_op_thread_pool",
+                                                            tp_options->inter_op_num_threads);
+      create_global_thread_pools_ = true;
+    }
+
     // Register Microsoft domain with min/max op_set version as 1/1.
     std::call_once(schemaRegistrationOnceFlag, []() {
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSDomain, 1, 1);
@@ -91,6 +113,8 @@ Internal copy node
 Internal copy node
 )DOC");
 
+    shared_initializer_store_ = std::make_shared<SharedInitializerStore>();
+
     // fire off startup telemetry (this call is idempotent)
     const Env& env = Env::Default();
     env.GetTelemetryProvider().LogProcessInfo();
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/idle_arena_trimmer.h"
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+IdleArenaTrimmer::IdleArenaTrimmer(std::function<common::Status()> shrink_fn, int64_t idle_ms)
+    : shrink_fn_(std::move(shrink_fn)), idle_time_(idle_ms) {
+  thread_ = std::thread(&IdleArenaTrimmer::ThreadMain, this);
+}
+
+IdleArenaTrimmer::~IdleArenaTrimmer() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void IdleArenaTrimmer::RunStarted(int num_runs) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  active_runs_ += num_runs;
+}
+
+void IdleArenaTrimmer::RunEnded(int num_runs) {
+  bool notify = false;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    active_runs_ -= num_runs;
+    shrink_pending_ = true;
+    last_run_end_ = std::chrono::steady_clock::now();
+    // a timed wait sees the new end time when it expires, only an untimed one needs waking up
+    notify = active_runs_ == 0 && waiting_for_run_;
+  }
+  if (notify) {
+    cv_.notify_all();
+  }
+}
+
+void IdleArenaTrimmer::ThreadMain() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (!stop_) {
+    if (!shrink_pending_ || active_runs_ > 0) {
+      waiting_for_run_ = true;
+      cv_.wait(lock);
+      waiting_for_run_ = false;
+      continue;
+    }
+
+    const auto deadline = last_run_end_ + idle_time_;
+    const auto now = std::chrono::steady_clock::now();
+    if (now < deadline) {
+      cv_.wait_for(lock, deadline - now);
+      continue;
+    }
+
+    shrink_pending_ = false;
+    lock.unlock();
+    auto status = shrink_fn_();
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Shrinking the memory arenas of an idle session failed: " << status.ErrorMessage();
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Shrinks the memory arenas of a session from a background thread once the session is idle, see
+ * SessionOptions::arena_idle_shrink_ms.
+ *
+ * The session reports the start and end of its runs. shrink_fn is called when no run was in progress for idle_ms
+ * since the last one ended, once per idle period. A run that starts while shrink_fn is running is not blocked.
+ */
+class IdleArenaTrimmer {
+ public:
+  IdleArenaTrimmer(std::function<common::Status()> shrink_fn, int64_t idle_ms);
+
+  // stops the thread. shrink_fn is not called after it returns.
+  ~IdleArenaTrimmer();
+
+  void RunStarted(int num_runs = 1);
+  void RunEnded(int num_runs = 1);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IdleArenaTrimmer);
+
+  void ThreadMain();
+
+  const std::function<common::Status()> shrink_fn_;
+  const std::chrono::milliseconds idle_time_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  // protected by mutex_
+  int active_runs_ = 0;
+  // a run ended since the last shrink
+  bool shrink_pending_ = false;
+  // the thread waits for a run to end, it doesn't time out
+  bool waiting_for_run_ = false;
+  bool stop_ = false;
+  std::chrono::steady_clock::time_point last_run_end_;
+
+  std::thread thread_;
+};
+
+}  // namespace onnxruntime
@@ -7,6 +7,7 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -15,13 +16,16 @@
 #include <thread>
 
 #include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 #include "core/platform/notification.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/customregistry.h"
 #include "core/session/environment.h"
 #include "core/framework/error_code_helper.h"
@@ -37,13 +41,17 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/utils.h"
+#include "core/optimizer/activation_offload.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/optimizer/zipmap_output_transformer.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
@@ -95,6 +103,71 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// metadata written to a model saved through SessionOptions::optimized_model_filepath
+constexpr const char* kOptimizationLevelMetadataKey = "onnxruntime.graph_optimization_level";
+constexpr const char* kExecutionProvidersMetadataKey = "onnxruntime.execution_providers";
+
+std::string JoinProviderIds(const std::vector<std::string>& ids) {
+  std::string joined;
+  for (const auto& id : ids) {
+    if (!joined.empty()) joined += ',';
+    joined += id;
+  }
+  return joined;
+}
+
+// get the optimization level a model saved through optimized_model_filepath was optimized to with the
+// given execution providers. returns Default if the model wasn't saved that way or used other providers.
+TransformerLevel GetSavedOptimizationLevel(const Model& model, const std::vector<std::string>& provider_ids) {
+  const auto& metadata = model.MetaData();
+  auto level_entry = metadata.find(kOptimizationLevelMetadataKey);
+  auto providers_entry = metadata.find(kExecutionProvidersMetadataKey);
+  if (level_entry == metadata.end() || providers_entry == metadata.end() ||
+      providers_entry->second != JoinProviderIds(provider_ids)) {
+    return TransformerLevel::Default;
+  }
+
+  int level = 0;
+  try {
+    level = std::stoi(level_entry->second);
+  } catch (const std::exception&) {
+    return TransformerLevel::Default;
+  }
+
+  if (level <= static_cast<int>(TransformerLevel::Default) || level > static_cast<int>(TransformerLevel::MaxLevel)) {
+    return TransformerLevel::Default;
+  }
+
+  return static_cast<TransformerLevel>(level);
+}
+
+// remove the nodes that don't contribute to any graph output. the initializers only used by the removed nodes are
+// released when the graph is resolved.
+void RemoveNodesNotContributingToOutputs(Graph& graph, const logging::Logger& logger) {
+  const auto& graph_outputs = graph.GetOutputs();
+  const std::unordered_set<const NodeArg*> outputs(graph_outputs.cbegin(), graph_outputs.cend());
+
+  // visit in reverse topological order so the consumers of a node are removed before it is checked
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto it = order.crbegin(), end = order.crend(); it != end; ++it) {
+    Node* node = graph.GetNode(*it);
+    // Graph::RemoveNode can't remove control edges
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || !node->ControlInputs().empty()) {
+      continue;
+    }
+
+    const auto& output_defs = node->OutputDefs();
+    if (std::any_of(output_defs.cbegin(), output_defs.cend(),
+                    [&outputs](const NodeArg* output_def) { return outputs.count(output_def) != 0; })) {
+      continue;
+    }
+
+    LOGS(logger, INFO) << "Removing node '" << node->Name() << "' as it doesn't contribute to any graph output.";
+    graph.RemoveNode(node->Index());
+  }
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -162,6 +235,37 @@ static Status FinalizeSessionOptions(const SessionOptions& user_provided_session
   return Status::OK();
 }
 
+// The processors of a thread affinity have to exist and be distinct, and the pool can't have more threads than the
+// processors they are restricted to.
+static Status ValidateThreadAffinity(const char* pool_name, const std::vector<int>& affinity, int num_threads) {
+  if (affinity.empty()) {
+    return Status::OK();
+  }
+
+  // 0 if the number of processors can't be determined
+  const int num_processors = static_cast<int>(std::thread::hardware_concurrency());
+  std::vector<int> processors(affinity);
+  std::sort(processors.begin(), processors.end());
+  for (size_t i = 0; i < processors.size(); ++i) {
+    const int processor = processors[i];
+    if (processor < 0 || (num_processors > 0 && processor >= num_processors)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The ", pool_name, " thread affinity names processor ",
+                             processor, " but the processor ids are in [0, ", num_processors, ").");
+    }
+    if (i > 0 && processors[i - 1] == processor) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The ", pool_name, " thread affinity names processor ",
+                             processor, " more than once.");
+    }
+  }
+
+  if (num_threads > static_cast<int>(affinity.size())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The ", pool_name, " thread pool has ", num_threads,
+                           " threads but its affinity only ", affinity.size(), " processors.");
+  }
+
+  return Status::OK();
+}
+
 void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                                          logging::LoggingManager* logging_manager) {
   ORT_ENFORCE(Environment::IsInitialized(),
@@ -175,13 +279,38 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       session_options_.max_num_graph_transformation_steps);
   logging_manager_ = logging_manager;
 
-  thread_pool_ = concurrency::CreateThreadPool("intra_op_thread_pool",
-                                               session_options_.intra_op_num_threads);
+  std::vector<int> intra_op_affinity = session_options_.intra_op_thread_affinity;
+  std::vector<int> inter_op_affinity = session_options_.inter_op_thread_affinity;
+  if (session_options_.numa_node >= 0) {
+    std::vector<int> numa_node_cpus;
+    status = Env::Default().GetNumaNodeCpus(session_options_.numa_node, numa_node_cpus);
+    ORT_ENFORCE(status.IsOK(), "Could not get the processors of NUMA node ", session_options_.numa_node,
+                ". Error Message: ", status.ErrorMessage());
+    if (intra_op_affinity.empty()) intra_op_affinity = numa_node_cpus;
+    if (inter_op_affinity.empty()) inter_op_affinity = numa_node_cpus;
+  }
 
-  inter_op_thread_pool_ = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
-                              ? concurrency::CreateThreadPool("inter_op_thread_pool",
-                                                              session_options_.inter_op_num_threads)
-                              : nullptr;
+  // the thread pools of the environment are set by UseGlobalThreadPools before the session is initialized
+  if (session_options_.use_per_session_threads) {
+    status = ValidateThreadAffinity("intra op", intra_op_affinity, session_options_.intra_op_num_threads);
+    if (status.IsOK() && session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+      status = ValidateThreadAffinity("inter op", inter_op_affinity, session_options_.inter_op_num_threads);
+    }
+    ORT_ENFORCE(status.IsOK(), "Invalid thread affinity in the session options. Error Message: ",
+                status.ErrorMessage());
+
+    thread_pool_ = concurrency::CreateThreadPool("intra_op_thread_pool",
+                                                 session_options_.intra_op_num_threads,
+                                                 session_options_.intra_op_allow_spinning,
+                                                 session_options_.intra_op_spin_duration_us,
+                                                 intra_op_affinity);
+
+    inter_op_thread_pool_ = session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
+                                ? concurrency::CreateThreadPool("inter_op_thread_pool",
+                                                                session_options_.inter_op_num_threads,
+                                                                true, 0, inter_op_affinity)
+                                : nullptr;
+  }
 
   session_state_ = onnxruntime::make_unique<SessionState>(execution_providers_,
                                                           session_options_.enable_mem_pattern &&
@@ -189,6 +318,10 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                                                           thread_pool_.get(),
                                                           inter_op_thread_pool_.get());
 
+  session_state_->SetMemoryPatternCacheOptions(session_options_.mem_pattern_shape_bucketing,
+                                               session_options_.mem_pattern_cache_capacity);
+  session_state_->SetEnableScratchAllocator(session_options_.enable_scratch_allocator);
+
   InitLogger(logging_manager);
 
   session_state_->SetDataTransferMgr(&data_transfer_mgr_);
@@ -266,6 +399,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
 }
 
 InferenceSession::~InferenceSession() {
+  idle_arena_trimmer_.reset();
+  runtime_profile_recorder_.reset();
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -351,6 +487,51 @@ common::Status InferenceSession::RegisterCustomRegistry(std::shared_ptr<CustomRe
   return Status::OK();
 }
 
+common::Status InferenceSession::SetSharedInitializerStore(std::shared_ptr<SharedInitializerStore> store) {
+  if (store == nullptr) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for shared initializer store");
+  }
+
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  if (is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL,
+                  "The shared initializer store must be set before the session is initialized");
+  }
+
+  shared_initializer_store_ = std::move(store);
+  return Status::OK();
+}
+
+common::Status InferenceSession::UseGlobalThreadPools(const Environment& env) {
+  if (session_options_.use_per_session_threads) {
+    return Status(common::ONNXRUNTIME, common::FAIL,
+                  "The global thread pools can only be used if per session threads are disabled");
+  }
+
+  if (!env.CreatedGlobalThreadPools()) {
+    return Status(common::ONNXRUNTIME, common::FAIL,
+                  "Per session threads are disabled but the environment was created without global thread pools");
+  }
+
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  if (is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL,
+                  "The global thread pools must be set before the session is initialized");
+  }
+
+  // like a per session thread pool, the inter op thread pool is only used by the parallel executor
+  session_state_->SetThreadPools(env.GetIntraOpThreadPool(),
+                                 session_options_.execution_mode == ExecutionMode::ORT_PARALLEL
+                                     ? env.GetInterOpThreadPool()
+                                     : nullptr);
+  uses_global_thread_pools_ = true;
+  return Status::OK();
+}
+
+SharedInitializerStore* InferenceSession::GetSharedInitializerStore() const {
+  return session_options_.share_initializers_across_sessions ? shared_initializer_store_.get() : nullptr;
+}
+
 common::Status InferenceSession::Load(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                                       const std::string& event_name) {
   Status status = Status::OK();
@@ -402,11 +583,18 @@ common::Status InferenceSession::Load(const std::basic_string<T>& model_uri) {
   model_location_ = ToWideString(model_uri);
   auto loader = [this](std::shared_ptr<onnxruntime::Model>& model) {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_location_, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(model_location_, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
+    if (session_options_.use_mmap_model_load) {
+      return onnxruntime::Model::LoadFromMappedFile(model_location_, model,
+                                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr,
+                                                    *session_logger_);
+    }
+
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
                                     *session_logger_);
   };
@@ -451,7 +639,8 @@ common::Status InferenceSession::Load(const ModelProto& model_proto) {
 
   auto loader = [this, &model_proto](std::shared_ptr<onnxruntime::Model>& model) {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
@@ -472,7 +661,8 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
 
   auto loader = [this, &p_model_proto](std::shared_ptr<onnxruntime::Model>& model) {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(*p_model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*p_model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
@@ -492,22 +682,24 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
   }
 
   auto loader = [this, &model_istream](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    // parse into a ModelProto that the Model takes ownership of so the initializers aren't copied
+    auto model_proto = onnxruntime::make_unique<ModelProto>();
 
     google::protobuf::io::IstreamInputStream zero_copy_input(&model_istream);
-    const bool result = model_proto.ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+    const bool result = model_proto->ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_);
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_);
   };
 
   return Load(loader, "model_loading_istream");
@@ -521,22 +713,24 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
   }
 
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    // parse into a ModelProto that the Model takes ownership of so the initializers aren't copied
+    auto model_proto = onnxruntime::make_unique<ModelProto>();
 
-    const bool result = model_proto.ParseFromArray(model_data, model_data_len);
+    const bool result = model_proto->ParseFromArray(model_data, model_data_len);
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
 
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_);
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_);
   };
 
   return Load(loader, "model_loading_array");
@@ -551,13 +745,15 @@ common::Status InferenceSession::Load() {
 
   auto loader = [this](std::shared_ptr<onnxruntime::Model>& model) {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(*this->model_proto_, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*this->model_proto_, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; },
+                session_options_.pyop_dedicated_thread);
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return Model::Load(*this->model_proto_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                       *session_logger_);
+    // the session has no further use for the parsed proto, so the Model takes ownership of it instead of a copy
+    return Model::Load(std::move(this->model_proto_), model,
+                       HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_);
   };
 
   return Load(loader, "model_loading_from_saved_proto");
@@ -597,7 +793,7 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 #endif
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  GraphPartitioner partitioner(kernel_registry_manager, providers, session_options_.enable_cost_based_partitioning);
   ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr()));
 
   // apply transformers except default transformers
@@ -659,6 +855,13 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   MemcpyTransformer copy_transformer{provider_types, kernel_registry_manager};
   ORT_RETURN_IF_ERROR_SESSIONID_(copy_transformer.Apply(graph, modified, *session_logger_));
 
+  // Spill long-lived CUDA activations to host memory.
+  if (session_options_.activation_offload_min_bytes > 0 && providers.Get(kCudaExecutionProvider) != nullptr) {
+    ActivationOffloadTransformer offload_transformer{kernel_registry_manager,
+                                                     session_options_.activation_offload_min_bytes};
+    ORT_RETURN_IF_ERROR_SESSIONID_(offload_transformer.Apply(graph, modified, *session_logger_));
+  }
+
   return common::Status::OK();
 }
 
@@ -675,6 +878,9 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
                                                                            session_state.GetEnableMemoryPattern(),
                                                                            session_state.GetThreadPool(),
                                                                            session_state.GetInterOpThreadPool());
+      subgraph_session_state->SetMemoryPatternCacheOptions(session_state.GetMemoryPatternShapeBucketing(),
+                                                           session_state.GetMemoryPatternCacheCapacity());
+      subgraph_session_state->SetEnableScratchAllocator(session_state.GetEnableScratchAllocator());
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
       // Pass data transfer manager to subgraph.
@@ -722,11 +928,14 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
 
       // setup everything required to execute the subgraph and save it in subgraph_session_state
       SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
-                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_);
+                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_,
+                                          session_options_.use_mmap_model_load, GetSharedInitializerStore(),
+                                          session_options_.defer_subgraph_initializers);
 
       const auto implicit_inputs = node.ImplicitInputDefs();
       ORT_RETURN_IF_ERROR_SESSIONID_(initializer.CreatePlan(&node, &implicit_inputs,
-                                                            session_options_.execution_mode));
+                                                            session_options_.execution_mode,
+                                                            session_options_.enable_memory_efficient_order));
       // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
       //                                                   &*subgraph_info.session_state);
 
@@ -766,10 +975,26 @@ common::Status InferenceSession::Initialize() {
     TraceLoggingWriteStart(session_activity, "OrtInferenceSessionActivity");
     session_activity_started_ = true;
 #endif
+    if (!session_options_.use_per_session_threads && !uses_global_thread_pools_) {
+      return common::Status(common::ONNXRUNTIME, common::FAIL,
+                            "Per session threads are disabled but the session wasn't given the global thread pools "
+                            "of an environment.");
+    }
+    if (session_options_.enable_cpu_gemm_autotuning) {
+      MlasGemmEnableAutotuning(session_options_.cpu_gemm_autotuning_cache_path.empty()
+                                   ? nullptr
+                                   : session_options_.cpu_gemm_autotuning_cache_path.c_str());
+    }
+
     // Register default CPUExecutionProvider if user didn't provide it through the Register() calls
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.use_bf16_gemm = session_options_.enable_cpu_bf16_gemm;
+      epi.use_fp16_weights = session_options_.enable_cpu_fp16_weights;
+      epi.arena_thread_cache = session_options_.enable_cpu_mem_arena_thread_cache;
+      epi.arena_backend = static_cast<ArenaBackend>(session_options_.cpu_arena_backend);
+      epi.huge_page_threshold = session_options_.cpu_huge_page_threshold_bytes;
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -783,9 +1008,33 @@ common::Status InferenceSession::Initialize() {
                             "for the registered CUDA Execution Provider.");
     }
 
-    // add predefined transformers
-    AddPredefinedTransformers(*graph_transformation_mgr_, session_options_.graph_optimization_level,
-                              transformers_to_enable_);
+    // a model saved through optimized_model_filepath by a session with the same execution providers doesn't need
+    // the predefined optimizers again unless this session asks for a higher level
+    const TransformerLevel saved_optimization_level = GetSavedOptimizationLevel(*model_, execution_providers_.GetIds());
+    if (saved_optimization_level != TransformerLevel::Default &&
+        saved_optimization_level >= session_options_.graph_optimization_level &&
+        transformers_to_enable_.empty() && session_options_.free_dimension_overrides.empty()) {
+      LOGS(*session_logger_, INFO) << "Model was already optimized to level "
+                                   << static_cast<int>(saved_optimization_level)
+                                   << ". Skipping the predefined graph optimizers.";
+    } else {
+      // add predefined transformers
+      AddPredefinedTransformers(*graph_transformation_mgr_, session_options_.graph_optimization_level,
+                                transformers_to_enable_);
+    }
+
+    if (session_options_.enable_cuda_mixed_precision && execution_providers_.Get(kCudaExecutionProvider)) {
+      // registered after the predefined Level2 transformers so that the fused nodes are converted.
+      std::unordered_set<std::string> cuda_execution_providers = {kCudaExecutionProvider};
+      ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformation_mgr_->Register(
+          onnxruntime::make_unique<MixedPrecisionTransformer>(cuda_execution_providers), TransformerLevel::Level2));
+    }
+
+    if (session_options_.enable_zipmap_tensor_outputs) {
+      // this changes the output types, so it doesn't depend on the optimization level.
+      ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformation_mgr_->Register(
+          onnxruntime::make_unique<ZipMapOutputTransformer>(), TransformerLevel::Level1));
+    }
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
@@ -800,7 +1049,8 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
-                                                *session_state_, execution_providers_, kernel_registry_manager_);
+                                                *session_state_, execution_providers_, kernel_registry_manager_,
+                                                session_options_.use_mmap_model_load, GetSharedInitializerStore());
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, *session_state_));
@@ -811,10 +1061,23 @@ common::Status InferenceSession::Initialize() {
                                                   insert_cast_transformer_,
                                                   *session_state_));
 
+    if (session_options_.graph_optimization_level >= TransformerLevel::Level1) {
+      RemoveNodesNotContributingToOutputs(graph, *session_logger_);
+    }
+
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
     if (!session_options_.optimized_model_filepath.empty()) {
+      // record what the model was optimized for so reloading it can skip the optimizers.
+      // the model keeps the level of an earlier optimization if it was loaded from an optimized model.
+      const TransformerLevel optimized_level = std::max(session_options_.graph_optimization_level,
+                                                        saved_optimization_level);
+      if (optimized_level != TransformerLevel::Default) {
+        model_->SetMetaData(kOptimizationLevelMetadataKey, std::to_string(static_cast<int>(optimized_level)));
+        model_->SetMetaData(kExecutionProvidersMetadataKey, JoinProviderIds(execution_providers_.GetIds()));
+      }
+
       // Serialize optimized ONNX model.
       ORT_RETURN_IF_ERROR_SESSIONID_(Model::Save(*model_, session_options_.optimized_model_filepath));
       if (session_options_.graph_optimization_level >= TransformerLevel::Level3) {
@@ -826,10 +1089,33 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode));
+    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode,
+                                                                  session_options_.enable_memory_efficient_order));
+
+    if (session_options_.enable_static_shape_planning) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(session_state_->GenerateStaticMemoryPattern());
+    }
+
+    if (session_options_.lightweight_profiling_sampling_interval > 0) {
+      lightweight_profiler_ = onnxruntime::make_unique<profiling::LightweightProfiler>(
+          *session_state_->GetGraphViewer(), session_options_.lightweight_profiling_sampling_interval);
+      session_state_->SetLightweightProfiler(lightweight_profiler_.get());
+    }
+
+    // before the subgraphs, so they get the memory pattern options of a profile that is applied here
+    InitializeRuntimeProfile();
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(graph, *session_state_));
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateRequestBatcher());
+
+    InitializeGraphCapture();
+
+    if (session_options_.arena_idle_shrink_ms > 0) {
+      idle_arena_trimmer_ = onnxruntime::make_unique<IdleArenaTrimmer>([this]() { return ShrinkMemoryArenas(); },
+                                                                       session_options_.arena_idle_shrink_ms);
+    }
     is_inited_ = true;
 
     // and log telemetry
@@ -914,6 +1200,83 @@ static common::Status CheckTypes(MLDataType actual, MLDataType expected) {
                 "Unexpected input data type. Actual: (" + actual_name + ") , expected: (" + expected_name + ")");
 }
 
+common::Status InferenceSession::CreateRequestBatcher() {
+  if (session_options_.dynamic_batching_max_batch_size <= 1) {
+    return Status::OK();
+  }
+
+  // dim 0 of every input must be the batch dimension. it's accepted if it's annotated as DATA_BATCH, or if it's
+  // symbolic and not annotated as something else.
+  for (const auto* input : model_->MainGraph().GetInputs()) {
+    const auto* shape = input->Shape();
+    bool is_batch_dim = false;
+    if (shape != nullptr && shape->dim_size() > 0) {
+      const auto& dim = shape->dim(0);
+      if (dim.has_denotation()) {
+        is_batch_dim = dim.denotation() == "DATA_BATCH";
+      } else {
+        is_batch_dim = !dim.has_dim_value();
+      }
+    }
+
+    if (!is_batch_dim) {
+      LOGS(*session_logger_, WARNING) << "Dynamic batching is disabled as dim 0 of input '" << input->Name()
+                                      << "' is not a free batch dimension.";
+      return Status::OK();
+    }
+  }
+
+  auto cpu_allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  request_batcher_ = onnxruntime::make_unique<RequestBatcher>(
+      [this](const RunOptions& run_options, const std::vector<std::string>& feed_names,
+             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+             std::vector<OrtValue>& fetches) {
+        return RunImpl(run_options, feed_names, feeds, output_names, &fetches);
+      },
+      cpu_allocator, session_options_.dynamic_batching_max_batch_size, session_options_.dynamic_batching_timeout_us);
+
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with max batch size "
+                               << session_options_.dynamic_batching_max_batch_size << " and timeout "
+                               << session_options_.dynamic_batching_timeout_us << "us.";
+  return Status::OK();
+}
+
+void InferenceSession::InitializeRuntimeProfile() {
+  const auto& path = session_options_.runtime_profile_path;
+  if (!path.empty()) {
+    // a profile that can't be read is recorded again rather than failing the session
+    RuntimeProfile profile;
+    auto status = RuntimeProfile::Load(path, profile);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << status.ErrorMessage();
+    } else if (profile.num_runs > 0) {
+      ApplyRuntimeProfile(profile, *session_state_);
+      return;
+    }
+  }
+
+  if (session_options_.runtime_profile_runs == 0) {
+    return;
+  }
+
+  if (lightweight_profiler_ == nullptr) {
+    lightweight_profiler_ = onnxruntime::make_unique<profiling::LightweightProfiler>(*session_state_->GetGraphViewer(),
+                                                                                    1);
+    session_state_->SetLightweightProfiler(lightweight_profiler_.get());
+  }
+
+  runtime_profile_recorder_ = onnxruntime::make_unique<RuntimeProfileRecorder>(
+      *lightweight_profiler_, session_options_.runtime_profile_runs, [this](const RuntimeProfile& profile) {
+        ApplyRuntimeProfile(profile, *session_state_);
+        if (!session_options_.runtime_profile_path.empty()) {
+          auto status = profile.Save(session_options_.runtime_profile_path);
+          if (!status.IsOK()) {
+            LOGS(*session_logger_, WARNING) << status.ErrorMessage();
+          }
+        }
+      });
+}
+
 common::Status InferenceSession::ValidateInputs(const std::vector<std::string>& feed_names,
                                                 const std::vector<OrtValue>& feeds) const {
   if (feed_names.size() != feeds.size()) {
@@ -929,45 +1292,51 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor.");
-      }
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else if (input_ml_value.IsSparseTensor()) {
-      if (!expected_type->IsSparseTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type sparse tensor.");
-      }
-      auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<SparseTensor>().Values().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-      // TODO: In the future, when sparsetensors are in use, find out how to properly verify the shape
-    } else if (input_ml_value.IsTensorSequence()) {
-      if (!expected_type->IsTensorSequenceType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor sequence.");
-      }
-      auto expected_element_type = expected_type->AsSequenceTensorBase()->GetElementType();
-      auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(feed_name, iter->second, feeds[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                                               const OrtValue& input_ml_value) const {
+  auto expected_type = input_def.ml_data_type;
+  if (input_ml_value.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor.");
+    }
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    const auto& expected_shape = input_def.tensor_shape;
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
     }
+  } else if (input_ml_value.IsSparseTensor()) {
+    if (!expected_type->IsSparseTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type sparse tensor.");
+    }
+    auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<SparseTensor>().Values().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+    // TODO: In the future, when sparsetensors are in use, find out how to properly verify the shape
+  } else if (input_ml_value.IsTensorSequence()) {
+    if (!expected_type->IsTensorSequenceType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor sequence.");
+    }
+    auto expected_element_type = expected_type->AsSequenceTensorBase()->GetElementType();
+    auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type));
+  } else {
+    auto input_type = input_ml_value.Type();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type));
   }
 
   return Status::OK();
@@ -1004,6 +1373,104 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
 Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
                              const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                              std::vector<OrtValue>* p_fetches) {
+  // drop a request that expired while it was queued before it takes the threads of the requests behind it
+  if (run_options.deadline != DeadlineTimePoint::max() && std::chrono::steady_clock::now() > run_options.deadline) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the deadline of the run having passed.");
+  }
+
+  if (request_batcher_ == nullptr) {
+    return RunImpl(run_options, feed_names, feeds, output_names, p_fetches);
+  }
+
+  // validate before batching so a bad request doesn't fail the other requests in its batch
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+
+  return request_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                 const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                                 std::vector<OrtValue>* p_fetches,
+                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators,
+                                 const std::vector<const OrtMemoryInfo*>* fetch_locations) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+
+  FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+  FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+  ORT_RETURN_IF_ERROR_SESSIONID_(utils::InitializeFeedFetchCopyInfo(*session_state_, feeds_fetches_manager));
+
+  return ExecuteRun(run_options, feeds_fetches_manager, feeds, p_fetches, fetch_allocators, fetch_locations);
+}
+
+void InferenceSession::InitializeGraphCapture() {
+  // the work of a Run can only be recorded as a whole when one provider runs all of it in order
+  if (session_options_.execution_mode != ExecutionMode::ORT_SEQUENTIAL) {
+    return;
+  }
+  IExecutionProvider* provider = nullptr;
+  for (auto& xp : execution_providers_) {
+    if (xp->IsGraphCaptureEnabled()) {
+      provider = xp.get();
+      break;
+    }
+  }
+  if (provider == nullptr) {
+    return;
+  }
+  for (const auto& node : session_state_->GetGraphViewer()->Nodes()) {
+    if (node.GetExecutionProviderType() != provider->Type() || node.ContainsSubgraph()) {
+      LOGS(*session_logger_, WARNING) << "The Runs are not captured into graphs by " << provider->Type()
+                                      << " as it does not run the node " << node.Name() << " without a subgraph.";
+      return;
+    }
+  }
+  graph_capture_provider_ = provider;
+}
+
+std::string InferenceSession::GetGraphCaptureKey(const FeedsFetchesManager& feeds_fetches_manager,
+                                                 const std::vector<OrtValue>& feeds,
+                                                 const std::vector<OrtValue>& fetches) const {
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  if (fetches.size() != info.output_names.size()) {
+    return std::string();
+  }
+  std::ostringstream key;
+  auto add_to_key = [&key](const std::string& name, const OrtValue& value) {
+    if (!value.IsAllocated() || !value.IsTensor()) {
+      return false;
+    }
+    const Tensor& tensor = value.Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::GPU) {
+      return false;
+    }
+    key << name << '@' << tensor.DataRaw() << tensor.Shape() << ';';
+    return true;
+  };
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!add_to_key(info.feed_names[i], feeds[i])) {
+      return std::string();
+    }
+  }
+  key << "->";
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    if (!add_to_key(info.output_names[i], fetches[i])) {
+      return std::string();
+    }
+  }
+  return key.str();
+}
+
+Status InferenceSession::ExecuteRun(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                    const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches,
+                                    const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators,
+                                    const std::vector<const OrtMemoryInfo*>* fetch_locations) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
@@ -1017,22 +1484,14 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   Status retval = Status::OK();
 
   try {
-    if (!is_inited_) {
-      LOGS(*session_logger_, ERROR) << "Session was not initialized";
-      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
-    }
-
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
-
-    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
 
     ++current_num_runs_;
+    if (idle_arena_trimmer_) {
+      idle_arena_trimmer_->RunStarted();
+    }
 
     // TODO should we add this exec to the list of executors? i guess its not needed now?
 
@@ -1047,11 +1506,60 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
       ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
     }
 
+    // the parallel loops of the kernels run with the priority of the run
+    concurrency::ThreadPoolPriorityScope priority_scope(
+        static_cast<concurrency::ThreadPoolPriority>(run_options.priority),
+        session_options_.intra_op_max_threads_by_priority.at(run_options.priority));
+
     // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(
-        utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                            session_options_.execution_mode,
-                            run_options.terminate, run_logger));
+    int64_t peak_activation_bytes = 0;
+    auto execute_graph = [&]() -> Status {
+      if (fetch_allocators != nullptr) {
+        return utils::ExecuteGraphWithInitializedCopyInfo(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                                          *fetch_allocators, *fetch_locations,
+                                                          session_options_.execution_mode,
+                                                          run_options.terminate, run_options.deadline, run_logger,
+                                                          &peak_activation_bytes);
+      }
+      return utils::ExecuteGraphWithInitializedCopyInfo(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                                        session_options_.execution_mode,
+                                                        run_options.terminate, run_options.deadline, run_logger,
+                                                        &peak_activation_bytes);
+    };
+
+    // the device work of the Runs with the same bound inputs and outputs is recorded once and replayed
+    std::string graph_key;
+    if (graph_capture_provider_ != nullptr && retval.IsOK() && !session_profiler_.IsEnabled()) {
+      graph_key = GetGraphCaptureKey(feeds_fetches_manager, feeds, *p_fetches);
+    }
+    if (graph_key.empty()) {
+      ORT_CHECK_AND_SET_RETVAL(execute_graph());
+    } else if (graph_capture_provider_->IsGraphCaptured(graph_key)) {
+      ORT_CHECK_AND_SET_RETVAL(graph_capture_provider_->ReplayGraph(graph_key));
+    } else if (!graph_capture_provider_->BeginGraphCapture(graph_key)) {
+      ORT_CHECK_AND_SET_RETVAL(execute_graph());
+    } else {
+      // the capture is ended even if a kernel throws, e.g. as it made a call that is not allowed while capturing
+      Status run_status;
+      try {
+        run_status = execute_graph();
+      } catch (const std::exception& e) {
+        run_status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, e.what());
+      }
+      Status capture_status = graph_capture_provider_->EndGraphCapture(graph_key, run_status.IsOK());
+      if (capture_status.IsOK()) {
+        ORT_CHECK_AND_SET_RETVAL(run_status);
+      } else {
+        // nothing ran while capturing
+        LOGS(*session_logger_, WARNING) << capture_status.ErrorMessage() << ". Running the kernels instead.";
+        ORT_CHECK_AND_SET_RETVAL(execute_graph());
+      }
+    }
+    RecordPeakActivationBytes(peak_activation_bytes);
+
+    if (runtime_profile_recorder_ && retval.IsOK()) {
+      runtime_profile_recorder_->RecordRun(feeds_fetches_manager.GetFeedsFetchesInfo().feed_names, feeds);
+    }
 
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
@@ -1064,7 +1572,14 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
   }
 
+  if (run_options.shrink_memory_arenas) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+  }
+
   --current_num_runs_;
+  if (idle_arena_trimmer_) {
+    idle_arena_trimmer_->RunEnded();
+  }
 
   // keep track of telemetry
   ++total_runs_since_last_;
@@ -1091,6 +1606,178 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   return retval;
 }
 
+Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                    const std::vector<std::string>& output_names,
+                                    std::unique_ptr<PreparedRun>& prepared_run) const {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  std::vector<OrtValue> no_fetches;
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, &no_fetches));
+
+  std::unique_ptr<PreparedRun> result(new PreparedRun());
+  result->input_defs_.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+    result->input_defs_.push_back(&iter->second);
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(FeedsFetchesManager::Create(feed_names, output_names,
+                                                             session_state_->GetOrtValueNameIdxMap(),
+                                                             result->feeds_fetches_manager_));
+  ORT_RETURN_IF_ERROR_SESSIONID_(utils::InitializeFeedFetchCopyInfo(*session_state_,
+                                                                    *result->feeds_fetches_manager_));
+
+  result->feed_names_ = feed_names;
+  result->output_names_ = output_names;
+  prepared_run = std::move(result);
+  return Status::OK();
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) {
+  if (feeds.size() != prepared_run.feed_names_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: the run was prepared for ",
+                           prepared_run.feed_names_.size(), " feeds, but feeds has ", feeds.size(), " elements.");
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInput(prepared_run.feed_names_[i], *prepared_run.input_defs_[i], feeds[i]));
+  }
+
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  if (!p_fetches->empty() && p_fetches->size() != prepared_run.output_names_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector incorrectly sized: the run was prepared for ",
+                           prepared_run.output_names_.size(), " outputs, but p_fetches has ", p_fetches->size(),
+                           " elements.");
+  }
+
+  std::lock_guard<OrtMutex> lock(prepared_run.mutex_);
+  return ExecuteRun(run_options, *prepared_run.feeds_fetches_manager_, feeds, p_fetches, nullptr, nullptr);
+}
+
+Status InferenceSession::RunBatch(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                  const std::vector<std::vector<OrtValue>>& feeds_batch,
+                                  const std::vector<std::string>& output_names,
+                                  std::vector<std::vector<OrtValue>>& fetches_batch) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  const size_t num_requests = feeds_batch.size();
+  fetches_batch.resize(num_requests);
+  if (num_requests == 0) {
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds_batch[i]));
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, &fetches_batch[i]));
+  }
+
+  TimePoint tp;
+  if (session_profiler_.IsEnabled()) {
+    tp = session_profiler_.StartTime();
+  }
+
+  Status retval = Status::OK();
+
+  std::unique_ptr<logging::Logger> owned_run_logger;
+  auto run_logger = CreateLoggerForRun(run_options, owned_run_logger);
+
+  current_num_runs_ += static_cast<int>(num_requests);
+  if (idle_arena_trimmer_) {
+    idle_arena_trimmer_->RunStarted(static_cast<int>(num_requests));
+  }
+
+  for (auto& xp : execution_providers_) {
+    ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
+  }
+
+  if (retval.IsOK()) {
+    // the requests of a lane run one after the other and share a FeedsFetchesManager, as finalizing the copy info
+    // for the feeds of a request updates it. the parallel executor is not used inside a lane as it schedules the
+    // nodes on the inter-op thread pool the lanes are running on.
+    concurrency::ThreadPool* const inter_op_thread_pool = session_state_->GetInterOpThreadPool();
+    const bool run_lanes_in_parallel = inter_op_thread_pool != nullptr && num_requests > 1;
+    const size_t num_lanes = run_lanes_in_parallel
+                                 ? std::min(num_requests, static_cast<size_t>(inter_op_thread_pool->NumThreads() + 1))
+                                 : 1;
+    const ExecutionMode lane_execution_mode = run_lanes_in_parallel ? ExecutionMode::ORT_SEQUENTIAL
+                                                                    : session_options_.execution_mode;
+    std::vector<Status> lane_status(num_lanes);
+
+    auto run_lane = [&](int32_t lane) {
+      try {
+        concurrency::ThreadPoolPriorityScope priority_scope(
+            static_cast<concurrency::ThreadPoolPriority>(run_options.priority),
+            session_options_.intra_op_max_threads_by_priority.at(run_options.priority));
+        FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+        FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+        auto status = utils::InitializeFeedFetchCopyInfo(*session_state_, feeds_fetches_manager);
+
+        for (size_t i = static_cast<size_t>(lane); status.IsOK() && i < num_requests; i += num_lanes) {
+          int64_t peak_activation_bytes = 0;
+          status = utils::ExecuteGraphWithInitializedCopyInfo(*session_state_, feeds_fetches_manager, feeds_batch[i],
+                                                              fetches_batch[i], lane_execution_mode,
+                                                              run_options.terminate, run_options.deadline,
+                                                              run_logger,
+                                                              &peak_activation_bytes);
+          RecordPeakActivationBytes(peak_activation_bytes);
+          if (runtime_profile_recorder_ && status.IsOK()) {
+            runtime_profile_recorder_->RecordRun(feed_names, feeds_batch[i]);
+          }
+        }
+
+        lane_status[lane] = status;
+      } catch (const std::exception& e) {
+        lane_status[lane] = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+      }
+    };
+
+    if (num_lanes == 1) {
+      run_lane(0);
+    } else {
+      inter_op_thread_pool->ParallelFor(static_cast<int32_t>(num_lanes), run_lane);
+    }
+
+    for (const auto& status : lane_status) {
+      ORT_CHECK_AND_SET_RETVAL(status);
+    }
+  }
+
+  for (auto& xp : execution_providers_) {
+    ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
+  }
+
+  if (run_options.shrink_memory_arenas) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+  }
+
+  current_num_runs_ -= static_cast<int>(num_requests);
+  if (idle_arena_trimmer_) {
+    idle_arena_trimmer_->RunEnded(static_cast<int>(num_requests));
+  }
+
+  total_runs_since_last_ += static_cast<uint32_t>(num_requests);
+  total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
+
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run_batch", tp);
+  }
+
+  return retval;
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -1181,6 +1868,17 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
+  if (!io_binding.output_pools_.empty()) {
+    // the outputs bound to a device are allocated from the binding's pools during the Run, so drop the values
+    // of the previous Run. these requests are not batched as the pools belong to a single request.
+    for (const auto& pool : io_binding.output_pools_) {
+      io_binding.outputs_[pool.first] = OrtValue();
+    }
+    return RunImpl(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
+                   io_binding.GetOutputNames(), &io_binding.GetOutputs(),
+                   &io_binding.output_allocators_, &io_binding.output_locations_);
+  }
+
   return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
              io_binding.GetOutputNames(), &io_binding.GetOutputs());
 }
@@ -1190,6 +1888,22 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, IOBinding& io_binding) {
+  const auto& output_names = io_binding.GetOutputNames();
+  const auto& outputs = io_binding.GetOutputs();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const bool on_device =
+        io_binding.output_pools_.count(i) != 0 ||
+        (outputs[i].IsAllocated() && outputs[i].IsTensor() &&
+         outputs[i].Get<Tensor>().Location().device.Type() != OrtDevice::CPU);
+    if (!on_device) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "RunAsync needs the output ", output_names[i],
+                             " bound to device memory.");
+    }
+  }
+  return Run(run_options, io_binding);
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -1214,6 +1928,10 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      // add the events the execution providers timed on their devices
+      for (auto& xp : execution_providers_) {
+        xp->FlushNodeProfiling();
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -1224,6 +1942,97 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+std::map<std::string, profiling::OpStatistics> InferenceSession::GetOpStatistics() const {
+  if (lightweight_profiler_ == nullptr) {
+    return {};
+  }
+  return lightweight_profiler_->GetOpStatistics();
+}
+
+std::map<std::string, profiling::OpStatistics> InferenceSession::GetNodeStatistics() const {
+  if (lightweight_profiler_ == nullptr) {
+    return {};
+  }
+  return lightweight_profiler_->GetNodeStatistics();
+}
+
+std::string InferenceSession::GetProfilingStatisticsJson() const {
+  if (lightweight_profiler_ == nullptr) {
+    return "{\"dropped_events\": 0, \"ops\": {}, \"nodes\": {}}";
+  }
+  return lightweight_profiler_->GetStatisticsJson();
+}
+
+std::vector<std::pair<OrtMemoryInfo, AllocatorStats>> InferenceSession::GetAllocatorStats() const {
+  std::vector<std::pair<OrtMemoryInfo, AllocatorStats>> result;
+  for (const auto& provider : execution_providers_) {
+    for (const auto& allocator : provider->GetAllocators()) {
+      const auto* arena = dynamic_cast<const BFCArena*>(allocator.get());
+      if (arena == nullptr) {
+        continue;
+      }
+      AllocatorStats stats;
+      arena->GetStats(&stats);
+      result.emplace_back(arena->Info(), stats);
+    }
+  }
+  return result;
+}
+
+void InferenceSession::GetArenaStats(AllocatorStats& stats) const {
+  stats.Clear();
+  for (const auto& entry : GetAllocatorStats()) {
+    const AllocatorStats& arena_stats = entry.second;
+    stats.num_allocs += arena_stats.num_allocs;
+    stats.bytes_in_use += arena_stats.bytes_in_use;
+    stats.total_allocated_bytes += arena_stats.total_allocated_bytes;
+    stats.max_bytes_in_use += arena_stats.max_bytes_in_use;
+    stats.max_alloc_size = std::max(stats.max_alloc_size, arena_stats.max_alloc_size);
+    stats.bytes_limit += arena_stats.bytes_limit;
+  }
+}
+
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  // the buffers kept for the frames of later Runs go back to the arenas first
+  if (session_state_) {
+    session_state_->ClearFrameResources();
+  }
+  for (auto& xp : execution_providers_) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(xp->ShrinkMemoryArenas());
+  }
+  return Status::OK();
+}
+
+void InferenceSession::RecordPeakActivationBytes(int64_t bytes) {
+  int64_t peak = peak_activation_bytes_.load(std::memory_order_relaxed);
+  while (bytes > peak && !peak_activation_bytes_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+std::string InferenceSession::GetMemoryStatisticsJson() const {
+  std::ostringstream json;
+  json << "{\"allocators\": [";
+  bool first = true;
+  for (const auto& entry : GetAllocatorStats()) {
+    const OrtMemoryInfo& info = entry.first;
+    const AllocatorStats& stats = entry.second;
+    json << (first ? "" : ", ")
+         // the allocator names are constants without characters that need escaping
+         << "{\"name\": \"" << info.name << "\""
+         << ", \"id\": " << info.id
+         << ", \"mem_type\": " << static_cast<int>(info.mem_type)
+         << ", \"num_allocs\": " << stats.num_allocs
+         << ", \"bytes_in_use\": " << stats.bytes_in_use
+         << ", \"max_bytes_in_use\": " << stats.max_bytes_in_use
+         << ", \"total_allocated_bytes\": " << stats.total_allocated_bytes
+         << ", \"max_alloc_size\": " << stats.max_alloc_size
+         << ", \"bytes_limit\": " << stats.bytes_limit << '}';
+    first = false;
+  }
+  json << "]}";
+  return json.str();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
@@ -1355,7 +2164,9 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
                                                  const std::vector<std::string>& custom_list) {
   auto add_transformers = [&](TransformerLevel level) {
     // Generate and register transformers for level
-    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
+    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides,
+                                                                          custom_list,
+                                                                          session_options_.constant_folding_max_output_bytes);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
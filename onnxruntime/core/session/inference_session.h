@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -10,16 +11,20 @@
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/runtime_profile.h"
 #include "core/framework/session_state.h"
 #include "core/graph/basic_types.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
+#include "core/session/idle_arena_trimmer.h"
+#include "core/session/request_batcher.h"
 
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -47,6 +52,8 @@ class IExecutionProvider;  // forward decl
 class IOBinding;
 class CustomRegistry;
 class Notification;
+class SharedInitializerStore;
+class Environment;
 
 namespace logging {
 class LoggingManager;
@@ -86,6 +93,12 @@ struct ModelMetadata {
  */
 
 class InferenceSession {
+ private:
+  struct InputDefMetaData;
+
+  // loads each replica from a single parsed ModelProto
+  friend class ReplicatedSession;
+
  public:
   /**
     Create a new InferenceSession
@@ -201,6 +214,24 @@ class InferenceSession {
     */
   common::Status RegisterCustomRegistry(std::shared_ptr<CustomRegistry> custom_registry);
 
+  /**
+    * Set the store used to share constant CPU initializers with other sessions.
+    * Call this before invoking Initialize(). The store is only used if
+    * SessionOptions::share_initializers_across_sessions is set.
+    * Calling this API is optional.
+    * @return OK if success.
+    */
+  common::Status SetSharedInitializerStore(std::shared_ptr<SharedInitializerStore> store);
+
+  /**
+    * Use the thread pools of the environment instead of per session thread pools.
+    * Call this before invoking Initialize(). It's required if SessionOptions::use_per_session_threads
+    * is false, and the environment must have been created with global thread pools.
+    * The environment must outlive the session.
+    * @return OK if success.
+    */
+  common::Status UseGlobalThreadPools(const Environment& env);
+
   /**
     * Load an ONNX model.
     * @param model_uri absolute path of the model file.
@@ -245,6 +276,28 @@ class InferenceSession {
                      const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                      std::vector<OrtValue>* p_fetches);
 
+  /**
+    * Run independent requests that use the same input and output names in one call.
+    * The names are resolved and the copy info between devices is computed once for all the requests instead of
+    * once per request. When the session uses the ORT_PARALLEL execution mode the requests are spread across the
+    * inter-op thread pool, and each of them runs its nodes sequentially. Otherwise they run one after the other.
+    * This API is thread-safe.
+    * @param feeds_batch the feeds of each request, in the order of feed_names.
+    * @param fetches_batch resized to the number of requests. Each entry may hold preallocated fetches like p_fetches
+    *        for Run.
+    * @return OK if all the requests succeeded, otherwise the error of the first failed request.
+    */
+  common::Status RunBatch(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                          const std::vector<std::vector<OrtValue>>& feeds_batch,
+                          const std::vector<std::string>& output_names,
+                          std::vector<std::vector<OrtValue>>& fetches_batch);
+
+  /**
+    * Get the dynamic batching counters.
+    * @return nullptr if dynamic batching is not enabled for this session.
+    */
+  const RequestBatcher* GetRequestBatcher() const { return request_batcher_.get(); }
+
   /**
     * Run a pre-loaded and pre-intialized model.
     * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -276,6 +329,53 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+    * Runs with the inputs and outputs of the binding and returns once the work is queued on the devices, without
+    * waiting for it. All the outputs must be bound to device memory, as copying an output to CPU memory waits for
+    * the device. The outputs are complete once the work queued on the device before they are read is done, e.g. on
+    * the stream supplied to the CUDA execution provider, or after IOBinding::SynchronizeOutputs().
+    * The kernels that read a result on the CPU, e.g. NonZero, and shrinking the arenas at the end of the Run still
+    * wait for the device.
+    */
+  common::Status RunAsync(const RunOptions& run_options, IOBinding& io_binding);
+
+  /**
+    * Feed and fetch names resolved by PrepareRun for repeated runs with the same names.
+    * The name to index mappings and the static copy info between devices are reused by each Run with it, so the
+    * names are not looked up again per request. Runs with the same PreparedRun are serialized: use one per thread
+    * to run concurrently. It must not outlive the session that created it.
+    */
+  class PreparedRun {
+   public:
+    const std::vector<std::string>& GetFeedNames() const { return feed_names_; }
+    const std::vector<std::string>& GetOutputNames() const { return output_names_; }
+
+   private:
+    friend class InferenceSession;
+    PreparedRun() = default;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+    std::vector<std::string> feed_names_;
+    std::vector<std::string> output_names_;
+    std::vector<const InputDefMetaData*> input_defs_;  // in the order of feed_names_
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+    OrtMutex mutex_;  // the copy info of feeds_fetches_manager_ is finalized per run
+  };
+
+  /**
+    * Resolve the names of the feeds and fetches for Run(const RunOptions&, PreparedRun&, ...).
+    * This API is thread-safe.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>& prepared_run) const;
+
+  /**
+    * Run with the names resolved by PrepareRun. feeds is in the order of the prepared feed names and p_fetches, if
+    * not empty, in the order of the prepared output names. These runs are not batched with other requests.
+    */
+  common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run, const std::vector<OrtValue>& feeds,
+                     std::vector<OrtValue>* p_fetches);
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -344,6 +444,52 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the kernel time statistics of the runs sampled by the lightweight profiler, keyed by op type.
+    * Empty if SessionOptions::lightweight_profiling_sampling_interval and SessionOptions::runtime_profile_runs are 0.
+    */
+  std::map<std::string, profiling::OpStatistics> GetOpStatistics() const;
+
+  /**
+    * Same as GetOpStatistics, keyed by node name.
+    */
+  std::map<std::string, profiling::OpStatistics> GetNodeStatistics() const;
+
+  /**
+    * The op and node statistics of the lightweight profiler as a JSON object.
+    * See profiling::LightweightProfiler::GetStatisticsJson.
+    */
+  std::string GetProfilingStatisticsJson() const;
+
+  /**
+    * Get the memory statistics of each arena allocator of the execution providers of this session.
+    * Allocators that don't use an arena are not included as they don't keep statistics.
+    */
+  std::vector<std::pair<OrtMemoryInfo, AllocatorStats>> GetAllocatorStats() const;
+
+  /**
+    * Sum the statistics of GetAllocatorStats, other than max_alloc_size which is the largest of them.
+    */
+  void GetArenaStats(AllocatorStats& stats) const;
+
+  /**
+    * The statistics of GetAllocatorStats as a JSON object:
+    * {"allocators": [{"name": "Cpu", "id": 0, "mem_type": 0, "bytes_in_use": N, ...}, ...]}
+    */
+  std::string GetMemoryStatisticsJson() const;
+
+  /**
+    * The largest number of bytes the intermediate and output tensors of a single Run of this session used at once,
+    * over all the Runs so far.
+    */
+  int64_t GetPeakActivationBytes() const { return peak_activation_bytes_.load(std::memory_order_relaxed); }
+
+  /**
+    * Return the memory the arenas of the execution providers hold but don't use to the devices, e.g. after a spike
+    * of large inputs. Can be called while Runs are in progress, the memory they use is kept.
+    */
+  common::Status ShrinkMemoryArenas();
+
  protected:
   /**
     * Load an ONNX model.
@@ -422,6 +568,37 @@ class InferenceSession {
 
   common::Status ValidateInputs(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds) const;
 
+  common::Status ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                               const OrtValue& feed) const;
+
+  // Execute with a feeds_fetches_manager whose copy info is initialized. The inputs and outputs must be validated.
+  common::Status ExecuteRun(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators,
+                            const std::vector<const OrtMemoryInfo*>* fetch_locations);
+
+  // Run without going through request_batcher_.
+  // fetch_allocators and fetch_locations are set for the outputs of an IOBinding that are bound to a device.
+  common::Status RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                         const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                         std::vector<OrtValue>* p_fetches,
+                         const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators = nullptr,
+                         const std::vector<const OrtMemoryInfo*>* fetch_locations = nullptr);
+
+  // Create request_batcher_ if dynamic batching is enabled and the model inputs are batch-major.
+  common::Status CreateRequestBatcher();
+
+  // Set graph_capture_provider_ if a provider can capture the Runs into graphs and runs all the nodes.
+  void InitializeGraphCapture();
+
+  // The key of the device work of a Run for graph_capture_provider_, which covers the names, addresses and shapes
+  // of the inputs and outputs, or an empty string if they are not all bound to device memory.
+  std::string GetGraphCaptureKey(const FeedsFetchesManager& feeds_fetches_manager,
+                                 const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches) const;
+
+  // Apply the runtime profile saved in the session options, or create runtime_profile_recorder_ to record one.
+  void InitializeRuntimeProfile();
+
   common::Status ValidateOutputs(const std::vector<std::string>& output_names, const std::vector<OrtValue>* p_fetches) const;
 
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
@@ -432,6 +609,9 @@ class InferenceSession {
   template <typename T>
   void StartProfiling(const std::basic_string<T>& file_prefix);
 
+  // the store to share initializers with, or nullptr if they aren't shared
+  SharedInitializerStore* GetSharedInitializerStore() const;
+
   SessionOptions session_options_;
 
   std::unique_ptr<onnxruntime::GraphTransformerManager> graph_transformation_mgr_;
@@ -450,6 +630,9 @@ class InferenceSession {
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // always-on profiler of the main graph. see SessionOptions::lightweight_profiling_sampling_interval.
+  std::unique_ptr<profiling::LightweightProfiler> lightweight_profiler_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
@@ -459,10 +642,31 @@ class InferenceSession {
   std::unique_ptr<SessionState> session_state_;
 
  private:
-  // Threadpool for this session
+  // Threadpool for this session. nullptr if the session uses the thread pools of the environment.
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Whether UseGlobalThreadPools was called.
+  bool uses_global_thread_pools_ = false;
+
+  // Coalesces concurrent Run calls along the batch dimension. nullptr unless enabled in the session options.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
+  // Shrinks the arenas when the session is idle. nullptr unless enabled in the session options.
+  // Destroyed first in ~InferenceSession as it shrinks the arenas from its own thread.
+  std::unique_ptr<IdleArenaTrimmer> idle_arena_trimmer_;
+
+  // Records the first runs and re-plans the session from them. nullptr unless enabled in the session options.
+  // Destroyed first in ~InferenceSession as it re-plans the session from its own thread.
+  std::unique_ptr<RuntimeProfileRecorder> runtime_profile_recorder_;
+
+  // The provider that records the device work of the Runs into graphs and replays them. nullptr unless a provider
+  // has it enabled and runs all the nodes of the model.
+  IExecutionProvider* graph_capture_provider_ = nullptr;
+
+  // Initializers shared with other sessions. nullptr unless set by SetSharedInitializerStore.
+  std::shared_ptr<SharedInitializerStore> shared_initializer_store_;
+
   KernelRegistryManager kernel_registry_manager_;
   std::list<std::shared_ptr<onnxruntime::IOnnxRuntimeOpSchemaCollection>> custom_schema_registries_;
 
@@ -489,6 +693,10 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Largest peak activation bytes of a single Run. Kept here as concurrent Runs may share their RunOptions.
+  std::atomic<int64_t> peak_activation_bytes_{0};
+  void RecordPeakActivationBytes(int64_t bytes);
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
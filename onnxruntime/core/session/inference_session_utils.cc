@@ -101,6 +101,33 @@ static Status SetEnableProfiling(SessionOptions& session_options,
   return Status::OK();
 }
 
+static Status SetEnableMemPattern(SessionOptions& session_options,
+                                  int value,
+                                  const logging::Logger& logger) {
+  if (value != 0 && value != 1) {
+    LOGS(logger, ERROR) << "Unsupported value for enable_mem_pattern option: " << value;
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported value for enable_mem_pattern option: ", value);
+  }
+
+  LOGS(logger, INFO) << "Setting enable_mem_pattern to " << (value == 0 ? "false" : "true");
+  session_options.enable_mem_pattern = (value == 0 ? false : true);
+  return Status::OK();
+}
+
+static Status SetEnableCpuMemArena(SessionOptions& session_options,
+                                   int value,
+                                   const logging::Logger& logger) {
+  if (value != 0 && value != 1) {
+    LOGS(logger, ERROR) << "Unsupported value for enable_cpu_mem_arena option: " << value;
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported value for enable_cpu_mem_arena option: ",
+                           value);
+  }
+
+  LOGS(logger, INFO) << "Setting enable_cpu_mem_arena to " << (value == 0 ? "false" : "true");
+  session_options.enable_cpu_mem_arena = (value == 0 ? false : true);
+  return Status::OK();
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -206,6 +233,22 @@ Status InferenceSessionUtils::ParseSessionOptionsFromModelProto(SessionOptions&
 
       ORT_RETURN_IF_ERROR(SetEnableProfiling(session_options, it.value().get<int>(), logger_));
 
+    } else if (key == "enable_mem_pattern") {
+      if (!value.is_number_integer()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "enable_mem_pattern option in the model file must be an integer");
+      }
+
+      ORT_RETURN_IF_ERROR(SetEnableMemPattern(session_options, it.value().get<int>(), logger_));
+
+    } else if (key == "enable_cpu_mem_arena") {
+      if (!value.is_number_integer()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "enable_cpu_mem_arena option in the model file must be an integer");
+      }
+
+      ORT_RETURN_IF_ERROR(SetEnableCpuMemArena(session_options, it.value().get<int>(), logger_));
+
     } else {
       LOGS(logger_, INFO) << "Ignoring unsupported session option in ORT config: " << key;
     }
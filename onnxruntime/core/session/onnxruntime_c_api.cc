@@ -23,6 +23,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
@@ -84,11 +85,14 @@ struct OrtEnv {
     const char* logid{};
   };
 
-  static OrtEnv* GetInstance(const LoggingManagerConstructionInfo& lm_info, Status& status) {
+  // tp_options is only used when the instance is created. nullptr creates the environment without global thread
+  // pools.
+  static OrtEnv* GetInstance(const LoggingManagerConstructionInfo& lm_info, Status& status,
+                             const ThreadingOptions* tp_options = nullptr) {
     std::lock_guard<OrtMutex> lock(m_);
     if (!p_instance_) {
       std::unique_ptr<Environment> env;
-      status = Environment::Create(env);
+      status = tp_options ? Environment::Create(env, *tp_options) : Environment::Create(env);
       if (!status.IsOK()) {
         return nullptr;
       }
@@ -134,6 +138,10 @@ struct OrtEnv {
     return logging_manager_.get();
   }
 
+  const Environment& GetEnvironment() const {
+    return *value_;
+  }
+
  private:
   static OrtEnv* p_instance_;
   static OrtMutex m_;
@@ -155,6 +163,10 @@ OrtEnv* OrtEnv::p_instance_ = nullptr;
 int OrtEnv::ref_count_ = 0;
 OrtMutex OrtEnv::m_;
 
+struct OrtThreadingOptions {
+  onnxruntime::ThreadingOptions value;
+};
+
 #define TENSOR_READ_API_BEGIN                          \
   API_IMPL_BEGIN                                       \
   auto v = reinterpret_cast<const ::OrtValue*>(value); \
@@ -186,6 +198,41 @@ ORT_API_STATUS_IMPL(OrtApis::CreateEnv, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  OrtEnv::LoggingManagerConstructionInfo lm_info{nullptr, nullptr, default_warning_level, logid};
+  Status status;
+  *out = OrtEnv::GetInstance(lm_info, status, &tp_options->value);
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out) {
+  API_IMPL_BEGIN
+  *out = new OrtThreadingOptions();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int intra_op_num_threads) {
+  if (intra_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The number of threads can't be negative.");
+  }
+  tp_options->value.intra_op_num_threads = intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int inter_op_num_threads) {
+  if (inter_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The number of threads can't be negative.");
+  }
+  tp_options->value.inter_op_num_threads = inter_op_num_threads;
+  return nullptr;
+}
+
 // enable platform telemetry
 ORT_API_STATUS_IMPL(OrtApis::EnableTelemetryEvents, _In_ const OrtEnv* ort_env) {
   API_IMPL_BEGIN
@@ -459,7 +506,7 @@ ORT_API_STATUS_IMPL(OrtApis::RegisterCustomOpsLibrary, _Inout_ OrtSessionOptions
 }
 
 namespace {
-OrtStatus* LoadAndInitializeSession(_In_ const OrtEnv* /*env*/, _In_ const OrtSessionOptions* options,
+OrtStatus* LoadAndInitializeSession(_In_ const OrtEnv* env, _In_ const OrtSessionOptions* options,
                                     _In_ std::unique_ptr<::onnxruntime::InferenceSession>& sess,
                                     _Outptr_ OrtSession** out) {
   // we need to disable mem pattern if DML is one of the providers since DML doesn't have the concept of
@@ -489,6 +536,18 @@ OrtStatus* LoadAndInitializeSession(_In_ const OrtEnv* /*env*/, _In_ const OrtSe
       if (!status.IsOK())
         return ToOrtStatus(status);
     }
+
+    if (options->value.share_initializers_across_sessions) {
+      status = sess->SetSharedInitializerStore(env->GetEnvironment().GetSharedInitializerStore());
+      if (!status.IsOK())
+        return ToOrtStatus(status);
+    }
+
+    if (!options->value.use_per_session_threads) {
+      status = sess->UseGlobalThreadPools(env->GetEnvironment());
+      if (!status.IsOK())
+        return ToOrtStatus(status);
+    }
   }
 
   // register the providers
@@ -603,6 +662,255 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunBatch, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    size_t batch_size, _Inout_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<std::vector<OrtValue>> feeds_batch(batch_size, std::vector<OrtValue>(input_len));
+  std::vector<std::vector<OrtValue>> fetches_batch(batch_size, std::vector<OrtValue>(output_names_len));
+  for (size_t request = 0; request != batch_size; ++request) {
+    for (size_t i = 0; i != input_len; ++i) {
+      auto& ort_value = feeds_batch[request][i] = *input[request * input_len + i];
+      if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    }
+
+    for (size_t i = 0; i != output_names_len; ++i) {
+      const ::OrtValue* value = output[request * output_names_len + i];
+      if (value != nullptr) {
+        if (value->Fence())
+          value->Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+        fetches_batch[request][i] = *value;
+      }
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->RunBatch(op, feed_names, feeds_batch, output_names, fetches_batch);
+  } else {
+    status = session->RunBatch(*run_options, feed_names, feeds_batch, output_names, fetches_batch);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t request = 0; request != batch_size; ++request) {
+    for (size_t i = 0; i != output_names_len; ++i) {
+      ::OrtValue& value = fetches_batch[request][i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+      OrtValue*& out = output[request * output_names_len + i];
+      if (out == nullptr) {
+        out = new OrtValue(value);
+      }
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::InferenceSession::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_ const OrtValue* const* input, size_t input_len,
+                    _Inout_ OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& prepared = *reinterpret_cast<::onnxruntime::InferenceSession::PreparedRun*>(prepared_run);
+  const int queue_id = 0;
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *input[i];
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<OrtValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, prepared, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtIoBinding*>(binding.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  API_IMPL_BEGIN
+  auto status = reinterpret_cast<::onnxruntime::IOBinding*>(binding)->BindInput(name, *val);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  API_IMPL_BEGIN
+  auto status = reinterpret_cast<::onnxruntime::IOBinding*>(binding)->BindOutput(name, *val);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info) {
+  API_IMPL_BEGIN
+  auto status = reinterpret_cast<::onnxruntime::IOBinding*>(binding)->BindOutput(name, *mem_info);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputCount, _In_ const OrtIoBinding* binding, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  *out = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding)->GetOutputNames().size();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputValues, _In_ const OrtIoBinding* binding, _Outptr_ OrtValue** output,
+                    size_t output_len) {
+  API_IMPL_BEGIN
+  // GetOutputs isn't const as the runs write the outputs, it's only read here
+  auto& outputs = const_cast<::onnxruntime::IOBinding*>(reinterpret_cast<const ::onnxruntime::IOBinding*>(binding))
+                      ->GetOutputs();
+  if (output_len != outputs.size()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output_len doesn't match the number of bound outputs");
+  }
+  for (size_t i = 0; i != output_len; ++i) {
+    output[i] = new OrtValue(outputs[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& io_binding = *reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, io_binding);
+  } else {
+    status = session->Run(*run_options, io_binding);
+  }
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& io_binding = *reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->RunAsync(op, io_binding);
+  } else {
+    status = session->RunAsync(*run_options, io_binding);
+  }
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::IsTensor, _In_ const OrtValue* value, int* out) {
   auto v = reinterpret_cast<const ::OrtValue*>(value);
   *out = v->IsTensor() ? 1 : 0;
@@ -667,7 +975,7 @@ ORT_API_STATUS_IMPL(OrtApis::GetStringTensorContent, _In_ const OrtValue* value,
   }
   size_t f = 0;
   char* p = static_cast<char*>(s);
-  for (size_t i = 0; i != offsets_len; ++i, ++offsets) {
+  for (size_t i = 0; i != len; ++i, ++offsets) {
     memcpy(p, input[i].data(), input[i].size());
     p += input[i].size();
     *offsets = f;
@@ -765,6 +1073,67 @@ static OrtStatus* GetNodeDefNameImpl(_In_ const OrtSession* sess, size_t index,
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStatistics, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetProfilingStatisticsJson(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetArenaMemoryUsage, _In_ const OrtSession* sess, _Out_ int64_t* bytes_in_use,
+                    _Out_ int64_t* max_bytes_in_use) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  onnxruntime::AllocatorStats stats;
+  session->GetArenaStats(stats);
+  *bytes_in_use = stats.bytes_in_use;
+  *max_bytes_in_use = stats.max_bytes_in_use;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionShrinkMemoryArenas, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->ShrinkMemoryArenas());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetDynamicBatchingStats, _In_ const OrtSession* sess, _Out_ uint64_t* requests,
+                    _Out_ uint64_t* batches, _Out_ uint64_t* unbatched_requests) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto* request_batcher = session->GetRequestBatcher();
+  ::onnxruntime::RequestBatcher::Stats stats;
+  if (request_batcher != nullptr) {
+    stats = request_batcher->GetStats();
+  }
+  *requests = stats.requests;
+  *batches = stats.batches;
+  *unbatched_requests = stats.unbatched_requests;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMemoryStatistics, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetMemoryStatisticsJson(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetPeakActivationBytes, _In_ const OrtSession* sess, _Out_ int64_t* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = session->GetPeakActivationBytes();
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetInputName, _In_ const OrtSession* sess, size_t index,
                     _Inout_ OrtAllocator* allocator, _Outptr_ char** output) {
   API_IMPL_BEGIN
@@ -1447,10 +1816,65 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+
+    &OrtApis::EnableSharedInitializers,
+    &OrtApis::DisableSharedInitializers,
+
+    &OrtApis::RunBatch,
+
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+
+    &OrtApis::SetLightweightProfilingSamplingInterval,
+    &OrtApis::SessionGetProfilingStatistics,
+    &OrtApis::SessionGetArenaMemoryUsage,
+    &OrtApis::SessionGetMemoryStatistics,
+    &OrtApis::SessionGetPeakActivationBytes,
+
+    &OrtApis::CreateIoBinding,
+    &OrtApis::BindInput,
+    &OrtApis::BindOutput,
+    &OrtApis::BindOutputToDevice,
+    &OrtApis::GetBoundOutputCount,
+    &OrtApis::GetBoundOutputValues,
+    &OrtApis::RunWithBinding,
+    &OrtApis::ReleaseIoBinding,
+
+    &OrtApis::SessionShrinkMemoryArenas,
+    &OrtApis::RunOptionsSetShrinkMemoryArenas,
+    &OrtApis::SetSessionArenaIdleShrinkTime,
+    &OrtApis::SetSessionCpuArenaBackend,
+    &OrtApis::SetSessionDeferSubgraphInitializers,
+
+    &OrtApis::KernelContext_GetThreadCount,
+    &OrtApis::KernelContext_ParallelFor,
+    &OrtApis::KernelContext_AllocateScratch,
+    &OrtApis::KernelContext_FreeScratch,
+
+    &OrtApis::ShapeInferContext_GetInputCount,
+    &OrtApis::ShapeInferContext_GetInputTypeShape,
+    &OrtApis::ShapeInferContext_SetOutputTypeShape,
+
+    &OrtApis::CreateEnvWithGlobalThreadPools,
+    &OrtApis::DisablePerSessionThreads,
+    &OrtApis::CreateThreadingOptions,
+    &OrtApis::ReleaseThreadingOptions,
+    &OrtApis::SetGlobalIntraOpNumThreads,
+    &OrtApis::SetGlobalInterOpNumThreads,
+
+    &OrtApis::RunOptionsSetDeadline,
+    &OrtApis::RunOptionsSetPriority,
+    &OrtApis::SetSessionRunPriorityMaxThreads,
+    &OrtApis::SetSessionCpuHugePageThreshold,
+    &OrtApis::RunAsync,
+    &OrtApis::SetSessionDynamicBatching,
+    &OrtApis::SessionGetDynamicBatchingStats,
 };
 
+// later versions append their functions to the same table
 ORT_API(const OrtApi*, OrtApis::GetApi, uint32_t version) {
-  if (version > 1)
+  if (version > ORT_API_VERSION)
     return nullptr;
 
   return &ort_api_1;
@@ -1471,3 +1895,6 @@ ORT_API(void, OrtApis::ReleaseEnv, _Frees_ptr_opt_ OrtEnv* value) {
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::InferenceSession::PreparedRun)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(IoBinding, ::onnxruntime::IOBinding)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ThreadingOptions, OrtThreadingOptions)
@@ -16,6 +16,9 @@ ORT_API(void, ReleaseTypeInfo, OrtTypeInfo*);
 ORT_API(void, ReleaseTensorTypeAndShapeInfo, OrtTensorTypeAndShapeInfo*);
 ORT_API(void, ReleaseSessionOptions, OrtSessionOptions*);
 ORT_API(void, ReleaseCustomOpDomain, OrtCustomOpDomain*);
+ORT_API(void, ReleasePreparedRun, OrtPreparedRun*);
+ORT_API(void, ReleaseIoBinding, OrtIoBinding*);
+ORT_API(void, ReleaseThreadingOptions, OrtThreadingOptions*);
 
 ORT_API_STATUS_IMPL(CreateStatus, OrtErrorCode code, _In_ const char* msg);
 OrtErrorCode ORT_API_CALL GetErrorCode(_In_ const OrtStatus* status) NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
@@ -46,6 +49,42 @@ ORT_API_STATUS_IMPL(EnableProfiling, _In_ OrtSessionOptions* options, _In_ const
 ORT_API_STATUS_IMPL(DisableProfiling, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(EnableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(DisableMemPattern, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(EnableSharedInitializers, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableSharedInitializers, _In_ OrtSessionOptions* options);
+
+ORT_API_STATUS_IMPL(RunBatch, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len,
+                    size_t batch_size, _Inout_ OrtValue** output);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_ const OrtValue* const* input, size_t input_len,
+                    _Inout_ OrtValue** output, size_t output_len);
+ORT_API_STATUS_IMPL(CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out);
+ORT_API_STATUS_IMPL(BindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* val);
+ORT_API_STATUS_IMPL(BindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* val);
+ORT_API_STATUS_IMPL(BindOutputToDevice, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info);
+ORT_API_STATUS_IMPL(GetBoundOutputCount, _In_ const OrtIoBinding* binding, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(GetBoundOutputValues, _In_ const OrtIoBinding* binding, _Outptr_ OrtValue** output,
+                    size_t output_len);
+ORT_API_STATUS_IMPL(RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS_IMPL(SetLightweightProfilingSamplingInterval, _In_ OrtSessionOptions* options, uint32_t sampling_interval);
+ORT_API_STATUS_IMPL(SessionGetProfilingStatistics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetArenaMemoryUsage, _In_ const OrtSession* sess, _Out_ int64_t* bytes_in_use,
+                    _Out_ int64_t* max_bytes_in_use);
+ORT_API_STATUS_IMPL(SessionGetMemoryStatistics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetPeakActivationBytes, _In_ const OrtSession* sess, _Out_ int64_t* out);
 ORT_API_STATUS_IMPL(EnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(DisableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(SetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
@@ -82,6 +121,12 @@ ORT_API_STATUS_IMPL(RunOptionsGetRunLogVerbosityLevel, _In_ const OrtRunOptions*
 ORT_API_STATUS_IMPL(RunOptionsGetRunLogSeverityLevel, _In_ const OrtRunOptions* options, _Out_ int* out);
 ORT_API_STATUS_IMPL(RunOptionsGetRunTag, _In_ const OrtRunOptions*, _Out_ const char** out);
 
+ORT_API_STATUS_IMPL(SessionShrinkMemoryArenas, _Inout_ OrtSession* sess);
+ORT_API_STATUS_IMPL(RunOptionsSetShrinkMemoryArenas, _Inout_ OrtRunOptions* options, int shrink);
+ORT_API_STATUS_IMPL(SetSessionArenaIdleShrinkTime, _Inout_ OrtSessionOptions* options, int64_t idle_ms);
+ORT_API_STATUS_IMPL(SetSessionCpuArenaBackend, _Inout_ OrtSessionOptions* options, OrtArenaBackend backend);
+ORT_API_STATUS_IMPL(SetSessionDeferSubgraphInitializers, _Inout_ OrtSessionOptions* options, int defer);
+
 ORT_API_STATUS_IMPL(RunOptionsSetTerminate, _Inout_ OrtRunOptions* options);
 ORT_API_STATUS_IMPL(RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options);
 
@@ -143,5 +188,35 @@ ORT_API_STATUS_IMPL(KernelContext_GetInputCount, _In_ const OrtKernelContext* co
 ORT_API_STATUS_IMPL(KernelContext_GetOutputCount, _In_ const OrtKernelContext* context, _Out_ size_t* out);
 ORT_API_STATUS_IMPL(KernelContext_GetInput, _In_ const OrtKernelContext* context, _In_ size_t index, _Out_ const OrtValue** out);
 ORT_API_STATUS_IMPL(KernelContext_GetOutput, _Inout_ OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count, _Out_ OrtValue** out);
+ORT_API_STATUS_IMPL(KernelContext_GetThreadCount, _In_ const OrtKernelContext* context, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(KernelContext_ParallelFor, _In_ const OrtKernelContext* context, _In_ OrtParallelForFunc fn,
+                    _In_opt_ void* user_data, size_t total, size_t num_batches);
+ORT_API_STATUS_IMPL(KernelContext_AllocateScratch, _Inout_ OrtKernelContext* context, size_t size, _Outptr_ void** out);
+ORT_API_STATUS_IMPL(KernelContext_FreeScratch, _Inout_ OrtKernelContext* context, _In_ void* p);
+
+ORT_API_STATUS_IMPL(ShapeInferContext_GetInputCount, _In_ const OrtShapeInferContext* context, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(ShapeInferContext_GetInputTypeShape, _In_ const OrtShapeInferContext* context, size_t index,
+                    _Outptr_ OrtTensorTypeAndShapeInfo** out);
+ORT_API_STATUS_IMPL(ShapeInferContext_SetOutputTypeShape, _Inout_ OrtShapeInferContext* context, size_t index,
+                    _In_ const OrtTensorTypeAndShapeInfo* info);
+
+ORT_API_STATUS_IMPL(CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                    _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out);
+ORT_API_STATUS_IMPL(DisablePerSessionThreads, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads);
+ORT_API_STATUS_IMPL(SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads);
+
+ORT_API_STATUS_IMPL(RunOptionsSetDeadline, _Inout_ OrtRunOptions* options, int64_t timeout_us);
+ORT_API_STATUS_IMPL(RunOptionsSetPriority, _Inout_ OrtRunOptions* options, OrtRunPriority priority);
+ORT_API_STATUS_IMPL(SetSessionRunPriorityMaxThreads, _Inout_ OrtSessionOptions* options, OrtRunPriority priority,
+                    int max_threads);
+ORT_API_STATUS_IMPL(SetSessionCpuHugePageThreshold, _Inout_ OrtSessionOptions* options, size_t threshold_bytes);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS_IMPL(SetSessionDynamicBatching, _Inout_ OrtSessionOptions* options, int64_t max_batch_size,
+                    int64_t timeout_us);
+ORT_API_STATUS_IMPL(SessionGetDynamicBatchingStats, _In_ const OrtSession* sess, _Out_ uint64_t* requests,
+                    _Out_ uint64_t* batches, _Out_ uint64_t* unbatched_requests);
 
 }  // namespace OrtApis
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/replicated_session.h"
+
+#include "core/framework/shared_initializer_store.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+ReplicatedSession::ReplicatedSession(std::vector<RunFunction> replicas) {
+  ORT_ENFORCE(!replicas.empty(), "A replicated session needs at least one replica.");
+  replicas_.reserve(replicas.size());
+  for (auto& run_fn : replicas) {
+    replicas_.push_back(onnxruntime::make_unique<Replica>(std::move(run_fn)));
+  }
+}
+
+ReplicatedSession::~ReplicatedSession() = default;
+
+common::Status ReplicatedSession::Create(const SessionOptions& session_options, const void* model_data,
+                                         int model_data_len, size_t num_replicas, const SetupFunction& setup,
+                                         std::shared_ptr<SharedInitializerStore> initializer_store,
+                                         logging::LoggingManager* logging_manager,
+                                         std::unique_ptr<ReplicatedSession>& replicated_session) {
+  if (num_replicas == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A replicated session needs at least one replica.");
+  }
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  if (!model_proto.ParseFromArray(model_data, model_data_len)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
+                  "Failed to load model because protobuf parsing failed.");
+  }
+
+  if (initializer_store == nullptr) {
+    initializer_store = std::make_shared<SharedInitializerStore>();
+  }
+
+  // the replicas share their constant CPU initializers whether or not the caller asked for sharing across sessions
+  SessionOptions replica_options = session_options;
+  replica_options.share_initializers_across_sessions = true;
+
+  std::unique_ptr<ReplicatedSession> result(new ReplicatedSession());
+  result->replicas_.reserve(num_replicas);
+  for (size_t i = 0; i < num_replicas; ++i) {
+    if (!session_options.session_logid.empty()) {
+      replica_options.session_logid = session_options.session_logid + "_replica_" + std::to_string(i);
+    }
+
+    auto session = onnxruntime::make_unique<InferenceSession>(replica_options, logging_manager);
+    ORT_RETURN_IF_ERROR(session->SetSharedInitializerStore(initializer_store));
+    if (setup) {
+      ORT_RETURN_IF_ERROR(setup(i, *session));
+    }
+    ORT_RETURN_IF_ERROR(session->Load(model_proto));
+    ORT_RETURN_IF_ERROR(session->Initialize());
+
+    InferenceSession* p_session = session.get();
+    auto replica = onnxruntime::make_unique<Replica>(
+        [p_session](const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                    const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                    std::vector<OrtValue>& fetches) {
+          return p_session->Run(run_options, feed_names, feeds, output_names, &fetches);
+        });
+    replica->session = std::move(session);
+    result->replicas_.push_back(std::move(replica));
+  }
+
+  replicated_session = std::move(result);
+  return Status::OK();
+}
+
+ReplicatedSession::Replica& ReplicatedSession::AcquireReplica() {
+  // start the scan one replica further on each run so idle replicas take turns. two concurrent runs may pick the
+  // same replica, which only makes the balance approximate.
+  const size_t num_replicas = replicas_.size();
+  const size_t start = next_replica_++ % num_replicas;
+  size_t best = start;
+  int best_in_flight = replicas_[start]->in_flight.load(std::memory_order_relaxed);
+  for (size_t i = 1; i < num_replicas && best_in_flight > 0; ++i) {
+    const size_t candidate = (start + i) % num_replicas;
+    const int in_flight = replicas_[candidate]->in_flight.load(std::memory_order_relaxed);
+    if (in_flight < best_in_flight) {
+      best = candidate;
+      best_in_flight = in_flight;
+    }
+  }
+
+  Replica& replica = *replicas_[best];
+  ++replica.in_flight;
+  ++replica.runs;
+  return replica;
+}
+
+common::Status ReplicatedSession::Run(const RunOptions& run_options,
+                                      const std::vector<std::string>& feed_names,
+                                      const std::vector<OrtValue>& feeds,
+                                      const std::vector<std::string>& output_names,
+                                      std::vector<OrtValue>* p_fetches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+
+  Replica& replica = AcquireReplica();
+  common::Status status;
+  try {
+    status = replica.run_fn(run_options, feed_names, feeds, output_names, *p_fetches);
+  } catch (...) {
+    --replica.in_flight;
+    throw;
+  }
+  --replica.in_flight;
+  return status;
+}
+
+const InferenceSession* ReplicatedSession::GetSession(size_t replica) const {
+  ORT_ENFORCE(replica < replicas_.size(), "Replica ", replica, " is out of range.");
+  return replicas_[replica]->session.get();
+}
+
+std::vector<uint64_t> ReplicatedSession::GetRunCounts() const {
+  std::vector<uint64_t> counts;
+  counts.reserve(replicas_.size());
+  for (const auto& replica : replicas_) {
+    counts.push_back(replica->runs.load());
+  }
+  return counts;
+}
+
+}  // namespace onnxruntime
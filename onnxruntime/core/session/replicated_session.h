@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/run_options.h"
+#include "core/framework/session_options.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+class SharedInitializerStore;
+namespace logging {
+class LoggingManager;
+}
+
+/**
+ * Runs a model that is replicated on several devices, e.g. one replica per CUDA device, as a single session.
+ *
+ * Each Run is dispatched to the replica with the fewest runs in flight. Ties are broken round-robin, so idle
+ * replicas take turns. Outputs that are not preallocated are returned on CPU like with InferenceSession::Run, and
+ * preallocated outputs are copied to the device they are allocated on, so the caller can get them on its own device.
+ * Feeds may be on CPU or on any device the replicas can copy from.
+ *
+ * The replicas must have the same inputs and outputs. This class is thread-safe.
+ */
+class ReplicatedSession {
+ public:
+  using RunFunction = std::function<common::Status(const RunOptions& run_options,
+                                                   const std::vector<std::string>& feed_names,
+                                                   const std::vector<OrtValue>& feeds,
+                                                   const std::vector<std::string>& output_names,
+                                                   std::vector<OrtValue>& fetches)>;
+
+  // Registers the execution providers of a replica before it's initialized, e.g. the CUDA provider of a device.
+  using SetupFunction = std::function<common::Status(size_t replica, InferenceSession& session)>;
+
+  // Dispatches to replicas that are owned elsewhere.
+  explicit ReplicatedSession(std::vector<RunFunction> replicas);
+
+  /**
+   * Create num_replicas initialized sessions of the model.
+   * The model is parsed once, and constant CPU initializers are shared by the replicas through initializer_store,
+   * which may also be shared with other sessions. If initializer_store is nullptr the replicas get a store of their
+   * own. Graph transformers and kernels are still instantiated per replica as they depend on its providers.
+   */
+  static common::Status Create(const SessionOptions& session_options, const void* model_data, int model_data_len,
+                               size_t num_replicas, const SetupFunction& setup,
+                               std::shared_ptr<SharedInitializerStore> initializer_store,
+                               logging::LoggingManager* logging_manager,
+                               std::unique_ptr<ReplicatedSession>& replicated_session);
+
+  ~ReplicatedSession();
+
+  common::Status Run(const RunOptions& run_options,
+                     const std::vector<std::string>& feed_names,
+                     const std::vector<OrtValue>& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>* p_fetches);
+
+  size_t NumReplicas() const { return replicas_.size(); }
+
+  // The session of a replica created by Create, nullptr for a replica given as a RunFunction.
+  const InferenceSession* GetSession(size_t replica) const;
+
+  // number of runs dispatched to each replica
+  std::vector<uint64_t> GetRunCounts() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ReplicatedSession);
+
+  struct Replica {
+    explicit Replica(RunFunction run_fn1) : run_fn(std::move(run_fn1)) {}
+
+    RunFunction run_fn;
+    std::unique_ptr<InferenceSession> session;
+    std::atomic<int> in_flight{0};
+    std::atomic<uint64_t> runs{0};
+  };
+
+  ReplicatedSession() = default;
+
+  // Select the replica for a run and count it as in flight.
+  Replica& AcquireReplica();
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  std::atomic<size_t> next_replica_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,331 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+#include "core/common/make_unique.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+OrtValue AllocateTensorValue(MLDataType element_type, const TensorShape& shape, const AllocatorPtr& allocator) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, allocator);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  OrtValue value;
+  value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return value;
+}
+
+Status TerminatedStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+}
+
+Status DeadlinePassedStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the deadline of the run having passed.");
+}
+
+bool IsBatchableTensor(const OrtValue& value) {
+  if (!value.IsTensor()) {
+    return false;
+  }
+
+  const auto& tensor = value.Get<Tensor>();
+  return tensor.Shape().NumDimensions() > 0 &&
+         !tensor.IsDataTypeString() &&
+         tensor.Location().device.Type() == OrtDevice::CPU;
+}
+}  // namespace
+
+RequestBatcher::RequestBatcher(RunFunction run_fn, AllocatorPtr allocator, int64_t max_batch_size,
+                               int64_t timeout_us)
+    : run_fn_(std::move(run_fn)),
+      allocator_(std::move(allocator)),
+      max_batch_size_(max_batch_size),
+      timeout_us_(timeout_us) {
+  ORT_ENFORCE(allocator_ != nullptr, "RequestBatcher requires a CPU allocator");
+}
+
+bool RequestBatcher::GetBatchKey(const RunOptions& run_options,
+                                 const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                 const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+                                 std::string& key, int64_t& batch_size) {
+  if (feeds.empty() || feed_names.size() != feeds.size() || run_options.terminate) {
+    return false;
+  }
+
+  // pre-allocated outputs would need to be written in place, so those requests run on their own
+  for (const auto& fetch : fetches) {
+    if (fetch.IsAllocated()) {
+      return false;
+    }
+  }
+
+  // the batched run uses the options of its requests, so only requests with the same options are batched. the run
+  // tags only label the logs of a run so they don't need to match, e.g. a server can tag each request with its id,
+  // and the batch runs with the earliest deadline of its requests.
+  std::ostringstream oss;
+  oss << run_options.run_log_severity_level << ';'
+      << run_options.run_log_verbosity_level << ';' << static_cast<int>(run_options.priority) << ';'
+      << run_options.shrink_memory_arenas << '|';
+
+  batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!IsBatchableTensor(feeds[i])) {
+      return false;
+    }
+
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const auto& dims = tensor.Shape().GetDims();
+    if (batch_size == -1) {
+      batch_size = dims[0];
+    } else if (dims[0] != batch_size) {
+      // inputs disagree on the batch size so dim 0 is not a batch dimension for all of them
+      return false;
+    }
+
+    oss << feed_names[i] << ':' << tensor.GetElementType();
+    for (size_t d = 1; d < dims.size(); ++d) {
+      oss << ',' << dims[d];
+    }
+    oss << ';';
+  }
+
+  oss << '|';
+  for (const auto& name : output_names) {
+    oss << name << ';';
+  }
+
+  key = oss.str();
+  return batch_size > 0;
+}
+
+common::Status RequestBatcher::Run(const RunOptions& run_options,
+                                   const std::vector<std::string>& feed_names,
+                                   const std::vector<OrtValue>& feeds,
+                                   const std::vector<std::string>& output_names,
+                                   std::vector<OrtValue>& fetches) {
+  std::string key;
+  int64_t batch_size = 0;
+  if (!GetBatchKey(run_options, feed_names, feeds, output_names, fetches, key, batch_size) ||
+      batch_size >= max_batch_size_) {
+    num_unbatched_requests_.fetch_add(1, std::memory_order_relaxed);
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  num_requests_.fetch_add(1, std::memory_order_relaxed);
+
+  Request request{&run_options, &feeds, &fetches, batch_size, Status::OK()};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  auto entry = open_batches_.find(key);
+  if (entry != open_batches_.end() && entry->second->total_batch_size + batch_size <= max_batch_size_) {
+    // join the batch and wait for its leader to run it
+    std::shared_ptr<Batch> batch = entry->second;
+    batch->requests.push_back(&request);
+    batch->total_batch_size += batch_size;
+    if (batch->total_batch_size >= max_batch_size_) {
+      // full. close it to new requests and let the leader run it now.
+      open_batches_.erase(entry);
+      cv_.notify_all();
+    } else if (run_options.deadline < batch->deadline) {
+      // the leader waits no later than this deadline
+      batch->deadline = run_options.deadline;
+      cv_.notify_all();
+    }
+
+    cv_.wait(lock, [&batch]() { return batch->done; });
+    return request.status;
+  }
+
+  // start a new batch with this request as the leader. any existing batch for the key can't fit this request
+  // so it's closed to new requests, and its leader runs it when its timeout expires.
+  auto batch = std::make_shared<Batch>();
+  batch->requests.push_back(&request);
+  batch->total_batch_size = batch_size;
+  batch->deadline = run_options.deadline;
+  open_batches_[key] = batch;
+
+  const auto timeout = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us_);
+  while (batch->total_batch_size < max_batch_size_) {
+    // a request doesn't wait for others past its deadline
+    const auto run_at = std::min(timeout, batch->deadline);
+    auto now = std::chrono::steady_clock::now();
+    if (now >= run_at) {
+      break;
+    }
+
+    cv_.wait_for(lock, run_at - now);
+  }
+
+  entry = open_batches_.find(key);
+  if (entry != open_batches_.end() && entry->second == batch) {
+    open_batches_.erase(entry);
+  }
+
+  lock.unlock();
+
+  // the batch is closed so its request list can be used without the lock
+  RunBatch(feed_names, output_names, *batch);
+  num_batches_.fetch_add(1, std::memory_order_relaxed);
+
+  lock.lock();
+  batch->done = true;
+  cv_.notify_all();
+
+  return request.status;
+}
+
+void RequestBatcher::RunIndividually(const std::vector<std::string>& feed_names,
+                                     const std::vector<std::string>& output_names,
+                                     const std::vector<Request*>& requests) {
+  for (auto* request : requests) {
+    request->status = run_fn_(*request->run_options, feed_names, *request->feeds, output_names, *request->fetches);
+  }
+}
+
+void RequestBatcher::RunBatch(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                              Batch& batch) {
+  // drop the requests that were terminated or whose deadline passed while they waited for the batch to fill
+  std::vector<Request*> requests;
+  int64_t total_batch_size = 0;
+  const auto now = std::chrono::steady_clock::now();
+  for (auto* request : batch.requests) {
+    if (request->run_options->terminate) {
+      request->status = TerminatedStatus();
+    } else if (now > request->run_options->deadline) {
+      request->status = DeadlinePassedStatus();
+    } else {
+      requests.push_back(request);
+      total_batch_size += request->batch_size;
+    }
+  }
+
+  if (requests.size() <= 1) {
+    RunIndividually(feed_names, output_names, requests);
+    return;
+  }
+
+  // the requests have the same options other than their run tags, deadlines and terminate flags, which only fail
+  // their own request. the batched run is tagged with the tags of its requests so its logs can be traced to each of
+  // them, and runs with the earliest deadline.
+  const RunOptions& first_options = *requests.front()->run_options;
+  RunOptions run_options;
+  run_options.run_log_severity_level = first_options.run_log_severity_level;
+  run_options.run_log_verbosity_level = first_options.run_log_verbosity_level;
+  std::vector<const std::string*> run_tags;
+  for (const auto* request : requests) {
+    const auto& run_tag = request->run_options->run_tag;
+    auto same_tag = [&run_tag](const std::string* tag) { return *tag == run_tag; };
+    if (run_tag.empty() || std::any_of(run_tags.cbegin(), run_tags.cend(), same_tag)) {
+      continue;
+    }
+
+    run_options.run_tag += run_tags.empty() ? run_tag : ',' + run_tag;
+    run_tags.push_back(&run_tag);
+  }
+  for (const auto* request : requests) {
+    run_options.deadline = std::min(run_options.deadline, request->run_options->deadline);
+  }
+  run_options.priority = first_options.priority;
+  run_options.shrink_memory_arenas = first_options.shrink_memory_arenas;
+
+  const size_t num_feeds = feed_names.size();
+
+  // concatenate the inputs along dim 0
+  std::vector<OrtValue> feeds;
+  feeds.reserve(num_feeds);
+  for (size_t i = 0; i < num_feeds; ++i) {
+    const auto& first = (*requests.front()->feeds)[i].Get<Tensor>();
+    std::vector<int64_t> dims = first.Shape().GetDims();
+    dims[0] = total_batch_size;
+
+    OrtValue value = AllocateTensorValue(first.DataType(), TensorShape(dims), allocator_);
+    auto* dst = static_cast<char*>(value.GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto* request : requests) {
+      const auto& src = (*request->feeds)[i].Get<Tensor>();
+      const size_t num_bytes = src.SizeInBytes();
+      if (num_bytes > 0) {
+        memcpy(dst, src.DataRaw(), num_bytes);
+      }
+      dst += num_bytes;
+    }
+
+    feeds.push_back(std::move(value));
+  }
+
+  std::vector<OrtValue> fetches;
+  Status status = run_fn_(run_options, feed_names, feeds, output_names, fetches);
+
+  if (!status.IsOK()) {
+    // if the batch failed as the earliest deadline passed, the requests with a later one get to run on their own
+    const bool deadline_passed = std::chrono::steady_clock::now() > run_options.deadline;
+    std::vector<Request*> later_deadline_requests;
+    for (auto* request : requests) {
+      if (deadline_passed && request->run_options->deadline > run_options.deadline) {
+        later_deadline_requests.push_back(request);
+      } else {
+        request->status = status;
+      }
+    }
+    RunIndividually(feed_names, output_names, later_deadline_requests);
+    return;
+  }
+
+  for (const auto& fetch : fetches) {
+    if (!IsBatchableTensor(fetch) || fetch.Get<Tensor>().Shape()[0] != total_batch_size) {
+      // dim 0 of this output doesn't map to the requests so the batch can't be split
+      RunIndividually(feed_names, output_names, requests);
+      return;
+    }
+  }
+
+  // split the outputs along dim 0. the requests terminated during the run get no outputs.
+  for (auto* request : requests) {
+    request->fetches->clear();
+    request->fetches->reserve(fetches.size());
+    if (request->run_options->terminate) {
+      request->status = TerminatedStatus();
+    }
+  }
+
+  for (const auto& fetch : fetches) {
+    const auto& tensor = fetch.Get<Tensor>();
+    const size_t bytes_per_row = tensor.SizeInBytes() / static_cast<size_t>(total_batch_size);
+    std::vector<int64_t> dims = tensor.Shape().GetDims();
+
+    const auto* src = static_cast<const char*>(tensor.DataRaw());
+    for (auto* request : requests) {
+      const size_t num_bytes = bytes_per_row * static_cast<size_t>(request->batch_size);
+      if (!request->status.IsOK()) {
+        src += num_bytes;
+        continue;
+      }
+
+      dims[0] = request->batch_size;
+      OrtValue value = AllocateTensorValue(tensor.DataType(), TensorShape(dims), allocator_);
+      if (num_bytes > 0) {
+        memcpy(value.GetMutable<Tensor>()->MutableDataRaw(), src, num_bytes);
+      }
+      src += num_bytes;
+      request->fetches->push_back(std::move(value));
+    }
+  }
+}
+
+RequestBatcher::Stats RequestBatcher::GetStats() const {
+  Stats stats;
+  stats.requests = num_requests_.load(std::memory_order_relaxed);
+  stats.batches = num_batches_.load(std::memory_order_relaxed);
+  stats.unbatched_requests = num_unbatched_requests_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Coalesces concurrent requests into a single Run along the batch dimension (dim 0) of the inputs.
+ *
+ * The first request to arrive waits up to timeout_us, and no later than the earliest deadline of the requests of the
+ * batch, for compatible requests to join. Requests are compatible if they have the same feed and output names, and
+ * their inputs have the same element types and non-batch dims.
+ * Up to max_batch_size rows are concatenated, run once, and dim 0 of each output is split back into the requests.
+ *
+ * Requests that can't be batched run directly. That includes requests with non-tensor, string or non-CPU inputs
+ * and requests with pre-allocated outputs. If an output of a batched run doesn't have the combined batch size as
+ * dim 0 the requests are run individually.
+ *
+ * Only requests with the same log levels, priority and shrink_memory_arenas setting are batched, so the batched run
+ * honors the RunOptions of each of its requests. It's tagged with the comma separated run tags of its requests and
+ * runs with the earliest of their deadlines, which don't need to match. A request whose deadline passes or whose
+ * terminate flag is set before the batch runs is dropped from it. If the batched run fails as its deadline passed,
+ * the requests with a later deadline run on their own. A request whose terminate flag is set while the batch runs
+ * fails when the batch is split. Setting the terminate flag of one request doesn't stop the batched run of the
+ * other requests.
+ */
+class RequestBatcher {
+ public:
+  using RunFunction = std::function<common::Status(const RunOptions& run_options,
+                                                   const std::vector<std::string>& feed_names,
+                                                   const std::vector<OrtValue>& feeds,
+                                                   const std::vector<std::string>& output_names,
+                                                   std::vector<OrtValue>& fetches)>;
+
+  RequestBatcher(RunFunction run_fn, AllocatorPtr allocator, int64_t max_batch_size, int64_t timeout_us);
+
+  common::Status Run(const RunOptions& run_options,
+                     const std::vector<std::string>& feed_names,
+                     const std::vector<OrtValue>& feeds,
+                     const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>& fetches);
+
+  struct Stats {
+    uint64_t requests = 0;            // requests that went through the batching path
+    uint64_t batches = 0;             // batches executed for those requests
+    uint64_t unbatched_requests = 0;  // requests that were not eligible for batching
+  };
+
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+  struct Request {
+    const RunOptions* run_options;
+    const std::vector<OrtValue>* feeds;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_size;
+    common::Status status;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t total_batch_size = 0;
+    // the earliest deadline of the requests
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    bool done = false;
+  };
+
+  // Returns false if the request can't be batched. Otherwise 'key' identifies compatible requests.
+  static bool GetBatchKey(const RunOptions& run_options,
+                          const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                          const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+                          std::string& key, int64_t& batch_size);
+
+  void RunBatch(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                Batch& batch);
+
+  // run each request with its own RunOptions
+  void RunIndividually(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                       const std::vector<Request*>& requests);
+
+  const RunFunction run_fn_;
+  const AllocatorPtr allocator_;
+  const int64_t max_batch_size_;
+  const int64_t timeout_us_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  // batches that are waiting for more requests, by batch key. protected by mutex_.
+  std::unordered_map<std::string, std::shared_ptr<Batch>> open_batches_;
+
+  std::atomic<uint64_t> num_requests_{0};
+  std::atomic<uint64_t> num_batches_{0};
+  std::atomic<uint64_t> num_unbatched_requests_{0};
+};
+
+}  // namespace onnxruntime
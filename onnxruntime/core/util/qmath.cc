@@ -6,7 +6,8 @@
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
 
-#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__) || \
+    defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_SUPPORTS_GEMM_U8X8
 #else
 // default to gemmlowp when building for arm devices
@@ -21,6 +22,28 @@
 
 namespace onnxruntime {
 
+#ifndef MLAS_SUPPORTS_GEMM_U8X8
+// result was computed with a zero point of 0 for rhs. subtract the zero point of each column times the sum of the
+// row of (lhs - lhs_offset).
+template <typename T>
+static void ApplyColumnZeroPoints(int M, int N, int K, const uint8_t* lhs_data, int lda, uint8_t lhs_offset,
+                                  const T* rhs_offsets, int32_t* result_data, int ldc) {
+  for (int m = 0; m < M; m++) {
+    const uint8_t* lhs_row = lhs_data + m * lda;
+    int32_t row_sum = 0;
+    for (int k = 0; k < K; k++) {
+      row_sum += static_cast<int32_t>(lhs_row[k]);
+    }
+    row_sum -= K * static_cast<int32_t>(lhs_offset);
+
+    int32_t* result_row = result_data + m * ldc;
+    for (int n = 0; n < N; n++) {
+      result_row[n] -= static_cast<int32_t>(rhs_offsets[n]) * row_sum;
+    }
+  }
+}
+#endif
+
 void QGemmu8s8_s32(
     int M,
     int N,
@@ -71,6 +94,98 @@ void QGemmu8u8_s32(
 #else
   MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, result_data, ldc, thread_pool);
 
+#endif
+}
+
+void QGemmu8s8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const int8_t* rhs_data,
+    int ldb,
+    const int8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offsets, result_data, ldc, nullptr, thread_pool);
+
+#else
+  QGemmu8s8_s32(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, static_cast<int8_t>(0), result_data, ldc,
+                thread_pool);
+  ApplyColumnZeroPoints(M, N, K, lhs_data, lda, lhs_offset, rhs_offsets, result_data, ldc);
+
+#endif
+}
+
+void QGemmu8u8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t* rhs_offsets,
+    int32_t* result_data,
+    int ldc,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offsets, result_data, ldc, nullptr, thread_pool);
+
+#else
+  QGemmu8u8_s32(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, static_cast<uint8_t>(0), result_data, ldc,
+                thread_pool);
+  ApplyColumnZeroPoints(M, N, K, lhs_data, lda, lhs_offset, rhs_offsets, result_data, ldc);
+
+#endif
+}
+
+void QGemmu8u8_u8(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    uint8_t* result_data,
+    int ldc,
+    float real_multiplier,
+    const uint8_t result_offset,
+    const int32_t* bias,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+  ORT_UNUSED_PARAMETER(thread_pool);
+
+  ORT_ENFORCE(lda == K && ldb == N && ldc == N, "For gemmlowp only RowMajor*RowMajor=RowMajor format is supported");
+
+  int32_t integer_multiplier;
+  int right_shift;
+  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+
+  GemmlowpMultiplyu8u8_u8(lhs_data, rhs_data, result_data, lhs_offset, rhs_offset, result_offset,
+                          M, N, K, integer_multiplier, right_shift, bias);
+
+#else
+  MLAS_QGEMM_OUTPUT_STAGE output_stage = {};
+  output_stage.Scale = &real_multiplier;
+  output_stage.PerColumnScale = false;
+  output_stage.ldOutput = ldc;
+  output_stage.RowBias = bias;
+  output_stage.QuantizedOutput = result_data;
+  output_stage.QuantizedZeroPoint = result_offset;
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, nullptr, 0, &output_stage, thread_pool);
+
 #endif
 }
 }  // namespace onnxruntime
@@ -6,14 +6,20 @@
 namespace onnxruntime {
 namespace concurrency {
 
-std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size) {
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size, bool allow_spinning,
+                                             int spin_duration_us, const std::vector<int>& cpu_affinity) {
   if (thread_pool_size <= 0) {  // default
-    thread_pool_size = std::max<int>(1, std::thread::hardware_concurrency() / 2);
+    const int num_cpus = cpu_affinity.empty() ? static_cast<int>(std::thread::hardware_concurrency())
+                                              : static_cast<int>(cpu_affinity.size());
+    thread_pool_size = std::max<int>(1, num_cpus / 2);
   }
 
   // since we use the main thread for execution we don't have to create any threads on the thread pool when
   // the requested size is 1. For other cases, we will have thread_pool_size + 1 threads for execution
-  return thread_pool_size == 1 ? nullptr : onnxruntime::make_unique<concurrency::ThreadPool>(name, thread_pool_size);
+  return thread_pool_size == 1 ? nullptr : onnxruntime::make_unique<concurrency::ThreadPool>(name, thread_pool_size,
+                                                                                          allow_spinning,
+                                                                                          spin_duration_us,
+                                                                                          cpu_affinity);
 }
 }  // namespace concurrency
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
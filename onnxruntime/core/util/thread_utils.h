@@ -1,10 +1,13 @@
 #include "core/platform/threadpool.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace onnxruntime {
 namespace concurrency {
 
-std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size);
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size,
+                                             bool allow_spinning = true, int spin_duration_us = 0,
+                                             const std::vector<int>& cpu_affinity = {});
 }  // namespace concurrency
 }  // namespace onnxruntime
\ No newline at end of file
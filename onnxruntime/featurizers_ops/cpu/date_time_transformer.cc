@@ -5,6 +5,7 @@
 #include "core/framework/data_types.h"
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel.h"
+#include "featurizers_ops/cpu/transformer_pool.h"
 
 #include "Featurizers/DateTimeFeaturizer.h"
 #include "Archive.h"
@@ -14,19 +15,11 @@ namespace featurizers {
 
 class DateTimeTransformer final : public OpKernel {
  public:
-  explicit DateTimeTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit DateTimeTransformer(const OpKernelInfo& info) : OpKernel(info), transformers_(info) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
-    // Create the transformer
-    Microsoft::Featurizer::Featurizers::DateTimeTransformer transformer(
-        [ctx](void) {
-          const auto* state_tensor(ctx->Input<Tensor>(0));
-          const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-
-          Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().GetDims()[0]);
-          return Microsoft::Featurizer::Featurizers::DateTimeTransformer(archive);
-        }());
+    using TransformerT = Microsoft::Featurizer::Featurizers::DateTimeTransformer;
 
     // Get the input
     const auto* input_tensor(ctx->Input<Tensor>(1));
@@ -80,34 +73,40 @@ class DateTimeTransformer final : public OpKernel {
     // Execute
     const int64_t length(input_tensor->Shape().Size());
 
-    for (int64_t i = 0; i < length; ++i) {
-      auto result(transformer.execute(std::chrono::system_clock::from_time_t(input_data[i])));
+    transformers_.Execute<TransformerT>(
+        ctx, length, 1000.0, [&](TransformerT& transformer, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i < end; ++i) {
+            auto result(transformer.execute(std::chrono::system_clock::from_time_t(input_data[i])));
 
-      year_data[i] = std::move(result.year);
-      month_data[i] = std::move(result.month);
-      day_data[i] = std::move(result.day);
-      hour_data[i] = std::move(result.hour);
-      minute_data[i] = std::move(result.minute);
-      second_data[i] = std::move(result.second);
-      amPm_data[i] = std::move(result.amPm);
-      hour12_data[i] = std::move(result.hour12);
-      dayOfWeek_data[i] = std::move(result.dayOfWeek);
-      dayOfQuarter_data[i] = std::move(result.dayOfQuarter);
-      dayOfYear_data[i] = std::move(result.dayOfYear);
-      weekOfMonth_data[i] = std::move(result.weekOfMonth);
-      quarterOfYear_data[i] = std::move(result.quarterOfYear);
-      halfOfYear_data[i] = std::move(result.halfOfYear);
-      weekIso_data[i] = std::move(result.weekIso);
-      yearIso_data[i] = std::move(result.yearIso);
-      monthLabel_data[i] = std::move(result.monthLabel);
-      amPmLabel_data[i] = std::move(result.amPmLabel);
-      dayOfWeekLabel_data[i] = std::move(result.dayOfWeekLabel);
-      holidayName_data[i] = std::move(result.holidayName);
-      isPaidTimeOff_data[i] = std::move(result.isPaidTimeOff);
-    }
+            year_data[i] = std::move(result.year);
+            month_data[i] = std::move(result.month);
+            day_data[i] = std::move(result.day);
+            hour_data[i] = std::move(result.hour);
+            minute_data[i] = std::move(result.minute);
+            second_data[i] = std::move(result.second);
+            amPm_data[i] = std::move(result.amPm);
+            hour12_data[i] = std::move(result.hour12);
+            dayOfWeek_data[i] = std::move(result.dayOfWeek);
+            dayOfQuarter_data[i] = std::move(result.dayOfQuarter);
+            dayOfYear_data[i] = std::move(result.dayOfYear);
+            weekOfMonth_data[i] = std::move(result.weekOfMonth);
+            quarterOfYear_data[i] = std::move(result.quarterOfYear);
+            halfOfYear_data[i] = std::move(result.halfOfYear);
+            weekIso_data[i] = std::move(result.weekIso);
+            yearIso_data[i] = std::move(result.yearIso);
+            monthLabel_data[i] = std::move(result.monthLabel);
+            amPmLabel_data[i] = std::move(result.amPmLabel);
+            dayOfWeekLabel_data[i] = std::move(result.dayOfWeekLabel);
+            holidayName_data[i] = std::move(result.holidayName);
+            isPaidTimeOff_data[i] = std::move(result.isPaidTimeOff);
+          }
+        });
 
     return Status::OK();
   }
+
+ private:
+  TransformerPool transformers_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
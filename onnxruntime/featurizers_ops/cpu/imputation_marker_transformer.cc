@@ -5,6 +5,7 @@
 #include "core/framework/data_types.h"
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel.h"
+#include "featurizers_ops/cpu/transformer_pool.h"
 
 #include "Featurizers/ImputationMarkerFeaturizer.h"
 #include "Archive.h"
@@ -20,16 +21,8 @@ inline nonstd::optional<std::string> PreprocessOptional(std::string value) {
 
 template <typename InputT>
 struct ImputationMarkerTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
-    // Create the transformer
-    Microsoft::Featurizer::Featurizers::ImputationMarkerTransformer<InputT> transformer(
-        [ctx](void) {
-          const auto* state_tensor(ctx->Input<Tensor>(0));
-          const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-
-          Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().GetDims()[0]);
-          return Microsoft::Featurizer::Featurizers::ImputationMarkerTransformer<InputT>(archive);
-        }());
+  void operator()(OpKernelContext* ctx, const TransformerPool& transformers) const {
+    using TransformerT = Microsoft::Featurizer::Featurizers::ImputationMarkerTransformer<InputT>;
 
     // Get the input
     const auto* input_tensor(ctx->Input<Tensor>(1));
@@ -42,22 +35,28 @@ struct ImputationMarkerTransformerImpl {
     // Execute
     const int64_t length(input_tensor->Shape().Size());
 
-    for (int64_t i = 0; i < length; ++i) {
-      output_data[i] = transformer.execute(PreprocessOptional(input_data[i]));
-    }
+    transformers.Execute<TransformerT>(
+        ctx, length, 10.0, [&](TransformerT& transformer, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i < end; ++i) {
+            output_data[i] = transformer.execute(PreprocessOptional(input_data[i]));
+          }
+        });
   }
 };
 
 class ImputationMarkerTransformer final : public OpKernel {
  public:
-  explicit ImputationMarkerTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit ImputationMarkerTransformer(const OpKernelInfo& info) : OpKernel(info), transformers_(info) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
     utils::MLTypeCallDispatcher<ImputationMarkerTransformerImpl, float, double, std::string> t_disp(ctx->Input<Tensor>(1)->GetElementType());
-    t_disp.Invoke(ctx);
+    t_disp.Invoke(ctx, transformers_);
     return Status::OK();
   }
+
+ private:
+  TransformerPool transformers_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
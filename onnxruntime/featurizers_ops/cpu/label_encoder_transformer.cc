@@ -5,6 +5,7 @@
 #include "core/framework/data_types.h"
 #include "core/framework/data_types_internal.h"
 #include "core/framework/op_kernel.h"
+#include "featurizers_ops/cpu/transformer_pool.h"
 
 #include "Featurizers/LabelEncoderFeaturizer.h"
 #include "Archive.h"
@@ -14,16 +15,8 @@ namespace featurizers {
 
 template <typename InputT>
 struct LabelEncoderTransformerImpl {
-  void operator()(OpKernelContext* ctx) const {
-    // Create the transformer
-    Microsoft::Featurizer::Featurizers::LabelEncoderTransformer<InputT> transformer(
-        [ctx](void) {
-          const auto* state_tensor(ctx->Input<Tensor>(0));
-          const uint8_t* const state_data(state_tensor->Data<uint8_t>());
-
-          Microsoft::Featurizer::Archive archive(state_data, state_tensor->Shape().GetDims()[0]);
-          return Microsoft::Featurizer::Featurizers::LabelEncoderTransformer<InputT>(archive);
-        }());
+  void operator()(OpKernelContext* ctx, const TransformerPool& transformers) const {
+    using TransformerT = Microsoft::Featurizer::Featurizers::LabelEncoderTransformer<InputT>;
 
     // Get the input
     const auto* input_tensor(ctx->Input<Tensor>(1));
@@ -36,24 +29,30 @@ struct LabelEncoderTransformerImpl {
     // Execute
     const int64_t length(input_tensor->Shape().Size());
 
-    for (int64_t i = 0; i < length; ++i) {
-      output_data[i] = transformer.execute(input_data[i]);
-    }
+    transformers.Execute<TransformerT>(
+        ctx, length, 50.0, [&](TransformerT& transformer, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i < end; ++i) {
+            output_data[i] = transformer.execute(input_data[i]);
+          }
+        });
   }
 };
 
 class LabelEncoderTransformer final : public OpKernel {
  public:
-  explicit LabelEncoderTransformer(const OpKernelInfo& info) : OpKernel(info) {
+  explicit LabelEncoderTransformer(const OpKernelInfo& info) : OpKernel(info), transformers_(info) {
   }
 
   Status Compute(OpKernelContext* ctx) const override {
     utils::MLTypeCallDispatcher<LabelEncoderTransformerImpl, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
                                 int64_t, uint64_t, float, double, bool, std::string>
         t_disp(ctx->Input<Tensor>(1)->GetElementType());
-    t_disp.Invoke(ctx);
+    t_disp.Invoke(ctx, transformers_);
     return Status::OK();
   }
+
+ private:
+  TransformerPool transformers_;
 };
 
 ONNX_OPERATOR_KERNEL_EX(
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+#include "Archive.h"
+
+namespace onnxruntime {
+namespace featurizers {
+
+// Runs a featurizer transformer over whole input tensors, in batches of elements on the intra op thread pool.
+//
+// The transformers of a kernel are created from its state (input 0). When the state is a constant initializer it is
+// copied when the kernel is created, and the transformers created from it are kept across Compute calls so the
+// state is not parsed again for every call. Executing a transformer may modify it, so each transformer is used by
+// one batch at a time, and the pool holds as many transformers as there were concurrent batches.
+// A kernel always creates the same TransformerT, as the input types of its node don't change.
+class TransformerPool {
+ public:
+  explicit TransformerPool(const OpKernelInfo& info) {
+    const Tensor* state_tensor = nullptr;
+    if (info.TryGetConstantInput(0, &state_tensor)) {
+      const uint8_t* const state_data(state_tensor->Data<uint8_t>());
+      state_.assign(state_data, state_data + state_tensor->Shape().GetDims()[0]);
+      has_constant_state_ = true;
+    }
+  }
+
+  // Calls fn(transformer, begin, end) for ranges of [0, length). cost_per_element is the estimated number of
+  // cycles to transform one element, which is used to pick the batch size.
+  template <typename TransformerT, typename Fn>
+  void Execute(OpKernelContext* ctx, int64_t length, double cost_per_element, Fn&& fn) const {
+    if (!has_constant_state_) {
+      // the state may differ between calls, so it is parsed for every call and the elements are transformed in order
+      const auto* state_tensor(ctx->Input<Tensor>(0));
+      Microsoft::Featurizer::Archive archive(state_tensor->Data<uint8_t>(), state_tensor->Shape().GetDims()[0]);
+      TransformerT transformer(archive);
+      fn(transformer, static_cast<std::ptrdiff_t>(0), static_cast<std::ptrdiff_t>(length));
+      return;
+    }
+
+    // a transformer that throws, e.g. for a value it doesn't know, is dropped and the exception is rethrown on the
+    // calling thread
+    OrtMutex exception_mutex;
+    std::exception_ptr exception;
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(length), cost_per_element,
+        [this, &fn, &exception_mutex, &exception](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          try {
+            std::shared_ptr<TransformerT> transformer(Acquire<TransformerT>());
+            fn(*transformer, begin, end);
+            Release(std::move(transformer));
+          } catch (...) {
+            std::lock_guard<OrtMutex> lock(exception_mutex);
+            if (!exception) {
+              exception = std::current_exception();
+            }
+          }
+        });
+
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+ private:
+  template <typename TransformerT>
+  std::shared_ptr<TransformerT> Acquire() const {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      if (!transformers_.empty()) {
+        std::shared_ptr<TransformerT> transformer(std::static_pointer_cast<TransformerT>(transformers_.back()));
+        transformers_.pop_back();
+        return transformer;
+      }
+    }
+
+    Microsoft::Featurizer::Archive archive(state_.data(), state_.size());
+    return std::make_shared<TransformerT>(archive);
+  }
+
+  void Release(std::shared_ptr<void> transformer) const {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    transformers_.push_back(std::move(transformer));
+  }
+
+  std::vector<uint8_t> state_;
+  bool has_constant_state_ = false;
+
+  mutable OrtMutex mutex_;
+  mutable std::vector<std::shared_ptr<void>> transformers_;
+};
+
+}  // namespace featurizers
+}  // namespace onnxruntime
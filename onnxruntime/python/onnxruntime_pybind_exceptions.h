@@ -83,5 +83,29 @@ inline void OrtPybindThrowIfError(onnxruntime::common::Status status) {
     }
   }
 }
+
+// Returns the python exception OrtPybindThrowIfError raises for a failed status, for errors that are reported
+// without raising them, such as the errors of asynchronous runs. The GIL must be held.
+inline pybind11::object StatusToPyException(const onnxruntime::common::Status& status) {
+  try {
+    OrtPybindThrowIfError(status);
+  } catch (...) {
+    // translate the exception as pybind11 does when it leaves a bound function. the most recent translators are first.
+    for (auto& translator : pybind11::detail::get_internals().registered_exception_translators) {
+      try {
+        translator(std::current_exception());
+        break;
+      } catch (...) {
+      }
+    }
+  }
+
+  PyObject *type, *value, *traceback;
+  PyErr_Fetch(&type, &value, &traceback);
+  PyErr_NormalizeException(&type, &value, &traceback);
+  Py_XDECREF(type);
+  Py_XDECREF(traceback);
+  return pybind11::reinterpret_steal<pybind11::object>(value);
+}
 }  // namespace python
 }  // namespace onnxruntime
@@ -15,6 +15,7 @@
 #include "core/framework/TensorSeq.h"
 #include "core/framework/data_types.h"
 #include "core/framework/onnxruntime_typeinfo.h"
+#include "core/framework/packed_strings.h"
 
 using namespace std;
 namespace onnxruntime {
@@ -98,7 +99,65 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
-std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject) {
+// Creates a string tensor in the packed layout (see Tensor::IsPackedStrings), which the kernels accepting it read
+// without a std::string per element. The characters of all the elements are found first to size the buffer.
+static std::unique_ptr<Tensor> CreatePackedStringTensor(AllocatorPtr alloc, PyArrayObject* darray,
+                                                        const TensorShape& shape) {
+  const int npy_type = PyArray_TYPE(darray);
+  const auto num_elements = static_cast<size_t>(shape.Size());
+  const auto item_size = static_cast<size_t>(PyArray_ITEMSIZE(darray));
+  char* src = static_cast<char*>(PyArray_DATA(darray));
+
+  // the UTF-8 strings of unicode and object elements belong to their Python strings, kept until they are copied
+  std::vector<py::object> py_strings;
+  std::vector<std::pair<const char*, size_t>> elements(num_elements);
+  size_t num_chars = 0;
+  for (size_t i = 0; i < num_elements; ++i, src += item_size) {
+    const char* data = src;
+    size_t length = item_size;
+    if (npy_type == NPY_UNICODE || npy_type == NPY_OBJECT) {
+      py::object py_str;
+      if (npy_type == NPY_UNICODE) {
+        // Python unicode strings are assumed to be USC-4. Strings are stored as UTF-8.
+        py_str = py::reinterpret_steal<py::object>(
+            PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, src, item_size / PyUnicode_4BYTE_KIND));
+      } else {
+        auto item = py::reinterpret_steal<py::object>(PyArray_GETITEM(darray, src));
+        py_str = py::reinterpret_steal<py::object>(PyObject_Str(item.ptr()));
+      }
+      Py_ssize_t size = 0;
+      data = py_str ? PyUnicode_AsUTF8AndSize(py_str.ptr(), &size) : nullptr;
+      if (data == nullptr) {
+        if (npy_type == NPY_OBJECT) {
+          throw py::error_already_set();
+        }
+        PyErr_Clear();
+        data = "";
+      }
+      // numpy pads the unicode strings of an array to the longest one with final 0s
+      length = npy_type == NPY_UNICODE ? strlen(data) : static_cast<size_t>(size);
+      py_strings.push_back(std::move(py_str));
+    } else if (npy_type == NPY_STRING) {
+      // A string as long as the item has no final 0.
+      length = static_cast<size_t>(std::find(src, src + item_size, '\0') - src);
+    }
+    // NPY_VOID does not trim final 0.
+    elements[i] = {data, length};
+    num_chars += length;
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(shape, num_chars, std::move(alloc));
+  StringTensorWriter writer(*p_tensor);
+  for (const auto& element : elements) {
+    writer.Append(element.first, element.second);
+  }
+  return p_tensor;
+}
+
+// pack_strings creates string tensors in the packed layout, for the feeds of a session which unpacks them for the
+// kernels that need std::string elements.
+std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject,
+                                     bool pack_strings = false) {
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -121,6 +180,8 @@ std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name
         npy_type != NPY_VOID && npy_type != NPY_OBJECT) {
       p_tensor = onnxruntime::make_unique<Tensor>(
           element_type, shape, static_cast<void*>(PyArray_DATA(darray)), alloc->Info());
+    } else if (pack_strings && element_type == DataTypeImpl::GetType<std::string>()) {
+      p_tensor = CreatePackedStringTensor(alloc, darray, shape);
     } else {
       p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, alloc);
       if (npy_type == NPY_UNICODE) {
@@ -156,7 +217,8 @@ std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name
         char* src = static_cast<char*>(PyArray_DATA(darray));
         for (int i = 0; i < shape.Size(); i++, src += item_size) {
           if (npy_type == NPY_STRING) {
-            dst[i] = src;
+            // A string as long as the item has no final 0.
+            dst[i].assign(src, std::find(src, src + item_size, '\0'));
           } else {
             dst[i].resize(item_size);
             memcpy((void*)dst[i].c_str(), src, item_size);
@@ -245,7 +307,7 @@ void CreateSequenceOfTensors(AllocatorPtr alloc, const std::string& name_input,
 
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject,
                          OrtValue* p_mlvalue) {
-  auto p_tensor = CreateTensor(alloc, name_input, pyObject);
+  auto p_tensor = CreateTensor(alloc, name_input, pyObject, true);
   if (!p_tensor) {
     throw std::runtime_error("Got exception while creating tensor for input: " + name_input);
   }
@@ -256,6 +318,129 @@ void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyAr
                   ml_tensor->GetDeleteFunc());
 }
 
+void CreateTensorMLValueOverArray(AllocatorPtr alloc, const std::string& name, py::object& array,
+                                  OrtValue* p_mlvalue) {
+  if (!PyObjectCheck_Array(array.ptr())) {
+    throw std::runtime_error("The object bound to '" + name + "' must be a numpy array.");
+  }
+  PyArrayObject* darray = reinterpret_cast<PyArrayObject*>(array.ptr());
+  const int npy_type = PyArray_TYPE(darray);
+  if (!PyArray_ISCARRAY(darray) || npy_type == NPY_UNICODE || npy_type == NPY_STRING ||
+      npy_type == NPY_VOID || npy_type == NPY_OBJECT) {
+    throw std::runtime_error("The array bound to '" + name +
+                             "' must be an aligned, C-contiguous and writable array of a numeric type.");
+  }
+
+  int ndim = PyArray_NDIM(darray);
+  npy_intp* npy_dims = PyArray_DIMS(darray);
+  std::vector<int64_t> dims(ndim);
+  for (int i = 0; i < ndim; ++i) {
+    dims[i] = npy_dims[i];
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(NumpyToOnnxRuntimeTensorType(npy_type), TensorShape(dims),
+                                                   PyArray_DATA(darray), alloc->Info());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  p_mlvalue->Init(p_tensor.release(),
+                  ml_tensor,
+                  ml_tensor->GetDeleteFunc());
+}
+
+// typestr of __cuda_array_interface__ without the byte order
+static const std::map<std::string, MLDataType>& CudaArrayInterfaceTypes() {
+  static std::map<std::string, MLDataType> type_map{
+      {"b1", DataTypeImpl::GetType<bool>()},
+      {"f2", DataTypeImpl::GetType<MLFloat16>()},
+      {"f4", DataTypeImpl::GetType<float>()},
+      {"f8", DataTypeImpl::GetType<double>()},
+      {"i1", DataTypeImpl::GetType<int8_t>()},
+      {"u1", DataTypeImpl::GetType<uint8_t>()},
+      {"i2", DataTypeImpl::GetType<int16_t>()},
+      {"u2", DataTypeImpl::GetType<uint16_t>()},
+      {"i4", DataTypeImpl::GetType<int32_t>()},
+      {"u4", DataTypeImpl::GetType<uint32_t>()},
+      {"i8", DataTypeImpl::GetType<int64_t>()},
+      {"u8", DataTypeImpl::GetType<uint64_t>()}};
+  return type_map;
+}
+
+void CreateTensorMLValueFromCudaArrayInterface(const std::string& name, py::object& obj, int device_id,
+                                               OrtValue* p_mlvalue, bool* readonly) {
+  if (!py::hasattr(obj, "__cuda_array_interface__")) {
+    throw std::runtime_error("The object bound to '" + name + "' does not have a __cuda_array_interface__.");
+  }
+  py::dict interface = obj.attr("__cuda_array_interface__");
+
+  const std::string typestr = interface["typestr"].cast<std::string>();
+  const auto& types = CudaArrayInterfaceTypes();
+  const auto type_it = typestr.size() == 3 ? types.find(typestr.substr(1)) : types.end();
+  // big endian data is only accepted for single byte types, where the byte order doesn't matter
+  if (type_it == types.end() || (typestr[0] == '>' && type_it->second->Size() != 1)) {
+    throw std::runtime_error("Unsupported typestr " + typestr + " of the CUDA array bound to '" + name + "'.");
+  }
+
+  std::vector<int64_t> dims;
+  for (auto dim : interface["shape"].cast<py::tuple>()) {
+    dims.push_back(dim.cast<int64_t>());
+  }
+
+  if (interface.contains("strides") && !interface["strides"].is_none()) {
+    // only C-contiguous strides are supported
+    int64_t stride = type_it->second->Size();
+    auto strides = interface["strides"].cast<py::tuple>();
+    for (size_t i = dims.size(); i > 0; --i) {
+      if (dims[i - 1] > 1 && strides[i - 1].cast<int64_t>() != stride) {
+        throw std::runtime_error("The CUDA array bound to '" + name + "' must be C-contiguous.");
+      }
+      stride *= dims[i - 1];
+    }
+  }
+
+  auto data = interface["data"].cast<py::tuple>();
+  void* p_data = reinterpret_cast<void*>(data[0].cast<uintptr_t>());
+  *readonly = data[1].cast<bool>();
+
+  OrtMemoryInfo info(CUDA, OrtDeviceAllocator,
+                     OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(device_id)),
+                     device_id, OrtMemTypeDefault);
+  auto p_tensor = onnxruntime::make_unique<Tensor>(type_it->second, TensorShape(dims), p_data, info);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  p_mlvalue->Init(p_tensor.release(),
+                  ml_tensor,
+                  ml_tensor->GetDeleteFunc());
+}
+
+py::dict GetCudaArrayInterface(const Tensor& tensor) {
+  if (tensor.Location().device.Type() != OrtDevice::GPU) {
+    throw std::runtime_error("Only tensors in CUDA memory have a __cuda_array_interface__.");
+  }
+
+  std::string typestr;
+  for (const auto& entry : CudaArrayInterfaceTypes()) {
+    if (entry.second == tensor.DataType()) {
+      typestr = (entry.second->Size() == 1 ? "|" : "<") + entry.first;
+      break;
+    }
+  }
+  if (typestr.empty()) {
+    throw std::runtime_error("The type of the tensor isn't supported by __cuda_array_interface__.");
+  }
+
+  const TensorShape& shape = tensor.Shape();
+  py::tuple dims(shape.NumDimensions());
+  for (size_t i = 0; i < shape.NumDimensions(); ++i) {
+    dims[i] = py::int_(shape[i]);
+  }
+
+  py::dict interface;
+  interface["shape"] = dims;
+  interface["typestr"] = typestr;
+  interface["data"] = py::make_tuple(reinterpret_cast<uintptr_t>(tensor.DataRaw()), false);
+  interface["strides"] = py::none();
+  interface["version"] = 2;
+  return interface;
+}
+
 std::string _get_type_name(int64_t&) {
   return std::string("int64_t");
 }
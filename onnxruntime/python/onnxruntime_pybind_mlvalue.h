@@ -25,5 +25,19 @@ int OnnxRuntimeTensorToNumpyType(const DataTypeImpl* tensor_type);
 void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, AllocatorPtr alloc, const std::string& name_input,
                           py::object& value, OrtValue* p_mlvalue);
 
+// Wraps the buffer of an aligned, C-contiguous and writable numpy array in a tensor OrtValue without copying, so
+// that ORT can write an output into it. The array must outlive the OrtValue.
+void CreateTensorMLValueOverArray(AllocatorPtr alloc, const std::string& name, py::object& array,
+                                  OrtValue* p_mlvalue);
+
+// Wraps the CUDA buffer described by the __cuda_array_interface__ of a python object, such as a CuPy array or a
+// PyTorch CUDA tensor, in a tensor OrtValue on device device_id without copying. The object must outlive the OrtValue.
+// readonly is set to whether the buffer must not be written.
+void CreateTensorMLValueFromCudaArrayInterface(const std::string& name, py::object& obj, int device_id,
+                                               OrtValue* p_mlvalue, bool* readonly);
+
+// Returns the __cuda_array_interface__ of a tensor in CUDA memory.
+py::dict GetCudaArrayInterface(const Tensor& tensor);
+
 }  // namespace python
 }  // namespace onnxruntime
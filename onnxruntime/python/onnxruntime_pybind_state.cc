@@ -8,13 +8,17 @@
 #define PY_ARRAY_UNIQUE_SYMBOL onnxruntime_python_ARRAY_API
 #include <numpy/arrayobject.h>
 
+#include "core/framework/arena.h"
 #include "core/framework/data_types_internal.h"
+#include "core/framework/packed_strings.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/session_options.h"
+#include "core/session/IOBinding.h"
+#include "core/session/replicated_session.h"
 
 #if USE_CUDA
 #define BACKEND_PROC "GPU"
@@ -86,7 +90,23 @@
 #include "core/providers/cpu/cpu_provider_factory.h"
 
 #ifdef USE_CUDA
+#include <limits>
 #include "core/providers/cuda/cuda_provider_factory.h"
+// device of the CUDA execution providers created by new sessions
+int cuda_device_id = 0;
+// device memory arena settings for the CUDA execution providers created by new sessions
+size_t cuda_mem_limit = std::numeric_limits<size_t>::max();
+onnxruntime::ArenaExtendStrategy cuda_arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+// cuDNN convolution algorithm search settings for the CUDA execution providers created by new sessions
+std::string cudnn_conv_algo_cache_file;
+bool cudnn_conv_use_heuristic = false;
+// largest batch of the RNNs run on the persistent cuDNN kernels by the CUDA execution providers created by new
+// sessions. 0 disables them.
+int64_t cudnn_rnn_persist_max_batch_size = 0;
+// whether the CUDA execution providers created by new sessions capture the Runs into CUDA graphs
+bool cuda_graph_enabled = false;
+// number of streams the CUDA execution providers created by new sessions run the branches of parallel execution on
+int cuda_branch_stream_count = 0;
 #endif
 #ifdef USE_TENSORRT
 #include "core/providers/tensorrt/tensorrt_provider_factory.h"
@@ -111,6 +131,13 @@ std::string nuphar_settings;
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id, size_t cuda_mem_limit,
+                                                                               ArenaExtendStrategy arena_extend_strategy,
+                                                                               const std::string& cudnn_conv_algo_cache_file,
+                                                                               bool cudnn_conv_use_heuristic,
+                                                                               int64_t cudnn_rnn_persist_max_batch_size,
+                                                                               bool enable_cuda_graph,
+                                                                               int branch_stream_count);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(int use_arena);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_NGraph(const char* ng_backend_type);
@@ -123,7 +150,9 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainS
 #pragma warning(disable : 4267 4996 4503 4003)
 #endif  // _MSC_VER
 
+#include <fstream>
 #include <iterator>
+#include <thread>
 
 #if defined(_MSC_VER)
 #pragma warning(disable : 4267 4996 4503 4003)
@@ -136,6 +165,11 @@ namespace py = pybind11;
 using namespace onnxruntime;
 using namespace onnxruntime::logging;
 
+static std::unique_ptr<Environment>& GetEnv() {
+  static std::unique_ptr<Environment> env;
+  return env;
+}
+
 static AllocatorPtr& GetAllocator() {
   static AllocatorPtr alloc = std::make_shared<TAllocator>();
   return alloc;
@@ -151,7 +185,9 @@ void AddNonTensor(OrtValue& val, std::vector<py::object>& pyobjs) {
   pyobjs.push_back(py::cast(val.Get<T>()));
 }
 
-void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj) {
+// Converts a tensor to a numpy array. If owner is the OrtValue holding the tensor and the tensor owns its CPU buffer,
+// the array uses the buffer without copying it and keeps a reference to the OrtValue in its base object.
+void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj, const OrtValue* owner = nullptr) {
   std::vector<npy_intp> npy_dims;
   const TensorShape& shape = rtensor.Shape();
 
@@ -161,6 +197,16 @@ void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+  if (owner != nullptr && numpy_type != NPY_OBJECT && rtensor.OwnsBuffer() &&
+      rtensor.Location().device.Type() == OrtDevice::CPU) {
+    obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+        static_cast<int>(shape.NumDimensions()), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw(dtype))));
+    py::capsule base(new OrtValue(*owner), [](void* value) { delete static_cast<OrtValue*>(value); });
+    // PyArray_SetBaseObject steals the reference
+    PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), base.release().ptr());
+    return;
+  }
+
   obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -172,9 +218,9 @@ void GetPyObjFromTensor(const Tensor& rtensor, py::object& obj) {
   } else {
     // Handle string type.
     py::object* outObj = static_cast<py::object*>(outPtr);
-    const std::string* src = rtensor.template Data<std::string>();
-    for (int i = 0; i < rtensor.Shape().Size(); i++, src++) {
-      outObj[i] = py::cast(*src);
+    StringTensorReader reader(rtensor);
+    for (size_t i = 0; i < reader.Size(); i++) {
+      outObj[i] = py::str(reader.Data(i), reader.Length(i));
     }
   }
 }
@@ -185,7 +231,7 @@ void AddNonTensor<TensorSeq>(OrtValue& val, std::vector<py::object>& pyobjs) {
   py::list py_list;
   for (const auto& rtensor : seq_tensors) {
     py::object obj;
-    GetPyObjFromTensor(rtensor, obj);
+    GetPyObjFromTensor(rtensor, obj, &val);
     py_list.append(obj);
   }
   pyobjs.push_back(py_list);
@@ -231,7 +277,7 @@ void AddNonTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
 void AddTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
   const Tensor& rtensor = val.Get<Tensor>();
   py::object obj;
-  GetPyObjFromTensor(rtensor, obj);
+  GetPyObjFromTensor(rtensor, obj, &val);
   pyobjs.push_back(obj);
 }
 
@@ -299,18 +345,146 @@ const std::vector<std::string>& GetAvailableProviders() {
   return available_providers;
 }
 
+// Converts a python feed to an OrtValue for the model input of that name.
+static OrtValue CreateFeed(const InferenceSession* sess, const std::string& name, py::object& value) {
+  OrtValue ml_value;
+  auto px = sess->GetModelInputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+  }
+  CreateGenericMLValue(px.second, GetAllocator(), name, value, &ml_value);
+  if (PyErr_Occurred()) {
+    PyObject *ptype, *pvalue, *ptraceback;
+    PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+    PyObject* pStr = PyObject_Str(ptype);
+    std::string sType = py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    pStr = PyObject_Str(pvalue);
+    sType += ": ";
+    sType += py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    throw std::runtime_error(sType);
+  }
+  return ml_value;
+}
+
+static std::vector<py::object> FetchesToPyObjs(std::vector<OrtValue>& fetches) {
+  std::vector<py::object> rfetch;
+  rfetch.reserve(fetches.size());
+  for (auto _ : fetches) {
+    if (_.IsTensor()) {
+      AddTensorAsPyObj(_, rfetch);
+    } else {
+      AddNonTensorAsPyObj(_, rfetch);
+    }
+  }
+  return rfetch;
+}
+
+// OrtValue exposed to python, with the python object whose buffer it uses if any.
+struct PyOrtValue {
+  OrtValue value;
+  py::object owner;
+  // whether the buffer of owner must not be written
+  bool readonly = false;
+};
+
+static OrtMemoryInfo GetDeviceMemoryInfo(const std::string& device_type, int device_id, OrtAllocatorType alloc_type) {
+  if (device_type == "cpu") {
+    return OrtMemoryInfo(CPU, alloc_type);
+  }
+  if (device_type == "cuda") {
+    return OrtMemoryInfo(CUDA, alloc_type,
+                         OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(device_id)),
+                         device_id, OrtMemTypeDefault);
+  }
+  throw std::runtime_error("Unsupported device type " + device_type + ", expected cpu or cuda");
+}
+
+// IOBinding of a session, with the python objects whose buffers it uses.
+struct SessionIOBinding {
+  SessionIOBinding(InferenceSession* sess) : session(sess) {
+    OrtPybindThrowIfError(session->NewIOBinding(&binding));
+  }
+
+  InferenceSession* session;
+  std::unique_ptr<IOBinding> binding;
+  // bound inputs, kept alive as the feeds may use their buffers
+  std::unordered_map<std::string, py::object> inputs;
+  // numpy arrays or OrtValues the outputs are written to. outputs missing from the map are allocated by the run.
+  std::unordered_map<std::string, py::object> output_arrays;
+  // devices of the outputs bound to a device without preallocating them
+  std::unordered_map<std::string, OrtMemoryInfo> output_devices;
+
+  void BindOutputToDevice(const std::string& name, const std::string& device_type, int device_id) {
+    // the allocator of the device is an arena unless the session disabled it
+    OrtMemoryInfo location = GetDeviceMemoryInfo(device_type, device_id, OrtArenaAllocator);
+    if (!binding->BindOutput(name, location).IsOK()) {
+      location = GetDeviceMemoryInfo(device_type, device_id, OrtDeviceAllocator);
+      OrtPybindThrowIfError(binding->BindOutput(name, location));
+    }
+    output_arrays.erase(name);
+    output_devices[name] = location;
+  }
+};
+
+// Run started by run_async. The python objects are only released with the GIL held.
+struct AsyncRun {
+  py::object session;
+  py::object callback;
+  // the feeds may use the buffers of these objects
+  std::map<std::string, py::object> pyfeeds;
+  NameMLValMap feeds;
+  std::vector<std::string> output_names;
+  // the RunOptions of the caller, so that setting terminate on it stops the run. default_run_options if it passed none.
+  py::object run_options_obj;
+  std::unique_ptr<RunOptions> default_run_options;
+  const RunOptions* run_options = nullptr;
+};
+
+static py::dict OpStatisticsToPyDict(const std::map<std::string, profiling::OpStatistics>& statistics) {
+  py::dict result;
+  for (const auto& entry : statistics) {
+    const auto& op_stats = entry.second;
+    py::dict stats;
+    stats["count"] = op_stats.count;
+    stats["total_ns"] = op_stats.total_ns;
+    stats["min_ns"] = op_stats.min_ns;
+    stats["max_ns"] = op_stats.max_ns;
+    stats["p50_ns"] = op_stats.p50_ns;
+    stats["p99_ns"] = op_stats.p99_ns;
+    stats["output_bytes"] = op_stats.output_bytes;
+    stats["parallel_for_calls"] = op_stats.parallel_for_calls;
+    stats["thread_pool_utilization"] = op_stats.thread_pool_utilization;
+    result[py::str(entry.first)] = stats;
+  }
+  return result;
+}
+
 void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::string>& provider_types) {
   for (const std::string& type : provider_types) {
     if (type == kCpuExecutionProvider) {
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena));
+      CPUExecutionProviderInfo info{sess->GetSessionOptions().enable_cpu_mem_arena};
+      info.use_bf16_gemm = sess->GetSessionOptions().enable_cpu_bf16_gemm;
+      info.use_fp16_weights = sess->GetSessionOptions().enable_cpu_fp16_weights;
+      info.arena_thread_cache = sess->GetSessionOptions().enable_cpu_mem_arena_thread_cache;
+      info.arena_backend = static_cast<ArenaBackend>(sess->GetSessionOptions().cpu_arena_backend);
+      info.huge_page_threshold = sess->GetSessionOptions().cpu_huge_page_threshold_bytes;
+      OrtPybindThrowIfError(sess->RegisterExecutionProvider(onnxruntime::make_unique<CPUExecutionProvider>(info)));
     } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_Tensorrt(0));
 #endif
     } else if (type == kCudaExecutionProvider) {
 #ifdef USE_CUDA
-      // device id??
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(0));
+      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(cuda_device_id, cuda_mem_limit,
+                                                                                        cuda_arena_extend_strategy,
+                                                                                        cudnn_conv_algo_cache_file,
+                                                                                        cudnn_conv_use_heuristic,
+                                                                                        cudnn_rnn_persist_max_batch_size,
+                                                                                        cuda_graph_enabled,
+                                                                                        cuda_branch_stream_count));
 #endif
     } else if (type == kDnnlExecutionProvider) {
 #ifdef USE_DNNL
@@ -371,6 +545,59 @@ void addGlobalMethods(py::module& m) {
       "get_available_providers", []() -> const std::vector<std::string>& { return GetAvailableProviders(); },
       "Return list of available Execution Providers available in this installed version of Onnxruntime.");
 
+#ifdef USE_CUDA
+  m.def(
+      "set_cuda_device_id", [](int device_id) {
+        if (device_id < 0) {
+          throw std::runtime_error("device_id must not be negative");
+        }
+        cuda_device_id = device_id;
+      },
+      "Set the CUDA device of the CUDA execution providers of sessions created afterwards.");
+  m.def(
+      "set_cuda_mem_limit", [](size_t limit) { cuda_mem_limit = limit; },
+      "Set the maximum size in bytes of the CUDA device memory arena for sessions created afterwards.");
+  m.def(
+      "set_cuda_arena_extend_strategy", [](int strategy) {
+        if (strategy != static_cast<int>(onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo) &&
+            strategy != static_cast<int>(onnxruntime::ArenaExtendStrategy::kSameAsRequested)) {
+          throw std::runtime_error("arena extend strategy must be 0 (next power of two) or 1 (same as requested)");
+        }
+        cuda_arena_extend_strategy = static_cast<onnxruntime::ArenaExtendStrategy>(strategy);
+      },
+      "Set how the CUDA device memory arena grows for sessions created afterwards. "
+      "0 doubles the region size, 1 allocates only the requested size.");
+  m.def(
+      "set_cudnn_conv_algo_cache_file", [](const std::string& path) { cudnn_conv_algo_cache_file = path; },
+      "Set the file the cuDNN convolution algorithms are loaded from and saved to by sessions created afterwards. "
+      "An empty path disables the file.");
+  m.def(
+      "set_cudnn_conv_use_heuristic", [](bool use_heuristic) { cudnn_conv_use_heuristic = use_heuristic; },
+      "Pick the cuDNN convolution algorithms with heuristics instead of benchmarking them in sessions created afterwards.");
+  m.def(
+      "set_cudnn_rnn_persist_max_batch_size", [](int64_t max_batch_size) {
+        if (max_batch_size < 0) {
+          throw std::runtime_error("the maximum batch size of the persistent RNN kernels must not be negative");
+        }
+        cudnn_rnn_persist_max_batch_size = max_batch_size;
+      },
+      "Run the RNN, GRU and LSTM batches up to this size on the persistent cuDNN kernels in sessions created "
+      "afterwards. 0 disables them.");
+  m.def(
+      "set_cuda_graph_enabled", [](bool enabled) { cuda_graph_enabled = enabled; },
+      "Capture the device work of the Runs of sessions created afterwards into CUDA graphs, and replay them for the "
+      "later Runs whose inputs and outputs are bound to the same device buffers with the same shapes.");
+  m.def(
+      "set_cuda_branch_stream_count", [](int count) {
+        if (count < 0) {
+          throw std::runtime_error("the number of branch streams must not be negative");
+        }
+        cuda_branch_stream_count = count;
+      },
+      "Run the independent branches of the models of sessions created afterwards with parallel execution on this "
+      "many CUDA streams, so that their kernels run concurrently. 0 runs them on one stream.");
+#endif
+
 #ifdef USE_NUPHAR
   m.def("set_nuphar_settings", [](const std::string& str) {
     nuphar_settings = str;
@@ -557,6 +784,16 @@ void addObjectMethods(py::module& m) {
       .value("ORT_SEQUENTIAL", ExecutionMode::ORT_SEQUENTIAL)
       .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL);
 
+  py::enum_<OrtArenaBackend>(m, "ArenaBackend")
+      .value("DEFAULT", OrtArenaBackend::ORT_ARENA_BACKEND_DEFAULT)
+      .value("BFC", OrtArenaBackend::ORT_ARENA_BACKEND_BFC)
+      .value("MIMALLOC", OrtArenaBackend::ORT_ARENA_BACKEND_MIMALLOC);
+
+  py::enum_<OrtRunPriority>(m, "RunPriority")
+      .value("HIGH", OrtRunPriority::ORT_RUN_PRIORITY_HIGH)
+      .value("NORMAL", OrtRunPriority::ORT_RUN_PRIORITY_NORMAL)
+      .value("LOW", OrtRunPriority::ORT_RUN_PRIORITY_LOW);
+
   py::class_<SessionOptions>
       sess(m, "SessionOptions", R"pbdoc(Configuration information for a session.)pbdoc");
   sess
@@ -564,12 +801,50 @@ void addObjectMethods(py::module& m) {
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_cpu_mem_arena_thread_cache", &SessionOptions::enable_cpu_mem_arena_thread_cache,
+                     R"pbdoc(Serve the CPU allocations of up to 64KB from per-thread caches in front of the arena to avoid contention on the arena lock. Default is false.)pbdoc")
+      .def_readwrite("cpu_arena_backend", &SessionOptions::cpu_arena_backend,
+                     R"pbdoc(Arena of the CPU allocations, BFC or MIMALLOC (requires a build with mimalloc). Default is ArenaBackend.DEFAULT.)pbdoc")
+      .def_readwrite("cpu_huge_page_threshold_bytes", &SessionOptions::cpu_huge_page_threshold_bytes,
+                     R"pbdoc(Back the CPU allocations of at least this many bytes, i.e. the arena regions and the initializer buffers, with huge pages when the OS provides them. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("arena_idle_shrink_ms", &SessionOptions::arena_idle_shrink_ms,
+                     R"pbdoc(Return the unused memory of the arenas to the system once no run was in progress for this many milliseconds. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("enable_scratch_allocator", &SessionOptions::enable_scratch_allocator,
+                     R"pbdoc(Allocate the temporary buffers of the CPU kernels from a per-run scratch buffer sized from the previous runs. Default is false.)pbdoc")
+      .def_readwrite("enable_cpu_bf16_gemm", &SessionOptions::enable_cpu_bf16_gemm,
+                     R"pbdoc(Pack the constant weights of float MatMul nodes on CPU as bfloat16. Default is false.)pbdoc")
+      .def_readwrite("enable_cpu_fp16_weights", &SessionOptions::enable_cpu_fp16_weights,
+                     R"pbdoc(Pack the constant weights of float MatMul and Gemm nodes on CPU as half precision and compute in float. Default is false.)pbdoc")
+      .def_readwrite("enable_cpu_gemm_autotuning", &SessionOptions::enable_cpu_gemm_autotuning,
+                     R"pbdoc(Time candidate block sizes and thread splits of float GEMMs on CPU for each new shape and use the fastest. Applies to the whole process once enabled. Default is false.)pbdoc")
+      .def_readwrite("cpu_gemm_autotuning_cache_path", &SessionOptions::cpu_gemm_autotuning_cache_path,
+                     R"pbdoc(File the autotuned GEMM parameters are read from and appended to. Default is empty (not persisted).)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
+      .def_readwrite("lightweight_profiling_sampling_interval", &SessionOptions::lightweight_profiling_sampling_interval,
+                     R"pbdoc(Record the per op kernel time of one in every this many runs with the lightweight profiler. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("runtime_profile_runs", &SessionOptions::runtime_profile_runs,
+                     R"pbdoc(Record the input shapes and node times of the first this many runs and re-plan the node order and the memory pattern cache from them. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("runtime_profile_path", &SessionOptions::runtime_profile_path,
+                     R"pbdoc(File the runtime profile is saved to, and applied from by later sessions. Default is empty (not persisted).)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
+      .def_readwrite("mem_pattern_shape_bucketing", &SessionOptions::mem_pattern_shape_bucketing,
+                     R"pbdoc(Round input dimensions up to the next power of two when looking up cached memory patterns. Default is false.)pbdoc")
+      .def_readwrite("mem_pattern_cache_capacity", &SessionOptions::mem_pattern_cache_capacity,
+                     R"pbdoc(Maximum number of cached memory patterns. Least recently used patterns are evicted. Default is 0 (unbounded).)pbdoc")
+      .def_readwrite("enable_memory_efficient_order", &SessionOptions::enable_memory_efficient_order,
+                     R"pbdoc(Order the nodes to reduce the peak memory of the intermediate tensors. Default is false.)pbdoc")
+      .def_readwrite("activation_offload_min_bytes", &SessionOptions::activation_offload_min_bytes,
+                     R"pbdoc(Offload long-lived CUDA activations of at least this many bytes to host memory. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("enable_static_shape_planning", &SessionOptions::enable_static_shape_planning,
+                     R"pbdoc(Compute the memory pattern during initialization when all graph inputs have fixed shapes. Default is false.)pbdoc")
+      .def_readwrite("enable_cuda_mixed_precision", &SessionOptions::enable_cuda_mixed_precision,
+                     R"pbdoc(Run MatMul, Gemm, Conv and Attention on the CUDA execution provider in float16. Default is false.)pbdoc")
+      .def_readwrite("enable_zipmap_tensor_outputs", &SessionOptions::enable_zipmap_tensor_outputs,
+                     R"pbdoc(Return the class scores of ZipMap graph outputs as a float tensor instead of a list of dictionaries. Default is false.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
                      R"pbdoc(Logger id to use for session output.)pbdoc")
       .def_readwrite("log_severity_level", &SessionOptions::session_log_severity_level,
@@ -580,8 +855,38 @@ Set this option to false if you don't want it. Default is True.)pbdoc")
 Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("intra_op_num_threads", &SessionOptions::intra_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution within nodes. Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_readwrite("intra_op_allow_spinning", &SessionOptions::intra_op_allow_spinning,
+                     R"pbdoc(Allow the threads used within nodes to spin looking for work before blocking. Default is true.)pbdoc")
+      .def_readwrite("intra_op_spin_duration_us", &SessionOptions::intra_op_spin_duration_us,
+                     R"pbdoc(Microseconds a thread waiting for work within a node to complete spins before blocking, and
+a thread that ran its part of the work spins for more before parking. Default is 0.)pbdoc")
+      .def_readwrite("intra_op_max_threads_by_priority", &SessionOptions::intra_op_max_threads_by_priority,
+                     R"pbdoc(The most threads, including the calling thread, a parallel loop within a node uses in the runs
+of each RunPriority, indexed by the priority. 0 means no limit. Default is [0, 0, 0].)pbdoc")
       .def_readwrite("inter_op_num_threads", &SessionOptions::inter_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_readwrite("intra_op_thread_affinity", &SessionOptions::intra_op_thread_affinity,
+                     R"pbdoc(Logical processor ids the threads used within nodes are restricted to. Default is no restriction.)pbdoc")
+      .def_readwrite("inter_op_thread_affinity", &SessionOptions::inter_op_thread_affinity,
+                     R"pbdoc(Logical processor ids the threads used across nodes are restricted to. Default is no restriction.)pbdoc")
+      .def_readwrite("numa_node", &SessionOptions::numa_node,
+                     R"pbdoc(Restrict the session threads to the processors of this NUMA node unless an explicit affinity is set. Default is -1 (no restriction).)pbdoc")
+      .def_readwrite("dynamic_batching_max_batch_size", &SessionOptions::dynamic_batching_max_batch_size,
+                     R"pbdoc(If greater than 1, concurrent runs are combined along the batch dimension into runs of up to this many rows. Default is 0 (disabled).)pbdoc")
+      .def_readwrite("dynamic_batching_timeout_us", &SessionOptions::dynamic_batching_timeout_us,
+                     R"pbdoc(Microseconds a run waits for other runs to join its batch. Default is 1000.)pbdoc")
+      .def_readwrite("use_mmap_model_load", &SessionOptions::use_mmap_model_load,
+                     R"pbdoc(Load the model through a memory mapping and use the data of CPU initializers in place. Default is false.)pbdoc")
+      .def_readwrite("share_initializers_across_sessions", &SessionOptions::share_initializers_across_sessions,
+                     R"pbdoc(Allocate identical constant CPU initializers once for all sessions that enable this. Default is false.)pbdoc")
+      .def_readwrite("defer_subgraph_initializers", &SessionOptions::defer_subgraph_initializers,
+                     R"pbdoc(Load the large initializers of control flow subgraphs when the subgraph first runs. Default is false.)pbdoc")
+      .def_readwrite("constant_folding_max_output_bytes", &SessionOptions::constant_folding_max_output_bytes,
+                     R"pbdoc(Constant folding skips nodes with an output larger than this many bytes. Default is 0 (no limit).)pbdoc")
+      .def_readwrite("enable_cost_based_partitioning", &SessionOptions::enable_cost_based_partitioning,
+                     R"pbdoc(Move small islands of device nodes back to CPU when the copies cost more than they save. Default is false.)pbdoc")
+      .def_readwrite("pyop_dedicated_thread", &SessionOptions::pyop_dedicated_thread,
+                     R"pbdoc(Run the PyOp nodes of the session on a dedicated Python thread. Default is false.)pbdoc")
       .def_readwrite("execution_mode", &SessionOptions::execution_mode,
                      R"pbdoc(Sets the execution mode. Default is sequential.)pbdoc")
       .def_property(
@@ -638,7 +943,13 @@ Applies to a particular Run() invocation. Default is 0.)pbdoc")
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("shrink_memory_arenas", &RunOptions::shrink_memory_arenas,
+                     R"pbdoc(Set to True to return the unused memory of the arenas of the session to the system at the
+end of the Run() calls that use this RunOptions instance. Default is False.)pbdoc")
+      .def_readwrite("priority", &RunOptions::priority,
+                     R"pbdoc(Priority of the Run() calls that use this RunOptions instance on the intra op thread pool.
+The pool threads stop helping the runs of a lower priority while a run is in a parallel loop. Default is NORMAL.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -710,20 +1021,180 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           },
           "node shape (assuming the node holds a tensor)");
 
+  py::class_<InferenceSession::PreparedRun>(m, "PreparedRun", R"pbdoc(Input and output names resolved once for repeated runs with the same names.)pbdoc")
+      .def_property_readonly("input_names", &InferenceSession::PreparedRun::GetFeedNames)
+      .def_property_readonly("output_names", &InferenceSession::PreparedRun::GetOutputNames);
+
+  py::class_<PyOrtValue>(m, "OrtValue", R"pbdoc(A value of onnxruntime, such as a tensor in CUDA memory.)pbdoc")
+      .def_static(
+          "from_cuda_array", [](py::object obj, int device_id) {
+            PyOrtValue value;
+            CreateTensorMLValueFromCudaArrayInterface("OrtValue", obj, device_id, &value.value, &value.readonly);
+            value.owner = obj;
+            return value;
+          },
+          py::arg("obj"), py::arg("device_id") = 0,
+          R"pbdoc(Create a tensor over the CUDA buffer of an object with a __cuda_array_interface__, such as a CuPy
+array or a PyTorch CUDA tensor, without copying it. The buffer must be on the CUDA device device_id.)pbdoc")
+      .def(
+          "device_name", [](const PyOrtValue* value) -> std::string {
+            return value->value.Get<Tensor>().Location().device.Type() == OrtDevice::GPU ? "cuda" : "cpu";
+          },
+          R"pbdoc(Device of the tensor, cpu or cuda.)pbdoc")
+      .def(
+          "shape", [](const PyOrtValue* value) {
+            return value->value.Get<Tensor>().Shape().GetDimsAsVector();
+          },
+          R"pbdoc(Shape of the tensor.)pbdoc")
+      .def(
+          "data_ptr", [](const PyOrtValue* value) {
+            return reinterpret_cast<uintptr_t>(value->value.Get<Tensor>().DataRaw());
+          },
+          R"pbdoc(Address of the data of the tensor.)pbdoc")
+      .def(
+          "numpy", [](PyOrtValue* value) -> py::object {
+            if (value->value.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+              throw std::runtime_error("Only tensors in CPU memory can be converted to numpy arrays.");
+            }
+            std::vector<py::object> result;
+            AddTensorAsPyObj(value->value, result);
+            return result[0];
+          },
+          R"pbdoc(Numpy array of a tensor in CPU memory.)pbdoc")
+      .def_property_readonly(
+          "__cuda_array_interface__", [](const PyOrtValue* value) {
+            return GetCudaArrayInterface(value->value.Get<Tensor>());
+          },
+          R"pbdoc(Describes a tensor in CUDA memory to CuPy, PyTorch, Numba and other consumers of the interface, which
+use it without copying.)pbdoc");
+
+  py::class_<SessionIOBinding>(m, "SessionIOBinding", R"pbdoc(Inputs and outputs bound to a session for runs with run_with_iobinding.)pbdoc")
+      .def(py::init<InferenceSession*>(), py::keep_alive<1, 2>())
+      .def(
+          "bind_input", [](SessionIOBinding* io_binding, const std::string& name, py::object value) {
+            OrtValue ml_value = py::isinstance<PyOrtValue>(value) ? value.cast<PyOrtValue&>().value
+                                                                  : CreateFeed(io_binding->session, name, value);
+            OrtPybindThrowIfError(io_binding->binding->BindInput(name, ml_value));
+            io_binding->inputs[name] = value;
+          },
+          R"pbdoc(Bind an input to a value or an OrtValue. The input is converted or copied to the device of the node
+using it now, so the value is not read again by the runs. An OrtValue already on that device is used without copying.)pbdoc")
+      .def(
+          "bind_output", [](SessionIOBinding* io_binding, const std::string& name, py::object array) {
+            OrtValue ml_value;
+            if (py::isinstance<PyOrtValue>(array)) {
+              const auto& value = array.cast<PyOrtValue&>();
+              if (value.readonly) {
+                throw std::runtime_error("The OrtValue bound to output '" + name + "' is read-only.");
+              }
+              ml_value = value.value;
+            } else if (!array.is_none()) {
+              CreateTensorMLValueOverArray(GetAllocator(), name, array, &ml_value);
+            }
+            OrtPybindThrowIfError(io_binding->binding->BindOutput(name, ml_value));
+            io_binding->output_devices.erase(name);
+            if (array.is_none()) {
+              io_binding->output_arrays.erase(name);
+            } else {
+              io_binding->output_arrays[name] = array;
+            }
+          },
+          py::arg("name"), py::arg("array") = py::none(),
+          R"pbdoc(Bind an output. If a numpy array or an OrtValue is given, the runs write the output into it, so its
+shape and type must match the output. Otherwise each run allocates the output on CPU.)pbdoc")
+      .def(
+          "bind_output_to_device", [](SessionIOBinding* io_binding, const std::string& name, const std::string& device_type, int device_id) {
+            io_binding->BindOutputToDevice(name, device_type, device_id);
+          },
+          R"pbdoc(Bind an output to a device, 'cpu' or 'cuda', without preallocating it. get_outputs returns the output
+as an OrtValue on that device, which is overwritten by the next run.)pbdoc")
+      .def(
+          "synchronize_inputs", [](SessionIOBinding* io_binding) {
+            OrtPybindThrowIfError(io_binding->binding->SynchronizeInputs());
+          },
+          R"pbdoc(Wait for the copies of the bound inputs to their devices.)pbdoc")
+      .def(
+          "synchronize_outputs", [](SessionIOBinding* io_binding) {
+            py::gil_scoped_release release;
+            OrtPybindThrowIfError(io_binding->binding->SynchronizeOutputs());
+          },
+          R"pbdoc(Wait for the outputs of the last run on their devices.)pbdoc")
+      .def(
+          "get_outputs", [](SessionIOBinding* io_binding) -> std::vector<py::object> {
+            const auto& names = io_binding->binding->GetOutputNames();
+            auto& outputs = io_binding->binding->GetOutputs();
+            std::vector<py::object> result;
+            result.reserve(names.size());
+            for (size_t i = 0; i < names.size(); ++i) {
+              auto it = io_binding->output_arrays.find(names[i]);
+              if (it != io_binding->output_arrays.end()) {
+                result.push_back(it->second);
+              } else if (!outputs[i].IsAllocated()) {
+                result.push_back(py::none());
+              } else if (outputs[i].IsTensor() &&
+                         outputs[i].Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+                PyOrtValue value;
+                value.value = outputs[i];
+                result.push_back(py::cast(std::move(value)));
+              } else if (outputs[i].IsTensor()) {
+                AddTensorAsPyObj(outputs[i], result);
+              } else {
+                AddNonTensorAsPyObj(outputs[i], result);
+              }
+            }
+            return result;
+          },
+          R"pbdoc(The outputs of the last run, in the order they were bound. Outputs bound to an array or an OrtValue return
+it, outputs on a device other than CPU are returned as OrtValues.)pbdoc")
+      .def(
+          "clear_binding_inputs", [](SessionIOBinding* io_binding) {
+            auto& previous = *io_binding->binding;
+            std::unique_ptr<IOBinding> binding;
+            OrtPybindThrowIfError(io_binding->session->NewIOBinding(&binding));
+            const auto& names = previous.GetOutputNames();
+            const auto& outputs = previous.GetOutputs();
+            for (size_t i = 0; i < names.size(); ++i) {
+              auto it = io_binding->output_devices.find(names[i]);
+              OrtPybindThrowIfError(it != io_binding->output_devices.end() ? binding->BindOutput(names[i], it->second)
+                                                                           : binding->BindOutput(names[i], outputs[i]));
+            }
+            io_binding->binding = std::move(binding);
+            io_binding->inputs.clear();
+          })
+      .def("clear_binding_outputs", [](SessionIOBinding* io_binding) {
+        auto& previous = *io_binding->binding;
+        std::unique_ptr<IOBinding> binding;
+        OrtPybindThrowIfError(io_binding->session->NewIOBinding(&binding));
+        const auto& names = previous.GetInputNames();
+        const auto& inputs = previous.GetInputs();
+        for (size_t i = 0; i < names.size(); ++i) {
+          OrtPybindThrowIfError(binding->BindInput(names[i], inputs[i]));
+        }
+        io_binding->binding = std::move(binding);
+        io_binding->output_arrays.clear();
+        io_binding->output_devices.clear();
+      });
+
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
   py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       // In Python3, a Python bytes object will be passed to C++ functions that accept std::string or char*
       // without any conversion. So this init method can be used for model file path (string)
       // and model content (bytes)
       .def(py::init([](const SessionOptions& so, const std::string& arg, bool is_arg_file_name) {
-        // Given arg is the file path. Invoke the corresponding ctor().
+        std::unique_ptr<InferenceSession> sess;
         if (is_arg_file_name) {
-          return onnxruntime::make_unique<InferenceSession>(so, arg, SessionObjectInitializer::Get());
+          // Given arg is the file path. Invoke the corresponding ctor().
+          sess = onnxruntime::make_unique<InferenceSession>(so, arg, SessionObjectInitializer::Get());
+        } else {
+          // Given arg is the model content as bytes. Invoke the corresponding ctor().
+          std::istringstream buffer(arg);
+          sess = onnxruntime::make_unique<InferenceSession>(so, buffer, SessionObjectInitializer::Get());
         }
 
-        // Given arg is the model content as bytes. Invoke the corresponding ctor().
-        std::istringstream buffer(arg);
-        return onnxruntime::make_unique<InferenceSession>(so, buffer, SessionObjectInitializer::Get());
+        if (so.share_initializers_across_sessions) {
+          OrtPybindThrowIfError(sess->SetSharedInitializerStore(GetEnv()->GetSharedInitializerStore()));
+        }
+        return sess;
       }))
       .def(
           "load_model", [](InferenceSession* sess, std::vector<std::string>& provider_types) {
@@ -734,26 +1205,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       .def("run", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
         NameMLValMap feeds;
         for (auto _ : pyfeeds) {
-          OrtValue ml_value;
-          auto px = sess->GetModelInputs();
-          if (!px.first.IsOK() || !px.second) {
-            throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-          }
-          CreateGenericMLValue(px.second, GetAllocator(), _.first, _.second, &ml_value);
-          if (PyErr_Occurred()) {
-            PyObject *ptype, *pvalue, *ptraceback;
-            PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-            PyObject* pStr = PyObject_Str(ptype);
-            std::string sType = py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            pStr = PyObject_Str(pvalue);
-            sType += ": ";
-            sType += py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            throw std::runtime_error(sType);
-          }
-          feeds.insert(std::make_pair(_.first, ml_value));
+          feeds.insert(std::make_pair(_.first, CreateFeed(sess, _.first, _.second)));
         }
 
         std::vector<OrtValue> fetches;
@@ -769,20 +1221,146 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           }
         }
 
-        std::vector<py::object> rfetch;
-        rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
-          if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
+        return FetchesToPyObjs(fetches);
+      })
+      .def(
+          "prepare_run", [](InferenceSession* sess, std::vector<std::string> output_names, std::vector<std::string> input_names) {
+            std::unique_ptr<InferenceSession::PreparedRun> prepared_run;
+            OrtPybindThrowIfError(sess->PrepareRun(input_names, output_names, prepared_run));
+            return prepared_run;
+          },
+          py::keep_alive<0, 1>())
+      .def("run_prepared", [](InferenceSession* sess, InferenceSession::PreparedRun* prepared_run, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
+        const auto& feed_names = prepared_run->GetFeedNames();
+        std::vector<OrtValue> feeds;
+        feeds.reserve(feed_names.size());
+        for (const auto& name : feed_names) {
+          auto it = pyfeeds.find(name);
+          if (it == pyfeeds.end()) {
+            throw std::runtime_error("Missing feed for input " + name + " of the prepared run");
+          }
+          feeds.push_back(CreateFeed(sess, name, it->second));
+        }
+
+        std::vector<OrtValue> fetches;
+
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            OrtPybindThrowIfError(sess->Run(*run_options, *prepared_run, feeds, &fetches));
           } else {
-            AddNonTensorAsPyObj(_, rfetch);
+            OrtPybindThrowIfError(sess->Run(RunOptions(), *prepared_run, feeds, &fetches));
+          }
+        }
+
+        return FetchesToPyObjs(fetches);
+      })
+      .def(
+          "run_async", [](py::object self, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, py::object callback, py::object run_options) {
+            InferenceSession* sess = self.cast<InferenceSession*>();
+            auto run = std::make_shared<AsyncRun>();
+            for (auto& _ : pyfeeds) {
+              run->feeds.insert(std::make_pair(_.first, CreateFeed(sess, _.first, _.second)));
+            }
+            run->session = std::move(self);
+            run->callback = std::move(callback);
+            run->pyfeeds = std::move(pyfeeds);
+            run->output_names = std::move(output_names);
+            if (run_options.is_none()) {
+              run->default_run_options = onnxruntime::make_unique<RunOptions>();
+              run->run_options = run->default_run_options.get();
+            } else {
+              run->run_options = &run_options.cast<const RunOptions&>();
+              run->run_options_obj = std::move(run_options);
+            }
+
+            std::thread([run, sess]() {
+              std::vector<OrtValue> fetches;
+              common::Status status;
+              try {
+                status = sess->Run(*run->run_options, run->feeds, run->output_names, &fetches);
+              } catch (const std::exception& e) {
+                status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, e.what());
+              }
+
+              py::gil_scoped_acquire acquire;
+              try {
+                if (status.IsOK()) {
+                  run->callback(FetchesToPyObjs(fetches), py::none());
+                } else {
+                  run->callback(py::none(), StatusToPyException(status));
+                }
+              } catch (py::error_already_set& e) {
+                // there is no caller to raise to
+                e.restore();
+                PyErr_Print();
+              }
+              fetches.clear();
+              run->feeds.clear();
+              run->pyfeeds.clear();
+              run->callback = py::object();
+              run->run_options_obj = py::object();
+              run->session = py::object();
+            }).detach();
+          },
+          R"pbdoc(Start a run on a new thread and return. callback(outputs, error) is called from that thread with the
+outputs, or with None and the exception of the run if it failed.)pbdoc")
+      .def("run_with_iobinding", [](InferenceSession* sess, SessionIOBinding& io_binding, RunOptions* run_options = nullptr) {
+        if (io_binding.session != sess) {
+          throw std::runtime_error("The IO binding was created for another session");
+        }
+        IOBinding& binding = *io_binding.binding;
+        const auto& names = binding.GetOutputNames();
+        auto& outputs = binding.GetOutputs();
+        for (size_t i = 0; i < names.size(); ++i) {
+          // outputs of the previous run may be referenced by the numpy arrays it returned, so they are not reused
+          if (io_binding.output_arrays.find(names[i]) == io_binding.output_arrays.end()) {
+            outputs[i] = OrtValue();
+          }
+        }
+
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            OrtPybindThrowIfError(sess->Run(*run_options, binding));
+          } else {
+            OrtPybindThrowIfError(sess->Run(RunOptions(), binding));
           }
         }
-        return rfetch;
       })
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
+      .def("get_op_statistics", [](InferenceSession* sess) -> py::dict {
+        return OpStatisticsToPyDict(sess->GetOpStatistics());
+      })
+      .def("get_node_statistics", [](InferenceSession* sess) -> py::dict {
+        return OpStatisticsToPyDict(sess->GetNodeStatistics());
+      })
+      .def("shrink_memory_arenas", [](InferenceSession* sess) {
+        OrtPybindThrowIfError(sess->ShrinkMemoryArenas());
+      })
+      .def("get_allocator_statistics", [](const InferenceSession* sess) -> py::list {
+        py::list result;
+        for (const auto& entry : sess->GetAllocatorStats()) {
+          py::dict stats;
+          stats["name"] = std::string(entry.first.name);
+          stats["id"] = entry.first.id;
+          stats["num_allocs"] = entry.second.num_allocs;
+          stats["bytes_in_use"] = entry.second.bytes_in_use;
+          stats["max_bytes_in_use"] = entry.second.max_bytes_in_use;
+          stats["total_allocated_bytes"] = entry.second.total_allocated_bytes;
+          stats["max_alloc_size"] = entry.second.max_alloc_size;
+          stats["bytes_limit"] = entry.second.bytes_limit;
+          result.append(stats);
+        }
+        return result;
+      })
+      .def("get_peak_activation_bytes", [](const InferenceSession* sess) -> int64_t {
+        return sess->GetPeakActivationBytes();
+      })
       .def("get_providers", [](InferenceSession* sess) -> const std::vector<std::string>& {
         return sess->GetRegisteredProviderTypes();
       })
@@ -809,6 +1387,77 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         OrtPybindThrowIfError(res.first);
         return *(res.second);
       });
+
+  py::class_<ReplicatedSession>(m, "ReplicatedSession", R"pbdoc(A model replicated on several CUDA devices that runs as a single session.)pbdoc")
+      .def(py::init([](const SessionOptions& so, const std::string& arg, bool is_arg_file_name, const std::vector<int>& device_ids) -> std::unique_ptr<ReplicatedSession> {
+#ifdef USE_CUDA
+        std::string model_data;
+        if (is_arg_file_name) {
+          std::ifstream model_file(arg, std::ios::in | std::ios::binary);
+          if (!model_file) {
+            throw std::runtime_error("Failed to open model file " + arg);
+          }
+          model_data.assign(std::istreambuf_iterator<char>(model_file), std::istreambuf_iterator<char>());
+        } else {
+          model_data = arg;
+        }
+
+        std::unique_ptr<ReplicatedSession> sess;
+        OrtPybindThrowIfError(ReplicatedSession::Create(
+            so, model_data.data(), static_cast<int>(model_data.size()), device_ids.size(),
+            [&device_ids](size_t replica, InferenceSession& replica_sess) {
+              RegisterExecutionProvider(&replica_sess, *onnxruntime::CreateExecutionProviderFactory_CUDA(device_ids[replica], cuda_mem_limit,
+                                                                                                       cuda_arena_extend_strategy,
+                                                                                                       cudnn_conv_algo_cache_file,
+                                                                                                       cudnn_conv_use_heuristic,
+                                                                                                       cudnn_rnn_persist_max_batch_size,
+                                                                                                       cuda_graph_enabled,
+                                                                                                       cuda_branch_stream_count));
+              RegisterExecutionProviders(&replica_sess, {kCpuExecutionProvider});
+              return Status::OK();
+            },
+            GetEnv()->GetSharedInitializerStore(), SessionObjectInitializer::Get(), sess));
+        return sess;
+#else
+        ORT_UNUSED_PARAMETER(so);
+        ORT_UNUSED_PARAMETER(arg);
+        ORT_UNUSED_PARAMETER(is_arg_file_name);
+        ORT_UNUSED_PARAMETER(device_ids);
+        throw std::runtime_error("ReplicatedSession requires a build with the CUDA execution provider.");
+#endif
+      }))
+      .def("run", [](ReplicatedSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
+        std::vector<std::string> feed_names;
+        std::vector<OrtValue> feeds;
+        feed_names.reserve(pyfeeds.size());
+        feeds.reserve(pyfeeds.size());
+        for (auto _ : pyfeeds) {
+          feed_names.push_back(_.first);
+          feeds.push_back(CreateFeed(sess->GetSession(0), _.first, _.second));
+        }
+
+        std::vector<OrtValue> fetches;
+        RunOptions default_run_options;
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel, which spreads them over the replicas.
+          py::gil_scoped_release release;
+          OrtPybindThrowIfError(sess->Run(run_options != nullptr ? *run_options : default_run_options, feed_names, feeds, output_names, &fetches));
+        }
+
+        return FetchesToPyObjs(fetches);
+      })
+      .def("get_run_counts", &ReplicatedSession::GetRunCounts, R"pbdoc(Number of runs dispatched to each replica.)pbdoc")
+      .def_property_readonly("num_replicas", &ReplicatedSession::NumReplicas)
+      .def_property_readonly("inputs_meta", [](const ReplicatedSession* sess) -> const std::vector<const onnxruntime::NodeArg*>& {
+        auto res = sess->GetSession(0)->GetModelInputs();
+        OrtPybindThrowIfError(res.first);
+        return *(res.second);
+      })
+      .def_property_readonly("outputs_meta", [](const ReplicatedSession* sess) -> const std::vector<const onnxruntime::NodeArg*>& {
+        auto res = sess->GetSession(0)->GetModelOutputs();
+        OrtPybindThrowIfError(res.first);
+        return *(res.second);
+      });
 }
 
 #ifdef USE_MIMALLOC
@@ -874,8 +1523,7 @@ PYBIND11_MODULE(onnxruntime_pybind11_state, m) {
       import_array1();
     })();
 
-    static std::unique_ptr<Environment> env;
-    OrtPybindThrowIfError(Environment::Create(env));
+    OrtPybindThrowIfError(Environment::Create(GetEnv()));
 
     static bool initialized = false;
     if (initialized) {
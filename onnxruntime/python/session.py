@@ -152,6 +152,83 @@ class InferenceSession:
                 raise
 
 
+    def run_async(self, output_names, input_feed, run_options=None, loop=None):
+        """
+        Compute the predictions on a thread of onnxruntime and return an :class:`asyncio.Future` for them.
+        The Python interpreter is not locked while the model runs, so a service can await many runs
+        of a session at the same time.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param loop: event loop the future belongs to, the current event loop if None
+
+        ::
+
+            outputs = await sess.run_async([output_name], {input_name: x})
+        """
+        import asyncio
+        if loop is None:
+            loop = asyncio.get_event_loop()
+        future = loop.create_future()
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+
+        def complete(outputs, error):
+            if future.cancelled():
+                return
+            if error is not None:
+                future.set_exception(error)
+            else:
+                future.set_result(outputs)
+
+        def callback(outputs, error):
+            # called from the thread of the run
+            loop.call_soon_threadsafe(complete, outputs, error)
+
+        self._sess.run_async(output_names, input_feed, callback, run_options)
+        return future
+
+    def prepare_run(self, output_names=None, input_names=None):
+        """
+        Resolve the input and output names once for repeated calls to :meth:`run_prepared`.
+
+        :param output_names: name of the outputs, all the outputs if None
+        :param input_names: name of the inputs that will be fed, all the inputs if None
+        """
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        if input_names is None:
+            input_names = [i.name for i in self._inputs_meta]
+        return self._sess.prepare_run(output_names, input_names)
+
+    def run_prepared(self, prepared_run, input_feed, run_options=None):
+        """
+        Compute the predictions for the inputs and outputs of a run prepared by :meth:`prepare_run`.
+        Runs with the same prepared run are serialized, so use one per thread to run concurrently.
+
+        :param prepared_run: the result of :meth:`prepare_run`
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        return self._sess.run_prepared(prepared_run, input_feed, run_options)
+
+    def io_binding(self):
+        """
+        Return a new :class:`IOBinding` of the session, to run with inputs and outputs bound once.
+        """
+        return IOBinding(self)
+
+    def run_with_iobinding(self, iobinding, run_options=None):
+        """
+        Compute the predictions for the inputs and outputs of an IO binding. Outputs bound to a numpy array
+        are written into it, the others are returned by :meth:`IOBinding.get_outputs`.
+
+        :param iobinding: the result of :meth:`io_binding`
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        self._sess.run_with_iobinding(iobinding._iobinding, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -160,3 +237,174 @@ class InferenceSession:
         :meth:`onnxruntime.SessionOptions.enable_profiling`.
         """
         return self._sess.end_profiling()
+
+    def get_op_statistics(self):
+        """
+        Return the statistics of the runs sampled by the lightweight profiler, keyed by op type.
+        Each value is a dictionary with count, total_ns, min_ns, max_ns, p50_ns, p99_ns, output_bytes,
+        parallel_for_calls and thread_pool_utilization. Nothing is written to a file.
+        The profiler is enabled by :meth:`onnxruntime.SessionOptions.lightweight_profiling_sampling_interval`.
+        """
+        return self._sess.get_op_statistics()
+
+    def get_node_statistics(self):
+        """
+        Same as :meth:`get_op_statistics`, keyed by node name.
+        """
+        return self._sess.get_node_statistics()
+
+    def get_allocator_statistics(self):
+        """
+        Return the memory statistics of each arena allocator of the session as a list of dictionaries
+        with the allocator name and id, num_allocs, bytes_in_use, max_bytes_in_use, total_allocated_bytes,
+        max_alloc_size and bytes_limit.
+        """
+        return self._sess.get_allocator_statistics()
+
+    def get_peak_activation_bytes(self):
+        """
+        Return the largest number of bytes the intermediate and output tensors of a single run of the session
+        used at once. Output buffers provided by the caller are not counted.
+        """
+        return self._sess.get_peak_activation_bytes()
+
+    def shrink_memory_arenas(self):
+        """
+        Return the memory the arenas of the session hold but don't use to the system, e.g. after a spike of
+        large inputs. Runs in progress keep the memory they use.
+        """
+        self._sess.shrink_memory_arenas()
+
+
+class ReplicatedSession:
+    """
+    A model replicated on several CUDA devices that runs as a single session.
+    Each run goes to the replica with the fewest runs in progress, so concurrent calls to :meth:`run`
+    from several threads use all the devices. The model is parsed once and the constant CPU initializers
+    are shared by the replicas.
+    """
+    def __init__(self, path_or_bytes, device_ids, sess_options=None):
+        """
+        :param path_or_bytes: filename or serialized model in a byte string
+        :param device_ids: the CUDA devices to create a replica on, one replica per device
+        :param sess_options: session options of every replica
+        """
+        if isinstance(path_or_bytes, str):
+            is_file_name = True
+        elif isinstance(path_or_bytes, bytes):
+            is_file_name = False
+        else:
+            raise TypeError("Unable to load from type '{0}'".format(type(path_or_bytes)))
+
+        self._sess = C.ReplicatedSession(
+            sess_options if sess_options else C.get_default_session_options(),
+            path_or_bytes, is_file_name, list(device_ids))
+        self._inputs_meta = self._sess.inputs_meta
+        self._outputs_meta = self._sess.outputs_meta
+
+    def get_inputs(self):
+        "Return the inputs metadata as a list of :class:`onnxruntime.NodeArg`."
+        return self._inputs_meta
+
+    def get_outputs(self):
+        "Return the outputs metadata as a list of :class:`onnxruntime.NodeArg`."
+        return self._outputs_meta
+
+    def get_run_counts(self):
+        "Return the number of runs dispatched to each replica."
+        return self._sess.get_run_counts()
+
+    def run(self, output_names, input_feed, run_options=None):
+        """
+        Compute the predictions on the least loaded replica. The outputs are returned on CPU.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run(output_names, input_feed, run_options)
+
+
+class IOBinding:
+    """
+    Inputs and outputs bound to a session. The buffers of numpy arrays bound to outputs are used by the runs
+    without copying, so repeated runs don't allocate the outputs.
+
+    ::
+
+        binding = sess.io_binding()
+        binding.bind_input('X', x)
+        binding.bind_output('Y', y)  # y is a preallocated numpy array
+        sess.run_with_iobinding(binding)
+    """
+    def __init__(self, session):
+        self._iobinding = C.SessionIOBinding(session._sess)
+
+    @staticmethod
+    def _as_ortvalue(value):
+        # CUDA arrays of other libraries are used without copying them to the host
+        if hasattr(value, '__cuda_array_interface__') and not isinstance(value, C.OrtValue):
+            device = getattr(value, 'device', None)
+            # PyTorch devices have an index, CuPy devices an id
+            device_id = getattr(device, 'index', None)
+            if device_id is None:
+                device_id = getattr(device, 'id', 0)
+            return C.OrtValue.from_cuda_array(value, device_id)
+        return value
+
+    def bind_input(self, name, value):
+        """
+        :param name: input name
+        :param value: input value, copied when bound unless it's an :class:`onnxruntime.OrtValue` or an object
+            with a ``__cuda_array_interface__`` (a CuPy array, a PyTorch CUDA tensor, ...) on the device of the
+            node using it.
+        """
+        self._iobinding.bind_input(name, self._as_ortvalue(value))
+
+    def bind_output(self, name, array=None):
+        """
+        :param name: output name
+        :param array: C-contiguous numpy array, :class:`onnxruntime.OrtValue` or object with a
+            ``__cuda_array_interface__``, with the shape and type of the output the runs write to, or None
+            to allocate the output on CPU in each run.
+        """
+        self._iobinding.bind_output(name, self._as_ortvalue(array))
+
+    def bind_output_to_device(self, name, device_type, device_id=0):
+        """
+        Bind an output to a device without preallocating it. :meth:`get_outputs` returns it as an
+        :class:`onnxruntime.OrtValue` on that device, which is overwritten by the next run.
+
+        :param name: output name
+        :param device_type: 'cpu' or 'cuda'
+        :param device_id: device id
+        """
+        self._iobinding.bind_output_to_device(name, device_type, device_id)
+
+    def synchronize_inputs(self):
+        self._iobinding.synchronize_inputs()
+
+    def synchronize_outputs(self):
+        """
+        Wait for the outputs of the last run on their devices. Call it before reading outputs on a device other
+        than CPU from another library.
+        """
+        self._iobinding.synchronize_outputs()
+
+    def get_outputs(self):
+        """
+        Return the outputs of the last run in the order they were bound.
+        """
+        return self._iobinding.get_outputs()
+
+    def clear_binding_inputs(self):
+        self._iobinding.clear_binding_inputs()
+
+    def clear_binding_outputs(self):
+        self._iobinding.clear_binding_outputs()
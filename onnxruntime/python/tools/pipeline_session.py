@@ -0,0 +1,261 @@
+#-------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+#--------------------------------------------------------------------------
+
+# Split a model into pipeline stages and run the stages on different devices.
+#
+# A model that doesn't fit one device is split into stage models at node boundaries. The values that cross a
+# boundary become outputs of the stage that produces them and inputs of the stages that use them. PipelineSession
+# runs every stage in its own session, on its own device and thread, so while a stage runs a request the previous
+# stage already runs the next one:
+#
+#   onnxruntime_split_pipeline model.onnx stage --num_stages 2
+#
+#   stages = split_model(onnx.load('model.onnx'), num_stages=2)
+#   with PipelineSession(stages, device_ids=[0, 1]) as pipeline:
+#       futures = [pipeline.submit(None, feeds) for feeds in requests]
+#       results = [f.result() for f in futures]
+#
+# Values that cross a boundary are copied through host memory.
+
+import argparse
+import json
+import queue
+import sys
+import threading
+from concurrent.futures import Future
+
+import onnx
+from onnx import helper, shape_inference
+import onnxruntime as onnxrt
+from onnxruntime.capi import _pybind_state as C
+
+# metadata of the stage models holding the outputs of the model they were split from, as a JSON list
+PIPELINE_OUTPUTS_KEY = 'pipeline_outputs'
+
+
+def _node_inputs(node):
+    '''
+    Names of the values a node uses, including the outer scope values used by its subgraphs.
+    '''
+    names = [name for name in node.input if name]
+    for attribute in node.attribute:
+        graphs = list(attribute.graphs)
+        if attribute.HasField('g'):
+            graphs.append(attribute.g)
+        for graph in graphs:
+            local = set(i.name for i in graph.input) | set(i.name for i in graph.initializer)
+            for subgraph_node in graph.node:
+                names.extend(name for name in _node_inputs(subgraph_node) if name not in local)
+                local.update(subgraph_node.output)
+    return names
+
+
+def _initializer_bytes(initializer):
+    if initializer.HasField('raw_data'):
+        return len(initializer.raw_data)
+    return initializer.ByteSize()
+
+
+def balanced_boundaries(model, num_stages):
+    '''
+    Indices of the first node of every stage but the first, so the stages hold about the same initializer bytes.
+    '''
+    if num_stages < 1:
+        raise ValueError('num_stages must be at least 1')
+    graph = model.graph
+    sizes = {i.name: _initializer_bytes(i) for i in graph.initializer}
+    node_bytes = []
+    seen = set()
+    for node in graph.node:
+        used = [name for name in _node_inputs(node) if name in sizes and name not in seen]
+        seen.update(used)
+        node_bytes.append(sum(sizes[name] for name in used))
+
+    total = sum(node_bytes)
+    boundaries = []
+    accumulated = 0
+    for index, size in enumerate(node_bytes):
+        # cut before the node that takes the stage over its share
+        if len(boundaries) < num_stages - 1 and index > 0 and accumulated + size > total * (len(boundaries) + 1) / num_stages:
+            boundaries.append(index)
+        accumulated += size
+    if len(boundaries) != num_stages - 1:
+        raise ValueError('the model has too few nodes for {} stages'.format(num_stages))
+    return boundaries
+
+
+def split_model(model, boundaries=None, num_stages=None):
+    '''
+    Split a model into stage models. boundaries are the indices, in the topological order of the graph, of the first
+    node of every stage but the first. If they are not given the model is split in num_stages stages holding about
+    the same initializer bytes.
+    The stages get the initializers they use. A stage's inputs are the graph inputs and the values of earlier stages
+    it uses, and its outputs the graph outputs and the values later stages use that it produces.
+    '''
+    if boundaries is None:
+        boundaries = balanced_boundaries(model, num_stages if num_stages is not None else 2)
+    graph = model.graph
+    boundaries = [0] + list(boundaries) + [len(graph.node)]
+    if any(begin >= end for begin, end in zip(boundaries, boundaries[1:])):
+        raise ValueError('boundaries must be increasing node indices between 1 and {}'.format(len(graph.node) - 1))
+
+    # types of the values that cross the boundaries
+    inferred = shape_inference.infer_shapes(model).graph
+    value_infos = {}
+    for value_info in list(inferred.value_info) + list(graph.input) + list(graph.output):
+        value_infos[value_info.name] = value_info
+    initializers = {i.name: i for i in graph.initializer}
+    graph_inputs = [i.name for i in graph.input if i.name not in initializers]
+    graph_outputs = [o.name for o in graph.output]
+
+    stage_nodes = [graph.node[begin:end] for begin, end in zip(boundaries, boundaries[1:])]
+    stage_uses = [set(name for node in nodes for name in _node_inputs(node)) for nodes in stage_nodes]
+    stages = []
+    for index, nodes in enumerate(stage_nodes):
+        produced = set(name for node in nodes for name in node.output if name)
+        used_later = set(graph_outputs).union(*stage_uses[index + 1:])
+        inputs = [name for name in graph_inputs if name in stage_uses[index]]
+        inputs += sorted(name for name in stage_uses[index]
+                         if name not in produced and name not in initializers and name not in graph_inputs)
+        outputs = [name for name in graph_outputs if name in produced]
+        outputs += sorted(name for name in produced if name in used_later and name not in graph_outputs)
+        missing = [name for name in inputs + outputs if name not in value_infos]
+        if missing:
+            raise ValueError('the type of {} is unknown. Split the model at other nodes.'.format(', '.join(missing)))
+
+        stage_graph = helper.make_graph(nodes, '{}_stage{}'.format(graph.name, index),
+                                        [value_infos[name] for name in inputs],
+                                        [value_infos[name] for name in outputs],
+                                        [initializers[name] for name in sorted(stage_uses[index]) if name in initializers])
+        stage = helper.make_model(stage_graph, producer_name=model.producer_name, opset_imports=model.opset_import)
+        stage.ir_version = model.ir_version
+        helper.set_model_props(stage, {PIPELINE_OUTPUTS_KEY: json.dumps(graph_outputs)})
+        stages.append(stage)
+    return stages
+
+
+class PipelineSession:
+    '''
+    Runs the stages of a split model as a pipeline. Each stage has its own session and a thread that runs the
+    requests in the order they were submitted, and passes their values to the next stage.
+    '''
+    def __init__(self, stages, device_ids=None, sess_options=None, providers=None, queue_size=4):
+        '''
+        :param stages: stage models, as ModelProto, serialized models or paths, e.g. from split_model
+        :param device_ids: CUDA device of every stage. Ignored if ORT is built without CUDA.
+        :param sess_options: session options of all the stages
+        :param providers: execution providers of all the stages. If empty, all the available providers are used.
+        :param queue_size: maximum number of requests waiting for each stage
+        '''
+        if device_ids is not None and len(device_ids) != len(stages):
+            raise ValueError('device_ids must have one entry per stage')
+        self._sessions = []
+        for index, stage in enumerate(stages):
+            if device_ids is not None and hasattr(C, 'set_cuda_device_id'):
+                C.set_cuda_device_id(device_ids[index])
+            if isinstance(stage, onnx.ModelProto):
+                stage = stage.SerializeToString()
+            self._sessions.append(onnxrt.InferenceSession(stage, sess_options, providers or []))
+        if device_ids is not None and hasattr(C, 'set_cuda_device_id'):
+            C.set_cuda_device_id(0)
+
+        # the outputs of the split model, which can be produced by any stage
+        metadata = self._sessions[-1].get_modelmeta().custom_metadata_map
+        if PIPELINE_OUTPUTS_KEY in metadata:
+            self._output_names = json.loads(metadata[PIPELINE_OUTPUTS_KEY])
+        else:
+            self._output_names = [o.name for o in self._sessions[-1].get_outputs()]
+        self._queues = [queue.Queue(queue_size) for _ in self._sessions]
+        self._threads = [threading.Thread(target=self._run_stage, args=(index,), daemon=True)
+                         for index in range(len(self._sessions))]
+        for thread in self._threads:
+            thread.start()
+
+    def _run_stage(self, index):
+        session = self._sessions[index]
+        input_names = [i.name for i in session.get_inputs()]
+        output_names = [o.name for o in session.get_outputs()]
+        last = index == len(self._sessions) - 1
+        while True:
+            request = self._queues[index].get()
+            if request is None:
+                if not last:
+                    self._queues[index + 1].put(None)
+                return
+            values, requested, future = request
+            if future.done():
+                # failed in an earlier stage
+                continue
+            try:
+                results = session.run(output_names, {name: values[name] for name in input_names})
+                values.update(zip(output_names, results))
+            except Exception as e:
+                future.set_exception(e)
+                continue
+            if last:
+                future.set_result([values[name] for name in requested])
+            else:
+                self._queues[index + 1].put(request)
+
+    def get_output_names(self):
+        "Return the names of the outputs of the model."
+        return list(self._output_names)
+
+    def submit(self, output_names, input_feed):
+        '''
+        Queue a request and return a Future of its outputs. Blocks while the first stage has queue_size requests
+        waiting.
+
+        :param output_names: names of the outputs. If None, all the outputs of the model.
+        :param input_feed: dictionary of the input names and values
+        '''
+        future = Future()
+        requested = list(output_names) if output_names else self._output_names
+        self._queues[0].put((dict(input_feed), requested, future))
+        return future
+
+    def run(self, output_names, input_feed):
+        "Run one request through the pipeline and return its outputs."
+        return self.submit(output_names, input_feed).result()
+
+    def close(self):
+        "Complete the submitted requests and stop the stage threads."
+        if self._threads:
+            self._queues[0].put(None)
+            for thread in self._threads:
+                thread.join()
+            self._threads = []
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Split a model into pipeline stages.')
+    parser.add_argument('model_path', help='model path')
+    parser.add_argument('output_prefix', help='the stages are written to <output_prefix><index>.onnx')
+    parser.add_argument('--num_stages', type=int, default=2,
+                        help='number of stages holding about the same initializer bytes. Default: 2')
+    parser.add_argument('--boundaries', help='comma separated indices of the first node of every stage but the '
+                        'first, instead of --num_stages')
+    args = parser.parse_args()
+
+    model = onnx.load(args.model_path)
+    boundaries = [int(b) for b in args.boundaries.split(',')] if args.boundaries else None
+    stages = split_model(model, boundaries, args.num_stages)
+    for index, stage in enumerate(stages):
+        path = '{}{}.onnx'.format(args.output_prefix, index)
+        onnx.save(stage, path)
+        print('stage {}: {} nodes, inputs {}, outputs {}, written to {}'.format(
+            index, len(stage.graph.node), [i.name for i in stage.graph.input],
+            [o.name for o in stage.graph.output], path))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,292 @@
+#-------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+#--------------------------------------------------------------------------
+
+# Find the threading, execution mode and memory SessionOptions that run a model fastest on this machine.
+# The best configuration is written in the format of the ORT config a model can carry in its `ort_config` metadata
+# ({"session_options": {...}}, read when ORT_LOAD_CONFIG_FROM_MODEL=1), and can be embedded in a copy of the model:
+#
+#   onnxruntime_tune model.onnx tuned.json --shape input:8x3x224x224 --objective throughput --concurrency 4
+#   onnxruntime_tune model.onnx tuned.json --embed_in_model tuned_model.onnx
+#
+#   sess = onnxruntime.InferenceSession('model.onnx', load_session_options('tuned.json'))
+
+import argparse
+import itertools
+import json
+import multiprocessing
+import sys
+import threading
+from timeit import default_timer as timer
+
+import numpy as np
+import onnxruntime as onnxrt
+
+# the SessionOptions the tuner sets. As in the ORT config, all the values are integers: execution_mode is 0 for
+# sequential and 1 for parallel, and the enable_ options are 0 or 1.
+TUNED_OPTIONS = ['intra_op_num_threads', 'inter_op_num_threads', 'execution_mode', 'enable_mem_pattern',
+                 'enable_cpu_mem_arena']
+ORT_CONFIG_KEY = 'ort_config'
+SEQUENTIAL = 0
+PARALLEL = 1
+
+float_dict = {
+    'tensor(float16)': 'float16',
+    'tensor(float)': 'float32',
+    'tensor(double)': 'float64'
+}
+
+integer_dict = {
+    'tensor(int32)': 'int32',
+    'tensor(int8)': 'int8',
+    'tensor(uint8)': 'uint8',
+    'tensor(int16)': 'int16',
+    'tensor(uint16)': 'uint16',
+    'tensor(int64)': 'int64',
+    'tensor(uint64)': 'uint64'
+}
+
+
+def create_session_options(config):
+    '''
+    Create SessionOptions with the options of a configuration.
+    '''
+    sess_options = onnxrt.SessionOptions()
+    for name, value in config.items():
+        if name not in TUNED_OPTIONS:
+            raise ValueError("Unsupported session option '{}'".format(name))
+        if name == 'execution_mode':
+            value = onnxrt.ExecutionMode.ORT_PARALLEL if value == PARALLEL else onnxrt.ExecutionMode.ORT_SEQUENTIAL
+        elif name.startswith('enable_'):
+            value = bool(value)
+        setattr(sess_options, name, value)
+    return sess_options
+
+
+def save_config(config, path, results=None):
+    '''
+    Write a configuration, and optionally the measurements it was picked from, to a JSON file. The file is an ORT
+    config: the results are ignored when it's embedded in a model.
+    '''
+    content = {'session_options': config}
+    if results is not None:
+        content['results'] = results
+    with open(path, 'w') as f:
+        json.dump(content, f, indent=2)
+
+
+def load_session_options(path):
+    '''
+    Create SessionOptions from a file written by save_config.
+    '''
+    with open(path) as f:
+        return create_session_options(json.load(f)['session_options'])
+
+
+def embed_config(model_path, config, output_model_path):
+    '''
+    Save a copy of the model with the configuration as its ORT config, replacing any existing one.
+    '''
+    import onnx
+    model = onnx.load(model_path)
+    for prop in model.metadata_props:
+        if prop.key == ORT_CONFIG_KEY:
+            model.metadata_props.remove(prop)
+            break
+    prop = model.metadata_props.add()
+    prop.key = ORT_CONFIG_KEY
+    prop.value = json.dumps({'session_options': config})
+    onnx.save(model, output_model_path)
+
+
+def parse_shapes(shape_args):
+    '''
+    Parse name:d0xd1x... arguments into a dict of input name to shape.
+    '''
+    shapes = {}
+    for arg in shape_args or []:
+        name, sep, dims = arg.rpartition(':')
+        if not sep or not name:
+            raise ValueError("Invalid shape '{}', expected name:d0xd1x...".format(arg))
+        shapes[name] = [int(dim) for dim in dims.split('x')] if dims else []
+    return shapes
+
+
+def create_feeds(sess, shapes):
+    '''
+    Random inputs for the session. Inputs missing from shapes use the model shape with symbolic dimensions set to 1.
+    '''
+    feeds = {}
+    for input_meta in sess.get_inputs():
+        shape = shapes.get(input_meta.name, [dim if isinstance(dim, int) and dim > 0 else 1
+                                               for dim in input_meta.shape])
+        if input_meta.type in float_dict:
+            feeds[input_meta.name] = np.random.rand(*shape).astype(float_dict[input_meta.type])
+        elif input_meta.type in integer_dict:
+            feeds[input_meta.name] = np.random.uniform(high=100, size=tuple(shape)).astype(
+                integer_dict[input_meta.type])
+        elif input_meta.type == 'tensor(bool)':
+            feeds[input_meta.name] = np.random.randint(2, size=tuple(shape)).astype('bool')
+        else:
+            raise ValueError("Unsupported input type {} for input {}".format(input_meta.type, input_meta.name))
+    return feeds
+
+
+def measure(model_path, config, shapes, objective, iterations, warmup, concurrency, percentile):
+    '''
+    Run the model with a configuration and return its measurements.
+    objective 'latency' runs the requests one at a time. 'throughput' runs them from concurrency threads sharing the
+    session.
+    '''
+    sess = onnxrt.InferenceSession(model_path, create_session_options(config))
+    feeds = create_feeds(sess, shapes)
+    prepared_run = sess.prepare_run([output.name for output in sess.get_outputs()], list(feeds.keys()))
+    for _ in range(warmup):
+        sess.run_prepared(prepared_run, feeds)
+
+    if objective == 'latency':
+        latencies = []
+        for _ in range(iterations):
+            start = timer()
+            sess.run_prepared(prepared_run, feeds)
+            latencies.append(timer() - start)
+        return {
+            'latency_ms': float(np.percentile(latencies, percentile)) * 1000,
+            'mean_latency_ms': float(np.mean(latencies)) * 1000
+        }
+
+    # a prepared run serializes the runs that use it, so each thread has its own
+    prepared_runs = [sess.prepare_run(prepared_run.output_names, prepared_run.input_names)
+                     for _ in range(concurrency)]
+    per_thread = (iterations + concurrency - 1) // concurrency
+    errors = []
+
+    def worker(index):
+        try:
+            for _ in range(per_thread):
+                sess.run_prepared(prepared_runs[index], feeds)
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=worker, args=(i, )) for i in range(concurrency)]
+    start = timer()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = timer() - start
+    if errors:
+        raise errors[0]
+    return {'throughput': per_thread * concurrency / elapsed}
+
+
+def thread_counts(max_threads):
+    '''
+    1, the powers of two below max_threads, and max_threads.
+    '''
+    counts = [1]
+    while counts[-1] * 2 < max_threads:
+        counts.append(counts[-1] * 2)
+    if max_threads > 1:
+        counts.append(max_threads)
+    return counts
+
+
+def candidate_configs(intra_op_threads, inter_op_threads, exhaustive):
+    '''
+    The configurations to measure, as a list of stages. Each stage varies some options and keeps the best values of
+    the previous stages for the others. exhaustive returns a single stage with every combination.
+    '''
+    threading_configs = [{'execution_mode': SEQUENTIAL, 'intra_op_num_threads': intra} for intra in intra_op_threads]
+    threading_configs += [{'execution_mode': PARALLEL, 'intra_op_num_threads': intra, 'inter_op_num_threads': inter}
+                          for intra, inter in itertools.product(intra_op_threads, inter_op_threads) if inter > 1]
+    memory_configs = [{'enable_mem_pattern': mem_pattern, 'enable_cpu_mem_arena': arena}
+                      for mem_pattern, arena in itertools.product([1, 0], repeat=2)]
+    if exhaustive:
+        return [[dict(t, **m) for t, m in itertools.product(threading_configs, memory_configs)]]
+    return [threading_configs, memory_configs]
+
+
+def tune(model_path, shapes=None, objective='latency', iterations=100, warmup=10, concurrency=1, percentile=50,
+         intra_op_threads=None, inter_op_threads=None, exhaustive=False, verbose=False):
+    '''
+    Measure the candidate configurations and return the best one along with all the measurements.
+    :param shapes: dict of input name to the shape of the random input used for it.
+    :param objective: 'latency' minimizes the given percentile of the latency of single requests, 'throughput'
+        maximizes the requests per second completed by concurrency threads.
+    :param intra_op_threads, inter_op_threads: thread counts to try. Default: 1, powers of two and the number of
+        logical processors.
+    :param exhaustive: measure every combination instead of tuning the threading options first and then the memory
+        options.
+    :return: (best config, list of {'session_options': config, <measurements>})
+    '''
+    if objective not in ('latency', 'throughput'):
+        raise ValueError("objective must be 'latency' or 'throughput'")
+    default_threads = thread_counts(multiprocessing.cpu_count())
+    intra_op_threads = intra_op_threads or default_threads
+    inter_op_threads = inter_op_threads or default_threads
+    key, better = ('latency_ms', lambda a, b: a < b) if objective == 'latency' else ('throughput', lambda a, b: a > b)
+
+    best = {}
+    results = []
+    for stage in candidate_configs(intra_op_threads, inter_op_threads, exhaustive):
+        stage_best = None
+        for candidate in stage:
+            config = dict(best, **candidate)
+            if config.get('execution_mode') != PARALLEL:
+                config.pop('inter_op_num_threads', None)
+            measurements = measure(model_path, config, shapes or {}, objective, iterations, warmup, concurrency,
+                                   percentile)
+            results.append(dict(measurements, session_options=config))
+            if verbose:
+                print('{}: {}'.format(json.dumps(config, sort_keys=True), measurements))
+            if stage_best is None or better(measurements[key], stage_best[0]):
+                stage_best = (measurements[key], config)
+        best = stage_best[1]
+    return best, results
+
+
+def parse_thread_list(arg):
+    return [int(count) for count in arg.split(',')] if arg else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Find the SessionOptions that run a model fastest on this machine.')
+    parser.add_argument('model_path', help='model path')
+    parser.add_argument('output', help='JSON file to write the best configuration to')
+    parser.add_argument('--shape', action='append', help='shape of the random data fed to an input, as '
+                        'name:d0xd1x... Can be repeated. Default: the model shape with symbolic dimensions set to 1')
+    parser.add_argument('--objective', choices=['latency', 'throughput'], default='latency',
+                        help="'latency' minimizes the latency percentile of single requests, 'throughput' maximizes "
+                        "the requests per second of --concurrency threads. Default: latency")
+    parser.add_argument('--percentile', type=float, default=50, help='latency percentile to minimize. Default: 50')
+    parser.add_argument('--concurrency', type=int, default=1,
+                        help='number of threads running requests for the throughput objective. Default: 1')
+    parser.add_argument('--iterations', type=int, default=100, help='runs per configuration. Default: 100')
+    parser.add_argument('--warmup', type=int, default=10, help='untimed runs per configuration. Default: 10')
+    parser.add_argument('--intra_op_threads', help='comma separated intra op thread counts to try. Default: 1, the '
+                        'powers of two and the number of logical processors')
+    parser.add_argument('--inter_op_threads', help='comma separated inter op thread counts to try with the parallel '
+                        'execution mode. Default: same as --intra_op_threads')
+    parser.add_argument('--exhaustive', action='store_true', help='measure every combination of the options instead '
+                        'of tuning the threading options first and then the memory options')
+    parser.add_argument('--embed_in_model', help='also save a copy of the model with the best configuration as its '
+                        'ORT config, used when the environment variable ORT_LOAD_CONFIG_FROM_MODEL is 1')
+    parser.add_argument('--verbose', action='store_true', help='print the measurements of every configuration')
+    args = parser.parse_args()
+
+    best, results = tune(args.model_path, parse_shapes(args.shape), args.objective, args.iterations, args.warmup,
+                         args.concurrency, args.percentile, parse_thread_list(args.intra_op_threads),
+                         parse_thread_list(args.inter_op_threads), args.exhaustive, args.verbose)
+    save_config(best, args.output, results)
+    print('best configuration: {}'.format(json.dumps(best, sort_keys=True)))
+    print('written to {}'.format(args.output))
+    if args.embed_in_model:
+        embed_config(args.model_path, best, args.embed_in_model)
+        print('model with the configuration written to {}'.format(args.embed_in_model))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -204,5 +208,221 @@ TEST(AttentionTest, AttentionMaskExceedSequence) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+// Computes the expected output of Attention directly from its definition. The past state has shape
+// (2, batch_size, num_heads, past_sequence_length, head_size), and the present state is returned in present_data.
+static std::vector<float> ComputeAttentionReference(
+    const std::vector<float>& input_data,
+    const std::vector<float>& weights_data,
+    const std::vector<float>& bias_data,
+    const std::vector<int32_t>& mask_index_data,
+    int batch_size,
+    int sequence_length,
+    int hidden_size,
+    int number_of_heads,
+    const std::vector<float>& past_data = {},
+    int past_sequence_length = 0,
+    bool is_unidirectional = false,
+    std::vector<float>* present_data = nullptr) {
+  const int head_size = hidden_size / number_of_heads;
+  const int all_sequence_length = past_sequence_length + sequence_length;
+  std::vector<float> qkv(batch_size * sequence_length * 3 * hidden_size);
+  for (int row = 0; row < batch_size * sequence_length; row++) {
+    for (int col = 0; col < 3 * hidden_size; col++) {
+      double sum = bias_data[col];
+      for (int k = 0; k < hidden_size; k++) {
+        sum += input_data[row * hidden_size + k] * weights_data[k * 3 * hidden_size + col];
+      }
+      qkv[row * 3 * hidden_size + col] = static_cast<float>(sum);
+    }
+  }
+
+  // present(2, B, N, L, H) = concat(past, K/V)
+  std::vector<float> present(2 * batch_size * number_of_heads * all_sequence_length * head_size);
+  for (int kv = 0; kv < 2; kv++) {
+    for (int b = 0; b < batch_size; b++) {
+      for (int n = 0; n < number_of_heads; n++) {
+        for (int t = 0; t < all_sequence_length; t++) {
+          for (int h = 0; h < head_size; h++) {
+            float value;
+            if (t < past_sequence_length) {
+              value = past_data[(((kv * batch_size + b) * number_of_heads + n) * past_sequence_length + t) * head_size + h];
+            } else {
+              value = qkv[(b * sequence_length + t - past_sequence_length) * 3 * hidden_size + (kv + 1) * hidden_size + n * head_size + h];
+            }
+            present[(((kv * batch_size + b) * number_of_heads + n) * all_sequence_length + t) * head_size + h] = value;
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<float> output_data(batch_size * sequence_length * hidden_size);
+  std::vector<double> probs(all_sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < number_of_heads; n++) {
+      const float* keys = &present[((0 * batch_size + b) * number_of_heads + n) * all_sequence_length * head_size];
+      const float* values = &present[((1 * batch_size + b) * number_of_heads + n) * all_sequence_length * head_size];
+      for (int s = 0; s < sequence_length; s++) {
+        const float* q = &qkv[(b * sequence_length + s) * 3 * hidden_size + n * head_size];
+        double max = -std::numeric_limits<double>::infinity();
+        for (int t = 0; t < all_sequence_length; t++) {
+          double dot = 0.0;
+          for (int h = 0; h < head_size; h++) {
+            dot += q[h] * keys[t * head_size + h];
+          }
+          probs[t] = dot / std::sqrt(static_cast<double>(head_size)) + (t < mask_index_data[b] ? 0.0 : -10000.0);
+          if (is_unidirectional && t > past_sequence_length + s) {
+            probs[t] += -10000.0;
+          }
+          max = std::max(max, probs[t]);
+        }
+        double sum = 0.0;
+        for (int t = 0; t < all_sequence_length; t++) {
+          probs[t] = std::exp(probs[t] - max);
+          sum += probs[t];
+        }
+        for (int h = 0; h < head_size; h++) {
+          double value = 0.0;
+          for (int t = 0; t < all_sequence_length; t++) {
+            value += probs[t] / sum * values[t * head_size + h];
+          }
+          output_data[(b * sequence_length + s) * hidden_size + n * head_size + h] = static_cast<float>(value);
+        }
+      }
+    }
+  }
+
+  if (present_data != nullptr) {
+    *present_data = std::move(present);
+  }
+  return output_data;
+}
+
+static void FillAttentionTestData(std::vector<float>& weight_data, std::vector<float>& bias_data, int hidden_size) {
+  weight_data.resize(hidden_size * 3 * hidden_size);
+  for (size_t i = 0; i < weight_data.size(); i++) {
+    weight_data[i] = static_cast<float>((i * 5) % 17) / 16.0f - 0.5f;
+  }
+
+  bias_data.resize(3 * hidden_size);
+  for (size_t i = 0; i < bias_data.size(); i++) {
+    bias_data[i] = static_cast<float>(i % 5) / 10.0f - 0.2f;
+  }
+}
+
+TEST(AttentionTest, AttentionLongSequence) {
+  // The sequence is long enough for the query rows of each head to be split into several blocks.
+  int batch_size = 2;
+  int sequence_length = 160;
+  int hidden_size = 8;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = static_cast<float>((i * 7) % 23) / 11.0f - 1.0f;
+  }
+
+  std::vector<float> weight_data;
+  std::vector<float> bias_data;
+  FillAttentionTestData(weight_data, bias_data, hidden_size);
+
+  std::vector<int32_t> mask_index_data = {160L, 97L};
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size, number_of_heads);
+
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads);
+}
+
+TEST(AttentionTest, AttentionFusedLongSequence) {
+  // Long enough for the CUDA kernel to compute the attention in one fused kernel, with a masked second sequence
+  // that ends within a tile of keys.
+  int batch_size = 2;
+  int sequence_length = 544;
+  int hidden_size = 128;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = static_cast<float>((i * 7) % 23) / 44.0f - 0.25f;
+  }
+
+  std::vector<float> weight_data;
+  std::vector<float> bias_data;
+  FillAttentionTestData(weight_data, bias_data, hidden_size);
+
+  std::vector<int32_t> mask_index_data = {544L, 301L};
+
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size, number_of_heads);
+
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads);
+}
+
+static void RunAttentionPastTest(int batch_size,
+                                 int sequence_length,
+                                 int past_sequence_length,
+                                 int hidden_size,
+                                 int number_of_heads,
+                                 bool is_unidirectional,
+                                 const std::vector<int32_t>& mask_index_data) {
+  const int head_size = hidden_size / number_of_heads;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = static_cast<float>((i * 7) % 23) / 11.0f - 1.0f;
+  }
+
+  std::vector<float> past_data(2 * batch_size * number_of_heads * past_sequence_length * head_size);
+  for (size_t i = 0; i < past_data.size(); i++) {
+    past_data[i] = static_cast<float>((i * 3) % 19) / 9.0f - 1.0f;
+  }
+
+  std::vector<float> weight_data;
+  std::vector<float> bias_data;
+  FillAttentionTestData(weight_data, bias_data, hidden_size);
+
+  std::vector<float> present_data;
+  std::vector<float> output_data = ComputeAttentionReference(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size, number_of_heads,
+                                                             past_data, past_sequence_length, is_unidirectional,
+                                                             &present_data);
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(is_unidirectional ? 1 : 0));
+
+  tester.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input_data);
+  tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddInput<int32_t>("mask_index", {batch_size}, mask_index_data);
+  tester.AddInput<float>("past", {2, batch_size, number_of_heads, past_sequence_length, head_size}, past_data);
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output_data);
+  tester.AddOutput<float>("present", {2, batch_size, number_of_heads, past_sequence_length + sequence_length, head_size},
+                          present_data);
+
+  // Only the CPU execution provider supports the past state.
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider});
+}
+
+TEST(AttentionTest, AttentionPastStateSingleToken) {
+  // One new token per step, as in incremental decoding.
+  RunAttentionPastTest(2, 1, 5, 8, 2, true, {6, 4});
+}
+
+TEST(AttentionTest, AttentionPastStateUnidirectional) {
+  RunAttentionPastTest(1, 3, 4, 8, 2, true, {7});
+}
+
+TEST(AttentionTest, AttentionPastStateBidirectional) {
+  RunAttentionPastTest(2, 3, 2, 4, 2, false, {5, 3});
+}
+
+TEST(AttentionTest, AttentionEmptyPastState) {
+  RunAttentionPastTest(1, 4, 0, 8, 2, true, {4});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// vectors of 8 or more elements use the GEMM based computation
+static const std::vector<float> cdist_a = {1.f, 2.f, 0.f, -1.f, 3.f, 0.5f, 2.f, -2.f,
+                                           0.f, -1.f, 4.f, 2.f, 1.f, 1.f, 0.f, 3.f};
+static const std::vector<float> cdist_b = {1.f, 2.f, 0.f, -1.f, 3.f, 0.5f, 2.f, -2.f,
+                                           2.f, 0.f, 1.f, 1.f, -1.f, 0.f, 0.5f, 1.f,
+                                           -3.f, 1.f, 2.f, 0.f, 0.f, 2.f, 1.f, -1.f};
+
+TEST(ContribOpTest, CDistSqeuclidean) {
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", std::string("sqeuclidean"));
+  test.AddInput<float>("A", {2, 8}, cdist_a);
+  test.AddInput<float>("B", {3, 8}, cdist_b);
+  test.AddOutput<float>("C", {2, 3}, {0.f, 37.5f, 35.25f, 68.25f, 24.25f, 40.f});
+  test.Run();
+}
+
+TEST(ContribOpTest, CDistEuclidean) {
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", std::string("euclidean"));
+  test.AddInput<double>("A", {2, 8}, std::vector<double>(cdist_a.begin(), cdist_a.end()));
+  test.AddInput<double>("B", {3, 8}, std::vector<double>(cdist_b.begin(), cdist_b.end()));
+  test.AddOutput<double>("C", {2, 3}, {0., 6.123724356957945, 5.937171043518958,
+                                       8.261355820929152, 4.924428900898052, 6.324555320336759});
+  test.Run();
+}
+
+TEST(ContribOpTest, CDistEuclideanShortVectors) {
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", std::string("euclidean"));
+  test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f, 0.f, -1.f, 0.5f});
+  test.AddInput<float>("B", {2, 3}, {1.f, 0.f, 1.f, 2.f, 2.f, 2.f});
+  test.AddOutput<float>("C", {2, 2}, {2.8284271f, 1.4142135f, 1.5f, 3.9051248f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
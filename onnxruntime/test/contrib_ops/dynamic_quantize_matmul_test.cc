@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// The range of A is [-8, 23.875], so A is quantized with a scale of 0.125 and a zero point of 64 without any
+// rounding and the results are exact.
+static const std::vector<float> kInputA = {-8.0f, 1.5f, 23.875f,
+                                           0.25f, -2.0f, 4.0f};
+
+// int8 B with a scale per column, and a bias
+TEST(DynamicQuantizeMatMul, Int8PerColumnScaleBias) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, kInputA);
+  test.AddInput<int8_t>("B", {3, 2}, {1, -2, 3, 4, -1, 2});
+  test.AddInput<float>("b_scale", {2}, {0.5f, 2.0f});
+  test.AddMissingOptionalInput<int8_t>();
+  test.AddInput<float>("bias", {2}, {1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2, 2},
+                        {-12.6875f, 138.5f,
+                         -3.875f, -2.0f});
+  test.Run();
+}
+
+// uint8 B with a scalar scale and zero point, and a batch of A multiplied by the same B
+TEST(DynamicQuantizeMatMul, UInt8ZeroPointBatch) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 1, 3}, kInputA);
+  test.AddInput<uint8_t>("B", {3, 2}, {129, 126, 131, 132, 127, 130});
+  test.AddInput<float>("b_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {128});
+  test.AddOutput<float>("Y", {2, 1, 2},
+                        {-13.6875f, 34.875f,
+                         -4.875f, -0.25f});
+  test.Run();
+}
+
+// int8 B with a zero point per column
+TEST(DynamicQuantizeMatMul, Int8PerColumnZeroPoint) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, kInputA);
+  test.AddInput<int8_t>("B", {3, 2}, {2, -4, 4, 2, 0, 0});
+  test.AddInput<float>("b_scale", {2}, {1.0f, 0.5f});
+  test.AddInput<int8_t>("b_zero_point", {2}, {1, -2});
+  test.AddOutput<float>("Y", {2, 2},
+                        {-27.375f, 34.875f,
+                         -9.75f, -0.25f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// The weights of the LSTM and GRU SimpleWeightsNoBiasTwoRows tests, quantized with a zero point of 0 and a scale
+// per row for W, and with a zero point of 10 for R so that the dequantized weights match the float weights.
+// The input and the hidden state are quantized to uint8 by the kernels, so the outputs match the float outputs
+// within the quantization error.
+static void RunDynamicQuantizeRNNTest(const std::string& op_type, int num_gates,
+                                      const std::vector<float>& W_float,
+                                      const std::vector<float>& Y_data,
+                                      const std::vector<float>& Y_h_data,
+                                      bool weights_are_initializers) {
+  const int64_t seq_length = 2;
+  const int64_t batch_size = 2;
+  const int64_t input_size = 1;
+  const int64_t hidden_size = 3;
+  const int64_t N = num_gates * hidden_size;
+
+  OpTester test(op_type.c_str(), 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("direction", "forward");
+  test.AddAttribute("hidden_size", hidden_size);
+
+  std::vector<int8_t> W_data(N * input_size, 100);
+  std::vector<float> W_scale;
+  for (float w : W_float) {
+    W_scale.push_back(w / 100.f);
+  }
+
+  std::vector<int8_t> R_data(N * hidden_size, 110);
+
+  test.AddInput<float>("X", {seq_length, batch_size, input_size}, {1.f, 2.f, 10.f, 11.f});
+  test.AddInput<int8_t>("W", {1, N, input_size}, W_data, weights_are_initializers);
+  test.AddInput<int8_t>("R", {1, N, hidden_size}, R_data, weights_are_initializers);
+
+  // B, sequence_lens, initial_h and for the LSTM initial_c and P
+  const int num_optional_inputs = op_type == "DynamicQuantizeLSTM" ? 5 : 3;
+  for (int i = 0; i < num_optional_inputs; ++i) {
+    test.AddMissingOptionalInput<float>();
+  }
+
+  test.AddInput<float>("W_scale", {1, N}, W_scale);
+  test.AddMissingOptionalInput<int8_t>();
+  test.AddInput<float>("R_scale", {1}, {0.001f});
+  test.AddInput<int8_t>("R_zero_point", {1}, {10});
+
+  test.AddOutput<float>("Y", {seq_length, 1, batch_size, hidden_size}, Y_data);
+  test.AddOutput<float>("Y_h", {1, batch_size, hidden_size}, Y_h_data);
+  test.SetOutputAbsErr("Y", 0.02f);
+  test.SetOutputAbsErr("Y_h", 0.02f);
+
+  test.Run();
+}
+
+TEST(DynamicQuantizeLSTMTest, ForwardSimpleWeightsNoBiasTwoRows) {
+  std::vector<float> W_float{
+      0.1f, 0.2f, 0.3f, 0.4f,
+      1.f, 2.f, 3.f, 4.f,
+      10.f, 11.f, 12.f, 13.f};
+
+  std::vector<float> Y_data{
+      0.28828835f, 0.36581863f, 0.45679406f,
+      0.34526032f, 0.47220859f, 0.55850911f,
+
+      0.84196719f, 0.89402526f, 0.91073048f,
+      0.85882828f, 0.90703777f, 0.92382453f};
+
+  std::vector<float> Y_h_data{
+      0.84196719f, 0.89402526f, 0.91073048f,
+      0.85882828f, 0.90703777f, 0.92382453f};
+
+  RunDynamicQuantizeRNNTest("DynamicQuantizeLSTM", 4, W_float, Y_data, Y_h_data, false);
+
+  // constant weights are transposed when the session is initialized
+  RunDynamicQuantizeRNNTest("DynamicQuantizeLSTM", 4, W_float, Y_data, Y_h_data, true);
+}
+
+TEST(DynamicQuantizeGRUTest, ForwardSimpleWeightsNoBiasTwoRows) {
+  std::vector<float> W_float{0.1f, 0.2f, 0.3f,
+                             1.f, 2.f, 3.f,
+                             10.f, 11.f, 12.f};
+
+  std::vector<float> Y_data{
+      0.4750208f, 0.450166f, 0.4255575f,
+      0.45016602f, 0.40131235f, 0.35434368f,
+
+      0.6027093f, 0.5083023f, 0.44950223f,
+      0.5754369f, 0.45485455f, 0.3747841f};
+
+  std::vector<float> Y_h_data{
+      0.6027093f, 0.5083023f, 0.44950223f,
+      0.5754369f, 0.45485455f, 0.3747841f};
+
+  RunDynamicQuantizeRNNTest("DynamicQuantizeGRU", 3, W_float, Y_data, Y_h_data, false);
+
+  // constant weights are transposed when the session is initialized
+  RunDynamicQuantizeRNNTest("DynamicQuantizeGRU", 3, W_float, Y_data, Y_h_data, true);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
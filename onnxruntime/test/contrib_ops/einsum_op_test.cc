@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(EinsumOpTest, MatMul) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ij,jk->ik");
+  test.AddInput<float>("x", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddInput<float>("y", {3, 2}, {0.f, 1.f, 2.f, 3.f, -3.f, -2.f});
+  test.AddOutput<float>("Output", {2, 2}, {-2.f, -5.f, -5.f, 1.f});
+  test.Run();
+}
+
+// the output labels of an equation without "->" are the labels that appear once, in alphabetical order
+TEST(EinsumOpTest, ImplicitOutput) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ij,jk");
+  test.AddInput<float>("x", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddInput<float>("y", {3, 2}, {0.f, 1.f, 2.f, 3.f, -3.f, -2.f});
+  test.AddOutput<float>("Output", {2, 2}, {-2.f, -5.f, -5.f, 1.f});
+  test.Run();
+}
+
+// the product of the queries and the keys of attention, which reads the keys transposed in place
+TEST(EinsumOpTest, BatchedMatMulTransposed) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "bhqd,bhkd->bhqk");
+  test.AddInput<float>("q", {1, 2, 2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f});
+  test.AddInput<float>("k", {1, 2, 3, 3},
+                       {0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f,
+                        2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddOutput<float>("Output", {1, 2, 2, 3}, {-1.f, -3.f, 2.f, 8.f, -9.f, 2.f, -9.f, 8.f, -10.f, -3.f, -1.f, 8.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, Transpose) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ij->ji");
+  test.AddInput<float>("x", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddOutput<float>("Output", {3, 2}, {-2.f, 1.f, -1.f, 2.f, 0.f, 3.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, ReduceSum) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ijk->ik");
+  test.AddInput<float>("x", {2, 3, 2}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f});
+  test.AddOutput<float>("Output", {2, 2}, {0.f, 3.f, -3.f, 0.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, Trace) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ii->");
+  test.AddInput<float>("x", {3, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f});
+  test.AddOutput<float>("Output", {}, {-1.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, Diagonal) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ii->i");
+  test.AddInput<float>("x", {3, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f});
+  test.AddOutput<float>("Output", {3}, {-2.f, 2.f, -1.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, DotProduct) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "i,i->");
+  test.AddInput<float>("x", {4}, {-2.f, -1.f, 0.f, 1.f});
+  test.AddInput<float>("y", {4}, {0.f, 1.f, 2.f, 3.f});
+  test.AddOutput<float>("Output", {}, {2.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, OuterProduct) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "i,j->ij");
+  test.AddInput<float>("x", {2}, {-2.f, -1.f});
+  test.AddInput<float>("y", {3}, {0.f, 1.f, 2.f});
+  test.AddOutput<float>("Output", {2, 3}, {0.f, -2.f, -4.f, 0.f, -1.f, -2.f});
+  test.Run();
+}
+
+// the ellipsis of y has no dimensions, so y multiplies each matrix of x
+TEST(EinsumOpTest, EllipsisBroadcast) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "...ij,...jk->...ik");
+  test.AddInput<float>("x", {2, 2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f});
+  test.AddInput<float>("y", {3, 2}, {0.f, 1.f, 2.f, 3.f, -3.f, -2.f});
+  test.AddOutput<float>("Output", {2, 2, 2}, {-2.f, -5.f, -5.f, 1.f, -1.f, -7.f, -4.f, -1.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, ThreeInputs) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ij,jk,kl->il");
+  test.AddInput<float>("x", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddInput<float>("y", {3, 2}, {0.f, 1.f, 2.f, 3.f, -3.f, -2.f});
+  test.AddInput<float>("z", {2, 2}, {2.f, 3.f, -3.f, -2.f});
+  test.AddOutput<float>("Output", {2, 2}, {11.f, 4.f, -13.f, -17.f});
+  test.Run();
+}
+
+TEST(EinsumOpTest, MismatchedLabelSizes) {
+  OpTester test("Einsum", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("equation", "ij,jk->ik");
+  test.AddInput<float>("x", {2, 3}, {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f});
+  test.AddInput<float>("y", {2, 2}, {0.f, 1.f, 2.f, 3.f});
+  test.AddOutput<float>("Output", {2, 2}, {0.f, 0.f, 0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "where the size of its label is 3");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
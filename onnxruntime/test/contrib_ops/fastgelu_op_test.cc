@@ -50,7 +50,10 @@ static void RunFastGeluTest(
     bool has_bias = true,
     bool use_float16 = false) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
-  if (HasCudaEnvironment(min_cuda_architecture)) {
+  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
+  bool enable_cpu = !use_float16;
+
+  if (enable_cpu || enable_cuda) {
     OpTester tester("FastGelu", 1, onnxruntime::kMSDomain);
 
     if (use_float16) {
@@ -68,7 +71,12 @@ static void RunFastGeluTest(
     }
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    if (enable_cuda) {
+      execution_providers.push_back(DefaultCudaExecutionProvider());
+    }
+    if (enable_cpu) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+    }
     tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -123,6 +131,25 @@ TEST(FastGeluTest, FastGeluWithoutBiasFloat32) {
   RunFastGeluTest(input_data, bias_data, batch_size, sequence_length, hidden_size);
 }
 
+TEST(FastGeluTest, FastGeluWithBiasFloat32LargeHidden) {
+  // The hidden size is not a multiple of the vector size, and a row is processed in several blocks.
+  int batch_size = 2;
+  int sequence_length = 5;
+  int hidden_size = 517;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = static_cast<float>(static_cast<int>(i % 41) - 20) / 5.0f;
+  }
+
+  std::vector<float> bias_data(hidden_size);
+  for (size_t i = 0; i < bias_data.size(); i++) {
+    bias_data[i] = static_cast<float>(static_cast<int>(i % 9) - 4) / 8.0f;
+  }
+
+  RunFastGeluTest(input_data, bias_data, batch_size, sequence_length, hidden_size);
+}
+
 TEST(FastGeluTest, FastGeluWithBiasFloat16) {
   int batch_size = 1;
   int sequence_length = 2;
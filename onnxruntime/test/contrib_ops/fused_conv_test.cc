@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+void TestFusedConvSum(bool has_bias, const std::vector<float>& expected_output) {
+  OpTester test("FusedConv", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  test.AddAttribute("group", static_cast<int64_t>(2));
+  test.AddAttribute("activation", "Relu");
+
+  std::vector<float> X = {-3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f,
+                          0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f,
+                          3.f, -3.f};
+  std::vector<float> W = {-2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f,
+                          0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f,
+                          2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f,
+                          -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f,
+                          1.f, 2.f, -2.f, -1.f};
+  std::vector<float> Z = {-1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f,
+                          0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f,
+                          -1.5f, -0.5f, 0.5f, 1.5f, -1.5f, -0.5f, 0.5f, 1.5f};
+
+  test.AddInput<float>("X", {1, 4, 3, 3}, X);
+  test.AddInput<float>("W", {4, 2, 3, 3}, W);
+  if (has_bias) {
+    test.AddInput<float>("B", {4}, {1.f, -2.f, 0.5f, 3.f});
+  } else {
+    test.AddMissingOptionalInput<float>();
+  }
+  test.AddInput<float>("Z", {1, 4, 3, 3}, Z);
+  test.AddOutput<float>("Y", {1, 4, 3, 3}, expected_output);
+  test.Run();
+}
+
+}  // namespace
+
+// The residual tensor Z is summed into the output before the bias and the activation are applied.
+TEST(ContribOpTest, FusedConvSum) {
+  TestFusedConvSum(true, {0.f, 0.f, 0.f, 12.5f, 0.f, 10.5f, 2.5f, 2.5f, 0.5f, 0.f, 12.5f, 0.f, 0.f, 0.f, 0.f, 4.5f,
+                          0.f, 4.5f, 2.f, 0.f, 0.f, 10.f, 0.f, 7.f, 0.f, 14.f, 0.f, 11.5f, 9.5f, 11.5f, 0.f, 0.f, 0.f,
+                          13.5f, 0.f, 3.5f});
+}
+
+TEST(ContribOpTest, FusedConvSumNoBias) {
+  TestFusedConvSum(false, {0.f, 0.f, 0.f, 11.5f, 0.f, 9.5f, 1.5f, 1.5f, 0.f, 0.f, 14.5f, 0.f, 0.f, 1.5f, 0.f, 6.5f,
+                           0.f, 6.5f, 1.5f, 0.f, 0.f, 9.5f, 0.f, 6.5f, 0.f, 13.5f, 0.f, 8.5f, 6.5f, 8.5f, 0.f, 0.f,
+                           0.f, 10.5f, 0.f, 0.5f});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Y = tanh(S * (X + B)) * X, with B broadcast along the last dimension and S a scalar.
+TEST(FusedElementwiseTest, AddMulTanhMul) {
+  const std::vector<int64_t> input_dims{2, 3};
+  const std::vector<float> input_data{-1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f};
+  const std::vector<float> bias_data{0.25f, -0.25f, 1.0f};
+  const float scale = 0.5f;
+
+  std::vector<float> output_data;
+  for (size_t i = 0; i < input_data.size(); i++) {
+    output_data.push_back(std::tanh(scale * (input_data[i] + bias_data[i % 3])) * input_data[i]);
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<std::vector<std::string>>("operations", {"Add", "Mul", "Tanh", "Mul"});
+  tester.AddAttribute<std::vector<int64_t>>("operand_indices", {1, 2, -1, 0});
+  tester.AddAttribute<std::vector<int64_t>>("operand_positions", {1, 0, -1, 1});
+  tester.AddInput<float>("X", input_dims, input_data);
+  tester.AddInput<float>("B", {3}, bias_data);
+  tester.AddInput<float>("S", {1}, {scale});
+  tester.AddOutput<float>("Y", input_dims, output_data);
+  tester.Run();
+}
+
+// Operands that come first in a non-commutative operation, with a row operand that wraps inside a block.
+TEST(FusedElementwiseTest, SubDivOperandFirst) {
+  const int64_t rows = 700;
+  const int64_t cols = 3;
+  std::vector<float> input_data;
+  std::vector<float> full_data;
+  std::vector<float> output_data;
+  const std::vector<float> row_data{1.0f, 2.0f, 4.0f};
+
+  for (int64_t i = 0; i < rows * cols; i++) {
+    const float x = static_cast<float>(i % 17) + 1.0f;
+    const float b = static_cast<float>(i % 5) - 2.0f;
+    input_data.push_back(x);
+    full_data.push_back(b);
+    output_data.push_back(std::fabs(row_data[i % cols] / (b - x)));
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<std::vector<std::string>>("operations", {"Sub", "Div", "Abs"});
+  tester.AddAttribute<std::vector<int64_t>>("operand_indices", {1, 2, -1});
+  tester.AddAttribute<std::vector<int64_t>>("operand_positions", {0, 0, -1});
+  tester.AddInput<float>("X", {rows, cols}, input_data);
+  tester.AddInput<float>("B", {rows, cols}, full_data);
+  tester.AddInput<float>("R", {1, cols}, row_data);
+  tester.AddOutput<float>("Y", {rows, cols}, output_data);
+  tester.Run();
+}
+
+TEST(FusedElementwiseTest, UnaryChain) {
+  const std::vector<int64_t> input_dims{4};
+  const std::vector<float> input_data{-2.0f, -0.5f, 0.5f, 3.0f};
+
+  std::vector<float> output_data;
+  for (float x : input_data) {
+    output_data.push_back(std::sqrt(std::exp(-std::max(x, 0.0f))));
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<std::vector<std::string>>("operations", {"Relu", "Neg", "Exp", "Sqrt"});
+  tester.AddAttribute<std::vector<int64_t>>("operand_indices", {-1, -1, -1, -1});
+  tester.AddAttribute<std::vector<int64_t>>("operand_positions", {-1, -1, -1, -1});
+  tester.AddInput<float>("X", input_dims, input_data);
+  tester.AddOutput<float>("Y", input_dims, output_data);
+  tester.Run();
+}
+
+// float16 runs on CUDA only, computing in float.
+TEST(FusedElementwiseTest, AddSigmoidMulFloat16) {
+  if (!HasCudaEnvironment(530)) {
+    return;
+  }
+
+  const std::vector<int64_t> input_dims{2, 4};
+  const std::vector<float> input_data{-2.0f, -1.0f, -0.5f, 0.0f, 0.25f, 0.5f, 1.0f, 2.0f};
+  const std::vector<float> bias_data{0.5f, -0.5f, 1.0f, -1.0f};
+
+  // Y = X * sigmoid(X + B), the last Mul taking X first
+  std::vector<float> output_data;
+  for (size_t i = 0; i < input_data.size(); i++) {
+    const float x = input_data[i];
+    output_data.push_back(x / (1.0f + std::exp(-(x + bias_data[i % 4]))));
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<std::vector<std::string>>("operations", {"Add", "Sigmoid", "Mul"});
+  tester.AddAttribute<std::vector<int64_t>>("operand_indices", {1, -1, 0});
+  tester.AddAttribute<std::vector<int64_t>>("operand_positions", {1, -1, 0});
+  tester.AddInput<MLFloat16>("X", input_dims, ToFloat16(input_data));
+  tester.AddInput<MLFloat16>("B", {4}, ToFloat16(bias_data));
+  tester.AddOutput<MLFloat16>("Y", input_dims, ToFloat16(output_data));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(FusedElementwiseTest, InvalidOperandShape) {
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<std::vector<std::string>>("operations", {"Add", "Relu"});
+  tester.AddAttribute<std::vector<int64_t>>("operand_indices", {1, -1});
+  tester.AddAttribute<std::vector<int64_t>>("operand_positions", {1, -1});
+  tester.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  tester.AddInput<float>("B", {2}, {1.0f, 2.0f});
+  tester.AddOutput<float>("Y", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  tester.Run(OpTester::ExpectResult::kExpectFailure, "does not broadcast to the input shape");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedGemmRelu) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+// B is constant so it is prepacked, and the (M, 1) bias is scaled by beta.
+TEST(ContribOpTest, FusedGemmLeakyReluColumnBias) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 0.5f);
+  test.AddAttribute("activation", "LeakyRelu");
+  test.AddAttribute("leaky_relu_alpha", 0.1f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4}, std::vector<float>(12, 1.0f), true);
+  test.AddInput<float>("C", {2, 1}, {1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {10.5f, 10.5f, 10.5f,
+                         -0.9f, -0.9f, -0.9f});
+  test.Run();
+}
+
+// FastGelu is only fused on CUDA, where cuBLASLt applies it with the (N) bias to the product.
+TEST(ContribOpTest, FusedGemmFastGeluRowBias) {
+  if (!HasCudaEnvironment(0)) {
+    return;
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "FastGelu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {0.1f, 0.2f, 0.3f, 0.4f,
+                        -0.1f, -0.2f, -0.3f, -0.4f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {3}, {0.5f, -0.5f, 1.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {1.3995716f, 0.3457140f, 1.9545977f,
+                         -0.1542860f, -0.1004284f, 0.0f});
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
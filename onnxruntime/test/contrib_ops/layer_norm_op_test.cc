@@ -244,5 +244,18 @@ TEST(LayerNormTest, BERTLayerNorm) {
   test.Run();
 }
 
+TEST(LayerNormTest, BERTLayerNormHiddenSize) {
+  // The hidden sizes cover the vector loops and the scalar remainder of the row.
+  for (int64_t hidden_size : {768, 771}) {
+    float epsilon = 1e-12f;
+    std::vector<int64_t> X_dims{3, 5, hidden_size};
+    std::vector<int64_t> scale_dims{hidden_size};
+    std::vector<int64_t> B_dims{hidden_size};
+    std::vector<int64_t> Y_dims{3, 5, hidden_size};
+    LayerNormOpTester test("LayerNormalization", X_dims, scale_dims, B_dims, Y_dims, epsilon, -1, 1);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void AddQuantizedInput(OpTester& test, const char* name, const std::vector<int64_t>& dims,
+                              const std::vector<uint8_t>& values, float scale, uint8_t zero_point) {
+  test.AddInput<uint8_t>(name, dims, values);
+  test.AddInput<float>((std::string(name) + "_scale").c_str(), {}, {scale});
+  test.AddInput<uint8_t>((std::string(name) + "_zero_point").c_str(), {}, {zero_point});
+}
+
+// B is broadcast along the rows of A
+TEST(QLinearBinaryOpTest, AddBroadcast) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  AddQuantizedInput(test, "A", {2, 3}, {130, 100, 255, 0, 128, 77}, 0.1f, 128);
+  AddQuantizedInput(test, "B", {3}, {100, 150, 20}, 0.2f, 100);
+  test.AddInput<float>("C_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {120});
+  test.AddOutput<uint8_t>("C", {2, 3}, {121, 149, 107, 69, 160, 36});
+  test.Run();
+}
+
+// a scalar B, with the results below 0 saturated
+TEST(QLinearBinaryOpTest, AddScalar) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  AddQuantizedInput(test, "A", {2, 3}, {130, 100, 255, 0, 128, 77}, 0.1f, 128);
+  AddQuantizedInput(test, "B", {}, {7}, 0.2f, 100);
+  test.AddInput<float>("C_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {120});
+  test.AddOutput<uint8_t>("C", {2, 3}, {46, 34, 96, 0, 46, 25});
+  test.Run();
+}
+
+TEST(QLinearBinaryOpTest, MulBroadcast) {
+  OpTester test("QLinearMul", 1, onnxruntime::kMSDomain);
+  AddQuantizedInput(test, "A", {2, 3}, {130, 100, 255, 0, 128, 77}, 0.1f, 128);
+  AddQuantizedInput(test, "B", {3}, {100, 150, 20}, 0.2f, 100);
+  test.AddInput<float>("C_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {10});
+  test.AddOutput<uint8_t>("C", {2, 3}, {10, 0, 0, 10, 10, 173});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
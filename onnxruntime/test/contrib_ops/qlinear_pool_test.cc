@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// X - x_zero_point is {0, 2, 4, ..., 16} and the averages are scaled by x_scale / y_scale = 2
+static const std::vector<uint8_t> kPoolInput = {10, 12, 14,
+                                                16, 18, 20,
+                                                22, 24, 26};
+
+TEST(QLinearPoolTest, AveragePool) {
+  OpTester test("QLinearAveragePool", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  test.AddInput<uint8_t>("X", {1, 1, 3, 3}, kPoolInput);
+  test.AddInput<float>("x_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {10});
+  test.AddInput<float>("y_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {0});
+  test.AddOutput<uint8_t>("Y", {1, 1, 2, 2}, {8, 12, 20, 24});
+  test.Run();
+}
+
+// the padding isn't counted in the averages
+TEST(QLinearPoolTest, AveragePoolPadsStrides) {
+  OpTester test("QLinearAveragePool", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  test.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  test.AddInput<uint8_t>("X", {1, 1, 3, 3}, kPoolInput);
+  test.AddInput<float>("x_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {10});
+  test.AddInput<float>("y_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+  test.AddOutput<uint8_t>("Y", {1, 1, 2, 2}, {100, 106, 118, 124});
+  test.Run();
+}
+
+TEST(QLinearPoolTest, GlobalAveragePool) {
+  OpTester test("QLinearGlobalAveragePool", 1, onnxruntime::kMSDomain);
+  test.AddInput<uint8_t>("X", {1, 2, 2, 2}, {10, 20, 30, 40, 0, 0, 0, 4});
+  test.AddInput<float>("x_scale", {}, {0.1f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {0});
+  test.AddInput<float>("y_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {5});
+  test.AddOutput<uint8_t>("Y", {1, 2, 1, 1}, {55, 7});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/mlas/inc/mlas.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// B is (K, N) = (10, 4) with 4 non-zero values
+static std::vector<uint8_t> PackSparseB() {
+  const size_t N = 4;
+  const size_t K = 10;
+  std::vector<float> b(N * K, 0.0f);
+  b[2 * N + 0] = 2.0f;
+  b[5 * N + 1] = -1.0f;
+  b[0 * N + 3] = 1.0f;
+  b[9 * N + 3] = 3.0f;
+
+  std::vector<uint8_t> packed_b(MlasSparseGemmPackBSize(CblasNoTrans, N, K, b.data(), N));
+  EXPECT_NE(packed_b.size(), 0u);
+  MlasSparseGemmPackB(CblasNoTrans, N, K, b.data(), N, packed_b.data());
+  return packed_b;
+}
+
+// A is (2, 1, K) and is multiplied like MatMul
+TEST(ContribOpTest, SparseGemmMatMul) {
+  const std::vector<uint8_t> packed_b = PackSparseB();
+
+  OpTester test("SparseGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("N", int64_t{4});
+  test.AddAttribute("K", int64_t{10});
+  test.AddInput<float>("A", {2, 1, 10},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f,
+                        10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f});
+  test.AddInput<uint8_t>("B", {static_cast<int64_t>(packed_b.size())}, packed_b);
+  test.AddOutput<float>("Y", {2, 1, 4},
+                        {6.0f, -6.0f, 0.0f, 31.0f,
+                         16.0f, -5.0f, 0.0f, 13.0f});
+  test.Run();
+}
+
+// A is stored as (K, M) = (10, 2) and C (M, 1) is broadcast along the rows
+TEST(ContribOpTest, SparseGemmTransABias) {
+  const std::vector<uint8_t> packed_b = PackSparseB();
+
+  OpTester test("SparseGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("N", int64_t{4});
+  test.AddAttribute("K", int64_t{10});
+  test.AddAttribute("transA", int64_t{1});
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+  test.AddInput<float>("A", {10, 2},
+                       {1.0f, 10.0f, 2.0f, 9.0f, 3.0f, 8.0f, 4.0f, 7.0f, 5.0f, 6.0f,
+                        6.0f, 5.0f, 7.0f, 4.0f, 8.0f, 3.0f, 9.0f, 2.0f, 10.0f, 1.0f});
+  test.AddInput<uint8_t>("B", {static_cast<int64_t>(packed_b.size())}, packed_b);
+  test.AddInput<float>("C", {2, 1}, {1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2, 4},
+                        {5.0f, -1.0f, 2.0f, 17.5f,
+                         6.0f, -4.5f, -2.0f, 4.5f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A is stored as (K, M) = (3, 2) and B as (N, K) = (2, 3)
+TEST(ContribOpTest, TransposeMatMul2D) {
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", int64_t{1});
+  test.AddAttribute("transB", int64_t{1});
+  test.AddInput<float>("A", {3, 2}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f});
+  test.AddInput<float>("B", {2, 3}, {1.f, 0.f, -1.f, 2.f, 1.f, 0.f});
+  test.AddOutput<float>("Y", {2, 2}, {-2.f, 4.f, -2.f, 13.f});
+  test.Run();
+}
+
+// a batch of transposed A with a 2-D B broadcast to each matrix
+TEST(ContribOpTest, TransposeMatMulBatchedTransA) {
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", int64_t{1});
+  test.AddInput<float>("A", {2, 2, 2}, {1.f, 3.f, 2.f, 4.f,
+                                        0.f, 1.f, 1.f, 0.f});
+  test.AddInput<float>("B", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddOutput<float>("Y", {2, 2, 3}, {9.f, 12.f, 15.f, 19.f, 26.f, 33.f,
+                                         4.f, 5.f, 6.f, 1.f, 2.f, 3.f});
+  test.Run();
+}
+
+TEST(ContribOpTest, TransposeMatMulBatchedTransB) {
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transB", int64_t{1});
+  test.AddInput<float>("A", {2, 1, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("B", {2, 3, 2}, {1.f, 0.f, 0.f, 1.f, 1.f, 1.f,
+                                        2.f, 0.f, 0.f, 2.f, -1.f, 1.f});
+  test.AddOutput<float>("Y", {2, 1, 3}, {1.f, 2.f, 3.f, 6.f, 8.f, 1.f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -44,5 +44,23 @@ TEST(FeaturizersTests, MaxAbsScaler_double_values) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// The state is an initializer, so the transformers are created once and reused across runs
+TEST(FeaturizersTests, MaxAbsScaler_double_values_constant_state) {
+  OpTester test("MaxAbsScalarTransformer", 1, onnxruntime::kMSFeaturizersDomain);
+
+  test.AddInput<uint8_t>("State", {12}, {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 64}, true);
+
+  std::vector<double> x(1000);
+  std::vector<double> scaled(1000);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<double>(i % 9) - 4;
+    scaled[i] = x[i] / 4;
+  }
+  test.AddInput<double>("X", {10, 100}, x);
+  test.AddOutput<double>("ScaledValues", {10, 100}, scaled);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
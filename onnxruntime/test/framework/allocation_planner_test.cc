@@ -125,15 +125,25 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool memory_efficient_order = false,
+                               bool parallel_execution = false)
+      : shape_map_(shape_map),
+        memory_efficient_order_(memory_efficient_order),
+        parallel_execution_(parallel_execution) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool IsMemoryEfficientOrderEnabled() const override { return memory_efficient_order_; }
+
+  bool IsParallelExecutionEnabled() const override { return parallel_execution_; }
+
  private:
   ShapeMap* shape_map_;
+  bool memory_efficient_order_;
+  bool parallel_execution_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -150,6 +160,8 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> view_kernel_;      // a unary kernel whose output may be a view
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel_;
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -170,6 +182,9 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    view_kernel_ =
+        KernelDefBuilder().SetName("Identity").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayView(0, 0).Build();
+    concat_kernel_ = KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 11).Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -198,6 +213,23 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddViewNode(std::string& input, std::string& output) {
+    return AddNode(*view_kernel_, input, output);
+  }
+
+  onnxruntime::Node* AddConcatNode(std::initializer_list<std::string> inputs, std::string& output, int64_t axis) {
+    std::vector<onnxruntime::NodeArg*> input_args;
+    for (auto& input : inputs) {
+      input_args.push_back(Arg(input));
+    }
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), "Concat", "test op", input_args,
+                                   {Arg(output)});
+    p_node->AddAttribute("axis", axis);
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    kernel_bindings_.emplace_back(p_node, *concat_kernel_);
+    return p_node;
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg) {
     auto info = onnxruntime::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node),
                                                state_.GetInitializedTensors(), state_.GetOrtValueNameIdxMap(),
@@ -219,7 +251,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {},
+                  bool memory_efficient_order = false, bool parallel_execution = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
     state_.SetGraph(graph_);
@@ -239,7 +272,7 @@ class PlannerTest : public ::testing::Test {
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
     status = state_.CreateKernels(kernel_registry_manager);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, memory_efficient_order, parallel_execution);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, state_.GetOrtValueNameIdxMap(), test_context, plan_);
 
@@ -253,6 +286,28 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckViewedValue(const std::string& name, const std::string& viewed_name) {
+    int id, viewed_id;
+    index(name, id);
+    index(viewed_name, viewed_id);
+    EXPECT_EQ(plan_->allocation_plan[id].viewed_value, viewed_id) << "Error in viewed value for " << name;
+  }
+
+  void CheckReusedBuffer(const std::string& name, const std::string& reused_name) {
+    int id, reused_id;
+    index(name, id);
+    index(reused_name, reused_id);
+    EXPECT_EQ(plan_->allocation_plan[id].reused_buffer, reused_id) << "Error in reused buffer for " << name;
+  }
+
+  void CheckContainer(const std::string& name, const std::string& container_name, size_t offset) {
+    int id, container_id;
+    index(name, id);
+    index(container_name, container_id);
+    EXPECT_EQ(plan_->allocation_plan[id].container, container_id) << "Error in container for " << name;
+    EXPECT_EQ(plan_->allocation_plan[id].container_offset, offset) << "Error in container offset for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -415,6 +470,142 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// ViewTest: Check that a buffer is kept alive while a view into it may be used, and that a value that
+// may be a view is neither updated in-place nor reused.
+TEST_F(PlannerTest, ViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddViewNode(X2, X3);     // X3 may be a view into X2
+  AddInplaceNode(X3, X4);  // may-in-place operator, but X3 may be a view; X4: temporary
+  AddNormalNode(X4, X5);   // no in-place operator; X5: temporary
+  AddNormalNode(X5, X6);   // no in-place operator; X6: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckViewedValue(X3, X2);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  // X2 and X3 are dead by now, but only X2 can be reused
+  CheckAllocKind(X5, AllocKind::kReuse);
+  CheckReusedBuffer(X5, X2);
+  CheckAllocKind(X6, AllocKind::kAllocateOutput);
+
+  // X2 is freed together with the view into it
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X2, X3});
+  CheckFreed(3, {X4});
+}
+
+// ConcatInputsTest: Check that the inputs of Concat are allocated in its output when their shapes are known,
+// and that the output is kept alive as long as they are used.
+TEST_F(PlannerTest, ConcatInputsTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), Y("Y"), Z("Z");
+
+  // graph structure:
+  AddNormalNode(X1, X2);
+  AddNormalNode(X1, X3);
+  AddConcatNode({X2, X3}, Y, 1);  // X2 and X3 can be written directly into Y
+  AddNormalNode(Y, Z);
+
+  // simulate shape-inference results:
+  Shape input_shape{1, 2, 3};
+  Shape output_shape{1, 4, 3};
+  SetShape({{X1, &input_shape.value}, {X2, &input_shape.value}, {X3, &input_shape.value},
+            {Y, &output_shape.value}, {Z, &output_shape.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(Y, AllocKind::kAllocate);
+  CheckContainer(X2, Y, 0);
+  CheckContainer(X3, Y, 2 * 3 * sizeof(float));
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X2, X3});
+  CheckFreed(3, {Y});
+}
+
+// MemoryEfficientOrderTest: X1 is consumed by the small Q and by the chain P1 -> P2. The default order runs the
+// chain first, keeping X1 alive with P1 and P2. Running Q first lets X1 be freed as soon as P1 has run.
+TEST_F(PlannerTest, MemoryEfficientOrderTest) {
+  // tensor variables:
+  std::string X0("X0"), X1("X1"), Q("Q"), P1("P1"), P2("P2");
+
+  // graph structure:
+  AddNormalNode(X0, X1);
+  auto* q_node = AddNormalNode(X1, Q);
+  auto* p1_node = AddNormalNode(X1, P1);
+  AddNormalNode(P1, P2);
+
+  // simulate shape-inference results:
+  Shape big_shape{100, 100};
+  Shape small_shape{1};
+  SetShape({{X0, &big_shape.value}, {X1, &big_shape.value}, {Q, &small_shape.value},
+            {P1, &big_shape.value}, {P2, &big_shape.value}});
+
+  CreatePlan({}, true);
+
+  const auto& execution_plan = GetPlan().execution_plan;
+  ASSERT_EQ(execution_plan.size(), 4u);
+  EXPECT_EQ(execution_plan[1].node_index, q_node->Index());
+  EXPECT_EQ(execution_plan[2].node_index, p1_node->Index());
+
+  // X1 is freed after P1 instead of at the end
+  CheckFreed(2, {X1});
+}
+
+// BranchesTest: with parallel execution a chain stays on one branch, the second consumer of X1 starts a new branch,
+// and the join continues the branch of its first producer.
+TEST_F(PlannerTest, BranchesTest) {
+  // tensor variables:
+  std::string X0("X0"), X1("X1"), X2("X2"), X3("X3"), Y("Y"), Z("Z");
+
+  // graph structure:
+  auto* a_node = AddNormalNode(X0, X1);
+  auto* b_node = AddNormalNode(X1, X2);
+  auto* c_node = AddNormalNode(X1, X3);
+  auto* join_node = AddConcatNode({X2, X3}, Y, 0);
+  auto* d_node = AddNormalNode(Y, Z);
+
+  CreatePlan({}, false, true);
+
+  const auto& node_branches = GetPlan().node_branches;
+  ASSERT_EQ(node_branches.size(), GetGraph().MaxNodeIndex());
+  EXPECT_EQ(node_branches[a_node->Index()], 0);
+  EXPECT_EQ(node_branches[b_node->Index()], 0);
+  EXPECT_EQ(node_branches[c_node->Index()], 1);
+  EXPECT_EQ(node_branches[join_node->Index()], 0);
+  EXPECT_EQ(node_branches[d_node->Index()], 0);
+}
+
+// the sequential executor doesn't use branches
+TEST_F(PlannerTest, NoBranchesWithoutParallelExecutionTest) {
+  std::string X0("X0"), X1("X1"), X2("X2");
+  AddNormalNode(X0, X1);
+  AddNormalNode(X1, X2);
+
+  CreatePlan();
+
+  EXPECT_TRUE(GetPlan().node_branches.empty());
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
@@ -3,6 +3,8 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
+#include "core/framework/huge_page_allocator.h"
+#include "core/framework/scratch_allocator.h"
 #include "test_utils.h"
 #include "gtest/gtest.h"
 
@@ -79,5 +81,79 @@ TEST(AllocatorTest, MakeUniquePtrTest) {
   auto void_ptr = IAllocator::MakeUniquePtr<void>(allocator, 16);
   void_ptr = nullptr;
 }
+
+TEST(AllocatorTest, ScratchAllocatorTest) {
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  // without a buffer everything goes to the underlying allocator, the peak is what a buffer would need
+  size_t peak_bytes = 0;
+  {
+    ScratchAllocator scratch(cpu_allocator, 0);
+    EXPECT_EQ(scratch.Info(), cpu_allocator->Info());
+    EXPECT_EQ(scratch.Alloc(0), nullptr);
+    void* p = scratch.Alloc(100);
+    ASSERT_NE(p, nullptr);
+    memset(p, -1, 100);
+    scratch.Free(p);
+    peak_bytes = scratch.PeakBytes();
+    EXPECT_EQ(peak_bytes, 128u);
+  }
+
+  ScratchAllocator scratch(cpu_allocator, 1024);
+  void* a = scratch.Alloc(100);
+  void* b = scratch.Alloc(200);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  // allocations are 64 byte aligned and follow each other in the buffer
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 64, 0u);
+  EXPECT_EQ(static_cast<char*>(b) - static_cast<char*>(a), 128);
+
+  // past the end of the buffer
+  void* c = scratch.Alloc(1024);
+  ASSERT_NE(c, nullptr);
+  memset(c, -1, 1024);
+  EXPECT_EQ(scratch.PeakBytes(), 128u + 256u + 1024u);
+
+  scratch.Free(b);
+  scratch.Free(c);
+  // a is still live so the buffer is not rewound, and c did not take space in it
+  void* d = scratch.Alloc(10);
+  EXPECT_EQ(static_cast<char*>(d) - static_cast<char*>(a), 384);
+  scratch.Free(a);
+  scratch.Free(d);
+  // rewound once all the allocations are freed
+  void* e = scratch.Alloc(10);
+  EXPECT_EQ(e, a);
+  scratch.Free(e);
+}
+
+TEST(AllocatorTest, HugePageAllocatorTest) {
+  constexpr size_t kThreshold = 1024 * 1024;
+  HugePageAllocator allocator(kThreshold);
+  EXPECT_EQ(allocator.Info().alloc_type, OrtAllocatorType::OrtDeviceAllocator);
+
+  // below the threshold
+  void* small = allocator.Alloc(1024);
+  ASSERT_NE(small, nullptr);
+  memset(small, -1, 1024);
+  EXPECT_EQ(allocator.HugePageBytes(), 0u);
+
+  // huge pages may not be available, then the large allocation is a malloc too
+  const size_t large_size = 3 * kThreshold + 100;
+  void* large = allocator.Alloc(large_size);
+  ASSERT_NE(large, nullptr);
+  memset(large, -1, large_size);
+  EXPECT_TRUE(allocator.HugePageBytes() == 0 || allocator.HugePageBytes() >= large_size);
+#if defined(__linux__)
+  // transparent huge pages are always an option on Linux, in a 2MB aligned mapping
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % (2 * 1024 * 1024), 0u);
+  EXPECT_EQ(allocator.HugePageBytes(), 4u * 1024 * 1024);
+#endif
+
+  allocator.Free(small);
+  allocator.Free(large);
+  EXPECT_EQ(allocator.HugePageBytes(), 0u);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
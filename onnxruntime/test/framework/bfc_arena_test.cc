@@ -6,7 +6,10 @@
 #include "gtest/gtest.h"
 #include "test_utils.h"
 
+#include <condition_variable>
 #include <cstdlib>
+#include <mutex>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -238,6 +241,191 @@ TEST(BFCArenaTest, TestReserve) {
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
 
+TEST(BFCArenaTest, TestExtendStrategy) {
+  const size_t region_size = 3 * 1024 * 1024;
+
+  // the first region uses the 1MB initial chunk size. the second doubles until the request fits.
+  BFCArena power_of_two(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+                        ArenaExtendStrategy::kNextPowerOfTwo);
+  void* first_ptr = power_of_two.Alloc(256);
+  void* second_ptr = power_of_two.Alloc(region_size);
+  AllocatorStats stats;
+  power_of_two.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1024 * 1024 + 4 * 1024 * 1024);
+  power_of_two.Free(first_ptr);
+  power_of_two.Free(second_ptr);
+
+  // the second region is exactly the requested size
+  BFCArena same_as_requested(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+                             ArenaExtendStrategy::kSameAsRequested);
+  first_ptr = same_as_requested.Alloc(256);
+  second_ptr = same_as_requested.Alloc(region_size);
+  same_as_requested.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1024 * 1024 + region_size);
+  same_as_requested.Free(first_ptr);
+  same_as_requested.Free(second_ptr);
+}
+
+TEST(BFCArenaTest, TestInitialChunkSize) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 64 * 1024);
+  void* ptr = a.Alloc(256);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 64 * 1024);
+  a.Free(ptr);
+}
+
+TEST(BFCArenaTest, TestShrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kSameAsRequested);
+  void* first_ptr = a.Alloc(256);
+  void* second_ptr = a.Alloc(3 * 1024 * 1024);
+
+  // only the region without allocations in use is freed
+  a.Free(second_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1024 * 1024);
+
+  a.Free(first_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // the arena grows again from the initial chunk size
+  first_ptr = a.Alloc(256);
+  EXPECT_NE(first_ptr, nullptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1024 * 1024);
+  a.Free(first_ptr);
+}
+
+TEST(BFCArenaTest, TestThreadCache) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 1 << 20, true);
+
+  // a freed small block is reused by the next allocation of its size class on the thread
+  void* ptr = a.Alloc(1000);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0u);
+  // 1000 bytes and the 64 byte header use a 2KB block
+  EXPECT_EQ(a.RequestedSize(ptr), 2048u - 64);
+  a.Free(ptr);
+  void* reused_ptr = a.Alloc(1500);
+  EXPECT_EQ(reused_ptr, ptr);
+  a.Free(reused_ptr);
+
+  // the large allocations and the reserved buffers bypass the caches
+  void* large_ptr = a.Alloc(1 << 20);
+  EXPECT_EQ(a.RequestedSize(large_ptr), size_t{1 << 20});
+  void* reserved_ptr = a.Reserve(4096);
+  a.Free(large_ptr);
+  a.Free(reserved_ptr);
+
+  // the blocks allocated and freed on different threads are all returned by Shrink
+  std::vector<void*> ptrs(64);
+  std::thread allocating_thread([&a, &ptrs]() {
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      ptrs[i] = a.Alloc(64 << (i % 10));
+    }
+  });
+  allocating_thread.join();
+  std::thread freeing_thread([&a, &ptrs]() {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  });
+  freeing_thread.join();
+
+  ASSERT_TRUE(a.Shrink().IsOK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheOfExitedThreads) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 1 << 20, true);
+
+  // the blocks a thread caches are returned to the arena when it exits, without a Shrink
+  for (int i = 0; i < 200; ++i) {
+    std::thread thread([&a]() {
+      for (int size_class = 0; size_class < 9; ++size_class) {
+        a.Free(a.Alloc((256 << size_class) - 64));
+      }
+    });
+    thread.join();
+
+    AllocatorStats stats;
+    a.GetStats(&stats);
+    ASSERT_EQ(stats.bytes_in_use, 0);
+  }
+
+  // a thread that outlives an arena doesn't return its blocks to it, and can use a new arena
+  auto short_lived_arena = onnxruntime::make_unique<BFCArena>(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()),
+                                                              1 << 30, ArenaExtendStrategy::kNextPowerOfTwo, 1 << 20,
+                                                              true);
+  std::mutex mutex;
+  std::condition_variable cv;
+  int step = 0;
+  std::thread thread([&]() {
+    short_lived_arena->Free(short_lived_arena->Alloc(1000));
+    std::unique_lock<std::mutex> lock(mutex);
+    step = 1;
+    cv.notify_one();
+    cv.wait(lock, [&step]() { return step == 2; });
+    a.Free(a.Alloc(1000));
+  });
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&step]() { return step == 1; });
+    short_lived_arena.reset();
+    step = 2;
+    cv.notify_one();
+  }
+  thread.join();
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheAfterThreadExit) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 1 << 20, true);
+
+  // a thread_local constructed before the arena caches of its thread is destroyed after them, and frees and
+  // allocates through the arena lock
+  struct ChunkHolder {
+    BFCArena* arena = nullptr;
+    void* ptr = nullptr;
+    ~ChunkHolder() {
+      if (arena != nullptr) {
+        arena->Free(ptr);
+        arena->Free(arena->Alloc(1000));
+      }
+    }
+  };
+
+  for (int i = 0; i < 20; ++i) {
+    std::thread thread([&a]() {
+      thread_local ChunkHolder holder;
+      holder.arena = &a;
+      holder.ptr = a.Alloc(1000);
+      a.Free(a.Alloc(1000));
+    });
+    thread.join();
+
+    AllocatorStats stats;
+    a.GetStats(&stats);
+    ASSERT_EQ(stats.bytes_in_use, 0);
+  }
+}
+
 // arena is disabled for CPUExecutionProvider on x86 and JEMalloc
 #if (defined(__amd64__) || defined(_M_AMD64)) && !defined(USE_JEMALLOC)
 TEST(BFCArenaTest, UtilsAllocateBlockTest) {
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/graph/model.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_execution_provider.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+#include "cuda_runtime.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int64_t kRows = 2;
+constexpr int64_t kCols = 3;
+
+// Y = Relu(X + B) with B an initializer
+std::string CreateAddReluModel() {
+  onnxruntime::Model model("add_relu", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kRows);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kCols);
+  TypeProto b_type;
+  b_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  b_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kCols);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& b = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  TensorProto initializer;
+  initializer.set_name("B");
+  initializer.set_data_type(TensorProto_DataType_FLOAT);
+  initializer.add_dims(kCols);
+  for (int64_t i = 0; i < kCols; ++i) {
+    initializer.add_float_data(static_cast<float>(i) - 1.0f);
+  }
+  graph.AddInitializedTensor(initializer);
+
+  graph.AddNode("add", "Add", "", {&x, &b}, {&sum});
+  graph.AddNode("relu", "Relu", "", {&sum}, {&y});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  return serialized_model;
+}
+
+std::vector<float> Expected(const std::vector<float>& x) {
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    y[i] = std::max(0.0f, x[i] + static_cast<float>(i % kCols) - 1.0f);
+  }
+  return y;
+}
+
+void Write(OrtValue& value, const std::vector<float>& data) {
+  ASSERT_EQ(cudaMemcpy(value.GetMutable<Tensor>()->MutableDataRaw(), data.data(), data.size() * sizeof(float),
+                       cudaMemcpyHostToDevice),
+            cudaSuccess);
+}
+
+std::vector<float> Read(const OrtValue& value) {
+  const auto& tensor = value.Get<Tensor>();
+  std::vector<float> data(tensor.Shape().Size());
+  EXPECT_EQ(cudaMemcpy(data.data(), tensor.DataRaw(), data.size() * sizeof(float), cudaMemcpyDeviceToHost),
+            cudaSuccess);
+  return data;
+}
+
+}  // namespace
+
+// the Runs with the same bound device buffers are captured on the second Run and replayed after it. the replays read
+// the values written to the buffers in between, and a Run with other buffers gets its own graph.
+TEST(CudaGraphTest, ReplaysRunsWithTheSameBuffers) {
+  SessionOptions so;
+  so.session_logid = "CudaGraphTest";
+  InferenceSession session{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo info;
+  info.enable_cuda_graph = true;
+  auto provider = onnxruntime::make_unique<CUDAExecutionProvider>(info);
+  ASSERT_TRUE(provider->IsGraphCaptureEnabled());
+  ASSERT_TRUE(session.RegisterExecutionProvider(std::move(provider)).IsOK());
+  std::stringstream model(CreateAddReluModel());
+  ASSERT_TRUE(session.Load(model).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+
+  AllocatorPtr allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+  for (int buffers = 0; buffers < 2; ++buffers) {
+    std::vector<OrtValue> feeds(1);
+    std::vector<OrtValue> fetches(1);
+    AllocateMLValue<float>(allocator, {kRows, kCols}, &feeds[0]);
+    AllocateMLValue<float>(allocator, {kRows, kCols}, &fetches[0]);
+
+    for (int run = 0; run < 5; ++run) {
+      std::vector<float> x(kRows * kCols);
+      for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<float>((static_cast<int>(i) + run * 3 + buffers) % 5) - 2.0f;
+      }
+      Write(feeds[0], x);
+      auto status = session.Run(RunOptions{}, {"X"}, feeds, {"Y"}, &fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      EXPECT_EQ(Read(fetches[0]), Expected(x)) << "buffers " << buffers << " run " << run;
+    }
+  }
+}
+
+// a key is captured on the Run after the first one with it and replayed from then on
+TEST(CudaGraphTest, CapturesAfterWarmupRun) {
+  CUDAExecutionProviderInfo info;
+  info.enable_cuda_graph = true;
+  CUDAExecutionProvider provider(info);
+
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  EXPECT_FALSE(provider.BeginGraphCapture("key"));
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  EXPECT_FALSE(provider.IsGraphCaptured("key"));
+
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  ASSERT_TRUE(provider.BeginGraphCapture("key"));
+  ASSERT_TRUE(provider.EndGraphCapture("key", true).IsOK());
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  EXPECT_TRUE(provider.IsGraphCaptured("key"));
+
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  EXPECT_TRUE(provider.ReplayGraph("key").IsOK());
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  EXPECT_FALSE(provider.ReplayGraph("other").IsOK());
+
+  // a Run that failed while capturing is not captured again
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  EXPECT_FALSE(provider.BeginGraphCapture("failed"));
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  ASSERT_TRUE(provider.BeginGraphCapture("failed"));
+  EXPECT_FALSE(provider.EndGraphCapture("failed", false).IsOK());
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  ASSERT_TRUE(provider.OnRunStart().IsOK());
+  EXPECT_FALSE(provider.BeginGraphCapture("failed"));
+  ASSERT_TRUE(provider.OnRunEnd().IsOK());
+  EXPECT_FALSE(provider.IsGraphCaptured("failed"));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "core/graph/model.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_execution_provider.h"
+#include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+#include "cuda_runtime.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int64_t kSize = 1 << 16;
+
+// Y = Relu(X)
+std::string CreateReluModel() {
+  onnxruntime::Model model("relu", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kSize);
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+  graph.AddNode("relu", "Relu", "", {&x}, {&y});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  return serialized_model;
+}
+
+// Y = Relu(X) + Abs(Neg(X)), two branches joined by the Add
+std::string CreateTwoBranchModel() {
+  onnxruntime::Model model("two_branches", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kSize);
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& relu = graph.GetOrCreateNodeArg("relu", &type);
+  auto& neg = graph.GetOrCreateNodeArg("neg", &type);
+  auto& abs = graph.GetOrCreateNodeArg("abs", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu});
+  graph.AddNode("neg", "Neg", "", {&x}, {&neg});
+  graph.AddNode("abs", "Abs", "", {&neg}, {&abs});
+  graph.AddNode("add", "Add", "", {&relu, &abs}, {&y});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  return serialized_model;
+}
+
+}  // namespace
+
+// the inputs are written, the Runs queued and the outputs read on the stream of the application, which is only
+// synchronized once at the end. each Run reads the input written just before it.
+TEST(CudaStreamTest, RunAsyncOnUserStream) {
+  cudaStream_t stream;
+  ASSERT_EQ(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking), cudaSuccess);
+
+  // the stream outlives the session
+  {
+    SessionOptions so;
+    so.session_logid = "CudaStreamTest";
+    InferenceSession session{so, &DefaultLoggingManager()};
+    CUDAExecutionProviderInfo info;
+    info.user_compute_stream = stream;
+    auto provider = onnxruntime::make_unique<CUDAExecutionProvider>(info);
+    ASSERT_EQ(provider->ComputeStream(), stream);
+    ASSERT_TRUE(session.RegisterExecutionProvider(std::move(provider)).IsOK());
+    std::stringstream model(CreateReluModel());
+    ASSERT_TRUE(session.Load(model).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    AllocatorPtr allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+    OrtValue x, y;
+    AllocateMLValue<float>(allocator, {kSize}, &x);
+    AllocateMLValue<float>(allocator, {kSize}, &y);
+    std::unique_ptr<IOBinding> binding;
+    ASSERT_TRUE(session.NewIOBinding(&binding).IsOK());
+    ASSERT_TRUE(binding->BindInput("X", x).IsOK());
+    ASSERT_TRUE(binding->BindOutput("Y", y).IsOK());
+
+    constexpr int num_runs = 4;
+    std::vector<std::vector<float>> inputs(num_runs, std::vector<float>(kSize));
+    std::vector<std::vector<float>> results(num_runs, std::vector<float>(kSize));
+    for (int run = 0; run < num_runs; ++run) {
+      for (int64_t i = 0; i < kSize; ++i) {
+        inputs[run][i] = static_cast<float>((i + run) % 7) - 3.0f;
+      }
+      ASSERT_EQ(cudaMemcpyAsync(x.GetMutable<Tensor>()->MutableDataRaw(), inputs[run].data(), kSize * sizeof(float),
+                                cudaMemcpyHostToDevice, stream),
+                cudaSuccess);
+      auto status = session.RunAsync(RunOptions{}, *binding);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      ASSERT_EQ(cudaMemcpyAsync(results[run].data(), y.Get<Tensor>().DataRaw(), kSize * sizeof(float),
+                                cudaMemcpyDeviceToHost, stream),
+                cudaSuccess);
+    }
+    ASSERT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+
+    for (int run = 0; run < num_runs; ++run) {
+      for (int64_t i = 0; i < kSize; ++i) {
+        ASSERT_EQ(results[run][i], std::max(0.0f, inputs[run][i])) << "run " << run << " index " << i;
+      }
+    }
+  }
+
+  ASSERT_EQ(cudaStreamDestroy(stream), cudaSuccess);
+}
+
+// copying an output to CPU memory would wait for the device
+TEST(CudaStreamTest, RunAsyncNeedsDeviceOutputs) {
+  SessionOptions so;
+  so.session_logid = "CudaStreamTest";
+  InferenceSession session{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo info;
+  ASSERT_TRUE(session.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(info)).IsOK());
+  std::stringstream model(CreateReluModel());
+  ASSERT_TRUE(session.Load(model).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+
+  OrtValue x;
+  AllocateMLValue<float>(std::make_shared<CUDAAllocator>(0, CUDA), {kSize}, &x);
+  std::unique_ptr<IOBinding> binding;
+  ASSERT_TRUE(session.NewIOBinding(&binding).IsOK());
+  ASSERT_TRUE(binding->BindInput("X", x).IsOK());
+
+  OrtValue cpu_y;
+  AllocateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {kSize}, &cpu_y);
+  ASSERT_TRUE(binding->BindOutput("Y", cpu_y).IsOK());
+  EXPECT_FALSE(session.RunAsync(RunOptions{}, *binding).IsOK());
+
+  OrtValue y;
+  AllocateMLValue<float>(std::make_shared<CUDAAllocator>(0, CUDA), {kSize}, &y);
+  ASSERT_TRUE(binding->BindOutput("Y", y).IsOK());
+  EXPECT_TRUE(session.RunAsync(RunOptions{}, *binding).IsOK());
+  EXPECT_TRUE(binding->SynchronizeOutputs().IsOK());
+}
+
+// the branches of parallel execution run on streams of their own, the join waits for both, and the outputs copied
+// after the Run are complete
+TEST(CudaStreamTest, ParallelBranchStreams) {
+  SessionOptions so;
+  so.session_logid = "CudaStreamTest";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  InferenceSession session{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo info;
+  info.branch_stream_count = 2;
+  auto provider = onnxruntime::make_unique<CUDAExecutionProvider>(info);
+  ASSERT_TRUE(provider->UsesBranchStreams());
+  ASSERT_TRUE(session.RegisterExecutionProvider(std::move(provider)).IsOK());
+  std::stringstream model(CreateTwoBranchModel());
+  ASSERT_TRUE(session.Load(model).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+
+  for (int run = 0; run < 4; ++run) {
+    std::vector<float> x(kSize);
+    for (int64_t i = 0; i < kSize; ++i) {
+      x[i] = static_cast<float>((i + run) % 7) - 3.0f;
+    }
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {kSize}, x, &feeds[0]);
+    std::vector<OrtValue> fetches;
+    auto status = session.Run(RunOptions{}, {"X"}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    const float* y = fetches[0].Get<Tensor>().Data<float>();
+    for (int64_t i = 0; i < kSize; ++i) {
+      ASSERT_EQ(y[i], std::max(0.0f, x[i]) + std::abs(x[i])) << "run " << run << " index " << i;
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
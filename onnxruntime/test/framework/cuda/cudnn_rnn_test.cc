@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <sstream>
+
+#include "core/graph/model.h"
+#include "core/providers/cuda/cuda_execution_provider.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int64_t kInputSize = 3;
+constexpr int64_t kHiddenSize = 4;
+
+std::vector<float> MakeValues(int64_t count, float scale, int seed) {
+  std::vector<float> values(count);
+  for (int64_t i = 0; i < count; ++i) {
+    values[i] = scale * std::sin(static_cast<float>(i * 7 + seed));
+  }
+  return values;
+}
+
+// an LSTM with X of shape [seq_length, batch_size, kInputSize]. the weights are initializers, which the CUDA kernel
+// packs once, unless weights_as_inputs is set.
+std::string CreateLstmModel(const std::string& direction, bool weights_as_inputs) {
+  const int64_t num_directions = direction == "bidirectional" ? 2 : 1;
+  onnxruntime::Model model("lstm", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  // -1 is the free sequence length and -2 the free batch size
+  auto tensor_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto* shape = type.mutable_tensor_type()->mutable_shape();
+    for (auto dim : dims) {
+      if (dim < 0) {
+        shape->add_dim()->set_dim_param(dim == -1 ? "seq" : "batch");
+      } else {
+        shape->add_dim()->set_dim_value(dim);
+      }
+    }
+    return type;
+  };
+
+  auto x_type = tensor_type({-1, -2, kInputSize});
+  auto y_type = tensor_type({-1, num_directions, -2, kHiddenSize});
+  auto y_h_type = tensor_type({num_directions, -2, kHiddenSize});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &y_type);
+  auto& y_h = graph.GetOrCreateNodeArg("Y_h", &y_h_type);
+
+  std::vector<NodeArg*> inputs{&x};
+  const std::vector<std::pair<std::string, std::vector<int64_t>>> weights{
+      {"W", {num_directions, 4 * kHiddenSize, kInputSize}},
+      {"R", {num_directions, 4 * kHiddenSize, kHiddenSize}},
+      {"B", {num_directions, 8 * kHiddenSize}}};
+  int seed = 0;
+  for (const auto& weight : weights) {
+    auto type = tensor_type(weight.second);
+    inputs.push_back(&graph.GetOrCreateNodeArg(weight.first, &type));
+
+    TensorProto initializer;
+    initializer.set_name(weight.first);
+    initializer.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t count = 1;
+    for (auto dim : weight.second) {
+      initializer.add_dims(dim);
+      count *= dim;
+    }
+    for (float value : MakeValues(count, 0.5f, ++seed)) {
+      initializer.add_float_data(value);
+    }
+    if (!weights_as_inputs) {
+      graph.AddInitializedTensor(initializer);
+    }
+  }
+
+  auto& node = graph.AddNode("lstm", "LSTM", "", inputs, {&y, &y_h});
+  node.AddAttribute("hidden_size", kHiddenSize);
+  node.AddAttribute("direction", direction);
+  EXPECT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  return serialized_model;
+}
+
+std::vector<std::vector<float>> Run(InferenceSession& session, const NameMLValMap& feeds) {
+  std::vector<OrtValue> fetches;
+  auto status = session.Run(RunOptions{}, feeds, {"Y", "Y_h"}, &fetches);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::vector<std::vector<float>> results;
+  for (const auto& fetch : fetches) {
+    const auto& tensor = fetch.Get<Tensor>();
+    results.emplace_back(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+  }
+  return results;
+}
+
+// one CUDA session runs with sequence lengths and batch sizes in turn, so its kernel reuses the descriptor it set up
+// when it was created and the persistent descriptors it cached per batch size. each result is compared with a new
+// CPU session.
+void TestCudnnRnnDescriptorCache(const std::string& direction, bool weights_as_inputs,
+                                 int64_t persist_max_batch_size) {
+  const std::string serialized_model = CreateLstmModel(direction, weights_as_inputs);
+  const int64_t num_directions = direction == "bidirectional" ? 2 : 1;
+
+  SessionOptions so;
+  so.session_logid = "CudnnRnnDescriptorCache";
+  InferenceSession cuda_session{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo info;
+  info.cudnn_rnn_persist_max_batch_size = persist_max_batch_size;
+  ASSERT_TRUE(cuda_session.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(info)).IsOK());
+  std::stringstream cuda_model(serialized_model);
+  ASSERT_TRUE(cuda_session.Load(cuda_model).IsOK());
+  ASSERT_TRUE(cuda_session.Initialize().IsOK());
+
+  InferenceSession cpu_session{so, &DefaultLoggingManager()};
+  std::stringstream cpu_model(serialized_model);
+  ASSERT_TRUE(cpu_session.Load(cpu_model).IsOK());
+  ASSERT_TRUE(cpu_session.Initialize().IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  // the batch sizes above persist_max_batch_size use the standard algorithm, and the batch sizes seen before reuse
+  // their cached descriptor
+  const std::vector<std::pair<int64_t, int64_t>> shapes{{5, 1}, {5, 2}, {3, 2}, {7, 8}, {1, 1}, {5, 2}, {2, 5}};
+  int seed = 100;
+  for (const auto& shape : shapes) {
+    const int64_t seq_length = shape.first;
+    const int64_t batch_size = shape.second;
+    NameMLValMap feeds;
+    OrtValue x;
+    CreateMLValue<float>(allocator, {seq_length, batch_size, kInputSize},
+                         MakeValues(seq_length * batch_size * kInputSize, 1.0f, ++seed), &x);
+    feeds.emplace("X", x);
+    if (weights_as_inputs) {
+      OrtValue w, r, b;
+      CreateMLValue<float>(allocator, {num_directions, 4 * kHiddenSize, kInputSize},
+                           MakeValues(num_directions * 4 * kHiddenSize * kInputSize, 0.5f, 1), &w);
+      CreateMLValue<float>(allocator, {num_directions, 4 * kHiddenSize, kHiddenSize},
+                           MakeValues(num_directions * 4 * kHiddenSize * kHiddenSize, 0.5f, 2), &r);
+      CreateMLValue<float>(allocator, {num_directions, 8 * kHiddenSize},
+                           MakeValues(num_directions * 8 * kHiddenSize, 0.5f, 3), &b);
+      feeds.emplace("W", w);
+      feeds.emplace("R", r);
+      feeds.emplace("B", b);
+    }
+
+    auto expected = Run(cpu_session, feeds);
+    auto results = Run(cuda_session, feeds);
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      ASSERT_EQ(results[i].size(), expected[i].size());
+      for (size_t j = 0; j < results[i].size(); ++j) {
+        EXPECT_NEAR(results[i][j], expected[i][j], 1e-4f)
+            << "output " << i << " seq_length " << seq_length << " batch_size " << batch_size;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(CudnnRnnTest, DescriptorCache) {
+  TestCudnnRnnDescriptorCache("forward", false, 0);
+  TestCudnnRnnDescriptorCache("reverse", false, 0);
+  TestCudnnRnnDescriptorCache("bidirectional", true, 0);
+}
+
+TEST(CudnnRnnTest, PersistentDescriptorCache) {
+  TestCudnnRnnDescriptorCache("forward", false, 4);
+  TestCudnnRnnDescriptorCache("bidirectional", false, 4);
+  TestCudnnRnnDescriptorCache("forward", true, 4);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
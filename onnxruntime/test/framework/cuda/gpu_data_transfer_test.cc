@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/tensor.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+#include "cuda_runtime.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// the size of the largest copy GPUDataTransfer stages through its pinned buffers
+constexpr size_t kMaxStagingBytes = 16 * 1024 * 1024;
+
+std::vector<uint8_t> MakePattern(size_t bytes, int seed) {
+  std::vector<uint8_t> data(bytes);
+  for (size_t i = 0; i < bytes; ++i) {
+    data[i] = static_cast<uint8_t>((i * 31 + seed * 7) & 0xff);
+  }
+  return data;
+}
+
+std::unique_ptr<Tensor> CreateTensor(size_t bytes, AllocatorPtr allocator) {
+  return onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<uint8_t>(),
+                                          TensorShape({static_cast<int64_t>(bytes)}), allocator);
+}
+
+std::vector<uint8_t> ReadDevice(const Tensor& tensor) {
+  std::vector<uint8_t> data(tensor.SizeInBytes());
+  EXPECT_EQ(cudaMemcpy(data.data(), tensor.DataRaw(), data.size(), cudaMemcpyDeviceToHost), cudaSuccess);
+  return data;
+}
+
+}  // namespace
+
+// more copies from pageable memory than there are staging buffers, with the sources overwritten as soon as each
+// copy returns: a staging buffer must not be reused before the copy queued from it is done.
+TEST(GPUDataTransferTest, PageableCopiesInFlight) {
+  GPUDataTransfer data_transfer;
+  AllocatorPtr cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  AllocatorPtr cuda_allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+
+  constexpr int num_copies = 16;
+  constexpr size_t bytes = 1024 * 1024 + 3;
+  auto src = CreateTensor(bytes, cpu_allocator);
+  std::vector<std::unique_ptr<Tensor>> dst;
+  for (int i = 0; i < num_copies; ++i) {
+    auto pattern = MakePattern(bytes, i);
+    memcpy(src->MutableDataRaw(), pattern.data(), bytes);
+    dst.push_back(CreateTensor(bytes, cuda_allocator));
+    ASSERT_TRUE(data_transfer.CopyTensor(*src, *dst.back(), kCudaStreamDefault).IsOK());
+    memset(src->MutableDataRaw(), 0xff, bytes);
+  }
+
+  ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+  for (int i = 0; i < num_copies; ++i) {
+    EXPECT_EQ(ReadDevice(*dst[i]), MakePattern(bytes, i)) << "copy " << i;
+  }
+}
+
+// the copies of exactly kMaxStagingBytes are staged, the larger ones go straight from the pageable memory
+TEST(GPUDataTransferTest, PageableCopiesAtStagingLimit) {
+  GPUDataTransfer data_transfer;
+  AllocatorPtr cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  AllocatorPtr cuda_allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+
+  int seed = 0;
+  for (size_t bytes : {kMaxStagingBytes, kMaxStagingBytes + 1, kMaxStagingBytes - 1, size_t{1}}) {
+    auto pattern = MakePattern(bytes, ++seed);
+    auto src = CreateTensor(bytes, cpu_allocator);
+    memcpy(src->MutableDataRaw(), pattern.data(), bytes);
+    auto dst = CreateTensor(bytes, cuda_allocator);
+    ASSERT_TRUE(data_transfer.CopyTensor(*src, *dst, kCudaStreamDefault).IsOK());
+    memset(src->MutableDataRaw(), 0, bytes);
+
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+    EXPECT_EQ(ReadDevice(*dst), pattern) << bytes << " bytes";
+  }
+}
+
+// a batch of small tensors that needs several scatter and gather kernels, with the tensors at offsets that don't
+// allow the vectorized copies, copied to the device and back
+TEST(GPUDataTransferTest, CopyTensorsBatch) {
+  GPUDataTransfer data_transfer;
+  AllocatorPtr cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto cuda_allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+
+  constexpr size_t num_tensors = 2 * cuda::DeviceCopyBatch::kMaxItems + 17;
+  const size_t sizes[] = {1, 3, 16, 17, 64, 255, 4096, 4099, 64 * 1024};
+  const size_t offsets[] = {0, 1, 3, 8, 16};
+
+  // the tensors are placed in one buffer per device so their alignments can be chosen
+  std::vector<size_t> tensor_sizes(num_tensors);
+  std::vector<size_t> tensor_offsets(num_tensors);
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < num_tensors; ++i) {
+    tensor_sizes[i] = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+    total_bytes = (total_bytes + 15) / 16 * 16 + offsets[i % (sizeof(offsets) / sizeof(offsets[0]))];
+    tensor_offsets[i] = total_bytes;
+    total_bytes += tensor_sizes[i];
+  }
+
+  auto* host_src_buffer = static_cast<uint8_t*>(cpu_allocator->Alloc(total_bytes));
+  auto* host_dst_buffer = static_cast<uint8_t*>(cpu_allocator->Alloc(total_bytes));
+  auto* device_buffer = static_cast<uint8_t*>(cuda_allocator->Alloc(total_bytes));
+  memset(host_dst_buffer, 0, total_bytes);
+
+  std::vector<std::unique_ptr<Tensor>> host_src, device, host_dst;
+  std::vector<const Tensor*> to_device_src, to_host_src;
+  std::vector<Tensor*> to_device_dst, to_host_dst;
+  for (size_t i = 0; i < num_tensors; ++i) {
+    TensorShape shape({static_cast<int64_t>(tensor_sizes[i])});
+    auto type = DataTypeImpl::GetType<uint8_t>();
+    auto pattern = MakePattern(tensor_sizes[i], static_cast<int>(i));
+    memcpy(host_src_buffer + tensor_offsets[i], pattern.data(), tensor_sizes[i]);
+
+    host_src.push_back(onnxruntime::make_unique<Tensor>(type, shape, host_src_buffer + tensor_offsets[i],
+                                                        cpu_allocator->Info()));
+    device.push_back(onnxruntime::make_unique<Tensor>(type, shape, device_buffer + tensor_offsets[i],
+                                                      cuda_allocator->Info()));
+    host_dst.push_back(onnxruntime::make_unique<Tensor>(type, shape, host_dst_buffer + tensor_offsets[i],
+                                                        cpu_allocator->Info()));
+    to_device_src.push_back(host_src.back().get());
+    to_device_dst.push_back(device.back().get());
+    to_host_src.push_back(device.back().get());
+    to_host_dst.push_back(host_dst.back().get());
+  }
+
+  ASSERT_TRUE(data_transfer.CopyTensors(to_device_src, to_device_dst).IsOK());
+  // the copies to the host are synchronized before CopyTensors returns
+  ASSERT_TRUE(data_transfer.CopyTensors(to_host_src, to_host_dst).IsOK());
+
+  for (size_t i = 0; i < num_tensors; ++i) {
+    std::vector<uint8_t> copied(host_dst_buffer + tensor_offsets[i],
+                                host_dst_buffer + tensor_offsets[i] + tensor_sizes[i]);
+    EXPECT_EQ(copied, MakePattern(tensor_sizes[i], static_cast<int>(i))) << "tensor " << i;
+  }
+
+  // the bytes between the tensors are left alone
+  std::vector<uint8_t> expected(total_bytes, 0);
+  for (size_t i = 0; i < num_tensors; ++i) {
+    auto pattern = MakePattern(tensor_sizes[i], static_cast<int>(i));
+    std::copy(pattern.begin(), pattern.end(), expected.begin() + tensor_offsets[i]);
+  }
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), host_dst_buffer));
+
+  cpu_allocator->Free(host_src_buffer);
+  cpu_allocator->Free(host_dst_buffer);
+  cuda_allocator->Free(device_buffer);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/data_transfer_manager.h"
+
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// CPU data transfer that counts how it's called
+class CountingDataTransfer : public CPUDataTransfer {
+ public:
+  using IDataTransfer::CopyTensors;
+  common::Status CopyTensors(const std::vector<const Tensor*>& src, const std::vector<Tensor*>& dst) const override {
+    ++num_batches;
+    num_batched_tensors += src.size();
+    return IDataTransfer::CopyTensors(src, dst);
+  }
+
+  mutable size_t num_batches = 0;
+  mutable size_t num_batched_tensors = 0;
+};
+}  // namespace
+
+TEST(DataTransferManagerTest, CopyTensorsInOneBatch) {
+  DataTransferManager manager;
+  auto data_transfer = onnxruntime::make_unique<CountingDataTransfer>();
+  const auto* counting = data_transfer.get();
+  ASSERT_TRUE(manager.RegisterDataTransfer(std::move(data_transfer)).IsOK());
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<std::unique_ptr<Tensor>> src_tensors;
+  std::vector<std::unique_ptr<Tensor>> dst_tensors;
+  std::vector<const Tensor*> src;
+  std::vector<Tensor*> dst;
+  for (int i = 0; i < 3; ++i) {
+    src_tensors.push_back(onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape({i + 1}),
+                                                           allocator));
+    dst_tensors.push_back(onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape({i + 1}),
+                                                           allocator));
+    for (int j = 0; j <= i; ++j) {
+      src_tensors.back()->MutableData<float>()[j] = static_cast<float>(i * 10 + j);
+    }
+    src.push_back(src_tensors.back().get());
+    dst.push_back(dst_tensors.back().get());
+  }
+
+  ASSERT_TRUE(manager.CopyTensors(src, dst).IsOK());
+  EXPECT_EQ(counting->num_batches, 1u);
+  EXPECT_EQ(counting->num_batched_tensors, 3u);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      EXPECT_EQ(dst_tensors[i]->Data<float>()[j], static_cast<float>(i * 10 + j));
+    }
+  }
+
+  // the sizes must match
+  Tensor mismatch(DataTypeImpl::GetType<float>(), TensorShape({5}), allocator);
+  dst[0] = &mismatch;
+  EXPECT_FALSE(manager.CopyTensors(src, dst).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -90,9 +90,10 @@ TEST_F(ExecutionFrameTest, TensorAllocationTest) {
   OrtValue* p_ml_value = frame.GetMutableNodeInputOrOutputMLValue(0);
   Tensor* p_tensor = p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
   EXPECT_TRUE(p_tensor);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&p_tensor->Shape()), *reinterpret_cast<const std::vector<int64_t>*>(&shape));
+  EXPECT_EQ(p_tensor->Shape().GetDimsAsVector(), shape.GetDimsAsVector());
   EXPECT_EQ(p_tensor->DataType(), DataTypeImpl::GetType<float>());
+  // 6 floats rounded up to the 64 byte alignment
+  EXPECT_EQ(frame.GetPeakAllocatedBytes(), 64);
 
   //test share memory from tensor
   TensorShape shape2(std::vector<int64_t>{3, 2});
@@ -107,9 +108,10 @@ TEST_F(ExecutionFrameTest, TensorAllocationTest) {
   const OrtValue* p_ml_value_const = frame.GetNodeInputOrOutputMLValue(1);
   auto tensor2 = p_ml_value_const ? &(p_ml_value_const->Get<Tensor>()) : nullptr;
   EXPECT_TRUE(tensor2);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&tensor2->Shape()), *reinterpret_cast<const std::vector<int64_t>*>(&shape2));
+  EXPECT_EQ(tensor2->Shape().GetDimsAsVector(), shape2.GetDimsAsVector());
   EXPECT_EQ(tensor2->template Data<float>(), p_tensor->template Data<float>());
+  // the shared buffer is not counted again
+  EXPECT_EQ(frame.GetPeakAllocatedBytes(), 64);
 }
 
 TEST_F(ExecutionFrameTest, FeedInDataTest) {
@@ -157,8 +159,7 @@ TEST_F(ExecutionFrameTest, FeedInDataTest) {
   OrtValue* p_ml_value = frame.GetMutableNodeInputOrOutputMLValue(0);
   Tensor* p_tensor_arg_0 = p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
   EXPECT_TRUE(p_tensor_arg_0);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&p_tensor_arg_0->Shape()), *reinterpret_cast<const std::vector<int64_t>*>(&shape));
+  EXPECT_EQ(p_tensor_arg_0->Shape().GetDimsAsVector(), shape.GetDimsAsVector());
   EXPECT_EQ(p_tensor_arg_0->DataType(), DataTypeImpl::GetType<float>());
   EXPECT_EQ(p_tensor_arg_0->MutableData<float>(), value.GetMutable<Tensor>()->MutableData<float>());
 }
@@ -306,5 +307,259 @@ TEST(ExecutionFrameTestWithoutSessionState, BadModelInvalidDimParamUsage) {
   EXPECT_THAT(st.ErrorMessage(), testing::HasSubstr("Shape mismatch attempting to re-use buffer."));
 }
 
+TEST_F(ExecutionFrameTest, ValuesStorageReusedAcrossFrames) {
+  onnxruntime::Model model("test", false, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  onnxruntime::Node* node = &graph.AddNode("node1", "Relu", "Relu operator", ArgMap{&input_def}, ArgMap{&output_def});
+  node->SetExecutionProviderType(kCpuExecutionProvider);
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  KernelRegistryManager kernel_registry_manager;
+  status = kernel_registry_manager.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionState state{execution_providers, true, &tp_, nullptr};
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  SequentialPlannerContext context(ExecutionMode::ORT_SEQUENTIAL);
+  status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         state.GetOrtValueNameIdxMap(), context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  const size_t num_values = static_cast<size_t>(state.GetOrtValueNameIdxMap().MaxIdx()) + 1;
+  EXPECT_TRUE(state.AcquireFrameResources(nullptr).values.empty());
+
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({}, {}, {}, outputs, {}, state);
+    int start_index = frame.GetNodeOffset(node->Index());
+    OrtValue& value = *frame.GetMutableNodeInputOrOutputMLValue(start_index);
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(
+        value, start_index, DataTypeImpl::GetType<float>(),
+        execution_providers.Get(xp_typ)->GetAllocator(0, OrtMemTypeDefault)->Info(),
+        TensorShape(std::vector<int64_t>{2, 3}));
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // the frame released its values and returned the storage
+  ExecutionFrameResources resources = state.AcquireFrameResources(nullptr);
+  ASSERT_EQ(resources.values.size(), num_values);
+  for (const auto& value : resources.values) {
+    EXPECT_FALSE(value.IsAllocated());
+  }
+  state.ReleaseFrameResources(std::move(resources));
+
+  // the next frame takes the storage
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({}, {}, {}, outputs, {}, state);
+    EXPECT_TRUE(state.AcquireFrameResources(nullptr).values.empty());
+    EXPECT_FALSE(frame.GetNodeInputOrOutputMLValue(frame.GetNodeOffset(node->Index()))->IsAllocated());
+  }
+}
+
+// a frame with the memory patterns of a previous frame reuses the buffers it allocated for them, the frame of other
+// patterns allocates its own
+TEST_F(ExecutionFrameTest, MemPatternBuffersReusedAcrossFrames) {
+  onnxruntime::Model model("test", false, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), relu_def("T", &tensor_float), output_def("Y", &tensor_float);
+
+  onnxruntime::Node* node = &graph.AddNode("node1", "Relu", "Relu operator", ArgMap{&input_def}, ArgMap{&relu_def});
+  node->SetExecutionProviderType(kCpuExecutionProvider);
+  graph.AddNode("node2", "Relu", "Relu operator", ArgMap{&relu_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  KernelRegistryManager kernel_registry_manager;
+  status = kernel_registry_manager.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionState state{execution_providers, true, &tp_, nullptr};
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  SequentialPlannerContext context(ExecutionMode::ORT_SEQUENTIAL);
+  status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         state.GetOrtValueNameIdxMap(), context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  int x_idx, t_idx;
+  ASSERT_TRUE(state.GetOrtValueNameIdxMap().GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(state.GetOrtValueNameIdxMap().GetIdx("T", t_idx).IsOK());
+  auto cpu_allocator = execution_providers.Get(xp_typ)->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &x);
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes{std::cref(x.Get<Tensor>().Shape())};
+
+  // allocates T in the buffer of the patterns if the frame has them and returns its address
+  auto allocate_t = [&](ExecutionFrame& frame) -> const void* {
+    OrtValue& t = *frame.GetMutableNodeInputOrOutputMLValue(frame.GetNodeOffset(node->Index()) + 1);
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(t, t_idx, DataTypeImpl::GetType<float>(), cpu_allocator->Info(),
+                                                      TensorShape(std::vector<int64_t>{2, 3}));
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    return t.Get<Tensor>().DataRaw();
+  };
+
+  // the first frame traces the allocations for the patterns
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {x}, {}, outputs, {}, state);
+    ASSERT_TRUE(frame.HasMemoryPatternPlanner());
+    allocate_t(frame);
+    auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
+    ASSERT_TRUE(frame.GeneratePatterns(mem_patterns.get()).IsOK());
+    ASSERT_TRUE(state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)).IsOK());
+  }
+  auto mem_patterns = state.GetMemoryPatternGroup(input_shapes);
+  ASSERT_NE(mem_patterns, nullptr);
+  ASSERT_GT(mem_patterns->GetPatterns(cpu_allocator->Info())->PeakSize(), 0u);
+
+  const void* t_data = nullptr;
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {x}, {}, outputs, {}, state);
+    ASSERT_FALSE(frame.HasMemoryPatternPlanner());
+    t_data = allocate_t(frame);
+  }
+
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {x}, {}, outputs, {}, state);
+    EXPECT_EQ(allocate_t(frame), t_data);
+    // the frame took the buffers, the resources left have none for the patterns
+    EXPECT_TRUE(state.AcquireFrameResources(mem_patterns.get()).buffers.empty());
+  }
+
+  // the buffers are kept with the patterns only
+  EXPECT_TRUE(state.AcquireFrameResources(nullptr).buffers.empty());
+
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {x}, {}, outputs, {}, state);
+  }
+  state.ClearFrameResources();
+  EXPECT_TRUE(state.AcquireFrameResources(mem_patterns.get()).values.empty());
+}
+
+// with shape bucketing, the pattern traced for the shapes of one Run is re-planned by a Run of the same bucket with
+// larger shapes, and then fits both
+TEST_F(ExecutionFrameTest, MemPatternGrowsToLargestShapesOfBucket) {
+  onnxruntime::Model model("test", false, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), relu_def("T", &tensor_float), output_def("Y", &tensor_float);
+
+  onnxruntime::Node* node = &graph.AddNode("node1", "Relu", "Relu operator", ArgMap{&input_def}, ArgMap{&relu_def});
+  node->SetExecutionProviderType(kCpuExecutionProvider);
+  graph.AddNode("node2", "Relu", "Relu operator", ArgMap{&relu_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  KernelRegistryManager kernel_registry_manager;
+  status = kernel_registry_manager.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionState state{execution_providers, true, &tp_, nullptr};
+  state.SetMemoryPatternCacheOptions(true, 0);
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  SequentialPlannerContext context(ExecutionMode::ORT_SEQUENTIAL);
+  status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         state.GetOrtValueNameIdxMap(), context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  int x_idx, t_idx;
+  ASSERT_TRUE(state.GetOrtValueNameIdxMap().GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(state.GetOrtValueNameIdxMap().GetIdx("T", t_idx).IsOK());
+  auto cpu_allocator = execution_providers.Get(xp_typ)->GetAllocator(0, OrtMemTypeDefault);
+
+  // {4, 20} and {4, 30} are both in the bucket {4, 32}
+  OrtValue small_x, large_x;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{4, 20}, std::vector<float>(80, 1.0f), &small_x);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{4, 30}, std::vector<float>(120, 1.0f), &large_x);
+
+  // allocates T with the shape of x, and caches the patterns like the executor does after the Run
+  auto run = [&](const OrtValue& x) {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {x}, {}, outputs, {}, state);
+    OrtValue& t = *frame.GetMutableNodeInputOrOutputMLValue(frame.GetNodeOffset(node->Index()) + 1);
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(t, t_idx, DataTypeImpl::GetType<float>(), cpu_allocator->Info(),
+                                                      x.Get<Tensor>().Shape());
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_TRUE(frame.ReleaseMLValue(t_idx).IsOK());
+
+    if (frame.ShouldCacheMemoryPatterns()) {
+      std::vector<std::reference_wrapper<const TensorShape>> input_shapes{std::cref(x.Get<Tensor>().Shape())};
+      auto mem_patterns = onnxruntime::make_unique<MemoryPatternGroup>();
+      ASSERT_TRUE(frame.GeneratePatterns(mem_patterns.get()).IsOK());
+      ASSERT_TRUE(state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns),
+                                                      frame.GetMemoryPatterns())
+                      .IsOK());
+    }
+  };
+
+  auto t_block_size = [&]() -> size_t {
+    std::vector<std::reference_wrapper<const TensorShape>> input_shapes{std::cref(small_x.Get<Tensor>().Shape())};
+    auto mem_patterns = state.GetMemoryPatternGroup(input_shapes);
+    if (!mem_patterns) {
+      return 0;
+    }
+    const MemoryBlock* block = mem_patterns->GetPatterns(cpu_allocator->Info())->GetBlock(t_idx);
+    return block != nullptr ? block->size_ : 0;
+  };
+
+  run(small_x);
+  EXPECT_EQ(t_block_size(), 320u);
+
+  // T doesn't fit, the pattern is re-planned for the larger shape
+  run(large_x);
+  const size_t large_t_size = t_block_size();
+  EXPECT_GE(large_t_size, 480u);
+
+  // both shapes fit now, and the pattern is kept
+  for (const auto* x : {&small_x, &large_x}) {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {*x}, {}, outputs, {}, state);
+    OrtValue& t = *frame.GetMutableNodeInputOrOutputMLValue(frame.GetNodeOffset(node->Index()) + 1);
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(t, t_idx, DataTypeImpl::GetType<float>(), cpu_allocator->Info(),
+                                                      x->Get<Tensor>().Shape());
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_FALSE(frame.ShouldCacheMemoryPatterns());
+  }
+  EXPECT_EQ(t_block_size(), large_t_size);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().size, 1u);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/compute_capability.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/fuse_nodes_funcs.h"
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "test/framework/dummy_provider.h"
+#include "test/test_environment.h"
+#include "test/util/include/default_providers.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Claims the Neg and MatMul nodes. As the DummyExecutionProvider has its own allocator, the values passed between
+// its nodes and the CPU nodes need copies.
+class NegMatMulExecutionProvider : public DummyExecutionProvider {
+ public:
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const GraphViewer& graph_viewer, const std::vector<const KernelRegistry*>&) const override {
+    std::vector<std::unique_ptr<ComputeCapability>> result;
+    for (auto& node : graph_viewer.Nodes()) {
+      if (node.OpType() == "Neg" || node.OpType() == "MatMul") {
+        auto sub_graph = onnxruntime::make_unique<IndexedSubGraph>();
+        sub_graph->nodes.push_back(node.Index());
+        result.push_back(onnxruntime::make_unique<ComputeCapability>(std::move(sub_graph)));
+      }
+    }
+    return result;
+  }
+};
+
+// X -> Neg -> Abs -> MatMul -> Y, with Abs only supported on CPU.
+static void PartitionNegAbsMatMul(bool enable_cost_based_placement, std::map<std::string, std::string>& placements) {
+  Model model("PartitionNegAbsMatMul", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256);
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  weights.add_dims(256);
+  weights.add_dims(256);
+  weights.mutable_float_data()->Resize(256 * 256, 0.f);
+  graph.AddInitializedTensor(weights);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_type);
+  auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &float_type);
+  auto& abs_out = graph.GetOrCreateNodeArg("abs_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  graph.AddNode("neg", "Neg", "", {&x}, {&neg_out});
+  graph.AddNode("abs", "Abs", "", {&neg_out}, {&abs_out});
+  graph.AddNode("matmul", "MatMul", "", {&abs_out, &w}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  ExecutionProviders execution_providers;
+  status = execution_providers.Add("NegMatMulExecutionProvider", onnxruntime::make_unique<NegMatMulExecutionProvider>());
+  ASSERT_TRUE(status.IsOK()) << status;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(kCpuExecutionProvider, onnxruntime::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  FuncManager func_mgr;
+  GraphPartitioner partitioner(krm, execution_providers, enable_cost_based_placement);
+  status = partitioner.Partition(graph, false, func_mgr);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  for (const auto& node : graph.Nodes()) {
+    placements[node.OpType()] = node.GetExecutionProviderType();
+  }
+}
+
+TEST(GraphPartitionerTest, GreedyPlacement) {
+  std::map<std::string, std::string> placements;
+  PartitionNegAbsMatMul(false, placements);
+  EXPECT_EQ(placements["Neg"], "DummyExecutionProvider");
+  EXPECT_EQ(placements["Abs"], kCpuExecutionProvider);
+  EXPECT_EQ(placements["MatMul"], "DummyExecutionProvider");
+}
+
+// Copying the input and output of Neg costs more than it saves, while the MatMul is worth the copies.
+TEST(GraphPartitionerTest, CostBasedPlacement) {
+  std::map<std::string, std::string> placements;
+  PartitionNegAbsMatMul(true, placements);
+  EXPECT_EQ(placements["Neg"], kCpuExecutionProvider);
+  EXPECT_EQ(placements["Abs"], kCpuExecutionProvider);
+  EXPECT_EQ(placements["MatMul"], "DummyExecutionProvider");
+}
+
+#ifdef USE_CUDA
+// X -> Shape -> Reshape(shape, Shape(shape)) -> Reshape(X, ...) -> Y. The shape computation in the middle reads its
+// shape input on CPU, and its result is only read on CPU by the last Reshape, so it stays on CPU with its inputs.
+TEST(GraphPartitionerTest, CudaShapeComputationOnCpu) {
+  Model model("CudaShapeComputationOnCpu", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto int64_type;
+  int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", &int64_type);
+  auto& shape_shape_out = graph.GetOrCreateNodeArg("shape_shape_out", &int64_type);
+  auto& new_shape = graph.GetOrCreateNodeArg("new_shape", &int64_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape_out});
+  graph.AddNode("shape_shape", "Shape", "", {&shape_out}, {&shape_shape_out});
+  graph.AddNode("reshape_shape", "Reshape", "", {&shape_out, &shape_shape_out}, {&new_shape});
+  graph.AddNode("reshape", "Reshape", "", {&x, &new_shape}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  ExecutionProviders execution_providers;
+  status = execution_providers.Add(kCudaExecutionProvider, DefaultCudaExecutionProvider());
+  ASSERT_TRUE(status.IsOK()) << status;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(kCpuExecutionProvider, onnxruntime::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  FuncManager func_mgr;
+  GraphPartitioner partitioner(krm, execution_providers, false);
+  status = partitioner.Partition(graph, false, func_mgr);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, std::string> placements;
+  for (const auto& node : graph.Nodes()) {
+    placements[node.Name()] = node.GetExecutionProviderType();
+  }
+  EXPECT_EQ(placements["shape"], kCudaExecutionProvider);
+  EXPECT_EQ(placements["reshape_shape"], kCpuExecutionProvider);
+  EXPECT_EQ(placements["reshape"], kCudaExecutionProvider);
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/idle_arena_trimmer.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(IdleArenaTrimmerTest, ShrinksOncePerIdlePeriod) {
+  std::atomic<int> num_shrinks{0};
+  auto shrink = [&num_shrinks]() {
+    ++num_shrinks;
+    return Status::OK();
+  };
+  IdleArenaTrimmer trimmer(shrink, 10);
+
+  // nothing to shrink before a run ended
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(num_shrinks, 0);
+
+  // not while a run is in progress
+  trimmer.RunStarted();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(num_shrinks, 0);
+
+  trimmer.RunEnded();
+  for (int i = 0; i < 200 && num_shrinks == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(num_shrinks, 1);
+
+  // the idle period lasts until the next run ends
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(num_shrinks, 1);
+
+  trimmer.RunStarted(2);
+  trimmer.RunEnded(2);
+  for (int i = 0; i < 200 && num_shrinks == 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(num_shrinks, 2);
+}
+
+TEST(IdleArenaTrimmerTest, StopsWithoutShrinking) {
+  std::atomic<int> num_shrinks{0};
+  auto shrink = [&num_shrinks]() {
+    ++num_shrinks;
+    return Status::OK();
+  };
+  {
+    IdleArenaTrimmer trimmer(shrink, 1000 * 60);
+    trimmer.RunStarted();
+    trimmer.RunEnded();
+  }
+  EXPECT_EQ(num_shrinks, 0);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cstdio>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -18,7 +19,9 @@
 #include "core/framework/execution_provider.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/packed_strings.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -126,6 +129,10 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
   const Graph& GetGraph() {
     return model_->MainGraph();
   }
+
+  const SessionState& GetSessionState() {
+    return *session_state_;
+  }
 };
 
 namespace test {
@@ -175,8 +182,7 @@ template <typename T = float>
 void VerifyOutputs(const Tensor& tensor, const std::vector<int64_t>& expected_dims,
                    const std::vector<T>& expected_values) {
   TensorShape expected_shape(expected_dims);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDimsAsVector(), tensor.Shape().GetDimsAsVector());
   const std::vector<T> found(tensor.template Data<T>(),
                              tensor.template Data<T>() + expected_values.size());
   ASSERT_EQ(expected_values, found);
@@ -361,6 +367,52 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, UseMmapModelLoad) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.UseMmapModelLoad";
+  so.use_mmap_model_load = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  Status st;
+  ASSERT_TRUE((st = session_object.Load(MODEL_URI)).IsOK()) << st.ErrorMessage();
+  ASSERT_TRUE((st = session_object.Initialize()).IsOK()) << st.ErrorMessage();
+
+  RunOptions run_options;
+  run_options.run_tag = "one session/one tag";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, SharedInitializers) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.SharedInitializers";
+  so.share_initializers_across_sessions = true;
+  auto store = std::make_shared<SharedInitializerStore>();
+
+  InferenceSession session_object1{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object1.SetSharedInitializerStore(store).IsOK());
+  ASSERT_TRUE(session_object1.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object1.Initialize().IsOK());
+  const size_t num_shared = store->Size();
+  ASSERT_GT(num_shared, 0u);
+
+  // the second session uses the initializers of the first one
+  InferenceSession session_object2{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object2.SetSharedInitializerStore(store).IsOK());
+  ASSERT_TRUE(session_object2.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object2.Initialize().IsOK());
+  ASSERT_EQ(store->Size(), num_shared);
+
+  // the store can't be changed once the session is initialized
+  ASSERT_FALSE(session_object2.SetSharedInitializerStore(store).IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "one session/one tag";
+  RunModel(session_object1, run_options);
+  RunModel(session_object2, run_options);
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -423,6 +475,34 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, TestOptimizedModelReload) {
+  SessionOptions so;
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  so.session_logid = "InferenceSessionTests.TestOptimizedModelReload";
+  so.graph_optimization_level = TransformerLevel::Level2;
+  so.optimized_model_filepath = ToWideString(test_model + "-Reload");
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the saved model records the level it was optimized to and the providers it was optimized for
+  SessionOptions so_reload;
+  so_reload.session_logid = "InferenceSessionTests.TestOptimizedModelReload";
+  so_reload.graph_optimization_level = TransformerLevel::Level2;
+  InferenceSessionGetGraphWrapper session_object_reload{so_reload, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object_reload.Load(so.optimized_model_filepath).IsOK());
+  auto metadata = session_object_reload.GetModelMetadata();
+  ASSERT_TRUE(metadata.first.IsOK());
+  const auto& custom_metadata = metadata.second->custom_metadata_map;
+  ASSERT_EQ(custom_metadata.at("onnxruntime.graph_optimization_level"), "2");
+  ASSERT_EQ(custom_metadata.at("onnxruntime.execution_providers"), kCpuExecutionProvider);
+
+  // the optimizers are skipped on reload and the graph is still the optimized one
+  ASSERT_TRUE(session_object_reload.Initialize().IsOK());
+  std::map<std::string, int> op_to_count = CountOpsInGraph(session_object_reload.GetGraph());
+  ASSERT_EQ(op_to_count["Identity"], 0);
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -627,6 +707,136 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, LightweightProfilerSamplesRuns) {
+  SessionOptions so;
+
+  so.session_logid = "LightweightProfilerSamplesRuns";
+  so.lightweight_profiling_sampling_interval = 2;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  EXPECT_TRUE(session_object.GetOpStatistics().empty());
+
+  RunOptions run_options;
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // runs 0, 2 and 4 are sampled
+  auto op_statistics = session_object.GetOpStatistics();
+  ASSERT_EQ(op_statistics.size(), 1u);
+  const auto& mul_statistics = op_statistics["Mul"];
+  EXPECT_EQ(mul_statistics.count, 3u);
+  EXPECT_LE(mul_statistics.min_ns, mul_statistics.max_ns);
+  EXPECT_LE(mul_statistics.max_ns, mul_statistics.total_ns);
+
+  // the statistics accumulate across calls
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+  EXPECT_EQ(session_object.GetOpStatistics()["Mul"].count, 4u);
+}
+
+TEST(InferenceSessionTests, LightweightProfilerNodeStatistics) {
+  SessionOptions so;
+
+  so.session_logid = "LightweightProfilerNodeStatistics";
+  so.lightweight_profiling_sampling_interval = 1;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  for (int i = 0; i < 10; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  auto node_statistics = session_object.GetNodeStatistics();
+  ASSERT_EQ(node_statistics.size(), 1u);
+  ASSERT_EQ(node_statistics.count("mul_1"), 1u);
+  const auto& mul_statistics = node_statistics["mul_1"];
+  EXPECT_EQ(mul_statistics.count, 10u);
+  EXPECT_LE(mul_statistics.min_ns, mul_statistics.p50_ns);
+  EXPECT_LE(mul_statistics.p50_ns, mul_statistics.p99_ns);
+  EXPECT_LE(mul_statistics.p99_ns, mul_statistics.max_ns);
+  // the output is a 3x2 float tensor
+  EXPECT_EQ(mul_statistics.output_bytes, 10u * 6 * sizeof(float));
+
+  std::string json = session_object.GetProfilingStatisticsJson();
+  EXPECT_NE(json.find("\"ops\": {\"Mul\": {\"count\": 10"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"nodes\": {\"mul_1\": {\"count\": 10"), std::string::npos) << json;
+}
+
+TEST(InferenceSessionTests, RuntimeProfileIsRecordedAndReused) {
+  const std::string profile_path = "runtime_profile_test.txt";
+  std::remove(profile_path.c_str());
+
+  SessionOptions so;
+  so.session_logid = "RuntimeProfileIsRecordedAndReused";
+  so.runtime_profile_runs = 3;
+  so.runtime_profile_path = profile_path;
+
+  RunOptions run_options;
+  {
+    InferenceSession session_object(so);
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    for (int i = 0; i < 5; ++i) {
+      RunModel(session_object, run_options);
+    }
+    // the session waits for the profile to be saved when it's destroyed
+  }
+
+  RuntimeProfile profile;
+  ASSERT_TRUE(RuntimeProfile::Load(profile_path, profile).IsOK());
+  EXPECT_EQ(profile.num_runs, 3u);
+  ASSERT_EQ(profile.input_names, std::vector<std::string>{"X"});
+  ASSERT_EQ(profile.input_shapes.size(), 1u);
+  EXPECT_EQ(profile.input_shapes.begin()->first, (std::vector<std::vector<int64_t>>{{3, 2}}));
+  EXPECT_EQ(profile.input_shapes.begin()->second, 3u);
+  ASSERT_EQ(profile.nodes.count("mul_1"), 1u);
+  EXPECT_GE(profile.nodes["mul_1"].mean_ns, 0);
+  EXPECT_EQ(profile.nodes["mul_1"].output_bytes, 6 * sizeof(float));
+
+  // a later session applies the saved profile instead of recording the runs
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  RunModel(session_object, run_options);
+  EXPECT_TRUE(session_object.GetNodeStatistics().empty());
+
+  std::remove(profile_path.c_str());
+}
+
+TEST(InferenceSessionTests, MemoryStatistics) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.MemoryStatistics";
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  // the output buffer provided by the caller isn't counted
+  RunModel(session_object, run_options, true);
+  EXPECT_EQ(session_object.GetPeakActivationBytes(), 0);
+
+  RunModel(session_object, run_options);
+  // the 3x2 float output, rounded up to the 64 byte alignment
+  EXPECT_EQ(session_object.GetPeakActivationBytes(), 64);
+
+  auto allocator_stats = session_object.GetAllocatorStats();
+  ASSERT_FALSE(allocator_stats.empty());
+  EXPECT_STREQ(allocator_stats[0].first.name, CPU);
+  EXPECT_GT(allocator_stats[0].second.num_allocs, 0);
+  EXPECT_GT(allocator_stats[0].second.max_bytes_in_use, 0);
+
+  std::string json = session_object.GetMemoryStatisticsJson();
+  EXPECT_EQ(json.find("{\"allocators\": [{\"name\": \"Cpu\", \"id\": 0"), 0u) << json;
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -833,6 +1043,45 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingOutputPool) {
+  SessionOptions so;
+  InferenceSession session_object(so);
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  unique_ptr<IOBinding> io_binding;
+  Status st = session_object.NewIOBinding(&io_binding);
+  ASSERT_TRUE(st.IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue input_a, input_b;
+  CreateMLValue<float>(allocator, {2, 2}, {1.f, 2.f, 3.f, 4.f}, &input_a);
+  CreateMLValue<float>(allocator, {2, 1}, {1.f, 1.f}, &input_b);
+  ASSERT_TRUE(io_binding->BindInput("A", input_a).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("B", input_b).IsOK());
+  st = io_binding->BindOutput("Y", allocator->Info());
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  RunOptions run_options;
+  st = session_object.Run(run_options, *io_binding);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(io_binding->GetOutputs()[0].Get<Tensor>(), {2, 1}, {3.f, 7.f});
+  const void* first_buffer = io_binding->GetOutputs()[0].Get<Tensor>().DataRaw();
+
+  // the second run reuses the pooled buffer
+  CreateMLValue<float>(allocator, {2, 1}, {2.f, 0.f}, &input_b);
+  ASSERT_TRUE(io_binding->BindInput("B", input_b).IsOK());
+  st = session_object.Run(run_options, *io_binding);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(io_binding->GetOutputs()[0].Get<Tensor>(), {2, 1}, {2.f, 6.f});
+  ASSERT_EQ(first_buffer, io_binding->GetOutputs()[0].Get<Tensor>().DataRaw());
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -995,6 +1244,161 @@ static common::Status RunOptionalInputTest(bool add_required_input,
   return status;
 }
 
+// Relu doesn't contribute to a graph output so it's removed at initialization, and Abs is skipped when only Y1 is
+// requested.
+TEST(InferenceSessionTests, PruneNodesNotNeededForOutputs) {
+  onnxruntime::Model model("prune_test", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &float_tensor);
+  auto& y2 = graph.GetOrCreateNodeArg("Y2", &float_tensor);
+  auto& unused = graph.GetOrCreateNodeArg("unused", &float_tensor);
+  graph.AddNode("neg", "Neg", "", {&x}, {&y1});
+  graph.AddNode("abs", "Abs", "", {&x}, {&y2});
+  graph.AddNode("relu", "Relu", "", {&x}, {&unused});
+  graph.SetOutputs({&y1, &y2});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::string model_file_name = "prune_test_graph.onnx";
+  status = onnxruntime::Model::Save(model, model_file_name);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PruneNodesNotNeededForOutputs";
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const auto& session_graph = session_object.GetGraph();
+  EXPECT_EQ(session_graph.NumberOfNodes(), 2);
+  NodeIndex abs_index = 0;
+  for (const auto& node : session_graph.Nodes()) {
+    EXPECT_NE(node.OpType(), "Relu");
+    if (node.OpType() == "Abs") {
+      abs_index = node.Index();
+    }
+  }
+
+  const auto& session_state = session_object.GetSessionState();
+  int y1_idx, y2_idx;
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("Y1", y1_idx).IsOK());
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("Y2", y2_idx).IsOK());
+  EXPECT_EQ(session_state.GetNodesToExecute({y1_idx, y2_idx}), nullptr);
+  const auto* nodes_to_execute = session_state.GetNodesToExecute({y1_idx});
+  ASSERT_NE(nodes_to_execute, nullptr);
+  EXPECT_FALSE((*nodes_to_execute)[abs_index]);
+
+  std::vector<int64_t> dims_x = {2, 2};
+  std::vector<float> values_x = {1.0f, -2.0f, 3.0f, -4.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x,
+                       &ml_value_x);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  status = session_object.Run(run_options, feeds, {"Y1"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, dims_x, {-1.0f, 2.0f, -3.0f, 4.0f});
+}
+
+// the processors of a thread affinity must exist and be distinct, and be enough for the threads of the pool
+TEST(InferenceSessionTests, InvalidThreadAffinity) {
+  std::vector<std::pair<std::vector<int>, int>> invalid_affinities{{{-1}, 1}, {{0, 0}, 1}, {{0}, 2}};
+  const int num_processors = static_cast<int>(std::thread::hardware_concurrency());
+  if (num_processors > 0) {
+    invalid_affinities.push_back({{num_processors}, 1});
+  }
+
+  for (const auto& affinity : invalid_affinities) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.InvalidThreadAffinity";
+    so.intra_op_thread_affinity = affinity.first;
+    so.intra_op_num_threads = affinity.second;
+    EXPECT_THROW(InferenceSession(so, &DefaultLoggingManager()), OnnxRuntimeException);
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InvalidThreadAffinity";
+  so.intra_op_thread_affinity = {0};
+  so.intra_op_num_threads = 1;
+  EXPECT_NO_THROW(InferenceSession(so, &DefaultLoggingManager()));
+}
+
+// the strings passed between Identity, Gather and Concat are in the packed layout, the packed feed is read by
+// Identity as is, and the graph output has std::string elements.
+TEST(InferenceSessionTests, PackedStringTensors) {
+  onnxruntime::Model model("packed_strings", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto string_tensor;
+  string_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_STRING);
+  ONNX_NAMESPACE::TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &string_tensor);
+  auto& indices = graph.GetOrCreateNodeArg("I", &int64_tensor);
+  auto& identity = graph.GetOrCreateNodeArg("identity", &string_tensor);
+  auto& gathered = graph.GetOrCreateNodeArg("gathered", &string_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &string_tensor);
+  graph.AddNode("identity", "Identity", "", {&x}, {&identity});
+  graph.AddNode("gather", "Gather", "", {&identity, &indices}, {&gathered});
+  graph.AddNode("concat", "Concat", "", {&gathered, &identity}, {&y}).AddAttribute("axis", int64_t{0});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::string model_file_name = "packed_strings_graph.onnx";
+  status = onnxruntime::Model::Save(model, model_file_name);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PackedStringTensors";
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const auto& session_state = session_object.GetSessionState();
+  const auto& alloc_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int idx;
+  for (const char* name : {"X", "identity", "gathered"}) {
+    ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx(name, idx).IsOK());
+    EXPECT_TRUE(alloc_plan[idx].packed_strings) << name;
+  }
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("Y", idx).IsOK());
+  EXPECT_FALSE(alloc_plan[idx].packed_strings);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  const std::vector<std::string> values_x{"a", "bc", "", "def"};
+  auto p_tensor = onnxruntime::make_unique<Tensor>(TensorShape({4}), 6, allocator);
+  StringTensorWriter writer(*p_tensor);
+  for (const auto& value : values_x) {
+    writer.Append(value.data(), value.size());
+  }
+  OrtValue ml_value_x;
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  ml_value_x.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  OrtValue ml_value_i;
+  CreateMLValue<int64_t>(allocator, {2}, {3, -3}, &ml_value_i);
+  NameMLValMap feeds{{"X", ml_value_x}, {"I", ml_value_i}};
+
+  std::vector<OrtValue> fetches;
+  status = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const auto& output = fetches[0].Get<Tensor>();
+  ASSERT_FALSE(output.IsPackedStrings());
+  VerifyOutputs(output, {6}, std::vector<std::string>{"def", "bc", "a", "bc", "", "def"});
+}
+
 // test the change in handling of graph inputs that match initializers between IR version 3 and 4
 // in V3 disallow overriding an initializer via the feeds
 // for V4 allow it
@@ -1312,8 +1716,7 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
   ASSERT_EQ(1, fetches.size());
   auto& rtensor = fetches.front().Get<Tensor>();
   TensorShape expected_shape(Y_dims);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&rtensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDimsAsVector(), rtensor.Shape().GetDimsAsVector());
   for (size_t i = 0; i < Y_data.size(); ++i)
     EXPECT_NEAR(Y_data[i], rtensor.template Data<float>()[i], FLT_EPSILON);
 
@@ -1355,8 +1758,7 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
     std::vector<int64_t> truncated_output_dims = Y_dims;
     truncated_output_dims[0] = truncated_len;
     TensorShape truncated_shape(truncated_output_dims);
-    //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-    ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&truncated_shape), *reinterpret_cast<const std::vector<int64_t>*>(&truncated_rtensor.Shape()));
+    ASSERT_EQ(truncated_shape.GetDimsAsVector(), truncated_rtensor.Shape().GetDimsAsVector());
     auto seq_output_stride = truncated_shape.SizeFromDimension(1);
     for (int i = 0; i < truncated_shape.Size(); ++i)
       EXPECT_NEAR(Y_data[i + seq_start * seq_output_stride], truncated_rtensor.template Data<float>()[i], FLT_EPSILON);
@@ -1542,6 +1944,31 @@ TEST(InferenceSessionTests, TestParallelExecutionWithCudaProvider) {
   ASSERT_TRUE(!status.IsOK());
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerRecordsCudaDeviceTime) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfilerRecordsCudaDeviceTime";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_cuda_profile_test");
+  InferenceSession session_object{so};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(onnxruntime::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  // the kernel of the CUDA node is also timed on the device
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::stringstream content;
+  content << profile.rdbuf();
+  EXPECT_NE(content.str().find("mul_1_device_time"), std::string::npos);
+}
+
 #endif
 
 // The model being tested here triggers a case where the allocation planner (AP) tries to reuse a tensor of type
@@ -45,7 +45,7 @@ class FooKernel : public OpKernel {
 
     auto shape = X->Shape().GetDims();
 
-    auto* Y = context->Output(0, shape);
+    auto* Y = context->Output(0, X->Shape());
     auto* Y_Data = Y->MutableData<T>();
 
     size_t size = 1;
@@ -142,7 +142,7 @@ class OptionalOpKernel : public OpKernel {
 
     auto* X_Data = X->Data<T>();
     auto& shape = X->Shape().GetDims();
-    auto* Y = context->Output(0, shape);
+    auto* Y = context->Output(0, X->Shape());
     auto* Y_Data = Y->MutableData<T>();
     size_t size = 1;
     for (size_t i = 0; i < shape.size(); i++) {
@@ -153,7 +153,7 @@ class OptionalOpKernel : public OpKernel {
       Y_Data[i] = X_Data[i];
     }
 
-    auto* Y2 = context->Output(1, shape);
+    auto* Y2 = context->Output(1, X->Shape());
     // Y2 is used or not
     if (Y2) {
       auto Y2_Data = Y2->MutableData<T>();
@@ -214,8 +214,7 @@ void RunSession(InferenceSession& session_object,
   ASSERT_EQ(1, fetches.size());
   auto& rtensor = fetches.front().Get<Tensor>();
   TensorShape expected_shape(dims_y);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&rtensor.Shape()));
+  EXPECT_EQ(expected_shape.GetDimsAsVector(), rtensor.Shape().GetDimsAsVector());
   const std::vector<float> found(rtensor.template Data<float>(), rtensor.template Data<float>() + expected_shape.Size());
   ASSERT_EQ(values_y, found);
 }
@@ -29,10 +29,38 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
 
   pattern = planner.GenerateMemPattern();
 
-  EXPECT_EQ(pattern.PeakSize(), 1024 + 256 + 512 + 1024 + 512);
-  EXPECT_EQ(pattern.GetBlock(4)->offset_, 1024 + 256 + 512 + 1024);
-  EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
-  EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
+  // Placing the blocks largest first against the blocks with overlapping lifetimes packs them into
+  // 1024 + 1024 + 512 + 512 bytes, less than the 1024 + 256 + 512 + 1024 + 512 bytes of the online layout.
+  EXPECT_EQ(pattern.PeakSize(), 1024 + 1024 + 512 + 512);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 1024 + 1024 + 512);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 1024 + 1024);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 1024);
+  EXPECT_EQ(pattern.GetBlock(4)->offset_, 1024 + 1024 + 512);
+  EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024);
+  EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024 + 600);
+}
+
+TEST(MemPatternPlannerTest, GreedyBySizeTest) {
+  // The small block allocated first pushes the second large block past the end of the first one in the
+  // online layout, which needs 2100 bytes.
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, 100);
+  planner.TraceAllocation(1, 1000);
+  planner.TraceFree(0);
+  planner.TraceAllocation(2, 1000);
+  planner.TraceFree(1);
+  planner.TraceAllocation(3, 100);
+  planner.TraceFree(2);
+  planner.TraceFree(3);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 2000);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 1000);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 1000);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 0);
 }
 }  // namespace test
 }  // namespace onnxruntime
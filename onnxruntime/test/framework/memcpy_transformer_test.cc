@@ -4,6 +4,7 @@
 #include <iterator>
 
 #include "core/framework/execution_providers.h"
+#include "core/optimizer/activation_offload.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/graph/model.h"
 #include "gtest/gtest.h"
@@ -288,6 +289,71 @@ TEST(TransformerTest, TestCopyNodeInsertionInitializerInSubgraph) {
   EXPECT_TRUE(modified);
 }
 
+// A = Relu(X) is used by the first and the last node of a chain of Neg nodes. It is copied to host memory after
+// the first use, and back to the device before the last one.
+TEST(TransformerTest, ActivationOffloadTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test", false, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float_type);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_float_type);
+  graph.AddNode("relu", "Relu", "", ArgMap{&x}, ArgMap{&a});
+  NodeArg* chain = &a;
+  for (int i = 0; i < 20; ++i) {
+    auto& neg_out = graph.GetOrCreateNodeArg("neg_out" + std::to_string(i), &tensor_float_type);
+    graph.AddNode("neg" + std::to_string(i), "Neg", "", ArgMap{chain}, ArgMap{&neg_out});
+    chain = &neg_out;
+  }
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float_type);
+  auto& add_node = graph.AddNode("add", "Add", "", ArgMap{chain, &a}, ArgMap{&y});
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          onnxruntime::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                          onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernels(execution_providers);
+
+  // the Neg outputs are only used by the next node, so only A is offloaded
+  ActivationOffloadTransformer transformer(test_registry_manager, 1024);
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified, DefaultLoggingManager().DefaultLogger());
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  int num_to_host = 0;
+  int num_from_host = 0;
+  for (auto& node : graph.Nodes()) {
+    num_to_host += node.OpType() == "MemcpyToHost";
+    num_from_host += node.OpType() == "MemcpyFromHost";
+  }
+  EXPECT_EQ(num_to_host, 1);
+  EXPECT_EQ(num_from_host, 1);
+
+  // Add reads the prefetched copy of A
+  EXPECT_EQ(add_node.InputDefs()[0], chain);
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "MemcpyToHost") {
+      EXPECT_EQ(node.InputDefs()[0], &a);
+    } else if (node.OpType() == "MemcpyFromHost") {
+      EXPECT_EQ(node.OutputDefs()[0], add_node.InputDefs()[1]);
+    }
+  }
+}
+
 #endif
 
 }  // namespace test
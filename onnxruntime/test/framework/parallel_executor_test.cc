@@ -9,6 +9,8 @@
 
 #include "gtest/gtest.h"
 
+#include <sstream>
+
 using namespace ONNX_NAMESPACE;
 using namespace onnxruntime::common;
 
@@ -117,6 +119,80 @@ TEST(ParallelExecutor, TestStatusPropagation) {
   }
 }
 
+// many branches finishing concurrently, with one failing, must neither hang nor touch the executor after Execute
+// returned. best run with a thread sanitizer.
+TEST(ParallelExecutor, TestManyBranchesWithError) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  Status status;
+  ASSERT_TRUE((status = registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11)).IsOK()) << status;
+  KernelCreateFn kernel_create_fn = [](const OpKernelInfo& info) { return new typename TestOp::OpKernelImpl(info); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_TRUE((status = registry->RegisterCustomKernel(kernel_def, kernel_create_fn)).IsOK()) << status;
+
+  // each branch is a chain of TestOp nodes from the "action" input. the action of the last branch comes from
+  // "fail_action" instead.
+  constexpr int num_branches = 32;
+  constexpr int branch_length = 3;
+  std::unordered_map<std::string, int> domain_to_version = {{onnxruntime::kOnnxDomain, 10}, {TestOp::OpDomain, 10}};
+  Model model("ManyBranches", false, ModelMetaData(), {registry->GetOpschemaRegistry()}, domain_to_version, {},
+              DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& action = graph.GetOrCreateNodeArg("action", &int64_tensor);
+  auto& fail_action = graph.GetOrCreateNodeArg("fail_action", &int64_tensor);
+  std::vector<std::string> output_names;
+  for (int b = 0; b < num_branches; ++b) {
+    NodeArg* input = b == num_branches - 1 ? &fail_action : &action;
+    for (int i = 0; i < branch_length; ++i) {
+      auto name = "branch_" + std::to_string(b) + "_" + std::to_string(i);
+      auto& output = graph.GetOrCreateNodeArg(name, &int64_tensor);
+      graph.AddNode(name, TestOp::OpName, "", {input}, {&output}, nullptr, TestOp::OpDomain);
+      input = &output;
+    }
+    output_names.push_back(input->Name());
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+
+  auto run = [&](int64_t last_action, int num_runs) {
+    SessionOptions so;
+    so.session_logid = "TestManyBranchesWithError";
+    so.execution_mode = ExecutionMode::ORT_PARALLEL;
+    so.inter_op_num_threads = 8;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_STATUS_OK(session_object.RegisterCustomRegistry(registry));
+    std::stringstream sstr(serialized_model);
+    ASSERT_STATUS_OK(session_object.Load(sstr));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    OrtValue action_value, fail_action_value;
+    auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+    CreateMLValue<int64_t>(allocator, {1}, {0}, &action_value);
+    CreateMLValue<int64_t>(allocator, {1}, {last_action}, &fail_action_value);
+    NameMLValMap feeds{{"action", action_value}, {"fail_action", fail_action_value}};
+
+    for (int i = 0; i < num_runs; ++i) {
+      std::vector<OrtValue> fetches;
+      auto run_status = session_object.Run(RunOptions{}, feeds, output_names, &fetches);
+      if (last_action == 0) {
+        ASSERT_STATUS_OK(run_status);
+        ASSERT_EQ(fetches.size(), static_cast<size_t>(num_branches));
+      } else {
+        ASSERT_FALSE(run_status.IsOK());
+        EXPECT_NE(run_status.ErrorMessage().find("Action was 1"), std::string::npos) << run_status.ErrorMessage();
+      }
+    }
+  };
+
+  run(0, 100);
+  run(1, 100);
+}
+
 TEST(ParallelExecutor, TestNullInterOpThreadPool) {
   auto registry = std::make_shared<CustomRegistry>();
   std::vector<OpSchema> schemas{TestOp::OpSchema()};
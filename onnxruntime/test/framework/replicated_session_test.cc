@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/replicated_session.h"
+
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "core/framework/data_types.h"
+#include "core/framework/shared_initializer_store.h"
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// run function that only counts the runs, and blocks the first one until 'release' is set
+ReplicatedSession::RunFunction CreateRunFunction(std::atomic<int>& num_runs, std::atomic<bool>* started = nullptr,
+                                                 std::atomic<bool>* release = nullptr) {
+  return [&num_runs, started, release](const RunOptions&, const std::vector<std::string>&,
+                                       const std::vector<OrtValue>&, const std::vector<std::string>&,
+                                       std::vector<OrtValue>&) {
+    if (num_runs++ == 0 && started != nullptr) {
+      *started = true;
+      while (!*release) {
+        std::this_thread::yield();
+      }
+    }
+    return Status::OK();
+  };
+}
+}  // namespace
+
+TEST(ReplicatedSessionTest, RunGoesToLeastLoadedReplica) {
+  std::atomic<int> num_runs0{0};
+  std::atomic<int> num_runs1{0};
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  ReplicatedSession session({CreateRunFunction(num_runs0, &started, &release), CreateRunFunction(num_runs1)});
+
+  // the first run occupies replica 0
+  std::thread busy([&]() {
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session.Run(RunOptions(), {}, {}, {}, &fetches).IsOK());
+  });
+  while (!started) {
+    std::this_thread::yield();
+  }
+
+  // the replica in turn for the next runs is idle first and then busy, both go to the idle replica 1
+  for (int i = 0; i < 2; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session.Run(RunOptions(), {}, {}, {}, &fetches).IsOK());
+  }
+  release = true;
+  busy.join();
+
+  EXPECT_EQ(num_runs0, 1);
+  EXPECT_EQ(num_runs1, 2);
+  EXPECT_EQ(session.GetRunCounts(), std::vector<uint64_t>({1, 2}));
+  EXPECT_TRUE(session.GetSession(0) == nullptr);
+}
+
+TEST(ReplicatedSessionTest, CreateSharesInitializers) {
+  std::ifstream model_file("testdata/mul_1.onnx", std::ios::in | std::ios::binary);
+  ASSERT_TRUE(model_file.good());
+  const std::string model_data((std::istreambuf_iterator<char>(model_file)), std::istreambuf_iterator<char>());
+
+  SessionOptions so;
+  so.session_logid = "ReplicatedSessionTest.CreateSharesInitializers";
+  auto store = std::make_shared<SharedInitializerStore>();
+
+  size_t num_setups = 0;
+  std::unique_ptr<ReplicatedSession> session;
+  Status st = ReplicatedSession::Create(
+      so, model_data.data(), static_cast<int>(model_data.size()), 2,
+      [&num_setups](size_t, InferenceSession&) {
+        ++num_setups;
+        return Status::OK();
+      },
+      store, &DefaultLoggingManager(), session);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  ASSERT_EQ(session->NumReplicas(), 2u);
+  EXPECT_EQ(num_setups, 2u);
+  ASSERT_TRUE(session->GetSession(1) != nullptr);
+
+  // a single copy of the weight of the Mul for both replicas
+  EXPECT_EQ(store->Size(), 1u);
+
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+  const std::vector<float> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (int i = 0; i < 4; ++i) {
+    std::vector<OrtValue> fetches;
+    st = session->Run(RunOptions(), {"X"}, {x}, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& y = fetches[0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({3, 2}));
+    EXPECT_EQ(std::vector<float>(y.Data<float>(), y.Data<float>() + 6), expected_y);
+  }
+
+  // sequential runs take turns
+  EXPECT_EQ(session->GetRunCounts(), std::vector<uint64_t>({2, 2}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,289 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+OrtValue CreateFloatValue(const AllocatorPtr& allocator, const std::vector<int64_t>& dims,
+                          const std::vector<float>& data) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape(dims), allocator);
+  std::copy(data.cbegin(), data.cend(), p_tensor->MutableData<float>());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  OrtValue value;
+  value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return value;
+}
+
+// run function that doubles the input. if 'sum_rows' is set the output has a fixed dim 0 of 1.
+// like a session it fails if the terminate flag is set or the deadline has passed.
+RequestBatcher::RunFunction CreateRunFunction(const AllocatorPtr& allocator, std::atomic<int>& num_runs,
+                                              bool sum_rows = false) {
+  return [allocator, &num_runs, sum_rows](const RunOptions& run_options, const std::vector<std::string>&,
+                                          const std::vector<OrtValue>& feeds, const std::vector<std::string>&,
+                                          std::vector<OrtValue>& fetches) {
+    ++num_runs;
+    if (run_options.terminate || std::chrono::steady_clock::now() > run_options.deadline) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "terminated");
+    }
+
+    const auto& input = feeds[0].Get<Tensor>();
+    auto span = input.DataAsSpan<float>();
+    std::vector<float> output;
+    if (sum_rows) {
+      float sum = 0.f;
+      for (auto v : span) sum += v;
+      output.push_back(sum);
+      fetches = {CreateFloatValue(allocator, {1, 1}, output)};
+    } else {
+      for (auto v : span) output.push_back(v * 2);
+      fetches = {CreateFloatValue(allocator, input.Shape().GetDims(), output)};
+    }
+    return Status::OK();
+  };
+}
+}  // namespace
+
+TEST(RequestBatcherTest, ConcurrentRequestsAreBatched) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  constexpr int num_requests = 4;
+  // long timeout so the batch is only run when it's full
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs), allocator, num_requests, 10 * 1000 * 1000);
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 2}, {float(i), float(i + 1)})};
+      statuses[i] = batcher.Run(RunOptions(), {"X"}, feeds, {"Y"}, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_runs, 1);
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i];
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const auto& output = fetches[i][0].Get<Tensor>();
+    EXPECT_EQ(output.Shape(), TensorShape({1, 2}));
+    EXPECT_EQ(output.Data<float>()[0], float(i * 2));
+    EXPECT_EQ(output.Data<float>()[1], float((i + 1) * 2));
+  }
+
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.requests, static_cast<uint64_t>(num_requests));
+  EXPECT_EQ(stats.batches, 1u);
+}
+
+TEST(RequestBatcherTest, TimeoutRunsPartialBatch) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs), allocator, 8, 100);
+
+  std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 2}, {1.f, 2.f})};
+  std::vector<OrtValue> fetches;
+  ASSERT_TRUE(batcher.Run(RunOptions(), {"X"}, feeds, {"Y"}, fetches).IsOK());
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_EQ(fetches[0].Get<Tensor>().Data<float>()[1], 4.f);
+}
+
+TEST(RequestBatcherTest, NonBatchMajorOutputFallsBack) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  constexpr int num_requests = 2;
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs, true), allocator, num_requests, 10 * 1000 * 1000);
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 2}, {float(i), float(i)})};
+      ASSERT_TRUE(batcher.Run(RunOptions(), {"X"}, feeds, {"Y"}, fetches[i]).IsOK());
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // one batched run whose output couldn't be split, then one run per request
+  EXPECT_EQ(num_runs, 1 + num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Data<float>()[0], float(i * 2));
+  }
+}
+
+TEST(RequestBatcherTest, LargeRequestIsNotBatched) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs), allocator, 2, 10 * 1000 * 1000);
+
+  std::vector<OrtValue> feeds{CreateFloatValue(allocator, {2, 1}, {1.f, 2.f})};
+  std::vector<OrtValue> fetches;
+  ASSERT_TRUE(batcher.Run(RunOptions(), {"X"}, feeds, {"Y"}, fetches).IsOK());
+  EXPECT_EQ(batcher.GetStats().unbatched_requests, 1u);
+}
+
+TEST(RequestBatcherTest, JoinedRequestKeepsItsTerminateFlag) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  constexpr int num_requests = 3;
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs), allocator, num_requests, 10 * 1000 * 1000);
+
+  std::vector<RunOptions> run_options(num_requests);
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  auto run = [&](int i) {
+    std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 1}, {float(i)})};
+    statuses[i] = batcher.Run(run_options[i], {"X"}, feeds, {"Y"}, fetches[i]);
+  };
+
+  // request 1 joins the batch of request 0 and is terminated before request 2 fills the batch
+  std::thread leader(run, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::thread joined(run, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  run_options[1].terminate = true;
+  std::thread last(run, 2);
+  leader.join();
+  joined.join();
+  last.join();
+
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_FALSE(statuses[1].IsOK());
+  for (int i : {0, 2}) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i];
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Data<float>()[0], float(i * 2));
+  }
+}
+
+TEST(RequestBatcherTest, RequestsWithOtherRunTagsAreBatched) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  std::string batched_run_tag;
+  auto run_fn = CreateRunFunction(allocator, num_runs);
+  constexpr int num_requests = 3;
+  RequestBatcher batcher(
+      [&run_fn, &batched_run_tag](const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                  const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                                  std::vector<OrtValue>& fetches) {
+        batched_run_tag = run_options.run_tag;
+        return run_fn(run_options, feed_names, feeds, output_names, fetches);
+      },
+      allocator, num_requests, 10 * 1000 * 1000);
+
+  // each request is tagged with its id, like the requests of a server. requests 1 and 2 have the same tag.
+  std::vector<RunOptions> run_options(num_requests);
+  run_options[0].run_tag = "request0";
+  run_options[1].run_tag = "request1";
+  run_options[2].run_tag = "request1";
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 1}, {float(i)})};
+      statuses[i] = batcher.Run(run_options[i], {"X"}, feeds, {"Y"}, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_TRUE(batched_run_tag == "request0,request1" || batched_run_tag == "request1,request0") << batched_run_tag;
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i];
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Data<float>()[0], float(i * 2));
+  }
+}
+
+TEST(RequestBatcherTest, RequestsWithOtherDeadlinesAreBatched) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  auto run_fn = CreateRunFunction(allocator, num_runs);
+  std::chrono::steady_clock::time_point batched_deadline;
+  RequestBatcher batcher(
+      [&run_fn, &batched_deadline](const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                   const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                                   std::vector<OrtValue>& fetches) {
+        batched_deadline = run_options.deadline;
+        return run_fn(run_options, feed_names, feeds, output_names, fetches);
+      },
+      allocator, 2, 10 * 1000 * 1000);
+
+  // the batch runs with the earliest deadline
+  constexpr int num_requests = 2;
+  std::vector<RunOptions> run_options(num_requests);
+  run_options[0].deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+  std::vector<std::thread> threads;
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&, i]() {
+      std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 1}, {float(i)})};
+      statuses[i] = batcher.Run(run_options[i], {"X"}, feeds, {"Y"}, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_EQ(batched_deadline, run_options[0].deadline);
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i];
+    EXPECT_EQ(fetches[i][0].Get<Tensor>().Data<float>()[0], float(i * 2));
+  }
+}
+
+TEST(RequestBatcherTest, PassedDeadlineFailsOnlyItsRequest) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::atomic<int> num_runs{0};
+  // the batch never fills and the timeout is long, so the batch runs when the deadline of request 0 passes
+  RequestBatcher batcher(CreateRunFunction(allocator, num_runs), allocator, 3, 10 * 1000 * 1000);
+
+  // request 0 joins request 1, which has no deadline and must not fail with it
+  constexpr int num_requests = 2;
+  std::vector<RunOptions> run_options(num_requests);
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  auto run_request = [&](int i) {
+    std::vector<OrtValue> feeds{CreateFloatValue(allocator, {1, 1}, {float(i)})};
+    statuses[i] = batcher.Run(run_options[i], {"X"}, feeds, {"Y"}, fetches[i]);
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  std::thread thread1(run_request, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  run_options[0].deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+  std::thread thread0(run_request, 0);
+  thread0.join();
+  thread1.join();
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  EXPECT_FALSE(statuses[0].IsOK());
+  ASSERT_TRUE(statuses[1].IsOK()) << statuses[1];
+  EXPECT_EQ(fetches[1][0].Get<Tensor>().Data<float>()[0], 2.f);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/runtime_profile.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_state.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+TEST(RuntimeProfileTest, SaveAndLoad) {
+  const std::string path = "runtime_profile_save_and_load.txt";
+
+  RuntimeProfile profile;
+  profile.num_runs = 4;
+  profile.input_names = {"input ids", "mask"};
+  profile.input_shapes[{{1, 5}, {1, 5}}] = 3;
+  profile.input_shapes[{{}, {2, 7}}] = 1;
+  profile.nodes["MatMul 1"] = {1500, 4096};
+  profile.nodes["relu"] = {20, 64};
+  ASSERT_TRUE(profile.Save(path).IsOK());
+
+  RuntimeProfile loaded;
+  ASSERT_TRUE(RuntimeProfile::Load(path, loaded).IsOK());
+  EXPECT_EQ(loaded.num_runs, 4u);
+  EXPECT_EQ(loaded.input_names, profile.input_names);
+  EXPECT_EQ(loaded.input_shapes, profile.input_shapes);
+  ASSERT_EQ(loaded.nodes.size(), 2u);
+  EXPECT_EQ(loaded.nodes["MatMul 1"].mean_ns, 1500);
+  EXPECT_EQ(loaded.nodes["MatMul 1"].output_bytes, 4096u);
+  EXPECT_EQ(loaded.nodes["relu"].mean_ns, 20);
+  std::remove(path.c_str());
+
+  // a missing file leaves the profile empty
+  RuntimeProfile missing;
+  ASSERT_TRUE(RuntimeProfile::Load(path, missing).IsOK());
+  EXPECT_EQ(missing.num_runs, 0u);
+
+  // a file that is not a profile is an error
+  {
+    std::ofstream file(path);
+    file << "onnxruntime cudnn convolution algorithms\n";
+  }
+  EXPECT_FALSE(RuntimeProfile::Load(path, missing).IsOK());
+  std::remove(path.c_str());
+}
+
+TEST(RuntimeProfileTest, ApplyRuntimeProfile) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+
+  // X -> Relu -> Abs -> Y
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("seq");
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  auto& abs = graph.AddNode("abs", "Abs", "", {&relu_out}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  ASSERT_TRUE(s.SetGraph(graph).IsOK());
+
+  // sequence lengths 5 and 7 share the bucket of 8
+  RuntimeProfile profile;
+  profile.num_runs = 3;
+  profile.input_names = {"X"};
+  profile.input_shapes[{{1, 5}}] = 2;
+  profile.input_shapes[{{1, 7}}] = 1;
+  profile.nodes["relu"] = {100, 20};
+  profile.nodes["abs"] = {50, 20};
+  profile.nodes["removed"] = {1000, 20};
+  ApplyRuntimeProfile(profile, s);
+
+  auto costs = s.GetNodeCriticalPathCosts();
+  EXPECT_EQ((*costs)[relu.Index()], 150);
+  EXPECT_EQ((*costs)[abs.Index()], 50);
+  EXPECT_TRUE(s.GetMemoryPatternShapeBucketing());
+
+  // shapes in different buckets don't enable it
+  SessionState other{execution_providers, true, &tp, nullptr};
+  ASSERT_TRUE(other.SetGraph(graph).IsOK());
+  profile.input_shapes.erase({{1, 7}});
+  profile.input_shapes[{{1, 9}}] = 1;
+  ApplyRuntimeProfile(profile, other);
+  EXPECT_FALSE(other.GetMemoryPatternShapeBucketing());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 #include "core/framework/execution_providers.h"
 #include "core/framework/graph_partitioner.h"
@@ -14,6 +16,7 @@
 #include "core/graph/op.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
 #include "test/test_environment.h"
 
 using namespace ONNX_NAMESPACE;
@@ -152,5 +155,281 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
 }
 
 INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
+
+TEST(SessionStateTest, NodeCriticalPathCosts) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+
+  // X -> Relu -> MatMul -> Y
+  //   -> Abs  -> Z
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_type);
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  auto& matmul = graph.AddNode("matmul", "MatMul", "", {&relu_out, &x}, {&y});
+  auto& abs = graph.AddNode("abs", "Abs", "", {&x}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ASSERT_TRUE(s.SetGraph(graph).IsOK());
+  auto estimated_costs = s.GetNodeCriticalPathCosts();
+  const auto& costs = *estimated_costs;
+  EXPECT_GT(costs[relu.Index()], costs[matmul.Index()]);
+  EXPECT_GT(costs[relu.Index()], costs[abs.Index()]);
+  EXPECT_GT(costs[matmul.Index()], costs[abs.Index()]);
+
+  // measured costs where Abs is slower than Relu and MatMul together
+  std::vector<int64_t> node_costs(graph.MaxNodeIndex(), 0);
+  node_costs[relu.Index()] = 100;
+  node_costs[matmul.Index()] = 200;
+  node_costs[abs.Index()] = 1000;
+  s.SetNodeCosts(node_costs);
+  auto measured_costs = s.GetNodeCriticalPathCosts();
+  EXPECT_EQ((*measured_costs)[relu.Index()], 300);
+  EXPECT_EQ((*measured_costs)[matmul.Index()], 200);
+  EXPECT_EQ((*measured_costs)[abs.Index()], 1000);
+
+  // a run that got the costs before they were replaced keeps them
+  EXPECT_GT(costs[relu.Index()], costs[abs.Index()]);
+}
+
+TEST(SessionStateTest, MemoryPatternCacheLruEviction) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+  s.SetMemoryPatternCacheOptions(false, 2);
+
+  TensorShape shape_a({1, 8}), shape_b({1, 16}), shape_c({1, 32});
+  std::vector<std::reference_wrapper<const TensorShape>> a{shape_a}, b{shape_b}, c{shape_c};
+
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(a, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(b, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+
+  // touch 'a' so 'b' is the least recently used entry
+  auto pattern_a = s.GetMemoryPatternGroup(a);
+  EXPECT_NE(pattern_a, nullptr);
+
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(c, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+  EXPECT_NE(s.GetMemoryPatternGroup(a), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(b), nullptr);
+  EXPECT_NE(s.GetMemoryPatternGroup(c), nullptr);
+
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.evictions, 1u);
+}
+
+TEST(SessionStateTest, MemoryPatternCacheShapeBucketing) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+  s.SetMemoryPatternCacheOptions(true, 0);
+
+  TensorShape shape_5({1, 5}), shape_7({1, 7}), shape_9({1, 9}), shape_transposed({5, 1});
+  std::vector<std::reference_wrapper<const TensorShape>> s5{shape_5}, s7{shape_7}, s9{shape_9},
+      transposed{shape_transposed};
+
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(s5, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+
+  // 5 and 7 both round up to 8
+  EXPECT_EQ(s.GetMemoryPatternGroup(s5), s.GetMemoryPatternGroup(s7));
+  EXPECT_NE(s.GetMemoryPatternGroup(s7), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(s9), nullptr);
+  EXPECT_EQ(s.GetMemoryPatternGroup(transposed), nullptr);
+}
+
+TEST(SessionStateTest, MemoryPatternCacheConcurrentAccess) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+  s.SetMemoryPatternCacheOptions(false, 4);
+
+  constexpr int num_threads = 8;
+  constexpr int num_iterations = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&s, t]() {
+      for (int i = 0; i < num_iterations; ++i) {
+        // a small set of shared shapes plus a shape unique to this thread to force cache updates and evictions
+        TensorShape shape({1, (i % 3 == 0) ? 100 + t : i % 4});
+        std::vector<std::reference_wrapper<const TensorShape>> shapes{shape};
+        if (!s.GetMemoryPatternGroup(shapes)) {
+          ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_LE(stats.size, 4u);
+  EXPECT_EQ(stats.hits + stats.misses, static_cast<uint64_t>(num_threads * num_iterations));
+}
+
+TEST(SessionStateTest, MemoryPatternCacheFreesReplacedSnapshots) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+  s.SetMemoryPatternCacheOptions(false, 2);
+
+  // lookups never stop, so there is never a moment without an active reader. each replaced snapshot must still be
+  // freed once the lookups that use it are done.
+  constexpr int num_readers = 4;
+  constexpr int num_publishes = 2000;
+  std::atomic<bool> done{false};
+  std::atomic<size_t> max_snapshots{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < num_readers; ++t) {
+    readers.emplace_back([&]() {
+      TensorShape shape({1, 1});
+      std::vector<std::reference_wrapper<const TensorShape>> shapes{shape};
+      while (!done.load()) {
+        s.GetMemoryPatternGroup(shapes);
+        auto snapshots = s.GetMemoryPatternCacheStats().snapshots;
+        auto max = max_snapshots.load();
+        while (snapshots > max && !max_snapshots.compare_exchange_weak(max, snapshots)) {
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < num_publishes; ++i) {
+    TensorShape shape({1, 2 + i});
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{shape};
+    ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+  }
+
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  // the current snapshot, plus the replaced one while its writer waits for the lookups that use it
+  EXPECT_LE(max_snapshots.load(), 2u);
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.snapshots, 1u);
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.evictions, static_cast<uint64_t>(num_publishes - 2));
+}
+
+TEST(SessionStateTest, MemoryPatternCacheConcurrentLookups) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, nullptr};
+
+  TensorShape hot_shape({4, 4});
+  std::vector<std::reference_wrapper<const TensorShape>> hot{hot_shape};
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(hot, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+  const auto hot_pattern = s.GetMemoryPatternGroup(hot);
+  ASSERT_NE(hot_pattern, nullptr);
+
+  // the lookups of a cached shape keep finding the same pattern while other shapes are added
+  constexpr int num_readers = 8;
+  constexpr int num_lookups = 20000;
+  constexpr int num_publishes = 200;
+  std::atomic<int> wrong_results{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < num_readers; ++t) {
+    readers.emplace_back([&]() {
+      for (int i = 0; i < num_lookups; ++i) {
+        if (s.GetMemoryPatternGroup(hot) != hot_pattern) {
+          ++wrong_results;
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < num_publishes; ++i) {
+    TensorShape shape({1, 1 + i});
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{shape};
+    ASSERT_TRUE(s.UpdateMemoryPatternGroupCache(shapes, onnxruntime::make_unique<MemoryPatternGroup>()).IsOK());
+  }
+
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(wrong_results.load(), 0);
+  auto stats = s.GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, static_cast<uint64_t>(num_readers * num_lookups + 1));
+  EXPECT_EQ(stats.misses, 0u);
+  EXPECT_EQ(stats.size, static_cast<size_t>(num_publishes + 1));
+  // each writer frees the snapshot it replaced before it returns
+  EXPECT_EQ(stats.snapshots, 1u);
+}
+
+TEST(SessionStateTest, StaticMemoryPattern) {
+  concurrency::ThreadPool tp{"test", 1};
+
+  // X -> Relu -> Neg -> Y with a fixed shape for X
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_out});
+  graph.AddNode("neg", "Neg", "", {&relu_out}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  auto status = execution_providers.Add(kCpuExecutionProvider, onnxruntime::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SessionState session_state(execution_providers, true, &tp, nullptr);
+  SessionStateInitializer session_initializer(true, ORT_TSTR(""), graph, session_state, execution_providers, krm);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  status = partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  status = session_initializer.CreatePlan(nullptr, nullptr, ExecutionMode::ORT_SEQUENTIAL);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  status = session_state.GenerateStaticMemoryPattern();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  int x_idx, relu_out_idx;
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("relu_out", relu_out_idx).IsOK());
+
+  auto alloc = execution_providers.Get(kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(alloc, {2, 4}, std::vector<float>(8, 1.f), &feeds[0]);
+
+  auto patterns = session_state.GetStaticMemoryPatternGroup({x_idx}, feeds);
+  ASSERT_NE(patterns, nullptr);
+  auto pattern = patterns->GetPatterns(alloc->Info());
+  ASSERT_NE(pattern, nullptr);
+  auto block = pattern->GetBlock(relu_out_idx);
+  ASSERT_NE(block, nullptr);
+  EXPECT_GE(block->size_, 8 * sizeof(float));
+
+  // the pattern is only used for the shapes it was generated for
+  CreateMLValue<float>(alloc, {2, 5}, std::vector<float>(10, 1.f), &feeds[0]);
+  EXPECT_EQ(session_state.GetStaticMemoryPatternGroup({x_idx}, feeds), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
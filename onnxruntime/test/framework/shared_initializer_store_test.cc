@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <algorithm>
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+void DeleteFloatArray(void* param) noexcept {
+  delete[] reinterpret_cast<float*>(param);
+}
+
+void CreateValue(const std::vector<float>& data, OrtValue& value, OrtCallback& deleter) {
+  auto* buffer = new float[data.size()];
+  std::copy(data.begin(), data.end(), buffer);
+  deleter = OrtCallback{DeleteFloatArray, buffer};
+
+  OrtMemoryInfo cpu_memory_info(CPU, OrtDeviceAllocator, OrtDevice(), 0, OrtMemTypeDefault);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(new Tensor(DataTypeImpl::GetType<float>(), TensorShape({static_cast<int64_t>(data.size())}), buffer,
+                        cpu_memory_info),
+             ml_tensor, ml_tensor->GetDeleteFunc());
+}
+
+void Release(OrtCallback& deleter) {
+  if (deleter.f != nullptr) {
+    deleter.f(deleter.param);
+  }
+}
+}  // namespace
+
+TEST(SharedInitializerStoreTest, IdenticalTensorsAreShared) {
+  SharedInitializerStore store;
+
+  OrtValue value1, value2, value3;
+  OrtCallback deleter1, deleter2, deleter3;
+  CreateValue({1.f, 2.f, 3.f}, value1, deleter1);
+  CreateValue({1.f, 2.f, 3.f}, value2, deleter2);
+  CreateValue({1.f, 2.f, 4.f}, value3, deleter3);
+
+  ASSERT_TRUE(store.Share(value1, deleter1).IsOK());
+  ASSERT_TRUE(store.Share(value2, deleter2).IsOK());
+  ASSERT_TRUE(store.Share(value3, deleter3).IsOK());
+  EXPECT_EQ(store.Size(), 2u);
+
+  EXPECT_EQ(value1.Get<Tensor>().Data<float>(), value2.Get<Tensor>().Data<float>());
+  EXPECT_NE(value1.Get<Tensor>().Data<float>(), value3.Get<Tensor>().Data<float>());
+  EXPECT_EQ(value3.Get<Tensor>().Data<float>()[2], 4.f);
+
+  // the shared tensor stays alive while any holder has it
+  value1 = OrtValue();
+  Release(deleter1);
+  EXPECT_EQ(store.Size(), 2u);
+  EXPECT_EQ(value2.Get<Tensor>().Data<float>()[1], 2.f);
+
+  value2 = OrtValue();
+  Release(deleter2);
+  EXPECT_EQ(store.Size(), 1u);
+
+  value3 = OrtValue();
+  Release(deleter3);
+  EXPECT_EQ(store.Size(), 0u);
+}
+
+TEST(SharedInitializerStoreTest, ShapeIsPartOfTheMatch) {
+  SharedInitializerStore store;
+
+  OrtValue value1, value2;
+  OrtCallback deleter1, deleter2;
+  CreateValue({1.f, 2.f, 3.f, 4.f}, value1, deleter1);
+  CreateValue({1.f, 2.f, 3.f, 4.f}, value2, deleter2);
+  // same data viewed as a 2x2 tensor
+  const_cast<Tensor&>(value2.Get<Tensor>()).Reshape(TensorShape({2, 2}));
+
+  ASSERT_TRUE(store.Share(value1, deleter1).IsOK());
+  ASSERT_TRUE(store.Share(value2, deleter2).IsOK());
+  EXPECT_EQ(store.Size(), 2u);
+  EXPECT_NE(value1.Get<Tensor>().Data<float>(), value2.Get<Tensor>().Data<float>());
+
+  value1 = OrtValue();
+  value2 = OrtValue();
+  Release(deleter1);
+  Release(deleter2);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/tensor.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/packed_strings.h"
 #include "test_utils.h"
 
 #include "gmock/gmock.h"
@@ -21,8 +22,7 @@ void CPUTensorTest(std::vector<int64_t> dims, const int offset = 0) {
   EXPECT_TRUE(data);
   Tensor t(DataTypeImpl::GetType<T>(), shape, data, alloc->Info(), offset);
   auto tensor_shape = t.Shape();
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+  EXPECT_EQ(shape.GetDimsAsVector(), tensor_shape.GetDimsAsVector());
   EXPECT_EQ(t.DataType(), DataTypeImpl::GetType<T>());
   auto& location = t.Location();
   EXPECT_STREQ(location.name, CPU);
@@ -37,8 +37,7 @@ void CPUTensorTest(std::vector<int64_t> dims, const int offset = 0) {
   Tensor new_t(DataTypeImpl::GetType<T>(), shape, alloc, offset);
 
   tensor_shape = new_t.Shape();
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+  EXPECT_EQ(shape.GetDimsAsVector(), tensor_shape.GetDimsAsVector());
   EXPECT_EQ(new_t.DataType(), DataTypeImpl::GetType<T>());
   auto& new_location = new_t.Location();
   ASSERT_STREQ(new_location.name, CPU);
@@ -158,8 +157,7 @@ TEST(TensorTest, StringTensorTest) {
     Tensor t(DataTypeImpl::GetType<std::string>(), shape, alloc);
 
     auto& tensor_shape = t.Shape();
-    //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-    EXPECT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&shape), *reinterpret_cast<const std::vector<int64_t>*>(&tensor_shape));
+    EXPECT_EQ(shape.GetDimsAsVector(), tensor_shape.GetDimsAsVector());
     EXPECT_EQ(t.DataType(), DataTypeImpl::GetType<std::string>());
     auto& location = t.Location();
     ASSERT_STREQ(location.name, CPU);
@@ -177,6 +175,46 @@ TEST(TensorTest, StringTensorTest) {
   }
 }
 
+// the strings of a packed tensor are read and written in place, copied at once into another packed tensor, and
+// unpacked into std::string elements.
+TEST(TensorTest, PackedStringTensorTest) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  const std::vector<std::string> values{"a", "", "bcd", "ef"};
+  Tensor t(TensorShape({2, 2}), 6, alloc);
+  EXPECT_TRUE(t.IsPackedStrings());
+  EXPECT_EQ(t.DataType(), DataTypeImpl::GetType<std::string>());
+  EXPECT_EQ(t.SizeInBytes(), 5 * sizeof(int64_t) + 6);
+
+  StringTensorWriter writer(t);
+  for (const auto& value : values) {
+    writer.Append(value.data(), value.size());
+  }
+  EXPECT_THAT(std::vector<int64_t>(t.PackedStringOffsets(), t.PackedStringOffsets() + 5),
+              testing::ElementsAre(0, 1, 1, 4, 6));
+  EXPECT_EQ(StringTensorLength(t), 6u);
+
+  StringTensorReader reader(t);
+  ASSERT_EQ(reader.Size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(std::string(reader.Data(i), reader.Length(i)), values[i]);
+  }
+
+  Tensor tail(TensorShape({2}), 5, alloc);
+  StringTensorWriter tail_writer(tail);
+  tail_writer.Append(reader, 2, 4);
+  EXPECT_THAT(std::vector<int64_t>(tail.PackedStringOffsets(), tail.PackedStringOffsets() + 3),
+              testing::ElementsAre(0, 3, 5));
+  EXPECT_EQ(std::string(tail.PackedStringChars(), 5), "bcdef");
+
+  OrtValue unpacked;
+  UnpackStrings(t, alloc, unpacked);
+  const auto& unpacked_tensor = unpacked.Get<Tensor>();
+  EXPECT_FALSE(unpacked_tensor.IsPackedStrings());
+  EXPECT_EQ(unpacked_tensor.Shape(), t.Shape());
+  EXPECT_EQ(std::vector<std::string>(unpacked_tensor.Data<std::string>(), unpacked_tensor.Data<std::string>() + 4),
+            values);
+}
+
 TEST(TensorTest, ConvertToString) {
   TensorShape shape({2, 3, 4});
 
@@ -195,5 +233,32 @@ TEST(TensorTest, Int64PtrConstructor) {
   EXPECT_THAT(shape.GetDims(), testing::ElementsAre(2, 3));
 }
 
+// shapes up to the inline rank keep their dimensions in the TensorShape, longer ones on the heap. both have to
+// survive copies and moves, and the moved-from shape is a scalar.
+TEST(TensorTest, InlineAndHeapShapes) {
+  std::vector<int64_t> long_dims{2, 3, 4, 5, 6, 7, 8};
+  for (const auto& dims : {std::vector<int64_t>{2, 3, 4}, long_dims}) {
+    TensorShape shape(dims);
+    EXPECT_EQ(shape.GetDims(), dims);
+    EXPECT_EQ(shape.GetDimsAsVector(), dims);
+
+    TensorShape copy(shape);
+    EXPECT_EQ(copy, shape);
+    copy[0] = 9;
+    EXPECT_EQ(shape[0], 2);
+
+    TensorShape moved(std::move(copy));
+    EXPECT_EQ(moved[0], 9);
+    EXPECT_EQ(moved.NumDimensions(), dims.size());
+    EXPECT_EQ(copy.NumDimensions(), 0u);
+
+    copy = shape;
+    EXPECT_EQ(copy, shape);
+    copy = TensorShape({1});
+    EXPECT_THAT(copy.GetDims(), testing::ElementsAre(1));
+    EXPECT_EQ(shape.Slice(1).Size(), shape.Size() / 2);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
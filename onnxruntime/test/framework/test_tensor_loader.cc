@@ -72,6 +72,33 @@ TEST(CApiTest, load_simple_float_tensor) {
   }
 }
 
+TEST(CApiTest, load_raw_data_tensor_in_place) {
+  std::vector<float> input{1.0f, 2.2f, 3.5f};
+  onnx::TensorProto p;
+  p.set_raw_data(input.data(), input.size() * sizeof(float));
+  p.mutable_dims()->Add(3);
+  p.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  ASSERT_TRUE(utils::CanUseTensorProtoDataInPlace(p));
+
+  OrtValue value;
+  auto deleter = onnxruntime::make_unique<onnxruntime::OrtCallback>();
+  OrtMemoryInfo cpu_memory_info(onnxruntime::CPU, OrtDeviceAllocator, OrtDevice(), 0, OrtMemTypeDefault);
+  auto st = utils::TensorProtoToMLValueInPlace(Env::Default(), nullptr, p, cpu_memory_info, value, *deleter);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  // the data was moved out of the tensor proto
+  ASSERT_TRUE(p.raw_data().empty());
+  float* real_output;
+  auto ort_st = g_ort->GetTensorMutableData(&value, (void**)&real_output);
+  ASSERT_EQ(ort_st, nullptr) << g_ort->GetErrorMessage(ort_st);
+  ASSERT_EQ(real_output[0], 1.0f);
+  ASSERT_EQ(real_output[1], 2.2f);
+  ASSERT_EQ(real_output[2], 3.5f);
+  g_ort->ReleaseStatus(ort_st);
+  if (deleter->f) {
+    OrtRunCallback(deleter.release());
+  }
+}
+
 template <bool use_current_dir>
 static void run_external_data_test() {
   FILE* fp;
@@ -17,6 +17,7 @@
 #else
 #pragma GCC diagnostic pop
 #endif
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
@@ -604,6 +605,54 @@ TEST(ResolvingGraphTest, UnusedInitializerIsIgnored) {
   ASSERT_TRUE(graph.GetAllInitializedTensors().empty());
 }
 
+TEST(ResolvingGraphTest, SparseInitializerIsDensified) {
+  ASSERT_TRUE(kSchemasRegistered);
+
+  Model model("SparseInitializerIsDensified", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_int32;
+  tensor_int32.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  tensor_int32.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_int32.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("sparse_weight", &tensor_int32);
+  auto& output_arg = graph.GetOrCreateNodeArg("node_out", &tensor_int32);
+  graph.AddNode("a", "Identity_Fake", "a", {&input_arg}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // store the input as a sparse initializer with the values 7 at (0, 1) and -3 at (1, 2)
+  ModelProto model_proto = model.ToProto();
+  SparseTensorProto* sparse_tensor = model_proto.mutable_graph()->add_sparse_initializer();
+  sparse_tensor->add_dims(2);
+  sparse_tensor->add_dims(3);
+  TensorProto* values = sparse_tensor->mutable_values();
+  values->set_name("sparse_weight");
+  values->set_data_type(TensorProto_DataType_INT32);
+  values->add_dims(2);
+  values->add_int32_data(7);
+  values->add_int32_data(-3);
+  TensorProto* indices = sparse_tensor->mutable_indices();
+  indices->set_data_type(TensorProto_DataType_INT64);
+  indices->add_dims(2);
+  indices->add_dims(2);
+  for (int64_t index : {0, 1, 1, 2}) {
+    indices->add_int64_data(index);
+  }
+
+  std::shared_ptr<Model> loaded_model;
+  ASSERT_STATUS_OK(Model::Load(model_proto, loaded_model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  auto& loaded_graph = loaded_model->MainGraph();
+  ASSERT_STATUS_OK(loaded_graph.Resolve());
+
+  const TensorProto* dense_tensor = nullptr;
+  ASSERT_TRUE(loaded_graph.GetInitializedTensor("sparse_weight", dense_tensor));
+  std::vector<int32_t> dense_values(6);
+  ASSERT_STATUS_OK(utils::UnpackTensor(*dense_tensor, dense_tensor->raw_data().data(), dense_tensor->raw_data().size(),
+                                       dense_values.data(), 6));
+  EXPECT_THAT(dense_values, testing::ElementsAre(0, 7, 0, 0, 0, -3));
+}
+
 TEST(ResolvingGraphTest, GraphConstruction_CheckIsNotAcyclic) {
   // A cyclic graph
   //                 SouceNode
@@ -849,6 +898,34 @@ TEST(TypeInferenceTest, VariadicOutput) {
   CheckTensorEltType(Z.TypeAsProto(), TensorProto_DataType_FLOAT);
 }
 
+// test that a shape change on a graph input is propagated through nodes that were already inferred
+TEST(TypeInferenceTest, ReResolveAfterInputShapeChange) {
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  auto& X = graph.GetOrCreateNodeArg("X", &tensor_type);
+  auto& Y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& Z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("node_1", "Relu", "node 1.", {&X}, {&Y});
+  graph.AddNode("node_2", "Relu", "node 2.", {&Y}, {&Z});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(Z.Shape() == nullptr);
+
+  TensorShapeProto shape;
+  shape.add_dim()->set_dim_value(2);
+  shape.add_dim()->set_dim_value(3);
+  X.SetShape(shape);
+  graph.SetGraphResolveNeeded();
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(Z.Shape() != nullptr);
+  ASSERT_EQ(Z.Shape()->dim_size(), 2);
+  EXPECT_EQ(Z.Shape()->dim(0).dim_value(), 2);
+  EXPECT_EQ(Z.Shape()->dim(1).dim_value(), 3);
+}
+
 // test that we prefer the graph input shape for a non-const initializer (initializer with matching graph input)
 TEST(TypeInferenceTest, NonConstInitializer) {
   Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
@@ -908,6 +985,34 @@ TEST(TypeInferenceTest, NonConstInitializer) {
   resolve_and_validate(graph2);
 }
 
+// the NodeProtos are released once the Nodes are created, so ToProto needs to regenerate them
+TEST(ResolvingGraphTest, NodeProtosRegeneratedAfterLoad) {
+  Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& X = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& Y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& Z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  graph.AddNode("node_1", "Relu", "node 1.", {&X}, {&Y});
+  graph.AddNode("node_2", "Relu", "node 2.", {&Y}, {&Z});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const ModelProto model_proto = model.ToProto();
+  ASSERT_EQ(model_proto.graph().node_size(), 2);
+
+  std::shared_ptr<onnxruntime::Model> p_model;
+  status = onnxruntime::Model::Load(model_proto, p_model, nullptr, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+  EXPECT_EQ(p_model->MainGraph().NumberOfNodes(), 2);
+
+  const ModelProto model_proto2 = p_model->ToProto();
+  EXPECT_EQ(model_proto2.SerializeAsString(), model_proto.SerializeAsString());
+}
+
 // Test that Graph::Resolve identifies name-duplication across initializer and node-output-arg
 TEST(NameResolutionTest, DuplicateName) {
   Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
@@ -17,8 +17,14 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <limits>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -40,7 +46,8 @@ Abstract:
 #define MLAS_HAS_DGEMM
 #endif
 
-#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__)
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__) || \
+    defined(_M_ARM64) || defined(__aarch64__)
 #define MLAS_HAS_QGEMM_U8X8
 #endif
 
@@ -197,7 +204,7 @@ public:
         ) = 0;
 };
 
-template <typename T>
+template <typename T, bool Packed = false>
 class MlasFgemmTest : public MlasTestBase
 {
 private:
@@ -242,7 +249,15 @@ private:
         std::fill_n(C, M * N, -0.5f);
         std::fill_n(CReference, M * N, -0.5f);
 
-        MlasGemm(TransA, TransB, M, N, K, T(alpha), A, lda, B, ldb, T(beta), C, ldc, threadpool);
+        if (Packed) {
+            static_assert(!Packed || std::is_same<T, float>::value, "Only SGEMM supports packing matrix B");
+            size_t PackedBSize = MlasGemmPackBSize(N, K);
+            void* PackedB = BufferBPacked.GetBuffer(PackedBSize / sizeof(float));
+            MlasGemmPackB(TransB, N, K, (const float*)B, ldb, PackedB);
+            MlasGemm(TransA, M, N, K, alpha, (const float*)A, lda, PackedB, beta, (float*)C, ldc, threadpool);
+        } else {
+            MlasGemm(TransA, TransB, M, N, K, T(alpha), A, lda, B, ldb, T(beta), C, ldc, threadpool);
+        }
         ReferenceGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc);
 
         for (size_t f = 0; f < M * N; f++) {
@@ -366,6 +381,7 @@ private:
     MatrixGuardBuffer<T> BufferB;
     MatrixGuardBuffer<T> BufferC;
     MatrixGuardBuffer<T> BufferCReference;
+    MatrixGuardBuffer<float> BufferBPacked;
 
 public:
     void
@@ -382,6 +398,12 @@ public:
         for (size_t b = 256; b < 320; b += 32) {
             Test(b, b, b, 1.0f, 0.0f);
         }
+        if (Packed) {
+            // span multiple packed panels along N and K with a partial last panel
+            Test(1, 300, 600, 1.0f, 0.0f);
+            Test(33, 257, 513, 0.5f, 1.0f);
+            Test(64, 640, 256, 1.0f, -0.5f);
+        }
     }
 
     void
@@ -459,10 +481,8 @@ public:
     }
 };
 
-#ifdef MLAS_HAS_QGEMM_U8X8
-
-template <typename xint8_t>
-class MlasQgemmU8X8Test : public MlasTestBase
+template <bool Packed>
+class MlasSgemmOutputStageTest : public MlasTestBase
 {
 private:
     void
@@ -470,86 +490,318 @@ private:
         size_t M,
         size_t N,
         size_t K,
-        uint8_t offa,
-        uint8_t offb
+        size_t BiasRowStride,
+        size_t BiasColumnStride,
+        float BiasScale
         )
     {
-        const uint8_t* A = BufferA.GetBuffer(K * M);
-        const xint8_t* B = BufferB.GetBuffer(N * K);
-        int32_t* C = BufferC.GetBuffer(N * M);
-        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* Bias = BufferBias.GetBuffer(N * M);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
 
-        Test(M, N, K, A, K, offa, B, N, xint8_t(offb), C, CReference, N);
+        for (size_t f = 0; f < M * N; f++) {
+            Bias[f] = float(int(f % 13) - 6);
+        }
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
+
+        MLAS_SGEMM_OUTPUT_STAGE OutputStage;
+        OutputStage.Bias = Bias;
+        OutputStage.BiasRowStride = BiasRowStride;
+        OutputStage.BiasColumnStride = BiasColumnStride;
+        OutputStage.BiasScale = BiasScale;
+        OutputStage.Activation = &Activation;
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        if (Packed) {
+            size_t PackedBSize = MlasGemmPackBSize(N, K);
+            void* PackedB = BufferBPacked.GetBuffer(PackedBSize / sizeof(float));
+            MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+            MlasGemm(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, 0.0f, C, N, &OutputStage, threadpool);
+        } else {
+            MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, &OutputStage, threadpool);
+        }
+        MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, CReference, N, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float Value = CReference[m * N + n] + Bias[m * BiasRowStride + n * BiasColumnStride] * BiasScale;
+                Value = std::max(Value, 0.0f);
+                if (C[m * N + n] != Value) {
+                    printf("mismatch M=%zd, N=%zd, K=%zd, BiasRowStride=%zd, BiasColumnStride=%zd %f %f!\n",
+                        M, N, K, BiasRowStride, BiasColumnStride, C[m * N + n], Value);
+                    return;
+                }
+            }
+        }
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        Test(M, N, K, 0, 0, 1.0f);
+        Test(M, N, K, 0, 1, 1.0f);
+        Test(M, N, K, 1, 0, 0.5f);
+        Test(M, N, K, N, 1, 2.0f);
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<float> BufferBPacked;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b);
+        }
+        Test(1, 300, 600);
+        Test(33, 257, 513);
+        Test(200, 17, 31);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 160; M += 3) {
+            for (size_t N = 1; N < 160; N += 5) {
+                for (size_t K = 1; K < 160; K += 7) {
+                    Test(M, N, K);
+                }
+            }
+            printf("M %zd\n", M);
+        }
     }
+};
 
+class MlasSgemmBatchTest : public MlasTestBase
+{
+private:
     void
     Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t BatchN,
         size_t M,
         size_t N,
         size_t K,
-        const uint8_t* A,
-        size_t lda,
-        uint8_t offa,
-        const xint8_t* B,
-        size_t ldb,
-        xint8_t offb,
-        int32_t* C,
-        int32_t* CReference,
-        size_t ldc
+        bool BroadcastB,
+        float beta
         )
     {
-        std::fill_n(C, M * N, -1);
-        std::fill_n(CReference, M * N, -1);
+        const size_t BCount = BroadcastB ? 1 : BatchN;
+        const size_t lda = (TransA == CblasNoTrans) ? K : M;
+        const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+        const float* A = BufferA.GetBuffer(K * M * BatchN);
+        const float* B = BufferB.GetBuffer(N * K * BCount);
+        float* C = BufferC.GetBuffer(N * M * BatchN);
+        float* CReference = BufferCReference.GetBuffer(N * M * BatchN);
+
+        std::vector<const float*> APointers(BatchN);
+        std::vector<const float*> BPointers(BatchN);
+        std::vector<float*> CPointers(BatchN);
+
+        for (size_t b = 0; b < BatchN; b++) {
+            APointers[b] = A + b * K * M;
+            BPointers[b] = B + (BroadcastB ? 0 : b * N * K);
+            CPointers[b] = C + b * N * M;
+        }
 
-        MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, threadpool);
-        ReferenceQgemm(M, N, K, A, lda, offa, B, ldb, offb, CReference, ldc);
+        std::fill_n(C, M * N * BatchN, -0.5f);
+        std::fill_n(CReference, M * N * BatchN, -0.5f);
 
-        for (size_t f = 0; f < M * N; f++) {
+        MlasGemmBatch(TransA, TransB, M, N, K, 1.0f, APointers.data(), lda, BPointers.data(), ldb, beta,
+            CPointers.data(), N, BatchN, threadpool);
+
+        for (size_t b = 0; b < BatchN; b++) {
+            MlasGemm(TransA, TransB, M, N, K, 1.0f, APointers[b], lda, BPointers[b], ldb, beta,
+                CReference + b * N * M, N, threadpool);
+        }
+
+        for (size_t f = 0; f < M * N * BatchN; f++) {
             if (C[f] != CReference[f]) {
-                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+                printf("mismatch TransA=%d, TransB=%d, BatchN=%zd, M=%zd, N=%zd, K=%zd, BroadcastB=%d %f %f!\n",
+                    TransA, TransB, BatchN, M, N, K, int(BroadcastB), C[f], CReference[f]);
+                return;
             }
         }
     }
 
     void
-    ReferenceQgemm(
+    Test(
+        size_t BatchN,
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        Test(CblasNoTrans, CblasNoTrans, BatchN, M, N, K, false, 0.0f);
+        Test(CblasNoTrans, CblasNoTrans, BatchN, M, N, K, true, 1.0f);
+        Test(CblasTrans, CblasNoTrans, BatchN, M, N, K, true, 0.0f);
+        Test(CblasNoTrans, CblasTrans, BatchN, M, N, K, false, 0.5f);
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t BatchN = 1; BatchN <= 12; BatchN += 3) {
+            Test(BatchN, 1, 1, 1);
+            Test(BatchN, 7, 9, 11);
+            Test(BatchN, 16, 16, 16);
+            Test(BatchN, 64, 64, 64);
+            Test(BatchN, 1, 300, 600);
+            Test(BatchN, 200, 17, 31);
+            Test(BatchN, 33, 257, 513);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t BatchN = 1; BatchN < 40; BatchN += 7) {
+            for (size_t M = 1; M < 160; M += 13) {
+                for (size_t N = 1; N < 160; N += 17) {
+                    for (size_t K = 1; K < 160; K += 19) {
+                        Test(BatchN, M, N, K);
+                    }
+                }
+            }
+            printf("BatchN %zd\n", BatchN);
+        }
+    }
+};
+
+class MlasBf16GemmTest : public MlasTestBase
+{
+private:
+    static
+    float
+    RoundToBf16(
+        float Value
+        )
+    {
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+        Bits += 0x7FFF + ((Bits >> 16) & 1);
+        Bits &= 0xFFFF0000;
+        memcpy(&Value, &Bits, sizeof(Value));
+        return Value;
+    }
+
+    void
+    Test(
         size_t M,
         size_t N,
         size_t K,
-        const uint8_t* A,
-        size_t lda,
-        uint8_t offa,
-        const xint8_t* B,
+        float alpha,
+        float beta
+        )
+    {
+        float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        // scale the integer fill values so that rounding to bfloat16 is exercised
+        for (size_t i = 0; i < K * M; i++) {
+            A[i] *= 0.3f;
+        }
+        for (size_t i = 0; i < N * K; i++) {
+            B[i] *= 0.1f;
+        }
+
+        Test(CblasNoTrans, M, N, K, alpha, A, B, N, beta, C, CReference);
+        Test(CblasTrans, M, N, K, alpha, A, B, K, beta, C, CReference);
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        const float* B,
         size_t ldb,
-        xint8_t offb,
-        int32_t* C,
-        size_t ldc
+        float beta,
+        float* C,
+        float* CReference
         )
     {
-        for (size_t m = 0; m < M; m++) {
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        size_t PackedBSize = MlasBf16GemmPackBSize(N, K);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+        MlasBf16GemmPackB(TransB, N, K, B, ldb, PackedB);
+        MlasBf16Gemm(M, N, K, alpha, A, K, PackedB, beta, C, N, threadpool);
 
+        // matrix B is always rounded to bfloat16. matrix A is only rounded if
+        // the inner products use the bfloat16 instructions.
+        const bool RoundA = MlasBf16GemmIsAccelerated();
+
+        for (size_t m = 0; m < M; m++) {
             for (size_t n = 0; n < N; n++) {
 
-                const uint8_t* a = A + (m * lda);
-                const xint8_t* b = B + n;
-                int32_t* c = C + (m * ldc) + n;
-                int32_t sum = 0;
+                double sum = 0.0;
+                double magnitude = 0.0;
 
                 for (size_t k = 0; k < K; k++) {
-                    sum += ((int32_t(*b) - offb) * (int32_t(*a) - offa));
-                    b += ldb;
-                    a += 1;
+                    float a = A[m * K + k];
+                    float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+                    double product = double(RoundA ? RoundToBf16(a) : a) * double(RoundToBf16(b));
+                    sum += product;
+                    magnitude += std::fabs(product);
                 }
 
-                *c = sum;
+                float* c = CReference + m * N + n;
+                double reference = double(*c) * beta + sum * alpha;
+                double tolerance = 1e-4 * (magnitude * std::fabs(alpha) + std::fabs(double(*c) * beta)) + 1e-6;
+
+                if (std::fabs(double(C[m * N + n]) - reference) > tolerance) {
+                    printf("mismatch TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransB, M, N, K, alpha, beta, C[m * N + n], float(reference));
+                }
             }
         }
     }
 
-    MatrixGuardBuffer<uint8_t> BufferA;
-    MatrixGuardBuffer<xint8_t> BufferB;
-    MatrixGuardBuffer<int32_t> BufferC;
-    MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
 
 public:
     void
@@ -558,19 +810,16 @@ public:
         ) override
     {
         for (size_t b = 1; b < 16; b++) {
-            Test(b, b, b, 14, 211);
+            Test(b, b, b, 1.0f, 0.0f);
         }
         for (size_t b = 16; b <= 256; b <<= 1) {
-            Test(b, b, b, 34, 1);
-        }
-        for (size_t b = 256; b < 320; b += 32) {
-            Test(b, b, b, 85, 173);
-        }
-        for (size_t b = 1; b < 96; b++) {
-            Test(1, b, 32, 0, 0);
-            Test(1, 32, b, 0, 0);
-            Test(1, b, b, 0, 0);
+            Test(b, b, b, 1.0f, 0.0f);
         }
+        // span multiple packed panels along N and K with partial and odd last slices
+        Test(1, 300, 600, 1.0f, 0.0f);
+        Test(33, 257, 513, 0.5f, 1.0f);
+        Test(7, 129, 301, 1.0f, -0.5f);
+        Test(64, 640, 256, 1.0f, 0.0f);
     }
 
     void
@@ -578,335 +827,2287 @@ public:
         void
         ) override
     {
-        static const uint8_t zero_points[] = { 0, 18, 75, 128, 157, 231, 255 };
-
-        for (size_t a = 0; a < _countof(zero_points); a++) {
-            uint8_t offa = zero_points[a];
-
-            for (size_t b = 0; b < _countof(zero_points); b++) {
-                uint8_t offb = zero_points[b];
-
-                for (size_t M = 16; M < 160; M += 32) {
-                    for (size_t N = 16; N < 160; N += 32) {
-
-                        static const size_t ks[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 20, 32, 48, 64, 118, 119, 120, 121, 122, 160, 240, 320 };
-                        for (size_t k = 0; k < _countof(ks); k++) {
-                            size_t K = ks[k];
+        static const float multipliers[] = { 0.0f, -0.5f, 1.0f };
 
-                            Test(M, N, K, offa, offb);
-                            Test(M + 1, N, K, offa, offb);
-                            Test(M, N + 1, K, offa, offb);
-                            Test(M + 1, N + 1, K, offa, offb);
-                            Test(M + 3, N + 2, K, offa, offb);
-                            Test(M + 4, N, K, offa, offb);
-                            Test(M, N + 4, K, offa, offb);
-                            Test(M + 4, N + 4, K, offa, offb);
-                            Test(M + 3, N + 7, K, offa, offb);
-                            Test(M + 8, N, K, offa, offb);
-                            Test(M, N + 8, K, offa, offb);
-                            Test(M + 12, N + 12, K, offa, offb);
-                            Test(M + 13, N, K, offa, offb);
-                            Test(M, N + 15, K, offa, offb);
-                            Test(M + 15, N + 15, K, offa, offb);
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 20; M += 3) {
+                    for (size_t N = 1; N < 200; N += 13) {
+                        for (size_t K = 1; K < 600; K += 37) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
                         }
                     }
-                    printf("a %zd/%zd b %zd/%zd M %zd\n", a, _countof(zero_points), b, _countof(zero_points), M);
                 }
             }
         }
+    }
+};
 
-        for (size_t M = 1; M < 160; M++) {
-            for (size_t N = 1; N < 160; N++) {
-                for (size_t K = 1; K < 160; K++) {
-                    Test(M, N, K, 18, 24);
-                }
-            }
-            printf("M %zd\n", M);
+class MlasHalfGemmTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferB.GetBuffer(N * K);
+        float* BRounded = BufferBRounded.GetBuffer(N * K);
+        unsigned short* BHalf = BufferBHalf.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        // scale the integer fill values so that rounding to half precision is
+        // exercised. the reference uses the rounded values of matrix B, which
+        // are checked by the half precision conversion tests.
+        for (size_t i = 0; i < N * K; i++) {
+            B[i] *= 0.1f;
         }
 
-        for (size_t M = 160; M < 320; M += 24) {
-            for (size_t N = 112; N < 320; N += 24) {
-                for (size_t K = 1; K < 16; K++) {
-                    Test(M, N, K, 1, 3);
-                }
-                for (size_t K = 16; K < 160; K += 32) {
-                    Test(M, N, K, 5, 7);
-                }
-            }
-            printf("M %zd\n", M);
-        }
-    }
-};
+        MlasConvertFloatToHalfBuffer(B, BHalf, N * K);
+        MlasConvertHalfToFloatBuffer(BHalf, BRounded, N * K);
 
-#endif
+        Test(CblasNoTrans, M, N, K, alpha, A, B, BRounded, N, beta, C, CReference);
+        Test(CblasTrans, M, N, K, alpha, A, B, BRounded, K, beta, C, CReference);
+    }
 
-class MlasConv2DTest : public MlasTestBase
-{
-protected:
     void
     Test(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        const float* B,
+        const float* BRounded,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference
         )
     {
-        int64_t OutputHeight64 =
-            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
-            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
-        int64_t OutputWidth64 =
-            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
-            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
 
-        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
-            return;
-        }
+        size_t PackedBSize = MlasHalfGemmPackBSize(N, K);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+        MlasHalfGemmPackB(TransB, N, K, B, ldb, PackedB);
+        MlasHalfGemm(M, N, K, alpha, A, K, PackedB, beta, C, N, threadpool);
 
-        size_t OutputHeight = size_t(OutputHeight64);
-        size_t OutputWidth = size_t(OutputWidth64);
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
 
-        size_t InputSize = InputHeight * InputWidth;
-        size_t KernelSize = KernelHeight * KernelWidth;
-        size_t OutputSize = OutputHeight * OutputWidth;
+                double sum = 0.0;
+                double magnitude = 0.0;
 
-        size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
-        size_t FilterElements = GroupCount * FilterCount * InputChannels * KernelSize;
-        size_t BiasElements = GroupCount * FilterCount;
-        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+                for (size_t k = 0; k < K; k++) {
+                    float a = A[m * K + k];
+                    float b = (TransB == CblasNoTrans) ? BRounded[k * ldb + n] : BRounded[n * ldb + k];
+                    double product = double(a) * double(b);
+                    sum += product;
+                    magnitude += std::fabs(product);
+                }
 
-        const float* Input = BufferInput.GetBuffer(InputElements);
-        const float* Filter = BufferFilter.GetBuffer(FilterElements);
-        const float* Bias = BufferBias.GetBuffer(BiasElements);
-        float* Output = BufferOutput.GetBuffer(OutputElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+                float* c = CReference + m * N + n;
+                double reference = double(*c) * beta + sum * alpha;
+                double tolerance = 1e-5 * (magnitude * std::fabs(alpha) + std::fabs(double(*c) * beta)) + 1e-6;
 
-        MlasConv2D(BatchCount,
-                   GroupCount,
-                   InputChannels,
-                   InputHeight, InputWidth,
-                   FilterCount,
-                   KernelHeight, KernelWidth,
-                   PaddingLeftHeight, PaddingLeftWidth,
-                   PaddingRightHeight, PaddingRightWidth,
-                   DilationHeight, DilationWidth,
-                   StrideHeight, StrideWidth,
-                   OutputHeight, OutputWidth,
-                   Input,
-                   Filter,
-                   Bias,
-                   Output);
+                if (std::fabs(double(C[m * N + n]) - reference) > tolerance) {
+                    printf("mismatch TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransB, M, N, K, alpha, beta, C[m * N + n], float(reference));
+                }
+            }
+        }
+    }
 
-        ReferenceConv2D(BatchCount,
-                        GroupCount,
-                        InputChannels,
-                        InputHeight, InputWidth,
-                        FilterCount,
-                        KernelHeight, KernelWidth,
-                        PaddingLeftHeight, PaddingLeftWidth,
-                        DilationHeight, DilationWidth,
-                        StrideHeight, StrideWidth,
-                        OutputHeight, OutputWidth,
-                        Input,
-                        Filter,
-                        Bias,
-                        OutputReference);
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBRounded;
+    MatrixGuardBuffer<unsigned short> BufferBHalf;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
 
-        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
-            printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
-                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
-                KernelHeight, KernelWidth);
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
         }
+        // span multiple packed panels along N and K with partial last slices
+        Test(1, 300, 600, 1.0f, 0.0f);
+        Test(33, 257, 513, 0.5f, 1.0f);
+        Test(7, 129, 301, 1.0f, -0.5f);
+        Test(64, 640, 256, 1.0f, 0.0f);
     }
 
-    virtual
     void
-    MlasConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const float multipliers[] = { 0.0f, -0.5f, 1.0f };
+
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 20; M += 3) {
+                    for (size_t N = 1; N < 200; N += 13) {
+                        for (size_t K = 1; K < 600; K += 37) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasSparseGemmTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
         )
     {
-        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+        float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        // set at most one in twelve values of matrix B
+        std::fill_n(B, N * K, 0.0f);
+        for (size_t i = 0; i < N * K / 12; i++) {
+            B[(i * 2654435761u) % (N * K)] = float(int(i % 23) - 11);
+        }
 
-        MLAS_ACTIVATION Activation;
-        Activation.ActivationKind = MlasIdentityActivation;
+        Test(CblasNoTrans, CblasNoTrans, M, N, K, alpha, A, K, B, N, beta, C, CReference);
+        Test(CblasNoTrans, CblasTrans, M, N, K, alpha, A, K, B, K, beta, C, CReference);
+        Test(CblasTrans, CblasNoTrans, M, N, K, alpha, A, M, B, N, beta, C, CReference);
+        Test(CblasTrans, CblasTrans, M, N, K, alpha, A, M, B, K, beta, C, CReference);
+    }
 
-        MLAS_CONV_PARAMETERS Parameters;
-        size_t WorkingBufferSize;
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference
+        )
+    {
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
 
-        MlasConvPrepare(&Parameters,
-                        2,
-                        BatchCount,
-                        GroupCount,
-                        InputChannels,
-                        InputShape,
-                        KernelShape,
-                        DilationShape,
-                        Padding,
-                        StrideShape,
-                        OutputShape,
-                        FilterCount,
-                        &Activation,
-                        &WorkingBufferSize,
-                        nullptr);
+        size_t PackedBSize = MlasSparseGemmPackBSize(TransB, N, K, B, ldb);
+        if (PackedBSize == 0) {
+            printf("mlas sparse gemm rejected a sparse B: N=%zd, K=%zd\n", N, K);
+            return;
+        }
 
-        MlasConv(&Parameters,
-                 Input,
-                 Filter,
-                 Bias,
-                 BufferWorking.GetBuffer(WorkingBufferSize),
-                 Output,
-                 nullptr);
+        void* PackedB = BufferBPacked.GetBuffer(PackedBSize);
+        MlasSparseGemmPackB(TransB, N, K, B, ldb, PackedB);
+        MlasSparseGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool);
+
+        ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+        for (size_t f = 0; f < M * N; f++) {
+            // Sensitive to comparing positive/negative zero.
+            if (C[f] != CReference[f]) {
+                printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
     }
 
     void
-    ReferenceConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
+    ReferenceSgemm(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        size_t ldc
         )
     {
-        size_t InputSize = InputHeight * InputWidth;
-        size_t OutputSize = OutputHeight * OutputWidth;
-        size_t KernelSize = KernelHeight * KernelWidth;
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+
+                float sum = 0.0f;
+
+                for (size_t k = 0; k < K; k++) {
+                    float a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+                    float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+                    sum += a * b;
+                }
+
+                float* c = C + (m * ldc) + n;
+                *c = (*c * beta) + (sum * alpha);
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 20; b++) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        // span multiple blocks of rows of matrix B with a partial last block
+        Test(1, 300, 600, 1.0f, 0.0f);
+        Test(33, 257, 513, 0.5f, 1.0f);
+        Test(7, 129, 301, 1.0f, -0.5f);
+        Test(64, 640, 256, 1.0f, 0.0f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const float multipliers[] = { 0.0f, -0.5f, 1.0f };
+
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 40; M += 3) {
+                    for (size_t N = 1; N < 200; N += 13) {
+                        for (size_t K = 1; K < 600; K += 37) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+#ifdef MLAS_HAS_QGEMM_U8X8
+
+template <typename xint8_t>
+class MlasQgemmU8X8Test : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        uint8_t offb
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M);
+        const xint8_t* B = BufferB.GetBuffer(N * K);
+        int32_t* C = BufferC.GetBuffer(N * M);
+        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+
+        Test(M, N, K, A, K, offa, B, N, xint8_t(offb), C, CReference, N);
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        const uint8_t* A,
+        size_t lda,
+        uint8_t offa,
+        const xint8_t* B,
+        size_t ldb,
+        xint8_t offb,
+        int32_t* C,
+        int32_t* CReference,
+        size_t ldc
+        )
+    {
+        std::fill_n(C, M * N, -1);
+        std::fill_n(CReference, M * N, -1);
+
+        MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, threadpool);
+        ReferenceQgemm(M, N, K, A, lda, offa, B, ldb, offb, CReference, ldc);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+            }
+        }
+    }
+
+    void
+    ReferenceQgemm(
+        size_t M,
+        size_t N,
+        size_t K,
+        const uint8_t* A,
+        size_t lda,
+        uint8_t offa,
+        const xint8_t* B,
+        size_t ldb,
+        xint8_t offb,
+        int32_t* C,
+        size_t ldc
+        )
+    {
+        for (size_t m = 0; m < M; m++) {
+
+            for (size_t n = 0; n < N; n++) {
+
+                const uint8_t* a = A + (m * lda);
+                const xint8_t* b = B + n;
+                int32_t* c = C + (m * ldc) + n;
+                int32_t sum = 0;
+
+                for (size_t k = 0; k < K; k++) {
+                    sum += ((int32_t(*b) - offb) * (int32_t(*a) - offa));
+                    b += ldb;
+                    a += 1;
+                }
+
+                *c = sum;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<uint8_t> BufferA;
+    MatrixGuardBuffer<xint8_t> BufferB;
+    MatrixGuardBuffer<int32_t> BufferC;
+    MatrixGuardBuffer<int32_t> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 14, 211);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 34, 1);
+        }
+        for (size_t b = 256; b < 320; b += 32) {
+            Test(b, b, b, 85, 173);
+        }
+        for (size_t b = 1; b < 96; b++) {
+            Test(1, b, 32, 0, 0);
+            Test(1, 32, b, 0, 0);
+            Test(1, b, b, 0, 0);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const uint8_t zero_points[] = { 0, 18, 75, 128, 157, 231, 255 };
+
+        for (size_t a = 0; a < _countof(zero_points); a++) {
+            uint8_t offa = zero_points[a];
+
+            for (size_t b = 0; b < _countof(zero_points); b++) {
+                uint8_t offb = zero_points[b];
+
+                for (size_t M = 16; M < 160; M += 32) {
+                    for (size_t N = 16; N < 160; N += 32) {
+
+                        static const size_t ks[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 20, 32, 48, 64, 118, 119, 120, 121, 122, 160, 240, 320 };
+                        for (size_t k = 0; k < _countof(ks); k++) {
+                            size_t K = ks[k];
+
+                            Test(M, N, K, offa, offb);
+                            Test(M + 1, N, K, offa, offb);
+                            Test(M, N + 1, K, offa, offb);
+                            Test(M + 1, N + 1, K, offa, offb);
+                            Test(M + 3, N + 2, K, offa, offb);
+                            Test(M + 4, N, K, offa, offb);
+                            Test(M, N + 4, K, offa, offb);
+                            Test(M + 4, N + 4, K, offa, offb);
+                            Test(M + 3, N + 7, K, offa, offb);
+                            Test(M + 8, N, K, offa, offb);
+                            Test(M, N + 8, K, offa, offb);
+                            Test(M + 12, N + 12, K, offa, offb);
+                            Test(M + 13, N, K, offa, offb);
+                            Test(M, N + 15, K, offa, offb);
+                            Test(M + 15, N + 15, K, offa, offb);
+                        }
+                    }
+                    printf("a %zd/%zd b %zd/%zd M %zd\n", a, _countof(zero_points), b, _countof(zero_points), M);
+                }
+            }
+        }
+
+        for (size_t M = 1; M < 160; M++) {
+            for (size_t N = 1; N < 160; N++) {
+                for (size_t K = 1; K < 160; K++) {
+                    Test(M, N, K, 18, 24);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+
+        for (size_t M = 160; M < 320; M += 24) {
+            for (size_t N = 112; N < 320; N += 24) {
+                for (size_t K = 1; K < 16; K++) {
+                    Test(M, N, K, 1, 3);
+                }
+                for (size_t K = 16; K < 160; K += 32) {
+                    Test(M, N, K, 5, 7);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+    }
+};
+
+template <typename xint8_t>
+class MlasQgemmU8X8OutputStageTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        bool UseOutputStage,
+        bool SupplyC = true
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M);
+        const xint8_t* B = BufferB.GetBuffer(N * K);
+        xint8_t* offb = BufferZeroPointB.GetBuffer(N);
+        float* Scale = BufferScale.GetBuffer(N);
+        float* Bias = BufferBias.GetBuffer(N);
+        int32_t* C = BufferC.GetBuffer(N * M);
+        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+        float* Output = BufferOutput.GetBuffer(N * M);
+
+        for (size_t n = 0; n < N; n++) {
+            offb[n] = xint8_t(n * 37 + 5);
+            Scale[n] = 0.25f + float(n % 7) * 0.125f;
+            Bias[n] = float(int(n % 11) - 5);
+        }
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
+
+        MLAS_QGEMM_OUTPUT_STAGE OutputStage;
+        OutputStage.Scale = Scale;
+        OutputStage.PerColumnScale = true;
+        OutputStage.Bias = Bias;
+        OutputStage.Activation = &Activation;
+        OutputStage.Output = Output;
+        OutputStage.ldOutput = N;
+        OutputStage.RowBias = nullptr;
+        OutputStage.QuantizedOutput = nullptr;
+        OutputStage.QuantizedZeroPoint = 0;
+
+        std::fill_n(C, M * N, -1);
+        std::fill_n(Output, M * N, -1.0f);
+
+        MlasGemm(M, N, K, A, K, offa, B, N, offb, SupplyC ? C : nullptr, N,
+            UseOutputStage ? &OutputStage : nullptr, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                int32_t sum = 0;
+                for (size_t k = 0; k < K; k++) {
+                    sum += (int32_t(B[k * N + n]) - int32_t(offb[n])) * (int32_t(A[m * K + k]) - int32_t(offa));
+                }
+                CReference[m * N + n] = sum;
+            }
+        }
+
+        for (size_t f = 0; f < M * N; f++) {
+            size_t n = f % N;
+            if (SupplyC && C[f] != CReference[f]) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d!\n", M, N, K, offa);
+                break;
+            }
+            if (UseOutputStage) {
+                float Value = std::max(float(CReference[f]) * Scale[n] + Bias[n], 0.0f);
+                if (Output[f] != Value) {
+                    printf("mismatch output M=%zd, N=%zd, K=%zd, offa=%d %f %f!\n", M, N, K, offa, Output[f], Value);
+                    break;
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<uint8_t> BufferA;
+    MatrixGuardBuffer<xint8_t> BufferB;
+    MatrixGuardBuffer<xint8_t> BufferZeroPointB;
+    MatrixGuardBuffer<float> BufferScale;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<int32_t> BufferC;
+    MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<float> BufferOutput;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 14, false);
+            Test(b, b, b, 14, true);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 34, true);
+        }
+        for (size_t b = 1; b < 96; b += 7) {
+            Test(1, b, 32, 0, true);
+            Test(b, 300, 17, 211, true);
+            Test(b, 300, 17, 211, true, false);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 34, true, false);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 160; M += 3) {
+            for (size_t N = 1; N < 160; N += 5) {
+                for (size_t K = 1; K < 160; K += 7) {
+                    Test(M, N, K, 18, true);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+    }
+};
+
+template <typename xint8_t>
+class MlasQgemmU8X8QuantizedOutputTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        xint8_t offb,
+        uint8_t offc
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M);
+        const xint8_t* B = BufferB.GetBuffer(N * K);
+        int32_t* RowBias = BufferRowBias.GetBuffer(M);
+        uint8_t* Output = BufferOutput.GetBuffer(N * M);
+        uint8_t* OutputReference = BufferOutputReference.GetBuffer(N * M);
+
+        for (size_t m = 0; m < M; m++) {
+            RowBias[m] = int32_t(m * 53 % 301) - 150;
+        }
+
+        const float Scale = 1.0f / float(K * 32 + 7);
+
+        MLAS_QGEMM_OUTPUT_STAGE OutputStage;
+        OutputStage.Scale = &Scale;
+        OutputStage.PerColumnScale = false;
+        OutputStage.Bias = nullptr;
+        OutputStage.Activation = nullptr;
+        OutputStage.Output = nullptr;
+        OutputStage.ldOutput = N;
+        OutputStage.RowBias = RowBias;
+        OutputStage.QuantizedOutput = Output;
+        OutputStage.QuantizedZeroPoint = offc;
+
+        MlasGemm(M, N, K, A, K, offa, B, N, offb, nullptr, 0, &OutputStage, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                int32_t sum = 0;
+                for (size_t k = 0; k < K; k++) {
+                    sum += (int32_t(B[k * N + n]) - int32_t(offb)) * (int32_t(A[m * K + k]) - int32_t(offa));
+                }
+                float Value = std::nearbyint(float(sum + RowBias[m]) * Scale) + float(offc);
+                Value = std::min(std::max(Value, 0.0f), 255.0f);
+                OutputReference[m * N + n] = uint8_t(Value);
+            }
+        }
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (Output[f] != OutputReference[f]) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d, offc=%d!\n", M, N, K, offa, int(offb), offc);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<uint8_t> BufferA;
+    MatrixGuardBuffer<xint8_t> BufferB;
+    MatrixGuardBuffer<int32_t> BufferRowBias;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+    MatrixGuardBuffer<uint8_t> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 14, 21, 128);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 34, 1, 0);
+        }
+        for (size_t b = 1; b < 96; b += 7) {
+            Test(1, b, 32, 0, 0, 17);
+            Test(b, 300, 17, 211, 3, 240);
+            Test(97, b + 257, b, 5, 9, 100);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 160; M += 3) {
+            for (size_t N = 1; N < 320; N += 13) {
+                for (size_t K = 1; K < 160; K += 7) {
+                    Test(M, N, K, 18, 24, 127);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+    }
+};
+
+#endif
+
+class MlasConv2DTest : public MlasTestBase
+{
+protected:
+    void
+    Test(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        size_t OutputHeight = size_t(OutputHeight64);
+        size_t OutputWidth = size_t(OutputWidth64);
+
+        size_t InputSize = InputHeight * InputWidth;
+        size_t KernelSize = KernelHeight * KernelWidth;
+        size_t OutputSize = OutputHeight * OutputWidth;
+
+        size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+        size_t FilterElements = GroupCount * FilterCount * InputChannels * KernelSize;
+        size_t BiasElements = GroupCount * FilterCount;
+        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+        const float* Input = BufferInput.GetBuffer(InputElements);
+        const float* Filter = BufferFilter.GetBuffer(FilterElements);
+        const float* Bias = BufferBias.GetBuffer(BiasElements);
+        float* Output = BufferOutput.GetBuffer(OutputElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        MlasConv2D(BatchCount,
+                   GroupCount,
+                   InputChannels,
+                   InputHeight, InputWidth,
+                   FilterCount,
+                   KernelHeight, KernelWidth,
+                   PaddingLeftHeight, PaddingLeftWidth,
+                   PaddingRightHeight, PaddingRightWidth,
+                   DilationHeight, DilationWidth,
+                   StrideHeight, StrideWidth,
+                   OutputHeight, OutputWidth,
+                   Input,
+                   Filter,
+                   Bias,
+                   Output);
+
+        ReferenceConv2D(BatchCount,
+                        GroupCount,
+                        InputChannels,
+                        InputHeight, InputWidth,
+                        FilterCount,
+                        KernelHeight, KernelWidth,
+                        PaddingLeftHeight, PaddingLeftWidth,
+                        DilationHeight, DilationWidth,
+                        StrideHeight, StrideWidth,
+                        OutputHeight, OutputWidth,
+                        Input,
+                        Filter,
+                        Bias,
+                        OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+            printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+                KernelHeight, KernelWidth);
+        }
+
+        //
+        // Accumulate the convolution into an existing output tensor as done
+        // for a fused residual sum.
+        //
+
+        if (SupportsBeta()) {
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                Output[i] = float(int(i % 17) - 8);
+                OutputReference[i] += Output[i];
+            }
+
+            Beta = 1.0f;
+
+            MlasConv2D(BatchCount,
+                       GroupCount,
+                       InputChannels,
+                       InputHeight, InputWidth,
+                       FilterCount,
+                       KernelHeight, KernelWidth,
+                       PaddingLeftHeight, PaddingLeftWidth,
+                       PaddingRightHeight, PaddingRightWidth,
+                       DilationHeight, DilationWidth,
+                       StrideHeight, StrideWidth,
+                       OutputHeight, OutputWidth,
+                       Input,
+                       Filter,
+                       Bias,
+                       Output);
+
+            Beta = 0.0f;
+
+            if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+                printf("mismatch beta: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+                    BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+                    KernelHeight, KernelWidth);
+            }
+        }
+    }
+
+    virtual
+    bool
+    SupportsBeta(
+        void
+        )
+    {
+        return true;
+    }
+
+    virtual
+    void
+    MlasConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        )
+    {
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MLAS_CONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+
+        MlasConvPrepare(&Parameters,
+                        2,
+                        BatchCount,
+                        GroupCount,
+                        InputChannels,
+                        InputShape,
+                        KernelShape,
+                        DilationShape,
+                        Padding,
+                        StrideShape,
+                        OutputShape,
+                        FilterCount,
+                        &Activation,
+                        &WorkingBufferSize,
+                        Beta,
+                        nullptr);
+
+        MlasConv(&Parameters,
+                 Input,
+                 Filter,
+                 Bias,
+                 BufferWorking.GetBuffer(WorkingBufferSize),
+                 Output,
+                 nullptr);
+    }
+
+    void
+    ReferenceConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        )
+    {
+        size_t InputSize = InputHeight * InputWidth;
+        size_t OutputSize = OutputHeight * OutputWidth;
+        size_t KernelSize = KernelHeight * KernelWidth;
+
+        size_t K = InputChannels * KernelSize;
+        size_t Im2ColElements = OutputSize * K;
+
+        for (size_t b = 0; b < BatchCount; b++) {
+
+            const float* filter = Filter;
+            const float* bias = Bias;
+
+            for (size_t g = 0; g < GroupCount; g++) {
+
+                //
+                // Transform the image using IM2COL and invoke the GEMM.
+                //
+
+                float* Im2Col = BufferIm2Col.GetBuffer(Im2ColElements);
+                float* Im2ColOut = Im2Col;
+
+                for (size_t c = 0; c < InputChannels; c++) {
+
+                    for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+                        for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                            for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+                                size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingLeftHeight;
+
+                                for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+                                    size_t iw = ow * StrideWidth + kx * DilationWidth - PaddingLeftWidth;
+
+                                    *Im2ColOut++ = (ih < InputHeight && iw < InputWidth) ?
+                                        Input[ih * InputWidth + iw] : 0;
+                                }
+                            }
+                        }
+                    }
+
+                    Input += InputSize;
+                }
+
+                MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
+                    filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, threadpool);
+
+                //
+                // Apply the bias.
+                //
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    float biasValue = *bias++;
+
+                    for (size_t o = 0; o < OutputSize; o++) {
+                        *Output++ += biasValue;
+                    }
+                }
+
+                filter += FilterCount * InputChannels * KernelSize;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferFilter;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferWorking;
+    MatrixGuardBuffer<float> BufferIm2Col;
+    float Beta = 0.0f;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 256; i <<= 1) {
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
+            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        //
+        // Depthwise convolutions.
+        //
+
+        for (unsigned i = 1; i <= 20; i++) {
+            Test(1, 16, 1, i, i + 1, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i + 1, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+            Test(1, 16, 1, i + 1, i, 1, 3, 3, 0, 0, 1, 1, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i, 1, 3, 3, 2, 2, 2, 2, 2, 2, 1, 1);
+            Test(1, 32, 1, i, i, 1, 3, 5, 1, 2, 0, 1, 1, 1, 3, 1);
+            Test(2, 16, 1, i, i, 1, 7, 7, 3, 3, 3, 3, 1, 1, 1, 1);
+        }
+
+        Test(1, 32, 1, 112, 112, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        Test(1, 96, 1, 112, 112, 1, 3, 3, 0, 0, 1, 1, 1, 1, 2, 2);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned cs[] = { 32, 14, 1 };
+        static const unsigned is[] = { 53, 11, 5, 1 };
+
+        for (unsigned i = 1; i <= 32; i++) {
+            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned b = 1; b < 64; b++) {
+            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned ic = 0; ic < _countof(cs); ic++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", cs[ic], is[ih], is[iw]);
+                    for (unsigned fc = 0; fc < _countof(cs); fc++) {
+                        for (unsigned kh = 1; kh <= 5; kh++) {
+                            if (kh == 4) continue;
+                            for (unsigned kw = 1; kw <= 5; kw++) {
+                                if (kw == 4) continue;
+                                for (unsigned p0 = 0; p0 < 2; p0++) {
+                                    for (unsigned p1 = 0; p1 < 2; p1++) {
+                                        for (unsigned p2 = 0; p2 < 2; p2++) {
+                                            for (unsigned p3 = 0; p3 < 2; p3++) {
+                                                for (unsigned dh = 1; dh <= 2; dh++) {
+                                                    for (unsigned dw = 1; dw <= 2; dw++) {
+                                                        for (unsigned sh = 1; sh <= 2; sh++) {
+                                                            for (unsigned sw = 1; sw <= 2; sw++) {
+                                                                Test(1, 1, cs[ic], is[ih], is[iw], cs[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasNchwcConv2DTest : public MlasConv2DTest
+{
+protected:
+    bool
+    SupportsBeta(
+        void
+        ) override
+    {
+        return false;
+    }
+
+    void
+    MlasConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        ) override
+    {
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(GroupCount * InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t FilterShape[] = { int64_t(GroupCount * FilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(GroupCount * FilterCount), int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+
+        //
+        // Select the type of convolution that will be performed.
+        //
+
+        bool DoReorderInput;
+        bool ReorderFilterOIHWBo;
+
+        if (GroupCount > 1 && InputChannels == 1 && FilterCount == 1) {
+            // Depthwise convolution.
+            DoReorderInput = true;
+            ReorderFilterOIHWBo = true;
+        } else if (InputChannels >= BlockSize) {
+            // NCHWc or pointwise convolution;
+            DoReorderInput = true;
+            ReorderFilterOIHWBo = false;
+        } else {
+            // NCHW convolution.
+            DoReorderInput = false;
+            ReorderFilterOIHWBo = true;
+        }
+
+        size_t NchwcInputChannels = (GroupCount * InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+        size_t NchwcOutputChannels = (GroupCount * FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+        //
+        // Reorder the filter buffer as needed.
+        //
+
+        float* ReorderedFilter;
+
+        if (ReorderFilterOIHWBo) {
+            size_t NchwcFilterElements = NchwcOutputChannels * InputChannels * KernelHeight * KernelWidth;
+            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
+            MlasReorderFilterOIHWBo(FilterShape, Filter, ReorderedFilter);
+        } else {
+            size_t NchwcFilterElements = NchwcOutputChannels * NchwcInputChannels * KernelHeight * KernelWidth;
+            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
+            MlasReorderFilterOIHWBiBo(FilterShape, Filter, ReorderedFilter);
+        }
+
+        //
+        // Align the bias buffer to the filter count if needed.
+        //
+
+        if (Bias != nullptr && GroupCount * FilterCount < NchwcOutputChannels) {
+
+            float* AlignedBias = BufferNchwcBias.GetBuffer(NchwcOutputChannels);
+
+            size_t i;
+            for (i = 0; i < GroupCount * FilterCount; i++) {
+                AlignedBias[i] = Bias[i];
+            }
+            for (; i < NchwcOutputChannels; i++) {
+                AlignedBias[i] = 0.0f;
+            }
+
+            Bias = AlignedBias;
+        }
+
+        //
+        // Reorder the input buffer if needed.
+        //
+
+        if (DoReorderInput) {
+            size_t NchwcInputElements = BatchCount * NchwcInputChannels * InputHeight * InputWidth;
+            float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+            MlasReorderInput(InputShape, Input, NchwcInput);
+            Input = NchwcInput;
+            InputShape[1] = NchwcInputChannels;
+        }
+
+        int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcOutputChannels), int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        size_t NchwcOutputElements = BatchCount * NchwcOutputChannels * OutputHeight * OutputWidth;
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MlasNchwcConv(2,
+                      InputShape,
+                      KernelShape,
+                      DilationShape,
+                      Padding,
+                      StrideShape,
+                      NchwcOutputShape,
+                      GroupCount,
+                      Input,
+                      ReorderedFilter,
+                      Bias,
+                      NchwcOutput,
+                      &Activation,
+                      true,
+                      nullptr);
+
+        //
+        // Reorder the output buffer.
+        //
+
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    }
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcFilter;
+    MatrixGuardBuffer<float> BufferNchwcBias;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+public:
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        // N.B. InputChannels must be a multiple of 4 if the count is greater
+        // than the block size.
+        static const unsigned cis[] = { 32, 20, 5, 1 };
+        static const unsigned cos[] = { 64, 15, 1 };
+        static const unsigned is[] = { 27, 11, 5, 1 };
+
+        // Depthwise convolutions.
+        for (unsigned i = 16; i < 256; i <<= 1) {
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(12, i, 1, 11, 11, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        // Test varying FilterCounts.
+        for (unsigned i = 1; i < 128; i++) {
+            Test(1, 1, 3, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, 34, 34, i, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned i = 1; i <= 32; i++) {
+            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned b = 1; b < 64; b++) {
+            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned ic = 0; ic < _countof(cis); ic++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", cis[ic], is[ih], is[iw]);
+                    for (unsigned fc = 0; fc < _countof(cos); fc++) {
+                        for (unsigned kh = 1; kh <= 5; kh++) {
+                            if (kh == 4) continue;
+                            for (unsigned kw = 1; kw <= 5; kw++) {
+                                if (kw == 4) continue;
+                                for (unsigned p0 = 0; p0 <= 3; p0++) {
+                                    for (unsigned p1 = 0; p1 <= 3; p1++) {
+                                        for (unsigned p2 = 0; p2 <= 3; p2++) {
+                                            for (unsigned p3 = 0; p3 <= 3; p3++) {
+                                                for (unsigned dh = 1; dh <= 2; dh++) {
+                                                    for (unsigned dw = 1; dw <= 2; dw++) {
+                                                        for (unsigned sh = 1; sh <= 2; sh++) {
+                                                            for (unsigned sw = 1; sw <= 2; sw++) {
+                                                                Test(1, 1, cis[ic], is[ih], is[iw], cos[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+};
+
+class MlasWinogradConv2DTest : public MlasConv2DTest
+{
+protected:
+    void
+    MlasConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        ) override
+    {
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MLAS_CONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+
+        MlasConvPrepare(&Parameters,
+                        2,
+                        BatchCount,
+                        GroupCount,
+                        InputChannels,
+                        InputShape,
+                        KernelShape,
+                        DilationShape,
+                        Padding,
+                        StrideShape,
+                        OutputShape,
+                        FilterCount,
+                        &Activation,
+                        &WorkingBufferSize,
+                        Beta,
+                        threadpool);
+
+        if (!MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, threadpool)) {
+            printf("Winograd convolution not supported: input(%zd,%zd,%zd),filter=%zd\n",
+                InputChannels, InputHeight, InputWidth, FilterCount);
+            return;
+        }
+
+        float* PackedFilter = BufferPackedFilter.GetBuffer(
+            MlasConvWinogradPackFilterSize(GroupCount, InputChannels, FilterCount));
+
+        MlasConvWinogradPackFilter(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+
+        MlasConvWinograd(&Parameters,
+                         Input,
+                         PackedFilter,
+                         Bias,
+                         BufferWorking.GetBuffer(WorkingBufferSize),
+                         Output,
+                         threadpool);
+    }
+
+    MatrixGuardBuffer<float> BufferPackedFilter;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        //
+        // The fill values are small integers, so the transformed products are
+        // exact and the results match the reference convolution.
+        //
+
+        for (unsigned i = 1; i <= 17; i++) {
+            Test(1, 1, 16, i, i, 16, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i + 3, 24, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(2, 2, 16, i + 2, i, 16, 3, 3, 2, 0, 1, 2, 1, 1, 1, 1);
+        }
+
+        Test(1, 1, 32, 56, 56, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        Test(3, 1, 24, 14, 14, 40, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        Test(1, 1, 16, 210, 5, 16, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+class MlasPool2DTest : public MlasTestBase
+{
+protected:
+    void
+    Test(
+        size_t BatchCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        const size_t DilationHeight = 1;
+        const size_t DilationWidth = 1;
+
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputHeight64, OutputWidth64 };
+
+        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
+        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+
+        const float* Input = BufferInput.GetBuffer(InputBufferElements);
+        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+        MlasPool2D(MlasMaximumPooling, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool2D(MlasAveragePoolingExcludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool2D(MlasAveragePoolingIncludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+    }
+
+    virtual
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+    }
+
+    void
+    ReferenceMaximumPool2D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputHeight = InputShape[2];
+        int64_t InputWidth = InputShape[3];
+
+        int64_t KernelHeight = KernelShape[0];
+        int64_t KernelWidth = KernelShape[1];
+
+        int64_t PaddingLeftY = Padding[0];
+        int64_t PaddingLeftX = Padding[1];
+        int64_t PaddingRightY = Padding[2];
+        int64_t PaddingRightX = Padding[3];
+
+        int64_t StrideHeight = StrideShape[0];
+        int64_t StrideWidth = StrideShape[1];
+
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                int64_t ihEnd = ihStart + KernelHeight;
+
+                ihStart = (std::max)(ihStart, int64_t(0));
+                ihEnd = (std::min)(ihEnd, InputHeight);
+
+                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                    int64_t iwEnd = iwStart + KernelWidth;
+
+                    iwStart = (std::max)(iwStart, int64_t(0));
+                    iwEnd = (std::min)(iwEnd, InputWidth);
+
+                    float m = std::numeric_limits<float>::lowest();
+
+                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                            m = (std::max)(m, Input[ih * InputWidth + iw]);
+                        }
+                    }
+
+                    Output[ph * OutputWidth + pw] = m;
+                }
+            }
+
+            Input += InputHeight * InputWidth;
+            Output += OutputHeight * OutputWidth;
+        }
+    }
+
+    void
+    ReferenceAveragePool2D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output,
+        bool CountIncludePad
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputHeight = InputShape[2];
+        int64_t InputWidth = InputShape[3];
+
+        int64_t KernelHeight = KernelShape[0];
+        int64_t KernelWidth = KernelShape[1];
+
+        int64_t PaddingLeftY = Padding[0];
+        int64_t PaddingLeftX = Padding[1];
+        int64_t PaddingRightY = Padding[2];
+        int64_t PaddingRightX = Padding[3];
+
+        int64_t StrideHeight = StrideShape[0];
+        int64_t StrideWidth = StrideShape[1];
+
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                int64_t ihEnd = ihStart + KernelHeight;
+
+                ihStart = (std::max)(ihStart, int64_t(0));
+                ihEnd = (std::min)(ihEnd, InputHeight);
+
+                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                    int64_t iwEnd = iwStart + KernelWidth;
+
+                    iwStart = (std::max)(iwStart, int64_t(0));
+                    iwEnd = (std::min)(iwEnd, InputWidth);
+
+                    float m = 0.0f;
+
+                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                            m += Input[ih * InputWidth + iw];
+                        }
+                    }
+
+                    if (CountIncludePad) {
+                        m /= (KernelHeight * KernelWidth);
+                    } else {
+                        m /= (ihEnd - ihStart) * (iwEnd - iwStart);
+                    }
+
+                    Output[ph * OutputWidth + pw] = m;
+                }
+            }
+
+            Input += InputHeight * InputWidth;
+            Output += OutputHeight * OutputWidth;
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 256; i <<= 1) {
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 2, 2);
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 3, 3, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, i, i, 1, 1, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, i, 1, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 1, i, 0, 0, 0, 0, 1, 1);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 53, 17, 11, 5, 4, 3, 2, 1 };
+
+        for (unsigned i = 1; i < 2058; i++) {
+            Test(1, 1, 4, i, 2, 4, 0, 2, 0, 1, 1, 1);
+        }
+
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
+                Test(1, 1, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
+                Test(1, 1, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
+                Test(1, 1, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
+                for (unsigned kh = 1; kh <= 5; kh++) {
+                    if (kh > is[ih]) break;
+                    for (unsigned kw = 1; kw <= 5; kw++) {
+                        if (kw > is[iw]) break;
+                        for (unsigned sh = 1; sh <= 3; sh++) {
+                            for (unsigned sw = 1; sw <= 3; sw++) {
+                                for (unsigned p0 = 0; p0 < kh; p0++) {
+                                    for (unsigned p1 = 0; p1 < kw; p1++) {
+                                        for (unsigned p2 = 0; p2 < kh; p2++) {
+                                            for (unsigned p3 = 0; p3 < kw; p3++) {
+                                                Test(5, 3, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasNchwcPool2DTest : public MlasPool2DTest
+{
+protected:
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        ) override
+    {
+        size_t NchwcChannels = (size_t(InputShape[1]) + BlockSize - 1) & ~(BlockSize - 1);
+
+        int64_t NchwcInputShape[] = { InputShape[0], int64_t(NchwcChannels), InputShape[2], InputShape[3] };
+        size_t NchwcInputElements = size_t(NchwcInputShape[0]) * size_t(NchwcInputShape[1]) * size_t(NchwcInputShape[2]) * size_t(NchwcInputShape[3]);
+        float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+
+        int64_t NchwcOutputShape[] = { OutputShape[0], int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
+        size_t NchwcOutputElements = size_t(NchwcOutputShape[0]) * size_t(NchwcOutputShape[1]) * size_t(NchwcOutputShape[2]) * size_t(NchwcOutputShape[3]);
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+        MlasReorderInput(InputShape, Input, NchwcInput);
+
+        MlasNchwcPool(PoolingKind,
+                      2,
+                      NchwcInputShape,
+                      KernelShape,
+                      nullptr,
+                      Padding,
+                      StrideShape,
+                      NchwcOutputShape,
+                      NchwcInput,
+                      NchwcOutput,
+                      nullptr);
+
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    }
+
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+public:
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 53, 11, 1 };
+
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
+                Test(1, 12, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
+                Test(1, 32, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
+                Test(1, 68, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
+                for (unsigned kh = 1; kh <= 5; kh++) {
+                    if (kh > is[ih]) break;
+                    for (unsigned kw = 1; kw <= 5; kw++) {
+                        if (kw > is[iw]) break;
+                        for (unsigned sh = 1; sh <= 3; sh++) {
+                            for (unsigned sw = 1; sw <= 3; sw++) {
+                                for (unsigned p0 = 0; p0 < kh; p0++) {
+                                    for (unsigned p1 = 0; p1 < kw; p1++) {
+                                        for (unsigned p2 = 0; p2 < kh; p2++) {
+                                            for (unsigned p3 = 0; p3 < kw; p3++) {
+                                                Test(1, 32, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+};
+
+class MlasPool3DTest : public MlasTestBase
+{
+protected:
+    void
+    Test(
+        size_t BatchCount,
+        size_t InputChannels,
+        size_t InputDepth,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelDepth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftDepth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightDepth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t StrideDepth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        const size_t DilationDepth = 1;
+        const size_t DilationHeight = 1;
+        const size_t DilationWidth = 1;
+
+        int64_t OutputDepth64 =
+            ((int64_t(InputDepth) + int64_t(PaddingLeftDepth) + int64_t(PaddingRightDepth)) -
+            (int64_t(DilationDepth) * (int64_t(KernelDepth) - 1) + 1)) / int64_t(StrideDepth) + 1;
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputDepth64 <= 0 || OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputDepth), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelDepth), int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftDepth), int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightDepth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideDepth), int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputDepth64, OutputHeight64, OutputWidth64 };
+
+        OutputShape[2] = (InputShape[2] + Padding[0] + Padding[3] - KernelShape[0]) / StrideShape[0] + 1;
+        OutputShape[3] = (InputShape[3] + Padding[1] + Padding[4] - KernelShape[1]) / StrideShape[1] + 1;
+        OutputShape[4] = (InputShape[4] + Padding[2] + Padding[5] - KernelShape[2]) / StrideShape[2] + 1;
+
+        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3] * InputShape[4]);
+        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3] * OutputShape[4]);
+
+        const float* Input = BufferInput.GetBuffer(InputBufferElements);
+        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+        MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: maximum input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageexcpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageincpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+    }
+
+    void
+    ReferenceMaximumPool3D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputDepth = InputShape[2];
+        int64_t InputHeight = InputShape[3];
+        int64_t InputWidth = InputShape[4];
+
+        int64_t KernelDepth = KernelShape[0];
+        int64_t KernelHeight = KernelShape[1];
+        int64_t KernelWidth = KernelShape[2];
+
+        int64_t PaddingLeftZ = Padding[0];
+        int64_t PaddingLeftY = Padding[1];
+        int64_t PaddingLeftX = Padding[2];
+        int64_t PaddingRightZ = Padding[3];
+        int64_t PaddingRightY = Padding[4];
+        int64_t PaddingRightX = Padding[5];
+
+        int64_t StrideDepth = StrideShape[0];
+        int64_t StrideHeight = StrideShape[1];
+        int64_t StrideWidth = StrideShape[2];
+
+        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+
+                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
+                int64_t idEnd = idStart + KernelDepth;
+
+                idStart = (std::max)(idStart, int64_t(0));
+                idEnd = (std::min)(idEnd, InputDepth);
+
+                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                    int64_t ihEnd = ihStart + KernelHeight;
+
+                    ihStart = (std::max)(ihStart, int64_t(0));
+                    ihEnd = (std::min)(ihEnd, InputHeight);
+
+                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                        int64_t iwEnd = iwStart + KernelWidth;
+
+                        iwStart = (std::max)(iwStart, int64_t(0));
+                        iwEnd = (std::min)(iwEnd, InputWidth);
+
+                        float m = std::numeric_limits<float>::lowest();
+
+                        for (int64_t id = idStart; id < idEnd; id++) {
+                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                                    m = (std::max)(m, Input[id * InputHeight * InputWidth + ih * InputWidth + iw]);
+                                }
+                            }
+                        }
+
+                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
+                    }
+                }
+            }
+
+            Input += InputDepth * InputHeight * InputWidth;
+            Output += OutputDepth * OutputHeight * OutputWidth;
+        }
+    }
+
+    void
+    ReferenceAveragePool3D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output,
+        bool CountIncludePad
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputDepth = InputShape[2];
+        int64_t InputHeight = InputShape[3];
+        int64_t InputWidth = InputShape[4];
+
+        int64_t KernelDepth = KernelShape[0];
+        int64_t KernelHeight = KernelShape[1];
+        int64_t KernelWidth = KernelShape[2];
+
+        int64_t PaddingLeftZ = Padding[0];
+        int64_t PaddingLeftY = Padding[1];
+        int64_t PaddingLeftX = Padding[2];
+        int64_t PaddingRightZ = Padding[3];
+        int64_t PaddingRightY = Padding[4];
+        int64_t PaddingRightX = Padding[5];
+
+        int64_t StrideDepth = StrideShape[0];
+        int64_t StrideHeight = StrideShape[1];
+        int64_t StrideWidth = StrideShape[2];
+
+        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+
+                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
+                int64_t idEnd = idStart + KernelDepth;
+
+                idStart = (std::max)(idStart, int64_t(0));
+                idEnd = (std::min)(idEnd, InputDepth);
+
+                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                    int64_t ihEnd = ihStart + KernelHeight;
+
+                    ihStart = (std::max)(ihStart, int64_t(0));
+                    ihEnd = (std::min)(ihEnd, InputHeight);
+
+                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                        int64_t iwEnd = iwStart + KernelWidth;
+
+                        iwStart = (std::max)(iwStart, int64_t(0));
+                        iwEnd = (std::min)(iwEnd, InputWidth);
+
+                        float m = 0.0f;
+
+                        for (int64_t id = idStart; id < idEnd; id++) {
+                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                                    m += Input[id * InputHeight * InputWidth + ih * InputWidth + iw];
+                                }
+                            }
+                        }
+
+                        if (CountIncludePad) {
+                            m /= (KernelDepth * KernelHeight * KernelWidth);
+                        } else {
+                            m /= (idEnd - idStart) * (ihEnd - ihStart) * (iwEnd - iwStart);
+                        }
+
+                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
+                    }
+                }
+            }
+
+            Input += InputDepth * InputHeight * InputWidth;
+            Output += OutputDepth * OutputHeight * OutputWidth;
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 64; i <<= 1) {
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 2, 2, 2);
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, i, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, 1, i, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 11, 5, 4, 3, 2, 1 };
+
+        for (unsigned id = 0; id < _countof(is); id++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", is[id], is[ih], is[iw]);
+                    Test(1, 1, is[id], is[ih], is[iw], is[id], is[ih], is[iw], 0, 0, 0, 0, 0, 0, 1, 1, 1);
+                    for (unsigned kd = 1; kd <= 4; kd++) {
+                        if (kd > is[id]) break;
+                        for (unsigned kh = 1; kh <= 4; kh++) {
+                            if (kh > is[ih]) break;
+                            for (unsigned kw = 1; kw <= 4; kw++) {
+                                if (kw > is[iw]) break;
+                                for (unsigned sd = 1; sd <= 3; sd++) {
+                                    for (unsigned sh = 1; sh <= 3; sh++) {
+                                        for (unsigned sw = 1; sw <= 3; sw++) {
+                                            for (unsigned p0 = 0; p0 < kd; p0++) {
+                                                for (unsigned p1 = 0; p1 < kh; p1++) {
+                                                    for (unsigned p2 = 0; p2 < kw; p2++) {
+                                                        for (unsigned p3 = 0; p3 < kd; p3++) {
+                                                            for (unsigned p4 = 0; p4 < kh; p4++) {
+                                                                for (unsigned p5 = 0; p5 < kw; p5++) {
+                                                                    Test(1, 1, is[id], is[ih], is[iw], kd, kh, kw, p0, p1, p2, p3, p4, p5, sd, sh, sw);
+                                                                }
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasActivationTest : public MlasTestBase
+{
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        union AliasedValue {
+            unsigned u;
+            float f;
+        };
+
+        // N.B. The test data includes values at the edge of Tanh/Logistic boundaries.
+        //    Identity,     Relu,         LeakyRelu,    Tanh,         Logistic,     Clip,
+        static const AliasedValue TestData[20][6] = {
+            { {0x00000001}, {0x00000001}, {0x00000001}, {0x00000000}, {0x3f000000}, {0x00000001}, }, // positive denormal
+            { {0x80000001}, {0x00000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x00000000}, }, // negative denormal
+            { {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, }, // positive NaN
+            { {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, }, // negative NaN
+            { {0x00000000}, {0x00000000}, {0x00000000}, {0x00000000}, {0x3f000000}, {0x00000000}, }, // 0.0f
+            { {0x80000000}, {0x80000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x80000000}, }, // -0.0f
+            { {0x3e800000}, {0x3e800000}, {0x3e800000}, {0x3e7acbf5}, {0x3f0feacc}, {0x3e800000}, }, // 0.25f
+            { {0xbe800000}, {0x00000000}, {0xbd4ccccd}, {0xbe7acbf5}, {0x3ee02a67}, {0x00000000}, }, // -0.25f
+            { {0x40800000}, {0x40800000}, {0x40800000}, {0x3f7fd40a}, {0x3f7b6541}, {0x40800000}, }, // 4.0f
+            { {0xc0800000}, {0x00000000}, {0xbf4ccccd}, {0xbf7fd40a}, {0x3c9357e0}, {0x00000000}, }, // -4.0f
+            { {0x41200000}, {0x41200000}, {0x41200000}, {0x3f800000}, {0x3f7ffd06}, {0x40c00000}, }, // 10.0f
+            { {0xc1200000}, {0x00000000}, {0xc0000000}, {0xbf800000}, {0x383e6000}, {0x00000000}, }, // -10.0f
+            { {0xc18866eb}, {0x00000000}, {0xc05a3e45}, {0xbf800000}, {0x33000000}, {0x00000000}, }, // -17.0502529144f
+            { {0xc18869bb}, {0x00000000}, {0xc05a42c5}, {0xbf800000}, {0x33c00000}, {0x00000000}, }, // -17.0516262054f
+            { {0xc18852a8}, {0x00000000}, {0xc05a1dda}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0403594971f
+            { {0xc18844aa}, {0x00000000}, {0xc05a0777}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0335273743f
+            { {0x418866eb}, {0x418866eb}, {0x418866eb}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0502529144f
+            { {0x418869bb}, {0x418869bb}, {0x418869bb}, {0x3f800000}, {0x3f7ffffe}, {0x40c00000}, }, // +17.0516262054f
+            { {0x418852a8}, {0x418852a8}, {0x418852a8}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0403594971f
+            { {0x418844aa}, {0x418844aa}, {0x418844aa}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0335273743f
+        };
 
-        size_t K = InputChannels * KernelSize;
-        size_t Im2ColElements = OutputSize * K;
+        MLAS_ACTIVATION Activation;
+        AliasedValue Buffer[_countof(TestData)];
 
-        for (size_t b = 0; b < BatchCount; b++) {
+        for (unsigned kind = 0; kind < unsigned(MlasClipActivation); kind++) {
 
-            const float* filter = Filter;
-            const float* bias = Bias;
+            Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
 
-            for (size_t g = 0; g < GroupCount; g++) {
+            if (Activation.ActivationKind == MlasLeakyReluActivation) {
+                Activation.Parameters.LeakyRelu.alpha = 0.2f;
+            } else if (Activation.ActivationKind == MlasClipActivation) {
+                Activation.Parameters.Clip.minimum = 0.0f;
+                Activation.Parameters.Clip.maximum = 6.0f;
+            }
 
-                //
-                // Transform the image using IM2COL and invoke the GEMM.
-                //
+            //
+            // Test the vectorized activations.
+            //
 
-                float* Im2Col = BufferIm2Col.GetBuffer(Im2ColElements);
-                float* Im2ColOut = Im2Col;
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                Buffer[i].u = TestData[i][0].u;
+            }
 
-                for (size_t c = 0; c < InputChannels; c++) {
+            MlasActivation(&Activation, &Buffer[0].f, nullptr, _countof(Buffer), 1, 1);
 
-                    for (size_t ky = 0; ky < KernelHeight; ky++) {
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                // Sensitive to comparing positive/negative zero and NaNs.
+                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
+                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
+                }
+            }
 
-                        for (size_t kx = 0; kx < KernelWidth; kx++) {
+            //
+            // Test the scalar activations.
+            //
 
-                            for (size_t oh = 0; oh < OutputHeight; oh++) {
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                Buffer[i].u = TestData[i][0].u;
+                MlasActivation(&Activation, &Buffer[i].f, nullptr, 1, 1, 1);
+            }
 
-                                size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingLeftHeight;
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                // Sensitive to comparing positive/negative zero and NaNs.
+                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
+                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
+                }
+            }
+        }
+    }
 
-                                for (size_t ow = 0; ow < OutputWidth; ow++) {
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-                                    size_t iw = ow * StrideWidth + kx * DilationWidth - PaddingLeftWidth;
+class MlasGeluTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
 
-                                    *Im2ColOut++ = (ih < InputHeight && iw < InputWidth) ?
-                                        Input[ih * InputWidth + iw] : 0;
-                                }
-                            }
-                        }
-                    }
+    void
+    Test(
+        MLAS_GELU_KIND Kind,
+        size_t N,
+        size_t BiasLength
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Bias = BufferBias.GetBuffer(BiasLength);
+        float* Output = BufferOutput.GetBuffer(N);
 
-                    Input += InputSize;
-                }
+        for (size_t i = 0; i < N; i++) {
+            Input[i] = float(int(i % 97) - 48) / 8.0f;
+        }
 
-                MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
-                    filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, threadpool);
+        for (size_t i = 0; i < BiasLength; i++) {
+            Bias[i] = float(int(i % 13) - 6) / 4.0f;
+        }
 
-                //
-                // Apply the bias.
-                //
+        MlasComputeGelu(Kind, Input, (BiasLength > 0) ? Bias : nullptr, Output, N, BiasLength, threadpool);
 
-                for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t i = 0; i < N; i++) {
 
-                    float biasValue = *bias++;
+            double x = double(Input[i]) + ((BiasLength > 0) ? Bias[i % BiasLength] : 0.0f);
+            double Reference;
 
-                    for (size_t o = 0; o < OutputSize; o++) {
-                        *Output++ += biasValue;
-                    }
-                }
+            if (Kind == MlasGeluErf) {
+                Reference = 0.5 * x * (1.0 + std::erf(x * 0.70710678118654752));
+            } else {
+                Reference = 0.5 * x * (1.0 + std::tanh(x * (0.035677408136300125 * x * x + 0.7978845608028654)));
+            }
 
-                filter += FilterCount * InputChannels * KernelSize;
+            if (std::fabs(Output[i] - Reference) > 1e-5 + 1e-5 * std::fabs(Reference)) {
+                printf("mismatch Gelu: kind=%d N=%zd BiasLength=%zd i=%zd %f %f\n", int(Kind), N, BiasLength, i, Output[i], Reference);
+                break;
             }
         }
     }
 
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferFilter;
-    MatrixGuardBuffer<float> BufferBias;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
-    MatrixGuardBuffer<float> BufferWorking;
-    MatrixGuardBuffer<float> BufferIm2Col;
-
 public:
     void
     ExecuteShort(
         void
         ) override
     {
-        for (unsigned i = 1; i < 256; i <<= 1) {
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
-            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+        for (MLAS_GELU_KIND Kind : {MlasGeluErf, MlasGeluTanh}) {
+
+            for (size_t n = 1; n <= 20; n++) {
+                Test(Kind, n, 0);
+                Test(Kind, n * 3, n);
+            }
+
+            Test(Kind, 4099, 0);
+            Test(Kind, 8 * 3072, 3072);
+            Test(Kind, 40 * 1023, 1023);
+            Test(Kind, 300000, 0);
         }
     }
 
@@ -915,518 +3116,578 @@ public:
         void
         ) override
     {
-        static const unsigned cs[] = { 32, 14, 1 };
-        static const unsigned is[] = { 53, 11, 5, 1 };
+    }
+};
 
-        for (unsigned i = 1; i <= 32; i++) {
-            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+class MlasLayerNormTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferSkip;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferGamma;
+    MatrixGuardBuffer<float> BufferBeta;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    void
+    Test(
+        size_t N,
+        bool UseSkip,
+        bool UseBias,
+        float Offset
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Skip = BufferSkip.GetBuffer(N);
+        float* Bias = BufferBias.GetBuffer(N);
+        float* Gamma = BufferGamma.GetBuffer(N);
+        float* Beta = BufferBeta.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        for (size_t i = 0; i < N; i++) {
+            Input[i] = Offset + float((i * 7) % 23) / 11.0f - 1.0f;
+            Skip[i] = float((i * 3) % 19) / 9.0f - 1.0f;
+            Bias[i] = float(i % 5) / 10.0f - 0.2f;
+            Gamma[i] = float((i * 5) % 17) / 8.0f - 1.0f;
+            Beta[i] = float(i % 7) / 7.0f;
         }
 
-        for (unsigned b = 1; b < 64; b++) {
-            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        const float Epsilon = 1e-5f;
+        float Mean;
+        float InvStdDev;
+
+        MlasComputeLayerNormalization(Input, UseSkip ? Skip : nullptr, UseBias ? Bias : nullptr,
+            Gamma, Beta, Output, N, Epsilon, &Mean, &InvStdDev);
+
+        double ReferenceSum = 0.0;
+
+        for (size_t i = 0; i < N; i++) {
+            ReferenceSum += double(Input[i]) + (UseSkip ? Skip[i] : 0.0f) + (UseBias ? Bias[i] : 0.0f);
         }
 
-        for (unsigned ic = 0; ic < _countof(cs); ic++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", cs[ic], is[ih], is[iw]);
-                    for (unsigned fc = 0; fc < _countof(cs); fc++) {
-                        for (unsigned kh = 1; kh <= 5; kh++) {
-                            if (kh == 4) continue;
-                            for (unsigned kw = 1; kw <= 5; kw++) {
-                                if (kw == 4) continue;
-                                for (unsigned p0 = 0; p0 < 2; p0++) {
-                                    for (unsigned p1 = 0; p1 < 2; p1++) {
-                                        for (unsigned p2 = 0; p2 < 2; p2++) {
-                                            for (unsigned p3 = 0; p3 < 2; p3++) {
-                                                for (unsigned dh = 1; dh <= 2; dh++) {
-                                                    for (unsigned dw = 1; dw <= 2; dw++) {
-                                                        for (unsigned sh = 1; sh <= 2; sh++) {
-                                                            for (unsigned sw = 1; sw <= 2; sw++) {
-                                                                Test(1, 1, cs[ic], is[ih], is[iw], cs[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+        double ReferenceMean = ReferenceSum / double(N);
+        double ReferenceVariance = 0.0;
+
+        for (size_t i = 0; i < N; i++) {
+            double Deviation = double(Input[i]) + (UseSkip ? Skip[i] : 0.0f) + (UseBias ? Bias[i] : 0.0f) - ReferenceMean;
+            ReferenceVariance += Deviation * Deviation;
+        }
+
+        double ReferenceInvStdDev = 1.0 / std::sqrt(ReferenceVariance / double(N) + Epsilon);
+
+        if (std::fabs(Mean - ReferenceMean) > 1e-4 * (1.0 + std::fabs(ReferenceMean)) ||
+            std::fabs(InvStdDev - ReferenceInvStdDev) > 1e-3 * ReferenceInvStdDev) {
+            printf("mismatch LayerNorm statistics: N=%zd skip=%d bias=%d offset=%f\n", N, int(UseSkip), int(UseBias), Offset);
+        }
+
+        for (size_t i = 0; i < N; i++) {
+            double Value = double(Input[i]) + (UseSkip ? Skip[i] : 0.0f) + (UseBias ? Bias[i] : 0.0f);
+            double Reference = (Value - ReferenceMean) * ReferenceInvStdDev * Gamma[i] + Beta[i];
+            if (std::fabs(Output[i] - Reference) > 1e-3 * (1.0 + std::fabs(Reference))) {
+                printf("mismatch LayerNorm: N=%zd skip=%d bias=%d offset=%f i=%zd %f %f\n", N, int(UseSkip), int(UseBias), Offset, i, Output[i], Reference);
+                break;
             }
         }
     }
-};
 
-class MlasNchwcConv2DTest : public MlasConv2DTest
-{
-protected:
+public:
     void
-    MlasConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
+    ExecuteShort(
+        void
         ) override
     {
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(GroupCount * InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t FilterShape[] = { int64_t(GroupCount * FilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(GroupCount * FilterCount), int64_t(OutputHeight), int64_t(OutputWidth) };
-
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-
-        //
-        // Select the type of convolution that will be performed.
-        //
-
-        bool DoReorderInput;
-        bool ReorderFilterOIHWBo;
+        for (size_t n = 1; n <= 40; n++) {
+            Test(n, false, false, 0.0f);
+            Test(n, true, false, 0.0f);
+            Test(n, true, true, 0.0f);
+        }
 
-        if (GroupCount > 1 && InputChannels == 1 && FilterCount == 1) {
-            // Depthwise convolution.
-            DoReorderInput = true;
-            ReorderFilterOIHWBo = true;
-        } else if (InputChannels >= BlockSize) {
-            // NCHWc or pointwise convolution;
-            DoReorderInput = true;
-            ReorderFilterOIHWBo = false;
-        } else {
-            // NCHW convolution.
-            DoReorderInput = false;
-            ReorderFilterOIHWBo = true;
+        for (size_t n : {127, 768, 1024, 4099}) {
+            Test(n, false, false, 0.0f);
+            Test(n, true, true, 0.0f);
+            Test(n, false, true, 1000.0f);
         }
+    }
 
-        size_t NchwcInputChannels = (GroupCount * InputChannels + BlockSize - 1) & ~(BlockSize - 1);
-        size_t NchwcOutputChannels = (GroupCount * FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-        //
-        // Reorder the filter buffer as needed.
-        //
+class MlasNormalizeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
 
-        float* ReorderedFilter;
+    void
+    TestScaleShift(
+        size_t N,
+        float Offset
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
 
-        if (ReorderFilterOIHWBo) {
-            size_t NchwcFilterElements = NchwcOutputChannels * InputChannels * KernelHeight * KernelWidth;
-            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
-            MlasReorderFilterOIHWBo(FilterShape, Filter, ReorderedFilter);
-        } else {
-            size_t NchwcFilterElements = NchwcOutputChannels * NchwcInputChannels * KernelHeight * KernelWidth;
-            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
-            MlasReorderFilterOIHWBiBo(FilterShape, Filter, ReorderedFilter);
+        for (size_t i = 0; i < N; i++) {
+            Input[i] = Offset + float((i * 7) % 23) / 11.0f - 1.0f;
         }
 
-        //
-        // Align the bias buffer to the filter count if needed.
-        //
+        const float Epsilon = 1e-5f;
+        float Mean;
+        float InvStdDev;
 
-        if (Bias != nullptr && GroupCount * FilterCount < NchwcOutputChannels) {
+        MlasComputeMeanAndInvStdDev(Input, N, Epsilon, &Mean, &InvStdDev);
 
-            float* AlignedBias = BufferNchwcBias.GetBuffer(NchwcOutputChannels);
+        double ReferenceSum = 0.0;
 
-            size_t i;
-            for (i = 0; i < GroupCount * FilterCount; i++) {
-                AlignedBias[i] = Bias[i];
-            }
-            for (; i < NchwcOutputChannels; i++) {
-                AlignedBias[i] = 0.0f;
-            }
+        for (size_t i = 0; i < N; i++) {
+            ReferenceSum += Input[i];
+        }
 
-            Bias = AlignedBias;
+        double ReferenceMean = ReferenceSum / double(N);
+        double ReferenceVariance = 0.0;
+
+        for (size_t i = 0; i < N; i++) {
+            ReferenceVariance += (Input[i] - ReferenceMean) * (Input[i] - ReferenceMean);
         }
 
-        //
-        // Reorder the input buffer if needed.
-        //
+        double ReferenceInvStdDev = 1.0 / std::sqrt(ReferenceVariance / double(N) + Epsilon);
 
-        if (DoReorderInput) {
-            size_t NchwcInputElements = BatchCount * NchwcInputChannels * InputHeight * InputWidth;
-            float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
-            MlasReorderInput(InputShape, Input, NchwcInput);
-            Input = NchwcInput;
-            InputShape[1] = NchwcInputChannels;
+        if (std::fabs(Mean - ReferenceMean) > 1e-4 * (1.0 + std::fabs(ReferenceMean)) ||
+            std::fabs(InvStdDev - ReferenceInvStdDev) > 1e-3 * ReferenceInvStdDev) {
+            printf("mismatch MeanAndInvStdDev: N=%zd offset=%f\n", N, Offset);
         }
 
-        int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcOutputChannels), int64_t(OutputHeight), int64_t(OutputWidth) };
+        const float Scale = 0.75f;
+        const float Shift = -2.5f;
 
-        size_t NchwcOutputElements = BatchCount * NchwcOutputChannels * OutputHeight * OutputWidth;
-        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+        MlasComputeScaleShift(Input, Output, N, Scale, Shift);
 
-        MLAS_ACTIVATION Activation;
-        Activation.ActivationKind = MlasIdentityActivation;
+        for (size_t i = 0; i < N; i++) {
+            float Reference = Input[i] * Scale + Shift;
+            if (std::fabs(Output[i] - Reference) > 1e-5f * (1.0f + std::fabs(Reference))) {
+                printf("mismatch ScaleShift: N=%zd offset=%f i=%zd %f %f\n", N, Offset, i, Output[i], Reference);
+                break;
+            }
+        }
+    }
 
-        MlasNchwcConv(2,
-                      InputShape,
-                      KernelShape,
-                      DilationShape,
-                      Padding,
-                      StrideShape,
-                      NchwcOutputShape,
-                      GroupCount,
-                      Input,
-                      ReorderedFilter,
-                      Bias,
-                      NchwcOutput,
-                      &Activation,
-                      true,
-                      nullptr);
+    void
+    TestLocalResponseNormalization(
+        size_t Channels,
+        size_t N,
+        size_t Size
+        )
+    {
+        const size_t ChannelStride = N + 3;
+        float* Input = BufferInput.GetBuffer(Channels * ChannelStride);
+        float* Output = BufferOutput.GetBuffer(Channels * ChannelStride);
 
-        //
-        // Reorder the output buffer.
-        //
+        for (size_t i = 0; i < Channels * ChannelStride; i++) {
+            Input[i] = float((i * 7) % 23) / 5.0f - 2.0f;
+        }
 
-        MlasReorderOutput(OutputShape, NchwcOutput, Output);
-    }
+        const float Alpha = 0.0001f * float(Size);
+        const float Beta = 0.75f;
+        const float Bias = 1.0f;
 
-    const size_t BlockSize = MlasNchwcGetBlockSize();
+        MlasComputeLocalResponseNormalization(Input, Output, Channels, ChannelStride, N, Size, Alpha, Beta, Bias);
 
-    MatrixGuardBuffer<float> BufferNchwcInput;
-    MatrixGuardBuffer<float> BufferNchwcFilter;
-    MatrixGuardBuffer<float> BufferNchwcBias;
-    MatrixGuardBuffer<float> BufferNchwcOutput;
+        const ptrdiff_t PrePad = ptrdiff_t((Size - 1) / 2);
+
+        for (size_t c = 0; c < Channels; c++) {
+            for (size_t i = 0; i < N; i++) {
+                double SumSquares = 0.0;
+                for (ptrdiff_t j = ptrdiff_t(c) - PrePad; j < ptrdiff_t(c) - PrePad + ptrdiff_t(Size); j++) {
+                    if (j >= 0 && j < ptrdiff_t(Channels)) {
+                        double Value = Input[j * ChannelStride + i];
+                        SumSquares += Value * Value;
+                    }
+                }
+                double Reference = Input[c * ChannelStride + i] / std::pow(Bias + Alpha / Size * SumSquares, double(Beta));
+                if (std::fabs(Output[c * ChannelStride + i] - Reference) > 1e-4 * (1.0 + std::fabs(Reference))) {
+                    printf("mismatch LRN: C=%zd N=%zd size=%zd c=%zd i=%zd %f %f\n", Channels, N, Size, c, i, Output[c * ChannelStride + i], Reference);
+                    return;
+                }
+            }
+        }
+    }
 
 public:
     void
-    ExecuteLong(
+    ExecuteShort(
         void
         ) override
     {
-        // N.B. InputChannels must be a multiple of 4 if the count is greater
-        // than the block size.
-        static const unsigned cis[] = { 32, 20, 5, 1 };
-        static const unsigned cos[] = { 64, 15, 1 };
-        static const unsigned is[] = { 27, 11, 5, 1 };
-
-        // Depthwise convolutions.
-        for (unsigned i = 16; i < 256; i <<= 1) {
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(12, i, 1, 11, 11, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
-
-        // Test varying FilterCounts.
-        for (unsigned i = 1; i < 128; i++) {
-            Test(1, 1, 3, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, 34, 34, i, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
-
-        for (unsigned i = 1; i <= 32; i++) {
-            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+        for (size_t n = 1; n <= 40; n++) {
+            TestScaleShift(n, 0.0f);
         }
 
-        for (unsigned b = 1; b < 64; b++) {
-            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        for (size_t n : {127, 768, 4099}) {
+            TestScaleShift(n, 0.0f);
+            TestScaleShift(n, 1000.0f);
         }
 
-        for (unsigned ic = 0; ic < _countof(cis); ic++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", cis[ic], is[ih], is[iw]);
-                    for (unsigned fc = 0; fc < _countof(cos); fc++) {
-                        for (unsigned kh = 1; kh <= 5; kh++) {
-                            if (kh == 4) continue;
-                            for (unsigned kw = 1; kw <= 5; kw++) {
-                                if (kw == 4) continue;
-                                for (unsigned p0 = 0; p0 <= 3; p0++) {
-                                    for (unsigned p1 = 0; p1 <= 3; p1++) {
-                                        for (unsigned p2 = 0; p2 <= 3; p2++) {
-                                            for (unsigned p3 = 0; p3 <= 3; p3++) {
-                                                for (unsigned dh = 1; dh <= 2; dh++) {
-                                                    for (unsigned dw = 1; dw <= 2; dw++) {
-                                                        for (unsigned sh = 1; sh <= 2; sh++) {
-                                                            for (unsigned sw = 1; sw <= 2; sw++) {
-                                                                Test(1, 1, cis[ic], is[ih], is[iw], cos[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
+        for (size_t Size : {1, 2, 3, 5, 8}) {
+            for (size_t Channels : {1, 3, 4, 17}) {
+                for (size_t n : {1, 7, 64, 300}) {
+                    TestLocalResponseNormalization(Channels, n, Size);
                 }
             }
         }
     }
 
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
 };
 
-class MlasPool2DTest : public MlasTestBase
+class MlasTranscendentalTest : public MlasTestBase
 {
-protected:
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    static
+    bool
+    CloseEnough(
+        float Actual,
+        double Expected,
+        double Tolerance
+        )
+    {
+        if (std::isnan(Expected)) {
+            return std::isnan(Actual);
+        }
+
+        //
+        // Results beyond the single precision range overflow to infinity.
+        //
+
+        if (std::fabs(Expected) > double(std::numeric_limits<float>::max())) {
+            Expected = (Expected > 0) ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+        }
+
+        if (std::isinf(Expected) || std::isinf(Actual)) {
+            return double(Actual) == Expected;
+        }
+
+        //
+        // Results that underflow to zero or a denormal are compared against
+        // the smallest normal value.
+        //
+
+        double Error = std::fabs(double(Actual) - Expected);
+        double Scale = std::max(std::fabs(Expected), double(std::numeric_limits<float>::min()));
+
+        return Error <= Tolerance * Scale;
+    }
+
+    template<typename MlasFunction, typename ReferenceFunction>
     void
     Test(
-        size_t BatchCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t StrideHeight,
-        size_t StrideWidth
+        const char* Name,
+        MlasFunction Function,
+        ReferenceFunction Reference,
+        const float* Values,
+        size_t N,
+        double Tolerance
         )
     {
-        const size_t DilationHeight = 1;
-        const size_t DilationWidth = 1;
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
 
-        int64_t OutputHeight64 =
-            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
-            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
-        int64_t OutputWidth64 =
-            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
-            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+        std::copy_n(Values, N, Input);
 
-        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
-            return;
+        Function(Input, Output, N);
+
+        for (size_t i = 0; i < N; i++) {
+            double Expected = Reference(double(Input[i]));
+            if (!CloseEnough(Output[i], Expected, Tolerance)) {
+                printf("mismatch %s: N=%zd i=%zd x=%g %g %g\n", Name, N, i, Input[i], Output[i], Expected);
+                break;
+            }
         }
+    }
 
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputHeight64, OutputWidth64 };
+    static
+    std::vector<float>
+    GenerateValues(
+        float Minimum,
+        float Maximum,
+        size_t Count
+        )
+    {
+        std::vector<float> Values(Count);
 
-        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
-        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+        for (size_t i = 0; i < Count; i++) {
+            Values[i] = Minimum + (Maximum - Minimum) * (float(i) / float(Count - 1));
+        }
 
-        const float* Input = BufferInput.GetBuffer(InputBufferElements);
-        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+        return Values;
+    }
 
-        MlasPool2D(MlasMaximumPooling, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+    static
+    std::vector<float>
+    GenerateLogarithmicValues(
+        size_t Count
+        )
+    {
+        //
+        // Cover the positive range from the denormals to the largest values.
+        //
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        std::vector<float> Values(Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            Values[i] = float(std::exp2(-148.0 + 275.0 * (double(i) / double(Count - 1))));
         }
 
-        MlasPool2D(MlasAveragePoolingExcludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+        return Values;
+    }
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        const float Infinity = std::numeric_limits<float>::infinity();
+        const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+        const std::vector<float> Special = { 0.0f, -0.0f, 1.0f, -1.0f, Infinity, -Infinity, NaN, 1e-40f, 2.5f, -2.5f, 100.0f };
+
+        const std::vector<float> ExpValues = GenerateValues(-110.0f, 90.0f, 20011);
+        const std::vector<float> LogValues = GenerateLogarithmicValues(20011);
+        const std::vector<float> PowValues = GenerateValues(-8.0f, 8.0f, 4003);
+
+        auto Exp = [](const float* Input, float* Output, size_t N) { MlasComputeExp(Input, Output, N); };
+        auto Log = [](const float* Input, float* Output, size_t N) { MlasComputeLog(Input, Output, N); };
+        auto Sqrt = [](const float* Input, float* Output, size_t N) { MlasComputeSqrt(Input, Output, N); };
+        auto ReciprocalSqrt = [](const float* Input, float* Output, size_t N) { MlasComputeReciprocalSqrt(Input, Output, N); };
+
+        for (size_t n = 1; n <= Special.size(); n++) {
+            Test("Exp", Exp, [](double x) { return std::exp(x); }, Special.data(), n, 4e-7);
+            Test("Log", Log, [](double x) { return std::log(x); }, Special.data(), n, 4e-7);
+            Test("Sqrt", Sqrt, [](double x) { return std::sqrt(x); }, Special.data(), n, 1e-7);
+            Test("ReciprocalSqrt", ReciprocalSqrt, [](double x) { return 1.0 / std::sqrt(x); }, Special.data(), n, 2e-7);
         }
 
-        MlasPool2D(MlasAveragePoolingIncludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+        //
+        // The exponential loses precision for results in the denormal range,
+        // which is covered by the tolerance relative to the smallest normal.
+        //
+
+        Test("Exp", Exp, [](double x) { return std::exp(x); }, ExpValues.data(), ExpValues.size(), 4e-7);
+        Test("Log", Log, [](double x) { return std::log(x); }, LogValues.data(), LogValues.size(), 4e-7);
+        Test("Sqrt", Sqrt, [](double x) { return std::sqrt(x); }, LogValues.data(), LogValues.size(), 1e-7);
+        Test("ReciprocalSqrt", ReciprocalSqrt, [](double x) { return 1.0 / std::sqrt(x); }, LogValues.data(), LogValues.size(), 2e-7);
+
+        for (float Exponent : { 0.0f, 1.0f, 2.0f, 3.0f, -1.0f, 0.5f, -0.5f, 4.0f, 5.0f, -3.0f, 1.5f, -2.25f, 0.3f, 10.0f }) {
+
+            auto Pow = [Exponent](const float* Input, float* Output, size_t N) { MlasComputePow(Input, Exponent, Output, N); };
+            auto Reference = [Exponent](double x) { return std::pow(x, double(Exponent)); };
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+            Test("Pow", Pow, Reference, PowValues.data(), PowValues.size(), 4e-6);
+            Test("Pow", Pow, Reference, Special.data(), Special.size() - 1, 4e-6);
         }
     }
 
-    virtual
     void
-    MlasPool2D(
-        MLAS_POOLING_KIND PoolingKind,
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const int64_t* OutputShape,
-        const float* Input,
-        float* Output
-        )
+    ExecuteLong(
+        void
+        ) override
     {
-        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     }
+};
+
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
 
     void
-    ReferenceMaximumPool2D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output
+    Test(
+        size_t N,
+        size_t D,
+        bool LogSoftmax,
+        float Scale
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
-
-        int64_t InputHeight = InputShape[2];
-        int64_t InputWidth = InputShape[3];
-
-        int64_t KernelHeight = KernelShape[0];
-        int64_t KernelWidth = KernelShape[1];
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
 
-        int64_t PaddingLeftY = Padding[0];
-        int64_t PaddingLeftX = Padding[1];
-        int64_t PaddingRightY = Padding[2];
-        int64_t PaddingRightX = Padding[3];
-
-        int64_t StrideHeight = StrideShape[0];
-        int64_t StrideWidth = StrideShape[1];
+        for (size_t i = 0; i < N * D; i++) {
+            Input[i] = float(int((i * 7) % 23) - 11) * Scale;
+        }
 
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        for (size_t n = 0; n < N; n++) {
 
-            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+            const float* x = Input + n * D;
+            const float* y = Output + n * D;
 
-                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                int64_t ihEnd = ihStart + KernelHeight;
+            double Maximum = x[0];
 
-                ihStart = (std::max)(ihStart, int64_t(0));
-                ihEnd = (std::min)(ihEnd, InputHeight);
+            for (size_t d = 1; d < D; d++) {
+                Maximum = std::max(Maximum, double(x[d]));
+            }
 
-                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+            double Sum = 0.0;
 
-                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                    int64_t iwEnd = iwStart + KernelWidth;
+            for (size_t d = 0; d < D; d++) {
+                Sum += std::exp(double(x[d]) - Maximum);
+            }
 
-                    iwStart = (std::max)(iwStart, int64_t(0));
-                    iwEnd = (std::min)(iwEnd, InputWidth);
+            for (size_t d = 0; d < D; d++) {
 
-                    float m = std::numeric_limits<float>::lowest();
+                double Reference;
 
-                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                            m = (std::max)(m, Input[ih * InputWidth + iw]);
-                        }
-                    }
+                if (LogSoftmax) {
+                    Reference = double(x[d]) - Maximum - std::log(Sum);
+                } else {
+                    Reference = std::exp(double(x[d]) - Maximum) / Sum;
+                }
 
-                    Output[ph * OutputWidth + pw] = m;
+                if (std::fabs(y[d] - Reference) > 1e-5 + 1e-5 * std::fabs(Reference)) {
+                    printf("mismatch Softmax: N=%zd D=%zd log=%d n=%zd d=%zd %f %f\n", N, D, int(LogSoftmax), n, d, y[d], Reference);
+                    return;
                 }
             }
-
-            Input += InputHeight * InputWidth;
-            Output += OutputHeight * OutputWidth;
         }
     }
 
+public:
     void
-    ReferenceAveragePool2D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output,
-        bool CountIncludePad
-        )
+    ExecuteShort(
+        void
+        ) override
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
+        for (bool LogSoftmax : {false, true}) {
 
-        int64_t InputHeight = InputShape[2];
-        int64_t InputWidth = InputShape[3];
+            for (size_t d = 1; d <= 20; d++) {
+                Test(1, d, LogSoftmax, 0.5f);
+                Test(3, d, LogSoftmax, 4.0f);
+            }
 
-        int64_t KernelHeight = KernelShape[0];
-        int64_t KernelWidth = KernelShape[1];
+            Test(7, 1000, LogSoftmax, 1.0f);
+            Test(12 * 128, 128, LogSoftmax, 0.25f);
+            Test(64, 3001, LogSoftmax, 8.0f);
+        }
+    }
 
-        int64_t PaddingLeftY = Padding[0];
-        int64_t PaddingLeftX = Padding[1];
-        int64_t PaddingRightY = Padding[2];
-        int64_t PaddingRightX = Padding[3];
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-        int64_t StrideHeight = StrideShape[0];
-        int64_t StrideWidth = StrideShape[1];
+class MlasReorderNhwcTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferInputNchw;
+    MatrixGuardBuffer<float> BufferNchwc;
+    MatrixGuardBuffer<float> BufferNchwcReference;
+    MatrixGuardBuffer<float> BufferOutput;
 
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+    void
+    Test(
+        size_t BatchCount,
+        size_t Height,
+        size_t Width,
+        size_t Channels
+        )
+    {
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+        const size_t NchwcChannels = (Channels + BlockSize - 1) & ~(BlockSize - 1);
+        const size_t InputSize = Height * Width;
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        const int64_t InputShape[] = { int64_t(BatchCount), int64_t(Height), int64_t(Width), int64_t(Channels) };
+        const int64_t InputShapeNchw[] = { int64_t(BatchCount), int64_t(Channels), int64_t(Height), int64_t(Width) };
 
-            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+        const size_t InputElements = BatchCount * InputSize * Channels;
+        const size_t NchwcElements = BatchCount * InputSize * NchwcChannels;
 
-                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                int64_t ihEnd = ihStart + KernelHeight;
+        float* Input = BufferInput.GetBuffer(InputElements);
+        float* InputNchw = BufferInputNchw.GetBuffer(InputElements);
+        float* Nchwc = BufferNchwc.GetBuffer(NchwcElements);
+        float* NchwcReference = BufferNchwcReference.GetBuffer(NchwcElements);
+        float* Output = BufferOutput.GetBuffer(InputElements);
 
-                ihStart = (std::max)(ihStart, int64_t(0));
-                ihEnd = (std::min)(ihEnd, InputHeight);
+        for (size_t i = 0; i < InputElements; i++) {
+            Input[i] = float(i % 251) - 125.0f;
+        }
 
-                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+        //
+        // Build the reference NCHWc buffer from the transposed input.
+        //
 
-                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                    int64_t iwEnd = iwStart + KernelWidth;
+        for (size_t n = 0; n < BatchCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t p = 0; p < InputSize; p++) {
+                    InputNchw[(n * Channels + c) * InputSize + p] = Input[(n * InputSize + p) * Channels + c];
+                }
+            }
+        }
 
-                    iwStart = (std::max)(iwStart, int64_t(0));
-                    iwEnd = (std::min)(iwEnd, InputWidth);
+        if (Channels == NchwcChannels) {
+            MlasReorderInput(InputShapeNchw, InputNchw, NchwcReference);
+        } else {
+            std::fill_n(NchwcReference, NchwcElements, 0.0f);
+            for (size_t n = 0; n < BatchCount; n++) {
+                for (size_t c = 0; c < Channels; c++) {
+                    for (size_t p = 0; p < InputSize; p++) {
+                        size_t NchwcIndex = (n * NchwcChannels + (c & ~(BlockSize - 1))) * InputSize + p * BlockSize + (c & (BlockSize - 1));
+                        NchwcReference[NchwcIndex] = InputNchw[(n * Channels + c) * InputSize + p];
+                    }
+                }
+            }
+        }
 
-                    float m = 0.0f;
+        std::fill_n(Nchwc, NchwcElements, -1.0f);
 
-                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                            m += Input[ih * InputWidth + iw];
-                        }
-                    }
+        MlasReorderInputNhwc(InputShape, Input, Nchwc);
 
-                    if (CountIncludePad) {
-                        m /= (KernelHeight * KernelWidth);
-                    } else {
-                        m /= (ihEnd - ihStart) * (iwEnd - iwStart);
-                    }
+        if (memcmp(Nchwc, NchwcReference, NchwcElements * sizeof(float)) != 0) {
+            printf("mismatch ReorderInputNhwc: %zd,%zd,%zd,%zd\n", BatchCount, Height, Width, Channels);
+        }
 
-                    Output[ph * OutputWidth + pw] = m;
-                }
-            }
+        std::fill_n(Output, InputElements, -1.0f);
 
-            Input += InputHeight * InputWidth;
-            Output += OutputHeight * OutputWidth;
+        MlasReorderOutputNhwc(InputShape, Nchwc, Output);
+
+        if (memcmp(Output, Input, InputElements * sizeof(float)) != 0) {
+            printf("mismatch ReorderOutputNhwc: %zd,%zd,%zd,%zd\n", BatchCount, Height, Width, Channels);
         }
     }
 
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
-
 public:
     void
     ExecuteShort(
         void
         ) override
     {
-        for (unsigned i = 1; i < 256; i <<= 1) {
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 2, 2);
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 3, 3, 1, 1, 1, 1, 1, 1);
-            Test(1, 16, i, i, 1, 1, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, i, 1, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 1, i, 0, 0, 0, 0, 1, 1);
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+
+        for (size_t c = 1; c <= 3 * BlockSize + 1; c++) {
+            Test(1, 3, 5, c);
+            Test(2, 7, 1, c);
         }
+
+        Test(1, 56, 56, 64);
+        Test(3, 14, 14, 2 * BlockSize + 3);
     }
 
     void
@@ -1434,400 +3695,484 @@ public:
         void
         ) override
     {
-        static const unsigned is[] = { 53, 17, 11, 5, 4, 3, 2, 1 };
+    }
+};
 
-        for (unsigned i = 1; i < 2058; i++) {
-            Test(1, 1, 4, i, 2, 4, 0, 2, 0, 1, 1, 1);
+class MlasTransposeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint32_t> BufferInput32;
+    MatrixGuardBuffer<uint32_t> BufferOutput32;
+    MatrixGuardBuffer<uint8_t> BufferInput8;
+    MatrixGuardBuffer<uint8_t> BufferOutput8;
+
+    template<typename T>
+    void
+    Test(
+        MatrixGuardBuffer<T>& BufferInput,
+        MatrixGuardBuffer<T>& BufferOutput,
+        size_t M,
+        size_t N,
+        size_t lda,
+        size_t ldb
+        )
+    {
+        T* Input = BufferInput.GetBuffer(M * lda);
+        T* Output = BufferOutput.GetBuffer(N * ldb);
+
+        for (size_t i = 0; i < M * lda; i++) {
+            Input[i] = T(i * 7 + 3);
         }
 
-        for (unsigned ih = 0; ih < _countof(is); ih++) {
-            for (unsigned iw = 0; iw < _countof(is); iw++) {
-                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
-                Test(1, 1, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
-                Test(1, 1, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
-                Test(1, 1, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
-                for (unsigned kh = 1; kh <= 5; kh++) {
-                    if (kh > is[ih]) break;
-                    for (unsigned kw = 1; kw <= 5; kw++) {
-                        if (kw > is[iw]) break;
-                        for (unsigned sh = 1; sh <= 3; sh++) {
-                            for (unsigned sw = 1; sw <= 3; sw++) {
-                                for (unsigned p0 = 0; p0 < kh; p0++) {
-                                    for (unsigned p1 = 0; p1 < kw; p1++) {
-                                        for (unsigned p2 = 0; p2 < kh; p2++) {
-                                            for (unsigned p3 = 0; p3 < kw; p3++) {
-                                                Test(5, 3, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
+        std::fill_n(Output, N * ldb, T(0xFF));
+
+        MlasTranspose(Input, lda, Output, ldb, M, N);
+
+        for (size_t n = 0; n < N; n++) {
+            for (size_t m = 0; m < ldb; m++) {
+                T Reference = (m < M) ? Input[m * lda + n] : T(0xFF);
+                if (Output[n * ldb + m] != Reference) {
+                    printf("mismatch Transpose: size=%zd M=%zd N=%zd lda=%zd ldb=%zd m=%zd n=%zd\n",
+                        sizeof(T), M, N, lda, ldb, m, n);
+                    return;
                 }
             }
         }
     }
-};
 
-class MlasNchwcPool2DTest : public MlasPool2DTest
-{
-protected:
+public:
     void
-    MlasPool2D(
-        MLAS_POOLING_KIND PoolingKind,
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const int64_t* OutputShape,
-        const float* Input,
-        float* Output
+    ExecuteShort(
+        void
         ) override
     {
-        size_t NchwcChannels = (size_t(InputShape[1]) + BlockSize - 1) & ~(BlockSize - 1);
-
-        int64_t NchwcInputShape[] = { InputShape[0], int64_t(NchwcChannels), InputShape[2], InputShape[3] };
-        size_t NchwcInputElements = size_t(NchwcInputShape[0]) * size_t(NchwcInputShape[1]) * size_t(NchwcInputShape[2]) * size_t(NchwcInputShape[3]);
-        float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
-
-        int64_t NchwcOutputShape[] = { OutputShape[0], int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
-        size_t NchwcOutputElements = size_t(NchwcOutputShape[0]) * size_t(NchwcOutputShape[1]) * size_t(NchwcOutputShape[2]) * size_t(NchwcOutputShape[3]);
-        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
-
-        MlasReorderInput(InputShape, Input, NchwcInput);
-
-        MlasNchwcPool(PoolingKind,
-                      2,
-                      NchwcInputShape,
-                      KernelShape,
-                      nullptr,
-                      Padding,
-                      StrideShape,
-                      NchwcOutputShape,
-                      NchwcInput,
-                      NchwcOutput,
-                      nullptr);
+        for (size_t m = 1; m <= 20; m++) {
+            for (size_t n = 1; n <= 20; n++) {
+                Test(BufferInput32, BufferOutput32, m, n, n, m);
+                Test(BufferInput8, BufferOutput8, m, n, n, m);
+            }
+        }
 
-        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+        Test(BufferInput32, BufferOutput32, 3, 224 * 224, 224 * 224, 3);
+        Test(BufferInput32, BufferOutput32, 224 * 224, 3, 3, 224 * 224);
+        Test(BufferInput32, BufferOutput32, 197, 301, 305, 200);
+        Test(BufferInput8, BufferOutput8, 197, 301, 305, 200);
+        Test(BufferInput8, BufferOutput8, 1000, 64, 64, 1000);
     }
 
-    MatrixGuardBuffer<float> BufferNchwcInput;
-    MatrixGuardBuffer<float> BufferNchwcOutput;
-
-    const size_t BlockSize = MlasNchwcGetBlockSize();
-
-public:
     void
     ExecuteLong(
         void
         ) override
     {
-        static const unsigned is[] = { 53, 11, 1 };
+    }
+};
 
-        for (unsigned ih = 0; ih < _countof(is); ih++) {
-            for (unsigned iw = 0; iw < _countof(is); iw++) {
-                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
-                Test(1, 12, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
-                Test(1, 32, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
-                Test(1, 68, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
-                for (unsigned kh = 1; kh <= 5; kh++) {
-                    if (kh > is[ih]) break;
-                    for (unsigned kw = 1; kw <= 5; kw++) {
-                        if (kw > is[iw]) break;
-                        for (unsigned sh = 1; sh <= 3; sh++) {
-                            for (unsigned sw = 1; sw <= 3; sw++) {
-                                for (unsigned p0 = 0; p0 < kh; p0++) {
-                                    for (unsigned p1 = 0; p1 < kw; p1++) {
-                                        for (unsigned p2 = 0; p2 < kh; p2++) {
-                                            for (unsigned p3 = 0; p3 < kw; p3++) {
-                                                Test(1, 32, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+class MlasConvertTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<unsigned short> BufferHalf;
+    MatrixGuardBuffer<float> BufferFloat;
+    MatrixGuardBuffer<float> BufferFloatOutput;
+    MatrixGuardBuffer<int8_t> BufferInt8;
+    MatrixGuardBuffer<uint8_t> BufferUInt8;
+
+    static
+    float
+    HalfToFloatReference(
+        unsigned short Value
+        )
+    {
+        const int Exponent = (Value >> 10) & 0x1F;
+        const int Mantissa = Value & 0x3FF;
+        float Magnitude;
+
+        if (Exponent == 0x1F) {
+            Magnitude = (Mantissa == 0) ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+        } else if (Exponent == 0) {
+            Magnitude = std::ldexp(float(Mantissa), -24);
+        } else {
+            Magnitude = std::ldexp(float(Mantissa + 0x400), Exponent - 25);
         }
+
+        return (Value & 0x8000) ? -Magnitude : Magnitude;
     }
 
-};
+    static
+    bool
+    IsSameFloat(
+        float Value,
+        float Reference
+        )
+    {
+        if (std::isnan(Reference)) {
+            return std::isnan(Value);
+        }
+        return Value == Reference && std::signbit(Value) == std::signbit(Reference);
+    }
 
-class MlasPool3DTest : public MlasTestBase
-{
-protected:
     void
-    Test(
-        size_t BatchCount,
-        size_t InputChannels,
-        size_t InputDepth,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t KernelDepth,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftDepth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightDepth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t StrideDepth,
-        size_t StrideHeight,
-        size_t StrideWidth
+    TestHalf(
+        size_t Count
         )
     {
-        const size_t DilationDepth = 1;
-        const size_t DilationHeight = 1;
-        const size_t DilationWidth = 1;
+        unsigned short* Half = BufferHalf.GetBuffer(Count);
+        float* Float = BufferFloat.GetBuffer(Count);
 
-        int64_t OutputDepth64 =
-            ((int64_t(InputDepth) + int64_t(PaddingLeftDepth) + int64_t(PaddingRightDepth)) -
-            (int64_t(DilationDepth) * (int64_t(KernelDepth) - 1) + 1)) / int64_t(StrideDepth) + 1;
-        int64_t OutputHeight64 =
-            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
-            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
-        int64_t OutputWidth64 =
-            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
-            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+        for (size_t i = 0; i < Count; i++) {
+            Half[i] = (unsigned short)(i * 7919 + 3);
+        }
 
-        if (OutputDepth64 <= 0 || OutputHeight64 <= 0 || OutputWidth64 <= 0) {
-            return;
+        MlasConvertHalfToFloatBuffer(Half, Float, Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            if (!IsSameFloat(Float[i], HalfToFloatReference(Half[i]))) {
+                printf("mismatch ConvertHalfToFloat: Count=%zd i=%zd %04x %g\n", Count, i, Half[i], Float[i]);
+                return;
+            }
         }
 
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputDepth), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelDepth), int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftDepth), int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightDepth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideDepth), int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputDepth64, OutputHeight64, OutputWidth64 };
+        //
+        // Finite values convert back to the same half precision value, except
+        // that NaNs only need to remain NaNs.
+        //
 
-        OutputShape[2] = (InputShape[2] + Padding[0] + Padding[3] - KernelShape[0]) / StrideShape[0] + 1;
-        OutputShape[3] = (InputShape[3] + Padding[1] + Padding[4] - KernelShape[1]) / StrideShape[1] + 1;
-        OutputShape[4] = (InputShape[4] + Padding[2] + Padding[5] - KernelShape[2]) / StrideShape[2] + 1;
+        MlasConvertFloatToHalfBuffer(Float, Half, Count);
 
-        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3] * InputShape[4]);
-        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3] * OutputShape[4]);
+        for (size_t i = 0; i < Count; i++) {
+            unsigned short Expected = (unsigned short)(i * 7919 + 3);
+            bool IsNaN = (Expected & 0x7C00) == 0x7C00 && (Expected & 0x3FF) != 0;
+            if (IsNaN ? !std::isnan(HalfToFloatReference(Half[i])) : Half[i] != Expected) {
+                printf("mismatch ConvertFloatToHalf: Count=%zd i=%zd %04x %04x\n", Count, i, Half[i], Expected);
+                return;
+            }
+        }
+    }
 
-        const float* Input = BufferInput.GetBuffer(InputBufferElements);
-        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    void
+    TestHalfRounding(
+        void
+        )
+    {
+        //
+        // Convert the midpoints between adjacent positive half precision values
+        // and check that they round to the value with an even mantissa.
+        //
 
-        MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+        const size_t Count = 0x7BFF;
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: maximum input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        unsigned short* Half = BufferHalf.GetBuffer(Count);
+        float* Float = BufferFloat.GetBuffer(Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            Float[i] = (HalfToFloatReference((unsigned short)i) + HalfToFloatReference((unsigned short)(i + 1))) / 2.0f;
         }
 
-        MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+        MlasConvertFloatToHalfBuffer(Float, Half, Count);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageexcpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        for (size_t i = 0; i < Count; i++) {
+            unsigned short Expected = (unsigned short)((i & 1) ? i + 1 : i);
+            if (Half[i] != Expected) {
+                printf("mismatch ConvertFloatToHalf rounding: i=%zd %04x %04x\n", i, Half[i], Expected);
+                return;
+            }
         }
 
-        MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+        Float[0] = 65520.0f;
+        Float[1] = -1.0e10f;
+        Float[2] = std::ldexp(1.0f, -26);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageincpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        MlasConvertFloatToHalfBuffer(Float, Half, 3);
+
+        if (Half[0] != 0x7C00 || Half[1] != 0xFC00 || Half[2] != 0x0000) {
+            printf("mismatch ConvertFloatToHalf limits: %04x %04x %04x\n", Half[0], Half[1], Half[2]);
         }
     }
 
+    template<typename T>
     void
-    ReferenceMaximumPool3D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output
+    TestInteger(
+        MatrixGuardBuffer<T>& BufferInteger,
+        size_t Count
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
+        float* Float = BufferFloat.GetBuffer(Count);
+        T* Integer = BufferInteger.GetBuffer(Count);
+        float* FloatOutput = BufferFloatOutput.GetBuffer(Count);
 
-        int64_t InputDepth = InputShape[2];
-        int64_t InputHeight = InputShape[3];
-        int64_t InputWidth = InputShape[4];
+        const float Limits[] = { -1.0e10f, 1.0e10f, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() };
 
-        int64_t KernelDepth = KernelShape[0];
-        int64_t KernelHeight = KernelShape[1];
-        int64_t KernelWidth = KernelShape[2];
+        for (size_t i = 0; i < Count; i++) {
+            Float[i] = (i % 37 == 36) ? Limits[(i / 37) % 4] : float(int(i % 601) - 300) * 0.75f;
+        }
 
-        int64_t PaddingLeftZ = Padding[0];
-        int64_t PaddingLeftY = Padding[1];
-        int64_t PaddingLeftX = Padding[2];
-        int64_t PaddingRightZ = Padding[3];
-        int64_t PaddingRightY = Padding[4];
-        int64_t PaddingRightX = Padding[5];
+        if (std::is_signed<T>::value) {
+            MlasConvertFloatToInt8Buffer(Float, reinterpret_cast<int8_t*>(Integer), Count);
+        } else {
+            MlasConvertFloatToUInt8Buffer(Float, reinterpret_cast<uint8_t*>(Integer), Count);
+        }
 
-        int64_t StrideDepth = StrideShape[0];
-        int64_t StrideHeight = StrideShape[1];
-        int64_t StrideWidth = StrideShape[2];
+        const float MinimumValue = float(std::numeric_limits<T>::min());
+        const float MaximumValue = float(std::numeric_limits<T>::max());
 
-        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        for (size_t i = 0; i < Count; i++) {
+            T Expected = T(std::trunc(std::min(std::max(Float[i], MinimumValue), MaximumValue)));
+            if (Integer[i] != Expected) {
+                printf("mismatch ConvertFloatToInteger: signed=%d Count=%zd i=%zd %g %d %d\n",
+                    int(std::is_signed<T>::value), Count, i, Float[i], int(Integer[i]), int(Expected));
+                return;
+            }
+        }
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        for (size_t i = 0; i < Count; i++) {
+            Integer[i] = T(i * 13 + 5);
+        }
 
-            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+        if (std::is_signed<T>::value) {
+            MlasConvertInt8ToFloatBuffer(reinterpret_cast<int8_t*>(Integer), FloatOutput, Count);
+        } else {
+            MlasConvertUInt8ToFloatBuffer(reinterpret_cast<uint8_t*>(Integer), FloatOutput, Count);
+        }
 
-                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
-                int64_t idEnd = idStart + KernelDepth;
+        for (size_t i = 0; i < Count; i++) {
+            if (FloatOutput[i] != float(Integer[i])) {
+                printf("mismatch ConvertIntegerToFloat: signed=%d Count=%zd i=%zd %d %g\n",
+                    int(std::is_signed<T>::value), Count, i, int(Integer[i]), FloatOutput[i]);
+                return;
+            }
+        }
+    }
 
-                idStart = (std::max)(idStart, int64_t(0));
-                idEnd = (std::min)(idEnd, InputDepth);
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t Count = 1; Count <= 48; Count++) {
+            TestHalf(Count);
+            TestInteger(BufferInt8, Count);
+            TestInteger(BufferUInt8, Count);
+        }
 
-                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+        TestHalf(65536);
+        TestHalfRounding();
+        TestInteger(BufferInt8, 10000);
+        TestInteger(BufferUInt8, 10000);
+    }
 
-                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                    int64_t ihEnd = ihStart + KernelHeight;
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-                    ihStart = (std::max)(ihStart, int64_t(0));
-                    ihEnd = (std::min)(ihEnd, InputHeight);
+class MlasFindMinMaxElementTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
 
-                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+    void
+    Test(
+        size_t N
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
 
-                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                        int64_t iwEnd = iwStart + KernelWidth;
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = float(int((n * 7919) % 211) - 100) * 0.25f;
+        }
 
-                        iwStart = (std::max)(iwStart, int64_t(0));
-                        iwEnd = (std::min)(iwEnd, InputWidth);
+        float MinimumReference = std::numeric_limits<float>::max();
+        float MaximumReference = std::numeric_limits<float>::lowest();
 
-                        float m = std::numeric_limits<float>::lowest();
+        for (size_t n = 0; n < N; n++) {
+            MinimumReference = std::min(MinimumReference, Input[n]);
+            MaximumReference = std::max(MaximumReference, Input[n]);
+        }
 
-                        for (int64_t id = idStart; id < idEnd; id++) {
-                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                                    m = (std::max)(m, Input[id * InputHeight * InputWidth + ih * InputWidth + iw]);
-                                }
-                            }
-                        }
+        float Minimum;
+        float Maximum;
 
-                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
-                    }
-                }
-            }
+        MlasFindMinMaxElement(Input, &Minimum, &Maximum, N);
 
-            Input += InputDepth * InputHeight * InputWidth;
-            Output += OutputDepth * OutputHeight * OutputWidth;
+        if (Minimum != MinimumReference || Maximum != MaximumReference) {
+            printf("mismatch FindMinMaxElement: N=%zd %f %f %f %f\n", N, Minimum, MinimumReference, Maximum,
+                MaximumReference);
         }
     }
 
+public:
     void
-    ReferenceAveragePool3D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output,
-        bool CountIncludePad
-        )
+    ExecuteShort(
+        void
+        ) override
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
-
-        int64_t InputDepth = InputShape[2];
-        int64_t InputHeight = InputShape[3];
-        int64_t InputWidth = InputShape[4];
+        for (size_t n = 0; n < 64; n++) {
+            Test(n);
+        }
+        for (size_t n = 64; n <= 65536; n <<= 2) {
+            Test(n - 1);
+            Test(n + 3);
+        }
+    }
 
-        int64_t KernelDepth = KernelShape[0];
-        int64_t KernelHeight = KernelShape[1];
-        int64_t KernelWidth = KernelShape[2];
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-        int64_t PaddingLeftZ = Padding[0];
-        int64_t PaddingLeftY = Padding[1];
-        int64_t PaddingLeftX = Padding[2];
-        int64_t PaddingRightZ = Padding[3];
-        int64_t PaddingRightY = Padding[4];
-        int64_t PaddingRightX = Padding[5];
+template<typename QuantInt>
+class MlasQuantizeLinearTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<QuantInt> BufferQuantized;
+    MatrixGuardBuffer<float> BufferDequantized;
 
-        int64_t StrideDepth = StrideShape[0];
-        int64_t StrideHeight = StrideShape[1];
-        int64_t StrideWidth = StrideShape[2];
+    void
+    Test(
+        size_t N
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        QuantInt* Quantized = BufferQuantized.GetBuffer(N);
+        float* Dequantized = BufferDequantized.GetBuffer(N);
 
-        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        //
+        // The values extend past the quantized range to test saturation.
+        //
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        const float Scale = 0.5f;
+        const QuantInt ZeroPoint = std::is_signed<QuantInt>::value ? QuantInt(-3) : QuantInt(117);
+        const int32_t MinimumValue = std::is_signed<QuantInt>::value ? -127 : 0;
+        const int32_t MaximumValue = std::is_signed<QuantInt>::value ? 127 : 255;
 
-            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = float(int((n * 7919) % 701) - 350) * 0.375f;
+        }
 
-                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
-                int64_t idEnd = idStart + KernelDepth;
+        MlasQuantizeLinear(Input, Quantized, N, Scale, ZeroPoint);
+
+        for (size_t n = 0; n < N; n++) {
+            float FloatValue = std::nearbyintf(Input[n] / Scale) + float(ZeroPoint);
+            FloatValue = std::max(FloatValue, float(MinimumValue));
+            FloatValue = std::min(FloatValue, float(MaximumValue));
+            QuantInt QuantizedReference = QuantInt(FloatValue);
+            if (Quantized[n] != QuantizedReference) {
+                printf("mismatch QuantizeLinear: N=%zd n=%zd %d %d\n", N, n, int(Quantized[n]),
+                    int(QuantizedReference));
+                break;
+            }
+        }
 
-                idStart = (std::max)(idStart, int64_t(0));
-                idEnd = (std::min)(idEnd, InputDepth);
+        MlasDequantizeLinear(Quantized, Dequantized, N, Scale, ZeroPoint);
 
-                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+        for (size_t n = 0; n < N; n++) {
+            float DequantizedReference = float(int32_t(Quantized[n]) - int32_t(ZeroPoint)) * Scale;
+            if (Dequantized[n] != DequantizedReference) {
+                printf("mismatch DequantizeLinear: N=%zd n=%zd %f %f\n", N, n, Dequantized[n],
+                    DequantizedReference);
+                break;
+            }
+        }
+    }
 
-                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                    int64_t ihEnd = ihStart + KernelHeight;
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 0; n < 80; n++) {
+            Test(n);
+        }
+        for (size_t n = 128; n <= 65536; n <<= 2) {
+            Test(n - 1);
+            Test(n + 5);
+        }
+    }
 
-                    ihStart = (std::max)(ihStart, int64_t(0));
-                    ihEnd = (std::min)(ihEnd, InputHeight);
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+class MlasQLinearBinaryOpTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint8_t> BufferInputA;
+    MatrixGuardBuffer<uint8_t> BufferInputB;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
 
-                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                        int64_t iwEnd = iwStart + KernelWidth;
+    void
+    Test(
+        bool IsMul,
+        size_t N,
+        bool IsScalarB,
+        float ScaleA,
+        uint8_t ZeroPointA,
+        float ScaleB,
+        uint8_t ZeroPointB,
+        float ScaleC,
+        uint8_t ZeroPointC
+        )
+    {
+        uint8_t* InputA = BufferInputA.GetBuffer(N);
+        uint8_t* InputB = BufferInputB.GetBuffer(IsScalarB ? 1 : N);
+        uint8_t* Output = BufferOutput.GetBuffer(N);
 
-                        iwStart = (std::max)(iwStart, int64_t(0));
-                        iwEnd = (std::min)(iwEnd, InputWidth);
+        for (size_t n = 0; n < N; n++) {
+            InputA[n] = uint8_t((n * 7919) % 256);
+        }
+        for (size_t n = 0; n < (IsScalarB ? 1 : N); n++) {
+            InputB[n] = uint8_t((n * 104729 + 17) % 256);
+        }
 
-                        float m = 0.0f;
+        if (IsMul) {
+            MlasQLinearMul(InputA, ScaleA, ZeroPointA, InputB, ScaleB, ZeroPointB, ScaleC, ZeroPointC, Output, N, IsScalarB);
+        } else {
+            MlasQLinearAdd(InputA, ScaleA, ZeroPointA, InputB, ScaleB, ZeroPointB, ScaleC, ZeroPointC, Output, N, IsScalarB);
+        }
 
-                        for (int64_t id = idStart; id < idEnd; id++) {
-                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                                    m += Input[id * InputHeight * InputWidth + ih * InputWidth + iw];
-                                }
-                            }
-                        }
+        for (size_t n = 0; n < N; n++) {
 
-                        if (CountIncludePad) {
-                            m /= (KernelDepth * KernelHeight * KernelWidth);
-                        } else {
-                            m /= (idEnd - idStart) * (ihEnd - ihStart) * (iwEnd - iwStart);
-                        }
+            const double ValueA = ScaleA * (double(InputA[n]) - ZeroPointA);
+            const double ValueB = ScaleB * (double(InputB[IsScalarB ? 0 : n]) - ZeroPointB);
+            const double Value = (IsMul ? ValueA * ValueB : ValueA + ValueB) / ScaleC + ZeroPointC;
+            const int32_t Reference = int32_t(std::min(255.0, std::max(0.0, std::nearbyint(Value))));
 
-                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
-                    }
-                }
+            // allow for the rounding of values close to the middle of two integers in single precision
+            if (std::abs(int32_t(Output[n]) - Reference) > 1) {
+                printf("mismatch QLinear%s: N=%zd n=%zd %d %d\n", IsMul ? "Mul" : "Add", N, n, int(Output[n]),
+                    int(Reference));
+                break;
             }
-
-            Input += InputDepth * InputHeight * InputWidth;
-            Output += OutputDepth * OutputHeight * OutputWidth;
         }
     }
 
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
-
 public:
     void
     ExecuteShort(
         void
         ) override
     {
-        for (unsigned i = 1; i < 64; i <<= 1) {
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 2, 2, 2);
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, i, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, 1, i, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+        for (size_t n = 1; n < 80; n++) {
+            Test(false, n, false, 0.05f, 128, 0.02f, 100, 0.07f, 120);
+            Test(false, n, true, 0.05f, 128, 0.02f, 100, 0.07f, 120);
+            Test(true, n, false, 0.05f, 128, 0.02f, 100, 0.03f, 10);
+            Test(true, n, true, 0.05f, 128, 0.02f, 100, 0.03f, 10);
         }
+        Test(false, 1003, false, 0.5f, 0, 0.25f, 255, 0.1f, 0);
+        Test(true, 1003, false, 0.5f, 0, 0.25f, 255, 0.1f, 255);
     }
 
     void
@@ -1835,132 +4180,122 @@ public:
         void
         ) override
     {
-        static const unsigned is[] = { 11, 5, 4, 3, 2, 1 };
+    }
+};
 
-        for (unsigned id = 0; id < _countof(is); id++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", is[id], is[ih], is[iw]);
-                    Test(1, 1, is[id], is[ih], is[iw], is[id], is[ih], is[iw], 0, 0, 0, 0, 0, 0, 1, 1, 1);
-                    for (unsigned kd = 1; kd <= 4; kd++) {
-                        if (kd > is[id]) break;
-                        for (unsigned kh = 1; kh <= 4; kh++) {
-                            if (kh > is[ih]) break;
-                            for (unsigned kw = 1; kw <= 4; kw++) {
-                                if (kw > is[iw]) break;
-                                for (unsigned sd = 1; sd <= 3; sd++) {
-                                    for (unsigned sh = 1; sh <= 3; sh++) {
-                                        for (unsigned sw = 1; sw <= 3; sw++) {
-                                            for (unsigned p0 = 0; p0 < kd; p0++) {
-                                                for (unsigned p1 = 0; p1 < kh; p1++) {
-                                                    for (unsigned p2 = 0; p2 < kw; p2++) {
-                                                        for (unsigned p3 = 0; p3 < kd; p3++) {
-                                                            for (unsigned p4 = 0; p4 < kh; p4++) {
-                                                                for (unsigned p5 = 0; p5 < kw; p5++) {
-                                                                    Test(1, 1, is[id], is[ih], is[iw], kd, kh, kw, p0, p1, p2, p3, p4, p5, sd, sh, sw);
-                                                                }
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+class MlasQLinearGlobalAveragePoolTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<uint8_t> BufferInput;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+
+    void
+    Test(
+        size_t Channels,
+        size_t ImageSize,
+        float ScaleInput,
+        uint8_t ZeroPointInput,
+        float ScaleOutput,
+        uint8_t ZeroPointOutput
+        )
+    {
+        uint8_t* Input = BufferInput.GetBuffer(Channels * ImageSize);
+        uint8_t* Output = BufferOutput.GetBuffer(Channels);
+
+        for (size_t n = 0; n < Channels * ImageSize; n++) {
+            Input[n] = uint8_t((n * 7919 + n / 13) % 256);
+        }
+
+        MlasQLinearGlobalAveragePool(Input, ScaleInput, ZeroPointInput, Output, ScaleOutput, ZeroPointOutput,
+            Channels, ImageSize);
+
+        for (size_t c = 0; c < Channels; c++) {
+
+            int64_t Sum = 0;
+            for (size_t n = 0; n < ImageSize; n++) {
+                Sum += Input[c * ImageSize + n];
+            }
+
+            const double Mean = double(Sum) / ImageSize - ZeroPointInput;
+            const double Value = std::nearbyint(Mean * ScaleInput / ScaleOutput) + ZeroPointOutput;
+            const int32_t Reference = int32_t(std::min(255.0, std::max(0.0, Value)));
+
+            if (std::abs(int32_t(Output[c]) - Reference) > 1) {
+                printf("mismatch QLinearGlobalAveragePool: C=%zd ImageSize=%zd c=%zd %d %d\n", Channels, ImageSize,
+                    c, int(Output[c]), int(Reference));
+                break;
             }
         }
     }
-};
 
-class MlasActivationTest : public MlasTestBase
-{
 public:
     void
     ExecuteShort(
         void
         ) override
     {
-        union AliasedValue {
-            unsigned u;
-            float f;
-        };
-
-        // N.B. The test data includes values at the edge of Tanh/Logistic boundaries.
-        //    Identity,     Relu,         LeakyRelu,    Tanh,         Logistic,     Clip,
-        static const AliasedValue TestData[20][6] = {
-            { {0x00000001}, {0x00000001}, {0x00000001}, {0x00000000}, {0x3f000000}, {0x00000001}, }, // positive denormal
-            { {0x80000001}, {0x00000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x00000000}, }, // negative denormal
-            { {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, }, // positive NaN
-            { {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, }, // negative NaN
-            { {0x00000000}, {0x00000000}, {0x00000000}, {0x00000000}, {0x3f000000}, {0x00000000}, }, // 0.0f
-            { {0x80000000}, {0x80000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x80000000}, }, // -0.0f
-            { {0x3e800000}, {0x3e800000}, {0x3e800000}, {0x3e7acbf5}, {0x3f0feacc}, {0x3e800000}, }, // 0.25f
-            { {0xbe800000}, {0x00000000}, {0xbd4ccccd}, {0xbe7acbf5}, {0x3ee02a67}, {0x00000000}, }, // -0.25f
-            { {0x40800000}, {0x40800000}, {0x40800000}, {0x3f7fd40a}, {0x3f7b6541}, {0x40800000}, }, // 4.0f
-            { {0xc0800000}, {0x00000000}, {0xbf4ccccd}, {0xbf7fd40a}, {0x3c9357e0}, {0x00000000}, }, // -4.0f
-            { {0x41200000}, {0x41200000}, {0x41200000}, {0x3f800000}, {0x3f7ffd06}, {0x40c00000}, }, // 10.0f
-            { {0xc1200000}, {0x00000000}, {0xc0000000}, {0xbf800000}, {0x383e6000}, {0x00000000}, }, // -10.0f
-            { {0xc18866eb}, {0x00000000}, {0xc05a3e45}, {0xbf800000}, {0x33000000}, {0x00000000}, }, // -17.0502529144f
-            { {0xc18869bb}, {0x00000000}, {0xc05a42c5}, {0xbf800000}, {0x33c00000}, {0x00000000}, }, // -17.0516262054f
-            { {0xc18852a8}, {0x00000000}, {0xc05a1dda}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0403594971f
-            { {0xc18844aa}, {0x00000000}, {0xc05a0777}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0335273743f
-            { {0x418866eb}, {0x418866eb}, {0x418866eb}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0502529144f
-            { {0x418869bb}, {0x418869bb}, {0x418869bb}, {0x3f800000}, {0x3f7ffffe}, {0x40c00000}, }, // +17.0516262054f
-            { {0x418852a8}, {0x418852a8}, {0x418852a8}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0403594971f
-            { {0x418844aa}, {0x418844aa}, {0x418844aa}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0335273743f
-        };
-
-        MLAS_ACTIVATION Activation;
-        AliasedValue Buffer[_countof(TestData)];
+        for (size_t ImageSize = 1; ImageSize < 40; ImageSize++) {
+            Test(3, ImageSize, 0.1f, 128, 0.05f, 128);
+        }
+        Test(64, 7 * 7, 0.02f, 0, 0.01f, 0);
+        Test(16, 56 * 56, 0.5f, 100, 0.25f, 130);
+        Test(2, 1 << 20, 1.0f, 255, 1.0f, 255);
+    }
 
-        for (unsigned kind = 0; kind < unsigned(MlasClipActivation); kind++) {
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-            Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
+class MlasSgemmAutotuningTest : public MlasTestBase
+{
+private:
+    static
+    size_t
+    CountCacheEntries(
+        const char* CacheFilePath
+        )
+    {
+        std::ifstream File(CacheFilePath);
+        std::string Line;
+        size_t Count = 0;
 
-            if (Activation.ActivationKind == MlasLeakyReluActivation) {
-                Activation.Parameters.LeakyRelu.alpha = 0.2f;
-            } else if (Activation.ActivationKind == MlasClipActivation) {
-                Activation.Parameters.Clip.minimum = 0.0f;
-                Activation.Parameters.Clip.maximum = 6.0f;
-            }
+        while (std::getline(File, Line)) {
+            Count++;
+        }
 
-            //
-            // Test the vectorized activations.
-            //
+        return Count;
+    }
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                Buffer[i].u = TestData[i][0].u;
-            }
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        static const char* CacheFilePath = "mlas_sgemm_autotuning_cache.txt";
 
-            MlasActivation(&Activation, &Buffer[0].f, nullptr, _countof(Buffer), 1, 1);
+        std::remove(CacheFilePath);
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                // Sensitive to comparing positive/negative zero and NaNs.
-                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
-                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
-                }
-            }
+        // Damaged lines are ignored when the cache file is loaded.
+        std::ofstream(CacheFilePath) << "garbage\n1 1 64\n0 0 256 256 256 1 65536 65536 1 0\n";
 
-            //
-            // Test the scalar activations.
-            //
+        MlasGemmEnableAutotuning(CacheFilePath);
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                Buffer[i].u = TestData[i][0].u;
-                MlasActivation(&Activation, &Buffer[i].f, nullptr, 1, 1, 1);
-            }
+        // The first pass tunes each shape and the second uses the cached parameters.
+        for (int i = 0; i < 2; i++) {
+            onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+            onnxruntime::make_unique<MlasSgemmOutputStageTest<false>>()->ExecuteShort();
+        }
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                // Sensitive to comparing positive/negative zero and NaNs.
-                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
-                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
-                }
-            }
+        if (CountCacheEntries(CacheFilePath) <= 3) {
+            printf("autotuning cache %s has no entries!\n", CacheFilePath);
         }
+
+        std::remove(CacheFilePath);
     }
 
     void
@@ -1983,6 +4318,19 @@ main(
 
         printf("SGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasFgemmTest<float, true>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmOutputStageTest<false>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmOutputStageTest<true>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmBatchTest>()->ExecuteShort();
+
+        printf("BF16GEMM tests.\n");
+        onnxruntime::make_unique<MlasBf16GemmTest>()->ExecuteShort();
+
+        printf("HALFGEMM tests.\n");
+        onnxruntime::make_unique<MlasHalfGemmTest>()->ExecuteShort();
+
+        printf("SPGEMM tests.\n");
+        onnxruntime::make_unique<MlasSparseGemmTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
         printf("DGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
@@ -1992,13 +4340,29 @@ main(
         printf("QGEMM tests.\n");
         onnxruntime::make_unique<MlasQgemmU8X8Test<int8_t>>()->ExecuteShort();
         onnxruntime::make_unique<MlasQgemmU8X8Test<uint8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasQgemmU8X8OutputStageTest<int8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasQgemmU8X8OutputStageTest<uint8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasQgemmU8X8QuantizedOutputTest<int8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasQgemmU8X8QuantizedOutputTest<uint8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasFindMinMaxElementTest>()->ExecuteShort();
 #endif
 
+        printf("QuantizeLinear tests.\n");
+        onnxruntime::make_unique<MlasQuantizeLinearTest<int8_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasQuantizeLinearTest<uint8_t>>()->ExecuteShort();
+
+        printf("QLinearBinaryOp tests.\n");
+        onnxruntime::make_unique<MlasQLinearBinaryOpTest>()->ExecuteShort();
+
+        printf("QLinearGlobalAveragePool tests.\n");
+        onnxruntime::make_unique<MlasQLinearGlobalAveragePoolTest>()->ExecuteShort();
+
         printf("Conv2D tests.\n");
         onnxruntime::make_unique<MlasConv2DTest>()->ExecuteShort();
         if (MlasNchwcGetBlockSize() > 1) {
           onnxruntime::make_unique<MlasNchwcConv2DTest>()->ExecuteShort();
         }
+        onnxruntime::make_unique<MlasWinogradConv2DTest>()->ExecuteShort();
 
         printf("Pool2D tests.\n");
         onnxruntime::make_unique<MlasPool2DTest>()->ExecuteShort();
@@ -2012,6 +4376,32 @@ main(
         printf("Activation tests.\n");
         onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Gelu tests.\n");
+        onnxruntime::make_unique<MlasGeluTest>()->ExecuteShort();
+
+        printf("LayerNorm tests.\n");
+        onnxruntime::make_unique<MlasLayerNormTest>()->ExecuteShort();
+
+        printf("Normalize tests.\n");
+        onnxruntime::make_unique<MlasNormalizeTest>()->ExecuteShort();
+
+        printf("Transcendental tests.\n");
+        onnxruntime::make_unique<MlasTranscendentalTest>()->ExecuteShort();
+
+        printf("Softmax tests.\n");
+        onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+        if (MlasNchwcGetBlockSize() > 1) {
+          printf("ReorderNhwc tests.\n");
+          onnxruntime::make_unique<MlasReorderNhwcTest>()->ExecuteShort();
+        }
+
+        printf("Transpose tests.\n");
+        onnxruntime::make_unique<MlasTransposeTest>()->ExecuteShort();
+
+        printf("Convert tests.\n");
+        onnxruntime::make_unique<MlasConvertTest>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
@@ -2019,6 +4409,11 @@ main(
         break;
 #endif
 	}
+
+    // The autotuning stays enabled for the process, so it is tested last.
+    printf("SGEMM autotuning tests.\n");
+    onnxruntime::make_unique<MlasSgemmAutotuningTest>()->ExecuteShort();
+
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
     delete threadpool;
 #endif
@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Microbenchmarks of the hot CPU kernels. Each benchmark runs a model with a single node through an
+// InferenceSession, so the numbers include the executor overhead of one node but not the model loading.
+// The last argument of each benchmark is intra_op_num_threads.
+// Run with --benchmark_out=<file> --benchmark_out_format=json to record the results for regression tracking.
+
+#include <benchmark/benchmark.h>
+#include <core/common/make_unique.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/inference_session.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace onnxruntime;
+
+namespace {
+
+const int kThreadCounts[] = {1, 4};
+
+class SingleNodeModel {
+ public:
+  SingleNodeModel(const std::string& op_type, const std::string& domain = "", int opset_version = 11) {
+    model_.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+    auto* opset = model_.add_opset_import();
+    opset->set_domain(domain);
+    opset->set_version(opset_version);
+    auto* graph = model_.mutable_graph();
+    graph->set_name("benchmark");
+    node_ = graph->add_node();
+    node_->set_op_type(op_type);
+    node_->set_domain(domain);
+  }
+
+  // A float graph input with random values between -10 and 10.
+  SingleNodeModel& AddInput(const std::string& name, const std::vector<int64_t>& dims) {
+    auto* input = model_.mutable_graph()->add_input();
+    input->set_name(name);
+    auto* tensor_type = input->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    node_->add_input(name);
+
+    std::unique_ptr<Tensor> tensor = onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(),
+                                                                      TensorShape(dims), allocator_);
+    std::minstd_rand engine(static_cast<std::minstd_rand::result_type>(feeds_.size()));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+    float* data = tensor->MutableData<float>();
+    for (int64_t i = 0, size = tensor->Shape().Size(); i < size; i++) {
+      data[i] = distribution(engine);
+    }
+    OrtValue value;
+    value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    feed_names_.push_back(name);
+    feeds_.push_back(value);
+    return *this;
+  }
+
+  // A float initializer with all the elements set to value.
+  SingleNodeModel& AddInitializer(const std::string& name, const std::vector<int64_t>& dims, float value) {
+    auto* initializer = model_.mutable_graph()->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      initializer->add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; i++) {
+      initializer->add_float_data(value);
+    }
+    node_->add_input(name);
+    return *this;
+  }
+
+  // An int64 initializer, for indices and other constant inputs.
+  SingleNodeModel& AddInt64Initializer(const std::string& name, const std::vector<int64_t>& dims,
+                                       const std::vector<int64_t>& values) {
+    auto* initializer = model_.mutable_graph()->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    for (auto dim : dims) {
+      initializer->add_dims(dim);
+    }
+    for (auto value : values) {
+      initializer->add_int64_data(value);
+    }
+    node_->add_input(name);
+    return *this;
+  }
+
+  SingleNodeModel& AddOutput(const std::string& name,
+                             ONNX_NAMESPACE::TensorProto_DataType type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    auto* output = model_.mutable_graph()->add_output();
+    output->set_name(name);
+    output->mutable_type()->mutable_tensor_type()->set_elem_type(type);
+    node_->add_output(name);
+    output_names_.push_back(name);
+    return *this;
+  }
+
+  SingleNodeModel& AddAttribute(const std::string& name, int64_t value) {
+    auto* attribute = node_->add_attribute();
+    attribute->set_name(name);
+    attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+    attribute->set_i(value);
+    return *this;
+  }
+
+  SingleNodeModel& AddAttribute(const std::string& name, float value) {
+    auto* attribute = node_->add_attribute();
+    attribute->set_name(name);
+    attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_FLOAT);
+    attribute->set_f(value);
+    return *this;
+  }
+
+  SingleNodeModel& AddAttribute(const std::string& name, const std::vector<int64_t>& values) {
+    auto* attribute = node_->add_attribute();
+    attribute->set_name(name);
+    attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INTS);
+    for (auto value : values) {
+      attribute->add_ints(value);
+    }
+    return *this;
+  }
+
+  // Create a session for the model and time its runs.
+  void Run(benchmark::State& state, int64_t intra_op_num_threads) {
+    SessionOptions so;
+    so.session_logid = "cpu_kernel_benchmark";
+    so.intra_op_num_threads = static_cast<int>(intra_op_num_threads);
+    InferenceSession session{so};
+
+    std::string model_data;
+    model_.SerializeToString(&model_data);
+    std::unique_ptr<InferenceSession::PreparedRun> prepared_run;
+    auto status = session.Load(model_data.data(), static_cast<int>(model_data.size()));
+    if (status.IsOK()) {
+      status = session.Initialize();
+    }
+    if (status.IsOK()) {
+      status = session.PrepareRun(feed_names_, output_names_, prepared_run);
+    }
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+
+    RunOptions run_options;
+    int64_t bytes = 0;
+    for (const auto& feed : feeds_) {
+      bytes += static_cast<int64_t>(feed.Get<Tensor>().SizeInBytes());
+    }
+    // the fetches of the previous run are reused as preallocated outputs, so the outputs are only allocated once
+    std::vector<OrtValue> fetches;
+    for (auto _ : state) {
+      status = session.Run(run_options, *prepared_run, feeds_, &fetches);
+      if (!status.IsOK()) {
+        state.SkipWithError(status.ErrorMessage().c_str());
+        break;
+      }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+  }
+
+ private:
+  ONNX_NAMESPACE::ModelProto model_;
+  ONNX_NAMESPACE::NodeProto* node_;
+  AllocatorPtr allocator_ = std::make_shared<CPUAllocator>();
+  std::vector<std::string> feed_names_;
+  std::vector<OrtValue> feeds_;
+  std::vector<std::string> output_names_;
+};
+
+// N rows of D elements, threads
+void RowArgs(benchmark::internal::Benchmark* b) {
+  const int64_t shapes[][2] = {{1, 1000}, {128, 128}, {1536, 128}, {128, 768}, {4096, 1024}};
+  for (const auto& shape : shapes) {
+    for (int threads : kThreadCounts) {
+      b->Args({shape[0], shape[1], threads});
+    }
+  }
+  b->ArgNames({"N", "D", "threads"});
+}
+
+void BM_Softmax(benchmark::State& state, const char* op_type) {
+  SingleNodeModel model(op_type);
+  model.AddInput("X", {state.range(0), state.range(1)}).AddOutput("Y").AddAttribute("axis", int64_t{1});
+  model.Run(state, state.range(2));
+}
+BENCHMARK_CAPTURE(BM_Softmax, Softmax, "Softmax")->Apply(RowArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Softmax, LogSoftmax, "LogSoftmax")->Apply(RowArgs)->UseRealTime();
+
+void BM_LayerNormalization(benchmark::State& state) {
+  const int64_t D = state.range(1);
+  SingleNodeModel model("LayerNormalization", "", 1);
+  model.AddInput("X", {state.range(0), D})
+      .AddInitializer("scale", {D}, 1.0f)
+      .AddInitializer("B", {D}, 0.0f)
+      .AddOutput("Y")
+      .AddAttribute("axis", int64_t{-1})
+      .AddAttribute("epsilon", 1e-5f);
+  model.Run(state, state.range(2));
+}
+BENCHMARK(BM_LayerNormalization)->Apply(RowArgs)->UseRealTime();
+
+// shape, perm. The argument is the thread count.
+void BM_Transpose(benchmark::State& state, std::vector<int64_t> dims, std::vector<int64_t> perm) {
+  SingleNodeModel model("Transpose");
+  model.AddInput("X", dims).AddOutput("Y").AddAttribute("perm", perm);
+  model.Run(state, state.range(0));
+}
+// NCHW to NHWC, the attention head split of BERT base and a plain 2D transpose
+BENCHMARK_CAPTURE(BM_Transpose, NCHW_NHWC, std::vector<int64_t>{1, 64, 112, 112}, std::vector<int64_t>{0, 2, 3, 1})
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Transpose, AttentionHeads, std::vector<int64_t>{8, 128, 12, 64}, std::vector<int64_t>{0, 2, 1, 3})
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Transpose, Matrix, std::vector<int64_t>{1024, 1024}, std::vector<int64_t>{1, 0})
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+
+// rows and columns of the data, number of indices, axis, threads
+void BM_Gather(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  const int64_t columns = state.range(1);
+  const int64_t index_count = state.range(2);
+  const int64_t axis = state.range(3);
+  const int64_t axis_size = axis == 0 ? rows : columns;
+
+  std::vector<int64_t> indices(static_cast<size_t>(index_count));
+  std::minstd_rand engine(0);
+  std::uniform_int_distribution<int64_t> distribution(0, axis_size - 1);
+  for (auto& index : indices) {
+    index = distribution(engine);
+  }
+
+  SingleNodeModel model("Gather");
+  model.AddInput("data", {rows, columns})
+      .AddInt64Initializer("indices", {index_count}, indices)
+      .AddOutput("output")
+      .AddAttribute("axis", axis);
+  model.Run(state, state.range(4));
+}
+BENCHMARK(BM_Gather)
+    ->Args({30522, 768, 128, 0, 1})  // BERT word embedding lookup
+    ->Args({30522, 768, 128, 0, 4})
+    ->Args({4096, 1024, 512, 1, 1})
+    ->Args({4096, 1024, 512, 1, 4})
+    ->ArgNames({"rows", "columns", "indices", "axis", "threads"})
+    ->UseRealTime();
+
+// rows, elements per row, k, threads
+void BM_TopK(benchmark::State& state) {
+  SingleNodeModel model("TopK");
+  model.AddInput("X", {state.range(0), state.range(1)})
+      .AddInt64Initializer("K", {1}, {state.range(2)})
+      .AddOutput("Values")
+      .AddOutput("Indices", ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  model.Run(state, state.range(3));
+}
+BENCHMARK(BM_TopK)
+    ->Args({1, 1000, 5, 1})  // image classification
+    ->Args({1, 30522, 10, 1})
+    ->Args({64, 4096, 10, 1})
+    ->Args({64, 4096, 10, 4})
+    ->Args({64, 4096, 1000, 4})
+    ->ArgNames({"N", "D", "k", "threads"})
+    ->UseRealTime();
+
+// shape, axes. The last argument is the thread count.
+void BM_Reduce(benchmark::State& state, const char* op_type, std::vector<int64_t> dims, std::vector<int64_t> axes) {
+  SingleNodeModel model(op_type);
+  model.AddInput("X", dims).AddOutput("Y").AddAttribute("axes", axes).AddAttribute("keepdims", int64_t{1});
+  model.Run(state, state.range(0));
+}
+#define REDUCE_BENCHMARK(op_type)                                                                        \
+  BENCHMARK_CAPTURE(BM_Reduce, op_type##_LastAxis, #op_type, std::vector<int64_t>{128, 768},             \
+                    std::vector<int64_t>{1})                                                             \
+      ->Arg(1)                                                                                           \
+      ->Arg(4)                                                                                           \
+      ->UseRealTime();                                                                                   \
+  BENCHMARK_CAPTURE(BM_Reduce, op_type##_FirstAxis, #op_type, std::vector<int64_t>{128, 768},            \
+                    std::vector<int64_t>{0})                                                             \
+      ->Arg(1)                                                                                           \
+      ->Arg(4)                                                                                           \
+      ->UseRealTime();                                                                                   \
+  BENCHMARK_CAPTURE(BM_Reduce, op_type##_Spatial, #op_type, std::vector<int64_t>{1, 256, 56, 56},        \
+                    std::vector<int64_t>{2, 3})                                                          \
+      ->Arg(1)                                                                                           \
+      ->Arg(4)                                                                                           \
+      ->UseRealTime()
+REDUCE_BENCHMARK(ReduceSum);
+REDUCE_BENCHMARK(ReduceMean);
+REDUCE_BENCHMARK(ReduceMax);
+
+}  // namespace
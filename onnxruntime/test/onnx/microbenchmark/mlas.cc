@@ -0,0 +1,483 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Microbenchmarks of the MLAS kernels, called directly so the numbers don't include any framework overhead.
+// The last argument of each benchmark is the number of threads, with the same meaning as intra_op_num_threads.
+// Run with --benchmark_out=<file> --benchmark_out_format=json to record the results for regression tracking.
+
+#include <benchmark/benchmark.h>
+#include <core/mlas/inc/mlas.h>
+#include <core/util/thread_utils.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace onnxruntime;
+
+namespace {
+
+const int kThreadCounts[] = {1, 4};
+
+std::unique_ptr<concurrency::ThreadPool> CreateThreadPool(const benchmark::State& state, int thread_count_arg) {
+  return concurrency::CreateThreadPool("mlas_benchmark", static_cast<int>(state.range(thread_count_arg)));
+}
+
+template <typename T>
+std::vector<T> RandomBuffer(size_t count, int low = -10, int high = 10) {
+  std::minstd_rand engine(static_cast<std::minstd_rand::result_type>(count));
+  std::uniform_int_distribution<int> distribution(low, high);
+  std::vector<T> buffer(count);
+  for (auto& value : buffer) {
+    value = static_cast<T>(distribution(engine));
+  }
+  return buffer;
+}
+
+// M, N, K, threads. Covers the square, skinny M (batch 1 fully connected) and tall K shapes of typical models.
+void GemmArgs(benchmark::internal::Benchmark* b) {
+  const int64_t shapes[][3] = {{1, 1024, 1024}, {1, 4096, 1024}, {64, 64, 64}, {256, 256, 256},
+                               {1024, 1024, 1024}, {128, 3072, 768}, {196, 64, 576}, {3136, 64, 576}};
+  for (const auto& shape : shapes) {
+    for (int threads : kThreadCounts) {
+      b->Args({shape[0], shape[1], shape[2], threads});
+    }
+  }
+  b->ArgNames({"M", "N", "K", "threads"});
+}
+
+void SetGemmCounters(benchmark::State& state) {
+  state.counters["FLOPS"] = benchmark::Counter(2.0 * state.range(0) * state.range(1) * state.range(2),
+                                               benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T>
+void RunGemm(benchmark::State& state, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateThreadPool(state, 3);
+
+  auto A = RandomBuffer<T>(M * K);
+  auto B = RandomBuffer<T>(K * N);
+  std::vector<T> C(M * N);
+  const size_t lda = trans_a == CblasNoTrans ? K : M;
+  const size_t ldb = trans_b == CblasNoTrans ? N : K;
+
+  for (auto _ : state) {
+    MlasGemm(trans_a, trans_b, M, N, K, T(1), A.data(), lda, B.data(), ldb, T(0), C.data(), N, tp.get());
+  }
+  SetGemmCounters(state);
+}
+
+void BM_SGemm(benchmark::State& state, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b) {
+  RunGemm<float>(state, trans_a, trans_b);
+}
+BENCHMARK_CAPTURE(BM_SGemm, NN, CblasNoTrans, CblasNoTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_SGemm, NT, CblasNoTrans, CblasTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_SGemm, TN, CblasTrans, CblasNoTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_SGemm, TT, CblasTrans, CblasTrans)->Apply(GemmArgs)->UseRealTime();
+
+void BM_DGemm(benchmark::State& state, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b) {
+  RunGemm<double>(state, trans_a, trans_b);
+}
+BENCHMARK_CAPTURE(BM_DGemm, NN, CblasNoTrans, CblasNoTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DGemm, NT, CblasNoTrans, CblasTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DGemm, TN, CblasTrans, CblasNoTrans)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DGemm, TT, CblasTrans, CblasTrans)->Apply(GemmArgs)->UseRealTime();
+
+void BM_GemmPackedB(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateThreadPool(state, 3);
+
+  auto A = RandomBuffer<float>(M * K);
+  auto B = RandomBuffer<float>(K * N);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> packed_b(MlasGemmPackBSize(N, K));
+  MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed_b.data());
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, M, N, K, 1.0f, A.data(), K, packed_b.data(), 0.0f, C.data(), N, tp.get());
+  }
+  SetGemmCounters(state);
+}
+BENCHMARK(BM_GemmPackedB)->Apply(GemmArgs)->UseRealTime();
+
+void BM_Bf16Gemm(benchmark::State& state) {
+  if (!MlasBf16GemmIsAccelerated()) {
+    state.SkipWithError("bfloat16 GEMM is not accelerated on this platform");
+    return;
+  }
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateThreadPool(state, 3);
+
+  auto A = RandomBuffer<float>(M * K);
+  auto B = RandomBuffer<float>(K * N);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> packed_b(MlasBf16GemmPackBSize(N, K));
+  MlasBf16GemmPackB(CblasNoTrans, N, K, B.data(), N, packed_b.data());
+
+  for (auto _ : state) {
+    MlasBf16Gemm(M, N, K, 1.0f, A.data(), K, packed_b.data(), 0.0f, C.data(), N, tp.get());
+  }
+  SetGemmCounters(state);
+}
+BENCHMARK(BM_Bf16Gemm)->Apply(GemmArgs)->UseRealTime();
+
+void BM_HalfGemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateThreadPool(state, 3);
+
+  auto A = RandomBuffer<float>(M * K);
+  auto B = RandomBuffer<float>(K * N);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> packed_b(MlasHalfGemmPackBSize(N, K));
+  MlasHalfGemmPackB(CblasNoTrans, N, K, B.data(), N, packed_b.data());
+
+  for (auto _ : state) {
+    MlasHalfGemm(M, N, K, 1.0f, A.data(), K, packed_b.data(), 0.0f, C.data(), N, tp.get());
+  }
+  SetGemmCounters(state);
+}
+BENCHMARK(BM_HalfGemm)->Apply(GemmArgs)->UseRealTime();
+
+template <typename BType>
+void BM_QGemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  auto tp = CreateThreadPool(state, 3);
+
+  auto A = RandomBuffer<uint8_t>(M * K, 0, 255);
+  auto B = std::is_signed<BType>::value ? RandomBuffer<BType>(K * N, -128, 127) : RandomBuffer<BType>(K * N, 0, 255);
+  std::vector<int32_t> C(M * N);
+
+  for (auto _ : state) {
+    MlasGemm(M, N, K, A.data(), K, uint8_t(3), B.data(), N, BType(5), C.data(), N, tp.get());
+  }
+  SetGemmCounters(state);
+}
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t)->Apply(GemmArgs)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QGemm, uint8_t)->Apply(GemmArgs)->UseRealTime();
+
+// Conv arguments: batch, group, input channels per group, input height and width, filters per group, kernel size,
+// stride, threads. Padding keeps the output the size of the input divided by the stride.
+void ConvArgs(benchmark::internal::Benchmark* b) {
+  const int64_t shapes[][7] = {
+      {1, 1, 3, 224, 64, 7, 2},     // ResNet stem
+      {1, 1, 64, 56, 64, 3, 1},     // ResNet 3x3
+      {1, 1, 256, 56, 64, 1, 1},    // ResNet 1x1 bottleneck
+      {1, 1, 512, 14, 512, 3, 1},   // VGG late 3x3
+      {1, 128, 1, 56, 1, 3, 1},     // MobileNet depthwise
+      {8, 1, 64, 28, 128, 3, 1},    // batched
+  };
+  for (const auto& shape : shapes) {
+    for (int threads : kThreadCounts) {
+      b->Args({shape[0], shape[1], shape[2], shape[3], shape[4], shape[5], shape[6], threads});
+    }
+  }
+  b->ArgNames({"N", "G", "C", "HW", "F", "k", "s", "threads"});
+}
+
+void BM_Conv(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  const int64_t groups = state.range(1);
+  const int64_t channels = state.range(2);
+  const int64_t size = state.range(3);
+  const int64_t filters = state.range(4);
+  const int64_t kernel = state.range(5);
+  const int64_t stride = state.range(6);
+  auto tp = CreateThreadPool(state, 7);
+
+  const int64_t pad = kernel / 2;
+  const int64_t output_size = (size + 2 * pad - kernel) / stride + 1;
+  const int64_t input_shape[] = {size, size};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {output_size, output_size};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  MlasConvPrepare(&parameters, 2, static_cast<size_t>(batch), static_cast<size_t>(groups),
+                  static_cast<size_t>(channels), input_shape, kernel_shape, dilation_shape, padding, stride_shape,
+                  output_shape, static_cast<size_t>(filters), &activation, &working_buffer_size, 0.0f, tp.get());
+
+  auto input = RandomBuffer<float>(static_cast<size_t>(batch * groups * channels * size * size));
+  auto filter = RandomBuffer<float>(static_cast<size_t>(groups * filters * channels * kernel * kernel));
+  auto bias = RandomBuffer<float>(static_cast<size_t>(groups * filters));
+  std::vector<float> working_buffer(working_buffer_size);
+  std::vector<float> output(static_cast<size_t>(batch * groups * filters * output_size * output_size));
+
+  for (auto _ : state) {
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(), output.data(), tp.get());
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * batch * groups * filters * output_size * output_size * channels * kernel * kernel,
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_Conv)->Apply(ConvArgs)->UseRealTime();
+
+// Same shapes as BM_Conv with the channels rounded up to the NCHWc block size. The depthwise case has one channel
+// per group, which NCHWc handles as a grouped convolution over the whole channel block.
+void BM_NchwcConv(benchmark::State& state) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc kernels are not supported on this platform");
+    return;
+  }
+  auto round_up = [block_size](int64_t n) { return (n + block_size - 1) / block_size * block_size; };
+
+  const int64_t batch = state.range(0);
+  const int64_t groups = state.range(1);
+  const bool depthwise = groups > 1;
+  const int64_t channels = depthwise ? round_up(groups) : round_up(state.range(2));
+  const int64_t size = state.range(3);
+  const int64_t filters = depthwise ? channels : round_up(state.range(4));
+  const int64_t kernel = state.range(5);
+  const int64_t stride = state.range(6);
+  auto tp = CreateThreadPool(state, 7);
+
+  const int64_t pad = kernel / 2;
+  const int64_t output_size = (size + 2 * pad - kernel) / stride + 1;
+  const int64_t input_shape[] = {batch, channels, size, size};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {batch, filters, output_size, output_size};
+  const int64_t group_count = depthwise ? channels : 1;
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasReluActivation;
+
+  auto input = RandomBuffer<float>(static_cast<size_t>(batch * channels * size * size));
+  auto filter = RandomBuffer<float>(static_cast<size_t>(filters * (channels / group_count) * kernel * kernel));
+  auto bias = RandomBuffer<float>(static_cast<size_t>(filters));
+  std::vector<float> output(static_cast<size_t>(batch * filters * output_size * output_size));
+
+  for (auto _ : state) {
+    MlasNchwcConv(2, input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(group_count), input.data(), filter.data(), bias.data(), output.data(),
+                  &activation, true, tp.get());
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * batch * filters * output_size * output_size * (channels / group_count) * kernel * kernel,
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_NchwcConv)->Apply(ConvArgs)->UseRealTime();
+
+// channels, input height and width, kernel size, stride, threads
+void PoolArgs(benchmark::internal::Benchmark* b) {
+  const int64_t shapes[][4] = {{64, 112, 3, 2}, {256, 56, 2, 2}, {512, 14, 3, 1}, {2048, 7, 7, 1}};
+  for (const auto& shape : shapes) {
+    for (int threads : kThreadCounts) {
+      b->Args({shape[0], shape[1], shape[2], shape[3], threads});
+    }
+  }
+  b->ArgNames({"C", "HW", "k", "s", "threads"});
+}
+
+void BM_Pool(benchmark::State& state, MLAS_POOLING_KIND kind, bool nchwc) {
+  const int64_t channels = state.range(0);
+  const int64_t size = state.range(1);
+  const int64_t kernel = state.range(2);
+  const int64_t stride = state.range(3);
+  auto tp = CreateThreadPool(state, 4);
+
+  if (nchwc && (MlasNchwcGetBlockSize() <= 1 || channels % static_cast<int64_t>(MlasNchwcGetBlockSize()) != 0)) {
+    state.SkipWithError("NCHWc kernels are not supported on this platform");
+    return;
+  }
+
+  const int64_t output_size = (size - kernel) / stride + 1;
+  const int64_t input_shape[] = {1, channels, size, size};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {0, 0, 0, 0};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {1, channels, output_size, output_size};
+
+  auto input = RandomBuffer<float>(static_cast<size_t>(channels * size * size));
+  std::vector<float> output(static_cast<size_t>(channels * output_size * output_size));
+
+  for (auto _ : state) {
+    if (nchwc) {
+      MlasNchwcPool(kind, 2, input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                    input.data(), output.data(), tp.get());
+    } else {
+      MlasPool(kind, 2, input_shape, kernel_shape, padding, stride_shape, output_shape, input.data(),
+               output.data(), tp.get());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size() * sizeof(float)));
+}
+BENCHMARK_CAPTURE(BM_Pool, MaxPool, MlasMaximumPooling, false)->Apply(PoolArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Pool, AveragePool, MlasAveragePoolingExcludePad, false)->Apply(PoolArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Pool, NchwcMaxPool, MlasMaximumPooling, true)->Apply(PoolArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Pool, NchwcAveragePool, MlasAveragePoolingExcludePad, true)->Apply(PoolArgs)->UseRealTime();
+
+// M, N. The activations are applied to a GEMM output in place.
+void BM_Activation(benchmark::State& state, MLAS_ACTIVATION_KIND kind) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = kind;
+  activation.Parameters.LeakyRelu.alpha = 0.01f;
+  if (kind == MlasClipActivation) {
+    activation.Parameters.Clip.minimum = 0.0f;
+    activation.Parameters.Clip.maximum = 6.0f;
+  }
+
+  auto buffer = RandomBuffer<float>(M * N);
+  auto bias = RandomBuffer<float>(M);
+
+  for (auto _ : state) {
+    MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size() * sizeof(float)));
+}
+#define ACTIVATION_BENCHMARK(kind) \
+  BENCHMARK_CAPTURE(BM_Activation, kind, Mlas##kind##Activation)->Args({64, 3136})->Args({768, 128})
+ACTIVATION_BENCHMARK(Relu);
+ACTIVATION_BENCHMARK(LeakyRelu);
+ACTIVATION_BENCHMARK(Tanh);
+ACTIVATION_BENCHMARK(Logistic);
+ACTIVATION_BENCHMARK(Clip);
+
+void BM_Elementwise(benchmark::State& state, void (*compute)(const float*, float*, size_t)) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  auto input = RandomBuffer<float>(N, 1, 10);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    compute(input.data(), output.data(), N);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(N * sizeof(float)));
+}
+BENCHMARK_CAPTURE(BM_Elementwise, Logistic, MlasComputeLogistic)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, Tanh, MlasComputeTanh)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, Erf, MlasComputeErf)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, Exp, MlasComputeExp)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, Log, MlasComputeLog)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, Sqrt, MlasComputeSqrt)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_Elementwise, ReciprocalSqrt, MlasComputeReciprocalSqrt)->Arg(1024)->Arg(1 << 20);
+
+// N rows of D elements, threads
+void BM_Softmax(benchmark::State& state, bool log_softmax) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+  auto tp = CreateThreadPool(state, 2);
+
+  auto input = RandomBuffer<float>(N * D);
+  std::vector<float> output(N * D);
+
+  for (auto _ : state) {
+    MlasComputeSoftmax(input.data(), output.data(), N, D, log_softmax, tp.get());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size() * sizeof(float)));
+}
+
+void RowArgs(benchmark::internal::Benchmark* b) {
+  const int64_t shapes[][2] = {{1, 1000}, {128, 128}, {1536, 128}, {128, 768}, {4096, 1024}};
+  for (const auto& shape : shapes) {
+    for (int threads : kThreadCounts) {
+      b->Args({shape[0], shape[1], threads});
+    }
+  }
+  b->ArgNames({"N", "D", "threads"});
+}
+BENCHMARK_CAPTURE(BM_Softmax, Softmax, false)->Apply(RowArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Softmax, LogSoftmax, true)->Apply(RowArgs)->UseRealTime();
+
+void BM_Gelu(benchmark::State& state, MLAS_GELU_KIND kind) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+  auto tp = CreateThreadPool(state, 2);
+
+  auto input = RandomBuffer<float>(N * D);
+  auto bias = RandomBuffer<float>(D);
+  std::vector<float> output(N * D);
+
+  for (auto _ : state) {
+    MlasComputeGelu(kind, input.data(), bias.data(), output.data(), N * D, D, tp.get());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size() * sizeof(float)));
+}
+BENCHMARK_CAPTURE(BM_Gelu, Erf, MlasGeluErf)->Apply(RowArgs)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Gelu, Tanh, MlasGeluTanh)->Apply(RowArgs)->UseRealTime();
+
+// Normalizes N rows of D elements one at a time, the way the LayerNormalization kernels call it.
+void BM_LayerNormalization(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+
+  auto input = RandomBuffer<float>(N * D);
+  auto gamma = RandomBuffer<float>(D);
+  auto beta = RandomBuffer<float>(D);
+  std::vector<float> output(N * D);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < N; i++) {
+      MlasComputeLayerNormalization(input.data() + i * D, nullptr, nullptr, gamma.data(), beta.data(),
+                                    output.data() + i * D, D, 1e-5f, nullptr, nullptr);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size() * sizeof(float)));
+}
+BENCHMARK(BM_LayerNormalization)->Args({128, 768})->Args({512, 1024})->Args({1, 4096})->ArgNames({"N", "D"});
+
+template <typename T>
+void BM_Transpose(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  auto input = RandomBuffer<T>(M * N, 0, 255);
+  std::vector<T> output(M * N);
+
+  for (auto _ : state) {
+    MlasTranspose(input.data(), N, output.data(), M, M, N);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size() * sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_Transpose, uint8_t)->Args({64, 64})->Args({1024, 1024})->Args({3136, 64});
+BENCHMARK_TEMPLATE(BM_Transpose, uint32_t)->Args({64, 64})->Args({1024, 1024})->Args({3136, 64});
+
+template <typename T>
+void BM_QuantizeLinear(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  auto input = RandomBuffer<float>(N);
+  std::vector<T> output(N);
+
+  for (auto _ : state) {
+    MlasQuantizeLinear(input.data(), output.data(), N, 0.1f, T(3));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(N * sizeof(float)));
+}
+BENCHMARK_TEMPLATE(BM_QuantizeLinear, uint8_t)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_QuantizeLinear, int8_t)->Arg(1024)->Arg(1 << 20);
+
+template <typename T>
+void BM_DequantizeLinear(benchmark::State& state) {
+  const size_t N = static_cast<size_t>(state.range(0));
+  std::vector<T> input(N, T(5));
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    MlasDequantizeLinear(input.data(), output.data(), N, 0.1f, T(3));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(N * sizeof(float)));
+}
+BENCHMARK_TEMPLATE(BM_DequantizeLinear, uint8_t)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_DequantizeLinear, int8_t)->Arg(1024)->Arg(1 << 20);
+
+}  // namespace
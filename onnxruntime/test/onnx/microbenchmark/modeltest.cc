@@ -20,30 +20,32 @@ static void BM_LoadModel(benchmark::State& state) {
 
 BENCHMARK(BM_LoadModel);
 
+extern const OrtApi* g_ort;
 extern OrtEnv* env;
 
-#define ORT_BREAK_ON_ERROR(expr)                            \
-  do {                                                      \
-    OrtStatus* onnx_status = (expr);                        \
-    if (onnx_status != NULL) {                              \
-      state.SkipWithError(OrtGetErrorMessage(onnx_status)); \
-      OrtReleaseStatus(onnx_status);                        \
-    }                                                       \
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+    }                                                           \
   } while (0);
 
 #ifdef USE_CUDA
 static void BM_CreateSession_WithGPU(benchmark::State& state) {
   const char* model_path = "../models/opset8/test_bvlc_alexnet/model.onnx";
-  OrtSessionOptions* session_option = OrtCreateSessionOptions();
+  OrtSessionOptions* session_option;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_option));
   ORT_BREAK_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_CUDA(session_option, 0));
   for (auto _ : state) {
     OrtSession* session;
-    ORT_BREAK_ON_ERROR(OrtCreateSession(env, model_path, session_option, &session));
+    ORT_BREAK_ON_ERROR(g_ort->CreateSession(env, model_path, session_option, &session));
     state.PauseTiming();
-    OrtReleaseSession(session);
+    g_ort->ReleaseSession(session);
     state.ResumeTiming();
   }
-  OrtReleaseSessionOptions(session_option);
+  g_ort->ReleaseSessionOptions(session_option);
 }
 BENCHMARK(BM_CreateSession_WithGPU);
 #endif
@@ -51,14 +53,14 @@ BENCHMARK(BM_CreateSession_WithGPU);
 static void BM_CreateSession(benchmark::State& state) {
   const ORTCHAR_T* model_path = ORT_TSTR("../models/opset8/test_bvlc_alexnet/model.onnx");
   OrtSessionOptions* session_option;
-  ORT_BREAK_ON_ERROR(OrtCreateSessionOptions(&session_option));
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_option));
   for (auto _ : state) {
     OrtSession* session;
-    ORT_BREAK_ON_ERROR(OrtCreateSession(env, model_path, session_option, &session));
+    ORT_BREAK_ON_ERROR(g_ort->CreateSession(env, model_path, session_option, &session));
     state.PauseTiming();
-    OrtReleaseSession(session);
+    g_ort->ReleaseSession(session);
     state.ResumeTiming();
   }
-  OrtReleaseSessionOptions(session_option);
+  g_ort->ReleaseSessionOptions(session_option);
 }
 BENCHMARK(BM_CreateSession);
@@ -4,15 +4,18 @@
 #include "core/session/inference_session.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/bias_gelu_fusion.h"
 #include "core/optimizer/gelu_fusion.h"
@@ -24,15 +27,23 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
+#include "core/optimizer/insert_cast_transformer.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/sparse_weight_transformer.h"
+#include "core/optimizer/transpose_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/utils.h"
+#include "core/optimizer/zipmap_output_transformer.h"
 #include "core/platform/env.h"
 #include "core/util/math.h"
 #include "test/capturing_sink.h"
@@ -114,6 +125,69 @@ TEST(GraphTransformationTests, SliceElimination) {
   }
 }
 
+// Transpose nodes around a chain of unary elementwise nodes are merged, and removed if the permutations cancel.
+TEST(GraphTransformationTests, TransposeElimination) {
+  auto test_case = [&](const std::vector<int64_t>& perm2, int expected_transpose_count) {
+    Model model("TransposeElimination", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto x_type;
+    x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : {2, 8, 6, 4}) {
+      x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+
+    auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+    auto& transpose1_out = graph.GetOrCreateNodeArg("transpose1_out", nullptr);
+    auto& relu_out = graph.GetOrCreateNodeArg("relu_out", nullptr);
+    auto& sigmoid_out = graph.GetOrCreateNodeArg("sigmoid_out", nullptr);
+    auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+    // Y = Transpose(Sigmoid(Relu(Transpose(X))))
+    auto& transpose1 = graph.AddNode("transpose1", "Transpose", "", {&x}, {&transpose1_out});
+    transpose1.AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+    graph.AddNode("relu", "Relu", "", {&transpose1_out}, {&relu_out});
+    graph.AddNode("sigmoid", "Sigmoid", "", {&relu_out}, {&sigmoid_out});
+    auto& transpose2 = graph.AddNode("transpose2", "Transpose", "", {&sigmoid_out}, {&y});
+    transpose2.AddAttribute("perm", perm2);
+
+    auto status = graph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    auto rule_transformer_L1 = onnxruntime::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+    rule_transformer_L1->Register(onnxruntime::make_unique<EliminateTranspose>());
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+    status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Transpose"], expected_transpose_count);
+    EXPECT_EQ(op_to_count["Relu"], 1);
+    EXPECT_EQ(op_to_count["Sigmoid"], 1);
+
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "Relu") {
+        EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+      } else if (node.OpType() == "Transpose") {
+        // The remaining Transpose node applies both permutations.
+        std::vector<int64_t> perm;
+        ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+        EXPECT_EQ(perm, (std::vector<int64_t>{0, 2, 3, 1}));
+        EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+      }
+    }
+
+    // The shape of the output is unchanged.
+    auto* y_shape = graph.GetOutputs()[0]->Shape();
+    ASSERT_TRUE(y_shape != nullptr);
+    ASSERT_EQ(y_shape->dim_size(), 4);
+  };
+
+  test_case({0, 2, 3, 1}, 0);
+  test_case({0, 3, 1, 2}, 1);
+}
+
 TEST(GraphTransformationTests, ConstantFolding) {
   auto model_uri = MODEL_FOLDER "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
   std::shared_ptr<Model> model;
@@ -232,6 +306,116 @@ TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+// The Gather of the known dimensions of X is folded even though dimension 0 is symbolic.
+TEST(GraphTransformationTests, ConstantFoldingShapeGatherSymbolicDims) {
+  Model model("ConstantFoldingShapeGatherSymbolicDims", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  TensorProto known_indices;
+  known_indices.set_name("known_indices");
+  known_indices.set_data_type(TensorProto_DataType_INT64);
+  known_indices.add_dims(2);
+  known_indices.add_int64_data(1);
+  known_indices.add_int64_data(-1);
+  graph.AddInitializedTensor(known_indices);
+
+  TensorProto batch_index;
+  batch_index.set_name("batch_index");
+  batch_index.set_data_type(TensorProto_DataType_INT64);
+  batch_index.add_int64_data(0);
+  graph.AddInitializedTensor(batch_index);
+
+  TensorProto minus_one;
+  minus_one.set_name("minus_one");
+  minus_one.set_data_type(TensorProto_DataType_INT64);
+  minus_one.add_dims(1);
+  minus_one.add_int64_data(-1);
+  graph.AddInitializedTensor(minus_one);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", nullptr);
+  auto& known_dims = graph.GetOrCreateNodeArg("known_dims", nullptr);
+  auto& batch_dim = graph.GetOrCreateNodeArg("batch_dim", nullptr);
+  auto& new_shape = graph.GetOrCreateNodeArg("new_shape", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape_out});
+  graph.AddNode("gather_known", "Gather", "", {&shape_out, graph.GetNodeArg("known_indices")}, {&known_dims});
+  graph.AddNode("gather_batch", "Gather", "", {&shape_out, graph.GetNodeArg("batch_index")}, {&batch_dim});
+  graph.AddNode("concat", "Concat", "", {graph.GetNodeArg("minus_one"), &known_dims}, {&new_shape})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("reshape", "Reshape", "", {&x, &new_shape}, {&y});
+  graph.AddNode("unsqueeze", "Unsqueeze", "", {&batch_dim}, {&z}).AddAttribute("axes", std::vector<int64_t>{0});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 1);
+  EXPECT_EQ(op_to_count["Concat"], 0);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+
+  const auto* folded_shape = graph_utils::GetConstantInitializer(graph, "new_shape");
+  ASSERT_NE(folded_shape, nullptr);
+  Initializer folded_shape_values(*folded_shape);
+  ASSERT_EQ(folded_shape_values.size(), 3);
+  EXPECT_EQ(folded_shape_values.data<int64_t>()[0], -1);
+  EXPECT_EQ(folded_shape_values.data<int64_t>()[1], 4);
+  EXPECT_EQ(folded_shape_values.data<int64_t>()[2], 8);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingMaxOutputBytes) {
+  auto build_graph = [](Graph& graph) {
+    TensorProto value;
+    value.set_name("value");
+    value.set_data_type(TensorProto_DataType_FLOAT);
+    value.add_dims(1);
+    value.add_float_data(1.f);
+    graph.AddInitializedTensor(value);
+
+    TensorProto shape;
+    shape.set_name("shape");
+    shape.set_data_type(TensorProto_DataType_INT64);
+    shape.add_dims(1);
+    shape.add_int64_data(1024);
+    graph.AddInitializedTensor(shape);
+
+    auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+    graph.AddNode("expand", "Expand", "", {graph.GetNodeArg("value"), graph.GetNodeArg("shape")}, {&y});
+    return graph.Resolve();
+  };
+
+  // the 4096 byte output of the Expand exceeds the budget
+  for (size_t max_output_bytes : {size_t{1024}, size_t{0}}) {
+    Model model("ConstantFoldingMaxOutputBytes", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    auto status = build_graph(graph);
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(
+        onnxruntime::make_unique<ConstantFolding>(std::unordered_set<std::string>{}, max_output_bytes),
+        TransformerLevel::Level1);
+    status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Expand"], max_output_bytes == 0 ? 0 : 1);
+  }
+}
+
 TEST(GraphTransformationTests, ShapeToInitializer) {
   auto model_uri = MODEL_FOLDER "shape-add.onnx";
   std::shared_ptr<Model> model;
@@ -396,6 +580,59 @@ TEST(GraphTransformationTests, FuseConvActivation) {
   }
 }
 
+TEST(GraphTransformationTests, FuseConvAddActivation) {
+  Model model("FuseConvAddActivation", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto x_type = make_type({1, 4, 6, 6});
+  TypeProto w_type = make_type({4, 4, 3, 3});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w = graph.GetOrCreateNodeArg("W", &w_type);
+  auto& r = graph.GetOrCreateNodeArg("R", &x_type);
+  auto& conv_out = graph.GetOrCreateNodeArg("conv_out", nullptr);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  // Y = Relu(Conv(X, W) + R)
+  auto& conv = graph.AddNode("conv", "Conv", "", {&x, &w}, {&conv_out});
+  conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  graph.AddNode("add", "Add", "", {&r, &conv_out}, {&add_out});
+  graph.AddNode("relu", "Relu", "", {&add_out}, {&y});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConvActivationFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+  ASSERT_EQ(op_to_count["FusedConv"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    // The residual tensor is the fourth input, after the missing bias.
+    const auto& input_defs = node.InputDefs();
+    ASSERT_EQ(input_defs.size(), 4u);
+    EXPECT_FALSE(input_defs[2]->Exists());
+    EXPECT_EQ(input_defs[3]->Name(), "R");
+    EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    EXPECT_EQ(node.GetAttributes().at("activation").s(), "Relu");
+  }
+}
+
 TEST(GraphTransformationTests, FuseConvClip11Activation) {
   auto model_uri = MODEL_FOLDER "fusion/conv_clip11.onnx";
   std::shared_ptr<Model> p_model;
@@ -678,8 +915,7 @@ TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
   ASSERT_EQ(1, fetches.size());
   auto& rtensor = fetches.front().Get<Tensor>();
   TensorShape expected_shape(expected_dims_prod);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&rtensor.Shape()));
+  ASSERT_EQ(expected_shape.GetDimsAsVector(), rtensor.Shape().GetDimsAsVector());
   const std::vector<MLFloat16> found(rtensor.template Data<MLFloat16>(),
                                      rtensor.template Data<MLFloat16>() + expected_dims_prod.size());
   ASSERT_EQ(expected_values_prod, found);
@@ -1443,7 +1679,713 @@ TEST(GraphTransformationTests, EmbedLayerNormFusionFormat5) {
   }
 }
 
+TEST(GraphTransformationTests, ElementwiseFusion) {
+  Model model("ElementwiseFusion", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  TypeProto x_type = make_type({2, 3, 4});
+  TypeProto bias_type = make_type({4});
+  TypeProto scale_type = make_type({1});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& bias = graph.GetOrCreateNodeArg("B", &bias_type);
+  auto& scale = graph.GetOrCreateNodeArg("S", &scale_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &x_type);
+  auto& mul1_out = graph.GetOrCreateNodeArg("mul1_out", &x_type);
+  auto& tanh_out = graph.GetOrCreateNodeArg("tanh_out", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &x_type);
+
+  // Y = tanh(S * (X + B)) * X
+  graph.AddNode("add", "Add", "", {&x, &bias}, {&add_out});
+  graph.AddNode("mul1", "Mul", "", {&scale, &add_out}, {&mul1_out});
+  graph.AddNode("tanh", "Tanh", "", {&mul1_out}, {&tanh_out});
+  graph.AddNode("mul2", "Mul", "", {&tanh_out, &x}, {&y});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Tanh"], 0);
+  EXPECT_EQ(op_to_count["FusedElementwise"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise") {
+      ASSERT_EQ(node.InputDefs().size(), 3u);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "X");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "B");
+      EXPECT_EQ(node.InputDefs()[2]->Name(), "S");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+
+      const auto& attributes = node.GetAttributes();
+      const auto& operations = attributes.at("operations").strings();
+      ASSERT_EQ(operations.size(), 4);
+      EXPECT_EQ(operations[0], "Add");
+      EXPECT_EQ(operations[1], "Mul");
+      EXPECT_EQ(operations[2], "Tanh");
+      EXPECT_EQ(operations[3], "Mul");
+
+      const std::vector<int64_t> expected_indices{1, 2, -1, 0};
+      const std::vector<int64_t> expected_positions{1, 0, -1, 1};
+      const auto& indices = attributes.at("operand_indices").ints();
+      const auto& positions = attributes.at("operand_positions").ints();
+      EXPECT_EQ(std::vector<int64_t>(indices.begin(), indices.end()), expected_indices);
+      EXPECT_EQ(std::vector<int64_t>(positions.begin(), positions.end()), expected_positions);
+    }
+  }
+}
+
+// An Add whose output is consumed twice ends the chain, so a single node is left alone.
+TEST(GraphTransformationTests, ElementwiseFusionMultipleConsumers) {
+  Model model("ElementwiseFusionMultipleConsumers", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& x2 = graph.GetOrCreateNodeArg("X2", &x_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &x_type);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &x_type);
+  auto& y2 = graph.GetOrCreateNodeArg("Y2", &x_type);
+
+  graph.AddNode("add", "Add", "", {&x, &x2}, {&add_out});
+  graph.AddNode("relu", "Relu", "", {&add_out}, {&y1});
+  graph.AddNode("sigmoid", "Sigmoid", "", {&add_out}, {&y2});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Sigmoid"], 1);
+  EXPECT_EQ(op_to_count["FusedElementwise"], 0);
+}
+
+// A float16 chain on CUDA is fused too, and split where the CUDA kernel's limit of 16 operations is reached.
+TEST(GraphTransformationTests, ElementwiseFusionCudaFloat16) {
+  Model model("ElementwiseFusionCudaFloat16", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+
+  // 20 alternating Neg and Relu nodes
+  NodeArg* value = &graph.GetOrCreateNodeArg("X", &x_type);
+  for (int i = 0; i < 20; i++) {
+    auto& out = graph.GetOrCreateNodeArg(i == 19 ? "Y" : "t" + std::to_string(i), &x_type);
+    graph.AddNode("n" + std::to_string(i), i % 2 == 0 ? "Neg" : "Relu", "", {value}, {&out});
+    value = &out;
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Neg"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+  EXPECT_EQ(op_to_count["FusedElementwise"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), kCudaExecutionProvider);
+    EXPECT_LE(node.GetAttributes().at("operations").strings_size(), 16);
+  }
+}
+
 #endif
 
+// Two chained MatMul nodes on CUDA run in float16 with a single Cast on each side, and Softmax stays in float.
+TEST(GraphTransformationTests, MixedPrecisionTransformer) {
+  Model model("MixedPrecisionTransformer", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  TypeProto x_type = make_type({2, 4});
+  TypeProto w1_type = make_type({4, 3});
+  TypeProto m_type = make_type({2, 3});
+  TypeProto w2_type = make_type({3, 2});
+  TypeProto y_type = make_type({2, 2});
+
+  TensorProto w1_tensor;
+  Initializer w1_init(TensorProto_DataType_FLOAT, "W1", {4, 3});
+  std::fill_n(w1_init.data<float>(), 12, 0.5f);
+  w1_init.ToProto(w1_tensor);
+  graph.AddInitializedTensor(w1_tensor);
+
+  TensorProto w2_tensor;
+  Initializer w2_init(TensorProto_DataType_FLOAT, "W2", {3, 2});
+  std::fill_n(w2_init.data<float>(), 6, 2.f);
+  w2_init.ToProto(w2_tensor);
+  graph.AddInitializedTensor(w2_tensor);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w1 = graph.GetOrCreateNodeArg("W1", &w1_type);
+  auto& w2 = graph.GetOrCreateNodeArg("W2", &w2_type);
+  auto& m = graph.GetOrCreateNodeArg("M", &m_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &y_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &y_type);
+
+  graph.AddNode("matmul1", "MatMul", "", {&x, &w1}, {&m});
+  graph.AddNode("matmul2", "MatMul", "", {&m, &w2}, {&z});
+  graph.AddNode("softmax", "Softmax", "", {&z}, {&y});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      onnxruntime::make_unique<MixedPrecisionTransformer>(std::unordered_set<std::string>{kCudaExecutionProvider}),
+      TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  InsertCastTransformer insert_cast_transformer("CastInserter");
+  bool modified = false;
+  status = insert_cast_transformer.Apply(graph, modified, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["MatMul"], 2);
+  EXPECT_EQ(op_to_count["Softmax"], 1);
+  EXPECT_EQ(op_to_count["Cast"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    const auto expected_type = node.OpType() == "MatMul" ? TensorProto_DataType_FLOAT16 : TensorProto_DataType_FLOAT;
+    if (node.OpType() != "Cast") {
+      EXPECT_EQ(node.OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), expected_type);
+    }
+    if (node.OpType() == "MatMul") {
+      const auto* weight = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      ASSERT_NE(weight, nullptr);
+      EXPECT_EQ(weight->data_type(), TensorProto_DataType_FLOAT16);
+    }
+  }
+}
+
+// A ZipMap that produces a graph output is replaced by an Identity, so the output is the float tensor of scores.
+TEST(GraphTransformationTests, ZipMapOutputTransformer) {
+  Model model("ZipMapOutputTransformer", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& scores = graph.GetOrCreateNodeArg("scores", &x_type);
+  auto& output = graph.GetOrCreateNodeArg("output_probability", nullptr);
+
+  graph.AddNode("softmax", "Softmax", "", {&x}, {&scores});
+  auto& zipmap = graph.AddNode("zipmap", "ZipMap", "", {&scores}, {&output}, nullptr, kMLDomain);
+  zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{10, 20, 30});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+  ASSERT_FALSE(utils::HasTensorType(*output.TypeAsProto()));
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ZipMapOutputTransformer>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["ZipMap"], 0);
+  EXPECT_EQ(op_to_count["Identity"], 1);
+
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  const NodeArg* graph_output = graph.GetOutputs()[0];
+  EXPECT_EQ(graph_output->Name(), "output_probability");
+  ASSERT_TRUE(utils::HasTensorType(*graph_output->TypeAsProto()));
+  EXPECT_EQ(graph_output->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT);
+}
+
+// The duplicated Shape->Gather->Unsqueeze chains are merged, while the chain gathering
+// with a different indices input is kept.
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  TensorProto index;
+  index.set_name("index");
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(0);
+  graph.AddInitializedTensor(index);
+  index.set_name("other_index");
+  graph.AddInitializedTensor(index);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& index_arg = graph.GetOrCreateNodeArg("index", nullptr);
+  auto& other_index_arg = graph.GetOrCreateNodeArg("other_index", nullptr);
+  std::vector<NodeArg*> outputs;
+  for (int i = 0; i < 3; ++i) {
+    const std::string suffix = std::to_string(i);
+    auto& shape_out = graph.GetOrCreateNodeArg("shape_out" + suffix, nullptr);
+    auto& gather_out = graph.GetOrCreateNodeArg("gather_out" + suffix, nullptr);
+    auto& unsqueeze_out = graph.GetOrCreateNodeArg("unsqueeze_out" + suffix, nullptr);
+    graph.AddNode("shape" + suffix, "Shape", "", {&x}, {&shape_out});
+    graph.AddNode("gather" + suffix, "Gather", "", {&shape_out, i == 2 ? &other_index_arg : &index_arg}, {&gather_out});
+    graph.AddNode("unsqueeze" + suffix, "Unsqueeze", "", {&gather_out}, {&unsqueeze_out})
+        .AddAttribute("axes", std::vector<int64_t>{0});
+    outputs.push_back(&unsqueeze_out);
+  }
+
+  // Concat the three values so only the Concat produces a graph output
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("concat", "Concat", "", outputs, {&y}).AddAttribute("axis", int64_t{0});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 2);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 2);
+  EXPECT_EQ(op_to_count["Concat"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Concat") {
+      ASSERT_EQ(node.InputDefs().size(), 3u);
+      EXPECT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+      EXPECT_NE(node.InputDefs()[0], node.InputDefs()[2]);
+    }
+  }
+}
+
+// The Transpose of the last two dimensions of A is fused, while the Transpose of B that also has another consumer
+// is kept for that consumer.
+TEST(GraphTransformationTests, MatmulTransposeFusion) {
+  Model model("MatmulTransposeFusion", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  TypeProto a_type = make_type({2, 4, 3});
+  TypeProto b_type = make_type({5, 4});
+
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& a_transposed = graph.GetOrCreateNodeArg("a_transposed", nullptr);
+  auto& b_transposed = graph.GetOrCreateNodeArg("b_transposed", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+
+  graph.AddNode("transpose_a", "Transpose", "", {&a}, {&a_transposed})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+  graph.AddNode("transpose_b", "Transpose", "", {&b}, {&b_transposed});
+  graph.AddNode("matmul", "MatMul", "", {&a_transposed, &b_transposed}, {&y});
+  graph.AddNode("relu", "Relu", "", {&b_transposed}, {&z});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<MatmulTransposeFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["Transpose"], 1);
+  EXPECT_EQ(op_to_count["TransposeMatMul"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "TransposeMatMul") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "A");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "B");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+      EXPECT_EQ(node.GetAttributes().at("transA").i(), 1);
+      EXPECT_EQ(node.GetAttributes().at("transB").i(), 1);
+
+      const auto* y_shape = node.OutputDefs()[0]->Shape();
+      ASSERT_TRUE(y_shape != nullptr);
+      ASSERT_EQ(y_shape->dim_size(), 3);
+      EXPECT_EQ(y_shape->dim(1).dim_value(), 3);
+      EXPECT_EQ(y_shape->dim(2).dim_value(), 5);
+    }
+  }
+}
+
+// The MatMul whose weight is mostly zeros is replaced by a SparseGemm with a packed weight, while the Gemm with a
+// dense weight is kept.
+TEST(GraphTransformationTests, SparseWeightTransformer) {
+  Model model("SparseWeightTransformer", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(64);
+
+  auto add_weight = [&graph](const std::string& name, const std::vector<float>& values) {
+    TensorProto weight;
+    weight.set_name(name);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(64);
+    weight.add_dims(32);
+    weight.set_raw_data(values.data(), values.size() * sizeof(float));
+    graph.AddInitializedTensor(weight);
+    return &graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  // one non-zero value in each column
+  std::vector<float> sparse_values(64 * 32, 0.0f);
+  for (int n = 0; n < 32; ++n) {
+    sparse_values[(n * 7 % 64) * 32 + n] = static_cast<float>(n + 1);
+  }
+
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("Z", nullptr);
+  graph.AddNode("matmul", "MatMul", "", {&a, add_weight("sparse_B", sparse_values)}, {&y});
+  graph.AddNode("gemm", "Gemm", "", {&a, add_weight("dense_B", std::vector<float>(64 * 32, 1.0f))}, {&z});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SparseWeightTransformer>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["Gemm"], 1);
+  EXPECT_EQ(op_to_count["SparseGemm"], 1);
+
+  // the dense copy of the sparse weight is no longer used
+  const auto& initializers = graph.GetAllInitializedTensors();
+  EXPECT_EQ(initializers.count("sparse_B"), 0u);
+  EXPECT_EQ(initializers.count("dense_B"), 1u);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "SparseGemm") {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "A");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+      EXPECT_EQ(node.GetAttributes().at("N").i(), 32);
+      EXPECT_EQ(node.GetAttributes().at("K").i(), 64);
+
+      const TensorProto* packed_weight = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), packed_weight));
+      EXPECT_EQ(packed_weight->data_type(), TensorProto_DataType_UINT8);
+      EXPECT_LT(packed_weight->dims(0), static_cast<int64_t>(sparse_values.size() * sizeof(float)));
+    }
+  }
+}
+
+// Build A -> DequantizeLinear -> MatMul <- DequantizeLinear <- B, optionally followed by a QuantizeLinear
+static void BuildQDQMatMulGraph(Graph& graph, TensorProto_DataType b_type, bool add_quantize) {
+  auto add_scalar = [&graph](const std::string& name, TensorProto_DataType data_type) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    if (data_type == TensorProto_DataType_FLOAT) {
+      tensor.add_float_data(0.5f);
+    } else {
+      tensor.add_int32_data(1);
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetNodeArg(name);
+  };
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto b_tensor_type;
+  b_tensor_type.mutable_tensor_type()->set_elem_type(b_type);
+  b_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  b_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &b_tensor_type);
+  auto& a_float = graph.GetOrCreateNodeArg("a_float", nullptr);
+  auto& b_float = graph.GetOrCreateNodeArg("b_float", nullptr);
+  auto& y_float = graph.GetOrCreateNodeArg(add_quantize ? "y_float" : "Y", nullptr);
+
+  graph.AddNode("dequantize_a", "DequantizeLinear", "",
+                {&a, add_scalar("a_scale", TensorProto_DataType_FLOAT),
+                 add_scalar("a_zero_point", TensorProto_DataType_UINT8)},
+                {&a_float});
+  graph.AddNode("dequantize_b", "DequantizeLinear", "",
+                {&b, add_scalar("b_scale", TensorProto_DataType_FLOAT), add_scalar("b_zero_point", b_type)},
+                {&b_float});
+  graph.AddNode("matmul", "MatMul", "", {&a_float, &b_float}, {&y_float});
+  if (add_quantize) {
+    auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+    graph.AddNode("quantize_y", "QuantizeLinear", "",
+                  {&y_float, add_scalar("y_scale", TensorProto_DataType_FLOAT),
+                   add_scalar("y_zero_point", TensorProto_DataType_UINT8)},
+                  {&y});
+  }
+}
+
+TEST(GraphTransformationTests, QDQFusionQLinearMatMul) {
+  Model model("QDQFusionQLinearMatMul", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  BuildQDQMatMulGraph(graph, TensorProto_DataType_UINT8, true);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["QLinearMatMul"], 1);
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), "Y");
+}
+
+// int8 weights without a QuantizeLinear use MatMulInteger and scale the int32 result
+TEST(GraphTransformationTests, QDQFusionMatMulInteger) {
+  Model model("QDQFusionMatMulInteger", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  BuildQDQMatMulGraph(graph, TensorProto_DataType_INT8, false);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["MatMulInteger"], 1);
+  EXPECT_EQ(op_to_count["Cast"], 1);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Mul") {
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+      const auto* scale = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      ASSERT_TRUE(scale != nullptr);
+      EXPECT_EQ(scale->float_data(0), 0.25f);
+    }
+  }
+}
+
+// A residual block: DequantizeLinear(A) + DequantizeLinear(B) -> QuantizeLinear -> DequantizeLinear ->
+// GlobalAveragePool -> QuantizeLinear stays in uint8 with QLinearAdd and QLinearGlobalAveragePool
+TEST(GraphTransformationTests, QDQFusionQLinearAddGlobalAveragePool) {
+  Model model("QDQFusionQLinearAddGlobalAveragePool", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto add_scalar = [&graph](const std::string& name, TensorProto_DataType data_type) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    if (data_type == TensorProto_DataType_FLOAT) {
+      tensor.add_float_data(0.5f);
+    } else {
+      tensor.add_int32_data(1);
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetNodeArg(name);
+  };
+
+  auto add_dequantize = [&](const std::string& name, NodeArg& input, NodeArg& output) {
+    graph.AddNode(name, "DequantizeLinear", "",
+                  {&input, add_scalar(name + "_scale", TensorProto_DataType_FLOAT),
+                   add_scalar(name + "_zero_point", TensorProto_DataType_UINT8)},
+                  {&output});
+  };
+  auto add_quantize = [&](const std::string& name, NodeArg& input, NodeArg& output) {
+    graph.AddNode(name, "QuantizeLinear", "",
+                  {&input, add_scalar(name + "_scale", TensorProto_DataType_FLOAT),
+                   add_scalar(name + "_zero_point", TensorProto_DataType_UINT8)},
+                  {&output});
+  };
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  for (int64_t dim : {1, 4, 3, 3}) {
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+
+  auto& a = graph.GetOrCreateNodeArg("A", &input_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &input_type);
+  auto& a_float = graph.GetOrCreateNodeArg("a_float", nullptr);
+  auto& b_float = graph.GetOrCreateNodeArg("b_float", nullptr);
+  auto& sum_float = graph.GetOrCreateNodeArg("sum_float", nullptr);
+  auto& sum = graph.GetOrCreateNodeArg("sum", nullptr);
+  auto& sum_dequantized = graph.GetOrCreateNodeArg("sum_dequantized", nullptr);
+  auto& pool_float = graph.GetOrCreateNodeArg("pool_float", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  add_dequantize("dequantize_a", a, a_float);
+  add_dequantize("dequantize_b", b, b_float);
+  graph.AddNode("add", "Add", "", {&a_float, &b_float}, {&sum_float});
+  add_quantize("quantize_sum", sum_float, sum);
+  add_dequantize("dequantize_sum", sum, sum_dequantized);
+  graph.AddNode("pool", "GlobalAveragePool", "", {&sum_dequantized}, {&pool_float});
+  add_quantize("quantize_y", pool_float, y);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["GlobalAveragePool"], 0);
+  EXPECT_EQ(op_to_count["QLinearAdd"], 1);
+  EXPECT_EQ(op_to_count["QLinearGlobalAveragePool"], 1);
+  ASSERT_EQ(graph.GetOutputs().size(), 1u);
+  EXPECT_EQ(graph.GetOutputs()[0]->Name(), "Y");
+}
+
+// A -> DynamicQuantizeLinear -> MatMulInteger -> Cast -> Mul(y_scale * b_scale) -> Add(bias) -> Y
+TEST(GraphTransformationTests, DynamicQuantizeMatMulFusion) {
+  Model model("DynamicQuantizeMatMulFusion", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, TensorProto_DataType data_type,
+                                  const std::vector<int64_t>& dims, size_t size) {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      if (data_type == TensorProto_DataType_FLOAT) {
+        tensor.add_float_data(0.5f);
+      } else {
+        tensor.add_int32_data(1);
+      }
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetNodeArg(name);
+  };
+
+  TypeProto a_type;
+  a_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  a_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& a = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& a_quantized = graph.GetOrCreateNodeArg("a_quantized", nullptr);
+  auto& a_scale = graph.GetOrCreateNodeArg("a_scale", nullptr);
+  auto& a_zero_point = graph.GetOrCreateNodeArg("a_zero_point", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("product", nullptr);
+  auto& float_product = graph.GetOrCreateNodeArg("float_product", nullptr);
+  auto& scale = graph.GetOrCreateNodeArg("scale", nullptr);
+  auto& scaled_product = graph.GetOrCreateNodeArg("scaled_product", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  graph.AddNode("quantize_a", "DynamicQuantizeLinear", "", {&a}, {&a_quantized, &a_scale, &a_zero_point});
+  graph.AddNode("matmul", "MatMulInteger", "",
+                {&a_quantized, add_initializer("B", TensorProto_DataType_INT8, {3, 4}, 12), &a_zero_point,
+                 add_initializer("b_zero_point", TensorProto_DataType_INT8, {}, 1)},
+                {&product});
+  graph.AddNode("cast", "Cast", "", {&product}, {&float_product})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("scale", "Mul", "", {add_initializer("b_scale", TensorProto_DataType_FLOAT, {4}, 4), &a_scale},
+                {&scale});
+  graph.AddNode("mul", "Mul", "", {&float_product, &scale}, {&scaled_product});
+  graph.AddNode("add", "Add", "", {&scaled_product, add_initializer("bias", TensorProto_DataType_FLOAT, {4}, 4)},
+                {&y});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<DynamicQuantizeMatMulFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, DefaultLoggingManager().DefaultLogger());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DynamicQuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["MatMulInteger"], 0);
+  EXPECT_EQ(op_to_count["Cast"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["DynamicQuantizeMatMul"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "DynamicQuantizeMatMul") {
+      ASSERT_EQ(node.InputDefs().size(), 5u);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "A");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "B");
+      EXPECT_EQ(node.InputDefs()[2]->Name(), "b_scale");
+      EXPECT_EQ(node.InputDefs()[3]->Name(), "b_zero_point");
+      EXPECT_EQ(node.InputDefs()[4]->Name(), "bias");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
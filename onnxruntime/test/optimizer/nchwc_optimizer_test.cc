@@ -669,6 +669,188 @@ TEST(NchwcOptimizerTests, ConvConcat) {
   test_case(0, 64, 3);
 }
 
+TEST(NchwcOptimizerTests, ConvBinary) {
+  auto test_case = [&](const std::string& op_type) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 32, 23, 21});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+      helper.AddNode(op_type, {conv1_output_arg, conv2_output_arg}, {output_arg});
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count[op_type], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that Mul and Sub operate on the NCHWc outputs directly. Unlike
+  // Add, these cannot be fused into the preceding Conv node.
+  std::vector<std::string> op_types = {"Mul", "Sub"};
+  for (auto& op_type : op_types) {
+    test_case(op_type);
+  }
+}
+
+TEST(NchwcOptimizerTests, ConvBatchNormalization) {
+  auto test_case = [&](bool do_relu) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 16, 28, 28});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* relu_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {32, 16, 3, 3});
+      helper.AddNode("Relu", {conv_output_arg}, {relu_output_arg});
+
+      // Use variances with a power of two square root so that the folded
+      // scale and shift produce the same results as the original node.
+      std::vector<float> var_data(32);
+      for (size_t i = 0; i < var_data.size(); i++) {
+        var_data[i] = (i % 3 == 0) ? 1.0f : (i % 3 == 1) ? 4.0f : 0.25f;
+      }
+      auto* scale_arg = helper.MakeInitializer({32});
+      auto* B_arg = helper.MakeInitializer({32});
+      auto* mean_arg = helper.MakeInitializer({32});
+      auto* var_arg = helper.MakeInitializer({32}, var_data);
+
+      if (do_relu) {
+        auto* bn_output_arg = helper.MakeIntermediate();
+        auto& bn_node = helper.AddNode("BatchNormalization", {relu_output_arg, scale_arg, B_arg, mean_arg, var_arg}, {bn_output_arg});
+        bn_node.AddAttribute("epsilon", 0.0f);
+        helper.AddNode("Relu", {bn_output_arg}, {output_arg});
+      } else {
+        auto& bn_node = helper.AddNode("BatchNormalization", {relu_output_arg, scale_arg, B_arg, mean_arg, var_arg}, {output_arg});
+        bn_node.AddAttribute("epsilon", 0.0f);
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+      EXPECT_EQ(op_to_count["Relu"], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that a BatchNormalization node that cannot be fused into the
+  // preceding Conv node is converted to a NCHWc depthwise convolution, with
+  // an optional Relu node following.
+  test_case(false);
+  test_case(true);
+}
+
+TEST(NchwcOptimizerTests, ConvUpsample) {
+  auto test_case = [&](const std::string& op_type, int opset_version, const std::string& coordinate_transformation_mode, const std::string& nearest_mode, int upsample_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 24, 15, 13});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {32, 24, 3, 3});
+
+      std::vector<float> scales = {1.0f, 1.0f, 2.0f, 3.0f};
+      std::vector<NodeArg*> input_args = {conv_output_arg};
+      if (op_type == "Resize" && opset_version >= 11) {
+        input_args.push_back(helper.MakeInitializer({0}, {}));
+      }
+      if (opset_version >= 9) {
+        input_args.push_back(helper.MakeInitializer({4}, scales));
+      }
+
+      auto& upsample_node = helper.AddNode(op_type, input_args, {output_arg});
+      upsample_node.AddAttribute("mode", "nearest");
+      if (opset_version < 9) {
+        upsample_node.AddAttribute("scales", scales);
+      }
+      if (!coordinate_transformation_mode.empty()) {
+        upsample_node.AddAttribute("coordinate_transformation_mode", coordinate_transformation_mode);
+      }
+      if (!nearest_mode.empty()) {
+        upsample_node.AddAttribute("nearest_mode", nearest_mode);
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.Upsample"], upsample_count);
+      EXPECT_EQ(op_to_count[op_type], 1 - upsample_count);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, opset_version);
+  };
+
+  test_case("Upsample", 7, "", "", 1);
+  test_case("Upsample", 9, "", "", 1);
+  test_case("Resize", 10, "", "", 1);
+  test_case("Resize", 11, "", "", 1);
+  test_case("Resize", 11, "asymmetric", "floor", 1);
+
+  // Verify that nearest modes that do not replicate the input elements are
+  // not converted.
+  test_case("Resize", 11, "asymmetric", "round_prefer_ceil", 0);
+  test_case("Resize", 11, "align_corners", "", 0);
+}
+
+TEST(NchwcOptimizerTests, ConvNhwcTranspose) {
+  auto test_case = [&](bool keep_transpose_output) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 27, 29, 32});
+      auto* transpose1_output_arg = helper.MakeIntermediate();
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* relu_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      auto& transpose1_node = helper.AddNode("Transpose", {input_arg}, {transpose1_output_arg});
+      transpose1_node.AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+
+      auto& conv_node = helper.AddConvNode(transpose1_output_arg, conv_output_arg, {48, 32, 3, 3});
+      conv_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      helper.AddNode("Relu", {conv_output_arg}, {relu_output_arg});
+
+      auto& transpose2_node = helper.AddNode("Transpose", {relu_output_arg}, {output_arg});
+      transpose2_node.AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+
+      if (keep_transpose_output) {
+        helper.AddNode("Sigmoid", {transpose1_output_arg}, {helper.MakeOutput()});
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], keep_transpose_output ? 1 : 0);
+      EXPECT_EQ(op_to_count["Relu"], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that the Transpose nodes that convert to and from NHWC format are
+  // replaced by reorders directly from and to the NHWC tensors. The first
+  // Transpose node is kept if another node uses its output.
+  test_case(false);
+  test_case(true);
+}
+
 TEST(NchwcOptimizerTests, ConvReuseWeightsOIHWBiBo) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput({1, 64, 7, 7});
@@ -32,6 +32,9 @@ namespace perftest {
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-q [requests_per_second]: Issues requests open loop at this average rate with Poisson arrivals, served by the\n"
+      "\t\t'-c' workers. The latency includes the time a request waits for a free worker. Default:0 (closed loop).\n"
+      "\t-w [warmup_times]: Specifies the number of runs before the measurement starts. Default:1.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|ngraph|openvino|nuphar|dml|acl]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'ngraph', 'openvino', 'nuphar', 'dml' or 'acl'. "
       "Default:'cpu'.\n"
@@ -43,6 +46,7 @@ namespace perftest {
       "\t-v: Show verbose information.\n"
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-y [inter_op_num_threads]: Sets the number of threads used to parallelize the execution of the graph (across nodes), A value of 0 means ORT will pick a default. Must >=0.\n"
+      "\t\t'-x' and '-y' accept a comma separated list, e.g. '-x 1,2,4', to run the test once per combination.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
       "\t-o [optimization level]: Default is 1. Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels. \n"
@@ -50,9 +54,39 @@ namespace perftest {
       "\t-h: help\n");
 }
 
+// Parse a thread count or a comma separated list of them. A single value is stored in num_threads, a list of more
+// than one in sweep.
+static bool ParseThreadCounts(const ORTCHAR_T* arg, int& num_threads, std::vector<int>& sweep) {
+  std::vector<int> counts;
+  const ORTCHAR_T* p = arg;
+  while (true) {
+    ORTCHAR_T* end;
+    long count = OrtStrtol<PATH_CHAR_TYPE>(p, &end);
+    if (end == p || count < 0) {
+      return false;
+    }
+    counts.push_back(static_cast<int>(count));
+    if (*end == 0) {
+      break;
+    }
+    if (*end != ',') {
+      return false;
+    }
+    p = end + 1;
+  }
+
+  if (counts.size() == 1) {
+    num_threads = counts[0];
+    sweep.clear();
+  } else {
+    sweep = counts;
+  }
+  return true;
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:u:AMPvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:q:w:o:u:AMPvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -123,14 +157,14 @@ namespace perftest {
         test_config.run_config.f_verbose = true;
         break;
       case 'x':
-        test_config.run_config.intra_op_num_threads = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        if (test_config.run_config.intra_op_num_threads < 0) {
+        if (!ParseThreadCounts(optarg, test_config.run_config.intra_op_num_threads,
+                               test_config.run_config.intra_op_num_threads_sweep)) {
           return false;
         }
         break;
       case 'y':
-        test_config.run_config.inter_op_num_threads = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        if (test_config.run_config.inter_op_num_threads < 0) {
+        if (!ParseThreadCounts(optarg, test_config.run_config.inter_op_num_threads,
+                               test_config.run_config.inter_op_num_threads_sweep)) {
           return false;
         }
         break;
@@ -144,6 +178,22 @@ namespace perftest {
           return false;
         }
         break;
+      case 'q': {
+        long requests_per_second = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (requests_per_second < 0) {
+          return false;
+        }
+        test_config.run_config.requests_per_second = static_cast<size_t>(requests_per_second);
+        break;
+      }
+      case 'w': {
+        long warmup_times = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (warmup_times < 0) {
+          return false;
+        }
+        test_config.run_config.warmup_times = static_cast<size_t>(warmup_times);
+        break;
+      }
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
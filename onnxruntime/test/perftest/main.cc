@@ -4,6 +4,7 @@
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
 #include <random>
+#include <vector>
 #include "command_args_parser.h"
 #include "performance_runner.h"
 
@@ -30,14 +31,38 @@ int real_main(int argc, char* argv[]) {
     return -1;
   }
   std::random_device rd;
-  perftest::PerformanceRunner perf_runner(env, test_config, rd);
-  auto status = perf_runner.Run();
-  if (!status.IsOK()) {
-    printf("Run failed:%s\n", status.ErrorMessage().c_str());
-    return -1;
+
+  // run once per combination of the swept thread counts, or once with the configured ones
+  const auto& run_config = test_config.run_config;
+  std::vector<int> intra_op_num_threads = run_config.intra_op_num_threads_sweep;
+  if (intra_op_num_threads.empty()) {
+    intra_op_num_threads.push_back(run_config.intra_op_num_threads);
+  }
+  std::vector<int> inter_op_num_threads = run_config.inter_op_num_threads_sweep;
+  if (inter_op_num_threads.empty()) {
+    inter_op_num_threads.push_back(run_config.inter_op_num_threads);
   }
+  const bool sweep = intra_op_num_threads.size() > 1 || inter_op_num_threads.size() > 1;
 
-  perf_runner.SerializeResult();
+  for (int intra_threads : intra_op_num_threads) {
+    for (int inter_threads : inter_op_num_threads) {
+      perftest::PerformanceTestConfig config = test_config;
+      config.run_config.intra_op_num_threads = intra_threads;
+      config.run_config.inter_op_num_threads = inter_threads;
+      if (sweep) {
+        printf("\nintra_op_num_threads:%d inter_op_num_threads:%d\n", intra_threads, inter_threads);
+      }
+
+      perftest::PerformanceRunner perf_runner(env, config, rd);
+      auto status = perf_runner.Run();
+      if (!status.IsOK()) {
+        printf("Run failed:%s\n", status.ErrorMessage().c_str());
+        return -1;
+      }
+
+      perf_runner.SerializeResult();
+    }
+  }
 
   return 0;
 }
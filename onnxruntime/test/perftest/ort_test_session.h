@@ -3,6 +3,7 @@
 
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
+#include <mutex>
 #include <random>
 #include "test_configuration.h"
 #include "test_session.h"
@@ -36,7 +37,8 @@ class OnnxRuntimeTestSession : public TestSession {
 
  private:
   Ort::Session session_{nullptr};
-  std::mt19937 rand_engine_;
+  std::mutex rand_mutex_;
+  std::mt19937 rand_engine_;  // protected by rand_mutex_
   std::uniform_int_distribution<int> dist_;
   std::vector<std::vector<Ort::Value>> test_inputs_;
   std::vector<std::string> output_names_;
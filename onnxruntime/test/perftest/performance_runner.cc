@@ -8,6 +8,7 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -47,22 +48,28 @@ Status PerformanceRunner::Run() {
   }
 
   // warm up
-  RunOneIteration<true>();
+  for (size_t i = 0; i < performance_test_config_.run_config.warmup_times; ++i) {
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start_ = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.requests_per_second > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end_ = std::chrono::high_resolution_clock::now();
 
@@ -79,7 +86,18 @@ Status PerformanceRunner::Run() {
             << "Total inference requests:" << performance_result_.time_costs.size() << std::endl
             << "Average inference time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl
             // Time between start and end of run. Less than Total time cost when running requests in parallel.
-            << "Total inference run time:" << inference_duration.count() << " s" << std::endl;
+            << "Total inference run time:" << inference_duration.count() << " s" << std::endl
+            << "Throughput:" << performance_result_.time_costs.size() / inference_duration.count() << " requests/s"
+            << std::endl;
+
+  if (!performance_result_.time_costs.empty()) {
+    std::vector<double> sorted_time = performance_result_.time_costs;
+    std::sort(sorted_time.begin(), sorted_time.end());
+    std::cout << "Latency P50:" << PerformanceResult::GetPercentile(sorted_time, 0.5) * 1000 << " ms, "
+              << "P90:" << PerformanceResult::GetPercentile(sorted_time, 0.9) * 1000 << " ms, "
+              << "P99:" << PerformanceResult::GetPercentile(sorted_time, 0.99) * 1000 << " ms, "
+              << "P999:" << PerformanceResult::GetPercentile(sorted_time, 0.999) * 1000 << " ms" << std::endl;
+  }
   return Status::OK();
 }
 
@@ -168,6 +186,58 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  const auto& run_config = performance_test_config_.run_config;
+  using clock = std::chrono::high_resolution_clock;
+
+  // a request that arrives while all the workers are busy waits in the queue of the pool. The latency is measured
+  // from the scheduled arrival time, so that wait is included and a slow run isn't hidden by delaying later arrivals.
+  auto tpool = onnxruntime::make_unique<DefaultThreadPoolType>(static_cast<int>(run_config.concurrent_session_runs));
+  std::exponential_distribution<double> interval_seconds(static_cast<double>(run_config.requests_per_second));
+  int pending = 0;
+  Status first_error;
+  std::mutex m;
+  std::condition_variable cv;
+
+  const bool fixed_count = run_config.test_mode == TestMode::KFixRepeatedTimesMode;
+  const auto duration = std::chrono::seconds(run_config.duration_in_seconds);
+  const auto start = clock::now();
+  auto arrival = start;
+  for (size_t requests = 0; fixed_count ? requests < run_config.repeated_times : arrival - start < duration;
+       ++requests) {
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<std::mutex> lg(m);
+      ++pending;
+    }
+    tpool->Schedule([this, arrival, &pending, &first_error, &m, &cv]() {
+      Status status;
+      try {
+        session_->Run();
+        std::chrono::duration<double> latency = clock::now() - arrival;
+        AddTimeCost(latency.count());
+      } catch (const std::exception& ex) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      }
+
+      std::lock_guard<std::mutex> lg(m);
+      if (!status.IsOK() && first_error.IsOK()) {
+        first_error = status;
+      }
+      --pending;
+      cv.notify_all();
+    });
+    arrival += std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(interval_seconds(rand_engine_)));
+  }
+
+  // Join
+  std::unique_lock<std::mutex> lock(m);
+  cv.wait(lock, [&pending]() { return pending == 0; });
+
+  return first_error;
+}
+
 static TestModelInfo* CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     return TestModelInfo::LoadOnnxModel(performance_test_config_.model_info.model_file_path.c_str());
@@ -193,7 +263,8 @@ static TestSession* CreateSession(Ort::Env& env, std::random_device& rd,
 }
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)) {
+      test_model_info_(CreateModelInfo(test_config)),
+      rand_engine_(rd()) {
   session_create_start_ = std::chrono::high_resolution_clock::now();
   session_.reset(CreateSession(env, rd, test_config, test_model_info_));
   session_create_end_ = std::chrono::high_resolution_clock::now();
@@ -215,6 +286,12 @@ bool PerformanceRunner::Initialize() {
   }
   std::string narrow_model_name = ToMBString(model_name);
   performance_result_.model_name = narrow_model_name;
+  const auto& run_config = performance_test_config_.run_config;
+  if (!run_config.intra_op_num_threads_sweep.empty() || !run_config.inter_op_num_threads_sweep.empty()) {
+    // tell the results of the sweep apart in the result file
+    performance_result_.model_name += "[x=" + std::to_string(run_config.intra_op_num_threads) +
+                                      ",y=" + std::to_string(run_config.inter_op_num_threads) + "]";
+  }
 
   test_case_.reset(CreateOnnxTestCase(narrow_model_name, test_model_info_, 0.0, 0.0));
 
@@ -36,6 +36,11 @@ struct PerformanceResult {
   std::vector<double> time_costs;
   std::string model_name;
 
+  // The latency below which the fraction p of the requests completed. sorted_time must not be empty.
+  static double GetPercentile(const std::vector<double>& sorted_time, double p) {
+    return sorted_time[std::min(static_cast<size_t>(sorted_time.size() * p), sorted_time.size() - 1)];
+  }
+
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const {
     std::ofstream outfile;
     outfile.open(path, std::ofstream::out | std::ofstream::app);
@@ -52,11 +57,6 @@ struct PerformanceResult {
       std::vector<double> sorted_time = time_costs;
 
       size_t total = sorted_time.size();
-      size_t n50 = static_cast<size_t>(total * 0.5);
-      size_t n90 = static_cast<size_t>(total * 0.9);
-      size_t n95 = static_cast<size_t>(total * 0.95);
-      size_t n99 = static_cast<size_t>(total * 0.99);
-      size_t n999 = static_cast<size_t>(total * 0.999);
 
       std::sort(sorted_time.begin(), sorted_time.end());
 
@@ -64,11 +64,11 @@ struct PerformanceResult {
       auto output_stats = [&](std::ostream& ostream) {
         ostream << "Min Latency is " << sorted_time[0] << "sec" << std::endl;
         ostream << "Max Latency is " << sorted_time[total - 1] << "sec" << std::endl;
-        ostream << "P50 Latency is " << sorted_time[n50] << "sec" << std::endl;
-        ostream << "P90 Latency is " << sorted_time[n90] << "sec" << std::endl;
-        ostream << "P95 Latency is " << sorted_time[n95] << "sec" << std::endl;
-        ostream << "P99 Latency is " << sorted_time[n99] << "sec" << std::endl;
-        ostream << "P999 Latency is " << sorted_time[n999] << "sec" << std::endl;
+        ostream << "P50 Latency is " << GetPercentile(sorted_time, 0.5) << "sec" << std::endl;
+        ostream << "P90 Latency is " << GetPercentile(sorted_time, 0.9) << "sec" << std::endl;
+        ostream << "P95 Latency is " << GetPercentile(sorted_time, 0.95) << "sec" << std::endl;
+        ostream << "P99 Latency is " << GetPercentile(sorted_time, 0.99) << "sec" << std::endl;
+        ostream << "P999 Latency is " << GetPercentile(sorted_time, 0.999) << "sec" << std::endl;
       };
 
       output_stats(outfile);
@@ -101,21 +101,28 @@ class PerformanceRunner {
   Status RunOneIteration() {
     std::chrono::duration<double> duration_seconds = session_->Run();
     if (!isWarmup) {
-      std::lock_guard<std::mutex> guard(results_mutex_);
-      performance_result_.time_costs.emplace_back(duration_seconds.count());
-      performance_result_.total_time_cost += duration_seconds.count();
-      if (performance_test_config_.run_config.f_verbose) {
-        std::cout << "iteration:" << performance_result_.time_costs.size() << ","
-                  << "time_cost:" << performance_result_.time_costs.back() << std::endl;
-      }
+      AddTimeCost(duration_seconds.count());
     }
     return Status::OK();
   }
 
+  void AddTimeCost(double seconds) {
+    std::lock_guard<std::mutex> guard(results_mutex_);
+    performance_result_.time_costs.emplace_back(seconds);
+    performance_result_.total_time_cost += seconds;
+    if (performance_test_config_.run_config.f_verbose) {
+      std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+                << "time_cost:" << performance_result_.time_costs.back() << std::endl;
+    }
+  }
+
   Status FixDurationTest();
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  // requests_per_second > 0: issue requests at Poisson arrival times and record the time from the arrival of each
+  // request to its completion
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -140,6 +147,8 @@ class PerformanceRunner {
   std::unique_ptr<TestSession> session_;
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
+  // arrival intervals of the open loop mode
+  std::mt19937 rand_engine_;
 
   // TODO: Convert to OrtMutex
   std::mutex results_mutex_;
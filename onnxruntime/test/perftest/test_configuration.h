@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -40,6 +41,13 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // runs before the measurement starts, not included in the results
+  size_t warmup_times{1};
+  // 0 runs closed loop: each of the concurrent_session_runs workers starts a request as soon as its previous one
+  // completes. Otherwise requests arrive open loop at this average rate with exponentially distributed
+  // intervals (a Poisson process), are served by concurrent_session_runs workers, and their latency includes the
+  // time they waited for a free worker.
+  size_t requests_per_second{0};
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
@@ -47,6 +55,9 @@ struct RunConfig {
   ExecutionMode execution_mode{ExecutionMode::ORT_SEQUENTIAL};
   int intra_op_num_threads{0};
   int inter_op_num_threads{0};
+  // when more than one thread count is given, the test runs once per combination of the two lists
+  std::vector<int> intra_op_num_threads_sweep;
+  std::vector<int> inter_op_num_threads_sweep;
   GraphOptimizationLevel optimization_level{ORT_ENABLE_ALL};
   std::basic_string<ORTCHAR_T> optimized_model_path;
 };
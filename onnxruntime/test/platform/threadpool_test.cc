@@ -7,9 +7,12 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <functional>
 #include <mutex>
+#include <thread>
 
 using namespace onnxruntime::concurrency;
 
@@ -66,6 +69,18 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
+void TestParallelForWithCost(const std::string& name, int num_threads, int num_tasks, double cost_per_unit) {
+  auto test_data = CreateTestData(num_tasks);
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    ThreadPool::TryParallelFor(tp, num_tasks, cost_per_unit, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        IncrementElement(*test_data, static_cast<int>(i));
+      }
+    });
+  });
+  ValidateTestData(*test_data);
+}
+
 }  // namespace
 
 TEST(ThreadPoolTest, TestParallelFor_2_Thread_NoTask) {
@@ -99,3 +114,144 @@ TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_50_Task_100_Batch) {
 TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_81_Task_20_Batch) {
   TestBatchParallelFor("TestBatchParallelFor_2_Thread_81_Task_20_Batch", 2, 81, 20);
 }
+
+TEST(ThreadPoolTest, TestParallelFor_2_Thread_1000_Task) {
+  TestParallelFor("TestParallelFor_2_Thread_1000_Task", 2, 1000);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_2_Thread_50_Task_Cheap) {
+  TestParallelForWithCost("TestParallelForWithCost_2_Thread_50_Task_Cheap", 2, 50, 1.0);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_4_Thread_1000_Task_Expensive) {
+  TestParallelForWithCost("TestParallelForWithCost_4_Thread_1000_Task_Expensive", 4, 1000, 100000.0);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCost_No_ThreadPool) {
+  auto test_data = CreateTestData(10);
+  ThreadPool::TryParallelFor(nullptr, 10, 100000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      IncrementElement(*test_data, static_cast<int>(i));
+    }
+  });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelFor_SpinWait) {
+  auto test_data = CreateTestData(100);
+  ThreadPool tp("TestParallelFor_SpinWait", 2, true, 100);
+  tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestParallelFor_NoSpinning) {
+  auto test_data = CreateTestData(100);
+  ThreadPool tp("TestParallelFor_NoSpinning", 2, false, 0);
+  tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+// after running the helper of a loop, the pool threads spin for spin_duration_us and take the helpers of the next
+// loops without being scheduled. the pool is destroyed without waiting for the spin to end.
+TEST(ThreadPoolTest, TestParallelFor_WorkerSpin) {
+  for (int spin_duration_us : {0, 10000000}) {
+    ThreadPool tp("TestParallelFor_WorkerSpin", 2, true, spin_duration_us);
+    ParallelForStats stats;
+    ParallelForStatsScope scope(&stats);
+    for (int run = 0; run < 10; ++run) {
+      auto test_data = CreateTestData(100);
+      tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+      ValidateTestData(*test_data);
+      // the helpers notify the caller before they start spinning
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (spin_duration_us == 0) {
+      EXPECT_EQ(stats.num_helpers_to_spinning_threads, 0u);
+    } else {
+      EXPECT_GT(stats.num_helpers_to_spinning_threads, 0u);
+    }
+  }
+}
+
+#ifdef __linux__
+TEST(ThreadPoolTest, TestParallelFor_CpuAffinity) {
+  auto test_data = CreateTestData(100);
+  ThreadPool tp("TestParallelFor_CpuAffinity", 2, true, 0, {0});
+  tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+#endif
+
+TEST(ThreadPoolTest, TestParallelForStats) {
+  auto test_data = CreateTestData(100);
+  ThreadPool tp("TestParallelForStats", 2);
+  ParallelForStats stats;
+  {
+    ParallelForStatsScope scope(&stats);
+    tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+    {
+      // collection is suspended within a nested scope without stats
+      ParallelForStatsScope suspended(nullptr);
+      tp.ParallelFor(100, [&](int) {});
+    }
+  }
+  tp.ParallelFor(100, [&](int) {});
+  ValidateTestData(*test_data);
+
+  EXPECT_EQ(stats.num_calls, 1u);
+  EXPECT_EQ(stats.num_threads_available, 3u);
+  EXPECT_GE(stats.num_threads_used, 1u);
+  EXPECT_LE(stats.num_threads_used, 3u);
+}
+
+TEST(ThreadPoolTest, TestParallelForPriorityMaxThreads) {
+  auto test_data = CreateTestData(100);
+  ThreadPool tp("TestParallelForPriorityMaxThreads", 2);
+  ParallelForStats stats;
+  {
+    ParallelForStatsScope stats_scope(&stats);
+    ThreadPoolPriorityScope priority_scope(ThreadPoolPriority::kLow, 1);
+    tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+  }
+  ValidateTestData(*test_data);
+
+  // the loop ran on the calling thread only
+  EXPECT_EQ(stats.num_calls, 1u);
+  EXPECT_EQ(stats.num_threads_used, 1u);
+}
+
+TEST(ThreadPoolTest, TestParallelForPriorityYield) {
+  ThreadPool tp("TestParallelForPriorityYield", 4);
+  std::atomic<bool> high_started{false};
+  std::atomic<bool> low_done{false};
+
+  // a high priority loop that runs until the low priority loop is done
+  std::thread high_thread([&]() {
+    ThreadPoolPriorityScope priority_scope(ThreadPoolPriority::kHigh);
+    tp.ParallelFor(2, [&](int) {
+      high_started = true;
+      while (!low_done) {
+        std::this_thread::yield();
+      }
+    });
+  });
+
+  while (!high_started) {
+    std::this_thread::yield();
+  }
+
+  auto test_data = CreateTestData(100);
+  ParallelForStats stats;
+  {
+    ParallelForStatsScope stats_scope(&stats);
+    ThreadPoolPriorityScope priority_scope(ThreadPoolPriority::kLow);
+    tp.ParallelFor(100, [&](int i) { IncrementElement(*test_data, i); });
+  }
+  low_done = true;
+  high_thread.join();
+  ValidateTestData(*test_data);
+
+  // the helpers of the low priority loop left all the blocks to the calling thread
+  EXPECT_EQ(stats.num_threads_used, 1u);
+}
@@ -22,6 +22,9 @@ struct RunOptions {
   int symbolic_dim_value_in_main_graph = -1;
   bool include_dim_values_in_subgraph = true;
   bool mixed_execution_providers = false;
+  // add a zero initializer that is large enough to be deferred to the subgraphs
+  bool large_initializer_in_subgraph = false;
+  bool defer_subgraph_initializers = false;
 };
 }  // namespace
 
@@ -191,6 +194,27 @@ static const ONNX_NAMESPACE::GraphProto CreateSubgraph(bool then_branch, const R
     inputs = {&split_output, &if_input};
     outputs = {&add_out};
 
+    if (options.large_initializer_in_subgraph) {
+      // add_out = (split_output + if_input) + ReduceSum(zeros)
+      TensorProto zeros;
+      zeros.set_name("zeros_" + suffix);
+      zeros.set_data_type(TensorProto_DataType_FLOAT);
+      zeros.add_dims(8192);
+      for (int i = 0; i < 8192; ++i) {
+        zeros.add_float_data(0.f);
+      }
+      graph.AddInitializedTensor(zeros);
+
+      TypeProto float_tensor;
+      float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+      auto& zeros_arg = graph.GetOrCreateNodeArg(zeros.name(), &float_tensor);
+      auto& zeros_sum = graph.GetOrCreateNodeArg("zeros_sum_" + suffix, &float_tensor);
+      auto& add_tmp = graph.GetOrCreateNodeArg("add_tmp_" + suffix, &add_output_tensor);
+      graph.AddNode("sum", "ReduceSum", "Sum the zeros.", {&zeros_arg}, {&zeros_sum});
+      graph.AddNode("add_tmp", "Add", "Add two inputs.", inputs, {&add_tmp});
+      inputs = {&add_tmp, &zeros_sum};
+    }
+
     graph.AddNode("add", "Add", "Add two inputs.", inputs, outputs);
   }
 
@@ -253,6 +277,12 @@ void RunTest(bool condition_value,
     execution_providers.push_back(DefaultCpuExecutionProvider());
 
     test.Run(expect_result, failure_message, excluded_providers, nullptr, &execution_providers);
+  } else if (options.defer_subgraph_initializers) {
+    SessionOptions so;
+    so.session_logid = "If";
+    so.graph_optimization_level = TransformerLevel::Default;  // don't fold the sum of the zeros
+    so.defer_subgraph_initializers = true;
+    test.Run(so, expect_result, failure_message, excluded_providers);
   } else {
     test.Run(expect_result, failure_message, excluded_providers);
   }
@@ -290,6 +320,15 @@ TEST(If, NoShapeInMainGraph_ShapeInSubgraph_False) {
   RunTest(false, options, false);
 }
 
+TEST(If, DeferredSubgraphInitializers) {
+  RunOptions options{};
+  options.large_initializer_in_subgraph = true;
+  options.defer_subgraph_initializers = true;
+
+  RunTest(true, options, false);
+  RunTest(false, options, false);
+}
+
 #ifdef USE_CUDA
 TEST(If, MixedExecutionProviders) {
   RunOptions options{};
@@ -470,77 +470,77 @@ TEST(Loop, ZeroIterations) {
           {});
 }
 
-TEST(Loop, InfiniteLoopTermination) {
-  auto create_subgraph = [](const RunOptions&) {
-    Model model("Infinite Loop subgraph", false, DefaultLoggingManager().DefaultLogger());
-    auto& graph = model.MainGraph();
+static const ONNX_NAMESPACE::GraphProto CreateInfiniteLoopSubgraph(const RunOptions&) {
+  Model model("Infinite Loop subgraph", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
 
-    std::vector<NodeArg*> inputs;
-    std::vector<NodeArg*> outputs;
+  std::vector<NodeArg*> inputs;
+  std::vector<NodeArg*> outputs;
 
-    /* Never change cond_in so loop is infinite
-            Inputs: iter_num, cond_in, loop carried state variables.
+  /* Never change cond_in so loop is infinite
+          Inputs: iter_num, cond_in, loop carried state variables.
 
-         iter_num_in    cond_in     [outer_scope_0]
-           (unused)        |                |
-                       [Identity]      [Identity]
-                           |               |
-                        cond_out     loop_var_0_out
-    */
+       iter_num_in    cond_in     [outer_scope_0]
+         (unused)        |                |
+                     [Identity]      [Identity]
+                         |               |
+                      cond_out     loop_var_0_out
+  */
 
-    // graph inputs types.
-    TypeProto int64_scalar;
-    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
-    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  // graph inputs types.
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
 
-    TypeProto bool_scalar;
-    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
-    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
 
-    TypeProto float_tensor;
-    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
-    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
 
-    // graph inputs
-    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
-    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+  // graph inputs
+  auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
 
-    // outer scope value. need type but not shape.
-    auto& outer_scope_0 = graph.GetOrCreateNodeArg("outer_scope_0", &float_tensor);
+  // outer scope value. need type but not shape.
+  auto& outer_scope_0 = graph.GetOrCreateNodeArg("outer_scope_0", &float_tensor);
 
-    // add so that we don't end up with it being considered a graph input
-    graph.AddOuterScopeNodeArg("outer_scope_0");
+  // add so that we don't end up with it being considered a graph input
+  graph.AddOuterScopeNodeArg("outer_scope_0");
 
-    // graph outputs
-    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
-    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+  // graph outputs
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+  auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
 
-    // cond_in -> cond_out
-    {
-      inputs = {&cond_in};
-      outputs = {&cond_out};
+  // cond_in -> cond_out
+  {
+    inputs = {&cond_in};
+    outputs = {&cond_out};
 
-      graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
-    }
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+  }
 
-    // outer_scope_0 -> loop_var_0_out
-    {
-      inputs = {&outer_scope_0};
-      outputs = {&loop_var_0_out};
+  // outer_scope_0 -> loop_var_0_out
+  {
+    inputs = {&outer_scope_0};
+    outputs = {&loop_var_0_out};
 
-      graph.AddNode("loop_var_out", "Identity", "Forward outer_scope_0 to loop_var_0_out", inputs, outputs);
-    }
+    graph.AddNode("loop_var_out", "Identity", "Forward outer_scope_0 to loop_var_0_out", inputs, outputs);
+  }
 
-    graph.SetInputs({&iter_num_in, &cond_in, &outer_scope_0});
-    graph.SetOutputs({&cond_out, &loop_var_0_out});
+  graph.SetInputs({&iter_num_in, &cond_in, &outer_scope_0});
+  graph.SetOutputs({&cond_out, &loop_var_0_out});
 
-    auto status = graph.Resolve();
-    EXPECT_EQ(status, Status::OK());
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
 
-    return graph.ToGraphProto();
-  };
+  return graph.ToGraphProto();
+}
 
-  LoopOpTester test{{}, create_subgraph};
+TEST(Loop, InfiniteLoopTermination) {
+  LoopOpTester test{{}, CreateInfiniteLoopSubgraph};
 
   test.AddInput<int64_t>("M", {1}, {INT64_MAX});
   test.AddInput<bool>("cond", {1}, {true});
@@ -574,6 +574,26 @@ TEST(Loop, InfiniteLoopTermination) {
   terminator_thread.join();
 }
 
+TEST(Loop, InfiniteLoopDeadline) {
+  LoopOpTester test{{}, CreateInfiniteLoopSubgraph};
+
+  test.AddInput<int64_t>("M", {1}, {INT64_MAX});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("fake", {1}, {0.f});
+  test.AddInput<float>("outer_scope_0", {1}, {kOuterNodeAddValue});
+
+  test.AddOutput<float>("loop_var_0_final", {1}, {0.f});
+  test.AddOutput<int64_t>("outer_scope_0_out", {1}, {int64_t(kOuterNodeAddValue)});
+
+  // the iterations check the deadline of the run
+  OrtRunOptions session_run_options;
+  session_run_options.run_tag = "Loop.InfiniteLoopDeadline";
+  session_run_options.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Exiting due to the deadline of the run having passed",
+           {kTensorrtExecutionProvider}, &session_run_options);  // Disable TensorRT on unsupported data type BOOL
+}
+
 // Regression test that a subgraph input overrides an outer scope value of the same name.
 // Replicate issue from https://github.com/onnx/onnx/issues/2082
 TEST(Loop, SubgraphInputShadowsOuterScopeValue) {
@@ -620,8 +640,7 @@ TEST(Loop, SubgraphInputShadowsOuterScopeValue) {
 
   auto& b_out = fetches[0].Get<Tensor>();
   TensorShape expected_shape(scalar);
-  //Use reinterpret_cast to bypass a gcc bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=51213
-  ASSERT_EQ(*reinterpret_cast<const std::vector<int64_t>*>(&expected_shape), *reinterpret_cast<const std::vector<int64_t>*>(&b_out.Shape()));
+  ASSERT_EQ(expected_shape.GetDimsAsVector(), b_out.Shape().GetDimsAsVector());
   ASSERT_EQ(b_out.DataAsSpan<float>()[0], expected_value_b);
 
   auto user_defined_vals_out = fetches[1].Get<Tensor>().DataAsSpan<float>();
@@ -714,6 +733,61 @@ TEST(Loop, Opset11WithNoVariadicInputsAndOutputs) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// the body swaps the loop carried variables and passes one of them through, and outputs the same value as a loop
+// carried variable and a loop output. none of these values can be written by a later iteration.
+TEST(Loop, LoopCarriedVarsSharingBuffers) {
+  auto create_subgraph = []() {
+    Model model("Loop fibonacci body graph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_scalar;
+    float_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& a_in = graph.GetOrCreateNodeArg("a_in", &float_scalar);
+    auto& b_in = graph.GetOrCreateNodeArg("b_in", &float_scalar);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& sum = graph.GetOrCreateNodeArg("sum", &float_scalar);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "a + b", {&a_in, &b_in}, {&sum});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &a_in, &b_in});
+    graph.SetOutputs({&cond_out, &b_in, &sum, &sum});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("a", {1}, {1.0f});
+  test.AddInput<float>("b", {1}, {1.0f});
+
+  test.AddOutput<float>("a_final", {1}, {8.0f});
+  test.AddOutput<float>("b_final", {1}, {13.0f});
+  test.AddOutput<float>("sums", {5, 1}, {2.0f, 3.0f, 5.0f, 8.0f, 13.0f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
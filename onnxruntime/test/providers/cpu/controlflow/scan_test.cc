@@ -24,6 +24,7 @@ struct RunOptions {
   bool scalar_loop_state_value = false;
   bool add_bad_shape = false;
   bool mixed_execution_providers = false;
+  ExecutionMode execution_mode = ExecutionMode::ORT_SEQUENTIAL;
   // Disable TensorRT because its parser fails, and it can't handle unknown dimensions
   std::unordered_set<std::string> excluded_provider_types{kTensorrtExecutionProvider};
 };
@@ -312,7 +313,7 @@ static void RunTest_v8(const std::string test_name, int64_t batch_size, int64_t
   test.AddOutput<float>("scan_output_2", output_shape, output_2);
   test.AddOutput<float>("scan_output_3", output_shape, output_3);
 
-  test.Run(expect_result, failure_message, options.excluded_provider_types);
+  test.Run(expect_result, failure_message, options.excluded_provider_types, nullptr, nullptr, options.execution_mode);
 }
 
 static void RunTest_v9(const std::string test_name, int64_t sequence_len, int64_t input_size,
@@ -604,7 +605,7 @@ TEST(Scan8, ShortSequenceTwoInBatchOneLoopStateVar) {
              iteration_count_out, output_0, output_1, output_2, output_3);
 }
 
-TEST(Scan8, MixedSequenceLens) {
+static void MixedSequenceLens(const RunOptions& options) {
   const int64_t batch_size = 3;
   const int64_t max_sequence_len = 2;
   const int64_t input_size = 2;
@@ -648,7 +649,20 @@ TEST(Scan8, MixedSequenceLens) {
   RunTest_v8("MixedSequenceLens", batch_size, max_sequence_len, input_size,
              nullptr, &sequence_lens,
              iteration_count_in, input_0, input_1,
-             iteration_count_out, output_0, output_1, output_2, output_3);
+             iteration_count_out, output_0, output_1, output_2, output_3, options);
+}
+
+TEST(Scan8, MixedSequenceLens) {
+  MixedSequenceLens({});
+}
+
+// the batch entries after the first are run concurrently on the inter-op thread pool.
+// leave out the dims in the subgraph so the first entry has to discover the output shapes.
+TEST(Scan8, MixedSequenceLensParallel) {
+  RunOptions options{};
+  options.include_dim_values_in_subgraph = false;
+  options.execution_mode = ExecutionMode::ORT_PARALLEL;
+  MixedSequenceLens(options);
 }
 
 TEST(Scan8, MixedSequenceLensReverse) {
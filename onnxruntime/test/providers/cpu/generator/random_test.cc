@@ -3,13 +3,66 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/providers/cpu/generator/philox.h"
 
 #include <algorithm>
-#include <random>
+#include <cmath>
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+// The uniform values in [0, 1) of the first call to a random generator kernel with the seed.
+// A Philox block gives 4 floats or 2 doubles.
+static void PhiloxUniformValues(float seed, std::vector<float>& values) {
+  PhiloxGenerator generator(gsl::narrow_cast<uint32_t>(seed));
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = PhiloxGenerator::ToFloat(generator(i / 4)[i % 4]);
+  }
+}
+
+static void PhiloxUniformValues(float seed, std::vector<double>& values) {
+  PhiloxGenerator generator(gsl::narrow_cast<uint32_t>(seed));
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto bits = generator(i / 2);
+    const size_t lane = (i % 2) * 2;
+    values[i] = PhiloxGenerator::ToDouble(bits[lane], bits[lane + 1]);
+  }
+}
+
+// Box-Muller transform of each pair of uniform values, for an even number of values
+template <typename T>
+static void PhiloxNormalValues(float seed, float mean, float scale, std::vector<T>& values) {
+  PhiloxUniformValues(seed, values);
+  for (size_t i = 0; i + 1 < values.size(); i += 2) {
+    const T radius = static_cast<T>(scale) * std::sqrt(static_cast<T>(-2) * std::log(static_cast<T>(1) - values[i]));
+    const T angle = static_cast<T>(6.283185307179586) * values[i + 1];
+    values[i] = static_cast<T>(mean) + radius * std::cos(angle);
+    values[i + 1] = static_cast<T>(mean) + radius * std::sin(angle);
+  }
+}
+
+template <typename T>
+static void PhiloxUniformValues(float seed, float low, float high, std::vector<T>& values) {
+  PhiloxUniformValues(seed, values);
+  const T range = static_cast<T>(high) - static_cast<T>(low);
+  std::for_each(values.begin(), values.end(), [low, range](T& value) { value = static_cast<T>(low) + range * value; });
+}
+
+TEST(Random, PhiloxKnownAnswers) {
+  // the test vectors of Philox4x32-10 from the Random123 library
+  EXPECT_EQ(PhiloxGenerator::Philox4x32({{0, 0, 0, 0}}, {{0, 0}}),
+            (PhiloxGenerator::Block{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+  EXPECT_EQ(PhiloxGenerator::Philox4x32({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, {{0xffffffff, 0xffffffff}}),
+            (PhiloxGenerator::Block{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+  EXPECT_EQ(PhiloxGenerator::Philox4x32({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, {{0xa4093822, 0x299f31d0}}),
+            (PhiloxGenerator::Block{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+
+  // the 64-bit counter and seed of the kernels fill the low half of the counter and key
+  PhiloxGenerator generator(0x299f31d0a4093822ull);
+  EXPECT_EQ(generator(0x85a308d3243f6a88ull),
+            PhiloxGenerator::Philox4x32({{0x243f6a88, 0x85a308d3, 0, 0}}, {{0xa4093822, 0x299f31d0}}));
+}
+
 TEST(Random, RandomNormal2DDouble) {
   OpTester test("RandomNormal");
 
@@ -25,12 +78,8 @@ TEST(Random, RandomNormal2DDouble) {
   test.AddAttribute<int64_t>("dtype", TensorProto::DOUBLE);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<double> distribution{mean, scale};
-
   std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  PhiloxNormalValues(seed, mean, scale, expected_output);
 
   test.AddOutput<double>("Y", dims, expected_output);
   test.Run();
@@ -59,12 +108,8 @@ void RunRandomNormalLike3DFloat(bool infer_dtype = false) {
                         0.f, 0.f, 0.f,
                         0.f, 0.f, 0.f});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<float> distribution{mean, scale};
-
   std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  PhiloxNormalValues(seed, mean, scale, expected_output);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -95,12 +140,8 @@ TEST(Random, RandomUniform1DFloat) {
   test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<float> distribution{low, high};
-
   std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  PhiloxUniformValues(seed, low, high, expected_output);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -127,12 +168,8 @@ void RunRandomUniformLikeTest(bool infer_dtype = false) {
                         {0., 0., 0., 0., 0., 0.,
                          0., 0., 0., 0., 0., 0.});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<double> distribution{low, high};
-
   std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  PhiloxUniformValues(seed, low, high, expected_output);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
@@ -222,9 +259,9 @@ TEST(Random, InvalidDType) {
 
 /*
 Note: There are no reference tests that can be reused in this case. I tried to use the tensorflow
-test cases but they use a different RNG (Philox) and hence the test results differ. Since the implementation
-of the op is same as tensorflow, for now I've just relied on the output generated by this code as ground truth
-for verification.
+test cases but they draw different values from their Philox RNG and hence the test results differ. Since the
+implementation of the op is same as tensorflow, for now I've just relied on the output generated by this code as
+ground truth for verification. The output is the same on all platforms as it doesn't depend on the standard library.
 */
 TEST(Random, MultinomialGoodCase) {
   OpTester test("Multinomial");
@@ -244,13 +281,7 @@ TEST(Random, MultinomialGoodCase) {
   test.AddAttribute<int64_t>("dtype", TensorProto::INT64);
 
   const std::vector<int64_t> output_dims{batch_size, num_samples};
-#ifdef _WIN32
-  const std::vector<int64_t> expected_output{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__)
-  const std::vector<int64_t> expected_output{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-#else
-  const std::vector<int64_t> expected_output{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-#endif
+  const std::vector<int64_t> expected_output{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
   test.AddOutput<int64_t>("Y", output_dims, expected_output);
 
   test.Run();
@@ -281,16 +312,8 @@ TEST(Random, MultinomialDefaultDType) {
     test.Run();
   };
 
-#ifdef _WIN32
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-  const std::vector<int32_t> expected_output_2{0, 0, 1, 0, 2, 2, 2, 0, 2, 1, 2, 1, 0, 2, 0, 2, 2, 1, 2, 1};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__)
-  const std::vector<int32_t> expected_output_1{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-  const std::vector<int32_t> expected_output_2{1, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 2, 0, 1, 1, 0, 2, 2, 2, 1};
-#else
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-  const std::vector<int32_t> expected_output_2{2, 2, 1, 1, 0, 2, 2, 1, 1, 2, 0, 0, 0, 2, 0, 1, 1, 1, 0, 0};
-#endif
+  const std::vector<int32_t> expected_output_1{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
+  const std::vector<int32_t> expected_output_2{2, 0, 0, 2, 0, 1, 2, 1, 1, 0, 0, 2, 0, 2, 2, 0, 2, 2, 1, 2};
 
   // Test output from a single call to Multinomial::Compute
   run_test(1, expected_output_1);
@@ -207,5 +207,25 @@ TEST(CumSumTest, _1DTestdouble_WithInt64Axis) {
   test.AddOutput<double>("y", {5}, {1., 3., 6., 10., 15.});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+TEST(CumSumTest, _1DTestLongAxisReverseExclusive) {
+  // long enough to be scanned in parallel blocks
+  const int64_t length = 40000;
+  std::vector<int64_t> x(length);
+  std::vector<int64_t> y(length);
+  int64_t sum = 0;
+  for (int64_t i = length - 1; i >= 0; --i) {
+    x[i] = i % 7;
+    y[i] = sum;
+    sum += x[i];
+  }
+
+  OpTester test("CumSum", 11, onnxruntime::kOnnxDomain);
+  test.AddAttribute<int64_t>("exclusive", 1);
+  test.AddAttribute<int64_t>("reverse", 1);
+  test.AddInput<int64_t>("x", {length}, x);
+  test.AddInput<int32_t>("axis", {1}, {0});
+  test.AddOutput<int64_t>("y", {length}, y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,8 @@
 #include "core/util/math.h"
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <numeric>
 
 namespace onnxruntime {
 namespace test {
@@ -276,6 +278,56 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// Shapes large enough for the broadcast loop to split the output across threads. The spans are short for the
+// per-channel and row cases and long enough to be split into pieces for the same shape and scalar cases.
+TEST(MathOpTest, Add_Broadcast_Large) {
+  auto run = [](const std::vector<int64_t>& dims_a, const std::vector<int64_t>& dims_b,
+                const std::vector<int64_t>& dims_c) {
+    auto size = [](const std::vector<int64_t>& dims) {
+      return std::accumulate(dims.begin(), dims.end(), int64_t{1}, std::multiplies<int64_t>());
+    };
+
+    std::vector<float> a(static_cast<size_t>(size(dims_a)));
+    std::vector<float> b(static_cast<size_t>(size(dims_b)));
+    for (size_t i = 0; i < a.size(); i++) a[i] = static_cast<float>(i % 1000);
+    for (size_t i = 0; i < b.size(); i++) b[i] = static_cast<float>(i) * 1000.0f;
+
+    // dims_c has the rank of dims_a, and each dim of b is either 1 or the dim of c
+    std::vector<float> c(static_cast<size_t>(size(dims_c)));
+    const size_t rank = dims_c.size();
+    for (size_t i = 0; i < c.size(); i++) {
+      size_t remaining = i;
+      size_t b_index = 0;
+      size_t b_stride = 1;
+      for (size_t d = rank; d-- > 0;) {
+        const size_t coordinate = remaining % static_cast<size_t>(dims_c[d]);
+        remaining /= static_cast<size_t>(dims_c[d]);
+        const size_t b_dim_index = d + dims_b.size() - rank;
+        if (d + dims_b.size() >= rank && dims_b[b_dim_index] != 1) {
+          b_index += coordinate * b_stride;
+        }
+        if (d + dims_b.size() >= rank) {
+          b_stride *= static_cast<size_t>(dims_b[b_dim_index]);
+        }
+      }
+      c[i] = a[i] + b[b_index];
+    }
+
+    OpTester test("Add");
+    test.AddInput<float>("A", dims_a, a);
+    test.AddInput<float>("B", dims_b, b);
+    test.AddOutput<float>("C", dims_c, c);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  };
+
+  run({8, 64, 7, 7}, {64, 1, 1}, {8, 64, 7, 7});      // per-channel bias
+  run({4, 64, 70, 70}, {64, 1, 1}, {4, 64, 70, 70});  // per-channel bias with long spans
+  run({512, 300}, {300}, {512, 300});                 // row
+  run({512, 300}, {512, 1}, {512, 300});              // column
+  run({3, 100000}, {3, 100000}, {3, 100000});         // same shape
+  run({300000}, {}, {300000});                        // scalar
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -603,6 +655,25 @@ TEST(MathOpTest, Pow_Broadcast_Scalar1) {
   test.Run();
 }
 
+TEST(MathOpTest, Pow_Broadcast_Scalar1_Fractional) {
+  OpTester test("Pow");
+
+  // Large enough to be split over the thread pool and to leave a partial vector at the end.
+  const int64_t size = 3 * 4096 + 3;
+  std::vector<float> x(size);
+  std::vector<float> z(size);
+  for (int64_t i = 0; i < size; i++) {
+    x[i] = static_cast<float>(i % 1000) / 16.0f;
+    z[i] = std::pow(x[i], 1.5f);
+  }
+
+  test.AddInput<float>("X", {size}, x);
+  test.AddInput<float>("Y", {}, {1.5f});
+  test.AddOutput<float>("Z", {size}, z);
+  test.SetOutputRelErr("Z", 1e-5f);
+  test.Run();
+}
+
 TEST(MathOpTest, Exp_float) {
   OpTester test("Exp");
   std::vector<int64_t> dims{2, 2};
@@ -643,6 +714,33 @@ TEST(MathOpTest, Log) {
   test.Run();
 }
 
+TEST(MathOpTest, ExpLog_LargeTensor) {
+  const int64_t size = 5 * 4096 + 1;
+  std::vector<float> x(size);
+  std::vector<float> exp_y(size);
+  std::vector<float> log_y(size);
+  for (int64_t i = 0; i < size; i++) {
+    x[i] = static_cast<float>(i % 401) / 8.0f - 20.0f;
+    exp_y[i] = std::exp(x[i]);
+    log_y[i] = std::log(std::fabs(x[i]) + 1.0f);
+  }
+
+  OpTester exp_test("Exp");
+  exp_test.AddInput<float>("X", {size}, x);
+  exp_test.AddOutput<float>("Y", {size}, exp_y);
+  exp_test.SetOutputRelErr("Y", 1e-6f);
+  exp_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  std::vector<float> log_x(size);
+  std::transform(x.begin(), x.end(), log_x.begin(), [](float v) { return std::fabs(v) + 1.0f; });
+
+  OpTester log_test("Log");
+  log_test.AddInput<float>("X", {size}, log_x);
+  log_test.AddOutput<float>("Y", {size}, log_y);
+  log_test.SetOutputRelErr("Y", 1e-6f);
+  log_test.Run();
+}
+
 TEST(MathOpTest, Sum_6) {
   OpTester test("Sum", 6);
   std::vector<int64_t> dims{3, 3};
@@ -1374,6 +1472,16 @@ TEST(MathOpTest, Expand_8_3x1x3x1_int64) {
   test.Run();
 }
 
+TEST(MathOpTest, Expand_8_3x1_to_2x3x4) {
+  OpTester test("Expand", 8);
+  test.AddInput<float>("data_0", {3, 1}, {1.0f, 2.0f, 3.0f});
+  test.AddInput<int64_t>("data_1", {3}, {2, 1, 4});
+  test.AddOutput<float>("result", {2, 3, 4},
+                        {1.0f, 1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f, 3.0f, 3.0f, 3.0f, 3.0f,
+                         1.0f, 1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f, 3.0f, 3.0f, 3.0f, 3.0f});
+  test.Run();
+}
+
 TEST(MathOpTest, Expand_8_3x3_float16) {
   OpTester test("Expand", 8);
   test.AddInput<MLFloat16>("data_0", {1}, {MLFloat16(math::floatToHalf(1.0f))});
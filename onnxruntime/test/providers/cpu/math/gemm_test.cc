@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace test {
@@ -106,6 +107,85 @@ TEST(GemmOpTest, GemmTrans) {
   test.Run();
 }
 
+TEST(GemmOpTest, GemmTransConstantB) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  test.AddInput<float>("A", {4, 2},
+                       {1.0f, -1.0f,
+                        2.0f, -2.0f,
+                        3.0f, -3.0f,
+                        4.0f, -4.0f});
+  // a constant B is pre-packed by the CPU kernel
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 1.0f, 1.0f, 1.0f,
+                        1.0f, 2.0f, 3.0f, 4.0f,
+                        0.0f, 0.0f, 0.0f, -1.0f},
+                       true);
+  test.AddInput<float>("C", {3}, std::vector<float>(3, 1.0f));
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 31.0f, -3.0f,
+                         -9.0f, -29.0f, 5.0f});
+  test.Run();
+}
+
+TEST(GemmOpTest, GemmTransConstantBFp16) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, 0.5f, 0.0f, 2.0f});
+  // the CPU kernel packs a constant B as half precision. the test values are exact in half precision.
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 1.0f, 1.0f, 1.0f,
+                        1.0f, 2.0f, 3.0f, 4.0f,
+                        0.25f, 0.0f, 0.0f, -1.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {7.0f, 19.0f, 4.125f,
+                         2.75f, 8.0f, 4.875f});
+
+  CPUExecutionProviderInfo info;
+  info.use_fp16_weights = true;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(GemmOpTest, GemmTransSparseConstantB) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+
+  test.AddInput<float>("A", {2, 10},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f,
+                        10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f});
+  // the CPU kernel packs the non-zero values of a constant B that is mostly zeros
+  test.AddInput<float>("B", {3, 10},
+                       {0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                        1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -4.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {5.0f, 4.0f, -13.5f,
+                         10.0f, 4.0f, 9.0f});
+  test.Run();
+}
+
 TEST(GemmOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
@@ -32,6 +32,26 @@ TEST(MatmulIntegerOpTest, MatMulInteger) {
   test.AddOutput<int32_t>("T3", {1, 1}, {-1});
   test.Run();
 }
+TEST(MatmulIntegerOpTest, MatMulInteger_PerColumnZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6});
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {2}, {1, 4});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-23, -23, -26, -26, -29, -29, -32, -32});
+  test.Run();
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_U8S8_PerColumnZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<int8_t>("T2", {2, 2}, {-1, 2, 3, -4});
+  test.AddInput<uint8_t>("a_zero_point", {}, {0});
+  test.AddInput<int8_t>("b_zero_point", {2}, {1, -2});
+  test.AddOutput<int32_t>("T3", {2, 2}, {2, 0, 2, 4});
+  test.Run();
+}
+
 TEST(MatmulIntegerOpTest, MatMulInteger_WithZero_ZeroPoint) {
   OpTester test("MatMulInteger", 10);
   test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
@@ -42,6 +62,16 @@ TEST(MatmulIntegerOpTest, MatMulInteger_WithZero_ZeroPoint) {
   test.Run();
 }
 
+// constant int8 weights and a zero point for A only, as taken by the DNNL subgraph
+TEST(MatmulIntegerOpTest, MatMulInteger_U8S8_3D_AZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {1, 2, 3}, {1, 2, 3, 4, 5, 6});
+  test.AddInput<int8_t>("T2", {3, 2}, {1, -1, 2, 0, -3, 4}, /*is_initializer*/ true);
+  test.AddInput<uint8_t>("a_zero_point", {}, {2});
+  test.AddOutput<int32_t>("T3", {1, 2, 2}, {-4, 5, -4, 14});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});  // currently nGraph provider does not support gemm_u8s8
+}
+
 template <typename T>
 std::vector<T> ToVector(const int* value, int size) {
   std::vector<T> data(size);
@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 namespace test {
@@ -81,19 +82,19 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
     OpTester test("MatMul", opset_version);
 
-    int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    int64_t size0 = TensorShape(t.input0_dims).SizeHelper(0, t.input0_dims.size());
     std::vector<T> input0_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size0);
     test.AddInput<T>("A", t.input0_dims, input0_vals);
 
-    int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    int64_t size1 = TensorShape(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
 
@@ -105,6 +106,69 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+TEST(MathOpTest, MatMulFloatTypeConstantB) {
+  // a constant 2-D B is pre-packed by the CPU kernel
+  RunMatMulTest<float>(7, true);
+}
+
+TEST(MathOpTest, MatMulFloatTypeConstantBBf16) {
+  // the CPU kernel packs a constant B as bfloat16. the test values are exact in bfloat16.
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {3, 4}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  test.AddInput<float>("B", {4, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, true);
+  test.AddOutput<float>("Y", {3, 3}, {42, 48, 54, 114, 136, 158, 186, 224, 262});
+
+  CPUExecutionProviderInfo info;
+  info.use_bf16_gemm = true;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, MatMulFloatTypeConstantBFp16) {
+  // the CPU kernel packs a constant B as half precision. the test values are exact in half precision.
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {3, 4}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  test.AddInput<float>("B", {4, 3}, {0, 0.5f, 2, 3, 4, 5, 6, 7, 8, 9, 10, -11}, true);
+  test.AddOutput<float>("Y", {3, 3}, {42, 48, -12, 114, 134, 4, 186, 220, 20});
+
+  CPUExecutionProviderInfo info;
+  info.use_fp16_weights = true;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, MatMulFloatTypeConstantBFp16Overflow) {
+  // a constant B with values that overflow half precision is packed as float
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<float>("B", {2, 2}, {100000, 1, 2, 3}, true);
+  test.AddOutput<float>("Y", {2, 2}, {100004, 7, 300008, 15});
+
+  CPUExecutionProviderInfo info;
+  info.use_fp16_weights = true;
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<CPUExecutionProvider>(info));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, MatMulFloatTypeSparseConstantB) {
+  // the CPU kernel packs the non-zero values of a constant B that is mostly zeros
+  OpTester test("MatMul", 9);
+  test.AddInput<float>("A", {2, 4}, {1, 2, 3, 4, -1, 0, 1, 2});
+  test.AddInput<float>("B", {4, 10},
+                       {0, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+                        0, 0, 0, 0, 0, 0, 0, 3, 0, 0,
+                        0, 0, 0, 0, 0, 0, 0, 0, 0, -1,
+                        0, 0, 0, 0, 0.5f, 0, 0, 0, 0, 0},
+                       true);
+  test.AddOutput<float>("Y", {2, 10},
+                        {0, 2, 0, 0, 2, 0, 0, 6, 0, -3,
+                         0, -2, 0, 0, 1, 0, 0, 0, 0, -1});
+  test.Run();
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
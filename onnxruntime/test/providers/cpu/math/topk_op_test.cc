@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -456,5 +458,66 @@ TEST(TopKOperator, SortedSelection) {
   RunTest(11, 5, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, axis, 0);  // smallest values
 }
 
+TEST(TopKOperator, HeapSelectionWideRow) {
+  // k is small compared to the row, so the heap selection is used, and the row is wide enough to be split into
+  // chunks that are selected on different threads. the values repeat so the lowest indices must win the ties.
+  const int64_t n = 100000;
+  std::vector<float> input_vals(n);
+  for (int64_t i = 0; i < n; ++i) {
+    input_vals[i] = static_cast<float>((i * 7919) % 1000);
+  }
+  std::vector<int64_t> input_dimensions = {n};
+
+  std::vector<int64_t> order(n);
+  for (int64_t i = 0; i < n; ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&input_vals](int64_t a, int64_t b) { return input_vals[a] > input_vals[b]; });
+
+  const int64_t k = 10;
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices(order.begin(), order.begin() + k);
+  for (auto index : expected_indices) {
+    expected_vals.push_back(input_vals[index]);
+  }
+  std::vector<int64_t> expected_dimensions = {k};
+  RunTest(11, k, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, 0);
+}
+
+TEST(TopKOperator, ManyRowsSmallestElements) {
+  // many narrow rows, which are sorted together rather than one at a time. the values repeat within a row.
+  const int64_t rows = 64;
+  const int64_t cols = 50;
+  const int64_t k = 3;
+  std::vector<float> input_vals(rows * cols);
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t r = 0; r < rows; ++r) {
+    std::vector<int64_t> order(cols);
+    for (int64_t c = 0; c < cols; ++c) {
+      input_vals[r * cols + c] = static_cast<float>((r * 7 + c * 13) % 11);
+      order[c] = c;
+    }
+    const float* row = input_vals.data() + r * cols;
+    std::stable_sort(order.begin(), order.end(), [row](int64_t a, int64_t b) { return row[a] < row[b]; });
+    for (int64_t i = 0; i < k; ++i) {
+      expected_vals.push_back(row[order[i]]);
+      expected_indices.push_back(order[i]);
+    }
+  }
+  RunTest(11, k, input_vals, {rows, cols}, expected_vals, expected_indices, {rows, k}, false, 1, 0);
+}
+
+TEST(TopKOperator, TopKInt64) {
+  OpTester test("TopK", 11);
+  test.AddAttribute("largest", static_cast<int64_t>(0));
+  test.AddInput<int64_t>("X", {2, 4}, {4, 1, 3, 1, 7, 8, 6, 5});
+  test.AddInput<int64_t>("K", {1}, {2});
+  test.AddOutput<int64_t>("Values", {2, 2}, {1, 1, 5, 6});
+  test.AddOutput<int64_t>("Indices", {2, 2}, {1, 3, 3, 2});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -168,5 +168,34 @@ TEST(LabelEncoder, Int64ToFloatOpset2) {
   test.Run();
 }
 
+// enough keys for the map to grow several times, and keys that are multiples of a large power of two
+TEST(LabelEncoder, ManyInt64KeysToStringOpset2) {
+  const int64_t num_keys = 1000;
+  std::vector<std::int64_t> keys;
+  std::vector<std::string> values;
+  for (int64_t i = 0; i < num_keys; ++i) {
+    keys.push_back(i << 20);
+    values.push_back("v" + std::to_string(i));
+  }
+
+  std::vector<std::int64_t> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < 2 * num_keys; ++i) {
+    input.push_back((i % 2 == 0) ? (i / 2) << 20 : i);
+    output.push_back((i % 2 == 0) ? values[i / 2] : "_Missing");
+  }
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_int64s", keys);
+  test.AddAttribute("values_strings", values);
+  test.AddAttribute("default_string", std::string("_Missing"));
+
+  test.AddInput<std::int64_t>("X", {2 * num_keys}, input);
+  test.AddOutput<std::string>("Y", {2 * num_keys}, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -54,6 +54,92 @@ TEST(MLOpTest, TreeEnsembleClassifier) {
   test.Run();
 }
 
+// the trees of the TreeEnsembleClassifier test, with the rows of X and the class ids of the leaf weights in arguments
+void RunTreeEnsembleClassifierTest(const std::vector<float>& X, const std::vector<int64_t>& results,
+                                   const std::vector<float>& scores, const std::vector<int64_t>& class_treeids,
+                                   const std::vector<int64_t>& class_classids,
+                                   OpTester::ExpectResult expect_result = OpTester::ExpectResult::kExpectSuccess,
+                                   const std::string& expected_error = "") {
+  OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, -1, 3, -1, -1, 1, -1, 3, 4, -1, -1, -1, 1, 2, -1, 4, -1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, 4, -1, -1, 2, -1, 6, 5, -1, -1, -1, 6, 3, -1, 5, -1, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> featureids = {2, -2, 0, -2, -2, 0, -2, 2, 1, -2, -2, -2, 0, 2, -2, 1, -2, -2, -2};
+  std::vector<float> thresholds = {-172.f, -2.f, 2.5f, -2.f, -2.f, 1.5f, -2.f, -62.5f, 213.09999084f,
+                                   -2.f, -2.f, -2.f, 27.5f, -172.f, -2.f, 8.10000038f, -2.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ",
+                                    "LEAF", "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF",
+                                    "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF"};
+  std::vector<int64_t> class_nodeids = {1, 3, 4, 1, 4, 5, 6, 2, 4, 5, 6};
+  std::vector<float> class_weights = {1.f, 4.f, 1.f, 2.f, 1.f, 1.f, 2.f, 1.f, 1.f, 1.f, 3.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3};
+  const auto N = static_cast<int64_t>(X.size()) / 3;
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_classids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  test.AddInput<float>("X", {N, 3}, X);
+  test.AddOutput<int64_t>("Y", {N}, results);
+  test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
+  test.Run(expect_result, expected_error);
+}
+
+const std::vector<int64_t> kClassTreeIds = {0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2};
+const std::vector<int64_t> kClassIds = {2, 0, 1, 0, 2, 3, 1, 2, 0, 1, 3};
+
+// more rows than a block of the tree traversal, which the threads split by rows
+TEST(MLOpTest, TreeEnsembleClassifierManyRows) {
+  std::vector<float> X = {-1.f, 8.f, -62.5f, 3.f, 214.f, -100.f, 1.f, 213.f, 0.f, 2.f, 213.f, -100.f,
+                          30.f, 213.f, -172.f, 1.f, 0.f, -172.f, 1.f, 8.f, 5.f, 1.f, 0.f, -62.5f,
+                          27.5f, 8.f, -100.f, 2.f, 0.f, -172.f, 3.f, 214.f, -100.f, 27.5f, 214.f, -100.f,
+                          1.f, 214.f, 0.f, 30.f, 0.f, -62.5f, 30.f, 214.f, -62.5f, 3.f, 213.f, -62.5f,
+                          -1.f, 213.f, 5.f, 3.f, 0.f, -172.f, -1.f, 8.f, -62.5f, 1.f, 0.f, -100.f,
+                          27.5f, 0.f, -312.f, -1.f, 214.f, -172.f, 27.5f, 0.f, -100.f, 27.5f, 0.f, -312.f,
+                          1.f, 214.f, -62.5f, 1.f, 9.f, -100.f, 27.5f, 9.f, -62.5f, -1.f, 0.f, -62.5f,
+                          3.f, 213.f, -62.5f, 2.f, 0.f, -172.f, -1.f, 9.f, 5.f, 2.f, 213.f, 5.f,
+                          1.f, 214.f, -312.f, 1.f, 214.f, -100.f, 1.f, 214.f, -312.f, 27.5f, 9.f, 5.f,
+                          -1.f, 9.f, 0.f};
+  std::vector<int64_t> results = {0, 1, 0, 0, 3, 0, 0, 0, 0, 2, 1, 1, 0, 3, 3, 1, 0, 2, 0, 0,
+                                  2, 0, 0, 2, 0, 0, 1, 0, 1, 2, 0, 0, 0, 0, 0, 1, 0};
+  std::vector<float> scores = {7.f, 0.f, 0.f, 0.f, 0.f, 2.f, 0.f, 1.f, 6.f, 1.f, 0.f, 0.f, 4.f, 1.f, 1.f, 0.f,
+                               0.f, 0.f, 2.f, 3.f, 2.f, 0.f, 2.f, 0.f, 7.f, 0.f, 0.f, 0.f, 7.f, 0.f, 0.f, 0.f,
+                               1.f, 1.f, 1.f, 0.f, 0.f, 0.f, 3.f, 0.f, 0.f, 2.f, 0.f, 1.f, 0.f, 2.f, 0.f, 1.f,
+                               6.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 3.f, 0.f, 1.f, 0.f, 4.f, 0.f, 2.f, 1.f, 0.f,
+                               6.f, 1.f, 0.f, 0.f, 0.f, 0.f, 3.f, 0.f, 7.f, 0.f, 0.f, 0.f, 7.f, 0.f, 0.f, 0.f,
+                               0.f, 0.f, 3.f, 0.f, 2.f, 0.f, 2.f, 0.f, 1.f, 1.f, 1.f, 0.f, 0.f, 0.f, 3.f, 0.f,
+                               6.f, 1.f, 0.f, 0.f, 6.f, 1.f, 0.f, 0.f, 0.f, 2.f, 1.f, 0.f, 7.f, 0.f, 0.f, 0.f,
+                               0.f, 2.f, 1.f, 0.f, 0.f, 0.f, 3.f, 0.f, 6.f, 1.f, 0.f, 0.f, 4.f, 3.f, 0.f, 0.f,
+                               2.f, 0.f, 2.f, 0.f, 6.f, 1.f, 0.f, 0.f, 2.f, 0.f, 2.f, 0.f, 0.f, 4.f, 0.f, 0.f,
+                               6.f, 1.f, 0.f, 0.f};
+
+  RunTreeEnsembleClassifierTest(X, results, scores, kClassTreeIds, kClassIds);
+}
+
+// a single row, which the threads split by trees
+TEST(MLOpTest, TreeEnsembleClassifierSingleRow) {
+  RunTreeEnsembleClassifierTest({-1.f, 8.f, -62.5f}, {0}, {7.f, 0.f, 0.f, 0.f}, kClassTreeIds, kClassIds);
+}
+
+TEST(MLOpTest, TreeEnsembleClassifierInvalidIds) {
+  const std::vector<float> X = {-1.f, 8.f, -62.5f};
+  RunTreeEnsembleClassifierTest(X, {0}, {7.f, 0.f, 0.f, 0.f}, kClassTreeIds, {2, 0, 1, 0, 2, 3, 1, 2, 0, 1, -1},
+                                OpTester::ExpectResult::kExpectFailure, "Invalid class id -1.");
+  RunTreeEnsembleClassifierTest(X, {0}, {7.f, 0.f, 0.f, 0.f}, {0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 3}, kClassIds,
+                                OpTester::ExpectResult::kExpectFailure, "Invalid tree id 3 for class weight 10.");
+}
+
 TEST(MLOpTest, TreeEnsembleClassifierLabels) {
   OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
 
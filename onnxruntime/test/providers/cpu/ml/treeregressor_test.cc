@@ -52,8 +52,9 @@ void GenTreeAndRunTest(const std::vector<T>& X, const std::vector<float>& base_v
   } // default function is SUM
 
   //fill input data
-  test.AddInput<T>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 2}, results);
+  const int64_t N = static_cast<int64_t>(X.size()) / 3;
+  test.AddInput<T>("X", {N, 3}, X);
+  test.AddOutput<float>("Y", {N, 2}, results);
   test.Run();
 }
 
@@ -85,6 +86,67 @@ TEST(MLOpTest, TreeRegressorMultiTargetMaxDouble) {
   GenTreeAndRunTest<double>(X, base_values, results, "MAX");
 }
 
+// more rows than a block of the tree traversal, which the threads split by rows
+std::vector<float> GetManyRowsX() {
+  return {17.f, 8.f, 10.5f, -1.f, 0.f, -213.f, 17.f, 200.f, -312.f, 2.f, 0.f, -213.f,
+          28.f, 13.5f, -213.f, 2.f, 0.f, 10.5f, -1.f, 200.f, -213.f, 2.f, 250.f, -312.f,
+          28.f, 0.f, -100.f, -1.f, 200.f, -200.f, 3.f, 13.5f, -200.f, 1.f, 200.f, -50.f,
+          1.5f, 0.f, -100.f, 17.f, 0.f, -213.f, -1.f, 200.f, -100.f, 44.f, 250.f, 10.5f,
+          17.f, 13.5f, 11.f, 17.f, 12.5f, -100.f, 1.5f, 250.f, -100.f, 1.f, 200.f, -50.f,
+          44.f, 12.5f, 11.f, 3.f, 200.f, -213.f, 1.f, 200.f, 10.5f, 1.5f, 12.5f, -200.f,
+          44.f, 13.5f, -312.f, 1.f, 200.f, 0.f, 17.f, 250.f, 0.f, 44.f, 200.f, 11.f,
+          1.f, 0.f, -50.f, 44.f, 250.f, -213.f, -1.f, 250.f, -50.f, 44.f, 12.5f, 10.5f,
+          17.f, 0.f, 11.f, 17.f, 8.f, -213.f, 44.f, 0.f, -100.f, 3.f, 8.f, -100.f,
+          28.f, 13.5f, 11.f};
+}
+
+TEST(MLOpTest, TreeRegressorMultiTargetManyRowsSum) {
+  std::vector<float> results = {8.f, 59.f, 5.f, 86.f, 9.f, 50.f, 7.f, 68.f, 9.f, 50.f, 8.f, 59.f,
+                                7.f, 68.f, 9.f, 50.f, 8.f, 59.f, 7.f, 68.f, 10.f, 41.f, 7.f, 68.f,
+                                5.f, 86.f, 7.f, 68.f, 7.f, 68.f, 10.f, 41.f, 7.f, 68.f, 8.f, 59.f,
+                                7.f, 68.f, 7.f, 68.f, 6.f, 77.f, 9.f, 50.f, 7.f, 68.f, 5.f, 86.f,
+                                9.f, 50.f, 7.f, 68.f, 10.f, 41.f, 7.f, 68.f, 5.f, 86.f, 9.f, 50.f,
+                                7.f, 68.f, 8.f, 59.f, 6.f, 77.f, 7.f, 68.f, 8.f, 59.f, 8.f, 59.f,
+                                7.f, 68.f};
+  std::vector<float> base_values{1.f, -1.f};
+  GenTreeAndRunTest<float>(GetManyRowsX(), base_values, results, "SUM");
+}
+
+TEST(MLOpTest, TreeRegressorMultiTargetManyRowsAverageDouble) {
+  std::vector<float> X = GetManyRowsX();
+  std::vector<float> results = {2.33333333f, 20.f, 1.33333333f, 29.f, 2.66666667f, 17.f, 2.f, 23.f,
+                                2.66666667f, 17.f, 2.33333333f, 20.f, 2.f, 23.f, 2.66666667f, 17.f,
+                                2.33333333f, 20.f, 2.f, 23.f, 3.f, 14.f, 2.f, 23.f,
+                                1.33333333f, 29.f, 2.f, 23.f, 2.f, 23.f, 3.f, 14.f,
+                                2.f, 23.f, 2.33333333f, 20.f, 2.f, 23.f, 2.f, 23.f,
+                                1.66666667f, 26.f, 2.66666667f, 17.f, 2.f, 23.f, 1.33333333f, 29.f,
+                                2.66666667f, 17.f, 2.f, 23.f, 3.f, 14.f, 2.f, 23.f,
+                                1.33333333f, 29.f, 2.66666667f, 17.f, 2.f, 23.f, 2.33333333f, 20.f,
+                                1.66666667f, 26.f, 2.f, 23.f, 2.33333333f, 20.f, 2.33333333f, 20.f,
+                                2.f, 23.f};
+  std::vector<float> base_values{0.f, 0.f};
+  GenTreeAndRunTest<double>(std::vector<double>(X.begin(), X.end()), base_values, results, "AVERAGE");
+}
+
+TEST(MLOpTest, TreeRegressorMultiTargetManyRowsMax) {
+  std::vector<float> results = {3.f, 23.f, 2.f, 41.f, 3.f, 23.f, 2.f, 23.f, 3.f, 23.f, 3.f, 23.f,
+                                3.f, 41.f, 3.f, 23.f, 3.f, 23.f, 3.f, 41.f, 3.f, 14.f, 3.f, 41.f,
+                                2.f, 41.f, 2.f, 23.f, 3.f, 41.f, 3.f, 14.f, 3.f, 41.f, 3.f, 23.f,
+                                3.f, 41.f, 3.f, 41.f, 3.f, 41.f, 3.f, 23.f, 3.f, 41.f, 2.f, 41.f,
+                                3.f, 23.f, 3.f, 41.f, 3.f, 14.f, 3.f, 41.f, 2.f, 41.f, 3.f, 23.f,
+                                3.f, 41.f, 3.f, 23.f, 3.f, 41.f, 2.f, 23.f, 3.f, 23.f, 3.f, 23.f,
+                                3.f, 41.f};
+  std::vector<float> base_values{0.f, 0.f};
+  GenTreeAndRunTest<float>(GetManyRowsX(), base_values, results, "MAX");
+}
+
+// a single row, which the threads split by trees
+TEST(MLOpTest, TreeRegressorMultiTargetSingleRow) {
+  std::vector<float> X = {17.f, 8.f, 10.5f};
+  std::vector<float> results = {8.f, 59.f};
+  std::vector<float> base_values{1.f, -1.f};
+  GenTreeAndRunTest<float>(X, base_values, results, "SUM");
+}
 
 TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
@@ -130,5 +192,64 @@ TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   test.Run();
 }
 
+// a single tree of 5 nodes that is made invalid by the arguments, which must be rejected
+void RunInvalidTreeTest(const std::vector<int64_t>& lefts, const std::vector<int64_t>& rights,
+                        const std::vector<std::string>& modes, const std::vector<int64_t>& featureids,
+                        const std::vector<int64_t>& target_treeids, const std::string& expected_error) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4};
+  std::vector<float> thresholds = {1.f, 0.f, 2.f, 0.f, 0.f};
+  std::vector<int64_t> target_nodeids = {2, 3, 4};
+  std::vector<int64_t> target_ids = {0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 3.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<float>("X", {2, 3}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f});
+  test.AddOutput<float>("Y", {2, 1}, {1.f, 3.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, expected_error);
+}
+
+TEST(MLOpTest, TreeRegressorInvalidTrees) {
+  const std::vector<int64_t> lefts = {1, 2, 0, 0, 0};
+  const std::vector<int64_t> rights = {4, 3, 0, 0, 0};
+  const std::vector<std::string> modes = {"BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF"};
+  const std::vector<int64_t> featureids = {0, 0, 0, 0, 0};
+  const std::vector<int64_t> target_treeids = {0, 0, 0};
+
+  // a child id past the last node of the tree
+  RunInvalidTreeTest({1, 5, 0, 0, 0}, rights, modes, featureids, target_treeids,
+                     "Invalid child node id for tree node 1.");
+  // the root is its own child and node 2 branches to node 1, so the tree has no root
+  RunInvalidTreeTest({0, 2, 1, 0, 0}, {4, 3, 3, 0, 0}, {"BRANCH_LEQ", "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF"},
+                     featureids, target_treeids, "Found 0 root nodes for 1 trees");
+  // node 3 isn't the child of any node, so it is a second root
+  RunInvalidTreeTest(lefts, {4, 2, 0, 0, 0}, modes, featureids, target_treeids,
+                     "Found 2 root nodes for 1 trees");
+  // node 2 branches to nodes 3 and 4, which are also the children of nodes 1 and 0
+  RunInvalidTreeTest({1, 2, 3, 0, 0}, {4, 3, 4, 0, 0}, {"BRANCH_LEQ", "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF"},
+                     featureids, target_treeids, "Tree node 3 is reached from more than one node");
+  // a branch on a negative feature
+  RunInvalidTreeTest(lefts, rights, modes, {0, -1, 0, 0, 0}, target_treeids, "Invalid feature id -1");
+  // a branch on a feature past the end of the rows
+  RunInvalidTreeTest(lefts, rights, modes, {0, 3, 0, 0, 0}, target_treeids,
+                     "Input has 3 features but the trees use feature 3.");
+  // a weight for a tree that doesn't exist
+  RunInvalidTreeTest(lefts, rights, modes, featureids, {0, 0, 1}, "Invalid tree id 1 for target weight 2.");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -608,6 +608,52 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+// each group reads two of the input channels
+TEST(ConvTest, Conv2D_group_2x2) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      2,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, -1.0f, 0.0f, 1.0f, 0.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+  vector<int64_t> X_shape = {1, 4, 2, 2};
+  vector<float> W = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<int64_t> Y_shape = {1, 2, 1, 1};
+  auto expected_vals = {15.0f, 1.0f};
+
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
+}
+
+// a depthwise convolution with two output channels for each input channel
+TEST(ConvTest, Conv2D_depthwise_multiplier) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      2,                            // group
+      vector<int64_t>{2, 2},        // kernel_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f};
+  vector<int64_t> W_shape = {4, 1, 2, 2};
+  vector<float> B = {1.0f, 2.0f, 3.0f, 4.0f};
+  vector<int64_t> B_shape = {4};
+  vector<int64_t> Y_shape = {1, 4, 1, 1};
+  auto expected_vals = {6.0f, 12.0f, 8.0f, -4.0f};
+
+  TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 TEST(ConvTest, ConvDimWithZero) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
@@ -632,5 +678,42 @@ TEST(ConvTest, ConvDimWithZero) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, {}, out_shape, OpTester::ExpectResult::kExpectSuccess, "", 10);
 }
 
+// A constant 3x3 W with enough channels is transformed when the session is created for the Winograd algorithm.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t C = 16;
+  constexpr int64_t M = 24;
+  constexpr int64_t H = 5;
+  constexpr int64_t W = 6;
+
+  OpTester test("Conv", 11);
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+
+  // the filters of output channel m are all (m % 5) - 2 and the output is the bias plus that value times the
+  // number of input elements under the kernel
+  vector<float> X_data(C * H * W, 1.0f);
+  vector<float> W_data(M * C * 3 * 3);
+  vector<float> B_data(M);
+  vector<float> Y_data(M * H * W);
+  for (int64_t m = 0; m < M; m++) {
+    const float weight = static_cast<float>(m % 5 - 2);
+    std::fill_n(W_data.begin() + m * C * 3 * 3, C * 3 * 3, weight);
+    B_data[m] = static_cast<float>(m);
+    for (int64_t h = 0; h < H; h++) {
+      for (int64_t w = 0; w < W; w++) {
+        const int64_t rows = 3 - (h == 0) - (h == H - 1);
+        const int64_t cols = 3 - (w == 0) - (w == W - 1);
+        Y_data[(m * H + h) * W + w] = B_data[m] + weight * static_cast<float>(C * rows * cols);
+      }
+    }
+  }
+
+  test.AddInput<float>("X", {1, C, H, W}, X_data);
+  test.AddInput<float>("W", {M, C, 3, 3}, W_data, true);
+  test.AddInput<float>("B", {M}, B_data, true);
+  test.AddOutput<float>("Y", {1, M, H, W}, Y_data);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -378,6 +378,30 @@ TEST(ConvTransposeTest, ConvTranspose_onnx_group) {
   TestConvTransposeOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+TEST(ConvTransposeTest, ConvTranspose_2D_Stride2_Group_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{2, 2},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{2, 2},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      2                             // group
+  };
+  vector<float> X = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f};
+  vector<int64_t> X_shape = {2, 2, 2, 2};
+  vector<float> W = {1.f, 2.f, 3.f, 4.f, -1.f, 0.5f, 2.f, -2.f};
+  vector<int64_t> W_shape = {2, 1, 2, 2};
+  vector<float> B = {0.5f, -1.f};
+  vector<int64_t> B_shape = {2};
+  vector<int64_t> Y_shape = {2, 2, 4, 4};
+  auto expected_vals = {0.5f, 0.5f, 1.5f, 2.5f, 0.5f, 0.5f, 3.5f, 4.5f, 2.5f, 4.5f, 3.5f, 6.5f, 6.5f, 8.5f, 9.5f, 12.5f,
+                        -5.f, 1.f, -6.f, 1.5f, 7.f, -9.f, 9.f, -11.f, -7.f, 2.f, -8.f, 2.5f, 11.f, -13.f, 13.f, -15.f,
+                        8.5f, 16.5f, 9.5f, 18.5f, 24.5f, 32.5f, 27.5f, 36.5f, 10.5f, 20.5f, 11.5f, 22.5f, 30.5f, 40.5f, 33.5f, 44.5f,
+                        -13.f, 5.f, -14.f, 5.5f, 23.f, -25.f, 25.f, -27.f, -15.f, 6.f, -16.f, 6.5f, 27.f, -29.f, 29.f, -31.f};
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 TEST(ConvTransposeTest, ConvTranspose_2D_Dilation_1) {
   ConvTransposeOpAttributes attrs = {
       vector<int64_t>{2, 2},
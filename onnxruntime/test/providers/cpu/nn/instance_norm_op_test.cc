@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
@@ -114,5 +116,43 @@ TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+TEST(InstanceNormalizationOpTest, InstanceNorm_LargeMean) {
+  OpTester test("InstanceNormalization");
+  const float epsilon = 1e-5F;
+  test.AddAttribute("epsilon", epsilon);
+
+  // the deviations are small relative to the mean, which the statistics must not lose
+  const int64_t N = 2, C = 3, W = 37;
+  vector<float> input(N * C * W);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 100.0F * static_cast<float>(i / W + 1) + static_cast<float>((i * 7) % 23) / 11.0F;
+  }
+  const vector<float> scale = {1.5F, -0.5F, 2.0F};
+  const vector<float> B = {0.25F, 1.0F, -3.0F};
+
+  vector<float> expected_output(input.size());
+  for (int64_t i = 0; i < N * C; ++i) {
+    double mean = 0.0;
+    for (int64_t j = 0; j < W; ++j) {
+      mean += input[i * W + j];
+    }
+    mean /= W;
+    double variance = 0.0;
+    for (int64_t j = 0; j < W; ++j) {
+      variance += (input[i * W + j] - mean) * (input[i * W + j] - mean);
+    }
+    const double inv_stdev = 1.0 / std::sqrt(variance / W + epsilon);
+    for (int64_t j = 0; j < W; ++j) {
+      expected_output[i * W + j] = static_cast<float>((input[i * W + j] - mean) * inv_stdev * scale[i % C] + B[i % C]);
+    }
+  }
+
+  test.AddInput<float>("input", {N, C, W}, input);
+  test.AddInput<float>("scale", {C}, scale);
+  test.AddInput<float>("B", {C}, B);
+  test.AddOutput<float>("Y", {N, C, W}, expected_output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
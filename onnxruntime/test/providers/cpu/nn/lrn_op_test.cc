@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
@@ -102,5 +105,43 @@ TEST(LRNTest, LRN_2) {
   test.Run();
 }
 
+TEST(LRNTest, LRN_MultipleColumnBlocks) {
+  OpTester test("LRN");
+  const float alpha = .01f;
+  const float beta = .75f;
+  const float bias = 1.5f;
+  const int64_t size = 3;
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddAttribute("bias", bias);
+  test.AddAttribute("size", size);
+
+  // the 17 x 19 columns of each channel span two blocks
+  const int64_t N = 2, C = 6, HW = 17 * 19;
+  vector<float> X(N * C * HW);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>((i * 7) % 23) / 5.0f - 2.0f;
+  }
+
+  vector<float> expected_output(X.size());
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      for (int64_t i = 0; i < HW; ++i) {
+        double sum_squares = 0.0;
+        for (int64_t j = std::max<int64_t>(c - 1, 0); j <= std::min<int64_t>(c + 1, C - 1); ++j) {
+          const double value = X[(n * C + j) * HW + i];
+          sum_squares += value * value;
+        }
+        const auto index = (n * C + c) * HW + i;
+        expected_output[index] = static_cast<float>(X[index] / std::pow(bias + alpha / size * sum_squares, beta));
+      }
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, 17, 19}, X);
+  test.AddOutput<float>("Y", {N, C, 17, 19}, expected_output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
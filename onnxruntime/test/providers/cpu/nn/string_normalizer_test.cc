@@ -165,6 +165,26 @@ TEST(ContribOpTest, StringNormalizerTest) {
     test.AddOutput<std::string>("Y", {6}, output);
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
+  // - case-INSENSETIVE approach en_US locale
+  // - ascii and non-ascii stopwords and strings mixed
+  // - filter out monday and école in any case
+  // - LOWER changes the case of the rest
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"MONDAY", u8"École"}, test_locale);
+    std::vector<int64_t> dims{5};
+    std::vector<std::string> input = {std::string(u8"Monday"),
+                                      std::string(u8"ÉCOLE"),
+                                      std::string(u8"Tuesday"),
+                                      std::string(u8"Besançon"),
+                                      std::string(u8"école")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"tuesday"),
+                                       std::string(u8"besançon")};
+    test.AddOutput<std::string>("Y", {2}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
 
   // Empty output case
   // - casesensitive approach
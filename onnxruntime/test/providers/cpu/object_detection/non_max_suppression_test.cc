@@ -1,7 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
+
 #include "gtest/gtest.h"
+#include "core/providers/cpu/object_detection/non_max_suppression_helper.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -288,6 +292,114 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManyClasses) {
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, 3, 4},
+                       {0.0f, 0.0f, 1.0f, 1.0f,
+                        0.0f, 0.1f, 1.0f, 1.1f,
+                        0.0f, 10.0f, 1.0f, 11.0f});
+
+  // the classes prefer different boxes, and boxes with the same score are selected in order of their index
+  const int64_t num_classes = 64;
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t c = 0; c < num_classes; ++c) {
+    const int64_t best = c % 3;
+    for (int64_t b = 0; b < 3; ++b) {
+      scores.push_back(b == best ? 0.9f : 0.5f);
+    }
+    // box 0 and 1 overlap, so the other one of them is suppressed
+    std::vector<int64_t> boxes = best == 2 ? std::vector<int64_t>{2, 0} : std::vector<int64_t>{best, 2};
+    for (int64_t box : boxes) {
+      selected_indices.insert(selected_indices.end(), {0, c, box});
+    }
+  }
+
+  test.AddInput<float>("scores", {1, num_classes, 3}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {3L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddOutput<int64_t>("selected_indices", {num_classes * 2, 3}, selected_indices);
+  // the order of boxes with the same score is not specified, and only the CPU provider orders them by index
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider});
+}
+
+// many batches and classes with more boxes than a block of the CUDA kernels handles, so the scores of all of them
+// are sorted together and the overlap masks take several words per box. the scores are distinct so the order of
+// the selected boxes is the same on every provider, and the expected result is computed greedily.
+static void RunManyBatchesAndClasses(int64_t max_output_boxes_per_class, float score_threshold) {
+  const int64_t num_batches = 3;
+  const int64_t num_classes = 5;
+  const int64_t num_boxes = 700;
+  const float iou_threshold = 0.4f;
+
+  // boxes on a grid of half units, so the overlaps are exact
+  std::vector<float> boxes;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t i = 0; i < num_boxes; ++i) {
+      const float y = static_cast<float>((i + b) % 20) * 0.5f;
+      const float x = static_cast<float>((i / 20) % 20) * 0.5f;
+      const float size = 1.0f + static_cast<float>(i % 3) * 0.5f;
+      boxes.insert(boxes.end(), {y, x, y + size, x + size});
+    }
+  }
+
+  std::vector<float> scores;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t c = 0; c < num_classes; ++c) {
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        const int64_t rank = (i * 389 + c * 97 + b * 31) % num_boxes;
+        scores.push_back(static_cast<float>(rank + 1) / static_cast<float>(num_boxes + 1));
+      }
+    }
+  }
+
+  std::vector<int64_t> selected_indices;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    const float* batch_boxes = boxes.data() + b * num_boxes * 4;
+    for (int64_t c = 0; c < num_classes; ++c) {
+      const float* class_scores = scores.data() + (b * num_classes + c) * num_boxes;
+      std::vector<int64_t> candidates;
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        if (class_scores[i] > score_threshold) {
+          candidates.push_back(i);
+        }
+      }
+      std::sort(candidates.begin(), candidates.end(),
+                [class_scores](int64_t l, int64_t r) { return class_scores[l] > class_scores[r]; });
+
+      std::vector<int64_t> selected;
+      for (int64_t candidate : candidates) {
+        if (static_cast<int64_t>(selected.size()) == max_output_boxes_per_class) {
+          break;
+        }
+        if (std::none_of(selected.begin(), selected.end(), [&](int64_t box) {
+              return nms_helpers::SuppressByIOU(batch_boxes, box, candidate, 0, iou_threshold);
+            })) {
+          selected.push_back(candidate);
+          selected_indices.insert(selected_indices.end(), {b, c, candidate});
+        }
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output_boxes_per_class});
+  test.AddInput<float>("iou_threshold", {}, {iou_threshold});
+  test.AddInput<float>("score_threshold", {}, {score_threshold});
+  test.AddOutput<int64_t>("selected_indices", {static_cast<int64_t>(selected_indices.size() / 3), 3},
+                          selected_indices);
+  test.Run();
+}
+
+TEST(NonMaxSuppressionOpTest, ManyBatchesAndClasses) {
+  // the selection of each class stops at max_output_boxes_per_class
+  RunManyBatchesAndClasses(20, 0.0f);
+  // every box that is not suppressed is selected, and the boxes below the threshold are ignored
+  RunManyBatchesAndClasses(1000, 0.3f);
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include <algorithm>
+#include <limits>
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/cpu/reduction/reduction_test_cases.h"
@@ -873,6 +875,72 @@ TEST(ReductionOpTest, ReduceSum_int64) {
   test.Run();
 }
 
+// a single output from many values, which is computed in chunks that are combined afterwards
+TEST(ReductionOpTest, ReduceSum_large_single_output) {
+  OpTester test("ReduceSum");
+  test.AddAttribute("keepdims", (int64_t)0);
+
+  std::vector<float> data(2 * 64 * 1024);
+  float expected = 0.f;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 7);
+    expected += data[i];
+  }
+
+  test.AddInput<float>("data", {2, 64, 1024}, data);
+  test.AddOutput<float>("reduced", {}, {expected});
+  test.Run();
+}
+
+// a row per output over the last axis, whose length isn't a multiple of the vector loads of the CUDA kernel
+TEST(ReductionOpTest, ReduceMean_last_axis_many_rows) {
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{-1});
+  test.AddAttribute("keepdims", (int64_t)1);
+
+  const int64_t rows = 37;
+  const int64_t cols = 129;
+  std::vector<float> data(rows * cols);
+  std::vector<float> expected(rows, 0.f);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      data[r * cols + c] = static_cast<float>((r + c) % 5);
+      expected[r] += data[r * cols + c];
+    }
+    expected[r] /= static_cast<float>(cols);
+  }
+
+  test.AddInput<float>("data", {rows, cols}, data);
+  test.AddOutput<float>("reduced", {rows, 1}, expected);
+  test.Run();
+}
+
+// reduce axes in the middle and at the start of the input, which are strided in memory
+TEST(ReductionOpTest, ReduceMax_strided_axes) {
+  OpTester test("ReduceMax");
+  test.AddAttribute("axes", std::vector<int64_t>{0, 2});
+  test.AddAttribute("keepdims", (int64_t)1);
+
+  const int64_t D0 = 3, D1 = 4, D2 = 500, D3 = 5;
+  std::vector<float> data(D0 * D1 * D2 * D3);
+  std::vector<float> expected(D1 * D3, std::numeric_limits<float>::lowest());
+  for (int64_t i0 = 0; i0 < D0; ++i0) {
+    for (int64_t i1 = 0; i1 < D1; ++i1) {
+      for (int64_t i2 = 0; i2 < D2; ++i2) {
+        for (int64_t i3 = 0; i3 < D3; ++i3) {
+          const float value = static_cast<float>((i0 * 31 + i2 * 7) % 101 + i1 * 1000 + i3 * 200);
+          data[((i0 * D1 + i1) * D2 + i2) * D3 + i3] = value;
+          expected[i1 * D3 + i3] = std::max(expected[i1 * D3 + i3], value);
+        }
+      }
+    }
+  }
+
+  test.AddInput<float>("data", {D0, D1, D2, D3}, data);
+  test.AddOutput<float>("reduced", {1, D1, 1, D3}, expected);
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceSum_default_axes_keepdims) {
   OpTester test("ReduceSum");
   test.AddAttribute("keepdims", (int64_t)1);
@@ -449,5 +449,18 @@ TEST(SequenceOpsTest, SplitToSequence_PositiveAxisDontKeepDims) {
   test.AddSeqOutput("S2", output);
   test.Run();
 }
+
+TEST(SequenceOpsTest, SplitToSequence_StringPositiveAxisUnevenSplit) {
+  OpTester test("SplitToSequence", 11);
+  test.AddInput<std::string>("input", {2, 3}, {"a", "b", "c", "d", "e", "f"});
+  test.AddInput<int64_t>("split", {}, {2});
+  int64_t axis = 1;
+  test.AddAttribute("axis", axis);
+  SeqTensors<std::string> output;
+  output.AddTensor({2, 2}, {"a", "b", "d", "e"});
+  output.AddTensor({2, 1}, {"c", "f"});
+  test.AddSeqOutput("S2", output);
+  test.Run();
+}
 }  // namespace test
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -47,5 +47,23 @@ TEST(QuantizeLinearOpTest, DynamicQuantizeLinear_Max_Adjusted) {
   test.Run();
 }
 
+
+// the range of tensors larger than a block is found by several threads
+TEST(QuantizeLinearOpTest, DynamicQuantizeLinear_LargeTensor) {
+  OpTester test("DynamicQuantizeLinear", 11);
+  std::vector<int64_t> dims{3, 20000};
+  std::vector<float> x(3 * 20000);
+  std::vector<uint8_t> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    const int value = static_cast<int>((i * 7919) % 256);
+    x[i] = static_cast<float>(value - 55);
+    y[i] = static_cast<uint8_t>(value);
+  }
+  test.AddInput<float>("x", dims, x);
+  test.AddOutput<uint8_t>("y", dims, y);
+  test.AddOutput<float>("y_scale", {}, {1.0f});
+  test.AddOutput<uint8_t>("y_zero_point", {}, {55});
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -323,5 +323,34 @@ TEST(GatherOpTest, Gather_axis1_neg_indices2d_int8) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  //TensorRT: Assertion `regionRanges != nullptr' failed
 }
 
+// consecutive indices are copied as a single range, which must stop at the end of each batch
+TEST(GatherOpTest, Gather_axis1_consecutive_indices) {
+  OpTester test("Gather", 11);
+  test.AddAttribute<int64_t>("axis", 1LL);
+  test.AddInput<float>("data", {2, 4, 2},
+                       {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f,
+                        10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f, 17.f});
+  test.AddInput<int64_t>("indices", {5}, {1, 2, 3, -3, 0});
+  test.AddOutput<float>("output", {2, 5, 2},
+                        {2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 2.f, 3.f, 0.f, 1.f,
+                         12.f, 13.f, 14.f, 15.f, 16.f, 17.f, 12.f, 13.f, 10.f, 11.f});
+  test.Run();
+}
+
+TEST(GatherOpTest, Gather_axis0_string_rows) {
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<std::string>("data", {3, 2},
+                             {"0", "1",
+                              "10", "11",
+                              "20", "21"});
+  test.AddInput<int64_t>("indices", {3}, {2, 0, 1});
+  test.AddOutput<std::string>("output", {3, 2},
+                              {"20", "21",
+                               "0", "1",
+                               "10", "11"});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -469,6 +471,34 @@ TEST(TensorOpTest, Pad_Edge_DimWithZeroInput) {
                                "edge");
 }
 
+TEST(TensorOpTest, Pad_Edge_4D_UnpaddedOuterAxes) {
+  // the two leading axes are not padded and are processed in parallel as one axis
+  const std::vector<int64_t> input_dims = {2, 3, 2, 3};
+  std::vector<float> input(36);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> output;
+  for (int64_t n = 0; n < 6; ++n) {
+    for (int64_t h = 0; h < 4; ++h) {
+      const int64_t in_h = std::min<int64_t>(std::max<int64_t>(h - 1, 0), 1);
+      for (int64_t w = 0; w < 5; ++w) {
+        const int64_t in_w = std::min<int64_t>(std::max<int64_t>(w - 2, 0), 2);
+        output.push_back(input[(n * 2 + in_h) * 3 + in_w]);
+      }
+    }
+  }
+
+  RunAllOpsetAllDomainPadTests(input_dims,
+                               input,
+                               {0, 0, 1, 2, 0, 0, 1, 0},
+                               0.0f,
+                               {2, 3, 4, 5},
+                               output,
+                               "edge");
+}
+
 TEST(TensorOpTest, Pad_Reflect_DimWithZeroInput) {
   RunAllOpsetAllDomainPadTests({2, 0},  // 2D
                                {},
@@ -4,6 +4,8 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 namespace test {
 // scalar zero & scale with uint8
@@ -110,5 +112,39 @@ TEST(QuantizeLinearOpTest, QuantizeLinear_1) {
                            0, 0, 1, 250});
   test.Run();
 }
+
+// tensors larger than a block are quantized and dequantized by several threads
+TEST(QuantizeLinearOpTest, QuantizeLinear_LargeTensor) {
+  OpTester test("QuantizeLinear", 10);
+  std::vector<int64_t> dims{5, 8191};
+  std::vector<float> x(5 * 8191);
+  std::vector<uint8_t> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    const int value = static_cast<int>(i % 301) - 150;
+    x[i] = static_cast<float>(value);
+    y[i] = static_cast<uint8_t>(std::max(0, std::min(255, value + 100)));
+  }
+  test.AddInput<float>("x", dims, x);
+  test.AddInput<float>("y_scale", {}, {1.0f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+  test.AddOutput<uint8_t>("y", dims, y);
+  test.Run();
+}
+
+TEST(DequantizeLinearOpTest, DequantizeLinear_LargeTensor) {
+  OpTester test("DequantizeLinear", 10);
+  std::vector<int64_t> dims{5, 8191};
+  std::vector<int8_t> x(5 * 8191);
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<int8_t>(static_cast<int>(i % 255) - 127);
+    y[i] = static_cast<float>(x[i] - 3) * 0.5f;
+  }
+  test.AddInput<int8_t>("x", dims, x);
+  test.AddInput<float>("x_scale", {}, {0.5f});
+  test.AddInput<int8_t>("x_zero_point", {}, {3});
+  test.AddOutput<float>("y", dims, y);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -155,5 +155,24 @@ TEST(ScatterNDOpTest, ScatterND_batched_3tensor_int64) {
   test3.Run();
 }
 
+TEST(ScatterNDOpTest, ScatterND_rows_float_int64) {
+  OpTester test("ScatterND", 11);
+  test.AddInput<float>("data", {6,2}, {0.0f,0.0f,1.0f,1.0f,2.0f,2.0f,3.0f,3.0f,4.0f,4.0f,5.0f,5.0f});
+  test.AddInput<int64_t>("indices", {4,1}, {5,0,3,2});
+  test.AddInput<float>("updates", {4,2}, {50.0f,51.0f,0.5f,0.6f,30.0f,31.0f,20.0f,21.0f});
+  test.AddOutput<float>("output", {6,2}, {0.5f,0.6f,1.0f,1.0f,20.0f,21.0f,30.0f,31.0f,4.0f,4.0f,50.0f,51.0f});
+  test.Run();
+}
+
+TEST(ScatterNDOpTest, ScatterND_repeated_index_int64) {
+  // the updates of a repeated index are applied in order
+  OpTester test("ScatterND", 11);
+  test.AddInput<int64_t>("data", {4}, {0LL,1LL,2LL,3LL});
+  test.AddInput<int64_t>("indices", {3,1}, {1LL,2LL,1LL});
+  test.AddInput<int64_t>("updates", {3}, {10LL,20LL,30LL});
+  test.AddOutput<int64_t>("output", {4}, {0LL,30LL,20LL,3LL});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
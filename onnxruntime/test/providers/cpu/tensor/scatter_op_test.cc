@@ -110,6 +110,31 @@ TEST(Scatter, ThreeDimsWithAxis_2) {
   scatter_three_dim_with_axis_2("ScatterElements", 11);
 }
 
+static void scatter_rows_with_axis_1(const char* op_name, int op_version) {
+  OpTester test(op_name, op_version);
+  test.AddAttribute<int64_t>("axis", 1);
+
+  test.AddInput<float>("data", {3, 3}, std::vector<float>(9, 0.0f));
+  test.AddInput<int64_t>("indices", {3, 2},
+                         {2, 0,
+                          1, 2,
+                          0, 1});
+  test.AddInput<float>("updates", {3, 2},
+                       {1.0f, 2.0f,
+                        3.0f, 4.0f,
+                        5.0f, 6.0f});
+  test.AddOutput<float>("y", {3, 3},
+                        {2.0f, 0.0f, 1.0f,
+                         0.0f, 3.0f, 4.0f,
+                         5.0f, 6.0f, 0.0f});
+  test.Run();
+}
+
+TEST(Scatter, RowsWithAxis_1) {
+  scatter_rows_with_axis_1("Scatter", 9);
+  scatter_rows_with_axis_1("ScatterElements", 11);
+}
+
 static void scatter_string(const char* op_name, int op_version) {
   OpTester test(op_name, op_version);
   test.AddAttribute<int64_t>("axis", 1);
@@ -263,6 +263,25 @@ TEST(TensorOpTest, CastFromFloat16) {
   TestCastOp(input, int64_t_data, shape, TensorProto::INT64);
 }
 
+TEST(TensorOpTest, CastFloatTo8Bit) {
+  // values are truncated toward zero and out of range values saturate
+  const std::vector<int64_t> shape{2, 4};
+  const std::vector<float> float_input = {-1000.f, -128.5f, -1.75f, -0.5f, 0.75f, 126.9f, 255.5f, 1e10f};
+
+  // other providers leave the result of out of range values undefined
+  OpTester int8_test("Cast", 9);
+  int8_test.AddAttribute("to", static_cast<int64_t>(TensorProto::INT8));
+  int8_test.AddInput<float>("input", shape, float_input);
+  int8_test.AddOutput<int8_t>("output", shape, {-128, -128, -1, 0, 0, 126, 127, 127});
+  int8_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+
+  OpTester uint8_test("Cast", 9);
+  uint8_test.AddAttribute("to", static_cast<int64_t>(TensorProto::UINT8));
+  uint8_test.AddInput<float>("input", shape, float_input);
+  uint8_test.AddOutput<uint8_t>("output", shape, {0, 0, 0, 0, 0, 126, 255, 255});
+  uint8_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 TEST(TensorOpTest, CastFromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   std::initializer_list<std::string> string_data = {"-inf", "+INF", "0.9767611f", "0.28280696f",
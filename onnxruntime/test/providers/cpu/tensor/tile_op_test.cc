@@ -106,5 +106,31 @@ TEST(TensorOpTest, TileUint64Type) {
 TEST(TensorOpTest, TileBoolType) {
   RunTestWrapper<bool>();
 }
+TEST(TensorOpTest, TileManyRepeatsOnOuterAndInnerAxes) {
+  // enough rows and repeats for the parallel outer axis and the doubling copies
+  const std::vector<int64_t> input_dims = {4, 3};
+  const std::vector<int64_t> repeats = {5, 7};
+  std::vector<float> input(12);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> output;
+  for (int64_t r0 = 0; r0 < repeats[0]; ++r0) {
+    for (int64_t i = 0; i < input_dims[0]; ++i) {
+      for (int64_t r1 = 0; r1 < repeats[1]; ++r1) {
+        for (int64_t j = 0; j < input_dims[1]; ++j) {
+          output.push_back(input[i * input_dims[1] + j]);
+        }
+      }
+    }
+  }
+
+  OpTester test("Tile");
+  test.AddInput<float>("input", input_dims, input);
+  test.AddInput<int64_t>("repeats", {2}, repeats);
+  test.AddOutput<float>("output", {20, 21}, output);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -414,5 +414,68 @@ TEST(TransposeOpTest, SingleAxisMovingInwardsBlockCopy) {
 
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false, false);
 }
+// Transposes the dims of input_shape with perm using a reference implementation.
+template <typename T>
+static std::vector<T> ReferenceTranspose(const std::vector<int64_t>& input_shape, const std::vector<T>& input_vals,
+                                         const std::vector<int64_t>& perm, std::vector<int64_t>& output_shape) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  output_shape.resize(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    output_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<T> output_vals;
+  output_vals.reserve(input_vals.size());
+  std::vector<int64_t> index(rank, 0);
+  for (size_t n = 0; n < input_vals.size(); ++n) {
+    int64_t offset = 0;
+    for (size_t i = 0; i < rank; ++i) {
+      offset += index[i] * input_strides[perm[i]];
+    }
+    output_vals.push_back(input_vals[offset]);
+    for (size_t i = rank; i-- > 0;) {
+      if (++index[i] < output_shape[i]) break;
+      index[i] = 0;
+    }
+  }
+  return output_vals;
+}
+
+template <typename T>
+static void LargeTransposeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  int64_t size = 1;
+  for (auto dim : input_shape) {
+    size *= dim;
+  }
+  std::vector<T> input_vals(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 251);
+  }
+
+  std::vector<int64_t> expected_shape;
+  std::vector<T> expected_vals = ReferenceTranspose(input_shape, input_vals, perm, expected_shape);
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", expected_shape, expected_vals);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+// covers the tiled 2D transpose path, with dims that are not a multiple of the micro-kernel sizes
+TEST(TransposeOpTest, LargeBatchedMatrixTranspose) {
+  LargeTransposeTest<float>({2, 5, 17, 19}, {0, 2, 3, 1});
+  LargeTransposeTest<float>({2, 17, 19, 5}, {0, 3, 1, 2});
+  LargeTransposeTest<uint8_t>({3, 37, 41}, {0, 2, 1});
+  LargeTransposeTest<int16_t>({1, 70, 1, 33}, {3, 1, 2, 0});
+  LargeTransposeTest<double>({65, 66}, {1, 0});
+  // the unchanged inner axis makes each element a block of two floats
+  LargeTransposeTest<float>({3, 10, 12, 2}, {0, 2, 1, 3});
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -118,6 +118,26 @@ TEST(Unique, Flatten_Sorted_String) {
                              inverse_indices_dims, inverse_indices, counts_dims, counts);
 }
 
+TEST(Unique, Flatten_Sorted_Int64_CollidingValues) {
+  // multiples of a power of 2 with more unique values than the initial slots of the hash map
+  const std::vector<int64_t> X_dims{10};
+  const std::vector<int64_t> X{4096, 0, 1024, 4096, 2048, 0, 1024, 3072, 8192, 0};
+  const int64_t* axis = nullptr;
+  bool sorted = true;
+  const std::vector<int64_t> Y_dims{6};
+  const std::vector<int64_t> Y{0, 1024, 2048, 3072, 4096, 8192};
+
+  const std::vector<int64_t> indices_dims{6};
+  const std::vector<int64_t> indices{1, 2, 4, 7, 0, 8};
+  const std::vector<int64_t> inverse_indices_dims{10};
+  const std::vector<int64_t> inverse_indices{4, 0, 1, 4, 2, 0, 1, 3, 5, 0};
+  const std::vector<int64_t> counts_dims{6};
+  const std::vector<int64_t> counts{3, 2, 1, 1, 2, 1};
+
+  RunUniqueTest<int64_t>(X_dims, X, axis, sorted, Y_dims, Y, indices_dims, indices,
+                         inverse_indices_dims, inverse_indices, counts_dims, counts);
+}
+
 TEST(Unique, NoOptionalOutput) {
   const std::vector<int64_t> X_dims{2, 4};
   const std::vector<int8_t> X{1, 4, -1, 2, 2, 0, -1, 4};
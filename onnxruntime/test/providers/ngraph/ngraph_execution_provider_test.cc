@@ -28,7 +28,7 @@ class UnSupportedOp final : public OpKernel {
     auto X_Data = X->Data<float>();
 
     auto& shape = X->Shape().GetDims();
-    auto* Y = p_context->Output(0, shape);
+    auto* Y = p_context->Output(0, X->Shape());
     auto* Y_Data = Y->MutableData<float>();
 
     size_t size = 1;
@@ -7,6 +7,7 @@ import os
 import numpy as np
 import onnxruntime as onnxrt
 import threading
+import time
 
 
 class TestInferenceSession(unittest.TestCase):
@@ -90,6 +91,131 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunPrepared(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        prepared_run = sess.prepare_run(["Y"], ["X"])
+        self.assertEqual(prepared_run.input_names, ["X"])
+        self.assertEqual(prepared_run.output_names, ["Y"])
+        for scale in [1.0, 2.0]:
+            x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32) * scale
+            res = sess.run_prepared(prepared_run, {"X": x})
+            np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunOutputsWithoutCopy(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run(["Y"], {"X": x})
+        # the array uses the buffer of the output, which it keeps alive through its base
+        self.assertIsNotNone(res[0].base)
+        del sess
+        np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunAsync(self):
+        import asyncio
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        inputs = [np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32) * scale for scale in range(8)]
+
+        async def run_all():
+            return await asyncio.gather(*[sess.run_async(["Y"], {"X": x}) for x in inputs])
+
+        loop = asyncio.new_event_loop()
+        try:
+            results = loop.run_until_complete(run_all())
+            for x, res in zip(inputs, results):
+                np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+
+            # the error of the run is raised by the future
+            with self.assertRaises(Exception):
+                loop.run_until_complete(sess.run_async(["Z"], {"X": inputs[0]}, loop=loop))
+
+            # the run uses the RunOptions of the caller
+            run_options = onnxrt.RunOptions()
+            res = loop.run_until_complete(sess.run_async(["Y"], {"X": inputs[1]}, run_options, loop=loop))
+            np.testing.assert_allclose(inputs[1] * inputs[1], res[0], rtol=1e-05, atol=1e-08)
+            run_options.terminate = True
+            with self.assertRaises(Exception):
+                loop.run_until_complete(sess.run_async(["Y"], {"X": inputs[1]}, run_options, loop=loop))
+        finally:
+            loop.close()
+
+    def testReplicatedSession(self):
+        if 'CUDAExecutionProvider' not in onnxrt.get_available_providers():
+            with self.assertRaises(RuntimeError):
+                onnxrt.ReplicatedSession(self.get_name("mul_1.onnx"), [0])
+            return
+
+        sess = onnxrt.ReplicatedSession(self.get_name("mul_1.onnx"), [0])
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run(["Y"], {"X": x})
+        np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+        run_options = onnxrt.RunOptions()
+        run_options.logid = "ReplicatedSession"
+        res = sess.run(["Y"], {"X": x}, run_options)
+        np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+        self.assertEqual(sess.get_run_counts(), [2])
+
+    def testRunWithIOBinding(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        binding = sess.io_binding()
+        y = np.zeros((3, 2), dtype=np.float32)
+        binding.bind_output("Y", y)
+        previous = None
+        for scale in [1.0, 2.0]:
+            x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32) * scale
+            binding.bind_input("X", x)
+            sess.run_with_iobinding(binding)
+            np.testing.assert_allclose(x * x, y, rtol=1e-05, atol=1e-08)
+            self.assertIs(binding.get_outputs()[0], y)
+
+        # outputs that are not bound to an array are allocated by each run
+        binding.clear_binding_outputs()
+        binding.bind_output("Y")
+        for scale in [1.0, 2.0]:
+            x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32) * scale
+            binding.bind_input("X", x)
+            sess.run_with_iobinding(binding)
+            res = binding.get_outputs()[0]
+            np.testing.assert_allclose(x * x, res, rtol=1e-05, atol=1e-08)
+            if previous is not None:
+                np.testing.assert_allclose(previous_expected, previous, rtol=1e-05, atol=1e-08)
+            previous, previous_expected = res, x * x
+
+        with self.assertRaises(RuntimeError):
+            binding.bind_output("Y", np.zeros((3, 2), dtype=np.float32).T)
+
+    def testOrtValueCudaArrayInterface(self):
+        class CudaArray:
+            # the buffer is not read, so a host address stands in for the device memory
+            def __init__(self, data):
+                self.data = data
+                self.__cuda_array_interface__ = {'shape': data.shape, 'typestr': data.dtype.str,
+                                                 'data': (data.ctypes.data, False), 'strides': None, 'version': 2}
+
+        array = CudaArray(np.zeros((3, 2), dtype=np.float32))
+        value = onnxrt.OrtValue.from_cuda_array(array, 0)
+        self.assertEqual(value.device_name(), 'cuda')
+        self.assertEqual(value.shape(), [3, 2])
+        self.assertEqual(value.data_ptr(), array.data.ctypes.data)
+        interface = value.__cuda_array_interface__
+        self.assertEqual(interface['shape'], (3, 2))
+        self.assertEqual(interface['typestr'], '<f4')
+        self.assertEqual(interface['data'], (array.data.ctypes.data, False))
+
+        transposed = CudaArray(np.zeros((3, 2), dtype=np.float32))
+        transposed.__cuda_array_interface__['strides'] = (4, 12)
+        with self.assertRaises(RuntimeError):
+            onnxrt.OrtValue.from_cuda_array(transposed, 0)
+
+    def testRunWithIOBindingOutputOnDevice(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        binding = sess.io_binding()
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        binding.bind_input("X", x)
+        binding.bind_output_to_device("Y", "cpu")
+        sess.run_with_iobinding(binding)
+        binding.synchronize_outputs()
+        np.testing.assert_allclose(x * x, binding.get_outputs()[0], rtol=1e-05, atol=1e-08)
+
     def testRunModelFromBytes(self):
         with open(self.get_name("mul_1.onnx"), "rb") as f:
             content = f.read()
@@ -407,6 +533,141 @@ class TestInferenceSession(unittest.TestCase):
                     self.assertTrue(tag in lines[i])
             self.assertTrue(']' in lines[8])
 
+    def testLightweightProfiler(self):
+        so = onnxrt.SessionOptions()
+        so.lightweight_profiling_sampling_interval = 2
+        sess = onnxrt.InferenceSession(
+            self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        for i in range(4):
+            sess.run([], {'X': x})
+
+        op_statistics = sess.get_op_statistics()
+        self.assertEqual(list(op_statistics.keys()), ['Mul'])
+        self.assertEqual(op_statistics['Mul']['count'], 2)
+        self.assertEqual(op_statistics['Mul']['output_bytes'], 2 * 6 * 4)
+        node_statistics = sess.get_node_statistics()
+        self.assertEqual(node_statistics['mul_1']['count'], 2)
+
+    def testRuntimeProfile(self):
+        profile_path = "runtime_profile_python_test.txt"
+        if os.path.exists(profile_path):
+            os.remove(profile_path)
+        so = onnxrt.SessionOptions()
+        so.runtime_profile_runs = 2
+        so.runtime_profile_path = profile_path
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        for i in range(3):
+            res = sess.run([], {'X': x})
+            np.testing.assert_allclose(res[0], x * x, rtol=1e-05, atol=1e-08)
+
+        # the profile is saved once the session is released
+        del sess
+        with open(profile_path) as f:
+            lines = f.read().splitlines()
+        self.assertEqual(lines[0], "onnxruntime runtime profile 1")
+        self.assertIn("runs 2", lines)
+        self.assertIn("input X", lines)
+        os.remove(profile_path)
+
+    def testMemoryStatistics(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        self.assertEqual(sess.get_peak_activation_bytes(), 0)
+        sess.run([], {'X': x})
+        self.assertGreater(sess.get_peak_activation_bytes(), 0)
+
+        allocator_statistics = sess.get_allocator_statistics()
+        self.assertEqual(allocator_statistics[0]['name'], 'Cpu')
+        self.assertGreater(allocator_statistics[0]['max_bytes_in_use'], 0)
+
+    def testShrinkMemoryArenas(self):
+        so = onnxrt.SessionOptions()
+        so.cpu_arena_backend = onnxrt.ArenaBackend.BFC
+        so.arena_idle_shrink_ms = 10
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ro = onnxrt.RunOptions()
+        ro.shrink_memory_arenas = True
+        res = sess.run([], {'X': x}, ro)
+        np.testing.assert_allclose(res[0], x * x, rtol=1e-05, atol=1e-08)
+        allocated = sess.get_allocator_statistics()[0]['total_allocated_bytes']
+
+        # the regions of the released output are returned
+        del res
+        sess.shrink_memory_arenas()
+        self.assertLessEqual(sess.get_allocator_statistics()[0]['total_allocated_bytes'], allocated)
+
+        # runs after the idle trimmer shrank the arena
+        time.sleep(0.1)
+        res = sess.run([], {'X': x})
+        np.testing.assert_allclose(res[0], x * x, rtol=1e-05, atol=1e-08)
+
+    def testTuneSessionOptions(self):
+        from onnxruntime.tools import tune_session_options
+        model_path = self.get_name("mul_1.onnx")
+        best, results = tune_session_options.tune(model_path, {'X': [3, 2]}, iterations=2, warmup=1,
+                                                  intra_op_threads=[1, 2], inter_op_threads=[2])
+        # 1 and 2 intra op threads sequential, both with 2 inter op threads parallel, then the 4 memory settings
+        self.assertEqual(len(results), 8)
+        self.assertIn(best['intra_op_num_threads'], [1, 2])
+        self.assertIn('enable_mem_pattern', best)
+
+        config_path = 'tuned_session_options.json'
+        try:
+            tune_session_options.save_config(best, config_path, results)
+            sess_options = tune_session_options.load_session_options(config_path)
+            self.assertEqual(sess_options.intra_op_num_threads, best['intra_op_num_threads'])
+            self.assertEqual(sess_options.enable_mem_pattern, bool(best['enable_mem_pattern']))
+            onnxrt.InferenceSession(model_path, sess_options)
+        finally:
+            if os.path.exists(config_path):
+                os.remove(config_path)
+
+    def testPipelineSession(self):
+        import onnx
+        from onnx import helper, numpy_helper, TensorProto
+        from onnxruntime.tools import pipeline_session
+        w = np.arange(4, dtype=np.float32).reshape(2, 2)
+        b = np.array([1.0, -100.0], dtype=np.float32)
+        graph = helper.make_graph(
+            [helper.make_node('MatMul', ['X', 'W'], ['XW']),
+             helper.make_node('Add', ['XW', 'B'], ['Z']),
+             helper.make_node('Relu', ['Z'], ['Y']),
+             helper.make_node('Add', ['Y', 'XW'], ['S'])],
+            'pipeline',
+            [helper.make_tensor_value_info('X', TensorProto.FLOAT, [3, 2])],
+            [helper.make_tensor_value_info('S', TensorProto.FLOAT, [3, 2]),
+             helper.make_tensor_value_info('XW', TensorProto.FLOAT, [3, 2])],
+            [numpy_helper.from_array(w, 'W'), numpy_helper.from_array(b, 'B')])
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid('', 11)])
+
+        stages = pipeline_session.split_model(model, [2])
+        self.assertEqual(len(stages), 2)
+        # XW is a model output and is used by the second stage
+        self.assertEqual([o.name for o in stages[0].graph.output], ['XW', 'Z'])
+        self.assertEqual([i.name for i in stages[1].graph.input], ['XW', 'Z'])
+        self.assertEqual([i.name for i in stages[0].graph.initializer], ['B', 'W'])
+        self.assertEqual(len(stages[1].graph.initializer), 0)
+        self.assertEqual(pipeline_session.balanced_boundaries(model, 2), [1])
+
+        expected = onnxrt.InferenceSession(model.SerializeToString()).run(None, {'X': np.ones((3, 2), np.float32)})
+        feeds = [{'X': np.full((3, 2), i, np.float32)} for i in range(8)]
+        with pipeline_session.PipelineSession(stages, queue_size=2) as pipeline:
+            self.assertEqual(pipeline.get_output_names(), ['S', 'XW'])
+            futures = [pipeline.submit(None, f) for f in feeds]
+            results = [f.result() for f in futures]
+            res = pipeline.run(['S', 'XW'], {'X': np.ones((3, 2), np.float32)})
+            with self.assertRaises(Exception):
+                pipeline.run(None, {'X': np.ones((2, 2, 2), np.float32)})
+        np.testing.assert_allclose(res[0], expected[0])
+        np.testing.assert_allclose(res[1], expected[1])
+        for f, result in zip(feeds, results):
+            xw = f['X'].dot(w)
+            np.testing.assert_allclose(result[0], np.maximum(xw + b, 0) + xw)
+            np.testing.assert_allclose(result[1], xw)
+
     def testDictVectorizer(self):
         sess = onnxrt.InferenceSession(
             self.get_name("pipeline_vectorize.onnx"))
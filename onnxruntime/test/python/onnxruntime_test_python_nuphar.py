@@ -172,6 +172,29 @@ class TestNuphar(unittest.TestCase):
         assert np.allclose(first_lstm_data_output, scan_batch_data_output)
 
 
+    def test_specialize_shapes(self):
+        input_dim = 3
+        hidden_dim = 5
+        lstm_model_name = 'test_specialize_rnn_lstm.onnx'
+        generate_model('lstm', input_dim, hidden_dim, False, 2, lstm_model_name, batch_one=False, has_seq_len=True)
+        scan_model_name = 'test_specialize_rnn_scan.onnx'
+        subprocess.run([sys.executable, '-m', 'onnxruntime.nuphar.model_editor', '--input', lstm_model_name, '--output', scan_model_name, '--mode', 'to_scan'], check=True)
+
+        feeds = []
+        for seq_len, batch_size in [(8, 2), (8, 2), (4, 3)]:
+            feeds.append({'input':(np.random.rand(seq_len, batch_size, input_dim) * 2 - 1).astype(np.float32),
+                          'seq_len':np.random.randint(1, seq_len, size=(batch_size,), dtype=np.int32)})
+        sess = onnxrt.InferenceSession(scan_model_name)
+        expected = [sess.run([], feed) for feed in feeds]
+
+        # compile a specialized kernel after the first run of a shape, and keep running while it is compiled
+        onnxrt.capi._pybind_state.set_nuphar_settings('nuphar_specialize_shapes:1')
+        sess = onnxrt.InferenceSession(scan_model_name)
+        for i in range(50):
+            for feed, expected_output in zip(feeds, expected):
+                assert np.allclose(expected_output, sess.run([], feed))
+
+
     def test_symbolic_shape_infer(self):
         cwd = os.getcwd()
         test_model_dir = os.path.join(cwd, '..', 'models')
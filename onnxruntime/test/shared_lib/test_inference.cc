@@ -10,6 +10,8 @@
 #include <fstream>
 #include <sstream>
 #include <atomic>
+#include <functional>
+#include <numeric>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -261,6 +263,151 @@ TEST_F(CApiTest, custom_op_handler) {
   TestInference<PATH_TYPE, float>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain, nullptr);
 }
 
+// Computes the same sum as MyCustomKernel on the intra-op thread pool, through a scratch buffer
+struct MyParallelCustomKernel {
+  MyParallelCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* /*info*/) : ort_(ort) {
+  }
+
+  void Compute(OrtKernelContext* context) {
+    const OrtValue* input_X = ort_.KernelContext_GetInput(context, 0);
+    const OrtValue* input_Y = ort_.KernelContext_GetInput(context, 1);
+    const float* X = ort_.GetTensorData<float>(input_X);
+    const float* Y = ort_.GetTensorData<float>(input_Y);
+
+    OrtTensorDimensions dimensions(ort_, input_X);
+    OrtValue* output = ort_.KernelContext_GetOutput(context, 0, dimensions.data(), dimensions.size());
+    float* out = ort_.GetTensorMutableData<float>(output);
+
+    OrtTensorTypeAndShapeInfo* output_info = ort_.GetTensorTypeAndShape(output);
+    size_t size = ort_.GetTensorShapeElementCount(output_info);
+    ort_.ReleaseTensorTypeAndShapeInfo(output_info);
+
+    ASSERT_GE(ort_.KernelContext_GetThreadCount(context), 1u);
+
+    float* sums = static_cast<float*>(ort_.KernelContext_AllocateScratch(context, size * sizeof(float)));
+    ort_.KernelContext_ParallelFor(context, size, 0, [&](size_t i) { sums[i] = X[i] + Y[i]; });
+    std::copy(sums, sums + size, out);
+    ort_.KernelContext_FreeScratch(context, sums);
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+};
+
+struct MyParallelCustomOp : Ort::CustomOpBase<MyParallelCustomOp, MyParallelCustomKernel> {
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyParallelCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+};
+
+TEST_F(CApiTest, custom_op_parallel_for) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyParallelCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE, float>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain, nullptr);
+}
+
+// Computes the same sum as MyCustomKernel from a copy of the constant W that is made when the session is created
+struct MyPrePackCustomKernel {
+  MyPrePackCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* /*info*/) : ort_(ort) {
+  }
+
+  OrtStatus* PrePack(const OrtValue* input, size_t input_index, int* is_packed) {
+    *is_packed = 0;
+    if (input_index == 1) {
+      OrtTensorDimensions dimensions(ort_, input);
+      const float* values = ort_.GetTensorData<float>(input);
+      packed_y_.assign(values, values + std::accumulate(dimensions.begin(), dimensions.end(), int64_t{1}, std::multiplies<int64_t>()));
+      *is_packed = 1;
+    }
+    return nullptr;
+  }
+
+  void Compute(OrtKernelContext* context) {
+    ASSERT_FALSE(packed_y_.empty());
+    const OrtValue* input_X = ort_.KernelContext_GetInput(context, 0);
+    const float* X = ort_.GetTensorData<float>(input_X);
+
+    OrtTensorDimensions dimensions(ort_, input_X);
+    OrtValue* output = ort_.KernelContext_GetOutput(context, 0, dimensions.data(), dimensions.size());
+    float* out = ort_.GetTensorMutableData<float>(output);
+
+    for (size_t i = 0; i < packed_y_.size(); i++) {
+      out[i] = X[i] + packed_y_[i];
+    }
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+  std::vector<float> packed_y_;
+};
+
+struct MyPrePackCustomOp : Ort::CustomOpBase<MyPrePackCustomOp, MyPrePackCustomKernel> {
+  MyPrePackCustomOp() {
+    OrtCustomOp::KernelPrePack = [](void* op_kernel, const OrtValue* input, size_t input_index, int* is_packed) {
+      return static_cast<MyPrePackCustomKernel*>(op_kernel)->PrePack(input, input_index, is_packed);
+    };
+    OrtCustomOp::InferOutputShapes = [](OrtCustomOp* this_, OrtShapeInferContext* context) -> OrtStatus* {
+      // the output has the shape of X
+      Ort::CustomOpApi ort(Ort::GetApi());
+      OrtTensorTypeAndShapeInfo* info = ort.ShapeInferContext_GetInputTypeShape(context, 0);
+      if (info != nullptr) {
+        ort.ShapeInferContext_SetOutputTypeShape(context, 0, info);
+        ort.ReleaseTensorTypeAndShapeInfo(info);
+      }
+      static_cast<MyPrePackCustomOp*>(this_)->inferred_shapes = true;
+      return nullptr;
+    };
+  }
+
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyPrePackCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  // Y may be written over X, which the test feeds and doesn't use after the run
+  int GetMayInplace(size_t /*output_index*/) const { return 0; }
+
+  bool inferred_shapes = false;
+};
+
+TEST_F(CApiTest, custom_op_prepack_and_shape_inference) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyPrePackCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE, float>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain, nullptr);
+  EXPECT_TRUE(custom_op.inferred_shapes);
+}
+
 TEST_F(CApiTest, DISABLED_test_custom_op_library) {
   std::cout << "Running inference using custom op shared library" << std::endl;
 
@@ -330,6 +477,89 @@ TEST_F(CApiTest, create_session_without_session_option) {
 }
 #endif
 
+TEST_F(CApiTest, run_batch) {
+  const std::vector<int64_t> dims = {3, 2};
+  const std::vector<std::vector<float>> values = {{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f},
+                                                  {-1.0f, 0.5f, 2.0f, 3.0f, -4.0f, 1.5f},
+                                                  {0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f}};
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+
+  for (auto execution_mode : {ORT_SEQUENTIAL, ORT_PARALLEL}) {
+    Ort::SessionOptions session_options;
+    session_options.SetExecutionMode(execution_mode);
+    Ort::Session session(env_, MODEL_URI, session_options);
+
+    std::vector<Ort::Value> ort_inputs;
+    for (const auto& request_values : values) {
+      ort_inputs.emplace_back(Ort::Value::CreateTensor<float>(default_allocator->Info(default_allocator.get()),
+                                                              const_cast<float*>(request_values.data()),
+                                                              request_values.size(), dims.data(), dims.size()));
+    }
+
+    const char* input_name = "X";
+    const char* output_name = "Y";
+    auto ort_outputs = session.RunBatch(Ort::RunOptions{nullptr}, &input_name, ort_inputs.data(), 1,
+                                        &output_name, 1, values.size());
+    ASSERT_EQ(ort_outputs.size(), values.size());
+
+    for (size_t request = 0; request < values.size(); ++request) {
+      auto type_info = ort_outputs[request].GetTensorTypeAndShapeInfo();
+      ASSERT_EQ(type_info.GetShape(), dims);
+      const float* y = ort_outputs[request].GetTensorMutableData<float>();
+      for (size_t i = 0; i < values[request].size(); ++i) {
+        ASSERT_EQ(values[request][i] * values[request][i], y[i]);
+      }
+    }
+  }
+}
+
+TEST_F(CApiTest, run_prepared) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{nullptr});
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  Ort::PreparedRun prepared_run(session, &input_name, 1, &output_name, 1);
+
+  const std::vector<int64_t> dims = {3, 2};
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+  for (float scale : {1.0f, 2.0f}) {
+    std::vector<float> values = {1.0f * scale, 2.0f * scale, 3.0f * scale, 4.0f * scale, 5.0f * scale, 6.0f * scale};
+    Ort::Value input = Ort::Value::CreateTensor<float>(default_allocator->Info(default_allocator.get()), values.data(),
+                                                       values.size(), dims.data(), dims.size());
+    auto ort_outputs = session.Run(Ort::RunOptions{nullptr}, prepared_run, &input, 1, 1);
+    ASSERT_EQ(ort_outputs.size(), 1u);
+    const float* y = ort_outputs[0].GetTensorMutableData<float>();
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(values[i] * values[i], y[i]);
+    }
+  }
+}
+
+TEST_F(CApiTest, io_binding) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{nullptr});
+  Ort::IoBinding binding(session);
+
+  const std::vector<int64_t> dims = {3, 2};
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+  std::vector<float> y_values(6);
+  Ort::Value output = Ort::Value::CreateTensor<float>(default_allocator->Info(default_allocator.get()), y_values.data(),
+                                                      y_values.size(), dims.data(), dims.size());
+  binding.BindOutput("Y", output);
+  for (float scale : {1.0f, 2.0f}) {
+    std::vector<float> values = {1.0f * scale, 2.0f * scale, 3.0f * scale, 4.0f * scale, 5.0f * scale, 6.0f * scale};
+    Ort::Value input = Ort::Value::CreateTensor<float>(default_allocator->Info(default_allocator.get()), values.data(),
+                                                       values.size(), dims.data(), dims.size());
+    binding.BindInput("X", input);
+    session.Run(Ort::RunOptions{nullptr}, binding);
+    // the output is written to the preallocated buffer
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(values[i] * values[i], y_values[i]);
+    }
+    auto ort_outputs = binding.GetOutputValues();
+    ASSERT_EQ(ort_outputs.size(), 1u);
+    ASSERT_EQ(ort_outputs[0].GetTensorMutableData<float>(), y_values.data());
+  }
+}
+
 TEST_F(CApiTest, create_tensor) {
   const char* s[] = {"abc", "kmp"};
   int64_t expected_len = 2;
@@ -424,6 +654,33 @@ TEST_F(CApiTest, override_initializer) {
   ASSERT_EQ(*output_data, f11_input_data[0]);
 }
 
+// the sessions that disable per session threads share the thread pools of the env
+TEST(CApiGlobalThreadPoolsTest, shared_thread_pools) {
+  Ort::ThreadingOptions tp_options;
+  tp_options.SetGlobalIntraOpNumThreads(2).SetGlobalInterOpNumThreads(2);
+  Ort::Env env(tp_options, ORT_LOGGING_LEVEL_WARNING, "Default");
+
+  std::vector<Input> inputs(1);
+  Input& input = inputs.back();
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  Ort::SessionOptions session_options;
+  session_options.DisablePerSessionThreads();
+  Ort::Session session1(env, MODEL_URI, session_options);
+
+  session_options.SetExecutionMode(ORT_PARALLEL);
+  Ort::Session session2(env, MODEL_URI, session_options);
+
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+  RunSession<float>(default_allocator.get(), session1, inputs, "Y", expected_dims_y, expected_values_y, nullptr);
+  RunSession<float>(default_allocator.get(), session2, inputs, "Y", expected_dims_y, expected_values_y, nullptr);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   int ret = RUN_ALL_TESTS();
@@ -14,7 +14,7 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Dnnl(i
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_NGraph(const char* ng_backend_type);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nuphar(bool, const char*);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainSlice(uint32_t ip, int, int, bool, const char*, const char*, const char*);
-std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi();
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi(uint32_t nnapi_flags);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(const char* device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_ACL(int use_arena);
@@ -85,7 +85,7 @@ std::unique_ptr<IExecutionProvider> DefaultBrainSliceExecutionProvider() {
 
 std::unique_ptr<IExecutionProvider> DefaultNnapiExecutionProvider() {
 #ifdef USE_NNAPI
-  return CreateExecutionProviderFactory_Nnapi()->CreateProvider();
+  return CreateExecutionProviderFactory_Nnapi(NNAPI_FLAG_USE_FP16)->CreateProvider();
 #else
   return nullptr;
 #endif
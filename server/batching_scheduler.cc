@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "batching_scheduler.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+BatchingScheduler::BatchingScheduler(RunFunction run_fn, StatsFunction stats_fn, const BatchingOptions& options)
+    : run_fn_(std::move(run_fn)), stats_fn_(std::move(stats_fn)), options_(options) {
+}
+
+void BatchingScheduler::SetSessionOptions(const BatchingOptions& options, Ort::SessionOptions& session_options) {
+  session_options.SetDynamicBatching(options.max_batch_size, options.max_queue_delay_us);
+}
+
+protobufutil::Status BatchingScheduler::Run(const Ort::RunOptions& run_options,
+                                            const std::vector<std::string>& input_names,
+                                            const std::vector<Ort::Value>& input_values,
+                                            const std::vector<std::string>& output_names,
+                                            const std::shared_ptr<spdlog::logger>& logger,
+                                            /* out */ std::vector<Ort::Value>& outputs) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (num_queued_ >= options_.max_queue_depth) {
+      ++rejected_requests_;
+      logger->warn("Batching queue is full ({} requests). Request rejected.", num_queued_);
+      return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "Batching queue is full");
+    }
+
+    ++num_queued_;
+  }
+
+  // the session batches the request with the concurrent requests of the model
+  protobufutil::Status status = protobufutil::Status::OK;
+  try {
+    outputs = run_fn_(run_options, input_names, input_values, output_names);
+  } catch (const Ort::Exception& e) {
+    status = GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  --num_queued_;
+  return status;
+}
+
+BatchingMetrics BatchingScheduler::GetMetrics() const {
+  BatchingMetrics metrics;
+  stats_fn_(metrics.requests, metrics.batches, metrics.unbatched_requests);
+  std::lock_guard<std::mutex> guard(mutex_);
+  metrics.rejected_requests = rejected_requests_;
+  return metrics;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/status.h>
+#include <spdlog/spdlog.h>
+
+#include "onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // maximum number of rows (dim 0) in a fused run. batching is disabled if this is <= 1.
+  int max_batch_size = 0;
+  // how long the first request of a batch waits for other requests to join it
+  int max_queue_delay_us = 1000;
+  // maximum number of requests waiting for their batch or running. requests over the limit are rejected.
+  int max_queue_depth = 64;
+};
+
+struct BatchingMetrics {
+  uint64_t requests = 0;            // requests that went through the batching queue
+  uint64_t batches = 0;             // runs executed for those requests
+  uint64_t rejected_requests = 0;   // requests rejected because the queue was full
+  uint64_t unbatched_requests = 0;  // requests that were not eligible for batching
+};
+
+// Admits the PredictRequests of a model whose session fuses concurrent Runs along dim 0 of the inputs, see
+// Ort::SessionOptions::SetDynamicBatching. The session batches requests with the same input names, element types,
+// non-batch dims and output names, and runs the others directly.
+//
+// Each request runs with its own RunOptions, so its request id stays the run tag of its run, or is part of the tag
+// of the fused run. A request that arrives when max_queue_depth requests are waiting or running is rejected.
+class BatchingScheduler {
+ public:
+  // Runs the model. Throws Ort::Exception on failure.
+  using RunFunction = std::function<std::vector<Ort::Value>(const Ort::RunOptions& run_options,
+                                                            const std::vector<std::string>& input_names,
+                                                            const std::vector<Ort::Value>& input_values,
+                                                            const std::vector<std::string>& output_names)>;
+
+  // Gets the batching counters of the session
+  using StatsFunction = std::function<void(uint64_t& requests, uint64_t& batches, uint64_t& unbatched_requests)>;
+
+  BatchingScheduler(RunFunction run_fn, StatsFunction stats_fn, const BatchingOptions& options);
+  BatchingScheduler(const BatchingScheduler&) = delete;
+  BatchingScheduler& operator=(const BatchingScheduler&) = delete;
+
+  // Sets the dynamic batching of the session options of a model from options
+  static void SetSessionOptions(const BatchingOptions& options, Ort::SessionOptions& session_options);
+
+  google::protobuf::util::Status Run(const Ort::RunOptions& run_options,
+                                     const std::vector<std::string>& input_names,
+                                     const std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& output_names,
+                                     const std::shared_ptr<spdlog::logger>& logger,
+                                     /* out */ std::vector<Ort::Value>& outputs);
+
+  BatchingMetrics GetMetrics() const;
+
+  const BatchingOptions& GetOptions() const { return options_; }
+
+ private:
+  const RunFunction run_fn_;
+  const StatsFunction stats_fn_;
+  const BatchingOptions options_;
+
+  mutable std::mutex mutex_;
+  // requests that are waiting for their batch or running. protected by mutex_.
+  int num_queued_ = 0;
+  // protected by mutex_
+  uint64_t rejected_requests_ = 0;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -76,6 +76,12 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
   // data_location field: Data is stored in raw_data (if set) otherwise in type-specified field.
   if (using_raw_data && data_type != onnx::TensorProto_DataType_STRING) {
     tensor_proto.set_data_location(onnx::TensorProto_DataLocation_DEFAULT);
+
+    // the value was preallocated over raw_data (see Executor::PreallocateOutputs) so the data is already in place
+    if (tensor_proto.has_raw_data() && !tensor_proto.raw_data().empty() &&
+        ml_value.GetTensorMutableData<char>() == tensor_proto.raw_data().data()) {
+      return;
+    }
   }
 
   // *_data field
@@ -1,8 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <tuple>
 #include "environment.h"
+#include "executor.h"
+#include "json_handling.h"
+#include "util.h"
 #include "onnxruntime_cxx_api.h"
 
 #ifdef USE_DNNL
@@ -66,67 +75,264 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
   spdlog::initialize_logger(default_logger_);
 }
 
-void ServerEnvironment::RegisterExecutionProviders(){
-  #ifdef USE_DNNL
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Dnnl(options_, 1));
-  #endif
+void ServerEnvironment::RegisterExecutionProviders() {
+  std::call_once(providers_registered_, [this]() {
+#ifdef USE_DNNL
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Dnnl(options_, 1));
+#endif
 
-  #ifdef USE_NGRAPH
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_NGraph(options_, "CPU"));
-  #endif
+#ifdef USE_NGRAPH
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_NGraph(options_, "CPU"));
+#endif
 
-  #ifdef USE_NUPHAR
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nuphar(options_, 1, ""));
-  #endif
-  
-  #ifdef USE_OPENVINO
-  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_OpenVINO(options_, "CPU"));
-  #endif
-  
+#ifdef USE_NUPHAR
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nuphar(options_, 1, ""));
+#endif
 
+#ifdef USE_OPENVINO
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_OpenVINO(options_, "CPU"));
+#endif
+  });
 }
 
-void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
+std::shared_ptr<LoadedModel> ServerEnvironment::CreateModel(const std::string& model_path,
+                                                            const BatchingOptions& batching_options) {
   RegisterExecutionProviders();
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), options_));
+  const bool batching = batching_options.max_batch_size > 1;
+  Ort::SessionOptions batching_session_options{nullptr};
+  if (batching) {
+    batching_session_options = options_.Clone();
+    BatchingScheduler::SetSessionOptions(batching_options, batching_session_options);
+  }
+  auto model = std::make_shared<LoadedModel>(runtime_environment_, model_path,
+                                             batching ? batching_session_options : options_);
+  model->response_cache = response_cache_.get();
+  auto output_count = model->session.GetOutputCount();
 
-  if (!result.second) {
-    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0; i < output_count; i++) {
+    auto name = model->session.GetOutputName(i, allocator);
+    model->output_names.push_back(name);
+    allocator.Free(name);
+
+    ModelOutputInfo info{};
+    auto type_info = model->session.GetOutputTypeInfo(i);
+    if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+      auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+      info.type = tensor_info.GetElementType();
+      info.element_size = GetElementSize(info.type);
+      info.shape = tensor_info.GetShape();
+      info.has_static_shape = std::all_of(info.shape.begin(), info.shape.end(), [](int64_t dim) { return dim >= 0; });
+    }
+    model->output_info.push_back(std::move(info));
+  }
+
+  if (batching) {
+    const Ort::Session* session = &model->session;
+    model->batching_scheduler = std::make_unique<BatchingScheduler>(
+        [session](const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                  const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+          return Run(*session, run_options, input_names, input_values, output_names);
+        },
+        [session](uint64_t& requests, uint64_t& batches, uint64_t& unbatched_requests) {
+          session->GetDynamicBatchingStats(requests, batches, unbatched_requests);
+        },
+        batching_options);
   }
 
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
+  return model;
+}
 
+// Zero filled inputs with the symbolic and unknown dims set to 1. Returns false if the model has inputs that aren't
+// tensors of fixed size elements.
+static bool CreateZeroInputs(const LoadedModel& model, MemBufferArray& buffers, std::vector<std::string>& input_names,
+                             std::vector<Ort::Value>& input_values) {
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
   Ort::AllocatorWithDefaultOptions allocator;
-  for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
+  for (size_t i = 0, count = model.session.GetInputCount(); i < count; i++) {
+    auto type_info = model.session.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return false;
+    }
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    auto type = tensor_info.GetElementType();
+    size_t num_bytes = GetElementSize(type);
+    if (num_bytes == 0) {
+      return false;
+    }
+    auto shape = tensor_info.GetShape();
+    for (auto& dim : shape) {
+      dim = std::max<int64_t>(dim, 1);
+      num_bytes *= static_cast<size_t>(dim);
+    }
+
+    auto name = model.session.GetInputName(i, allocator);
+    input_names.push_back(name);
     allocator.Free(name);
+    input_values.push_back(Ort::Value::CreateTensor(memory_info, buffers.AllocNewBuffer(num_bytes), num_bytes,
+                                                    shape.data(), shape.size(), type));
   }
+
+  return true;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
+static void ReadWarmUpRequest(const std::string& path, PredictRequest& request) {
+  std::ifstream file(path, std::ios::binary);
+  std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  if (!file.good() && !file.eof()) {
+    throw Ort::Exception("Failed to read the warm up request " + path, ORT_INVALID_ARGUMENT);
+  }
+
+  const std::string json_extension = ".json";
+  bool is_json = path.size() >= json_extension.size() &&
+                 path.compare(path.size() - json_extension.size(), json_extension.size(), json_extension) == 0;
+  if (is_json) {
+    auto status = GetRequestFromJson(content, request);
+    if (!status.ok()) {
+      throw Ort::Exception("Invalid warm up request " + path + ": " + status.error_message(), ORT_INVALID_ARGUMENT);
+    }
+  } else if (!request.ParseFromString(content)) {
+    throw Ort::Exception("Invalid warm up request " + path, ORT_INVALID_ARGUMENT);
+  }
+}
+
+void ServerEnvironment::WarmUp(const std::string& model_name, const std::string& model_version,
+                               const LoadedModel& model, const WarmUpOptions& options) {
+  if (options.num_runs <= 0) {
+    return;
+  }
+
+  const bool from_request = !options.request_path.empty();
+  PredictRequest request;
+  MemBufferArray buffers;
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  std::vector<std::string> output_names = model.output_names;
+  if (from_request) {
+    ReadWarmUpRequest(options.request_path, request);
+    Executor executor(this, "WarmUp");
+    auto status = executor.SetNameMLValueMap(input_names, input_values, request, buffers);
+    if (!status.ok()) {
+      throw Ort::Exception("Invalid warm up request " + options.request_path + ": " + status.error_message(),
+                           ORT_INVALID_ARGUMENT);
+    }
+    if (!request.output_filter().empty()) {
+      output_names.assign(request.output_filter().begin(), request.output_filter().end());
+    }
+  } else if (!CreateZeroInputs(model, buffers, input_names, input_values)) {
+    default_logger_->info("Model {} version {} is not warmed up as it has inputs that can't be generated",
+                          model_name, model_version);
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Ort::RunOptions run_options{};
+  run_options.SetRunTag("WarmUp");
+  for (int i = 0; i < options.num_runs; i++) {
+    try {
+      Run(model.session, run_options, input_names, input_values, output_names);
+    } catch (const Ort::Exception& ex) {
+      if (from_request) {
+        throw Ort::Exception("Warm up request " + options.request_path + " failed: " + ex.what(), ex.GetOrtErrorCode());
+      }
+      // the model may not accept zeros or the guessed dims. it is still served.
+      default_logger_->warn("Warm up of model {} version {} failed: {}", model_name, model_version, ex.what());
+      return;
+    }
+  }
+
+  default_logger_->info("Warmed up model {} version {} with {} runs in {} ms", model_name, model_version,
+                        options.num_runs,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                                        const BatchingOptions& batching_options, const WarmUpOptions& warm_up_options) {
   auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    if (sessions_.find(identifier) != sessions_.end()) {
+      throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+    }
   }
 
-  return it->second.output_names;
+  auto model = CreateModel(model_path, batching_options);
+  WarmUp(model_name, model_version, *model, warm_up_options);
+
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  auto result = sessions_.emplace(identifier, std::move(model));
+  if (!result.second) {
+    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+  }
+  metrics_.AddModel(model_name, model_version);
 }
 
-OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
-  return severity_;
+void ServerEnvironment::LoadModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                                  const BatchingOptions& batching_options, const WarmUpOptions& warm_up_options) {
+  auto model = CreateModel(model_path, batching_options);
+  WarmUp(model_name, model_version, *model, warm_up_options);
+
+  std::shared_ptr<const LoadedModel> retired;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto& entry = sessions_[std::make_pair(model_name, model_version)];
+    retired = std::move(entry);
+    entry = std::move(model);
+    metrics_.AddModel(model_name, model_version);
+  }
+  // retired is released here, or by the last request that still uses it
 }
 
-const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
+std::shared_ptr<const LoadedModel> ServerEnvironment::GetModel(const std::string& model_name, const std::string& model_version) const {
   auto identifier = std::make_pair(model_name, model_version);
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
   auto it = sessions_.find(identifier);
   if (it == sessions_.end()) {
     throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
   }
 
-  return it->second.session;
+  return it->second;
+}
+
+std::string ServerEnvironment::GetLatestVersion(const std::string& model_name) const {
+  // numeric versions are ordered by value and after the other versions, which are ordered as strings
+  auto order = [](const std::string& version) {
+    bool numeric = !version.empty() && version.size() <= 18 &&
+                   std::all_of(version.begin(), version.end(), [](char c) { return c >= '0' && c <= '9'; });
+    return std::make_tuple(numeric, numeric ? std::stoll(version) : 0LL, version);
+  };
+
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  std::string latest;
+  bool found = false;
+  for (const auto& session : sessions_) {
+    if (session.first.first == model_name && (!found || order(latest) < order(session.first.second))) {
+      latest = session.first.second;
+      found = true;
+    }
+  }
+
+  return latest;
+}
+
+BatchingScheduler* ServerEnvironment::GetBatchingScheduler(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->batching_scheduler.get();
+}
+
+const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->output_names;
+}
+
+const std::vector<ModelOutputInfo>& ServerEnvironment::GetModelOutputInfo(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->output_info;
+}
+
+OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
+  return severity_;
+}
+
+const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
+  return GetModel(model_name, model_version)->session;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -141,12 +347,98 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
   auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  std::shared_ptr<const LoadedModel> retired;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(identifier);
+    if (it == sessions_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    retired = std::move(it->second);
+    sessions_.erase(it);
+  }
+  // retired is released here, or by the last request that still uses it
+}
+
+ServerMetrics& ServerEnvironment::GetMetrics() {
+  return metrics_;
+}
+
+void ServerEnvironment::EnableResponseCache(const ResponseCacheOptions& options) {
+  response_cache_ = std::make_unique<ResponseCache>(options);
+}
+
+ResponseCache* ServerEnvironment::GetResponseCache() const {
+  return response_cache_.get();
+}
+
+void ServerEnvironment::WriteMetrics(std::ostream& out) const {
+  metrics_.Write(out);
+  if (response_cache_ != nullptr) {
+    response_cache_->WriteMetrics(out);
+  }
+
+  // sort the models so the output is stable
+  std::map<std::pair<std::string, std::string>, std::shared_ptr<const LoadedModel>> models;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    for (const auto& session : sessions_) {
+      models.emplace(session.first, session.second);
+    }
+  }
+
+  // bytes in use and peak bytes in use
+  std::map<std::pair<std::string, std::string>, std::pair<int64_t, int64_t>> arena_usage;
+  for (const auto& model : models) {
+    auto& usage = arena_usage[model.first];
+    model.second->session.GetArenaMemoryUsage(usage.first, usage.second);
+  }
+  out << "# HELP ort_server_arena_bytes_in_use Bytes in use in the arena allocators of the model.\n"
+      << "# TYPE ort_server_arena_bytes_in_use gauge\n";
+  for (const auto& model : arena_usage) {
+    out << "ort_server_arena_bytes_in_use";
+    ServerMetrics::WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << model.second.first << '\n';
+  }
+  out << "# HELP ort_server_arena_max_bytes_in_use Peak bytes in use in the arena allocators of the model.\n"
+      << "# TYPE ort_server_arena_max_bytes_in_use gauge\n";
+  for (const auto& model : arena_usage) {
+    out << "ort_server_arena_max_bytes_in_use";
+    ServerMetrics::WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << model.second.second << '\n';
+  }
+
+  std::map<std::pair<std::string, std::string>, BatchingMetrics> batching_metrics;
+  for (const auto& model : models) {
+    if (model.second->batching_scheduler != nullptr) {
+      batching_metrics.emplace(model.first, model.second->batching_scheduler->GetMetrics());
+    }
+  }
+  if (batching_metrics.empty()) {
+    return;
   }
 
-  sessions_.erase(it);
+  auto write_metric = [&out, &batching_metrics](const char* name, const char* type, const char* help,
+                                                double (*value)(const BatchingMetrics&)) {
+    out << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+    for (const auto& model : batching_metrics) {
+      out << name;
+      ServerMetrics::WriteModelLabels(out, model.first.first, model.first.second);
+      out << ' ' << value(model.second) << '\n';
+    }
+  };
+  write_metric("ort_server_batching_requests_total", "counter", "Requests that went through the batching queue.",
+               [](const BatchingMetrics& m) { return static_cast<double>(m.requests); });
+  write_metric("ort_server_batching_rejected_requests_total", "counter",
+               "Requests rejected because the batching queue was full.",
+               [](const BatchingMetrics& m) { return static_cast<double>(m.rejected_requests); });
+  write_metric("ort_server_batches_total", "counter", "Runs executed for the batched requests.",
+               [](const BatchingMetrics& m) { return static_cast<double>(m.batches); });
+  write_metric("ort_server_unbatched_requests_total", "counter",
+               "Requests of the batching queue that were not eligible for batching.",
+               [](const BatchingMetrics& m) { return static_cast<double>(m.unbatched_requests); });
 }
 
 }  // namespace server
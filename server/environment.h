@@ -4,9 +4,14 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"
+#include "batching_scheduler.h"
+#include "metrics.h"
+#include "response_cache.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
@@ -14,6 +19,50 @@
 namespace onnxruntime {
 namespace server {
 
+// Type and shape of a model output that are known when the model is loaded
+struct ModelOutputInfo {
+  ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  // 0 if the output is not a tensor of fixed size elements
+  size_t element_size = 0;
+  // true if none of the dims in shape are symbolic or unknown
+  bool has_static_shape = false;
+  std::vector<int64_t> shape;
+};
+
+// How a model is warmed up before it serves requests. The first runs of a session are slower than the steady state
+// as they grow the arenas, plan the memory patterns and initialize the kernels.
+struct WarmUpOptions {
+  // runs of the warm-up inputs. 0 disables the warm-up.
+  int num_runs = 2;
+  // file of a PredictRequest with representative inputs, in JSON if its extension is .json and binary protobuf
+  // otherwise. If empty, the inputs are zero filled tensors of the input shapes with the symbolic dims set to 1.
+  std::string request_path;
+};
+
+// A loaded version of a model. Requests hold a reference to it while they run, so a version that is reloaded or
+// unloaded is released once the last request that uses it completes.
+struct LoadedModel {
+  Ort::Session session;
+  std::string model_path;
+  std::vector<std::string> output_names;
+  // Same order as output_names
+  std::vector<ModelOutputInfo> output_info;
+  // nullptr if batching is not enabled for the model
+  std::unique_ptr<BatchingScheduler> batching_scheduler;
+  // nullptr if the responses are not cached. The cached responses of the model are removed when it is released.
+  ResponseCache* response_cache = nullptr;
+
+  explicit LoadedModel(Ort::Env& env, const std::string& path, const Ort::SessionOptions& options)
+      : session(env, path.c_str(), options), model_path(path) {}
+  ~LoadedModel() {
+    if (response_cache != nullptr) {
+      response_cache->Erase(this);
+    }
+  }
+  LoadedModel(const LoadedModel&) = delete;
+  LoadedModel& operator=(const LoadedModel&) = delete;
+};
+
 class ServerEnvironment {
  public:
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
@@ -22,13 +71,47 @@ class ServerEnvironment {
 
   OrtLoggingLevel GetLogSeverity() const;
 
+  // Returns the loaded model. Throws if no model of that name and version is loaded.
+  std::shared_ptr<const LoadedModel> GetModel(const std::string& model_name, const std::string& model_version) const;
+  // Returns the highest version of the model that is loaded, numeric versions ordered by value.
+  // Returns an empty string if no version of the model is loaded.
+  std::string GetLatestVersion(const std::string& model_name) const;
+
+  // The references returned by GetSession, GetBatchingScheduler, GetModelOutputNames and GetModelOutputInfo are only
+  // valid until the model is reloaded or unloaded. Use GetModel while other threads can load models.
   const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
-  void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
+  // Throws if a model of that name and version is already loaded, or if the warm-up request fails.
+  // A failed run of generated warm-up inputs is only logged.
+  void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                       const BatchingOptions& batching_options = BatchingOptions{},
+                       const WarmUpOptions& warm_up_options = WarmUpOptions{});
+  // Loads the model and warms it up, then makes it the model of that name and version, replacing the loaded one.
+  // Requests keep running on the loaded model while the new one is loaded, and the requests that started before the
+  // swap complete on it. Throws if the model can't be loaded, in which case the loaded model stays in place.
+  void LoadModel(const std::string& model_path, const std::string& model_name, const std::string& model_version,
+                 const BatchingOptions& batching_options = BatchingOptions{},
+                 const WarmUpOptions& warm_up_options = WarmUpOptions{});
+  // Returns nullptr if batching is not enabled for the model
+  BatchingScheduler* GetBatchingScheduler(const std::string& model_name, const std::string& model_version) const;
   const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Same order as GetModelOutputNames
+  const std::vector<ModelOutputInfo>& GetModelOutputInfo(const std::string& model_name, const std::string& model_version) const;
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
+  // The model is released once the requests that use it complete
   void UnloadModel(const std::string& model_name, const std::string& model_version);
+  // Appends the execution providers the server was built with to the session options. Only the first call has
+  // an effect.
   void RegisterExecutionProviders();
+  ServerMetrics& GetMetrics();
+  // Caches the responses of the models loaded after the call. Call it before the first model is loaded.
+  void EnableResponseCache(const ResponseCacheOptions& options);
+  // Returns nullptr if the response cache is not enabled
+  ResponseCache* GetResponseCache() const;
+  // Write the request metrics, the response cache metrics, the batching queue metrics and the arena memory use of
+  // the loaded models
+  // in the Prometheus text exposition format
+  void WriteMetrics(std::ostream& out) const;
 
  private:
   const OrtLoggingLevel severity_;
@@ -38,20 +121,19 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  ServerMetrics metrics_;
+  std::once_flag providers_registered_;
+  // declared before sessions_ so it outlives the models, which remove their responses when they are released
+  std::unique_ptr<ResponseCache> response_cache_;
+
+  std::shared_ptr<LoadedModel> CreateModel(const std::string& model_path, const BatchingOptions& batching_options);
+  // Runs the model so the first requests don't pay for the lazy initialization
+  void WarmUp(const std::string& model_name, const std::string& model_version, const LoadedModel& model,
+              const WarmUpOptions& options);
 
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
-
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // Models are loaded without holding the lock. It is only held to look up, add, replace or remove a model.
+  mutable std::mutex sessions_mutex_;
+  std::unordered_map<std::pair<std::string, std::string>, std::shared_ptr<const LoadedModel>, boost::hash<std::pair<std::string, std::string>>> sessions_;
 };
 
 }  // namespace server
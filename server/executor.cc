@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
+#include <chrono>
 #include "serializing/mem_buffer.h"
 #include "serializing/tensorprotoutils.h"
 
@@ -10,6 +12,7 @@
 
 #include "converter.h"
 #include "executor.h"
+#include "response_cache.h"
 #include "util.h"
 
 namespace onnxruntime {
@@ -23,6 +26,16 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // raw_data with the right layout is used in place. the request outlives the run so no copy is needed.
+  try {
+    if (onnxruntime::server::TryCreateMLValueOverRawData(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TryCreateMLValueOverRawData() failed. Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -79,30 +92,84 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
-  size_t input_count = input_names.size();
-  size_t output_count = output_names.size();
-
-  std::vector<const char*> input_ptrs{};
-  input_ptrs.reserve(input_count);
-  for (const auto& input : input_names) {
-    input_ptrs.push_back(input.data());
+void Executor::PreallocateOutputs(const LoadedModel& model,
+                                  const std::vector<std::string>& output_names,
+                                  const OrtMemoryInfo* cpu_memory_info,
+                                  onnxruntime::server::PredictResponse& response,
+                                  /* out */ std::vector<Ort::Value>& outputs) {
+  outputs.clear();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    outputs.emplace_back(nullptr);
   }
-  std::vector<const char*> output_ptrs{};
-  output_ptrs.reserve(output_count);
-  for (const auto& output : output_names) {
-    output_ptrs.push_back(output.data());
+
+  // Only raw_data responses can be written in place
+  if (!using_raw_data_) {
+    return;
   }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  const auto& model_output_names = model.output_names;
+  const auto& model_output_info = model.output_info;
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    auto it = std::find(model_output_names.begin(), model_output_names.end(), output_names[i]);
+    if (it == model_output_names.end()) {
+      continue;
+    }
+
+    const auto& info = model_output_info[it - model_output_names.begin()];
+    if (info.element_size == 0 || !info.has_static_shape) {
+      continue;
+    }
+
+    size_t num_bytes = info.element_size;
+    for (auto dim : info.shape) {
+      num_bytes *= static_cast<size_t>(dim);
+    }
+
+    auto* raw_data = (*response.mutable_outputs())[output_names[i]].mutable_raw_data();
+    raw_data->resize(num_bytes);
+    if (reinterpret_cast<uintptr_t>(&(*raw_data)[0]) % info.element_size != 0) {
+      raw_data->clear();
+      continue;
+    }
+
+    outputs[i] = Ort::Value::CreateTensor(cpu_memory_info, &(*raw_data)[0], num_bytes,
+                                          info.shape.data(), info.shape.size(), info.type);
+  }
 }
 
 protobufutil::Status Executor::Predict(const std::string& model_name,
                                        const std::string& model_version,
                                        const onnxruntime::server::PredictRequest& request,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
+  auto status = PredictImpl(model_name, model_version, request, response);
+  env_->GetMetrics().RecordRequest(model_name, model_version, status.ok() ? "" : GetErrorCodeName(status.code()));
+  return status;
+}
+
+protobufutil::Status Executor::PredictImpl(const std::string& model_name,
+                                           const std::string& model_version,
+                                           const onnxruntime::server::PredictRequest& request,
+                                           /* out */ onnxruntime::server::PredictResponse& response) {
   auto logger = env_->GetLogger(request_id_);
 
+  // Held for the whole request so a reload or unload of the model doesn't release it while it is used
+  std::shared_ptr<const LoadedModel> model;
+  try {
+    model = env_->GetModel(model_name, model_version);
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  // Repeated requests are answered from the cache without a Run
+  auto* response_cache = model->response_cache;
+  std::string cache_key;
+  if (response_cache != nullptr) {
+    cache_key = ResponseCache::GetKey(request);
+    if (response_cache->Lookup(model.get(), model_name, model_version, cache_key, response)) {
+      return protobufutil::Status::OK;
+    }
+  }
+
   // Convert PredictRequest to NameMLValMap
   MemBufferArray buffer_array;
   std::vector<std::string> input_names;
@@ -125,19 +192,41 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       output_names.push_back(name);
     }
   } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
+    output_names = model->output_names;
+  }
+
+  // Output names must be unique as each of them is a key in the response
+  for (size_t i = 0, sz = output_names.size(); i < sz; ++i) {
+    if (std::find(output_names.begin() + i + 1, output_names.end(), output_names[i]) != output_names.end()) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
   }
 
   std::vector<Ort::Value> outputs;
+  const auto run_start = std::chrono::steady_clock::now();
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    auto* scheduler = model->batching_scheduler.get();
+    if (scheduler != nullptr) {
+      auto run_status = scheduler->Run(run_options, input_names, input_values, output_names, logger, outputs);
+      if (run_status != protobufutil::Status::OK) {
+        return run_status;
+      }
+    } else {
+      auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+      PreallocateOutputs(*model, output_names, memory_info, response, outputs);
+      Run(model->session, run_options, input_names, input_values, output_names, outputs);
+    }
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
+  env_->GetMetrics().RecordRunDuration(
+      model_name, model_version,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count());
 
-  // Build the response
+  // Build the response. Outputs that were preallocated are already in place.
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    auto& output_tensor = (*response.mutable_outputs())[output_names[i]];
     try {
       MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
     } catch (const Ort::Exception& e) {
@@ -145,13 +234,10 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
+  }
 
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
+  if (response_cache != nullptr) {
+    response_cache->Insert(model.get(), cache_key, response);
   }
 
   return protobufutil::Status::OK;
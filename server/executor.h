@@ -25,20 +25,36 @@ class Executor {
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Converts the inputs of the request to values. buffers holds the data of the values that don't use the
+  // request in place.
+  google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
+                                                   /* out */ std::vector<Ort::Value>& input_values,
+                                                   const onnxruntime::server::PredictRequest& request,
+                                                   MemBufferArray& buffers);
+
  private:
   ServerEnvironment* env_;
   const std::string request_id_;
   bool using_raw_data_;
 
+  // Predict without recording the request in the server metrics
+  google::protobuf::util::Status PredictImpl(const std::string& model_name,
+                                             const std::string& model_version,
+                                             const onnxruntime::server::PredictRequest& request,
+                                             /* out */ onnxruntime::server::PredictResponse& response);
+
   google::protobuf::util::Status SetMLValue(const onnx::TensorProto& input_tensor,
                                             MemBufferArray& buffers,
                                             OrtMemoryInfo* cpu_memory_info,
                                             /* out */ Ort::Value& ml_value);
 
-  google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
-                                                   /* out */ std::vector<Ort::Value>& input_values,
-                                                   const onnxruntime::server::PredictRequest& request,
-                                                   MemBufferArray& buffers);
+  // Creates output values over the raw_data of the response tensors for outputs with a static shape,
+  // so they are written in place by the run. The others are left empty to be allocated by the session.
+  void PreallocateOutputs(const LoadedModel& model,
+                          const std::vector<std::string>& output_names,
+                          const OrtMemoryInfo* cpu_memory_info,
+                          onnxruntime::server::PredictResponse& response,
+                          /* out */ std::vector<Ort::Value>& outputs);
 };
 
 }  // namespace server
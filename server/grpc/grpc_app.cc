@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "grpc_app.h"
+#include "predict_stream_call.h"
 #include <grpcpp/health_check_service_interface.h>
 #include <grpcpp/ext/channelz_service_plugin.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
@@ -9,16 +12,39 @@ namespace onnx_grpc = onnxruntime::server::grpc;
 
 namespace onnxruntime {
 namespace server {
-GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port) : prediction_service_implementation_(env) {
+GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+                 int num_stream_threads) : prediction_service_implementation_(env) {
   ::grpc::EnableDefaultHealthCheckService(true);
   ::grpc::channelz::experimental::InitChannelzService();
   ::grpc::reflection::InitProtoReflectionServerBuilderPlugin();
   ::grpc::ServerBuilder builder;
   builder.RegisterService(&prediction_service_implementation_);
   builder.AddListeningPort(host + ":" + std::to_string(port), ::grpc::InsecureServerCredentials());
+  stream_cq_ = builder.AddCompletionQueue();
 
   server_ = builder.BuildAndStart();
   server_->GetHealthCheckService()->SetServingStatus(PredictionService::service_full_name(), true);
+
+  // the threads share the completion queue, so the requests of a stream are predicted concurrently
+  onnx_grpc::PredictStreamCall::Start(&prediction_service_implementation_, stream_cq_.get());
+  for (int i = 0; i < std::max(num_stream_threads, 1); ++i) {
+    stream_threads_.emplace_back([this]() {
+      void* tag = nullptr;
+      bool ok = false;
+      while (stream_cq_->Next(&tag, &ok)) {
+        onnx_grpc::PredictStreamCall::HandleEvent(tag, ok);
+      }
+    });
+  }
+}
+
+GRPCApp::~GRPCApp() {
+  // the completion queue is shut down after the server, and drained by the threads
+  server_->Shutdown();
+  stream_cq_->Shutdown();
+  for (auto& thread : stream_threads_) {
+    thread.join();
+  }
 }
 
 void GRPCApp::Run() {
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <thread>
+#include <vector>
 #include <grpcpp/grpcpp.h>
 #include "prediction_service_impl.h"
 #include "environment.h"
@@ -10,8 +12,10 @@ namespace onnxruntime {
 namespace server {
 class GRPCApp {
  public:
-  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port);
-  ~GRPCApp() = default;
+  // num_stream_threads threads serve the completion queue of the PredictStream calls, and predict their requests
+  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+          int num_stream_threads = 1);
+  ~GRPCApp();
   GRPCApp(const GRPCApp& other) = delete;
   GRPCApp(GRPCApp&& other) = delete;
 
@@ -22,7 +26,9 @@ class GRPCApp {
 
  private:
   grpc::PredictionServiceImpl prediction_service_implementation_;
+  std::unique_ptr<::grpc::ServerCompletionQueue> stream_cq_;
   std::unique_ptr<::grpc::Server> server_;
+  std::vector<std::thread> stream_threads_;
 };
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "predict_stream_call.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+void PredictStreamCall::Start(PredictionServiceImpl* service, ::grpc::ServerCompletionQueue* cq) {
+  auto* call = new PredictStreamCall(service, cq);
+  service->RequestPredictStream(&call->context_, &call->stream_, cq, cq, &call->connect_op_);
+}
+
+PredictStreamCall::PredictStreamCall(PredictionServiceImpl* service, ::grpc::ServerCompletionQueue* cq)
+    : service_(service), cq_(cq), stream_(&context_) {}
+
+void PredictStreamCall::HandleEvent(void* tag, bool ok) {
+  auto* op = static_cast<Operation*>(tag);
+  switch (op->type) {
+    case OperationType::Connect:
+      op->call->OnConnect(ok);
+      break;
+    case OperationType::Read:
+      op->call->OnRead(ok);
+      break;
+    case OperationType::Write:
+      op->call->OnWrite(ok);
+      break;
+    case OperationType::Finish:
+      op->call->OnFinish();
+      break;
+  }
+}
+
+void PredictStreamCall::OnConnect(bool ok) {
+  if (!ok) {
+    // the server is shutting down
+    delete this;
+    return;
+  }
+
+  // wait for the next stream while this one is served
+  Start(service_, cq_);
+
+  request_id_ = service_->SetRequestContext(&context_);
+  service_->GetModelSpec(context_, model_name_, model_version_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  StartReadLocked();
+}
+
+void PredictStreamCall::OnRead(bool ok) {
+  PredictRequest request;
+  uint64_t index = 0;
+  bool predict = false;
+  bool done = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_pending_ = false;
+    if (!ok || finish_started_) {
+      // the client is done writing, or the stream is finishing
+      reads_done_ = true;
+      MaybeFinishLocked();
+      done = DoneLocked();
+    } else {
+      request.Swap(&read_request_);
+      index = next_read_index_++;
+      ++num_predicting_;
+      predict = true;
+      StartReadLocked();
+    }
+  }
+
+  if (predict) {
+    Result result;
+    result.status = service_->Predict(request_id_, model_name_, model_version_, request, result.response);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --num_predicting_;
+    if (!finish_started_) {
+      results_.emplace(index, std::move(result));
+      WriteNextLocked();
+      MaybeFinishLocked();
+    }
+    done = DoneLocked();
+  }
+
+  if (done) {
+    // no operation refers to the call anymore
+    delete this;
+  }
+}
+
+void PredictStreamCall::OnWrite(bool ok) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_pending_ = false;
+    if (!ok) {
+      // the stream is broken
+      FinishLocked(::grpc::Status(::grpc::StatusCode::CANCELLED, "Failed to write the response"));
+      return;
+    }
+    WriteNextLocked();
+    MaybeFinishLocked();
+    if (!DoneLocked()) {
+      return;
+    }
+  }
+  delete this;
+}
+
+void PredictStreamCall::OnFinish() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finish_done_ = true;
+    if (!DoneLocked()) {
+      return;
+    }
+  }
+  delete this;
+}
+
+void PredictStreamCall::StartReadLocked() {
+  if (read_pending_ || reads_done_ || finish_started_) {
+    return;
+  }
+  read_pending_ = true;
+  stream_.Read(&read_request_, &read_op_);
+}
+
+void PredictStreamCall::WriteNextLocked() {
+  if (write_pending_ || finish_started_) {
+    return;
+  }
+
+  auto next = results_.find(next_write_index_);
+  if (next == results_.end()) {
+    return;
+  }
+
+  if (!next->second.status.ok()) {
+    FinishLocked(next->second.status);
+    return;
+  }
+
+  write_response_.Swap(&next->second.response);
+  results_.erase(next);
+  ++next_write_index_;
+  write_pending_ = true;
+  stream_.Write(write_response_, &write_op_);
+}
+
+void PredictStreamCall::FinishLocked(const ::grpc::Status& status) {
+  if (finish_started_) {
+    return;
+  }
+  finish_started_ = true;
+  results_.clear();
+  stream_.Finish(status, &finish_op_);
+}
+
+void PredictStreamCall::MaybeFinishLocked() {
+  if (reads_done_ && num_predicting_ == 0 && !write_pending_ && results_.empty()) {
+    FinishLocked(::grpc::Status::OK);
+  }
+}
+
+bool PredictStreamCall::DoneLocked() const {
+  return finish_done_ && !read_pending_ && !write_pending_ && num_predicting_ == 0;
+}
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
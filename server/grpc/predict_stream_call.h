@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include "prediction_service_impl.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+// One PredictStream call, driven by the threads of its completion queue.
+//
+// The next read of the stream is started before a request that was read is predicted, so when several threads
+// serve the completion queue the requests of a stream are predicted concurrently and can be batched together.
+// The responses are written one at a time in the order of the requests. The first request that fails finishes the
+// stream with its status once the responses before it are written.
+class PredictStreamCall {
+ public:
+  // Waits for the next PredictStream call on cq. The call deletes itself once it is finished.
+  static void Start(PredictionServiceImpl* service, ::grpc::ServerCompletionQueue* cq);
+
+  // Handles an event of cq. tag is a tag of a PredictStreamCall and ok the result of its operation.
+  static void HandleEvent(void* tag, bool ok);
+
+  PredictStreamCall(const PredictStreamCall&) = delete;
+  PredictStreamCall& operator=(const PredictStreamCall&) = delete;
+
+ private:
+  enum class OperationType { Connect,
+                             Read,
+                             Write,
+                             Finish };
+
+  struct Operation {
+    PredictStreamCall* call;
+    OperationType type;
+  };
+
+  PredictStreamCall(PredictionServiceImpl* service, ::grpc::ServerCompletionQueue* cq);
+
+  void OnConnect(bool ok);
+  void OnRead(bool ok);
+  void OnWrite(bool ok);
+  void OnFinish();
+
+  // the methods below must be called with mutex_ held
+  void StartReadLocked();
+  void WriteNextLocked();
+  void FinishLocked(const ::grpc::Status& status);
+  void MaybeFinishLocked();
+  bool DoneLocked() const;
+
+  struct Result {
+    ::grpc::Status status;
+    PredictResponse response;
+  };
+
+  PredictionServiceImpl* const service_;
+  ::grpc::ServerCompletionQueue* const cq_;
+  ::grpc::ServerContext context_;
+  ::grpc::ServerAsyncReaderWriter<PredictResponse, PredictRequest> stream_;
+  std::string request_id_;
+  // all the requests of the stream go to the model selected when the stream starts
+  std::string model_name_;
+  std::string model_version_;
+
+  Operation connect_op_{this, OperationType::Connect};
+  Operation read_op_{this, OperationType::Read};
+  Operation write_op_{this, OperationType::Write};
+  Operation finish_op_{this, OperationType::Finish};
+
+  std::mutex mutex_;
+  PredictRequest read_request_;    // target of the pending read
+  PredictResponse write_response_;  // source of the pending write
+  uint64_t next_read_index_ = 0;
+  uint64_t next_write_index_ = 0;
+  // responses that wait for the responses of earlier requests to be written, by request index
+  std::map<uint64_t, Result> results_;
+  int num_predicting_ = 0;
+  bool read_pending_ = false;
+  bool write_pending_ = false;
+  bool reads_done_ = false;
+  bool finish_started_ = false;
+  bool finish_done_ = false;
+};
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
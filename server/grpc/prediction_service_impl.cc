@@ -8,13 +8,23 @@ namespace onnxruntime {
 namespace server {
 namespace grpc {
 
+const char* const MODEL_NAME_METADATA = "model-name";
+const char* const MODEL_VERSION_METADATA = "model-version";
+
 PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
+  std::string model_name;
+  std::string model_version;
+  GetModelSpec(*context, model_name, model_version);
+  return Predict(request_id, model_name, model_version, *request, *response);
+}
+
+::grpc::Status PredictionServiceImpl::Predict(const std::string& request_id, const std::string& model_name, const std::string& model_version,
+                                              const ::onnxruntime::server::PredictRequest& request, ::onnxruntime::server::PredictResponse& response) {
   onnxruntime::server::Executor executor(environment_.get(), request_id);
-  //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  auto status = executor.Predict(model_name, model_version, request, response);
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
@@ -36,6 +46,15 @@ std::string PredictionServiceImpl::SetRequestContext(::grpc::ServerContext* cont
   return request_id;
 }
 
+void PredictionServiceImpl::GetModelSpec(const ::grpc::ServerContext& context, std::string& model_name, std::string& model_version) const {
+  const auto& metadata = context.client_metadata();
+  auto name = metadata.find(MODEL_NAME_METADATA);
+  model_name = name != metadata.end() ? std::string(name->second.data(), name->second.length()) : "default";
+  auto version = metadata.find(MODEL_VERSION_METADATA);
+  model_version = version != metadata.end() ? std::string(version->second.data(), version->second.length())
+                                            : environment_->GetLatestVersion(model_name);
+}
+
 }  // namespace grpc
 }  // namespace server
 
@@ -10,16 +10,33 @@
 namespace onnxruntime {
 namespace server {
 namespace grpc {
-class PredictionServiceImpl final : public onnxruntime::server::PredictionService::Service {
+
+// Client metadata keys selecting the model of a call
+extern const char* const MODEL_NAME_METADATA;
+extern const char* const MODEL_VERSION_METADATA;
+
+// Predict is served by the synchronous gRPC threads and PredictStream through the asynchronous API, see
+// PredictStreamCall.
+class PredictionServiceImpl final
+    : public onnxruntime::server::PredictionService::WithAsyncMethod_PredictStream<
+          onnxruntime::server::PredictionService::Service> {
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
   ::grpc::Status Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response);
 
- private:
-  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
+  // Predicts one request of a stream
+  ::grpc::Status Predict(const std::string& request_id, const std::string& model_name, const std::string& model_version,
+                         const ::onnxruntime::server::PredictRequest& request, ::onnxruntime::server::PredictResponse& response);
 
   //Extract customer request ID and set request ID for response.
   std::string SetRequestContext(::grpc::ServerContext* context);
+
+  // The model named by the model-name and model-version metadata of the call. The model defaults to "default"
+  // and the version to the latest loaded version of the model.
+  void GetModelSpec(const ::grpc::ServerContext& context, std::string& model_name, std::string& model_version) const;
+
+ private:
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
 };
 }  // namespace grpc
 }  // namespace server
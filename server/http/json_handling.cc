@@ -1,8 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#include <sstream>
+#include <cerrno>
+#include <cstdlib>
 #include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 #include <boost/beast/core.hpp>
 #include <google/protobuf/util/json_util.h>
@@ -34,6 +38,109 @@ protobufutil::Status GenerateResponseInJson(const onnxruntime::server::PredictRe
   return result;
 }
 
+static bool ParseSize(const std::string& value, size_t& size) {
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  errno = 0;
+  auto parsed = std::strtoull(value.c_str(), nullptr, 10);
+  if (errno == ERANGE || parsed > std::numeric_limits<size_t>::max()) {
+    return false;
+  }
+  size = static_cast<size_t>(parsed);
+  return true;
+}
+
+protobufutil::Status GetRequestFromJsonWithBinaryData(const std::string& body, size_t header_length,
+                                                      /* out */ onnxruntime::server::PredictRequest& request) {
+  if (header_length > body.size()) {
+    return protobufutil::Status(protobufutil::error::INVALID_ARGUMENT,
+                                "Inference-Header-Content-Length is larger than the body");
+  }
+
+  protobufutil::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+  protobufutil::Status result = JsonStringToMessage(google::protobuf::StringPiece(body.data(), header_length),
+                                                    &request, options);
+  if (!result.ok()) {
+    return result;
+  }
+
+  const char* binary_data = body.data() + header_length;
+  const size_t binary_size = body.size() - header_length;
+  for (auto& input : *request.mutable_inputs()) {
+    auto& tensor = input.second;
+    if (tensor.data_location() != onnx::TensorProto_DataLocation_EXTERNAL) {
+      continue;
+    }
+
+    bool has_offset = false;
+    bool has_length = false;
+    size_t offset = 0;
+    size_t length = 0;
+    for (const auto& entry : tensor.external_data()) {
+      if (entry.key() == "offset") {
+        has_offset = ParseSize(entry.value(), offset);
+      } else if (entry.key() == "length") {
+        has_length = ParseSize(entry.value(), length);
+      }
+    }
+    if (!has_offset || !has_length) {
+      return protobufutil::Status(protobufutil::error::INVALID_ARGUMENT,
+                                  "Input " + input.first + " needs a valid offset and length of its binary data");
+    }
+    if (offset > binary_size || length > binary_size - offset) {
+      return protobufutil::Status(protobufutil::error::INVALID_ARGUMENT,
+                                  "The binary data of input " + input.first + " is out of the body");
+    }
+
+    tensor.set_raw_data(binary_data + offset, length);
+    tensor.clear_external_data();
+    tensor.clear_data_location();
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status GenerateResponseInJsonWithBinaryData(onnxruntime::server::PredictResponse& response,
+                                                          /* out */ std::string& body,
+                                                          /* out */ size_t& header_length) {
+  // move the raw data out of the outputs and reference it from the header
+  std::vector<std::string> binary_data;
+  binary_data.reserve(response.outputs().size());
+  size_t binary_size = 0;
+  for (auto& output : *response.mutable_outputs()) {
+    auto& tensor = output.second;
+    if (!tensor.has_raw_data()) {
+      continue;
+    }
+
+    binary_data.emplace_back();
+    binary_data.back().swap(*tensor.mutable_raw_data());
+    tensor.clear_raw_data();
+    tensor.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+    auto* offset = tensor.add_external_data();
+    offset->set_key("offset");
+    offset->set_value(std::to_string(binary_size));
+    auto* length = tensor.add_external_data();
+    length->set_key("length");
+    length->set_value(std::to_string(binary_data.back().size()));
+    binary_size += binary_data.back().size();
+  }
+
+  protobufutil::Status result = GenerateResponseInJson(response, body);
+  if (!result.ok()) {
+    return result;
+  }
+
+  header_length = body.size();
+  body.reserve(header_length + binary_size);
+  for (const auto& data : binary_data) {
+    body.append(data);
+  }
+  return protobufutil::Status::OK;
+}
+
 std::string CreateJsonError(const http::status error_code, const std::string& error_message) {
   auto escaped_message = escape_string(error_message);
   return R"({"error_code": )" + std::to_string(int(error_code)) + R"(, "error_message": ")" + escaped_message + R"("})" + "\n";
@@ -22,6 +22,21 @@ google::protobuf::util::Status GetRequestFromJson(const std::string& json_string
 // 2. Enums will be printed as string, not int, to improve readability
 google::protobuf::util::Status GenerateResponseInJson(const onnxruntime::server::PredictResponse& response, /* out */ std::string& json_string);
 
+// Deserialize a body made of a Json header of header_length bytes followed by the raw data of the input tensors.
+// The header is a Json PredictRequest. An input with its data in the binary part has the EXTERNAL data location and
+// the "offset" and "length" of its data in the binary part as external data entries, e.g.
+// {"inputs":{"x":{"dims":["3"],"dataType":1,"dataLocation":"EXTERNAL",
+//                 "externalData":[{"key":"offset","value":"0"},{"key":"length","value":"12"}]}}}
+// The data is copied to raw_data of the input as is.
+google::protobuf::util::Status GetRequestFromJsonWithBinaryData(const std::string& body, size_t header_length,
+                                                                /* out */ onnxruntime::server::PredictRequest& request);
+
+// Serialize PredictResponse to a Json header followed by the raw data of the output tensors, in the format
+// described above. The raw_data of the outputs is moved to the binary part of the body.
+google::protobuf::util::Status GenerateResponseInJsonWithBinaryData(onnxruntime::server::PredictResponse& response,
+                                                                    /* out */ std::string& body,
+                                                                    /* out */ size_t& header_length);
+
 // Constructs JSON error message from error code object and error message
 std::string CreateJsonError(http::status error_code, const std::string& error_message);
 
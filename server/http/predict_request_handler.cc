@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cerrno>
+#include <cstdlib>
+
+#include <google/protobuf/arena.h>
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
@@ -40,7 +44,8 @@ void Predict(const std::string& name,
   logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
 
   auto effective_name = name.empty() ? "default" : name;
-  auto effective_version = version.empty() ? "1" : version;
+  // the latest loaded version when the request doesn't name one
+  auto effective_version = version.empty() ? env->GetLatestVersion(effective_name) : version;
 
   if (!context.client_request_id.empty()) {
     logger->info("{}: [{}]", util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
@@ -53,12 +58,13 @@ void Predict(const std::string& name,
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
 
-  // Deserialize the payload
-  auto body = context.request.body();
-  PredictRequest predict_request{};
+  // Deserialize the payload. The request and response messages are allocated on an arena that lives for the request,
+  // and the input tensors use the raw_data of the request in place.
+  google::protobuf::Arena arena;
+  auto* predict_request = google::protobuf::Arena::CreateMessage<PredictRequest>(&arena);
   http::status error_code;
   std::string error_message;
-  bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
+  bool parse_succeeded = ParseRequestPayload(context, request_type, *predict_request, error_code, error_message);
   if (!parse_succeeded) {
     GenerateErrorResponse(logger, error_code, error_message, context);
     return;
@@ -66,8 +72,8 @@ void Predict(const std::string& name,
 
   // Run Prediction
   Executor executor(env.get(), context.request_id);
-  PredictResponse predict_response{};
-  auto status = executor.Predict(effective_name, effective_version, predict_request, predict_response);
+  auto* predict_response = google::protobuf::Arena::CreateMessage<PredictResponse>(&arena);
+  auto status = executor.Predict(effective_name, effective_version, *predict_request, *predict_response);
   if (!status.ok()) {
     GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
     return;
@@ -76,14 +82,23 @@ void Predict(const std::string& name,
   // Serialize to proper output format
   std::string response_body{};
   if (response_type == SupportedContentType::Json) {
-    status = GenerateResponseInJson(predict_response, response_body);
+    status = GenerateResponseInJson(*predict_response, response_body);
     if (!status.ok()) {
       GenerateErrorResponse(logger, http::status::internal_server_error, status.error_message(), context);
       return;
     }
     context.response.set(http::field::content_type, "application/json");
+  } else if (response_type == SupportedContentType::JsonWithBinaryData) {
+    size_t header_length = 0;
+    status = GenerateResponseInJsonWithBinaryData(*predict_response, response_body, header_length);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, http::status::internal_server_error, status.error_message(), context);
+      return;
+    }
+    context.response.set(INFERENCE_HEADER_CONTENT_LENGTH, std::to_string(header_length));
+    context.response.set(http::field::content_type, "application/octet-stream");
   } else {
-    response_body = predict_response.SerializeAsString();
+    predict_response->SerializeToString(&response_body);
     if (context.request.find("Accept") != context.request.end() && context.request["Accept"] != "*/*") {
       context.response.set(http::field::content_type, context.request["Accept"].to_string());
     } else {
@@ -96,12 +111,12 @@ void Predict(const std::string& name,
   if (!context.client_request_id.empty()) {
     context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
   }
-  context.response.body() = response_body;
+  context.response.body() = std::move(response_body);
   context.response.result(http::status::ok);
 };
 
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
-  auto body = context.request.body();
+  const auto& body = context.request.body();
   protobufutil::Status status;
   switch (request_type) {
     case SupportedContentType::Json: {
@@ -113,6 +128,24 @@ static bool ParseRequestPayload(const HttpContext& context, SupportedContentType
       }
       break;
     }
+    case SupportedContentType::JsonWithBinaryData: {
+      const auto header_length = context.request[INFERENCE_HEADER_CONTENT_LENGTH].to_string();
+      char* end = nullptr;
+      errno = 0;
+      auto length = std::strtoull(header_length.c_str(), &end, 10);
+      if (header_length.empty() || *end != '\0' || errno == ERANGE || header_length[0] == '-') {
+        error_code = http::status::bad_request;
+        error_message = "Invalid Inference-Header-Content-Length header field in the request";
+        return false;
+      }
+      status = GetRequestFromJsonWithBinaryData(body, static_cast<size_t>(length), predictRequest);
+      if (!status.ok()) {
+        error_code = GetHttpStatusCode(status);
+        error_message = status.error_message();
+        return false;
+      }
+      break;
+    }
     case SupportedContentType::PbByteArray: {
       bool parse_succeeded = predictRequest.ParseFromArray(body.data(), static_cast<int>(body.size()));
       if (!parse_succeeded) {
@@ -13,6 +13,8 @@ namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
 namespace server {
 
+const char* const INFERENCE_HEADER_CONTENT_LENGTH = "Inference-Header-Content-Length";
+
 static std::unordered_set<std::string> protobuf_mime_types{
     "application/octet-stream",
     "application/vnd.google.protobuf",
@@ -55,6 +57,9 @@ boost::beast::http::status GetHttpStatusCode(const protobufutil::Status& status)
 }
 
 SupportedContentType GetRequestContentType(const HttpContext& context) {
+  if (context.request.find(INFERENCE_HEADER_CONTENT_LENGTH) != context.request.end()) {
+    return SupportedContentType::JsonWithBinaryData;
+  }
   if (context.request.find("Content-Type") != context.request.end()) {
     if (context.request["Content-Type"] == "application/json") {
       return SupportedContentType::Json;
@@ -67,6 +72,11 @@ SupportedContentType GetRequestContentType(const HttpContext& context) {
 }
 
 SupportedContentType GetResponseContentType(const HttpContext& context) {
+  bool binary_request = context.request.find(INFERENCE_HEADER_CONTENT_LENGTH) != context.request.end();
+  if (binary_request && (context.request.find("Accept") == context.request.end() ||
+                         context.request["Accept"] == "*/*")) {
+    return SupportedContentType::JsonWithBinaryData;
+  }
   if (context.request.find("Accept") != context.request.end()) {
     if (context.request["Accept"] == "application/json") {
       return SupportedContentType::Json;
@@ -17,18 +17,25 @@ namespace beast = boost::beast;  // from <boost/beast.hpp>
 enum class SupportedContentType : int {
   Unknown,
   Json,
-  PbByteArray
+  PbByteArray,
+  // a Json header of INFERENCE_HEADER_CONTENT_LENGTH bytes followed by the raw data of the tensors
+  JsonWithBinaryData
 };
 
+// Header field with the length of the Json header of a body with binary tensor data
+extern const char* const INFERENCE_HEADER_CONTENT_LENGTH;
+
 // Mapping protobuf status to http status
 boost::beast::http::status GetHttpStatusCode(const google::protobuf::util::Status& status);
 
 // "Content-Type" header field in request is MUST-HAVE.
 // Currently we only support two types of input content type: application/json and application/octet-stream
+// A request with the Inference-Header-Content-Length header field has binary tensor data, whatever its content type.
 SupportedContentType GetRequestContentType(const HttpContext& context);
 
 // "Accept" header field in request is OPTIONAL.
 // Currently we only support three types of response content type: */*, application/json and application/octet-stream
+// A request with binary tensor data gets a response with binary tensor data unless it accepts a specific type.
 SupportedContentType GetResponseContentType(const HttpContext& context);
 
 }  // namespace server
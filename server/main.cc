@@ -3,6 +3,8 @@
 
 #include "environment.h"
 #include "http_server.h"
+#include "metrics_request_handler.h"
+#include "model_repository.h"
 #include "predict_request_handler.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
@@ -60,23 +62,64 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}, ", config.model_path);
-  logger->info("Model name: {}", config.model_name);
-  logger->info("Model version: {}", config.model_version);
-
-  try {
-    env->InitializeModel(config.model_path, config.model_name, config.model_version);
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+  if (config.model_repository.empty()) {
+    logger->info("Model path: {}, ", config.model_path);
+    logger->info("Model name: {}", config.model_name);
+    logger->info("Model version: {}", config.model_version);
+  } else {
+    logger->info("Model repository: {}", config.model_repository);
+  }
+
+  server::BatchingOptions batching_options{};
+  batching_options.max_batch_size = config.max_batch_size;
+  batching_options.max_queue_delay_us = config.max_queue_delay_us;
+  batching_options.max_queue_depth = config.max_queue_depth;
+  if (batching_options.max_batch_size > 1) {
+    logger->info("Batching: max batch size {}, max queue delay {}us, max queue depth {}",
+                 batching_options.max_batch_size, batching_options.max_queue_delay_us, batching_options.max_queue_depth);
+  }
+
+  if (config.response_cache_bytes > 0) {
+    server::ResponseCacheOptions response_cache_options{};
+    response_cache_options.capacity_bytes = config.response_cache_bytes;
+    response_cache_options.ttl_seconds = config.response_cache_ttl_seconds;
+    env->EnableResponseCache(response_cache_options);
+    logger->info("Response cache: {} bytes, ttl {}s", response_cache_options.capacity_bytes,
+                 response_cache_options.ttl_seconds);
+  }
+
+  server::WarmUpOptions warm_up_options{};
+  warm_up_options.num_runs = config.num_warmup_runs;
+  warm_up_options.request_path = config.warmup_request;
+
+  // The servers are started once the models are loaded and warmed up, so no request sees the cold start.
+  // declared before the servers so it stops polling after they are stopped
+  std::unique_ptr<server::ModelRepository> model_repository;
+  if (config.model_repository.empty()) {
+    try {
+      env->InitializeModel(config.model_path, config.model_name, config.model_version, batching_options,
+                           warm_up_options);
+      logger->debug("Initialize Model Successfully!");
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
+  } else {
+    model_repository = std::make_unique<server::ModelRepository>(env.get(), config.model_repository, batching_options,
+                                                                  warm_up_options);
+    model_repository->Scan();
+    if (model_repository->NumLoadedVersions() == 0) {
+      logger->critical("No model was loaded from the model repository {}", config.model_repository);
+      exit(EXIT_FAILURE);
+    }
+    model_repository->StartPolling(std::chrono::seconds(config.model_repository_poll_seconds));
   }
 
   //Setup GRPC Server
   auto const grpc_address = config.address;
   auto const grpc_port = config.grpc_port;
 
-  server::GRPCApp grpc_app{env, grpc_address, grpc_port};
+  server::GRPCApp grpc_app{env, grpc_address, grpc_port, config.num_grpc_stream_threads};
 
   logger->info("GRPC Listening at: {}:{}", grpc_address, grpc_port);
 
@@ -118,6 +161,12 @@ int main(int argc, char* argv[]) {
       }
   );
 
+  app.RegisterGet(
+      R"(/metrics()()())",
+      [&env](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::Metrics(context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
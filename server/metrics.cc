@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+constexpr std::array<double, 13> ServerMetrics::kLatencyBuckets;
+
+static void WriteLabelValue(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      out << '\\' << c;
+    } else if (c == '\n') {
+      out << "\\n";
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+static void WriteHeader(std::ostream& out, const char* name, const char* type, const char* help) {
+  out << "# HELP " << name << ' ' << help << '\n'
+      << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void ServerMetrics::WriteModelLabels(std::ostream& out, const std::string& model_name,
+                                     const std::string& model_version) {
+  out << "{model=";
+  WriteLabelValue(out, model_name);
+  out << ",version=";
+  WriteLabelValue(out, model_version);
+  out << '}';
+}
+
+void ServerMetrics::AddModel(const std::string& model_name, const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  models_[std::make_pair(model_name, model_version)];
+}
+
+void ServerMetrics::RecordRequest(const std::string& model_name, const std::string& model_version,
+                                  const std::string& code) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = models_.find(std::make_pair(model_name, model_version));
+  if (it == models_.end()) {
+    return;
+  }
+  ++it->second.requests;
+  if (!code.empty()) {
+    ++it->second.errors[code];
+  }
+}
+
+void ServerMetrics::RecordRunDuration(const std::string& model_name, const std::string& model_version,
+                                      double seconds) {
+  auto bucket = std::lower_bound(kLatencyBuckets.begin(), kLatencyBuckets.end(), seconds) - kLatencyBuckets.begin();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = models_.find(std::make_pair(model_name, model_version));
+  if (it == models_.end()) {
+    return;
+  }
+  ++it->second.latency_buckets[bucket];
+  it->second.latency_sum += seconds;
+  ++it->second.latency_count;
+}
+
+void ServerMetrics::Write(std::ostream& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  WriteHeader(out, "ort_server_requests_total", "counter", "Prediction requests received.");
+  for (const auto& model : models_) {
+    out << "ort_server_requests_total";
+    WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << model.second.requests << '\n';
+  }
+
+  WriteHeader(out, "ort_server_request_errors_total", "counter", "Prediction requests that failed, by error code.");
+  for (const auto& model : models_) {
+    for (const auto& error : model.second.errors) {
+      out << "ort_server_request_errors_total{model=";
+      WriteLabelValue(out, model.first.first);
+      out << ",version=";
+      WriteLabelValue(out, model.first.second);
+      out << ",code=";
+      WriteLabelValue(out, error.first);
+      out << "} " << error.second << '\n';
+    }
+  }
+
+  WriteHeader(out, "ort_server_run_duration_seconds", "histogram",
+              "Duration of the model runs, including the time spent in the batching queue.");
+  for (const auto& model : models_) {
+    const auto& metrics = model.second;
+    uint64_t cumulative_count = 0;
+    for (size_t i = 0; i <= kLatencyBuckets.size(); ++i) {
+      cumulative_count += metrics.latency_buckets[i];
+      out << "ort_server_run_duration_seconds_bucket{model=";
+      WriteLabelValue(out, model.first.first);
+      out << ",version=";
+      WriteLabelValue(out, model.first.second);
+      out << ",le=\"";
+      if (i < kLatencyBuckets.size()) {
+        out << kLatencyBuckets[i];
+      } else {
+        out << "+Inf";
+      }
+      out << "\"} " << cumulative_count << '\n';
+    }
+    out << "ort_server_run_duration_seconds_sum";
+    WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << metrics.latency_sum << '\n';
+    out << "ort_server_run_duration_seconds_count";
+    WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << metrics.latency_count << '\n';
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
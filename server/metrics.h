@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace onnxruntime {
+namespace server {
+
+// Per model request counts, error counts and Run latency, written in the Prometheus text exposition format.
+class ServerMetrics {
+ public:
+  // upper bounds of the Run latency histogram buckets, in seconds
+  static constexpr std::array<double, 13> kLatencyBuckets{
+      {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10}};
+
+  // Start reporting metrics for the model. Requests to models that weren't added are not recorded, so clients
+  // can't add labels for arbitrary model names.
+  void AddModel(const std::string& model_name, const std::string& model_version);
+
+  // Count a request to the model. code is the name of the error code of the response, empty if it succeeded.
+  void RecordRequest(const std::string& model_name, const std::string& model_version, const std::string& code);
+
+  // Record the duration of a Run, including the time spent in the batching queue.
+  void RecordRunDuration(const std::string& model_name, const std::string& model_version, double seconds);
+
+  // Write the metrics of all the models, each metric preceded by its HELP and TYPE lines.
+  void Write(std::ostream& out) const;
+
+  // Write a label set of the form {model="...",version="..."}, with the values escaped.
+  static void WriteModelLabels(std::ostream& out, const std::string& model_name, const std::string& model_version);
+
+ private:
+  struct ModelMetrics {
+    uint64_t requests = 0;
+    // keyed by error code name
+    std::map<std::string, uint64_t> errors;
+    // not cumulative. the last bucket holds the runs longer than the last bound.
+    std::array<uint64_t, kLatencyBuckets.size() + 1> latency_buckets{};
+    double latency_sum = 0;
+    uint64_t latency_count = 0;
+  };
+
+  mutable std::mutex mutex_;
+  // keyed by model name and version. protected by mutex_.
+  std::map<std::pair<std::string, std::string>, ModelMetrics> models_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
+#include <boost/filesystem.hpp>
+
+#include "model_repository.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace fs = boost::filesystem;
+
+constexpr const char* ModelRepository::kModelFileName;
+constexpr const char* ModelRepository::kJsonWarmUpFileName;
+constexpr const char* ModelRepository::kProtobufWarmUpFileName;
+
+static bool IsVersion(const std::string& name) {
+  return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+ModelRepository::ModelRepository(ServerEnvironment* env, std::string root, const BatchingOptions& batching_options,
+                                 const WarmUpOptions& warm_up_options)
+    : env_(env), root_(std::move(root)), batching_options_(batching_options), warm_up_options_(warm_up_options) {}
+
+ModelRepository::~ModelRepository() {
+  {
+    std::lock_guard<std::mutex> lock(poll_mutex_);
+    stop_polling_ = true;
+  }
+  poll_cv_.notify_all();
+  if (poll_thread_.joinable()) {
+    poll_thread_.join();
+  }
+}
+
+size_t ModelRepository::Scan() {
+  auto logger = env_->GetAppLogger();
+
+  // list the model files. a listing error leaves the loaded versions as they are.
+  std::map<ModelKey, std::pair<std::string, FileSignature>> found;
+  boost::system::error_code ec;
+  for (fs::directory_iterator model_dir(root_, ec), end; !ec && model_dir != end; model_dir.increment(ec)) {
+    if (!fs::is_directory(model_dir->status())) {
+      continue;
+    }
+
+    const auto model_name = model_dir->path().filename().string();
+    for (fs::directory_iterator version_dir(model_dir->path(), ec); !ec && version_dir != end; version_dir.increment(ec)) {
+      const auto version = version_dir->path().filename().string();
+      const auto model_file = version_dir->path() / kModelFileName;
+      if (!IsVersion(version) || !fs::is_regular_file(model_file, ec)) {
+        ec.clear();
+        continue;
+      }
+
+      auto write_time = fs::last_write_time(model_file, ec);
+      auto size = ec ? 0 : fs::file_size(model_file, ec);
+      if (ec) {
+        // e.g. removed while listing
+        ec.clear();
+        continue;
+      }
+      found.emplace(std::make_pair(model_name, version),
+                    std::make_pair(model_file.string(), std::make_pair(write_time, size)));
+    }
+  }
+  if (ec) {
+    logger->error("Failed to list the model repository {}: {}", root_, ec.message());
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(scan_mutex_);
+  size_t num_failures = 0;
+
+  // load the new and changed versions before unloading the removed ones, so a model that gets a new version
+  // keeps being served
+  for (const auto& model : found) {
+    const auto& key = model.first;
+    const auto& path = model.second.first;
+    const auto& signature = model.second.second;
+    auto attempted = attempted_.find(key);
+    if (attempted != attempted_.end() && attempted->second == signature) {
+      continue;
+    }
+
+    attempted_[key] = signature;
+    WarmUpOptions warm_up_options = warm_up_options_;
+    warm_up_options.request_path.clear();
+    const auto version_dir = fs::path(path).parent_path();
+    for (const auto* file_name : {kJsonWarmUpFileName, kProtobufWarmUpFileName}) {
+      boost::system::error_code warm_up_ec;
+      if (fs::is_regular_file(version_dir / file_name, warm_up_ec)) {
+        warm_up_options.request_path = (version_dir / file_name).string();
+        break;
+      }
+    }
+
+    try {
+      env_->LoadModel(path, key.first, key.second, batching_options_, warm_up_options);
+      loaded_[key] = signature;
+      logger->info("Loaded model {} version {} from {}", key.first, key.second, path);
+    } catch (const Ort::Exception& ex) {
+      ++num_failures;
+      logger->error("Failed to load model {} version {} from {}: {} ---- Error: [{}]", key.first, key.second, path,
+                    ex.GetOrtErrorCode(), ex.what());
+    }
+  }
+
+  for (auto it = loaded_.begin(); it != loaded_.end();) {
+    if (found.find(it->first) != found.end()) {
+      ++it;
+      continue;
+    }
+
+    try {
+      env_->UnloadModel(it->first.first, it->first.second);
+      logger->info("Unloaded model {} version {}", it->first.first, it->first.second);
+    } catch (const Ort::Exception& ex) {
+      logger->error("Failed to unload model {} version {}: {}", it->first.first, it->first.second, ex.what());
+    }
+    attempted_.erase(it->first);
+    it = loaded_.erase(it);
+  }
+
+  // forget the failed versions that were removed
+  for (auto it = attempted_.begin(); it != attempted_.end();) {
+    it = found.find(it->first) == found.end() ? attempted_.erase(it) : std::next(it);
+  }
+
+  return num_failures;
+}
+
+void ModelRepository::StartPolling(std::chrono::seconds interval) {
+  if (poll_thread_.joinable() || interval.count() <= 0) {
+    return;
+  }
+
+  poll_thread_ = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> lock(poll_mutex_);
+    while (!poll_cv_.wait_for(lock, interval, [this]() { return stop_polling_; })) {
+      lock.unlock();
+      Scan();
+      lock.lock();
+    }
+  });
+}
+
+size_t ModelRepository::NumLoadedVersions() const {
+  std::lock_guard<std::mutex> lock(scan_mutex_);
+  return loaded_.size();
+}
+
+}  // namespace server
+}  // namespace onnxruntime
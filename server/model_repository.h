@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "batching_scheduler.h"
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Serves the models of a directory laid out as <root>/<model name>/<version>/model.onnx, where version is a number.
+// A version is warmed up with the PredictRequest in warmup.json or warmup.pb next to its model.onnx, if there is one.
+//
+// Scan loads the versions that were added or whose model file changed, and unloads the versions that were removed.
+// A version is loaded and warmed up while the version it replaces keeps serving, see ServerEnvironment::LoadModel.
+// A model file that fails to load is retried once it changes.
+class ModelRepository {
+ public:
+  static constexpr const char* kModelFileName = "model.onnx";
+  static constexpr const char* kJsonWarmUpFileName = "warmup.json";
+  static constexpr const char* kProtobufWarmUpFileName = "warmup.pb";
+
+  // The request_path of warm_up_options is replaced by the warm-up file of each version
+  ModelRepository(ServerEnvironment* env, std::string root, const BatchingOptions& batching_options,
+                  const WarmUpOptions& warm_up_options = WarmUpOptions{});
+  // Stops polling
+  ~ModelRepository();
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Returns the number of versions that failed to load
+  size_t Scan();
+
+  // Scans the repository every interval on a background thread until the repository is destroyed
+  void StartPolling(std::chrono::seconds interval);
+
+  // Number of versions loaded from the repository
+  size_t NumLoadedVersions() const;
+
+ private:
+  // last write time and size of a model file
+  using FileSignature = std::pair<std::time_t, uintmax_t>;
+  using ModelKey = std::pair<std::string, std::string>;
+
+  ServerEnvironment* const env_;
+  const std::string root_;
+  const BatchingOptions batching_options_;
+  const WarmUpOptions warm_up_options_;
+
+  // held while scanning. protects loaded_ and attempted_.
+  mutable std::mutex scan_mutex_;
+  // versions loaded from the repository, by the signature of the file they were loaded from
+  std::map<ModelKey, FileSignature> loaded_;
+  // signature of the last file each version was loaded from, or failed to load from
+  std::map<ModelKey, FileSignature> attempted_;
+
+  std::mutex poll_mutex_;
+  std::condition_variable poll_cv_;
+  bool stop_polling_ = false;  // protected by poll_mutex_
+  std::thread poll_thread_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
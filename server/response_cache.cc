@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <iterator>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "metrics.h"
+#include "response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+
+std::string ResponseCache::GetKey(const PredictRequest& request) {
+  // the entries of the inputs map are serialized in the order of their names, so equal requests have equal keys
+  std::string key;
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.SetSerializationDeterministic(true);
+    request.SerializeToCodedStream(&coded_stream);
+  }
+  return key;
+}
+
+std::string ResponseCache::GetEntryKey(const LoadedModel* model, const std::string& key) {
+  std::string entry_key(sizeof(model), '\0');
+  std::memcpy(&entry_key[0], &model, sizeof(model));
+  return entry_key + key;
+}
+
+bool ResponseCache::Lookup(const LoadedModel* model, const std::string& model_name, const std::string& model_version,
+                           const std::string& key, PredictResponse& response,
+                           std::chrono::steady_clock::time_point now) {
+  auto entry_key = GetEntryKey(model, key);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& metrics = metrics_[std::make_pair(model_name, model_version)];
+  auto it = index_.find(entry_key);
+  if (it == index_.end()) {
+    ++metrics.misses;
+    return false;
+  }
+
+  auto entry = it->second;
+  if (options_.ttl_seconds > 0 && now - entry->insert_time >= std::chrono::seconds(options_.ttl_seconds)) {
+    EraseEntry(entry);
+    ++metrics.misses;
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  response = entry->response;
+  ++metrics.hits;
+  return true;
+}
+
+void ResponseCache::Insert(const LoadedModel* model, const std::string& key, const PredictResponse& response,
+                           std::chrono::steady_clock::time_point now) {
+  auto entry_key = GetEntryKey(model, key);
+  const size_t size_in_bytes = entry_key.size() + response.ByteSizeLong();
+  if (size_in_bytes > options_.capacity_bytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(entry_key);
+  if (it != index_.end()) {
+    // a concurrent request for the same inputs ran too
+    EraseEntry(it->second);
+  }
+
+  while (size_in_bytes_ + size_in_bytes > options_.capacity_bytes) {
+    EraseEntry(std::prev(entries_.end()));
+  }
+
+  // the keys of the nodes of index_ don't move, so the entry refers to its key instead of holding a copy
+  auto index_entry = index_.emplace(std::move(entry_key), entries_.end()).first;
+  entries_.push_front(Entry{model, &index_entry->first, response, size_in_bytes, now});
+  index_entry->second = entries_.begin();
+  size_in_bytes_ += size_in_bytes;
+}
+
+void ResponseCache::Erase(const LoadedModel* model) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    auto next = std::next(entry);
+    if (entry->model == model) {
+      EraseEntry(entry);
+    }
+    entry = next;
+  }
+}
+
+void ResponseCache::EraseEntry(EntryList::iterator entry) {
+  size_in_bytes_ -= entry->size_in_bytes;
+  auto entry_key = entry->entry_key;
+  entries_.erase(entry);
+  index_.erase(*entry_key);
+}
+
+size_t ResponseCache::GetSizeInBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_in_bytes_;
+}
+
+size_t ResponseCache::GetNumEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void ResponseCache::WriteMetrics(std::ostream& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  out << "# HELP ort_server_response_cache_hits_total Requests answered from the response cache.\n"
+      << "# TYPE ort_server_response_cache_hits_total counter\n";
+  for (const auto& model : metrics_) {
+    out << "ort_server_response_cache_hits_total";
+    ServerMetrics::WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << model.second.hits << '\n';
+  }
+  out << "# HELP ort_server_response_cache_misses_total Requests that were not in the response cache.\n"
+      << "# TYPE ort_server_response_cache_misses_total counter\n";
+  for (const auto& model : metrics_) {
+    out << "ort_server_response_cache_misses_total";
+    ServerMetrics::WriteModelLabels(out, model.first.first, model.first.second);
+    out << ' ' << model.second.misses << '\n';
+  }
+  out << "# HELP ort_server_response_cache_bytes Bytes of the requests and responses in the response cache.\n"
+      << "# TYPE ort_server_response_cache_bytes gauge\n"
+      << "ort_server_response_cache_bytes " << size_in_bytes_ << '\n';
+  out << "# HELP ort_server_response_cache_entries Responses in the response cache.\n"
+      << "# TYPE ort_server_response_cache_entries gauge\n"
+      << "ort_server_response_cache_entries " << entries_.size() << '\n';
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct LoadedModel;
+
+struct ResponseCacheOptions {
+  // bytes of the cached requests and responses. the cache is disabled if this is 0.
+  size_t capacity_bytes = 0;
+  // seconds a cached response is served for. 0 keeps the responses until they are evicted.
+  int ttl_seconds = 60;
+};
+
+struct ResponseCacheMetrics {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+// Least recently used cache of the responses of models whose outputs only depend on their inputs, so repeated
+// requests are answered without a Run.
+//
+// A response is keyed by the loaded model and by the deterministic serialization of the request, which is compared in
+// full so requests whose hashes collide don't share a response. The responses of a model are removed when it is
+// released, so a reloaded model doesn't serve the responses of the model it replaced. The size of an entry is the
+// size of its key plus the size of the serialized response. Responses larger than the capacity are not cached.
+class ResponseCache {
+ public:
+  explicit ResponseCache(const ResponseCacheOptions& options) : options_(options) {}
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Returns the key of the request for Lookup and Insert
+  static std::string GetKey(const PredictRequest& request);
+
+  // Copies the cached response of the request to response and returns true if there is one that hasn't expired.
+  // Counts a hit or a miss for the model name and version.
+  bool Lookup(const LoadedModel* model, const std::string& model_name, const std::string& model_version,
+              const std::string& key,
+              /* out */ PredictResponse& response,
+              std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  // Caches the response of the request, evicting the least recently used responses to make room for it
+  void Insert(const LoadedModel* model, const std::string& key, const PredictResponse& response,
+              std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  // Removes the responses of the model
+  void Erase(const LoadedModel* model);
+
+  size_t GetSizeInBytes() const;
+  size_t GetNumEntries() const;
+
+  // Write the hits and misses of the models and the size of the cache in the Prometheus text exposition format
+  void WriteMetrics(std::ostream& out) const;
+
+  const ResponseCacheOptions& GetOptions() const { return options_; }
+
+ private:
+  struct Entry {
+    const LoadedModel* model;
+    // the key of the entry in index_
+    const std::string* entry_key;
+    PredictResponse response;
+    size_t size_in_bytes;
+    std::chrono::steady_clock::time_point insert_time;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static std::string GetEntryKey(const LoadedModel* model, const std::string& key);
+
+  void EraseEntry(EntryList::iterator entry);
+
+  const ResponseCacheOptions options_;
+
+  mutable std::mutex mutex_;
+  // most recently used first. protected by mutex_.
+  EntryList entries_;
+  // keyed by the model and the key of the request. protected by mutex_.
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  // protected by mutex_
+  size_t size_in_bytes_ = 0;
+  // keyed by model name and version. protected by mutex_.
+  std::map<std::pair<std::string, std::string>, ResponseCacheMetrics> metrics_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
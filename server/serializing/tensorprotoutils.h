@@ -27,6 +27,13 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Create an Ort::Value that uses the raw_data of the TensorProto as its buffer, without a copy.
+ * The TensorProto must outlive the value and must not be modified while it's in use.
+ * Returns false if the data can't be used in place (no raw_data, big endian host, unaligned data or a size mismatch).
+ */
+bool TryCreateMLValueOverRawData(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info, /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
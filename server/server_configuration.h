@@ -7,6 +7,7 @@
 #include <fstream>
 #include <unordered_map>
 
+#include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "onnxruntime_cxx_api.h"
 
@@ -41,22 +42,42 @@ class ServerConfiguration {
   std::string model_path;
   std::string model_name = "default";
   std::string model_version = "1";
+  std::string model_repository;
+  int model_repository_poll_seconds = 30;
+  int num_warmup_runs = 2;
+  std::string warmup_request;
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
+  int num_grpc_stream_threads = 2;
   int num_http_threads = std::thread::hardware_concurrency();
   OrtLoggingLevel logging_level{};
+  int max_batch_size = 0;
+  int max_queue_delay_us = 1000;
+  int max_queue_depth = 64;
+  size_t response_cache_bytes = 0;
+  int response_cache_ttl_seconds = 60;
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model. Required unless model_repository is given");
     desc.add_options()("model_name", po::value(&model_name)->default_value(model_name), "ONNX model name");
     desc.add_options()("model_version", po::value(&model_version)->default_value(model_version), "ONNX model version");
+    desc.add_options()("model_repository", po::value(&model_repository), "Directory of models laid out as <model name>/<version>/model.onnx, served instead of model_path");
+    desc.add_options()("model_repository_poll_seconds", po::value(&model_repository_poll_seconds)->default_value(model_repository_poll_seconds), "Seconds between the scans of model_repository for new, changed and removed versions. 0 disables the scans after startup");
+    desc.add_options()("num_warmup_runs", po::value(&num_warmup_runs)->default_value(num_warmup_runs), "Runs of a model before it serves requests. 0 disables the warm-up");
+    desc.add_options()("warmup_request", po::value(&warmup_request), "PredictRequest file (.json for JSON, binary protobuf otherwise) to warm up model_path with. Zero filled inputs are generated if not given");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("num_grpc_stream_threads", po::value(&num_grpc_stream_threads)->default_value(num_grpc_stream_threads), "Number of threads serving the GRPC completion queue of the streaming predictions");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum batch size of a fused run of concurrent requests. 0 or 1 disables batching");
+    desc.add_options()("max_queue_delay_us", po::value(&max_queue_delay_us)->default_value(max_queue_delay_us), "Microseconds a request waits for other requests to batch with");
+    desc.add_options()("max_queue_depth", po::value(&max_queue_depth)->default_value(max_queue_depth), "Maximum number of requests waiting to be batched or running per model before requests are rejected");
+    desc.add_options()("response_cache_bytes", po::value(&response_cache_bytes)->default_value(response_cache_bytes), "Bytes of the cache of the responses to repeated requests, for models whose outputs only depend on their inputs. 0 disables the cache");
+    desc.add_options()("response_cache_ttl_seconds", po::value(&response_cache_ttl_seconds)->default_value(response_cache_ttl_seconds), "Seconds a cached response is served for. 0 keeps the responses until they are evicted");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -103,6 +124,36 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
+    } else if (num_grpc_stream_threads <= 0) {
+      PrintHelp(std::cerr, "num_grpc_stream_threads must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_batch_size < 0) {
+      PrintHelp(std::cerr, "max_batch_size must not be negative");
+      return Result::ExitFailure;
+    } else if (max_queue_delay_us < 0) {
+      PrintHelp(std::cerr, "max_queue_delay_us must not be negative");
+      return Result::ExitFailure;
+    } else if (max_queue_depth <= 0) {
+      PrintHelp(std::cerr, "max_queue_depth must be greater than 0");
+      return Result::ExitFailure;
+    } else if (response_cache_ttl_seconds < 0) {
+      PrintHelp(std::cerr, "response_cache_ttl_seconds must not be negative");
+      return Result::ExitFailure;
+    } else if (num_warmup_runs < 0) {
+      PrintHelp(std::cerr, "num_warmup_runs must not be negative");
+      return Result::ExitFailure;
+    } else if (!warmup_request.empty() && !file_exists(warmup_request)) {
+      PrintHelp(std::cerr, "warmup_request must be the location of a valid file");
+      return Result::ExitFailure;
+    } else if (model_repository_poll_seconds < 0) {
+      PrintHelp(std::cerr, "model_repository_poll_seconds must not be negative");
+      return Result::ExitFailure;
+    } else if (!model_repository.empty()) {
+      if (!boost::filesystem::is_directory(model_repository)) {
+        PrintHelp(std::cerr, "model_repository must be the location of a directory");
+        return Result::ExitFailure;
+      }
+      return Result::ContinueSuccess;
     } else if (!file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
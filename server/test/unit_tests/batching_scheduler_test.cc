@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "batching_scheduler.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+namespace {
+Ort::Value CreateFloatValue(const std::vector<int64_t>& dims, const std::vector<float>& data) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto value = Ort::Value::CreateTensor<float>(allocator, dims.data(), dims.size());
+  std::copy(data.cbegin(), data.cend(), value.GetTensorMutableData<float>());
+  return value;
+}
+
+// doubles the first input
+BatchingScheduler::RunFunction CreateRunFunction(std::atomic<int>& num_runs) {
+  return [&num_runs](const Ort::RunOptions&, const std::vector<std::string>&,
+                     const std::vector<Ort::Value>& input_values, const std::vector<std::string>&) {
+    ++num_runs;
+    auto& input = const_cast<Ort::Value&>(input_values[0]);
+    auto info = input.GetTensorTypeAndShapeInfo();
+    auto shape = info.GetShape();
+    const auto* data = input.GetTensorMutableData<float>();
+    std::vector<float> output(data, data + info.GetElementCount());
+    for (auto& v : output) v *= 2;
+    std::vector<Ort::Value> outputs;
+    outputs.push_back(CreateFloatValue(shape, output));
+    return outputs;
+  };
+}
+
+// counters of a session that batched 4 requests into 1 run and ran 2 requests directly
+BatchingScheduler::StatsFunction CreateStatsFunction() {
+  return [](uint64_t& requests, uint64_t& batches, uint64_t& unbatched_requests) {
+    requests = 4;
+    batches = 1;
+    unbatched_requests = 2;
+  };
+}
+}  // namespace
+
+TEST(BatchingSchedulerTest, RequestsRunWithTheirOwnRunOptions) {
+  std::atomic<int> num_runs{0};
+  auto run_fn = CreateRunFunction(num_runs);
+  std::vector<std::string> run_tags;
+  BatchingOptions options;
+  options.max_batch_size = 8;
+  BatchingScheduler scheduler(
+      [&run_fn, &run_tags](const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                           const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+        run_tags.push_back(run_options.GetRunTag());
+        return run_fn(run_options, input_names, input_values, output_names);
+      },
+      CreateStatsFunction(), options);
+  auto logger = ServerEnv()->GetLogger("BatchingSchedulerTest");
+
+  for (int i = 0; i < 2; ++i) {
+    Ort::RunOptions run_options;
+    run_options.SetRunTag(("request" + std::to_string(i)).c_str());
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(CreateFloatValue({1, 2}, {float(i), float(i + 1)}));
+    std::vector<Ort::Value> outputs;
+    ASSERT_TRUE(scheduler.Run(run_options, {"X"}, inputs, {"Y"}, logger, outputs).ok());
+    ASSERT_EQ(outputs.size(), 1u);
+    EXPECT_EQ(outputs[0].GetTensorMutableData<float>()[1], float((i + 1) * 2));
+  }
+
+  EXPECT_EQ(num_runs, 2);
+  EXPECT_EQ(run_tags, std::vector<std::string>({"request0", "request1"}));
+
+  // the batching counters are the ones of the session
+  auto metrics = scheduler.GetMetrics();
+  EXPECT_EQ(metrics.requests, 4u);
+  EXPECT_EQ(metrics.batches, 1u);
+  EXPECT_EQ(metrics.unbatched_requests, 2u);
+  EXPECT_EQ(metrics.rejected_requests, 0u);
+}
+
+TEST(BatchingSchedulerTest, FailedRunReturnsError) {
+  BatchingOptions options;
+  options.max_batch_size = 8;
+  BatchingScheduler scheduler(
+      [](const Ort::RunOptions&, const std::vector<std::string>&, const std::vector<Ort::Value>&,
+         const std::vector<std::string>&) -> std::vector<Ort::Value> {
+        throw Ort::Exception("invalid input", ORT_INVALID_ARGUMENT);
+      },
+      CreateStatsFunction(), options);
+  auto logger = ServerEnv()->GetLogger("BatchingSchedulerTest");
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatValue({1, 1}, {1.f}));
+  std::vector<Ort::Value> outputs;
+  auto status = scheduler.Run(Ort::RunOptions{}, {"X"}, inputs, {"Y"}, logger, outputs);
+  EXPECT_EQ(status.error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+
+  EXPECT_EQ(scheduler.GetMetrics().rejected_requests, 0u);
+}
+
+TEST(BatchingSchedulerTest, FullQueueRejectsRequests) {
+  std::atomic<int> num_runs{0};
+  auto run_fn = CreateRunFunction(num_runs);
+  std::atomic<bool> running{false};
+  std::atomic<bool> release{false};
+  BatchingOptions options;
+  options.max_batch_size = 8;
+  options.max_queue_depth = 1;
+  // the first request waits in the session, like a request waiting for its batch to fill
+  BatchingScheduler scheduler(
+      [&](const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+          const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+        running = true;
+        while (!release) {
+          std::this_thread::yield();
+        }
+        return run_fn(run_options, input_names, input_values, output_names);
+      },
+      CreateStatsFunction(), options);
+  auto logger = ServerEnv()->GetLogger("BatchingSchedulerTest");
+
+  std::vector<Ort::Value> outputs;
+  std::thread leader([&]() {
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(CreateFloatValue({1, 1}, {1.f}));
+    EXPECT_TRUE(scheduler.Run(Ort::RunOptions{}, {"X"}, inputs, {"Y"}, logger, outputs).ok());
+  });
+
+  while (!running) {
+    std::this_thread::yield();
+  }
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatValue({1, 1}, {2.f}));
+  std::vector<Ort::Value> rejected_outputs;
+  auto status = scheduler.Run(Ort::RunOptions{}, {"X"}, inputs, {"Y"}, logger, rejected_outputs);
+  EXPECT_EQ(status.error_code(), protobufutil::error::Code::RESOURCE_EXHAUSTED);
+
+  release = true;
+  leader.join();
+  EXPECT_EQ(num_runs, 1);
+  EXPECT_EQ(scheduler.GetMetrics().rejected_requests, 1u);
+
+  // the queue has room again once the first request completed
+  std::vector<Ort::Value> more_outputs;
+  EXPECT_TRUE(scheduler.Run(Ort::RunOptions{}, {"X"}, inputs, {"Y"}, logger, more_outputs).ok());
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
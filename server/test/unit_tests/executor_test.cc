@@ -52,6 +52,31 @@ TEST_F(ExecutorTest, TestMul_1) {
   EXPECT_EQ(expected, body);
 }
 
+TEST_F(ExecutorTest, TestMul_1_RawData) {
+  // [1, 2, 3, 4, 5, 6] as little endian floats
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"rawData":"AACAPwAAAEAAAEBAAACAQAAAoEAAAMBA"}},"outputFilter":["Y"]})";
+  const std::vector<float> expected{1, 4, 9, 16, 25, 36};
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  onnxruntime::server::PredictResponse response{};
+
+  auto protostatus = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_TRUE(protostatus.ok());
+
+  auto prediction_res = executor.Predict("Name", "version", request, response);
+  EXPECT_TRUE(prediction_res.ok());
+
+  const auto& output = response.outputs().at("Y");
+  ASSERT_EQ(output.dims_size(), 2);
+  EXPECT_EQ(output.dims(0), 3);
+  EXPECT_EQ(output.dims(1), 2);
+  ASSERT_EQ(output.raw_data().size(), expected.size() * sizeof(float));
+  EXPECT_EQ(memcmp(output.raw_data().data(), expected.data(), output.raw_data().size()), 0);
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
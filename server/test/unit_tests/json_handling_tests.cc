@@ -68,6 +68,57 @@ TEST(JsonSerializationTests, HappyPath) {
   EXPECT_EQ(expected_json_string, json_string);
 }
 
+TEST(JsonWithBinaryDataTests, Request) {
+  std::string header = R"({"inputs":{"x":{"dims":["2"],"dataType":1,"dataLocation":"EXTERNAL",)"
+                       R"("externalData":[{"key":"offset","value":"4"},{"key":"length","value":"8"}]},)"
+                       R"("y":{"dims":["1"],"dataType":6,"int32Data":[7]}}})";
+  const float x[] = {1.f, 2.f};
+  std::string body = header + std::string(4, '\0') + std::string(reinterpret_cast<const char*>(x), sizeof(x));
+
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = GetRequestFromJsonWithBinaryData(body, header.size(), request);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code()) << status.error_message();
+
+  const auto& x_tensor = request.inputs().at("x");
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(x), sizeof(x)), x_tensor.raw_data());
+  EXPECT_EQ(0, x_tensor.external_data_size());
+  EXPECT_FALSE(x_tensor.has_data_location());
+  EXPECT_EQ(7, request.inputs().at("y").int32_data(0));
+}
+
+TEST(JsonWithBinaryDataTests, RequestOutOfBody) {
+  std::string header = R"({"inputs":{"x":{"dims":["2"],"dataType":1,"dataLocation":"EXTERNAL",)"
+                       R"("externalData":[{"key":"offset","value":"4"},{"key":"length","value":"8"}]}}})";
+  std::string body = header + std::string(8, '\0');
+
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = GetRequestFromJsonWithBinaryData(body, header.size(), request);
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+
+  status = GetRequestFromJsonWithBinaryData(body, body.size() + 1, request);
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+}
+
+TEST(JsonWithBinaryDataTests, Response) {
+  onnxruntime::server::PredictResponse response;
+  auto& tensor = (*response.mutable_outputs())["out"];
+  tensor.add_dims(2);
+  tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  const float out[] = {3.f, 4.f};
+  const std::string raw_data(reinterpret_cast<const char*>(out), sizeof(out));
+  tensor.set_raw_data(raw_data);
+
+  std::string body;
+  size_t header_length = 0;
+  protobufutil::Status status = GenerateResponseInJsonWithBinaryData(response, body, header_length);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code()) << status.error_message();
+
+  EXPECT_EQ(R"({"outputs":{"out":{"dims":["2"],"dataType":1,"externalData":[{"key":"offset","value":"0"},)"
+            R"({"key":"length","value":"8"}],"dataLocation":"EXTERNAL"}}})",
+            body.substr(0, header_length));
+  EXPECT_EQ(raw_data, body.substr(header_length));
+}
+
 TEST(StringEscapingTests, SimpleString) {
   std::string unescaped = "This is an error message \" \n ";
   EXPECT_EQ("This is an error message \\\" \\n ", escape_string(unescaped));
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static bool Contains(const std::string& text, const std::string& line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+TEST(ServerMetricsTests, WritesRequestsErrorsAndLatency) {
+  ServerMetrics metrics;
+  metrics.AddModel("mnist", "1");
+
+  metrics.RecordRequest("mnist", "1", "");
+  metrics.RecordRequest("mnist", "1", "INVALID_ARGUMENT");
+  metrics.RecordRequest("mnist", "1", "INVALID_ARGUMENT");
+  metrics.RecordRunDuration("mnist", "1", 0.002);
+  metrics.RecordRunDuration("mnist", "1", 0.02);
+  metrics.RecordRunDuration("mnist", "1", 20);
+
+  std::ostringstream out;
+  metrics.Write(out);
+  auto text = out.str();
+
+  EXPECT_TRUE(Contains(text, "# TYPE ort_server_requests_total counter"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_requests_total{model="mnist",version="1"} 3)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_request_errors_total{model="mnist",version="1",code="INVALID_ARGUMENT"} 2)"));
+  EXPECT_TRUE(Contains(text, "# TYPE ort_server_run_duration_seconds histogram"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_bucket{model="mnist",version="1",le="0.001"} 0)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_bucket{model="mnist",version="1",le="0.0025"} 1)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_bucket{model="mnist",version="1",le="0.025"} 2)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_bucket{model="mnist",version="1",le="10"} 2)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_bucket{model="mnist",version="1",le="+Inf"} 3)"));
+  EXPECT_TRUE(Contains(text, R"(ort_server_run_duration_seconds_count{model="mnist",version="1"} 3)"));
+}
+
+TEST(ServerMetricsTests, IgnoresModelsNotAdded) {
+  ServerMetrics metrics;
+  metrics.RecordRequest("unknown", "1", "INVALID_ARGUMENT");
+  metrics.RecordRunDuration("unknown", "1", 0.1);
+
+  std::ostringstream out;
+  metrics.Write(out);
+  EXPECT_EQ(out.str().find("unknown"), std::string::npos);
+}
+
+TEST(ServerMetricsTests, EscapesLabelValues) {
+  ServerMetrics metrics;
+  metrics.AddModel("a\"b\\c", "1");
+  metrics.RecordRequest("a\"b\\c", "1", "");
+
+  std::ostringstream out;
+  metrics.Write(out);
+  EXPECT_TRUE(Contains(out.str(), R"(ort_server_requests_total{model="a\"b\\c",version="1"} 1)"));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
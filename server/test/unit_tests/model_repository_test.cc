@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "executor.h"
+#include "http/json_handling.h"
+#include "model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace fs = boost::filesystem;
+
+const static auto model_file = "testdata/mul_1.onnx";
+const static auto mul_request_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+
+static google::protobuf::util::Status PredictMul(ServerEnvironment* env, const std::string& model_name,
+                                                 const std::string& model_version) {
+  PredictRequest request{};
+  PredictResponse response{};
+  auto status = GetRequestFromJson(mul_request_json, request);
+  if (!status.ok()) {
+    return status;
+  }
+
+  Executor executor(env, "RequestId");
+  return executor.Predict(model_name, model_version, request, response);
+}
+
+class ModelRepositoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = fs::temp_directory_path() / fs::unique_path("ort_server_model_repository_%%%%-%%%%");
+    fs::create_directories(root_);
+  }
+
+  void TearDown() override {
+    fs::remove_all(root_);
+    if (repository_ != nullptr) {
+      // unloads the remaining versions
+      repository_->Scan();
+    }
+  }
+
+  ModelRepository& Repository() {
+    if (repository_ == nullptr) {
+      repository_ = std::make_unique<ModelRepository>(ServerEnv(), root_.string(), BatchingOptions{});
+    }
+    return *repository_;
+  }
+
+  void AddVersion(const std::string& model_name, const std::string& version) {
+    auto dir = root_ / model_name / version;
+    fs::create_directories(dir);
+    fs::copy_file(model_file, dir / ModelRepository::kModelFileName, fs::copy_option::overwrite_if_exists);
+  }
+
+  fs::path root_;
+  std::unique_ptr<ModelRepository> repository_;
+};
+
+TEST_F(ModelRepositoryTest, LoadsAndUnloadsVersions) {
+  auto* env = ServerEnv();
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 0u);
+
+  AddVersion("repository_mul", "1");
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 1u);
+  EXPECT_EQ(env->GetLatestVersion("repository_mul"), "1");
+  EXPECT_TRUE(PredictMul(env, "repository_mul", "1").ok());
+
+  AddVersion("repository_mul", "10");
+  AddVersion("repository_mul", "2");
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 3u);
+  EXPECT_EQ(env->GetLatestVersion("repository_mul"), "10");
+
+  // a request that holds the version keeps it alive after it is unloaded
+  auto held = env->GetModel("repository_mul", "1");
+  fs::remove_all(root_ / "repository_mul" / "1");
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 2u);
+  EXPECT_THROW(env->GetModel("repository_mul", "1"), Ort::Exception);
+  EXPECT_FALSE(PredictMul(env, "repository_mul", "1").ok());
+  EXPECT_EQ(held->output_names, std::vector<std::string>{"Y"});
+}
+
+TEST_F(ModelRepositoryTest, IgnoresInvalidLayout) {
+  fs::create_directories(root_ / "repository_mul" / "latest");
+  fs::copy_file(model_file, root_ / "repository_mul" / "latest" / ModelRepository::kModelFileName);
+  fs::create_directories(root_ / "repository_mul" / "1");
+  fs::copy_file(model_file, root_ / "repository_mul" / "1" / "other.onnx");
+
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 0u);
+}
+
+TEST_F(ModelRepositoryTest, InvalidModelIsNotRetriedUntilItChanges) {
+  auto dir = root_ / "repository_bad" / "1";
+  fs::create_directories(dir);
+  fs::ofstream(dir / ModelRepository::kModelFileName) << "not a model";
+
+  EXPECT_EQ(Repository().Scan(), 1u);
+  EXPECT_EQ(Repository().Scan(), 0u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 0u);
+  EXPECT_EQ(ServerEnv()->GetLatestVersion("repository_bad"), "");
+}
+
+TEST_F(ModelRepositoryTest, WarmsUpWithTheRequestOfTheVersion) {
+  AddVersion("repository_warm_mul", "1");
+  AddVersion("repository_warm_mul", "2");
+  fs::ofstream(root_ / "repository_warm_mul" / "1" / ModelRepository::kJsonWarmUpFileName) << mul_request_json;
+  // the warm-up request of version 2 doesn't match the model, so version 2 isn't loaded
+  fs::ofstream(root_ / "repository_warm_mul" / "2" / ModelRepository::kJsonWarmUpFileName)
+      << R"({"inputs":{"Z":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}}})";
+
+  EXPECT_EQ(Repository().Scan(), 1u);
+  EXPECT_EQ(Repository().NumLoadedVersions(), 1u);
+  EXPECT_EQ(ServerEnv()->GetLatestVersion("repository_warm_mul"), "1");
+}
+
+TEST(ServerEnvironmentTest, InvalidWarmUpRequest) {
+  auto* env = ServerEnv();
+  WarmUpOptions warm_up_options{};
+  warm_up_options.request_path = "does/not/exist.json";
+  EXPECT_THROW(env->LoadModel(model_file, "warm_up_mul", "1", BatchingOptions{}, warm_up_options), Ort::Exception);
+  EXPECT_THROW(env->GetModel("warm_up_mul", "1"), Ort::Exception);
+
+  // without warm-up and with generated inputs
+  warm_up_options.request_path.clear();
+  warm_up_options.num_runs = 0;
+  env->InitializeModel(model_file, "warm_up_mul", "1", BatchingOptions{}, warm_up_options);
+  warm_up_options.num_runs = 3;
+  env->LoadModel(model_file, "warm_up_mul", "1", BatchingOptions{}, warm_up_options);
+  EXPECT_TRUE(PredictMul(env, "warm_up_mul", "1").ok());
+  env->UnloadModel("warm_up_mul", "1");
+}
+
+TEST(ServerEnvironmentTest, LoadModelReplacesLoadedVersion) {
+  auto* env = ServerEnv();
+  env->LoadModel(model_file, "reloaded_mul", "1");
+  auto previous = env->GetModel("reloaded_mul", "1");
+
+  env->LoadModel(model_file, "reloaded_mul", "1");
+  auto current = env->GetModel("reloaded_mul", "1");
+  EXPECT_NE(previous, current);
+  EXPECT_TRUE(PredictMul(env, "reloaded_mul", "1").ok());
+
+  // the replaced version is still usable by the requests that hold it
+  std::vector<Ort::Value> outputs;
+  std::vector<float> input{1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> shape{3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(Ort::Value::CreateTensor<float>(memory_info, input.data(), input.size(), shape.data(), shape.size()));
+  outputs = Run(previous->session, Ort::RunOptions{}, {"X"}, inputs, {"Y"});
+  ASSERT_EQ(outputs.size(), 1u);
+  EXPECT_FLOAT_EQ(outputs[0].GetTensorMutableData<float>()[5], 36.f);
+
+  env->UnloadModel("reloaded_mul", "1");
+  EXPECT_THROW(env->UnloadModel("reloaded_mul", "1"), Ort::Exception);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -38,7 +38,7 @@ class PredictionServiceImplTest : public ::testing::Test {
     const static auto model_file = "testdata/mul_1.onnx";
 
     onnxruntime::server::ServerEnvironment* env = onnxruntime::server::test::ServerEnv();
-    // Implementation detail - currently predict is hardcoded to model "default" version 1.
+    // Calls without model-name and model-version metadata go to the latest version of model "default".
     env->InitializeModel(model_file, "default", "1");
   }
   void TearDown() override {
@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace {
+
+PredictRequest CreateRequest(const std::vector<std::pair<std::string, float>>& inputs) {
+  PredictRequest request;
+  for (const auto& input : inputs) {
+    auto& tensor = (*request.mutable_inputs())[input.first];
+    tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+    tensor.add_dims(1);
+    tensor.add_float_data(input.second);
+  }
+  return request;
+}
+
+PredictResponse CreateResponse(float value, int size = 1) {
+  PredictResponse response;
+  auto& tensor = (*response.mutable_outputs())["Y"];
+  tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  tensor.add_dims(size);
+  for (int i = 0; i < size; ++i) {
+    tensor.add_float_data(value);
+  }
+  return response;
+}
+
+float GetOutput(const PredictResponse& response) {
+  return response.outputs().at("Y").float_data(0);
+}
+
+// the cache only compares the addresses of the models
+const LoadedModel* GetModel(const int& id) {
+  return reinterpret_cast<const LoadedModel*>(&id);
+}
+
+}  // namespace
+
+TEST(ResponseCacheTests, ReturnsTheResponseOfTheSameRequest) {
+  ResponseCacheOptions options;
+  options.capacity_bytes = 1 << 20;
+  ResponseCache cache(options);
+  const int model = 0;
+
+  auto key = ResponseCache::GetKey(CreateRequest({{"X", 1.0f}}));
+  PredictResponse response;
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", key, response));
+
+  cache.Insert(GetModel(model), key, CreateResponse(2.0f));
+  ASSERT_TRUE(cache.Lookup(GetModel(model), "mnist", "1", key, response));
+  EXPECT_EQ(GetOutput(response), 2.0f);
+
+  // other inputs, output filter or model
+  PredictResponse other;
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", ResponseCache::GetKey(CreateRequest({{"X", 3.0f}})), other));
+  auto filtered_request = CreateRequest({{"X", 1.0f}});
+  filtered_request.add_output_filter("Y");
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", ResponseCache::GetKey(filtered_request), other));
+  const int other_model = 0;
+  EXPECT_FALSE(cache.Lookup(GetModel(other_model), "mnist", "2", key, other));
+}
+
+TEST(ResponseCacheTests, KeyDoesNotDependOnTheOrderOfTheInputs) {
+  auto request = CreateRequest({{"A", 1.0f}, {"B", 2.0f}, {"C", 3.0f}});
+  auto reordered_request = CreateRequest({{"C", 3.0f}, {"A", 1.0f}, {"B", 2.0f}});
+  EXPECT_EQ(ResponseCache::GetKey(request), ResponseCache::GetKey(reordered_request));
+}
+
+TEST(ResponseCacheTests, EvictsTheLeastRecentlyUsedResponses) {
+  const int model = 0;
+  auto key_1 = ResponseCache::GetKey(CreateRequest({{"X", 1.0f}}));
+  auto key_2 = ResponseCache::GetKey(CreateRequest({{"X", 2.0f}}));
+  auto key_3 = ResponseCache::GetKey(CreateRequest({{"X", 3.0f}}));
+
+  // room for two responses
+  ResponseCacheOptions options;
+  options.capacity_bytes = 2 * (sizeof(const LoadedModel*) + key_1.size() + CreateResponse(1.0f).ByteSizeLong());
+  ResponseCache cache(options);
+
+  cache.Insert(GetModel(model), key_1, CreateResponse(1.0f));
+  cache.Insert(GetModel(model), key_2, CreateResponse(2.0f));
+  EXPECT_EQ(cache.GetNumEntries(), 2u);
+  EXPECT_EQ(cache.GetSizeInBytes(), options.capacity_bytes);
+
+  PredictResponse response;
+  EXPECT_TRUE(cache.Lookup(GetModel(model), "mnist", "1", key_1, response));
+  cache.Insert(GetModel(model), key_3, CreateResponse(3.0f));
+  EXPECT_EQ(cache.GetNumEntries(), 2u);
+  EXPECT_TRUE(cache.Lookup(GetModel(model), "mnist", "1", key_1, response));
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", key_2, response));
+  EXPECT_TRUE(cache.Lookup(GetModel(model), "mnist", "1", key_3, response));
+
+  // larger than the whole cache
+  cache.Insert(GetModel(model), key_2, CreateResponse(2.0f, 1000));
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", key_2, response));
+  EXPECT_EQ(cache.GetNumEntries(), 2u);
+}
+
+TEST(ResponseCacheTests, ExpiresTheResponsesAfterTheTtl) {
+  ResponseCacheOptions options;
+  options.capacity_bytes = 1 << 20;
+  options.ttl_seconds = 10;
+  ResponseCache cache(options);
+  const int model = 0;
+
+  auto key = ResponseCache::GetKey(CreateRequest({{"X", 1.0f}}));
+  const auto start = std::chrono::steady_clock::now();
+  cache.Insert(GetModel(model), key, CreateResponse(2.0f), start);
+
+  PredictResponse response;
+  EXPECT_TRUE(cache.Lookup(GetModel(model), "mnist", "1", key, response, start + std::chrono::seconds(9)));
+  EXPECT_FALSE(cache.Lookup(GetModel(model), "mnist", "1", key, response, start + std::chrono::seconds(10)));
+  EXPECT_EQ(cache.GetNumEntries(), 0u);
+  EXPECT_EQ(cache.GetSizeInBytes(), 0u);
+}
+
+TEST(ResponseCacheTests, EraseRemovesTheResponsesOfTheModel) {
+  ResponseCacheOptions options;
+  options.capacity_bytes = 1 << 20;
+  ResponseCache cache(options);
+  const int model_1 = 0;
+  const int model_2 = 0;
+
+  auto key = ResponseCache::GetKey(CreateRequest({{"X", 1.0f}}));
+  cache.Insert(GetModel(model_1), key, CreateResponse(1.0f));
+  cache.Insert(GetModel(model_2), key, CreateResponse(2.0f));
+
+  cache.Erase(GetModel(model_1));
+  PredictResponse response;
+  EXPECT_FALSE(cache.Lookup(GetModel(model_1), "mnist", "1", key, response));
+  ASSERT_TRUE(cache.Lookup(GetModel(model_2), "mnist", "2", key, response));
+  EXPECT_EQ(GetOutput(response), 2.0f);
+  EXPECT_EQ(cache.GetNumEntries(), 1u);
+}
+
+TEST(ResponseCacheTests, WritesHitsAndMisses) {
+  ResponseCacheOptions options;
+  options.capacity_bytes = 1 << 20;
+  ResponseCache cache(options);
+  const int model = 0;
+
+  auto key = ResponseCache::GetKey(CreateRequest({{"X", 1.0f}}));
+  PredictResponse response;
+  cache.Lookup(GetModel(model), "mnist", "1", key, response);
+  cache.Insert(GetModel(model), key, CreateResponse(2.0f));
+  cache.Lookup(GetModel(model), "mnist", "1", key, response);
+  cache.Lookup(GetModel(model), "mnist", "1", key, response);
+
+  std::ostringstream out;
+  cache.WriteMetrics(out);
+  auto text = out.str();
+  EXPECT_NE(text.find("# TYPE ort_server_response_cache_hits_total counter\n"), std::string::npos);
+  EXPECT_NE(text.find(R"(ort_server_response_cache_hits_total{model="mnist",version="1"} 2)" "\n"), std::string::npos);
+  EXPECT_NE(text.find(R"(ort_server_response_cache_misses_total{model="mnist",version="1"} 1)" "\n"), std::string::npos);
+  EXPECT_NE(text.find("ort_server_response_cache_entries 1\n"), std::string::npos);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -48,6 +48,9 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.address, "0.0.0.0");
   EXPECT_EQ(config.http_port, 8001);
   EXPECT_EQ(config.num_http_threads, 3);
+  EXPECT_EQ(config.num_grpc_stream_threads, 2);
+  EXPECT_EQ(config.num_warmup_runs, 2);
+  EXPECT_TRUE(config.warmup_request.empty());
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
@@ -84,6 +87,30 @@ TEST(ConfigParsingTests, ModelNotFound) {
   EXPECT_EQ(res, Result::ExitFailure);
 }
 
+TEST(ConfigParsingTests, ModelRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_repository"), const_cast<char*>("testdata"),
+      const_cast<char*>("--model_repository_poll_seconds"), const_cast<char*>("5")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.model_repository, "testdata");
+  EXPECT_EQ(config.model_repository_poll_seconds, 5);
+  EXPECT_TRUE(config.model_path.empty());
+}
+
+TEST(ConfigParsingTests, ModelRepositoryNotFound) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_repository"), const_cast<char*>("does/not/exist")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(3, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, WrongLoggingLevel) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
@@ -98,6 +125,33 @@ TEST(ConfigParsingTests, WrongLoggingLevel) {
   EXPECT_EQ(res, Result::ExitFailure);
 }
 
+TEST(ConfigParsingTests, BatchingArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("16"),
+      const_cast<char*>("--max_queue_delay_us"), const_cast<char*>("500"),
+      const_cast<char*>("--max_queue_depth"), const_cast<char*>("32")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(9, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 16);
+  EXPECT_EQ(config.max_queue_delay_us, 500);
+  EXPECT_EQ(config.max_queue_depth, 32);
+}
+
+TEST(ConfigParsingTests, WrongQueueDepth) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_queue_depth"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
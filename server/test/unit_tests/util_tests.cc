@@ -107,6 +107,21 @@ TEST(ResponseContentTypeTests, ContentTypeUnknown) {
   EXPECT_EQ(result, SupportedContentType::Unknown);
 }
 
+TEST(RequestContentTypeTests, ContentTypeBinaryData) {
+  HttpContext context;
+  http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
+  request.set(http::field::content_type, "application/octet-stream");
+  request.set(INFERENCE_HEADER_CONTENT_LENGTH, "10");
+  context.request = request;
+
+  EXPECT_EQ(GetRequestContentType(context), SupportedContentType::JsonWithBinaryData);
+  EXPECT_EQ(GetResponseContentType(context), SupportedContentType::JsonWithBinaryData);
+
+  // a specific accepted type wins
+  context.request.set(http::field::accept, "application/json");
+  EXPECT_EQ(GetResponseContentType(context), SupportedContentType::Json);
+}
+
 TEST(ContentTypeTests, ContentTypeMissing) {
   HttpContext context;
   http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
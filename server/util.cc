@@ -42,5 +42,98 @@ protobufutil::Status GenerateProtobufStatus(const int& onnx_status, const std::s
   return protobufutil::Status(code, oss.str());
 }
 
+const char* GetErrorCodeName(protobufutil::error::Code code) {
+  switch (code) {
+    case protobufutil::error::Code::OK:
+      return "OK";
+    case protobufutil::error::Code::CANCELLED:
+      return "CANCELLED";
+    case protobufutil::error::Code::UNKNOWN:
+      return "UNKNOWN";
+    case protobufutil::error::Code::INVALID_ARGUMENT:
+      return "INVALID_ARGUMENT";
+    case protobufutil::error::Code::DEADLINE_EXCEEDED:
+      return "DEADLINE_EXCEEDED";
+    case protobufutil::error::Code::NOT_FOUND:
+      return "NOT_FOUND";
+    case protobufutil::error::Code::ALREADY_EXISTS:
+      return "ALREADY_EXISTS";
+    case protobufutil::error::Code::PERMISSION_DENIED:
+      return "PERMISSION_DENIED";
+    case protobufutil::error::Code::UNAUTHENTICATED:
+      return "UNAUTHENTICATED";
+    case protobufutil::error::Code::RESOURCE_EXHAUSTED:
+      return "RESOURCE_EXHAUSTED";
+    case protobufutil::error::Code::FAILED_PRECONDITION:
+      return "FAILED_PRECONDITION";
+    case protobufutil::error::Code::ABORTED:
+      return "ABORTED";
+    case protobufutil::error::Code::OUT_OF_RANGE:
+      return "OUT_OF_RANGE";
+    case protobufutil::error::Code::UNIMPLEMENTED:
+      return "UNIMPLEMENTED";
+    case protobufutil::error::Code::INTERNAL:
+      return "INTERNAL";
+    case protobufutil::error::Code::UNAVAILABLE:
+      return "UNAVAILABLE";
+    case protobufutil::error::Code::DATA_LOSS:
+      return "DATA_LOSS";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    output_values.emplace_back(nullptr);
+  }
+
+  Run(session, options, input_names, input_values, output_names, output_values);
+  return output_values;
+}
+
+void Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names, std::vector<Ort::Value>& output_values) {
+  size_t input_count = input_names.size();
+  size_t output_count = output_names.size();
+
+  std::vector<const char*> input_ptrs{};
+  input_ptrs.reserve(input_count);
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+  std::vector<const char*> output_ptrs{};
+  output_ptrs.reserve(output_count);
+  for (const auto& output : output_names) {
+    output_ptrs.push_back(output.data());
+  }
+
+  const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_values.data(), output_count);
+}
+
+size_t GetElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -41,6 +41,18 @@ class MemBufferArray {
 
 google::protobuf::util::Status GenerateProtobufStatus(const int& onnx_status, const std::string& message);
 
+// Name of the error code, e.g. "INVALID_ARGUMENT"
+const char* GetErrorCodeName(google::protobuf::util::error::Code code);
+
+// Size in bytes of an element of the type. 0 for types that can't be copied as raw bytes, e.g. strings.
+size_t GetElementSize(ONNXTensorElementDataType type);
+
+// Runs the session with the given inputs. Throws Ort::Exception on failure.
+std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names);
+
+// Same as above but output_values can contain preallocated values. Empty values are allocated by the session.
+void Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names, std::vector<Ort::Value>& output_values);
+
 
 }  // namespace server
 }  // namespace onnxruntime
@@ -229,6 +229,8 @@ setup(
     entry_points= {
         'console_scripts': [
             'onnxruntime_test = onnxruntime.tools.onnxruntime_test:main',
+            'onnxruntime_tune = onnxruntime.tools.tune_session_options:main',
+            'onnxruntime_split_pipeline = onnxruntime.tools.pipeline_session:main',
         ]
     },
     classifiers=[